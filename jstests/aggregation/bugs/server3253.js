@@ -87,6 +87,19 @@ test(input, [{$project: {c: {$concat: ["hello there ", "_id"]}}}], [
     {_id: 3, c: "hello there _id"}
 ]);
 
+// test that a unique index is still enforced, even though it is only built on the temp collection
+// after all the data has been written, and that the previous output is left alone
+output.ensureIndex({d: 1}, {unique: true});
+assert.eq(output.getIndexes().length, 5);
+assertErrorCode(input, [{$project: {d: {$literal: 1}}}, {$out: output.getName()}], 40205);
+assert.eq(output.getIndexes().length, 5);
+assert.eq(output.find().sort({_id: 1}).toArray(), [
+    {_id: 1, c: "hello there _id"},
+    {_id: 2, c: "hello there _id"},
+    {_id: 3, c: "hello there _id"}
+]);
+assert.eq([], listCollections(/tmp\.agg_out/));
+
 // test with capped collection
 cappedOutput.drop();
 db.createCollection(cappedOutput.getName(), {capped: true, size: 2});
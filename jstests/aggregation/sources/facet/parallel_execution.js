@@ -0,0 +1,64 @@
+// Tests that $facet produces the same results when its sub-pipelines run on separate threads, and
+// that it still runs sub-pipelines which need storage access, such as $lookup.
+
+(function() {
+    "use strict";
+
+    var coll = db.facet_parallel_execution;
+    var foreign = db.facet_parallel_execution_foreign;
+    coll.drop();
+    foreign.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, group: i % 7, padding: "x".repeat(100)});
+    }
+    assert.writeOK(bulk.execute());
+    assert.writeOK(foreign.insert({_id: 0, name: "zero"}));
+
+    function setParameter(name, value) {
+        var cmd = {setParameter: 1};
+        cmd[name] = value;
+        var res = db.adminCommand(cmd);
+        assert.commandWorked(res);
+        return res.was;
+    }
+
+    var pipeline = [{
+        $facet: {
+            count: [{$group: {_id: null, n: {$sum: 1}}}],
+            byGroup: [{$group: {_id: "$group", n: {$sum: 1}}}, {$sort: {_id: 1}}],
+            firstThree: [{$sort: {_id: 1}}, {$limit: 3}, {$project: {padding: 0}}],
+            skipped: [{$skip: 995}, {$count: "n"}],
+        }
+    }];
+    var lookupPipeline = [{
+        $facet: {
+            count: [{$count: "n"}],
+            joined: [
+                {$match: {_id: 0}},
+                {
+                  $lookup:
+                      {from: foreign.getName(), localField: "_id", foreignField: "_id", as: "f"}
+                },
+                {$project: {_id: 1, f: 1}}
+            ],
+        }
+    }];
+
+    var serialResults = coll.aggregate(pipeline).toArray();
+    var serialLookupResults = coll.aggregate(lookupPipeline).toArray();
+
+    var original = setParameter("internalDocumentSourceFacetParallelExecution", true);
+    try {
+        assert.eq(coll.aggregate(pipeline).toArray(), serialResults);
+        assert.eq(coll.aggregate(lookupPipeline).toArray(), serialLookupResults);
+    } finally {
+        setParameter("internalDocumentSourceFacetParallelExecution", original);
+    }
+
+    assert.eq(serialResults[0].count, [{_id: null, n: 1000}]);
+    assert.eq(serialResults[0].firstThree,
+              [{_id: 0, group: 0}, {_id: 1, group: 1}, {_id: 2, group: 2}]);
+    assert.eq(serialLookupResults[0].joined, [{_id: 0, f: [{_id: 0, name: "zero"}]}]);
+}());
@@ -0,0 +1,69 @@
+// Tests that $graphLookup finds the same documents when it splits a wide search frontier into
+// several $in queries, and that its memory limit can be configured.
+
+(function() {
+    "use strict";
+
+    var local = db.local;
+    var foreign = db.foreign;
+
+    local.drop();
+    foreign.drop();
+
+    // A two-level tree, with 200 children under the root and 5 more under each child.
+    var bulk = foreign.initializeUnorderedBulkOp();
+    bulk.insert({_id: 0, children: []});
+    for (var i = 1; i <= 200; i++) {
+        var grandchildren = [];
+        for (var j = 0; j < 5; j++) {
+            grandchildren.push(1000 + i * 5 + j);
+            bulk.insert({_id: 1000 + i * 5 + j});
+        }
+        bulk.insert({_id: i, children: grandchildren});
+    }
+    assert.writeOK(bulk.execute());
+    var allChildren = [];
+    for (var i = 1; i <= 200; i++) {
+        allChildren.push(i);
+    }
+    assert.writeOK(foreign.update({_id: 0}, {$set: {children: allChildren}}));
+
+    assert.writeOK(local.insert({root: 0}));
+
+    function setParameter(name, value) {
+        var cmd = {setParameter: 1};
+        cmd[name] = value;
+        var res = db.adminCommand(cmd);
+        assert.commandWorked(res);
+        return res.was;
+    }
+
+    function countFound() {
+        return local
+            .aggregate({
+                $graphLookup: {
+                    from: "foreign",
+                    startWith: "$root",
+                    connectFromField: "children",
+                    connectToField: "_id",
+                    as: "found"
+                }
+            })
+            .toArray()[0]
+            .found.length;
+    }
+
+    var expected = 1 + 200 + 200 * 5;
+    var originalValues = setParameter("internalDocumentSourceGraphLookupMaxQueryValues", 7);
+    assert.eq(countFound(), expected);
+    setParameter("internalDocumentSourceGraphLookupMaxQueryValues", 1);
+    assert.eq(countFound(), expected);
+    setParameter("internalDocumentSourceGraphLookupMaxQueryValues", originalValues);
+    assert.eq(countFound(), expected);
+
+    // A memory limit too small for the search fails it.
+    var originalBytes = setParameter("internalDocumentSourceGraphLookupMaxMemoryBytes", 1024);
+    assert.throws(countFound);
+    setParameter("internalDocumentSourceGraphLookupMaxMemoryBytes", originalBytes);
+    assert.eq(countFound(), expected);
+}());
@@ -0,0 +1,56 @@
+// Tests that a $group on an indexed field with only $first or only $last accumulators reads one
+// document per group through a DISTINCT_SCAN, and produces the same results as without the index.
+
+(function() {
+    "use strict";
+
+    var coll = db.group_distinct_scan;
+    coll.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 200; i++) {
+        bulk.insert({_id: i, a: i % 10, b: i});
+    }
+    bulk.insert({_id: 200, b: 200});
+    assert.writeOK(bulk.execute());
+
+    function sortById(results) {
+        return results.sort(function(x, y) {
+            return bsonWoCompare({_id: x._id}, {_id: y._id});
+        });
+    }
+
+    function usesDistinctScan(pipeline) {
+        var explain = coll.explain().aggregate(pipeline);
+        var winningPlan = explain.stages[0].$cursor.queryPlanner.winningPlan;
+        return tojson(winningPlan).indexOf("DISTINCT_SCAN") >= 0;
+    }
+
+    var pipelines = [
+        [{$sort: {a: 1, b: 1}}, {$group: {_id: "$a", b: {$first: "$b"}}}],
+        [{$sort: {a: 1, b: 1}}, {$group: {_id: "$a", b: {$last: "$b"}}}],
+        [{$sort: {a: -1, b: -1}}, {$group: {_id: "$a", doc: {$first: "$$ROOT"}}}],
+        [{$group: {_id: "$a"}}],
+    ];
+
+    var expected = pipelines.map(function(pipeline) {
+        return sortById(coll.aggregate(pipeline).toArray());
+    });
+
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+    pipelines.forEach(function(pipeline, i) {
+        assert(usesDistinctScan(pipeline), tojson(pipeline));
+        assert.eq(sortById(coll.aggregate(pipeline).toArray()), expected[i], tojson(pipeline));
+    });
+
+    assert.eq(expected[0].length, 11);
+    assert.eq(expected[0][1], {_id: 0, b: 0});
+    assert.eq(expected[1][1], {_id: 0, b: 190});
+
+    // Any other accumulator needs every document of its group.
+    assert(!usesDistinctScan([{$group: {_id: "$a", n: {$sum: 1}}}]));
+
+    // A multikey index holds several keys per document, so it can't be used.
+    assert.writeOK(coll.insert({_id: 201, a: [1, 2], b: 201}));
+    assert(!usesDistinctScan(pipelines[0]));
+}());
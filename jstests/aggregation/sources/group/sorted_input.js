@@ -0,0 +1,49 @@
+// Tests that a $group on input sorted by its key, which streams its output, produces each group
+// exactly once, even when the key holds null, missing or array values which the sort interleaves.
+
+(function() {
+    "use strict";
+
+    var coll = db.group_sorted_input;
+    coll.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 300; i++) {
+        switch (i % 6) {
+            case 0:
+                bulk.insert({_id: i, a: null, b: 1});
+                break;
+            case 1:
+                bulk.insert({_id: i, b: 1});
+                break;
+            case 2:
+                bulk.insert({_id: i, a: [i % 4, 10], b: 1});
+                break;
+            default:
+                bulk.insert({_id: i, a: i % 5, b: 1});
+        }
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+
+    function sortById(results) {
+        return results.sort(function(x, y) {
+            return bsonWoCompare({_id: x._id}, {_id: y._id});
+        });
+    }
+
+    var group = {$group: {_id: "$a", n: {$sum: "$b"}}};
+    var sorted = sortById(coll.aggregate([{$sort: {a: 1}}, group]).toArray());
+    var unsorted = sortById(coll.aggregate([{$match: {}}, group]).toArray());
+    assert.eq(sorted, unsorted);
+
+    var total = 0;
+    sorted.forEach(function(result) {
+        total += result.n;
+    });
+    assert.eq(total, 300);
+
+    var multiField = {$group: {_id: {x: "$a", y: "$b"}, n: {$sum: 1}}};
+    assert.eq(sortById(coll.aggregate([{$sort: {a: 1, b: 1}}, multiField]).toArray()),
+              sortById(coll.aggregate([{$match: {}}, multiField]).toArray()));
+}());
@@ -0,0 +1,80 @@
+// Tests that $lookup returns the same results whether it joins its input documents in batches
+// with a shared $in query, or with a query for each input document.
+
+(function() {
+    "use strict";
+
+    var local = db.lookup_batched_local;
+    var foreign = db.lookup_batched_foreign;
+
+    local.drop();
+    foreign.drop();
+
+    var bulk = local.initializeUnorderedBulkOp();
+    for (var i = 0; i < 250; i++) {
+        bulk.insert({_id: i, key: i % 20});
+    }
+    // Values which are not joined by the shared query.
+    bulk.insert({_id: "missing"});
+    bulk.insert({_id: "null", key: null});
+    bulk.insert({_id: "array", key: [1, 2]});
+    bulk.insert({_id: "string", key: "a"});
+    bulk.insert({_id: "double", key: 3.0});
+    assert.writeOK(bulk.execute());
+
+    bulk = foreign.initializeUnorderedBulkOp();
+    for (var i = 0; i < 40; i++) {
+        bulk.insert({_id: i, key: i % 25});
+    }
+    bulk.insert({_id: "array", key: [1, 3, [4]]});
+    bulk.insert({_id: "nested", key: [{x: 1}]});
+    bulk.insert({_id: "nullForeign", key: null});
+    bulk.insert({_id: "missingForeign"});
+    bulk.insert({_id: "stringForeign", key: "a"});
+    bulk.insert({_id: "long", key: NumberLong(2)});
+    assert.writeOK(bulk.execute());
+
+    function runLookup(batchSize) {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalDocumentSourceLookupBatchSize: batchSize}));
+        // An $unwind directly after the $lookup would be absorbed by it, and absorbing one
+        // disables batching, so only project the joined documents' ids.
+        var results =
+            local
+                .aggregate([
+                    {
+                      $lookup:
+                          {from: foreign.getName(), localField: "key", foreignField: "key", as: "j"}
+                    },
+                    {$project: {_id: 1, j: "$j._id"}},
+                    {$sort: {_id: 1}}
+                ])
+                .toArray();
+        results.forEach(function(result) {
+            result.j.sort();
+        });
+        return results;
+    }
+
+    var original =
+        db.adminCommand({getParameter: 1, internalDocumentSourceLookupBatchSize: 1})
+            .internalDocumentSourceLookupBatchSize;
+
+    var unbatched = runLookup(1);
+    var batched = runLookup(100);
+    assert.eq(unbatched, batched);
+
+    // Batch sizes which do not divide the input evenly give the same results.
+    assert.eq(unbatched, runLookup(7));
+
+    // Each foreign document appears once per input even when it holds the value more than once.
+    assert.writeOK(foreign.insert({_id: "twice", key: [5, 5.0]}));
+    assert.eq(runLookup(1), runLookup(100));
+
+    // Joining on an index of the foreign collection gives the same results.
+    assert.commandWorked(foreign.createIndex({key: 1}));
+    assert.eq(runLookup(1), runLookup(100));
+
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalDocumentSourceLookupBatchSize: original}));
+}());
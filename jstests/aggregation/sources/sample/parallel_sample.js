@@ -0,0 +1,50 @@
+// Tests that a $sample drawn from random cursors on several worker threads returns the requested
+// number of distinct documents, including for samples well above 5% of the collection.
+
+(function() {
+    "use strict";
+
+    var coll = db.sample_parallel_sample;
+    coll.drop();
+
+    var nDocs = 1000;
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < nDocs; i++) {
+        bulk.insert({_id: i, padding: "x".repeat(100)});
+    }
+    assert.writeOK(bulk.execute());
+
+    function setParameter(name, value) {
+        var cmd = {setParameter: 1};
+        cmd[name] = value;
+        var res = db.adminCommand(cmd);
+        assert.commandWorked(res);
+        return res.was;
+    }
+
+    function assertDistinctSample(size) {
+        var results = coll.aggregate([{$sample: {size: size}}]).toArray();
+        assert.eq(results.length, Math.min(size, nDocs));
+
+        var seenIds = {};
+        results.forEach(function(result) {
+            assert.lt(result._id, nDocs, "$sample returned an unknown document");
+            assert(!seenIds[result._id], "$sample returned the same document twice: " + result._id);
+            seenIds[result._id] = true;
+        });
+    }
+
+    var originalThreads = setParameter("internalQueryExecParallelSampleThreads", 4);
+    try {
+        [10, 200, 450, 2000].forEach(assertDistinctSample);
+
+        var storageEngine = jsTest.options().storageEngine || "wiredTiger";
+        if (storageEngine == "wiredTiger" && coll.stats().wiredTiger.type != "lsm") {
+            // A sample of 20% of the collection still uses the random cursors.
+            var explain = coll.explain().aggregate([{$sample: {size: 200}}]);
+            assert(tojson(explain).indexOf("PARALLEL_COLLSCAN") >= 0, tojson(explain));
+        }
+    } finally {
+        setParameter("internalQueryExecParallelSampleThreads", originalThreads);
+    }
+}());
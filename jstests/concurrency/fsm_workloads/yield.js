@@ -134,6 +134,8 @@ var $config = (function() {
                 db.adminCommand({setParameter: 1, internalQueryExecYieldIterations: 5}));
             assertAlways.commandWorked(
                 db.adminCommand({setParameter: 1, internalQueryExecYieldPeriodMS: 1}));
+            assertAlways.commandWorked(db.adminCommand(
+                {setParameter: 1, internalQueryExecYieldOnlyWhenContended: false}));
         });
         // Set up some data to query.
         var N = this.nDocs;
@@ -160,6 +162,8 @@ var $config = (function() {
                 db.adminCommand({setParameter: 1, internalQueryExecYieldIterations: 128}));
             assertAlways.commandWorked(
                 db.adminCommand({setParameter: 1, internalQueryExecYieldPeriodMS: 10}));
+            assertAlways.commandWorked(db.adminCommand(
+                {setParameter: 1, internalQueryExecYieldOnlyWhenContended: true}));
         });
     }
 
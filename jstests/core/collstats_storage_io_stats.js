@@ -0,0 +1,53 @@
+// Tests that $collStats with "storageIOStats" and $indexStats report the storage engine's cache and
+// I/O counters for the collection and each of its indexes on WiredTiger.
+(function() {
+    "use strict";
+
+    var coll = db.collstats_storage_io_stats;
+    coll.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 100; i++) {
+        bulk.insert({_id: i, a: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.writeOK(coll.insert({_id: 100, a: 100}));
+    assert.eq(101, coll.find({a: {$gte: 0}}).itcount());
+
+    // The option takes an empty object only.
+    assert.commandFailedWithCode(
+        db.runCommand(
+            {aggregate: coll.getName(), pipeline: [{$collStats: {storageIOStats: {x: 1}}}]}),
+        40221);
+
+    var res = db.runCommand(
+        {aggregate: coll.getName(), pipeline: [{$collStats: {storageIOStats: {}}}]});
+    assert.commandWorked(res);
+    res.result.forEach(function(stats) {
+        assert(stats.hasOwnProperty("storageIOStats"), tojson(stats));
+    });
+
+    var isWiredTiger = db.serverStatus().storageEngine.name == "wiredTiger";
+    if (!isWiredTiger) {
+        return;
+    }
+
+    res.result.forEach(function(stats) {
+        var ioStats = stats.storageIOStats;
+        assert.gte(ioStats.bytesReadIntoCache, 0, tojson(stats));
+        assert.gte(ioStats.pagesRequestedFromCache, 0, tojson(stats));
+        assert.gt(ioStats.cursor.insert, 0, tojson(stats));
+        if (ioStats.hasOwnProperty("cacheHitPercent")) {
+            assert.lte(ioStats.cacheHitPercent, 100, tojson(stats));
+        }
+    });
+
+    var indexNames = [];
+    coll.aggregate([{$indexStats: {}}]).forEach(function(stats) {
+        indexNames.push(stats.name);
+        assert(stats.hasOwnProperty("storageIOStats"), tojson(stats));
+        assert.gt(stats.storageIOStats.cursor.insert, 0, tojson(stats));
+    });
+    assert.contains("a_1", indexNames);
+}());
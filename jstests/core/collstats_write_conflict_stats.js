@@ -0,0 +1,33 @@
+// Tests that $collStats with "writeConflictStats" reports the collection's write conflict and
+// document contention counters.
+(function() {
+    "use strict";
+
+    var coll = db.collstats_write_conflict_stats;
+    coll.drop();
+
+    assert.writeOK(coll.insert({_id: 0, count: 0}));
+    for (var i = 0; i < 10; i++) {
+        assert.writeOK(coll.update({_id: 0}, {$inc: {count: 1}}));
+    }
+
+    // The option takes an empty object only.
+    assert.commandFailedWithCode(
+        db.runCommand(
+            {aggregate: coll.getName(), pipeline: [{$collStats: {writeConflictStats: {x: 1}}}]}),
+        40396);
+
+    var res = db.runCommand(
+        {aggregate: coll.getName(), pipeline: [{$collStats: {writeConflictStats: {}}}]});
+    assert.commandWorked(res);
+    res.result.forEach(function(stats) {
+        var conflictStats = stats.writeConflictStats;
+        assert(conflictStats, tojson(stats));
+        assert.gte(conflictStats.writeConflicts, 0, tojson(stats));
+        assert.gte(conflictStats.contentionWaits, 0, tojson(stats));
+        assert.gte(conflictStats.contentionWaitMicros, 0, tojson(stats));
+        assert.gte(conflictStats.contentionWaitTimeouts, 0, tojson(stats));
+        assert.gte(conflictStats.maxQueueLength, 0, tojson(stats));
+        assert.gte(conflictStats.currentHotDocuments, 0, tojson(stats));
+    });
+}());
@@ -0,0 +1,54 @@
+// Tests the hashAlgorithm, min, max and bucketSize options of dbHash.
+(function() {
+    "use strict";
+
+    var coll = db.dbhash_ranges;
+    coll.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 25; i++) {
+        bulk.insert({_id: i, x: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    function hashOf(options) {
+        var res = db.runCommand(Object.extend({dbHash: 1, collections: [coll.getName()]}, options));
+        assert.commandWorked(res);
+        return res;
+    }
+
+    var md5 = hashOf({}).collections[coll.getName()];
+    assert.eq(md5, hashOf({hashAlgorithm: "md5"}).collections[coll.getName()]);
+    var murmur3 = hashOf({hashAlgorithm: "murmur3"}).collections[coll.getName()];
+    assert.eq(32, murmur3.length);
+    assert.neq(md5, murmur3);
+
+    // The buckets partition the collection and report the hash of their documents as a range.
+    var res = hashOf({bucketSize: 10});
+    var buckets = res.buckets[coll.getName()];
+    assert.eq(3, buckets.length, tojson(res));
+    assert.eq([10, 10, 5],
+              buckets.map(function(bucket) {
+                  return bucket.count;
+              }),
+              tojson(res));
+    assert.eq({_id: MinKey}, buckets[0].min, tojson(res));
+    assert.eq({_id: 10}, buckets[0].max, tojson(res));
+    assert.eq({_id: 10}, buckets[1].min, tojson(res));
+    assert.eq({_id: MaxKey}, buckets[2].max, tojson(res));
+    assert.eq(md5, res.collections[coll.getName()]);
+
+    var rangeHash = hashOf({min: buckets[1].min, max: buckets[1].max}).collections[coll.getName()];
+    assert.eq(buckets[1].hash, rangeHash);
+
+    // A change to one document only changes the hash of its bucket.
+    assert.writeOK(coll.update({_id: 15}, {$set: {x: -1}}));
+    var changed = hashOf({bucketSize: 10}).buckets[coll.getName()];
+    assert.eq(buckets[0].hash, changed[0].hash);
+    assert.neq(buckets[1].hash, changed[1].hash);
+    assert.eq(buckets[2].hash, changed[2].hash);
+
+    assert.commandFailed(db.runCommand({dbHash: 1, hashAlgorithm: "sha1"}));
+    assert.commandFailed(db.runCommand({dbHash: 1, bucketSize: 0}));
+    assert.commandFailed(db.runCommand({dbHash: 1, min: 5}));
+}());
@@ -0,0 +1,54 @@
+/**
+ * Tests that distinct uses a DISTINCT_SCAN for predicates on the trailing fields of a compound
+ * index and for multikey indexes which need a fetch, and that it returns the right values.
+ */
+(function() {
+    'use strict';
+
+    load("jstests/libs/analyze_plan.js");
+
+    var coll = db.distinct_scan_filter;
+    coll.drop();
+
+    function getDistinctPlan(key, query) {
+        var explain =
+            coll.runCommand({explain: {distinct: coll.getName(), key: key, query: query}});
+        assert.commandWorked(explain);
+        return explain.queryPlanner.winningPlan;
+    }
+
+    // For each 'a' in [0, 4] insert documents with every 'b' in [0, 9], except that no document
+    // with a: 2 has b: 7.
+    for (var a = 0; a < 5; ++a) {
+        for (var b = 0; b < 10; ++b) {
+            if (a !== 2 || b !== 7) {
+                assert.writeOK(coll.insert({a: a, b: b}));
+            }
+        }
+    }
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+
+    // A predicate on 'b' alone can be expressed by the bounds of the compound index.
+    assert.eq([0, 1, 3, 4], coll.distinct('a', {b: 7}).sort());
+    assert(planHasStage(getDistinctPlan('a', {b: 7}), "DISTINCT_SCAN"));
+    assert.eq([0, 1, 2, 3, 4], coll.distinct('a', {b: {$gte: 8}}).sort());
+    assert.eq([3, 4], coll.distinct('a', {a: {$gt: 2}, b: {$in: [6, 7]}}).sort());
+    assert(planHasStage(getDistinctPlan('a', {a: {$gt: 2}, b: {$in: [6, 7]}}), "DISTINCT_SCAN"));
+
+    // Predicates which the bounds can't express exactly still produce the right answer.
+    assert.eq([0, 1, 3, 4], coll.distinct('a', {a: {$gte: 0}, b: {$mod: [10, 7]}}).sort());
+    assert.eq([], coll.distinct('a', {b: {$exists: false}}));
+
+    // Over a multikey index the scan fetches each document, whose other values are collected too.
+    coll.drop();
+    for (var i = 0; i < 20; ++i) {
+        assert.writeOK(coll.insert({a: [1, 2, 3], b: i}));
+        assert.writeOK(coll.insert({a: [4, 5, 6], b: i}));
+    }
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.eq([1, 2, 3, 4, 5, 6], coll.distinct('a').sort());
+    assert.eq([4, 5, 6], coll.distinct('a', {a: {$gte: 4}}).sort());
+    var plan = getDistinctPlan('a', {a: {$gte: 4}});
+    assert(planHasStage(plan, "DISTINCT_SCAN"));
+    assert(planHasStage(plan, "FETCH"));
+})();
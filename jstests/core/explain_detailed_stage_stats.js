@@ -0,0 +1,53 @@
+// Tests that explain at executionStats verbosity reports per-stage nanosecond timings, CPU time
+// and disk reads, and that queryPlanner verbosity doesn't.
+(function() {
+    "use strict";
+
+    var coll = db.explain_detailed_stage_stats;
+    coll.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 200; i++) {
+        bulk.insert({_id: i, a: i % 20});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+
+    // Calls 'callback' on each execution stage below 'root', including those of every shard.
+    function forEachStage(root, callback) {
+        if (root.shards) {
+            root.shards.forEach(function(shard) {
+                forEachStage(shard.executionStages, callback);
+            });
+            return;
+        }
+        callback(root);
+        if (root.inputStage) {
+            forEachStage(root.inputStage, callback);
+        }
+        (root.inputStages || []).forEach(function(stage) {
+            forEachStage(stage, callback);
+        });
+    }
+
+    var explain = coll.find({a: {$gte: 5}}).explain("executionStats");
+    var stageNames = [];
+    forEachStage(explain.executionStats.executionStages, function(stage) {
+        stageNames.push(stage.stage);
+        assert.gte(stage.executionTimeNanos, 0, tojson(stage));
+        assert.gte(stage.cpuTimeNanos, 0, tojson(stage));
+        assert.gte(stage.diskBytesRead, 0, tojson(stage));
+        assert.gte(stage.majorPageFaults, 0, tojson(stage));
+        if (stage.inputStage && stage.inputStage.executionTimeNanos !== undefined) {
+            // A stage's timings include the time spent in its children.
+            assert.gte(
+                stage.executionTimeNanos, stage.inputStage.executionTimeNanos, tojson(stage));
+        }
+    });
+    assert.contains("IXSCAN", stageNames, tojson(explain));
+    assert.contains("FETCH", stageNames, tojson(explain));
+
+    explain = coll.find({a: {$gte: 5}}).explain("queryPlanner");
+    assert(!("executionStats" in explain), tojson(explain));
+    assert.eq(-1, tojson(explain).indexOf("executionTimeNanos"), tojson(explain));
+}());
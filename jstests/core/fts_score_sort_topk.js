@@ -0,0 +1,60 @@
+// Tests that a text search sorted by score with a limit returns the same documents as sorting
+// every match, and that the TEXT_OR stage reports the number of documents it needed.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    var coll = db.fts_score_sort_topk;
+    coll.drop();
+
+    var words = ["apple", "banana", "cherry", "date", "elder"];
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 200; i++) {
+        var text = [];
+        for (var j = 0; j < words.length; j++) {
+            for (var k = 0; k < (i + j) % 7; k++) {
+                text.push(words[j]);
+            }
+        }
+        text.push("filler" + i);
+        bulk.insert({_id: i, t: text.join(" ")});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({t: "text"}));
+
+    function scoresOf(cursor) {
+        return cursor.toArray().map(function(doc) {
+            return doc.score;
+        });
+    }
+
+    var proj = {score: {$meta: "textScore"}};
+    var sort = {score: {$meta: "textScore"}};
+    ["apple", "apple banana", "cherry date elder"].forEach(function(search) {
+        var query = {$text: {$search: search}};
+        var all = scoresOf(coll.find(query, proj).sort(sort));
+        var top = scoresOf(coll.find(query, proj).sort(sort).limit(10));
+        assert.eq(all.slice(0, 10), top, search);
+    });
+
+    // Only the score sort with a limit bounds the stage.
+    var query = {$text: {$search: "apple banana"}};
+    var explain = coll.find(query, proj).sort(sort).limit(10).explain("executionStats");
+    var textOr = getPlanStage(explain.executionStats.executionStages, "TEXT_OR");
+    if (textOr !== null) {
+        assert.eq(10, textOr.topK, tojson(explain));
+        assert(textOr.hasOwnProperty("stoppedEarly"), tojson(explain));
+    }
+
+    explain = coll.find(query, proj).sort({_id: 1}).limit(10).explain("executionStats");
+    textOr = getPlanStage(explain.executionStats.executionStages, "TEXT_OR");
+    if (textOr !== null) {
+        assert.eq(0, textOr.topK, tojson(explain));
+    }
+
+    // Negated terms disable the bound, since they can remove any document from the results.
+    var negated = {$text: {$search: "apple banana -cherry"}};
+    assert.eq(scoresOf(coll.find(negated, proj).sort(sort)).slice(0, 10),
+              scoresOf(coll.find(negated, proj).sort(sort).limit(10)));
+}());
@@ -0,0 +1,46 @@
+// Tests that $near queries on a 2dsphere index size their first search annulus from the density
+// earlier queries near the same point measured, and still return the same results.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    var coll = db.geonear_density_grid;
+    coll.drop();
+
+    // A dense cluster of points, and a few far away.
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 500; i++) {
+        var coordinates = [(i % 25) * 0.001, Math.floor(i / 25) * 0.001];
+        bulk.insert({_id: i, loc: {type: "Point", coordinates: coordinates}});
+    }
+    for (var i = 0; i < 10; i++) {
+        bulk.insert({_id: 500 + i, loc: {type: "Point", coordinates: [100 + i, 10]}});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({loc: "2dsphere"}));
+
+    var query = {loc: {$near: {$geometry: {type: "Point", coordinates: [0.01, 0.01]}}}};
+    var firstIds = coll.find(query).toArray().map(function(doc) {
+        return doc._id;
+    });
+    assert.eq(510, firstIds.length);
+
+    var explain = coll.find(query).limit(10).explain("executionStats");
+    var nearStage = getPlanStage(explain.executionStats.executionStages, "GEO_NEAR_2DSPHERE");
+    assert.neq(null, nearStage, tojson(explain));
+    assert.eq(true, nearStage.usedDensityGrid, tojson(explain));
+
+    // Documents at the same distance may come back in either order.
+    var secondIds = coll.find(query).toArray().map(function(doc) {
+        return doc._id;
+    });
+    assert.eq(firstIds.sort(), secondIds.sort());
+
+    // A sparse neighborhood gets wide annuli, and still finds everything in order.
+    var sparseQuery = {loc: {$near: {$geometry: {type: "Point", coordinates: [105, 10]}}}};
+    var sparseDocs = coll.find(sparseQuery).limit(10).toArray();
+    assert.eq(10, sparseDocs.length);
+    assert.eq(505, sparseDocs[0]._id);
+    assert.eq(sparseDocs.length, coll.find(sparseQuery).limit(10).itcount());
+}());
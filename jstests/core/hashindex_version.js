@@ -0,0 +1,30 @@
+// Tests hashed indexes built with hashVersion 1, which hash their keys with MurmurHash3 rather
+// than MD5, and that queries use the seed and hash version of the index they scan.
+(function() {
+    "use strict";
+
+    var coll = db.hashindex_version;
+    coll.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 100; i++) {
+        bulk.insert({_id: i, a: i % 10, b: "str" + (i % 10)});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandFailedWithCode(coll.createIndex({a: "hashed"}, {hashVersion: 2}), 40224);
+    assert.commandWorked(coll.createIndex({a: "hashed"}, {hashVersion: 1}));
+    assert.commandWorked(coll.createIndex({b: "hashed"}, {hashVersion: 1, seed: 3}));
+
+    assert.eq(10, coll.find({a: 3}).hint({a: "hashed"}).itcount());
+    assert.eq(30, coll.find({a: {$in: [1, 2, 3]}}).hint({a: "hashed"}).itcount());
+    assert.eq(10, coll.find({b: "str4"}).hint({b: "hashed"}).itcount());
+    assert.eq(20, coll.find({b: {$in: ["str4", "str5", "none"]}}).hint({b: "hashed"}).itcount());
+    assert.eq(0, coll.find({a: 10}).hint({a: "hashed"}).itcount());
+
+    // The hash of a value depends on the hash version.
+    var res = db.runCommand({_hashBSONElement: 3, hashVersion: 1});
+    if (res.ok) {
+        assert.neq(res.out, db.runCommand({_hashBSONElement: 3}).out, tojson(res));
+    }
+}());
@@ -60,4 +60,42 @@
     // Delete that does affect partial index.
     assert.writeOK(coll.remove({x: 6}));
     assert.eq(0, getNumKeys("x_1"));
+
+    // Updates only maintain the indexes whose key or filter fields they modify. Check that each
+    // index stays correct when another index's fields change.
+    coll.drop();
+    assert.commandWorked(coll.ensureIndex({x: 1}, {partialFilterExpression: {"f.g": {$gt: 0}}}));
+    assert.commandWorked(coll.ensureIndex({y: 1}));
+    assert.commandWorked(coll.ensureIndex({"z.w": 1}, {partialFilterExpression: {a: 1}}));
+    assert.writeOK(coll.insert({_id: 1, x: 1, y: 1, z: [{w: 1}, {w: 2}], f: {g: 1}, a: 1}));
+    assert.eq(1, getNumKeys("x_1"));
+    assert.eq(1, getNumKeys("y_1"));
+    assert.eq(2, getNumKeys("z.w_1"));
+
+    assert.writeOK(coll.update({_id: 1}, {$set: {y: 2}}));
+    assert.eq(1, coll.find({y: 2}).hint({y: 1}).itcount());
+    assert.eq(1, coll.find({x: 1, "f.g": {$gt: 0}}).hint({x: 1}).itcount());
+
+    // Modifying a parent of a filter field.
+    assert.writeOK(coll.update({_id: 1}, {$set: {f: {g: -1}}}));
+    assert.eq(0, getNumKeys("x_1"));
+    assert.eq(1, getNumKeys("y_1"));
+
+    // Modifying a field below an indexed field, through a positional update.
+    assert.writeOK(coll.update({_id: 1, "z.w": 2}, {$set: {"z.$.w": 3}}));
+    assert.eq(1, coll.find({"z.w": 3, a: 1}).hint({"z.w": 1}).itcount());
+    assert.eq(0, coll.find({"z.w": 2, a: 1}).hint({"z.w": 1}).itcount());
+    assert.eq(2, getNumKeys("z.w_1"));
+
+    // A replacement may change every field.
+    assert.writeOK(coll.update({_id: 1}, {x: 2, y: 3, f: {g: 2}, z: {w: 4}, a: 1}));
+    assert.eq(1, getNumKeys("x_1"));
+    assert.eq(1, coll.find({y: 3}).hint({y: 1}).itcount());
+    assert.eq(1, coll.find({"z.w": 4, a: 1}).hint({"z.w": 1}).itcount());
+    assert.eq(1, getNumKeys("z.w_1"));
+
+    assert.writeOK(coll.remove({_id: 1}));
+    assert.eq(0, getNumKeys("x_1"));
+    assert.eq(0, getNumKeys("y_1"));
+    assert.eq(0, getNumKeys("z.w_1"));
 })();
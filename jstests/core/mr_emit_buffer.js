@@ -0,0 +1,62 @@
+// Tests that mapReduce gives the same results when the map function mixes the simple emits, which
+// are buffered before being added, with emits of objects, which are added at once.
+(function() {
+    "use strict";
+
+    var coll = db.mr_emit_buffer;
+    coll.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 500; i++) {
+        bulk.insert({_id: i, words: ["a", "b", "c", "d"].slice(0, (i % 4) + 1)});
+    }
+    assert.writeOK(bulk.execute());
+
+    function map() {
+        var counter = {count: 0};
+        for (var i = 0; i < this.words.length; i++) {
+            emit(this.words[i], 1);
+
+            // The object emitted must be the one at the time of the emit, even though it is
+            // modified right after.
+            counter.count = 1;
+            emit("obj_" + this.words[i], counter);
+            counter.count = 1000;
+        }
+        emit(undefined, 1);
+    }
+
+    function reduce(key, values) {
+        var total = 0;
+        values.forEach(function(value) {
+            total += (typeof(value) === "object") ? value.count : value;
+        });
+        return (typeof(values[0]) === "object") ? {count: total} : total;
+    }
+
+    var res = coll.mapReduce(map, reduce, {out: {inline: 1}});
+    assert.commandWorked(res);
+    assert.eq(500 * 2.5 * 2 + 500, res.counts.emit, tojson(res.counts));
+
+    var results = {};
+    res.results.forEach(function(doc) {
+        results[doc._id] = doc.value;
+    });
+    assert.eq(500, results[null], tojson(res));
+    assert.eq(500, results.a, tojson(res));
+    assert.eq(375, results.b, tojson(res));
+    assert.eq(250, results.c, tojson(res));
+    assert.eq(125, results.d, tojson(res));
+    assert.eq({count: 500}, results.obj_a, tojson(res));
+    assert.eq({count: 125}, results.obj_d, tojson(res));
+
+    // The emit function still checks its arguments.
+    assert.throws(function() {
+        coll.mapReduce(
+            function() {
+                emit(this._id);
+            },
+            reduce,
+            {out: {inline: 1}});
+    });
+}());
@@ -0,0 +1,55 @@
+// Checks that $collStats reports latency histograms per query shape when asked to, and that a
+// query shape is counted once per operation of that shape.
+
+(function() {
+    "use strict";
+
+    if (db.runCommand({isMaster: 1}).msg == "isdbgrid") {
+        // Query shape latencies are only recorded by mongod.
+        return;
+    }
+
+    var coll = db.query_shape_latency_stats;
+    coll.drop();
+    assert.writeOK(coll.insert({a: 1, b: 1}));
+
+    function getQueryShapes() {
+        var stats =
+            coll.aggregate([{$collStats: {latencyStats: {queryShapes: true}}}]).toArray()[0];
+        assert(stats.latencyStats.hasOwnProperty("queryShapes"), tojson(stats));
+        return stats.latencyStats.queryShapes;
+    }
+
+    function getOps(shapes) {
+        return shapes.reduce(function(total, shape) {
+            return total + shape.reads.ops + shape.writes.ops + shape.commands.ops;
+        }, 0);
+    }
+
+    // Without the option, no query shapes are reported.
+    var plainStats = coll.aggregate([{$collStats: {latencyStats: {}}}]).toArray()[0];
+    assert(!plainStats.latencyStats.hasOwnProperty("queryShapes"), tojson(plainStats));
+
+    var before = getOps(getQueryShapes());
+    for (var i = 0; i < 5; i++) {
+        assert.eq(1, coll.find({a: i}).itcount());
+    }
+    assert.eq(1, coll.find({b: 1}).sort({a: 1}).itcount());
+
+    var shapes = getQueryShapes();
+    assert.gte(shapes.length, 2, tojson(shapes));
+    assert.eq(getOps(shapes) - before, 6, tojson(shapes));
+    shapes.forEach(function(shape) {
+        assert.eq(typeof shape.queryShape, "string");
+    });
+
+    // Query shapes are also reported by serverStatus on request.
+    var serverStatus = db.serverStatus({queryShapeLatency: 1});
+    assert(serverStatus.queryShapeLatency.hasOwnProperty(coll.getFullName()),
+           tojson(serverStatus.queryShapeLatency));
+
+    // Dropping the collection drops its query shapes.
+    assert(coll.drop());
+    assert.writeOK(coll.insert({a: 1}));
+    assert.eq(0, getOps(getQueryShapes()));
+}());
@@ -0,0 +1,24 @@
+// Tests that setOperationPriority changes the priority of the connection's later operations and
+// reports the previous one.
+(function() {
+    "use strict";
+
+    var coll = db.set_operation_priority;
+    coll.drop();
+    assert.writeOK(coll.insert({_id: 1}));
+
+    var res = assert.commandWorked(db.adminCommand({setOperationPriority: "low"}));
+    assert.eq("normal", res.was, tojson(res));
+
+    // Low priority operations still run.
+    assert.eq(1, coll.find().itcount());
+    assert.writeOK(coll.insert({_id: 2}));
+
+    res = assert.commandWorked(db.adminCommand({setOperationPriority: "normal"}));
+    assert.eq("low", res.was, tojson(res));
+
+    assert.commandFailedWithCode(db.adminCommand({setOperationPriority: "high"}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(db.adminCommand({setOperationPriority: 1}),
+                                 ErrorCodes.TypeMismatch);
+}());
@@ -0,0 +1,125 @@
+/**
+ * Tests that a summary collection holds the grouping of its source collection as the source is
+ * inserted into, updated and deleted from.
+ */
+(function() {
+    'use strict';
+
+    var sales = db.summary_collection_sales;
+    var summary = db.summary_collection_by_region;
+    sales.drop();
+    summary.drop();
+
+    // Returns the result of the aggregation the summary stands for, to compare with it.
+    function expectedSummary() {
+        return sales
+            .aggregate([
+                {$match: {status: "closed"}},
+                {
+                  $group: {
+                      _id: "$region",
+                      _count: {$sum: 1},
+                      total: {$sum: "$amount"},
+                      n: {$sum: 1},
+                      lowest: {$min: "$amount"},
+                      highest: {$max: "$amount"}
+                  }
+                },
+                {$sort: {_id: 1}}
+            ])
+            .toArray();
+    }
+
+    function assertSummaryMatches() {
+        assert.eq(expectedSummary(), summary.find().sort({_id: 1}).toArray());
+    }
+
+    // The documents which exist when the summary is created are summarized.
+    assert.writeOK(sales.insert({_id: 0, region: "east", amount: 10, status: "closed"}));
+    assert.writeOK(sales.insert({_id: 1, region: "west", amount: 5, status: "closed"}));
+    assert.writeOK(sales.insert({_id: 2, region: "west", amount: 7, status: "open"}));
+    assert.commandWorked(sales.createIndex({region: 1}));
+
+    assert.commandWorked(db.createCollection(summary.getName(), {
+        summary: {
+            source: sales.getName(),
+            groupBy: "$region",
+            filter: {status: "closed"},
+            accumulators: {
+                total: {$sum: "$amount"},
+                n: {$count: {}},
+                lowest: {$min: "$amount"},
+                highest: {$max: "$amount"}
+            }
+        }
+    }));
+    assertSummaryMatches();
+
+    // Inserts, including a batch which adds several documents to one group.
+    assert.writeOK(sales.insert([
+        {_id: 3, region: "east", amount: 3, status: "closed"},
+        {_id: 4, region: "east", amount: 20, status: "closed"},
+        {_id: 5, region: "north", amount: 1, status: "closed"},
+        {_id: 6, amount: 2, status: "closed"}
+    ]));
+    assertSummaryMatches();
+    assert.eq({_id: "east", _count: 3, total: 33, n: 3, lowest: 3, highest: 20},
+              summary.findOne({_id: "east"}));
+
+    // Updates which change the amount, the group, or whether the document passes the filter.
+    assert.writeOK(sales.update({_id: 0}, {$inc: {amount: 100}}));
+    assertSummaryMatches();
+    assert.writeOK(sales.update({_id: 3}, {$set: {region: "west"}}));
+    assertSummaryMatches();
+    assert.writeOK(sales.update({_id: 2}, {$set: {status: "closed"}}));
+    assertSummaryMatches();
+    assert.writeOK(sales.update({_id: 1}, {$set: {status: "open", note: "reopened"}}));
+    assertSummaryMatches();
+    assert.writeOK(sales.update({_id: 4}, {region: "north", amount: 2.5, status: "closed"}));
+    assertSummaryMatches();
+
+    // Deleting the minimum or maximum of a group finds the next one.
+    assert.writeOK(sales.remove({_id: 0}));
+    assertSummaryMatches();
+    assert.eq(3, summary.findOne({_id: "west"}).lowest);
+    assert.writeOK(sales.remove({_id: 3}));
+    assertSummaryMatches();
+    assert.eq(7, summary.findOne({_id: "west"}).lowest);
+
+    // A group left without documents disappears.
+    assert.writeOK(sales.remove({_id: 6}));
+    assertSummaryMatches();
+    assert.eq(null, summary.findOne({_id: null}));
+
+    // The summary can be queried and indexed like any collection.
+    assert.commandWorked(summary.createIndex({total: 1}));
+    assert.eq(["north"], summary.find({total: {$lt: 5}}).toArray().map(function(doc) {
+        return doc._id;
+    }));
+
+    // Renaming a summary or its source is refused, and dropping the source empties the summary.
+    assert.commandFailedWithCode(sales.renameCollection("summary_collection_renamed"),
+                                 ErrorCodes.IllegalOperation);
+    assert.commandFailedWithCode(summary.renameCollection("summary_collection_renamed"),
+                                 ErrorCodes.IllegalOperation);
+    assert(sales.drop());
+    assert.eq(0, summary.count());
+    assert.writeOK(sales.insert({_id: 0, region: "south", amount: 4, status: "closed"}));
+    assertSummaryMatches();
+
+    // Invalid definitions are rejected.
+    summary.drop();
+    function assertInvalid(spec) {
+        assert.commandFailedWithCode(db.createCollection(summary.getName(), {summary: spec}),
+                                     ErrorCodes.BadValue);
+    }
+    assertInvalid({groupBy: "$region", accumulators: {n: {$count: {}}}});
+    assertInvalid({source: sales.getName(), accumulators: {n: {$count: {}}}});
+    assertInvalid({source: sales.getName(), groupBy: "$region", accumulators: {}});
+    assertInvalid({source: sales.getName(), groupBy: "region", accumulators: {n: {$count: {}}}});
+    assertInvalid(
+        {source: sales.getName(), groupBy: "$region", accumulators: {n: {$avg: "$amount"}}});
+    assertInvalid(
+        {source: sales.getName(), groupBy: "$region", accumulators: {_count: {$count: {}}}});
+    assertInvalid({source: summary.getName(), groupBy: null, accumulators: {n: {$count: {}}}});
+})();
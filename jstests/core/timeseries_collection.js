@@ -0,0 +1,125 @@
+/**
+ * Tests that a time-series collection stores its measurements in buckets of one series each, and
+ * returns them as measurements to queries.
+ */
+(function() {
+    'use strict';
+
+    load("jstests/libs/analyze_plan.js");
+
+    var coll = db.timeseries_collection;
+    coll.drop();
+
+    assert.commandWorked(db.createCollection(
+        coll.getName(), {timeseries: {timeField: "time", metaField: "sensor", bucketMaxCount: 4}}));
+
+    function rawBuckets() {
+        var res = assert.commandWorked(
+            db.runCommand({find: coll.getName(), rawData: true, sort: {_id: 1}}));
+        return res.cursor.firstBatch;
+    }
+
+    var start = ISODate("2016-11-01T00:00:00Z").getTime();
+    function measurement(i, sensor) {
+        var doc = {time: new Date(start + i * 1000), value: i};
+        if (sensor !== undefined) {
+            doc.sensor = sensor;
+        }
+        return doc;
+    }
+
+    // Measurements of two series, one at a time and in batches.
+    var expected = [];
+    for (var i = 0; i < 10; ++i) {
+        var doc = measurement(i, {id: i % 2});
+        expected.push(doc);
+        assert.writeOK(coll.insert(doc));
+    }
+    var batch = [];
+    for (var i = 10; i < 16; ++i) {
+        batch.push(measurement(i));
+    }
+    expected = expected.concat(batch);
+    assert.writeOK(coll.insert(batch));
+
+    // Each series has its own buckets of at most four measurements.
+    var buckets = rawBuckets();
+    assert.eq(6, buckets.length, tojson(buckets));
+    var total = 0;
+    buckets.forEach(function(bucket) {
+        assert.lte(bucket.control.count, 4, tojson(bucket));
+        total += bucket.control.count;
+    });
+    assert.eq(16, total);
+
+    // Full buckets are closed, and regular columns are compressed.
+    var closed = buckets.filter(function(bucket) {
+        return bucket.control.version === 2;
+    });
+    assert.eq(3, closed.length, tojson(buckets));
+    closed.forEach(function(bucket) {
+        assert.eq(4, bucket.control.count, tojson(bucket));
+        assert.eq("object", typeof bucket.data.time, tojson(bucket));
+        assert(bucket.data.time instanceof BinData, tojson(bucket));
+    });
+
+    // Queries return the measurements.
+    function values(docs) {
+        return (Array.isArray(docs) ? docs : docs.toArray()).map(function(doc) {
+            return doc.value;
+        });
+    }
+    assert.eq(16, coll.find().itcount());
+    assert.eq(16, coll.count());
+    assert.eq(values(expected), values(coll.find().sort({value: 1})));
+    var found = coll.findOne({value: 3});
+    assert.eq(expected[3]._id, found._id);
+    assert.eq(expected[3].time, found.time);
+    assert.eq({id: 1}, found.sensor);
+
+    // Predicates on the time and meta fields.
+    var window = {$gte: new Date(start + 4000), $lt: new Date(start + 7000)};
+    assert.eq([4, 5, 6], values(coll.find({time: window}).sort({value: 1})));
+    assert.eq([1, 3, 5, 7, 9], values(coll.find({"sensor.id": 1}).sort({value: 1})));
+    assert.eq([12, 13], values(coll.find({sensor: null, value: {$in: [12, 13]}}).sort({value: 1})));
+    assert.eq(5, coll.count({"sensor.id": 0}));
+
+    // Aggregations and distinct.
+    var grouped =
+        coll.aggregate([{$group: {_id: "$sensor.id", n: {$sum: 1}}}, {$sort: {_id: 1}}]).toArray();
+    assert.eq([{_id: null, n: 6}, {_id: 0, n: 5}, {_id: 1, n: 5}], grouped);
+    assert.eq([0, 1], coll.distinct("sensor.id").sort());
+
+    // Queries unpack the buckets.
+    var explain = coll.find({"sensor.id": 1}).explain();
+    assert(planHasStage(explain.queryPlanner.winningPlan, "UNPACK_BUCKET"), tojson(explain));
+    assert(planHasStage(explain.queryPlanner.winningPlan, "COLLSCAN"), tojson(explain));
+
+    // A measurement has to have a Date in the timeField.
+    assert.writeError(coll.insert({value: 100}));
+    assert.writeError(coll.insert({time: 1, value: 100}));
+    assert.eq(16, coll.count());
+
+    // Measurements can't be updated or deleted.
+    assert.writeErrorWithCode(coll.update({value: 1}, {$set: {value: 2}}),
+                              ErrorCodes.IllegalOperation);
+    assert.writeErrorWithCode(coll.remove({value: 1}), ErrorCodes.IllegalOperation);
+    assert.commandFailedWithCode(
+        db.runCommand({findAndModify: coll.getName(), query: {value: 1}, remove: true}),
+        ErrorCodes.IllegalOperation);
+
+    // Invalid options are rejected.
+    coll.drop();
+    function assertInvalid(options, code) {
+        assert.commandFailedWithCode(db.createCollection(coll.getName(), options), code);
+    }
+    assertInvalid({timeseries: {}}, ErrorCodes.BadValue);
+    assertInvalid({timeseries: {timeField: "t", metaField: "t"}}, ErrorCodes.BadValue);
+    assertInvalid({timeseries: {timeField: "a.b"}}, ErrorCodes.BadValue);
+    assertInvalid({timeseries: {timeField: "_id"}}, ErrorCodes.BadValue);
+    assertInvalid({timeseries: {timeField: "t", bucketMaxCount: 0}}, ErrorCodes.BadValue);
+    assertInvalid({timeseries: {timeField: "t", unknown: 1}}, ErrorCodes.BadValue);
+    assertInvalid({timeseries: {timeField: "t"}, capped: true, size: 4096},
+                  ErrorCodes.InvalidOptions);
+    assertInvalid({timeseries: {timeField: "t"}, validator: {a: 1}}, ErrorCodes.InvalidOptions);
+})();
@@ -0,0 +1,56 @@
+// Tests single-document updates whose predicate compares _id, or a field with a unique index, and
+// other fields to values. They look the document up without planning, and still only update it
+// if the other fields match.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    var coll = db.update_point_query;
+    coll.drop();
+
+    assert.writeOK(coll.insert({_id: 1, version: 5, u: "a"}));
+    assert.writeOK(coll.insert({_id: 2, version: 1, u: ["b", "c"]}));
+    assert.commandWorked(coll.createIndex({u: 1}, {unique: true}));
+
+    // Optimistic concurrency control on _id and a version.
+    var explain = coll.explain().update({_id: 1, version: 5}, {$inc: {version: 1}});
+    var idHack = getPlanStage(explain.queryPlanner.winningPlan, "IDHACK");
+    assert.neq(null, idHack, tojson(explain));
+
+    var res = assert.writeOK(coll.update({_id: 1, version: 5}, {$inc: {version: 1}}));
+    assert.eq(1, res.nModified, tojson(res));
+    res = assert.writeOK(coll.update({_id: 1, version: 5}, {$inc: {version: 1}}));
+    assert.eq(0, res.nMatched, tojson(res));
+    assert.eq(6, coll.findOne({_id: 1}).version);
+
+    var doc = coll.findAndModify(
+        {query: {_id: 1, version: 6}, update: {$inc: {version: 1}}, new: true});
+    assert.eq(7, doc.version, tojson(doc));
+    assert.eq(null, coll.findAndModify({query: {_id: 1, version: 6}, update: {$set: {x: 1}}}));
+
+    // An upsert inserts the fields it compares.
+    res = assert.writeOK(coll.update({_id: 3, version: 1}, {$set: {u: "d"}}, {upsert: true}));
+    assert.eq(1, res.nUpserted, tojson(res));
+    assert.eq({_id: 3, version: 1, u: "d"}, coll.findOne({_id: 3}));
+
+    // Mongos needs the _id of a single-document update.
+    var isMongos = db.runCommand("ismaster").msg === "isdbgrid";
+    if (isMongos) {
+        return;
+    }
+
+    // The document is looked up through the unique index, including an element of an array.
+    explain = coll.explain().update({u: "c", version: 1}, {$inc: {version: 1}});
+    idHack = getPlanStage(explain.queryPlanner.winningPlan, "IDHACK");
+    assert.neq(null, idHack, tojson(explain));
+    res = assert.writeOK(coll.update({u: "c", version: 1}, {$inc: {version: 1}}));
+    assert.eq(1, res.nModified, tojson(res));
+    res = assert.writeOK(coll.update({u: "c", version: 1}, {$inc: {version: 1}}));
+    assert.eq(0, res.nMatched, tojson(res));
+    assert.eq(2, coll.findOne({_id: 2}).version);
+
+    // A null value matches documents without the field too, so the planner handles it.
+    explain = coll.explain().update({u: null, version: 1}, {$set: {x: 1}});
+    assert.eq(null, getPlanStage(explain.queryPlanner.winningPlan, "IDHACK"), tojson(explain));
+}());
@@ -0,0 +1,45 @@
+// Verify that a mongod servicing connections with the "workerPool" connection service model
+// handles many concurrent connections, including connections that are idle between requests.
+
+(function() {
+    'use strict';
+
+    var conn = MongoRunner.runMongod(
+        {setParameter: {connectionServiceModel: "workerPool", connectionServiceWorkerThreads: 2}});
+    assert.neq(null, conn, "mongod failed to start with the workerPool service model");
+
+    var res = conn.getDB("admin").runCommand({getParameter: 1, connectionServiceModel: 1});
+    assert.commandWorked(res);
+    assert.eq("workerPool", res.connectionServiceModel);
+
+    // Open more connections than there are worker threads and interleave their requests, so that
+    // every connection is parked and resumed several times.
+    var connections = [];
+    for (var i = 0; i < 20; i++) {
+        connections.push(new Mongo(conn.host));
+    }
+
+    for (var round = 0; round < 5; round++) {
+        connections.forEach(function(c, i) {
+            var coll = c.getDB("test").worker_pool;
+            assert.writeOK(coll.insert({conn: i, round: round}));
+            assert.eq(round + 1, coll.find({conn: i}).itcount());
+        });
+    }
+
+    // Exercise a request that keeps its worker busy while other connections are serviced.
+    var awaitShell = startParallelShell(function() {
+        db.getSiblingDB("test").runCommand({sleep: 1, secs: 2, w: false});
+    }, conn.port);
+    connections.forEach(function(c) {
+        assert.commandWorked(c.getDB("admin").runCommand({ping: 1}));
+    });
+    awaitShell();
+
+    assert.eq(100, conn.getDB("test").worker_pool.count());
+
+    MongoRunner.stopMongod(conn);
+
+    // An unknown service model is rejected at startup.
+    assert.eq(null, MongoRunner.runMongod({setParameter: {connectionServiceModel: "bogus"}}));
+})();
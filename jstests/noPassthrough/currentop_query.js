@@ -23,6 +23,8 @@
         // Force yield to occur on every PlanExecutor iteration.
         assert.commandWorked(
             testDB.adminCommand({setParameter: 1, internalQueryExecYieldIterations: 1}));
+        assert.commandWorked(testDB.adminCommand(
+            {setParameter: 1, internalQueryExecYieldOnlyWhenContended: false}));
 
         /**
          * Captures currentOp() for a given test command/operation and confirms that namespace,
@@ -0,0 +1,26 @@
+// Tests that the devnull storage engine adds the configured latency to writes and to syncs.
+(function() {
+    "use strict";
+
+    var mongo = MongoRunner.runMongod({
+        storageEngine: "devnull",
+        setParameter: {devnullWriteLatencyMicros: 20000, devnullSyncLatencyMicros: 50000}
+    });
+    var db = mongo.getDB("test");
+
+    // Each insert writes the document and its _id index key.
+    var start = new Date();
+    for (var i = 0; i < 10; i++) {
+        assert.writeOK(db.foo.insert({_id: i}));
+    }
+    assert.gte(new Date() - start, 10 * 2 * 20, "inserts were not slowed down");
+
+    start = new Date();
+    assert.writeOK(db.foo.insert({_id: 10}, {writeConcern: {fsync: true}}));
+    assert.gte(new Date() - start, 50, "the fsync write was not slowed down");
+
+    assert.commandWorked(db.adminCommand({setParameter: 1, devnullExponentialLatency: true}));
+    assert.writeOK(db.foo.insert({_id: 11}));
+
+    MongoRunner.stopMongod(mongo);
+}());
@@ -0,0 +1,91 @@
+// Verify that wire protocol compression is negotiated during the isMaster handshake and applied
+// to client, replication and mongos traffic.
+
+(function() {
+    'use strict';
+
+    function compressorStats(conn, name) {
+        var status = conn.getDB("admin").serverStatus();
+        assert.commandWorked(status);
+        return status.network.compression[name];
+    }
+
+    // The handshake returns the compressors both sides support, in the client's order.
+    var conn = MongoRunner.runMongod({networkMessageCompressors: "zlib,snappy"});
+    assert.neq(null, conn, "mongod failed to start with compression enabled");
+
+    var res =
+        conn.getDB("admin").runCommand({isMaster: 1, compression: ["lzma", "snappy", "zlib"]});
+    assert.commandWorked(res);
+    assert.eq(["snappy", "zlib"], res.compression);
+
+    res = conn.getDB("admin").runCommand({isMaster: 1});
+    assert.commandWorked(res);
+    assert(!res.hasOwnProperty("compression"), tojson(res));
+
+    // The shell offers snappy, so traffic on this connection is compressed.
+    var before = compressorStats(conn, "snappy");
+    var coll = conn.getDB("test").network_compression;
+    var doc = {payload: new Array(4096).join("x")};
+    for (var i = 0; i < 100; i++) {
+        assert.writeOK(coll.insert(doc));
+    }
+    assert.eq(100, coll.find().itcount());
+    var after = compressorStats(conn, "snappy");
+    assert.gt(after.decompressor.bytesOut, before.decompressor.bytesOut, tojson(after));
+    assert.gt(after.compressor.bytesIn, before.compressor.bytesIn, tojson(after));
+    assert.lt(after.decompressor.bytesIn - before.decompressor.bytesIn,
+              after.decompressor.bytesOut - before.decompressor.bytesOut,
+              tojson(after));
+    MongoRunner.stopMongod(conn);
+
+    // Compression can be turned off.
+    conn = MongoRunner.runMongod({networkMessageCompressors: "disabled"});
+    assert.neq(null, conn, "mongod failed to start with compression disabled");
+    res = conn.getDB("admin").runCommand({isMaster: 1, compression: ["snappy"]});
+    assert.commandWorked(res);
+    assert(!res.hasOwnProperty("compression"), tojson(res));
+    MongoRunner.stopMongod(conn);
+
+    // Unknown compressors are rejected at startup.
+    assert.eq(null, MongoRunner.runMongod({networkMessageCompressors: "snappy,lzma"}));
+
+    // Replication between members is compressed.
+    var rst = new ReplSetTest({nodes: 2, nodeOptions: {networkMessageCompressors: "snappy"}});
+    rst.startSet();
+    rst.initiate();
+    var primary = rst.getPrimary();
+    var secondary = rst.getSecondary();
+    var secondaryBefore = compressorStats(secondary, "snappy");
+    for (var i = 0; i < 100; i++) {
+        assert.writeOK(primary.getDB("test").repl.insert(doc));
+    }
+    rst.awaitReplication();
+    var secondaryAfter = compressorStats(secondary, "snappy");
+    assert.gt(secondaryAfter.decompressor.bytesOut,
+              secondaryBefore.decompressor.bytesOut + 100 * 4096,
+              tojson(secondaryAfter));
+    rst.stopSet();
+
+    // mongos negotiates compression with its clients and with the shards.
+    var st = new ShardingTest({
+        shards: 1,
+        other: {
+            mongosOptions: {networkMessageCompressors: "snappy"},
+            shardOptions: {networkMessageCompressors: "snappy"}
+        }
+    });
+    res = st.s.getDB("admin").runCommand({isMaster: 1, compression: ["snappy"]});
+    assert.commandWorked(res);
+    assert.eq(["snappy"], res.compression);
+
+    var shardBefore = compressorStats(st.shard0, "snappy");
+    for (var i = 0; i < 100; i++) {
+        assert.writeOK(st.s.getDB("test").sharded.insert(doc));
+    }
+    assert.eq(100, st.s.getDB("test").sharded.find().itcount());
+    var shardAfter = compressorStats(st.shard0, "snappy");
+    assert.gt(
+        shardAfter.decompressor.bytesOut, shardBefore.decompressor.bytesOut, tojson(shardAfter));
+    st.stop();
+})();
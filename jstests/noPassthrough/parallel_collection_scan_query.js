@@ -0,0 +1,70 @@
+// Verify that finds and aggregations whose only plan is a collection scan return the same results
+// when the scan is divided between worker threads by internalQueryExecParallelCollScanThreads.
+
+(function() {
+    'use strict';
+
+    var conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod failed to start");
+    var testDB = conn.getDB("test");
+
+    // Only WiredTiger can divide a collection into ranges of RecordIds.
+    if (testDB.serverStatus().storageEngine.name !== "wiredTiger") {
+        jsTest.log("Skipping test since the storage engine is not WiredTiger");
+        MongoRunner.stopMongod(conn);
+        return;
+    }
+
+    var coll = testDB.parallel_collscan;
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 20000; i++) {
+        bulk.insert({_id: i, a: i % 100, b: "x".repeat(i % 50)});
+    }
+    assert.writeOK(bulk.execute());
+
+    function runQueries() {
+        return {
+            count: coll.find({a: {$lt: 10}}).itcount(),
+            ids: coll.find({a: 42}, {_id: 1}).sort({_id: 1}).toArray(),
+            groups: coll.aggregate([
+                            {$match: {a: {$gte: 90}}},
+                            {$group: {_id: "$a", n: {$sum: 1}}},
+                            {$sort: {_id: 1}}
+                        ])
+                        .toArray(),
+        };
+    }
+
+    var serial = runQueries();
+    assert.eq(2000, serial.count);
+
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, internalQueryExecParallelCollScanThreads: 4}));
+
+    var explain = coll.find({a: {$lt: 10}}).explain("executionStats");
+    var stage = explain.executionStats.executionStages;
+    assert.eq("PARALLEL_COLLSCAN", stage.stage, tojson(explain));
+    assert.eq(4, stage.workers, tojson(explain));
+    assert.eq(20000, stage.docsExamined, tojson(explain));
+    assert.eq(2000, stage.nReturned, tojson(explain));
+
+    assert.eq(serial, runQueries());
+
+    // Scans that depend on natural order stay serial.
+    explain = coll.find({a: 1}).hint({$natural: 1}).explain();
+    assert.eq("COLLSCAN", explain.queryPlanner.winningPlan.stage, tojson(explain));
+
+    // $where filters cannot be evaluated concurrently.
+    explain = coll.find({$where: "this.a == 1"}).explain();
+    assert.eq("COLLSCAN", explain.queryPlanner.winningPlan.stage, tojson(explain));
+
+    // Dropping the collection while a parallel scan is open kills the cursor.
+    var cursor = coll.find().batchSize(2);
+    assert(cursor.hasNext());
+    coll.drop();
+    assert.throws(function() {
+        cursor.itcount();
+    });
+
+    MongoRunner.stopMongod(conn);
+})();
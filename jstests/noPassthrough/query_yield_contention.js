@@ -0,0 +1,40 @@
+// Tests that queries skip the yields which are due while no other operation waits for a lock or a
+// ticket, and that explain reports the yields performed and skipped.
+(function() {
+    'use strict';
+
+    var mongod = MongoRunner.runMongod({
+        setParameter: {
+            internalQueryExecYieldIterations: 10,
+            internalQueryExecUncontendedYieldPeriodMS: 60 * 60 * 1000
+        }
+    });
+    assert.neq(null, mongod, 'mongod was unable to start up');
+
+    var db = mongod.getDB('test');
+    var coll = db.query_yield_contention;
+    coll.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 200; i++) {
+        bulk.insert({_id: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    // Nothing else runs, so every yield which is due is skipped.
+    var explain = coll.find().explain('executionStats');
+    var yieldStats = explain.executionStats.yieldStats;
+    assert.eq(0, yieldStats.numYields, tojson(explain));
+    assert.gt(yieldStats.numSkippedYields, 200 / 10 / 2, tojson(explain));
+    assert.eq(0, yieldStats.yieldTimeMicros, tojson(explain));
+
+    // Without contention-aware yielding, the query yields every 10 work cycles.
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryExecYieldOnlyWhenContended: false}));
+    explain = coll.find().explain('executionStats');
+    yieldStats = explain.executionStats.yieldStats;
+    assert.gt(yieldStats.numYields, 200 / 10 / 2, tojson(explain));
+    assert.eq(0, yieldStats.numSkippedYields, tojson(explain));
+
+    MongoRunner.stopMongod(mongod);
+})();
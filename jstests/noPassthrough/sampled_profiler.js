@@ -0,0 +1,52 @@
+// Tests that the sampled profiler records sampled operations without writing to system.profile,
+// that $sampledProfile returns them, and that they are written to system.profile on request.
+
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod failed to start");
+    var testDB = conn.getDB("sampled_profiler");
+    var coll = testDB.coll;
+    assert.writeOK(coll.insert({a: 1}));
+
+    function getSampled() {
+        return coll.aggregate([{$sampledProfile: {}}]).toArray();
+    }
+
+    assert.eq(0, getSampled().length);
+
+    // Sample every operation.
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, sampledProfilerSampleRate: 1}));
+    for (var i = 0; i < 5; i++) {
+        assert.eq(1, coll.find({a: 1}).itcount());
+    }
+    assert.commandWorked(testDB.adminCommand({setParameter: 1, sampledProfilerSampleRate: 0}));
+
+    var sampled = getSampled();
+    var finds = sampled.filter(function(doc) {
+        return doc.op == "query" && doc.ns == coll.getFullName();
+    });
+    assert.gte(finds.length, 5, tojson(sampled));
+    assert.eq(0, testDB.system.profile.find().itcount());
+
+    assert.commandWorked(testDB.dropDatabase());
+    assert.writeOK(coll.insert({a: 1}));
+
+    // Sample each query shape at most once per minute, and write the samples to system.profile.
+    assert.commandWorked(testDB.createCollection("system.profile", {capped: true, size: 1 << 20}));
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, sampledProfilerWriteToCollection: true}));
+    assert.commandWorked(
+        testDB.adminCommand({setParameter: 1, sampledProfilerShapeIntervalMillis: 60 * 1000}));
+    for (var i = 0; i < 5; i++) {
+        assert.eq(1, coll.find({a: i + 1}).itcount());
+    }
+
+    assert.soon(function() {
+        return testDB.system.profile.find({ns: coll.getFullName(), op: "query"}).itcount() > 0;
+    });
+    assert.eq(1, testDB.system.profile.find({ns: coll.getFullName(), op: "query"}).itcount());
+
+    MongoRunner.stopMongod(conn);
+}());
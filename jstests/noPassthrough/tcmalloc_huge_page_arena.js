@@ -0,0 +1,29 @@
+// Tests that with tcmallocHugePageArena=transparent the growth of the tcmalloc heap is served by
+// the huge page arena and reported in serverStatus.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({setParameter: "tcmallocHugePageArena=transparent"});
+    if (!conn) {
+        // The arena is only available on Linux builds which use tcmalloc.
+        jsTest.log("skipping test since mongod failed to start with the huge page arena");
+        return;
+    }
+
+    var arena = conn.getDB("admin").serverStatus().tcmalloc.huge_page_arena;
+    assert.eq("transparent", arena.mode, tojson(arena));
+    assert.eq(2 * 1024 * 1024, arena.page_size_bytes, tojson(arena));
+
+    // Grow the heap with a few large documents.
+    var coll = conn.getDB("test").tcmalloc_huge_page_arena;
+    var str = "x".repeat(1024 * 1024);
+    for (var i = 0; i < 32; i++) {
+        assert.writeOK(coll.insert({_id: i, str: str}));
+    }
+
+    arena = conn.getDB("admin").serverStatus().tcmalloc.huge_page_arena;
+    assert.gt(arena.mapped_bytes, 0, tojson(arena));
+    assert.gt(arena.mappings, 0, tojson(arena));
+
+    MongoRunner.stopMongod(conn);
+}());
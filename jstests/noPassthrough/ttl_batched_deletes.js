@@ -0,0 +1,69 @@
+// Tests that the TTL monitor deletes expired documents in batches of at most ttlMonitorBatchSize,
+// works on several collections at once, honors ttlMonitorDeletesPerSecond, and reports its
+// progress through each TTL index in the "ttlIndexes" section of serverStatus.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({
+        setParameter: {ttlMonitorSleepSecs: 1, ttlMonitorBatchSize: 10, ttlMonitorParallelism: 2}
+    });
+    assert.neq(null, conn, "mongod failed to start");
+    var db = conn.getDB("test");
+
+    var past = new Date(new Date().getTime() - 3600 * 1000);
+    function insertExpired(coll, n) {
+        var bulk = coll.initializeUnorderedBulkOp();
+        for (var i = 0; i < n; i++) {
+            bulk.insert({x: past, i: i});
+        }
+        assert.writeOK(bulk.execute());
+    }
+
+    var colls = [db.ttl_batched_deletes_a, db.ttl_batched_deletes_b, db.ttl_batched_deletes_c];
+    colls.forEach(function(coll) {
+        coll.drop();
+        insertExpired(coll, 100);
+        // A document which isn't expired yet.
+        assert.writeOK(coll.insert({x: new Date(new Date().getTime() + 3600 * 1000)}));
+    });
+
+    var batchesBefore = db.serverStatus().metrics.ttl.deleteBatches;
+    colls.forEach(function(coll) {
+        assert.commandWorked(coll.createIndex({x: 1}, {expireAfterSeconds: 60}));
+    });
+    colls.forEach(function(coll) {
+        assert.soon(function() {
+            return coll.count() == 1;
+        }, "TTL monitor didn't delete the expired documents of " + coll.getFullName());
+    });
+
+    var status = db.serverStatus({ttlIndexes: 1});
+    assert.gte(status.metrics.ttl.deleteBatches - batchesBefore, 30, tojson(status.metrics.ttl));
+    colls.forEach(function(coll) {
+        var stats = status.ttlIndexes[coll.getFullName()].x_1;
+        assert.eq(100, stats.deletedDocuments, tojson(stats));
+        assert.gte(stats.batches, 10, tojson(stats));
+        assert.gte(stats.passes, 1, tojson(stats));
+    });
+
+    // With a limit of 20 deletes per second, deleting 60 documents takes at least 2 seconds.
+    assert.commandWorked(db.adminCommand({setParameter: 1, ttlMonitorDeletesPerSecond: 20}));
+    var coll = colls[0];
+    insertExpired(coll, 60);
+    var start = new Date();
+    assert.soon(function() {
+        return coll.count() == 1;
+    }, "TTL monitor didn't delete the expired documents under a rate limit");
+    assert.gte(new Date() - start, 2000);
+
+    // Dropped TTL indexes are no longer reported once a pass has gone by.
+    assert.commandWorked(colls[1].dropIndex({x: 1}));
+    var passes = db.serverStatus().metrics.ttl.passes;
+    assert.soon(function() {
+        return db.serverStatus().metrics.ttl.passes >= passes + 2;
+    }, "TTL monitor didn't run before timing out.");
+    status = db.serverStatus({ttlIndexes: 1});
+    assert(!status.ttlIndexes.hasOwnProperty(colls[1].getFullName()), tojson(status.ttlIndexes));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -20,9 +20,13 @@
     const nDocsToInsert = 300;
     const worksPerYield = 50;
 
-    // Start a mongod that will yield every 50 work cycles.
+    // Start a mongod that will yield every 50 work cycles, even though no other operation waits
+    // for its locks.
     var mongod = MongoRunner.runMongod({
-        setParameter: `internalQueryExecYieldIterations=${worksPerYield}`,
+        setParameter: {
+            internalQueryExecYieldIterations: worksPerYield,
+            internalQueryExecYieldOnlyWhenContended: false
+        },
         profile: 2,
     });
     assert.neq(null, mongod, 'mongod was unable to start up');
@@ -0,0 +1,39 @@
+// Tests that the time an operation spends waiting for its write concern is reported as wait
+// events in the profiler and in the server status.
+
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod failed to start");
+    var testDB = conn.getDB("wait_events");
+    var coll = testDB.coll;
+
+    function getGlobalJournalFlushes() {
+        var waitEvents = testDB.serverStatus().metrics.waitEvents;
+        assert(waitEvents.hasOwnProperty("ticketAcquisition"), tojson(waitEvents));
+        return waitEvents.journalFlush.count;
+    }
+
+    var flushesBefore = getGlobalJournalFlushes();
+
+    assert.commandWorked(testDB.setProfilingLevel(2));
+    assert.writeOK(coll.insert({_id: 1}, {writeConcern: {j: true}}));
+    assert.writeOK(coll.insert({_id: 2}));
+    assert.commandWorked(testDB.setProfilingLevel(0));
+
+    var journaled = testDB.system.profile.findOne({op: "insert", "query.documents._id": 1});
+    assert.neq(null, journaled);
+    assert.eq(1, journaled.waitEvents.journalFlush.count, tojson(journaled));
+    assert.gte(journaled.waitEvents.journalFlush.timeMicros, 0, tojson(journaled));
+
+    var unjournaled = testDB.system.profile.findOne({op: "insert", "query.documents._id": 2});
+    assert.neq(null, unjournaled);
+    assert(!unjournaled.hasOwnProperty("waitEvents") ||
+               !unjournaled.waitEvents.hasOwnProperty("journalFlush"),
+           tojson(unjournaled));
+
+    assert.gt(getGlobalJournalFlushes(), flushesBefore);
+
+    MongoRunner.stopMongod(conn);
+}());
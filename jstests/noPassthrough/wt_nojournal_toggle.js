@@ -11,6 +11,11 @@
         return;
     }
 
+    // Naming the section makes serverStatus read the statistics afresh.
+    function getNumLogWrites(testDB) {
+        return testDB.serverStatus({wiredTiger: 1}).wiredTiger.log['log write operations'];
+    }
+
     // Returns a function that primarily executes unjournaled inserts, but periodically does a
     // journaled insert. If 'checkpoint' is true, then the fsync command is run to create a
     // checkpoint prior to the mongod being terminated.
@@ -83,10 +88,10 @@
                    testDB.nojournal.count({journaled: {$exists: true}}),
                    'journaled write operations since the last checkpoint were not replayed');
 
-        var initialNumLogWrites = testDB.serverStatus().wiredTiger.log['log write operations'];
+        var initialNumLogWrites = getNumLogWrites(testDB);
         assert.writeOK(testDB.nojournal.insert({a: 1}, {writeConcern: {fsync: true}}));
         assert.eq(initialNumLogWrites,
-                  testDB.serverStatus().wiredTiger.log['log write operations'],
+                  getNumLogWrites(testDB),
                   'journaling is still enabled even though --nojournal was specified');
 
         MongoRunner.stopMongod(conn);
@@ -101,11 +106,11 @@
 
         // Change the database object to connect to the restarted mongod.
         testDB = conn.getDB('test');
-        initialNumLogWrites = testDB.serverStatus().wiredTiger.log['log write operations'];
+        initialNumLogWrites = getNumLogWrites(testDB);
 
         assert.writeOK(testDB.nojournal.insert({a: 1}, {writeConcern: {fsync: true}}));
         assert.lt(initialNumLogWrites,
-                  testDB.serverStatus().wiredTiger.log['log write operations'],
+                  getNumLogWrites(testDB),
                   'journaling is still disabled even though --journal was specified');
 
         MongoRunner.stopMongod(conn);
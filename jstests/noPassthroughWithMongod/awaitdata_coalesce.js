@@ -0,0 +1,36 @@
+// Tests that an awaitData getMore woken by an insert waits out the coalescing window and returns
+// the inserts made during it in the same batch.
+(function() {
+    "use strict";
+
+    var collName = "awaitdata_coalesce";
+    var coll = db[collName];
+    coll.drop();
+    assert.commandWorked(db.createCollection(collName, {capped: true, size: 1024 * 1024}));
+    assert.writeOK(coll.insert({_id: 0}));
+
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryAwaitDataCoalesceMicros: 2 * 1000 * 1000}));
+
+    var cmdRes = db.runCommand({find: collName, awaitData: true, tailable: true});
+    assert.commandWorked(cmdRes);
+    assert.eq(1, cmdRes.cursor.firstBatch.length, tojson(cmdRes));
+    var cursorId = cmdRes.cursor.id;
+
+    var awaitShell = startParallelShell(function() {
+        sleep(500);
+        for (var i = 1; i <= 5; i++) {
+            assert.writeOK(db.awaitdata_coalesce.insert({_id: i}));
+            sleep(50);
+        }
+    });
+
+    cmdRes = db.runCommand({getMore: cursorId, collection: collName, maxTimeMS: 30 * 1000});
+    assert.commandWorked(cmdRes);
+    assert.eq(5, cmdRes.cursor.nextBatch.length, tojson(cmdRes));
+    awaitShell();
+
+    assert.commandWorked(
+        db.adminCommand({setParameter: 1, internalQueryAwaitDataCoalesceMicros: 0}));
+    assert.commandWorked(db.runCommand({killCursors: collName, cursors: [cursorId]}));
+}());
@@ -0,0 +1,75 @@
+// Tests the "opsPerSecond" option, latency percentiles, and the aggregate, findAndModify and
+// "bulkSize" ops of benchRun().
+(function() {
+    "use strict";
+
+    var coll = db.bench_test_open_loop;
+    coll.drop();
+
+    function executeBenchRun(benchOps, extraArgs) {
+        var benchArgs = {ops: benchOps, parallel: 2, seconds: 2, host: db.getMongo().host};
+        if (jsTest.options().auth) {
+            benchArgs['db'] = 'admin';
+            benchArgs['username'] = jsTest.options().adminUser;
+            benchArgs['password'] = jsTest.options().adminPassword;
+        }
+        Object.extend(benchArgs, extraArgs || {});
+        return benchRun(benchArgs);
+    }
+
+    // Each insert statement counts once, however many documents a bulk of them carries.
+    var res = executeBenchRun([{
+        ns: coll.getFullName(),
+        op: "insert",
+        doc: {x: {"#RAND_INT": [0, 100]}},
+        bulkSize: 10,
+        writeCmd: true
+    }]);
+    assert.gt(res.insert, 0, tojson(res));
+    assert.eq(coll.count() % 10, 0);
+    var latencies = res.latencyMicros.insert;
+    assert.gt(latencies.count, 0, tojson(res));
+    assert.lte(latencies.p50, latencies.p99, tojson(res));
+    assert.lte(latencies.p99, latencies.p999, tojson(res));
+    assert.lte(latencies.p999, latencies.max, tojson(res));
+
+    // "bulkSize" needs write commands.
+    assert.throws(function() {
+        executeBenchRun(
+            [{ns: coll.getFullName(), op: "insert", doc: {}, bulkSize: 10, writeCmd: false}]);
+    });
+
+    res = executeBenchRun([
+        {
+          ns: coll.getFullName(),
+          op: "aggregate",
+          pipeline: [{$match: {x: {$lt: 50}}}, {$group: {_id: "$x", n: {$sum: 1}}}],
+          batchSize: NumberInt(10)
+        },
+        {
+          ns: coll.getFullName(),
+          op: "findAndModify",
+          query: {x: {"#RAND_INT": [0, 100]}},
+          update: {$inc: {y: 1}},
+          sort: {_id: 1}
+        }
+    ]);
+    assert.gt(res.aggregate, 0, tojson(res));
+    assert.gt(res.findAndModify, 0, tojson(res));
+    assert.gt(res.latencyMicros.aggregate.count, 0, tojson(res));
+    assert.gt(res.latencyMicros.findAndModify.count, 0, tojson(res));
+    assert.gt(coll.count({y: {$gt: 0}}), 0);
+
+    // findAndModify needs exactly one of "update" and "remove".
+    assert.throws(function() {
+        executeBenchRun([{ns: coll.getFullName(), op: "findAndModify", query: {}}]);
+    });
+
+    // With a target rate, the workers issue no more than that many ops per second.
+    res = executeBenchRun([{ns: coll.getFullName(), op: "findOne", query: {}}],
+                          {opsPerSecond: 50});
+    assert.gt(res.findOne, 0, tojson(res));
+    assert.lte(res.findOne, 50 * 1.2, tojson(res));
+    assert.eq(res["targetOps/s"], 50, tojson(res));
+    assert.gt(res.scheduleLagMicros.count, 0, tojson(res));
+})();
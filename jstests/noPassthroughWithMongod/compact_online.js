@@ -0,0 +1,29 @@
+// Tests that an online compact runs under intent locks, reports the bytes it freed, and is
+// refused by storage engines which don't compact in place.
+(function() {
+    "use strict";
+
+    var coll = db.compact_online;
+    coll.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, a: i, s: new Array(1024).join("x")});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.writeOK(coll.remove({_id: {$lt: 900}}));
+
+    var res = db.runCommand({compact: coll.getName(), online: true});
+    if (db.serverStatus().storageEngine.name != "wiredTiger") {
+        assert.commandFailedWithCode(res, ErrorCodes.CommandNotSupported);
+        return;
+    }
+    assert.commandWorked(res);
+    assert(res.hasOwnProperty("bytesFreed"), tojson(res));
+
+    // The collection stays readable and writable after compacting.
+    assert.eq(100, coll.find().itcount());
+    assert.writeOK(coll.insert({_id: 1000, a: 1000}));
+    assert.eq(101, coll.find({a: {$gte: 0}}).hint({a: 1}).itcount());
+}());
@@ -0,0 +1,47 @@
+// Tests that compressionAdvisor estimates the compression of a collection's documents and
+// recommends zlib for repetitive data and no compression for random data.
+(function() {
+    "use strict";
+
+    var coll = db.compression_advisor;
+    coll.drop();
+
+    assert.commandFailed(db.runCommand({compressionAdvisor: coll.getName()}));
+
+    var line = "2016-11-02T10:00:00.000+0000 I NETWORK  [conn42] end connection 127.0.0.1:51000";
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 500; i++) {
+        bulk.insert({_id: i, msg: line, level: "info", n: i % 10});
+    }
+    assert.writeOK(bulk.execute());
+
+    var res = db.runCommand({compressionAdvisor: coll.getName(), sampleSize: 200});
+    assert.commandWorked(res);
+    assert.eq(200, res.sampledDocuments, tojson(res));
+    assert.gt(res.sampledBytes, 0, tojson(res));
+    ["snappy", "zlib"].forEach(function(name) {
+        assert.gt(res.compressors[name].ratio, 1, tojson(res));
+        assert.gte(res.compressors[name].decompressMicros, 0, tojson(res));
+    });
+    assert.eq(res.recommended, "zlib", tojson(res));
+    assert.eq("block_compressor=zlib", res.storageEngine.wiredTiger.configString, tojson(res));
+
+    // Random bytes don't compress at all.
+    var random = db.compression_advisor_random;
+    random.drop();
+    for (var i = 0; i < 100; i++) {
+        var hex = "";
+        for (var j = 0; j < 512; j++) {
+            hex += Math.floor(Math.random() * 16).toString(16);
+        }
+        assert.writeOK(random.insert({_id: i, b: HexData(0, hex)}));
+    }
+    res = db.runCommand({compressionAdvisor: random.getName()});
+    assert.commandWorked(res);
+    assert.eq("none", res.recommended, tojson(res));
+
+    assert.commandFailedWithCode(
+        db.runCommand({compressionAdvisor: coll.getName(), sampleSize: 0}), ErrorCodes.BadValue);
+    assert.commandFailedWithCode(
+        db.runCommand({compressionAdvisor: coll.getName(), blockSize: 1}), ErrorCodes.BadValue);
+}());
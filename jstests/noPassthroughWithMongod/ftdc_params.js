@@ -21,6 +21,9 @@
     assert.eq(getparam("diagnosticDataCollectionFileSizeMB"), 10);
     assert.eq(getparam("diagnosticDataCollectionSamplesPerChunk"), 300);
     assert.eq(getparam("diagnosticDataCollectionSamplesPerInterimUpdate"), 10);
+    assert.eq(getparam("diagnosticDataCollectionHighResolutionEnabled"), false);
+    assert.eq(getparam("diagnosticDataCollectionHighResolutionPeriodMillis"), 100);
+    assert.eq(getparam("diagnosticDataCollectionHighResolutionDirectorySizeMB"), 20);
 
     function setparam(obj) {
         var ret = admin.runCommand(Object.extend({setParameter: 1}, obj));
@@ -49,7 +52,17 @@
     assert.commandWorked(setparam({"diagnosticDataCollectionFileSizeMB": 50}));
     assert.commandFailed(setparam({"diagnosticDataCollectionDirectorySizeMB": 10}));
 
+    // High resolution collection
+    assert.commandWorked(setparam({"diagnosticDataCollectionHighResolutionEnabled": 1}));
+    assert.commandWorked(setparam({"diagnosticDataCollectionHighResolutionPeriodMillis": 10}));
+    assert.commandWorked(setparam({"diagnosticDataCollectionHighResolutionDirectorySizeMB": 2}));
+    assert.commandFailed(setparam({"diagnosticDataCollectionHighResolutionPeriodMillis": 1}));
+    assert.commandFailed(setparam({"diagnosticDataCollectionHighResolutionDirectorySizeMB": 1}));
+
     // Reset
+    assert.commandWorked(setparam({"diagnosticDataCollectionHighResolutionEnabled": 0}));
+    assert.commandWorked(setparam({"diagnosticDataCollectionHighResolutionPeriodMillis": 100}));
+    assert.commandWorked(setparam({"diagnosticDataCollectionHighResolutionDirectorySizeMB": 20}));
     assert.commandWorked(setparam({"diagnosticDataCollectionFileSizeMB": 10}));
     assert.commandWorked(setparam({"diagnosticDataCollectionDirectorySizeMB": 100}));
     assert.commandWorked(setparam({"diagnosticDataCollectionPeriodMillis": 1000}));
@@ -0,0 +1,74 @@
+// Tests the usage profile $indexStats reports for each index and the recommendations of the
+// $indexAdvisor stage built on it.
+(function() {
+    "use strict";
+
+    var coll = db.index_advisor;
+    coll.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 100; i++) {
+        bulk.insert({_id: i, a: i % 10, b: i, c: i % 3, d: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+    assert.commandWorked(coll.createIndex({a: 1, b: 1}));
+    assert.commandWorked(coll.createIndex({c: 1}));
+    assert.commandWorked(coll.createIndex({e: 1}));
+    assert.commandWorked(coll.createIndex({f: 1}, {unique: true, sparse: true}));
+
+    function getIndexStats(indexName) {
+        var stats = coll.aggregate([{$indexStats: {}}]).toArray().filter(function(doc) {
+            return doc.name == indexName;
+        });
+        assert.eq(1, stats.length, indexName);
+        return stats[0];
+    }
+
+    // Covered and fetching queries over point and range bounds.
+    assert.eq(10, coll.find({a: 3}, {_id: 0, a: 1}).hint({a: 1}).itcount());
+    assert.eq(10, coll.find({a: 3}).hint({a: 1}).itcount());
+    assert.eq(20, coll.find({a: {$gte: 8}}).hint({a: 1}).itcount());
+
+    var accesses = getIndexStats("a_1").accesses;
+    assert.eq(3, accesses.ops, tojson(accesses));
+    assert.eq(1, accesses.covering, tojson(accesses));
+    assert.eq(2, accesses.boundsShapes.length, tojson(accesses));
+    assert.contains({shape: {a: "point"}, ops: 2}, accesses.boundsShapes, tojson(accesses));
+    assert.contains({shape: {a: "range"}, ops: 1}, accesses.boundsShapes, tojson(accesses));
+
+    // The candidate plans of this query shape put it in the plan cache, though no index starts
+    // with its equality field "c" and then its sort field "d". An index on "a" and "b" serves the
+    // second one.
+    assert.eq(33, coll.find({c: 1, a: {$gte: 0}, b: {$gte: 0}}).sort({d: 1}).itcount());
+    assert.eq(20, coll.find({a: {$lt: 2}, b: {$gte: 0}}).itcount());
+
+    var recommendations = coll.aggregate([{$indexAdvisor: {}}]).toArray();
+    function findRecommendations(action, field, value) {
+        return recommendations.filter(function(doc) {
+            return doc.action == action && friendlyEqual(doc[field], value);
+        });
+    }
+
+    // "a_1" is a prefix of "a_1_b_1".
+    var drops = findRecommendations("drop", "index", "a_1");
+    assert.eq(1, drops.length, tojson(recommendations));
+    assert.eq("prefix", drops[0].reason, tojson(recommendations));
+    assert.eq("a_1_b_1", drops[0].prefixOf, tojson(recommendations));
+
+    // "e_1" has not been used at all. Unique indexes are never dropped.
+    drops = findRecommendations("drop", "index", "e_1");
+    assert.eq(1, drops.length, tojson(recommendations));
+    assert.eq("unused", drops[0].reason, tojson(recommendations));
+    assert.eq(0, findRecommendations("drop", "index", "f_1").length, tojson(recommendations));
+    assert.eq(0, findRecommendations("drop", "index", "_id_").length, tojson(recommendations));
+
+    var creates = findRecommendations("create", "key", {c: 1, d: 1, a: 1, b: 1});
+    assert.eq(1, creates.length, tojson(recommendations));
+    assert.eq("queryShape", creates[0].reason, tojson(recommendations));
+    assert.eq(
+        0, findRecommendations("create", "key", {a: 1, b: 1}).length, tojson(recommendations));
+
+    assert.commandFailedWithCode(
+        db.runCommand({aggregate: coll.getName(), pipeline: [{$indexAdvisor: {x: 1}}]}), 40222);
+}());
@@ -0,0 +1,48 @@
+// Tests that the logOperationsAsJSON server parameter logs slow operations as JSON objects with the
+// fields of their profiler entries, and that commands are still redacted.
+(function() {
+    "use strict";
+
+    var coll = db.log_operations_as_json;
+    coll.drop();
+    assert.writeOK(coll.insert({_id: 1, a: 1}));
+
+    // Finds the logged operations whose text contains every string of 'markers' and parses them.
+    function findLoggedOps(markers) {
+        var log = assert.commandWorked(db.adminCommand({getLog: "global"})).log;
+        return log.filter(function(line) {
+            return markers.every(function(marker) {
+                return line.indexOf(marker) >= 0;
+            });
+        }).map(function(line) {
+            return JSON.parse(line.substring(line.indexOf("{")));
+        });
+    }
+
+    assert.commandWorked(db.adminCommand({setParameter: 1, logOperationsAsJSON: true}));
+    var originalProfiling = db.getProfilingStatus();
+    try {
+        // Have every operation count as slow.
+        db.setProfilingLevel(0, -1);
+
+        assert.eq(1, coll.find({a: 1}).comment("log_operations_as_json_find").itcount());
+        var ops = findLoggedOps(["log_operations_as_json_find"]);
+        assert.eq(1, ops.length, tojson(ops));
+        assert.eq(coll.getFullName(), ops[0].ns, tojson(ops));
+        assert.eq("COLLSCAN", ops[0].planSummary, tojson(ops));
+        assert.eq(1, ops[0].docsExamined, tojson(ops));
+        assert(ops[0].hasOwnProperty("millis"), tojson(ops));
+        assert(ops[0].hasOwnProperty("locks"), tojson(ops));
+
+        db.createUser({user: "log_operations_as_json", pwd: "secretpassword", roles: []});
+        ops = findLoggedOps(["createUser", "log_operations_as_json"]);
+        assert.neq(0, ops.length);
+        ops.forEach(function(op) {
+            assert.eq(-1, tojson(op).indexOf("secretpassword"), tojson(op));
+        });
+        db.dropUser("log_operations_as_json");
+    } finally {
+        db.setProfilingLevel(originalProfiling.was, originalProfiling.slowms);
+        assert.commandWorked(db.adminCommand({setParameter: 1, logOperationsAsJSON: false}));
+    }
+}());
@@ -0,0 +1,77 @@
+// Tests that a mapReduce over a whole collection returns the same results and counts when its map
+// phase runs on several threads.
+(function() {
+    "use strict";
+
+    var coll = db.mr_parallel_map;
+    coll.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 5000; i++) {
+        bulk.insert({_id: i, a: i % 37, b: i % 5, s: "x" + (i % 11)});
+    }
+    assert.writeOK(bulk.execute());
+
+    function map() {
+        emit(this.a, {count: 1, b: this.b});
+        emit(this.s, this.b);
+    }
+
+    function reduce(key, values) {
+        if (typeof(values[0]) === "object") {
+            var res = {count: 0, b: 0};
+            values.forEach(function(v) {
+                res.count += v.count;
+                res.b += v.b;
+            });
+            return res;
+        }
+        return Array.sum(values);
+    }
+
+    function getParam() {
+        var res = db.adminCommand({getParameter: 1, internalMapReduceMapThreads: 1});
+        assert.commandWorked(res);
+        return res.internalMapReduceMapThreads;
+    }
+
+    function setParam(value) {
+        assert.commandWorked(
+            db.adminCommand({setParameter: 1, internalMapReduceMapThreads: value}));
+    }
+
+    function sortById(docs) {
+        return docs.sort(function(x, y) {
+            return tojson(x._id) < tojson(y._id) ? -1 : 1;
+        });
+    }
+
+    function runMapReduce(out) {
+        var res = db.runCommand({mapReduce: coll.getName(), map: map, reduce: reduce, out: out});
+        assert.commandWorked(res);
+        assert.eq(5000, res.counts.input, tojson(res));
+        assert.eq(10000, res.counts.emit, tojson(res));
+        var results = out.inline ? res.results : db[res.result].find().toArray();
+        return sortById(results);
+    }
+
+    var original = getParam();
+    try {
+        setParam(1);
+        var expectedInline = runMapReduce({inline: 1});
+        var expectedReplace = runMapReduce({replace: "mr_parallel_map_out"});
+        assert.eq(48, expectedInline.length);
+
+        setParam(4);
+        assert.eq(expectedInline, runMapReduce({inline: 1}));
+        assert.eq(expectedReplace, runMapReduce({replace: "mr_parallel_map_out"}));
+
+        // Queries, sorts and limits keep the map phase on the command's own thread.
+        var res = db.runCommand(
+            {mapReduce: coll.getName(), map: map, reduce: reduce, out: {inline: 1}, limit: 10});
+        assert.commandWorked(res);
+        assert.eq(10, res.counts.input, tojson(res));
+    } finally {
+        setParam(original);
+    }
+}());
@@ -50,6 +50,29 @@ function test(t) {
     cursor = t.find({ts: {$gte: makeTS(20)}, _id: 25}).addOption(DBQuery.Option.oplogReplay);
     assert.eq(25, cursor.next()["_id"]);
     assert(!cursor.hasNext());
+
+    // A reverse scan starts at the newest entry within a $lt or $lte over 'ts'.
+    cursor = t.find({ts: {$lte: makeTS(20)}})
+                 .sort({$natural: -1})
+                 .addOption(DBQuery.Option.oplogReplay);
+    assert.eq(20, cursor.next()["_id"]);
+    assert.eq(19, cursor.next()["_id"]);
+
+    cursor = t.find({ts: {$lt: makeTS(20)}, _id: {$lt: 10}})
+                 .sort({$natural: -1})
+                 .addOption(DBQuery.Option.oplogReplay);
+    assert.eq(9, cursor.next()["_id"]);
+
+    assert.eq(0,
+              t.find({ts: {$lt: makeTS(0)}})
+                  .sort({$natural: -1})
+                  .addOption(DBQuery.Option.oplogReplay)
+                  .itcount());
+
+    // Without such a predicate the entries still come back in reverse order.
+    cursor = t.find({ts: {$gt: makeTS(20)}}).sort({$natural: -1}).addOption(
+        DBQuery.Option.oplogReplay);
+    assert.eq(99, cursor.next()["_id"]);
 }
 
 // test on non-oplog
@@ -0,0 +1,53 @@
+// Tests that the samplingProfiler command samples the stacks of running commands and reports them
+// in folded form, tagged by command name.
+(function() {
+    "use strict";
+
+    var admin = db.getSiblingDB("admin");
+    var coll = db.sampling_profiler;
+    coll.drop();
+
+    assert.commandFailedWithCode(admin.runCommand({samplingProfiler: "bogus"}),
+                                 ErrorCodes.BadValue);
+    assert.commandFailedWithCode(admin.runCommand({samplingProfiler: "start", samplesPerSecond: 0}),
+                                 ErrorCodes.BadValue);
+
+    assert.commandWorked(admin.runCommand({samplingProfiler: "reset"}));
+    var res = admin.runCommand({samplingProfiler: "start", samplesPerSecond: 200});
+    if (res.code == ErrorCodes.CommandNotSupported) {
+        jsTestLog("The sampling profiler isn't supported on this platform");
+        return;
+    }
+    assert.commandWorked(res);
+    assert.commandFailedWithCode(admin.runCommand({samplingProfiler: "start"}),
+                                 ErrorCodes.ConflictingOperationInProgress);
+
+    try {
+        // Keep the server busy with a command whose work is all on the CPU.
+        var bulk = coll.initializeUnorderedBulkOp();
+        for (var i = 0; i < 1000; i++) {
+            bulk.insert({_id: i, x: i});
+        }
+        assert.writeOK(bulk.execute());
+        for (var j = 0; j < 200; j++) {
+            coll.aggregate([{$group: {_id: {$mod: ["$x", 7]}, n: {$sum: {$multiply: ["$x", 2]}}}}])
+                .toArray();
+        }
+    } finally {
+        assert.commandWorked(admin.runCommand({samplingProfiler: "stop"}));
+    }
+
+    var report = admin.runCommand({samplingProfiler: "report", limit: 1000});
+    assert.commandWorked(report);
+    assert.eq(false, report.running, tojson(report));
+    assert.eq(200, report.samplesPerSecond, tojson(report));
+    assert.gt(report.samples, 0, tojson(report));
+    assert.gt(report.stacks.length, 0, tojson(report));
+    var sawAggregate = report.stacks.some(function(stack) {
+        assert.gt(stack.samples, 0, tojson(stack));
+        return stack.stack.indexOf("aggregate;") == 0;
+    });
+    assert(sawAggregate, tojson(report));
+
+    assert.lte(admin.runCommand({samplingProfiler: "report", limit: 1}).stacks.length, 1);
+}());
@@ -0,0 +1,42 @@
+// Tests that validate with background: true checks a collection under an intent lock on storage
+// engines with document-level locking, and is refused on the others.
+(function() {
+    "use strict";
+
+    var coll = db.validate_background;
+    coll.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, a: i % 10});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({a: 1}));
+
+    var res = db.runCommand({validate: coll.getName(), background: true, full: true});
+    if (res.code == ErrorCodes.CommandNotSupported) {
+        jsTest.log("Skipping test: the storage engine has no document-level locking");
+        return;
+    }
+    assert.commandWorked(res);
+    assert(res.valid, tojson(res));
+    assert.eq(1000, res.nrecords, tojson(res));
+    assert.eq(1000, res.keysPerIndex[coll.getFullName() + ".$a_1"], tojson(res));
+
+    // Writes don't wait for a background validate, so they can run alongside it.
+    var awaitShell = startParallelShell(function() {
+        for (var i = 0; i < 20; i++) {
+            var res = db.runCommand({validate: "validate_background", background: true});
+            assert.commandWorked(res);
+            assert(res.valid, tojson(res));
+        }
+    });
+    for (var i = 1000; i < 2000; i++) {
+        assert.writeOK(coll.insert({_id: i, a: i % 10}));
+    }
+    awaitShell();
+
+    res = assert.commandWorked(db.runCommand({validate: coll.getName(), full: true}));
+    assert(res.valid, tojson(res));
+    assert.eq(2000, res.nrecords, tojson(res));
+}());
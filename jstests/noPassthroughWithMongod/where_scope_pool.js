@@ -0,0 +1,61 @@
+// Tests that $where gives the same results whether its JavaScript scopes are pooled or not, and
+// that the scope pool server parameters can be set at runtime.
+(function() {
+    "use strict";
+
+    var coll = db.where_scope_pool;
+    coll.drop();
+
+    for (var i = 0; i < 20; i++) {
+        assert.writeOK(coll.insert({_id: i, a: i}));
+    }
+
+    function getParam(name) {
+        var cmd = {getParameter: 1};
+        cmd[name] = 1;
+        var res = db.adminCommand(cmd);
+        assert.commandWorked(res);
+        return res[name];
+    }
+
+    function setParam(name, value) {
+        var cmd = {setParameter: 1};
+        cmd[name] = value;
+        assert.commandWorked(db.adminCommand(cmd));
+    }
+
+    var params = ["scriptingScopePoolSize", "scriptingScopeMaxReuse", "scriptingScopePoolMaxMB"];
+    var original = {};
+    params.forEach(function(name) {
+        original[name] = getParam(name);
+    });
+
+    function runWhereQueries() {
+        for (var i = 0; i < 5; i++) {
+            assert.eq(10, coll.find({$where: "this.a >= 10"}).itcount());
+            assert.eq(5, coll.find({$where: "function() { return this.a % 4 == 0; }"}).itcount());
+        }
+    }
+
+    try {
+        runWhereQueries();
+
+        // No pooling at all.
+        setParam("scriptingScopePoolSize", 0);
+        runWhereQueries();
+
+        // Pooled scopes which are discarded after every use.
+        setParam("scriptingScopePoolSize", 10);
+        setParam("scriptingScopeMaxReuse", 1);
+        runWhereQueries();
+
+        // A pool which can't hold any JavaScript heap.
+        setParam("scriptingScopeMaxReuse", 100);
+        setParam("scriptingScopePoolMaxMB", 0);
+        runWhereQueries();
+    } finally {
+        params.forEach(function(name) {
+            setParam(name, original[name]);
+        });
+    }
+}());
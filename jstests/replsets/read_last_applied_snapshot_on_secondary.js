@@ -0,0 +1,56 @@
+/**
+ * Tests that with readFromLastAppliedSnapshotOnSecondaries, reads on a secondary are served from
+ * the snapshot of the last applied batch: replicated writes become visible, and reads of a
+ * collection or index created after the snapshot still succeed.
+ */
+
+load("jstests/replsets/rslib.js");  // For startSetIfSupportsReadMajority.
+
+(function() {
+    "use strict";
+
+    var name = "read_last_applied_snapshot_on_secondary";
+    var replTest = new ReplSetTest({
+        name: name,
+        nodes: 2,
+        nodeOptions: {
+            enableMajorityReadConcern: '',
+            setParameter: "readFromLastAppliedSnapshotOnSecondaries=true"
+        }
+    });
+
+    if (!startSetIfSupportsReadMajority(replTest)) {
+        jsTest.log("skipping test since storage engine doesn't support committed reads");
+        return;
+    }
+
+    var config = replTest.getReplSetConfig();
+    config.members[1].priority = 0;
+    updateConfigIfNotDurable(config);
+    replTest.initiate(config);
+
+    var primary = replTest.getPrimary();
+    var secondary = replTest.getSecondary();
+    secondary.setSlaveOk();
+
+    var collPrimary = primary.getDB(name)[name];
+    var collSecondary = secondary.getDB(name)[name];
+
+    // Snapshots are taken after each batch without waiting, so a read may briefly lag.
+    for (var i = 0; i < 10; ++i) {
+        assert.writeOK(collPrimary.insert({_id: i}, {writeConcern: {w: 2}}));
+        assert.soon(function() {
+            return collSecondary.find({_id: i}).itcount() === 1;
+        }, "document " + i + " never became visible on the secondary");
+    }
+    assert.eq(10, collSecondary.find().itcount());
+
+    // Reads of a collection and an index newer than the last snapshot fall back to the latest
+    // data rather than failing.
+    var newCollPrimary = primary.getDB(name).newColl;
+    assert.writeOK(newCollPrimary.insert({_id: 0, a: 1}, {writeConcern: {w: 2}}));
+    assert.commandWorked(newCollPrimary.createIndex({a: 1}, {writeConcern: {w: 2}}));
+    assert.eq(1, secondary.getDB(name).newColl.find({a: 1}).hint({a: 1}).itcount());
+
+    replTest.stopSet();
+}());
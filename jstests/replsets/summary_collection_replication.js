@@ -0,0 +1,39 @@
+/**
+ * Tests that secondaries apply the writes the primary makes to maintain a summary collection,
+ * rather than maintaining it a second time from the writes of its source.
+ */
+(function() {
+    'use strict';
+
+    var rst = new ReplSetTest({nodes: 2});
+    rst.startSet();
+    rst.initiate();
+
+    var primaryDB = rst.getPrimary().getDB("test");
+    var sales = primaryDB.sales;
+
+    assert.writeOK(sales.insert([{region: "east", amount: 1}, {region: "west", amount: 2}]));
+    assert.commandWorked(primaryDB.createCollection("byRegion", {
+        summary: {
+            source: "sales",
+            groupBy: "$region",
+            accumulators: {total: {$sum: "$amount"}, highest: {$max: "$amount"}}
+        }
+    }));
+
+    for (var i = 0; i < 10; ++i) {
+        assert.writeOK(sales.insert({region: i % 2 ? "east" : "west", amount: i}));
+    }
+    assert.writeOK(sales.update({amount: 9}, {$set: {region: "north"}}));
+    assert.writeOK(sales.remove({amount: 8}));
+    rst.awaitReplication();
+
+    var expected = primaryDB.byRegion.find().sort({_id: 1}).toArray();
+    assert.eq(3, expected.length, tojson(expected));
+
+    var secondaryDB = rst.getSecondary().getDB("test");
+    secondaryDB.getMongo().setSlaveOk();
+    assert.eq(expected, secondaryDB.byRegion.find().sort({_id: 1}).toArray());
+
+    rst.stopSet();
+})();
@@ -0,0 +1,53 @@
+// Tests that a shard started with shardAutoSplit splits its own chunks as they are written to,
+// with mongos autosplit disabled.
+(function() {
+    'use strict';
+
+    var chunkSizeMB = 1;
+
+    var st = new ShardingTest({
+        shards: 1,
+        mongos: 1,
+        other: {
+            chunkSize: chunkSizeMB,
+            mongosOptions: {noAutoSplit: ""},
+            shardOptions: {setParameter: "shardAutoSplit=true"}
+        }
+    });
+
+    var mongos = st.s0;
+    var admin = mongos.getDB("admin");
+    var config = mongos.getDB("config");
+    var coll = mongos.getCollection("foo.bar");
+
+    assert.commandWorked(admin.runCommand({enableSharding: coll.getDB() + ""}));
+    assert.commandWorked(admin.runCommand({shardCollection: coll + "", key: {x: 1}}));
+
+    var data = "x";
+    while (data.length < 1024) {
+        data += data;
+    }
+
+    var x = 0;
+    function insertMB(megabytes) {
+        var bulk = coll.initializeUnorderedBulkOp();
+        for (var i = 0; i < megabytes * 1024; i++) {
+            bulk.insert({x: x++, data: data});
+        }
+        assert.writeOK(bulk.execute());
+    }
+
+    insertMB(4 * chunkSizeMB);
+
+    assert.soon(function() {
+        // Each write past the split threshold schedules another check of its chunk.
+        insertMB(chunkSizeMB / 4);
+        return config.chunks.find({ns: coll + ""}).count() > 1;
+    }, "shard did not split the chunk", 60 * 1000);
+
+    // Every document is still found through the new chunks.
+    assert.eq(x, coll.find().itcount());
+
+    st.stop();
+
+})();
@@ -0,0 +1,30 @@
+// Tests that repeated connections from one client resume their TLS session, and that the
+// handshakes are counted in serverStatus.
+(function() {
+    "use strict";
+
+    var SERVER_CERT = "jstests/libs/server.pem";
+    var CA_CERT = "jstests/libs/ca.pem";
+
+    var conn = MongoRunner.runMongod(
+        {sslMode: "requireSSL", sslPEMKeyFile: SERVER_CERT, sslCAFile: CA_CERT});
+
+    function getIncomingHandshakes() {
+        var status = assert.commandWorked(conn.adminCommand({serverStatus: 1}));
+        assert(status.security.hasOwnProperty("SSLHandshakes"), tojson(status.security));
+        return status.security.SSLHandshakes.incoming;
+    }
+
+    var before = getIncomingHandshakes();
+    for (var i = 0; i < 5; i++) {
+        var other = new Mongo(conn.host);
+        assert.commandWorked(other.adminCommand({ping: 1}));
+    }
+    var after = getIncomingHandshakes();
+
+    assert.eq(before.total + 5, after.total, tojson(after));
+    assert.gte(after.resumed - before.resumed, 4, tojson(after));
+    assert.gte(after.totalMicros, before.totalMicros, tojson(after));
+
+    MongoRunner.stopMongod(conn.port);
+}());
@@ -30,6 +30,7 @@
 #include "mongo/base/global_initializer.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/quick_exit.h"
+#include "mongo/util/time_support.h"
 #include <iostream>
 
 namespace mongo {
@@ -38,13 +39,14 @@ Initializer::Initializer() {}
 Initializer::~Initializer() {}
 
 Status Initializer::execute(const InitializerContext::ArgumentVector& args,
-                            const InitializerContext::EnvironmentMap& env) const {
+                            const InitializerContext::EnvironmentMap& env) {
     std::vector<std::string> sortedNodes;
     Status status = _graph.topSort(&sortedNodes);
     if (Status::OK() != status)
         return status;
 
     InitializerContext context(args, env);
+    _executionTimes.clear();
 
     for (size_t i = 0; i < sortedNodes.size(); ++i) {
         InitializerFunction fn = _graph.getInitializerFunction(sortedNodes[i]);
@@ -53,11 +55,14 @@ Status Initializer::execute(const InitializerContext::ArgumentVector& args,
                           "topSort returned a node that has no associated function: \"" +
                               sortedNodes[i] + '"');
         }
+        const long long startMicros = curTimeMicros64();
         try {
             status = fn(&context);
         } catch (const DBException& xcp) {
             return xcp.toStatus();
         }
+        _executionTimes.emplace_back(
+            sortedNodes[i], Microseconds(static_cast<long long>(curTimeMicros64()) - startMicros));
 
         if (Status::OK() != status)
             return status;
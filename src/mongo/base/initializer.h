@@ -28,12 +28,14 @@
 #pragma once
 
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/initializer_context.h"
 #include "mongo/base/initializer_dependency_graph.h"
 #include "mongo/base/status.h"
+#include "mongo/util/duration.h"
 
 namespace mongo {
 
@@ -66,10 +68,19 @@ public:
      * and the thing being initialized should be considered dead in the water.
      */
     Status execute(const InitializerContext::ArgumentVector& args,
-                   const InitializerContext::EnvironmentMap& env) const;
+                   const InitializerContext::EnvironmentMap& env);
+
+    /**
+     * Returns the name of each initialization operation run by the last call to execute(), in
+     * the order they ran, with the time each took.
+     */
+    const std::vector<std::pair<std::string, Microseconds>>& getExecutionTimes() const {
+        return _executionTimes;
+    }
 
 private:
     InitializerDependencyGraph _graph;
+    std::vector<std::pair<std::string, Microseconds>> _executionTimes;
 };
 
 /**
@@ -161,6 +161,13 @@ TEST(InitializerTest, SuccessfulInitialization) {
                                   InitializerContext::EnvironmentMap()));
     for (int i = 0; i < 9; ++i)
         ASSERT_EQUALS(1, globalCounts[i]);
+
+    const auto& executionTimes = initializer.getExecutionTimes();
+    ASSERT_EQUALS(9U, executionTimes.size());
+    ASSERT_EQUALS("n8", executionTimes.back().first);
+    for (const auto& executionTime : executionTimes) {
+        ASSERT_GTE(executionTime.second, Microseconds(0));
+    }
 }
 
 TEST(InitializerTest, Step5Misimplemented) {
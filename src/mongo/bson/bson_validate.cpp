@@ -27,7 +27,9 @@
  *    then also delete it in the license file.
  */
 
+#include <algorithm>
 #include <cstring>
+#include <iterator>
 #include <limits>
 #include <vector>
 
@@ -56,6 +58,9 @@ Status NOINLINE_DECL makeError(StringData baseMsg, BSONElement idElem) {
     return Status(ErrorCodes::InvalidBSON, msg);
 }
 
+// C-strings are scanned inline for up to this many bytes before handing over to memchr().
+const uint64_t kInlineCStringScanLength = 16;
+
 class Buffer {
 public:
     Buffer(const char* buffer, uint64_t maxLength, BSONVersion version)
@@ -73,10 +78,22 @@ public:
     }
 
     Status readCString(StringData* out) {
-        const void* x = memchr(_buffer + _position, 0, _maxLength - _position);
-        if (!x)
-            return makeError("no end of c-string", _idElem);
-        uint64_t len = static_cast<uint64_t>(static_cast<const char*>(x) - (_buffer + _position));
+        const char* start = _buffer + _position;
+        const uint64_t remaining = _maxLength - _position;
+
+        // Most c-strings are short field names, which are quicker to scan here than through a
+        // call to memchr(), whose vectorized loop only pays off on longer strings.
+        const uint64_t inlineScanLength = std::min(remaining, kInlineCStringScanLength);
+        uint64_t len = 0;
+        while (len < inlineScanLength && start[len] != '\0') {
+            ++len;
+        }
+        if (len == inlineScanLength) {
+            const void* x = memchr(start + len, 0, remaining - len);
+            if (!x)
+                return makeError("no end of c-string", _idElem);
+            len = static_cast<uint64_t>(static_cast<const char*>(x) - start);
+        }
 
         StringData data(_buffer + _position, len);
         _position += len + 1;
@@ -176,6 +193,30 @@ private:
     int _startPosition;
 };
 
+/**
+ * The size of the value of each element type whose values all have the same size and need no
+ * checks beyond fitting in the buffer, or -1. Bool values have to be checked, and the size of a
+ * decimal depends on the BSON version, so neither is in here.
+ */
+struct FixedValueSizes {
+    FixedValueSizes() {
+        std::fill(std::begin(sizes), std::end(sizes), -1);
+        sizes[static_cast<unsigned char>(MinKey)] = 0;
+        sizes[static_cast<unsigned char>(MaxKey)] = 0;
+        sizes[jstNULL] = 0;
+        sizes[Undefined] = 0;
+        sizes[jstOID] = OID::kOIDSize;
+        sizes[NumberInt] = sizeof(int32_t);
+        sizes[NumberDouble] = sizeof(int64_t);
+        sizes[NumberLong] = sizeof(int64_t);
+        sizes[bsonTimestamp] = sizeof(int64_t);
+        sizes[Date] = sizeof(int64_t);
+    }
+
+    int sizes[256];
+};
+const FixedValueSizes kFixedValueSizes;
+
 /**
  * WARNING: only pass in a non-EOO idElem if it has been fully validated already!
  */
@@ -198,6 +239,14 @@ Status validateElementInfo(Buffer* buffer,
     if (!status.isOK())
         return status;
 
+    // Most elements have values of a fixed size, which only need to fit in the buffer.
+    const int fixedValueSize = kFixedValueSizes.sizes[static_cast<unsigned char>(type)];
+    if (fixedValueSize >= 0) {
+        if (fixedValueSize && !buffer->skip(fixedValueSize))
+            return makeError("invalid bson", idElem);
+        return Status::OK();
+    }
+
     switch (type) {
         case MinKey:
         case MaxKey:
@@ -35,6 +35,8 @@
 #include "mongo/platform/random.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 namespace {
 
@@ -341,4 +343,81 @@ TEST(BSONValidateBool, BoolValuesAreValidated) {
     }
 }
 
+TEST(BSONValidateFast, FieldNamesAroundTheInlineScanLength) {
+    for (size_t nameLength = 1; nameLength < 40; ++nameLength) {
+        const std::string name(nameLength, 'n');
+        const BSONObj obj = BSON(name << 1 << "_id" << 2 << name + "x" << "y");
+        ASSERT_OK(validateBSON(obj.objdata(), obj.objsize()));
+
+        // A field name without its NUL at the end of the buffer.
+        BufBuilder bb;
+        bb.appendNum(static_cast<int>(4 + 1 + nameLength));
+        bb.appendChar(NumberInt);
+        bb.appendStr(name, /*withNUL*/ false);
+        ASSERT_NOT_OK(validateBSON(bb.buf(), bb.len()));
+    }
+}
+
+/**
+ * Validates a corpus of large documents of the kind an insert-heavy workload sends, checking that
+ * validateBSON() agrees with BSONObj::valid() about them and about truncated copies of them, and
+ * logs how fast each of them is.
+ */
+TEST(BSONValidateFast, Corpus) {
+    PseudoRandom randomSource(12345);
+    std::vector<BSONObj> corpus;
+    for (int i = 0; i < 20; ++i) {
+        BSONObjBuilder bob;
+        bob.append("_id", OID::gen());
+        for (int j = 0; bob.len() < 50 * 1024; ++j) {
+            const std::string name = str::stream() << "field" << j;
+            switch (randomSource.nextInt32(6)) {
+                case 0:
+                    bob.append(name, randomSource.nextInt32());
+                    break;
+                case 1:
+                    bob.append(name, randomSource.nextCanonicalDouble());
+                    break;
+                case 2:
+                    bob.append(name, std::string(randomSource.nextInt32(100), 's'));
+                    break;
+                case 3:
+                    bob.append(name, BSON("a" << j << "b" << BSON_ARRAY(1 << 2.5 << "c")));
+                    break;
+                case 4:
+                    bob.appendDate(name, Date_t::fromMillisSinceEpoch(randomSource.nextInt64()));
+                    break;
+                default:
+                    bob.append(name + "WithAFieldNameLongerThanMost", true);
+            }
+        }
+        corpus.push_back(bob.obj());
+    }
+
+    Timer validateTimer;
+    for (int round = 0; round < 50; ++round) {
+        for (auto&& obj : corpus) {
+            ASSERT_OK(validateBSON(obj.objdata(), obj.objsize()));
+        }
+    }
+    const long long validateMicros = validateTimer.micros();
+
+    Timer validTimer;
+    for (int round = 0; round < 50; ++round) {
+        for (auto&& obj : corpus) {
+            ASSERT_TRUE(obj.valid());
+        }
+    }
+    const long long validMicros = validTimer.micros();
+
+    log() << "Corpus: validateBSON took " << validateMicros << "us, BSONObj::valid took "
+          << validMicros << "us";
+
+    for (auto&& obj : corpus) {
+        for (int length = 5; length < obj.objsize(); length += 997) {
+            ASSERT_NOT_OK(validateBSON(obj.objdata(), length));
+        }
+    }
+}
+
 }  // namespace
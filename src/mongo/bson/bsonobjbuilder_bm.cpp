@@ -0,0 +1,76 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+MONGO_BENCHMARK(BSONObjBuilderSmallObject) {
+    while (state.keepRunning()) {
+        BSONObjBuilder builder;
+        builder.append("_id", 1);
+        builder.append("name", "benchmark");
+        builder.append("value", 3.5);
+        benchmark::doNotOptimizeAway(builder.obj());
+    }
+}
+
+MONGO_BENCHMARK(BSONObjBuilderNestedObject) {
+    while (state.keepRunning()) {
+        BSONObjBuilder builder;
+        builder.append("_id", 1);
+        {
+            BSONObjBuilder sub(builder.subobjStart("sub"));
+            sub.append("a", 1);
+            sub.append("b", "two");
+        }
+        {
+            BSONArrayBuilder arr(builder.subarrayStart("arr"));
+            for (int i = 0; i < 10; ++i) {
+                arr.append(i);
+            }
+        }
+        benchmark::doNotOptimizeAway(builder.obj());
+    }
+}
+
+MONGO_BENCHMARK(BSONObjBuilderAppendElements) {
+    const BSONObj source = BSON("a" << 1 << "b" << 2.0 << "c" << BSON("d" << 3) << "e" << true);
+    while (state.keepRunning()) {
+        BSONObjBuilder builder;
+        builder.appendElements(source);
+        benchmark::doNotOptimizeAway(builder.obj());
+    }
+}
+
+}  // namespace
+}  // namespace mongo
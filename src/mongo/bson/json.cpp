@@ -65,8 +65,6 @@ enum {
     ID_RESERVE_SIZE = 64,
     PAT_RESERVE_SIZE = 4096,
     OPT_RESERVE_SIZE = 64,
-    FIELD_RESERVE_SIZE = 4096,
-    STRINGVAL_RESERVE_SIZE = 4096,
     BINDATA_RESERVE_SIZE = 4096,
     BINDATATYPE_RESERVE_SIZE = 4096,
     NS_RESERVE_SIZE = 64,
@@ -105,6 +103,13 @@ Status JParse::value(StringData fieldName, BSONObjBuilder& builder) {
         if (ret != Status::OK()) {
             return ret;
         }
+    } else if (peekToken(DOUBLEQUOTE) || peekToken(SINGLEQUOTE)) {
+        std::string valueString;
+        Status ret = quotedString(&valueString);
+        if (ret != Status::OK()) {
+            return ret;
+        }
+        builder.append(fieldName, valueString);
     } else if (readToken("new")) {
         Status ret = constructor(fieldName, builder);
         if (ret != Status::OK()) {
@@ -150,14 +155,6 @@ Status JParse::value(StringData fieldName, BSONObjBuilder& builder) {
         if (ret != Status::OK()) {
             return ret;
         }
-    } else if (peekToken(DOUBLEQUOTE) || peekToken(SINGLEQUOTE)) {
-        std::string valueString;
-        valueString.reserve(STRINGVAL_RESERVE_SIZE);
-        Status ret = quotedString(&valueString);
-        if (ret != Status::OK()) {
-            return ret;
-        }
-        builder.append(fieldName, valueString);
     } else if (readToken("true")) {
         builder.append(fieldName, true);
     } else if (readToken("false")) {
@@ -202,7 +199,6 @@ Status JParse::object(StringData fieldName, BSONObjBuilder& builder, bool subObj
 
     // Special object
     std::string firstField;
-    firstField.reserve(FIELD_RESERVE_SIZE);
     Status ret = field(&firstField);
     if (ret != Status::OK()) {
         return ret;
@@ -314,9 +310,10 @@ Status JParse::object(StringData fieldName, BSONObjBuilder& builder, bool subObj
         if (valueRet != Status::OK()) {
             return valueRet;
         }
+        // Reuse one string for the names of all other fields, which rarely need to allocate.
+        std::string fieldName;
         while (readToken(COMMA)) {
-            std::string fieldName;
-            fieldName.reserve(FIELD_RESERVE_SIZE);
+            fieldName.clear();
             Status fieldRet = field(&fieldName);
             if (fieldRet != Status::OK()) {
                 return fieldRet;
@@ -429,7 +426,6 @@ Status JParse::dateObject(StringData fieldName, BSONObjBuilder& builder) {
         date = dateRet.getValue();
     } else if (readToken(LBRACE)) {
         std::string fieldName;
-        fieldName.reserve(FIELD_RESERVE_SIZE);
         Status ret = field(&fieldName);
         if (ret != Status::OK()) {
             return ret;
@@ -1099,8 +1095,29 @@ Status JParse::chars(std::string* result, const char* terminalSet, const char* a
     if (_input >= _input_end) {
         return parseError("Unexpected end of input");
     }
+    // Quoted strings end at a single terminal character, which is cheaper to compare with than
+    // to look up in 'terminalSet'.
+    char terminal = '\0';
+    if (allowedSet == NULL && terminalSet[0] != '\0' && terminalSet[1] == '\0') {
+        terminal = terminalSet[0];
+    }
     const char* q = _input;
-    while (q < _input_end && !match(*q, terminalSet)) {
+    while (q < _input_end) {
+        if (terminal != '\0') {
+            // Copy each run of characters which need neither unescaping nor validation at once.
+            const char* run = q;
+            while (q < _input_end && *q != terminal && *q != '\\' &&
+                   static_cast<unsigned char>(*q) > 0x1F) {
+                ++q;
+            }
+            result->append(run, q - run);
+            if (q >= _input_end) {
+                break;
+            }
+        }
+        if (match(*q, terminalSet)) {
+            break;
+        }
         MONGO_JSON_DEBUG("q: " << q);
         if (allowedSet != NULL) {
             if (!match(*q, allowedSet)) {
@@ -1246,7 +1263,6 @@ bool JParse::readTokenImpl(const char* token, bool advance) {
 bool JParse::readField(StringData expectedField) {
     MONGO_JSON_DEBUG("expectedField: " << expectedField);
     std::string nextField;
-    nextField.reserve(FIELD_RESERVE_SIZE);
     Status ret = field(&nextField);
     if (ret != Status::OK()) {
         return false;
@@ -38,6 +38,7 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/platform/random.h"
+#include "mongo/util/concurrency/threadlocal.h"
 #include "mongo/util/hex.h"
 
 namespace mongo {
@@ -49,6 +50,44 @@ const std::size_t kTimestampOffset = 0;
 const std::size_t kInstanceUniqueOffset = kTimestampOffset + OID::kTimestampSize;
 const std::size_t kIncrementOffset = kInstanceUniqueOffset + OID::kInstanceUniqueSize;
 OID::InstanceUnique _instanceUnique;
+
+// Each thread reserves this many consecutive counter values at a time, so that generating an OID
+// usually does not touch the shared counter's cache line.
+const uint32_t kIncrementBlockSize = 64;
+
+/**
+ * A thread's reserved counter values. A block is only used with the timestamp it was reserved
+ * under: if it outlived its second, the shared counter could have wrapped around and handed the
+ * same values to another thread since. OIDs therefore stay unique as long as fewer than 2^24
+ * counter values are reserved within one second, as before.
+ */
+struct IncrementBlock {
+    OID::Timestamp timestamp;
+    uint32_t next;
+    uint32_t end;
+};
+
+MONGO_TRIVIALLY_CONSTRUCTIBLE_THREAD_LOCAL IncrementBlock incrementBlock;
+
+OID::Increment makeIncrement(uint32_t ctr) {
+    OID::Increment incr;
+
+    incr.bytes[0] = uint8_t(ctr >> 16);
+    incr.bytes[1] = uint8_t(ctr >> 8);
+    incr.bytes[2] = uint8_t(ctr);
+
+    return incr;
+}
+
+OID::Increment nextIncrementAt(OID::Timestamp timestamp) {
+    IncrementBlock& block = incrementBlock;
+    if (block.next == block.end || block.timestamp != timestamp) {
+        block.timestamp = timestamp;
+        block.next = counter->fetchAndAdd(kIncrementBlockSize);
+        block.end = block.next + kIncrementBlockSize;
+    }
+    return makeIncrement(block.next++);
+}
 }  // namespace
 
 MONGO_INITIALIZER_GENERAL(OIDGeneration, MONGO_NO_PREREQUISITES, ("default"))
@@ -60,14 +99,7 @@ MONGO_INITIALIZER_GENERAL(OIDGeneration, MONGO_NO_PREREQUISITES, ("default"))
 }
 
 OID::Increment OID::Increment::next() {
-    uint64_t nextCtr = counter->fetchAndAdd(1);
-    OID::Increment incr;
-
-    incr.bytes[0] = uint8_t(nextCtr >> 16);
-    incr.bytes[1] = uint8_t(nextCtr >> 8);
-    incr.bytes[2] = uint8_t(nextCtr);
-
-    return incr;
+    return makeIncrement(counter->fetchAndAdd(1));
 }
 
 OID::InstanceUnique OID::InstanceUnique::generate(SecureRandom& entropy) {
@@ -134,9 +166,10 @@ void OID::justForked() {
 
 void OID::init() {
     // each set* method handles endianness
-    setTimestamp(time(0));
+    const Timestamp now = time(0);
+    setTimestamp(now);
     setInstanceUnique(_instanceUnique);
-    setIncrement(Increment::next());
+    setIncrement(nextIncrementAt(now));
 }
 
 void OID::initFromTermNumber(int64_t term) {
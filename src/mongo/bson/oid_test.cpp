@@ -27,7 +27,11 @@
 
 #include "mongo/bson/oid.h"
 
+#include <set>
+#include <vector>
+
 #include "mongo/platform/endian.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 
 namespace {
@@ -57,6 +61,30 @@ TEST(Increasing, Simple) {
     ASSERT_TRUE(o1 < o2);
 }
 
+TEST(Unique, ManyThreads) {
+    const size_t kThreads = 8;
+    const size_t kOIDsPerThread = 10000;
+
+    std::vector<std::vector<OID>> generated(kThreads);
+    std::vector<mongo::stdx::thread> threads;
+    for (size_t i = 0; i < kThreads; ++i) {
+        threads.emplace_back([&generated, i] {
+            for (size_t j = 0; j < kOIDsPerThread; ++j) {
+                generated[i].push_back(OID::gen());
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::set<OID> all;
+    for (const auto& oids : generated) {
+        all.insert(oids.begin(), oids.end());
+    }
+    ASSERT_EQUALS(all.size(), kThreads * kOIDsPerThread);
+}
+
 TEST(IsSet, Simple) {
     OID o;
     ASSERT_FALSE(o.isSet());
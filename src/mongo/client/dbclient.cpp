@@ -60,6 +60,7 @@
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/transport/message_compressor_manager.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/debug_util.h"
@@ -730,6 +731,8 @@ StatusWith<executor::RemoteCommandResponse> initWireVersion(DBClientConnection*
             bob.append("hostInfo", sb.str());
         }
 
+        conn->port().compressorManager().clientBegin(&bob);
+
         Date_t start{Date_t::now()};
         auto result =
             conn->runCommandWithMetadata("admin", "isMaster", rpc::makeEmptyMetadata(), bob.done());
@@ -743,6 +746,8 @@ StatusWith<executor::RemoteCommandResponse> initWireVersion(DBClientConnection*
             conn->setWireVersions(minWireVersion, maxWireVersion);
         }
 
+        conn->port().compressorManager().clientFinish(isMasterObj);
+
         return executor::RemoteCommandResponse{
             std::move(isMasterObj), result->getMetadata().getOwned(), finish - start};
 
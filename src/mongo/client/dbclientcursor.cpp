@@ -180,7 +180,7 @@ bool DBClientCursor::initLazyFinish(bool& retry) {
     return !retry;
 }
 
-void DBClientCursor::requestMore() {
+void DBClientCursor::_assembleGetMore(Message& toSend) {
     verify(cursorId && batch.pos == batch.nReturned);
 
     if (haveLimit) {
@@ -193,8 +193,12 @@ void DBClientCursor::requestMore() {
     b.appendNum(nextBatchSize());
     b.appendNum(cursorId);
 
-    Message toSend;
     toSend.setData(dbGetMore, b.buf(), b.len());
+}
+
+void DBClientCursor::requestMore() {
+    Message toSend;
+    _assembleGetMore(toSend);
     Message response;
 
     if (_client) {
@@ -213,6 +217,21 @@ void DBClientCursor::requestMore() {
     }
 }
 
+void DBClientCursor::requestMoreLazy() {
+    verify(_client && !_moreRequested);
+    Message toSend;
+    _assembleGetMore(toSend);
+    _client->say(toSend);
+    _moreRequested = true;
+}
+
+void DBClientCursor::requestMoreLazyFinish() {
+    verify(_moreRequested);
+    _moreRequested = false;
+    uassert(40390, "recv failed while reading prefetched batch", _client->recv(batch.m));
+    dataReceived();
+}
+
 /** with QueryOption_Exhaust, the server just blasts data at us (marked at end with cursorid==0). */
 void DBClientCursor::exhaustReceiveMore() {
     verify(cursorId && batch.pos == batch.nReturned);
@@ -326,6 +345,11 @@ bool DBClientCursor::more() {
     if (batch.pos < batch.nReturned)
         return true;
 
+    if (_moreRequested) {
+        requestMoreLazyFinish();
+        return batch.pos < batch.nReturned;
+    }
+
     if (cursorId == 0)
         return false;
 
@@ -347,6 +371,12 @@ BSONObj DBClientCursor::next() {
     BSONObj o(batch.data);
     batch.data += o.objsize();
     /* todo would be good to make data null at end of batch for safety */
+
+    // The reply only replaces the batch's buffer once more() reads it, so 'o' stays valid for as
+    // long as it would have without the prefetch.
+    if (_prefetch && batch.pos == batch.nReturned && cursorId && !haveLimit) {
+        requestMoreLazy();
+    }
     return o;
 }
 
@@ -506,6 +536,9 @@ DBClientCursor::~DBClientCursor() {
 void DBClientCursor::kill() {
     DESTRUCTOR_GUARD(
 
+        // The reply to a prefetched getMore must be read before the connection can be used again.
+        if (_moreRequested) { requestMoreLazyFinish(); }
+
         if (cursorId && _ownCursor && !inShutdown()) {
             if (_client) {
                 _client->killCursor(cursorId);
@@ -157,6 +157,17 @@ public:
         batchSize = newBatchSize;
     }
 
+    /**
+     * Once enabled, next() sends the getMore for the following batch as soon as it hands out the
+     * last document of the current one, without waiting for the reply. The reply is read by the
+     * next call to more(), so the server works on the batch while the caller consumes other
+     * input. The connection must not be used for anything else while the cursor is alive, and
+     * the cursor must have been created on a connection which supports lazy requests.
+     */
+    void enablePrefetch() {
+        _prefetch = true;
+    }
+
     DBClientCursor(DBClientBase* client,
                    const std::string& ns,
                    const BSONObj& query,
@@ -268,6 +279,8 @@ private:
     std::string _scopedHost;
     std::string _lazyHost;
     bool wasError;
+    bool _prefetch = false;
+    bool _moreRequested = false;
 
     void dataReceived() {
         bool retry;
@@ -285,6 +298,14 @@ private:
 
     void requestMore();
 
+    // Sends the getMore for the next batch without waiting for the reply.
+    void requestMoreLazy();
+
+    // Reads the reply to a getMore sent by requestMoreLazy().
+    void requestMoreLazyFinish();
+
+    void _assembleGetMore(Message& toSend);
+
     // Don't call from a virtual function
     void _assertIfNull() const {
         uassert(13348, "connection died", this);
@@ -88,6 +88,11 @@ Query& Query::snapshot() {
     return *this;
 }
 
+Query& Query::rawData() {
+    appendComplex("$rawData", true);
+    return *this;
+}
+
 Query& Query::minKey(const BSONObj& val) {
     appendComplex("$min", val);
     return *this;
@@ -109,6 +109,11 @@ public:
     */
     Query& snapshot();
 
+    /** Read the buckets of a time-series collection as they are stored rather than the
+        measurements they hold, to copy the collection.
+    */
+    Query& rawData();
+
     /** Queries to the Mongo database support a $where parameter option which contains
         a javascript function that is evaluated to see whether objects being queried match
         its criteria.  Use this helper to append such a function to a query object.
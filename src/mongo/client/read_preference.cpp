@@ -46,6 +46,7 @@ namespace {
 
 const char kModeFieldName[] = "mode";
 const char kTagsFieldName[] = "tags";
+const char kHedgeFieldName[] = "hedge";
 
 const char kPrimaryOnly[] = "primary";
 const char kPrimaryPreferred[] = "primaryPreferred";
@@ -167,7 +168,20 @@ StatusWith<ReadPreferenceSetting> ReadPreferenceSetting::fromBSON(const BSONObj&
         return tagExtractStatus;
     }
 
-    return ReadPreferenceSetting(mode, tags);
+    bool hedge;
+    auto hedgeExtractStatus =
+        bsonExtractBooleanFieldWithDefault(readPrefObj, kHedgeFieldName, false, &hedge);
+    if (!hedgeExtractStatus.isOK()) {
+        return hedgeExtractStatus;
+    }
+    if (hedge && ReadPreference::PrimaryOnly == mode) {
+        return Status(ErrorCodes::BadValue,
+                      "Hedged reads are not allowed with primary read preference");
+    }
+
+    ReadPreferenceSetting readPref(mode, tags);
+    readPref.hedge = hedge;
+    return readPref;
 }
 
 BSONObj ReadPreferenceSetting::toBSON() const {
@@ -176,6 +190,9 @@ BSONObj ReadPreferenceSetting::toBSON() const {
     if (tags != defaultTagSetForMode(pref)) {
         bob.append(kTagsFieldName, tags.getTagBSON());
     }
+    if (hedge) {
+        bob.append(kHedgeFieldName, true);
+    }
     return bob.obj();
 }
 
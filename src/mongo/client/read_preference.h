@@ -124,7 +124,7 @@ struct ReadPreferenceSetting {
     explicit ReadPreferenceSetting(ReadPreference pref);
 
     inline bool equals(const ReadPreferenceSetting& other) const {
-        return (pref == other.pref) && (tags == other.tags);
+        return (pref == other.pref) && (tags == other.tags) && (hedge == other.hedge);
     }
 
     /**
@@ -139,16 +139,21 @@ struct ReadPreferenceSetting {
 
     /**
      * Parses a ReadPreferenceSetting from a BSON document of the form:
-     * { mode: <mode>, tags: <array of tags> }. The 'mode' element must a string equal to either
-     * "primary", "primaryPreferred", "secondary", "secondaryPreferred", or "nearest". Although
-     * the tags array is intended to be an array of unique BSON documents, no further validation
-     * is performed on it other than checking that it is an array, and that it is empty if
-     * 'mode' is 'primary'.
+     * { mode: <mode>, tags: <array of tags>, hedge: <bool> }. The 'mode' element must a string
+     * equal to either "primary", "primaryPreferred", "secondary", "secondaryPreferred", or
+     * "nearest". Although the tags array is intended to be an array of unique BSON documents, no
+     * further validation is performed on it other than checking that it is an array, and that it
+     * is empty if 'mode' is 'primary'. The optional 'hedge' element must be a boolean, and may
+     * only be true if 'mode' is not 'primary'.
      */
     static StatusWith<ReadPreferenceSetting> fromBSON(const BSONObj& readPrefSettingObj);
 
     ReadPreference pref;
     TagSet tags;
+
+    // Whether a read which is slow to answer may also be sent to a second eligible host, taking
+    // whichever response arrives first.
+    bool hedge = false;
 };
 
 }  // namespace mongo
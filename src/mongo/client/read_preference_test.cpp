@@ -64,6 +64,14 @@ TEST(ReadPreferenceSetting, ParseValid) {
                ReadPreferenceSetting(ReadPreference::SecondaryPreferred,
                                      TagSet(BSON_ARRAY(BSON("dc"
                                                             << "ny")))));
+
+    ReadPreferenceSetting hedged(ReadPreference::Nearest);
+    hedged.hedge = true;
+    checkParse(BSON("mode"
+                    << "nearest"
+                    << "hedge"
+                    << true),
+               hedged);
 }
 
 void checkParseFails(const BSONObj& rpsObj) {
@@ -91,6 +99,18 @@ TEST(ReadPreferenceSetting, ParseInvalid) {
                          << "nearest"
                          << "tags"
                          << "bad"));
+
+    // mode primary can not be hedged
+    checkParseFails(BSON("mode"
+                         << "primary"
+                         << "hedge"
+                         << true));
+
+    // hedge not a boolean
+    checkParseFails(BSON("mode"
+                         << "nearest"
+                         << "hedge"
+                         << "yes"));
 }
 
 void checkRoundtrip(const ReadPreferenceSetting& rps) {
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/util/time_support.h"
 
@@ -72,6 +74,21 @@ public:
     virtual StatusWith<HostAndPort> findHost(const ReadPreferenceSetting& readPref,
                                              Milliseconds maxWait = Milliseconds(0)) = 0;
 
+    /**
+     * Obtains a host other than 'firstHost' which also matches readPref, to send a hedged copy of
+     * a read which was first sent to 'firstHost'. Never blocks: only the cached view of the
+     * replica set's host state is consulted.
+     *
+     * Returns ErrorCodes::FailedToSatisfyReadPreference if there is no such host.
+     */
+    virtual StatusWith<HostAndPort> findHedgeHost(const ReadPreferenceSetting& readPref,
+                                                  const HostAndPort& firstHost) = 0;
+
+    /**
+     * Returns the last observed round trip time to 'host', or boost::none if it is not known.
+     */
+    virtual boost::optional<Microseconds> getHostLatency(const HostAndPort& host) = 0;
+
     /**
      * Reports to the targeter that a NotMaster response was received when communicating with
      * "host', and so it should update its bookkeeping to avoid giving out the host again on a
@@ -86,6 +103,19 @@ public:
      */
     virtual void markHostUnreachable(const HostAndPort& host) = 0;
 
+    /**
+     * Reports that a request is about to be sent to 'host', which was returned by findHost. Must be
+     * followed by a call to noteRequestFinished once the request has completed.
+     */
+    virtual void noteRequestStarted(const HostAndPort& host) = 0;
+
+    /**
+     * Reports that a request reported by noteRequestStarted has completed, with the time it took
+     * or boost::none if no response was received.
+     */
+    virtual void noteRequestFinished(const HostAndPort& host,
+                                     boost::optional<Microseconds> latency) = 0;
+
     /**
      * Based on the remaining time of the operation and the default max wait time for findHost,
      * selects an appropriate value to pass to the maxWait argument of the findHost method, so it
@@ -36,7 +36,9 @@
 namespace mongo {
 
 RemoteCommandTargeterMock::RemoteCommandTargeterMock()
-    : _findHostReturnValue(Status(ErrorCodes::InternalError, "No return value set")) {}
+    : _findHostReturnValue(Status(ErrorCodes::InternalError, "No return value set")),
+      _findHedgeHostReturnValue(
+          Status(ErrorCodes::FailedToSatisfyReadPreference, "No return value set")) {}
 
 RemoteCommandTargeterMock::~RemoteCommandTargeterMock() = default;
 
@@ -57,10 +59,24 @@ StatusWith<HostAndPort> RemoteCommandTargeterMock::findHost(const ReadPreference
     return _findHostReturnValue;
 }
 
+StatusWith<HostAndPort> RemoteCommandTargeterMock::findHedgeHost(
+    const ReadPreferenceSetting& readPref, const HostAndPort& firstHost) {
+    return _findHedgeHostReturnValue;
+}
+
+boost::optional<Microseconds> RemoteCommandTargeterMock::getHostLatency(const HostAndPort& host) {
+    return _hostLatencyReturnValue;
+}
+
 void RemoteCommandTargeterMock::markHostNotMaster(const HostAndPort& host) {}
 
 void RemoteCommandTargeterMock::markHostUnreachable(const HostAndPort& host) {}
 
+void RemoteCommandTargeterMock::noteRequestStarted(const HostAndPort& host) {}
+
+void RemoteCommandTargeterMock::noteRequestFinished(const HostAndPort& host,
+                                                    boost::optional<Microseconds> latency) {}
+
 void RemoteCommandTargeterMock::setConnectionStringReturnValue(const ConnectionString returnValue) {
     _connectionStringReturnValue = std::move(returnValue);
 }
@@ -69,4 +85,13 @@ void RemoteCommandTargeterMock::setFindHostReturnValue(StatusWith<HostAndPort> r
     _findHostReturnValue = std::move(returnValue);
 }
 
+void RemoteCommandTargeterMock::setFindHedgeHostReturnValue(StatusWith<HostAndPort> returnValue) {
+    _findHedgeHostReturnValue = std::move(returnValue);
+}
+
+void RemoteCommandTargeterMock::setHostLatencyReturnValue(
+    boost::optional<Microseconds> returnValue) {
+    _hostLatencyReturnValue = std::move(returnValue);
+}
+
 }  // namespace mongo
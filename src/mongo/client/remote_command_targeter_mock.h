@@ -57,6 +57,19 @@ public:
     StatusWith<HostAndPort> findHost(const ReadPreferenceSetting& readPref,
                                      Milliseconds maxWait) override;
 
+    /**
+     * Returns the return value last set by setFindHedgeHostReturnValue.
+     * Returns ErrorCodes::FailedToSatisfyReadPreference if setFindHedgeHostReturnValue was never
+     * called.
+     */
+    StatusWith<HostAndPort> findHedgeHost(const ReadPreferenceSetting& readPref,
+                                          const HostAndPort& firstHost) override;
+
+    /**
+     * Returns the value last set by setHostLatencyReturnValue, or boost::none.
+     */
+    boost::optional<Microseconds> getHostLatency(const HostAndPort& host) override;
+
     /**
      * No-op for the mock.
      */
@@ -67,6 +80,17 @@ public:
      */
     void markHostUnreachable(const HostAndPort& host) override;
 
+    /**
+     * No-op for the mock.
+     */
+    void noteRequestStarted(const HostAndPort& host) override;
+
+    /**
+     * No-op for the mock.
+     */
+    void noteRequestFinished(const HostAndPort& host,
+                             boost::optional<Microseconds> latency) override;
+
     /**
      * Sets the return value for the next call to connectionString.
      */
@@ -77,9 +101,21 @@ public:
      */
     void setFindHostReturnValue(StatusWith<HostAndPort> returnValue);
 
+    /**
+     * Sets the return value for the next call to findHedgeHost.
+     */
+    void setFindHedgeHostReturnValue(StatusWith<HostAndPort> returnValue);
+
+    /**
+     * Sets the return value for the next call to getHostLatency.
+     */
+    void setHostLatencyReturnValue(boost::optional<Microseconds> returnValue);
+
 private:
     ConnectionString _connectionStringReturnValue;
     StatusWith<HostAndPort> _findHostReturnValue;
+    StatusWith<HostAndPort> _findHedgeHostReturnValue;
+    boost::optional<Microseconds> _hostLatencyReturnValue;
 };
 
 }  // namespace mongo
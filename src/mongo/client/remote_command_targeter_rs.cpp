@@ -63,6 +63,24 @@ StatusWith<HostAndPort> RemoteCommandTargeterRS::findHost(const ReadPreferenceSe
     return _rsMonitor->getHostOrRefresh(readPref, maxWait);
 }
 
+StatusWith<HostAndPort> RemoteCommandTargeterRS::findHedgeHost(
+    const ReadPreferenceSetting& readPref, const HostAndPort& firstHost) {
+    HostAndPort host = _rsMonitor->getMatchingHostExcluding(readPref, firstHost);
+    if (host.empty()) {
+        return Status(ErrorCodes::FailedToSatisfyReadPreference,
+                      str::stream() << "no host other than " << firstHost.toString()
+                                    << " matches read preference "
+                                    << readPref.toString()
+                                    << " for set "
+                                    << _rsName);
+    }
+    return host;
+}
+
+boost::optional<Microseconds> RemoteCommandTargeterRS::getHostLatency(const HostAndPort& host) {
+    return _rsMonitor->getLatency(host);
+}
+
 void RemoteCommandTargeterRS::markHostNotMaster(const HostAndPort& host) {
     invariant(_rsMonitor);
 
@@ -75,4 +93,17 @@ void RemoteCommandTargeterRS::markHostUnreachable(const HostAndPort& host) {
     _rsMonitor->failedHost(host);
 }
 
+void RemoteCommandTargeterRS::noteRequestStarted(const HostAndPort& host) {
+    invariant(_rsMonitor);
+
+    _rsMonitor->noteRequestStarted(host);
+}
+
+void RemoteCommandTargeterRS::noteRequestFinished(const HostAndPort& host,
+                                                  boost::optional<Microseconds> latency) {
+    invariant(_rsMonitor);
+
+    _rsMonitor->noteRequestFinished(host, latency);
+}
+
 }  // namespace mongo
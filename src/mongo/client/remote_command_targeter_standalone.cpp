@@ -47,6 +47,18 @@ StatusWith<HostAndPort> RemoteCommandTargeterStandalone::findHost(
     return _hostAndPort;
 }
 
+StatusWith<HostAndPort> RemoteCommandTargeterStandalone::findHedgeHost(
+    const ReadPreferenceSetting& readPref, const HostAndPort& firstHost) {
+    dassert(firstHost == _hostAndPort);
+    return Status(ErrorCodes::FailedToSatisfyReadPreference,
+                  "a standalone host has no other member to hedge a read with");
+}
+
+boost::optional<Microseconds> RemoteCommandTargeterStandalone::getHostLatency(
+    const HostAndPort& host) {
+    return boost::none;
+}
+
 void RemoteCommandTargeterStandalone::markHostNotMaster(const HostAndPort& host) {
     dassert(host == _hostAndPort);
 }
@@ -55,4 +67,13 @@ void RemoteCommandTargeterStandalone::markHostUnreachable(const HostAndPort& hos
     dassert(host == _hostAndPort);
 }
 
+void RemoteCommandTargeterStandalone::noteRequestStarted(const HostAndPort& host) {
+    dassert(host == _hostAndPort);
+}
+
+void RemoteCommandTargeterStandalone::noteRequestFinished(const HostAndPort& host,
+                                                          boost::optional<Microseconds> latency) {
+    dassert(host == _hostAndPort);
+}
+
 }  // namespace mongo
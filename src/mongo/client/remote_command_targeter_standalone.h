@@ -46,10 +46,20 @@ public:
     StatusWith<HostAndPort> findHost(const ReadPreferenceSetting& readPref,
                                      Milliseconds maxWait) override;
 
+    StatusWith<HostAndPort> findHedgeHost(const ReadPreferenceSetting& readPref,
+                                          const HostAndPort& firstHost) override;
+
+    boost::optional<Microseconds> getHostLatency(const HostAndPort& host) override;
+
     void markHostNotMaster(const HostAndPort& host) override;
 
     void markHostUnreachable(const HostAndPort& host) override;
 
+    void noteRequestStarted(const HostAndPort& host) override;
+
+    void noteRequestFinished(const HostAndPort& host,
+                             boost::optional<Microseconds> latency) override;
+
 private:
     const HostAndPort _hostAndPort;
 };
@@ -39,6 +39,7 @@
 #include "mongo/client/replica_set_monitor_internal.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/grid.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
@@ -84,6 +85,22 @@ const int64_t unknownLatency = numeric_limits<int64_t>::max();
 const ReadPreferenceSetting kPrimaryOnlyReadPreference(ReadPreference::PrimaryOnly, TagSet());
 const Milliseconds kFindHostMaxBackOffTime(500);
 
+// A host is left out of host selection for this many milliseconds once its request latencies have
+// become outliers. Zero disables the ejection of hosts.
+MONGO_EXPORT_SERVER_PARAMETER(replicaSetMonitorOutlierEjectionMS, int, 30 * 1000);
+
+// Request latencies are outliers once both their average and their 90th percentile exceed this
+// many times the median of those of the other hosts in the same role.
+MONGO_EXPORT_SERVER_PARAMETER(replicaSetMonitorOutlierLatencyFactor, int, 3);
+
+// Hosts whose average request latency is below this many milliseconds are never ejected.
+MONGO_EXPORT_SERVER_PARAMETER(replicaSetMonitorOutlierMinLatencyMS, int, 5);
+
+// Request latencies of a host are only compared with those of others once this many are known.
+const size_t kMinRequestLatencySamples = 16;
+
+const double kRequestLatencyTailFraction = 0.9;
+
 // TODO: Move to ReplicaSetMonitorManager
 ReplicaSetMonitor::ConfigChangeHook asyncConfigChangeHook;
 ReplicaSetMonitor::ConfigChangeHook syncConfigChangeHook;
@@ -98,6 +115,13 @@ bool isMaster(const Node& node) {
     return node.isMaster;
 }
 
+int64_t median(std::vector<int64_t>* values) {
+    invariant(!values->empty());
+    auto middle = values->begin() + values->size() / 2;
+    std::nth_element(values->begin(), middle, values->end());
+    return *middle;
+}
+
 bool compareLatencies(const Node* lhs, const Node* rhs) {
     // NOTE: this automatically compares Node::unknownLatency worse than all others.
     return lhs->latencyMicros < rhs->latencyMicros;
@@ -309,6 +333,44 @@ HostAndPort ReplicaSetMonitor::getMasterOrUassert() {
     return uassertStatusOK(getHostOrRefresh(kPrimaryOnlyReadPreference));
 }
 
+HostAndPort ReplicaSetMonitor::getMatchingHostExcluding(const ReadPreferenceSetting& readPref,
+                                                        const HostAndPort& excludedHost) const {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    return _state->getMatchingHost(readPref, excludedHost);
+}
+
+boost::optional<Microseconds> ReplicaSetMonitor::getLatency(const HostAndPort& host) const {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    Node* node = _state->findNode(host);
+    if (!node || node->latencyMicros == unknownLatency)
+        return boost::none;
+    return Microseconds(node->latencyMicros);
+}
+
+void ReplicaSetMonitor::noteRequestStarted(const HostAndPort& host) {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    Node* node = _state->findNode(host);
+    if (node)
+        ++node->outstandingRequests;
+}
+
+void ReplicaSetMonitor::noteRequestFinished(const HostAndPort& host,
+                                            boost::optional<Microseconds> latency) {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    Node* node = _state->findNode(host);
+    if (!node)
+        return;
+
+    // The node may have been recreated while the request was outstanding.
+    if (node->outstandingRequests > 0)
+        --node->outstandingRequests;
+
+    if (latency) {
+        node->recordRequestLatency(durationCount<Microseconds>(*latency));
+        _state->ejectIfRequestLatencyOutlier(node);
+    }
+}
+
 Refresher ReplicaSetMonitor::startOrContinueRefresh() {
     stdx::lock_guard<stdx::mutex> lk(_state->mutex);
 
@@ -437,6 +499,22 @@ void ReplicaSetMonitor::appendInfo(BSONObjBuilder& bsonObjBuilder) const {
             builder.append("tags", node.tags);
         }
 
+        if (node.requestLatencySamples > 0) {
+            builder.append("requestLatencyMicros",
+                           static_cast<long long>(node.requestLatencyMicros));
+            builder.append("requestLatencyP90Micros",
+                           static_cast<long long>(
+                               node.recentRequestLatencyPercentile(kRequestLatencyTailFraction)));
+        }
+
+        if (node.outstandingRequests > 0) {
+            builder.append("outstandingRequests", node.outstandingRequests);
+        }
+
+        if (node.ejectedUntil != Date_t()) {
+            builder.append("ejectedUntil", node.ejectedUntil);
+        }
+
         hosts.append(builder.obj());
     }
     hosts.done();
@@ -874,7 +952,10 @@ void IsMasterReply::parse(const BSONObj& obj) {
     }
 }
 
-Node::Node(const HostAndPort& host) : host(host), latencyMicros(unknownLatency) {}
+const size_t Node::kRecentRequestLatencyCount;
+
+Node::Node(const HostAndPort& host)
+    : host(host), latencyMicros(unknownLatency), requestLatencyMicros(unknownLatency) {}
 
 void Node::markFailed() {
     LOG(1) << "Marking host " << host << " as failed";
@@ -936,6 +1017,33 @@ void Node::update(const IsMasterReply& reply) {
     }
 }
 
+void Node::recordRequestLatency(int64_t micros) {
+    if (requestLatencyMicros == unknownLatency) {
+        requestLatencyMicros = micros;
+    } else {
+        // Smoothed the same way as the isMaster latency.
+        requestLatencyMicros += (micros - requestLatencyMicros) / 4;
+    }
+
+    recentRequestLatencies[requestLatencySamples % kRecentRequestLatencyCount] = micros;
+    ++requestLatencySamples;
+}
+
+int64_t Node::recentRequestLatencyPercentile(double fraction) const {
+    invariant(requestLatencySamples > 0);
+
+    const size_t count = std::min(requestLatencySamples, kRecentRequestLatencyCount);
+    auto latencies = recentRequestLatencies;
+    auto nth = latencies.begin() + std::min(count - 1, static_cast<size_t>(fraction * count));
+    std::nth_element(latencies.begin(), nth, latencies.begin() + count);
+    return *nth;
+}
+
+void Node::resetRequestLatencies() {
+    requestLatencyMicros = unknownLatency;
+    requestLatencySamples = 0;
+}
+
 SetState::SetState(StringData name, const std::set<HostAndPort>& seedNodes)
     : name(name.toString()),
       consecutiveFailedScans(0),
@@ -965,33 +1073,34 @@ bool SetState::isUsable() const {
     return consecutiveFailedScans < maxConsecutiveFailedChecks;
 }
 
-HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) const {
+HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria,
+                                      const HostAndPort& excludedHost) const {
     switch (criteria.pref) {
         // "Prefered" read preferences are defined in terms of other preferences
         case ReadPreference::PrimaryPreferred: {
-            HostAndPort out =
-                getMatchingHost(ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags));
+            HostAndPort out = getMatchingHost(
+                ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags), excludedHost);
             // NOTE: the spec says we should use the primary even if tags don't match
             if (!out.empty())
                 return out;
             return getMatchingHost(
-                ReadPreferenceSetting(ReadPreference::SecondaryOnly, criteria.tags));
+                ReadPreferenceSetting(ReadPreference::SecondaryOnly, criteria.tags), excludedHost);
         }
 
         case ReadPreference::SecondaryPreferred: {
             HostAndPort out = getMatchingHost(
-                ReadPreferenceSetting(ReadPreference::SecondaryOnly, criteria.tags));
+                ReadPreferenceSetting(ReadPreference::SecondaryOnly, criteria.tags), excludedHost);
             if (!out.empty())
                 return out;
             // NOTE: the spec says we should use the primary even if tags don't match
             return getMatchingHost(
-                ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags));
+                ReadPreferenceSetting(ReadPreference::PrimaryOnly, criteria.tags), excludedHost);
         }
 
         case ReadPreference::PrimaryOnly: {
             // NOTE: isMaster implies isUp
             Nodes::const_iterator it = std::find_if(nodes.begin(), nodes.end(), isMaster);
-            if (it == nodes.end())
+            if (it == nodes.end() || it->host == excludedHost)
                 return HostAndPort();
             return it->host;
         }
@@ -1005,11 +1114,21 @@ HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) con
 
                 std::vector<const Node*> matchingNodes;
                 for (size_t i = 0; i < nodes.size(); i++) {
-                    if (nodes[i].matches(criteria.pref) && nodes[i].matches(tag)) {
+                    if (nodes[i].host != excludedHost && nodes[i].matches(criteria.pref) &&
+                        nodes[i].matches(tag)) {
                         matchingNodes.push_back(&nodes[i]);
                     }
                 }
 
+                // leave out hosts ejected for their request latencies, unless only those match
+                const Date_t now = Date_t::now();
+                const auto isEjected = [now](const Node* node) { return node->isEjected(now); };
+                if (!std::all_of(matchingNodes.begin(), matchingNodes.end(), isEjected)) {
+                    matchingNodes.erase(
+                        std::remove_if(matchingNodes.begin(), matchingNodes.end(), isEjected),
+                        matchingNodes.end());
+                }
+
                 // don't do more complicated selection if not needed
                 if (matchingNodes.empty())
                     continue;
@@ -1029,6 +1148,22 @@ HostAndPort SetState::getMatchingHost(const ReadPreferenceSetting& criteria) con
                     }
                 }
 
+                // of those, only consider the ones with the fewest requests outstanding
+                const int fewestOutstanding =
+                    (*std::min_element(matchingNodes.begin(),
+                                       matchingNodes.end(),
+                                       [](const Node* lhs, const Node* rhs) {
+                                           return lhs->outstandingRequests <
+                                               rhs->outstandingRequests;
+                                       }))->outstandingRequests;
+                matchingNodes.erase(std::remove_if(matchingNodes.begin(),
+                                                   matchingNodes.end(),
+                                                   [fewestOutstanding](const Node* node) {
+                                                       return node->outstandingRequests >
+                                                           fewestOutstanding;
+                                                   }),
+                                    matchingNodes.end());
+
                 // of the remaining nodes, pick one at random (or use round-robin)
                 if (ReplicaSetMonitor::useDeterministicHostSelection) {
                     // only in tests
@@ -1068,6 +1203,44 @@ Node* SetState::findOrCreateNode(const HostAndPort& host) {
     return &(*it);
 }
 
+void SetState::ejectIfRequestLatencyOutlier(Node* node) {
+    const int ejectionMillis = replicaSetMonitorOutlierEjectionMS.load();
+    if (ejectionMillis <= 0 || node->requestLatencySamples < kMinRequestLatencySamples)
+        return;
+
+    const Date_t now = Date_t::now();
+    std::vector<int64_t> peerAverages;
+    std::vector<int64_t> peerTails;
+    for (const Node& peer : nodes) {
+        if (&peer == node || !peer.isUp || peer.isMaster != node->isMaster ||
+            peer.isEjected(now) || peer.requestLatencySamples < kMinRequestLatencySamples)
+            continue;
+
+        peerAverages.push_back(peer.requestLatencyMicros);
+        peerTails.push_back(peer.recentRequestLatencyPercentile(kRequestLatencyTailFraction));
+    }
+
+    // a host is never ejected unless another one in the same role can take its requests
+    if (peerAverages.empty())
+        return;
+
+    const int64_t factor = replicaSetMonitorOutlierLatencyFactor.load();
+    const int64_t tail = node->recentRequestLatencyPercentile(kRequestLatencyTailFraction);
+    if (node->requestLatencyMicros < replicaSetMonitorOutlierMinLatencyMS.load() * 1000LL ||
+        node->requestLatencyMicros <= factor * median(&peerAverages) ||
+        tail <= factor * median(&peerTails))
+        return;
+
+    log() << "Leaving " << node->host << " of replica set " << name
+          << " out of host selection for " << ejectionMillis
+          << "ms since its request latencies are outliers, averaging "
+          << node->requestLatencyMicros << "micros with a 90th percentile of " << tail
+          << "micros";
+
+    node->ejectedUntil = now + Milliseconds(ejectionMillis);
+    node->resetRequestLatencies();
+}
+
 void SetState::updateNodeIfInNodes(const IsMasterReply& reply) {
     Node* node = findNode(reply.host);
     if (!node) {
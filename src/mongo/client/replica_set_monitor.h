@@ -28,6 +28,7 @@
 #pragma once
 
 #include <atomic>
+#include <boost/optional.hpp>
 #include <memory>
 #include <memory>
 #include <set>
@@ -98,6 +99,34 @@ public:
      */
     HostAndPort getMasterOrUassert();
 
+    /**
+     * Returns a host other than 'excludedHost' which matches the given read preference, or an
+     * empty HostAndPort if there is none. Only the cached view of the set is consulted.
+     */
+    HostAndPort getMatchingHostExcluding(const ReadPreferenceSetting& readPref,
+                                         const HostAndPort& excludedHost) const;
+
+    /**
+     * Returns the round trip time of the last isMaster sent to 'host', or boost::none if it is not
+     * known.
+     */
+    boost::optional<Microseconds> getLatency(const HostAndPort& host) const;
+
+    /**
+     * Notifies this Monitor that a request is about to be sent to 'host'. Hosts with fewer
+     * outstanding requests are preferred when several are eligible for a read preference.
+     *
+     * Must be followed by a call to noteRequestFinished for the same host.
+     */
+    void noteRequestStarted(const HostAndPort& host);
+
+    /**
+     * Notifies this Monitor that a request to 'host' has completed, with the time it took or
+     * boost::none if no response was received. Hosts whose request latencies become outliers are
+     * left out of host selection for a while.
+     */
+    void noteRequestFinished(const HostAndPort& host, boost::optional<Microseconds> latency);
+
     /**
      * Returns a refresher object that can be used to update our view of the set.
      * If a refresh is currently in-progress, the returned Refresher will participate in the
@@ -33,6 +33,7 @@
 
 #pragma once
 
+#include <array>
 #include <cstdint>
 #include <deque>
 #include <set>
@@ -47,6 +48,7 @@
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/net/hostandport.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -115,6 +117,34 @@ public:
          */
         void update(const IsMasterReply& reply);
 
+        /**
+         * Folds the latency of a request which completed on this host into its request latency
+         * statistics.
+         */
+        void recordRequestLatency(int64_t micros);
+
+        /**
+         * Returns the latency under which the given fraction of the recent requests to this host
+         * completed. Only meaningful once requestLatencySamples is at least 1.
+         */
+        int64_t recentRequestLatencyPercentile(double fraction) const;
+
+        /**
+         * Forgets the request latency statistics, for instance once the host has been ejected for
+         * them.
+         */
+        void resetRequestLatencies();
+
+        /**
+         * Returns whether the host is currently left out of host selection for its request latency.
+         */
+        bool isEjected(Date_t now) const {
+            return ejectedUntil > now;
+        }
+
+        // Number of request latencies kept to estimate their percentiles.
+        static const size_t kRecentRequestLatencyCount = 32;
+
         HostAndPort host;
         bool isUp{false};
         bool isMaster{false};   // implies isUp
@@ -122,6 +152,16 @@ public:
         BSONObj tags;           // owned
         int minWireVersion{0};
         int maxWireVersion{0};
+
+        // Latencies of the requests sent to this host by the users of the monitor, as opposed to
+        // the isMaster requests of the monitor itself. 'requestLatencyMicros' is their smoothed
+        // moving average and 'recentRequestLatencies' a ring of the most recent ones.
+        int64_t requestLatencyMicros;  // unknownLatency if unknown
+        std::array<int64_t, kRecentRequestLatencyCount> recentRequestLatencies;
+        size_t requestLatencySamples{0};  // since the last reset
+
+        int outstandingRequests{0};
+        Date_t ejectedUntil;  // Date_t() if never ejected
     };
 
     typedef std::vector<Node> Nodes;
@@ -138,7 +178,8 @@ public:
      *
      * Note: Uses only local data and does not go over the network.
      */
-    HostAndPort getMatchingHost(const ReadPreferenceSetting& criteria) const;
+    HostAndPort getMatchingHost(const ReadPreferenceSetting& criteria,
+                                const HostAndPort& excludedHost = HostAndPort()) const;
 
     /**
      * Returns the Node with the given host, or NULL if no Node has that host.
@@ -153,6 +194,12 @@ public:
 
     void updateNodeIfInNodes(const IsMasterReply& reply);
 
+    /**
+     * Ejects 'node' from host selection for a while if its request latencies have become outliers
+     * compared to the other nodes in the same role.
+     */
+    void ejectIfRequestLatencyOutlier(Node* node);
+
     /**
      * Returns the connection string of the nodes that are known the be in the set because we've
      * seen them in the isMaster reply of a PRIMARY.
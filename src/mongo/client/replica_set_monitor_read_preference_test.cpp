@@ -1065,4 +1065,82 @@ TEST(TagSet, DefaultConstructorMatchesAll) {
     TagSet tags;
     ASSERT_EQUALS(tags.getTagBSON(), BSON_ARRAY(BSONObj()));
 }
+
+vector<Node> getThreeSecondaries() {
+    vector<Node> nodes;
+    for (const char* host : {"a", "b", "c"}) {
+        nodes.push_back(Node(HostAndPort(host)));
+        nodes.back().isUp = true;
+        nodes.back().latencyMicros = 1000;
+    }
+    return nodes;
+}
+
+TEST(RequestLatency, OutlierIsEjected) {
+    SetState set("name", {HostAndPort("a")});
+    set.nodes = getThreeSecondaries();
+    set.latencyThresholdMicros = 15 * 1000;
+
+    for (size_t i = 0; i < 16; i++) {
+        set.nodes[0].recordRequestLatency(1000);
+        set.nodes[1].recordRequestLatency(2000);
+        set.nodes[2].recordRequestLatency(50 * 1000);
+    }
+    ASSERT_EQUALS(set.nodes[2].recentRequestLatencyPercentile(0.9), 50 * 1000);
+
+    // Neither of the fast hosts is an outlier.
+    set.ejectIfRequestLatencyOutlier(&set.nodes[0]);
+    set.ejectIfRequestLatencyOutlier(&set.nodes[1]);
+    ASSERT_FALSE(set.nodes[0].isEjected(Date_t::now()));
+    ASSERT_FALSE(set.nodes[1].isEjected(Date_t::now()));
+
+    set.ejectIfRequestLatencyOutlier(&set.nodes[2]);
+    ASSERT_TRUE(set.nodes[2].isEjected(Date_t::now()));
+    ASSERT_EQUALS(set.nodes[2].requestLatencySamples, 0U);
+
+    ReadPreferenceSetting criteria(ReadPreference::Nearest, TagSet());
+    for (int i = 0; i < 100; i++) {
+        ASSERT_NOT_EQUALS(set.getMatchingHost(criteria), HostAndPort("c"));
+    }
+
+    // Ejected hosts are still used when nothing else matches.
+    set.nodes[0].isUp = false;
+    set.nodes[1].isUp = false;
+    ASSERT_EQUALS(set.getMatchingHost(criteria), HostAndPort("c"));
+}
+
+TEST(RequestLatency, NotEjectedWithoutPeers) {
+    SetState set("name", {HostAndPort("a")});
+    set.nodes = getThreeSecondaries();
+
+    // The other hosts have too few samples to be compared with.
+    for (size_t i = 0; i < 16; i++) {
+        set.nodes[2].recordRequestLatency(50 * 1000);
+    }
+    set.nodes[0].recordRequestLatency(1000);
+
+    set.ejectIfRequestLatencyOutlier(&set.nodes[2]);
+    ASSERT_FALSE(set.nodes[2].isEjected(Date_t::now()));
+}
+
+TEST(RequestLatency, PreferFewestOutstandingRequests) {
+    SetState set("name", {HostAndPort("a")});
+    set.nodes = getThreeSecondaries();
+    set.latencyThresholdMicros = 15 * 1000;
+
+    set.nodes[0].outstandingRequests = 2;
+    set.nodes[1].outstandingRequests = 0;
+    set.nodes[2].outstandingRequests = 1;
+
+    ReadPreferenceSetting criteria(ReadPreference::Nearest, TagSet());
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQUALS(set.getMatchingHost(criteria), HostAndPort("b"));
+    }
+
+    // Hosts outside of the latency window are not considered, however idle.
+    set.nodes[1].latencyMicros = 100 * 1000;
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQUALS(set.getMatchingHost(criteria), HostAndPort("c"));
+    }
+}
 }
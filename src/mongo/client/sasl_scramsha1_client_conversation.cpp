@@ -30,11 +30,15 @@
 
 #include "mongo/client/sasl_scramsha1_client_conversation.h"
 
+#include <array>
 #include <boost/algorithm/string/replace.hpp>
+#include <map>
+#include <tuple>
 
 #include "mongo/base/parse_number.h"
 #include "mongo/client/sasl_client_session.h"
 #include "mongo/platform/random.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/base64.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/password_digest.h"
@@ -45,6 +49,68 @@ namespace mongo {
 using std::unique_ptr;
 using std::string;
 
+namespace {
+
+/**
+ * Caches the SaltedPassword computed for each user, salt and iteration count, so that a process
+ * opening many connections with the same credentials only runs PBKDF2 for the first of them. The
+ * password is kept with each entry, so a changed password is never matched with an old result.
+ */
+class SaltedPasswordCache {
+public:
+    bool get(const std::string& user,
+             const std::string& hashedPassword,
+             const std::string& salt,
+             int iterationCount,
+             unsigned char saltedPassword[scram::hashSize]) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _entries.find(std::make_tuple(user, salt, iterationCount));
+        if (it == _entries.end() || it->second.hashedPassword != hashedPassword) {
+            return false;
+        }
+        memcpy(saltedPassword, it->second.saltedPassword.data(), scram::hashSize);
+        return true;
+    }
+
+    void put(const std::string& user,
+             const std::string& hashedPassword,
+             const std::string& salt,
+             int iterationCount,
+             const unsigned char saltedPassword[scram::hashSize]) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_entries.size() >= kMaxEntries) {
+            _clear_inlock();
+        }
+        Entry& entry = _entries[std::make_tuple(user, salt, iterationCount)];
+        entry.hashedPassword = hashedPassword;
+        memcpy(entry.saltedPassword.data(), saltedPassword, scram::hashSize);
+    }
+
+private:
+    // Processes authenticate as a handful of users, so the cache is simply emptied if it ever
+    // grows past this
+    static const size_t kMaxEntries = 64;
+
+    struct Entry {
+        std::string hashedPassword;
+        std::array<unsigned char, scram::hashSize> saltedPassword;
+    };
+
+    void _clear_inlock() {
+        for (auto& entry : _entries) {
+            memset(entry.second.saltedPassword.data(), 0, scram::hashSize);
+        }
+        _entries.clear();
+    }
+
+    stdx::mutex _mutex;
+    std::map<std::tuple<std::string, std::string, int>, Entry> _entries;
+};
+
+SaltedPasswordCache saltedPasswordCache;
+
+}  // namespace
+
 SaslSCRAMSHA1ClientConversation::SaslSCRAMSHA1ClientConversation(
     SaslClientSession* saslClientSession)
     : SaslClientConversation(saslClientSession), _step(0), _authMessage(""), _clientNonce("") {}
@@ -180,12 +246,18 @@ StatusWith<bool> SaslSCRAMSHA1ClientConversation::_secondStep(const std::vector<
         return StatusWith<bool>(ex.toStatus());
     }
 
-    scram::generateSaltedPassword(
-        _saslClientSession->getParameter(SaslClientSession::parameterPassword),
-        reinterpret_cast<const unsigned char*>(decodedSalt.c_str()),
-        decodedSalt.size(),
-        iterationCount,
-        _saltedPassword);
+    const std::string user =
+        _saslClientSession->getParameter(SaslClientSession::parameterUser).toString();
+    const std::string hashedPassword =
+        _saslClientSession->getParameter(SaslClientSession::parameterPassword).toString();
+    if (!saltedPasswordCache.get(user, hashedPassword, salt, iterationCount, _saltedPassword)) {
+        scram::generateSaltedPassword(hashedPassword,
+                                      reinterpret_cast<const unsigned char*>(decodedSalt.c_str()),
+                                      decodedSalt.size(),
+                                      iterationCount,
+                                      _saltedPassword);
+        saltedPasswordCache.put(user, hashedPassword, salt, iterationCount, _saltedPassword);
+    }
 
     std::string clientProof = scram::generateClientProof(_saltedPassword, _authMessage);
 
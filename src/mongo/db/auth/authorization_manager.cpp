@@ -585,6 +585,29 @@ void AuthorizationManager::invalidateUsersFromDB(const std::string& dbname) {
     }
 }
 
+void AuthorizationManager::invalidateUsersWithRole(const RoleName& role) {
+    CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
+    _updateCacheGeneration_inlock();
+    unordered_map<UserName, User*>::iterator it = _userCache.begin();
+    while (it != _userCache.end()) {
+        User* user = it->second;
+        bool holdsRole = false;
+        for (RoleNameIterator roles = user->getIndirectRoles(); roles.more(); roles.next()) {
+            if (roles.get() == role) {
+                holdsRole = true;
+                break;
+            }
+        }
+
+        if (holdsRole) {
+            _userCache.erase(it++);
+            user->invalidate();
+        } else {
+            ++it;
+        }
+    }
+}
+
 void AuthorizationManager::invalidateUserCache() {
     CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
     _invalidateUserCache_inlock();
@@ -678,6 +701,50 @@ StatusWith<UserName> extractUserNameFromIdString(StringData idstr) {
         UserName(idstr.substr(splitPoint + 1), idstr.substr(0, splitPoint)));
 }
 
+StatusWith<RoleName> extractRoleNameFromIdString(StringData idstr) {
+    size_t splitPoint = idstr.find('.');
+    if (splitPoint == string::npos) {
+        return StatusWith<RoleName>(ErrorCodes::FailedToParse,
+                                    mongoutils::str::stream()
+                                        << "_id entries for role documents must be of "
+                                           "the form <dbname>.<rolename>.  Found: "
+                                        << idstr);
+    }
+    return StatusWith<RoleName>(
+        RoleName(idstr.substr(splitPoint + 1), idstr.substr(0, splitPoint)));
+}
+
+bool isRolesFieldPath(StringData path) {
+    return path == "roles" || path.startsWith("roles.");
+}
+
+/**
+ * Returns true if the update described by "updatePattern" may change which roles a role inherits
+ * from. Such an update can change the privileges of users who don't hold the updated role, by
+ * creating or breaking a cycle in the role graph.
+ */
+bool updateChangesRoleInheritance(const BSONObj& updatePattern) {
+    for (auto&& field : updatePattern) {
+        if (field.fieldName()[0] != '$') {
+            // A replacement style update, which sets every field of the role.
+            return true;
+        }
+        if (field.type() != Object) {
+            return true;
+        }
+        for (auto&& modified : field.Obj()) {
+            if (isRolesFieldPath(modified.fieldNameStringData())) {
+                return true;
+            }
+            if (modified.type() == String && isRolesFieldPath(modified.valueStringData())) {
+                // The target of a $rename.
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 }  // namespace
 
 void AuthorizationManager::_updateCacheGeneration_inlock() {
@@ -688,8 +755,22 @@ void AuthorizationManager::_invalidateRelevantCacheData(const char* op,
                                                         const char* ns,
                                                         const BSONObj& o,
                                                         const BSONObj* o2) {
-    if (ns == AuthorizationManager::rolesCollectionNamespace.ns() ||
-        ns == AuthorizationManager::versionCollectionNamespace.ns()) {
+    if (ns == AuthorizationManager::rolesCollectionNamespace.ns()) {
+        // Updates to the privileges of a role only affect the users who hold it. Users resolved
+        // while the role graph had a cycle only have the privileges of their direct roles, and
+        // updates that leave the inheritance alone can't change that.
+        if (*op == 'u' && o2 && !updateChangesRoleInheritance(o)) {
+            StatusWith<RoleName> roleName = extractRoleNameFromIdString((*o2)["_id"].str());
+            if (roleName.isOK()) {
+                invalidateUsersWithRole(roleName.getValue());
+                return;
+            }
+        }
+        invalidateUserCache();
+        return;
+    }
+
+    if (ns == AuthorizationManager::versionCollectionNamespace.ns()) {
         invalidateUserCache();
         return;
     }
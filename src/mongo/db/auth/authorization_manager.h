@@ -284,6 +284,12 @@ public:
      */
     void invalidateUsersFromDB(const std::string& dbname);
 
+    /**
+     * Invalidates all users who hold "role", directly or through role inheritance, and removes
+     * them from the user cache.
+     */
+    void invalidateUsersWithRole(const RoleName& role);
+
     /**
      * Initializes the authorization manager.  Depending on what version the authorization
      * system is at, this may involve building up the user cache and/or the roles graph.
@@ -237,6 +237,65 @@ TEST_F(AuthorizationManagerTest, testAcquireV2User) {
     authzManager->releaseUser(v2cluster);
 }
 
+TEST_F(AuthorizationManagerTest, testRolePrivilegeUpdateInvalidatesOnlyUsersWithRole) {
+    OperationContextNoop txn;
+
+    ASSERT_OK(externalState->insertPrivilegeDocument(&txn,
+                                                     BSON("_id"
+                                                          << "test.reader"
+                                                          << "user"
+                                                          << "reader"
+                                                          << "db"
+                                                          << "test"
+                                                          << "credentials"
+                                                          << BSON("MONGODB-CR"
+                                                                  << "password")
+                                                          << "roles"
+                                                          << BSON_ARRAY(BSON("role"
+                                                                             << "read"
+                                                                             << "db"
+                                                                             << "test"))),
+                                                     BSONObj()));
+    ASSERT_OK(externalState->insertPrivilegeDocument(&txn,
+                                                     BSON("_id"
+                                                          << "test.writer"
+                                                          << "user"
+                                                          << "writer"
+                                                          << "db"
+                                                          << "test"
+                                                          << "credentials"
+                                                          << BSON("MONGODB-CR"
+                                                                  << "password")
+                                                          << "roles"
+                                                          << BSON_ARRAY(BSON("role"
+                                                                             << "readWrite"
+                                                                             << "db"
+                                                                             << "test"))),
+                                                     BSONObj()));
+
+    User* reader;
+    ASSERT_OK(authzManager->acquireUser(&txn, UserName("reader", "test"), &reader));
+    User* writer;
+    ASSERT_OK(authzManager->acquireUser(&txn, UserName("writer", "test"), &writer));
+
+    const BSONObj roleId = BSON("_id"
+                                << "test.read");
+    authzManager->logOp(&txn,
+                        "u",
+                        "admin.system.roles",
+                        BSON("$set" << BSON("privileges" << BSONArray())),
+                        &roleId);
+    ASSERT_FALSE(reader->isValid());
+    ASSERT(writer->isValid());
+    authzManager->releaseUser(reader);
+
+    // Changing what a role inherits from can affect every user.
+    authzManager->logOp(
+        &txn, "u", "admin.system.roles", BSON("$set" << BSON("roles" << BSONArray())), &roleId);
+    ASSERT_FALSE(writer->isValid());
+    authzManager->releaseUser(writer);
+}
+
 /**
  * An implementation of AuthzManagerExternalStateMock that overrides the getUserDescription method
  * to return the user document unmodified from how it was inserted.  When using this insert user
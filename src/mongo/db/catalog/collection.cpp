@@ -47,6 +47,7 @@
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/curop.h"
+#include "mongo/db/field_ref_set.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/matcher/expression_parser.h"
@@ -64,6 +65,7 @@
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
+#include "mongo/stdx/chrono.h"
 
 #include "mongo/db/auth/user_document_parser.h"  // XXX-ANDY
 #include "mongo/util/log.h"
@@ -119,6 +121,18 @@ std::unique_ptr<CollatorInterface> parseCollation(OperationContext* txn,
 
     return std::move(collator.getValue());
 }
+
+// Returns whether an update that modified 'updatedFields' could change the keys of the index of
+// 'entry' or whether the document matches its partial filter.
+bool updateAffectsIndex(const FieldRefSet& updatedFields, const IndexCatalogEntry* entry) {
+    const UpdateIndexData& indexedPaths = entry->getIndexedPaths();
+    for (const FieldRef* updatedField : updatedFields) {
+        if (indexedPaths.mightBeIndexed(updatedField->dottedField())) {
+            return true;
+        }
+    }
+    return false;
+}
 }
 
 using std::unique_ptr;
@@ -178,6 +192,32 @@ void CappedInsertNotifier::wait(uint64_t prevVersion, Microseconds timeout) cons
     _wait(lk, prevVersion, timeout);
 }
 
+void CappedInsertNotifier::wait(uint64_t prevVersion,
+                                Microseconds timeout,
+                                Microseconds coalesceWindow) const {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (coalesceWindow <= Microseconds(0)) {
+        _wait(lk, prevVersion, timeout);
+        return;
+    }
+
+    const auto start = stdx::chrono::steady_clock::now();
+    _wait(lk, prevVersion, timeout);
+    if (_dead || prevVersion == _version) {
+        return;
+    }
+
+    auto deadline = stdx::chrono::steady_clock::now() + coalesceWindow.toSystemDuration();
+    if (timeout != Microseconds::max()) {
+        deadline = std::min(deadline, start + timeout.toSystemDuration());
+    }
+    while (!_dead) {
+        if (stdx::cv_status::timeout == _killNotifier.wait_until(lk, deadline)) {
+            return;
+        }
+    }
+}
+
 void CappedInsertNotifier::wait(Microseconds timeout) const {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
     _wait(lk, _version, timeout);
@@ -192,6 +232,7 @@ void CappedInsertNotifier::kill() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     _dead = true;
     _notifier.notify_all();
+    _killNotifier.notify_all();
 }
 
 bool CappedInsertNotifier::isDead() {
@@ -201,6 +242,12 @@ bool CappedInsertNotifier::isDead() {
 
 // ----
 
+// Number of Collection objects currently in memory. Every collection of an open database is
+// instantiated, so this is a measure of how much of the catalog is resident.
+Counter64 collectionObjectCounter;
+ServerStatusMetricField<Counter64> collectionObjectCounterDisplay("catalog.collectionObjects",
+                                                                  &collectionObjectCounter);
+
 Collection::Collection(OperationContext* txn,
                        StringData fullNS,
                        CollectionCatalogEntry* details,
@@ -224,16 +271,22 @@ Collection::Collection(OperationContext* txn,
       _cappedNotifier(_recordStore->isCapped() ? new CappedInsertNotifier() : nullptr),
       _mustTakeCappedLockOnInsert(isCapped() && !_ns.isSystemDotProfile() && !_ns.isOplog()) {
     _magic = 1357924;
+    const BSONObj timeseries = _details->getCollectionOptions(txn).timeseries;
+    if (!timeseries.isEmpty()) {
+        _timeseriesOptions = uassertStatusOK(TimeseriesOptions::parse(timeseries));
+    }
     _indexCatalog.init(txn);
     if (isCapped())
         _recordStore->setCappedCallback(this);
 
     _infoCache.init(txn);
+    collectionObjectCounter.increment();
 }
 
 Collection::~Collection() {
     verify(ok());
     _magic = 0;
+    collectionObjectCounter.decrement();
     if (_cappedNotifier) {
         _cappedNotifier->kill();
     }
@@ -574,7 +627,8 @@ StatusWith<RecordId> Collection::updateDocument(OperationContext* txn,
                                                 bool enforceQuota,
                                                 bool indexesAffected,
                                                 OpDebug* opDebug,
-                                                OplogUpdateEntryArgs* args) {
+                                                OplogUpdateEntryArgs* args,
+                                                const FieldRefSet* updatedFields) {
     {
         auto status = checkValidation(txn, newDoc);
         if (!status.isOK()) {
@@ -604,6 +658,11 @@ StatusWith<RecordId> Collection::updateDocument(OperationContext* txn,
 
     SnapshotId sid = txn->recoveryUnit()->getSnapshotId();
 
+    auto opObserver = getGlobalServiceContext()->getOpObserver();
+    if (opObserver && opObserver->needsPreImage(txn, ns())) {
+        args->preImageDoc = oldDoc.value().getOwned();
+    }
+
     BSONElement oldId = oldDoc.value()["_id"];
     if (!oldId.eoo() && (oldId != newDoc["_id"]))
         return StatusWith<RecordId>(
@@ -635,6 +694,12 @@ StatusWith<RecordId> Collection::updateDocument(OperationContext* txn,
             IndexCatalogEntry* entry = ii.catalogEntry(descriptor);
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
+            // Neither the keys of this index nor whether its partial filter matches can change
+            // unless the update touches one of its paths.
+            if (updatedFields && !updateAffectsIndex(*updatedFields, entry)) {
+                continue;
+            }
+
             InsertDeleteOptions options;
             options.logIfError = false;
             options.dupsAllowed =
@@ -672,10 +737,14 @@ StatusWith<RecordId> Collection::updateDocument(OperationContext* txn,
             IndexDescriptor* descriptor = ii.next();
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
+            auto updateTicket = updateTickets.map().find(descriptor);
+            if (updateTicket == updateTickets.map().end()) {
+                continue;
+            }
+
             int64_t keysInserted;
             int64_t keysDeleted;
-            Status ret = iam->update(
-                txn, *updateTickets.mutableMap()[descriptor], &keysInserted, &keysDeleted);
+            Status ret = iam->update(txn, *updateTicket->second, &keysInserted, &keysDeleted);
             if (!ret.isOK())
                 return StatusWith<RecordId>(ret);
             if (opDebug) {
@@ -688,7 +757,6 @@ StatusWith<RecordId> Collection::updateDocument(OperationContext* txn,
     invariant(sid == txn->recoveryUnit()->getSnapshotId());
     args->updatedDoc = newDoc;
 
-    auto opObserver = getGlobalServiceContext()->getOpObserver();
     if (opObserver)
         opObserver->onUpdate(txn, *args);
 
@@ -778,13 +846,18 @@ StatusWith<RecordData> Collection::updateDocumentWithDamages(
     // Broadcast the mutation so that query results stay correct.
     _cursorManager.invalidateDocument(txn, loc, INVALIDATION_MUTATION);
 
+    // The damages are applied in place, so the old document has to be copied first.
+    auto opObserver = getGlobalServiceContext()->getOpObserver();
+    if (opObserver && opObserver->needsPreImage(txn, ns())) {
+        args->preImageDoc = oldRec.value().toBson().getOwned();
+    }
+
     auto newRecStatus =
         _recordStore->updateWithDamages(txn, loc, oldRec.value(), damageSource, damages);
 
     if (newRecStatus.isOK()) {
         args->updatedDoc = newRecStatus.getValue().toBson();
 
-        auto opObserver = getGlobalServiceContext()->getOpObserver();
         if (opObserver)
             opObserver->onUpdate(txn, *args);
     }
@@ -1235,7 +1308,8 @@ private:
 Status Collection::validate(OperationContext* txn,
                             ValidateCmdLevel level,
                             ValidateResults* results,
-                            BSONObjBuilder* output) {
+                            BSONObjBuilder* output,
+                            bool background) {
     dassert(txn->lockState()->isCollectionLockedForMode(ns().toString(), MODE_IS));
 
     try {
@@ -1289,8 +1363,13 @@ Status Collection::validate(OperationContext* txn,
             }
         }
 
-        // Validate index key count.
-        if (results->valid) {
+        // Validate index key count. The record count of the collection isn't part of the snapshot
+        // a background validate reads, so it can't be compared with the key counts.
+        if (background) {
+            results->warnings.push_back(
+                "Index key counts were not checked against the record count, since the "
+                "validation ran in the background.");
+        } else if (results->valid) {
             IndexCatalog::IndexIterator i = _indexCatalog.getIndexIterator(txn, false);
             while (i.more()) {
                 IndexDescriptor* descriptor = i.next();
@@ -49,6 +49,7 @@
 #include "mongo/db/storage/capped_callback.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/snapshot.h"
+#include "mongo/db/timeseries/timeseries_options.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 
@@ -57,6 +58,7 @@ namespace mongo {
 class CollectionCatalogEntry;
 class DatabaseCatalogEntry;
 class ExtentManager;
+class FieldRefSet;
 class IndexCatalog;
 class MatchExpression;
 class MultiIndexBlock;
@@ -96,9 +98,13 @@ struct CompactOptions {
 struct CompactStats {
     CompactStats() {
         corruptDocuments = 0;
+        bytesFreed = 0;
     }
 
     long long corruptDocuments;
+
+    // How much compacting in place shrank the storage of the collection and its indexes.
+    long long bytesFreed;
 };
 
 /**
@@ -127,6 +133,13 @@ public:
      */
     void wait(uint64_t prevVersion, Microseconds timeout) const;
 
+    /**
+     * Same as above, but once the version has changed, keeps waiting for up to 'coalesceWindow'
+     * longer (without exceeding 'timeout' overall) so that the caller picks up a burst of inserts
+     * in one batch. Further inserts do not wake a thread during that window; only kill() does.
+     */
+    void wait(uint64_t prevVersion, Microseconds timeout, Microseconds coalesceWindow) const;
+
     /**
      * Returns the version for use as an additional wake condition when used above.
      */
@@ -158,6 +171,9 @@ private:
     // Signalled when a successful insert is made into a capped collection.
     mutable stdx::condition_variable _notifier;
 
+    // Signalled only when the notifier is killed. Threads in their coalescing window wait on this.
+    mutable stdx::condition_variable _killNotifier;
+
     // Mutex used with '_notifier'. Protects access to '_version'.
     mutable stdx::mutex _mutex;
 
@@ -314,6 +330,8 @@ public:
      * Sets 'args.updatedDoc' to the updated version of the document with damages applied, on
      * success.
      * 'opDebug' Optional argument. When not null, will be used to record operation statistics.
+     * 'updatedFields' Optional argument. When not null, the paths the update modified; indexes
+     * whose key pattern and partial filter depend on none of them are not updated.
      * @return the post update location of the doc (may or may not be the same as oldLocation)
      */
     StatusWith<RecordId> updateDocument(OperationContext* txn,
@@ -323,7 +341,8 @@ public:
                                         bool enforceQuota,
                                         bool indexesAffected,
                                         OpDebug* opDebug,
-                                        OplogUpdateEntryArgs* args);
+                                        OplogUpdateEntryArgs* args,
+                                        const FieldRefSet* updatedFields = nullptr);
 
     bool updateWithDamagesSupported() const;
 
@@ -356,11 +375,17 @@ public:
      * @return OK if the validate run successfully
      *         OK will be returned even if corruption is found
      *         deatils will be in result
+     *
+     * A 'background' validate runs under an intent lock on a storage engine with document-level
+     * locking, reading a single snapshot of the collection while writes go on. It leaves out the
+     * checks which need the collection not to change: structural verification by the storage
+     * engine and comparing key counts with the collection's record count.
      */
     Status validate(OperationContext* txn,
                     ValidateCmdLevel level,
                     ValidateResults* results,
-                    BSONObjBuilder* output);
+                    BSONObjBuilder* output,
+                    bool background = false);
 
     /**
      * forces data into cache
@@ -445,6 +470,14 @@ public:
      */
     const CollatorInterface* getDefaultCollator() const;
 
+    /**
+     * Returns the options of a time-series collection, whose documents are buckets of
+     * measurements, or null for a regular collection.
+     */
+    const TimeseriesOptions* getTimeseriesOptions() const {
+        return _timeseriesOptions.get_ptr();
+    }
+
 private:
     /**
      * Returns a non-ok Status if document does not pass this collection's validator.
@@ -514,6 +547,9 @@ private:
     static StatusWith<ValidationLevel> _parseValidationLevel(StringData);
     static StatusWith<ValidationAction> _parseValidationAction(StringData);
 
+    // Set only for a time-series collection.
+    boost::optional<TimeseriesOptions> _timeseriesOptions;
+
     // this is mutable because read only users of the Collection class
     // use it keep state.  This seems valid as const correctness of Collection
     // should be about the data.
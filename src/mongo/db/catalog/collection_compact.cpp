@@ -100,7 +100,8 @@ private:
 
 StatusWith<CompactStats> Collection::compact(OperationContext* txn,
                                              const CompactOptions* compactOptions) {
-    dassert(txn->lockState()->isCollectionLockedForMode(ns().toString(), MODE_X));
+    // A record store which compacts in place may do so online, while the collection is written.
+    dassert(txn->lockState()->isCollectionLockedForMode(ns().toString(), MODE_IS));
 
     DisableDocumentValidation validationDisabler(txn);
 
@@ -112,27 +113,43 @@ StatusWith<CompactStats> Collection::compact(OperationContext* txn,
 
     if (_recordStore->compactsInPlace()) {
         CompactStats stats;
+
+        stdx::unique_lock<Client> lk(*txn->getClient());
+        ProgressMeterHolder pm(*txn->setMessage_inlock(
+            "compact", "Compact Progress", 1 + _indexCatalog.numIndexesReady(txn)));
+        lk.unlock();
+
+        const long long sizeBefore = _recordStore->storageSize(txn);
         Status status = _recordStore->compact(txn, NULL, compactOptions, &stats);
         if (!status.isOK())
             return StatusWith<CompactStats>(status);
+        stats.bytesFreed += sizeBefore - _recordStore->storageSize(txn);
+        pm.hit();
 
         // Compact all indexes (not including unfinished indexes)
         IndexCatalog::IndexIterator ii(_indexCatalog.getIndexIterator(txn, false));
         while (ii.more()) {
+            txn->checkForInterrupt();
             IndexDescriptor* descriptor = ii.next();
             IndexAccessMethod* index = _indexCatalog.getIndex(descriptor);
 
             LOG(1) << "compacting index: " << descriptor->toString();
+            const long long indexSizeBefore = index->getSpaceUsedBytes(txn);
             Status status = index->compact(txn);
             if (!status.isOK()) {
                 error() << "failed to compact index: " << descriptor->toString();
                 return status;
             }
+            stats.bytesFreed += indexSizeBefore - index->getSpaceUsedBytes(txn);
+            pm.hit();
         }
+        pm.finished();
 
         return StatusWith<CompactStats>(stats);
     }
 
+    dassert(txn->lockState()->isCollectionLockedForMode(ns().toString(), MODE_X));
+
     if (_indexCatalog.numIndexesInProgress(txn))
         return StatusWith<CompactStats>(ErrorCodes::BadValue,
                                         "cannot compact when indexes in progress");
@@ -35,11 +35,13 @@
 #include "mongo/db/catalog/collection_info_cache.h"
 
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index_legacy.h"
 #include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/query/planner_ixselect.h"
 #include "mongo/db/service_context.h"
 #include "mongo/util/clock_source.h"
@@ -47,6 +49,23 @@
 #include "mongo/util/log.h"
 
 namespace mongo {
+namespace {
+
+// Plan cache usage summed over all collections. collStats reports each collection's own.
+ServerStatusMetricField<Counter64> planCacheHitsDisplay("query.planCache.hits",
+                                                        &PlanCache::globalStats().hits);
+ServerStatusMetricField<Counter64> planCacheMissesDisplay("query.planCache.misses",
+                                                          &PlanCache::globalStats().misses);
+ServerStatusMetricField<Counter64> planCacheEvictionsDisplay(
+    "query.planCache.evictions", &PlanCache::globalStats().evictions);
+ServerStatusMetricField<Counter64> planCacheReplansDisplay("query.planCache.replans",
+                                                           &PlanCache::globalStats().replans);
+ServerStatusMetricField<Counter64> planCachePlanningMillisDisplay(
+    "query.planCache.planningMillis", &PlanCache::globalStats().planningMillis);
+ServerStatusMetricField<Counter64> planCacheSizeBytesDisplay(
+    "query.planCache.sizeBytes", &PlanCache::globalStats().sizeBytes);
+
+}  // namespace
 
 CollectionInfoCache::CollectionInfoCache(Collection* collection)
     : _collection(collection),
@@ -63,6 +82,50 @@ const UpdateIndexData& CollectionInfoCache::getIndexKeys(OperationContext* txn)
     return _indexedPaths;
 }
 
+// static
+void CollectionInfoCache::addIndexedPaths(const IndexDescriptor* descriptor,
+                                          const MatchExpression* filter,
+                                          UpdateIndexData* indexedPaths) {
+    if (descriptor->getAccessMethodName() != IndexNames::TEXT) {
+        BSONObj key = descriptor->keyPattern();
+        BSONObjIterator j(key);
+        while (j.more()) {
+            BSONElement e = j.next();
+            indexedPaths->addPath(e.fieldName());
+        }
+    } else {
+        fts::FTSSpec ftsSpec(descriptor->infoObj());
+
+        if (ftsSpec.wildcard()) {
+            indexedPaths->allPathsIndexed();
+        } else {
+            for (size_t i = 0; i < ftsSpec.numExtraBefore(); ++i) {
+                indexedPaths->addPath(ftsSpec.extraBefore(i));
+            }
+            for (fts::Weights::const_iterator it = ftsSpec.weights().begin();
+                 it != ftsSpec.weights().end();
+                 ++it) {
+                indexedPaths->addPath(it->first);
+            }
+            for (size_t i = 0; i < ftsSpec.numExtraAfter(); ++i) {
+                indexedPaths->addPath(ftsSpec.extraAfter(i));
+            }
+            // Any update to a path containing "language" as a component could change the
+            // language of a subdocument.  Add the override field as a path component.
+            indexedPaths->addPathComponent(ftsSpec.languageOverrideField());
+        }
+    }
+
+    // handle partial indexes
+    if (filter) {
+        unordered_set<std::string> paths;
+        QueryPlannerIXSelect::getFields(filter, "", &paths);
+        for (auto it = paths.begin(); it != paths.end(); ++it) {
+            indexedPaths->addPath(*it);
+        }
+    }
+}
+
 void CollectionInfoCache::computeIndexKeys(OperationContext* txn) {
     _indexedPaths.clear();
 
@@ -70,60 +133,29 @@ void CollectionInfoCache::computeIndexKeys(OperationContext* txn) {
     while (i.more()) {
         IndexDescriptor* descriptor = i.next();
 
-        if (descriptor->getAccessMethodName() != IndexNames::TEXT) {
-            BSONObj key = descriptor->keyPattern();
-            BSONObjIterator j(key);
-            while (j.more()) {
-                BSONElement e = j.next();
-                _indexedPaths.addPath(e.fieldName());
-            }
-        } else {
-            fts::FTSSpec ftsSpec(descriptor->infoObj());
-
-            if (ftsSpec.wildcard()) {
-                _indexedPaths.allPathsIndexed();
-            } else {
-                for (size_t i = 0; i < ftsSpec.numExtraBefore(); ++i) {
-                    _indexedPaths.addPath(ftsSpec.extraBefore(i));
-                }
-                for (fts::Weights::const_iterator it = ftsSpec.weights().begin();
-                     it != ftsSpec.weights().end();
-                     ++it) {
-                    _indexedPaths.addPath(it->first);
-                }
-                for (size_t i = 0; i < ftsSpec.numExtraAfter(); ++i) {
-                    _indexedPaths.addPath(ftsSpec.extraAfter(i));
-                }
-                // Any update to a path containing "language" as a component could change the
-                // language of a subdocument.  Add the override field as a path component.
-                _indexedPaths.addPathComponent(ftsSpec.languageOverrideField());
-            }
-        }
-
-        // handle partial indexes
         const IndexCatalogEntry* entry = i.catalogEntry(descriptor);
-        const MatchExpression* filter = entry->getFilterExpression();
-        if (filter) {
-            unordered_set<std::string> paths;
-            QueryPlannerIXSelect::getFields(filter, "", &paths);
-            for (auto it = paths.begin(); it != paths.end(); ++it) {
-                _indexedPaths.addPath(*it);
-            }
-        }
+        addIndexedPaths(descriptor, entry->getFilterExpression(), &_indexedPaths);
     }
 
     _keysComputed = true;
 }
 
 void CollectionInfoCache::notifyOfQuery(OperationContext* txn,
-                                        const std::set<std::string>& indexesUsed) {
+                                        const PlanSummaryStats& summaryStats) {
+    // The operation was answered from its indexes alone if it never had to fetch a document.
+    const bool covering = summaryStats.totalDocsExamined == 0;
+
     // Record indexes used to fulfill query.
-    for (auto it = indexesUsed.begin(); it != indexesUsed.end(); ++it) {
+    for (const auto& indexName : summaryStats.indexesUsed) {
         // This index should still exist, since the PlanExecutor would have been killed if the
         // index was dropped (and we would not get here).
-        dassert(NULL != _collection->getIndexCatalog()->findIndexByName(txn, *it));
+        dassert(NULL != _collection->getIndexCatalog()->findIndexByName(txn, indexName));
 
-        _indexUsageTracker.recordIndexAccess(*it);
+        auto shape = summaryStats.indexBoundsShapes.find(indexName);
+        _indexUsageTracker.recordIndexAccess(
+            indexName,
+            shape == summaryStats.indexBoundsShapes.end() ? BSONObj() : shape->second,
+            covering);
     }
 }
 
@@ -39,7 +39,9 @@ namespace mongo {
 
 class Collection;
 class IndexDescriptor;
+class MatchExpression;
 class OperationContext;
+struct PlanSummaryStats;
 
 /**
  * this is for storing things that you want to cache about a single collection
@@ -64,6 +66,15 @@ public:
     */
     const UpdateIndexData& getIndexKeys(OperationContext* txn) const;
 
+    /**
+     * Adds to 'indexedPaths' every path whose update could change the keys of the index
+     * described by 'descriptor': the paths of its key pattern and those that 'filter', the
+     * index's partial filter expression if it has one, depends on.
+     */
+    static void addIndexedPaths(const IndexDescriptor* descriptor,
+                                const MatchExpression* filter,
+                                UpdateIndexData* indexedPaths);
+
     /**
      * Returns cached index usage statistics for this collection.  The map returned will contain
      * entry for each index in the collection along with both a usage counter and a timestamp
@@ -100,10 +111,10 @@ public:
     void clearQueryCache();
 
     /**
-     * Signal to the cache that a query operation has completed.  'indexesUsed' should list the
-     * set of indexes used by the winning plan, if any.
+     * Signal to the cache that a query operation has completed.  'summaryStats' should be the
+     * summary of the winning plan, whose 'indexesUsed' lists the set of indexes it used, if any.
      */
-    void notifyOfQuery(OperationContext* txn, const std::set<std::string>& indexesUsed);
+    void notifyOfQuery(OperationContext* txn, const PlanSummaryStats& summaryStats);
 
 private:
     Collection* _collection;  // not owned
@@ -30,6 +30,9 @@
 
 #include "mongo/db/catalog/collection_options.h"
 
+#include <algorithm>
+#include <cctype>
+
 #include "mongo/base/string_data.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -106,6 +109,9 @@ void CollectionOptions::reset() {
     validationLevel = "";
     validationAction = "";
     collation = BSONObj();
+    storageTier = "";
+    summary = BSONObj();
+    timeseries = BSONObj();
 }
 
 bool CollectionOptions::isValid() const {
@@ -220,6 +226,34 @@ Status CollectionOptions::parse(const BSONObj& options) {
             }
 
             collation = e.Obj().getOwned();
+        } else if (fieldName == "storageTier") {
+            if (e.type() != mongo::String) {
+                return Status(ErrorCodes::BadValue, "'storageTier' has to be a string.");
+            }
+
+            // The tier name is a directory name.
+            StringData tier = e.valueStringData();
+            if (tier.empty() || tier.size() > 64 ||
+                std::any_of(tier.begin(), tier.end(), [](char c) {
+                    return !std::isalnum(static_cast<unsigned char>(c)) && c != '_' && c != '-';
+                })) {
+                return Status(ErrorCodes::BadValue,
+                              "'storageTier' has to be at most 64 letters, digits, '_' or '-'.");
+            }
+
+            storageTier = tier.toString();
+        } else if (fieldName == "summary") {
+            if (e.type() != mongo::Object) {
+                return Status(ErrorCodes::BadValue, "'summary' has to be a document.");
+            }
+
+            summary = e.Obj().getOwned();
+        } else if (fieldName == "timeseries") {
+            if (e.type() != mongo::Object) {
+                return Status(ErrorCodes::BadValue, "'timeseries' has to be a document.");
+            }
+
+            timeseries = e.Obj().getOwned();
         }
     }
 
@@ -274,6 +308,18 @@ BSONObj CollectionOptions::toBSON() const {
         b.append("collation", collation);
     }
 
+    if (!storageTier.empty()) {
+        b.append("storageTier", storageTier);
+    }
+
+    if (!summary.isEmpty()) {
+        b.append("summary", summary);
+    }
+
+    if (!timeseries.isEmpty()) {
+        b.append("timeseries", timeseries);
+    }
+
     return b.obj();
 }
 }
@@ -108,5 +108,18 @@ struct CollectionOptions {
 
     // The collection's default collation.
     BSONObj collation;
+
+    // The storage tier of the collection and its indexes, or empty for the default one. KV
+    // storage engines place the files of a tier under "tiers/<name>" in the dbpath, which may be
+    // a mount point or a symlink to another volume.
+    std::string storageTier;
+
+    // The definition of the grouping this collection summarizes, or empty for a regular
+    // collection. See SummaryDefinition. Always owned or empty.
+    BSONObj summary;
+
+    // The options of a time-series collection, or empty for a regular collection. See
+    // TimeseriesOptions. Always owned or empty.
+    BSONObj timeseries;
 };
 }
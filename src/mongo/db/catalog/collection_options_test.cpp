@@ -234,4 +234,46 @@ TEST(CollectionOptions, CollationFieldNotDumpedToBSONWhenOmitted) {
     BSONObj asBSON = options.toBSON();
     ASSERT_FALSE(asBSON["collation"]);
 }
+
+TEST(CollectionOptions, StorageTierRoundTrips) {
+    CollectionOptions options;
+    ASSERT_OK(options.parse(fromjson("{storageTier: 'cold_hdd-1'}")));
+    ASSERT_EQUALS("cold_hdd-1", options.storageTier);
+    ASSERT_EQUALS("cold_hdd-1", options.toBSON()["storageTier"].String());
+
+    CollectionOptions defaults;
+    ASSERT_OK(defaults.parse(fromjson("{capped: true, size: 4096}")));
+    ASSERT_TRUE(defaults.storageTier.empty());
+    ASSERT_FALSE(defaults.toBSON()["storageTier"]);
+}
+
+TEST(CollectionOptions, StorageTierMustBeADirectoryName) {
+    CollectionOptions options;
+    ASSERT_NOT_OK(options.parse(fromjson("{storageTier: 1}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{storageTier: ''}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{storageTier: '../cold'}")));
+    ASSERT_NOT_OK(options.parse(fromjson("{storageTier: 'a/b'}")));
+    ASSERT_NOT_OK(options.parse(BSON("storageTier" << std::string(65, 'a'))));
+}
+
+TEST(CollectionOptions, SummaryRoundTrips) {
+    CollectionOptions options;
+    BSONObj summary = fromjson(
+        "{source: 'sales', groupBy: '$region', accumulators: {total: {$sum: '$amount'}}}");
+    ASSERT_OK(options.parse(BSON("summary" << summary)));
+    ASSERT_EQUALS(summary, options.summary);
+    ASSERT_EQUALS(summary, options.toBSON()["summary"].Obj());
+
+    ASSERT_NOT_OK(options.parse(fromjson("{summary: 'sales'}")));
+}
+
+TEST(CollectionOptions, TimeseriesRoundTrips) {
+    CollectionOptions options;
+    BSONObj timeseries = fromjson("{timeField: 'ts', metaField: 'sensor'}");
+    ASSERT_OK(options.parse(BSON("timeseries" << timeseries)));
+    ASSERT_EQUALS(timeseries, options.timeseries);
+    ASSERT_EQUALS(timeseries, options.toBSON()["timeseries"].Obj());
+
+    ASSERT_NOT_OK(options.parse(fromjson("{timeseries: 'ts'}")));
+}
 }
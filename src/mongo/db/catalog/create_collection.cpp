@@ -38,6 +38,8 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/ops/insert.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/summary_collection.h"
+#include "mongo/db/timeseries/timeseries_options.h"
 
 namespace mongo {
 Status createCollection(OperationContext* txn, const std::string& dbName, const BSONObj& cmdObj) {
@@ -66,6 +68,37 @@ Status createCollection(OperationContext* txn, const std::string& dbName, const
             !options["capped"].trueValue() || options["size"].isNumber() ||
                 options.hasField("$nExtents"));
 
+    std::unique_ptr<SummaryDefinition> summaryDefinition;
+    if (auto summarySpec = options["summary"]) {
+        if (summarySpec.type() != Object) {
+            return Status(ErrorCodes::BadValue, "'summary' has to be a document.");
+        }
+        auto parsed = SummaryDefinition::parse(nss, summarySpec.Obj());
+        if (!parsed.isOK()) {
+            return parsed.getStatus();
+        }
+        summaryDefinition = std::move(parsed.getValue());
+    }
+
+    if (auto timeseriesSpec = options["timeseries"]) {
+        if (timeseriesSpec.type() != Object) {
+            return Status(ErrorCodes::BadValue, "'timeseries' has to be a document.");
+        }
+        auto parsed = TimeseriesOptions::parse(timeseriesSpec.Obj());
+        if (!parsed.isOK()) {
+            return parsed.getStatus();
+        }
+
+        // The documents of a time-series collection are buckets rather than the measurements
+        // which a validator or a summary would look at.
+        if (options["capped"].trueValue() || options.hasField("summary") ||
+            options.hasField("validator")) {
+            return Status(ErrorCodes::InvalidOptions,
+                          "A time-series collection cannot be capped, a summary, or have a "
+                          "validator.");
+        }
+    }
+
     MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
         ScopedTransaction transaction(txn, MODE_IX);
         Lock::DBLock dbXLock(txn->lockState(), dbName, MODE_X);
@@ -84,6 +117,14 @@ Status createCollection(OperationContext* txn, const std::string& dbName, const
             return status;
         }
 
+        // Secondaries receive the documents of a new summary through the oplog.
+        if (summaryDefinition && txn->writesAreReplicated()) {
+            status = populateSummaryCollection(txn, ctx.db(), *summaryDefinition);
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+
         wunit.commit();
     }
     MONGO_WRITE_CONFLICT_RETRY_LOOP_END(txn, "create", nss.ns());
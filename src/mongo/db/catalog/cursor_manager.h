@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include <array>
 
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/invalidation_type.h"
@@ -143,19 +144,39 @@ public:
     static std::size_t timeoutCursorsGlobal(OperationContext* txn, int millisSinceLastCall);
 
 private:
-    CursorId _allocateCursorId_inlock();
+    typedef unordered_set<PlanExecutor*> ExecSet;
+    typedef std::map<CursorId, ClientCursor*> CursorMap;
+
+    // The cursors and registered executors are spread over partitions with a mutex each, so that
+    // getMores and yielding queries on the same collection rarely contend with each other.
+    static const size_t kNumPartitions = 16;
+
+    struct Partition {
+        mutable SimpleMutex mutex;
+        ExecSet nonCachedExecutors;
+        CursorMap cursors;
+    };
+
+    Partition& _partitionForCursor(CursorId id);
+    const Partition& _partitionForCursor(CursorId id) const;
+    Partition& _partitionForExecutor(PlanExecutor* exec);
+
+    /**
+     * Registers 'cc' under a new cursor id, which is returned.
+     */
+    CursorId _allocateCursorId(ClientCursor* cc);
+
+    /**
+     * Must hold the mutex of the partition of 'cc'.
+     */
     void _deregisterCursor_inlock(ClientCursor* cc);
 
     NamespaceString _nss;
     unsigned _collectionCacheRuntimeId;
-    std::unique_ptr<PseudoRandom> _random;
 
-    mutable SimpleMutex _mutex;
+    SimpleMutex _randomMutex;
+    std::unique_ptr<PseudoRandom> _random;  // Guarded by _randomMutex.
 
-    typedef unordered_set<PlanExecutor*> ExecSet;
-    ExecSet _nonCachedExecutors;
-
-    typedef std::map<CursorId, ClientCursor*> CursorMap;
-    CursorMap _cursors;
+    std::array<Partition, kNumPartitions> _partitions;
 };
 }
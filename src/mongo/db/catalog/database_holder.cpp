@@ -84,13 +84,7 @@ Database* DatabaseHolder::get(OperationContext* txn, StringData ns) const {
     const StringData db = _todb(ns);
     invariant(txn->lockState()->isDbLockedForMode(db, MODE_IS));
 
-    stdx::lock_guard<SimpleMutex> lk(_m);
-    DBs::const_iterator it = _dbs.find(db);
-    if (it != _dbs.end()) {
-        return it->second;
-    }
-
-    return NULL;
+    return _dbs.find(db);
 }
 
 Database* DatabaseHolder::openDb(OperationContext* txn, StringData ns, bool* justCreated) {
@@ -136,7 +130,7 @@ Database* DatabaseHolder::openDb(OperationContext* txn, StringData ns, bool* jus
     db = new Database(txn, dbname, entry);
 
     stdx::lock_guard<SimpleMutex> lk(_m);
-    _dbs[dbname] = db;
+    _dbs.insert(dbname, db);
 
     return db;
 }
@@ -145,20 +139,21 @@ void DatabaseHolder::close(OperationContext* txn, StringData ns) {
     // TODO: This should be fine if only a DB X-lock
     invariant(txn->lockState()->isW());
 
-    const StringData dbName = _todb(ns);
+    // Copied, since 'ns' may point into the database which is deleted below.
+    const std::string dbName = _todb(ns).toString();
 
     stdx::lock_guard<SimpleMutex> lk(_m);
 
-    DBs::const_iterator it = _dbs.find(dbName);
-    if (it == _dbs.end()) {
+    Database* db = _dbs.find(dbName);
+    if (!db) {
         return;
     }
 
-    it->second->close(txn);
-    delete it->second;
-    _dbs.erase(it);
+    db->close(txn);
+    delete db;
+    _dbs.erase(dbName);
 
-    getGlobalServiceContext()->getGlobalStorageEngine()->closeDatabase(txn, dbName.toString());
+    getGlobalServiceContext()->getGlobalStorageEngine()->closeDatabase(txn, dbName);
 }
 
 bool DatabaseHolder::closeAll(OperationContext* txn, BSONObjBuilder& result, bool force) {
@@ -167,9 +162,7 @@ bool DatabaseHolder::closeAll(OperationContext* txn, BSONObjBuilder& result, boo
     stdx::lock_guard<SimpleMutex> lk(_m);
 
     set<string> dbs;
-    for (DBs::const_iterator i = _dbs.begin(); i != _dbs.end(); ++i) {
-        dbs.insert(i->first);
-    }
+    _dbs.forEach([&dbs](StringData name, Database*) { dbs.insert(name.toString()); });
 
     BSONArrayBuilder bb(result.subarrayStart("dbs"));
     int nNotClosed = 0;
@@ -185,7 +178,7 @@ bool DatabaseHolder::closeAll(OperationContext* txn, BSONObjBuilder& result, boo
             continue;
         }
 
-        Database* db = _dbs[name];
+        Database* db = _dbs.find(name);
         db->close(txn);
         delete db;
 
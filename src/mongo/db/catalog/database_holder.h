@@ -34,7 +34,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/mutex.h"
-#include "mongo/util/string_map.h"
+#include "mongo/util/read_mostly_string_map.h"
 
 namespace mongo {
 
@@ -83,13 +83,14 @@ public:
      */
     void getAllShortNames(std::set<std::string>& all) const {
         stdx::lock_guard<SimpleMutex> lk(_m);
-        for (DBs::const_iterator j = _dbs.begin(); j != _dbs.end(); ++j) {
-            all.insert(j->first);
-        }
+        _dbs.forEach([&all](StringData name, Database*) { all.insert(name.toString()); });
     }
 
 private:
-    typedef StringMap<Database*> DBs;
+    // Databases are only closed under the global X lock, which excludes every reader since get()
+    // requires a database lock. So get() can search '_dbs' without taking '_m', which only
+    // serializes the changes to it.
+    typedef ReadMostlyStringMap<Database> DBs;
 
     mutable SimpleMutex _m;
     DBs _dbs;
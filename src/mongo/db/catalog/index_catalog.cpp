@@ -1003,7 +1003,11 @@ void IndexCatalog::IndexIterator::_advance() {
 
         if (!_includeUnfinishedIndexes) {
             if (auto minSnapshot = entry->getMinimumVisibleSnapshot()) {
-                if (auto mySnapshot = _txn->recoveryUnit()->getMajorityCommittedSnapshot()) {
+                auto mySnapshot = _txn->recoveryUnit()->getMajorityCommittedSnapshot();
+                if (!mySnapshot) {
+                    mySnapshot = _txn->recoveryUnit()->getLastAppliedSnapshot();
+                }
+                if (mySnapshot) {
                     if (mySnapshot < minSnapshot) {
                         // This index isn't finished in my snapshot.
                         continue;
@@ -1164,6 +1168,22 @@ Status IndexCatalog::_indexFilteredRecords(OperationContext* txn,
     options.logIfError = false;
     options.dupsAllowed = isDupsAllowed(index->descriptor());
 
+    if (bsonRecords.size() > 1) {
+        for (const auto& bsonRecord : bsonRecords) {
+            invariant(bsonRecord.id != RecordId());
+        }
+
+        int64_t inserted;
+        Status status = index->accessMethod()->insertBatch(txn, bsonRecords, options, &inserted);
+        if (!status.isOK())
+            return status;
+
+        if (keysInsertedOut) {
+            *keysInsertedOut += inserted;
+        }
+        return Status::OK();
+    }
+
     for (auto bsonRecord : bsonRecords) {
         int64_t inserted;
         invariant(bsonRecord.id != RecordId());
@@ -1202,6 +1222,13 @@ Status IndexCatalog::_unindexRecord(OperationContext* txn,
                                     const RecordId& loc,
                                     bool logIfError,
                                     int64_t* keysDeletedOut) {
+    // A document that doesn't match the partial filter was never indexed, so there are no keys
+    // to generate or remove for it.
+    const MatchExpression* filter = index->getFilterExpression();
+    if (filter && !filter->matchesBSON(obj)) {
+        return Status::OK();
+    }
+
     InsertDeleteOptions options;
     options.logIfError = logIfError;
     options.dupsAllowed = isDupsAllowed(index->descriptor());
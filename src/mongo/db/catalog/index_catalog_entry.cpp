@@ -36,8 +36,11 @@
 
 #include <algorithm>
 
+#include "mongo/base/counter.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
+#include "mongo/db/catalog/collection_info_cache.h"
 #include "mongo/db/catalog/head_manager.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
@@ -72,6 +75,11 @@ private:
     IndexCatalogEntry* _catalogEntry;
 };
 
+// Number of IndexCatalogEntry objects, and so of open indexes, currently in memory.
+Counter64 indexObjectCounter;
+ServerStatusMetricField<Counter64> indexObjectCounterDisplay("catalog.indexObjects",
+                                                             &indexObjectCounter);
+
 IndexCatalogEntry::IndexCatalogEntry(OperationContext* txn,
                                      StringData ns,
                                      CollectionCatalogEntry* collection,
@@ -118,10 +126,15 @@ IndexCatalogEntry::IndexCatalogEntry(OperationContext* txn,
         LOG(2) << "have filter expression for " << _ns << " " << _descriptor->indexName() << " "
                << filter;
     }
+
+    CollectionInfoCache::addIndexedPaths(_descriptor, _filterExpression.get(), &_indexedPaths);
+
+    indexObjectCounter.increment();
 }
 
 IndexCatalogEntry::~IndexCatalogEntry() {
     _descriptor->_cachedEntry = NULL;  // defensive
+    indexObjectCounter.decrement();
 
     delete _headManager;
     delete _descriptor;
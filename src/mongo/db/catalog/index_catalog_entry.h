@@ -38,6 +38,7 @@
 #include "mongo/db/index/multikey_paths.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/snapshot_name.h"
+#include "mongo/db/update_index_data.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
 
@@ -96,6 +97,14 @@ public:
         return _collator.get();
     }
 
+    /**
+     * The paths whose update could change this index's keys, including those its partial filter
+     * expression depends on. An update that modifies none of them can leave the index alone.
+     */
+    const UpdateIndexData& getIndexedPaths() const {
+        return _indexedPaths;
+    }
+
     /// ---------------------
 
     const RecordId& head(OperationContext* txn) const;
@@ -184,6 +193,9 @@ private:
     std::unique_ptr<CollatorInterface> _collator;
     std::unique_ptr<MatchExpression> _filterExpression;
 
+    // The paths of the key pattern and of '_filterExpression'. Effectively const.
+    UpdateIndexData _indexedPaths;
+
     // cached stuff
 
     Ordering _ordering;  // TODO: this might be b-tree specific
@@ -34,6 +34,10 @@
 
 #include "mongo/db/catalog/index_create.h"
 
+#include <algorithm>
+#include <deque>
+#include <limits>
+
 #include "mongo/base/error_codes.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/audit.h"
@@ -47,7 +51,12 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -64,6 +73,27 @@ using std::endl;
 MONGO_FP_DECLARE(crashAfterStartingIndexBuild);
 MONGO_FP_DECLARE(hangAfterStartingIndexBuild);
 
+namespace {
+
+// The number of side writes a hybrid background build applies to an index per unit of work. Once
+// fewer than this are pending, the rest are left for commit() to apply under the exclusive lock.
+const size_t kSideWritesBatchSize = 1000;
+
+// The most threads which generate the keys of the indexes built by a MultiIndexBlock which allows
+// parallel key generation. No more threads are started than there are indexes to build.
+MONGO_EXPORT_SERVER_PARAMETER(internalIndexBuildKeyGenerationThreads, int, 4);
+
+// The scanned documents are handed to the key generation threads in batches of up to this many
+// documents or bytes.
+const size_t kKeyGenerationBatchSize = 1000;
+const size_t kKeyGenerationBatchBytes = 16 * 1024 * 1024;
+
+// The most batches a key generation thread may fall behind the collection scan before the scan
+// waits for it, which bounds the documents held in memory.
+const size_t kMaxPendingKeyGenerationBatches = 4;
+
+}  // namespace
+
 /**
  * On rollback sets MultiIndexBlock::_needToCleanup to true.
  */
@@ -98,12 +128,228 @@ private:
     MultiIndexBlock* const _indexer;
 };
 
+/**
+ * On commit, makes the indexes' access methods write to them directly again.
+ */
+class MultiIndexBlock::StopCapturingSideWritesOnCommit : public RecoveryUnit::Change {
+public:
+    explicit StopCapturingSideWritesOnCommit(MultiIndexBlock* indexer) : _indexer(indexer) {}
+
+    virtual void commit() {
+        for (auto&& index : _indexer->_indexes) {
+            index.real->stopCapturingSideWrites();
+        }
+    }
+    virtual void rollback() {}
+
+private:
+    MultiIndexBlock* const _indexer;
+};
+
+/**
+ * Threads which each insert the keys of some of the indexes of a MultiIndexBlock into their bulk
+ * builders, so that the collection is scanned only once however many indexes are built. Every
+ * thread has its own Client and OperationContext, whose CurOp reports the progress of its indexes.
+ */
+class MultiIndexBlock::KeyGenerationWorkers {
+    MONGO_DISALLOW_COPYING(KeyGenerationWorkers);
+
+public:
+    using Batch = std::vector<std::pair<BSONObj, RecordId>>;
+
+    /**
+     * Starts 'numWorkers' threads, dividing every bulk build in 'indexes' among them.
+     */
+    KeyGenerationWorkers(std::vector<IndexToBuild>* indexes,
+                         size_t numWorkers,
+                         unsigned long long numRecords) {
+        for (size_t i = 0; i < numWorkers; i++) {
+            _workers.push_back(stdx::make_unique<Worker>());
+        }
+        size_t next = 0;
+        for (auto&& index : *indexes) {
+            if (index.bulk) {
+                _workers[next++ % numWorkers]->indexes.push_back(&index);
+            }
+        }
+        for (auto&& worker : _workers) {
+            Worker* const w = worker.get();
+            w->thread = stdx::thread([this, w, numRecords] { _run(w, numRecords); });
+        }
+    }
+
+    ~KeyGenerationWorkers() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _done = true;
+            for (auto&& worker : _workers) {
+                worker->pending.clear();
+            }
+        }
+        _condition.notify_all();
+        for (auto&& worker : _workers) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+    }
+
+    /**
+     * Hands 'batch' to every thread, first waiting for any thread which has fallen too far behind.
+     * Returns the first error any thread ran into, in which case 'batch' is dropped.
+     */
+    Status add(std::shared_ptr<const Batch> batch) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _condition.wait(lk, [this] {
+            for (auto&& worker : _workers) {
+                if (!worker->status.isOK()) {
+                    return true;
+                }
+                if (worker->pending.size() >= kMaxPendingKeyGenerationBatches) {
+                    return false;
+                }
+            }
+            return true;
+        });
+
+        Status status = _firstError_inlock();
+        if (!status.isOK()) {
+            return status;
+        }
+        for (auto&& worker : _workers) {
+            worker->pending.push_back(batch);
+        }
+        lk.unlock();
+        _condition.notify_all();
+        return Status::OK();
+    }
+
+    /**
+     * Waits for every thread to insert the keys of every batch and stops the threads. Returns the
+     * first error any thread ran into.
+     */
+    Status finish() {
+        {
+            stdx::unique_lock<stdx::mutex> lk(_mutex);
+            _condition.wait(lk, [this] {
+                for (auto&& worker : _workers) {
+                    if (worker->busy || !worker->pending.empty()) {
+                        return false;
+                    }
+                }
+                return true;
+            });
+            _done = true;
+        }
+        _condition.notify_all();
+        for (auto&& worker : _workers) {
+            worker->thread.join();
+        }
+        return _firstError_inlock();
+    }
+
+private:
+    struct Worker {
+        std::vector<IndexToBuild*> indexes;
+        std::deque<std::shared_ptr<const Batch>> pending;
+        bool busy = false;
+        Status status = Status::OK();
+        stdx::thread thread;
+    };
+
+    void _run(Worker* worker, unsigned long long numRecords) {
+        Client::initThread("indexKeyGeneration");
+        const auto txn = cc().makeOperationContext();
+
+        std::string indexNames;
+        for (auto&& index : worker->indexes) {
+            indexNames += (indexNames.empty() ? "" : ", ") +
+                index->block->getEntry()->descriptor()->indexName();
+        }
+        const char* curopMessage = "Index Build: generating keys";
+        stdx::unique_lock<Client> clientLock(*txn->getClient());
+        ProgressMeterHolder progress(*txn->setMessage_inlock(
+            curopMessage, str::stream() << curopMessage << " for " << indexNames, numRecords));
+        clientLock.unlock();
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        while (true) {
+            _condition.wait(lk, [&] { return _done || !worker->pending.empty(); });
+            if (worker->pending.empty()) {
+                return;
+            }
+            const auto batch = std::move(worker->pending.front());
+            worker->pending.pop_front();
+            worker->busy = true;
+            // Once any thread fails the index build does too, so the rest of its batches are
+            // skipped.
+            const bool failed = !_firstError_inlock().isOK();
+            lk.unlock();
+
+            Status status = Status::OK();
+            if (!failed) {
+                status = _insertKeys(txn.get(), worker->indexes, *batch);
+                progress.hit(batch->size());
+            }
+
+            lk.lock();
+            worker->busy = false;
+            if (!status.isOK()) {
+                worker->status = status;
+            }
+            _condition.notify_all();
+        }
+    }
+
+    static Status _insertKeys(OperationContext* txn,
+                              const std::vector<IndexToBuild*>& indexes,
+                              const Batch& batch) {
+        try {
+            for (auto&& doc : batch) {
+                for (auto&& index : indexes) {
+                    if (index->filterExpression &&
+                        !index->filterExpression->matchesBSON(doc.first)) {
+                        continue;
+                    }
+                    int64_t unused;
+                    Status status =
+                        index->bulk->insert(txn, doc.first, doc.second, index->options, &unused);
+                    if (!status.isOK()) {
+                        return status;
+                    }
+                }
+            }
+        } catch (const DBException& ex) {
+            return ex.toStatus();
+        }
+        return Status::OK();
+    }
+
+    // Must hold '_mutex', or have joined every thread.
+    Status _firstError_inlock() const {
+        for (auto&& worker : _workers) {
+            if (!worker->status.isOK()) {
+                return worker->status;
+            }
+        }
+        return Status::OK();
+    }
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _condition;
+    bool _done = false;
+    std::vector<std::unique_ptr<Worker>> _workers;
+};
+
 MultiIndexBlock::MultiIndexBlock(OperationContext* txn, Collection* collection)
     : _collection(collection),
       _txn(txn),
       _buildInBackground(false),
+      _hybridBuild(false),
       _allowInterruption(false),
       _ignoreUnique(false),
+      _parallelBulkCommit(false),
+      _parallelKeyGeneration(false),
       _needToCleanup(true) {}
 
 MultiIndexBlock::~MultiIndexBlock() {
@@ -178,6 +424,10 @@ Status MultiIndexBlock::init(const std::vector<BSONObj>& indexSpecs) {
         _buildInBackground = (_buildInBackground && info["background"].trueValue());
     }
 
+    // Without document-level locking, other operations can't write to the collection while its
+    // indexes are bulk loaded, so there would be no concurrency left to the background build.
+    _hybridBuild = _buildInBackground && supportsDocLocking();
+
     for (size_t i = 0; i < indexSpecs.size(); i++) {
         BSONObj info = indexSpecs[i];
         StatusWith<BSONObj> statusWithInfo =
@@ -198,10 +448,14 @@ Status MultiIndexBlock::init(const std::vector<BSONObj>& indexSpecs) {
         if (!status.isOK())
             return status;
 
-        if (!_buildInBackground) {
-            // Bulk build process requires foreground building as it assumes nothing is changing
-            // under it.
+        if (!_buildInBackground || _hybridBuild) {
+            // Bulk build process assumes nothing is changing under it, so a background build
+            // captures the writes of other operations on the side until the index is loaded.
+            // This must start before the exclusive lock is released.
             index.bulk = index.real->initiateBulk();
+            if (_hybridBuild) {
+                index.real->beginCapturingSideWrites();
+            }
         }
 
         const IndexDescriptor* descriptor = index.block->getEntry()->descriptor();
@@ -213,6 +467,8 @@ Status MultiIndexBlock::init(const std::vector<BSONObj>& indexSpecs) {
         log() << "build index on: " << ns << " properties: " << descriptor->toString();
         if (index.bulk)
             log() << "\t building index using bulk method";
+        if (_hybridBuild)
+            log() << "\t capturing concurrent writes until the index is loaded";
 
         index.filterExpression = index.block->getEntry()->getFilterExpression();
 
@@ -260,6 +516,23 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(std::set<RecordId>* dupsO
         exec->setYieldPolicy(PlanExecutor::WRITE_CONFLICT_RETRY_ONLY, _collection);
     }
 
+    // Bulk builders only write to the storage engine once the scan is done, so their keys can be
+    // generated on other threads.
+    std::unique_ptr<KeyGenerationWorkers> keyGenerators;
+    const size_t numBulkBuilds =
+        std::count_if(_indexes.begin(), _indexes.end(), [](const IndexToBuild& index) {
+            return static_cast<bool>(index.bulk);
+        });
+    const size_t maxKeyGenerators =
+        static_cast<size_t>(std::max(1, internalIndexBuildKeyGenerationThreads.load()));
+    const size_t numKeyGenerators = std::min(numBulkBuilds, maxKeyGenerators);
+    if (_parallelKeyGeneration && numBulkBuilds == _indexes.size() && numKeyGenerators > 1) {
+        keyGenerators =
+            stdx::make_unique<KeyGenerationWorkers>(&_indexes, numKeyGenerators, numRecords);
+    }
+    auto batch = std::make_shared<KeyGenerationWorkers::Batch>();
+    size_t batchBytes = 0;
+
     Snapshotted<BSONObj> objToIndex;
     RecordId loc;
     PlanExecutor::ExecState state;
@@ -281,22 +554,35 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(std::set<RecordId>* dupsO
             // Done before insert so we can retry document if it WCEs.
             progress->setTotalWhileRunning(_collection->numRecords(_txn));
 
-            WriteUnitOfWork wunit(_txn);
-            Status ret = insert(objToIndex.value(), loc);
-            if (_buildInBackground)
-                exec->saveState();
-            if (ret.isOK()) {
-                wunit.commit();
-            } else if (dupsOut && ret.code() == ErrorCodes::DuplicateKey) {
-                // If dupsOut is non-null, we should only fail the specific insert that
-                // led to a DuplicateKey rather than the whole index build.
-                dupsOut->insert(loc);
+            if (keyGenerators) {
+                batch->emplace_back(objToIndex.value().getOwned(), loc);
+                batchBytes += objToIndex.value().objsize();
+                if (batch->size() >= kKeyGenerationBatchSize ||
+                    batchBytes >= kKeyGenerationBatchBytes) {
+                    Status ret = keyGenerators->add(std::move(batch));
+                    if (!ret.isOK())
+                        return ret;
+                    batch = std::make_shared<KeyGenerationWorkers::Batch>();
+                    batchBytes = 0;
+                }
             } else {
-                // Fail the index build hard.
-                return ret;
+                WriteUnitOfWork wunit(_txn);
+                Status ret = insert(objToIndex.value(), loc);
+                if (_buildInBackground)
+                    exec->saveState();
+                if (ret.isOK()) {
+                    wunit.commit();
+                } else if (dupsOut && ret.code() == ErrorCodes::DuplicateKey) {
+                    // If dupsOut is non-null, we should only fail the specific insert that
+                    // led to a DuplicateKey rather than the whole index build.
+                    dupsOut->insert(loc);
+                } else {
+                    // Fail the index build hard.
+                    return ret;
+                }
+                if (_buildInBackground)
+                    exec->restoreState();  // Handles any WCEs internally.
             }
-            if (_buildInBackground)
-                exec->restoreState();  // Handles any WCEs internally.
 
             // Go to the next document
             progress->hit();
@@ -320,6 +606,14 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(std::set<RecordId>* dupsO
                 WorkingSetCommon::toStatusString(objToIndex.value()),
             state == PlanExecutor::IS_EOF);
 
+    if (keyGenerators) {
+        Status ret = batch->empty() ? Status::OK() : keyGenerators->add(std::move(batch));
+        if (ret.isOK())
+            ret = keyGenerators->finish();
+        if (!ret.isOK())
+            return ret;
+    }
+
     // Need the index build to hang before the progress meter is marked as finished so we can
     // reliably check that the index build has actually started in js tests.
     while (MONGO_FAIL_POINT(hangAfterStartingIndexBuild)) {
@@ -360,6 +654,107 @@ Status MultiIndexBlock::insert(const BSONObj& doc, const RecordId& loc) {
 }
 
 Status MultiIndexBlock::doneInserting(std::set<RecordId>* dupsOut) {
+    if (!_hybridBuild) {
+        return _commitBulkBuilds(dupsOut);
+    }
+
+    // Keys which collide while the indexes are loaded may belong to documents which other
+    // operations changed after they were scanned, so their documents are reindexed along with the
+    // side writes rather than reported right away.
+    std::set<RecordId> bulkDups;
+    Status status = _commitBulkBuilds(&bulkDups);
+    if (!status.isOK()) {
+        return status;
+    }
+    for (auto&& index : _indexes) {
+        for (auto&& loc : bulkDups) {
+            index.real->recordSideWrite(loc);
+        }
+    }
+
+    // Other operations keep writing to the collection while the side writes are drained, so this
+    // only brings them down to a number commit() can apply quickly under the exclusive lock.
+    std::set<RecordId> retryDups;
+    while (true) {
+        size_t maxPending = 0;
+        for (auto&& index : _indexes) {
+            maxPending = std::max(maxPending, index.real->numPendingSideWrites());
+        }
+        if (maxPending <= kSideWritesBatchSize) {
+            break;
+        }
+
+        status = _drainSideWrites(kSideWritesBatchSize, &retryDups);
+        if (!status.isOK()) {
+            return status;
+        }
+    }
+
+    // A document which collided with another may not anymore, now that the writes which changed
+    // the other one have been applied. Those which still do violate the uniqueness constraint.
+    for (auto&& index : _indexes) {
+        for (auto&& loc : retryDups) {
+            index.real->recordSideWrite(loc);
+        }
+    }
+    status = _drainSideWrites(std::numeric_limits<size_t>::max(), dupsOut);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    // commit() reads the documents left to reindex at the snapshot it opens after the exclusive
+    // lock is taken.
+    _txn->recoveryUnit()->abandonSnapshot();
+    return Status::OK();
+}
+
+Status MultiIndexBlock::_drainSideWrites(size_t maxWrites, std::set<RecordId>* dupsOut) {
+    for (auto&& index : _indexes) {
+        size_t remaining = std::min(maxWrites, index.real->numPendingSideWrites());
+        while (remaining > 0) {
+            if (_allowInterruption)
+                _txn->checkForInterrupt();
+
+            const size_t batchSize = std::min(remaining, kSideWritesBatchSize);
+            std::set<RecordId> batchDups;
+            MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
+                // The documents must be read at a snapshot which includes every write in the
+                // batch.
+                _txn->recoveryUnit()->abandonSnapshot();
+                batchDups.clear();
+
+                WriteUnitOfWork wunit(_txn);
+                Status status = index.real->drainSideWrites(_txn,
+                                                            _collection->getRecordStore(),
+                                                            index.options,
+                                                            batchSize,
+                                                            dupsOut ? &batchDups : NULL);
+                if (!status.isOK()) {
+                    return status;
+                }
+                wunit.commit();
+            }
+            MONGO_WRITE_CONFLICT_RETRY_LOOP_END(
+                _txn, "applying side writes to index", _collection->ns().ns());
+
+            if (dupsOut) {
+                dupsOut->insert(batchDups.begin(), batchDups.end());
+            }
+            remaining -= batchSize;
+        }
+    }
+    return Status::OK();
+}
+
+Status MultiIndexBlock::_commitBulkBuilds(std::set<RecordId>* dupsOut) {
+    const auto numBulkBuilds =
+        std::count_if(_indexes.begin(), _indexes.end(), [](const IndexToBuild& index) {
+            return static_cast<bool>(index.bulk);
+        });
+    if (_parallelBulkCommit && numBulkBuilds > 1 && supportsDocLocking()) {
+        return _doneInsertingInParallel(dupsOut);
+    }
+
     for (size_t i = 0; i < _indexes.size(); i++) {
         if (_indexes[i].bulk == NULL)
             continue;
@@ -378,12 +773,85 @@ Status MultiIndexBlock::doneInserting(std::set<RecordId>* dupsOut) {
     return Status::OK();
 }
 
+Status MultiIndexBlock::_doneInsertingInParallel(std::set<RecordId>* dupsOut) {
+    struct BulkCommit {
+        explicit BulkCommit(IndexToBuild* index) : index(index) {}
+
+        IndexToBuild* index;
+        Status status = Status::OK();
+        std::set<RecordId> dups;
+    };
+
+    // Setting the multikey flag writes to the collection's catalog entry, which requires the
+    // locks held by '_txn'. Once it is set, commitBulk() only touches the index's own table.
+    std::vector<BulkCommit> commits;
+    for (auto&& index : _indexes) {
+        if (!index.bulk)
+            continue;
+        index.real->setMultikeyForBulk(_txn, *index.bulk);
+        commits.emplace_back(&index);
+    }
+
+    std::vector<stdx::thread> threads;
+    threads.reserve(commits.size());
+    for (auto&& commit : commits) {
+        threads.emplace_back([&commit, dupsOut] {
+            Client::initThread("indexBulkCommit");
+            const auto txn = cc().makeOperationContext();
+
+            LOG(1) << "\t bulk commit starting for index: "
+                   << commit.index->block->getEntry()->descriptor()->indexName();
+            try {
+                commit.status = commit.index->real->commitBulk(txn.get(),
+                                                               std::move(commit.index->bulk),
+                                                               false,
+                                                               commit.index->options.dupsAllowed,
+                                                               dupsOut ? &commit.dups : NULL);
+            } catch (const DBException& ex) {
+                commit.status = ex.toStatus();
+            }
+        });
+    }
+
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    for (auto&& commit : commits) {
+        if (!commit.status.isOK()) {
+            return commit.status;
+        }
+        if (dupsOut) {
+            dupsOut->insert(commit.dups.begin(), commit.dups.end());
+        }
+    }
+
+    if (_allowInterruption) {
+        _txn->checkForInterrupt();
+    }
+
+    return Status::OK();
+}
+
 void MultiIndexBlock::abortWithoutCleanup() {
     _indexes.clear();
     _needToCleanup = false;
 }
 
 void MultiIndexBlock::commit() {
+    if (_hybridBuild) {
+        // No other operation can write to the collection anymore, so this drains every side
+        // write. They are only discarded, and the indexes written to directly, if we commit.
+        for (auto&& index : _indexes) {
+            uassertStatusOK(index.real->drainSideWrites(_txn,
+                                                        _collection->getRecordStore(),
+                                                        index.options,
+                                                        std::numeric_limits<size_t>::max(),
+                                                        NULL));
+        }
+        _txn->recoveryUnit()->registerChange(new StopCapturingSideWritesOnCommit(this));
+    }
+
     for (size_t i = 0; i < _indexes.size(); i++) {
         _indexes[i].block->success();
     }
@@ -75,6 +75,11 @@ public:
      * be built in the foreground, as there is no concurrency benefit to building a subset of
      * indexes in the background, but there is a performance benefit to building all in the
      * foreground.
+     *
+     * On storage engines with document-level locking, a background build still bulk loads each
+     * index from its external sorter. The writes other operations make while the collection is
+     * scanned are captured on the side instead of going to the index, and are applied once it is
+     * loaded: mostly by doneInserting(), and the remainder by commit().
      */
     void allowBackgroundBuilding() {
         _buildInBackground = true;
@@ -99,6 +104,29 @@ public:
         _ignoreUnique = true;
     }
 
+    /**
+     * Call this before doneInserting() to build the bottom layer of each index on its own thread.
+     * Every index already has its own external sorter, so the only shared work is marking indexes
+     * multikey, which is done up front on the calling thread. This is ignored on storage engines
+     * without document-level locking.
+     *
+     * The bottom-up builds are not interruptible when run in parallel; if allowInterruption() was
+     * called, doneInserting() checks for interruption once they complete.
+     */
+    void allowParallelBulkCommit() {
+        _parallelBulkCommit = true;
+    }
+
+    /**
+     * Call this before insertAllDocumentsInCollection() to generate the keys of several bulk built
+     * indexes on worker threads while the calling thread scans the collection once. Each worker
+     * owns a subset of the indexes and reports its progress through its own CurOp. This is ignored
+     * unless at least two indexes are bulk built.
+     */
+    void allowParallelKeyGeneration() {
+        _parallelKeyGeneration = true;
+    }
+
     /**
      * Removes pre-existing indexes from 'specs'. If this isn't done, init() may fail with
      * IndexAlreadyExists.
@@ -158,6 +186,9 @@ public:
      * Marks the index ready for use. Should only be called as the last method after
      * doneInserting() or insertAllDocumentsInCollection() return success.
      *
+     * A background build first applies the writes other operations made to the collection since
+     * doneInserting() drained them, and throws if one of those violates a uniqueness constraint.
+     *
      * Should be called inside of a WriteUnitOfWork. If the index building is to be logOp'd,
      * logOp() should be called from the same unit of work as commit().
      *
@@ -188,6 +219,28 @@ public:
 private:
     class SetNeedToCleanupOnRollback;
     class CleanupIndexesVectorOnRollback;
+    class StopCapturingSideWritesOnCommit;
+    class KeyGenerationWorkers;
+
+    /**
+     * Implements doneInserting() when '_parallelBulkCommit' is set, running every bulk commit on
+     * a separate thread with its own Client and OperationContext.
+     */
+    Status _doneInsertingInParallel(std::set<RecordId>* dupsOut);
+
+    /**
+     * Commits every bulk build, on separate threads if '_parallelBulkCommit' is set.
+     */
+    Status _commitBulkBuilds(std::set<RecordId>* dupsOut);
+
+    /**
+     * Applies up to 'maxWrites' of the side writes captured for each index during a hybrid
+     * background build, in units of work of their own. If 'dupsOut' is not NULL, documents which
+     * violate a uniqueness constraint are added to it rather than failing.
+     *
+     * Should not be called inside of a WriteUnitOfWork.
+     */
+    Status _drainSideWrites(size_t maxWrites, std::set<RecordId>* dupsOut);
 
     struct IndexToBuild {
         std::unique_ptr<IndexCatalog::IndexBuildBlock> block;
@@ -208,8 +261,15 @@ private:
     OperationContext* _txn;
 
     bool _buildInBackground;
+
+    // Set by init() for a background build which bulk loads its indexes while capturing the
+    // writes of other operations on the side.
+    bool _hybridBuild;
+
     bool _allowInterruption;
     bool _ignoreUnique;
+    bool _parallelBulkCommit;
+    bool _parallelKeyGeneration;
 
     bool _needToCleanup;
 };
@@ -47,6 +47,8 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/db/summary_collection.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -112,6 +114,16 @@ Status renameCollection(OperationContext* txn,
         }
     }
 
+    // A summary is maintained from its source by name, and its source is named relative to its
+    // database.
+    auto summaryCatalog = SummaryCatalog::get(txn->getServiceContext());
+    if (summaryCatalog->isSummaryOrSource(txn, source) ||
+        summaryCatalog->isSummaryOrSource(txn, target)) {
+        return Status(ErrorCodes::IllegalOperation,
+                      str::stream() << "Cannot rename " << source.ns() << " to " << target.ns()
+                                    << " because of a summary collection");
+    }
+
     BackgroundOperation::assertNoBgOpInProgForNs(source.ns());
 
     Database* const targetDB = dbHolder().openDb(txn, target.db());
@@ -201,13 +213,29 @@ Status renameCollection(OperationContext* txn,
     }
 
     {
-        // Copy over all the data from source collection to target collection.
+        // Copy over all the data from source collection to target collection. The target is new
+        // and nothing else can write to it, so its records can be loaded in bulk when the storage
+        // engine supports it. The documents passed validation when they were first inserted.
+        auto recordLoader = targetColl->getRecordStore()->getBulkLoader(txn);
         auto cursor = sourceColl->getCursor(txn);
         while (auto record = cursor->next()) {
             txn->checkForInterrupt();
 
             const auto obj = record->data.releaseToBson();
 
+            if (recordLoader) {
+                auto loc = recordLoader->insertRecord(obj.objdata(), obj.objsize());
+                if (!loc.isOK())
+                    return loc.getStatus();
+
+                WriteUnitOfWork wunit(txn);
+                Status status = indexer.insert(obj, loc.getValue());
+                if (!status.isOK())
+                    return status;
+                wunit.commit();
+                continue;
+            }
+
             WriteUnitOfWork wunit(txn);
             // No logOp necessary because the entire renameCollection command is one logOp.
             bool shouldReplicateWrites = txn->writesAreReplicated();
@@ -218,6 +246,12 @@ Status renameCollection(OperationContext* txn,
                 return status;
             wunit.commit();
         }
+
+        if (recordLoader) {
+            Status status = recordLoader->commit(txn);
+            if (!status.isOK())
+                return status;
+        }
     }
 
     Status status = indexer.doneInserting();
@@ -90,6 +90,22 @@ public:
      */
     static void destroy();
 
+    /**
+     * Detaches the Client object stored in TLS for the current thread and returns it to the
+     * caller, leaving the current thread without a Client. Returns nullptr if the current thread
+     * has no Client.
+     *
+     * Together with setCurrent(), this allows a Client to be serviced by different threads over
+     * its lifetime, for example by a pool of worker threads shared among many connections.
+     */
+    static ServiceContext::UniqueClient releaseCurrent();
+
+    /**
+     * Attaches "client" to the current thread, which must not already have a Client, and sets
+     * the thread name to the Client's description.
+     */
+    static void setCurrent(ServiceContext::UniqueClient client);
+
     std::string clientAddress(bool includePort = false) const;
     const std::string& desc() const {
         return _desc;
@@ -166,7 +182,7 @@ private:
     const std::string _desc;
 
     // OS id of the thread, which owns this client
-    const stdx::thread::id _threadId;
+    stdx::thread::id _threadId;
 
     // > 0 for things "conn", 0 otherwise
     const ConnectionId _connectionId;
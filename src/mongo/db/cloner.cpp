@@ -419,7 +419,7 @@ bool Cloner::copyCollection(OperationContext* txn,
     // main data
     CloneOptions opts;
     opts.slaveOk = true;
-    copy(txn, dbname, nss, options, nss, false, opts, Query(query).snapshot());
+    copy(txn, dbname, nss, options, nss, false, opts, Query(query).snapshot().rawData());
 
     /* TODO : copyIndexes bool does not seem to be implemented! */
     if (!shouldCopyIndexes) {
@@ -608,6 +608,7 @@ Status Cloner::copyDb(OperationContext* txn,
             Query q;
             if (opts.snapshot)
                 q.snapshot();
+            q.rawData();
 
             copy(txn, toDBName, from_name, options, to_name, masterSameProcess, opts, q);
 
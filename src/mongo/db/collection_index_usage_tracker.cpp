@@ -37,16 +37,46 @@
 
 namespace mongo {
 
+const size_t CollectionIndexUsageTracker::kMaxBoundsShapes;
+
 CollectionIndexUsageTracker::CollectionIndexUsageTracker(ClockSource* clockSource)
     : _clockSource(clockSource) {
     invariant(_clockSource);
 }
 
 void CollectionIndexUsageTracker::recordIndexAccess(StringData indexName) {
+    recordIndexAccess(indexName, BSONObj(), false);
+}
+
+void CollectionIndexUsageTracker::recordIndexAccess(StringData indexName,
+                                                    const BSONObj& boundsShape,
+                                                    bool covering) {
     invariant(!indexName.empty());
     dassert(_indexUsageMap.find(indexName) != _indexUsageMap.end());
 
-    _indexUsageMap[indexName].accesses.fetchAndAdd(1);
+    auto& stats = _indexUsageMap[indexName];
+    stats.accesses.fetchAndAdd(1);
+    if (covering) {
+        stats.coveringAccesses.fetchAndAdd(1);
+    }
+
+    if (boundsShape.isEmpty()) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_boundsShapesMutex);
+    for (auto& shapeCount : stats.boundsShapes) {
+        if (shapeCount.first.binaryEqual(boundsShape)) {
+            ++shapeCount.second;
+            return;
+        }
+    }
+
+    if (stats.boundsShapes.size() < kMaxBoundsShapes) {
+        stats.boundsShapes.emplace_back(boundsShape.getOwned(), 1);
+    } else {
+        ++stats.otherBoundsShapeAccesses;
+    }
 }
 
 void CollectionIndexUsageTracker::registerIndex(StringData indexName, const BSONObj& indexKey) {
@@ -64,6 +94,7 @@ void CollectionIndexUsageTracker::unregisterIndex(StringData indexName) {
 }
 
 CollectionIndexUsageMap CollectionIndexUsageTracker::getUsageStats() const {
+    stdx::lock_guard<stdx::mutex> lk(_boundsShapesMutex);
     return _indexUsageMap;
 }
 
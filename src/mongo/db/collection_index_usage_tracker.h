@@ -28,10 +28,14 @@
 
 #pragma once
 
+#include <utility>
+#include <vector>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/string_data.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/string_map.h"
 #include "mongo/util/time_support.h"
 
@@ -42,7 +46,8 @@ class ClockSource;
 /**
  * CollectionIndexUsageTracker tracks index usage statistics for a collection.  An index is
  * considered "used" when it appears as part of a winning plan for an operation that uses the
- * query system.
+ * query system. Besides counting the operations that used each index, it profiles how they used
+ * it: how many never fetched a document, and the shapes of the bounds they scanned.
  *
  * Indexes must be registered and deregistered on creation/destruction.
  */
@@ -57,11 +62,17 @@ public:
 
         IndexUsageStats(const IndexUsageStats& other)
             : accesses(other.accesses.load()),
+              coveringAccesses(other.coveringAccesses.load()),
+              boundsShapes(other.boundsShapes),
+              otherBoundsShapeAccesses(other.otherBoundsShapeAccesses),
               trackerStartTime(other.trackerStartTime),
               indexKey(other.indexKey) {}
 
         IndexUsageStats& operator=(const IndexUsageStats& other) {
             accesses.store(other.accesses.load());
+            coveringAccesses.store(other.coveringAccesses.load());
+            boundsShapes = other.boundsShapes;
+            otherBoundsShapeAccesses = other.otherBoundsShapeAccesses;
             trackerStartTime = other.trackerStartTime;
             indexKey = other.indexKey;
             return *this;
@@ -70,6 +81,17 @@ public:
         // Number of operations that have used this index.
         AtomicInt64 accesses;
 
+        // Number of operations that used this index and never fetched a document.
+        AtomicInt64 coveringAccesses;
+
+        // The distinct shapes of the bounds scanned on this index, as given by
+        // IndexBounds::toShapeBSON(), with the number of operations that scanned each. Holds at
+        // most kMaxBoundsShapes shapes.
+        std::vector<std::pair<BSONObj, long long>> boundsShapes;
+
+        // Number of operations whose bounds shape didn't fit in 'boundsShapes'.
+        long long otherBoundsShapeAccesses = 0;
+
         // Date/Time that we started tracking index usage.
         Date_t trackerStartTime;
 
@@ -85,12 +107,22 @@ public:
      */
     explicit CollectionIndexUsageTracker(ClockSource* clockSource);
 
+    // The most distinct bounds shapes kept for each index.
+    static const size_t kMaxBoundsShapes = 16;
+
     /**
      * Record that an operation used index 'indexName'. Safe to be called by multiple threads
      * concurrently.
      */
     void recordIndexAccess(StringData indexName);
 
+    /**
+     * Like recordIndexAccess(indexName), but also records how the operation used the index:
+     * 'boundsShape' is the shape of the bounds it scanned, or empty if it didn't scan a range of
+     * keys, and 'covering' is whether it never fetched a document.
+     */
+    void recordIndexAccess(StringData indexName, const BSONObj& boundsShape, bool covering);
+
     /**
      * Add map entry for 'indexName' stats collection. Must be called under exclusive collection
      * lock.
@@ -114,6 +146,10 @@ private:
     // Map from index name to usage statistics.
     StringMap<CollectionIndexUsageTracker::IndexUsageStats> _indexUsageMap;
 
+    // Protects the bounds shapes of the entries of '_indexUsageMap', which operations holding the
+    // collection lock in a shared mode update concurrently.
+    mutable stdx::mutex _boundsShapesMutex;
+
     // Clock source. Used when the 'trackerStartTime' time for an IndexUsageStats object needs to
     // be set.
     ClockSource* _clockSource;
@@ -148,5 +148,44 @@ TEST_F(CollectionIndexUsageTrackerTest, DateTimeAfterDeregister) {
     ASSERT(statsMap.find("foo") != statsMap.end());
     ASSERT_EQUALS(statsMap["foo"].trackerStartTime, getClockSource()->now());
 }
+
+// Test that accesses that never fetched a document are counted as covering.
+TEST_F(CollectionIndexUsageTrackerTest, CoveringAccesses) {
+    getTracker()->registerIndex("foo", BSON("foo" << 1));
+    getTracker()->recordIndexAccess("foo", BSONObj(), true);
+    getTracker()->recordIndexAccess("foo", BSONObj(), false);
+    getTracker()->recordIndexAccess("foo");
+    CollectionIndexUsageMap statsMap = getTracker()->getUsageStats();
+    ASSERT_EQUALS(3, statsMap["foo"].accesses.loadRelaxed());
+    ASSERT_EQUALS(1, statsMap["foo"].coveringAccesses.loadRelaxed());
+    ASSERT(statsMap["foo"].boundsShapes.empty());
+}
+
+// Test that accesses are counted per distinct bounds shape, up to kMaxBoundsShapes shapes.
+TEST_F(CollectionIndexUsageTrackerTest, BoundsShapes) {
+    const BSONObj pointShape = BSON("foo"
+                                    << "point");
+    const BSONObj rangeShape = BSON("foo"
+                                    << "range");
+    getTracker()->registerIndex("foo", BSON("foo" << 1));
+    getTracker()->recordIndexAccess("foo", pointShape, false);
+    getTracker()->recordIndexAccess("foo", rangeShape, false);
+    getTracker()->recordIndexAccess("foo", pointShape, false);
+    CollectionIndexUsageMap statsMap = getTracker()->getUsageStats();
+    ASSERT_EQUALS(2U, statsMap["foo"].boundsShapes.size());
+    ASSERT_EQUALS(pointShape, statsMap["foo"].boundsShapes[0].first);
+    ASSERT_EQUALS(2, statsMap["foo"].boundsShapes[0].second);
+    ASSERT_EQUALS(rangeShape, statsMap["foo"].boundsShapes[1].first);
+    ASSERT_EQUALS(1, statsMap["foo"].boundsShapes[1].second);
+
+    for (size_t i = 0; i < CollectionIndexUsageTracker::kMaxBoundsShapes; ++i) {
+        getTracker()->recordIndexAccess("foo", BSON("shape" << static_cast<int>(i)), false);
+    }
+    statsMap = getTracker()->getUsageStats();
+    ASSERT_EQUALS(CollectionIndexUsageTracker::kMaxBoundsShapes,
+                  statsMap["foo"].boundsShapes.size());
+    ASSERT_EQUALS(2, statsMap["foo"].otherBoundsShapeAccesses);
+    ASSERT_EQUALS(19, statsMap["foo"].accesses.loadRelaxed());
+}
 }  // namespace
 }  // namespace mongo
@@ -30,6 +30,7 @@
 
 #define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kCommand
 
+#include <boost/optional.hpp>
 #include <string>
 #include <vector>
 
@@ -79,8 +80,10 @@ public:
                 "warning: this operation locks the database and is slow. you can cancel with "
                 "killOp()\n"
                 "{ compact : <collection_name>, [force:<bool>], [validate:<bool>],\n"
-                "  [paddingFactor:<num>], [paddingBytes:<num>] }\n"
+                "  [paddingFactor:<num>], [paddingBytes:<num>], [online:<bool>] }\n"
                 "  force - allows to run on a replica set primary\n"
+                "  online - compact in place under intent locks, without blocking the database. "
+                "only for storage engines which compact in place\n"
                 "  validate - check records are noncorrupt before adding to newly compacting "
                 "extents. slower but safer (defaults to true in this version)\n";
     }
@@ -93,9 +96,11 @@ public:
                      string& errmsg,
                      BSONObjBuilder& result) {
         NamespaceString nss = parseNsCollectionRequired(db, cmdObj);
+        const bool online = cmdObj["online"].trueValue();
 
+        // An online compact doesn't block the primary's writes, so it needs no forcing.
         repl::ReplicationCoordinator* replCoord = repl::getGlobalReplicationCoordinator();
-        if (replCoord->getMemberState().primary() && !cmdObj["force"].trueValue()) {
+        if (replCoord->getMemberState().primary() && !cmdObj["force"].trueValue() && !online) {
             errmsg =
                 "will not run compact on an active replica set primary as this is a slow blocking "
                 "operation. use force:true to force";
@@ -146,8 +151,15 @@ public:
 
 
         ScopedTransaction transaction(txn, MODE_IX);
-        AutoGetDb autoDb(txn, db, MODE_X);
+        AutoGetDb autoDb(txn, db, online ? MODE_IX : MODE_X);
         Database* const collDB = autoDb.getDb();
+
+        // Online, the collection only needs to be kept from being dropped or having its indexes
+        // change.
+        boost::optional<Lock::CollectionLock> collLock;
+        if (online) {
+            collLock.emplace(txn->lockState(), nss.ns(), MODE_IS);
+        }
         Collection* collection = collDB ? collDB->getCollection(nss) : NULL;
 
         // If db/collection does not exist, short circuit and return.
@@ -156,10 +168,19 @@ public:
             return false;
         }
 
+        if (online && !collection->getRecordStore()->compactsInPlace()) {
+            return appendCommandStatus(
+                result,
+                Status(ErrorCodes::CommandNotSupported,
+                       str::stream() << "cannot compact online with record store: "
+                                     << collection->getRecordStore()->name()));
+        }
+
         OldClientContext ctx(txn, nss.ns());
         BackgroundOperation::assertNoBgOpInProgForNs(nss.ns());
 
-        log() << "compact " << nss.ns() << " begin, options: " << compactOptions.toString();
+        log() << "compact " << nss.ns() << " begin, options: " << compactOptions.toString()
+              << (online ? ", online" : "");
 
         StatusWith<CompactStats> status = collection->compact(txn, &compactOptions);
         if (!status.isOK())
@@ -167,8 +188,11 @@ public:
 
         if (status.getValue().corruptDocuments > 0)
             result.append("invalidObjects", status.getValue().corruptDocuments);
+        if (collection->getRecordStore()->compactsInPlace())
+            result.appendNumber("bytesFreed", status.getValue().bytesFreed);
 
-        log() << "compact " << nss.ns() << " end";
+        log() << "compact " << nss.ns() << " end, freed " << status.getValue().bytesFreed
+              << " bytes";
 
         return true;
     }
@@ -0,0 +1,285 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/message_compressor_snappy.h"
+#include "mongo/transport/message_compressor_zlib.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+using std::string;
+using std::stringstream;
+
+namespace {
+
+const long long kDefaultSampleSize = 1000;
+const long long kMaxSampleSize = 100 * 1000;
+
+// WiredTiger's default leaf_page_max, the unit in which it compresses collection data.
+const int kDefaultBlockSize = 32 * 1024;
+const int kMaxBlockSize = 16 * 1024 * 1024;
+
+// zlib is recommended when it stores a sample in this fraction of what snappy needs, and no
+// compression when snappy can't shrink it by at least the second one.
+const double kZlibRecommendRatio = 0.8;
+const double kIncompressibleRatio = 0.9;
+
+/**
+ * Compresses the blocks of a sample with one algorithm, and adds up the sizes and the time the
+ * round trips took.
+ */
+class CompressorTrial {
+public:
+    explicit CompressorTrial(std::unique_ptr<MessageCompressorBase> compressor)
+        : _compressor(std::move(compressor)) {}
+
+    Status addBlock(const string& block) {
+        _compressed.resize(_compressor->getMaxCompressedSize(block.size()));
+        Timer compressTimer;
+        auto compressed = _compressor->compressData(ConstDataRange(block.data(), block.size()),
+                                                    DataRange(&_compressed[0], _compressed.size()));
+        _compressMicros += compressTimer.micros();
+        if (!compressed.isOK()) {
+            return compressed.getStatus();
+        }
+
+        _decompressed.resize(block.size());
+        Timer decompressTimer;
+        auto decompressed = _compressor->decompressData(
+            ConstDataRange(_compressed.data(), compressed.getValue()),
+            DataRange(&_decompressed[0], _decompressed.size()));
+        _decompressMicros += decompressTimer.micros();
+        if (!decompressed.isOK()) {
+            return decompressed.getStatus();
+        }
+
+        _compressedBytes += compressed.getValue();
+        return Status::OK();
+    }
+
+    const string& getName() const {
+        return _compressor->getName();
+    }
+
+    long long getCompressedBytes() const {
+        return _compressedBytes;
+    }
+
+    void appendStats(long long sampledBytes, BSONObjBuilder* b) const {
+        b->appendNumber("compressedBytes", _compressedBytes);
+        b->append("ratio",
+                  _compressedBytes ? static_cast<double>(sampledBytes) / _compressedBytes : 1.0);
+        b->appendNumber("compressMicros", _compressMicros);
+        b->appendNumber("decompressMicros", _decompressMicros);
+    }
+
+private:
+    std::unique_ptr<MessageCompressorBase> _compressor;
+    std::vector<char> _compressed;
+    std::vector<char> _decompressed;
+    long long _compressedBytes = 0;
+    long long _compressMicros = 0;
+    long long _decompressMicros = 0;
+};
+
+/**
+ * Estimates how well a collection's data compresses with each block compressor WiredTiger
+ * supports, from a sample of its documents packed into blocks of the size WiredTiger compresses.
+ */
+class CompressionAdvisorCmd : public Command {
+public:
+    CompressionAdvisorCmd() : Command("compressionAdvisor") {}
+
+    virtual bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+    virtual bool slaveOk() const {
+        return true;
+    }
+    virtual void help(stringstream& help) const {
+        help << "estimate the compression of a collection's data by each block compressor\n"
+                "{ compressionAdvisor : <collection_name>, [sampleSize:<num>], "
+                "[blockSize:<bytes>] }\n"
+                "  sampleSize - number of documents sampled at random, default 1000\n"
+                "  blockSize - bytes of documents compressed together, default 32KB\n"
+                "the result recommends a compressor, and the storageEngine option which creates "
+                "a collection with it\n";
+    }
+    virtual void addRequiredPrivileges(const std::string& dbname,
+                                       const BSONObj& cmdObj,
+                                       std::vector<Privilege>* out) {
+        ActionSet actions;
+        actions.addAction(ActionType::collStats);
+        out->push_back(Privilege(parseResourcePattern(dbname, cmdObj), actions));
+    }
+
+    virtual bool run(OperationContext* txn,
+                     const string& dbname,
+                     BSONObj& cmdObj,
+                     int,
+                     string& errmsg,
+                     BSONObjBuilder& result) {
+        const NamespaceString nss = parseNsCollectionRequired(dbname, cmdObj);
+
+        long long sampleSize = kDefaultSampleSize;
+        if (BSONElement elem = cmdObj["sampleSize"]) {
+            if (!elem.isNumber() || elem.numberLong() <= 0 ||
+                elem.numberLong() > kMaxSampleSize) {
+                return appendCommandStatus(
+                    result,
+                    Status(ErrorCodes::BadValue,
+                           str::stream() << "sampleSize must be a number between 1 and "
+                                         << kMaxSampleSize));
+            }
+            sampleSize = elem.numberLong();
+        }
+
+        int blockSize = kDefaultBlockSize;
+        if (BSONElement elem = cmdObj["blockSize"]) {
+            if (!elem.isNumber() || elem.numberLong() < 512 ||
+                elem.numberLong() > kMaxBlockSize) {
+                return appendCommandStatus(
+                    result,
+                    Status(ErrorCodes::BadValue,
+                           str::stream() << "blockSize must be a number between 512 and "
+                                         << kMaxBlockSize));
+            }
+            blockSize = elem.numberInt();
+        }
+
+        AutoGetCollectionForRead ctx(txn, nss);
+        Collection* collection = ctx.getCollection();
+        if (!collection) {
+            errmsg = "collection not found";
+            return false;
+        }
+
+        std::vector<std::unique_ptr<CompressorTrial>> trials;
+        trials.emplace_back(
+            stdx::make_unique<CompressorTrial>(stdx::make_unique<SnappyMessageCompressor>()));
+        trials.emplace_back(
+            stdx::make_unique<CompressorTrial>(stdx::make_unique<ZlibMessageCompressor>()));
+
+        // A random cursor samples the whole collection; engines without one give its start.
+        RecordStore* rs = collection->getRecordStore();
+        auto cursor = rs->getRandomCursor(txn);
+        const bool random = static_cast<bool>(cursor);
+        if (!random) {
+            cursor = rs->getCursor(txn);
+        }
+
+        long long sampledDocuments = 0;
+        long long sampledBytes = 0;
+        long long blocks = 0;
+        string block;
+        block.reserve(blockSize);
+
+        auto compressBlock = [&]() -> Status {
+            for (auto&& trial : trials) {
+                Status status = trial->addBlock(block);
+                if (!status.isOK()) {
+                    return status;
+                }
+            }
+            sampledBytes += block.size();
+            blocks++;
+            block.clear();
+            return Status::OK();
+        };
+
+        while (sampledDocuments < sampleSize) {
+            auto record = cursor->next();
+            if (!record) {
+                break;
+            }
+            block.append(record->data.data(), record->data.size());
+            sampledDocuments++;
+
+            if (block.size() >= static_cast<size_t>(blockSize)) {
+                Status status = compressBlock();
+                if (!status.isOK()) {
+                    return appendCommandStatus(result, status);
+                }
+            }
+        }
+        if (!block.empty()) {
+            Status status = compressBlock();
+            if (!status.isOK()) {
+                return appendCommandStatus(result, status);
+            }
+        }
+
+        result.append("ns", nss.ns());
+        result.append("randomSample", random);
+        result.appendNumber("sampledDocuments", sampledDocuments);
+        result.appendNumber("sampledBytes", sampledBytes);
+        result.appendNumber("blocks", blocks);
+
+        BSONObjBuilder compressors(result.subobjStart("compressors"));
+        for (auto&& trial : trials) {
+            BSONObjBuilder trialBuilder(compressors.subobjStart(trial->getName()));
+            trial->appendStats(sampledBytes, &trialBuilder);
+        }
+        compressors.doneFast();
+
+        // zlib decompresses several times slower than snappy, so it is only worth it when it
+        // saves a good part of the space.
+        const long long snappyBytes = trials[0]->getCompressedBytes();
+        const long long zlibBytes = trials[1]->getCompressedBytes();
+        string recommended = "snappy";
+        if (zlibBytes < snappyBytes * kZlibRecommendRatio) {
+            recommended = "zlib";
+        } else if (snappyBytes > sampledBytes * kIncompressibleRatio) {
+            recommended = "none";
+        }
+        result.append("recommended", recommended);
+        result.append("storageEngine",
+                      BSON("wiredTiger" << BSON("configString"
+                                                << ("block_compressor=" + recommended))));
+        return true;
+    }
+} cmdCompressionAdvisor;
+
+}  // namespace
+}  // namespace mongo
@@ -41,6 +41,7 @@
 #include "mongo/db/server_options.h"
 #include "mongo/executor/connection_pool_stats.h"
 #include "mongo/executor/network_interface_factory.h"
+#include "mongo/executor/reply_buffer_pool.h"
 #include "mongo/executor/task_executor_pool.h"
 #include "mongo/s/catalog/sharding_catalog_manager.h"
 #include "mongo/s/client/shard_registry.h"
@@ -100,6 +101,11 @@ public:
         // Output to a BSON object.
         stats.appendToBSON(result);
 
+        // Reuse of the buffers which hold replies read by the task executors.
+        BSONObjBuilder replyBufferStats(result.subobjStart("replyBufferPool"));
+        executor::ReplyBufferPool::get()->appendStats(&replyBufferStats);
+        replyBufferStats.doneFast();
+
         // Always report all replica sets being tracked.
         BSONObjBuilder setStats(result.subobjStart("replicaSets"));
         globalRSMonitorManager.report(&setStats);
@@ -176,7 +176,7 @@ public:
         PlanSummaryStats summaryStats;
         Explain::getSummaryStats(*exec, &summaryStats);
         if (collection) {
-            collection->infoCache()->notifyOfQuery(txn, summaryStats.indexesUsed);
+            collection->infoCache()->notifyOfQuery(txn, summaryStats);
         }
         curOp->debug().setPlanSummaryMetrics(summaryStats);
 
@@ -60,6 +60,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/util/sampling_profiler.h"
 
 namespace mongo {
 
@@ -144,8 +145,15 @@ bool CpuProfilerStartCommand::run(OperationContext* txn,
     Lock::DBLock dbXLock(txn->lockState(), db, MODE_X);
     OldClientContext ctx(txn, db, false /* no shard version checking */);
 
+    // Both profilers sample on SIGPROF.
+    Status status = SamplingProfiler::get().setSignalReserved(true);
+    if (!status.isOK()) {
+        return appendCommandStatus(result, status);
+    }
+
     std::string profileFilename = cmdObj[commandName]["profileFilename"].String();
     if (!::ProfilerStart(profileFilename.c_str())) {
+        SamplingProfiler::get().setSignalReserved(false);
         errmsg = "Failed to start profiler";
         return false;
     }
@@ -164,6 +172,7 @@ bool CpuProfilerStopCommand::run(OperationContext* txn,
     OldClientContext ctx(txn, db, false /* no shard version checking */);
 
     ::ProfilerStop();
+    SamplingProfiler::get().setSignalReserved(false);
     return true;
 }
 
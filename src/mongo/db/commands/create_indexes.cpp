@@ -216,6 +216,7 @@ public:
         MultiIndexBlock indexer(txn, collection);
         indexer.allowBackgroundBuilding();
         indexer.allowInterruption();
+        indexer.allowParallelKeyGeneration();
 
         const size_t origSpecsSize = specs.size();
         indexer.removeExistingIndexes(&specs);
@@ -45,6 +45,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/stats/fill_locker_info.h"
+#include "mongo/db/stats/wait_event_stats.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -142,6 +143,13 @@ public:
                 Locker::LockerInfo lockerInfo;
                 opCtx->lockState()->getLockerInfo(&lockerInfo);
                 fillLockerInfo(lockerInfo, infoBuilder);
+
+                // Time blocked other than on locks
+                const WaitEventStats& waitEventStats = WaitEventStats::get(opCtx);
+                if (!waitEventStats.empty()) {
+                    BSONObjBuilder waitEventsBuilder(infoBuilder.subobjStart("waitEvents"));
+                    waitEventStats.append(&waitEventsBuilder);
+                }
             }
 
             infoBuilder.done();
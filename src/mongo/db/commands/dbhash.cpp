@@ -45,10 +45,13 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/hex.h"
 #include "mongo/util/log.h"
 #include "mongo/util/md5.hpp"
 #include "mongo/util/timer.h"
+#include "third_party/murmurhash3/MurmurHash3.h"
 
 namespace mongo {
 
@@ -60,6 +63,92 @@ using std::vector;
 
 namespace {
 
+/**
+ * How to hash the collections: with which algorithm, over which _id range, and whether to also
+ * hash ranges of 'bucketSize' documents separately.
+ */
+struct HashOptions {
+    bool useMurmur3 = false;
+
+    // Index keys of the _id index bounding the documents to hash; 'min' is inclusive and 'max'
+    // exclusive. Empty if unbounded.
+    BSONObj min;
+    BSONObj max;
+
+    long long bucketSize = 0;
+
+    bool isDefault() const {
+        return !useMurmur3 && min.isEmpty() && max.isEmpty() && bucketSize == 0;
+    }
+};
+
+/**
+ * Hashes a sequence of documents, in order, with MD5 or with the much cheaper MurmurHash3.
+ */
+class DocumentHasher {
+public:
+    explicit DocumentHasher(bool useMurmur3) : _useMurmur3(useMurmur3) {
+        md5_init(&_md5State);
+    }
+
+    void append(const BSONObj& doc) {
+        if (!_useMurmur3) {
+            md5_append(&_md5State, (const md5_byte_t*)doc.objdata(), doc.objsize());
+            return;
+        }
+
+        // Chain each document's hash into the state, so that the result depends on the order.
+        uint64_t chain[4] = {_murmur3State[0], _murmur3State[1]};
+        MurmurHash3_x64_128(doc.objdata(), doc.objsize(), 0, chain + 2);
+        MurmurHash3_x64_128(chain, sizeof(chain), 0, _murmur3State);
+    }
+
+    std::string finish() {
+        if (!_useMurmur3) {
+            md5digest d;
+            md5_finish(&_md5State, d);
+            return digestToString(d);
+        }
+        return toHexLower(_murmur3State, sizeof(_murmur3State));
+    }
+
+private:
+    const bool _useMurmur3;
+    md5_state_t _md5State;
+    uint64_t _murmur3State[2] = {0, 0};
+};
+
+/**
+ * Parses 'elem', the "min" or "max" option of the form {_id: <value>}, into a key of the _id
+ * index. Returns false if it has another form.
+ */
+bool parseIdBound(const BSONElement& elem, BSONObj* key) {
+    if (elem.eoo()) {
+        return true;
+    }
+    if (elem.type() != Object || elem.Obj().nFields() != 1 || !elem.Obj().hasField("_id")) {
+        return false;
+    }
+    *key = BSON("" << elem.Obj().firstElement());
+    return true;
+}
+
+/**
+ * Returns {_id: <value>} for the _id index key 'key'. If 'key' is empty, returns {_id: MinKey} for
+ * the start of a range and {_id: MaxKey} for its end.
+ */
+BSONObj makeIdBound(const BSONObj& key, bool isStart) {
+    BSONObjBuilder b;
+    if (key.isEmpty() && isStart) {
+        b.appendMinKey("_id");
+    } else if (key.isEmpty()) {
+        b.appendMaxKey("_id");
+    } else {
+        b.appendAs(key.firstElement(), "_id");
+    }
+    return b.obj();
+}
+
 class DBHashCmd : public Command {
 public:
     DBHashCmd() : Command("dbHash", false, "dbhash") {}
@@ -101,6 +190,29 @@ public:
             }
         }
 
+        HashOptions options;
+        if (BSONElement algorithmElem = cmdObj["hashAlgorithm"]) {
+            if (algorithmElem.type() != String ||
+                (algorithmElem.valueStringData() != "md5" &&
+                 algorithmElem.valueStringData() != "murmur3")) {
+                errmsg = "hashAlgorithm has to be \"md5\" or \"murmur3\"";
+                return false;
+            }
+            options.useMurmur3 = algorithmElem.valueStringData() == "murmur3";
+        }
+        if (!parseIdBound(cmdObj["min"], &options.min) ||
+            !parseIdBound(cmdObj["max"], &options.max)) {
+            errmsg = "min and max have to be of the form {_id: <value>}";
+            return false;
+        }
+        if (BSONElement bucketSizeElem = cmdObj["bucketSize"]) {
+            if (!bucketSizeElem.isNumber() || bucketSizeElem.numberLong() <= 0) {
+                errmsg = "bucketSize has to be a positive number";
+                return false;
+            }
+            options.bucketSize = bucketSizeElem.numberLong();
+        }
+
         list<string> colls;
         const string ns = parseNs(dbname, cmdObj);
 
@@ -130,6 +242,7 @@ public:
 
 
         BSONObjBuilder bb(result.subobjStart("collections"));
+        BSONObjBuilder bucketsBuilder;
         for (list<string>::iterator i = colls.begin(); i != colls.end(); i++) {
             string fullCollectionName = *i;
             if (fullCollectionName.size() - 1 <= dbname.size()) {
@@ -148,7 +261,12 @@ public:
                 continue;
 
             bool fromCache = false;
-            string hash = _hashCollection(txn, db, fullCollectionName, &fromCache);
+            BSONArrayBuilder buckets;
+            string hash =
+                _hashCollection(txn, db, fullCollectionName, options, &fromCache, &buckets);
+            if (options.bucketSize) {
+                bucketsBuilder.append(shortCollectionName, buckets.arr());
+            }
 
             bb.append(shortCollectionName, hash);
 
@@ -163,6 +281,9 @@ public:
         string hash = digestToString(d);
 
         result.append("md5", hash);
+        if (options.bucketSize) {
+            result.append("buckets", bucketsBuilder.obj());
+        }
         result.appendNumber("timeMillis", timer.millis());
 
         result.append("fromCache", cached);
@@ -192,15 +313,23 @@ private:
         return ns.isConfigDB();
     }
 
+    /**
+     * Returns the hash of the documents of 'fullCollectionName' chosen by 'options'. If
+     * 'options' asks for buckets, appends the _id range, count and hash of each bucket to
+     * 'buckets'.
+     */
     std::string _hashCollection(OperationContext* opCtx,
                                 Database* db,
                                 const std::string& fullCollectionName,
-                                bool* fromCache) {
+                                const HashOptions& options,
+                                bool* fromCache,
+                                BSONArrayBuilder* buckets) {
         stdx::unique_lock<stdx::mutex> cachedHashedLock(_cachedHashedMutex, stdx::defer_lock);
 
         NamespaceString ns(fullCollectionName);
 
-        if (_isCachable(ns)) {
+        // Only the hash of all the documents with the default algorithm is cached.
+        if (_isCachable(ns) && options.isDefault()) {
             cachedHashedLock.lock();
             string hash = _cachedHashed[ns.db().toString()][ns.coll().toString()];
             if (hash.size() > 0) {
@@ -216,18 +345,26 @@ private:
 
         IndexDescriptor* desc = collection->getIndexCatalog()->findIdIndex(opCtx);
 
+        // Bounds on the _id index don't hold the _ids themselves under a collation.
+        uassert(ErrorCodes::BadValue,
+                str::stream() << "min and max can't be used with " << fullCollectionName
+                              << ", which has a collation",
+                (options.min.isEmpty() && options.max.isEmpty()) ||
+                    !collection->getDefaultCollator());
+
         unique_ptr<PlanExecutor> exec;
         if (desc) {
             exec = InternalPlanner::indexScan(opCtx,
                                               collection,
                                               desc,
-                                              BSONObj(),
-                                              BSONObj(),
+                                              options.min,
+                                              options.max,
                                               false,  // endKeyInclusive
                                               PlanExecutor::YIELD_MANUAL,
                                               InternalPlanner::FORWARD,
                                               InternalPlanner::IXSCAN_FETCH);
-        } else if (collection->isCapped()) {
+        } else if (collection->isCapped() && options.min.isEmpty() && options.max.isEmpty() &&
+                   !options.bucketSize) {
             exec = InternalPlanner::collectionScan(
                 opCtx, fullCollectionName, collection, PlanExecutor::YIELD_MANUAL);
         } else {
@@ -235,15 +372,40 @@ private:
             return "no _id _index";
         }
 
-        md5_state_t st;
-        md5_init(&st);
+        DocumentHasher hasher(options.useMurmur3);
+
+        // The buckets cover the whole range hashed: each one starts at the _id of its first
+        // document, or the start of the range, and ends where the next one starts.
+        std::unique_ptr<DocumentHasher> bucketHasher;
+        BSONObj bucketMin = makeIdBound(options.min, true);
+        long long bucketCount = 0;
+        auto appendBucket = [&](const BSONObj& bucketMax) {
+            buckets->append(BSON("min" << bucketMin << "max" << bucketMax << "count"
+                                       << bucketCount
+                                       << "hash"
+                                       << bucketHasher->finish()));
+        };
+        if (options.bucketSize) {
+            bucketHasher = stdx::make_unique<DocumentHasher>(options.useMurmur3);
+        }
 
         long long n = 0;
         PlanExecutor::ExecState state;
         BSONObj c;
         verify(NULL != exec.get());
         while (PlanExecutor::ADVANCED == (state = exec->getNext(&c, NULL))) {
-            md5_append(&st, (const md5_byte_t*)c.objdata(), c.objsize());
+            hasher.append(c);
+            if (bucketHasher) {
+                if (bucketCount == options.bucketSize) {
+                    BSONObj nextMin = BSON("_id" << c["_id"]);
+                    appendBucket(nextMin);
+                    bucketMin = nextMin;
+                    bucketCount = 0;
+                    bucketHasher = stdx::make_unique<DocumentHasher>(options.useMurmur3);
+                }
+                bucketHasher->append(c);
+                bucketCount++;
+            }
             n++;
         }
         if (PlanExecutor::IS_EOF != state) {
@@ -252,9 +414,11 @@ private:
                       "Plan executor error while running dbHash command: " +
                           WorkingSetCommon::toStatusString(c));
         }
-        md5digest d;
-        md5_finish(&st, d);
-        string hash = digestToString(d);
+        if (bucketHasher) {
+            appendBucket(makeIdBound(options.max, false));
+        }
+
+        string hash = hasher.finish();
 
         if (cachedHashedLock.owns_lock()) {
             _cachedHashed[ns.db().toString()][ns.coll().toString()] = hash;
@@ -29,6 +29,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/commands.h"
+#include "mongo/db/exec/detailed_stage_timer.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/rpc/metadata/server_selection_metadata.h"
@@ -153,6 +154,12 @@ public:
             return false;
         }
 
+        // Per-stage nanosecond timings and resource usage are too costly to collect for every
+        // query, so only do so for the stages this explain runs.
+        if (verbosity >= ExplainCommon::EXEC_STATS) {
+            ScopedDetailedStageTimer::setEnabled(txn, true);
+        }
+
         // Actually call the nested command's explain(...) method.
         Status explainStatus = commToExplain->explain(
             txn, dbname, explainObj, verbosity, rpc::ServerSelectionMetadata::get(txn), &result);
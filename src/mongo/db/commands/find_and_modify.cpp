@@ -200,6 +200,19 @@ Status checkCanAcceptWritesForDatabase(const NamespaceString& nsString) {
     return Status::OK();
 }
 
+/**
+ * The measurements of a time-series collection are only inserted, since its documents are the
+ * buckets which hold them.
+ */
+Status checkNotTimeseries(const Collection* collection) {
+    if (collection && collection->getTimeseriesOptions()) {
+        return Status(ErrorCodes::IllegalOperation,
+                      str::stream() << "Cannot run findAndModify on the time-series collection "
+                                    << collection->ns().ns());
+    }
+    return Status::OK();
+}
+
 }  // namespace
 
 /* Find and Modify an object returning either the old (default) or new value*/
@@ -398,6 +411,11 @@ public:
                 }
 
                 Collection* const collection = autoDb.getDb()->getCollection(nsString.ns());
+                Status notTimeseries = checkNotTimeseries(collection);
+                if (!notTimeseries.isOK()) {
+                    return appendCommandStatus(result, notTimeseries);
+                }
+
                 auto statusWithPlanExecutor =
                     getExecutorDelete(txn, opDebug, collection, &parsedDelete);
                 if (!statusWithPlanExecutor.isOK()) {
@@ -420,7 +438,7 @@ public:
                 PlanSummaryStats summaryStats;
                 Explain::getSummaryStats(*exec, &summaryStats);
                 if (collection) {
-                    collection->infoCache()->notifyOfQuery(txn, summaryStats.indexesUsed);
+                    collection->infoCache()->notifyOfQuery(txn, summaryStats);
                 }
                 opDebug->setPlanSummaryMetrics(summaryStats);
 
@@ -495,6 +513,11 @@ public:
                     }
                 }
 
+                Status notTimeseries = checkNotTimeseries(collection);
+                if (!notTimeseries.isOK()) {
+                    return appendCommandStatus(result, notTimeseries);
+                }
+
                 auto statusWithPlanExecutor =
                     getExecutorUpdate(txn, opDebug, collection, &parsedUpdate);
                 if (!statusWithPlanExecutor.isOK()) {
@@ -517,7 +540,7 @@ public:
                 PlanSummaryStats summaryStats;
                 Explain::getSummaryStats(*exec, &summaryStats);
                 if (collection) {
-                    collection->infoCache()->notifyOfQuery(txn, summaryStats.indexesUsed);
+                    collection->infoCache()->notifyOfQuery(txn, summaryStats);
                 }
                 UpdateStage::recordUpdateStatsInOpDebug(getUpdateStats(exec.get()), opDebug);
                 opDebug->setPlanSummaryMetrics(summaryStats);
@@ -272,6 +272,12 @@ public:
 
         const QueryRequest& originalQR = exec->getCanonicalQuery()->getQueryRequest();
 
+        // Grow the reply buffer once to fit the whole batch, rather than doubling it as it fills.
+        const int firstBatchBufferSize =
+            FindCommon::getFirstBatchBufferSize(originalQR, collection->averageObjectSize(txn));
+        result.bb().reserveBytes(firstBatchBufferSize);
+        result.bb().claimReservedBytes(firstBatchBufferSize);
+
         // Stream query results, adding them to a BSONArray as we go.
         CursorResponseBuilder firstBatch(/*isInitialResponse*/ true, &result);
         BSONObj obj;
@@ -324,7 +324,7 @@ public:
         stats.append("time", curOp->elapsedMillis());
         stats.done();
 
-        collection->infoCache()->notifyOfQuery(txn, summary.indexesUsed);
+        collection->infoCache()->notifyOfQuery(txn, summary);
 
         curOp->debug().setPlanSummaryMetrics(summary);
 
@@ -49,6 +49,7 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/operation_sharding_state.h"
@@ -375,7 +376,9 @@ public:
 
                 // Block waiting for data.
                 const auto timeout = txn->getRemainingMaxTimeMicros();
-                notifier->wait(notifierVersion, timeout);
+                notifier->wait(notifierVersion,
+                               timeout,
+                               Microseconds(internalQueryAwaitDataCoalesceMicros.load()));
                 notifier.reset();
 
                 // Set expected latency to match wait time. This makes sure the logs aren't spammed
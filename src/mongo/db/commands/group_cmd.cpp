@@ -195,7 +195,7 @@ private:
         PlanSummaryStats summaryStats;
         Explain::getSummaryStats(*planExecutor, &summaryStats);
         if (coll) {
-            coll->infoCache()->notifyOfQuery(txn, summaryStats.indexesUsed);
+            coll->infoCache()->notifyOfQuery(txn, summaryStats);
         }
         curOp->debug().setPlanSummaryMetrics(summaryStats);
 
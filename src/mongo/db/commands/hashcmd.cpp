@@ -68,7 +68,7 @@ public:
     }
 
     /* CmdObj has the form {"hash" : <thingToHash>}
-     * or {"hash" : <thingToHash>, "seed" : <number> }
+     * or {"hash" : <thingToHash>, "seed" : <number>, "hashVersion" : <number> }
      * Result has the form
      * {"key" : <thingTohash>, "seed" : <int>, "out": NumberLong(<hash>)}
      *
@@ -97,7 +97,18 @@ public:
         }
         result.append("seed", seed);
 
-        result.append("out", BSONElementHasher::hash64(cmdObj.firstElement(), seed));
+        int hashVersion = kMD5HashVersion;
+        if (cmdObj.hasField("hashVersion")) {
+            if (!cmdObj["hashVersion"].isNumber() ||
+                !Hasher::isValidHashVersion(cmdObj["hashVersion"].numberInt())) {
+                errmsg += "hashVersion must be 0 or 1";
+                return false;
+            }
+            hashVersion = cmdObj["hashVersion"].numberInt();
+            result.append("hashVersion", hashVersion);
+        }
+
+        result.append("out", BSONElementHasher::hash64(cmdObj.firstElement(), seed, hashVersion));
         return true;
     }
 };
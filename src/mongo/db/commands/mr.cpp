@@ -59,6 +59,7 @@
 #include "mongo/db/ops/insert.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_summary_stats.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/range_preserver.h"
@@ -68,6 +69,7 @@
 #include "mongo/db/s/operation_sharding_state.h"
 #include "mongo/db/s/sharded_connection_info.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/s/catalog/catalog_cache.h"
 #include "mongo/s/chunk.h"
@@ -78,7 +80,9 @@
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/scripting/engine.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
@@ -97,6 +101,14 @@ namespace dps = ::mongo::dotted_path_support;
 
 namespace mr {
 
+namespace {
+
+// The number of threads that map the documents of a collection when a mapReduce reads all of
+// them, in no particular order
+MONGO_EXPORT_SERVER_PARAMETER(internalMapReduceMapThreads, int, 1);
+
+}  // namespace
+
 AtomicUInt32 Config::JOB_NUMBER;
 
 JSFunction::JSFunction(const std::string& type, const BSONElement& e) {
@@ -838,6 +850,7 @@ void State::init() {
     // _scope->setObject("_mrMap", BSONObj(), false);
     ScriptingFunction init = _scope->createFunction(
         "_emitCt = 0;"
+        "_emitBuffer = [];"
         "_keyCt = 0;"
         "_dupCt = 0;"
         "_redCt = 0;"
@@ -914,6 +927,9 @@ void State::init() {
         "  _nativeToTemp({_id: key, value: ret});"
         "}");
     massert(16720, "error initializing JavaScript functions", _reduceAndFinalizeAndInsert != 0);
+
+    _flushEmitBuffer = _scope->createFunction("_flushEmitBuffer();");
+    massert(40228, "error initializing JavaScript functions", _flushEmitBuffer != 0);
 }
 
 void State::switchMode(bool jsMode) {
@@ -940,17 +956,55 @@ void State::switchMode(bool jsMode) {
                             "}");
         _scope->injectNative("_bailFromJS", _bailFromJS, this);
     } else {
-        // emit now populates C++ map
-        _scope->injectNative("emit", fast_emit, this);
+        // emit now populates C++ map. Emits of simple values are buffered and added in batches,
+        // which saves a call into C++ for each of them. Objects are added at once, because the map
+        // function may still modify them afterwards.
+        _scope->injectNative("_nativeEmit", fast_emit, this);
+        _scope->injectNative("_nativeEmitBatch", fast_emit_batch, this);
+        _scope->setFunction("_flushEmitBuffer",
+                            "function() {"
+                            "  var buffer = _emitBuffer;"
+                            "  if (buffer.length) {"
+                            "    _emitBuffer = [];"
+                            "    _nativeEmitBatch(buffer);"
+                            "  }"
+                            "}");
+        _scope->setFunction("emit",
+                            "function(key, value) {"
+                            "  function isBufferable(v) {"
+                            "    var t = typeof(v);"
+                            "    return v === null || t === 'undefined' || t === 'number' ||"
+                            "      t === 'boolean' || (t === 'string' && v.length <= 1024);"
+                            "  }"
+                            "  if (arguments.length == 2 && isBufferable(key) &&"
+                            "      isBufferable(value)) {"
+                            "    var buffer = _emitBuffer;"
+                            "    buffer.push(key, value);"
+                            "    if (buffer.length >= 2000) {"
+                            "      _flushEmitBuffer();"
+                            "    }"
+                            "    return;"
+                            "  }"
+                            "  _flushEmitBuffer();"
+                            "  Function.prototype.apply.call(_nativeEmit, null, arguments);"
+                            "}");
     }
 }
 
+void State::flushEmitBuffer() {
+    if (_jsMode)
+        return;
+
+    _scope->invoke(_flushEmitBuffer, 0, 0, 0, true);
+}
+
 void State::bailFromJS() {
     LOG(1) << "M/R: Switching from JS mode to mixed mode" << endl;
 
     // reduce and reemit into c++
     switchMode(false);
     _scope->invoke(_reduceAndEmit, 0, 0, 0, true);
+    flushEmitBuffer();
     // need to get the real number emitted so far
     _numEmits = _scope->getNumberInt("_emitCt");
     _config.reducer->numReduces = _scope->getNumberInt("_redCt");
@@ -1202,6 +1256,23 @@ void State::emit(const BSONObj& a) {
     _size += _add(_temp.get(), a);
 }
 
+unique_ptr<InMemory> State::releaseInMemory() {
+    unique_ptr<InMemory> released(std::move(_temp));
+    _temp.reset(new InMemory());
+    _size = 0;
+    _dupCount = 0;
+    return released;
+}
+
+void State::addInMemory(const InMemory& tuples, long long numEmits) {
+    _numEmits += numEmits;
+    for (const auto& keyAndTuples : tuples) {
+        for (const auto& tuple : keyAndTuples.second) {
+            _size += _add(_temp.get(), tuple);
+        }
+    }
+}
+
 int State::_add(InMemory* im, const BSONObj& a) {
     BSONList& all = (*im)[a];
     all.push_back(a);
@@ -1217,6 +1288,8 @@ void State::reduceAndSpillInMemoryStateIfNeeded() {
     // write units of work.
     invariant(!_txn->lockState()->isLocked());
 
+    flushEmitBuffer();
+
     if (_jsMode) {
         // try to reduce if it is beneficial
         int dupCt = _scope->getNumberInt("_dupCt");
@@ -1279,6 +1352,29 @@ BSONObj fast_emit(const BSONObj& args, void* data) {
     return BSONObj();
 }
 
+/**
+ * emit of a batch of key/value pairs buffered by the js emit function, as one array of
+ * alternating keys and values
+ */
+BSONObj fast_emit_batch(const BSONObj& args, void* data) {
+    uassert(40226,
+            "fast_emit_batch takes an array of keys and values",
+            args.nFields() == 1 && args.firstElement().type() == Array);
+
+    BSONObjIterator i(args.firstElement().embeddedObject());
+    while (i.more()) {
+        BSONElement key = i.next();
+        uassert(40227, "fast_emit_batch takes an array of keys and values", i.more());
+        BSONElement value = i.next();
+
+        BSONObjBuilder b;
+        b.appendAs(key, "0");
+        b.appendAs(value, "1");
+        fast_emit(b.obj(), data);
+    }
+    return BSONObj();
+}
+
 /**
  * function is called when we realize we cant use js mode for m/r on the 1st key
  */
@@ -1293,6 +1389,216 @@ BSONObj _bailFromJS(const BSONObj& args, void* data) {
     return BSONObj();
 }
 
+/**
+ * Runs the map phase of a mapReduce over a whole collection on several threads. Each thread has a
+ * state and JavaScript scope of its own and maps the documents of its share of the collection,
+ * chosen by the hash of their record id. What the threads emit is reduced in memory on the thread
+ * and handed over in batches to the state of the command, which keeps spilling it to the
+ * incremental collection as the single threaded map phase does.
+ */
+class ParallelMapPhase {
+    MONGO_DISALLOW_COPYING(ParallelMapPhase);
+
+public:
+    ParallelMapPhase(const string& dbname,
+                     const BSONObj& cmdObj,
+                     shared_ptr<CollectionMetadata> collMetadata,
+                     int numThreads)
+        : _dbname(dbname),
+          _cmdObj(cmdObj.getOwned()),
+          _collMetadata(std::move(collMetadata)),
+          _numThreads(numThreads) {}
+
+    ~ParallelMapPhase() {
+        _cancelled.store(true);
+        for (auto& thread : _threads) {
+            thread.join();
+        }
+    }
+
+    /**
+     * Runs the map phase, adding everything emitted to 'state'. Must be called without any locks
+     * held. Returns the number of documents mapped.
+     */
+    long long run(OperationContext* txn, State* state, Config* config, ProgressMeterHolder* pm) {
+        invariant(!txn->lockState()->isLocked());
+
+        _numRunning = _numThreads;
+        for (int i = 0; i < _numThreads; i++) {
+            _threads.emplace_back([this, i] { _runThread(i); });
+        }
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        while (true) {
+            while (_handoffs.empty() && _numRunning > 0) {
+                _handoffsChanged.wait_for(lk, Milliseconds(100).toSystemDuration());
+                if (!txn->checkForInterruptNoAssert().isOK()) {
+                    _cancelled.store(true);
+                }
+            }
+
+            if (_handoffs.empty()) {
+                break;
+            }
+
+            Handoff handoff = std::move(_handoffs.front());
+            _handoffs.pop_front();
+            lk.unlock();
+
+            state->addInMemory(*handoff.tuples, handoff.numEmits);
+            state->reduceAndSpillInMemoryStateIfNeeded();
+            pm->hit(handoff.numInputs);
+
+            lk.lock();
+        }
+
+        txn->checkForInterrupt();
+        uassertStatusOK(_status);
+
+        config->reducer->numReduces += _numReduces;
+        return _numInputs;
+    }
+
+private:
+    struct Handoff {
+        unique_ptr<InMemory> tuples;
+        long long numEmits;
+        long long numInputs;
+    };
+
+    void _runThread(int partition) {
+        const std::string threadName = str::stream() << "mapReduceMapper-" << partition;
+        Client::initThread(threadName.c_str());
+        AuthorizationSession::get(cc())->grantInternalAuthorization();
+        auto txn = cc().makeOperationContext();
+
+        long long numInputs = 0;
+        long long numReduces = 0;
+        Status status = Status::OK();
+        try {
+            Config config(_dbname, _cmdObj);
+            config.outputOptions.outType = Config::INMEMORY;
+
+            State state(txn.get(), config);
+            state.init();
+
+            long long numInputsHandedOff = 0;
+            long long numEmitsHandedOff = 0;
+            auto handOff = [&] {
+                Handoff handoff{state.releaseInMemory(),
+                                state.numEmits() - numEmitsHandedOff,
+                                numInputs - numInputsHandedOff};
+                numEmitsHandedOff += handoff.numEmits;
+                numInputsHandedOff += handoff.numInputs;
+
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                _handoffs.push_back(std::move(handoff));
+                _handoffsChanged.notify_all();
+            };
+
+            const NamespaceString nss(config.ns);
+            unique_ptr<ScopedTransaction> scopedXact(new ScopedTransaction(txn.get(), MODE_IS));
+            unique_ptr<AutoGetDb> scopedAutoDb(new AutoGetDb(txn.get(), nss.db(), MODE_S));
+
+            Collection* coll = State::getCollectionOrUassert(scopedAutoDb->getDb(), config.ns);
+            auto exec = InternalPlanner::collectionScan(
+                txn.get(), config.ns, coll, PlanExecutor::YIELD_AUTO);
+
+            BSONObj o;
+            RecordId recordId;
+            PlanExecutor::ExecState execState;
+            while (PlanExecutor::ADVANCED == (execState = exec->getNext(&o, &recordId))) {
+                if (static_cast<int>(RecordId::Hasher()(recordId) % _numThreads) != partition) {
+                    continue;
+                }
+
+                // check to see if this is a new object we don't own yet because of a chunk
+                // migration
+                if (_collMetadata) {
+                    ShardKeyPattern kp(_collMetadata->getKeyPattern());
+                    if (!_collMetadata->keyBelongsToMe(kp.extractShardKeyFromDoc(o))) {
+                        continue;
+                    }
+                }
+
+                config.mapper->map(o);
+
+                if (++numInputs % 100 == 0) {
+                    exec->saveState();
+                    scopedAutoDb.reset();
+                    scopedXact.reset();
+
+                    state.flushEmitBuffer();
+                    state.reduceAndSpillInMemoryStateIfNeeded();
+                    if (state.inMemorySize() > config.maxInMemSize / _numThreads) {
+                        handOff();
+                    }
+
+                    uassert(ErrorCodes::Interrupted,
+                            "mapReduce map phase cancelled",
+                            !_cancelled.load());
+
+                    scopedXact.reset(new ScopedTransaction(txn.get(), MODE_IS));
+                    scopedAutoDb.reset(new AutoGetDb(txn.get(), nss.db(), MODE_S));
+
+                    if (!exec->restoreState()) {
+                        uasserted(ErrorCodes::OperationFailed,
+                                  "Executor killed during mapReduce command");
+                    }
+                }
+            }
+
+            if (PlanExecutor::DEAD == execState || PlanExecutor::FAILURE == execState) {
+                uasserted(ErrorCodes::OperationFailed,
+                          str::stream() << "Executor error during mapReduce command: "
+                                        << WorkingSetCommon::toStatusString(o));
+            }
+
+            exec.reset();
+            scopedAutoDb.reset();
+            scopedXact.reset();
+
+            state.flushEmitBuffer();
+            state.reduceInMemory();
+            handOff();
+
+            numReduces = state.numReduces();
+        } catch (const DBException& ex) {
+            status = ex.toStatus();
+            _cancelled.store(true);
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_status.isOK()) {
+            _status = status;
+        }
+        _numInputs += numInputs;
+        _numReduces += numReduces;
+        --_numRunning;
+        _handoffsChanged.notify_all();
+    }
+
+    const string _dbname;
+    const BSONObj _cmdObj;
+    const shared_ptr<CollectionMetadata> _collMetadata;
+    const int _numThreads;
+
+    // Set to make the threads stop early, because of an error or an interruption
+    AtomicWord<bool> _cancelled{false};
+
+    std::vector<stdx::thread> _threads;
+
+    // Protects the members below
+    stdx::mutex _mutex;
+    stdx::condition_variable _handoffsChanged;
+
+    std::deque<Handoff> _handoffs;
+    int _numRunning{0};
+    Status _status{Status::OK()};
+    long long _numInputs{0};
+    long long _numReduces{0};
+};
+
 /**
  * This class represents a map/reduce command executed on a single server
  */
@@ -1435,7 +1741,12 @@ public:
             long long reduceTime = 0;
             long long numInputs = 0;
 
-            {
+            const int numMapThreads = internalMapReduceMapThreads.load();
+            if (numMapThreads > 1 && config.filter.isEmpty() && config.sort.isEmpty() &&
+                !config.limit && !state.jsMode()) {
+                ParallelMapPhase mapPhase(dbname, cmd, collMetadata, numMapThreads);
+                numInputs = mapPhase.run(txn, &state, &config, &pm);
+            } else {
                 // We've got a cursor preventing migrations off, now re-establish our
                 // useful cursor.
 
@@ -1552,6 +1863,8 @@ public:
                                              << WorkingSetCommon::toStatusString(o)));
                 }
 
+                state.flushEmitBuffer();
+
                 // Record the indexes used by the PlanExecutor.
                 PlanSummaryStats stats;
                 Explain::getSummaryStats(*exec, &stats);
@@ -1562,7 +1875,7 @@ public:
 
                 Collection* coll = scopedAutoDb->getDb()->getCollection(config.ns);
                 invariant(coll);  // 'exec' hasn't been killed, so collection must be alive.
-                coll->infoCache()->notifyOfQuery(txn, stats.indexesUsed);
+                coll->infoCache()->notifyOfQuery(txn, stats);
 
                 if (curOp->shouldDBProfile(curOp->elapsedMillis())) {
                     BSONObjBuilder execStatsBob;
@@ -288,6 +288,31 @@ public:
     */
     void reduceAndSpillInMemoryStateIfNeeded();
 
+    /**
+     * Adds the emits, which the map function has buffered in JavaScript, to the in memory map.
+     * Must be called after running the map function and before reading the in memory map.
+     */
+    void flushEmitBuffer();
+
+    /**
+     * Releases the in memory map, leaving an empty one in its place. Used by the threads of a
+     * parallel map phase to hand what they have emitted over to the state of the command.
+     */
+    std::unique_ptr<InMemory> releaseInMemory();
+
+    /**
+     * Adds the tuples of an in memory map released by another state, and the number of emits
+     * which produced them.
+     */
+    void addInMemory(const InMemory& tuples, long long numEmits);
+
+    /**
+     * Returns the estimated size in bytes of the in memory map.
+     */
+    long inMemorySize() const {
+        return _size;
+    }
+
     /**
      * run reduce on _temp
      */
@@ -403,9 +428,11 @@ protected:
     ScriptingFunction _reduceAndEmit;
     ScriptingFunction _reduceAndFinalize;
     ScriptingFunction _reduceAndFinalizeAndInsert;
+    ScriptingFunction _flushEmitBuffer;
 };
 
 BSONObj fast_emit(const BSONObj& args, void* data);
+BSONObj fast_emit_batch(const BSONObj& args, void* data);
 BSONObj _bailFromJS(const BSONObj& args, void* data);
 
 void addPrivilegesRequiredForMapReduce(Command* commandTemplate,
@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/commands/operation_priority.h"
+
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+using std::string;
+using std::stringstream;
+
+namespace {
+
+const auto lowPriority = Client::declareDecoration<bool>();
+
+const char kLowPriority[] = "low";
+const char kNormalPriority[] = "normal";
+
+class CmdSetOperationPriority : public Command {
+public:
+    CmdSetOperationPriority() : Command("setOperationPriority") {}
+
+    virtual bool slaveOk() const {
+        return true;
+    }
+
+    virtual bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+
+    // Lowering the priority of a connection's own operations, or restoring it, needs no
+    // privileges.
+    virtual void addRequiredPrivileges(const std::string& dbname,
+                                       const BSONObj& cmdObj,
+                                       std::vector<Privilege>* out) {}
+
+    void help(stringstream& h) const {
+        h << "Sets the priority of this connection's later operations, \"low\" or \"normal\". "
+             "Low priority operations wait for tickets and locks behind normal priority ones "
+             "and yield more often.\n"
+             "{ setOperationPriority: \"low\" }";
+    }
+
+    bool run(OperationContext* txn,
+             const string&,
+             BSONObj& cmdObj,
+             int,
+             string& errmsg,
+             BSONObjBuilder& result) {
+        std::string priority;
+        Status status = bsonExtractStringField(cmdObj, getName(), &priority);
+        if (!status.isOK()) {
+            return appendCommandStatus(result, status);
+        }
+        if (priority != kLowPriority && priority != kNormalPriority) {
+            return appendCommandStatus(result,
+                                       Status(ErrorCodes::BadValue,
+                                              str::stream() << "Unknown operation priority '"
+                                                            << priority
+                                                            << "'; must be '"
+                                                            << kLowPriority
+                                                            << "' or '"
+                                                            << kNormalPriority
+                                                            << "'"));
+        }
+
+        Client* client = txn->getClient();
+        result.append("was", lowPriority(client) ? kLowPriority : kNormalPriority);
+        lowPriority(client) = (priority == kLowPriority);
+        return true;
+    }
+} cmdSetOperationPriority;
+
+}  // namespace
+
+bool isLowPriorityClient(Client* client) {
+    return lowPriority(client);
+}
+
+}  // namespace mongo
@@ -54,6 +54,7 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/storage_options.h"
 #include "mongo/stdx/memory.h"
@@ -298,6 +299,10 @@ public:
             std::shared_ptr<PlanExecutor> input =
                 PipelineD::prepareCursorSource(txn, collection, nss, pipeline, expCtx);
 
+            if (internalQueryAggUseDocumentArena.load() && pipeline->canUseDocumentArena()) {
+                expCtx->documentArena = stdx::make_unique<DocumentArena>();
+            }
+
             // Create the PlanExecutor which returns results from the pipeline. The WorkingSet
             // ('ws') and the PipelineProxyStage ('proxy') will be owned by the created
             // PlanExecutor.
@@ -321,7 +326,7 @@ public:
             if (collection) {
                 PlanSummaryStats stats;
                 Explain::getSummaryStats(*exec, &stats);
-                collection->infoCache()->notifyOfQuery(txn, stats.indexesUsed);
+                collection->infoCache()->notifyOfQuery(txn, stats);
             }
 
             if (collection) {
@@ -0,0 +1,143 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * Defines the samplingProfiler command, which controls the built-in sampling profiler and
+ * returns the stacks it sampled in folded form:
+ *
+ *     {samplingProfiler: "start", samplesPerSecond: 19}
+ *     {samplingProfiler: "stop"}
+ *     {samplingProfiler: "report", limit: 500}
+ *     {samplingProfiler: "reset"}
+ *
+ * Joining the "stack" strings of a report with their "samples" counts, separated by a space, one
+ * stack per line, gives the input of flamegraph.pl.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/util/sampling_profiler.h"
+
+namespace mongo {
+namespace {
+
+// Low enough to leave on in production, and prime, so that it doesn't beat with periodic work.
+const int kDefaultSamplesPerSecond = 19;
+
+const long long kDefaultReportLimit = 500;
+
+class CmdSamplingProfiler : public Command {
+public:
+    CmdSamplingProfiler() : Command("samplingProfiler") {}
+
+    virtual bool supportsWriteConcern(const BSONObj& cmd) const override {
+        return false;
+    }
+    virtual bool slaveOk() const {
+        return true;
+    }
+    virtual bool adminOnly() const {
+        return true;
+    }
+    virtual void help(std::stringstream& help) const {
+        help << "controls the sampling CPU profiler: {samplingProfiler: "
+                "'start'|'stop'|'report'|'reset', samplesPerSecond: <int>, limit: <int>}";
+    }
+    virtual void addRequiredPrivileges(const std::string& dbname,
+                                       const BSONObj& cmdObj,
+                                       std::vector<Privilege>* out) {
+        ActionSet actions;
+        actions.addAction(ActionType::cpuProfiler);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+
+    virtual bool run(OperationContext* txn,
+                     const std::string& db,
+                     BSONObj& cmdObj,
+                     int options,
+                     std::string& errmsg,
+                     BSONObjBuilder& result) {
+        SamplingProfiler& profiler = SamplingProfiler::get();
+        const std::string action = cmdObj.firstElement().str();
+
+        if (action == "start") {
+            int samplesPerSecond = kDefaultSamplesPerSecond;
+            BSONElement rateElem = cmdObj["samplesPerSecond"];
+            if (!rateElem.eoo()) {
+                if (!rateElem.isNumber()) {
+                    return appendCommandStatus(
+                        result,
+                        Status(ErrorCodes::TypeMismatch, "samplesPerSecond must be a number"));
+                }
+                samplesPerSecond = rateElem.numberInt();
+            }
+            return appendCommandStatus(result, profiler.start(samplesPerSecond));
+        }
+
+        if (action == "stop") {
+            profiler.stop();
+            return true;
+        }
+
+        if (action == "reset") {
+            profiler.reset();
+            return true;
+        }
+
+        if (action == "report") {
+            long long limit = kDefaultReportLimit;
+            BSONElement limitElem = cmdObj["limit"];
+            if (!limitElem.eoo()) {
+                if (!limitElem.isNumber() || limitElem.numberLong() < 0) {
+                    return appendCommandStatus(
+                        result,
+                        Status(ErrorCodes::BadValue, "limit must be a non-negative number"));
+                }
+                limit = limitElem.numberLong();
+            }
+            profiler.appendReport(static_cast<size_t>(limit), &result);
+            return true;
+        }
+
+        return appendCommandStatus(
+            result,
+            Status(ErrorCodes::BadValue,
+                   "samplingProfiler must be one of 'start', 'stop', 'report' and 'reset'"));
+    }
+} cmdSamplingProfiler;
+
+}  // namespace
+}  // namespace mongo
@@ -47,6 +47,8 @@
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/platform/process_id.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/transport/message_compressor_registry.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/hostname_canonicalization_worker.h"
 #include "mongo/util/net/listen.h"
@@ -137,7 +139,7 @@ public:
             if (!include)
                 continue;
 
-            BSONObj data = section->generateSection(txn, e);
+            BSONObj data = _generateSection(txn, section, e, clock->now());
             if (data.isEmpty())
                 continue;
 
@@ -189,11 +191,51 @@ public:
     }
 
 private:
+    struct CachedSection {
+        Date_t generated;
+        BSONObj data;
+    };
+
+    /**
+     * Generates "section", or returns the result of a recent call if the section allows it and
+     * the command doesn't mention the section. Naming a section always generates it afresh.
+     */
+    BSONObj _generateSection(OperationContext* txn,
+                             ServerStatusSection* section,
+                             const BSONElement& configElement,
+                             Date_t now) {
+        const Milliseconds cacheDuration = section->cacheDuration();
+        const bool cacheable = cacheDuration > Milliseconds(0) && configElement.eoo();
+        if (!cacheable) {
+            return section->generateSection(txn, configElement);
+        }
+
+        {
+            stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
+            auto it = _cache.find(section->getSectionName());
+            if (it != _cache.end() && now - it->second.generated < cacheDuration) {
+                return it->second.data;
+            }
+        }
+
+        BSONObj data = section->generateSection(txn, configElement).getOwned();
+
+        stdx::lock_guard<stdx::mutex> lk(_cacheMutex);
+        _cache[section->getSectionName()] = {now, data};
+        return data;
+    }
+
     const Date_t _started;
     bool _runCalled;
 
     typedef map<string, ServerStatusSection*> SectionMap;
     static SectionMap* _sections;
+
+    // Protects _cache
+    stdx::mutex _cacheMutex;
+
+    // The sections last generated with a cacheDuration, by name
+    map<string, CachedSection> _cache;
 } cmdServerStatus;
 
 
@@ -286,6 +328,11 @@ public:
     BSONObj generateSection(OperationContext* txn, const BSONElement& configElement) const {
         BSONObjBuilder b;
         networkCounter.append(b);
+
+        BSONObjBuilder compressionBuilder(b.subobjStart("compression"));
+        MessageCompressorRegistry::get().appendStats(&compressionBuilder);
+        compressionBuilder.doneFast();
+
         return b.obj();
     }
 
@@ -300,12 +347,13 @@ public:
     }
 
     BSONObj generateSection(OperationContext* txn, const BSONElement& configElement) const {
-        BSONObj result;
+        BSONObjBuilder result;
         if (getSSLManager()) {
-            result = getSSLManager()->getSSLConfiguration().getServerStatusBSON();
+            result.appendElements(getSSLManager()->getSSLConfiguration().getServerStatusBSON());
+            getSSLManager()->appendHandshakeStats(&result);
         }
 
-        return result;
+        return result.obj();
     }
 } security;
 #endif
@@ -34,6 +34,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/platform/atomic_word.h"
+#include "mongo/util/duration.h"
 #include <string>
 
 namespace mongo {
@@ -79,6 +80,15 @@ public:
     virtual BSONObj generateSection(OperationContext* txn,
                                     const BSONElement& configElement) const = 0;
 
+    /**
+     * How long the result of generateSection() may be returned again, to serverStatus calls that
+     * don't mention the section. Sections that are expensive to generate override this, so that
+     * callers polling at the same time share the work.
+     */
+    virtual Milliseconds cacheDuration() const {
+        return Milliseconds(0);
+    }
+
 private:
     const std::string _sectionName;
 };
@@ -37,6 +37,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
@@ -60,7 +61,8 @@ public:
     virtual void help(stringstream& h) const {
         h << "Validate contents of a namespace by scanning its data structures for correctness.  "
              "Slow.\n"
-             "Add full:true option to do a more thorough check";
+             "Add full:true option to do a more thorough check.\n"
+             "Add background:true to validate under an intent lock, without blocking writes";
     }
 
     virtual bool supportsWriteConcern(const BSONObj& cmd) const override {
@@ -92,6 +94,7 @@ public:
         NamespaceString ns_string(ns);
         const bool full = cmdObj["full"].trueValue();
         const bool scanData = cmdObj["scandata"].trueValue();
+        const bool background = cmdObj["background"].trueValue();
 
         ValidateCmdLevel level = kValidateIndex;
 
@@ -106,12 +109,24 @@ public:
             return false;
         }
 
+        // Without document-level locking, the collection can't be read at a point in time while
+        // it is being written.
+        StorageEngine* storageEngine = txn->getServiceContext()->getGlobalStorageEngine();
+        if (background && !storageEngine->supportsDocLocking()) {
+            return appendCommandStatus(
+                result,
+                Status(ErrorCodes::CommandNotSupported,
+                       "background validation requires a storage engine with document-level "
+                       "locking"));
+        }
+
         if (!serverGlobalParams.quiet) {
             LOG(0) << "CMD: validate " << ns << endl;
         }
 
-        AutoGetDb ctx(txn, ns_string.db(), MODE_IX);
-        Lock::CollectionLock collLk(txn->lockState(), ns_string.ns(), MODE_X);
+        AutoGetDb ctx(txn, ns_string.db(), background ? MODE_IS : MODE_IX);
+        Lock::CollectionLock collLk(
+            txn->lockState(), ns_string.ns(), background ? MODE_IS : MODE_X);
         Collection* collection = ctx.getDb() ? ctx.getDb()->getCollection(ns_string) : NULL;
         if (!collection) {
             errmsg = "ns not found";
@@ -121,7 +136,7 @@ public:
         result.append("ns", ns);
 
         ValidateResults results;
-        Status status = collection->validate(txn, level, &results, &result);
+        Status status = collection->validate(txn, level, &results, &result, background);
         if (!status.isOK())
             return appendCommandStatus(result, status);
 
@@ -73,7 +73,7 @@ Lock::GlobalLock::GlobalLock(Locker* locker, LockMode lockMode, EnqueueOnly enqu
 }
 
 void Lock::GlobalLock::_enqueue(LockMode lockMode) {
-    if (!_locker->isBatchWriter()) {
+    if (_shouldLockParallelBatchWriterMode()) {
         _pbwm.lock(MODE_IS);
     }
 
@@ -85,11 +85,15 @@ void Lock::GlobalLock::waitForLock(unsigned timeoutMs) {
         _result = _locker->lockGlobalComplete(timeoutMs);
     }
 
-    if (_result != LOCK_OK && !_locker->isBatchWriter()) {
+    if (_result != LOCK_OK && _shouldLockParallelBatchWriterMode()) {
         _pbwm.unlock();
     }
 }
 
+bool Lock::GlobalLock::_shouldLockParallelBatchWriterMode() const {
+    return !_locker->isBatchWriter() && _locker->shouldConflictWithSecondaryBatchApplication();
+}
+
 void Lock::GlobalLock::_unlock() {
     if (isLocked()) {
         _locker->unlockGlobal();
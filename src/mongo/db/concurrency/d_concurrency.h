@@ -183,6 +183,7 @@ public:
     private:
         void _enqueue(LockMode lockMode);
         void _unlock();
+        bool _shouldLockParallelBatchWriterMode() const;
 
         Locker* const _locker;
         LockResult _result;
@@ -229,6 +229,18 @@ TEST(DConcurrency, GlobalLockX_Timeout) {
     }
 }
 
+TEST(DConcurrency, GlobalLockIS_NoConflictWithSecondaryBatchApplication) {
+    MMAPV1LockerImpl lsBatch;
+    lsBatch.setIsBatchWriter(true);
+    Lock::ParallelBatchWriterMode pbwm(&lsBatch);
+
+    MMAPV1LockerImpl ls;
+    ls.setShouldConflictWithSecondaryBatchApplication(false);
+    Lock::GlobalLock globalRead(&ls, MODE_IS, 1);
+    ASSERT(globalRead.isLocked());
+    ASSERT_EQUALS(MODE_NONE, ls.getLockMode(resourceIdParallelBatchWriterMode));
+}
+
 TEST(DConcurrency, GlobalLockS_NoTimeoutDueToGlobalLockS) {
     MMAPV1LockerImpl ls;
     Lock::GlobalRead globalRead(&ls);
@@ -35,6 +35,8 @@
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/config.h"
 #include "mongo/db/concurrency/locker.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/stringutils.h"
@@ -44,6 +46,8 @@ namespace mongo {
 
 using std::string;
 
+MONGO_EXPORT_SERVER_PARAMETER(internalLockManagerIntentFastPath, bool, false);
+
 namespace {
 
 /**
@@ -122,6 +126,44 @@ static_assert((sizeof(LockRequestStatusNames) / sizeof(LockRequestStatusNames[0]
               "(sizeof(LockRequestStatusNames) / sizeof(LockRequestStatusNames[0])) == "
               "LockRequest::StatusCount");
 
+// How many later requests may be queued ahead of a waiting low priority request.
+const unsigned kMaxLowPriorityPassOvers = 8;
+
+// Number of requests waiting on conflict queues or for conversions, in any lock manager.
+AtomicUInt32 numWaitingRequests;
+
+/**
+ * Layout of FastPathLockHead::state:
+ *
+ *   bits  0-15: number of MODE_IS requests granted through the fast path lock head
+ *   bits 16-31: number of MODE_IX requests granted through the fast path lock head
+ *   bit     32: set while the fast path lock head is open, i.e. granting new requests
+ *   bits 33-63: generation, incremented every time the fast path lock head is closed
+ */
+const uint64_t kFastPathCountMask = 0xFFFF;
+const uint64_t kFastPathOpen = 1ULL << 32;
+const unsigned kFastPathGenerationShift = 33;
+
+unsigned fastPathCountShift(LockMode mode) {
+    return mode == MODE_IS ? 0 : 16;
+}
+
+uint32_t fastPathCount(uint64_t state, LockMode mode) {
+    return (state >> fastPathCountShift(mode)) & kFastPathCountMask;
+}
+
+uint64_t fastPathGeneration(uint64_t state) {
+    return state >> kFastPathGenerationShift;
+}
+
+/**
+ * Only the resources which nearly every operation locks in an intent mode use the fast path.
+ */
+bool isFastPathResource(ResourceId resId) {
+    const ResourceType type = resId.getType();
+    return type == RESOURCE_GLOBAL || type == RESOURCE_DATABASE || type == RESOURCE_COLLECTION;
+}
+
 }  // namespace
 
 
@@ -152,6 +194,9 @@ struct LockHead {
 
         conversionsCount = 0;
         compatibleFirstCount = 0;
+
+        fastPathLock = NULL;
+        fastPathMigratedCount = 0;
     }
 
     /**
@@ -192,6 +237,7 @@ struct LockHead {
         request->mode = mode;
         request->lock = this;
         request->partitionedLock = NULL;
+        request->passedOverCount = 0;
         if (!partitioned()) {
             request->recursiveCount = 1;
         }
@@ -208,6 +254,8 @@ struct LockHead {
             // Put it on the conflict queue. Conflicts are granted front to back.
             if (request->enqueueAtFront) {
                 conflictList.push_front(request);
+            } else if (!request->lowPriority) {
+                enqueueAheadOfLowPriority(request);
             } else {
                 conflictList.push_back(request);
             }
@@ -230,12 +278,46 @@ struct LockHead {
         return LOCK_OK;
     }
 
+    /**
+     * Puts 'request' on the conflict queue ahead of the low priority requests at its back, which
+     * have not yet been passed over too often.
+     */
+    void enqueueAheadOfLowPriority(LockRequest* request) {
+        LockRequest* position = NULL;
+        for (LockRequest* it = conflictList._back;
+             it != NULL && it->lowPriority && it->passedOverCount < kMaxLowPriorityPassOvers;
+             it = it->prev) {
+            position = it;
+        }
+        if (position == NULL) {
+            conflictList.push_back(request);
+            return;
+        }
+
+        for (LockRequest* it = position; it != NULL; it = it->next) {
+            it->passedOverCount++;
+        }
+        conflictList.insert_before(request, position);
+    }
+
     /**
      * Lock each partitioned LockHead in turn, and move any (granted) intent mode requests for
      * lock->resourceId to lock, which must itself already be locked.
      */
     void migratePartitionedLockHeads();
 
+    /**
+     * Tries to take ownership of the fast path lock head for this resource and open it. Returns
+     * true if this LockHead owns an open fast path lock head afterwards.
+     */
+    bool openFastPathLockHead(FastPathLockHead* fastPathLockHead);
+
+    /**
+     * Closes the fast path lock head owned by this LockHead, which must itself already be
+     * locked, and accounts for the requests granted through it on this LockHead instead.
+     */
+    void closeFastPathLockHead();
+
     // Methods to maintain the granted queue
     void incGrantedModeCount(LockMode mode) {
         invariant(grantedCounts[mode] >= 0);
@@ -245,6 +327,17 @@ struct LockHead {
         }
     }
 
+    void addGrantedModeCount(LockMode mode, uint32_t count) {
+        if (count == 0) {
+            return;
+        }
+        grantedCounts[mode] += count;
+        if (grantedCounts[mode] == count) {
+            invariant((grantedModes & modeMask(mode)) == 0);
+            grantedModes |= modeMask(mode);
+        }
+    }
+
     void decGrantedModeCount(LockMode mode) {
         invariant(grantedCounts[mode] >= 1);
         if (--grantedCounts[mode] == 0) {
@@ -256,6 +349,7 @@ struct LockHead {
     // Methods to maintain the conflict queue
     void incConflictModeCount(LockMode mode) {
         invariant(conflictCounts[mode] >= 0);
+        numWaitingRequests.fetchAndAdd(1);
         if (++conflictCounts[mode] == 1) {
             invariant((conflictModes & modeMask(mode)) == 0);
             conflictModes |= modeMask(mode);
@@ -264,6 +358,7 @@ struct LockHead {
 
     void decConflictModeCount(LockMode mode) {
         invariant(conflictCounts[mode] >= 1);
+        numWaitingRequests.fetchAndSubtract(1);
         if (--conflictCounts[mode] == 0) {
             invariant((conflictModes & modeMask(mode)) == modeMask(mode));
             conflictModes &= ~modeMask(mode);
@@ -314,6 +409,14 @@ struct LockHead {
     // TODO: Remove this vector and make LockHead a POD
     std::vector<LockManager::Partition*> partitions;
 
+    // The fast path lock head owned by this LockHead, if any. Non-null implies the fast path
+    // lock head is open, so the lock has no conflicts and only has intent modes as grantedModes.
+    FastPathLockHead* fastPathLock;
+
+    // Counts the requests which were granted through a since closed fast path lock head. These
+    // are included in grantedCounts, but are not on the granted list.
+    uint32_t fastPathMigratedCount;
+
     //
     // Conversion
     //
@@ -376,6 +479,78 @@ struct PartitionedLockHead {
     LockRequestList grantedList;
 };
 
+/**
+ * The FastPathLockHead grants uncontended intent mode requests on the most frequently locked
+ * resources without taking any mutex. Instead of keeping a list of the granted requests, it only
+ * counts them in a single atomic word, which is updated with compare-and-swap.
+ *
+ * A FastPathLockHead is owned by at most one LockHead at a time. The owner opens it under its
+ * bucket mutex while it only has intent modes granted and no conflicts, and closes it under the
+ * same mutex before granting or queueing any conflicting request. Closing bumps the generation
+ * and moves the counts to the owner, so requests which were granted through a FastPathLockHead
+ * can detect on release whether they are still counted there.
+ *
+ * Requests granted through a FastPathLockHead are not visible to the deadlock detector or to
+ * lock dumps, until their FastPathLockHead is closed.
+ */
+struct FastPathLockHead {
+    AtomicUInt64 state;
+
+    // The resource and the LockHead which own this fast path lock head. Only changed while the
+    // fast path lock head is closed, so readers that observe it open through 'state' beforehand
+    // and unchanged afterwards read consistent values.
+    AtomicUInt64 resourceId;
+    std::atomic<LockHead*> owner{nullptr};  // NOLINT
+};
+
+bool LockHead::openFastPathLockHead(FastPathLockHead* fastPathLockHead) {
+    if (fastPathLock) {
+        return true;
+    }
+
+    LockHead* expected = nullptr;
+    if (!fastPathLockHead->owner.compare_exchange_strong(expected, this)) {
+        // Owned by another resource mapping to the same fast path lock head
+        return false;
+    }
+    fastPathLockHead->resourceId.store(resourceId);
+
+    // A closed fast path lock head never has any granted requests counted against it
+    const uint64_t state = fastPathLockHead->state.load();
+    invariant((state & ~(~0ULL << kFastPathGenerationShift)) == 0);
+    fastPathLockHead->state.store(state | kFastPathOpen);
+
+    fastPathLock = fastPathLockHead;
+    return true;
+}
+
+void LockHead::closeFastPathLockHead() {
+    invariant(fastPathLock);
+    // There can't be non-intent modes or conflicts while the fast path lock head is open
+    invariant(!(grantedModes & ~intentModes) && !conflictModes);
+
+    uint64_t state = fastPathLock->state.load();
+    while (true) {
+        const uint64_t closedState = (fastPathGeneration(state) + 1) << kFastPathGenerationShift;
+        const uint64_t oldState = fastPathLock->state.compareAndSwap(state, closedState);
+        if (oldState == state) {
+            break;
+        }
+        state = oldState;
+    }
+
+    // No request can be granted through or released from the fast path lock head anymore, so the
+    // counts it had when it was closed are final.
+    const uint32_t numIS = fastPathCount(state, MODE_IS);
+    const uint32_t numIX = fastPathCount(state, MODE_IX);
+    addGrantedModeCount(MODE_IS, numIS);
+    addGrantedModeCount(MODE_IX, numIX);
+    fastPathMigratedCount += numIS + numIX;
+
+    fastPathLock->owner.store(nullptr);
+    fastPathLock = NULL;
+}
+
 void LockHead::migratePartitionedLockHeads() {
     invariant(partitioned());
     // There can't be non-intent modes or conflicts when the lock is partitioned
@@ -418,9 +593,14 @@ const unsigned LockManager::_numLockBuckets(128);
 // The exact value doesn't appear very important, but should be power of two
 const unsigned LockManager::_numPartitions = 32;
 
+// Only a handful of resources are hot at any time, but collisions disable the fast path for all
+// but one of the colliding resources, so have plenty of fast path lock heads.
+const unsigned LockManager::_numFastPathLockHeads = 256;
+
 LockManager::LockManager() {
     _lockBuckets = new LockBucket[_numLockBuckets];
     _partitions = new Partition[_numPartitions];
+    _fastPathLockHeads = new FastPathLockHead[_numFastPathLockHeads];
 }
 
 LockManager::~LockManager() {
@@ -433,6 +613,7 @@ LockManager::~LockManager() {
 
     delete[] _lockBuckets;
     delete[] _partitions;
+    delete[] _fastPathLockHeads;
 }
 
 LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mode) {
@@ -441,6 +622,14 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
 
     request->partitioned = (mode == MODE_IX || mode == MODE_IS);
 
+    const bool useFastPath = request->partitioned && !request->compatibleFirst &&
+        isFastPathResource(resId) && internalLockManagerIntentFastPath.load();
+
+    // For intent modes on the hottest resources, try the FastPathLockHead first
+    if (useFastPath && _tryFastPathLock(resId, request, mode)) {
+        return LOCK_OK;
+    }
+
     // For intent modes, try the PartitionedLockHead
     if (request->partitioned) {
         Partition* partition = _getPartition(request);
@@ -466,6 +655,11 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
 
     // Start a partitioned lock if possible
     if (request->partitioned && !(lock->grantedModes & (~intentModes)) && !lock->conflictModes) {
+        if (useFastPath && lock->openFastPathLockHead(_getFastPathLockHead(resId)) &&
+            _tryFastPathLock(resId, request, mode)) {
+            return LOCK_OK;
+        }
+
         Partition* partition = _getPartition(request);
         stdx::lock_guard<SimpleMutex> scopedLock(partition->mutex);
         PartitionedLockHead* partitionedLock = partition->findOrInsert(resId);
@@ -479,6 +673,9 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
     if (lock->partitioned()) {
         lock->migratePartitionedLockHeads();
     }
+    if (lock->fastPathLock) {
+        lock->closeFastPathLockHead();
+    }
 
     request->partitioned = false;
     return lock->newRequest(request, mode);
@@ -518,6 +715,12 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
     if (lock->partitioned()) {
         lock->migratePartitionedLockHeads();
     }
+    if (lock->fastPathLock) {
+        lock->closeFastPathLockHead();
+    }
+    if (request->fastPathLock) {
+        _migrateFastPathRequest(lock, request);
+    }
 
     // Construct granted mask without our current mode, so that it is not counted as
     // conflicting
@@ -547,6 +750,7 @@ LockResult LockManager::convert(ResourceId resId, LockRequest* request, LockMode
         request->convertMode = newMode;
 
         lock->conversionsCount++;
+        numWaitingRequests.fetchAndAdd(1);
         lock->incGrantedModeCount(request->convertMode);
 
         return LOCK_WAITING;
@@ -586,6 +790,9 @@ bool LockManager::unlock(LockRequest* request) {
 
         // not partitioned anymore, fall through to regular case
     }
+    if (request->fastPathLock && _tryFastPathUnlock(request)) {
+        return true;
+    }
     invariant(request->lock);
 
     LockHead* lock = request->lock;
@@ -597,8 +804,15 @@ bool LockManager::unlock(LockRequest* request) {
         // as efficient as possible. The fast path for decrementing multiple references did
         // already ensure request->recursiveCount == 0.
 
-        // Remove from the granted list
-        lock->grantedList.remove(request);
+        // Remove from the granted list, unless the request was only counted on the lock when
+        // its fast path lock head was closed
+        if (request->fastPathLock) {
+            invariant(lock->fastPathMigratedCount > 0);
+            lock->fastPathMigratedCount--;
+            request->fastPathLock = NULL;
+        } else {
+            lock->grantedList.remove(request);
+        }
         lock->decGrantedModeCount(request->mode);
 
         if (request->compatibleFirst) {
@@ -624,6 +838,7 @@ bool LockManager::unlock(LockRequest* request) {
         request->status = LockRequest::STATUS_GRANTED;
 
         lock->conversionsCount--;
+        numWaitingRequests.fetchAndSubtract(1);
         lock->decGrantedModeCount(request->convertMode);
 
         request->convertMode = MODE_NONE;
@@ -637,6 +852,11 @@ bool LockManager::unlock(LockRequest* request) {
     return (request->recursiveCount == 0);
 }
 
+/* static */
+bool LockManager::hasWaitingRequests() {
+    return numWaitingRequests.load() > 0;
+}
+
 void LockManager::downgrade(LockRequest* request, LockMode newMode) {
     invariant(request->lock);
     invariant(request->status == LockRequest::STATUS_GRANTED);
@@ -652,6 +872,13 @@ void LockManager::downgrade(LockRequest* request, LockMode newMode) {
     LockBucket* bucket = _getBucket(lock->resourceId);
     stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
 
+    if (request->fastPathLock) {
+        if (lock->fastPathLock) {
+            lock->closeFastPathLockHead();
+        }
+        _migrateFastPathRequest(lock, request);
+    }
+
     lock->incGrantedModeCount(newMode);
     lock->decGrantedModeCount(request->mode);
     request->mode = newMode;
@@ -675,6 +902,9 @@ void LockManager::_cleanupUnusedLocksInBucket(LockBucket* bucket) {
         if (lock->partitioned()) {
             lock->migratePartitionedLockHeads();
         }
+        if (lock->fastPathLock) {
+            lock->closeFastPathLockHead();
+        }
         if (lock->grantedModes == 0) {
             invariant(lock->grantedModes == 0);
             invariant(lock->grantedList._front == NULL);
@@ -684,6 +914,7 @@ void LockManager::_cleanupUnusedLocksInBucket(LockBucket* bucket) {
             invariant(lock->conflictList._back == NULL);
             invariant(lock->conversionsCount == 0);
             invariant(lock->compatibleFirstCount == 0);
+            invariant(lock->fastPathMigratedCount == 0);
 
             bucket->data.erase(it++);
             deletedLockHeads++;
@@ -727,6 +958,7 @@ void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
 
             if (!conflicts(iter->convertMode, grantedModesWithoutCurrentRequest)) {
                 lock->conversionsCount--;
+                numWaitingRequests.fetchAndSubtract(1);
                 lock->decGrantedModeCount(iter->mode);
                 iter->status = LockRequest::STATUS_GRANTED;
                 iter->mode = iter->convertMode;
@@ -798,7 +1030,8 @@ void LockManager::_onLockModeChanged(LockHead* lock, bool checkConflictQueue) {
 
     // This is a convenient place to check that the state of the two request queues is in sync
     // with the bitmask on the modes.
-    dassert((lock->grantedModes == 0) ^ (lock->grantedList._front != NULL));
+    dassert((lock->grantedModes == 0) ^
+            (lock->grantedList._front != NULL || lock->fastPathMigratedCount != 0));
     dassert((lock->conflictModes == 0) ^ (lock->conflictList._front != NULL));
 }
 
@@ -810,6 +1043,73 @@ LockManager::Partition* LockManager::_getPartition(LockRequest* request) const {
     return &_partitions[request->locker->getId() % _numPartitions];
 }
 
+FastPathLockHead* LockManager::_getFastPathLockHead(ResourceId resId) const {
+    return &_fastPathLockHeads[resId % _numFastPathLockHeads];
+}
+
+bool LockManager::_tryFastPathLock(ResourceId resId, LockRequest* request, LockMode mode) {
+    FastPathLockHead* fastPathLock = _getFastPathLockHead(resId);
+    const uint64_t increment = 1ULL << fastPathCountShift(mode);
+
+    uint64_t state = fastPathLock->state.load();
+    while ((state & kFastPathOpen) && fastPathCount(state, mode) < kFastPathCountMask) {
+        // The owner can only change while the fast path lock head is closed, which also changes
+        // the generation, so a successful compare-and-swap below validates these reads.
+        if (fastPathLock->resourceId.load() != static_cast<uint64_t>(resId)) {
+            return false;
+        }
+        LockHead* const lock = fastPathLock->owner.load();
+
+        const uint64_t oldState = fastPathLock->state.compareAndSwap(state, state + increment);
+        if (oldState == state) {
+            request->lock = lock;
+            request->partitionedLock = NULL;
+            request->fastPathLock = fastPathLock;
+            request->fastPathGeneration = fastPathGeneration(state);
+            request->recursiveCount = 1;
+            request->status = LockRequest::STATUS_GRANTED;
+            request->partitioned = false;
+            request->mode = mode;
+            return true;
+        }
+        state = oldState;
+    }
+
+    return false;
+}
+
+bool LockManager::_tryFastPathUnlock(LockRequest* request) {
+    invariant(request->status == LockRequest::STATUS_GRANTED);
+    FastPathLockHead* fastPathLock = request->fastPathLock;
+    const uint64_t decrement = 1ULL << fastPathCountShift(request->mode);
+
+    uint64_t state = fastPathLock->state.load();
+    while (fastPathGeneration(state) == request->fastPathGeneration) {
+        invariant(fastPathCount(state, request->mode) > 0);
+
+        const uint64_t oldState = fastPathLock->state.compareAndSwap(state, state - decrement);
+        if (oldState == state) {
+            request->fastPathLock = NULL;
+            return true;
+        }
+        state = oldState;
+    }
+
+    // Closed since the request was granted, so it is now accounted for on its LockHead
+    return false;
+}
+
+void LockManager::_migrateFastPathRequest(LockHead* lock, LockRequest* request) {
+    // The fast path lock head must have been closed since the request was granted
+    invariant(fastPathGeneration(request->fastPathLock->state.load()) !=
+              request->fastPathGeneration);
+    invariant(lock->fastPathMigratedCount > 0);
+
+    lock->fastPathMigratedCount--;
+    lock->grantedList.push_back(request);
+    request->fastPathLock = NULL;
+}
+
 void LockManager::dump() const {
     log() << "Dumping LockManager @ " << static_cast<const void*>(this) << '\n';
 
@@ -861,6 +1161,7 @@ void LockManager::_buildBucketBSON(const LockRequest* iter,
     info.append("convertMode", modeName(iter->convertMode));
     info.append("enqueueAtFront", iter->enqueueAtFront);
     info.append("compatibleFirst", iter->compatibleFirst);
+    info.append("lowPriority", iter->lowPriority);
 
     LockerId lockerId = iter->locker->getId();
     std::map<LockerId, BSONObj>::const_iterator it = lockToClientMap.find(lockerId);
@@ -1152,15 +1453,19 @@ void LockRequest::initNew(Locker* locker, LockGrantNotification* notify) {
 
     enqueueAtFront = false;
     compatibleFirst = false;
+    lowPriority = false;
     recursiveCount = 0;
 
     lock = NULL;
+    fastPathLock = NULL;
+    fastPathGeneration = 0;
     prev = NULL;
     next = NULL;
     status = STATUS_NEW;
     partitioned = false;
     mode = MODE_NONE;
     convertMode = MODE_NONE;
+    passedOverCount = 0;
 }
 
 
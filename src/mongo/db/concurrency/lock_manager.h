@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <cstdint>
 #include <deque>
 #include <map>
@@ -46,6 +47,10 @@
 
 namespace mongo {
 
+// When set, uncontended intent mode requests on the global, database and collection resources are
+// granted through an atomic lock head, without taking the lock bucket or partition mutexes.
+extern std::atomic<bool> internalLockManagerIntentFastPath;  // NOLINT
+
 /**
  * Entry point for the lock manager scheduling functionality. Don't use it directly, but
  * instead go through the Locker interface.
@@ -112,6 +117,12 @@ public:
      */
     void downgrade(LockRequest* request, LockMode newMode);
 
+    /**
+     * Returns whether any request of any lock manager is waiting to be granted or converted.
+     * This is a cheap check, meant for deciding whether it is worth giving up locks.
+     */
+    static bool hasWaitingRequests();
+
     /**
      * Iterates through all buckets and deletes all locks, which have no requests on them. This
      * call is kind of expensive and should only be used for reducing the memory footprint of
@@ -135,7 +146,7 @@ private:
     // The deadlock detector needs to access the buckets and locks directly
     friend class DeadlockDetector;
 
-    // The lockheads need access to the partitions
+    // The lockheads need access to the partitions and the fast path lock heads
     friend struct LockHead;
 
     // These types describe the locks hash table
@@ -170,6 +181,34 @@ private:
      */
     Partition* _getPartition(LockRequest* request) const;
 
+    /**
+     * Retrieves the FastPathLockHead, which a particular resource may use for intent locking.
+     * Multiple resources may map to the same FastPathLockHead, but only one of them can own it
+     * at any given time.
+     */
+    FastPathLockHead* _getFastPathLockHead(ResourceId resId) const;
+
+    /**
+     * Tries to grant an intent mode request through the fast path lock head for resId without
+     * taking any mutex. Returns false if the fast path lock head is closed, is owned by another
+     * resource or has run out of space in its counters, in which case the request is untouched.
+     */
+    bool _tryFastPathLock(ResourceId resId, LockRequest* request, LockMode mode);
+
+    /**
+     * Releases a request granted by _tryFastPathLock. Returns false if the fast path lock head
+     * has since been closed, in which case the request must be released from its LockHead.
+     */
+    bool _tryFastPathUnlock(LockRequest* request);
+
+    /**
+     * Puts a request granted through a since closed fast path lock head on the granted list of
+     * its LockHead, so it can be converted or downgraded like any other granted request.
+     *
+     * MUST be called under the lock bucket's mutex.
+     */
+    void _migrateFastPathRequest(LockHead* lock, LockRequest* request);
+
     /**
      * Prints the contents of a bucket to the log.
      */
@@ -216,6 +255,9 @@ private:
 
     static const unsigned _numPartitions;
     Partition* _partitions;
+
+    static const unsigned _numFastPathLockHeads;
+    FastPathLockHead* _fastPathLockHeads;
 };
 
 
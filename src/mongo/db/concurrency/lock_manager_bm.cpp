@@ -0,0 +1,87 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/lock_manager.h"
+#include "mongo/db/concurrency/lock_state.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+const ResourceId kDatabaseResource(RESOURCE_DATABASE, std::string("benchmark"));
+const ResourceId kCollectionResource(RESOURCE_COLLECTION, std::string("benchmark.coll"));
+
+MONGO_BENCHMARK(LockManagerLockUnlock) {
+    LockManager lockManager;
+    DefaultLockerImpl locker;
+    CondVarLockGrantNotification notify;
+    LockRequest request;
+    request.initNew(&locker, &notify);
+    while (state.keepRunning()) {
+        lockManager.lock(kCollectionResource, &request, MODE_IX);
+        lockManager.unlock(&request);
+    }
+}
+
+MONGO_BENCHMARK(LockerGlobalLockUnlock) {
+    DefaultLockerImpl locker;
+    while (state.keepRunning()) {
+        locker.lockGlobal(MODE_IX);
+        locker.unlockGlobal();
+    }
+}
+
+MONGO_BENCHMARK(LockerCollectionLockUnlock) {
+    DefaultLockerImpl locker;
+    while (state.keepRunning()) {
+        locker.lockGlobal(MODE_IX);
+        locker.lock(kDatabaseResource, MODE_IX);
+        locker.lock(kCollectionResource, MODE_IX);
+        locker.unlock(kCollectionResource);
+        locker.unlock(kDatabaseResource);
+        locker.unlockGlobal();
+    }
+}
+
+MONGO_BENCHMARK(LockerGetLockerInfo) {
+    DefaultLockerImpl locker;
+    locker.lockGlobal(MODE_IX);
+    locker.lock(kDatabaseResource, MODE_IX);
+    locker.lock(kCollectionResource, MODE_IX);
+    while (state.keepRunning()) {
+        Locker::LockerInfo info;
+        locker.getLockerInfo(&info);
+        benchmark::doNotOptimizeAway(info);
+    }
+    locker.unlockGlobal();
+}
+
+}  // namespace
+}  // namespace mongo
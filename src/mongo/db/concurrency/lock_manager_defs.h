@@ -40,6 +40,7 @@ namespace mongo {
 
 class Locker;
 
+struct FastPathLockHead;
 struct LockHead;
 struct PartitionedLockHead;
 
@@ -364,6 +365,11 @@ struct LockRequest {
     // granted immediately. This effectively turns off fairness.
     bool compatibleFirst;
 
+    // If the request cannot be granted right away, whether it may be queued behind requests
+    // without this flag which arrive later. Each low priority request is passed over only a
+    // bounded number of times, so it is not starved. Default is FALSE.
+    bool lowPriority;
+
     // When set, an attempt is made to execute this request using partitioned lockheads.
     // This speeds up the common case where all requested locking modes are compatible with
     // each other, at the cost of extra overhead for conflicting modes.
@@ -389,6 +395,14 @@ struct LockRequest {
     // only transition from 'partitionedLock' to 'lock', never the other way around.
     PartitionedLockHead* partitionedLock;
 
+    // Pointer to the fast path lock head through which this request was granted, or null if it
+    // was granted through 'lock' or 'partitionedLock'. If set, 'lock' points to the LockHead,
+    // which owned the fast path lock head at the time of the grant and 'fastPathGeneration'
+    // identifies that ownership. Once the fast path lock head has moved to a later generation,
+    // the request is accounted for on 'lock' instead.
+    FastPathLockHead* fastPathLock;
+    uint64_t fastPathGeneration;
+
     // The reason intrusive linked list is used instead of the std::list class is to allow
     // for entries to be removed from the middle of the list in O(1) time, if they are known
     // instead of having to search for them and we cannot persist iterators, because the list
@@ -406,6 +420,10 @@ struct LockRequest {
     // This value is different from MODE_NONE only if a conversion is requested for a lock and
     // that conversion cannot be immediately granted.
     LockMode convertMode;
+
+    // If this is a low priority request on the conflict queue, how many later requests have
+    // been queued ahead of it.
+    unsigned passedOverCount;
 };
 
 /**
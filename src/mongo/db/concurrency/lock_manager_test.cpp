@@ -684,6 +684,79 @@ TEST(LockManager, EnqueueAtFront) {
     ASSERT(lockMgr.unlock(&requestLow));
 }
 
+TEST(LockManager, LowPriorityQueuedBehindLaterRequests) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    MMAPV1LockerImpl lockerX;
+    LockRequestCombo requestX(&lockerX);
+
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestX, MODE_X));
+
+    MMAPV1LockerImpl lockerLow;
+    LockRequestCombo requestLow(&lockerLow);
+    requestLow.lowPriority = true;
+
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestLow, MODE_X));
+
+    // This request arrives later, but goes before the low priority one
+    MMAPV1LockerImpl lockerNormal;
+    LockRequestCombo requestNormal(&lockerNormal);
+
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestNormal, MODE_X));
+    ASSERT_EQUALS(1U, requestLow.passedOverCount);
+
+    ASSERT(lockMgr.unlock(&requestX));
+
+    ASSERT(requestNormal.lastResId == resId);
+    ASSERT(requestNormal.lastResult == LOCK_OK);
+    ASSERT(requestLow.lastResult == LOCK_INVALID);
+
+    ASSERT(lockMgr.unlock(&requestNormal));
+
+    ASSERT(requestLow.lastResId == resId);
+    ASSERT(requestLow.lastResult == LOCK_OK);
+
+    // This avoids the lock manager asserting on leaked locks
+    ASSERT(lockMgr.unlock(&requestLow));
+}
+
+TEST(LockManager, HasWaitingRequests) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    MMAPV1LockerImpl locker1;
+    LockRequestCombo request1(&locker1);
+
+    MMAPV1LockerImpl locker2;
+    LockRequestCombo request2(&locker2);
+
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request1, MODE_S));
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request2, MODE_S));
+    ASSERT_FALSE(LockManager::hasWaitingRequests());
+
+    // A conversion which has to wait counts, as does a request on the conflict queue
+    ASSERT(LOCK_WAITING == lockMgr.convert(resId, &request1, MODE_X));
+    ASSERT_TRUE(LockManager::hasWaitingRequests());
+
+    // Cancel the conversion and release the lock
+    ASSERT(!lockMgr.unlock(&request1));
+    ASSERT_FALSE(LockManager::hasWaitingRequests());
+    ASSERT(lockMgr.unlock(&request1));
+
+    MMAPV1LockerImpl locker3;
+    LockRequestCombo request3(&locker3);
+
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &request3, MODE_X));
+    ASSERT_TRUE(LockManager::hasWaitingRequests());
+
+    ASSERT(lockMgr.unlock(&request2));
+    ASSERT_FALSE(LockManager::hasWaitingRequests());
+    ASSERT(request3.lastResult == LOCK_OK);
+
+    ASSERT(lockMgr.unlock(&request3));
+}
+
 TEST(LockManager, CompatibleFirstImmediateGrant) {
     LockManager lockMgr;
     const ResourceId resId(RESOURCE_GLOBAL, 0);
@@ -932,4 +1005,168 @@ TEST(LockManager, Fairness) {
     ASSERT(lockMgr.unlock(&requestIX1));
 }
 
+namespace {
+
+/**
+ * Enables the intent lock fast path for the duration of a test.
+ */
+class IntentFastPathEnabled {
+public:
+    IntentFastPathEnabled() : _oldValue(internalLockManagerIntentFastPath.load()) {
+        internalLockManagerIntentFastPath.store(true);
+    }
+
+    ~IntentFastPathEnabled() {
+        internalLockManagerIntentFastPath.store(_oldValue);
+    }
+
+private:
+    const bool _oldValue;
+};
+
+}  // namespace
+
+TEST(LockManager, FastPathGrantIntentModes) {
+    IntentFastPathEnabled fastPathEnabled;
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    MMAPV1LockerImpl lockerIS;
+    LockRequestCombo requestIS(&lockerIS);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIS, MODE_IS));
+    ASSERT(requestIS.fastPathLock != NULL);
+    ASSERT(requestIS.recursiveCount == 1);
+
+    MMAPV1LockerImpl lockerIX;
+    LockRequestCombo requestIX(&lockerIX);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIX, MODE_IX));
+    ASSERT(requestIX.fastPathLock == requestIS.fastPathLock);
+
+    // Recursive acquisitions in covered modes don't leave the fast path
+    ASSERT(LOCK_OK == lockMgr.convert(resId, &requestIX, MODE_IS));
+    ASSERT(!lockMgr.unlock(&requestIX));
+    ASSERT(requestIX.fastPathLock != NULL);
+
+    ASSERT(lockMgr.unlock(&requestIS));
+    ASSERT(lockMgr.unlock(&requestIX));
+    ASSERT(requestIS.fastPathLock == NULL);
+    ASSERT(requestIX.fastPathLock == NULL);
+}
+
+TEST(LockManager, FastPathNotUsedForOtherResourcesOrModes) {
+    IntentFastPathEnabled fastPathEnabled;
+    LockManager lockMgr;
+    const ResourceId resIdMetadata(RESOURCE_METADATA, std::string("TestDB.collection"));
+    const ResourceId resIdCollection(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    MMAPV1LockerImpl locker;
+    LockRequestCombo requestMetadata(&locker);
+    ASSERT(LOCK_OK == lockMgr.lock(resIdMetadata, &requestMetadata, MODE_IX));
+    ASSERT(requestMetadata.fastPathLock == NULL);
+
+    LockRequestCombo requestCollection(&locker);
+    ASSERT(LOCK_OK == lockMgr.lock(resIdCollection, &requestCollection, MODE_S));
+    ASSERT(requestCollection.fastPathLock == NULL);
+
+    ASSERT(lockMgr.unlock(&requestMetadata));
+    ASSERT(lockMgr.unlock(&requestCollection));
+}
+
+TEST(LockManager, FastPathConflict) {
+    IntentFastPathEnabled fastPathEnabled;
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_DATABASE, std::string("TestDB"));
+
+    MMAPV1LockerImpl lockerIS;
+    LockRequestCombo requestIS(&lockerIS);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIS, MODE_IS));
+    ASSERT(requestIS.fastPathLock != NULL);
+
+    MMAPV1LockerImpl lockerIX;
+    LockRequestCombo requestIX(&lockerIX);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIX, MODE_IX));
+    ASSERT(requestIX.fastPathLock != NULL);
+
+    // The conflicting request must close the fast path and wait for both intent locks
+    MMAPV1LockerImpl lockerX;
+    LockRequestCombo requestX(&lockerX);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestX, MODE_X));
+
+    // No new intent locks are granted through the fast path while the X lock is pending
+    MMAPV1LockerImpl lockerIS1;
+    LockRequestCombo requestIS1(&lockerIS1);
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestIS1, MODE_IS));
+    ASSERT(requestIS1.fastPathLock == NULL);
+
+    ASSERT(lockMgr.unlock(&requestIS));
+    ASSERT_EQ(0, requestX.numNotifies);
+
+    ASSERT(lockMgr.unlock(&requestIX));
+    ASSERT_EQ(1, requestX.numNotifies);
+    ASSERT_EQ(LOCK_OK, requestX.lastResult);
+    ASSERT_EQ(0, requestIS1.numNotifies);
+
+    ASSERT(lockMgr.unlock(&requestX));
+    ASSERT_EQ(1, requestIS1.numNotifies);
+    ASSERT_EQ(LOCK_OK, requestIS1.lastResult);
+
+    ASSERT(lockMgr.unlock(&requestIS1));
+}
+
+TEST(LockManager, FastPathConvertUpgrade) {
+    IntentFastPathEnabled fastPathEnabled;
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_GLOBAL, 0);
+
+    MMAPV1LockerImpl locker1;
+    LockRequestCombo request1(&locker1);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request1, MODE_IX));
+    ASSERT(request1.fastPathLock != NULL);
+
+    MMAPV1LockerImpl locker2;
+    LockRequestCombo request2(&locker2);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request2, MODE_IS));
+    ASSERT(request2.fastPathLock != NULL);
+
+    // Upgrading must wait for the other fast path holder
+    ASSERT(LOCK_WAITING == lockMgr.convert(resId, &request1, MODE_X));
+    ASSERT(request1.fastPathLock == NULL);
+
+    ASSERT(lockMgr.unlock(&request2));
+    ASSERT_EQ(1, request1.numNotifies);
+    ASSERT_EQ(LOCK_OK, request1.lastResult);
+    ASSERT(request1.mode == MODE_X);
+
+    // Downgrade back to IX, which keeps the request on the LockHead
+    lockMgr.downgrade(&request1, MODE_IX);
+    ASSERT(request1.mode == MODE_IX);
+
+    ASSERT(!lockMgr.unlock(&request1));
+    ASSERT(lockMgr.unlock(&request1));
+}
+
+TEST(LockManager, FastPathDowngrade) {
+    IntentFastPathEnabled fastPathEnabled;
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_GLOBAL, 0);
+
+    MMAPV1LockerImpl locker1;
+    LockRequestCombo request1(&locker1);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request1, MODE_IX));
+    ASSERT(request1.fastPathLock != NULL);
+
+    lockMgr.downgrade(&request1, MODE_IS);
+    ASSERT(request1.mode == MODE_IS);
+    ASSERT(request1.fastPathLock == NULL);
+
+    // The fast path lock head was closed, so the next intent lock reopens it
+    MMAPV1LockerImpl locker2;
+    LockRequestCombo request2(&locker2);
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &request2, MODE_IX));
+    ASSERT(request2.fastPathLock != NULL);
+
+    ASSERT(lockMgr.unlock(&request1));
+    ASSERT(lockMgr.unlock(&request2));
+}
+
 }  // namespace mongo
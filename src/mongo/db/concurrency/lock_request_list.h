@@ -75,6 +75,21 @@ public:
         }
     }
 
+    void insert_before(LockRequest* request, LockRequest* position) {
+        // Sanity check that we do not reuse entries without cleaning them up
+        invariant(request->next == NULL);
+        invariant(request->prev == NULL);
+
+        request->next = position;
+        request->prev = position->prev;
+        if (position->prev != NULL) {
+            position->prev->next = request;
+        } else {
+            _front = request;
+        }
+        position->prev = request;
+    }
+
     void remove(LockRequest* request) {
         if (request->prev != NULL) {
             request->prev->next = request->next;
@@ -34,14 +34,18 @@
 
 #include <vector>
 
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/client.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/wait_event_stats.h"
 #include "mongo/platform/compiler.h"
 #include "mongo/util/background.h"
 #include "mongo/util/concurrency/ticketholder.h"
 #include "mongo/util/debug_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace {
@@ -59,6 +63,10 @@ public:
         _get(id).recordAcquisition(resId, mode);
     }
 
+    void recordFastPathAcquisition(LockerId id, ResourceId resId, LockMode mode) {
+        _get(id).recordFastPathAcquisition(resId, mode);
+    }
+
     void recordWait(LockerId id, ResourceId resId, LockMode mode) {
         _get(id).recordWait(resId, mode);
     }
@@ -269,6 +277,33 @@ void Locker::setGlobalThrottling(class TicketHolder* reading, class TicketHolder
     ticketHolders[MODE_IX] = writing;
 }
 
+/* static */
+void Locker::appendGlobalThrottlingStats(BSONObjBuilder* builder) {
+    auto appendHolder = [builder](StringData name, TicketHolder* holder) {
+        if (!holder) {
+            return;
+        }
+        BSONObjBuilder sub(builder->subobjStart(name));
+        sub.append("out", holder->used());
+        sub.append("available", holder->available());
+        sub.append("totalTickets", holder->outof());
+        sub.append("waiting", holder->waiting());
+    };
+
+    appendHolder("read", ticketHolders[MODE_S]);
+    appendHolder("write", ticketHolders[MODE_IX]);
+}
+
+/* static */
+bool Locker::hasGlobalThrottlingWaiters() {
+    for (auto holder : {ticketHolders[MODE_S], ticketHolders[MODE_IX]}) {
+        if (holder && holder->waiting() > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 template <bool IsForMMAPV1>
 LockerImpl<IsForMMAPV1>::LockerImpl()
     : _id(idCounter.addAndFetch(1)), _wuowNestingLevel(0), _batchWriter(false) {}
@@ -311,10 +346,17 @@ LockResult LockerImpl<IsForMMAPV1>::lockGlobalBegin(LockMode mode) {
     dassert(isLocked() == (_modeForTicket != MODE_NONE));
     if (_modeForTicket == MODE_NONE) {
         const bool reader = isSharedLockMode(mode);
-        auto holder = ticketHolders[mode];
+        auto holder = _shouldAcquireTicket ? ticketHolders[mode] : nullptr;
         if (holder) {
             _clientState.store(reader ? kQueuedReader : kQueuedWriter);
-            holder->waitForTicket();
+            if (!holder->tryAcquire()) {
+                // The locker has no pointer to its operation, but it is always used by the thread
+                // running that operation.
+                ScopedWaitEvent wait(haveClient() ? cc().getOperationContext() : nullptr,
+                                     WaitEvent::kTicketAcquisition);
+                holder->waitForTicket(_lowPriority ? TicketHolder::Priority::kLow
+                                                   : TicketHolder::Priority::kNormal);
+            }
         }
         _clientState.store(reader ? kActiveReader : kActiveWriter);
         _modeForTicket = mode;
@@ -678,6 +720,8 @@ LockResult LockerImpl<IsForMMAPV1>::lockBegin(ResourceId resId, LockMode mode) {
     globalStats.recordAcquisition(_id, resId, mode);
     _stats.recordAcquisition(resId, mode);
 
+    request->lowPriority = _lowPriority;
+
     // Give priority to the full modes for global, parallel batch writer mode,
     // and flush lock so we don't stall global operations such as shutdown or flush.
     const ResourceType resType = resId.getType();
@@ -710,6 +754,9 @@ LockResult LockerImpl<IsForMMAPV1>::lockBegin(ResourceId resId, LockMode mode) {
     if (result == LOCK_WAITING) {
         globalStats.recordWait(_id, resId, mode);
         _stats.recordWait(resId, mode);
+    } else if (isNew && request->fastPathLock) {
+        globalStats.recordFastPathAcquisition(_id, resId, mode);
+        _stats.recordFastPathAcquisition(resId, mode);
     }
 
     return result;
@@ -735,8 +782,8 @@ LockResult LockerImpl<IsForMMAPV1>::lockComplete(ResourceId resId,
     // Don't go sleeping without bound in order to be able to report long waits or wake up for
     // deadlock detection.
     unsigned waitTimeMs = std::min(timeoutMs, DeadlockTimeoutMs);
-    const uint64_t startOfTotalWaitTime = curTimeMicros64();
-    uint64_t startOfCurrentWaitTime = startOfTotalWaitTime;
+    const Timer waitTimer;
+    uint64_t startOfCurrentWaitTime = 0;
 
     while (true) {
         // It is OK if this call wakes up spuriously, because we re-evaluate the remaining
@@ -744,7 +791,7 @@ LockResult LockerImpl<IsForMMAPV1>::lockComplete(ResourceId resId,
         result = _notify.wait(waitTimeMs);
 
         // Account for the time spent waiting on the notification object
-        const uint64_t curTimeMicros = curTimeMicros64();
+        const uint64_t curTimeMicros = waitTimer.micros();
         const uint64_t elapsedTimeMicros = curTimeMicros - startOfCurrentWaitTime;
         startOfCurrentWaitTime = curTimeMicros;
 
@@ -772,7 +819,7 @@ LockResult LockerImpl<IsForMMAPV1>::lockComplete(ResourceId resId,
             continue;
         }
 
-        const unsigned totalBlockTimeMs = (curTimeMicros - startOfTotalWaitTime) / 1000;
+        const unsigned totalBlockTimeMs = curTimeMicros / 1000;
         waitTimeMs = (totalBlockTimeMs < timeoutMs)
             ? std::min(timeoutMs - totalBlockTimeMs, DeadlockTimeoutMs)
             : 0;
@@ -802,7 +849,7 @@ bool LockerImpl<IsForMMAPV1>::_unlockImpl(LockRequestsMap::Iterator* it) {
     if (globalLockManager.unlock(it->objAddr())) {
         if (it->key() == resourceIdGlobal) {
             invariant(_modeForTicket != MODE_NONE);
-            auto holder = ticketHolders[_modeForTicket];
+            auto holder = _shouldAcquireTicket ? ticketHolders[_modeForTicket] : nullptr;
             _modeForTicket = MODE_NONE;
             if (holder) {
                 holder->release();
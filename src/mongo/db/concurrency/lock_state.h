@@ -220,6 +220,15 @@ private:
     // Mode for which the Locker acquired a ticket, or MODE_NONE if no ticket was acquired.
     LockMode _modeForTicket = MODE_NONE;
 
+    // If false, the global lock is taken without a ticket.
+    bool _shouldAcquireTicket = true;
+
+    // If true, this locker waits for tickets and locks at low priority.
+    bool _lowPriority = false;
+
+    // If false, the global lock is taken without the ParallelBatchWriterMode lock.
+    bool _shouldConflictWithSecondaryBatchApplication = true;
+
     // Indicates whether the client is active reader/writer or is queued.
     AtomicWord<ClientState> _clientState{kInactive};
 
@@ -252,6 +261,27 @@ public:
         return _batchWriter;
     }
 
+    virtual void setShouldAcquireTicket(bool newValue) {
+        invariant(!isLocked());
+        _shouldAcquireTicket = newValue;
+    }
+
+    virtual void setLowPriority(bool newValue) {
+        invariant(!isLocked());
+        _lowPriority = newValue;
+    }
+    virtual bool isLowPriority() const {
+        return _lowPriority;
+    }
+
+    virtual void setShouldConflictWithSecondaryBatchApplication(bool newValue) {
+        invariant(!isLocked());
+        _shouldConflictWithSecondaryBatchApplication = newValue;
+    }
+    virtual bool shouldConflictWithSecondaryBatchApplication() const {
+        return _shouldConflictWithSecondaryBatchApplication;
+    }
+
 private:
     bool _batchWriter;
 };
@@ -36,7 +36,9 @@
 #include "mongo/config.h"
 #include "mongo/db/concurrency/lock_manager_test_help.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/ticketholder.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 #include "mongo/util/timer.h"
 
 namespace mongo {
@@ -130,6 +132,26 @@ TEST(LockerImpl, ReadTransaction) {
     locker.unlockGlobal();
 }
 
+TEST(LockerImpl, LockerWhichShouldNotAcquireTicketsIgnoresThrottling) {
+    TicketHolder tickets(1);
+    Locker::setGlobalThrottling(&tickets, &tickets);
+    ON_BLOCK_EXIT([] { Locker::setGlobalThrottling(nullptr, nullptr); });
+
+    DefaultLockerImpl user;
+    ASSERT(LOCK_OK == user.lockGlobal(MODE_IX));
+    ASSERT_EQUALS(0, tickets.available());
+
+    DefaultLockerImpl internal;
+    internal.setShouldAcquireTicket(false);
+    ASSERT(LOCK_OK == internal.lockGlobal(MODE_IX));
+    ASSERT_EQUALS(1, tickets.used());
+    internal.unlockGlobal();
+    ASSERT_EQUALS(1, tickets.used());
+
+    user.unlockGlobal();
+    ASSERT_EQUALS(0, tickets.used());
+}
+
 /**
  * Test that saveMMAPV1LockerImpl works by examining the output.
  */
@@ -77,6 +77,25 @@ void LockStats<CounterType>::_report(BSONObjBuilder* builder,
         }
     }
 
+    // Num acquires granted through the lock manager's fast path
+    {
+        std::unique_ptr<BSONObjBuilder> numFastPathAcquires;
+        for (int mode = 1; mode < LockModesCount; mode++) {
+            const long long value = CounterOps::get(stat.modeStats[mode].numFastPathAcquisitions);
+            if (value > 0) {
+                if (!numFastPathAcquires) {
+                    if (!section) {
+                        section.reset(new BSONObjBuilder(builder->subobjStart(sectionName)));
+                    }
+
+                    numFastPathAcquires.reset(
+                        new BSONObjBuilder(section->subobjStart("acquireFastPathCount")));
+                }
+                numFastPathAcquires->append(legacyModeName(static_cast<LockMode>(mode)), value);
+            }
+        }
+    }
+
     // Num waits
     {
         std::unique_ptr<BSONObjBuilder> numWaits;
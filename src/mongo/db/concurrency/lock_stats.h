@@ -78,6 +78,7 @@ struct LockStatCounters {
     template <typename OtherType>
     void append(const LockStatCounters<OtherType>& other) {
         CounterOps::add(numAcquisitions, other.numAcquisitions);
+        CounterOps::add(numFastPathAcquisitions, other.numFastPathAcquisitions);
         CounterOps::add(numWaits, other.numWaits);
         CounterOps::add(combinedWaitTimeMicros, other.combinedWaitTimeMicros);
         CounterOps::add(numDeadlocks, other.numDeadlocks);
@@ -85,6 +86,7 @@ struct LockStatCounters {
 
     void reset() {
         CounterOps::set(numAcquisitions, 0);
+        CounterOps::set(numFastPathAcquisitions, 0);
         CounterOps::set(numWaits, 0);
         CounterOps::set(combinedWaitTimeMicros, 0);
         CounterOps::set(numDeadlocks, 0);
@@ -92,6 +94,8 @@ struct LockStatCounters {
 
 
     CounterType numAcquisitions;
+    // Subset of numAcquisitions, which the lock manager granted without taking any mutex
+    CounterType numFastPathAcquisitions;
     CounterType numWaits;
     CounterType combinedWaitTimeMicros;
     CounterType numDeadlocks;
@@ -117,6 +121,10 @@ public:
         CounterOps::add(get(resId, mode).numAcquisitions, 1);
     }
 
+    void recordFastPathAcquisition(ResourceId resId, LockMode mode) {
+        CounterOps::add(get(resId, mode).numFastPathAcquisitions, 1);
+    }
+
     void recordWait(ResourceId resId, LockMode mode) {
         CounterOps::add(get(resId, mode).numWaits, 1);
     }
@@ -52,6 +52,27 @@ TEST(LockStats, NoWait) {
     ASSERT_EQUALS(0, stats.get(resId, MODE_X).combinedWaitTimeMicros);
 }
 
+TEST(LockStats, FastPath) {
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("LockStats.FastPath"));
+
+    const bool oldFastPath = internalLockManagerIntentFastPath.load();
+    internalLockManagerIntentFastPath.store(true);
+    resetGlobalLockStats();
+
+    LockerForTests locker(MODE_IX);
+    locker.lock(resId, MODE_IX);
+    locker.unlock(resId);
+
+    internalLockManagerIntentFastPath.store(oldFastPath);
+
+    SingleThreadedLockStats stats;
+    reportGlobalLockingStats(&stats);
+
+    ASSERT_EQUALS(1, stats.get(resId, MODE_IX).numAcquisitions);
+    ASSERT_EQUALS(1, stats.get(resId, MODE_IX).numFastPathAcquisitions);
+    ASSERT_EQUALS(0, stats.get(resId, MODE_IX).numWaits);
+}
+
 TEST(LockStats, Wait) {
     const ResourceId resId(RESOURCE_COLLECTION, std::string("LockStats.Wait"));
 
@@ -57,6 +57,18 @@ public:
      */
     static void setGlobalThrottling(class TicketHolder* reading, class TicketHolder* writing);
 
+    /**
+     * Appends the number of tickets in use, available and waited for to 'builder', as
+     * {read: {...}, write: {...}}, for the ticket holders installed by setGlobalThrottling. Appends
+     * nothing if there is no throttling.
+     */
+    static void appendGlobalThrottlingStats(BSONObjBuilder* builder);
+
+    /**
+     * Returns whether any operation is waiting for a ticket installed by setGlobalThrottling.
+     */
+    static bool hasGlobalThrottlingWaiters();
+
     /**
      * State for reporting the number of active and queued reader and writer clients.
      */
@@ -306,6 +318,30 @@ public:
     virtual void setIsBatchWriter(bool newValue) = 0;
     virtual bool isBatchWriter() const = 0;
 
+    /**
+     * Set to false for internal operations which must not queue behind user operations for the
+     * tickets installed by setGlobalThrottling, such as oplog application and diagnostic data
+     * collection. Must not be called while the global lock is held.
+     */
+    virtual void setShouldAcquireTicket(bool newValue) = 0;
+
+    /**
+     * While both are waiting, low priority operations get tickets and conflicting locks after
+     * normal priority ones, though never fall behind indefinitely. Their plans also yield more
+     * often. Must not be called while the global lock is held.
+     */
+    virtual void setLowPriority(bool newValue) = 0;
+    virtual bool isLowPriority() const = 0;
+
+    /**
+     * Set to false for reads on a secondary which are served from the snapshot taken at the end
+     * of the last applied batch, so that the global lock is taken without waiting for the
+     * ParallelBatchWriterMode lock held during batch application. Must not be called while the
+     * global lock is held.
+     */
+    virtual void setShouldConflictWithSecondaryBatchApplication(bool newValue) = 0;
+    virtual bool shouldConflictWithSecondaryBatchApplication() const = 0;
+
 protected:
     Locker() {}
 };
@@ -167,6 +167,20 @@ public:
     virtual bool isBatchWriter() const {
         invariant(false);
     }
+
+    virtual void setShouldAcquireTicket(bool newValue) {}
+
+    virtual void setLowPriority(bool newValue) {}
+
+    virtual bool isLowPriority() const {
+        return false;
+    }
+
+    virtual void setShouldConflictWithSecondaryBatchApplication(bool newValue) {}
+
+    virtual bool shouldConflictWithSecondaryBatchApplication() const {
+        return true;
+    }
 };
 
 }  // namespace mongo
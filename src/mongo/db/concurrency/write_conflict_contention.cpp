@@ -0,0 +1,165 @@
+/**
+ * Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/write_conflict_contention.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+
+namespace {
+
+using Document = std::pair<std::string, RecordId>;
+
+const auto getManager = ServiceContext::declareDecoration<WriteConflictContentionManager>();
+
+// The document an operation last conflicted on, until it waits for its turn to retry it.
+const auto getNotedConflict = OperationContext::declareDecoration<boost::optional<Document>>();
+
+const Milliseconds kInterruptCheckInterval(10);
+
+}  // namespace
+
+const Milliseconds WriteConflictContentionManager::kMaxWait(100);
+
+void WriteConflictContentionManager::Turn::release() {
+    if (_manager) {
+        _manager->_release(_document);
+        _manager = nullptr;
+    }
+}
+
+WriteConflictContentionManager& WriteConflictContentionManager::get(ServiceContext* service) {
+    return getManager(service);
+}
+
+void WriteConflictContentionManager::noteConflict(OperationContext* txn,
+                                                  StringData ns,
+                                                  const RecordId& id) {
+    getNotedConflict(txn) = Document(ns.toString(), id);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ++_stats[ns].writeConflicts;
+}
+
+bool WriteConflictContentionManager::waitForTurn(OperationContext* txn, Turn* turn) {
+    auto& noted = getNotedConflict(txn);
+    if (!noted) {
+        return false;
+    }
+    Document document = std::move(*noted);
+    noted = boost::none;
+
+    if (turn->isHeld() && turn->_document == document) {
+        // Another writer beat the turn holder to the document, so there is nobody to wait for.
+        return false;
+    }
+    turn->release();
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    DocumentQueue& queue = _queues[document];
+    if (!queue.held) {
+        queue.held = true;
+    } else {
+        CollectionStats& stats = _stats[document.first];
+        Waiter waiter;
+        queue.waiters.push_back(&waiter);
+        ++stats.waits;
+        stats.maxQueueLength =
+            std::max(stats.maxQueueLength, static_cast<long long>(queue.waiters.size()));
+
+        const Date_t start = Date_t::now();
+        const Date_t deadline = start + kMaxWait;
+        while (!waiter.granted) {
+            if (Date_t::now() >= deadline || !txn->checkForInterruptNoAssert().isOK()) {
+                break;
+            }
+            _turnGranted.wait_for(lk, kInterruptCheckInterval.toSystemDuration());
+        }
+        stats.waitMicros += durationCount<Microseconds>(Date_t::now() - start);
+
+        if (!waiter.granted) {
+            // The queue is still held by someone else, so it can't have been removed.
+            queue.waiters.remove(&waiter);
+            ++stats.waitTimeouts;
+            return true;
+        }
+    }
+
+    turn->_manager = this;
+    turn->_document = std::move(document);
+    return true;
+}
+
+void WriteConflictContentionManager::_release(const Document& document) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _queues.find(document);
+    invariant(it != _queues.end() && it->second.held);
+
+    DocumentQueue& queue = it->second;
+    if (queue.waiters.empty()) {
+        _queues.erase(it);
+        return;
+    }
+
+    queue.waiters.front()->granted = true;
+    queue.waiters.pop_front();
+    _turnGranted.notify_all();
+}
+
+void WriteConflictContentionManager::appendStats(StringData ns, BSONObjBuilder* builder) const {
+    CollectionStats stats;
+    long long hotDocuments = 0;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _stats.find(ns);
+        if (it != _stats.end()) {
+            stats = it->second;
+        }
+        for (auto&& queue : _queues) {
+            if (queue.first.first == ns && !queue.second.waiters.empty()) {
+                ++hotDocuments;
+            }
+        }
+    }
+
+    builder->append("writeConflicts", stats.writeConflicts);
+    builder->append("contentionWaits", stats.waits);
+    builder->append("contentionWaitMicros", stats.waitMicros);
+    builder->append("contentionWaitTimeouts", stats.waitTimeouts);
+    builder->append("maxQueueLength", stats.maxQueueLength);
+    builder->append("currentHotDocuments", hotDocuments);
+}
+
+}  // namespace mongo
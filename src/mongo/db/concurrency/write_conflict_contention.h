@@ -0,0 +1,142 @@
+/**
+ * Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Queues writers which hit a WriteConflictException on the same document, so that they retry one
+ * at a time in the order they conflicted rather than all spinning on it at once.
+ *
+ * A write stage calls noteConflict() when its write to a document conflicts. The retry loop then
+ * calls waitForTurn(), which blocks until the writers queued earlier on that document have
+ * retried, and leaves the caller holding a Turn until its own retry is done.
+ */
+class WriteConflictContentionManager {
+    MONGO_DISALLOW_COPYING(WriteConflictContentionManager);
+
+public:
+    /**
+     * The longest a writer waits for its turn. A writer waiting longer, e.g. because the one
+     * ahead of it waits on a lock held by the writer, retries without its turn.
+     */
+    static const Milliseconds kMaxWait;
+
+    /**
+     * The right to retry writing a document ahead of the writers queued behind it. Handed to the
+     * next writer when released or destroyed.
+     */
+    class Turn {
+        MONGO_DISALLOW_COPYING(Turn);
+
+    public:
+        Turn() = default;
+        ~Turn() {
+            release();
+        }
+
+        void release();
+
+        bool isHeld() const {
+            return _manager != nullptr;
+        }
+
+    private:
+        friend class WriteConflictContentionManager;
+
+        WriteConflictContentionManager* _manager = nullptr;
+        std::pair<std::string, RecordId> _document;
+    };
+
+    WriteConflictContentionManager() = default;
+
+    static WriteConflictContentionManager& get(ServiceContext* service);
+
+    /**
+     * Records that 'txn' conflicted writing the document 'id' of collection 'ns'. The next call
+     * to waitForTurn() for 'txn' queues on that document.
+     */
+    void noteConflict(OperationContext* txn, StringData ns, const RecordId& id);
+
+    /**
+     * Waits for the turn of 'txn' to retry the document of its last noted conflict, and stores it
+     * in 'turn'. Returns false without waiting if no conflict was noted since the last call or if
+     * 'turn' already holds that document, in which case the caller should back off instead.
+     */
+    bool waitForTurn(OperationContext* txn, Turn* turn);
+
+    /**
+     * Appends the write conflict counters of collection 'ns' to 'builder'.
+     */
+    void appendStats(StringData ns, BSONObjBuilder* builder) const;
+
+private:
+    struct Waiter {
+        bool granted = false;
+    };
+
+    struct DocumentQueue {
+        bool held = false;
+        std::list<Waiter*> waiters;
+    };
+
+    struct CollectionStats {
+        long long writeConflicts = 0;
+        long long waits = 0;
+        long long waitMicros = 0;
+        long long waitTimeouts = 0;
+        long long maxQueueLength = 0;
+    };
+
+    void _release(const std::pair<std::string, RecordId>& document);
+
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _turnGranted;
+    std::map<std::pair<std::string, RecordId>, DocumentQueue> _queues;
+    StringMap<CollectionStats> _stats;
+};
+
+}  // namespace mongo
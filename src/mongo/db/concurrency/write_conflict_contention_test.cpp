@@ -0,0 +1,185 @@
+/**
+ * Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/write_conflict_contention.h"
+
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/operation_context_noop.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+class WriteConflictContentionTest : public unittest::Test {
+protected:
+    OperationContext* makeOpCtx() {
+        _clients.push_back(_service.makeClient("test"));
+        _opCtxs.push_back(
+            stdx::make_unique<OperationContextNoop>(_clients.back().get(), _opCtxs.size()));
+        return _opCtxs.back().get();
+    }
+
+    BSONObj getStats(StringData ns) {
+        BSONObjBuilder builder;
+        _manager.appendStats(ns, &builder);
+        return builder.obj();
+    }
+
+    /**
+     * Waits until 'count' writers have queued on collection 'ns'.
+     */
+    void waitForWaiters(StringData ns, long long count) {
+        while (getStats(ns)["contentionWaits"].numberLong() < count) {
+            sleepmillis(1);
+        }
+    }
+
+    WriteConflictContentionManager _manager;
+
+private:
+    ServiceContextNoop _service;
+    std::vector<ServiceContext::UniqueClient> _clients;
+    std::vector<std::unique_ptr<OperationContextNoop>> _opCtxs;
+};
+
+TEST_F(WriteConflictContentionTest, NoTurnWithoutNotedConflict) {
+    WriteConflictContentionManager::Turn turn;
+    ASSERT_FALSE(_manager.waitForTurn(makeOpCtx(), &turn));
+    ASSERT_FALSE(turn.isHeld());
+}
+
+TEST_F(WriteConflictContentionTest, FirstWriterTakesTurnWithoutWaiting) {
+    auto txn = makeOpCtx();
+    WriteConflictContentionManager::Turn turn;
+    _manager.noteConflict(txn, "test.coll", RecordId(1));
+    ASSERT_TRUE(_manager.waitForTurn(txn, &turn));
+    ASSERT_TRUE(turn.isHeld());
+
+    // Conflicting again on the same document while holding its turn means backing off.
+    _manager.noteConflict(txn, "test.coll", RecordId(1));
+    ASSERT_FALSE(_manager.waitForTurn(txn, &turn));
+    ASSERT_TRUE(turn.isHeld());
+
+    BSONObj stats = getStats("test.coll");
+    ASSERT_EQUALS(2, stats["writeConflicts"].numberLong());
+    ASSERT_EQUALS(0, stats["contentionWaits"].numberLong());
+}
+
+TEST_F(WriteConflictContentionTest, WritersTakeTurnsInOrder) {
+    auto first = makeOpCtx();
+    auto second = makeOpCtx();
+    auto third = makeOpCtx();
+
+    WriteConflictContentionManager::Turn firstTurn;
+    _manager.noteConflict(first, "test.coll", RecordId(1));
+    ASSERT_TRUE(_manager.waitForTurn(first, &firstTurn));
+
+    stdx::mutex mutex;
+    std::vector<int> order;
+    auto retry = [&](OperationContext* txn, int writer) {
+        WriteConflictContentionManager::Turn turn;
+        _manager.noteConflict(txn, "test.coll", RecordId(1));
+        ASSERT_TRUE(_manager.waitForTurn(txn, &turn));
+        ASSERT_TRUE(turn.isHeld());
+        stdx::lock_guard<stdx::mutex> lk(mutex);
+        order.push_back(writer);
+    };
+
+    stdx::thread secondThread(retry, second, 2);
+    waitForWaiters("test.coll", 1);
+    stdx::thread thirdThread(retry, third, 3);
+    waitForWaiters("test.coll", 2);
+
+    ASSERT_EQUALS(1, getStats("test.coll")["currentHotDocuments"].numberLong());
+    firstTurn.release();
+    secondThread.join();
+    thirdThread.join();
+
+    ASSERT_EQUALS(2U, order.size());
+    ASSERT_EQUALS(2, order[0]);
+    ASSERT_EQUALS(3, order[1]);
+
+    BSONObj stats = getStats("test.coll");
+    ASSERT_EQUALS(2, stats["maxQueueLength"].numberLong());
+    ASSERT_EQUALS(0, stats["contentionWaitTimeouts"].numberLong());
+    ASSERT_EQUALS(0, stats["currentHotDocuments"].numberLong());
+}
+
+TEST_F(WriteConflictContentionTest, WaitGivesUpAfterMaxWait) {
+    auto holder = makeOpCtx();
+    auto waiter = makeOpCtx();
+
+    WriteConflictContentionManager::Turn holderTurn;
+    _manager.noteConflict(holder, "test.coll", RecordId(1));
+    ASSERT_TRUE(_manager.waitForTurn(holder, &holderTurn));
+
+    WriteConflictContentionManager::Turn waiterTurn;
+    _manager.noteConflict(waiter, "test.coll", RecordId(1));
+    ASSERT_TRUE(_manager.waitForTurn(waiter, &waiterTurn));
+    ASSERT_FALSE(waiterTurn.isHeld());
+    ASSERT_EQUALS(1, getStats("test.coll")["contentionWaitTimeouts"].numberLong());
+
+    // The writer which gave up left the queue, so the turn is free once released.
+    holderTurn.release();
+    _manager.noteConflict(waiter, "test.coll", RecordId(1));
+    ASSERT_TRUE(_manager.waitForTurn(waiter, &waiterTurn));
+    ASSERT_TRUE(waiterTurn.isHeld());
+}
+
+TEST_F(WriteConflictContentionTest, DocumentsAreQueuedIndependently) {
+    auto first = makeOpCtx();
+    auto second = makeOpCtx();
+
+    WriteConflictContentionManager::Turn firstTurn;
+    _manager.noteConflict(first, "test.coll", RecordId(1));
+    ASSERT_TRUE(_manager.waitForTurn(first, &firstTurn));
+
+    WriteConflictContentionManager::Turn secondTurn;
+    _manager.noteConflict(second, "test.coll", RecordId(2));
+    ASSERT_TRUE(_manager.waitForTurn(second, &secondTurn));
+    ASSERT_TRUE(secondTurn.isHeld());
+
+    WriteConflictContentionManager::Turn otherCollectionTurn;
+    _manager.noteConflict(second, "test.other", RecordId(1));
+    ASSERT_TRUE(_manager.waitForTurn(second, &otherCollectionTurn));
+    ASSERT_TRUE(otherCollectionTurn.isHeld());
+
+    ASSERT_EQUALS(0, getStats("test.coll")["contentionWaits"].numberLong());
+    ASSERT_EQUALS(1, getStats("test.other")["writeConflicts"].numberLong());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -32,28 +32,33 @@
 
 #include <exception>
 
+#include "mongo/db/concurrency/write_conflict_contention.h"
 #include "mongo/util/assert_util.h"
 
-#define MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN \
-    do {                                      \
-        int wcr__Attempts = 0;                \
-        do {                                  \
+#define MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN                         \
+    do {                                                              \
+        int wcr__Attempts = 0;                                        \
+        ::mongo::WriteConflictContentionManager::Turn wcr__Turn;      \
+        do {                                                          \
             try
-#define MONGO_WRITE_CONFLICT_RETRY_LOOP_END(PTXN, OPSTR, NSSTR) \
-    catch (const ::mongo::WriteConflictException& wce) {        \
-        const OperationContext* ptxn = (PTXN);                  \
-        ++CurOp::get(ptxn)->debug().writeConflicts;             \
-        wce.logAndBackoff(wcr__Attempts, (OPSTR), (NSSTR));     \
-        ++wcr__Attempts;                                        \
-        ptxn->recoveryUnit()->abandonSnapshot();                \
-        continue;                                               \
-    }                                                           \
-    break;                                                      \
-    }                                                           \
-    while (true)                                                \
-        ;                                                       \
-    }                                                           \
-    while (false)                                               \
+#define MONGO_WRITE_CONFLICT_RETRY_LOOP_END(PTXN, OPSTR, NSSTR)                               \
+    catch (const ::mongo::WriteConflictException& wce) {                                      \
+        OperationContext* const ptxn = (PTXN);                                                \
+        ++CurOp::get(ptxn)->debug().writeConflicts;                                           \
+        ptxn->recoveryUnit()->abandonSnapshot();                                              \
+        if (!::mongo::WriteConflictContentionManager::get(ptxn->getServiceContext())          \
+                 .waitForTurn(ptxn, &wcr__Turn)) {                                            \
+            wce.logAndBackoff(wcr__Attempts, (OPSTR), (NSSTR));                               \
+        }                                                                                     \
+        ++wcr__Attempts;                                                                      \
+        continue;                                                                             \
+    }                                                                                         \
+    break;                                                                                    \
+    }                                                                                         \
+    while (true)                                                                              \
+        ;                                                                                     \
+    }                                                                                         \
+    while (false)                                                                             \
         ;
 
 namespace mongo {
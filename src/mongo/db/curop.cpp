@@ -41,7 +41,9 @@
 #include "mongo/db/json.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/util/log.h"
+#include "mongo/util/system_tick_source.h"
 
 namespace mongo {
 
@@ -230,7 +232,11 @@ CurOp* CurOp::get(const OperationContext& opCtx) {
 
 CurOp::CurOp(OperationContext* opCtx) : CurOp(opCtx, &_curopStack(opCtx)) {}
 
-CurOp::CurOp(OperationContext* opCtx, CurOpStack* stack) : _stack(stack) {
+CurOp::CurOp(OperationContext* opCtx, CurOpStack* stack)
+    : _stack(stack),
+      _tickSource(opCtx && opCtx->getClient()
+                      ? opCtx->getServiceContext()->getTickSource()
+                      : SystemTickSource::get()) {
     if (opCtx) {
         _stack->push(opCtx, this);
     } else {
@@ -266,7 +272,7 @@ void CurOp::setNS_inlock(StringData ns) {
 
 void CurOp::ensureStarted() {
     if (_start == 0) {
-        _start = curTimeMicros64();
+        _start = _tickSource->getTicks();
     }
 }
 
@@ -389,6 +395,10 @@ void CurOp::reportState(BSONObjBuilder* builder) {
 }
 
 namespace {
+
+// Log each slow operation as a JSON object of the fields the profiler records, for tools to parse.
+MONGO_EXPORT_SERVER_PARAMETER(logOperationsAsJSON, bool, false);
+
 StringData getProtoString(int op) {
     if (op == dbQuery) {
         return "op_query";
@@ -397,6 +407,39 @@ StringData getProtoString(int op) {
     }
     MONGO_UNREACHABLE;
 }
+
+/**
+ * Returns the fields that OpDebug::append() would put in the profiler entry of the operation as
+ * JSON, with the command redacted as in the text form and without the execution stats.
+ */
+string reportAsJSON(const OpDebug& debug,
+                    const CurOp& curop,
+                    const SingleThreadedLockStats& lockStats,
+                    const WaitEventStats& waitEventStats) {
+    BSONObjBuilder profiled;
+    debug.append(curop, lockStats, waitEventStats, profiled);
+
+    Command* curCommand = curop.getCommand();
+    BSONObjBuilder b;
+    for (auto&& field : profiled.done()) {
+        const StringData fieldName = field.fieldNameStringData();
+        if (fieldName == "execStats") {
+            continue;
+        }
+
+        if (debug.iscommand && curCommand && field.type() == Object &&
+            (fieldName == "command" || fieldName == "query")) {
+            mutablebson::Document cmdToLog(field.Obj(), mutablebson::Document::kInPlaceDisabled);
+            curCommand->redactForLogging(&cmdToLog);
+            b.append(fieldName, cmdToLog.getObject());
+            continue;
+        }
+
+        b.append(field);
+    }
+    return b.done().jsonString();
+}
+
 }  // namespace
 
 #define OPDEBUG_TOSTRING_HELP(x) \
@@ -406,7 +449,13 @@ StringData getProtoString(int op) {
     if (x)                            \
     s << " " #x ":" << (x)
 
-string OpDebug::report(const CurOp& curop, const SingleThreadedLockStats& lockStats) const {
+string OpDebug::report(const CurOp& curop,
+                       const SingleThreadedLockStats& lockStats,
+                       const WaitEventStats& waitEventStats) const {
+    if (logOperationsAsJSON.load()) {
+        return reportAsJSON(*this, curop, lockStats, waitEventStats);
+    }
+
     StringBuilder s;
     if (iscommand)
         s << "command ";
@@ -503,6 +552,12 @@ string OpDebug::report(const CurOp& curop, const SingleThreadedLockStats& lockSt
         s << " locks:" << locks.obj().toString();
     }
 
+    if (!waitEventStats.empty()) {
+        BSONObjBuilder waitEvents;
+        waitEventStats.append(&waitEvents);
+        s << " waitEvents:" << waitEvents.obj().toString();
+    }
+
     if (iscommand) {
         s << " protocol:" << getProtoString(networkOp);
     }
@@ -521,6 +576,7 @@ string OpDebug::report(const CurOp& curop, const SingleThreadedLockStats& lockSt
 
 void OpDebug::append(const CurOp& curop,
                      const SingleThreadedLockStats& lockStats,
+                     const WaitEventStats& waitEventStats,
                      BSONObjBuilder& b) const {
     const size_t maxElementSize = 50 * 1024;
 
@@ -590,6 +646,11 @@ void OpDebug::append(const CurOp& curop,
         lockStats.report(&locks);
     }
 
+    if (!waitEventStats.empty()) {
+        BSONObjBuilder waitEvents(b.subobjStart("waitEvents"));
+        waitEventStats.append(&waitEvents);
+    }
+
     if (!exceptionInfo.empty()) {
         exceptionInfo.append(b, "exception", "exceptionCode");
     }
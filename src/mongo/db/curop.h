@@ -35,9 +35,11 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/stats/wait_event_stats.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/progress_meter.h"
+#include "mongo/util/tick_source.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
@@ -52,16 +54,24 @@ class OpDebug {
 public:
     OpDebug() = default;
 
-    std::string report(const CurOp& curop, const SingleThreadedLockStats& lockStats) const;
+    /**
+     * Returns the line logged for a slow operation. With the logOperationsAsJSON server parameter
+     * set, this is a JSON object of the fields append() reports.
+     */
+    std::string report(const CurOp& curop,
+                       const SingleThreadedLockStats& lockStats,
+                       const WaitEventStats& waitEventStats) const;
 
     /**
      * Appends information about the current operation to "builder"
      *
      * @param curop reference to the CurOp that owns this OpDebug
      * @param lockStats lockStats object containing locking information about the operation
+     * @param waitEventStats the time the operation spent blocked other than on locks
      */
     void append(const CurOp& curop,
                 const SingleThreadedLockStats& lockStats,
+                const WaitEventStats& waitEventStats,
                 BSONObjBuilder& builder) const;
 
     /**
@@ -260,31 +270,29 @@ public:
     }
 
     //
-    // Methods for getting/setting elapsed time. Note that the observed elapsed time may be
-    // negative, if the system time has been reset during the course of this operation.
+    // Methods for getting/setting elapsed time. Times are measured with the service context's
+    // tick source, which is monotonic, so they are unaffected by changes to the system time.
     //
 
     void ensureStarted();
     bool isStarted() const {
         return _start > 0;
     }
-    long long startTime() {  // micros
-        ensureStarted();
-        return _start;
-    }
     void done() {
-        _end = curTimeMicros64();
+        _end = _tickSource->getTicks();
     }
 
     long long totalTimeMicros() {
         massert(12601, "CurOp not marked done yet", _end);
-        return _end - startTime();
+        ensureStarted();
+        return _ticksToMicros(_end - _start);
     }
     int totalTimeMillis() {
         return (int)(totalTimeMicros() / 1000);
     }
     long long elapsedMicros() {
-        return curTimeMicros64() - startTime();
+        ensureStarted();
+        return _ticksToMicros(_tickSource->getTicks() - _start);
     }
     int elapsedMillis() {
         return (int)(elapsedMicros() / 1000);
@@ -375,6 +383,17 @@ public:
         _expectedLatencyMs = latency;
     }
 
+    /**
+     * The PlanCacheKey of the query run by the operation, if any, by which its latency is recorded
+     * in Top. Like _expectedLatencyMs, it is only accessed by the thread running the operation.
+     */
+    StringData getQueryShape() const {
+        return _queryShape;
+    }
+    void setQueryShape(std::string queryShape) {
+        _queryShape = std::move(queryShape);
+    }
+
     /**
      * this should be used very sparingly
      * generally the Context should set this up
@@ -401,11 +420,19 @@ private:
 
     CurOp(OperationContext*, CurOpStack*);
 
+    long long _ticksToMicros(TickSource::Tick ticks) const {
+        return static_cast<long long>(ticks * 1000000.0 / _tickSource->getTicksPerSecond());
+    }
+
     CurOpStack* _stack;
     CurOp* _parent{nullptr};
     Command* _command{nullptr};
-    long long _start{0};
-    long long _end{0};
+
+    TickSource* const _tickSource;
+
+    // Ticks of '_tickSource' when the operation started and finished
+    TickSource::Tick _start{0};
+    TickSource::Tick _end{0};
 
     // _networkOp represents the network-level op code: OP_QUERY, OP_GET_MORE, OP_COMMAND, etc.
     NetworkOp _networkOp{opInvalid};  // only set this through setNetworkOp_inlock() to keep synced
@@ -429,6 +456,8 @@ private:
     // so this should be 30000 in that case
     long long _expectedLatencyMs{0};
 
+    std::string _queryShape;
+
     std::string _planSummary;
 };
 }  // namespace mongo
@@ -567,6 +567,7 @@ static void _initAndListen(int listenPort) {
 #endif
 
     logProcessDetails();
+    logGlobalInitializerTimes();
 
     checked_cast<ServiceContextMongoD*>(getGlobalServiceContext())->createLockFile();
 
@@ -763,6 +764,7 @@ static void _initAndListen(int listenPort) {
     }
 
     startClientCursorMonitor();
+    startSampledProfileWriter();
 
     PeriodicTask::startRunningPeriodicTasks();
 
@@ -37,10 +37,13 @@
 #include "mongo/db/curop.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/top.h"
 
 namespace mongo {
 
+MONGO_EXPORT_SERVER_PARAMETER(readFromLastAppliedSnapshotOnSecondaries, bool, false);
+
 AutoGetDb::AutoGetDb(OperationContext* txn, StringData ns, LockMode mode)
     : _dbLock(txn->lockState(), ns, mode), _db(dbHolder().get(txn, ns)) {}
 
@@ -79,6 +82,7 @@ AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* txn, const
 AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* txn,
                                                    const NamespaceString& nss)
     : _txn(txn), _transaction(txn, MODE_IS) {
+    _readingFromLastAppliedSnapshot = _startReadingFromLastAppliedSnapshot();
     {
         _autoColl.emplace(txn, nss, MODE_IS);
         auto curOp = CurOp::get(_txn);
@@ -96,7 +100,8 @@ AutoGetCollectionForRead::AutoGetCollectionForRead(OperationContext* txn,
         }
     }
 
-    // Note: this can yield.
+    // Note: these can yield.
+    _ensureLastAppliedSnapshotIsValid(nss);
     _ensureMajorityCommittedSnapshotIsValid(nss);
 
     // We have both the DB and collection locked, which is the prerequisite to do a stable shard
@@ -116,6 +121,78 @@ AutoGetCollectionForRead::~AutoGetCollectionForRead() {
                 _timer.micros(),
                 currentOp->isCommand(),
                 currentOp->getReadWriteType());
+
+    // Later operations on '_txn', such as writing to the profiler, must not use the snapshot.
+    if (_readingFromLastAppliedSnapshot) {
+        _autoColl = boost::none;
+        if (!_txn->lockState()->isLocked()) {
+            _stopReadingFromLastAppliedSnapshot();
+        }
+    }
+}
+
+bool AutoGetCollectionForRead::_startReadingFromLastAppliedSnapshot() {
+    if (!readFromLastAppliedSnapshotOnSecondaries.load()) {
+        return false;
+    }
+
+    // A read which already holds locks may have passed the ParallelBatchWriterMode lock, and
+    // replication's own reads must see the batch being applied.
+    if (_txn->lockState()->isLocked() || !_txn->getClient()->isFromUserConnection() ||
+        _txn->recoveryUnit()->isReadingFromMajorityCommittedSnapshot()) {
+        return false;
+    }
+
+    auto replCoord = repl::ReplicationCoordinator::get(_txn);
+    if (replCoord->getReplicationMode() != repl::ReplicationCoordinator::modeReplSet ||
+        !replCoord->getMemberState().secondary()) {
+        return false;
+    }
+
+    if (!_txn->recoveryUnit()->setReadFromLastAppliedSnapshot().isOK()) {
+        return false;
+    }
+
+    _txn->lockState()->setShouldConflictWithSecondaryBatchApplication(false);
+    return true;
+}
+
+void AutoGetCollectionForRead::_stopReadingFromLastAppliedSnapshot() {
+    _txn->recoveryUnit()->abandonSnapshot();
+    _txn->recoveryUnit()->clearReadFromLastAppliedSnapshot();
+    _txn->lockState()->setShouldConflictWithSecondaryBatchApplication(true);
+    _readingFromLastAppliedSnapshot = false;
+}
+
+void AutoGetCollectionForRead::_ensureLastAppliedSnapshotIsValid(const NamespaceString& nss) {
+    if (!_readingFromLastAppliedSnapshot) {
+        return;
+    }
+
+    auto coll = _autoColl->getCollection();
+    if (!coll) {
+        return;
+    }
+    auto minSnapshot = coll->getMinimumVisibleSnapshot();
+    if (!minSnapshot) {
+        return;
+    }
+    auto mySnapshot = _txn->recoveryUnit()->getLastAppliedSnapshot();
+    if (mySnapshot && *mySnapshot >= *minSnapshot) {
+        return;
+    }
+
+    // The collection or one of its indexes was created after the snapshot, so read the latest
+    // data instead, waiting for the batch being applied.
+    _autoColl = boost::none;
+    _stopReadingFromLastAppliedSnapshot();
+
+    {
+        stdx::lock_guard<Client> lk(*_txn->getClient());
+        CurOp::get(_txn)->yielded();
+    }
+
+    _autoColl.emplace(_txn, nss, MODE_IS);
 }
 
 void AutoGetCollectionForRead::_ensureMajorityCommittedSnapshotIsValid(const NamespaceString& nss) {
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <string>
 
 #include "mongo/base/string_data.h"
@@ -41,6 +42,12 @@ namespace mongo {
 
 class Collection;
 
+// If true, reads by clients of a secondary are served from the snapshot taken at the end of the
+// last applied oplog batch, without waiting for the batch being applied. This requires a storage
+// engine with named snapshots, which replication only creates when majority read concern or the
+// snapshot thread is enabled.
+extern std::atomic<bool> readFromLastAppliedSnapshotOnSecondaries;  // NOLINT
+
 /**
  * RAII-style class, which acquires a lock on the specified database in the requested mode and
  * obtains a reference to the database. Used as a shortcut for calls to dbHolder().get().
@@ -159,9 +166,24 @@ private:
     void _init(const std::string& ns, StringData coll);
     void _ensureMajorityCommittedSnapshotIsValid(const NamespaceString& nss);
 
+    /**
+     * Switches '_txn' to reading from the last applied snapshot without the
+     * ParallelBatchWriterMode lock, if this is a client's read on a secondary which holds no
+     * locks yet. Returns whether it did.
+     */
+    bool _startReadingFromLastAppliedSnapshot();
+    void _stopReadingFromLastAppliedSnapshot();
+
+    /**
+     * Falls back to reading the latest data if the collection changed after the last applied
+     * snapshot was taken.
+     */
+    void _ensureLastAppliedSnapshotIsValid(const NamespaceString& nss);
+
     const Timer _timer;
     OperationContext* const _txn;
     const ScopedTransaction _transaction;
+    bool _readingFromLastAppliedSnapshot = false;
     boost::optional<AutoGetCollection> _autoColl;
 };
 
@@ -78,6 +78,7 @@
 #include "mongo/db/ops/insert.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/repair_database.h"
 #include "mongo/db/repl/optime.h"
@@ -106,6 +107,7 @@
 #include "mongo/util/log.h"
 #include "mongo/util/md5.hpp"
 #include "mongo/util/print.h"
+#include "mongo/util/sampling_profiler.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -998,6 +1000,10 @@ public:
         result.appendNumber("totalIndexSize", indexSize / scale);
         result.append("indexSizes", indexSizes.obj());
 
+        BSONObjBuilder planCacheStats(result.subobjStart("planCache"));
+        collection->infoCache()->getPlanCache()->getStats().appendTo(&planCacheStats);
+        planCacheStats.doneFast();
+
         return true;
     }
 
@@ -1268,6 +1274,7 @@ void Command::execCommand(OperationContext* txn,
                           Command* command,
                           const rpc::RequestInterface& request,
                           rpc::ReplyBuilderInterface* replyBuilder) {
+    SamplingProfiler::ScopedTag profilerTag(command->getName().c_str());
     try {
         {
             stdx::lock_guard<Client> lk(*txn->getClient());
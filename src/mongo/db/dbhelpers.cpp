@@ -32,6 +32,7 @@
 
 #include "mongo/db/dbhelpers.h"
 
+#include <algorithm>
 #include <boost/filesystem/operations.hpp>
 #include <fstream>
 
@@ -59,6 +60,7 @@
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/data_protector.h"
 #include "mongo/db/storage/storage_options.h"
@@ -69,6 +71,7 @@
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -82,6 +85,17 @@ using std::stringstream;
 
 using logger::LogComponent;
 
+namespace {
+
+// The number of documents removeRange() deletes under one lock acquisition, and between waits
+// for replication.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterBatchSize, int, 128);
+
+// How long removeRange() sleeps between batches, to leave I/O for other operations.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterBatchDelayMS, int, 0);
+
+}  // namespace
+
 void Helpers::ensureIndex(OperationContext* txn,
                           Collection* collection,
                           BSONObj keyPattern,
@@ -321,7 +335,8 @@ long long Helpers::removeRange(OperationContext* txn,
                                const WriteConcernOptions& writeConcern,
                                RemoveSaver* callback,
                                bool fromMigrate,
-                               bool onlyRemoveOrphanedDocs) {
+                               bool onlyRemoveOrphanedDocs,
+                               long long* bytesDeleted) {
     Timer rangeRemoveTimer;
     const string& ns = range.ns;
 
@@ -351,10 +366,17 @@ long long Helpers::removeRange(OperationContext* txn,
         << " with write concern: " << writeConcern.toBSON() << endl;
 
     long long numDeleted = 0;
+    long long numBytesDeleted = 0;
 
     Milliseconds millisWaitingForReplication{0};
 
-    while (1) {
+    bool done = false;
+    while (!done) {
+        txn->checkForInterrupt();
+
+        const size_t batchSize = std::max(1, rangeDeleterBatchSize.load());
+        long long batchDeleted = 0;
+
         // Scoping for write lock.
         {
             OldClientWriteContext ctx(txn, ns);
@@ -365,92 +387,124 @@ long long Helpers::removeRange(OperationContext* txn,
             IndexDescriptor* desc =
                 collection->getIndexCatalog()->findIndexByKeyPattern(txn, indexKeyPattern.toBSON());
 
-            unique_ptr<PlanExecutor> exec(
-                InternalPlanner::indexScan(txn,
-                                           collection,
-                                           desc,
-                                           min,
-                                           max,
-                                           maxInclusive,
-                                           PlanExecutor::YIELD_MANUAL,
-                                           InternalPlanner::FORWARD,
-                                           InternalPlanner::IXSCAN_FETCH));
-            exec->setYieldPolicy(PlanExecutor::YIELD_AUTO, collection);
-
-            RecordId rloc;
-            BSONObj obj;
-            PlanExecutor::ExecState state;
-            // This may yield so we cannot touch nsd after this.
-            state = exec->getNext(&obj, &rloc);
-            if (PlanExecutor::IS_EOF == state) {
-                break;
-            }
+            // Collect the next batch from the index without fetching. The scan doesn't yield, so
+            // that the lock held while collecting the batch is also held while deleting it.
+            std::vector<RecordId> batch;
+            {
+                unique_ptr<PlanExecutor> exec(
+                    InternalPlanner::indexScan(txn,
+                                               collection,
+                                               desc,
+                                               min,
+                                               max,
+                                               maxInclusive,
+                                               PlanExecutor::YIELD_MANUAL,
+                                               InternalPlanner::FORWARD));
+
+                RecordId rloc;
+                BSONObj obj;
+                PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
+                while (batch.size() < batchSize &&
+                       PlanExecutor::ADVANCED == (state = exec->getNext(&obj, &rloc))) {
+                    batch.push_back(rloc);
+                }
 
-            if (PlanExecutor::FAILURE == state || PlanExecutor::DEAD == state) {
-                warning(LogComponent::kSharding)
-                    << PlanExecutor::statestr(state) << " - cursor error while trying to delete "
-                    << min << " to " << max << " in " << ns << ": "
-                    << WorkingSetCommon::toStatusString(obj)
-                    << ", stats: " << Explain::getWinningPlanStats(exec.get()) << endl;
-                break;
+                if (PlanExecutor::FAILURE == state || PlanExecutor::DEAD == state) {
+                    warning(LogComponent::kSharding)
+                        << PlanExecutor::statestr(state)
+                        << " - cursor error while trying to delete " << min << " to " << max
+                        << " in " << ns << ": " << WorkingSetCommon::toStatusString(obj)
+                        << ", stats: " << Explain::getWinningPlanStats(exec.get()) << endl;
+                    break;
+                }
+
+                done = batch.size() < batchSize;
             }
 
-            verify(PlanExecutor::ADVANCED == state);
+            // Deleting in RecordId order visits the documents in their storage order, rather
+            // than in the order of the shard key.
+            std::sort(batch.begin(), batch.end());
 
-            WriteUnitOfWork wuow(txn);
+            for (const RecordId& rloc : batch) {
+                WriteUnitOfWork wuow(txn);
 
-            if (onlyRemoveOrphanedDocs) {
-                // Do a final check in the write lock to make absolutely sure that our
-                // collection hasn't been modified in a way that invalidates our migration
-                // cleanup.
+                Snapshotted<BSONObj> snapshotted;
+                if (!collection->findDoc(txn, rloc, &snapshotted)) {
+                    // Deleted by another operation since the scan.
+                    continue;
+                }
+                const BSONObj& obj = snapshotted.value();
+
+                if (onlyRemoveOrphanedDocs) {
+                    // Do a final check in the write lock to make absolutely sure that our
+                    // collection hasn't been modified in a way that invalidates our migration
+                    // cleanup.
+
+                    // We should never be able to turn off the sharding state once enabled, but
+                    // in the future we might want to.
+                    verify(ShardingState::get(txn)->enabled());
+
+                    bool docIsOrphan;
+
+                    // In write lock, so will be the most up-to-date version
+                    auto metadataNow = CollectionShardingState::get(txn, ns)->getMetadata();
+                    if (metadataNow) {
+                        ShardKeyPattern kp(metadataNow->getKeyPattern());
+                        BSONObj key = kp.extractShardKeyFromDoc(obj);
+                        docIsOrphan =
+                            !metadataNow->keyBelongsToMe(key) && !metadataNow->keyIsPending(key);
+                    } else {
+                        docIsOrphan = false;
+                    }
+
+                    if (!docIsOrphan) {
+                        warning(LogComponent::kSharding)
+                            << "aborting migration cleanup for chunk " << min << " to " << max
+                            << (metadataNow ? (string) " at document " + obj.toString() : "")
+                            << ", collection " << ns << " has changed " << endl;
+                        done = true;
+                        break;
+                    }
+                }
 
-                // We should never be able to turn off the sharding state once enabled, but
-                // in the future we might want to.
-                verify(ShardingState::get(txn)->enabled());
+                NamespaceString nss(ns);
+                if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(nss)) {
+                    warning() << "stepped down from primary while deleting chunk; "
+                              << "orphaning data in " << ns << " in range [" << min << ", " << max
+                              << ")";
+                    if (bytesDeleted)
+                        *bytesDeleted = numBytesDeleted;
+                    return numDeleted;
+                }
 
-                bool docIsOrphan;
+                if (callback)
+                    callback->goingToDelete(obj);
 
-                // In write lock, so will be the most up-to-date version
-                auto metadataNow = CollectionShardingState::get(txn, ns)->getMetadata();
-                if (metadataNow) {
-                    ShardKeyPattern kp(metadataNow->getKeyPattern());
-                    BSONObj key = kp.extractShardKeyFromDoc(obj);
-                    docIsOrphan =
-                        !metadataNow->keyBelongsToMe(key) && !metadataNow->keyIsPending(key);
-                } else {
-                    docIsOrphan = false;
-                }
+                numBytesDeleted += obj.objsize();
 
-                if (!docIsOrphan) {
-                    warning(LogComponent::kSharding)
-                        << "aborting migration cleanup for chunk " << min << " to " << max
-                        << (metadataNow ? (string) " at document " + obj.toString() : "")
-                        << ", collection " << ns << " has changed " << endl;
-                    break;
-                }
+                OpDebug* const nullOpDebug = nullptr;
+                collection->deleteDocument(txn, rloc, nullOpDebug, fromMigrate);
+                wuow.commit();
+                batchDeleted++;
             }
 
-            NamespaceString nss(ns);
-            if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(nss)) {
-                warning() << "stepped down from primary while deleting chunk; "
-                          << "orphaning data in " << ns << " in range [" << min << ", " << max
-                          << ")";
-                return numDeleted;
+            if (!batch.empty() && batchDeleted == 0 && !done) {
+                // Every document of the batch was deleted by other operations. Scanning again
+                // from the start of the range should not find them, unless the index is
+                // inconsistent with the collection.
+                warning(LogComponent::kSharding)
+                    << "found no documents to delete for the index keys in " << min << " to "
+                    << max << " in " << ns << ", aborting removal";
+                done = true;
             }
-
-            if (callback)
-                callback->goingToDelete(obj);
-
-            OpDebug* const nullOpDebug = nullptr;
-            collection->deleteDocument(txn, rloc, nullOpDebug, fromMigrate);
-            wuow.commit();
-            numDeleted++;
         }
 
+        numDeleted += batchDeleted;
+
         // TODO remove once the yielding below that references this timer has been removed
         Timer secondaryThrottleTime;
 
-        if (writeConcern.shouldWaitForOtherNodes() && numDeleted > 0) {
+        if (writeConcern.shouldWaitForOtherNodes() && batchDeleted > 0) {
             repl::ReplicationCoordinator::StatusAndDuration replStatus =
                 repl::getGlobalReplicationCoordinator()->awaitReplication(
                     txn,
@@ -464,6 +518,11 @@ long long Helpers::removeRange(OperationContext* txn,
             }
             millisWaitingForReplication += replStatus.duration;
         }
+
+        const int batchDelayMillis = rangeDeleterBatchDelayMS.load();
+        if (!done && batchDelayMillis > 0) {
+            sleepmillis(batchDelayMillis);
+        }
     }
 
     if (writeConcern.shouldWaitForOtherNodes())
@@ -475,6 +534,8 @@ long long Helpers::removeRange(OperationContext* txn,
                                                     << " in " << ns << " (took "
                                                     << rangeRemoveTimer.millis() << "ms)" << endl;
 
+    if (bytesDeleted)
+        *bytesDeleted = numBytesDeleted;
     return numDeleted;
 }
 
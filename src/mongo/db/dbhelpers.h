@@ -166,6 +166,10 @@ struct Helpers {
      *
      * Returns -1 when no usable index exists
      *
+     * Deletes the documents in batches of rangeDeleterBatchSize, in RecordId order within each
+     * batch, and waits for 'secondaryThrottle' after each batch. If 'bytesDeleted' is not NULL,
+     * it is set to the total size of the deleted documents.
+     *
      * Does oplog the individual document deletions.
      * // TODO: Refactor this mechanism, it is growing too large
      */
@@ -175,7 +179,8 @@ struct Helpers {
                                  const WriteConcernOptions& secondaryThrottle,
                                  RemoveSaver* callback = NULL,
                                  bool fromMigrate = false,
-                                 bool onlyRemoveOrphanedDocs = false);
+                                 bool onlyRemoveOrphanedDocs = false,
+                                 long long* bytesDeleted = NULL);
 
     /**
      * Remove all documents from a collection.
@@ -41,6 +41,21 @@ namespace {
 // Stage execution will fail once size of all buffered data exceeds this threshold.
 const size_t kDefaultMaxMemUsageBytes = 32 * 1024 * 1024;
 
+// With two hash functions this gives a false positive rate of about 5%.
+const size_t kBloomFilterBitsPerRecordId = 8;
+
+// The finalizer of MurmurHash3, so that both halves of the hash are well distributed even when
+// the RecordIds are dense and sequential.
+uint64_t hashForBloomFilter(const mongo::RecordId& recordId) {
+    uint64_t hash = static_cast<uint64_t>(recordId.repr());
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
 }  // namespace
 
 namespace mongo {
@@ -224,6 +239,12 @@ PlanStage::StageState AndHashStage::doWork(WorkingSetID* out) {
         return PlanStage::NEED_TIME;
     }
 
+    if (!mayBeInDataMap(member->recordId)) {
+        ++_specificStats.bloomFilterRejects;
+        _ws->free(*out);
+        return PlanStage::NEED_TIME;
+    }
+
     DataMap::iterator it = _dataMap.find(member->recordId);
     if (_dataMap.end() == it) {
         // Child's output wasn't in every previous child.  Throw it out.
@@ -295,6 +316,7 @@ PlanStage::StageState AndHashStage::readFirstChild(WorkingSetID* out) {
         }
 
         _specificStats.mapAfterChild.push_back(_dataMap.size());
+        rebuildBloomFilter();
 
         return PlanStage::NEED_TIME;
     } else if (PlanStage::FAILURE == childStatus || PlanStage::DEAD == childStatus) {
@@ -335,12 +357,19 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
         }
 
         verify(member->hasRecordId());
-        if (_dataMap.end() == _dataMap.find(member->recordId)) {
+        DataMap::const_iterator it = _dataMap.end();
+        if (mayBeInDataMap(member->recordId)) {
+            it = _dataMap.find(member->recordId);
+        } else {
+            ++_specificStats.bloomFilterRejects;
+        }
+
+        if (_dataMap.end() == it) {
             // Ignore.  It's not in any previous child.
         } else {
             // We have a hit.  Copy data into the WSM we already have.
             _seenMap.insert(member->recordId);
-            WorkingSetID olderMemberID = _dataMap[member->recordId];
+            WorkingSetID olderMemberID = it->second;
             WorkingSetMember* olderMember = _ws->get(olderMemberID);
             size_t memUsageBefore = olderMember->getMemUsage();
 
@@ -385,6 +414,8 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
             return PlanStage::IS_EOF;
         }
 
+        rebuildBloomFilter();
+
         // We've finished scanning all children.  Return results with the next call to work().
         if (_currentChild == _children.size()) {
             _hashingChildren = false;
@@ -412,6 +443,38 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
     }
 }
 
+void AndHashStage::rebuildBloomFilter() {
+    // A power of two number of bits, so that a hash maps to a bit with a mask.
+    size_t numBits = 64;
+    while (numBits < kBloomFilterBitsPerRecordId * _dataMap.size()) {
+        numBits *= 2;
+    }
+    _bloomFilter.assign(numBits / 64, 0);
+
+    for (const auto& entry : _dataMap) {
+        const uint64_t hash = hashForBloomFilter(entry.first);
+        const uint64_t firstBit = hash & (numBits - 1);
+        const uint64_t secondBit = (hash >> 32) & (numBits - 1);
+        _bloomFilter[firstBit / 64] |= 1ULL << (firstBit % 64);
+        _bloomFilter[secondBit / 64] |= 1ULL << (secondBit % 64);
+    }
+}
+
+bool AndHashStage::mayBeInDataMap(const RecordId& recordId) const {
+    if (_bloomFilter.empty()) {
+        return true;
+    }
+
+    // RecordIds removed from _dataMap by invalidations stay in the filter, which only makes it
+    // return true more often than needed.
+    const size_t numBits = _bloomFilter.size() * 64;
+    const uint64_t hash = hashForBloomFilter(recordId);
+    const uint64_t firstBit = hash & (numBits - 1);
+    const uint64_t secondBit = (hash >> 32) & (numBits - 1);
+    return (_bloomFilter[firstBit / 64] & (1ULL << (firstBit % 64))) &&
+        (_bloomFilter[secondBit / 64] & (1ULL << (secondBit % 64)));
+}
+
 void AndHashStage::doInvalidate(OperationContext* txn, const RecordId& dl, InvalidationType type) {
     // TODO remove this since calling isEOF is illegal inside of doInvalidate().
     if (isEOF()) {
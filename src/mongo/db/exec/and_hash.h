@@ -92,6 +92,17 @@ private:
     StageState hashOtherChildren(WorkingSetID* out);
     StageState workChild(size_t childNo, WorkingSetID* out);
 
+    /**
+     * Rebuilds _bloomFilter from the RecordIds in _dataMap. Called each time a child other than
+     * the last has been intersected into _dataMap.
+     */
+    void rebuildBloomFilter();
+
+    /**
+     * Returns false if 'recordId' is definitely not in _dataMap, and true if it may be.
+     */
+    bool mayBeInDataMap(const RecordId& recordId) const;
+
     // Not owned by us.
     const Collection* _collection;
 
@@ -108,6 +119,12 @@ private:
     typedef unordered_map<RecordId, WorkingSetID, RecordId::Hasher> DataMap;
     DataMap _dataMap;
 
+    // A Bloom filter over the keys of _dataMap once the first child has been read. Most of what
+    // the later children return is usually not in _dataMap, and probing this compact bitmap
+    // first spares those RecordIds a lookup among _dataMap's nodes, which are scattered over
+    // memory.
+    std::vector<uint64_t> _bloomFilter;
+
     // Keeps track of what elements from _dataMap subsequent children have seen.
     // Only used while _hashingChildren.
     typedef unordered_set<RecordId, RecordId::Hasher> SeenMap;
@@ -34,11 +34,13 @@
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/detailed_stage_timer.h"
 #include "mongo/db/exec/multi_plan.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_cache_replanner.h"
 #include "mongo/db/query/plan_ranker.h"
 #include "mongo/db/query/plan_yield_policy.h"
 #include "mongo/db/query/query_knobs.h"
@@ -75,6 +77,7 @@ Status CachedPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     // execution work that happens here, so this is needed for the time accounting to
     // make sense.
     ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    ScopedDetailedStageTimer detailedTimer(getOpCtx(), &_commonStats);
 
     // If we work this many times during the trial period, then we will replan the
     // query from scratch.
@@ -161,7 +164,19 @@ Status CachedPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     }
 
     // If we're here, the trial period took more than 'maxWorksBeforeReplan' work cycles. This
-    // plan is taking too long, so we replan from scratch.
+    // plan is taking too long, so we replan from scratch. When replanning in the background, this
+    // query carries on with the cached plan instead.
+    if (internalQueryCacheBackgroundReplan.load()) {
+        LOG(1) << "Execution of cached plan required " << maxWorksBeforeReplan
+               << " works, but was originally cached with only " << _decisionWorks
+               << " works. Scheduling background replan of query: "
+               << _canonicalQuery->toStringShort()
+               << " plan summary: " << Explain::getPlanSummary(child().get());
+
+        scheduleBackgroundReplan();
+        return Status::OK();
+    }
+
     LOG(1) << "Execution of cached plan required " << maxWorksBeforeReplan
            << " works, but was originally cached with only " << _decisionWorks
            << " works. Evicting cache entry and replanning query: "
@@ -202,6 +217,7 @@ Status CachedPlanStage::replan(PlanYieldPolicy* yieldPolicy, bool shouldCache) {
     _children.clear();
 
     _specificStats.replanned = true;
+    _collection->infoCache()->getPlanCache()->noteReplan();
 
     // Use the query planning module to plan the whole query.
     std::vector<QuerySolution*> rawSolutions;
@@ -330,8 +346,12 @@ void CachedPlanStage::updatePlanCache() {
     feedback->stats = getStats();
     feedback->score = PlanRanker::scoreTree(feedback->stats->children[0].get());
 
+    const bool backgroundReplan = internalQueryCacheBackgroundReplan.load();
+    bool drifted = false;
+
     PlanCache* cache = _collection->infoCache()->getPlanCache();
-    Status fbs = cache->feedback(*_canonicalQuery, feedback.release());
+    Status fbs = cache->feedback(
+        *_canonicalQuery, feedback.release(), backgroundReplan ? &drifted : nullptr);
     if (!fbs.isOK()) {
         LOG(5) << _canonicalQuery->ns()
                << ": Failed to update cache with feedback: " << fbs.toString() << " - "
@@ -339,7 +359,19 @@ void CachedPlanStage::updatePlanCache() {
                << "; sort: " << _canonicalQuery->getQueryRequest().getSort()
                << "; projection: " << _canonicalQuery->getQueryRequest().getProj()
                << ") is no longer in plan cache.";
+    } else if (drifted) {
+        LOG(1) << "Execution of cached plan needed considerably more works per result than when "
+               << "it was cached. Scheduling background replan of query: "
+               << _canonicalQuery->toStringShort()
+               << " plan summary: " << Explain::getPlanSummary(child().get());
+
+        scheduleBackgroundReplan();
     }
 }
 
+void CachedPlanStage::scheduleBackgroundReplan() {
+    PlanCacheReplanner* replanner = PlanCacheReplanner::get(getOpCtx()->getServiceContext());
+    _specificStats.backgroundReplanScheduled = replanner->schedule(_collection, *_canonicalQuery);
+}
+
 }  // namespace mongo
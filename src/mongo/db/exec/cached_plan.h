@@ -107,6 +107,12 @@ private:
      */
     Status replan(PlanYieldPolicy* yieldPolicy, bool shouldCache);
 
+    /**
+     * Asks the PlanCacheReplanner to replan this query's shape on its own thread, so that this
+     * query can carry on with the cached plan.
+     */
+    void scheduleBackgroundReplan();
+
     /**
      * May yield during the cached plan stage's trial period or replanning phases.
      *
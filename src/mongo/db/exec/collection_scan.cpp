@@ -30,6 +30,8 @@
 
 #include "mongo/db/exec/collection_scan.h"
 
+#include <map>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -38,8 +40,12 @@
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/storage/record_fetcher.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 
@@ -51,6 +57,59 @@ using std::unique_ptr;
 using std::vector;
 using stdx::make_unique;
 
+namespace {
+
+// A shared scan reports its position after reading this many records.
+const size_t kSharedScanReportInterval = 128;
+
+/**
+ * Tracks, for each collection, how many shared scans are running and the last position one of
+ * them reported.
+ */
+class SharedScanPositions {
+public:
+    /**
+     * Registers a scan of 'ns'. Returns where the running scans of 'ns' last were, or a null
+     * RecordId if there are none.
+     */
+    RecordId join(const std::string& ns) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        Entry& entry = _entries[ns];
+        ++entry.activeScans;
+        return entry.position;
+    }
+
+    void report(const std::string& ns, const RecordId& position) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _entries.find(ns);
+        if (it != _entries.end()) {
+            it->second.position = position;
+        }
+    }
+
+    void leave(const std::string& ns) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _entries.find(ns);
+        invariant(it != _entries.end());
+        if (--it->second.activeScans == 0) {
+            _entries.erase(it);
+        }
+    }
+
+private:
+    struct Entry {
+        size_t activeScans = 0;
+        RecordId position;
+    };
+
+    stdx::mutex _mutex;
+    std::map<std::string, Entry> _entries;
+};
+
+SharedScanPositions sharedScanPositions;
+
+}  // namespace
+
 // static
 const char* CollectionScan::kStageType = "COLLSCAN";
 
@@ -63,11 +122,64 @@ CollectionScan::CollectionScan(OperationContext* txn,
       _filter(filter),
       _params(params),
       _isDead(false),
-      _wsidForFetch(_workingSet->allocate()) {
+      _wsidForFetch(_workingSet->allocate()),
+      _sharedScan(canShareScan(params)) {
     // Explain reports the direction of the collection scan.
     _specificStats.direction = params.direction;
 }
 
+CollectionScan::~CollectionScan() {
+    leaveSharedScan();
+}
+
+// static
+bool CollectionScan::canShareScan(const CollectionScanParams& params) {
+    if (!internalQueryExecSharedCollectionScans.load()) {
+        return false;
+    }
+
+    // Only a scan which would read the whole collection once, in no particular order, may start
+    // in the middle. The RecordIds of storage engines without document-level locking do not
+    // follow insertion order, so a position reported by one scan means nothing to another.
+    return params.collection && !params.collection->isCapped() &&
+        params.direction == CollectionScanParams::FORWARD && params.start.isNull() &&
+        !params.tailable && !params.stopApplyingFilterAfterFirstMatch && params.maxScan == 0 &&
+        supportsDocLocking();
+}
+
+void CollectionScan::makeSharedScanCursor() {
+    _seekableCursor = nullptr;
+    if (_sharedScanNs.empty()) {
+        _joinedSharedScan = true;
+        _sharedScanNs = _params.collection->ns().ns();
+        _wrapId = sharedScanPositions.join(_sharedScanNs);
+    }
+
+    if (!_wrapId.isNull()) {
+        const RecordStore* rs = _params.collection->getRecordStore();
+        _cursor = _wrapped ? rs->getCursorForRange(getOpCtx(), RecordId(), _wrapId)
+                           : rs->getCursorForRange(getOpCtx(), _wrapId, RecordId::max());
+        if (_cursor) {
+            return;
+        }
+
+        // The record store can't start a cursor in the middle, so read it from the beginning.
+        invariant(!_wrapped);
+        _wrapId = RecordId();
+    }
+
+    auto cursor = _params.collection->getCursor(getOpCtx(), true);
+    _seekableCursor = cursor.get();
+    _cursor = std::move(cursor);
+}
+
+void CollectionScan::leaveSharedScan() {
+    if (_joinedSharedScan) {
+        _joinedSharedScan = false;
+        sharedScanPositions.leave(_sharedScanNs);
+    }
+}
+
 PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
     if (_isDead) {
         Status status(
@@ -88,14 +200,27 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    // The cursor may be about to move, so the document we returned last can't stay borrowed.
+    WorkingSetCommon::ownObjIfStillInUse(_workingSet, &_borrowedId);
+
     boost::optional<Record> record;
     const bool needToMakeCursor = !_cursor;
     try {
         if (needToMakeCursor) {
-            const bool forward = _params.direction == CollectionScanParams::FORWARD;
-            _cursor = _params.collection->getCursor(getOpCtx(), forward);
+            if (_sharedScan) {
+                makeSharedScanCursor();
+            } else {
+                const bool forward = _params.direction == CollectionScanParams::FORWARD;
+                auto cursor = _params.collection->getCursor(getOpCtx(), forward);
+                _seekableCursor = cursor.get();
+                _cursor = std::move(cursor);
+            }
 
-            if (!_lastSeenId.isNull()) {
+            if (!_params.fieldSubset.empty()) {
+                _cursor->restrictToFields(_params.fieldSubset);
+            }
+
+            if (!_lastSeenId.isNull() && !_sharedScan) {
                 invariant(_params.tailable);
                 // Seek to where we were last time. If it no longer exists, mark us as dead
                 // since we want to signal an error rather than silently dropping data from the
@@ -103,7 +228,7 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
                 // we want to return the record *after* this one since we have already returned
                 // this one. This is only possible in the tailing case because that is the only
                 // time we'd need to create a cursor after already getting a record out of it.
-                if (!_cursor->seekExact(_lastSeenId)) {
+                if (!_seekableCursor->seekExact(_lastSeenId)) {
                     _isDead = true;
                     Status status(ErrorCodes::CappedPositionLost,
                                   str::stream() << "CollectionScan died due to failure to restore "
@@ -119,7 +244,7 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         }
 
         if (_lastSeenId.isNull() && !_params.start.isNull()) {
-            record = _cursor->seekExact(_params.start);
+            record = _seekableCursor->seekExact(_params.start);
         } else {
             // See if the record we're about to access is in memory. If not, pass a fetch
             // request up.
@@ -135,20 +260,32 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
         }
     } catch (const WriteConflictException& wce) {
         // Leave us in a state to try again next time.
-        if (needToMakeCursor)
+        if (needToMakeCursor) {
             _cursor.reset();
+            _seekableCursor = nullptr;
+        }
         *out = WorkingSet::INVALID_ID;
         return PlanStage::NEED_YIELD;
     }
 
     if (!record) {
+        if (!_wrapId.isNull() && !_wrapped) {
+            // This shared scan started in the middle of the collection. Carry on from the
+            // beginning up to where it started.
+            _wrapped = true;
+            _cursor.reset();
+            return PlanStage::NEED_TIME;
+        }
+
         // We just hit EOF. If we are tailable and have already returned data, leave us in a
         // state to pick up where we left off on the next call to work(). Otherwise EOF is
         // permanent.
         if (_params.tailable && !_lastSeenId.isNull()) {
             _cursor.reset();
+            _seekableCursor = nullptr;
         } else {
             _commonStats.isEOF = true;
+            leaveSharedScan();
         }
 
         return PlanStage::IS_EOF;
@@ -156,6 +293,11 @@ PlanStage::StageState CollectionScan::doWork(WorkingSetID* out) {
 
     _lastSeenId = record->id;
 
+    if (_joinedSharedScan && ++_recordsSinceReport >= kSharedScanReportInterval) {
+        _recordsSinceReport = 0;
+        sharedScanPositions.report(_sharedScanNs, record->id);
+    }
+
     WorkingSetID id = _workingSet->allocate();
     WorkingSetMember* member = _workingSet->get(id);
     member->recordId = record->id;
@@ -174,6 +316,7 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
         if (_params.stopApplyingFilterAfterFirstMatch) {
             _filter = nullptr;
         }
+        _borrowedId = memberID;
         *out = memberID;
         return PlanStage::ADVANCED;
     } else {
@@ -182,6 +325,12 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
     }
 }
 
+PlanStage::StageState CollectionScan::doWorkBatch(size_t maxWorks,
+                                                  std::vector<WorkingSetID>* results,
+                                                  WorkingSetID* out) {
+    return doWorkBatchWith(this, maxWorks, results, out);
+}
+
 bool CollectionScan::isEOF() {
     return _commonStats.isEOF || _isDead;
 }
@@ -210,6 +359,7 @@ void CollectionScan::doInvalidate(OperationContext* txn,
 }
 
 void CollectionScan::doSaveState() {
+    WorkingSetCommon::ownObjIfStillInUse(_workingSet, &_borrowedId);
     if (_cursor) {
         _cursor->save();
     }
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <memory>
+#include <string>
 
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/plan_stage.h"
@@ -37,6 +38,7 @@
 
 namespace mongo {
 
+class RecordCursor;
 class SeekableRecordCursor;
 class WorkingSet;
 class OperationContext;
@@ -46,6 +48,10 @@ class OperationContext;
  * there are no more records in the collection.
  *
  * Preconditions: Valid RecordId.
+ *
+ * If internalQueryExecSharedCollectionScans is set, a full forward scan which starts while other
+ * such scans of the same collection are running begins at the position they last reported, reads
+ * to the end of the collection, and then reads from the beginning up to where it began.
  */
 class CollectionScan final : public PlanStage {
 public:
@@ -54,7 +60,12 @@ public:
                    WorkingSet* workingSet,
                    const MatchExpression* filter);
 
+    ~CollectionScan();
+
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxWorks,
+                           std::vector<WorkingSetID>* results,
+                           WorkingSetID* out) final;
     bool isEOF() final;
 
     void doInvalidate(OperationContext* txn, const RecordId& dl, InvalidationType type) final;
@@ -80,13 +91,34 @@ private:
      */
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
+    /**
+     * Returns true if a scan with 'params' may start in the middle of the collection to share
+     * its reads with concurrent scans.
+     */
+    static bool canShareScan(const CollectionScanParams& params);
+
+    /**
+     * Positions '_cursor' for a shared scan: from '_wrapId' to the end of the collection on the
+     * first pass, and from the beginning of the collection up to '_wrapId' after wrapping around.
+     * On the first call, also joins the other scans of the collection.
+     */
+    void makeSharedScanCursor();
+
+    /**
+     * Stops reporting this scan's position to the other scans of the collection.
+     */
+    void leaveSharedScan();
+
     // WorkingSet is not owned by us.
     WorkingSet* _workingSet;
 
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
-    std::unique_ptr<SeekableRecordCursor> _cursor;
+    std::unique_ptr<RecordCursor> _cursor;
+
+    // Points to '_cursor' if it was made by Collection::getCursor(), and is null otherwise.
+    SeekableRecordCursor* _seekableCursor = nullptr;
 
     CollectionScanParams _params;
 
@@ -94,11 +126,30 @@ private:
 
     RecordId _lastSeenId;  // Null if nothing has been returned from _cursor yet.
 
+    // The last member we returned, whose document may point into _cursor's buffer until the
+    // cursor moves.
+    WorkingSetID _borrowedId = WorkingSet::INVALID_ID;
+
     // We allocate a working set member with this id on construction of the stage. It gets used for
     // all fetch requests. This should only be used for passing up the Fetcher for a NEED_YIELD, and
     // should remain in the INVALID state.
     const WorkingSetID _wsidForFetch;
 
+    // Set if this scan may share its reads with other scans of the collection. See canShareScan().
+    const bool _sharedScan;
+
+    // Set while this scan is reporting its position under '_sharedScanNs'.
+    bool _joinedSharedScan = false;
+    std::string _sharedScanNs;
+
+    // The RecordId at which a shared scan started, and at which it stops once it has wrapped
+    // around the end of the collection. Null if the scan started at the beginning.
+    RecordId _wrapId;
+    bool _wrapped = false;
+
+    // The number of records read since this scan last reported its position.
+    size_t _recordsSinceReport = 0;
+
     // Stats
     CollectionScanStats _specificStats;
 };
@@ -28,6 +28,9 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "mongo/db/record_id.h"
 
 namespace mongo {
@@ -59,6 +62,10 @@ struct CollectionScanParams {
 
     // If non-zero, how many documents will we look at?
     size_t maxScan = 0;
+
+    // If non-empty, only these top-level fields of each document are needed by the rest of the
+    // plan. The record cursor is asked to return just these, though it may return more.
+    std::vector<std::string> fieldSubset;
 };
 
 }  // namespace mongo
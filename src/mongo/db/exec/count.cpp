@@ -30,6 +30,8 @@
 
 #include "mongo/db/exec/count.h"
 
+#include <algorithm>
+
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
@@ -116,38 +118,77 @@ PlanStage::StageState CountStage::doWork(WorkingSetID* out) {
     WorkingSetID id = WorkingSet::INVALID_ID;
     PlanStage::StageState state = child()->work(&id);
 
-    if (PlanStage::IS_EOF == state) {
+    if (PlanStage::ADVANCED == state) {
+        countResult(id);
+    }
+    return handleChildState(state, id, out);
+}
+
+PlanStage::StageState CountStage::doWorkBatch(size_t maxWorks,
+                                              std::vector<WorkingSetID>* results,
+                                              WorkingSetID* out) {
+    if (_params.useRecordStoreCount || isEOF()) {
+        return doWorkBatchWith(this, 1, results, out);
+    }
+
+    // Don't ask for results beyond the limit.
+    size_t childWorks = maxWorks;
+    if (_params.limit > 0) {
+        const long long wanted = _params.limit - _specificStats.nCounted + _leftToSkip;
+        childWorks = std::min(childWorks, static_cast<size_t>(wanted));
+    }
+
+    invariant(child());
+    std::vector<WorkingSetID> block;
+    WorkingSetID childId = WorkingSet::INVALID_ID;
+    PlanStage::StageState childState = child()->workBatch(childWorks, &block, &childId);
+    for (auto id : block) {
+        countResult(id);
+    }
+
+    *out = WorkingSet::INVALID_ID;
+    PlanStage::StageState state = handleChildState(childState, childId, out);
+    recordWork(state);
+    return state;
+}
+
+void CountStage::countResult(WorkingSetID id) {
+    // We got a result. If we're still skipping, then decrement the number left to skip.
+    // Otherwise increment the count until we hit the limit.
+    if (_leftToSkip > 0) {
+        _leftToSkip--;
+        _specificStats.nSkipped++;
+    } else {
+        _specificStats.nCounted++;
+    }
+
+    // Count doesn't need the actual results, so we just discard any valid working
+    // set members that got returned from the child.
+    if (WorkingSet::INVALID_ID != id) {
+        _ws->free(id);
+    }
+}
+
+PlanStage::StageState CountStage::handleChildState(StageState childState,
+                                                   WorkingSetID childId,
+                                                   WorkingSetID* out) {
+    if (PlanStage::IS_EOF == childState) {
         _commonStats.isEOF = true;
         return PlanStage::IS_EOF;
-    } else if (PlanStage::DEAD == state) {
-        return state;
-    } else if (PlanStage::FAILURE == state) {
-        *out = id;
+    } else if (PlanStage::DEAD == childState) {
+        return childState;
+    } else if (PlanStage::FAILURE == childState) {
+        *out = childId;
         // If a stage fails, it may create a status WSM to indicate why it failed, in which
         // case 'id' is valid. If ID is invalid, we create our own error message.
-        if (WorkingSet::INVALID_ID == id) {
+        if (WorkingSet::INVALID_ID == childId) {
             const std::string errmsg = "count stage failed to read result from child";
             Status status = Status(ErrorCodes::InternalError, errmsg);
             *out = WorkingSetCommon::allocateStatusMember(_ws, status);
         }
-        return state;
-    } else if (PlanStage::ADVANCED == state) {
-        // We got a result. If we're still skipping, then decrement the number left to skip.
-        // Otherwise increment the count until we hit the limit.
-        if (_leftToSkip > 0) {
-            _leftToSkip--;
-            _specificStats.nSkipped++;
-        } else {
-            _specificStats.nCounted++;
-        }
-
-        // Count doesn't need the actual results, so we just discard any valid working
-        // set members that got returned from the child.
-        if (WorkingSet::INVALID_ID != id) {
-            _ws->free(id);
-        }
-    } else if (PlanStage::NEED_YIELD == state) {
-        *out = id;
+        return childState;
+    } else if (PlanStage::NEED_YIELD == childState) {
+        *out = childId;
         return PlanStage::NEED_YIELD;
     }
 
@@ -80,6 +80,14 @@ public:
     bool isEOF() final;
     StageState doWork(WorkingSetID* out) final;
 
+    /**
+     * Counts a block of results pulled from our child with a single call to workBatch(), as one
+     * unit of work. Since count returns no results of its own, 'results' is never appended to.
+     */
+    StageState doWorkBatch(size_t maxWorks,
+                           std::vector<WorkingSetID>* results,
+                           WorkingSetID* out) final;
+
     StageType stageType() const final {
         return STAGE_COUNT;
     }
@@ -99,6 +107,18 @@ private:
      */
     void recordStoreCount();
 
+    /**
+     * Skips or counts one result returned by our child, and frees its working set member if it
+     * has one.
+     */
+    void countResult(WorkingSetID id);
+
+    /**
+     * Returns the state with which a unit of work ends once our child has returned 'childState'
+     * and 'childId', setting *out as work() would.
+     */
+    StageState handleChildState(StageState childState, WorkingSetID childId, WorkingSetID* out);
+
     // The collection over which we are counting.
     Collection* _collection;
 
@@ -92,6 +92,38 @@ CountScan::CountScan(OperationContext* txn, const CountScanParams& params, Worki
 
 
 PlanStage::StageState CountScan::doWork(WorkingSetID* out) {
+    const StageState state = advance();
+    if (PlanStage::ADVANCED == state) {
+        WorkingSetID id = _workingSet->allocate();
+        _workingSet->transitionToRecordIdAndObj(id);
+        *out = id;
+    } else if (PlanStage::NEED_YIELD == state) {
+        *out = WorkingSet::INVALID_ID;
+    }
+    return state;
+}
+
+PlanStage::StageState CountScan::doWorkBatch(size_t maxWorks,
+                                             std::vector<WorkingSetID>* results,
+                                             WorkingSetID* out) {
+    // Our results carry no data, and the CountStage asking for them would only free their
+    // members, so every result of a batch is returned as WorkingSet::INVALID_ID.
+    StageState state = PlanStage::NEED_TIME;
+    for (size_t works = 0; works < maxWorks; ++works) {
+        state = advance();
+        recordWork(state);
+
+        if (PlanStage::ADVANCED == state) {
+            results->push_back(WorkingSet::INVALID_ID);
+        } else if (PlanStage::NEED_TIME != state) {
+            *out = WorkingSet::INVALID_ID;
+            break;
+        }
+    }
+    return state;
+}
+
+PlanStage::StageState CountScan::advance() {
     if (_commonStats.isEOF)
         return PlanStage::IS_EOF;
 
@@ -115,7 +147,6 @@ PlanStage::StageState CountScan::doWork(WorkingSetID* out) {
             // Release our cursor and try again next time.
             _cursor.reset();
         }
-        *out = WorkingSet::INVALID_ID;
         return PlanStage::NEED_YIELD;
     }
 
@@ -132,9 +163,6 @@ PlanStage::StageState CountScan::doWork(WorkingSetID* out) {
         return PlanStage::NEED_TIME;
     }
 
-    WorkingSetID id = _workingSet->allocate();
-    _workingSet->transitionToRecordIdAndObj(id);
-    *out = id;
     return PlanStage::ADVANCED;
 }
 
@@ -70,6 +70,16 @@ public:
     CountScan(OperationContext* txn, const CountScanParams& params, WorkingSet* workingSet);
 
     StageState doWork(WorkingSetID* out) final;
+
+    /**
+     * Like repeated calls to doWork(), but returns every result as WorkingSet::INVALID_ID rather
+     * than allocating a member for it. Only CountStage, which has no use for the members, asks a
+     * CountScan for a batch.
+     */
+    StageState doWorkBatch(size_t maxWorks,
+                           std::vector<WorkingSetID>* results,
+                           WorkingSetID* out) final;
+
     bool isEOF() final;
     void doSaveState() final;
     void doRestoreState() final;
@@ -88,6 +98,12 @@ public:
     static const char* kStageType;
 
 private:
+    /**
+     * Moves to the next index entry. Returns ADVANCED if it holds a RecordId we have not counted
+     * yet, without creating a working set member for it.
+     */
+    StageState advance();
+
     // The WorkingSet we annotate with results.  Not owned by us.
     WorkingSet* _workingSet;
 
@@ -218,6 +218,8 @@ PlanStage::StageState DeleteStage::doWork(WorkingSetID* out) {
             _collection->deleteDocument(getOpCtx(), recordId, _params.opDebug, _params.fromMigrate);
             wunit.commit();
         } catch (const WriteConflictException& wce) {
+            WriteConflictContentionManager::get(getOpCtx()->getServiceContext())
+                .noteConflict(getOpCtx(), _collection->ns().ns(), recordId);
             memberFreer.Dismiss();  // Keep this member around so we can retry deleting it.
             return prepareToRetryWSM(id, out);
         }
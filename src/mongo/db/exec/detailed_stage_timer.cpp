@@ -0,0 +1,118 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/detailed_stage_timer.h"
+
+#ifndef _WIN32
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+#include "mongo/db/exec/plan_stats.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+namespace {
+
+const auto detailedStatsEnabled = OperationContext::declareDecoration<bool>();
+
+}  // namespace
+
+ScopedDetailedStageTimer::ScopedDetailedStageTimer(OperationContext* opCtx, CommonStats* stats) {
+    if (!isEnabled(opCtx)) {
+        return;
+    }
+
+    _stats = stats;
+    _stats->detailedStats = true;
+    _tickSource = opCtx->getServiceContext()->getTickSource();
+    _startUsage = getThreadUsage();
+    _startTicks = _tickSource->getTicks();
+}
+
+ScopedDetailedStageTimer::~ScopedDetailedStageTimer() {
+    if (!_stats) {
+        return;
+    }
+
+    const TickSource::Tick elapsedTicks = _tickSource->getTicks() - _startTicks;
+    const ThreadUsage endUsage = getThreadUsage();
+
+    _stats->executionTimeNanos += static_cast<long long>(
+        elapsedTicks * (1.0e9 / static_cast<double>(_tickSource->getTicksPerSecond())));
+    _stats->cpuTimeNanos += endUsage.cpuNanos - _startUsage.cpuNanos;
+    _stats->diskBytesRead += endUsage.diskBytesRead - _startUsage.diskBytesRead;
+    _stats->majorPageFaults += endUsage.majorPageFaults - _startUsage.majorPageFaults;
+}
+
+void ScopedDetailedStageTimer::setEnabled(OperationContext* opCtx, bool enabled) {
+    detailedStatsEnabled(opCtx) = enabled;
+}
+
+bool ScopedDetailedStageTimer::isEnabled(const OperationContext* opCtx) {
+    return opCtx && detailedStatsEnabled(opCtx);
+}
+
+ScopedDetailedStageTimer::ThreadUsage ScopedDetailedStageTimer::getThreadUsage() {
+    ThreadUsage usage;
+#if defined(_WIN32)
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+        // FILETIMEs count 100ns intervals.
+        auto toNanos = [](const FILETIME& ft) {
+            ULARGE_INTEGER value;
+            value.LowPart = ft.dwLowDateTime;
+            value.HighPart = ft.dwHighDateTime;
+            return static_cast<long long>(value.QuadPart) * 100;
+        };
+        usage.cpuNanos = toNanos(kernelTime) + toNanos(userTime);
+    }
+#else
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+    struct timespec ts;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts) == 0) {
+        usage.cpuNanos = static_cast<long long>(ts.tv_sec) * 1000 * 1000 * 1000 + ts.tv_nsec;
+    }
+#endif
+#if defined(RUSAGE_THREAD)
+    // Reads served from the page cache don't count as block input operations, so these are the
+    // reads that went to disk.
+    struct rusage ru;
+    if (getrusage(RUSAGE_THREAD, &ru) == 0) {
+        usage.diskBytesRead = static_cast<long long>(ru.ru_inblock) * 512;
+        usage.majorPageFaults = ru.ru_majflt;
+    }
+#endif
+#endif
+    return usage;
+}
+
+}  // namespace mongo
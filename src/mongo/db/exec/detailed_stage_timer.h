@@ -0,0 +1,82 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/util/tick_source.h"
+
+namespace mongo {
+
+struct CommonStats;
+class OperationContext;
+
+/**
+ * Adds the wall clock time in nanoseconds, the CPU time, and the disk reads and major page faults
+ * of the current thread, between its construction and its destruction, to a stage's CommonStats.
+ *
+ * Taking these snapshots costs system calls, so the timer does nothing unless detailed stage
+ * stats were turned on for the operation, which explain does at executionStats verbosity.
+ */
+class ScopedDetailedStageTimer {
+    MONGO_DISALLOW_COPYING(ScopedDetailedStageTimer);
+
+public:
+    ScopedDetailedStageTimer(OperationContext* opCtx, CommonStats* stats);
+
+    ~ScopedDetailedStageTimer();
+
+    /**
+     * Turns the collection of detailed stage stats on or off for the plans run by 'opCtx'.
+     */
+    static void setEnabled(OperationContext* opCtx, bool enabled);
+
+    static bool isEnabled(const OperationContext* opCtx);
+
+    /**
+     * Resource usage of the current thread since it started. Fields the platform can't report
+     * are left at zero.
+     */
+    struct ThreadUsage {
+        long long cpuNanos = 0;
+        long long diskBytesRead = 0;
+        long long majorPageFaults = 0;
+    };
+
+    static ThreadUsage getThreadUsage();
+
+private:
+    // Null if detailed stats are off, in which case nothing else is set.
+    CommonStats* _stats = nullptr;
+    TickSource* _tickSource = nullptr;
+
+    TickSource::Tick _startTicks = 0;
+    ThreadUsage _startUsage;
+};
+
+}  // namespace mongo
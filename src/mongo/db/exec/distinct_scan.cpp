@@ -101,15 +101,26 @@ PlanStage::StageState DistinctScan::doWork(WorkingSetID* out) {
             return IS_EOF;
 
         case IndexBoundsChecker::VALID:
-            // Return this key. Adjust the _seekPoint so that it is exclusive on the field we
-            // are using.
-
             if (!kv->key.isOwned())
                 kv->key = kv->key.getOwned();
             _seekPoint.keyPrefix = kv->key;
-            _seekPoint.prefixLen = _params.fieldNo + 1;
             _seekPoint.prefixExclusive = true;
 
+            if (_params.filter &&
+                !Filter::passes(kv->key, _descriptor->keyPattern(), _params.filter)) {
+                // Step over just this key; a later key with the same distinct value may pass.
+                _seekPoint.prefixLen = kv->key.nFields();
+                return PlanStage::NEED_TIME;
+            }
+
+            // Adjust the _seekPoint so that it is exclusive on the field we are using.
+            _seekPoint.prefixLen = _params.fieldNo + 1;
+
+            if (_params.dedup && !_returned.insert(kv->loc).second) {
+                // The document holding this value was already returned for an earlier value.
+                return PlanStage::NEED_TIME;
+            }
+
             // Package up the result for the caller.
             WorkingSetID id = _workingSet->allocate();
             WorkingSetMember* member = _workingSet->get(id);
@@ -148,7 +159,24 @@ void DistinctScan::doReattachToOperationContext() {
         _cursor->reattachToOperationContext(getOpCtx());
 }
 
+void DistinctScan::doInvalidate(OperationContext* txn,
+                                const RecordId& dl,
+                                InvalidationType type) {
+    // If we see this RecordId again, it may not be the same document it was before, so we want
+    // to return it if we see it again.
+    if (INVALIDATION_DELETION == type) {
+        _returned.erase(dl);
+    }
+}
+
 unique_ptr<PlanStageStats> DistinctScan::getStats() {
+    // Add a BSON representation of the filter to the stats tree, if there is one.
+    if (_params.filter && _commonStats.filter.isEmpty()) {
+        BSONObjBuilder bob;
+        _params.filter->serialize(&bob);
+        _commonStats.filter = bob.obj();
+    }
+
     // Serialize the bounds to BSON if we have not done so already. This is done here rather than in
     // the constructor in order to avoid the expensive serialization operation unless the distinct
     // command is being explained.
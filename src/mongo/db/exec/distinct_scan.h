@@ -44,7 +44,7 @@ class IndexDescriptor;
 class WorkingSet;
 
 struct DistinctParams {
-    DistinctParams() : descriptor(NULL), direction(1), fieldNo(0) {}
+    DistinctParams() : descriptor(NULL), direction(1), fieldNo(0), filter(NULL), dedup(false) {}
 
     // What index are we traversing?
     const IndexDescriptor* descriptor;
@@ -61,6 +61,17 @@ struct DistinctParams {
     // If we distinct over 'a' the position is 0.
     // If we distinct over 'b' the position is 1.
     int fieldNo;
+
+    // An optional filter over the index key data.  Keys which don't pass it are stepped over one
+    // at a time, and the scan only skips to the next value of the distinct field once it finds a
+    // key that passes.  Not owned by us.
+    const MatchExpression* filter;
+
+    // If true, don't return a RecordId more than once, and treat a value whose first matching key
+    // belongs to an already returned RecordId as seen.  Only correct when the consumer reads every
+    // value of the distinct field from the fetched document, as the distinct command does over a
+    // multikey index.
+    bool dedup;
 };
 
 /**
@@ -82,6 +93,7 @@ public:
     void doRestoreState() final;
     void doDetachFromOperationContext() final;
     void doReattachToOperationContext() final;
+    void doInvalidate(OperationContext* txn, const RecordId& dl, InvalidationType type) final;
 
     StageType stageType() const final {
         return STAGE_DISTINCT_SCAN;
@@ -110,6 +122,9 @@ private:
     IndexBoundsChecker _checker;
     IndexSeekPoint _seekPoint;
 
+    // The RecordIds we have returned, if _params.dedup is set.
+    unordered_set<RecordId, RecordId::Hasher> _returned;
+
     // Stats
     DistinctScanStats _specificStats;
 };
@@ -35,6 +35,7 @@
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/fail_point_service.h"
@@ -71,9 +72,31 @@ bool FetchStage::isEOF() {
         return false;
     }
 
+    if (hasBufferedChildResults()) {
+        return false;
+    }
+
     return child()->isEOF();
 }
 
+PlanStage::StageState FetchStage::getNextFromChild(WorkingSetID* out) {
+    if (!_childResults.empty()) {
+        *out = _childResults.front();
+        _childResults.pop_front();
+        return ADVANCED;
+    }
+
+    if (NEED_TIME != _childBatchState) {
+        StageState state = _childBatchState;
+        *out = _childBatchId;
+        _childBatchState = NEED_TIME;
+        _childBatchId = WorkingSet::INVALID_ID;
+        return state;
+    }
+
+    return child()->work(out);
+}
+
 PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     if (isEOF()) {
         return PlanStage::IS_EOF;
@@ -83,7 +106,7 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     WorkingSetID id;
     StageState status;
     if (_idRetrying == WorkingSet::INVALID_ID) {
-        status = child()->work(&id);
+        status = getNextFromChild(&id);
     } else {
         status = ADVANCED;
         id = _idRetrying;
@@ -115,11 +138,14 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
                 }
 
                 // The doc is already in memory, so go ahead and grab it. Now we have a RecordId
-                // as well as an unowned object
+                // as well as an unowned object. Fetching moves the cursor, so the document we
+                // fetched last can't stay borrowed.
+                WorkingSetCommon::ownObjIfStillInUse(_ws, &_borrowedId);
                 if (!WorkingSetCommon::fetch(getOpCtx(), _ws, id, _cursor)) {
                     _ws->free(id);
                     return NEED_TIME;
                 }
+                _borrowedId = id;
             } catch (const WriteConflictException& wce) {
                 // Ensure that the BSONObj underlying the WorkingSetMember is owned because it may
                 // be freed when we yield.
@@ -150,7 +176,74 @@ PlanStage::StageState FetchStage::doWork(WorkingSetID* out) {
     return status;
 }
 
+PlanStage::StageState FetchStage::doWorkBatch(size_t maxWorks,
+                                              std::vector<WorkingSetID>* results,
+                                              WorkingSetID* out) {
+    // Pull a block of record ids from our child in one call, unless we are still working through
+    // the previous one.
+    if (WorkingSet::INVALID_ID == _idRetrying && !hasBufferedChildResults() &&
+        !child()->isEOF()) {
+        std::vector<WorkingSetID> block;
+        WorkingSetID childId = WorkingSet::INVALID_ID;
+        StageState childState = child()->workBatch(maxWorks, &block, &childId);
+
+        _childResults.insert(_childResults.end(), block.begin(), block.end());
+        if (ADVANCED != childState && NEED_TIME != childState) {
+            _childBatchState = childState;
+            _childBatchId = childId;
+        }
+
+        if (internalQueryExecFetchReadAhead.load()) {
+            readAhead(block);
+        }
+    }
+
+    // Fetch what we pulled. The first unit of work always runs, so that reaching EOF or a child
+    // batch that produced nothing is reported like it would be by work().
+    StageState state = NEED_TIME;
+    for (size_t works = 0; works < maxWorks; ++works) {
+        if (works > 0 && WorkingSet::INVALID_ID == _idRetrying && !hasBufferedChildResults()) {
+            break;
+        }
+
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        state = doWork(&id);
+        recordWork(state);
+
+        if (ADVANCED == state) {
+            results->push_back(id);
+        } else if (NEED_TIME != state) {
+            *out = id;
+            break;
+        }
+    }
+    return state;
+}
+
+void FetchStage::readAhead(const std::vector<WorkingSetID>& block) {
+    std::vector<RecordId> ids;
+    for (auto id : block) {
+        WorkingSetMember* member = _ws->get(id);
+        if (!member->hasObj() && member->hasRecordId()) {
+            ids.push_back(member->recordId);
+        }
+    }
+    if (ids.size() < 2) {
+        return;
+    }
+
+    try {
+        if (!_cursor)
+            _cursor = _collection->getCursor(getOpCtx());
+        _cursor->readAhead(ids);
+    } catch (const WriteConflictException& wce) {
+        // Read-ahead is only a hint. If the conflict persists, fetching the first of these
+        // records will surface it and yield.
+    }
+}
+
 void FetchStage::doSaveState() {
+    WorkingSetCommon::ownObjIfStillInUse(_ws, &_borrowedId);
     if (_cursor)
         _cursor->saveUnpositioned();
 }
@@ -180,6 +273,15 @@ void FetchStage::doInvalidate(OperationContext* txn, const RecordId& dl, Invalid
             WorkingSetCommon::fetchAndInvalidateRecordId(txn, member, _collection);
         }
     }
+
+    // The same applies to the record ids our child handed us in a batch that we have not
+    // fetched yet.
+    for (auto id : _childResults) {
+        WorkingSetMember* member = _ws->get(id);
+        if (member->hasRecordId() && (member->recordId == dl)) {
+            WorkingSetCommon::fetchAndInvalidateRecordId(txn, member, _collection);
+        }
+    }
 }
 
 PlanStage::StageState FetchStage::returnIfMatches(WorkingSetMember* member,
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
 
 #include "mongo/db/exec/plan_stage.h"
@@ -59,6 +60,9 @@ public:
 
     bool isEOF() final;
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxWorks,
+                           std::vector<WorkingSetID>* results,
+                           WorkingSetID* out) final;
 
     void doSaveState() final;
     void doRestoreState() final;
@@ -83,6 +87,25 @@ private:
      */
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
+    /**
+     * Returns the next result of our child, taking it from the results of the last block pulled by
+     * doWorkBatch() if any remain, and calling work() on the child otherwise.
+     */
+    StageState getNextFromChild(WorkingSetID* out);
+
+    /**
+     * Passes the RecordIds of the members of 'block' that still need to be fetched to our cursor
+     * as a read-ahead hint.
+     */
+    void readAhead(const std::vector<WorkingSetID>& block);
+
+    /**
+     * Returns true if results pulled from our child by doWorkBatch() have yet to be processed.
+     */
+    bool hasBufferedChildResults() const {
+        return !_childResults.empty() || NEED_TIME != _childBatchState;
+    }
+
     // Collection which is used by this stage. Used to resolve record ids retrieved by child
     // stages. The lifetime of the collection must supersede that of the stage.
     const Collection* _collection;
@@ -98,6 +121,17 @@ private:
     // If not Null, we use this rather than asking our child what to do next.
     WorkingSetID _idRetrying;
 
+    // The last member we fetched a document into, which may point into _cursor's buffer until
+    // the cursor moves.
+    WorkingSetID _borrowedId = WorkingSet::INVALID_ID;
+
+    // Results of our child's last workBatch() that we have not fetched yet. If that batch ended
+    // with a state other than ADVANCED or NEED_TIME, the state and its WorkingSetID are kept in
+    // _childBatchState and _childBatchId until the buffered results are consumed.
+    std::deque<WorkingSetID> _childResults;
+    StageState _childBatchState = NEED_TIME;
+    WorkingSetID _childBatchId = WorkingSet::INVALID_ID;
+
     // Stats
     FetchStats _specificStats;
 };
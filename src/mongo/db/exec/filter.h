@@ -41,7 +41,16 @@ namespace mongo {
  */
 class WorkingSetMatchableDocument : public MatchableDocument {
 public:
-    WorkingSetMatchableDocument(WorkingSetMember* wsm) : _wsm(wsm) {}
+    WorkingSetMatchableDocument(WorkingSetMember* wsm)
+        : _wsm(wsm),
+          _topLevelFields(wsm->getTopLevelFieldCache()),
+          _localTopLevelFields(BSONObj()) {
+        // An unowned object can only be indexed for as long as this document exists.
+        if (!_topLevelFields && wsm->hasObj()) {
+            _localTopLevelFields.reset(wsm->obj.value());
+            _topLevelFields = &_localTopLevelFields;
+        }
+    }
 
     // This is only called by a $where query.  The query system must be smart enough to realize
     // that it should do a fetch beforehand.
@@ -54,7 +63,13 @@ public:
         // BSONElementIterator does some interesting things with arrays that I don't think
         // SimpleArrayElementIterator does.
         if (_wsm->hasObj()) {
-            return new BSONElementIterator(path, _wsm->obj.value());
+            // Like BSONMatchableDocument, avoid allocating an iterator for every predicate.
+            if (_iteratorUsed) {
+                return new BSONElementIterator(path, _wsm->obj.value(), _topLevelFields);
+            }
+            _iteratorUsed = true;
+            _iterator.reset(path, _wsm->obj.value(), _topLevelFields);
+            return &_iterator;
         }
 
         // NOTE: This (kind of) duplicates code in WorkingSetMember::getFieldDotted.
@@ -89,11 +104,19 @@ public:
     }
 
     void releaseIterator(ElementIterator* iterator) const final {
-        delete iterator;
+        if (iterator == &_iterator) {
+            _iteratorUsed = false;
+        } else {
+            delete iterator;
+        }
     }
 
 private:
     WorkingSetMember* _wsm;
+    const BSONTopLevelFieldCache* _topLevelFields;
+    BSONTopLevelFieldCache _localTopLevelFields;
+    mutable BSONElementIterator _iterator;
+    mutable bool _iteratorUsed = false;
 };
 
 class IndexKeyMatchableDocument : public MatchableDocument {
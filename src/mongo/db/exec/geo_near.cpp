@@ -36,13 +36,17 @@
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/exec/fetch.h"
 #include "mongo/db/exec/index_scan.h"
 #include "mongo/db/exec/working_set_computed_data.h"
 #include "mongo/db/geo/geoconstants.h"
 #include "mongo/db/geo/geoparser.h"
 #include "mongo/db/geo/hash.h"
+#include "mongo/db/geo/s2_density_grid.h"
 #include "mongo/db/index/expression_params.h"
+#include "mongo/db/index/s2_access_method.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/query/expression_index.h"
 #include "mongo/db/query/expression_index_knobs.h"
@@ -753,9 +757,24 @@ GeoNear2DSphereStage::GeoNear2DSphereStage(const GeoNearParams& nearParams,
     // strings, and _nearParams.filter should have the collator.
     const CollatorInterface* collator = nullptr;
     ExpressionParams::initialize2dsphereParams(s2Index->infoObj(), collator, &_indexParams);
+
+    if (collection) {
+        auto accessMethod =
+            static_cast<S2AccessMethod*>(collection->getIndexCatalog()->getIndex(s2Index));
+        if (accessMethod) {
+            _densityGrid = accessMethod->getDensityGrid();
+        }
+    }
 }
 
-GeoNear2DSphereStage::~GeoNear2DSphereStage() {}
+GeoNear2DSphereStage::~GeoNear2DSphereStage() {
+    // Share what this query learned about the density around its center with later queries.
+    if (_densityGrid && _scannedOuter > 0) {
+        _densityGrid->recordSample(_nearParams.nearQuery->centroid->cell.id(),
+                                   S2DensityGrid::ringArea(_fullBounds.getInner(), _scannedOuter),
+                                   _scannedKeys);
+    }
+}
 
 namespace {
 
@@ -912,10 +931,42 @@ PlanStage::StageState GeoNear2DSphereStage::DensityEstimator::work(OperationCont
 }
 
 
+namespace {
+
+// How many keys the first annulus of a $geoNear search should hold, and how many each later one
+// should, when the index's density around the center is known.
+const double kFirstIntervalTargetKeys = 50;
+const double kIntervalTargetKeys = 400;
+
+// Returns the narrowest annulus worth scanning, which is about the width of a cell at the finest
+// level coverings use.
+double minS2BoundsIncrement() {
+    const int level =
+        std::max(0, std::min(S2::kMaxCellLevel, internalQueryS2GeoFinestLevel.load()));
+    return S2::kAvgEdge.GetValue(level) * kRadiusOfEarthInMeters;
+}
+
+}  // namespace
+
 PlanStage::StageState GeoNear2DSphereStage::initialize(OperationContext* txn,
                                                        WorkingSet* workingSet,
                                                        Collection* collection,
                                                        WorkingSetID* out) {
+    if (!_densityEstimator && _densityGrid) {
+        // Earlier queries near this center measured the index's density here, so size the first
+        // annulus from that rather than probing the index.
+        auto keysPerSquareMeter =
+            _densityGrid->getKeysPerSquareMeter(_nearParams.nearQuery->centroid->cell.id());
+        if (keysPerSquareMeter) {
+            const double inner = std::max(_fullBounds.getInner(), 0.0);
+            const double outer = S2DensityGrid::ringOuterRadius(
+                inner, *keysPerSquareMeter, kFirstIntervalTargetKeys);
+            _boundsIncrement = std::max(outer - inner, minS2BoundsIncrement());
+            _specificStats.usedDensityGrid = true;
+            return IS_EOF;
+        }
+    }
+
     if (!_densityEstimator) {
         _densityEstimator.reset(
             new DensityEstimator(&_children, _s2Index, &_nearParams, _indexParams));
@@ -947,6 +998,14 @@ StatusWith<NearStage::CoveredInterval*>  //
     GeoNear2DSphereStage::nextInterval(OperationContext* txn,
                                        WorkingSet* workingSet,
                                        Collection* collection) {
+    // The previous annulus has been scanned in full, so count its keys toward the density.
+    if (_currScan) {
+        _scannedKeys +=
+            static_cast<const IndexScanStats*>(_currScan->getSpecificStats())->keysExamined;
+        _scannedOuter = _currBounds.getOuter();
+        _currScan = nullptr;
+    }
+
     // The search is finished if we searched at least once and all the way to the edge
     if (_currBounds.getInner() >= 0 && _currBounds.getOuter() == _fullBounds.getOuter()) {
         return StatusWith<CoveredInterval*>(NULL);
@@ -957,13 +1016,32 @@ StatusWith<NearStage::CoveredInterval*>  //
     //
 
     if (!_specificStats.intervalStats.empty()) {
-        const IntervalStats& lastIntervalStats = _specificStats.intervalStats.back();
+        // Prefer the density this query has seen, then the density earlier queries saw here.
+        boost::optional<double> keysPerSquareMeter;
+        if (_scannedKeys > 0) {
+            keysPerSquareMeter =
+                _scannedKeys / S2DensityGrid::ringArea(_fullBounds.getInner(), _scannedOuter);
+        } else if (_densityGrid) {
+            keysPerSquareMeter =
+                _densityGrid->getKeysPerSquareMeter(_nearParams.nearQuery->centroid->cell.id());
+        }
 
-        // TODO: Generally we want small numbers of results fast, then larger numbers later
-        if (lastIntervalStats.numResultsReturned < 300)
-            _boundsIncrement *= 2;
-        else if (lastIntervalStats.numResultsReturned > 600)
-            _boundsIncrement /= 2;
+        if (keysPerSquareMeter) {
+            // Size the annulus to hold about the same number of keys each time. Sparse regions get
+            // wide annuli instead of many empty ones.
+            const double inner = _currBounds.getOuter();
+            const double outer =
+                S2DensityGrid::ringOuterRadius(inner, *keysPerSquareMeter, kIntervalTargetKeys);
+            _boundsIncrement = std::max(outer - inner, minS2BoundsIncrement());
+        } else {
+            const IntervalStats& lastIntervalStats = _specificStats.intervalStats.back();
+
+            // TODO: Generally we want small numbers of results fast, then larger numbers later
+            if (lastIntervalStats.numResultsReturned < 300)
+                _boundsIncrement *= 2;
+            else if (lastIntervalStats.numResultsReturned > 600)
+                _boundsIncrement /= 2;
+        }
     }
 
     invariant(_boundsIncrement > 0.0);
@@ -1015,6 +1093,7 @@ StatusWith<NearStage::CoveredInterval*>  //
     ExpressionMapping::S2CellIdsToIntervalsWithParents(cover, _indexParams, coveredIntervals);
 
     IndexScan* scan = new IndexScan(txn, scanParams, workingSet, nullptr);
+    _currScan = scan;
 
     // FetchStage owns index scan
     _children.emplace_back(new FetchStage(txn, workingSet, scan, _nearParams.filter, collection));
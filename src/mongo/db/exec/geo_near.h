@@ -42,6 +42,9 @@
 
 namespace mongo {
 
+class IndexScan;
+class S2DensityGrid;
+
 /**
  * Generic parameters for a GeoNear search
  */
@@ -154,6 +157,17 @@ private:
 
     class DensityEstimator;
     std::unique_ptr<DensityEstimator> _densityEstimator;
+
+    // The index's shared density estimates. Null if the index isn't available to this stage.
+    S2DensityGrid* _densityGrid = nullptr;
+
+    // The index scan of the current annulus. Owned in _children.
+    IndexScan* _currScan = nullptr;
+
+    // The keys examined in the annuli this stage has finished scanning, which reach out to
+    // _scannedOuter meters.
+    long long _scannedKeys = 0;
+    double _scannedOuter = -1;
 };
 
 }  // namespace mongo
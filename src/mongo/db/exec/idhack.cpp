@@ -32,6 +32,7 @@
 
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/projection.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
@@ -75,11 +76,13 @@ IDHackStage::IDHackStage(OperationContext* txn,
                          Collection* collection,
                          const BSONObj& key,
                          WorkingSet* ws,
-                         const IndexDescriptor* descriptor)
+                         const IndexDescriptor* descriptor,
+                         const MatchExpression* filter)
     : PlanStage(kStageType, txn),
       _collection(collection),
       _workingSet(ws),
       _key(key),
+      _filter(filter),
       _done(false),
       _addKeyMetadata(false),
       _idBeingPagedIn(WorkingSet::INVALID_ID) {
@@ -176,6 +179,14 @@ PlanStage::StageState IDHackStage::advance(WorkingSetID id,
                                            WorkingSetID* out) {
     invariant(member->hasObj());
 
+    if (!Filter::passes(member, _filter)) {
+        // The key is unique, so no other document can match.
+        _workingSet->free(id);
+        _commonStats.isEOF = true;
+        _done = true;
+        return IS_EOF;
+    }
+
     if (_addKeyMetadata) {
         BSONObjBuilder bob;
         BSONObj ownedKeyObj = member->obj.value()["_id"].wrap().getOwned();
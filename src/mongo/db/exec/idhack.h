@@ -42,7 +42,7 @@ class RecordCursor;
 
 /**
  * A standalone stage implementing the fast path for key-value retrievals
- * via the _id index.
+ * via the _id index, or via another unique index on a single field.
  */
 class IDHackStage final : public PlanStage {
 public:
@@ -53,11 +53,17 @@ public:
                 WorkingSet* ws,
                 const IndexDescriptor* descriptor);
 
+    /**
+     * Returns the document whose key in the index 'descriptor' is 'key', if it also matches
+     * 'filter'. A null filter matches every document. The filter is not owned and must outlive
+     * this stage.
+     */
     IDHackStage(OperationContext* txn,
                 Collection* collection,
                 const BSONObj& key,
                 WorkingSet* ws,
-                const IndexDescriptor* descriptor);
+                const IndexDescriptor* descriptor,
+                const MatchExpression* filter = nullptr);
 
     ~IDHackStage();
 
@@ -107,6 +113,9 @@ private:
     // The value to match against the _id field.
     BSONObj _key;
 
+    // Further predicate the document found must match, or null. Not owned here.
+    const MatchExpression* _filter = nullptr;
+
     // Have we returned our one document?
     bool _done;
 
@@ -224,6 +224,12 @@ PlanStage::StageState IndexScan::doWork(WorkingSetID* out) {
     return PlanStage::ADVANCED;
 }
 
+PlanStage::StageState IndexScan::doWorkBatch(size_t maxWorks,
+                                             std::vector<WorkingSetID>* results,
+                                             WorkingSetID* out) {
+    return doWorkBatchWith(this, maxWorks, results, out);
+}
+
 bool IndexScan::isEOF() {
     return _commonStats.isEOF;
 }
@@ -96,6 +96,9 @@ public:
               const MatchExpression* filter);
 
     StageState doWork(WorkingSetID* out) final;
+    StageState doWorkBatch(size_t maxWorks,
+                           std::vector<WorkingSetID>* results,
+                           WorkingSetID* out) final;
     bool isEOF() final;
     void doSaveState() final;
     void doRestoreState() final;
@@ -111,6 +114,10 @@ public:
 
     const SpecificStats* getSpecificStats() const final;
 
+    const IndexBounds& getBounds() const {
+        return _params.bounds;
+    }
+
     static const char* kStageType;
 
 private:
@@ -56,6 +56,7 @@ MergeSortStage::MergeSortStage(OperationContext* opCtx,
       _pattern(params.pattern),
       _collator(params.collator),
       _dedup(params.dedup),
+      _singleSortKeyPerRecord(params.singleSortKeyPerRecord),
       _merging(StageWithValueComparison(ws, params.pattern, params.collator)) {}
 
 void MergeSortStage::addChild(PlanStage* child) {
@@ -167,12 +168,62 @@ PlanStage::StageState MergeSortStage::doWork(WorkingSetID* out) {
     WorkingSetID idToTest = top->id;
     _mergingData.erase(top);
 
+    if (_dedup && _singleSortKeyPerRecord) {
+        pruneSeen(_ws->get(idToTest));
+    }
+
     // Return the min.
     *out = idToTest;
 
     return PlanStage::ADVANCED;
 }
 
+void MergeSortStage::pruneSeen(WorkingSetMember* member) {
+    if (_pruneAfterKey.isEmpty()) {
+        if (_seen.size() >= kSeenRecordsBeforePruning) {
+            extractSortKey(member, &_pruneAfterKey);
+        }
+        return;
+    }
+
+    BSONObj key;
+    if (!extractSortKey(member, &key) ||
+        key.woCompare(_pruneAfterKey, _pattern, false, _collator) <= 0) {
+        return;
+    }
+
+    // Each child produces its records in sort order and every child's next record sorts at or
+    // after 'member', so a record which sorts before 'member' can't be produced again. Since
+    // 'member' is the first result past '_pruneAfterKey', the only records we have seen which
+    // don't sort before it are 'member' itself and the results waiting to be merged.
+    _seen.clear();
+    if (member->hasRecordId()) {
+        _seen.insert(member->recordId);
+    }
+    for (auto&& value : _mergingData) {
+        WorkingSetMember* waiting = _ws->get(value.id);
+        if (waiting->hasRecordId()) {
+            _seen.insert(waiting->recordId);
+        }
+    }
+    _pruneAfterKey = BSONObj();
+    ++_specificStats.dedupPrunes;
+}
+
+bool MergeSortStage::extractSortKey(WorkingSetMember* member, BSONObj* out) const {
+    BSONObjBuilder keyBuilder;
+    BSONObjIterator it(_pattern);
+    while (it.more()) {
+        BSONElement elt;
+        if (!member->getFieldDotted(it.next().fieldName(), &elt) || elt.eoo() ||
+            Array == elt.type()) {
+            return false;
+        }
+        keyBuilder.appendAs(elt, "");
+    }
+    *out = keyBuilder.obj();
+    return true;
+}
 
 void MergeSortStage::doInvalidate(OperationContext* txn,
                                   const RecordId& dl,
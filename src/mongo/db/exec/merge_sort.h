@@ -78,7 +78,24 @@ public:
 
     static const char* kStageType;
 
+    // When the records are known to have a single sort key, the set of records seen for
+    // deduplication is pruned once it holds this many records.
+    static const size_t kSeenRecordsBeforePruning = 1024;
+
 private:
+    /**
+     * Called with each result we return when deduplicating records which have a single sort key.
+     * Once '_seen' is large, notes the sort key of 'member', and empties '_seen' of the records
+     * which can't be produced again when the first result with a greater sort key is returned.
+     */
+    void pruneSeen(WorkingSetMember* member);
+
+    /**
+     * Builds the key of 'member' under '_pattern' into 'out'. Returns false if it has no usable
+     * key, for instance because a sort field is missing or is an array.
+     */
+    bool extractSortKey(WorkingSetMember* member, BSONObj* out) const;
+
     // Not owned by us.
     const Collection* _collection;
 
@@ -95,9 +112,16 @@ private:
     // Are we deduplicating on RecordId?
     bool _dedup;
 
+    // Are a record's sort keys the same in every child that produces it?
+    bool _singleSortKeyPerRecord;
+
     // Which RecordIds have we seen?
     unordered_set<RecordId, RecordId::Hasher> _seen;
 
+    // If not empty, '_seen' is pruned when we return the first result whose sort key is greater
+    // than this one.
+    BSONObj _pruneAfterKey;
+
     // In order to pick the next smallest value, we need each child work(...) until it produces
     // a result.  This is the queue of children that haven't given us a result yet.
     std::queue<PlanStage*> _noResultToMerge;
@@ -153,7 +177,7 @@ private:
 // Parameters that must be provided to a MergeSortStage
 class MergeSortStageParams {
 public:
-    MergeSortStageParams() : collator(NULL), dedup(true) {}
+    MergeSortStageParams() : collator(NULL), dedup(true), singleSortKeyPerRecord(false) {}
 
     // How we're sorting.
     BSONObj pattern;
@@ -164,6 +188,10 @@ public:
 
     // Do we deduplicate on RecordId?
     bool dedup;
+
+    // Does each child produce a record under the same sort key, if at all? Deduplication then
+    // only needs to remember the records whose sort key hasn't been passed yet.
+    bool singleSortKeyPerRecord;
 };
 
 }  // namespace mongo
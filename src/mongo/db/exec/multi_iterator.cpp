@@ -62,6 +62,9 @@ PlanStage::StageState MultiIteratorStage::doWork(WorkingSetID* out) {
         return PlanStage::DEAD;
     }
 
+    // An iterator may be about to move, so the document we returned last can't stay borrowed.
+    WorkingSetCommon::ownObjIfStillInUse(_ws, &_borrowedId);
+
     boost::optional<Record> record;
     try {
         while (!_iterators.empty()) {
@@ -93,6 +96,7 @@ PlanStage::StageState MultiIteratorStage::doWork(WorkingSetID* out) {
     member->recordId = record->id;
     member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(), record->data.releaseToBson()};
     _ws->transitionToRecordIdAndObj(*out);
+    _borrowedId = *out;
     return PlanStage::ADVANCED;
 }
 
@@ -101,11 +105,13 @@ bool MultiIteratorStage::isEOF() {
 }
 
 void MultiIteratorStage::kill() {
+    WorkingSetCommon::ownObjIfStillInUse(_ws, &_borrowedId);
     _collection = NULL;
     _iterators.clear();
 }
 
 void MultiIteratorStage::doSaveState() {
+    WorkingSetCommon::ownObjIfStillInUse(_ws, &_borrowedId);
     for (auto&& iterator : _iterators) {
         iterator->save();
     }
@@ -90,6 +90,10 @@ private:
     // all fetch requests. This should only be used for passing up the Fetcher for a NEED_YIELD, and
     // should remain in the INVALID state.
     const WorkingSetID _wsidForFetch;
+
+    // The last member we returned, whose document may point into the buffer of one of
+    // _iterators until it moves.
+    WorkingSetID _borrowedId = WorkingSet::INVALID_ID;
 };
 
 }  // namespace mongo
@@ -40,11 +40,13 @@
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/detailed_stage_timer.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/plan_ranker.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -73,6 +75,7 @@ MultiPlanStage::MultiPlanStage(OperationContext* txn,
       _backupPlanIdx(kNoSuchPlan),
       _failure(false),
       _failureCount(0),
+      _prunedCount(0),
       _statusMemberId(WorkingSet::INVALID_ID) {
     invariant(_collection);
 }
@@ -205,13 +208,25 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     // execution work that happens here, so this is needed for the time accounting to
     // make sense.
     ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    ScopedDetailedStageTimer detailedTimer(getOpCtx(), &_commonStats);
+    const Date_t planningStart = getClock()->now();
 
     size_t numWorks = getTrialPeriodWorks(getOpCtx(), _collection);
     size_t numResults = getTrialPeriodNumToReturn(*_query);
 
+    // With many candidates, most of the trial period is spent on plans which are plainly losing.
+    // Once the first quarter of the trial is done, keep only the most promising candidates.
+    const size_t maxCandidates =
+        static_cast<size_t>(std::max(0, internalQueryPlanEvaluationMaxCandidates.load()));
+    const size_t pruneAfterWorks = numWorks / 4;
+
     // Work the plans, stopping when a plan hits EOF or returns some
     // fixed number of results.
     for (size_t ix = 0; ix < numWorks; ++ix) {
+        if (ix == pruneAfterWorks && pruneAfterWorks > 0 && maxCandidates > 0) {
+            pruneCandidates(maxCandidates);
+        }
+
         bool moreToDo = workAllPlans(numResults, yieldPolicy);
         if (!moreToDo) {
             break;
@@ -230,6 +245,9 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     _bestPlanIdx = PlanRanker::pickBestPlan(_candidates, ranking.get());
     verify(_bestPlanIdx >= 0 && _bestPlanIdx < static_cast<int>(_candidates.size()));
 
+    PlanCache* planCache = _collection->infoCache()->getPlanCache();
+    planCache->notePlanningTime(getClock()->now() - planningStart);
+
     // Copy candidate order. We will need this to sort candidate stats for explain
     // after transferring ownership of 'ranking' to plan cache.
     std::vector<size_t> candidateOrder = ranking->candidateOrder;
@@ -323,19 +341,55 @@ Status MultiPlanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
         }
 
         if (validSolutions) {
-            _collection->infoCache()->getPlanCache()->add(*_query, solutions, ranking.release());
+            planCache->add(*_query, solutions, ranking.release());
         }
     }
 
     return Status::OK();
 }
 
+void MultiPlanStage::pruneCandidates(size_t maxCandidates) {
+    std::vector<std::pair<double, size_t>> scores;
+    for (size_t ix = 0; ix < _candidates.size(); ++ix) {
+        if (_candidates[ix].failed) {
+            continue;
+        }
+
+        std::unique_ptr<PlanStageStats> stats = _candidates[ix].root->getStats();
+        scores.push_back(std::make_pair(PlanRanker::scoreTree(stats.get()), ix));
+    }
+
+    if (scores.size() <= maxCandidates) {
+        return;
+    }
+
+    std::stable_sort(scores.begin(),
+                     scores.end(),
+                     [](const std::pair<double, size_t>& lhs,
+                        const std::pair<double, size_t>& rhs) { return lhs.first > rhs.first; });
+
+    for (size_t ix = maxCandidates; ix < scores.size(); ++ix) {
+        CandidatePlan& candidate = _candidates[scores[ix].second];
+        LOG(2) << "Pruning query plan with score " << scores[ix].first << ": "
+               << Explain::getPlanSummary(candidate.root);
+        candidate.pruned = true;
+        ++_prunedCount;
+    }
+}
+
+void MultiPlanStage::restorePrunedCandidates() {
+    for (auto&& candidate : _candidates) {
+        candidate.pruned = false;
+    }
+    _prunedCount = 0;
+}
+
 bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy) {
     bool doneWorking = false;
 
     for (size_t ix = 0; ix < _candidates.size(); ++ix) {
         CandidatePlan& candidate = _candidates[ix];
-        if (candidate.failed) {
+        if (candidate.failed || candidate.pruned) {
             continue;
         }
 
@@ -397,6 +451,12 @@ bool MultiPlanStage::workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolic
                 _failure = true;
                 return false;
             }
+
+            // Every plan which survived pruning has failed. Let the pruned plans back into the
+            // race rather than failing the query.
+            if (_failureCount + _prunedCount == _candidates.size()) {
+                restorePrunedCandidates();
+            }
         }
     }
 
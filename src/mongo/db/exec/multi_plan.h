@@ -167,6 +167,17 @@ private:
      */
     bool workAllPlans(size_t numResults, PlanYieldPolicy* yieldPolicy);
 
+    /**
+     * Scores the candidates which have not failed using the work done so far, and marks all but
+     * the 'maxCandidates' best of them as pruned so that workAllPlans() stops working them.
+     */
+    void pruneCandidates(size_t maxCandidates);
+
+    /**
+     * Clears the pruned flag on every candidate.
+     */
+    void restorePrunedCandidates();
+
     /**
      * Checks whether we need to perform either a timing-based yield or a yield for a document
      * fetch. If so, then uses 'yieldPolicy' to actually perform the yield.
@@ -217,6 +228,9 @@ private:
     // If everything fails during the plan competition, we can't pick one.
     size_t _failureCount;
 
+    // The number of candidates which were dropped from the trial period by pruneCandidates().
+    size_t _prunedCount;
+
     // if pickBestPlan fails, this is set to the wsid of the statusMember
     // returned by ::work()
     WorkingSetID _statusMemberId;
@@ -0,0 +1,706 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/parallel_collection_scan.h"
+
+#include <deque>
+#include <iterator>
+#include <unordered_set>
+#include <vector>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/record_fetcher.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+using std::unique_ptr;
+using std::vector;
+using stdx::make_unique;
+
+// static
+const char* ParallelCollectionScan::kStageType = "PARALLEL_COLLSCAN";
+
+namespace {
+
+// Each worker scans this many records between acquiring and releasing its locks.
+const size_t kRecordsPerBlock = 256;
+
+// The collection is divided into this many ranges per worker.
+const size_t kRangesPerWorker = 4;
+
+// Workers stop scanning while the documents waiting to be returned exceed this size.
+const size_t kMaxBufferedBytes = 16 * 1024 * 1024;
+
+// A sampling worker gives up once this many blocks in a row bring no new records.
+const size_t kMaxBlocksWithoutNewRecords = 4;
+
+// How long a yielded plan waits for its workers before checking for interrupts again.
+const Milliseconds kWaitForResultsTimeout(100);
+
+bool containsWhere(const MatchExpression* expr) {
+    if (MatchExpression::WHERE == expr->matchType()) {
+        return true;
+    }
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        if (containsWhere(expr->getChild(i))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+struct Range {
+    RecordId start;
+    RecordId end;
+};
+
+struct Result {
+    RecordId id;
+    BSONObj obj;
+};
+
+}  // namespace
+
+/**
+ * State shared between the stage and its worker threads. Workers keep it alive after the stage
+ * is destroyed, until they notice 'shuttingDown' and exit.
+ */
+struct ParallelCollectionScan::SharedState {
+    SharedState(const NamespaceString& nss,
+                const MatchExpression* filter,
+                std::vector<std::string> fieldSubset,
+                size_t randomSampleSize)
+        : nss(nss),
+          filter(filter),
+          fieldSubset(std::move(fieldSubset)),
+          randomSampleSize(randomSampleSize) {}
+
+    /**
+     * Runs on a worker thread until there are no ranges left to scan or the stage is destroyed.
+     */
+    void runWorker();
+
+    /**
+     * Scans 'range' one block of records at a time, queueing the documents that match the filter.
+     * Returns false if the worker should stop.
+     */
+    bool scanRange(OperationContext* txn, const Range& range);
+
+    /**
+     * Draws records from a random cursor one block at a time, queueing the ones not sampled yet,
+     * until the sample is complete or the cursor stops bringing new records. Returns false if the
+     * worker should stop without finishing its range.
+     */
+    bool sampleRandomly(OperationContext* txn);
+
+    /**
+     * Marks the start of a block of scanning, during which the worker uses 'filter'. Returns false
+     * if the stage is being destroyed, in which case the worker must not use 'filter'.
+     */
+    bool beginBlock();
+    void endBlock();
+
+    /**
+     * Waits, without holding any locks, until the queue has room and then queues 'results'.
+     * Returns false if the worker should stop.
+     */
+    bool queueResults(vector<Result> results, size_t bytes, size_t docsTested);
+
+    /**
+     * Like queueResults(), but only queues the records which are not part of the sample yet, up
+     * to the sample size. Sets 'newRecords' to how many it queued and 'sampleComplete' to whether
+     * the sample now has all of its records.
+     */
+    bool queueSample(vector<Result> results,
+                     size_t docsTested,
+                     size_t* newRecords,
+                     bool* sampleComplete);
+
+    /**
+     * Records that a worker finished scanning a range, with 'status' if it failed.
+     */
+    void finishRange(const Status& status);
+
+    /**
+     * Blocks the calling thread, which must not hold any locks, until results are available,
+     * every range has been scanned, or 'timeout' has elapsed.
+     */
+    void waitForResults(Milliseconds timeout);
+
+    const NamespaceString nss;
+
+    // Owned by the query solution, and only valid while the stage exists.
+    const MatchExpression* const filter;
+
+    // The top-level fields the rest of the plan needs, or empty if it needs whole documents.
+    const std::vector<std::string> fieldSubset;
+
+    // Zero unless the workers draw a random sample of this many records.
+    const size_t randomSampleSize;
+
+    stdx::mutex mutex;
+
+    // Signaled when results are queued, a range is finished or a worker fails.
+    stdx::condition_variable resultsAvailable;
+
+    // Signaled when results are removed from the queue or the stage is being destroyed.
+    stdx::condition_variable queueHasRoom;
+
+    // Signaled when the last worker in a block of scanning finishes it.
+    stdx::condition_variable blocksDone;
+
+    std::deque<Range> pendingRanges;
+    size_t rangesRemaining = 0;
+
+    std::deque<Result> results;
+    size_t bufferedBytes = 0;
+
+    // How many workers are in a block of scanning, and may be using 'filter'.
+    size_t activeBlocks = 0;
+
+    // How many records the workers have checked against the filter so far.
+    size_t docsTested = 0;
+
+    // The records queued so far when drawing a random sample.
+    std::unordered_set<RecordId, RecordId::Hasher> sampledRecords;
+
+    // The first error a worker ran into.
+    Status status = Status::OK();
+
+    bool shuttingDown = false;
+};
+
+void ParallelCollectionScan::SharedState::runWorker() {
+    auto txn = cc().makeOperationContext();
+
+    while (true) {
+        Range range;
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            if (shuttingDown || !status.isOK() || pendingRanges.empty()) {
+                return;
+            }
+            range = pendingRanges.front();
+            pendingRanges.pop_front();
+        }
+
+        // When sampling, each "range" is the sampling done by one worker.
+        if (!(randomSampleSize ? sampleRandomly(txn.get()) : scanRange(txn.get(), range))) {
+            return;
+        }
+        finishRange(Status::OK());
+    }
+}
+
+bool ParallelCollectionScan::SharedState::scanRange(OperationContext* txn, const Range& range) {
+    unique_ptr<RecordCursor> cursor;
+    bool exhausted = false;
+
+    while (!exhausted) {
+        vector<Result> blockResults;
+        size_t bytes = 0;
+        size_t blockDocsTested = 0;
+
+        try {
+            AutoGetCollection autoColl(txn, nss, MODE_IS);
+            if (!beginBlock()) {
+                return false;
+            }
+            ON_BLOCK_EXIT([&] { endBlock(); });
+
+            Collection* collection = autoColl.getCollection();
+            if (!collection) {
+                finishRange({ErrorCodes::NamespaceNotFound,
+                             str::stream() << "collection dropped during parallel scan: "
+                                           << nss.ns()});
+                return false;
+            }
+
+            if (!cursor) {
+                cursor = collection->getRecordStore()->getCursorForRange(
+                    txn, range.start, range.end);
+                if (!cursor) {
+                    // Only a single range covering the whole collection gets here.
+                    cursor = collection->getCursor(txn);
+                }
+                if (!fieldSubset.empty()) {
+                    cursor->restrictToFields(fieldSubset);
+                }
+            } else if (!cursor->restore()) {
+                finishRange({ErrorCodes::OperationFailed,
+                             str::stream() << "failed to restore parallel scan of " << nss.ns()});
+                return false;
+            }
+
+            while (blockDocsTested < kRecordsPerBlock) {
+                auto record = cursor->next();
+                if (!record) {
+                    exhausted = true;
+                    break;
+                }
+
+                ++blockDocsTested;
+                BSONObj obj = record->data.releaseToBson();
+                if (!filter || filter->matchesBSON(obj)) {
+                    bytes += obj.objsize();
+                    blockResults.push_back({record->id, obj.getOwned()});
+                }
+            }
+
+            cursor->save();
+        } catch (const WriteConflictException& wce) {
+            // The cursor resumes after the last record it returned, and the records before it were
+            // read in a valid snapshot, so keep what we have and retry from there.
+            if (cursor) {
+                cursor->save();
+            }
+        } catch (const DBException& ex) {
+            finishRange(ex.toStatus());
+            return false;
+        }
+
+        // Our locks are released, so a long wait for room in the queue blocks nobody else.
+        txn->recoveryUnit()->abandonSnapshot();
+        if (!queueResults(std::move(blockResults), bytes, blockDocsTested)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool ParallelCollectionScan::SharedState::sampleRandomly(OperationContext* txn) {
+    unique_ptr<RecordCursor> cursor;
+    size_t blocksWithoutNewRecords = 0;
+
+    while (blocksWithoutNewRecords < kMaxBlocksWithoutNewRecords) {
+        vector<Result> blockResults;
+        size_t blockDocsTested = 0;
+        bool exhausted = false;
+
+        try {
+            AutoGetCollection autoColl(txn, nss, MODE_IS);
+            if (!beginBlock()) {
+                return false;
+            }
+            ON_BLOCK_EXIT([&] { endBlock(); });
+
+            Collection* collection = autoColl.getCollection();
+            if (!collection) {
+                finishRange({ErrorCodes::NamespaceNotFound,
+                             str::stream() << "collection dropped during parallel sample: "
+                                           << nss.ns()});
+                return false;
+            }
+
+            if (!cursor) {
+                cursor = collection->getRecordStore()->getRandomCursor(txn);
+                if (!cursor) {
+                    finishRange({ErrorCodes::InternalError,
+                                 str::stream() << "no random cursor to sample " << nss.ns()});
+                    return false;
+                }
+                if (!fieldSubset.empty()) {
+                    cursor->restrictToFields(fieldSubset);
+                }
+            } else if (!cursor->restore()) {
+                finishRange({ErrorCodes::OperationFailed,
+                             str::stream() << "failed to restore parallel sample of "
+                                           << nss.ns()});
+                return false;
+            }
+
+            while (blockDocsTested < kRecordsPerBlock) {
+                auto record = cursor->next();
+                if (!record) {
+                    // Only an empty collection gets here.
+                    exhausted = true;
+                    break;
+                }
+
+                ++blockDocsTested;
+                blockResults.push_back({record->id, record->data.releaseToBson().getOwned()});
+            }
+
+            cursor->save();
+        } catch (const WriteConflictException& wce) {
+            // Whatever was drawn before the conflict is still a valid part of the sample.
+            if (cursor) {
+                cursor->save();
+            }
+        } catch (const DBException& ex) {
+            finishRange(ex.toStatus());
+            return false;
+        }
+
+        txn->recoveryUnit()->abandonSnapshot();
+        size_t newRecords;
+        bool sampleComplete;
+        if (!queueSample(std::move(blockResults), blockDocsTested, &newRecords, &sampleComplete)) {
+            return false;
+        }
+        if (sampleComplete || exhausted) {
+            return true;
+        }
+        blocksWithoutNewRecords = newRecords ? 0 : blocksWithoutNewRecords + 1;
+    }
+
+    return true;
+}
+
+bool ParallelCollectionScan::SharedState::beginBlock() {
+    stdx::lock_guard<stdx::mutex> lk(mutex);
+    if (shuttingDown || !status.isOK()) {
+        return false;
+    }
+    ++activeBlocks;
+    return true;
+}
+
+void ParallelCollectionScan::SharedState::endBlock() {
+    stdx::lock_guard<stdx::mutex> lk(mutex);
+    invariant(activeBlocks > 0);
+    if (--activeBlocks == 0) {
+        blocksDone.notify_all();
+    }
+}
+
+bool ParallelCollectionScan::SharedState::queueResults(vector<Result> blockResults,
+                                                       size_t bytes,
+                                                       size_t blockDocsTested) {
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    queueHasRoom.wait(lk, [&] {
+        return shuttingDown || !status.isOK() || bufferedBytes < kMaxBufferedBytes;
+    });
+    if (shuttingDown || !status.isOK()) {
+        return false;
+    }
+
+    docsTested += blockDocsTested;
+    if (blockResults.empty()) {
+        return true;
+    }
+
+    bufferedBytes += bytes;
+    std::move(blockResults.begin(), blockResults.end(), std::back_inserter(results));
+    resultsAvailable.notify_one();
+    return true;
+}
+
+bool ParallelCollectionScan::SharedState::queueSample(vector<Result> blockResults,
+                                                      size_t blockDocsTested,
+                                                      size_t* newRecords,
+                                                      bool* sampleComplete) {
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    queueHasRoom.wait(lk, [&] {
+        return shuttingDown || !status.isOK() || bufferedBytes < kMaxBufferedBytes;
+    });
+    if (shuttingDown || !status.isOK()) {
+        return false;
+    }
+
+    docsTested += blockDocsTested;
+    *newRecords = 0;
+    for (auto&& result : blockResults) {
+        if (sampledRecords.size() >= randomSampleSize) {
+            break;
+        }
+        if (!sampledRecords.insert(result.id).second) {
+            continue;
+        }
+        bufferedBytes += result.obj.objsize();
+        results.push_back(std::move(result));
+        ++*newRecords;
+    }
+    *sampleComplete = sampledRecords.size() >= randomSampleSize;
+
+    if (*newRecords) {
+        resultsAvailable.notify_one();
+    }
+    return true;
+}
+
+void ParallelCollectionScan::SharedState::finishRange(const Status& rangeStatus) {
+    stdx::lock_guard<stdx::mutex> lk(mutex);
+    invariant(rangesRemaining > 0);
+    --rangesRemaining;
+    if (!rangeStatus.isOK() && status.isOK()) {
+        status = rangeStatus;
+        // Unblock the other workers, which stop as soon as they see the error.
+        queueHasRoom.notify_all();
+    }
+    resultsAvailable.notify_one();
+}
+
+void ParallelCollectionScan::SharedState::waitForResults(Milliseconds timeout) {
+    stdx::unique_lock<stdx::mutex> lk(mutex);
+    resultsAvailable.wait_for(lk, timeout.toSystemDuration(), [&] {
+        return !results.empty() || rangesRemaining == 0 || !status.isOK();
+    });
+}
+
+/**
+ * Passed up with NEED_YIELD when no results are buffered. The PlanExecutor calls fetch() after
+ * releasing its locks, which is when we can wait for the workers.
+ */
+class ParallelCollectionScan::ResultWaiter final : public RecordFetcher {
+public:
+    explicit ResultWaiter(std::shared_ptr<SharedState> shared) : _shared(std::move(shared)) {}
+
+    void setup() final {}
+
+    void fetch() final {
+        _shared->waitForResults(kWaitForResultsTimeout);
+    }
+
+private:
+    const std::shared_ptr<SharedState> _shared;
+};
+
+ParallelCollectionScan::ParallelCollectionScan(OperationContext* txn,
+                                               const CollectionScanParams& params,
+                                               WorkingSet* workingSet,
+                                               const MatchExpression* filter,
+                                               size_t numWorkers,
+                                               size_t randomSampleSize)
+    : PlanStage(kStageType, txn),
+      _workingSet(workingSet),
+      _filter(filter),
+      _params(params),
+      _numWorkers(numWorkers),
+      _randomSampleSize(randomSampleSize),
+      _wsidForFetch(_workingSet->allocate()) {
+    invariant(_numWorkers > 0);
+    invariant(!_randomSampleSize || !_filter);
+    invariant(!_params.tailable);
+    invariant(_params.direction == CollectionScanParams::FORWARD);
+    invariant(_params.start.isNull());
+    invariant(_params.maxScan == 0);
+}
+
+ParallelCollectionScan::~ParallelCollectionScan() {
+    if (!_shared) {
+        return;
+    }
+
+    // Wait for the workers to stop using the filter. Workers waiting for locks or for room in the
+    // queue are not in a block and will exit once they see that we are shutting down.
+    stdx::unique_lock<stdx::mutex> lk(_shared->mutex);
+    _shared->shuttingDown = true;
+    _shared->queueHasRoom.notify_all();
+    _shared->blocksDone.wait(lk, [&] { return _shared->activeBlocks == 0; });
+}
+
+// static
+bool ParallelCollectionScan::canScanInParallel(OperationContext* txn,
+                                               const Collection* collection,
+                                               const MatchExpression* filter) {
+    if (!collection || collection->isCapped() || !supportsDocLocking()) {
+        return false;
+    }
+
+    if (txn->recoveryUnit()->isReadingFromMajorityCommittedSnapshot()) {
+        return false;
+    }
+
+    return !filter || !containsWhere(filter);
+}
+
+void ParallelCollectionScan::startWorkers() {
+    const Collection* collection = _params.collection;
+    const RecordStore* rs = collection->getRecordStore();
+
+    std::deque<Range> ranges;
+    std::unique_ptr<RecordCursor> cursor;
+    if (!_randomSampleSize) {
+        cursor = rs->getCursorForRange(getOpCtx(), RecordId(), RecordId::max());
+    }
+    if (_randomSampleSize) {
+        // Each worker samples on its own until the sample is complete.
+        ranges.resize(_numWorkers);
+    } else if (!cursor) {
+        // The record store can't position cursors in the middle of the collection, so one
+        // worker scans all of it. We still get to run the filter off this thread.
+        ranges.push_back({RecordId(), RecordId::max()});
+    } else {
+        const auto first = cursor->next();
+        const auto last = collection->getCursor(getOpCtx(), false)->next();
+        if (!first || !last) {
+            _commonStats.isEOF = true;
+            return;
+        }
+
+        // Divide [first, last] into ranges of about the same number of RecordIds. The last
+        // range is unbounded, so that it includes any records inserted during the scan.
+        const uint64_t span = static_cast<uint64_t>(last->id.repr() - first->id.repr()) + 1;
+        const uint64_t numRanges = std::min<uint64_t>(_numWorkers * kRangesPerWorker, span);
+        const uint64_t step = span / numRanges;
+        for (uint64_t i = 0; i < numRanges; ++i) {
+            RecordId start(first->id.repr() + static_cast<int64_t>(i * step));
+            RecordId end = (i + 1 == numRanges)
+                ? RecordId::max()
+                : RecordId(first->id.repr() + static_cast<int64_t>((i + 1) * step));
+            ranges.push_back({start, end});
+        }
+    }
+
+    _shared = std::make_shared<SharedState>(
+        collection->ns(), _filter, _params.fieldSubset, _randomSampleSize);
+    if (_randomSampleSize) {
+        _specificStats.sampleSize = _randomSampleSize;
+    } else {
+        _specificStats.ranges = ranges.size();
+    }
+
+    const size_t numWorkers = std::min(_numWorkers, ranges.size());
+    {
+        stdx::lock_guard<stdx::mutex> lk(_shared->mutex);
+        _shared->rangesRemaining = ranges.size();
+        _shared->pendingRanges = std::move(ranges);
+    }
+
+    for (size_t i = 0; i < numWorkers; ++i) {
+        try {
+            std::shared_ptr<SharedState> shared = _shared;
+            stdx::thread([shared] {
+                Client::initThread("parallelCollScan");
+                shared->runWorker();
+            }).detach();
+            ++_specificStats.workers;
+        } catch (const std::exception& ex) {
+            // Workers take ranges from a shared queue, so fewer workers still scan everything.
+            warning() << "failed to start parallel collection scan worker: " << ex.what();
+            if (0 == _specificStats.workers && i + 1 == numWorkers) {
+                stdx::lock_guard<stdx::mutex> lk(_shared->mutex);
+                _shared->status = {ErrorCodes::InternalError,
+                                   str::stream() << "failed to start parallel collection scan: "
+                                                 << ex.what()};
+            }
+        }
+    }
+}
+
+PlanStage::StageState ParallelCollectionScan::doWork(WorkingSetID* out) {
+    if (_commonStats.isEOF) {
+        return PlanStage::IS_EOF;
+    }
+
+    if (!_shared) {
+        try {
+            startWorkers();
+        } catch (const WriteConflictException& wce) {
+            *out = WorkingSet::INVALID_ID;
+            return PlanStage::NEED_YIELD;
+        }
+        return _commonStats.isEOF ? PlanStage::IS_EOF : PlanStage::NEED_TIME;
+    }
+
+    stdx::unique_lock<stdx::mutex> lk(_shared->mutex);
+    _specificStats.docsTested = _shared->docsTested;
+
+    if (!_shared->status.isOK()) {
+        *out = WorkingSetCommon::allocateStatusMember(_workingSet, _shared->status);
+        return PlanStage::FAILURE;
+    }
+
+    if (!_shared->results.empty()) {
+        Result result = std::move(_shared->results.front());
+        _shared->results.pop_front();
+        _shared->bufferedBytes -= result.obj.objsize();
+        _shared->queueHasRoom.notify_one();
+        lk.unlock();
+
+        WorkingSetID id = _workingSet->allocate();
+        WorkingSetMember* member = _workingSet->get(id);
+        member->recordId = result.id;
+        member->obj = {SnapshotId(), std::move(result.obj)};
+        _workingSet->transitionToRecordIdAndObj(id);
+        *out = id;
+        return PlanStage::ADVANCED;
+    }
+
+    if (_shared->rangesRemaining == 0) {
+        _commonStats.isEOF = true;
+        return PlanStage::IS_EOF;
+    }
+
+    // Nothing to return yet. Wait for the workers once our locks are released.
+    WorkingSetMember* member = _workingSet->get(_wsidForFetch);
+    member->setFetcher(new ResultWaiter(_shared));
+    *out = _wsidForFetch;
+    return PlanStage::NEED_YIELD;
+}
+
+bool ParallelCollectionScan::isEOF() {
+    return _commonStats.isEOF;
+}
+
+unique_ptr<PlanStageStats> ParallelCollectionScan::getStats() {
+    // Add a BSON representation of the filter to the stats tree, if there is one.
+    if (NULL != _filter) {
+        BSONObjBuilder bob;
+        _filter->serialize(&bob);
+        _commonStats.filter = bob.obj();
+    }
+
+    if (_shared) {
+        stdx::lock_guard<stdx::mutex> lk(_shared->mutex);
+        _specificStats.docsTested = _shared->docsTested;
+    }
+
+    unique_ptr<PlanStageStats> ret =
+        make_unique<PlanStageStats>(_commonStats, STAGE_PARALLEL_COLLSCAN);
+    ret->specific = make_unique<ParallelCollectionScanStats>(_specificStats);
+    return ret;
+}
+
+const SpecificStats* ParallelCollectionScan::getSpecificStats() const {
+    return &_specificStats;
+}
+
+}  // namespace mongo
@@ -0,0 +1,142 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/db/exec/collection_scan_common.h"
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/plan_stats.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/record_id.h"
+
+namespace mongo {
+
+class Collection;
+class OperationContext;
+class WorkingSet;
+
+/**
+ * Scans over a collection on several worker threads, each of which applies the filter to the
+ * records of a different range of RecordIds, and returns the matching documents in no particular
+ * order.
+ *
+ * The collection is divided into several ranges per worker, so that workers that finish early
+ * take over more of the scan. Each worker has its own Client and OperationContext. It takes its
+ * own intent locks, scans a block of records, and releases its locks again before handing the
+ * matching documents to this stage, so a worker never waits for this stage while holding locks.
+ * This stage only waits for its workers while its own locks are yielded, by passing a
+ * RecordFetcher up with NEED_YIELD.
+ *
+ * The stage may be destroyed while its executor holds locks, so it never waits for a worker that
+ * may be waiting for a lock. The workers share their state with the stage and exit on their own
+ * once the stage is gone.
+ *
+ * Documents are owned copies that carry their RecordId but no snapshot id, since the workers
+ * read in their own snapshots. Only use this for read-only plans run by a YIELD_AUTO executor;
+ * see canScanInParallel().
+ *
+ * If constructed with a non-zero 'randomSampleSize', the workers instead draw records from
+ * random cursors, and the stage returns up to that many distinct records in random order. The
+ * workers de-duplicate the records by RecordId as they hand them over. A worker stops early if
+ * several blocks in a row bring no new records, as when the collection holds fewer records than
+ * the sample size.
+ */
+class ParallelCollectionScan final : public PlanStage {
+public:
+    ParallelCollectionScan(OperationContext* txn,
+                           const CollectionScanParams& params,
+                           WorkingSet* workingSet,
+                           const MatchExpression* filter,
+                           size_t numWorkers,
+                           size_t randomSampleSize = 0);
+
+    ~ParallelCollectionScan();
+
+    /**
+     * Returns true if a scan of 'collection' with 'filter' can be divided between worker threads.
+     * This requires a storage engine with document-level locking, a collection that is not
+     * capped, a read that does not use a committed snapshot, and a filter that can be evaluated
+     * concurrently, which rules out $where.
+     */
+    static bool canScanInParallel(OperationContext* txn,
+                                  const Collection* collection,
+                                  const MatchExpression* filter);
+
+    StageState doWork(WorkingSetID* out) final;
+    bool isEOF() final;
+
+    StageType stageType() const final {
+        return STAGE_PARALLEL_COLLSCAN;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats() final;
+
+    const SpecificStats* getSpecificStats() const final;
+
+    static const char* kStageType;
+
+private:
+    class ResultWaiter;
+    struct SharedState;
+
+    /**
+     * Divides the collection into ranges and starts the worker threads. Sets EOF if the
+     * collection is empty. May throw WriteConflictException.
+     */
+    void startWorkers();
+
+    // WorkingSet is not owned by us.
+    WorkingSet* _workingSet;
+
+    // The filter is not owned by us. It is shared with the worker threads.
+    const MatchExpression* _filter;
+
+    const CollectionScanParams _params;
+
+    const size_t _numWorkers;
+
+    // Zero unless this stage draws a random sample rather than scanning the collection.
+    const size_t _randomSampleSize;
+
+    // Queues, counters and synchronization shared with the worker threads. Null until the first
+    // call to doWork().
+    std::shared_ptr<SharedState> _shared;
+
+    // We allocate a working set member with this id on construction of the stage. It gets used for
+    // all fetch requests. This should only be used for passing up the Fetcher for a NEED_YIELD, and
+    // should remain in the INVALID state.
+    const WorkingSetID _wsidForFetch;
+
+    // Stats
+    ParallelCollectionScanStats _specificStats;
+};
+
+}  // namespace mongo
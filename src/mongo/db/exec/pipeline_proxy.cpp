@@ -124,6 +124,7 @@ unique_ptr<PlanStageStats> PipelineProxyStage::getStats() {
 }
 
 boost::optional<BSONObj> PipelineProxyStage::getNextBson() {
+    DocumentArena::Scope arenaScope(_pipeline->getContext()->documentArena.get());
     if (boost::optional<Document> next = _pipeline->output()->getNext()) {
         if (_includeMetaData) {
             return next->toBsonWithMetaData();
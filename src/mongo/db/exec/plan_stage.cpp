@@ -32,6 +32,7 @@
 
 #include "mongo/db/exec/plan_stage.h"
 
+#include "mongo/db/exec/detailed_stage_timer.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/service_context.h"
@@ -41,19 +42,35 @@ namespace mongo {
 PlanStage::StageState PlanStage::work(WorkingSetID* out) {
     invariant(_opCtx);
     ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
-    ++_commonStats.works;
+    ScopedDetailedStageTimer detailedTimer(_opCtx, &_commonStats);
 
     StageState workResult = doWork(out);
+    recordWork(workResult);
+
+    return workResult;
+}
+
+PlanStage::StageState PlanStage::workBatch(size_t maxWorks,
+                                           std::vector<WorkingSetID>* results,
+                                           WorkingSetID* out) {
+    invariant(_opCtx);
+    invariant(maxWorks > 0);
+    ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    ScopedDetailedStageTimer detailedTimer(_opCtx, &_commonStats);
 
-    if (StageState::ADVANCED == workResult) {
+    return doWorkBatch(maxWorks, results, out);
+}
+
+void PlanStage::recordWork(StageState state) {
+    ++_commonStats.works;
+
+    if (StageState::ADVANCED == state) {
         ++_commonStats.advanced;
-    } else if (StageState::NEED_TIME == workResult) {
+    } else if (StageState::NEED_TIME == state) {
         ++_commonStats.needTime;
-    } else if (StageState::NEED_YIELD == workResult) {
+    } else if (StageState::NEED_YIELD == state) {
         ++_commonStats.needYield;
     }
-
-    return workResult;
 }
 
 void PlanStage::saveState() {
@@ -188,6 +188,20 @@ public:
      */
     StageState work(WorkingSetID* out);
 
+    /**
+     * Performs up to 'maxWorks' units of work, appending the result of every unit that returns
+     * ADVANCED to 'results'. A parent that can consume a block of results at a time uses this to
+     * pay the overhead of a call to work() once per block rather than once per result.
+     *
+     * Stops as soon as a unit of work returns IS_EOF, NEED_YIELD, DEAD or FAILURE, and returns
+     * that state with *out set as work() would have set it. Otherwise returns the state of the
+     * last unit of work performed, which is ADVANCED or NEED_TIME.
+     *
+     * Results appended to 'results' are owned by the caller exactly as if they had been returned
+     * by work(), and must be consumed before acting upon the returned state.
+     */
+    StageState workBatch(size_t maxWorks, std::vector<WorkingSetID>* results, WorkingSetID* out);
+
     /**
      * Returns true if no more work can be done on the query / out of results.
      */
@@ -324,6 +338,50 @@ protected:
      */
     virtual StageState doWork(WorkingSetID* out) = 0;
 
+    /**
+     * Performs up to 'maxWorks' units of work. See comment at workBatch() above.
+     *
+     * The default implementation calls doWork() once per unit of work. Stages can override it to
+     * exchange blocks of results with their children; overrides must report every unit of work
+     * they perform through recordWork().
+     */
+    virtual StageState doWorkBatch(size_t maxWorks,
+                                   std::vector<WorkingSetID>* results,
+                                   WorkingSetID* out) {
+        return doWorkBatchWith(this, maxWorks, results, out);
+    }
+
+    /**
+     * Runs a batch by calling stage->doWork() up to 'maxWorks' times. Stages whose doWork() is
+     * final implement doWorkBatch() by passing themselves here, so that each unit of work is a
+     * direct call rather than a virtual one.
+     */
+    template <typename Stage>
+    StageState doWorkBatchWith(Stage* stage,
+                               size_t maxWorks,
+                               std::vector<WorkingSetID>* results,
+                               WorkingSetID* out) {
+        StageState state = NEED_TIME;
+        for (size_t works = 0; works < maxWorks; ++works) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            state = stage->doWork(&id);
+            recordWork(state);
+
+            if (ADVANCED == state) {
+                results->push_back(id);
+            } else if (NEED_TIME != state) {
+                *out = id;
+                break;
+            }
+        }
+        return state;
+    }
+
+    /**
+     * Updates the common stats for one unit of work that returned 'state'.
+     */
+    void recordWork(StageState state);
+
     /**
      * Saves any stage-specific state required to resume where it was if the underlying data
      * changes.
@@ -0,0 +1,218 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+//
+// This file contains tests for the batched execution protocol of mongo/db/exec/plan_stage.cpp
+//
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/db/exec/fetch.h"
+#include "mongo/db/exec/queued_data_stage.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/operation_context_noop.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/clock_source_mock.h"
+
+using namespace mongo;
+
+namespace {
+
+using std::unique_ptr;
+using std::vector;
+using stdx::make_unique;
+
+class PlanStageBatchTest : public unittest::Test {
+public:
+    PlanStageBatchTest() {
+        _service = stdx::make_unique<ServiceContextNoop>();
+        _service.get()->setFastClockSource(stdx::make_unique<ClockSourceMock>());
+        _client = _service.get()->makeClient("test");
+        _opCtxNoop.reset(new OperationContextNoop(_client.get(), 0));
+        _opCtx = _opCtxNoop.get();
+    }
+
+protected:
+    OperationContext* getOpCtx() {
+        return _opCtx;
+    }
+
+    /**
+     * Queues a result that already holds the document {a: value}, so that a FetchStage above the
+     * queue has nothing to read from a collection.
+     */
+    void pushObj(QueuedDataStage* stage, int value) {
+        WorkingSetID id = _ws.allocate();
+        WorkingSetMember* member = _ws.get(id);
+        member->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("a" << value));
+        _ws.transitionToOwnedObj(id);
+        stage->pushBack(id);
+    }
+
+    int valueOf(WorkingSetID id) {
+        return _ws.get(id)->obj.value()["a"].numberInt();
+    }
+
+    WorkingSet _ws;
+
+private:
+    OperationContext* _opCtx;
+
+    // Members of a class are destroyed in reverse order of declaration.
+    // The UniqueClient must be destroyed before the ServiceContextNoop is destroyed.
+    // The OperationContextNoop must be destroyed before the UniqueClient is destroyed.
+    std::unique_ptr<ServiceContextNoop> _service;
+    ServiceContext::UniqueClient _client;
+    std::unique_ptr<OperationContextNoop> _opCtxNoop;
+};
+
+//
+// A stage without a batched implementation performs one unit of work per result.
+//
+TEST_F(PlanStageBatchTest, DefaultBatchStopsAfterMaxWorks) {
+    auto queue = make_unique<QueuedDataStage>(getOpCtx(), &_ws);
+    pushObj(queue.get(), 1);
+    queue->pushBack(PlanStage::NEED_TIME);
+    pushObj(queue.get(), 2);
+    pushObj(queue.get(), 3);
+
+    vector<WorkingSetID> results;
+    WorkingSetID out = WorkingSet::INVALID_ID;
+    ASSERT_EQUALS(PlanStage::ADVANCED, queue->workBatch(3, &results, &out));
+    ASSERT_EQUALS(2U, results.size());
+    ASSERT_EQUALS(1, valueOf(results[0]));
+    ASSERT_EQUALS(2, valueOf(results[1]));
+
+    const CommonStats* stats = queue->getCommonStats();
+    ASSERT_EQUALS(3U, stats->works);
+    ASSERT_EQUALS(2U, stats->advanced);
+    ASSERT_EQUALS(1U, stats->needTime);
+
+    results.clear();
+    ASSERT_EQUALS(PlanStage::IS_EOF, queue->workBatch(3, &results, &out));
+    ASSERT_EQUALS(1U, results.size());
+    ASSERT_EQUALS(3, valueOf(results[0]));
+}
+
+//
+// A batch ends as soon as a stage asks to yield, keeping the results produced before that.
+//
+TEST_F(PlanStageBatchTest, DefaultBatchStopsAtYield) {
+    auto queue = make_unique<QueuedDataStage>(getOpCtx(), &_ws);
+    pushObj(queue.get(), 1);
+    queue->pushBack(PlanStage::NEED_YIELD);
+    pushObj(queue.get(), 2);
+
+    vector<WorkingSetID> results;
+    WorkingSetID out = WorkingSet::INVALID_ID;
+    ASSERT_EQUALS(PlanStage::NEED_YIELD, queue->workBatch(10, &results, &out));
+    ASSERT_EQUALS(1U, results.size());
+    ASSERT_EQUALS(WorkingSet::INVALID_ID, out);
+    ASSERT_EQUALS(1U, queue->getCommonStats()->needYield);
+
+    results.clear();
+    ASSERT_EQUALS(PlanStage::IS_EOF, queue->workBatch(10, &results, &out));
+    ASSERT_EQUALS(1U, results.size());
+    ASSERT_EQUALS(2, valueOf(results[0]));
+}
+
+//
+// A FetchStage pulls a block from its child and returns the same results in the same order
+// as it would through work().
+//
+TEST_F(PlanStageBatchTest, FetchStagePullsBlocksFromChild) {
+    auto queue = make_unique<QueuedDataStage>(getOpCtx(), &_ws);
+    for (int i = 0; i < 10; ++i) {
+        pushObj(queue.get(), i);
+    }
+    QueuedDataStage* child = queue.get();
+    auto fetch = make_unique<FetchStage>(getOpCtx(), &_ws, queue.release(), nullptr, nullptr);
+
+    vector<WorkingSetID> results;
+    WorkingSetID out = WorkingSet::INVALID_ID;
+    ASSERT_EQUALS(PlanStage::ADVANCED, fetch->workBatch(4, &results, &out));
+    ASSERT_EQUALS(4U, results.size());
+    ASSERT_EQUALS(4U, child->getCommonStats()->works);
+
+    // The rest can still be read one at a time.
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    ASSERT_EQUALS(PlanStage::ADVANCED, fetch->work(&id));
+    ASSERT_EQUALS(4, valueOf(id));
+
+    while (!fetch->isEOF()) {
+        PlanStage::StageState state = fetch->workBatch(4, &results, &out);
+        ASSERT(PlanStage::ADVANCED == state || PlanStage::IS_EOF == state);
+    }
+    ASSERT_EQUALS(9U, results.size());
+    for (size_t i = 0; i < 4; ++i) {
+        ASSERT_EQUALS(static_cast<int>(i), valueOf(results[i]));
+    }
+    for (size_t i = 4; i < results.size(); ++i) {
+        ASSERT_EQUALS(static_cast<int>(i) + 1, valueOf(results[i]));
+    }
+
+    const CommonStats* stats = fetch->getCommonStats();
+    ASSERT_EQUALS(10U, stats->advanced);
+    ASSERT_EQUALS(10U, static_cast<const FetchStats*>(fetch->getSpecificStats())->alreadyHasObj);
+}
+
+//
+// When the child's block ends with a request to yield, FetchStage first returns the results of
+// the block and only then passes the yield request up.
+//
+TEST_F(PlanStageBatchTest, FetchStageDefersChildYield) {
+    auto queue = make_unique<QueuedDataStage>(getOpCtx(), &_ws);
+    pushObj(queue.get(), 1);
+    pushObj(queue.get(), 2);
+    queue->pushBack(PlanStage::NEED_YIELD);
+    pushObj(queue.get(), 3);
+    auto fetch = make_unique<FetchStage>(getOpCtx(), &_ws, queue.release(), nullptr, nullptr);
+
+    vector<WorkingSetID> results;
+    WorkingSetID out = WorkingSet::INVALID_ID;
+    ASSERT_EQUALS(PlanStage::ADVANCED, fetch->workBatch(1, &results, &out));
+    ASSERT_EQUALS(1U, results.size());
+    ASSERT_FALSE(fetch->isEOF());
+
+    ASSERT_EQUALS(PlanStage::NEED_YIELD, fetch->workBatch(10, &results, &out));
+    ASSERT_EQUALS(2U, results.size());
+    ASSERT_EQUALS(WorkingSet::INVALID_ID, out);
+
+    ASSERT_EQUALS(PlanStage::IS_EOF, fetch->workBatch(10, &results, &out));
+    ASSERT_EQUALS(3U, results.size());
+    ASSERT_EQUALS(3, valueOf(results[2]));
+    ASSERT_TRUE(fetch->isEOF());
+}
+
+}  // namespace
@@ -65,6 +65,11 @@ struct CommonStats {
           needTime(0),
           needYield(0),
           executionTimeMillis(0),
+          detailedStats(false),
+          executionTimeNanos(0),
+          cpuTimeNanos(0),
+          diskBytesRead(0),
+          majorPageFaults(0),
           isEOF(false) {}
     // String giving the type of the stage. Not owned.
     const char* stageTypeStr;
@@ -87,6 +92,16 @@ struct CommonStats {
     // Time elapsed while working inside this stage.
     long long executionTimeMillis;
 
+    // Set when the fields below were collected, which ScopedDetailedStageTimer only does when
+    // asked to. Like executionTimeMillis, they include the work done by the stage's children.
+    bool detailedStats;
+    long long executionTimeNanos;
+    long long cpuTimeNanos;
+    // Bytes the thread read from disk, rather than from the filesystem cache, while working in the
+    // stage. Storage engine cache hits don't reach the filesystem at all.
+    long long diskBytesRead;
+    long long majorPageFaults;
+
     // TODO: have some way of tracking WSM sizes (or really any series of #s).  We can measure
     // the size of our inputs and the size of our outputs.  We can do a lot with the WS here.
 
@@ -138,7 +153,12 @@ private:
 };
 
 struct AndHashStats : public SpecificStats {
-    AndHashStats() : flaggedButPassed(0), flaggedInProgress(0), memUsage(0), memLimit(0) {}
+    AndHashStats()
+        : flaggedButPassed(0),
+          flaggedInProgress(0),
+          bloomFilterRejects(0),
+          memUsage(0),
+          memLimit(0) {}
 
     SpecificStats* clone() const final {
         AndHashStats* specific = new AndHashStats(*this);
@@ -160,6 +180,10 @@ struct AndHashStats : public SpecificStats {
     // mapAfterChild[mapAfterChild.size() - 1] WSMswere match tested.
     // commonstats.advanced is how many passed.
 
+    // How many RecordIds from children after the first were ruled out by the Bloom filter
+    // without probing the hash table?
+    size_t bloomFilterRejects;
+
     // What's our current memory usage?
     size_t memUsage;
 
@@ -183,13 +207,16 @@ struct AndSortedStats : public SpecificStats {
 };
 
 struct CachedPlanStats : public SpecificStats {
-    CachedPlanStats() : replanned(false) {}
+    CachedPlanStats() : replanned(false), backgroundReplanScheduled(false) {}
 
     SpecificStats* clone() const final {
         return new CachedPlanStats(*this);
     }
 
     bool replanned;
+
+    // True if this query handed replanning over to the PlanCacheReplanner.
+    bool backgroundReplanScheduled;
 };
 
 struct CollectionScanStats : public SpecificStats {
@@ -486,6 +513,27 @@ struct OrStats : public SpecificStats {
     size_t recordIdsForgotten;
 };
 
+struct ParallelCollectionScanStats : public SpecificStats {
+    ParallelCollectionScanStats() : docsTested(0), workers(0), ranges(0), sampleSize(0) {}
+
+    SpecificStats* clone() const final {
+        ParallelCollectionScanStats* specific = new ParallelCollectionScanStats(*this);
+        return specific;
+    }
+
+    // How many documents did the worker threads check against our filter?
+    size_t docsTested;
+
+    // How many worker threads scanned the collection?
+    size_t workers;
+
+    // How many ranges of RecordIds was the collection divided into?
+    size_t ranges;
+
+    // If non-zero, the workers drew a random sample of up to this many records instead.
+    size_t sampleSize;
+};
+
 struct ProjectionStats : public SpecificStats {
     ProjectionStats() {}
 
@@ -499,7 +547,7 @@ struct ProjectionStats : public SpecificStats {
 };
 
 struct SortStats : public SpecificStats {
-    SortStats() : forcedFetches(0), memUsage(0), memLimit(0) {}
+    SortStats() : forcedFetches(0), memUsage(0), memLimit(0), spills(0) {}
 
     SpecificStats* clone() const final {
         SortStats* specific = new SortStats(*this);
@@ -515,6 +563,9 @@ struct SortStats : public SpecificStats {
     // What's our memory limit?
     size_t memLimit;
 
+    // How many times was sorted data written to disk? Only an external sort spills.
+    size_t spills;
+
     // The number of results to return from the sort.
     size_t limit;
 
@@ -523,7 +574,7 @@ struct SortStats : public SpecificStats {
 };
 
 struct MergeSortStats : public SpecificStats {
-    MergeSortStats() : dupsTested(0), dupsDropped(0), forcedFetches(0) {}
+    MergeSortStats() : dupsTested(0), dupsDropped(0), dedupPrunes(0), forcedFetches(0) {}
 
     SpecificStats* clone() const final {
         MergeSortStats* specific = new MergeSortStats(*this);
@@ -533,6 +584,10 @@ struct MergeSortStats : public SpecificStats {
     size_t dupsTested;
     size_t dupsDropped;
 
+    // How many times were the records remembered for deduplication forgotten because the sort
+    // key had moved past them?
+    size_t dedupPrunes;
+
     // How many records were we forced to fetch as the result of an invalidation?
     size_t forcedFetches;
 
@@ -562,6 +617,20 @@ struct SkipStats : public SpecificStats {
     size_t skip;
 };
 
+struct UnpackBucketStats : public SpecificStats {
+    UnpackBucketStats() : bucketsUnpacked(0), measurementsUnpacked(0) {}
+
+    SpecificStats* clone() const final {
+        UnpackBucketStats* specific = new UnpackBucketStats(*this);
+        return specific;
+    }
+
+    size_t bucketsUnpacked;
+
+    // How many measurements did the buckets hold, whether or not they matched the filter?
+    size_t measurementsUnpacked;
+};
+
 struct IntervalStats {
     // Number of results found in the covering of this interval.
     long long numResultsBuffered = 0;
@@ -588,6 +657,9 @@ struct NearStats : public SpecificStats {
     // btree index version, not geo index version
     int indexVersion;
     BSONObj keyPattern;
+    // True if a 2dsphere search sized its first annulus from the index's shared density
+    // estimates rather than by probing the index.
+    bool usedDensityGrid = false;
 };
 
 struct UpdateStats : public SpecificStats {
@@ -668,6 +740,14 @@ struct TextOrStats : public SpecificStats {
     }
 
     size_t fetches;
+
+    // The number of highest scoring documents the stage was asked for, or 0 if it returns every
+    // matching document.
+    size_t topK = 0;
+
+    // Whether the stage stopped reading the index once no unread document could score higher
+    // than the 'topK' documents it had found.
+    bool stoppedEarly = false;
 };
 
 }  // namespace mongo
@@ -61,6 +61,15 @@ Status addSortKeyMetaProj(StringData fieldName,
     return Status::OK();
 }
 
+/**
+ * Returns the bit which represents 'fieldName' in ProjectionExec's copy plan filter.
+ */
+uint64_t copyPlanFilterBit(StringData fieldName) {
+    const size_t hash =
+        fieldName.size() * 31 + (fieldName.empty() ? 0 : static_cast<unsigned char>(fieldName[0]));
+    return 1ULL << (hash % 64);
+}
+
 }  // namespace
 
 ProjectionExec::ProjectionExec()
@@ -175,6 +184,8 @@ ProjectionExec::ProjectionExec(const BSONObj& spec,
             _arrayOpType = ARRAY_OP_POSITIONAL;
         }
     }
+
+    compileCopyPlan();
 }
 
 ProjectionExec::~ProjectionExec() {
@@ -228,6 +239,52 @@ void ProjectionExec::add(const string& field, int skip, int limit) {
     }
 }
 
+void ProjectionExec::compileCopyPlan() {
+    if (_special || _hasReturnKey || ARRAY_OP_NORMAL != _arrayOpType || !_matchers.empty()) {
+        return;
+    }
+
+    std::vector<CopyStep> plan;
+    auto addStep = [&plan](StringData fieldName, CopyStep::Action action) {
+        for (auto&& step : plan) {
+            if (step.fieldName == fieldName) {
+                return;
+            }
+        }
+        plan.push_back({fieldName.toString(), action});
+    };
+
+    // Steps are added in the order in which transform() and append() give each kind of field
+    // precedence: the _id, then $meta fields, then projected fields.
+    addStep("_id", _includeID ? CopyStep::kCopy : CopyStep::kSkip);
+    for (auto&& meta : _meta) {
+        addStep(meta.first, CopyStep::kSkip);
+    }
+    for (auto&& field : _fields) {
+        const ProjectionExec& subfm = *field.second;
+        if (subfm._fields.empty()) {
+            addStep(field.first, subfm._include ? CopyStep::kCopy : CopyStep::kSkip);
+        } else {
+            // Dotted fields are projected by append(), which builds the sub-object.
+            addStep(field.first, CopyStep::kDescend);
+        }
+    }
+
+    // Names are matched by a linear search, which only beats the interpreter's hash lookups for
+    // projections of a few fields.
+    if (plan.size() > 64) {
+        return;
+    }
+
+    for (size_t i = 0; i < plan.size(); ++i) {
+        _copyPlanFilter |= copyPlanFilterBit(plan[i].fieldName);
+        if (!_include && CopyStep::kSkip != plan[i].action) {
+            _copyPlanOutputMask |= 1ULL << i;
+        }
+    }
+    _copyPlan = std::move(plan);
+}
+
 //
 // Execution
 //
@@ -373,6 +430,10 @@ Status ProjectionExec::transform(WorkingSetMember* member) const {
 Status ProjectionExec::transform(const BSONObj& in,
                                  BSONObjBuilder* bob,
                                  const MatchDetails* details) const {
+    if (!_copyPlan.empty()) {
+        return transformWithCopyPlan(in, bob);
+    }
+
     const ArrayOpType& arrayOpType = _arrayOpType;
 
     BSONObjIterator it(in);
@@ -442,6 +503,59 @@ Status ProjectionExec::transform(const BSONObj& in,
     return Status::OK();
 }
 
+Status ProjectionExec::transformWithCopyPlan(const BSONObj& in, BSONObjBuilder* bob) const {
+    // The elements of 'in' which are being copied but have not been appended to 'bob' yet.
+    const char* runStart = nullptr;
+    size_t runSize = 0;
+    auto flushRun = [&]() {
+        if (runSize > 0) {
+            bob->bb().appendBuf(runStart, runSize);
+            runSize = 0;
+        }
+    };
+
+    uint64_t outputSeen = 0;
+    BSONObjIterator it(in);
+    while (it.more()) {
+        BSONElement elt = it.next();
+        const StringData fieldName = elt.fieldNameStringData();
+
+        CopyStep::Action action = _include ? CopyStep::kCopy : CopyStep::kSkip;
+        if (_copyPlanFilter & copyPlanFilterBit(fieldName)) {
+            for (size_t i = 0; i < _copyPlan.size(); ++i) {
+                if (_copyPlan[i].fieldName == fieldName) {
+                    action = _copyPlan[i].action;
+                    outputSeen |= _copyPlanOutputMask & (1ULL << i);
+                    break;
+                }
+            }
+        }
+
+        if (CopyStep::kCopy == action) {
+            if (runStart + runSize != elt.rawdata()) {
+                flushRun();
+                runStart = elt.rawdata();
+            }
+            runSize += elt.size();
+        } else if (CopyStep::kDescend == action) {
+            flushRun();
+            Status status = append(bob, elt);
+            if (!status.isOK()) {
+                return status;
+            }
+        }
+
+        // An inclusion projection has nothing left to output once every field it includes has
+        // been found, since field names are unique within a document.
+        if (_copyPlanOutputMask && outputSeen == _copyPlanOutputMask) {
+            break;
+        }
+    }
+    flushRun();
+
+    return Status::OK();
+}
+
 void ProjectionExec::appendArray(BSONObjBuilder* bob, const BSONObj& array, bool nested) const {
     int skip = nested ? 0 : _skip;
     int limit = nested ? -1 : _limit;
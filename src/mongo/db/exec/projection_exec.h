@@ -95,6 +95,12 @@ private:
      */
     void add(const std::string& field, int skip, int limit);
 
+    /**
+     * If this projection has no array operators, $slice or returnKey, flattens its top level into
+     * '_copyPlan' so that transform() can apply it with a single pass over each document.
+     */
+    void compileCopyPlan();
+
     //
     // Execution
     //
@@ -128,6 +134,12 @@ private:
                   const MatchDetails* details = NULL,
                   const ArrayOpType arrayOpType = ARRAY_OP_NORMAL) const;
 
+    /**
+     * Applies '_copyPlan' to 'in'. Each run of adjacent elements copied from 'in' is appended to
+     * 'bob' with one buffer copy.
+     */
+    Status transformWithCopyPlan(const BSONObj& in, BSONObjBuilder* bob) const;
+
     /**
      * Like append, but for arrays.
      * Deals with slice and calls appendArray to preserve the array-ness.
@@ -184,6 +196,26 @@ private:
     // that perform matching (e.g. elemMatch projection). If null, the collation is a simple binary
     // compare.
     const CollatorInterface* _collator = nullptr;
+
+    // What to do with one top-level field of the input document when applying the copy plan.
+    struct CopyStep {
+        enum Action { kCopy, kSkip, kDescend };
+
+        std::string fieldName;
+        Action action;
+    };
+
+    // The compiled form of a simple projection, or empty if the projection must be interpreted.
+    // Fields of the input which have no step are copied if '_include' is true.
+    std::vector<CopyStep> _copyPlan;
+
+    // One bit per field name length and first character in '_copyPlan', so that most fields which
+    // are not mentioned by the projection are rejected without comparing names.
+    uint64_t _copyPlanFilter = 0;
+
+    // The steps that produce output for an inclusion projection, as a bit per index in
+    // '_copyPlan'. Once all of them have been seen the rest of the input can be skipped.
+    uint64_t _copyPlanOutputMask = 0;
 };
 
 }  // namespace mongo
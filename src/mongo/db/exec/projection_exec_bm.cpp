@@ -0,0 +1,91 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/projection_exec.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Returns a document with an _id and 'numFields' other top-level fields named "f0", "f1", ...
+ */
+BSONObj makeWideDocument(int numFields) {
+    BSONObjBuilder bob;
+    bob.append("_id", 1);
+    for (int i = 0; i < numFields; ++i) {
+        bob.append("f" + std::to_string(i), BSON("x" << i << "y" << "value"));
+    }
+    return bob.obj();
+}
+
+void runProjection(benchmark::BenchmarkState& state, const BSONObj& spec, const BSONObj& doc) {
+    ProjectionExec exec(spec, nullptr, nullptr, ExtensionsCallbackNoop());
+    WorkingSetMember member;
+    while (state.keepRunning()) {
+        member.obj = Snapshotted<BSONObj>(SnapshotId(), doc);
+        member.transitionToOwnedObj();
+        invariantOK(exec.transform(&member));
+        benchmark::doNotOptimizeAway(member.obj.value());
+    }
+}
+
+MONGO_BENCHMARK(ProjectionInclusionSmallDocument) {
+    runProjection(state, fromjson("{a: 1, c: 1}"), fromjson("{_id: 1, a: 1, b: 'two', c: 3.5}"));
+}
+
+MONGO_BENCHMARK(ProjectionInclusionWideDocument) {
+    runProjection(state, fromjson("{f1: 1, f2: 1, f3: 1}"), makeWideDocument(100));
+}
+
+MONGO_BENCHMARK(ProjectionInclusionLastFieldsOfWideDocument) {
+    runProjection(state, fromjson("{_id: 0, f97: 1, f98: 1}"), makeWideDocument(100));
+}
+
+MONGO_BENCHMARK(ProjectionExclusionWideDocument) {
+    runProjection(state, fromjson("{f10: 0, f50: 0}"), makeWideDocument(100));
+}
+
+MONGO_BENCHMARK(ProjectionDottedInclusionWideDocument) {
+    runProjection(state, fromjson("{'f1.x': 1, f2: 1}"), makeWideDocument(100));
+}
+
+MONGO_BENCHMARK(ProjectionSliceSmallDocument) {
+    runProjection(state,
+                  fromjson("{f1: 1, arr: {$slice: 2}}"),
+                  BSON("_id" << 1 << "f1" << 1 << "arr" << BSON_ARRAY(1 << 2 << 3 << 4)));
+}
+
+}  // namespace
+}  // namespace mongo
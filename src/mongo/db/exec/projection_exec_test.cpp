@@ -176,6 +176,62 @@ BSONObj transformMetaSortKeyCovered(const BSONObj& sortKey,
     return wsm->obj.value();
 }
 
+//
+// Inclusion and exclusion
+//
+
+TEST(ProjectionExecTest, TransformInclusion) {
+    const char* s = "{_id: 1, a: 1, b: {c: 2, d: 3}, e: [4, 5], f: 6}";
+
+    testTransform("{a: 1}", "{}", s, true, "{_id: 1, a: 1}");
+    testTransform("{a: 1, f: 1}", "{}", s, true, "{_id: 1, a: 1, f: 6}");
+    testTransform("{f: 1, a: 1}", "{}", s, true, "{_id: 1, a: 1, f: 6}");
+    testTransform("{_id: 0, b: 1, e: 1}", "{}", s, true, "{b: {c: 2, d: 3}, e: [4, 5]}");
+    testTransform("{_id: 1, z: 1}", "{}", s, true, "{_id: 1}");
+    testTransform("{a: 1}", "{}", "{a: 1, _id: 1, b: 2}", true, "{a: 1, _id: 1}");
+    testTransform("{a: 1}", "{}", "{b: 1}", true, "{}");
+}
+
+TEST(ProjectionExecTest, TransformExclusion) {
+    const char* s = "{_id: 1, a: 1, b: {c: 2, d: 3}, e: [4, 5], f: 6}";
+
+    testTransform("{a: 0}", "{}", s, true, "{_id: 1, b: {c: 2, d: 3}, e: [4, 5], f: 6}");
+    testTransform("{a: 0, e: 0}", "{}", s, true, "{_id: 1, b: {c: 2, d: 3}, f: 6}");
+    testTransform("{_id: 0}", "{}", s, true, "{a: 1, b: {c: 2, d: 3}, e: [4, 5], f: 6}");
+    testTransform("{_id: 0, f: 0}", "{}", s, true, "{a: 1, b: {c: 2, d: 3}, e: [4, 5]}");
+    testTransform("{z: 0}", "{}", s, true, s);
+}
+
+TEST(ProjectionExecTest, TransformDottedInclusionAndExclusion) {
+    const char* s = "{_id: 1, a: 1, b: {c: 2, d: 3}, e: [{c: 4, d: 5}, 6], f: 7}";
+
+    testTransform("{'b.c': 1}", "{}", s, true, "{_id: 1, b: {c: 2}}");
+    testTransform("{'b.c': 1, f: 1}", "{}", s, true, "{_id: 1, b: {c: 2}, f: 7}");
+    testTransform("{'e.d': 1, a: 1}", "{}", s, true, "{_id: 1, a: 1, e: [{d: 5}]}");
+    testTransform(
+        "{'b.c': 0}", "{}", s, true, "{_id: 1, a: 1, b: {d: 3}, e: [{c: 4, d: 5}, 6], f: 7}");
+    testTransform("{'a.c': 1}", "{}", s, true, "{_id: 1}");
+    testTransform("{'a.c': 0}", "{}", s, true, s);
+}
+
+TEST(ProjectionExecTest, TransformInclusionWithMeta) {
+    // The document's own copy of a $meta field is replaced by the computed value.
+    testTransform("{a: 1, b: {$meta: 'textScore'}}",
+                  "{}",
+                  "{_id: 1, a: 'hello', b: -1, c: 2}",
+                  new mongo::TextScoreComputedData(100),
+                  nullptr,  // collator
+                  true,
+                  "{_id: 1, a: 'hello', b: 100}");
+    testTransform("{c: 0, b: {$meta: 'textScore'}}",
+                  "{}",
+                  "{_id: 1, a: 'hello', b: -1, c: 2}",
+                  new mongo::TextScoreComputedData(100),
+                  nullptr,  // collator
+                  true,
+                  "{_id: 1, a: 'hello', b: 100}");
+}
+
 //
 // position $
 //
@@ -35,8 +35,6 @@
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
-#include "mongo/db/s/collection_metadata.h"
-#include "mongo/s/shard_key_pattern.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
@@ -56,6 +54,10 @@ ShardFilterStage::ShardFilterStage(OperationContext* opCtx,
                                    PlanStage* child)
     : PlanStage(kStageType, opCtx), _ws(ws), _metadata(metadata) {
     _children.emplace_back(child);
+    if (_metadata) {
+        _shardKeyPattern.emplace(_metadata->getKeyPattern());
+        _keyFilter.emplace(_metadata.get());
+    }
 }
 
 ShardFilterStage::~ShardFilterStage() {}
@@ -77,10 +79,9 @@ PlanStage::StageState ShardFilterStage::doWork(WorkingSetID* out) {
         // including pending documents from in-progress migrations and orphaned documents from
         // aborted migrations
         if (_metadata) {
-            ShardKeyPattern shardKeyPattern(_metadata->getKeyPattern());
             WorkingSetMember* member = _ws->get(*out);
             WorkingSetMatchableDocument matchable(member);
-            BSONObj shardKey = shardKeyPattern.extractShardKeyFromMatchable(matchable);
+            BSONObj shardKey = _shardKeyPattern->extractShardKeyFromMatchable(matchable);
 
             if (shardKey.isEmpty()) {
                 // We can't find a shard key for this document - this should never happen with
@@ -107,7 +108,7 @@ PlanStage::StageState ShardFilterStage::doWork(WorkingSetID* out) {
                           << "document may have been inserted manually into shard";
             }
 
-            if (!_metadata->keyBelongsToMe(shardKey)) {
+            if (!_keyFilter->keyBelongsToMe(shardKey)) {
                 _ws->free(*out);
                 ++_specificStats.chunkSkips;
                 return PlanStage::NEED_TIME;
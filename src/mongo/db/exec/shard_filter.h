@@ -28,12 +28,14 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/s/collection_metadata.h"
+#include "mongo/s/shard_key_pattern.h"
 
 namespace mongo {
 
-class CollectionMetadata;
-
 /**
  * This stage drops documents that didn't belong to the shard we're executing on at the time of
  * construction. This matches the contract for sharded cursorids which guarantees that a
@@ -99,6 +101,10 @@ private:
     // Note: it is important that this is the metadata from the time this stage is constructed.
     // See class comment for details.
     const std::shared_ptr<CollectionMetadata> _metadata;
+
+    // Set if there is metadata.
+    boost::optional<ShardKeyPattern> _shardKeyPattern;
+    boost::optional<CollectionMetadata::KeyFilter> _keyFilter;
 };
 
 }  // namespace mongo
@@ -41,6 +41,7 @@
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/storage/storage_options.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
@@ -54,6 +55,51 @@ using stdx::make_unique;
 // static
 const char* SortStage::kStageType = "SORT";
 
+namespace {
+
+const char kSpilledRecordIdField[] = "r";
+const char kSpilledObjField[] = "o";
+
+/**
+ * Orders the (sort key, {r: <RecordId>, o: <document>}) pairs of an external sort the same way
+ * WorkingSetComparator orders the buffered data.
+ */
+class ExternalSortComparator {
+public:
+    explicit ExternalSortComparator(BSONObj pattern) : _pattern(std::move(pattern)) {}
+
+    int operator()(const std::pair<BSONObj, BSONObj>& lhs,
+                   const std::pair<BSONObj, BSONObj>& rhs) const {
+        // False means ignore field names.
+        int result = lhs.first.woCompare(rhs.first, _pattern, false);
+        if (0 != result) {
+            return result;
+        }
+        const long long lhsRecordId = lhs.second.firstElement()._numberLong();
+        const long long rhsRecordId = rhs.second.firstElement()._numberLong();
+        return lhsRecordId < rhsRecordId ? -1 : (lhsRecordId > rhsRecordId ? 1 : 0);
+    }
+
+private:
+    BSONObj _pattern;
+};
+
+/**
+ * Only the document and its sort key are written to disk, so a working set member with any
+ * other computed data, such as a text score, cannot be spilled.
+ */
+bool canSpill(const WorkingSetMember* member) {
+    for (int type = 0; type < WSM_COMPUTED_NUM_TYPES; ++type) {
+        if (WSM_SORT_KEY != type &&
+            member->hasComputed(static_cast<WorkingSetComputedDataType>(type))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
 SortStage::WorkingSetComparator::WorkingSetComparator(BSONObj p) : pattern(p) {}
 
 bool SortStage::WorkingSetComparator::operator()(const SortableDataItem& lhs,
@@ -76,6 +122,7 @@ SortStage::SortStage(OperationContext* opCtx,
       _ws(ws),
       _pattern(params.pattern),
       _limit(params.limit),
+      _allowDiskUse(params.allowDiskUse),
       _sorted(false),
       _resultIterator(_data.end()),
       _memUsage(0) {
@@ -97,12 +144,16 @@ SortStage::~SortStage() {}
 bool SortStage::isEOF() {
     // We're done when our child has no more results, we've sorted the child's results, and
     // we've returned all sorted results.
+    if (_externalIterator) {
+        return child()->isEOF() && _sorted && !_externalIterator->more();
+    }
     return child()->isEOF() && _sorted && (_data.end() == _resultIterator);
 }
 
 PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     const size_t maxBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes);
-    if (_memUsage > maxBytes) {
+    const bool overMemLimit = !_externalSorter && _memUsage > maxBytes;
+    if (overMemLimit && !(_allowDiskUse && !_sorted && switchToExternalSort())) {
         mongoutils::str::stream ss;
         ss << "Sort operation used more than the maximum " << maxBytes
            << " bytes of RAM. Add an index, or specify a smaller limit.";
@@ -148,10 +199,29 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
                 item.recordId = member->recordId;
             }
 
-            addToBuffer(item);
+            if (_externalSorter && canSpill(member)) {
+                addToExternalSorter(item);
+            } else if (_externalSorter) {
+                Status status(ErrorCodes::OperationFailed,
+                              "Sort operation cannot spill results with computed metadata to "
+                              "disk. Add an index, or specify a smaller limit.");
+                *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+                return PlanStage::FAILURE;
+            } else {
+                addToBuffer(item);
+            }
 
             return PlanStage::NEED_TIME;
         } else if (PlanStage::IS_EOF == code) {
+            if (_externalSorter) {
+                _externalIterator.reset(_externalSorter->done());
+                _specificStats.spills = _externalSorter->numFiles();
+                _externalSorter.reset();
+                _memUsage = 0;
+                _sorted = true;
+                return PlanStage::NEED_TIME;
+            }
+
             // TODO: We don't need the lock for this.  We could ask for a yield and do this work
             // unlocked.  Also, this is performing a lot of work for one call to work(...)
             sortBuffer();
@@ -178,6 +248,19 @@ PlanStage::StageState SortStage::doWork(WorkingSetID* out) {
     }
 
     // Returning results.
+    if (_externalIterator) {
+        ExternalSorter::Data next = _externalIterator->next();
+
+        // The RecordId is not restored, since this stage no longer tracks invalidations for it.
+        *out = _ws->allocate();
+        WorkingSetMember* member = _ws->get(*out);
+        member->obj =
+            Snapshotted<BSONObj>(SnapshotId(), next.second[kSpilledObjField].Obj().getOwned());
+        member->addComputed(new SortKeyComputedData(next.first));
+        _ws->transitionToOwnedObj(*out);
+        return PlanStage::ADVANCED;
+    }
+
     verify(_resultIterator != _data.end());
     verify(_sorted);
     *out = _resultIterator->wsid;
@@ -340,4 +423,59 @@ void SortStage::sortBuffer() {
     }
 }
 
+bool SortStage::switchToExternalSort() {
+    invariant(!_externalSorter);
+
+    std::vector<SortableDataItem> buffered;
+    if (_dataSet) {
+        buffered.assign(_dataSet->begin(), _dataSet->end());
+    } else {
+        buffered = _data;
+    }
+    for (const SortableDataItem& item : buffered) {
+        if (!canSpill(_ws->get(item.wsid))) {
+            return false;
+        }
+    }
+
+    SortOptions opts;
+    opts.limit = _limit;
+    opts.maxMemoryUsageBytes = static_cast<size_t>(internalQueryExecMaxBlockingSortBytes);
+    opts.extSortAllowed = true;
+    opts.tempDir = storageGlobalParams.dbpath + "/_tmp";
+    _externalSorter.reset(
+        ExternalSorter::make(opts, ExternalSortComparator(_sortKeyComparator->pattern)));
+
+    _data.clear();
+    if (_dataSet) {
+        _dataSet->clear();
+    }
+    for (const SortableDataItem& item : buffered) {
+        addToExternalSorter(item);
+    }
+
+    LOG(1) << "sort operation exceeded " << opts.maxMemoryUsageBytes
+           << " bytes of RAM, switching to external sort";
+    return true;
+}
+
+void SortStage::addToExternalSorter(const SortableDataItem& item) {
+    WorkingSetMember* member = _ws->get(item.wsid);
+    BSONObjBuilder spilled;
+    spilled.append(kSpilledRecordIdField, static_cast<long long>(item.recordId.repr()));
+    spilled.append(kSpilledObjField, member->obj.value());
+    _externalSorter->add(item.sortKey, spilled.obj());
+
+    if (member->hasRecordId()) {
+        _wsidByRecordId.erase(member->recordId);
+    }
+    _ws->free(item.wsid);
+
+    _memUsage = _externalSorter->memUsed();
+    _specificStats.spills = _externalSorter->numFiles();
+}
+
 }  // namespace mongo
+
+#include "mongo/db/sorter/sorter.cpp"
+// Explicit instantiation unneeded since we aren't exposing Sorter outside of this file.
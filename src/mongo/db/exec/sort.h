@@ -37,6 +37,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/sorter/sorter.h"
 #include "mongo/platform/unordered_map.h"
 
 namespace mongo {
@@ -46,7 +47,7 @@ class BtreeKeyGenerator;
 // Parameters that must be provided to a SortStage
 class SortStageParams {
 public:
-    SortStageParams() : collection(NULL), limit(0) {}
+    SortStageParams() : collection(NULL), limit(0), allowDiskUse(false) {}
 
     // Used for resolving RecordIds to BSON
     const Collection* collection;
@@ -56,6 +57,10 @@ public:
 
     // Equal to 0 for no limit.
     size_t limit;
+
+    // If true, data that does not fit in internalQueryExecMaxBlockingSortBytes is sorted
+    // externally, spilling to disk, instead of failing the query.
+    bool allowDiskUse;
 };
 
 /**
@@ -106,6 +111,8 @@ private:
     // Equal to 0 for no limit.
     size_t _limit;
 
+    bool _allowDiskUse;
+
     //
     // Data storage
     //
@@ -152,6 +159,18 @@ private:
      */
     void sortBuffer();
 
+    /**
+     * Moves the buffered data into an external sorter, which may spill it to disk, and from then
+     * on sends all data from the child to it instead of buffering. Returns false, leaving the
+     * buffered data in place, if any of it has computed data which would be lost by spilling.
+     */
+    bool switchToExternalSort();
+
+    /**
+     * Adds one item to the external sorter and frees its working set member.
+     */
+    void addToExternalSorter(const SortableDataItem& item);
+
     // Comparator for data buffer
     // Initialization follows sort key generator
     std::unique_ptr<WorkingSetComparator> _sortKeyComparator;
@@ -174,6 +193,16 @@ private:
     typedef unordered_map<RecordId, WorkingSetID, RecordId::Hasher> DataMap;
     DataMap _wsidByRecordId;
 
+    // Once the data outgrows the memory limit, it is sorted by _externalSorter instead of being
+    // buffered in _data or _dataSet. Each value holds a document and the RecordId it came from,
+    // keyed by its sort key. Spilled documents no longer receive invalidations, just as if they
+    // had been fetched and invalidated.
+    typedef Sorter<BSONObj, BSONObj> ExternalSorter;
+    std::unique_ptr<ExternalSorter> _externalSorter;
+
+    // Iterates through the results of the external sort once all data has been gathered.
+    std::unique_ptr<ExternalSorter::Iterator> _externalIterator;
+
     SortStats _specificStats;
 
     // The usage in bytes of all buffered data that we're sorting.
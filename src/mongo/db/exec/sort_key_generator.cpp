@@ -41,6 +41,7 @@
 #include "mongo/db/exec/working_set_computed_data.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/db/query/collation/collator_interface_caching.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -55,7 +56,8 @@ SortKeyGenerator::SortKeyGenerator(OperationContext* txn,
                                    const BSONObj& sortSpec,
                                    const BSONObj& queryObj,
                                    const CollatorInterface* collator)
-    : _collator(collator) {
+    : _cachingCollator(collator ? stdx::make_unique<CollatorInterfaceCaching>(collator) : nullptr),
+      _collator(_cachingCollator.get()) {
     _hasBounds = false;
     _sortHasMeta = false;
     _rawSortSpec = sortSpec;
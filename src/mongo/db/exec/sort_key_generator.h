@@ -85,6 +85,10 @@ private:
      */
     void getBoundsForSort(OperationContext* txn, const BSONObj& queryObj, const BSONObj& sortObj);
 
+    // Wraps the query's collator, if it has one, so that each distinct string's comparison key
+    // is computed only once however many documents share it.
+    const std::unique_ptr<CollatorInterface> _cachingCollator;
+
     const CollatorInterface* _collator;
 
     // The raw object in .sort()
@@ -33,6 +33,7 @@
 #include "mongo/db/exec/subplan.h"
 
 #include "mongo/client/dbclientinterface.h"
+#include "mongo/db/exec/detailed_stage_timer.h"
 #include "mongo/db/exec/multi_plan.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
@@ -288,6 +289,9 @@ Status SubplanStage::choosePlanForSubqueries(PlanYieldPolicy* yieldPolicy) {
     // This is the skeleton of index selections that is inserted into the cache.
     std::unique_ptr<PlanCacheIndexTree> cacheData(new PlanCacheIndexTree());
 
+    // The winning plans of the branches ranked so far, by the shape of the branch.
+    std::map<PlanCacheKey, std::unique_ptr<SolutionCacheData>> rankedShapes;
+
     for (size_t i = 0; i < _orExpression->numChildren(); ++i) {
         MatchExpression* orChild = _orExpression->getChild(i);
         BranchPlanningResult* branchResult = _branchResults[i];
@@ -307,7 +311,32 @@ Status SubplanStage::choosePlanForSubqueries(PlanYieldPolicy* yieldPolicy) {
                 return tagStatus;
             }
         } else {
-            // N solutions, rank them.
+            // N solutions. If an earlier branch of the same shape has already been ranked, the
+            // plan cache would hand its winner to this branch, so reuse it rather than ranking the
+            // same candidates again. This matters for $or queries with many similar clauses,
+            // which the plan cache can't help with since no branch is cached until all of them
+            // have been planned.
+            PlanCacheKey shapeKey;
+            const bool shapeIsCacheable =
+                PlanCache::shouldCacheQuery(*branchResult->canonicalQuery);
+            if (shapeIsCacheable) {
+                shapeKey = _collection->infoCache()->getPlanCache()->computeKey(
+                    *branchResult->canonicalQuery);
+                auto rankedShape = rankedShapes.find(shapeKey);
+                if (rankedShape != rankedShapes.end()) {
+                    LOG(5) << "Subplanner: reusing plan of an earlier branch for child " << i
+                           << " of " << _orExpression->numChildren();
+                    Status tagStatus = tagOrChildAccordingToCache(
+                        cacheData.get(), rankedShape->second.get(), orChild, _indexMap);
+                    if (!tagStatus.isOK()) {
+                        return tagStatus;
+                    }
+                    branchResult->plannedFromEarlierBranch = true;
+                    continue;
+                }
+            }
+
+            // Rank the solutions.
 
             // We already checked for zero solutions in planSubqueries(...).
             invariant(!branchResult->solutions.empty());
@@ -384,6 +413,10 @@ Status SubplanStage::choosePlanForSubqueries(PlanYieldPolicy* yieldPolicy) {
             }
 
             cacheData->children.push_back(bestSoln->cacheData->tree->clone());
+
+            if (shapeIsCacheable) {
+                rankedShapes[shapeKey].reset(bestSoln->cacheData->clone());
+            }
         }
     }
 
@@ -495,6 +528,7 @@ Status SubplanStage::pickBestPlan(PlanYieldPolicy* yieldPolicy) {
     // Adds the amount of time taken by pickBestPlan() to executionTimeMillis. There's lots of
     // work that happens here, so this is needed for the time accounting to make sense.
     ScopedTimer timer(getClock(), &_commonStats.executionTimeMillis);
+    ScopedDetailedStageTimer detailedTimer(getOpCtx(), &_commonStats);
 
     // Plan each branch of the $or.
     Status subplanningStatus = planSubqueries();
@@ -538,6 +572,10 @@ bool SubplanStage::branchPlannedFromCache(size_t i) const {
     return NULL != _branchResults[i]->cachedSolution.get();
 }
 
+bool SubplanStage::branchPlannedFromEarlierBranch(size_t i) const {
+    return _branchResults[i]->plannedFromEarlierBranch;
+}
+
 const SpecificStats* SubplanStage::getSpecificStats() const {
     return NULL;
 }
@@ -125,6 +125,12 @@ public:
      */
     bool branchPlannedFromCache(size_t i) const;
 
+    /**
+     * Returns true if the i-th branch reused the winning plan of an earlier branch of the same
+     * shape, rather than ranking its candidate plans again.
+     */
+    bool branchPlannedFromEarlierBranch(size_t i) const;
+
     /**
      * Provide access to the query solution for our composite solution. Does not relinquish
      * ownership.
@@ -155,6 +161,10 @@ private:
 
         // Query solutions resulting from planning the $or branch.
         OwnedPointerVector<QuerySolution> solutions;
+
+        // Set if the index tags were taken from the winner of an earlier branch with the same
+        // plan cache key, in which case 'solutions' were never ranked.
+        bool plannedFromEarlierBranch = false;
     };
 
     /**
@@ -113,6 +113,15 @@ unique_ptr<PlanStage> TextStage::buildTextTree(OperationContext* txn,
         textScorer->addChild(make_unique<IndexScan>(txn, ixparams, ws, nullptr));
     }
 
+    // Without negations, phrases, or case or diacritic sensitivity, every document found in the
+    // index for one of the terms matches the query. The highest scoring ones are then the results.
+    const auto& query = _params.query;
+    if (_params.topK && query.getNegatedTerms().empty() && query.getPositivePhr().empty() &&
+        query.getNegatedPhr().empty() && !query.getCaseSensitive() &&
+        !query.getDiacriticSensitive()) {
+        textScorer->enableTopK(_params.topK, query.getTermsForBounds());
+    }
+
     auto matcher =
         make_unique<TextMatchStage>(txn, std::move(textScorer), _params.query, _params.spec, ws);
 
@@ -62,6 +62,9 @@ struct TextStageParams {
 
     // The text query.
     FTSQueryImpl query;
+
+    // If non-zero, only the 'topK' documents with the highest text scores need to be returned.
+    size_t topK = 0;
 };
 
 /**
@@ -28,6 +28,7 @@
 
 #include "mongo/db/exec/text_or.h"
 
+#include <algorithm>
 #include <map>
 #include <vector>
 
@@ -37,6 +38,7 @@
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/exec/working_set_computed_data.h"
+#include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/matchable.h"
 #include "mongo/db/query/internal_plans.h"
@@ -73,6 +75,16 @@ void TextOrStage::addChild(unique_ptr<PlanStage> child) {
     _children.push_back(std::move(child));
 }
 
+void TextOrStage::enableTopK(size_t topK, const std::set<std::string>& terms) {
+    invariant(topK > 0);
+    invariant(terms.size() == _children.size());
+    _topK = topK;
+    _terms.assign(terms.begin(), terms.end());
+    _termScoreBounds.assign(_children.size(), -1);
+    _childExhausted.assign(_children.size(), false);
+    _specificStats.topK = topK;
+}
+
 bool TextOrStage::isEOF() {
     return _internalState == State::kDone;
 }
@@ -106,6 +118,9 @@ void TextOrStage::doInvalidate(OperationContext* txn, const RecordId& dl, Invali
         if (scoreIt == _scoreIterator) {
             _scoreIterator++;
         }
+        if (_topK) {
+            _topKScores.erase(std::make_pair(scoreIt->second.score, dl));
+        }
         _scores.erase(scoreIt);
     }
 }
@@ -191,8 +206,32 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
         _idRetrying = WorkingSet::INVALID_ID;
     }
 
-    if (PlanStage::ADVANCED == childState) {
+    if (PlanStage::ADVANCED == childState && _topK) {
+        StageState stageState = addTermTopK(id, out);
+        if (_idRetrying == WorkingSet::INVALID_ID) {
+            if (hasTopK()) {
+                _specificStats.stoppedEarly = true;
+                _scoreIterator = _scores.begin();
+                _internalState = State::kReturningResults;
+            } else {
+                nextChildTopK();
+            }
+        }
+        return stageState;
+    } else if (PlanStage::ADVANCED == childState) {
         return addTerm(id, out);
+    } else if (PlanStage::IS_EOF == childState && _topK) {
+        // No key the child has yet to read can raise the score of a document anymore.
+        _termScoreBounds[_currentChild] = 0;
+        _childExhausted[_currentChild] = true;
+        if (std::find(_childExhausted.begin(), _childExhausted.end(), false) ==
+            _childExhausted.end()) {
+            _scoreIterator = _scores.begin();
+            _internalState = State::kReturningResults;
+        } else {
+            nextChildTopK();
+        }
+        return PlanStage::NEED_TIME;
     } else if (PlanStage::IS_EOF == childState) {
         // Done with this child.
         ++_currentChild;
@@ -408,8 +447,91 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
         wsm = _ws->get(textRecordData->wsid);
     }
 
+    // Aggregate relevance score, term keys.
+    textRecordData->score += getTermScore(newKeyData.keyData);
+    return NEED_TIME;
+}
+
+PlanStage::StageState TextOrStage::addTermTopK(WorkingSetID wsid, WorkingSetID* out) {
+    WorkingSetMember* wsm = _ws->get(wsid);
+    invariant(wsm->getState() == WorkingSetMember::RID_AND_IDX);
+    invariant(1 == wsm->keyData.size());
+    const IndexKeyDatum newKeyData = wsm->keyData.back();  // copy to keep it around.
+    const double termScore = getTermScore(newKeyData.keyData);
+    _termScoreBounds[_currentChild] = termScore;
+
+    if (_seen.count(wsm->recordId)) {
+        // The document has been scored over every term already.
+        _ws->free(wsid);
+        return NEED_TIME;
+    }
+
+    bool shouldKeep = true;
+    bool wasDeleted = false;
+    try {
+        if (_filter) {
+            TextMatchableDocument tdoc(getOpCtx(),
+                                       newKeyData.indexKeyPattern,
+                                       newKeyData.keyData,
+                                       _ws,
+                                       wsid,
+                                       _recordCursor);
+            shouldKeep = _filter->matches(&tdoc);
+        }
+        if (shouldKeep && !wsm->hasObj()) {
+            shouldKeep = WorkingSetCommon::fetch(getOpCtx(), _ws, wsid, _recordCursor);
+            wasDeleted = !shouldKeep;
+        }
+    } catch (const WriteConflictException& wce) {
+        wsm->makeObjOwnedIfNeeded();
+        _idRetrying = wsid;
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    } catch (const TextMatchableDocument::DocumentDeletedException&) {
+        shouldKeep = false;
+        wasDeleted = true;
+    }
+
+    if (wasDeleted || wsm->hasObj()) {
+        ++_specificStats.fetches;
+    }
+
+    const RecordId recordId = wsm->recordId;
+    _seen.insert(recordId);
+    if (!shouldKeep) {
+        _ws->free(wsid);
+        return NEED_TIME;
+    }
+
+    // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we yield.
+    wsm->makeObjOwnedIfNeeded();
+
+    // With a single term, the key holds the score of the document.
+    const double score = (_terms.size() == 1) ? termScore : scoreDocument(*wsm);
+    if (_topKScores.size() == _topK) {
+        const auto lowest = _topKScores.begin();
+        if (score <= lowest->first) {
+            _ws->free(wsid);
+            return NEED_TIME;
+        }
+
+        const auto evicted = _scores.find(lowest->second);
+        invariant(evicted != _scores.end());
+        _ws->free(evicted->second.wsid);
+        _scores.erase(evicted);
+        _topKScores.erase(lowest);
+    }
+
+    TextRecordData* textRecordData = &_scores[recordId];
+    textRecordData->wsid = wsid;
+    textRecordData->score = score;
+    _topKScores.emplace(score, recordId);
+    return NEED_TIME;
+}
+
+double TextOrStage::getTermScore(const BSONObj& key) const {
     // Locate score within possibly compound key: {prefix,term,score,suffix}.
-    BSONObjIterator keyIt(newKeyData.keyData);
+    BSONObjIterator keyIt(key);
     for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
         keyIt.next();
     }
@@ -417,11 +539,46 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
     keyIt.next();  // Skip past 'term'.
 
     BSONElement scoreElement = keyIt.next();
-    double documentTermScore = scoreElement.number();
+    return scoreElement.number();
+}
 
-    // Aggregate relevance score, term keys.
-    textRecordData->score += documentTermScore;
-    return NEED_TIME;
+double TextOrStage::scoreDocument(const WorkingSetMember& wsm) const {
+    fts::TermFrequencyMap termScores;
+    _ftsSpec.scoreDocument(wsm.obj.value(), &termScores);
+
+    double score = 0;
+    for (auto&& term : _terms) {
+        const auto it = termScores.find(term);
+        if (it != termScores.end()) {
+            score += it->second;
+        }
+    }
+    return score;
+}
+
+bool TextOrStage::hasTopK() const {
+    if (_topKScores.size() < _topK) {
+        return false;
+    }
+
+    double threshold = 0;
+    for (double bound : _termScoreBounds) {
+        if (bound < 0) {
+            return false;
+        }
+        threshold += bound;
+    }
+    return _topKScores.begin()->first >= threshold;
+}
+
+void TextOrStage::nextChildTopK() {
+    for (size_t i = 1; i <= _children.size(); i++) {
+        const size_t child = (_currentChild + i) % _children.size();
+        if (!_childExhausted[child]) {
+            _currentChild = child;
+            return;
+        }
+    }
 }
 
 }  // namespace mongo
@@ -29,6 +29,8 @@
 #pragma once
 
 #include <memory>
+#include <set>
+#include <string>
 #include <vector>
 
 #include "mongo/db/catalog/collection.h"
@@ -37,6 +39,7 @@
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
+#include "mongo/platform/unordered_set.h"
 
 namespace mongo {
 
@@ -52,6 +55,11 @@ class OperationContext;
  * the positive terms in the search query, as well as their scores.
  *
  * The WorkingSetMembers returned are fetched and in the LOC_AND_OBJ state.
+ *
+ * Each child scans the index keys of one term in decreasing order of score. If the stage only has
+ * to return the 'topK' highest scoring documents, it reads the children in turn and scores each
+ * document it finds in full. Since no document it hasn't found yet can score more than the sum of
+ * the scores its children last read, it stops once its 'topK' lowest score reaches that sum.
  */
 class TextOrStage final : public PlanStage {
 public:
@@ -81,6 +89,13 @@ public:
 
     void addChild(unique_ptr<PlanStage> child);
 
+    /**
+     * Limits the results to the 'topK' highest scoring documents. 'terms' are the terms the
+     * children scan, in the order they were added. Every document they find must match the query.
+     * Must be called after the last addChild().
+     */
+    void enableTopK(size_t topK, const std::set<std::string>& terms);
+
     bool isEOF() final;
 
     StageState doWork(WorkingSetID* out) final;
@@ -120,6 +135,32 @@ private:
      */
     StageState addTerm(WorkingSetID wsid, WorkingSetID* out);
 
+    /**
+     * Variant of addTerm() used when only the '_topK' highest scoring documents are returned.
+     */
+    StageState addTermTopK(WorkingSetID wsid, WorkingSetID* out);
+
+    /**
+     * Returns the score of the term within the text index key 'key'.
+     */
+    double getTermScore(const BSONObj& key) const;
+
+    /**
+     * Returns the score of the fetched document in 'wsm' over all of the query terms.
+     */
+    double scoreDocument(const WorkingSetMember& wsm) const;
+
+    /**
+     * Returns true if no document the children haven't found yet can score higher than the
+     * '_topK' best documents found.
+     */
+    bool hasTopK() const;
+
+    /**
+     * Moves '_currentChild' to the next child which still has keys to read, in turn.
+     */
+    void nextChildTopK();
+
     /**
      * Worker for kReturningResults. Returns a wsm with RecordID and Score.
      */
@@ -152,6 +193,20 @@ private:
     ScoreMap _scores;
     ScoreMap::const_iterator _scoreIterator;
 
+    // The number of documents to return if non-zero, in which case '_scores' only holds the
+    // highest scoring documents found so far, ordered by '_topKScores'.
+    size_t _topK = 0;
+    std::vector<std::string> _terms;
+    std::set<std::pair<double, RecordId>> _topKScores;
+
+    // Every document found so far when '_topK' is set, including rejected ones.
+    unordered_set<RecordId, RecordId::Hasher> _seen;
+
+    // The score of the last key read by each child, which no key it has yet to read exceeds, or
+    // a negative value until the child reads its first key.
+    std::vector<double> _termScoreBounds;
+    std::vector<bool> _childExhausted;
+
     TextOrStats _specificStats;
 
     // Members needed only for using the TextMatchableDocument.
@@ -0,0 +1,128 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/unpack_bucket.h"
+
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+using std::unique_ptr;
+using stdx::make_unique;
+
+// static
+const char* UnpackBucketStage::kStageType = "UNPACK_BUCKET";
+
+UnpackBucketStage::UnpackBucketStage(OperationContext* opCtx,
+                                     const TimeseriesOptions& options,
+                                     WorkingSet* ws,
+                                     const MatchExpression* filter,
+                                     PlanStage* child)
+    : PlanStage(kStageType, opCtx), _ws(ws), _filter(filter), _unpacker(options) {
+    _children.emplace_back(child);
+}
+
+bool UnpackBucketStage::isEOF() {
+    return !_unpacker.more() && child()->isEOF();
+}
+
+PlanStage::StageState UnpackBucketStage::doWork(WorkingSetID* out) {
+    if (_unpacker.more()) {
+        BSONObj measurement = _unpacker.next();
+        ++_specificStats.measurementsUnpacked;
+        if (_filter && !_filter->matchesBSON(measurement)) {
+            return PlanStage::NEED_TIME;
+        }
+
+        *out = _ws->allocate();
+        WorkingSetMember* member = _ws->get(*out);
+        member->obj = Snapshotted<BSONObj>(SnapshotId(), measurement);
+        member->transitionToOwnedObj();
+        return PlanStage::ADVANCED;
+    }
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    StageState status = child()->work(&id);
+
+    if (PlanStage::ADVANCED == status) {
+        WorkingSetMember* member = _ws->get(id);
+        _bucket = member->obj.value().getOwned();
+        _ws->free(id);
+
+        try {
+            _unpacker.reset(_bucket);
+        } catch (const UserException& ex) {
+            *out = WorkingSetCommon::allocateStatusMember(_ws, ex.toStatus());
+            return PlanStage::FAILURE;
+        }
+        ++_specificStats.bucketsUnpacked;
+        return PlanStage::NEED_TIME;
+    } else if (PlanStage::FAILURE == status || PlanStage::DEAD == status) {
+        *out = id;
+        // If a stage fails, it may create a status WSM to indicate why it
+        // failed, in which case 'id' is valid.  If ID is invalid, we
+        // create our own error message.
+        if (WorkingSet::INVALID_ID == id) {
+            mongoutils::str::stream ss;
+            ss << "unpack bucket stage failed to read in results from child";
+            Status status(ErrorCodes::InternalError, ss);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+        }
+    } else if (PlanStage::NEED_YIELD == status) {
+        *out = id;
+    }
+
+    return status;
+}
+
+unique_ptr<PlanStageStats> UnpackBucketStage::getStats() {
+    _commonStats.isEOF = isEOF();
+
+    // Add a BSON representation of the filter to the stats tree, if there is one.
+    if (NULL != _filter) {
+        BSONObjBuilder bob;
+        _filter->serialize(&bob);
+        _commonStats.filter = bob.obj();
+    }
+
+    unique_ptr<PlanStageStats> ret = make_unique<PlanStageStats>(_commonStats, STAGE_UNPACK_BUCKET);
+    ret->specific = make_unique<UnpackBucketStats>(_specificStats);
+    ret->children.emplace_back(child()->getStats());
+    return ret;
+}
+
+const SpecificStats* UnpackBucketStage::getSpecificStats() const {
+    return &_specificStats;
+}
+
+}  // namespace mongo
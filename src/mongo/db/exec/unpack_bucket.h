@@ -0,0 +1,78 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/timeseries/bucket.h"
+
+namespace mongo {
+
+/**
+ * Unpacks each bucket of a time-series collection which its child returns into the measurements
+ * it holds, and returns those which pass the filter as owned objects without a RecordId.
+ *
+ * Preconditions: Child must be fetched.
+ */
+class UnpackBucketStage final : public PlanStage {
+public:
+    UnpackBucketStage(OperationContext* opCtx,
+                      const TimeseriesOptions& options,
+                      WorkingSet* ws,
+                      const MatchExpression* filter,
+                      PlanStage* child);
+
+    bool isEOF() final;
+    StageState doWork(WorkingSetID* out) final;
+
+    StageType stageType() const final {
+        return STAGE_UNPACK_BUCKET;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats() final;
+
+    const SpecificStats* getSpecificStats() const final;
+
+    static const char* kStageType;
+
+private:
+    WorkingSet* _ws;
+
+    // The filter is not owned by us.
+    const MatchExpression* _filter;
+
+    // The bucket being unpacked. Owned, since its record may change while yielded.
+    BSONObj _bucket;
+    BucketUnpacker _unpacker;
+
+    UnpackBucketStats _specificStats;
+};
+
+}  // namespace mongo
@@ -616,6 +616,9 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
                 args.update = logObj;
                 args.criteria = idQuery;
                 args.fromMigrate = request->isFromMigration();
+                // A replacement can change any field, so every index must be checked then.
+                const FieldRefSet* modifiedPaths =
+                    driver->isDocReplacement() ? nullptr : &updatedFields;
                 StatusWith<RecordId> res = _collection->updateDocument(getOpCtx(),
                                                                        recordId,
                                                                        oldObj,
@@ -623,7 +626,8 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
                                                                        true,
                                                                        driver->modsAffectIndices(),
                                                                        _params.opDebug,
-                                                                       &args);
+                                                                       &args,
+                                                                       modifiedPaths);
                 uassertStatusOK(res.getStatus());
                 newRecordId = res.getValue();
             }
@@ -889,7 +893,7 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
         bool docStillMatches;
         try {
             docStillMatches = write_stage_common::ensureStillMatches(
-                _collection, getOpCtx(), _ws, id, _params.canonicalQuery);
+                _collection, getOpCtx(), _ws, id, _params.canonicalQuery, _params.filter);
         } catch (const WriteConflictException& wce) {
             // There was a problem trying to detect if the document still exists, so retry.
             memberFreer.Dismiss();
@@ -928,6 +932,8 @@ PlanStage::StageState UpdateStage::doWork(WorkingSetID* out) {
             // Do the update, get us the new version of the doc.
             newObj = transformAndUpdate(member->obj, recordId);
         } catch (const WriteConflictException& wce) {
+            WriteConflictContentionManager::get(getOpCtx()->getServiceContext())
+                .noteConflict(getOpCtx(), _collection->ns().ns(), recordId);
             memberFreer.Dismiss();  // Keep this member around so we can retry updating it.
             return prepareToRetryWSM(id, out);
         }
@@ -44,7 +44,7 @@ struct PlanSummaryStats;
 
 struct UpdateStageParams {
     UpdateStageParams(const UpdateRequest* r, UpdateDriver* d, OpDebug* o)
-        : request(r), driver(d), opDebug(o), canonicalQuery(NULL) {}
+        : request(r), driver(d), opDebug(o), canonicalQuery(NULL), filter(NULL) {}
 
     // Contains update parameters like whether it's a multi update or an upsert. Not owned.
     // Must outlive the UpdateStage.
@@ -60,6 +60,10 @@ struct UpdateStageParams {
     // Not owned here.
     CanonicalQuery* canonicalQuery;
 
+    // The predicate documents are checked against again after yielding, for updates which are
+    // executed without a canonical query. Not owned here.
+    const MatchExpression* filter;
+
 private:
     // Default constructor not allowed.
     UpdateStageParams();
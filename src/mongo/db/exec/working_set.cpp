@@ -28,6 +28,8 @@
 
 #include "mongo/db/exec/working_set.h"
 
+#include <algorithm>
+
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/service_context.h"
@@ -39,26 +41,33 @@ using std::string;
 
 namespace dps = ::mongo::dotted_path_support;
 
+const size_t WorkingSet::kMinMembersPerChunk;
+const size_t WorkingSet::kMaxMembersPerChunk;
+
 WorkingSet::MemberHolder::MemberHolder() : member(NULL) {}
 WorkingSet::MemberHolder::~MemberHolder() {}
 
 WorkingSet::WorkingSet() : _freeList(INVALID_ID) {}
 
-WorkingSet::~WorkingSet() {
-    for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
-    }
-}
+WorkingSet::~WorkingSet() {}
 
 WorkingSetID WorkingSet::allocate() {
     if (_freeList == INVALID_ID) {
         // The free list is empty so we need to make a single new WSM to return. This relies on
         // vector::resize being amortized O(1) for efficient allocation. Note that the free list
         // remains empty until something is returned by a call to free().
+        if (_lastChunkUsed == _lastChunkSize) {
+            _lastChunkSize = std::min(std::max(_data.size(), kMinMembersPerChunk),
+                                      kMaxMembersPerChunk);
+            _lastChunkUsed = 0;
+            _memberChunks.emplace_back(new WorkingSetMember[_lastChunkSize]);
+            _data.reserve(_data.size() + _lastChunkSize);
+        }
+
         WorkingSetID id = _data.size();
         _data.resize(_data.size() + 1);
         _data.back().nextFreeOrSelf = id;
-        _data.back().member = new WorkingSetMember();
+        _data.back().member = &_memberChunks.back()[_lastChunkUsed++];
         return id;
     }
 
@@ -96,14 +105,17 @@ bool WorkingSet::isFlagged(WorkingSetID id) const {
 }
 
 void WorkingSet::clear() {
-    for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
-    }
-    _data.clear();
-
-    // Since working set is now empty, the free list pointer should
-    // point to nothing.
+    // Free every member that is in use and rebuild the free list so that, as after construction,
+    // ids are handed out again in increasing order.
     _freeList = INVALID_ID;
+    for (size_t i = _data.size(); i-- > 0;) {
+        MemberHolder& holder = _data[i];
+        if (holder.nextFreeOrSelf == i) {
+            holder.member->clear();
+        }
+        holder.nextFreeOrSelf = _freeList;
+        _freeList = i;
+    }
 
     _flagged.clear();
     _yieldSensitiveIds.clear();
@@ -147,6 +159,7 @@ void WorkingSetMember::clear() {
 
     keyData.clear();
     obj.reset();
+    _topLevelFields.reset(BSONObj());
     _state = WorkingSetMember::INVALID;
 }
 
@@ -208,7 +221,12 @@ bool WorkingSetMember::hasFetcher() const {
 bool WorkingSetMember::getFieldDotted(const string& field, BSONElement* out) const {
     // If our state is such that we have an object, use it.
     if (hasObj()) {
-        *out = dps::extractElementAtPath(obj.value(), field);
+        const BSONTopLevelFieldCache* topLevelFields = getTopLevelFieldCache();
+        if (topLevelFields && field.find('.') == string::npos) {
+            *out = topLevelFields->getField(field);
+        } else {
+            *out = dps::extractElementAtPath(obj.value(), field);
+        }
         return true;
     }
 
@@ -232,6 +250,19 @@ bool WorkingSetMember::getFieldDotted(const string& field, BSONElement* out) con
     return false;
 }
 
+const BSONTopLevelFieldCache* WorkingSetMember::getTopLevelFieldCache() const {
+    if (!hasOwnedObj()) {
+        return nullptr;
+    }
+
+    // The cache holds a reference to the buffer of the object it indexes, so another object can't
+    // be allocated at the same address while the cache exists.
+    if (_topLevelFields.obj().objdata() != obj.value().objdata()) {
+        _topLevelFields.reset(obj.value());
+    }
+    return &_topLevelFields;
+}
+
 size_t WorkingSetMember::getMemUsage() const {
     size_t memUsage = 0;
 
@@ -28,11 +28,14 @@
 
 #pragma once
 
+#include <boost/container/small_vector.hpp>
+#include <memory>
 #include <unordered_set>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/path.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/snapshot.h"
 #include "mongo/platform/unordered_set.h"
@@ -87,6 +90,14 @@ public:
         return _data[i].nextFreeOrSelf != i;
     }
 
+    /**
+     * Returns true if WorkingSetMember with id 'i' is in use. Unlike isFree(), 'i' may be
+     * INVALID_ID or an id that was handed out before the last call to clear().
+     */
+    bool isInUse(WorkingSetID i) const {
+        return i < _data.size() && _data[i].nextFreeOrSelf == i;
+    }
+
     /**
      * Deallocate the i-th query result and release its resources.
      */
@@ -113,7 +124,8 @@ public:
     const unordered_set<WorkingSetID>& getFlagged() const;
 
     /**
-     * Removes and deallocates all members of this working set.
+     * Frees all members of this working set. The members themselves are kept for reuse by later
+     * calls to allocate(), and ids handed out before the call are no longer in use.
      */
     void clear();
 
@@ -147,14 +159,27 @@ private:
         // Free list link if freed. Points to self if in use.
         WorkingSetID nextFreeOrSelf;
 
-        // Owning pointer
+        // Points into one of '_memberChunks'.
         WorkingSetMember* member;
     };
 
+    // The first chunk holds this many members, and each later chunk doubles the total capacity
+    // until chunks reach kMaxMembersPerChunk.
+    static const size_t kMinMembersPerChunk = 4;
+    static const size_t kMaxMembersPerChunk = 256;
+
     // All WorkingSetIDs are indexes into this, except for INVALID_ID.
-    // Elements are added to _freeList rather than removed when freed.
+    // Elements are added to _freeList rather than removed when freed. It never shrinks, since
+    // clear() recycles members instead of deleting them.
     std::vector<MemberHolder> _data;
 
+    // Storage for the members, which is only released when the WorkingSet is destroyed. Members
+    // are created a chunk at a time so that allocate() only goes to the heap once all members
+    // created so far are in use.
+    std::vector<std::unique_ptr<WorkingSetMember[]>> _memberChunks;
+    size_t _lastChunkSize = 0;
+    size_t _lastChunkUsed = 0;
+
     // Index into _data, forming a linked-list using MemberHolder::nextFreeOrSelf as the next
     // link. INVALID_ID is the list terminator since 0 is a valid index.
     // If _freeList == INVALID_ID, the free list is empty and all elements in _data are in use.
@@ -280,7 +305,10 @@ public:
 
     RecordId recordId;
     Snapshotted<BSONObj> obj;
-    std::vector<IndexKeyDatum> keyData;
+
+    // Almost every member read from an index holds a single key, which is stored inline. Its
+    // capacity is kept when the member is freed, so recycled members don't reallocate it.
+    boost::container::small_vector<IndexKeyDatum, 1> keyData;
 
     // True if this WSM has survived a yield in RID_AND_IDX state.
     // TODO consider replacing by tracking SnapshotIds for IndexKeyDatums.
@@ -326,6 +354,15 @@ public:
      */
     bool getFieldDotted(const std::string& field, BSONElement* out) const;
 
+    /**
+     * Returns a cache of the top-level fields of 'obj', which is kept for as long as 'obj' is
+     * unchanged, so that the stages looking up fields of this WSM share a single index of them.
+     *
+     * Returns nullptr if this WSM has no object or if it is unowned, in which case a document at
+     * the same address may not be the same document.
+     */
+    const BSONTopLevelFieldCache* getTopLevelFieldCache() const;
+
     /**
      * Returns expected memory usage of working set member.
      */
@@ -339,6 +376,8 @@ private:
     std::unique_ptr<WorkingSetComputedData> _computed[WSM_COMPUTED_NUM_TYPES];
 
     std::unique_ptr<RecordFetcher> _fetcher;
+
+    mutable BSONTopLevelFieldCache _topLevelFields{BSONObj()};
 };
 
 }  // namespace mongo
@@ -84,6 +84,14 @@ void WorkingSetCommon::prepareForSnapshotChange(WorkingSet* workingSet) {
     }
 }
 
+// static
+void WorkingSetCommon::ownObjIfStillInUse(WorkingSet* workingSet, WorkingSetID* id) {
+    if (workingSet->isInUse(*id)) {
+        workingSet->get(*id)->makeObjOwnedIfNeeded();
+    }
+    *id = WorkingSet::INVALID_ID;
+}
+
 // static
 bool WorkingSetCommon::fetch(OperationContext* txn,
                              WorkingSet* workingSet,
@@ -61,6 +61,18 @@ public:
      */
     static void prepareForSnapshotChange(WorkingSet* workingSet);
 
+    /**
+     * If the WorkingSetMember with WorkingSetID 'id' is still in use, gives it an owned copy of
+     * its document in case the document points into a record cursor's buffer. Resets 'id' to
+     * WorkingSet::INVALID_ID.
+     *
+     * Stages that return documents straight from a record cursor hand them out unowned and keep
+     * the id of the last one. They call this before moving or saving the cursor, so that a copy
+     * is only made when the consumer is still holding on to the member, such as when it buffers
+     * a batch of results, rather than for every document.
+     */
+    static void ownObjIfStillInUse(WorkingSet* workingSet, WorkingSetID* id);
+
     /**
      * Transitions the WorkingSetMember with WorkingSetID 'id' from the RID_AND_IDX state to the
      * RID_AND_OBJ state by fetching a document. Does the fetch using 'cursor'.
@@ -115,6 +115,35 @@ TEST_F(WorkingSetFixture, getFieldOwned) {
     ASSERT_EQUALS(elt.numberInt(), 5);
 }
 
+TEST_F(WorkingSetFixture, topLevelFieldCacheFollowsOwnedObj) {
+    BSONObj obj = BSON("x" << 5 << "y" << 6);
+    member->obj = Snapshotted<BSONObj>(SnapshotId(), obj);
+    ws->transitionToOwnedObj(id);
+
+    const BSONTopLevelFieldCache* topLevelFields = member->getTopLevelFieldCache();
+    ASSERT_TRUE(topLevelFields);
+    ASSERT_TRUE(topLevelFields == member->getTopLevelFieldCache());
+    ASSERT_EQUALS(topLevelFields->getField("y").numberInt(), 6);
+
+    BSONElement elt;
+    ASSERT_TRUE(member->getFieldDotted("x", &elt));
+    ASSERT_EQUALS(elt.numberInt(), 5);
+
+    // Replacing the object also replaces the document the cache indexes.
+    member->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("x" << 7));
+    ASSERT_TRUE(member->getFieldDotted("x", &elt));
+    ASSERT_EQUALS(elt.numberInt(), 7);
+    ASSERT_TRUE(member->getFieldDotted("y", &elt));
+    ASSERT_TRUE(elt.eoo());
+}
+
+TEST_F(WorkingSetFixture, noTopLevelFieldCacheForUnownedObj) {
+    BSONObj obj = BSON("x" << 5);
+    ws->transitionToRecordIdAndObj(id);
+    member->obj = Snapshotted<BSONObj>(SnapshotId(), BSONObj(obj.objdata()));
+    ASSERT_FALSE(member->getTopLevelFieldCache());
+}
+
 TEST_F(WorkingSetFixture, getFieldFromIndex) {
     string firstName = "x";
     int firstValue = 5;
@@ -154,4 +183,39 @@ TEST_F(WorkingSetFixture, getDottedFieldFromIndex) {
     ASSERT_FALSE(member->getFieldDotted("y", &elt));
 }
 
+TEST_F(WorkingSetFixture, clearRecyclesMembers) {
+    WorkingSetID otherId = ws->allocate();
+    WorkingSetMember* otherMember = ws->get(otherId);
+    otherMember->keyData.push_back(IndexKeyDatum(BSON("x" << 1), BSON("" << 5), NULL));
+    ws->transitionToRecordIdAndIdx(otherId);
+    ws->free(id);
+
+    ws->clear();
+    ASSERT_FALSE(ws->isInUse(id));
+    ASSERT_FALSE(ws->isInUse(otherId));
+    ASSERT_TRUE(ws->getAndClearYieldSensitiveIds().empty());
+
+    // Ids are handed out from the lowest one again, backed by the members that were cleared.
+    ASSERT_EQUALS(id, ws->allocate());
+    ASSERT_EQUALS(member, ws->get(id));
+    ASSERT_EQUALS(otherId, ws->allocate());
+    ASSERT_EQUALS(otherMember, ws->get(otherId));
+    ASSERT_EQUALS(WorkingSetMember::INVALID, otherMember->getState());
+    ASSERT_TRUE(otherMember->keyData.empty());
+}
+
+TEST(WorkingSetTest, membersStayAtTheSameAddressAsTheSetGrows) {
+    WorkingSet ws;
+    std::vector<WorkingSetMember*> members;
+    for (size_t i = 0; i < 1000; ++i) {
+        WorkingSetID id = ws.allocate();
+        ASSERT_EQUALS(i, id);
+        members.push_back(ws.get(id));
+    }
+
+    for (size_t i = 0; i < members.size(); ++i) {
+        ASSERT_EQUALS(members[i], ws.get(i));
+    }
+}
+
 }  // namespace
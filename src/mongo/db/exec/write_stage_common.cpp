@@ -43,7 +43,8 @@ bool ensureStillMatches(const Collection* collection,
                         OperationContext* txn,
                         WorkingSet* ws,
                         WorkingSetID id,
-                        const CanonicalQuery* cq) {
+                        const CanonicalQuery* cq,
+                        const MatchExpression* filter) {
     // If the snapshot changed, then we have to make sure we have the latest copy of the doc and
     // that it still matches.
     WorkingSetMember* member = ws->get(id);
@@ -56,7 +57,10 @@ bool ensureStillMatches(const Collection* collection,
         }
 
         // Make sure the re-fetched doc still matches the predicate.
-        if (cq && !cq->root()->matchesBSON(member->obj.value(), nullptr)) {
+        if (cq) {
+            filter = cq->root();
+        }
+        if (filter && !filter->matchesBSON(member->obj.value(), nullptr)) {
             // No longer matches.
             return false;
         }
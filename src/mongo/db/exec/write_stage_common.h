@@ -37,14 +37,15 @@ namespace mongo {
 
 class CanonicalQuery;
 class Collection;
+class MatchExpression;
 class OperationContext;
 
 namespace write_stage_common {
 
 /**
  * Returns true if the document referred to by 'id' still exists and matches the query predicate
- * given by 'cq'. Returns true if the document still exists and 'cq' is null. Returns false
- * otherwise.
+ * given by 'cq', or by 'filter' if 'cq' is null. Returns true if the document still exists and
+ * both are null. Returns false otherwise.
  *
  * May throw a WriteConflictException if there was a conflict while searching to see if the document
  * still exists.
@@ -53,6 +54,7 @@ bool ensureStillMatches(const Collection* collection,
                         OperationContext* txn,
                         WorkingSet* ws,
                         WorkingSetID id,
-                        const CanonicalQuery* cq);
+                        const CanonicalQuery* cq,
+                        const MatchExpression* filter = nullptr);
 }
 }
@@ -34,9 +34,11 @@
 #include "mongo/bson/bsonmisc.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/client.h"
+#include "mongo/db/concurrency/locker.h"
 #include "mongo/db/ftdc/constants.h"
 #include "mongo/db/ftdc/util.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/operation_context.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
@@ -81,6 +83,10 @@ std::tuple<BSONObj, Date_t> FTDCCollectorCollection::collect(Client* client) {
             // across multiple command invocations.
             auto txn = client->makeOperationContext();
 
+            // Diagnostic data is most useful when the server is overloaded, so it is collected
+            // without waiting for a ticket.
+            txn->lockState()->setShouldAcquireTicket(false);
+
             collector->collect(txn.get(), subObjBuilder);
         }
 
@@ -37,14 +37,18 @@
 #include "mongo/bson/bsonobjbuilder.h"
 
 #include "mongo/db/commands.h"
+#include "mongo/db/concurrency/lock_stats.h"
+#include "mongo/db/concurrency/locker.h"
 #include "mongo/db/ftdc/collector.h"
 #include "mongo/db/ftdc/config.h"
 #include "mongo/db/ftdc/controller.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/operation_context.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/top.h"
 #include "mongo/db/storage/storage_options.h"
 
 namespace mongo {
@@ -61,6 +65,19 @@ FTDCController* getGlobalFTDCController() {
     return getFTDCController(getGlobalServiceContext()).get();
 }
 
+// The high resolution controller only collects the cheap, wait-related metrics below, at a
+// shorter period, into its own directory so that it does not rotate the regular FTDC files out.
+const auto getHighResolutionFTDCController =
+    ServiceContext::declareDecoration<std::unique_ptr<FTDCController>>();
+
+FTDCController* getGlobalHighResolutionFTDCController() {
+    if (!hasGlobalServiceContext()) {
+        return nullptr;
+    }
+
+    return getHighResolutionFTDCController(getGlobalServiceContext()).get();
+}
+
 std::atomic<bool> localEnabledFlag(FTDCConfig::kEnabledDefault);  // NOLINT
 
 class ExportedFTDCEnabledParameter
@@ -245,6 +262,89 @@ public:
 
 } exportedFTDCInterimChunkSizeParameter;
 
+std::atomic<bool> localHighResolutionEnabledFlag(false);  // NOLINT
+
+class ExportedFTDCHighResolutionEnabledParameter
+    : public ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFTDCHighResolutionEnabledParameter()
+        : ExportedServerParameter<bool, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionHighResolutionEnabled",
+              &localHighResolutionEnabledFlag) {}
+
+    virtual Status validate(const bool& potentialNewValue) {
+        auto controller = getGlobalHighResolutionFTDCController();
+        if (controller) {
+            controller->setEnabled(potentialNewValue);
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCHighResolutionEnabledParameter;
+
+std::atomic<std::int32_t> localHighResolutionPeriodMillis(100);  // NOLINT
+
+class ExportedFTDCHighResolutionPeriodParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFTDCHighResolutionPeriodParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionHighResolutionPeriodMillis",
+              &localHighResolutionPeriodMillis) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue < 10) {
+            return Status(ErrorCodes::BadValue,
+                          "diagnosticDataCollectionHighResolutionPeriodMillis must be greater than "
+                          "or equal to 10ms");
+        }
+
+        auto controller = getGlobalHighResolutionFTDCController();
+        if (controller) {
+            controller->setPeriod(Milliseconds(potentialNewValue));
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCHighResolutionPeriodParameter;
+
+// The high resolution files are kept small so that a burst of samples can only ever churn through
+// a few of them, and the whole directory stays bounded.
+const std::int32_t kHighResolutionMaxFileSizeMB = 2;
+
+std::atomic<std::int32_t> localHighResolutionMaxDirectorySizeMB(20);  // NOLINT
+
+class ExportedFTDCHighResolutionDirectorySizeParameter
+    : public ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime> {
+public:
+    ExportedFTDCHighResolutionDirectorySizeParameter()
+        : ExportedServerParameter<std::int32_t, ServerParameterType::kStartupAndRuntime>(
+              ServerParameterSet::getGlobal(),
+              "diagnosticDataCollectionHighResolutionDirectorySizeMB",
+              &localHighResolutionMaxDirectorySizeMB) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue < kHighResolutionMaxFileSizeMB) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << "diagnosticDataCollectionHighResolutionDirectorySizeMB "
+                                           "must be greater than or equal to "
+                                        << kHighResolutionMaxFileSizeMB);
+        }
+
+        auto controller = getGlobalHighResolutionFTDCController();
+        if (controller) {
+            controller->setMaxDirectorySizeBytes(potentialNewValue * 1024 * 1024);
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCHighResolutionDirectorySizeParameter;
+
 class FTDCSimpleInternalCommandCollector final : public FTDCCollectorInterface {
 public:
     FTDCSimpleInternalCommandCollector(StringData command,
@@ -281,6 +381,80 @@ private:
     Command* _command;
 };
 
+/**
+ * Collects the global operation latency histograms, i.e. the opLatencies section of serverStatus.
+ */
+class FTDCOperationLatencyCollector final : public FTDCCollectorInterface {
+public:
+    void collect(OperationContext* txn, BSONObjBuilder& builder) override {
+        Top::get(txn->getServiceContext()).appendGlobalLatencyStats(&builder);
+    }
+
+    std::string name() const override {
+        return "opLatencies";
+    }
+};
+
+/**
+ * Collects the lock acquisition counts and wait times of all lockers, without walking the
+ * sessions like the locks section of serverStatus does.
+ */
+class FTDCLockWaitCollector final : public FTDCCollectorInterface {
+public:
+    void collect(OperationContext* txn, BSONObjBuilder& builder) override {
+        SingleThreadedLockStats stats;
+        reportGlobalLockingStats(&stats);
+        stats.report(&builder);
+    }
+
+    std::string name() const override {
+        return "locks";
+    }
+};
+
+/**
+ * Collects the state of the storage engine's read and write ticket holders, including the number
+ * of operations queued for a ticket.
+ */
+class FTDCTicketCollector final : public FTDCCollectorInterface {
+public:
+    void collect(OperationContext* txn, BSONObjBuilder& builder) override {
+        Locker::appendGlobalThrottlingStats(&builder);
+    }
+
+    std::string name() const override {
+        return "tickets";
+    }
+};
+
+/**
+ * Starts the high resolution controller. It is always created, even when disabled, so that it can
+ * be enabled at runtime; it writes nothing until then.
+ */
+void startHighResolutionFTDC() {
+    boost::filesystem::path dir(storageGlobalParams.dbpath);
+    dir /= "diagnostic.data";
+    dir /= "highResolution";
+
+    FTDCConfig config;
+    config.period = Milliseconds(localHighResolutionPeriodMillis.load());
+    config.enabled = localHighResolutionEnabledFlag;
+    config.maxFileSizeBytes = kHighResolutionMaxFileSizeMB * 1024 * 1024;
+    config.maxDirectorySizeBytes = localHighResolutionMaxDirectorySizeMB * 1024 * 1024;
+
+    auto controller = stdx::make_unique<FTDCController>(dir, config);
+
+    controller->addPeriodicCollector(stdx::make_unique<FTDCOperationLatencyCollector>());
+    controller->addPeriodicCollector(stdx::make_unique<FTDCLockWaitCollector>());
+    controller->addPeriodicCollector(stdx::make_unique<FTDCTicketCollector>());
+
+    auto& staticFTDC = getHighResolutionFTDCController(getGlobalServiceContext());
+
+    staticFTDC = std::move(controller);
+
+    staticFTDC->start();
+}
+
 }  // namespace
 
 
@@ -310,6 +484,9 @@ void startFTDC() {
     controller->addPeriodicCollector(stdx::make_unique<FTDCSimpleInternalCommandCollector>(
         "serverStatus", "serverStatus", "", BSON("serverStatus" << 1 << "tcMalloc" << true)));
 
+    // Ticket queue depth, which serverStatus does not report
+    controller->addPeriodicCollector(stdx::make_unique<FTDCTicketCollector>());
+
     // These metrics are only collected if replication is enabled
     if (repl::getGlobalReplicationCoordinator()->getReplicationMode() !=
         repl::ReplicationCoordinator::modeNone) {
@@ -347,6 +524,8 @@ void startFTDC() {
     staticFTDC = std::move(controller);
 
     staticFTDC->start();
+
+    startHighResolutionFTDC();
 }
 
 void stopFTDC() {
@@ -355,6 +534,12 @@ void stopFTDC() {
     if (controller) {
         controller->stop();
     }
+
+    auto highResolutionController = getGlobalHighResolutionFTDCController();
+
+    if (highResolutionController) {
+        highResolutionController->stop();
+    }
 }
 
 }  // namespace mongo
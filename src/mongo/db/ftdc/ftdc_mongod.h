@@ -32,7 +32,8 @@ namespace mongo {
 
 /**
  * Start Full Time Data Capture
- * Starts 1 thread.
+ * Starts 2 threads: one for the regular collection, and one for the high resolution collection,
+ * which is idle unless diagnosticDataCollectionHighResolutionEnabled is set.
  */
 void startFTDC();
 
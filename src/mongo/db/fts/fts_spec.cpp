@@ -31,6 +31,11 @@
 
 #include "mongo/db/fts/fts_spec.h"
 
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/field_ref.h"
 #include "mongo/db/fts/fts_element_iterator.h"
@@ -174,25 +179,104 @@ const FTSLanguage* FTSSpec::_getLanguageToUseV2(const BSONObj& userDoc,
     return swl.getValue();
 }
 
+namespace {
+
+/**
+ * Stores the bytes of many short strings in large blocks, so that they don't each need their own
+ * allocation. The blocks never move, so the StringData copy() returns stay valid until clear().
+ */
+class TermArena {
+public:
+    StringData copy(StringData term) {
+        if (_blockIndex == _blocks.size() || _used + term.size() > _blocks[_blockIndex].size) {
+            _nextBlock(term.size());
+        }
+        char* dest = _blocks[_blockIndex].data.get() + _used;
+        std::copy(term.begin(), term.end(), dest);
+        _used += term.size();
+        return StringData(dest, term.size());
+    }
+
+    /**
+     * Forgets every copied string, but keeps the blocks for reuse.
+     */
+    void clear() {
+        _blockIndex = 0;
+        _used = 0;
+    }
+
+private:
+    static const size_t kBlockSize = 4096;
+
+    struct Block {
+        std::unique_ptr<char[]> data;
+        size_t size;
+    };
+
+    void _nextBlock(size_t minSize) {
+        if (_blockIndex < _blocks.size()) {
+            ++_blockIndex;
+        }
+        _used = 0;
+        if (_blockIndex < _blocks.size() && _blocks[_blockIndex].size >= minSize) {
+            return;
+        }
+        const size_t size = std::max(kBlockSize, minSize);
+        Block block{std::unique_ptr<char[]>(new char[size]), size};
+        _blocks.insert(_blocks.begin() + _blockIndex, std::move(block));
+    }
+
+    std::vector<Block> _blocks;
+    size_t _blockIndex = 0;
+    size_t _used = 0;
+};
+
+}  // namespace
+
+struct FTSSpec::ScoringBuffers {
+    /**
+     * Returns a tokenizer for 'language', creating it the first time the document uses it.
+     */
+    FTSTokenizer* getTokenizer(const FTSLanguage* language) {
+        for (auto& tokenizer : tokenizers) {
+            if (tokenizer.first == language) {
+                return tokenizer.second.get();
+            }
+        }
+        tokenizers.emplace_back(language, language->createTokenizer());
+        return tokenizers.back().second.get();
+    }
+
+    std::vector<std::pair<const FTSLanguage*, std::unique_ptr<FTSTokenizer>>> tokenizers;
+
+    // The terms of the string being scored. The keys point into 'arena'.
+    unordered_map<StringData, ScoreHelperStruct, StringData::Hasher> terms;
+    TermArena arena;
+};
+
 void FTSSpec::scoreDocument(const BSONObj& obj, TermFrequencyMap* term_freqs) const {
     if (_textIndexVersion == TEXT_INDEX_VERSION_1) {
         return _scoreDocumentV1(obj, term_freqs);
     }
 
     FTSElementIterator it(*this, obj);
+    ScoringBuffers buffers;
 
     while (it.more()) {
         FTSIteratorValue val = it.next();
-        std::unique_ptr<FTSTokenizer> tokenizer(val._language->createTokenizer());
-        _scoreStringV2(tokenizer.get(), val._text, term_freqs, val._weight);
+        _scoreStringV2(
+            buffers.getTokenizer(val._language), val._text, term_freqs, val._weight, &buffers);
     }
 }
 
 void FTSSpec::_scoreStringV2(FTSTokenizer* tokenizer,
                              StringData raw,
                              TermFrequencyMap* docScores,
-                             double weight) const {
-    ScoreHelperMap terms;
+                             double weight,
+                             ScoringBuffers* buffers) const {
+    auto& terms = buffers->terms;
+    terms.clear();
+    buffers->arena.clear();
 
     unsigned numTokens = 0;
 
@@ -201,7 +285,12 @@ void FTSSpec::_scoreStringV2(FTSTokenizer* tokenizer,
     while (tokenizer->moveNext()) {
         StringData term = tokenizer->get();
 
-        ScoreHelperStruct& data = terms[term];
+        auto it = terms.find(term);
+        if (it == terms.end()) {
+            // The token only lives until the next moveNext(), so keep a copy of the new term.
+            it = terms.emplace(buffers->arena.copy(term), ScoreHelperStruct()).first;
+        }
+        ScoreHelperStruct& data = it->second;
 
         if (data.exp) {
             data.exp *= 2;
@@ -213,9 +302,9 @@ void FTSSpec::_scoreStringV2(FTSTokenizer* tokenizer,
         numTokens++;
     }
 
-    for (ScoreHelperMap::const_iterator i = terms.begin(); i != terms.end(); ++i) {
-        const string& term = i->first;
-        const ScoreHelperStruct& data = i->second;
+    for (const auto& i : terms) {
+        StringData term = i.first;
+        const ScoreHelperStruct& data = i.second;
 
         // in order to adjust weights as a function of term count as it
         // relates to total field length. ie. is this the only word or
@@ -227,10 +316,10 @@ void FTSSpec::_scoreStringV2(FTSTokenizer* tokenizer,
         // if term is identical to the raw form of the
         // field (untokenized) give it a small boost.
         double adjustment = 1;
-        if (raw.size() == term.length() && raw.equalCaseInsensitive(term))
+        if (raw.size() == term.size() && raw.equalCaseInsensitive(term))
             adjustment += 0.1;
 
-        double& score = (*docScores)[term];
+        double& score = (*docScores)[term.toString()];
         score += (weight * data.freq * coeff * adjustment);
         verify(score <= MAX_WEIGHT);
     }
@@ -128,14 +128,20 @@ private:
     // Helper methods.  Invoked for TEXT_INDEX_VERSION_2 spec objects only.
     //
 
+    /**
+     * The tokenizers and term storage that scoreDocument() reuses for each string of a document.
+     */
+    struct ScoringBuffers;
+
     /**
      * Calculate the term scores for 'raw' and update 'term_freqs' with the result.  Parses
-     * 'raw' using 'tools', and weights term scores based on 'weight'.
+     * 'raw' using 'tokenizer', and weights term scores based on 'weight'.
      */
     void _scoreStringV2(FTSTokenizer* tokenizer,
                         StringData raw,
                         TermFrequencyMap* term_freqs,
-                        double weight) const;
+                        double weight,
+                        ScoringBuffers* buffers) const;
 
 public:
     /**
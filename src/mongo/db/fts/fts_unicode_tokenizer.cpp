@@ -30,6 +30,8 @@
 
 #include "mongo/db/fts/fts_unicode_tokenizer.h"
 
+#include <array>
+
 #include "mongo/db/fts/fts_query_impl.h"
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/fts/stemmer.h"
@@ -44,6 +46,47 @@ namespace fts {
 
 using std::string;
 
+namespace {
+
+const size_t kNumAsciiChars = 128;
+
+/**
+ * Builds the table of which ASCII characters are delimiters in 'lang'.
+ */
+std::array<bool, kNumAsciiChars> makeAsciiDelimiters(unicode::DelimiterListLanguage lang) {
+    std::array<bool, kNumAsciiChars> delimiters;
+    for (size_t c = 0; c < kNumAsciiChars; ++c) {
+        delimiters[c] = unicode::codepointIsDelimiter(c, lang);
+    }
+    return delimiters;
+}
+
+const bool* getAsciiDelimiters(unicode::DelimiterListLanguage lang) {
+    static const std::array<bool, kNumAsciiChars> english =
+        makeAsciiDelimiters(unicode::DelimiterListLanguage::kEnglish);
+    static const std::array<bool, kNumAsciiChars> notEnglish =
+        makeAsciiDelimiters(unicode::DelimiterListLanguage::kNotEnglish);
+    return lang == unicode::DelimiterListLanguage::kEnglish ? english.data() : notEnglish.data();
+}
+
+/**
+ * Returns whether 'document' can be tokenized byte by byte. Turkish case folding lowers 'I' to a
+ * character outside ASCII, and embedded null characters end the document when it is decoded, so
+ * both of those take the Unicode path too.
+ */
+bool canTokenizeAsAscii(StringData document, unicode::CaseFoldMode caseFoldMode) {
+    for (char c : document) {
+        const unsigned char byte = static_cast<unsigned char>(c);
+        if (byte == 0 || byte >= kNumAsciiChars ||
+            (byte == 'I' && caseFoldMode == unicode::CaseFoldMode::kTurkish)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
 UnicodeFTSTokenizer::UnicodeFTSTokenizer(const FTSLanguage* language)
     : _language(language),
       _stemmer(language),
@@ -52,12 +95,18 @@ UnicodeFTSTokenizer::UnicodeFTSTokenizer(const FTSLanguage* language)
                              ? unicode::DelimiterListLanguage::kEnglish
                              : unicode::DelimiterListLanguage::kNotEnglish),
       _caseFoldMode(_language->str() == "turkish" ? unicode::CaseFoldMode::kTurkish
-                                                  : unicode::CaseFoldMode::kNormal) {}
+                                                  : unicode::CaseFoldMode::kNormal),
+      _asciiDelimiters(getAsciiDelimiters(_delimListLanguage)) {}
 
 void UnicodeFTSTokenizer::reset(StringData document, Options options) {
     _options = options;
     _pos = 0;
-    _document.resetData(document);  // Validates that document is valid UTF8.
+    _isAscii = canTokenizeAsAscii(document, _caseFoldMode);
+    if (_isAscii) {
+        _asciiDocument.assign(document.rawData(), document.size());
+    } else {
+        _document.resetData(document);  // Validates that document is valid UTF8.
+    }
 
     // Skip any leading delimiters (and handle the case where the document is entirely delimiters).
     _skipDelimiters();
@@ -65,15 +114,14 @@ void UnicodeFTSTokenizer::reset(StringData document, Options options) {
 
 bool UnicodeFTSTokenizer::moveNext() {
     while (true) {
-        if (_pos >= _document.size()) {
+        if (_pos >= _documentSize()) {
             _word = "";
             return false;
         }
 
         // Traverse through non-delimiters and build the next token.
         size_t start = _pos++;
-        while (_pos < _document.size() &&
-               (!unicode::codepointIsDelimiter(_document[_pos], _delimListLanguage))) {
+        while (_pos < _documentSize() && !_isDelimiter(_pos)) {
             ++_pos;
         }
         const size_t len = _pos - start;
@@ -83,14 +131,16 @@ bool UnicodeFTSTokenizer::moveNext() {
 
         // Stop words are case-sensitive and diacritic sensitive, so we need them to be lower cased
         // but with diacritics not removed to check against the stop word list.
-        _word = _document.toLowerToBuf(&_wordBuf, _caseFoldMode, start, len);
+        _word = _isAscii ? _asciiToLowerToBuf(start, len)
+                         : _document.toLowerToBuf(&_wordBuf, _caseFoldMode, start, len);
 
         if ((_options & kFilterStopWords) && _stopWords->isStopWord(_word)) {
             continue;
         }
 
         if (_options & kGenerateCaseSensitiveTokens) {
-            _word = _document.substrToBuf(&_wordBuf, start, len);
+            _word = _isAscii ? StringData(_asciiDocument.data() + start, len)
+                             : _document.substrToBuf(&_wordBuf, start, len);
         }
 
         // The stemmer is diacritic sensitive, so stem the word before removing diacritics.
@@ -111,11 +161,20 @@ StringData UnicodeFTSTokenizer::get() const {
 }
 
 void UnicodeFTSTokenizer::_skipDelimiters() {
-    while (_pos < _document.size() &&
-           unicode::codepointIsDelimiter(_document[_pos], _delimListLanguage)) {
+    while (_pos < _documentSize() && _isDelimiter(_pos)) {
         ++_pos;
     }
 }
 
+StringData UnicodeFTSTokenizer::_asciiToLowerToBuf(size_t start, size_t len) {
+    _wordBuf.reset();
+    char* out = _wordBuf.skip(len);
+    for (size_t i = 0; i < len; ++i) {
+        const char c = _asciiDocument[start + i];
+        out[i] = (c >= 'A' && c <= 'Z') ? (c | 0x20) : c;
+    }
+    return StringData(_wordBuf.buf(), len);
+}
+
 }  // namespace fts
 }  // namespace mongo
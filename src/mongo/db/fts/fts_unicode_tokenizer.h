@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/string_data.h"
 #include "mongo/db/fts/fts_tokenizer.h"
@@ -53,6 +55,9 @@ class StopWords;
  *
  * For each word returns a stem version of a word optimized for full text indexing.
  * Optionally supports returning case sensitive search terms.
+ *
+ * Documents that are entirely ASCII are tokenized directly from their bytes, without decoding them
+ * to UTF-32 or looking up each codepoint in the Unicode tables.
  */
 class UnicodeFTSTokenizer final : public FTSTokenizer {
     MONGO_DISALLOW_COPYING(UnicodeFTSTokenizer);
@@ -73,12 +78,37 @@ private:
      */
     void _skipDelimiters();
 
+    /**
+     * Returns whether the codepoint at 'pos' of the current document is a delimiter.
+     */
+    bool _isDelimiter(size_t pos) const {
+        if (_isAscii) {
+            return _asciiDelimiters[static_cast<unsigned char>(_asciiDocument[pos])];
+        }
+        return unicode::codepointIsDelimiter(_document[pos], _delimListLanguage);
+    }
+
+    size_t _documentSize() const {
+        return _isAscii ? _asciiDocument.size() : _document.size();
+    }
+
+    /**
+     * Lowercases the ASCII substring of the current document at 'start' into _wordBuf.
+     */
+    StringData _asciiToLowerToBuf(size_t start, size_t len);
+
     const FTSLanguage* const _language;
     const Stemmer _stemmer;
     const StopWords* const _stopWords;
     const unicode::DelimiterListLanguage _delimListLanguage;
     const unicode::CaseFoldMode _caseFoldMode;
 
+    // Whether each ASCII character is a delimiter in _delimListLanguage.
+    const bool* const _asciiDelimiters;
+
+    // The current document is in _asciiDocument if it is entirely ASCII, and in _document if not.
+    bool _isAscii = false;
+    std::string _asciiDocument;
     unicode::String _document;
     size_t _pos;
     StringData _word;
@@ -241,5 +241,59 @@ TEST(FtsUnicodeTokenizer, FrenchStopWordsAndDiacriticSensitive) {
     ASSERT_EQUALS("excit", terms[4]);
 }
 
+// Ensure that ASCII documents, which skip decoding to UTF-32, get the same tokens as documents with
+// other characters in them.
+TEST(FtsUnicodeTokenizer, AsciiDocumentsMatchUnicodeDocuments) {
+    const std::string ascii = "  Do you SEE Mark's dogs, running^ `fast`? 42 times_over (I think)";
+    const std::string unicode = ascii + " \xc3\xa9";  // Appends " é".
+    const FTSTokenizer::Options allOptions[] = {
+        FTSTokenizer::kNone,
+        FTSTokenizer::kFilterStopWords,
+        FTSTokenizer::kGenerateCaseSensitiveTokens,
+        FTSTokenizer::kGenerateDiacriticSensitiveTokens,
+        FTSTokenizer::kGenerateCaseSensitiveTokens | FTSTokenizer::kFilterStopWords |
+            FTSTokenizer::kGenerateDiacriticSensitiveTokens,
+    };
+
+    for (const char* language : {"english", "french", "turkish", "none"}) {
+        for (FTSTokenizer::Options options : allOptions) {
+            std::vector<std::string> asciiTerms =
+                tokenizeString(ascii.c_str(), language, options);
+            std::vector<std::string> unicodeTerms =
+                tokenizeString(unicode.c_str(), language, options);
+
+            ASSERT_EQUALS(asciiTerms.size() + 1, unicodeTerms.size());
+            unicodeTerms.pop_back();
+            for (size_t i = 0; i < asciiTerms.size(); ++i) {
+                ASSERT_EQUALS(asciiTerms[i], unicodeTerms[i]);
+            }
+        }
+    }
+}
+
+// Ensure that one tokenizer can switch between ASCII and non-ASCII documents.
+TEST(FtsUnicodeTokenizer, ResetBetweenAsciiAndUnicodeDocuments) {
+    StatusWithFTSLanguage swl = FTSLanguage::make("english", TEXT_INDEX_VERSION_3);
+    ASSERT_OK(swl);
+    UnicodeFTSTokenizer tokenizer(swl.getValue());
+
+    tokenizer.reset("caf\xc3\xa9 running", FTSTokenizer::kNone);
+    ASSERT(tokenizer.moveNext());
+    ASSERT_EQUALS("cafe", tokenizer.get());
+    ASSERT(tokenizer.moveNext());
+    ASSERT_EQUALS("run", tokenizer.get());
+    ASSERT_FALSE(tokenizer.moveNext());
+
+    tokenizer.reset("Dogs", FTSTokenizer::kNone);
+    ASSERT(tokenizer.moveNext());
+    ASSERT_EQUALS("dog", tokenizer.get());
+    ASSERT_FALSE(tokenizer.moveNext());
+
+    tokenizer.reset("\xc3\x89T\xc3\x89", FTSTokenizer::kNone);
+    ASSERT(tokenizer.moveNext());
+    ASSERT_EQUALS("ete", tokenizer.get());
+    ASSERT_FALSE(tokenizer.moveNext());
+}
+
 }  // namespace fts
 }  // namespace mongo
@@ -28,16 +28,84 @@
 *    it in the license file.
 */
 
+#include <boost/thread/tss.hpp>
 #include <cstdlib>
+#include <iterator>
+#include <list>
+#include <map>
+#include <utility>
 
 #include "mongo/db/fts/stemmer.h"
+#include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
 namespace fts {
 
-Stemmer::Stemmer(const FTSLanguage* language) {
+namespace {
+
+// Words longer than this are rare enough that caching their stems isn't worth the memory.
+const size_t kMaxCachedWordLength = 32;
+
+// The number of stems each thread remembers per language.
+const size_t kStemCacheSize = 512;
+
+/**
+ * A least recently used cache of the stems of one language's words.
+ */
+class StemCache {
+public:
+    /**
+     * Returns the cached stem of 'word', or nullptr if it isn't cached. The returned string is
+     * valid until the next call to insert().
+     */
+    const std::string* find(StringData word) {
+        auto it = _index.find(word);
+        if (it == _index.end()) {
+            return nullptr;
+        }
+        _entries.splice(_entries.begin(), _entries, it->second);
+        return &it->second->second;
+    }
+
+    void insert(StringData word, StringData stem) {
+        if (_entries.size() < kStemCacheSize) {
+            _entries.emplace_front(word.toString(), stem.toString());
+        } else {
+            // Reuse the least recently used entry and its strings' buffers.
+            _index.erase(_entries.back().first);
+            _entries.splice(_entries.begin(), _entries, std::prev(_entries.end()));
+            _entries.front().first.assign(word.rawData(), word.size());
+            _entries.front().second.assign(stem.rawData(), stem.size());
+        }
+        _index[word] = _entries.begin();
+    }
+
+private:
+    using Entry = std::pair<std::string, std::string>;
+
+    std::list<Entry> _entries;  // Most recently used first.
+    StringMap<std::list<Entry>::iterator> _index;
+};
+
+using StemCaches = std::map<const FTSLanguage*, StemCache>;
+
+boost::thread_specific_ptr<StemCaches> threadStemCaches;
+
+StemCache* getStemCache(const FTSLanguage* language) {
+    StemCaches* caches = threadStemCaches.get();
+    if (!caches) {
+        caches = new StemCaches();
+        threadStemCaches.reset(caches);
+    }
+    return &(*caches)[language];
+}
+
+}  // namespace
+
+Stemmer::Stemmer(const FTSLanguage* language) : _language(language) {
     _stemmer = NULL;
     if (language->str() != "none")
         _stemmer = sb_stemmer_new(language->str().c_str(), "UTF_8");
@@ -54,6 +122,21 @@ StringData Stemmer::stem(StringData word) const {
     if (!_stemmer)
         return word;
 
+    if (word.size() > kMaxCachedWordLength)
+        return _stemUncached(word);
+
+    StemCache* cache = getStemCache(_language);
+    if (const std::string* cached = cache->find(word)) {
+        _cachedStem.assign(*cached);
+        return _cachedStem;
+    }
+
+    StringData stemmed = _stemUncached(word);
+    cache->insert(word, stemmed);
+    return stemmed;
+}
+
+StringData Stemmer::_stemUncached(StringData word) const {
     const sb_symbol* sb_sym =
         sb_stemmer_stem(_stemmer, (const sb_symbol*)word.rawData(), word.size());
 
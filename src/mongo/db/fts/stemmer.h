@@ -31,6 +31,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "mongo/base/string_data.h"
 #include "mongo/db/fts/fts_language.h"
 #include "third_party/libstemmer_c/include/libstemmer.h"
@@ -43,6 +45,9 @@ namespace fts {
  * maintains case
  * but works
  * running/Running -> run/Run
+ *
+ * Stems are remembered in a small per-thread LRU cache for each language, since the words of a
+ * text index repeat far more often than they are new.
  */
 class Stemmer {
     MONGO_DISALLOW_COPYING(Stemmer);
@@ -61,7 +66,16 @@ public:
     StringData stem(StringData word) const;
 
 private:
+    /**
+     * Stems 'word' with libstemmer. The result is valid until the next call to the stemmer.
+     */
+    StringData _stemUncached(StringData word) const;
+
+    const FTSLanguage* const _language;
     struct sb_stemmer* _stemmer;
+
+    // Holds the last stem found in the cache, which later cache updates may evict.
+    mutable std::string _cachedStem;
 };
 }
 }
@@ -48,5 +48,25 @@ TEST(English, Caps) {
     ASSERT_EQUALS("unit", s.stem("united"));
     ASSERT_EQUALS("Unite", s.stem("United"));
 }
+
+TEST(English, CachedStems) {
+    Stemmer s(&languageEnglishV2);
+    Stemmer other(&languageEnglishV2);
+    ASSERT_EQUALS("run", s.stem("running"));
+
+    // Stems another stemmer of the same language found come from the thread's cache.
+    StringData cached = other.stem("running");
+    ASSERT_EQUALS("run", cached);
+    ASSERT_EQUALS("dog", s.stem("dogs"));
+    ASSERT_EQUALS("run", cached);
+
+    // Enough distinct words to evict "running" from the cache.
+    for (int i = 0; i < 1000; i++) {
+        std::string word = "walking" + std::to_string(i);
+        ASSERT_EQUALS(word, s.stem(word));
+    }
+    ASSERT_EQUALS("run", s.stem("running"));
+    ASSERT_EQUALS("Run", s.stem("Running"));
+}
 }
 }
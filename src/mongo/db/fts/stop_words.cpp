@@ -28,6 +28,7 @@
 *    it in the license file.
 */
 
+#include <algorithm>
 #include <set>
 #include <string>
 
@@ -51,8 +52,10 @@ StopWords empty;
 StopWords::StopWords() {}
 
 StopWords::StopWords(const std::set<std::string>& words) {
-    for (std::set<std::string>::const_iterator i = words.begin(); i != words.end(); ++i)
+    for (std::set<std::string>::const_iterator i = words.begin(); i != words.end(); ++i) {
         _words[*i] = true;
+        _maxWordLength = std::max(_maxWordLength, i->size());
+    }
 }
 
 const StopWords* StopWords::getStopWords(const FTSLanguage* language) {
@@ -49,7 +49,8 @@ public:
     StopWords(const std::set<std::string>& words);
 
     bool isStopWord(StringData word) const {
-        return _words.find(word) != _words.end();
+        // Most words are longer than every stop word, so check the length before hashing.
+        return word.size() <= _maxWordLength && _words.find(word) != _words.end();
     }
 
     size_t numStopWords() const {
@@ -60,6 +61,7 @@ public:
 
 private:
     StringMap<bool> _words;  // Used as a set. The values have no meaning.
+    size_t _maxWordLength = 0;
 };
 }
 }
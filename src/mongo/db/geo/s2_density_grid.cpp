@@ -0,0 +1,114 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/geo/s2_density_grid.h"
+
+#include <cmath>
+#include <limits>
+
+#include "mongo/db/geo/geoconstants.h"
+#include "third_party/s2/s2cellid.h"
+
+namespace mongo {
+
+const int S2DensityGrid::kLevel;
+const size_t S2DensityGrid::kMaxCells;
+const double S2DensityGrid::kSampleWeight = 0.25;
+
+namespace {
+
+const double kMaxEarthDistanceInMeters = M_PI * kRadiusOfEarthInMeters;
+
+uint64_t gridCellId(const S2CellId& cellId) {
+    return cellId.level() > S2DensityGrid::kLevel ? cellId.parent(S2DensityGrid::kLevel).id()
+                                                  : cellId.id();
+}
+
+// The area of the spherical cap within 'radius' meters of a point.
+double capArea(double radius) {
+    const double angle = std::min(radius, kMaxEarthDistanceInMeters) / kRadiusOfEarthInMeters;
+    return 2 * M_PI * kRadiusOfEarthInMeters * kRadiusOfEarthInMeters * (1 - std::cos(angle));
+}
+
+}  // namespace
+
+boost::optional<double> S2DensityGrid::getKeysPerSquareMeter(const S2CellId& cellId) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _keysPerSquareMeter.find(gridCellId(cellId));
+    if (it == _keysPerSquareMeter.end()) {
+        return boost::none;
+    }
+    return it->second;
+}
+
+void S2DensityGrid::recordSample(const S2CellId& cellId,
+                                 double areaSquareMeters,
+                                 long long numKeys) {
+    if (!(areaSquareMeters > 0) || numKeys < 0) {
+        return;
+    }
+    const double sample = numKeys / areaSquareMeters;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    const uint64_t id = gridCellId(cellId);
+    auto it = _keysPerSquareMeter.find(id);
+    if (it != _keysPerSquareMeter.end()) {
+        it->second += kSampleWeight * (sample - it->second);
+    } else if (_keysPerSquareMeter.size() < kMaxCells) {
+        _keysPerSquareMeter.emplace(id, sample);
+    }
+}
+
+size_t S2DensityGrid::numCells() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _keysPerSquareMeter.size();
+}
+
+double S2DensityGrid::ringArea(double inner, double outer) {
+    return capArea(outer) - capArea(std::max(inner, 0.0));
+}
+
+double S2DensityGrid::ringOuterRadius(double inner, double keysPerSquareMeter, double numKeys) {
+    inner = std::max(inner, 0.0);
+    if (!(keysPerSquareMeter > 0)) {
+        // Nothing has been seen here, so the next ring may as well take in everything.
+        return kMaxEarthDistanceInMeters;
+    }
+
+    // Solve capArea(outer) = capArea(inner) + numKeys / keysPerSquareMeter for outer.
+    const double capFraction = (capArea(inner) + numKeys / keysPerSquareMeter) /
+        (2 * M_PI * kRadiusOfEarthInMeters * kRadiusOfEarthInMeters);
+    if (capFraction >= 2) {
+        return kMaxEarthDistanceInMeters;
+    }
+    return std::acos(1 - capFraction) * kRadiusOfEarthInMeters;
+}
+
+}  // namespace mongo
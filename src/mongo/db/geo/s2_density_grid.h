@@ -0,0 +1,104 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <cstdint>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/unordered_map.h"
+#include "mongo/stdx/mutex.h"
+
+class S2CellId;
+
+namespace mongo {
+
+/**
+ * A coarse map of how densely the keys of one 2dsphere index cover the Earth. It lives as long as
+ * the index's access method, and $geoNear queries both consult it and feed it: each search
+ * annulus records how many keys it examined over how much area, and later queries near the same
+ * place size their annuli from that instead of probing the index cell level by cell level.
+ *
+ * The grid only ever chooses how wide an annulus is, so a stale or missing estimate costs time but
+ * never changes which documents a query returns.
+ *
+ * This class is thread-safe.
+ */
+class S2DensityGrid {
+    MONGO_DISALLOW_COPYING(S2DensityGrid);
+
+public:
+    // The level of the grid's cells. Level 8 cells are about 40km across.
+    static const int kLevel = 8;
+
+    // The most cells the grid keeps estimates for. Samples in other cells are dropped once full.
+    static const size_t kMaxCells = 100 * 1000;
+
+    // How much a new sample counts against a cell's previous estimate.
+    static const double kSampleWeight;
+
+    S2DensityGrid() = default;
+
+    /**
+     * Returns the estimated number of index keys per square meter in the grid cell containing
+     * 'cellId', or boost::none if no query has sampled that cell yet.
+     */
+    boost::optional<double> getKeysPerSquareMeter(const S2CellId& cellId) const;
+
+    /**
+     * Records that scanning 'areaSquareMeters' of the Earth around 'cellId' examined 'numKeys'
+     * index keys.
+     */
+    void recordSample(const S2CellId& cellId, double areaSquareMeters, long long numKeys);
+
+    /**
+     * Returns the number of grid cells with an estimate.
+     */
+    size_t numCells() const;
+
+    /**
+     * Returns the area, in square meters, of the part of the Earth's surface between 'inner' and
+     * 'outer' meters from a point.
+     */
+    static double ringArea(double inner, double outer);
+
+    /**
+     * Returns the radius, in meters, that an annulus starting 'inner' meters from its center
+     * needs to reach to hold about 'numKeys' keys at 'keysPerSquareMeter'.
+     */
+    static double ringOuterRadius(double inner, double keysPerSquareMeter, double numKeys);
+
+private:
+    mutable stdx::mutex _mutex;
+
+    // Estimated keys per square meter, by the id of the grid cell.
+    unordered_map<uint64_t, double> _keysPerSquareMeter;
+};
+
+}  // namespace mongo
@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/geo/s2_density_grid.h"
+
+#include <cmath>
+
+#include "mongo/db/geo/geoconstants.h"
+#include "mongo/unittest/unittest.h"
+#include "third_party/s2/s2cellid.h"
+#include "third_party/s2/s2latlng.h"
+
+namespace mongo {
+namespace {
+
+S2CellId cellAt(double lat, double lng) {
+    return S2CellId::FromLatLng(S2LatLng::FromDegrees(lat, lng));
+}
+
+TEST(S2DensityGridTest, UnsampledCellsHaveNoEstimate) {
+    S2DensityGrid grid;
+    ASSERT_FALSE(grid.getKeysPerSquareMeter(cellAt(40.7, -74.0)));
+    ASSERT_EQUALS(0U, grid.numCells());
+}
+
+TEST(S2DensityGridTest, SamplesAreSharedWithinAGridCell) {
+    S2DensityGrid grid;
+    grid.recordSample(cellAt(40.7, -74.0), 1000.0, 10);
+    ASSERT_EQUALS(1U, grid.numCells());
+
+    // A point a few hundred meters away falls in the same grid cell.
+    auto estimate = grid.getKeysPerSquareMeter(cellAt(40.701, -74.001));
+    ASSERT(estimate);
+    ASSERT_APPROX_EQUAL(0.01, *estimate, 1e-12);
+
+    // The other side of the world doesn't.
+    ASSERT_FALSE(grid.getKeysPerSquareMeter(cellAt(-40.7, 106.0)));
+}
+
+TEST(S2DensityGridTest, NewSamplesMoveTheEstimate) {
+    S2DensityGrid grid;
+    const S2CellId cell = cellAt(51.5, -0.1);
+    grid.recordSample(cell, 100.0, 0);
+    ASSERT_EQUALS(0.0, *grid.getKeysPerSquareMeter(cell));
+
+    grid.recordSample(cell, 100.0, 100);
+    ASSERT_APPROX_EQUAL(S2DensityGrid::kSampleWeight, *grid.getKeysPerSquareMeter(cell), 1e-12);
+
+    // Samples without an area are ignored.
+    grid.recordSample(cell, 0.0, 100);
+    ASSERT_APPROX_EQUAL(S2DensityGrid::kSampleWeight, *grid.getKeysPerSquareMeter(cell), 1e-12);
+}
+
+TEST(S2DensityGridTest, RingAreas) {
+    const double earthArea = 4 * M_PI * kRadiusOfEarthInMeters * kRadiusOfEarthInMeters;
+    ASSERT_APPROX_EQUAL(earthArea, S2DensityGrid::ringArea(0, M_PI * kRadiusOfEarthInMeters), 1);
+    ASSERT_APPROX_EQUAL(earthArea / 2,
+                        S2DensityGrid::ringArea(-1, M_PI / 2 * kRadiusOfEarthInMeters),
+                        1);
+
+    // Small rings are nearly flat.
+    ASSERT_APPROX_EQUAL(M_PI * (200.0 * 200.0 - 100.0 * 100.0),
+                        S2DensityGrid::ringArea(100, 200),
+                        1);
+}
+
+TEST(S2DensityGridTest, RingOuterRadiusHoldsTheTargetKeys) {
+    const double density = 1e-6;  // One key per square kilometer.
+    const double outer = S2DensityGrid::ringOuterRadius(5000, density, 100);
+    ASSERT_GT(outer, 5000);
+    ASSERT_APPROX_EQUAL(100, S2DensityGrid::ringArea(5000, outer) * density, 1e-3);
+
+    // An empty neighborhood takes in the rest of the Earth.
+    ASSERT_APPROX_EQUAL(M_PI * kRadiusOfEarthInMeters,
+                        S2DensityGrid::ringOuterRadius(5000, 0, 100),
+                        1e-6);
+    ASSERT_APPROX_EQUAL(M_PI * kRadiusOfEarthInMeters,
+                        S2DensityGrid::ringOuterRadius(5000, 1e-15, 100),
+                        1e-6);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -35,34 +35,91 @@
 #include "mongo/db/hasher.h"
 
 
+#include "mongo/base/data_view.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/util/mongoutils/str.h"
 #include "mongo/util/startup_test.h"
+#include "third_party/murmurhash3/MurmurHash3.h"
 
 namespace mongo {
 
-using std::unique_ptr;
+namespace {
 
-Hasher::Hasher(HashSeed seed) : _seed(seed) {
+long long int digestToHash64(const HashDigest d) {
+    // HashDigest is actually 16 bytes, but we just read 8 bytes
+    ConstDataView digestView(reinterpret_cast<const char*>(d));
+    return digestView.read<LittleEndian<long long int>>();
+}
+
+}  // namespace
+
+Hasher::Hasher(HashSeed seed, int hashVersion) : _seed(seed), _hashVersion(hashVersion) {
+    massert(40223,
+            str::stream() << "Unsupported hashVersion " << hashVersion,
+            isValidHashVersion(hashVersion));
+    reset();
+}
+
+void Hasher::reset() {
+    if (_hashVersion == kMurmur3HashVersion) {
+        _buffer.reset();
+        return;
+    }
     md5_init(&_md5State);
     md5_append(&_md5State, reinterpret_cast<const md5_byte_t*>(&_seed), sizeof(_seed));
 }
 
 void Hasher::addData(const void* keyData, size_t numBytes) {
+    if (_hashVersion == kMurmur3HashVersion) {
+        _buffer.appendBuf(keyData, numBytes);
+        return;
+    }
     md5_append(&_md5State, static_cast<const md5_byte_t*>(keyData), numBytes);
 }
 
 void Hasher::finish(HashDigest out) {
+    if (_hashVersion == kMurmur3HashVersion) {
+        uint64_t h[2];
+        MurmurHash3_x64_128(_buffer.buf(), _buffer.len(), static_cast<uint32_t>(_seed), h);
+        // Store the halves as little-endian, as MD5 digests are, so that hash64 reads the same
+        // key on every platform.
+        DataView digestView(reinterpret_cast<char*>(out));
+        digestView.write<LittleEndian<uint64_t>>(h[0], 0);
+        digestView.write<LittleEndian<uint64_t>>(h[1], sizeof(uint64_t));
+        return;
+    }
     md5_finish(&_md5State, out);
 }
 
 long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed) {
-    unique_ptr<Hasher> h(HasherFactory::createHasher(seed));
-    recursiveHash(h.get(), e, false);
+    return hash64(e, seed, kMD5HashVersion);
+}
+
+long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed, int hashVersion) {
+    Hasher h(seed, hashVersion);
+    recursiveHash(&h, e, false);
     HashDigest d;
-    h->finish(d);
-    // HashDigest is actually 16 bytes, but we just read 8 bytes
-    ConstDataView digestView(reinterpret_cast<const char*>(d));
-    return digestView.read<LittleEndian<long long int>>();
+    h.finish(d);
+    return digestToHash64(d);
+}
+
+void BSONElementHasher::hash64Batch(const std::vector<BSONElement>& elements,
+                                    HashSeed seed,
+                                    int hashVersion,
+                                    std::vector<long long int>* out) {
+    out->clear();
+    out->reserve(elements.size());
+
+    Hasher h(seed, hashVersion);
+    HashDigest d;
+    for (size_t i = 0; i < elements.size(); ++i) {
+        if (i > 0) {
+            h.reset();
+        }
+        recursiveHash(&h, elements[i], false);
+        h.finish(d);
+        out->push_back(digestToHash64(d));
+    }
 }
 
 void BSONElementHasher::recursiveHash(Hasher* h, const BSONElement& e, bool includeFieldName) {
@@ -108,6 +165,8 @@ struct HasherUnitTest : public StartupTest {
         // Hard-coded check to ensure the hash function is consistent across platforms
         BSONObj o = BSON("check" << 42);
         verify(BSONElementHasher::hash64(o.firstElement(), 0) == -944302157085130861LL);
+        verify(BSONElementHasher::hash64(o.firstElement(), 0, kMurmur3HashVersion) ==
+               8715208212397937794LL);
     }
 } hasherUnitTest;
 }
@@ -34,8 +34,11 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/bson/bsonelement.h"
+#include "mongo/bson/util/builder.h"
 #include "mongo/util/md5.hpp"
 
 namespace mongo {
@@ -43,23 +46,41 @@ namespace mongo {
 typedef int HashSeed;
 typedef unsigned char HashDigest[16];
 
+/* The hash function used by a Hasher. Version 0 is MD5, which every hashed index and hashed
+ * shard key built before version 1 existed uses. Version 1 is the much cheaper MurmurHash3
+ * (x64, 128-bit variant), computed the same way on every platform.
+ */
+enum HashVersion { kMD5HashVersion = 0, kMurmur3HashVersion = 1 };
+
 class Hasher {
     MONGO_DISALLOW_COPYING(Hasher);
 
 public:
-    explicit Hasher(HashSeed seed);
+    explicit Hasher(HashSeed seed, int hashVersion = kMD5HashVersion);
     ~Hasher(){};
 
+    static bool isValidHashVersion(int hashVersion) {
+        return hashVersion == kMD5HashVersion || hashVersion == kMurmur3HashVersion;
+    }
+
     // pointer to next part of input key, length in bytes to read
     void addData(const void* keyData, size_t numBytes);
 
     // finish computing the hash, put the result in the digest
-    // only call this once per Hasher
+    // only call this once per Hasher, unless reset() is called in between
     void finish(HashDigest out);
 
+    // start computing a new hash with the same seed and version
+    void reset();
+
 private:
-    md5_state_t _md5State;
     HashSeed _seed;
+    int _hashVersion;
+    md5_state_t _md5State;
+
+    // MurmurHash3 isn't incremental, so version 1 gathers its input here and hashes it all in
+    // finish(). Canonicalized elements are usually short and stay on the stack.
+    StackBufBuilder _buffer;
 };
 
 class HasherFactory {
@@ -69,8 +90,8 @@ public:
     /* Eventually this may be a more sophisticated factory
      * for creating other hashers, but for now use MD5.
      */
-    static Hasher* createHasher(HashSeed seed) {
-        return new Hasher(seed);
+    static Hasher* createHasher(HashSeed seed, int hashVersion = kMD5HashVersion) {
+        return new Hasher(seed, hashVersion);
     }
 
 private:
@@ -104,6 +125,20 @@ public:
      */
     static long long int hash64(const BSONElement& e, HashSeed seed);
 
+    /* As above, using the hash function of "hashVersion" rather than always MD5. Only
+     * hashed indexes whose spec sets "hashVersion" may use a version other than 0.
+     */
+    static long long int hash64(const BSONElement& e, HashSeed seed, int hashVersion);
+
+    /* Computes hash64(e, seed, hashVersion) for each element of "elements" and replaces the
+     * contents of "out" with the results, in the same order. Reuses one Hasher for the whole
+     * batch, which is cheaper than hashing the elements one at a time.
+     */
+    static void hash64Batch(const std::vector<BSONElement>& elements,
+                            HashSeed seed,
+                            int hashVersion,
+                            std::vector<long long int>* out);
+
     /* This incrementally computes the hash of BSONElement "e"
      * using hash function "h".  If "includeFieldName" is true,
      * then the name of the field is hashed in between the type of
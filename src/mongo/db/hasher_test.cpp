@@ -359,5 +359,62 @@ TEST(BSONElementHasher, HashCodeWScope) {
     ASSERT_EQUALS(hashIt(o), 501342939894575968LL);
 }
 
+TEST(BSONElementHasher, Murmur3HashVersionIsPlatformIndependent) {
+    BSONObj o = BSON("check" << 42);
+    ASSERT_EQUALS(BSONElementHasher::hash64(o.firstElement(), 0, kMurmur3HashVersion),
+                  8715208212397937794LL);
+    ASSERT_EQUALS(BSONElementHasher::hash64(o.firstElement(), 1, kMurmur3HashVersion),
+                  -9087602108468514688LL);
+
+    // Long enough to be hashed in 16-byte blocks.
+    o = BSON("check"
+             << "mongodb hashed index");
+    ASSERT_EQUALS(BSONElementHasher::hash64(o.firstElement(), 0, kMurmur3HashVersion),
+                  -6468429703851763438LL);
+}
+
+TEST(BSONElementHasher, MD5IsTheDefaultHashVersion) {
+    BSONObj o = BSON("check" << 42);
+    ASSERT_EQUALS(BSONElementHasher::hash64(o.firstElement(), 0, kMD5HashVersion), hashIt(o));
+    ASSERT_NOT_EQUALS(BSONElementHasher::hash64(o.firstElement(), 0, kMurmur3HashVersion),
+                      hashIt(o));
+}
+
+TEST(BSONElementHasher, Murmur3HashVersionSquashesNumericTypes) {
+    auto murmurHashIt = [](const BSONObj& object) {
+        return BSONElementHasher::hash64(object.firstElement(), 0, kMurmur3HashVersion);
+    };
+    ASSERT_EQUALS(murmurHashIt(BSON("a" << 3)), murmurHashIt(BSON("a" << 3.1)));
+    ASSERT_EQUALS(murmurHashIt(BSON("a" << BSON("b" << 4))),
+                  murmurHashIt(BSON("a" << BSON("b" << 4LL))));
+}
+
+TEST(BSONElementHasher, BatchHashesMatchSingleHashes) {
+    BSONObj o = fromjson("{a: 1, b: 'string', c: {d: [1, 2, 3]}, e: null, f: 2.5}");
+    std::vector<BSONElement> elements;
+    for (auto&& element : o) {
+        elements.push_back(element);
+    }
+
+    for (int hashVersion : {0, 1}) {
+        std::vector<long long int> hashes;
+        BSONElementHasher::hash64Batch(elements, 7, hashVersion, &hashes);
+        ASSERT_EQUALS(elements.size(), hashes.size());
+        for (size_t i = 0; i < elements.size(); ++i) {
+            ASSERT_EQUALS(BSONElementHasher::hash64(elements[i], 7, hashVersion), hashes[i]);
+        }
+    }
+
+    std::vector<long long int> hashes{1, 2};
+    BSONElementHasher::hash64Batch(std::vector<BSONElement>(), 0, 0, &hashes);
+    ASSERT(hashes.empty());
+}
+
+TEST(BSONElementHasher, UnknownHashVersionIsRejected) {
+    BSONObj o = BSON("check" << 42);
+    ASSERT_THROWS_CODE(
+        BSONElementHasher::hash64(o.firstElement(), 0, 2), MsgAssertionException, 40223);
+}
+
 }  // namespace
 }  // namespace mongo
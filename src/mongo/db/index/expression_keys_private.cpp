@@ -30,6 +30,8 @@
 
 #include "mongo/db/index/expression_keys_private.h"
 
+#include <algorithm>
+#include <exception>
 #include <utility>
 
 #include "mongo/db/bson/dotted_path_support.h"
@@ -43,16 +45,27 @@
 #include "mongo/db/index/s2_common.h"
 #include "mongo/db/index_names.h"
 #include "mongo/db/query/collation/collation_index_key.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "third_party/s2/s2cell.h"
 #include "third_party/s2/s2regioncoverer.h"
 
+namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(internalIndexS2ParallelCoveringMinBytes, int, 64 * 1024);
+
+}  // namespace mongo
+
 namespace {
 
 using namespace mongo;
 
+// The most threads that compute the coverings of one document's geometries.
+const size_t kMaxS2CoveringThreads = 4;
+
 namespace dps = ::mongo::dotted_path_support;
 
 //
@@ -124,14 +137,73 @@ Status S2GetKeysForElement(const BSONElement& element,
  * Returns true if an indexed element of the document uses multiple cells for its covering, and
  * returns false otherwise.
  */
+/**
+ * Computes the covering of each of 'elements' into 'cells' and the outcome into 'statuses'. An
+ * exception that computing an element's covering throws goes into 'errors' instead.
+ *
+ * Coverings of large polygons are the expensive part of generating 2dsphere keys, and each
+ * element's covering is independent of the others', so a document with several large geometries
+ * spreads them over a few threads.
+ */
+void S2GetKeysForElements(const std::vector<BSONElement>& elements,
+                          const S2IndexingParams& params,
+                          std::vector<vector<S2CellId>>* cells,
+                          std::vector<Status>* statuses,
+                          std::vector<std::exception_ptr>* errors) {
+    cells->resize(elements.size());
+    statuses->assign(elements.size(), Status::OK());
+    errors->assign(elements.size(), std::exception_ptr());
+
+    auto coverElements = [&](size_t first, size_t stride) {
+        for (size_t i = first; i < elements.size(); i += stride) {
+            try {
+                (*statuses)[i] = S2GetKeysForElement(elements[i], params, &(*cells)[i]);
+            } catch (...) {
+                (*errors)[i] = std::current_exception();
+            }
+        }
+    };
+
+    size_t totalBytes = 0;
+    for (const auto& element : elements) {
+        totalBytes += element.size();
+    }
+
+    const int minBytes = internalIndexS2ParallelCoveringMinBytes.load();
+    if (elements.size() < 2 || minBytes <= 0 || totalBytes < static_cast<size_t>(minBytes)) {
+        coverElements(0, 1);
+        return;
+    }
+
+    const size_t numThreads = std::min(elements.size(), kMaxS2CoveringThreads);
+    std::vector<stdx::thread> threads;
+    for (size_t i = 1; i < numThreads; ++i) {
+        threads.emplace_back(coverElements, i, numThreads);
+    }
+    coverElements(0, numThreads);
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
 bool getS2GeoKeys(const BSONObj& document,
-                  const BSONElementSet& elements,
+                  const BSONElementSet& elementSet,
                   const S2IndexingParams& params,
                   BSONObjSet* out) {
+    const std::vector<BSONElement> elements(elementSet.begin(), elementSet.end());
+    std::vector<vector<S2CellId>> cellsPerElement;
+    std::vector<Status> statuses;
+    std::vector<std::exception_ptr> errors;
+    S2GetKeysForElements(elements, params, &cellsPerElement, &statuses, &errors);
+
     bool everGeneratedMultipleCells = false;
-    for (BSONElementSet::iterator i = elements.begin(); i != elements.end(); ++i) {
-        vector<S2CellId> cells;
-        Status status = S2GetKeysForElement(*i, params, &cells);
+    for (size_t i = 0; i < elements.size(); ++i) {
+        const vector<S2CellId>& cells = cellsPerElement[i];
+        if (errors[i]) {
+            std::rethrow_exception(errors[i]);
+        }
+
+        const Status& status = statuses[i];
         uassert(16755,
                 str::stream() << "Can't extract geo keys: " << document << "  " << status.reason(),
                 status.isOK());
@@ -385,8 +457,8 @@ void ExpressionKeysPrivate::getHashKeys(const BSONObj& obj,
 
 // static
 long long int ExpressionKeysPrivate::makeSingleHashKey(const BSONElement& e, HashSeed seed, int v) {
-    massert(16767, "Only HashVersion 0 has been defined", v == 0);
-    return BSONElementHasher::hash64(e, seed);
+    massert(16767, "Only HashVersions 0 and 1 have been defined", Hasher::isValidHashVersion(v));
+    return BSONElementHasher::hash64(e, seed, v);
 }
 
 // static
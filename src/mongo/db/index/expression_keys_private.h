@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <vector>
 
 #include "mongo/bson/bsonmisc.h"
@@ -47,6 +48,12 @@ class FTSSpec;
 
 }  // namespace fts
 
+/**
+ * The total size of a document's 2dsphere geometries above which getS2Keys() computes their
+ * coverings on several threads. 0 disables the parallel computation.
+ */
+extern std::atomic<int> internalIndexS2ParallelCoveringMinBytes;  // NOLINT
+
 /**
  * Do not use this class or any of its methods directly.  The key generation of btree-indexed
  * expression indices is kept outside of the access method for testing and for upgrade
@@ -72,6 +72,17 @@ void ExpressionParams::parseHashParams(const BSONObj& infoObj,
                                        HashSeed* seedOut,
                                        int* versionOut,
                                        std::string* fieldOut) {
+    parseHashSeedAndVersion(infoObj, seedOut, versionOut);
+
+    // Get the hashfield name
+    BSONElement firstElt = infoObj.getObjectField("key").firstElement();
+    massert(16765, "error: no hashed index field", firstElt.str().compare(IndexNames::HASHED) == 0);
+    *fieldOut = firstElt.fieldName();
+}
+
+void ExpressionParams::parseHashSeedAndVersion(const BSONObj& infoObj,
+                                               HashSeed* seedOut,
+                                               int* versionOut) {
     // Default _seed to DEFAULT_HASH_SEED if "seed" is not included in the index spec
     // or if the value of "seed" is not a number
 
@@ -84,16 +95,10 @@ void ExpressionParams::parseHashParams(const BSONObj& infoObj,
         *seedOut = infoObj["seed"].numberInt();
     }
 
-    // In case we have hashed indexes based on other hash functions in the future, we store
-    // a hashVersion number. If hashVersion changes, "makeSingleHashKey" will need to change
-    // accordingly.  Defaults to 0 if "hashVersion" is not included in the index spec or if
-    // the value of "hashversion" is not a number
+    // Hashed indexes store the version of the hash function that computed their keys, see
+    // HashVersion in hasher.h. Defaults to 0 (MD5) if "hashVersion" is not included in the
+    // index spec or if the value of "hashversion" is not a number
     *versionOut = infoObj["hashVersion"].numberInt();
-
-    // Get the hashfield name
-    BSONElement firstElt = infoObj.getObjectField("key").firstElement();
-    massert(16765, "error: no hashed index field", firstElt.str().compare(IndexNames::HASHED) == 0);
-    *fieldOut = firstElt.fieldName();
 }
 
 void ExpressionParams::parseHaystackParams(const BSONObj& infoObj,
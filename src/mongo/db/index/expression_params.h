@@ -49,6 +49,12 @@ void parseHashParams(const BSONObj& infoObj,
                      int* versionOut,
                      std::string* fieldOut);
 
+/**
+ * Like parseHashParams, but doesn't require 'infoObj' to have a hashed key pattern. Used by the
+ * planner to hash query values the same way the index hashed its keys.
+ */
+void parseHashSeedAndVersion(const BSONObj& infoObj, HashSeed* seedOut, int* versionOut);
+
 void parseHaystackParams(const BSONObj& infoObj,
                          std::string* geoFieldOut,
                          std::vector<std::string>* otherFieldsOut,
@@ -30,6 +30,7 @@
 #include "mongo/db/hasher.h"
 #include "mongo/db/index/expression_keys_private.h"
 #include "mongo/db/index/expression_params.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -48,6 +49,11 @@ HashAccessMethod::HashAccessMethod(IndexCatalogEntry* btreeState, SortedDataInte
 
     ExpressionParams::parseHashParams(descriptor->infoObj(), &_seed, &_hashVersion, &_hashedField);
 
+    uassert(40224,
+            str::stream() << "Unsupported hashVersion " << _hashVersion
+                          << " for hashed index, must be 0 or 1",
+            Hasher::isValidHashVersion(_hashVersion));
+
     _collator = btreeState->getCollator();
 }
 
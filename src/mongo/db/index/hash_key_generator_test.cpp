@@ -123,4 +123,29 @@ TEST(HashKeyGeneratorTest, NoCollation) {
     ASSERT(assertKeysetsEqual(expectedKeys, actualKeys));
 }
 
+TEST(HashKeyGeneratorTest, HashVersionOneUsesMurmur3) {
+    BSONObj obj = fromjson("{a: 'string'}");
+    BSONObjSet actualKeys;
+    ExpressionKeysPrivate::getHashKeys(
+        obj, "a", kHashSeed, kMurmur3HashVersion, false, nullptr, &actualKeys);
+
+    BSONObjSet expectedKeys;
+    expectedKeys.insert(
+        BSON("" << BSONElementHasher::hash64(obj["a"], kHashSeed, kMurmur3HashVersion)));
+    ASSERT(assertKeysetsEqual(expectedKeys, actualKeys));
+
+    BSONObjSet md5Keys;
+    md5Keys.insert(makeHashKey(obj["a"]));
+    ASSERT(expectedKeys != md5Keys);
+}
+
+TEST(HashKeyGeneratorTest, UnknownHashVersionIsRejected) {
+    BSONObj obj = fromjson("{a: 'string'}");
+    BSONObjSet actualKeys;
+    ASSERT_THROWS_CODE(ExpressionKeysPrivate::getHashKeys(
+                           obj, "a", kHashSeed, 2, false, nullptr, &actualKeys),
+                       MsgAssertionException,
+                       16767);
+}
+
 }  // namespace
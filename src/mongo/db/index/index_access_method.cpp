@@ -32,6 +32,7 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -42,6 +43,7 @@
 #include "mongo/db/curop.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/keypattern.h"
+#include "mongo/db/matcher/expression.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/server_parameters.h"
@@ -72,6 +74,9 @@ bool isMultikeyFromPaths(const MultikeyPaths& multikeyPaths) {
 
 MONGO_EXPORT_SERVER_PARAMETER(failIndexKeyTooLong, bool, true);
 
+// Number of threads each index build sorts its keys with.
+MONGO_EXPORT_SERVER_PARAMETER(indexBuildSorterThreads, int, 4);
+
 //
 // Comparison for external sorter interface
 //
@@ -103,6 +108,46 @@ private:
     const int _version;
 };
 
+/**
+ * On commit, appends a side write to the index's list of pending side writes.
+ */
+class IndexAccessMethod::CaptureSideWriteOnCommit : public RecoveryUnit::Change {
+public:
+    CaptureSideWriteOnCommit(IndexAccessMethod* index, SideWrite write)
+        : _index(index), _write(std::move(write)) {}
+
+    void commit() final {
+        stdx::lock_guard<stdx::mutex> lk(_index->_sideWritesMutex);
+        _index->_sideWrites.push_back(std::move(_write));
+    }
+    void rollback() final {}
+
+private:
+    IndexAccessMethod* const _index;
+    SideWrite _write;
+};
+
+/**
+ * On commit, discards the 'numWrites' oldest side writes, which have been drained.
+ */
+class IndexAccessMethod::DiscardSideWritesOnCommit : public RecoveryUnit::Change {
+public:
+    DiscardSideWritesOnCommit(IndexAccessMethod* index, size_t numWrites)
+        : _index(index), _numWrites(numWrites) {}
+
+    void commit() final {
+        stdx::lock_guard<stdx::mutex> lk(_index->_sideWritesMutex);
+        invariant(_numWrites <= _index->_sideWrites.size());
+        _index->_sideWrites.erase(_index->_sideWrites.begin(),
+                                  _index->_sideWrites.begin() + _numWrites);
+    }
+    void rollback() final {}
+
+private:
+    IndexAccessMethod* const _index;
+    const size_t _numWrites;
+};
+
 IndexAccessMethod::IndexAccessMethod(IndexCatalogEntry* btreeState, SortedDataInterface* btree)
     : _btreeState(btreeState), _descriptor(btreeState->descriptor()), _newInterface(btree) {
     verify(0 == _descriptor->version() || 1 == _descriptor->version());
@@ -122,6 +167,19 @@ Status IndexAccessMethod::insert(OperationContext* txn,
                                  const InsertDeleteOptions& options,
                                  int64_t* numInserted) {
     invariant(numInserted);
+    if (_capturingSideWrites) {
+        *numInserted = 0;
+        _captureSideWrite(txn, loc, {});
+        return Status::OK();
+    }
+    return _indexDocument(txn, obj, loc, options, numInserted);
+}
+
+Status IndexAccessMethod::_indexDocument(OperationContext* txn,
+                                         const BSONObj& obj,
+                                         const RecordId& loc,
+                                         const InsertDeleteOptions& options,
+                                         int64_t* numInserted) {
     *numInserted = 0;
     BSONObjSet keys;
     MultikeyPaths multikeyPaths;
@@ -169,6 +227,103 @@ Status IndexAccessMethod::insert(OperationContext* txn,
     return ret;
 }
 
+Status IndexAccessMethod::insertBatch(OperationContext* txn,
+                                      const std::vector<BsonRecord>& records,
+                                      const InsertDeleteOptions& options,
+                                      int64_t* numInserted) {
+    invariant(numInserted);
+    *numInserted = 0;
+
+    if (_capturingSideWrites) {
+        for (auto&& record : records) {
+            _captureSideWrite(txn, record.id, {});
+        }
+        return Status::OK();
+    }
+
+    struct KeyToInsert {
+        BSONObj key;
+        RecordId loc;
+        size_t recordIndex;
+    };
+    vector<KeyToInsert> keysToInsert;
+    MultikeyPaths batchMultikeyPaths;
+    for (size_t i = 0; i < records.size(); ++i) {
+        BSONObjSet keys;
+        MultikeyPaths multikeyPaths;
+        // Delegate to the subclass.
+        getKeys(*records[i].docPtr, &keys, &multikeyPaths);
+
+        for (BSONObjSet::const_iterator it = keys.begin(); it != keys.end(); ++it) {
+            keysToInsert.push_back({*it, records[i].id, i});
+        }
+
+        if (!multikeyPaths.empty()) {
+            if (batchMultikeyPaths.empty()) {
+                batchMultikeyPaths = std::move(multikeyPaths);
+            } else {
+                invariant(batchMultikeyPaths.size() == multikeyPaths.size());
+                for (size_t j = 0; j < multikeyPaths.size(); ++j) {
+                    batchMultikeyPaths[j].insert(multikeyPaths[j].begin(), multikeyPaths[j].end());
+                }
+            }
+        }
+    }
+
+    const Ordering ordering = Ordering::make(_descriptor->keyPattern());
+    std::sort(keysToInsert.begin(),
+              keysToInsert.end(),
+              [&ordering](const KeyToInsert& lhs, const KeyToInsert& rhs) {
+                  const int cmp = lhs.key.woCompare(rhs.key, ordering, false);
+                  return cmp < 0 || (cmp == 0 && lhs.loc < rhs.loc);
+              });
+
+    vector<int64_t> numInsertedPerRecord(records.size(), 0);
+    for (auto i = keysToInsert.begin(); i != keysToInsert.end(); ++i) {
+        Status status = _newInterface->insert(txn, i->key, i->loc, options.dupsAllowed);
+
+        // Everything's OK, carry on.
+        if (status.isOK()) {
+            ++numInsertedPerRecord[i->recordIndex];
+            ++*numInserted;
+            continue;
+        }
+
+        // Error cases.
+
+        if (status.code() == ErrorCodes::KeyTooLong && ignoreKeyTooLong(txn)) {
+            continue;
+        }
+
+        if (status.code() == ErrorCodes::DuplicateKeyValue) {
+            // A document might be indexed multiple times during a background index build
+            // if it moves ahead of the collection scan cursor (e.g. via an update).
+            if (!_btreeState->isReady(txn)) {
+                LOG(3) << "key " << i->key << " already in index during background indexing (ok)";
+                continue;
+            }
+        }
+
+        // Clean up after ourselves.
+        for (auto j = keysToInsert.begin(); j != i; ++j) {
+            removeOneKey(txn, j->key, j->loc, options.dupsAllowed);
+        }
+        *numInserted = 0;
+
+        return status;
+    }
+
+    const bool anyRecordInsertedMultipleKeys =
+        std::any_of(numInsertedPerRecord.begin(),
+                    numInsertedPerRecord.end(),
+                    [](int64_t numInsertedForRecord) { return numInsertedForRecord > 1; });
+    if (anyRecordInsertedMultipleKeys || isMultikeyFromPaths(batchMultikeyPaths)) {
+        _btreeState->setMultikey(txn, batchMultikeyPaths);
+    }
+
+    return Status::OK();
+}
+
 void IndexAccessMethod::removeOneKey(OperationContext* txn,
                                      const BSONObj& key,
                                      const RecordId& loc,
@@ -208,6 +363,11 @@ Status IndexAccessMethod::remove(OperationContext* txn,
     MultikeyPaths* multikeyPaths = nullptr;
     getKeys(obj, &keys, multikeyPaths);
 
+    if (_capturingSideWrites) {
+        _captureSideWrite(txn, loc, std::vector<BSONObj>(keys.begin(), keys.end()));
+        return Status::OK();
+    }
+
     for (BSONObjSet::const_iterator i = keys.begin(); i != keys.end(); ++i) {
         removeOneKey(txn, *i, loc, options.dupsAllowed);
         ++*numDeleted;
@@ -270,6 +430,10 @@ bool IndexAccessMethod::appendCustomStats(OperationContext* txn,
     return _newInterface->appendCustomStats(txn, output, scale);
 }
 
+void IndexAccessMethod::appendStorageIOStats(OperationContext* txn, BSONObjBuilder* output) const {
+    _newInterface->appendStorageIOStats(txn, output);
+}
+
 long long IndexAccessMethod::getSpaceUsedBytes(OperationContext* txn) const {
     return _newInterface->getSpaceUsedBytes(txn);
 }
@@ -353,6 +517,11 @@ Status IndexAccessMethod::update(OperationContext* txn,
         return Status(ErrorCodes::InternalError, "Invalid UpdateTicket in update");
     }
 
+    if (_capturingSideWrites) {
+        _captureSideWrite(txn, ticket.loc, ticket.removed);
+        return Status::OK();
+    }
+
     if (ticket.oldKeys.size() + ticket.added.size() - ticket.removed.size() > 1 ||
         isMultikeyFromPaths(ticket.newMultikeyPaths)) {
         _btreeState->setMultikey(txn, ticket.newMultikeyPaths);
@@ -394,7 +563,8 @@ IndexAccessMethod::BulkBuilder::BulkBuilder(const IndexAccessMethod* index,
           SortOptions()
               .TempDir(storageGlobalParams.dbpath + "/_tmp")
               .ExtSortAllowed()
-              .MaxMemoryUsageBytes(100 * 1024 * 1024),
+              .MaxMemoryUsageBytes(100 * 1024 * 1024)
+              .NumThreads(std::max(1, indexBuildSorterThreads.load())),
           BtreeExternalSortComparison(descriptor->keyPattern(), descriptor->version()))),
       _real(index) {}
 
@@ -518,6 +688,105 @@ Status IndexAccessMethod::commitBulk(OperationContext* txn,
     return Status::OK();
 }
 
+void IndexAccessMethod::setMultikeyForBulk(OperationContext* txn, const BulkBuilder& bulk) {
+    if (!bulk._everGeneratedMultipleKeys && !isMultikeyFromPaths(bulk._indexMultikeyPaths)) {
+        return;
+    }
+
+    MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
+        WriteUnitOfWork wunit(txn);
+        _btreeState->setMultikey(txn, bulk._indexMultikeyPaths);
+        wunit.commit();
+    }
+    MONGO_WRITE_CONFLICT_RETRY_LOOP_END(txn, "setting index multikey flag", "");
+}
+
+void IndexAccessMethod::beginCapturingSideWrites() {
+    invariant(!_capturingSideWrites);
+    _capturingSideWrites = true;
+}
+
+void IndexAccessMethod::stopCapturingSideWrites() {
+    _capturingSideWrites = false;
+
+    stdx::lock_guard<stdx::mutex> lk(_sideWritesMutex);
+    _sideWrites.clear();
+}
+
+size_t IndexAccessMethod::numPendingSideWrites() const {
+    stdx::lock_guard<stdx::mutex> lk(_sideWritesMutex);
+    return _sideWrites.size();
+}
+
+void IndexAccessMethod::recordSideWrite(const RecordId& loc) {
+    invariant(_capturingSideWrites);
+
+    stdx::lock_guard<stdx::mutex> lk(_sideWritesMutex);
+    _sideWrites.push_back(SideWrite{loc, {}});
+}
+
+void IndexAccessMethod::_captureSideWrite(OperationContext* txn,
+                                          const RecordId& loc,
+                                          std::vector<BSONObj> removedKeys) {
+    txn->recoveryUnit()->registerChange(
+        new CaptureSideWriteOnCommit(this, SideWrite{loc, std::move(removedKeys)}));
+}
+
+Status IndexAccessMethod::drainSideWrites(OperationContext* txn,
+                                          const RecordStore* recordStore,
+                                          const InsertDeleteOptions& options,
+                                          size_t maxWrites,
+                                          set<RecordId>* dupRecords) {
+    invariant(_capturingSideWrites);
+
+    vector<SideWrite> writes;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_sideWritesMutex);
+        const auto end = _sideWrites.begin() + std::min(maxWrites, _sideWrites.size());
+        writes.assign(_sideWrites.begin(), end);
+    }
+
+    // The keys removed by the whole batch are taken out of the index before any document is
+    // reindexed, so that a key which moved from one document to another isn't a duplicate.
+    set<RecordId> locs;
+    for (auto&& write : writes) {
+        for (auto&& key : write.removedKeys) {
+            removeOneKey(txn, key, write.loc, options.dupsAllowed);
+        }
+        locs.insert(write.loc);
+    }
+
+    // Each document is reindexed as of our snapshot, which includes every write drained here since
+    // a side write is only recorded after it commits. This makes the result independent of the
+    // order in which concurrent operations recorded their writes.
+    const MatchExpression* filter = _btreeState->getFilterExpression();
+    for (auto&& loc : locs) {
+        RecordData record;
+        if (!recordStore->findRecord(txn, loc, &record)) {
+            // The document was deleted.
+            continue;
+        }
+
+        const BSONObj obj = record.releaseToBson();
+        if (filter && !filter->matchesBSON(obj)) {
+            continue;
+        }
+
+        int64_t numInserted;
+        Status status = _indexDocument(txn, obj, loc, options, &numInserted);
+        if (!status.isOK()) {
+            if (dupRecords && status.code() == ErrorCodes::DuplicateKey) {
+                dupRecords->insert(loc);
+                continue;
+            }
+            return status;
+        }
+    }
+
+    txn->recoveryUnit()->registerChange(new DiscardSideWritesOnCommit(this, writes.size()));
+    return Status::OK();
+}
+
 }  // namespace mongo
 
 #include "mongo/db/sorter/sorter.cpp"
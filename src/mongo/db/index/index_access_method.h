@@ -29,7 +29,10 @@
 #pragma once
 
 #include <atomic>
+#include <deque>
 #include <memory>
+#include <set>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/index/index_descriptor.h"
@@ -37,7 +40,9 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/sorter/sorter.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/sorted_data_interface.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
@@ -84,7 +89,19 @@ public:
                   int64_t* numInserted);
 
     /**
-     * Analogous to above, but remove the records instead of inserting them.
+     * Equivalent to calling insert() for each of 'records', except that the keys generated for
+     * the whole batch are inserted in index order, so that the storage engine moves forward
+     * through the index instead of seeking to a random position for every key.
+     * 'numInserted' will be set to the number of keys added to the index. If any key cannot be
+     * inserted, none of the keys for the batch are.
+     */
+    Status insertBatch(OperationContext* txn,
+                       const std::vector<BsonRecord>& records,
+                       const InsertDeleteOptions& options,
+                       int64_t* numInserted);
+
+    /**
+     * Analogous to insert(), but remove the records instead of inserting them.
      * 'numDeleted' will be set to the number of keys removed from the index for the document.
      */
     Status remove(OperationContext* txn,
@@ -177,6 +194,11 @@ public:
      */
     bool appendCustomStats(OperationContext* txn, BSONObjBuilder* result, double scale) const;
 
+    /**
+     * Add the storage engine's cache and I/O counters for this index to 'result'.
+     */
+    void appendStorageIOStats(OperationContext* txn, BSONObjBuilder* result) const;
+
     /**
      * @return The number of bytes consumed by this index.
      *         Exactly what is counted is not defined based on padding, re-use, etc...
@@ -250,6 +272,58 @@ public:
                       bool dupsAllowed,
                       std::set<RecordId>* dups);
 
+    /**
+     * Marks the index multikey if any document inserted into 'bulk' generated multiple keys.
+     *
+     * commitBulk() does this on its own. Calling this first, from a thread holding the collection
+     * lock, allows commitBulk() to run on an OperationContext which holds no locks.
+     */
+    void setMultikeyForBulk(OperationContext* txn, const BulkBuilder& bulk);
+
+    //
+    // Side writes support
+    //
+
+    /**
+     * Makes insert(), insertBatch(), remove() and update() record which documents they changed
+     * instead of writing to the index, until stopCapturingSideWrites() is called. A hybrid
+     * background build calls this before any other operation can see the index, bulk loads the
+     * index from a collection scan, and then applies the recorded writes with drainSideWrites().
+     *
+     * Both require holding an exclusive lock on the collection. Stopping discards any writes
+     * which haven't been drained.
+     */
+    void beginCapturingSideWrites();
+    void stopCapturingSideWrites();
+
+    /**
+     * Returns the number of side writes which haven't been drained yet.
+     */
+    size_t numPendingSideWrites() const;
+
+    /**
+     * Records that the document at 'loc' must be reindexed when the side writes are drained.
+     * Unlike the writes captured from other operations, this takes effect immediately rather than
+     * when the current WriteUnitOfWork commits.
+     */
+    void recordSideWrite(const RecordId& loc);
+
+    /**
+     * Applies up to 'maxWrites' of the oldest side writes: removes the keys they took out of the
+     * index, then reindexes the version in 'recordStore' of each document they touched. The
+     * applied writes are discarded once the current WriteUnitOfWork commits, so this may be
+     * retried after a WriteConflictException.
+     *
+     * Documents are read at the storage snapshot of 'txn', which must not have been opened before
+     * this is called. If 'dupRecords' is not NULL, documents which can't be reindexed because of
+     * a uniqueness violation are added to it rather than failing.
+     */
+    Status drainSideWrites(OperationContext* txn,
+                           const RecordStore* recordStore,
+                           const InsertDeleteOptions& options,
+                           size_t maxWrites,
+                           std::set<RecordId>* dupRecords);
+
     /**
      * Fills 'keys' with the keys that should be generated for 'obj' on this index.
      *
@@ -282,12 +356,49 @@ protected:
     const IndexDescriptor* _descriptor;
 
 private:
+    class CaptureSideWriteOnCommit;
+    class DiscardSideWritesOnCommit;
+
+    /**
+     * A write to this index by another operation during a hybrid background build. The document
+     * at 'loc' is reindexed when the write is drained, so only the keys it removed are kept.
+     */
+    struct SideWrite {
+        RecordId loc;
+        std::vector<BSONObj> removedKeys;
+    };
+
+    /**
+     * Implements insert() when side writes aren't being captured.
+     */
+    Status _indexDocument(OperationContext* txn,
+                          const BSONObj& obj,
+                          const RecordId& loc,
+                          const InsertDeleteOptions& options,
+                          int64_t* numInserted);
+
+    /**
+     * Records a side write which takes effect once the current WriteUnitOfWork commits.
+     */
+    void _captureSideWrite(OperationContext* txn,
+                           const RecordId& loc,
+                           std::vector<BSONObj> removedKeys);
+
     void removeOneKey(OperationContext* txn,
                       const BSONObj& key,
                       const RecordId& loc,
                       bool dupsAllowed);
 
     const std::unique_ptr<SortedDataInterface> _newInterface;
+
+    // Only changed while holding an exclusive lock on the collection, so operations which hold an
+    // intent lock can read it without synchronization.
+    bool _capturingSideWrites = false;
+
+    // Side writes in the order they committed. Appended to by any operation writing to the
+    // collection, and drained by the index build.
+    mutable stdx::mutex _sideWritesMutex;
+    std::deque<SideWrite> _sideWrites;
 };
 
 /**
@@ -30,6 +30,7 @@
 
 #include "mongo/base/status.h"
 #include "mongo/base/status_with.h"
+#include "mongo/db/geo/s2_density_grid.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index/s2_common.h"
@@ -51,6 +52,13 @@ public:
      */
     static StatusWith<BSONObj> fixSpec(const BSONObj& specObj);
 
+    /**
+     * Returns the map of this index's key density that $geoNear queries share.
+     */
+    S2DensityGrid* getDensityGrid() {
+        return &_densityGrid;
+    }
+
 private:
     /**
      * Fills 'keys' with the keys that should be generated for 'obj' on this index.
@@ -70,6 +78,8 @@ private:
     // Null if this index orders strings according to the simple binary compare. If non-null,
     // represents the collator used to generate index keys for indexed strings.
     const CollatorInterface* _collator;
+
+    S2DensityGrid _densityGrid;
 };
 
 }  // namespace mongo
@@ -37,6 +37,7 @@
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 using namespace mongo;
 
@@ -399,4 +400,47 @@ TEST(S2KeyGeneratorTest, NoCollation) {
                              actualMultikeyPaths);
 }
 
+// Tests that the coverings of a document's geometries come out the same when they are computed on
+// several threads.
+TEST(S2KeyGeneratorTest, ParallelCoveringsMatchSequentialCoverings) {
+    BSONObj obj = fromjson(
+        "{a: [{b: {type: 'Polygon', coordinates: [[[0, 0], [0, 5], [5, 5], [5, 0], [0, 0]]]}}, "
+        "{b: {type: 'Polygon', coordinates: [[[10, 10], [10, 12], [13, 12], [10, 10]]]}}, "
+        "{b: {type: 'LineString', coordinates: [[-20, -20], [-25, -21], [-30, -20]]}}, "
+        "{b: {type: 'Point', coordinates: [40, 40]}}]}");
+    BSONObj keyPattern = fromjson("{'a.b': '2dsphere'}");
+    BSONObj infoObj = fromjson("{key: {'a.b': '2dsphere'}, '2dsphereIndexVersion': 3}");
+    S2IndexingParams params;
+    const CollatorInterface* collator = nullptr;
+    ExpressionParams::initialize2dsphereParams(infoObj, collator, &params);
+
+    const int originalMinBytes = internalIndexS2ParallelCoveringMinBytes.load();
+    ON_BLOCK_EXIT([&] { internalIndexS2ParallelCoveringMinBytes.store(originalMinBytes); });
+
+    internalIndexS2ParallelCoveringMinBytes.store(0);
+    BSONObjSet sequentialKeys;
+    MultikeyPaths sequentialMultikeyPaths;
+    ExpressionKeysPrivate::getS2Keys(
+        obj, keyPattern, params, &sequentialKeys, &sequentialMultikeyPaths);
+
+    internalIndexS2ParallelCoveringMinBytes.store(1);
+    BSONObjSet parallelKeys;
+    MultikeyPaths parallelMultikeyPaths;
+    ExpressionKeysPrivate::getS2Keys(obj, keyPattern, params, &parallelKeys, &parallelMultikeyPaths);
+
+    ASSERT_GT(sequentialKeys.size(), 4U);
+    assertKeysetsEqual(sequentialKeys, parallelKeys);
+    assertMultikeyPathsEqual(sequentialMultikeyPaths, parallelMultikeyPaths);
+
+    // Errors still surface from the geometry that caused them.
+    BSONObj badObj = fromjson(
+        "{a: [{b: {type: 'Point', coordinates: [0, 0]}}, {b: {type: 'Polygon', coordinates: "
+        "[[[0, 0], [0, 5], [5, 5], [0, 5], [0, 0]]]}}]}");
+    BSONObjSet badKeys;
+    ASSERT_THROWS_CODE(
+        ExpressionKeysPrivate::getS2Keys(badObj, keyPattern, params, &badKeys, nullptr),
+        UserException,
+        16755);
+}
+
 }  // namespace
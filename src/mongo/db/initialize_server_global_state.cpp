@@ -43,14 +43,20 @@
 #include <syslog.h>
 #endif
 
+#include "mongo/base/global_initializer.h"
 #include "mongo/base/init.h"
+#include "mongo/base/initializer.h"
 #include "mongo/client/sasl_client_authenticate.h"
 #include "mongo/config.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/authorization_manager_global.h"
 #include "mongo/db/auth/internal_user_auth.h"
 #include "mongo/db/auth/security_key.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/logger/async_file_appender.h"
+#include "mongo/logger/async_file_writer.h"
 #include "mongo/logger/console_appender.h"
 #include "mongo/logger/logger.h"
 #include "mongo/logger/message_event.h"
@@ -65,6 +71,7 @@
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/listen.h"
 #include "mongo/util/net/ssl_manager.h"
+#include "mongo/util/exit.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/quick_exit.h"
 #include "mongo/util/signal_handlers_synchronous.h"
@@ -198,6 +205,42 @@ void forkServerOrDie() {
         quickExit(EXIT_FAILURE);
 }
 
+namespace {
+
+// Write the log file from a thread of its own, so operations don't wait on the file system.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(asyncLogging, bool, false);
+
+// The number of log lines that may wait to be written when asyncLogging is on, and what happens to
+// the lines logged while that many are waiting: "block" makes the logging thread wait, "drop"
+// discards them.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(asyncLogMaxQueuedEvents, int, 100000);
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(asyncLogOverflowPolicy, std::string, "block");
+
+ServerStatusMetricField<Counter64> displayAsyncLogQueued("log.async.queued",
+                                                         &logger::AsyncFileWriter::queuedEvents);
+ServerStatusMetricField<Counter64> displayAsyncLogDropped("log.async.dropped",
+                                                          &logger::AsyncFileWriter::droppedEvents);
+
+}  // namespace
+
+void logGlobalInitializerTimes() {
+    // Initializers taking this long are logged at the default verbosity.
+    const Milliseconds kSlowInitializerThreshold(100);
+
+    Microseconds total(0);
+    for (const auto& executionTime : getGlobalInitializer().getExecutionTimes()) {
+        total += executionTime.second;
+        if (executionTime.second >= kSlowInitializerThreshold) {
+            log() << "Initializer " << executionTime.first << " took "
+                  << durationCount<Milliseconds>(executionTime.second) << "ms";
+        } else {
+            LOG(1) << "Initializer " << executionTime.first << " took "
+                   << durationCount<Microseconds>(executionTime.second) << "us";
+        }
+    }
+    LOG(1) << "Global initializers took " << durationCount<Milliseconds>(total) << "ms";
+}
+
 MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
                           ("GlobalLogManager", "EndStartupOptionHandling", "ForkServer"),
                           ("default"))
@@ -280,13 +323,48 @@ MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
 
         LogManager* manager = logger::globalLogManager();
         manager->getGlobalDomain()->clearAppenders();
-        manager->getGlobalDomain()->attachAppender(
-            MessageLogDomain::AppenderAutoPtr(new RotatableFileAppender<MessageEventEphemeral>(
-                new MessageEventDetailsEncoder, writer.getValue())));
-        manager->getNamedDomain("javascriptOutput")
-            ->attachAppender(
+        if (asyncLogging) {
+            using logger::AsyncFileAppender;
+            using logger::AsyncFileWriter;
+
+            AsyncFileWriter::OverflowPolicy policy;
+            if (asyncLogOverflowPolicy == "block") {
+                policy = AsyncFileWriter::OverflowPolicy::kBlock;
+            } else if (asyncLogOverflowPolicy == "drop") {
+                policy = AsyncFileWriter::OverflowPolicy::kDrop;
+            } else {
+                return Status(ErrorCodes::BadValue,
+                              mongoutils::str::stream()
+                                  << "asyncLogOverflowPolicy must be \"block\" or \"drop\", not \""
+                                  << asyncLogOverflowPolicy
+                                  << "\"");
+            }
+            if (asyncLogMaxQueuedEvents <= 0) {
+                return Status(ErrorCodes::BadValue, "asyncLogMaxQueuedEvents must be positive");
+            }
+
+            // Lives as long as the process, like the file writer. Lines logged while the process
+            // exits are written directly.
+            AsyncFileWriter* asyncWriter =
+                new AsyncFileWriter(writer.getValue(), asyncLogMaxQueuedEvents, policy);
+            registerShutdownTask([asyncWriter] { asyncWriter->stop(); });
+
+            manager->getGlobalDomain()->attachAppender(
+                MessageLogDomain::AppenderAutoPtr(new AsyncFileAppender<MessageEventEphemeral>(
+                    new MessageEventDetailsEncoder, asyncWriter)));
+            manager->getNamedDomain("javascriptOutput")
+                ->attachAppender(
+                    MessageLogDomain::AppenderAutoPtr(new AsyncFileAppender<MessageEventEphemeral>(
+                        new MessageEventDetailsEncoder, asyncWriter)));
+        } else {
+            manager->getGlobalDomain()->attachAppender(
                 MessageLogDomain::AppenderAutoPtr(new RotatableFileAppender<MessageEventEphemeral>(
                     new MessageEventDetailsEncoder, writer.getValue())));
+            manager->getNamedDomain("javascriptOutput")
+                ->attachAppender(MessageLogDomain::AppenderAutoPtr(
+                    new RotatableFileAppender<MessageEventEphemeral>(new MessageEventDetailsEncoder,
+                                                                     writer.getValue())));
+        }
 
         if (serverGlobalParams.logAppend && exists) {
             log() << "***** SERVER RESTARTED *****" << endl;
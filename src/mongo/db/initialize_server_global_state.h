@@ -37,6 +37,12 @@ namespace mongo {
  */
 bool initializeServerGlobalState();
 
+/**
+ * Logs the global initializers that were slow to run, and at higher verbosity the time each of
+ * them took. Call once the log is set up.
+ */
+void logGlobalInitializerTimes();
+
 /**
  * Forks and detaches the server, on platforms that support it, if serverGlobalParams.doFork is
  * true.
@@ -44,6 +44,7 @@
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/fsync.h"
+#include "mongo/db/commands/operation_priority.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/concurrency/lock_state.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -71,6 +72,7 @@
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/sampled_profile_buffer.h"
 #include "mongo/db/stats/top.h"
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/storage/storage_options.h"
@@ -555,6 +557,7 @@ void assembleResponse(OperationContext* txn,
 
         // We should not be holding any locks at this point
         invariant(!txn->lockState()->isLocked());
+        txn->lockState()->setLowPriority(isLowPriorityClient(&c));
     }
 
     const char* ns = dbmsg.messageShouldHaveNs() ? dbmsg.getns() : NULL;
@@ -690,12 +693,20 @@ void assembleResponse(OperationContext* txn,
     Top::get(txn->getServiceContext())
         .incrementGlobalLatencyStats(
             txn, currentOp.totalTimeMicros(), currentOp.getReadWriteType());
+    if (!currentOp.getQueryShape().empty()) {
+        Top::get(txn->getServiceContext())
+            .incrementQueryShapeLatencyStats(txn,
+                                             currentOp.getNS(),
+                                             currentOp.getQueryShape(),
+                                             currentOp.totalTimeMicros(),
+                                             currentOp.getReadWriteType());
+    }
 
     if (shouldLogOpDebug || debug.executionTime > logThreshold) {
         Locker::LockerInfo lockerInfo;
         txn->lockState()->getLockerInfo(&lockerInfo);
 
-        log() << debug.report(currentOp, lockerInfo.stats);
+        log() << debug.report(currentOp, lockerInfo.stats, WaitEventStats::get(txn));
     }
 
     if (currentOp.shouldDBProfile(debug.executionTime)) {
@@ -711,6 +722,12 @@ void assembleResponse(OperationContext* txn,
         }
     }
 
+    if (c.isFromUserConnection() && !c.isInDirectClient() &&
+        SampledProfileBuffer::get(txn->getServiceContext())
+            ->shouldSample(currentOp.getNS(), currentOp.getQueryShape(), Date_t::now())) {
+        profileSampled(txn);
+    }
+
     recordCurOpMetrics(txn);
 }
 
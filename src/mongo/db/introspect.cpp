@@ -41,6 +41,11 @@
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/stats/sampled_profile_buffer.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/util/background.h"
+#include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
 
@@ -52,6 +57,8 @@ using std::string;
 
 namespace {
 
+MONGO_EXPORT_SERVER_PARAMETER(sampledProfilerWriteToCollection, bool, false);
+
 void _appendUserInfo(const CurOp& c, BSONObjBuilder& builder, AuthorizationSession* authSession) {
     UserNameIterator nameIter = authSession->getAuthenticatedUserNames();
 
@@ -77,10 +84,7 @@ void _appendUserInfo(const CurOp& c, BSONObjBuilder& builder, AuthorizationSessi
     builder.append("user", bestUser.getUser().empty() ? "" : bestUser.getFullName());
 }
 
-}  // namespace
-
-
-void profile(OperationContext* txn, NetworkOp op) {
+BSONObj buildProfileDocument(OperationContext* txn) {
     // Initialize with 1kb at start in order to avoid realloc later
     BufBuilder profileBufBuilder(1024);
 
@@ -89,7 +93,8 @@ void profile(OperationContext* txn, NetworkOp op) {
     {
         Locker::LockerInfo lockerInfo;
         txn->lockState()->getLockerInfo(&lockerInfo);
-        CurOp::get(txn)->debug().append(*CurOp::get(txn), lockerInfo.stats, b);
+        CurOp::get(txn)->debug().append(
+            *CurOp::get(txn), lockerInfo.stats, WaitEventStats::get(txn), b);
     }
 
     b.appendDate("ts", jsTime());
@@ -98,56 +103,110 @@ void profile(OperationContext* txn, NetworkOp op) {
     AuthorizationSession* authSession = AuthorizationSession::get(txn->getClient());
     _appendUserInfo(*CurOp::get(txn), b, authSession);
 
-    const BSONObj p = b.done();
+    return b.obj();
+}
 
+/**
+ * Inserts 'p' into the system.profile collection of database 'dbName', creating it if needed and
+ * possible. Returns false if the database went away.
+ */
+bool insertProfileDocument(OperationContext* txn, const string& dbName, const BSONObj& p) {
     const bool wasLocked = txn->lockState()->isLocked();
 
-    const string dbName(nsToDatabase(CurOp::get(txn)->getNS()));
+    bool acquireDbXLock = false;
+    while (true) {
+        ScopedTransaction scopedXact(txn, MODE_IX);
 
-    try {
-        bool acquireDbXLock = false;
-        while (true) {
-            ScopedTransaction scopedXact(txn, MODE_IX);
-
-            std::unique_ptr<AutoGetDb> autoGetDb;
-            if (acquireDbXLock) {
-                autoGetDb.reset(new AutoGetDb(txn, dbName, MODE_X));
-                if (autoGetDb->getDb()) {
-                    createProfileCollection(txn, autoGetDb->getDb());
-                }
-            } else {
-                autoGetDb.reset(new AutoGetDb(txn, dbName, MODE_IX));
+        std::unique_ptr<AutoGetDb> autoGetDb;
+        if (acquireDbXLock) {
+            autoGetDb.reset(new AutoGetDb(txn, dbName, MODE_X));
+            if (autoGetDb->getDb()) {
+                createProfileCollection(txn, autoGetDb->getDb());
             }
+        } else {
+            autoGetDb.reset(new AutoGetDb(txn, dbName, MODE_IX));
+        }
+
+        Database* const db = autoGetDb->getDb();
+        if (!db) {
+            return false;
+        }
+
+        Lock::CollectionLock collLock(txn->lockState(), db->getProfilingNS(), MODE_IX);
+
+        Collection* const coll = db->getCollection(db->getProfilingNS());
+        if (coll) {
+            WriteUnitOfWork wuow(txn);
+            OpDebug* const nullOpDebug = nullptr;
+            coll->insertDocument(txn, p, nullOpDebug, false);
+            wuow.commit();
+
+            return true;
+        } else if (!acquireDbXLock &&
+                   (!wasLocked || txn->lockState()->isDbLockedForMode(dbName, MODE_X))) {
+            // Try to create the collection only if we are not under lock, in order to
+            // avoid deadlocks due to lock conversion. This would only be hit if someone
+            // deletes the profiler collection after setting profile level.
+            acquireDbXLock = true;
+        } else {
+            // Cannot write the profile information
+            return true;
+        }
+    }
+}
 
-            Database* const db = autoGetDb->getDb();
-            if (!db) {
-                // Database disappeared
-                log() << "note: not profiling because db went away for "
-                      << CurOp::get(txn)->getNS();
-                break;
+/**
+ * Drains the sampled profile buffer every second, and inserts the sampled profile documents into
+ * the system.profile collections of their databases if sampledProfilerWriteToCollection is set.
+ */
+class SampledProfileWriter : public BackgroundJob {
+public:
+    string name() const override {
+        return "SampledProfileWriter";
+    }
+
+    void run() override {
+        Client::initThread(name().c_str());
+        AuthorizationSession::get(cc())->grantInternalAuthorization();
+
+        while (!inShutdown()) {
+            sleepsecs(1);
+
+            auto records = SampledProfileBuffer::get(getGlobalServiceContext())->drain();
+            if (records.empty() || !sampledProfilerWriteToCollection.load() ||
+                storageGlobalParams.readOnly) {
+                continue;
             }
 
-            Lock::CollectionLock collLock(txn->lockState(), db->getProfilingNS(), MODE_IX);
-
-            Collection* const coll = db->getCollection(db->getProfilingNS());
-            if (coll) {
-                WriteUnitOfWork wuow(txn);
-                OpDebug* const nullOpDebug = nullptr;
-                coll->insertDocument(txn, p, nullOpDebug, false);
-                wuow.commit();
-
-                break;
-            } else if (!acquireDbXLock &&
-                       (!wasLocked || txn->lockState()->isDbLockedForMode(dbName, MODE_X))) {
-                // Try to create the collection only if we are not under lock, in order to
-                // avoid deadlocks due to lock conversion. This would only be hit if someone
-                // deletes the profiler collection after setting profile level.
-                acquireDbXLock = true;
-            } else {
-                // Cannot write the profile information
-                break;
+            const auto txn = cc().makeOperationContext();
+            for (const auto& record : records) {
+                try {
+                    insertProfileDocument(txn.get(), record.dbName, record.doc);
+                } catch (const DBException& ex) {
+                    LOG(1) << "Could not write a sampled profile document to " << record.dbName
+                           << ": " << ex.toString();
+                }
             }
         }
+    }
+};
+
+// The SampledProfileWriter is intentionally leaked, like the TTLMonitor.
+SampledProfileWriter* sampledProfileWriter = nullptr;
+
+}  // namespace
+
+
+void profile(OperationContext* txn, NetworkOp op) {
+    const BSONObj p = buildProfileDocument(txn);
+
+    const string dbName(nsToDatabase(CurOp::get(txn)->getNS()));
+
+    try {
+        if (!insertProfileDocument(txn, dbName, p)) {
+            // Database disappeared
+            log() << "note: not profiling because db went away for " << CurOp::get(txn)->getNS();
+        }
     } catch (const AssertionException& assertionEx) {
         warning() << "Caught Assertion while trying to profile " << networkOpToString(op)
                   << " against " << CurOp::get(txn)->getNS() << ": " << assertionEx.toString()
@@ -155,6 +214,16 @@ void profile(OperationContext* txn, NetworkOp op) {
     }
 }
 
+void profileSampled(OperationContext* txn) {
+    SampledProfileBuffer::get(txn->getServiceContext())
+        ->record({nsToDatabase(CurOp::get(txn)->getNS()), buildProfileDocument(txn)});
+}
+
+void startSampledProfileWriter() {
+    sampledProfileWriter = new SampledProfileWriter();
+    sampledProfileWriter->go();
+}
+
 
 Status createProfileCollection(OperationContext* txn, Database* db) {
     invariant(txn->lockState()->isDbLockedForMode(db->name(), MODE_X));
@@ -41,6 +41,18 @@ class OperationContext;
  */
 void profile(OperationContext* txn, NetworkOp op);
 
+/**
+ * Invoked when the sampled profiler samples the operation. Only builds its profile document and
+ * adds it to the SampledProfileBuffer, without taking any lock.
+ */
+void profileSampled(OperationContext* txn);
+
+/**
+ * Starts the background job which drains the SampledProfileBuffer and writes its documents to the
+ * system.profile collections when sampledProfilerWriteToCollection is set.
+ */
+void startSampledProfileWriter();
+
 /**
  * Pre-creates the profile collection for the specified database.
  */
@@ -0,0 +1,85 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+const BSONObj kDocument =
+    fromjson("{_id: 1, a: 5, b: 'hello', c: [1, 2, 3, 4, 5], d: {e: 10, f: 20}}");
+
+std::unique_ptr<MatchExpression> parse(const BSONObj& filter) {
+    auto status = MatchExpressionParser::parse(filter, ExtensionsCallbackNoop(), nullptr);
+    invariantOK(status.getStatus());
+    return std::move(status.getValue());
+}
+
+void runMatch(benchmark::BenchmarkState& state, const BSONObj& filter) {
+    const auto expression = parse(filter);
+    while (state.keepRunning()) {
+        benchmark::doNotOptimizeAway(expression->matchesBSON(kDocument));
+    }
+}
+
+MONGO_BENCHMARK(MatchExpressionEquality) {
+    runMatch(state, fromjson("{a: 5}"));
+}
+
+MONGO_BENCHMARK(MatchExpressionRangeAndString) {
+    runMatch(state, fromjson("{a: {$gt: 1, $lt: 10}, b: {$ne: 'x'}}"));
+}
+
+MONGO_BENCHMARK(MatchExpressionArrayElement) {
+    runMatch(state, fromjson("{c: 4}"));
+}
+
+MONGO_BENCHMARK(MatchExpressionDottedPath) {
+    runMatch(state, fromjson("{'d.f': {$in: [5, 20, 30]}}"));
+}
+
+MONGO_BENCHMARK(MatchExpressionOr) {
+    runMatch(state, fromjson("{$or: [{a: 1}, {b: 'hello'}]}"));
+}
+
+MONGO_BENCHMARK(MatchExpressionParse) {
+    const BSONObj filter = fromjson("{a: {$gt: 1, $lt: 10}, 'd.f': {$in: [5, 20]}}");
+    while (state.keepRunning()) {
+        benchmark::doNotOptimizeAway(parse(filter));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
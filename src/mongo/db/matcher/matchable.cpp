@@ -34,7 +34,8 @@
 
 namespace mongo {
 
-BSONMatchableDocument::BSONMatchableDocument(const BSONObj& obj) : _obj(obj) {
+BSONMatchableDocument::BSONMatchableDocument(const BSONObj& obj)
+    : _obj(obj), _topLevelFields(obj) {
     _iteratorUsed = false;
 }
 
@@ -85,9 +85,9 @@ public:
 
     virtual ElementIterator* allocateIterator(const ElementPath* path) const {
         if (_iteratorUsed)
-            return new BSONElementIterator(path, _obj);
+            return new BSONElementIterator(path, _obj, &_topLevelFields);
         _iteratorUsed = true;
-        _iterator.reset(path, _obj);
+        _iterator.reset(path, _obj, &_topLevelFields);
         return &_iterator;
     }
 
@@ -101,6 +101,7 @@ public:
 
 private:
     BSONObj _obj;
+    BSONTopLevelFieldCache _topLevelFields;
     mutable BSONElementIterator _iterator;
     mutable bool _iteratorUsed;
 };
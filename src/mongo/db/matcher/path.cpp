@@ -44,6 +44,91 @@ Status ElementPath::init(StringData path) {
 
 // -----
 
+namespace {
+
+// Below this many fields, scanning the index of a document's fields is about as fast as hashing
+// the name being looked up.
+const size_t kMinFieldsToHash = 32;
+
+}  // namespace
+
+void BSONTopLevelFieldCache::reset(const BSONObj& obj) {
+    _obj = obj;
+    _searched = false;
+    _indexed = false;
+    _fields.clear();
+    _hashTable.clear();
+}
+
+void BSONTopLevelFieldCache::_buildIndex() const {
+    BSONObjIterator it(_obj);
+    while (it.more()) {
+        BSONElement e = it.next();
+        _fields.emplace_back(e.fieldNameStringData(), e);
+    }
+    _indexed = true;
+
+    if (_fields.size() < kMinFieldsToHash) {
+        return;
+    }
+
+    // Keep the table at most half full, so that probe sequences stay short.
+    size_t numSlots = 1;
+    while (numSlots < 2 * _fields.size()) {
+        numSlots <<= 1;
+    }
+    _hashTable.assign(numSlots, 0);
+
+    const size_t mask = numSlots - 1;
+    StringData::Hasher hasher;
+    for (size_t i = 0; i < _fields.size(); ++i) {
+        size_t slot = hasher(_fields[i].first) & mask;
+        bool isDuplicate = false;
+        while (_hashTable[slot] != 0) {
+            // Like getField(), lookups must find the first of several fields with the same name.
+            if (_fields[_hashTable[slot] - 1].first == _fields[i].first) {
+                isDuplicate = true;
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+        if (!isDuplicate) {
+            _hashTable[slot] = static_cast<uint32_t>(i + 1);
+        }
+    }
+}
+
+BSONElement BSONTopLevelFieldCache::getField(StringData name) const {
+    if (!_indexed) {
+        if (!_searched) {
+            _searched = true;
+            return _obj.getField(name);
+        }
+        _buildIndex();
+    }
+
+    if (!_hashTable.empty()) {
+        const size_t mask = _hashTable.size() - 1;
+        for (size_t slot = StringData::Hasher()(name) & mask; _hashTable[slot] != 0;
+             slot = (slot + 1) & mask) {
+            const auto& field = _fields[_hashTable[slot] - 1];
+            if (field.first == name) {
+                return field.second;
+            }
+        }
+        return BSONElement();
+    }
+
+    for (const auto& field : _fields) {
+        if (field.first == name) {
+            return field.second;
+        }
+    }
+    return BSONElement();
+}
+
+// -----
+
 ElementIterator::~ElementIterator() {}
 
 void ElementIterator::Context::reset() {
@@ -87,17 +172,22 @@ BSONElementIterator::BSONElementIterator() {
     _path = NULL;
 }
 
-BSONElementIterator::BSONElementIterator(const ElementPath* path, const BSONObj& context)
-    : _path(path), _context(context) {
+BSONElementIterator::BSONElementIterator(const ElementPath* path,
+                                         const BSONObj& context,
+                                         const BSONTopLevelFieldCache* topLevelFields)
+    : _path(path), _context(context), _topLevelFields(topLevelFields) {
     _state = BEGIN;
     // log() << "path: " << path.fieldRef().dottedField() << " context: " << context << endl;
 }
 
 BSONElementIterator::~BSONElementIterator() {}
 
-void BSONElementIterator::reset(const ElementPath* path, const BSONObj& context) {
+void BSONElementIterator::reset(const ElementPath* path,
+                                const BSONObj& context,
+                                const BSONTopLevelFieldCache* topLevelFields) {
     _path = path;
     _context = context;
+    _topLevelFields = topLevelFields;
     _state = BEGIN;
     _next.reset();
 
@@ -192,7 +282,8 @@ bool BSONElementIterator::more() {
 
     if (_state == BEGIN) {
         size_t idxPath = 0;
-        BSONElement e = getFieldDottedOrArray(_context, _path->fieldRef(), &idxPath);
+        BSONElement e =
+            getFieldDottedOrArray(_context, _path->fieldRef(), &idxPath, _topLevelFields);
 
         if (e.type() != Array) {
             _next.reset(e, BSONElement(), false);
@@ -30,6 +30,9 @@
 
 #pragma once
 
+#include <cstdint>
+#include <utility>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/base/string_data.h"
@@ -65,6 +68,46 @@ private:
     bool _shouldTraverseLeafArray;
 };
 
+/**
+ * Looks up the top-level fields of a document for the paths of several predicates matched
+ * against it. The first lookup searches the document like BSONObj::getField(). The second one
+ * indexes all of its fields in a single pass, after which lookups scan the index instead of
+ * decoding the size of every element in the document before the one they are looking for.
+ * Documents with many fields also get a hash table over the index, so that each lookup costs the
+ * same however many fields the document has.
+ */
+class BSONTopLevelFieldCache {
+public:
+    explicit BSONTopLevelFieldCache(const BSONObj& obj) : _obj(obj) {}
+
+    /**
+     * Makes this a cache of 'obj', keeping the memory allocated for the previous document's index.
+     */
+    void reset(const BSONObj& obj);
+
+    const BSONObj& obj() const {
+        return _obj;
+    }
+
+    /**
+     * Returns the first field named 'name' in the document, or EOO if there is none.
+     */
+    BSONElement getField(StringData name) const;
+
+private:
+    void _buildIndex() const;
+
+    BSONObj _obj;
+
+    mutable bool _searched = false;
+    mutable bool _indexed = false;
+    mutable std::vector<std::pair<StringData, BSONElement>> _fields;
+
+    // An open-addressed table with linear probing, only built for documents with many fields. Each
+    // slot holds one plus the position of a field in '_fields', or zero if it is empty.
+    mutable std::vector<uint32_t> _hashTable;
+};
+
 class ElementIterator {
 public:
     class Context {
@@ -137,11 +180,20 @@ private:
 class BSONElementIterator : public ElementIterator {
 public:
     BSONElementIterator();
-    BSONElementIterator(const ElementPath* path, const BSONObj& context);
+
+    /**
+     * If 'topLevelFields' is not null, it must be a cache of 'context' which outlives this
+     * iterator, and is used to find the first component of 'path'.
+     */
+    BSONElementIterator(const ElementPath* path,
+                        const BSONObj& context,
+                        const BSONTopLevelFieldCache* topLevelFields = nullptr);
 
     virtual ~BSONElementIterator();
 
-    void reset(const ElementPath* path, const BSONObj& context);
+    void reset(const ElementPath* path,
+               const BSONObj& context,
+               const BSONTopLevelFieldCache* topLevelFields = nullptr);
 
     bool more();
     Context next();
@@ -155,6 +207,7 @@ private:
 
     const ElementPath* _path;
     BSONObj _context;
+    const BSONTopLevelFieldCache* _topLevelFields = nullptr;
 
     enum State { BEGIN, IN_ARRAY, DONE } _state;
     Context _next;
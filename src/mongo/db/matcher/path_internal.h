@@ -40,8 +40,15 @@ namespace mongo {
 
 bool isAllDigits(StringData str);
 
+class BSONTopLevelFieldCache;
+
 // XXX document me
 // Replaces getFieldDottedOrArray without recursion nor std::string manipulation
-BSONElement getFieldDottedOrArray(const BSONObj& doc, const FieldRef& path, size_t* idxPath);
+// If 'topLevelFields' is not null, it is a cache of 'doc' and is used to find the first part of
+// 'path'.
+BSONElement getFieldDottedOrArray(const BSONObj& doc,
+                                  const FieldRef& path,
+                                  size_t* idxPath,
+                                  const BSONTopLevelFieldCache* topLevelFields = nullptr);
 
 }  // namespace mongo
@@ -34,6 +34,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/path.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -468,6 +469,58 @@ TEST(SimpleArrayElementIterator, SimpleArrayLast1) {
     ASSERT(!i.more());
 }
 
+TEST(Path, NestedWithTopLevelFieldCache) {
+    ElementPath p;
+    ASSERT(p.init("a.b").isOK());
+
+    BSONObj doc = BSON("x" << 4 << "a" << BSON("b" << 5));
+    BSONTopLevelFieldCache topLevelFields(doc);
+
+    // The second and later lookups of the cache go through its index of the fields.
+    for (int i = 0; i < 3; i++) {
+        BSONElementIterator cursor(&p, doc, &topLevelFields);
+        ASSERT(cursor.more());
+        ElementIterator::Context e = cursor.next();
+        ASSERT_EQUALS((string) "b", e.element().fieldName());
+        ASSERT_EQUALS(5, e.element().numberInt());
+        ASSERT(!cursor.more());
+    }
+}
+
+TEST(BSONTopLevelFieldCache, GetField) {
+    BSONObj doc = BSON("x" << 4 << "a" << 5 << "a" << 6);
+    BSONTopLevelFieldCache topLevelFields(doc);
+
+    // The first lookup searches the document, later ones the index built by the second.
+    ASSERT_EQUALS(5, topLevelFields.getField("a").numberInt());
+    ASSERT_EQUALS(4, topLevelFields.getField("x").numberInt());
+    ASSERT_EQUALS(5, topLevelFields.getField("a").numberInt());
+    ASSERT(topLevelFields.getField("b").eoo());
+    ASSERT(topLevelFields.getField("").eoo());
+}
+
+TEST(BSONTopLevelFieldCache, GetFieldOfDocumentWithManyFields) {
+    BSONObjBuilder bob;
+    for (int i = 0; i < 300; i++) {
+        bob.append(std::string(str::stream() << "f" << i), i);
+    }
+    bob.append("f7", -1);
+    BSONObj doc = bob.obj();
+    BSONTopLevelFieldCache topLevelFields(doc);
+
+    for (int i = 0; i < 300; i++) {
+        std::string field = str::stream() << "f" << i;
+        ASSERT_EQUALS(i, topLevelFields.getField(field).numberInt());
+    }
+    ASSERT_EQUALS(7, topLevelFields.getField("f7").numberInt());
+    ASSERT(topLevelFields.getField("f300").eoo());
+    ASSERT(topLevelFields.getField("").eoo());
+
+    topLevelFields.reset(BSON("a" << 1));
+    ASSERT_EQUALS(1, topLevelFields.getField("a").numberInt());
+    ASSERT(topLevelFields.getField("f1").eoo());
+}
+
 TEST(SingleElementElementIterator, Simple1) {
     BSONObj obj = BSON("x" << 3 << "y" << 5);
     SingleElementElementIterator i(obj["y"]);
@@ -37,6 +37,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/summary_collection.h"
 #include "mongo/scripting/engine.h"
 
 namespace mongo {
@@ -80,6 +81,12 @@ void OpObserver::onInserts(OperationContext* txn,
     if (strstr(ns, ".system.js")) {
         Scope::storedFuncMod(txn);
     }
+
+    SummaryCatalog::get(txn->getServiceContext())->onInserts(txn, nss, begin, end);
+}
+
+bool OpObserver::needsPreImage(OperationContext* txn, const NamespaceString& ns) {
+    return SummaryCatalog::get(txn->getServiceContext())->hasSummaries(txn, ns);
 }
 
 void OpObserver::onUpdate(OperationContext* txn, const OplogUpdateEntryArgs& args) {
@@ -101,6 +108,9 @@ void OpObserver::onUpdate(OperationContext* txn, const OplogUpdateEntryArgs& arg
     if (strstr(args.ns.c_str(), ".system.js")) {
         Scope::storedFuncMod(txn);
     }
+
+    SummaryCatalog::get(txn->getServiceContext())
+        ->onUpdate(txn, NamespaceString(args.ns), args.preImageDoc, args.updatedDoc);
 }
 
 OpObserver::DeleteState OpObserver::aboutToDelete(OperationContext* txn,
@@ -115,6 +125,10 @@ OpObserver::DeleteState OpObserver::aboutToDelete(OperationContext* txn,
     auto css = CollectionShardingState::get(txn, ns.ns());
     deleteState.isMigrating = css->isDocumentInMigratingChunk(txn, doc);
 
+    if (SummaryCatalog::get(txn->getServiceContext())->hasSummaries(txn, ns)) {
+        deleteState.deletedDoc = doc.getOwned();
+    }
+
     return deleteState;
 }
 
@@ -122,6 +136,10 @@ void OpObserver::onDelete(OperationContext* txn,
                           const NamespaceString& ns,
                           OpObserver::DeleteState deleteState,
                           bool fromMigrate) {
+    if (!deleteState.deletedDoc.isEmpty()) {
+        SummaryCatalog::get(txn->getServiceContext())->onDelete(txn, ns, deleteState.deletedDoc);
+    }
+
     if (deleteState.idDoc.isEmpty())
         return;
 
@@ -153,6 +171,10 @@ void OpObserver::onCreateCollection(OperationContext* txn,
     b.appendElements(options.toBSON());
     BSONObj cmdObj = b.obj();
 
+    if (!options.summary.isEmpty()) {
+        SummaryCatalog::get(txn->getServiceContext())->invalidate(txn, collectionName.db());
+    }
+
     if (!collectionName.isSystemDotProfile()) {
         // do not replicate system.profile modifications
         repl::logOp(txn, "c", dbName.c_str(), cmdObj, nullptr, false);
@@ -180,6 +202,8 @@ void OpObserver::onCollMod(OperationContext* txn,
 void OpObserver::onDropDatabase(OperationContext* txn, const std::string& dbName) {
     BSONObj cmdObj = BSON("dropDatabase" << 1);
 
+    SummaryCatalog::get(txn->getServiceContext())->invalidate(txn, nsToDatabaseSubstring(dbName));
+
     repl::logOp(txn, "c", dbName.c_str(), cmdObj, nullptr, false);
 
     getGlobalAuthorizationManager()->logOp(txn, "c", dbName.c_str(), cmdObj, nullptr);
@@ -190,6 +214,8 @@ void OpObserver::onDropCollection(OperationContext* txn, const NamespaceString&
     std::string dbName = collectionName.db().toString() + ".$cmd";
     BSONObj cmdObj = BSON("drop" << collectionName.coll().toString());
 
+    SummaryCatalog::get(txn->getServiceContext())->onDropCollection(txn, collectionName);
+
     if (!collectionName.isSystemDotProfile()) {
         // do not replicate system.profile modifications
         repl::logOp(txn, "c", dbName.c_str(), cmdObj, nullptr, false);
@@ -220,6 +246,10 @@ void OpObserver::onRenameCollection(OperationContext* txn,
                                 << "dropTarget"
                                 << dropTarget);
 
+    auto summaryCatalog = SummaryCatalog::get(txn->getServiceContext());
+    summaryCatalog->invalidate(txn, fromCollection.db());
+    summaryCatalog->invalidate(txn, toCollection.db());
+
     repl::logOp(txn, "c", dbName.c_str(), cmdObj, nullptr, false);
 
     getGlobalAuthorizationManager()->logOp(txn, "c", dbName.c_str(), cmdObj, nullptr);
@@ -54,6 +54,10 @@ struct OplogUpdateEntryArgs {
     // Document containing the _id field of the doc being updated.
     BSONObj criteria;
 
+    // The document as it was before the update, only set if OpObserver::needsPreImage() asked for
+    // it.
+    BSONObj preImageDoc;
+
     // True if this update comes from a chunk migration.
     bool fromMigrate;
 };
@@ -75,6 +79,10 @@ public:
         // True if doc being deleted is located in a currently migrating
         // chunk, where this is the chunk source.
         bool isMigrating = false;
+
+        // The whole document being deleted, only kept if a summary collection is maintained from
+        // its collection.
+        BSONObj deletedDoc;
     };
 
     void onCreateIndex(OperationContext* txn,
@@ -86,6 +94,11 @@ public:
                    std::vector<BSONObj>::const_iterator begin,
                    std::vector<BSONObj>::const_iterator end,
                    bool fromMigrate = false);
+    /**
+     * Returns whether onUpdate() needs the preImageDoc of updates of the collection 'ns'. Copying
+     * it is left to the callers, for whom it costs nothing unless it is needed.
+     */
+    bool needsPreImage(OperationContext* txn, const NamespaceString& ns);
     void onUpdate(OperationContext* txn, const OplogUpdateEntryArgs& args);
     DeleteState aboutToDelete(OperationContext* txn, const NamespaceString& ns, const BSONObj& doc);
     /**
@@ -93,6 +93,10 @@ Status ModifierInc::init(const BSONElement& modExpr, const Options& opts, bool*
                                     << "'");
     }
 
+    return rebind(modExpr, opts);
+}
+
+Status ModifierInc::rebind(const BSONElement& modExpr, const Options& opts) {
     //
     // value analysis
     //
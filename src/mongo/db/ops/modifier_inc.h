@@ -63,6 +63,13 @@ public:
      */
     virtual Status init(const BSONElement& modExpr, const Options& opts, bool* positional = NULL);
 
+    /** Only the value of the field this mod is on has to be checked again to rebind it. */
+    virtual bool canRebind() const {
+        return true;
+    }
+
+    virtual Status rebind(const BSONElement& modExpr, const Options& opts);
+
     /** Evaluates the validity of applying $inc to the identified node, and computes
      *  effects, handling upcasting and overflow as necessary.
      */
@@ -95,6 +95,23 @@ public:
                         const Options& opts,
                         bool* positional = NULL) = 0;
 
+    /**
+     * Returns true if this mod, once init() succeeded, can be bound to the argument of another
+     * 'modExpr' on the same field through rebind(), rather than built and initialized anew.
+     */
+    virtual bool canRebind() const {
+        return false;
+    }
+
+    /**
+     * Rebinds a mod for which canRebind() is true to the argument of 'modExpr', whose field
+     * name is the one init() was given. Returns the error init() would have returned for
+     * 'modExpr', if any. The notes on init() about the lifetime of 'modExpr' apply here too.
+     */
+    virtual Status rebind(const BSONElement& modExpr, const Options& opts) {
+        return Status(ErrorCodes::IllegalOperation, "modifier cannot be rebound");
+    }
+
     /**
      * Returns OK if it would be correct to apply this mod over the document 'root' (e.g, if
      * we're $inc-ing a field, is that field numeric in the current doc?).
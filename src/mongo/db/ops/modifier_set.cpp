@@ -92,6 +92,10 @@ Status ModifierSet::init(const BSONElement& modExpr, const Options& opts, bool*
                                     << "'");
     }
 
+    return rebind(modExpr, opts);
+}
+
+Status ModifierSet::rebind(const BSONElement& modExpr, const Options& opts) {
     //
     // value analysis
     //
@@ -61,6 +61,13 @@ public:
      */
     virtual Status init(const BSONElement& modExpr, const Options& opts, bool* positional = NULL);
 
+    /** Only the value of the field this mod is on has to be checked again to rebind it. */
+    virtual bool canRebind() const {
+        return true;
+    }
+
+    virtual Status rebind(const BSONElement& modExpr, const Options& opts);
+
     /**
      * Looks up the field name in the sub-tree rooted at 'root', and binds, if necessary,
      * the '$' field part using the 'matchedfield' number. prepare() returns OK and
@@ -87,7 +87,10 @@ Status ModifierUnset::init(const BSONElement& modExpr, const Options& opts, bool
                                     << "'");
     }
 
+    return rebind(modExpr, opts);
+}
 
+Status ModifierUnset::rebind(const BSONElement& modExpr, const Options& opts) {
     //
     // value analysis
     //
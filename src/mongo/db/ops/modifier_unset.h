@@ -60,6 +60,13 @@ public:
      */
     virtual Status init(const BSONElement& modExpr, const Options& opts, bool* positional = NULL);
 
+    /** Only the value of the field this mod is on has to be checked again to rebind it. */
+    virtual bool canRebind() const {
+        return true;
+    }
+
+    virtual Status rebind(const BSONElement& modExpr, const Options& opts);
+
     /**
      * Locates the field to be removed under the 'root' element, if it exist, and fills in
      * 'execInfo' accordingly. Return OK if successful or a status describing the error.
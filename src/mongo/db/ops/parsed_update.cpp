@@ -30,6 +30,8 @@
 
 #include "mongo/db/ops/parsed_update.h"
 
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/ops/update_request.h"
 #include "mongo/db/query/canonical_query.h"
@@ -77,9 +79,21 @@ Status ParsedUpdate::parseQuery() {
 
     // TODO SERVER-23924: Create decision logic for idhack when the query has no collation, but
     // there may be a collection default collation.
-    if (!_driver.needMatchDetails() && _request->getCollation().isEmpty() &&
-        CanonicalQuery::isSimpleIdQuery(_request->getQuery())) {
-        return Status::OK();
+    if (!_driver.needMatchDetails() && _request->getCollation().isEmpty()) {
+        if (CanonicalQuery::isSimpleIdQuery(_request->getQuery())) {
+            return Status::OK();
+        }
+
+        // An upsert needs the canonical query to build the document it inserts.
+        if (!_request->isUpsert() && !_request->isMulti() &&
+            CanonicalQuery::isSimpleEqualityQuery(_request->getQuery())) {
+            auto statusWithMatcher = MatchExpressionParser::parse(
+                _request->getQuery(), ExtensionsCallbackDisallowExtensions(), nullptr);
+            if (statusWithMatcher.isOK()) {
+                _pointQueryFilter = std::move(statusWithMatcher.getValue());
+                return Status::OK();
+            }
+        }
     }
 
     return parseQueryToCQ();
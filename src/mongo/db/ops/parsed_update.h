@@ -37,6 +37,7 @@
 namespace mongo {
 
 class CanonicalQuery;
+class MatchExpression;
 class OperationContext;
 class UpdateRequest;
 
@@ -111,6 +112,16 @@ public:
      */
     std::unique_ptr<CanonicalQuery> releaseParsedQuery();
 
+    /**
+     * As a further optimization, a single-document update whose predicate only compares fields
+     * to values, such as {_id: 1, version: 5}, is not canonicalized either. Its predicate is
+     * parsed directly, so that the document found through the _id index or another unique index
+     * can be checked against it. Returns null if the update is not of this kind.
+     */
+    const MatchExpression* getPointQueryFilter() const {
+        return _pointQueryFilter.get();
+    }
+
     /**
      * Get the collator of the parsed update.
      */
@@ -151,6 +162,9 @@ private:
 
     // Parsed query object, or NULL if the query proves to be an id hack query.
     std::unique_ptr<CanonicalQuery> _canonicalQuery;
+
+    // Parsed predicate of a point update, or NULL. See getPointQueryFilter().
+    std::unique_ptr<MatchExpression> _pointQueryFilter;
 };
 
 }  // namespace mongo
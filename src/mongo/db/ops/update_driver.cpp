@@ -28,6 +28,9 @@
 
 #include "mongo/db/ops/update_driver.h"
 
+#include <boost/thread/tss.hpp>
+#include <list>
+
 
 #include "mongo/base/error_codes.h"
 #include "mongo/base/string_data.h"
@@ -53,8 +56,100 @@ using std::vector;
 
 using pathsupport::EqualityMatches;
 
+namespace {
+
+// The most update shapes whose mods each thread keeps.
+const size_t kMaxCachedUpdateShapes = 16;
+
+/**
+ * The mods of the updates recently parsed on a thread, by update shape. A driver parsing an
+ * update of a known shape rebinds these mods to its arguments, which saves allocating them and
+ * parsing and checking their field paths again for every update an application repeats.
+ */
+class ModifierCache {
+public:
+    using Mods = std::vector<unique_ptr<ModifierInterface>>;
+
+    /** Removes and returns the mods kept for 'shape', if there are any. */
+    Mods take(const std::string& shape) {
+        for (auto it = _entries.begin(); it != _entries.end(); ++it) {
+            if (it->first == shape) {
+                Mods mods = std::move(it->second);
+                _entries.erase(it);
+                return mods;
+            }
+        }
+        return Mods();
+    }
+
+    /**
+     * Keeps the mods of 'mods' for 'shape', evicting the least recently kept shape if the cache
+     * is full, and empties 'mods'.
+     */
+    void put(std::string shape, vector<ModifierInterface*>* mods) {
+        Mods owned;
+        for (auto&& mod : *mods) {
+            owned.emplace_back(mod);
+        }
+        mods->clear();
+
+        for (auto&& entry : _entries) {
+            if (entry.first == shape) {
+                // Another driver on this thread already gave back mods for this shape.
+                return;
+            }
+        }
+
+        if (_entries.size() == kMaxCachedUpdateShapes) {
+            _entries.pop_back();
+        }
+        _entries.emplace_front(std::move(shape), std::move(owned));
+    }
+
+private:
+    std::list<std::pair<std::string, Mods>> _entries;  // Most recently kept first.
+};
+
+boost::thread_specific_ptr<ModifierCache> threadModifierCache;
+
+ModifierCache* getModifierCache() {
+    ModifierCache* cache = threadModifierCache.get();
+    if (!cache) {
+        cache = new ModifierCache();
+        threadModifierCache.reset(cache);
+    }
+    return cache;
+}
+
+/**
+ * Fills in 'shape' with the modifier names of the $mod update 'updateExpr' and, for each one,
+ * the fields it is on. Returns false if a modifier doesn't take an object, since such an update
+ * can't have been parsed into mods.
+ */
+bool getUpdateShape(const BSONObj& updateExpr, std::string* shape) {
+    BSONObjIterator outerIter(updateExpr);
+    while (outerIter.more()) {
+        BSONElement outerModElem = outerIter.next();
+        if (outerModElem.type() != Object) {
+            return false;
+        }
+
+        shape->append(outerModElem.fieldName(), outerModElem.fieldNameSize());
+        BSONObjIterator innerIter(outerModElem.embeddedObject());
+        while (innerIter.more()) {
+            BSONElement innerModElem = innerIter.next();
+            shape->append(innerModElem.fieldName(), innerModElem.fieldNameSize());
+        }
+        shape->push_back('\0');
+    }
+    return true;
+}
+
+}  // namespace
+
 UpdateDriver::UpdateDriver(const Options& opts)
     : _replacementMode(false),
+      _reusedCachedMods(false),
       _indexedFields(NULL),
       _logOp(opts.logOp),
       _modOptions(opts.modOptions),
@@ -93,6 +188,12 @@ Status UpdateDriver::parse(const BSONObj& updateExpr, const bool multi) {
         return Status::OK();
     }
 
+    // An update of the same shape as an earlier one only needs its arguments checked.
+    Status rebindStatus = Status::OK();
+    if (rebindCachedMods(updateExpr, &rebindStatus)) {
+        return rebindStatus;
+    }
+
     // The update expression is made of mod operators, that is
     // { <$mod>: {...}, <$mod>: {...}, ...  }
     BSONObjIterator outerIter(updateExpr);
@@ -142,9 +243,55 @@ Status UpdateDriver::parse(const BSONObj& updateExpr, const bool multi) {
     // replacement.
     _replacementMode = false;
 
+    // Positional mods bind their paths to each document, so only keep mods on fixed paths.
+    bool canRebind = !_positional;
+    for (auto&& mod : _mods) {
+        canRebind = canRebind && mod->canRebind();
+    }
+    if (canRebind && !getUpdateShape(updateExpr, &_cacheShape)) {
+        _cacheShape.clear();
+    }
+
     return Status::OK();
 }
 
+bool UpdateDriver::rebindCachedMods(const BSONObj& updateExpr, Status* status) {
+    std::string shape;
+    if (!getUpdateShape(updateExpr, &shape)) {
+        return false;
+    }
+
+    ModifierCache::Mods mods = getModifierCache()->take(shape);
+    if (mods.empty()) {
+        return false;
+    }
+
+    // The shapes are the same, so there is one mod per field of the update, in order. A mod
+    // which fails to rebind is not kept again, since it may no longer be bound at all.
+    auto modIt = mods.begin();
+    BSONObjIterator outerIter(updateExpr);
+    while (outerIter.more()) {
+        BSONObjIterator innerIter(outerIter.next().embeddedObject());
+        while (innerIter.more()) {
+            invariant(modIt != mods.end());
+            ModifierInterface* mod = modIt->release();
+            ++modIt;
+            _mods.push_back(mod);
+
+            *status = mod->rebind(innerIter.next(), _modOptions);
+            if (!status->isOK()) {
+                return true;
+            }
+        }
+    }
+    invariant(modIt == mods.end());
+
+    _replacementMode = false;
+    _reusedCachedMods = true;
+    _cacheShape = std::move(shape);
+    return true;
+}
+
 inline Status UpdateDriver::addAndParse(const modifiertable::ModifierType type,
                                         const BSONElement& elem) {
     if (elem.eoo()) {
@@ -393,12 +540,18 @@ BSONObj UpdateDriver::makeOplogEntryQuery(const BSONObj& doc, bool multi) const
     }
 }
 void UpdateDriver::clear() {
+    if (!_cacheShape.empty()) {
+        getModifierCache()->put(std::move(_cacheShape), &_mods);
+        _cacheShape.clear();
+    }
+
     for (vector<ModifierInterface*>::iterator it = _mods.begin(); it != _mods.end(); ++it) {
         delete *it;
     }
     _mods.clear();
     _indexedFields = NULL;
     _replacementMode = false;
+    _reusedCachedMods = false;
     _positional = false;
 }
 
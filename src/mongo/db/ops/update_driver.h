@@ -136,6 +136,14 @@ public:
         return _positional;
     }
 
+    /**
+     * Returns true if the last call to parse() rebound the modifiers kept from an earlier
+     * update of the same shape on this thread, rather than creating new ones.
+     */
+    bool reusedCachedMods() const {
+        return _reusedCachedMods;
+    }
+
     /**
      * Set the collator which will be used by all of the UpdateDriver's underlying modifiers.
      *
@@ -144,9 +152,18 @@ public:
     void setCollator(const CollatorInterface* collator);
 
 private:
-    /** Resets the state of the class associated with mods (not the error state) */
+    /**
+     * Resets the state of the class associated with mods (not the error state). Mods which may
+     * be rebound to a later update of the same shape are given to this thread's cache.
+     */
     void clear();
 
+    /**
+     * Rebinds the mods kept for updates shaped as 'updateExpr' to its arguments. Returns false,
+     * leaving '_mods' empty, if there are no such mods.
+     */
+    bool rebindCachedMods(const BSONObj& updateExpr, Status* status);
+
     /** Create the modifier and add it to the back of the modifiers vector */
     inline Status addAndParse(const modifiertable::ModifierType type, const BSONElement& elem);
 
@@ -160,6 +177,13 @@ private:
     // Collection of update mod instances. Owned here.
     std::vector<ModifierInterface*> _mods;
 
+    // The shape of the parsed update, made of its modifier names and the fields each one is
+    // on, if its mods may be kept for later updates of the same shape. Empty otherwise.
+    std::string _cacheShape;
+
+    // Were '_mods' taken from the cache rather than created by the last parse?
+    bool _reusedCachedMods;
+
     // What are the list of fields in the collection over which the update is going to be
     // applied that participate in indices?
     //
@@ -131,6 +131,64 @@ TEST(Parse, SetOnInsert) {
     ASSERT_FALSE(driver.isDocReplacement());
 }
 
+TEST(Parse, RebindsModsOfSameShape) {
+    UpdateDriver::Options opts;
+    {
+        UpdateDriver driver(opts);
+        ASSERT_OK(driver.parse(fromjson("{$set: {rebindA: 1}, $inc: {rebindB: 2}}")));
+        ASSERT_FALSE(driver.reusedCachedMods());
+    }
+
+    // The mods of the first update are rebound to the arguments of the second one.
+    UpdateDriver driver(opts);
+    BSONObj updateExpr = fromjson("{$set: {rebindA: 'x'}, $inc: {rebindB: 5}}");
+    ASSERT_OK(driver.parse(updateExpr));
+    ASSERT_TRUE(driver.reusedCachedMods());
+    ASSERT_EQUALS(driver.numMods(), 2U);
+
+    Document doc(fromjson("{rebindA: 0, rebindB: 1}"));
+    ASSERT_OK(driver.update(StringData(), &doc));
+    ASSERT_EQUALS(fromjson("{rebindA: 'x', rebindB: 6}"), doc);
+
+    // Parsing again gives the mods back to the cache before taking them.
+    ASSERT_OK(driver.parse(fromjson("{$set: {rebindA: 'y'}, $inc: {rebindB: 1}}")));
+    ASSERT_TRUE(driver.reusedCachedMods());
+
+    // A different shape, or a different order of the same fields, isn't a cache hit.
+    ASSERT_OK(driver.parse(fromjson("{$inc: {rebindB: 1}, $set: {rebindA: 'y'}}")));
+    ASSERT_FALSE(driver.reusedCachedMods());
+    ASSERT_OK(driver.parse(fromjson("{$set: {rebindA: 'y', rebindC: 1}}")));
+    ASSERT_FALSE(driver.reusedCachedMods());
+}
+
+TEST(Parse, RebindChecksArguments) {
+    UpdateDriver::Options opts;
+    {
+        UpdateDriver driver(opts);
+        ASSERT_OK(driver.parse(fromjson("{$inc: {rebindChecked: 1}}")));
+    }
+
+    UpdateDriver driver(opts);
+    ASSERT_NOT_OK(driver.parse(fromjson("{$inc: {rebindChecked: 'a'}}")));
+
+    // The mod which failed to rebind isn't kept.
+    ASSERT_OK(driver.parse(fromjson("{$inc: {rebindChecked: 1}}")));
+    ASSERT_FALSE(driver.reusedCachedMods());
+}
+
+TEST(Parse, PositionalModsAreNotCached) {
+    UpdateDriver::Options opts;
+    {
+        UpdateDriver driver(opts);
+        ASSERT_OK(driver.parse(fromjson("{$set: {'rebindPos.$': 1}}")));
+        ASSERT_TRUE(driver.needMatchDetails());
+    }
+
+    UpdateDriver driver(opts);
+    ASSERT_OK(driver.parse(fromjson("{$set: {'rebindPos.$': 2}}")));
+    ASSERT_FALSE(driver.reusedCachedMods());
+}
+
 TEST(Collator, SetCollationUpdatesModifierInterfaces) {
     CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
     BSONObj updateDocument = fromjson("{$max: {a: 'abd'}}");
@@ -62,6 +62,7 @@
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/db/stats/top.h"
+#include "mongo/db/timeseries/bucket_catalog.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/rpc/command_reply.h"
 #include "mongo/rpc/command_reply_builder.h"
@@ -107,7 +108,7 @@ void finishCurOp(OperationContext* txn, CurOp* curOp) {
         if (logAll || logSlow) {
             Locker::LockerInfo lockerInfo;
             txn->lockState()->getLockerInfo(&lockerInfo);
-            log() << curOp->debug().report(*curOp, lockerInfo.stats);
+            log() << curOp->debug().report(*curOp, lockerInfo.stats, WaitEventStats::get(txn));
         }
 
         if (curOp->shouldDBProfile(executionTimeMs)) {
@@ -168,6 +169,18 @@ void assertCanWrite_inlock(OperationContext* txn, const NamespaceString& ns) {
     CollectionShardingState::get(txn, ns)->checkShardVersionOrThrow(txn);
 }
 
+/**
+ * The measurements of a time-series collection are only inserted, since its documents are the
+ * buckets which hold them.
+ */
+void assertNotTimeseries(const Collection* collection, StringData opName) {
+    uassert(ErrorCodes::IllegalOperation,
+            str::stream() << "Cannot " << opName << " the measurements of the time-series "
+                          << "collection "
+                          << collection->ns().ns(),
+            !collection || !collection->getTimeseriesOptions());
+}
+
 void makeCollection(OperationContext* txn, const NamespaceString& ns) {
     MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
         AutoGetOrCreateDb db(txn, ns.db(), MODE_X);
@@ -300,8 +313,13 @@ static void insertDocuments(OperationContext* txn,
     // Intentionally not using a WRITE_CONFLICT_RETRY_LOOP. That is handled by the caller so it can
     // react to oversized batches.
     WriteUnitOfWork wuow(txn);
-    uassertStatusOK(collection->insertDocuments(
-        txn, begin, end, &CurOp::get(txn)->debug(), /*enforceQuota*/ true));
+    if (collection->getTimeseriesOptions()) {
+        uassertStatusOK(
+            BucketCatalog::get(txn->getServiceContext())->insert(txn, collection, begin, end));
+    } else {
+        uassertStatusOK(collection->insertDocuments(
+            txn, begin, end, &CurOp::get(txn)->debug(), /*enforceQuota*/ true));
+    }
     wuow.commit();
 }
 
@@ -510,6 +528,7 @@ static WriteResult::SingleResult performSingleUpdateOp(OperationContext* txn,
     }
 
     assertCanWrite_inlock(txn, ns);
+    assertNotTimeseries(collection->getCollection(), "update");
 
     auto exec = uassertStatusOK(
         getExecutorUpdate(txn, &curOp.debug(), collection->getCollection(), &parsedUpdate));
@@ -524,7 +543,7 @@ static WriteResult::SingleResult performSingleUpdateOp(OperationContext* txn,
     PlanSummaryStats summary;
     Explain::getSummaryStats(*exec, &summary);
     if (collection->getCollection()) {
-        collection->getCollection()->infoCache()->notifyOfQuery(txn, summary.indexesUsed);
+        collection->getCollection()->infoCache()->notifyOfQuery(txn, summary);
     }
 
     if (curOp.shouldDBProfile(curOp.elapsedMillis())) {
@@ -616,6 +635,7 @@ static WriteResult::SingleResult performSingleDeleteOp(OperationContext* txn,
     }
 
     assertCanWrite_inlock(txn, ns);
+    assertNotTimeseries(collection.getCollection(), "delete");
 
     auto exec = uassertStatusOK(
         getExecutorDelete(txn, &curOp.debug(), collection.getCollection(), &parsedDelete));
@@ -632,7 +652,7 @@ static WriteResult::SingleResult performSingleDeleteOp(OperationContext* txn,
     PlanSummaryStats summary;
     Explain::getSummaryStats(*exec, &summary);
     if (collection.getCollection()) {
-        collection.getCollection()->infoCache()->notifyOfQuery(txn, summary.indexesUsed);
+        collection.getCollection()->infoCache()->notifyOfQuery(txn, summary);
     }
     curOp.debug().setPlanSummaryMetrics(summary);
 
@@ -52,6 +52,14 @@ void Accumulator::registerAccumulator(std::string name, Factory factory) {
     factoryMap[name] = factory;
 }
 
+size_t Accumulator::leadingRunLength(const Value* inputs, size_t count, BSONType type) {
+    size_t length = 0;
+    while (length < count && inputs[length].getType() == type) {
+        length++;
+    }
+    return length;
+}
+
 Factory Accumulator::getFactory(StringData name) {
     auto it = factoryMap.find(name);
     uassert(
@@ -68,6 +68,18 @@ public:
         processInternal(input, merging);
     }
 
+    /**
+     * Processes the 'count' inputs starting at 'inputs' in order, with the same result as calling
+     * process() on each of them. Accumulators over numbers override this to handle each run of
+     * inputs of the same numeric type in a tight loop, rather than with a virtual call and a type
+     * switch per input.
+     */
+    virtual void processBatch(const Value* inputs, size_t count, bool merging) {
+        for (size_t i = 0; i < count; i++) {
+            processInternal(inputs[i], merging);
+        }
+    }
+
     /** Marks the end of the evaluate() phase and return accumulated result.
      *  toBeMerged should be true when the outputs will be merged by process().
      */
@@ -112,6 +124,9 @@ protected:
     /// Update subclass's internal state based on input
     virtual void processInternal(const Value& input, bool merging) = 0;
 
+    /// Returns the number of the 'count' inputs starting at 'inputs' which lead with type 'type'.
+    static size_t leadingRunLength(const Value* inputs, size_t count, BSONType type);
+
     /// subclasses are expected to update this as necessary
     int _memUsageBytes = 0;
 };
@@ -180,6 +195,7 @@ public:
     AccumulatorSum();
 
     void processInternal(const Value& input, bool merging) final;
+    void processBatch(const Value* inputs, size_t count, bool merging) final;
     Value getValue(bool toBeMerged) const final;
     const char* getOpName() const final;
     void reset() final;
@@ -211,6 +227,7 @@ public:
     explicit AccumulatorMinMax(Sense sense);
 
     void processInternal(const Value& input, bool merging) final;
+    void processBatch(const Value* inputs, size_t count, bool merging) final;
     Value getValue(bool toBeMerged) const final;
     const char* getOpName() const final;
     void reset() final;
@@ -262,6 +279,7 @@ public:
     AccumulatorAvg();
 
     void processInternal(const Value& input, bool merging) final;
+    void processBatch(const Value* inputs, size_t count, bool merging) final;
     Value getValue(bool toBeMerged) const final;
     const char* getOpName() const final;
     void reset() final;
@@ -28,6 +28,9 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/expression.h"
@@ -90,6 +93,40 @@ void AccumulatorAvg::processInternal(const Value& input, bool merging) {
     _count++;
 }
 
+void AccumulatorAvg::processBatch(const Value* inputs, size_t count, bool merging) {
+    if (merging) {
+        Accumulator::processBatch(inputs, count, merging);
+        return;
+    }
+
+    size_t i = 0;
+    while (i < count) {
+        const BSONType type = inputs[i].getType();
+        size_t runLength = leadingRunLength(inputs + i, count - i, type);
+        if (type == NumberInt) {
+            // The sum of fewer than 2**32 ints is exact as a long long, as is each int as a
+            // double, so adding the sum at once is the same as adding each int.
+            runLength = std::min(runLength, static_cast<size_t>(std::numeric_limits<int>::max()));
+            long long runTotal = 0;
+            for (size_t j = i; j < i + runLength; j++) {
+                runTotal += inputs[j].getInt();
+            }
+            _nonDecimalTotal.addLong(runTotal);
+            _count += runLength;
+        } else if (type == NumberDouble) {
+            for (size_t j = i; j < i + runLength; j++) {
+                _nonDecimalTotal.addDouble(inputs[j].getDouble());
+            }
+            _count += runLength;
+        } else {
+            for (size_t j = i; j < i + runLength; j++) {
+                processInternal(inputs[j], merging);
+            }
+        }
+        i += runLength;
+    }
+}
+
 intrusive_ptr<Accumulator> AccumulatorAvg::create() {
     return new AccumulatorAvg();
 }
@@ -28,6 +28,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <cmath>
+
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/value.h"
@@ -59,6 +61,48 @@ void AccumulatorMinMax::processInternal(const Value& input, bool merging) {
     }
 }
 
+void AccumulatorMinMax::processBatch(const Value* inputs, size_t count, bool merging) {
+    size_t i = 0;
+    while (i < count) {
+        const BSONType type = inputs[i].getType();
+        const size_t runLength = leadingRunLength(inputs + i, count - i, type);
+
+        // Find the first of the run's extreme values, which is the only one of them that
+        // processInternal() could keep.
+        size_t best = i;
+        if (type == NumberInt) {
+            int bestValue = inputs[i].getInt();
+            for (size_t j = i + 1; j < i + runLength; j++) {
+                const int value = inputs[j].getInt();
+                if (_sense == MIN ? value < bestValue : value > bestValue) {
+                    best = j;
+                    bestValue = value;
+                }
+            }
+            processInternal(inputs[best], merging);
+        } else if (type == NumberDouble) {
+            // NaN compares lower than all other numbers.
+            auto lessThan = [](double lhs, double rhs) {
+                return std::isnan(lhs) ? !std::isnan(rhs) : lhs < rhs;
+            };
+            double bestValue = inputs[i].getDouble();
+            for (size_t j = i + 1; j < i + runLength; j++) {
+                const double value = inputs[j].getDouble();
+                if (_sense == MIN ? lessThan(value, bestValue) : lessThan(bestValue, value)) {
+                    best = j;
+                    bestValue = value;
+                }
+            }
+            processInternal(inputs[best], merging);
+        } else {
+            for (size_t j = i; j < i + runLength; j++) {
+                processInternal(inputs[j], merging);
+            }
+        }
+        i += runLength;
+    }
+}
+
 Value AccumulatorMinMax::getValue(bool toBeMerged) const {
     if (_val.missing()) {
         return Value(BSONNULL);
@@ -28,6 +28,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 
@@ -82,6 +83,34 @@ void AccumulatorSum::processInternal(const Value& input, bool merging) {
     }
 }
 
+void AccumulatorSum::processBatch(const Value* inputs, size_t count, bool merging) {
+    size_t i = 0;
+    while (i < count) {
+        const BSONType type = inputs[i].getType();
+        size_t runLength = leadingRunLength(inputs + i, count - i, type);
+        if (type == NumberInt) {
+            // The sum of fewer than 2**32 ints can't overflow a long long, so it is exact, and
+            // adding it to the total at once is the same as adding each int.
+            runLength = std::min(runLength, static_cast<size_t>(std::numeric_limits<int>::max()));
+            long long runTotal = 0;
+            for (size_t j = i; j < i + runLength; j++) {
+                runTotal += inputs[j].getInt();
+            }
+            nonDecimalTotal.addLong(runTotal);
+        } else if (type == NumberDouble) {
+            totalType = Value::getWidestNumeric(totalType, NumberDouble);
+            for (size_t j = i; j < i + runLength; j++) {
+                nonDecimalTotal.addDouble(inputs[j].getDouble());
+            }
+        } else {
+            for (size_t j = i; j < i + runLength; j++) {
+                processInternal(inputs[j], merging);
+            }
+        }
+        i += runLength;
+    }
+}
+
 intrusive_ptr<Accumulator> AccumulatorSum::create() {
     return new AccumulatorSum();
 }
@@ -86,6 +86,15 @@ static void assertExpectedResults(
                 ASSERT_EQUALS(op.second, result);
                 ASSERT_EQUALS(op.second.getType(), result.getType());
             }
+
+            // Asserts that result equals expected result when all input is processed as a batch.
+            {
+                boost::intrusive_ptr<Accumulator> accum = factory();
+                accum->processBatch(op.first.data(), op.first.size(), false);
+                Value result = accum->getValue(false);
+                ASSERT_EQUALS(op.second, result);
+                ASSERT_EQUALS(op.second.getType(), result.getType());
+            }
         } catch (...) {
             log() << "failed with arguments: " << Value(op.first);
             throw;
@@ -195,7 +204,14 @@ TEST(Accumulators, Min) {
          // The accumulator evaluates two documents and retains the minimum value.
          {{Value(5), Value(7)}, Value(5)},
          // The accumulator evaluates two documents and ignores the missing value.
-         {{Value(7), Value()}, Value(7)}});
+         {{Value(7), Value()}, Value(7)},
+
+         // A run of ints, then a run of doubles, keeps the minimum of both.
+         {{Value(5), Value(-3), Value(8), Value(2.5), Value(-1.5)}, Value(-3)},
+         {{Value(5), Value(3), Value(2.5), Value(-1.5), Value(4.0)}, Value(-1.5)},
+         // NaN is lower than all other numbers.
+         {{Value(1.0), Value(numeric_limits<double>::quiet_NaN()), Value(-1.0)},
+          Value(numeric_limits<double>::quiet_NaN())}});
 }
 
 TEST(Accumulators, Max) {
@@ -212,7 +228,15 @@ TEST(Accumulators, Max) {
          // The accumulator evaluates two documents and retains the maximum value.
          {{Value(5), Value(7)}, Value(7)},
          // The accumulator evaluates two documents and ignores the missing value.
-         {{Value(7), Value()}, Value(7)}});
+         {{Value(7), Value()}, Value(7)},
+
+         // A run of ints, then a run of doubles, keeps the maximum of both.
+         {{Value(5), Value(-3), Value(8), Value(2.5), Value(-1.5)}, Value(8)},
+         {{Value(5), Value(3), Value(2.5), Value(7.5), Value(4.0)}, Value(7.5)},
+         // NaN is lower than all other numbers.
+         {{Value(numeric_limits<double>::quiet_NaN()), Value(-1.0)}, Value(-1.0)},
+         {{Value(numeric_limits<double>::quiet_NaN())},
+          Value(numeric_limits<double>::quiet_NaN())}});
 }
 
 TEST(Accumulators, Sum) {
@@ -144,13 +144,21 @@ void DocumentStorage::alloc(unsigned newSize) {
 
     uassert(16490, "Tried to make oversized document", capacity <= size_t(BufferMaxSize));
 
-    std::unique_ptr<char[]> oldBuf(_buffer);
-    _buffer = new char[capacity];
+    boost::intrusive_ptr<DocumentArena::Chunk> newChunk;
+    char* newBuffer = allocateBuffer(capacity, &newChunk);
+
+    // Whichever way the old buffer was allocated, it is released at the end of this scope.
+    std::unique_ptr<char[]> oldBuf(_arenaChunk ? nullptr : _buffer);
+    const boost::intrusive_ptr<DocumentArena::Chunk> oldChunk = std::move(_arenaChunk);
+    const char* const oldBuffer = _buffer;
+
+    _buffer = newBuffer;
+    _arenaChunk = std::move(newChunk);
     _bufferEnd = _buffer + capacity - hashTabBytes();
 
     if (!firstAlloc) {
         // This just copies the elements
-        memcpy(_buffer, oldBuf.get(), _usedBytes);
+        memcpy(_buffer, oldBuffer, _usedBytes);
 
         if (_numFields >= HASH_TAB_MIN) {
             // if we were hashing, deal with the hash table
@@ -158,7 +166,7 @@ void DocumentStorage::alloc(unsigned newSize) {
                 rehash();
             } else {
                 // no rehash needed so just slide table down to new position
-                memcpy(_hashTab, oldBuf.get() + oldCapacity, hashTabBytes());
+                memcpy(_hashTab, oldBuffer + oldCapacity, hashTabBytes());
             }
         }
     }
@@ -177,17 +185,25 @@ void DocumentStorage::reserveFields(size_t expectedFields) {
 
     uassert(16491, "Tried to make oversized document", newSize <= size_t(BufferMaxSize));
 
-    _buffer = new char[newSize + hashTabBytes()];
+    _buffer = allocateBuffer(newSize + hashTabBytes(), &_arenaChunk);
     _bufferEnd = _buffer + newSize;
 }
 
+char* DocumentStorage::allocateBuffer(size_t bytes,
+                                      boost::intrusive_ptr<DocumentArena::Chunk>* chunk) {
+    if (DocumentArena* arena = DocumentArena::current()) {
+        return arena->allocate(bytes, chunk);
+    }
+    return new char[bytes];
+}
+
 intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
     intrusive_ptr<DocumentStorage> out(new DocumentStorage());
 
     // Make a copy of the buffer.
     // It is very important that the positions of each field are the same after cloning.
     const size_t bufferBytes = (_bufferEnd + hashTabBytes()) - _buffer;
-    out->_buffer = new char[bufferBytes];
+    out->_buffer = allocateBuffer(bufferBytes, &out->_arenaChunk);
     out->_bufferEnd = out->_buffer + (_bufferEnd - _buffer);
     memcpy(out->_buffer, _buffer, bufferBytes);
 
@@ -208,7 +224,8 @@ intrusive_ptr<DocumentStorage> DocumentStorage::clone() const {
 }
 
 DocumentStorage::~DocumentStorage() {
-    std::unique_ptr<char[]> deleteBufferAtScopeEnd(_buffer);
+    // An arena buffer goes away with the last reference to its chunk.
+    std::unique_ptr<char[]> deleteBufferAtScopeEnd(_arenaChunk ? nullptr : _buffer);
 
     for (DocumentStorageIterator it = iteratorAll(); !it.atEnd(); it.advance()) {
         it->val.~Value();  // explicit destructor call
@@ -245,12 +262,21 @@ BSONObjBuilder& operator<<(BSONObjBuilderValueStream& builder, const Document& d
 }
 
 void Document::toBson(BSONObjBuilder* pBuilder) const {
+    if (!storage().getOriginalBson().isEmpty()) {
+        pBuilder->appendElements(storage().getOriginalBson());
+        return;
+    }
+
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
         *pBuilder << it->nameSD() << it->val;
     }
 }
 
 BSONObj Document::toBson() const {
+    if (!storage().getOriginalBson().isEmpty()) {
+        return storage().getOriginalBson();
+    }
+
     BSONObjBuilder bb;
     toBson(&bb);
     return bb.obj();
@@ -260,6 +286,10 @@ const StringData Document::metaFieldTextScore("$textScore"_sd);
 const StringData Document::metaFieldRandVal("$randVal"_sd);
 
 BSONObj Document::toBsonWithMetaData() const {
+    if (!hasTextScore() && !hasRandMetaField()) {
+        return toBson();
+    }
+
     BSONObjBuilder bb;
     toBson(&bb);
     if (hasTextScore())
@@ -293,6 +323,16 @@ Document Document::fromBsonWithMetaData(const BSONObj& bson) {
     return md.freeze();
 }
 
+Document Document::fromBsonKeepingOriginal(const BSONObj& bson) {
+    dassert(bson.isOwned());
+    Document doc = fromBsonWithMetaData(bson);
+    if (doc._storage && !doc.hasTextScore() && !doc.hasRandMetaField()) {
+        // Nothing else refers to the storage yet.
+        const_cast<DocumentStorage&>(doc.storage()).setOriginalBson(bson);
+    }
+    return doc;
+}
+
 MutableDocument::MutableDocument(size_t expectedFields)
     : _storageHolder(NULL), _storage(_storageHolder) {
     if (expectedFields) {
@@ -364,6 +404,9 @@ size_t Document::getApproximateSize() const {
 
     size_t size = sizeof(DocumentStorage);
     size += storage().allocatedBytes();
+    if (!storage().getOriginalBson().isEmpty()) {
+        size += storage().getOriginalBson().objsize();
+    }
 
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
         size += it->val.getApproximateSize();
@@ -178,6 +178,13 @@ public:
      */
     static Document fromBsonWithMetaData(const BSONObj& bson);
 
+    /**
+     * Like fromBsonWithMetaData, but if 'bson' holds no metadata, the document remembers it. Until
+     * the document is modified, toBson() then returns 'bson' itself rather than serializing the
+     * document again. 'bson' must be owned, and is counted in getApproximateSize().
+     */
+    static Document fromBsonKeepingOriginal(const BSONObj& bson);
+
     // Support BSONObjBuilder and BSONArrayBuilder "stream" API
     friend BSONObjBuilder& operator<<(BSONObjBuilderValueStream& builder, const Document& d);
 
@@ -497,7 +504,11 @@ private:
             return clonedStorage();
 
         // This function exists to ensure this is safe
-        return const_cast<DocumentStorage&>(*storagePtr());
+        DocumentStorage& storage = const_cast<DocumentStorage&>(*storagePtr());
+
+        // A modified document no longer matches the BSON it was read from.
+        storage.clearOriginalBson();
+        return storage;
     }
     DocumentStorage& newStorage() {
         reset(new DocumentStorage);
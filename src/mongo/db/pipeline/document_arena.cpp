@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_arena.h"
+
+#include <cstdlib>
+
+#include "mongo/util/allocator.h"
+#include "mongo/util/concurrency/threadlocal.h"
+
+namespace mongo {
+
+namespace {
+MONGO_TRIVIALLY_CONSTRUCTIBLE_THREAD_LOCAL DocumentArena* currentArena;
+
+constexpr size_t alignUp(size_t bytes) {
+    return (bytes + DocumentArena::kAlignment - 1) & ~(DocumentArena::kAlignment - 1);
+}
+}  // namespace
+
+const size_t DocumentArena::Chunk::kHeaderBytes = alignUp(sizeof(DocumentArena::Chunk));
+
+boost::intrusive_ptr<DocumentArena::Chunk> DocumentArena::Chunk::create(size_t capacity) {
+#pragma warning(push)
+#pragma warning(disable : 4291)
+    return new (kHeaderBytes + capacity) Chunk(capacity);  // uses custom operator new
+#pragma warning(pop)
+}
+
+void* DocumentArena::Chunk::operator new(size_t objSize, size_t realSize) {
+    return mongoMalloc(realSize);
+}
+
+void DocumentArena::Chunk::operator delete(void* ptr) {
+    free(ptr);
+}
+
+DocumentArena::Scope::Scope(DocumentArena* arena) : _previous(currentArena) {
+    currentArena = arena;
+}
+
+DocumentArena::Scope::~Scope() {
+    currentArena = _previous;
+}
+
+DocumentArena* DocumentArena::current() {
+    return currentArena;
+}
+
+char* DocumentArena::allocate(size_t bytes, boost::intrusive_ptr<Chunk>* chunk) {
+    bytes = alignUp(bytes);
+    _bytesAllocated += bytes;
+
+    if (bytes > kMaxSharedAllocationBytes) {
+        *chunk = Chunk::create(bytes);
+        _chunksAllocated++;
+        return (*chunk)->data();
+    }
+
+    if (!_chunk || _chunkUsed + bytes > _chunk->capacity()) {
+        // Dropping our reference lets the old chunk go as soon as its last buffer does.
+        _chunk = Chunk::create(kChunkBytes);
+        _chunkUsed = 0;
+        _chunksAllocated++;
+    }
+
+    char* out = _chunk->data() + _chunkUsed;
+    _chunkUsed += bytes;
+    *chunk = _chunk;
+    return out;
+}
+
+}  // namespace mongo
@@ -0,0 +1,134 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/intrusive_ptr.hpp>
+#include <cstddef>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/util/intrusive_counter.h"
+
+namespace mongo {
+
+/**
+ * A bump allocator for the buffers of the DocumentStorage objects created while a pipeline runs.
+ *
+ * Memory is handed out from reference-counted chunks. Every buffer holds a reference to the chunk
+ * it lives in, and the arena holds one to the chunk it is currently filling, so a chunk is freed
+ * in one piece once the arena has moved on and the last document allocated from it is gone. For a
+ * pipeline which does not hold on to its input, that happens between calls to getNext().
+ *
+ * Allocation only happens from the thread which has installed the arena with a Scope. Chunks may
+ * be released from any thread.
+ */
+class DocumentArena {
+    MONGO_DISALLOW_COPYING(DocumentArena);
+
+public:
+    static const size_t kChunkBytes = 64 * 1024;
+
+    // Allocations larger than this get a chunk of their own rather than wasting the rest of the
+    // current one.
+    static const size_t kMaxSharedAllocationBytes = kChunkBytes / 4;
+
+    // Every allocation is aligned to this, which matches what malloc() guarantees.
+    static const size_t kAlignment = 16;
+
+    class Chunk : public RefCountable {
+    public:
+        static boost::intrusive_ptr<Chunk> create(size_t capacity);
+
+        char* data() {
+            return reinterpret_cast<char*>(this) + kHeaderBytes;
+        }
+        size_t capacity() const {
+            return _capacity;
+        }
+
+        void operator delete(void* ptr);
+
+    private:
+        // sizeof(Chunk) rounded up to kAlignment, so that data() is aligned for any Value.
+        static const size_t kHeaderBytes;
+
+        explicit Chunk(size_t capacity) : _capacity(capacity) {}
+        void* operator new(size_t objSize, size_t realSize);
+
+        const size_t _capacity;
+        // char[_capacity] array allocated past end of class
+    };
+
+    /**
+     * Makes 'arena' the arena of the current thread until the Scope is destroyed, restoring the
+     * previous one afterwards. A null 'arena' turns arena allocation off for the scope.
+     */
+    class Scope {
+        MONGO_DISALLOW_COPYING(Scope);
+
+    public:
+        explicit Scope(DocumentArena* arena);
+        ~Scope();
+
+    private:
+        DocumentArena* const _previous;
+    };
+
+    DocumentArena() = default;
+
+    /**
+     * Returns the arena installed on the current thread, or nullptr if there is none.
+     */
+    static DocumentArena* current();
+
+    /**
+     * Returns 'bytes' bytes of memory, and sets '*chunk' to the chunk they belong to. The memory
+     * stays valid for as long as the caller holds on to that reference.
+     */
+    char* allocate(size_t bytes, boost::intrusive_ptr<Chunk>* chunk);
+
+    /**
+     * Returns the number of bytes handed out by this arena since it was created, and the number of
+     * chunks it has allocated to hold them.
+     */
+    size_t bytesAllocated() const {
+        return _bytesAllocated;
+    }
+    size_t chunksAllocated() const {
+        return _chunksAllocated;
+    }
+
+private:
+    boost::intrusive_ptr<Chunk> _chunk;
+    size_t _chunkUsed = 0;
+
+    size_t _bytesAllocated = 0;
+    size_t _chunksAllocated = 0;
+};
+
+}  // namespace mongo
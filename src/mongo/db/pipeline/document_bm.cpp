@@ -0,0 +1,74 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+const BSONObj kSource = fromjson("{_id: 1, a: 2, b: 3.5, c: {d: 4, e: 5}, f: [1, 2, 3]}");
+
+MONGO_BENCHMARK(DocumentConstructFromMutableDocument) {
+    while (state.keepRunning()) {
+        MutableDocument md(4);
+        md.addField("_id", Value(1));
+        md.addField("a", Value(2));
+        md.addField("b", Value(3.5));
+        md.addField("c", Value(StringData("benchmark")));
+        benchmark::doNotOptimizeAway(md.freeze());
+    }
+}
+
+MONGO_BENCHMARK(DocumentConstructFromBSON) {
+    while (state.keepRunning()) {
+        benchmark::doNotOptimizeAway(Document(kSource));
+    }
+}
+
+MONGO_BENCHMARK(DocumentGetField) {
+    const Document doc(kSource);
+    while (state.keepRunning()) {
+        benchmark::doNotOptimizeAway(doc["c"]);
+    }
+}
+
+MONGO_BENCHMARK(DocumentToBson) {
+    const Document doc(kSource);
+    while (state.keepRunning()) {
+        benchmark::doNotOptimizeAway(doc.toBson());
+    }
+}
+
+}  // namespace
+}  // namespace mongo
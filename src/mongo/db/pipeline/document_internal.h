@@ -33,6 +33,7 @@
 #include <bitset>
 #include <boost/intrusive_ptr.hpp>
 
+#include "mongo/db/pipeline/document_arena.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/util/intrusive_counter.h"
 
@@ -304,6 +305,22 @@ public:
         _randVal = val;
     }
 
+    /**
+     * The BSON this document was read from, as long as the document still matches it, or an
+     * empty object. See Document::fromBsonKeepingOriginal().
+     */
+    const BSONObj& getOriginalBson() const {
+        return _originalBson;
+    }
+    void setOriginalBson(BSONObj bson) {
+        _originalBson = std::move(bson);
+    }
+    void clearOriginalBson() {
+        if (MONGO_unlikely(!_originalBson.isEmpty())) {
+            _originalBson = BSONObj();
+        }
+    }
+
 private:
     /// Same as lastElement->next() or firstElement() if empty.
     const ValueElement* end() const {
@@ -313,6 +330,12 @@ private:
     /// Allocates space in _buffer. Copies existing data if there is any.
     void alloc(unsigned newSize);
 
+    /**
+     * Returns a new buffer of 'bytes' bytes. It comes from the current thread's DocumentArena, in
+     * which case '*chunk' is set to the chunk holding it, if there is one, or from the heap.
+     */
+    static char* allocateBuffer(size_t bytes, boost::intrusive_ptr<DocumentArena::Chunk>* chunk);
+
     /// Call after adding field to _buffer and increasing _numFields
     void addFieldToHashTable(Position pos);
 
@@ -387,6 +410,12 @@ private:
     double _randVal;
     // When adding a field, make sure to update clone() method
 
+    // Not copied by clone(), since clones are made to be modified.
+    BSONObj _originalBson;
+
+    // The arena chunk holding _buffer, or null if _buffer was allocated with new[].
+    boost::intrusive_ptr<DocumentArena::Chunk> _arenaChunk;
+
     // Defined in document.cpp
     static const DocumentStorage kEmptyDoc;
 };
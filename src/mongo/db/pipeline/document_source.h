@@ -30,6 +30,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <atomic>
 #include <deque>
 #include <list>
 #include <string>
@@ -220,6 +221,25 @@ public:
         return false;
     }
 
+    /**
+     * Returns true if this stage lets go of each input document, and of any value taken from it,
+     * once it has produced the output derived from it. Only a pipeline made entirely of such
+     * stages may allocate its documents from a DocumentArena, as a stage holding on to documents
+     * would keep whole arena chunks alive without accounting for them.
+     */
+    virtual bool canUseDocumentArena() const {
+        return false;
+    }
+
+    /**
+     * Returns true if this stage never modifies the documents it receives, but only filters,
+     * reorders or writes them. Documents which only go through such stages are serialized as the
+     * BSON they were read as. See Pipeline::neverModifiesDocuments().
+     */
+    virtual bool neverModifiesDocuments() const {
+        return false;
+    }
+
     /**
      * If DocumentSource uses additional collections, it adds the namespaces to the input vector.
      */
@@ -350,11 +370,34 @@ public:
         virtual bool hasUniqueIdIndex(const NamespaceString& ns) const = 0;
 
         /**
-         * Appends operation latency statistics for collection "nss" to "builder"
+         * Appends operation latency statistics for collection "nss" to "builder", including those
+         * of each of its query shapes if "includeQueryShapes" is true.
          */
         virtual void appendLatencyStats(const NamespaceString& nss,
+                                        bool includeQueryShapes,
                                         BSONObjBuilder* builder) const = 0;
 
+        /**
+         * Appends the storage engine's cache and I/O counters for collection "nss" to "builder".
+         * Appends nothing if the collection doesn't exist.
+         */
+        virtual void appendStorageIOStats(const NamespaceString& nss,
+                                          BSONObjBuilder* builder) const = 0;
+
+        /**
+         * Returns the storage engine's cache and I/O counters for each index of collection "ns",
+         * keyed by index name.
+         */
+        virtual BSONObj getIndexStorageIOStats(OperationContext* opCtx,
+                                               const NamespaceString& ns) = 0;
+
+        /**
+         * Appends the write conflict and document contention counters for collection "nss" to
+         * "builder".
+         */
+        virtual void appendWriteConflictStats(const NamespaceString& nss,
+                                              BSONObjBuilder* builder) const = 0;
+
         // Add new methods as needed.
     };
 
@@ -413,6 +456,9 @@ public:
     ~DocumentSourceCursor() final;
     boost::optional<Document> getNext() final;
     const char* getSourceName() const final;
+    bool canUseDocumentArena() const final {
+        return true;
+    }
     BSONObjSet getOutputSorts() final {
         return _outputSorts;
     }
@@ -487,6 +533,14 @@ public:
         _shouldProduceEmptyDocs = true;
     }
 
+    /**
+     * Makes each document remember the BSON it was read from, so that it is serialized as that
+     * BSON for as long as it is not modified. Only has an effect on whole documents.
+     */
+    void shouldKeepOriginalBson() {
+        _shouldKeepOriginalBson = true;
+    }
+
     const std::string& getPlanSummaryStr() const;
 
     const PlanSummaryStats& getPlanSummaryStats() const;
@@ -509,6 +563,7 @@ private:
     BSONObj _sort;
     BSONObj _projection;
     bool _shouldProduceEmptyDocs = false;
+    bool _shouldKeepOriginalBson = false;
     boost::optional<ParsedDeps> _dependencies;
     boost::intrusive_ptr<DocumentSourceLimit> _limit;
     long long _docsAddedToBatches;  // for _limit enforcement
@@ -521,6 +576,10 @@ private:
 };
 
 
+// If greater than 1, an unsorted $group partitions its groups by hash of the group key between
+// this many worker threads, each of which owns the accumulators of its partition.
+extern std::atomic<int> internalDocumentSourceGroupParallelThreads;  // NOLINT
+
 class DocumentSourceGroup final : public DocumentSource, public SplittableDocumentSource {
 public:
     using Accumulators = std::vector<boost::intrusive_ptr<Accumulator>>;
@@ -569,6 +628,15 @@ public:
         return _streaming;
     }
 
+    /**
+     * Returns true if this $group's _id is a single field path of the input documents, and it
+     * only has $first accumulators, or only $last accumulators. Each group then only depends on
+     * one of its documents, so the input can be narrowed down to that document for each value of
+     * the _id. Sets 'idPath' to the path of the _id, and 'usesLast' to whether the accumulators
+     * are $last.
+     */
+    bool onlyNeedsOneDocumentPerGroup(std::string* idPath, bool* usesLast) const;
+
     // Virtuals for SplittableDocumentSource.
     boost::intrusive_ptr<DocumentSource> getShardSource() final;
     boost::intrusive_ptr<DocumentSource> getMergeSource() final;
@@ -591,6 +659,31 @@ private:
      */
     boost::optional<BSONObj> findRelevantInputSort() const;
 
+    /**
+     * Returns true if the documents in the same group as 'input' are guaranteed to be adjacent to
+     * each other in the sorted input of a streaming $group, ignoring documents for which this
+     * returns false. That is not the case if any of the fields the input is sorted on holds an
+     * array, an object or a nullish value: null, undefined and missing values are ordered together
+     * but form distinct groups, and an array is ordered by one of its elements. Strings are not
+     * safe either if the pipeline has a collation.
+     */
+    bool hasStreamableKey(const Document& input) const;
+
+    /**
+     * Pulls input for a streaming $group until it finds a document with a streamable key, which it
+     * leaves in '_firstDocOfNextGroup' and as the root of '_variables', with its group key in
+     * 'id'. The other documents are accumulated in 'groups', spilling them to
+     * '_unstreamableSpills' if they take up too much memory. Returns false once the input is
+     * exhausted.
+     */
+    bool loadNextStreamableDocument(Value* id);
+
+    /**
+     * Called once the sorted input of a streaming $group is exhausted. Prepares to output the
+     * groups of the documents with unstreamable keys, as an unsorted $group would.
+     */
+    void finishStreaming();
+
     /**
      * Before returning anything, this source must prepare itself. In a streaming $group,
      * initialize() requests the first document from the previous source, and uses it to prepare the
@@ -600,11 +693,25 @@ private:
     void initialize();
 
     /**
-     * Spill groups map to disk and returns an iterator to the file. Note: Since a sorted $group
+     * The parallel counterpart of the unsorted part of initialize(). Exhausts the previous source,
+     * evaluating the group key and accumulator arguments of each document on this thread and
+     * handing them in batches to one of 'numPartitions' worker threads, chosen by hash of the
+     * key. Each worker owns the groups of its partition and spills them on its own once they
+     * outgrow their share of '_maxMemoryUsageBytes'.
+     *
+     * On return either 'sortedFiles' holds every group, or it is empty and the groups are in
+     * 'groups' and '_pendingGroups'.
+     */
+    void initializeParallel(
+        size_t numPartitions,
+        std::vector<std::shared_ptr<Sorter<Value, Value>::Iterator>>* sortedFiles);
+
+    /**
+     * Spill a groups map to disk and returns an iterator to the file. Note: Since a sorted $group
      * does not exhaust the previous stage before returning, and thus does not maintain as large a
      * store of documents at any one time, only an unsorted group can spill to disk.
      */
-    std::shared_ptr<Sorter<Value, Value>::Iterator> spill();
+    std::shared_ptr<Sorter<Value, Value>::Iterator> spill(GroupsMap* groupsToSpill);
 
     Document makeDocument(const Value& id, const Accumulators& accums, bool mergeableOutput);
 
@@ -644,6 +751,13 @@ private:
     bool _streaming;
     bool _initialized;
 
+    // The fields of '_inputSort', and the state of the side table in 'groups' that holds the
+    // groups with unstreamable keys. Only used when '_streaming' is true.
+    std::vector<FieldPath> _inputSortPaths;
+    int _unstreamableMemoryUsageBytes = 0;
+    std::vector<std::shared_ptr<Sorter<Value, Value>::Iterator>> _unstreamableSpills;
+    bool _sortedInputExhausted = false;
+
     Value _currentId;
     Accumulators _currentAccumulators;
 
@@ -654,6 +768,10 @@ private:
     // Only used when '_spilled' is false.
     GroupsMap::iterator groupsIterator;
 
+    // Partitions of a parallel $group whose groups are returned once 'groups' is exhausted. Only
+    // used when '_spilled' is false.
+    std::vector<GroupsMap> _pendingGroups;
+
     // Only used when '_spilled' is true.
     std::unique_ptr<Sorter<Value, Value>::Iterator> _sorterIterator;
     const bool _extSortAllowed;
@@ -686,14 +804,59 @@ private:
 
     CollectionIndexUsageMap _indexStatsMap;
     CollectionIndexUsageMap::const_iterator _indexStatsIter;
+    BSONObj _indexStorageIOStats;
     std::string _processName;
 };
 
+/**
+ * Provides recommended index changes for a collection, from the usage profile of each of its
+ * indexes and the query shapes in its plan cache. Each output document is either a "drop" of an
+ * index that no operation used since the server started tracking it, or whose key pattern is a
+ * prefix of another index's, or a "create" of an index on the equality, sort and then range
+ * fields of a cached query shape that no index starts with.
+ */
+class DocumentSourceIndexAdvisor final : public DocumentSourceNeedsMongod {
+public:
+    // virtuals from DocumentSource
+    boost::optional<Document> getNext() final;
+    const char* getSourceName() const final;
+    Value serialize(bool explain = false) const final;
+
+    virtual bool isValidInitialSource() const final {
+        return true;
+    }
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
+
+    /**
+     * Returns the key pattern of the index that best serves query shape 'query' and 'sort': its
+     * equality fields first, then its sort fields, then its range fields. Returns an empty object
+     * if the shape constrains no top-level field.
+     */
+    static BSONObj recommendedKeyPattern(const BSONObj& query, const BSONObj& sort);
+
+private:
+    DocumentSourceIndexAdvisor(const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
+
+    void computeRecommendations();
+
+    bool _computed = false;
+    std::vector<Document> _recommendations;
+    std::vector<Document>::const_iterator _recommendationsIter;
+};
+
 class DocumentSourceMatch final : public DocumentSource {
 public:
     // virtuals from DocumentSource
     boost::optional<Document> getNext() final;
     const char* getSourceName() const final;
+    bool canUseDocumentArena() const final {
+        return true;
+    }
+    bool neverModifiesDocuments() const final {
+        return true;
+    }
     Value serialize(bool explain = false) const final;
     boost::intrusive_ptr<DocumentSource> optimize() final;
     BSONObjSet getOutputSorts() final {
@@ -929,6 +1092,12 @@ public:
     ~DocumentSourceOut() final;
     boost::optional<Document> getNext() final;
     const char* getSourceName() const final;
+    bool canUseDocumentArena() const final {
+        return true;
+    }
+    bool neverModifiesDocuments() const final {
+        return true;
+    }
     Value serialize(bool explain = false) const final;
     GetDepsReturn getDependencies(DepsTracker* deps) const final;
     bool needsPrimaryShard() const final {
@@ -969,10 +1138,18 @@ private:
 
     void spill(const std::vector<BSONObj>& toInsert);
 
+    // Builds the indexes in _indexesToBuild on _tempNs, once all data has been inserted.
+    void buildIndexes();
+
     bool _done;
 
     NamespaceString _tempNs;          // output goes here as it is being processed.
     const NamespaceString _outputNs;  // output will go here after all data is processed.
+
+    // The secondary indexes of _outputNs, which are only built on _tempNs after all of the data
+    // has been inserted, so that they are bulk built with one collection scan rather than
+    // maintained by every insert.
+    std::vector<BSONObj> _indexesToBuild;
 };
 
 
@@ -980,6 +1157,9 @@ class DocumentSourceProject final : public DocumentSource {
 public:
     boost::optional<Document> getNext() final;
     const char* getSourceName() const final;
+    bool canUseDocumentArena() const final {
+        return true;
+    }
     Value serialize(bool explain = false) const final;
     void dispose() final;
 
@@ -1019,6 +1199,9 @@ class DocumentSourceRedact final : public DocumentSource {
 public:
     boost::optional<Document> getNext() final;
     const char* getSourceName() const final;
+    bool canUseDocumentArena() const final {
+        return true;
+    }
     boost::intrusive_ptr<DocumentSource> optimize() final;
 
     /**
@@ -1051,6 +1234,9 @@ public:
     boost::optional<Document> getNext() final;
     const char* getSourceName() const final;
     Value serialize(bool explain = false) const final;
+    bool neverModifiesDocuments() const final {
+        return true;
+    }
 
     GetDepsReturn getDependencies(DepsTracker* deps) const final {
         return SEE_NEXT;
@@ -1086,17 +1272,23 @@ public:
     Value serialize(bool explain = false) const final;
     GetDepsReturn getDependencies(DepsTracker* deps) const final;
 
+    /**
+     * If 'deduplicate' is false, the input is known to hold no duplicates, and is not
+     * de-duplicated by 'idField'.
+     */
     static boost::intrusive_ptr<DocumentSourceSampleFromRandomCursor> create(
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
         long long size,
         std::string idField,
-        long long collectionSize);
+        long long collectionSize,
+        bool deduplicate = true);
 
 private:
     DocumentSourceSampleFromRandomCursor(const boost::intrusive_ptr<ExpressionContext>& expCtx,
                                          long long size,
                                          std::string idField,
-                                         long long collectionSize);
+                                         long long collectionSize,
+                                         bool deduplicate);
 
     /**
      * Keep asking for documents from the random cursor until it yields a new document. Errors if a
@@ -1110,10 +1302,15 @@ private:
     // The field to use as the id of a document. Usually '_id', but 'ts' for the oplog.
     std::string _idField;
 
+    // Whether the input may hold duplicates, which have to be filtered out by '_idField'.
+    const bool _deduplicate;
+
     // Keeps track of the documents that have been returned, since a random cursor is allowed to
-    // return duplicates.
+    // return duplicates. Only used if '_deduplicate' is true.
     ValueSet _seenDocs;
 
+    long long _nReturned = 0;
+
     // The approximate number of documents in the collection (includes orphans).
     const long long _nDocsInColl;
 
@@ -1128,6 +1325,12 @@ public:
     // virtuals from DocumentSource
     boost::optional<Document> getNext() final;
     const char* getSourceName() const final;
+    bool canUseDocumentArena() const final {
+        return true;
+    }
+    bool neverModifiesDocuments() const final {
+        return true;
+    }
     BSONObjSet getOutputSorts() final {
         return pSource ? pSource->getOutputSorts() : BSONObjSet();
     }
@@ -1194,6 +1397,9 @@ public:
     boost::optional<Document> getNext() final;
     const char* getSourceName() const final;
     void serializeToArray(std::vector<Value>& array, bool explain = false) const final;
+    bool neverModifiesDocuments() const final {
+        return true;
+    }
 
     BSONObjSet getOutputSorts() final {
         return allPrefixes(_sort);
@@ -1349,6 +1555,12 @@ public:
     // virtuals from DocumentSource
     boost::optional<Document> getNext() final;
     const char* getSourceName() const final;
+    bool canUseDocumentArena() const final {
+        return true;
+    }
+    bool neverModifiesDocuments() const final {
+        return true;
+    }
     /**
      * Attempts to move a subsequent $limit before the skip, potentially allowing for forther
      * optimizations earlier in the pipeline.
@@ -1417,6 +1629,9 @@ public:
     // virtuals from DocumentSource
     boost::optional<Document> getNext() final;
     const char* getSourceName() const final;
+    bool canUseDocumentArena() const final {
+        return true;
+    }
     Value serialize(bool explain = false) const final;
     BSONObjSet getOutputSorts() final;
 
@@ -1544,6 +1759,10 @@ private:
  * Queries separate collection for equality matches with documents in the pipeline collection.
  * Adds matching documents to a new array field in the input document.
  */
+// How many input documents does a $lookup without an absorbed $unwind join with a single query on
+// the foreign collection? Values of 1 or less query once per input document.
+extern std::atomic<int> internalDocumentSourceLookupBatchSize;  // NOLINT
+
 class DocumentSourceLookUp final : public DocumentSourceNeedsMongod,
                                    public SplittableDocumentSource {
 public:
@@ -1603,6 +1822,26 @@ private:
 
     boost::optional<Document> unwindResult();
 
+    /**
+     * Returns the documents of the foreign collection which join with 'input', each queried on its
+     * own.
+     */
+    std::vector<Value> lookUpInput(const Document& input);
+
+    /**
+     * Pulls up to 'batchSize' documents from our source and appends them to '_batchedResults' with
+     * their joined documents. Inputs whose local field is a scalar that compares the same under
+     * any collation are joined using a single $in query, then hashed into place by the values of
+     * their foreign field. The rest are queried on their own.
+     */
+    void lookUpBatch(size_t batchSize);
+
+    /**
+     * Returns true if inputs whose local field is 'localFieldVal' can be joined by lookUpBatch()'s
+     * shared $in query.
+     */
+    bool isBatchableValue(const Value& localFieldVal) const;
+
     NamespaceString _fromNs;
     FieldPath _as;
     FieldPath _localField;
@@ -1618,8 +1857,23 @@ private:
     std::unique_ptr<DBClientCursor> _cursor;
     long long _cursorIndex = 0;
     boost::optional<Document> _input;
+
+    // Whether '_foreignField' can be traversed by extractAllElementsAlongPath() the same way the
+    // matcher would, which lookUpBatch() relies on. Paths with positional components can't.
+    bool _canBatchForeignField = true;
+
+    // Joined documents produced by lookUpBatch(), waiting to be returned in input order.
+    std::deque<Document> _batchedResults;
 };
 
+// How much memory may a $graphLookup use for the documents it has found for an input, its search
+// frontier and, in whatever is left, its cache of query results?
+extern std::atomic<long long> internalDocumentSourceGraphLookupMaxMemoryBytes;  // NOLINT
+
+// At most how many frontier values does each $in query of a $graphLookup search ask for? Larger
+// frontiers are queried in several batches.
+extern std::atomic<int> internalDocumentSourceGraphLookupMaxQueryValues;  // NOLINT
+
 class DocumentSourceGraphLookUp final : public DocumentSourceNeedsMongod {
 public:
     boost::optional<Document> getNext() final;
@@ -1666,14 +1920,15 @@ private:
     }
 
     /**
-     * Prepare the query to execute on the 'from' collection, using the contents of '_frontier'.
+     * Prepare the queries to execute on the 'from' collection, using the contents of '_frontier'.
+     * Each asks for at most internalDocumentSourceGraphLookupMaxQueryValues values, and stays well
+     * under the maximum BSON object size.
      *
      * Fills 'cached' with any values that were retrieved from the cache.
      *
-     * Returns boost::none if no query is necessary, i.e., all values were retrieved from the cache.
-     * Otherwise, returns a query object.
+     * Returns no queries if none are necessary, i.e., all values were retrieved from the cache.
      */
-    boost::optional<BSONObj> constructQuery(BSONObjSet* cached);
+    std::vector<BSONObj> constructQueries(BSONObjSet* cached);
 
     /**
      * If we have internalized a $unwind, getNext() dispatches to this function.
@@ -1722,7 +1977,7 @@ private:
     boost::optional<FieldPath> _depthField;
     boost::optional<long long> _maxDepth;
 
-    size_t _maxMemoryUsageBytes = 100 * 1024 * 1024;
+    const size_t _maxMemoryUsageBytes;
 
     // Track memory usage to ensure we don't exceed '_maxMemoryUsageBytes'.
     size_t _visitedUsageBytes = 0;
@@ -1794,6 +2049,37 @@ public:
 
 private:
     bool _latencySpecified = false;
+    bool _queryShapesSpecified = false;
+    bool _storageIOSpecified = false;
+    bool _writeConflictsSpecified = false;
     bool _finished = false;
 };
+
+/**
+ * Returns the most recent profile documents recorded by the sampled profiler for the database of
+ * the aggregation, oldest first.
+ */
+class DocumentSourceSampledProfile final : public DocumentSource {
+public:
+    boost::optional<Document> getNext() final;
+
+    const char* getSourceName() const final;
+
+    bool isValidInitialSource() const final {
+        return true;
+    }
+
+    Value serialize(bool explain = false) const final;
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
+
+private:
+    DocumentSourceSampledProfile(const boost::intrusive_ptr<ExpressionContext>& pExpCtx)
+        : DocumentSource(pExpCtx) {}
+
+    bool _initialized = false;
+    std::vector<BSONObj> _docs;
+    size_t _nextDoc = 0;
+};
 }  // namespace mongo
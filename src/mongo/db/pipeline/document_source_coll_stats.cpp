@@ -59,6 +59,20 @@ intrusive_ptr<DocumentSource> DocumentSourceCollStats::createFromBson(
                     str::stream() << "latencyStats argument must be an object, but found: " << elem,
                     elem.type() == BSONType::Object);
             collStats->_latencySpecified = true;
+            collStats->_queryShapesSpecified = elem.embeddedObject()["queryShapes"].trueValue();
+        } else if (fieldName == "storageIOStats") {
+            uassert(40221,
+                    str::stream() << "storageIOStats argument must be an empty object, but found: "
+                                  << elem,
+                    elem.type() == BSONType::Object && elem.embeddedObject().isEmpty());
+            collStats->_storageIOSpecified = true;
+        } else if (fieldName == "writeConflictStats") {
+            uassert(40396,
+                    str::stream()
+                        << "writeConflictStats argument must be an empty object, but found: "
+                        << elem,
+                    elem.type() == BSONType::Object && elem.embeddedObject().isEmpty());
+            collStats->_writeConflictsSpecified = true;
         } else {
             uasserted(40168, str::stream() << "unrecognized option to $collStats: " << fieldName);
         }
@@ -78,7 +92,13 @@ boost::optional<Document> DocumentSourceCollStats::getNext() {
 
     builder.appendDate("localTime", jsTime());
     if (_latencySpecified) {
-        _mongod->appendLatencyStats(pExpCtx->ns, &builder);
+        _mongod->appendLatencyStats(pExpCtx->ns, _queryShapesSpecified, &builder);
+    }
+    if (_storageIOSpecified) {
+        _mongod->appendStorageIOStats(pExpCtx->ns, &builder);
+    }
+    if (_writeConflictsSpecified) {
+        _mongod->appendWriteConflictStats(pExpCtx->ns, &builder);
     }
 
     return Document(builder.obj());
@@ -89,10 +109,18 @@ bool DocumentSourceCollStats::isValidInitialSource() const {
 }
 
 Value DocumentSourceCollStats::serialize(bool explain) const {
+    MutableDocument spec;
     if (_latencySpecified) {
-        return Value(DOC(getSourceName() << DOC("latencyStats" << Document())));
+        spec["latencyStats"] =
+            Value(_queryShapesSpecified ? DOC("queryShapes" << true) : Document());
+    }
+    if (_storageIOSpecified) {
+        spec["storageIOStats"] = Value(Document());
+    }
+    if (_writeConflictsSpecified) {
+        spec["writeConflictStats"] = Value(Document());
     }
-    return Value(DOC(getSourceName() << Document()));
+    return Value(DOC(getSourceName() << spec.freeze()));
 }
 
 }  // namespace mongo
@@ -100,6 +100,8 @@ void DocumentSourceCursor::loadBatch() {
                 _currentBatch.push_back(Document());
             } else if (_dependencies) {
                 _currentBatch.push_back(_dependencies->extractFields(obj));
+            } else if (_shouldKeepOriginalBson) {
+                _currentBatch.push_back(Document::fromBsonKeepingOriginal(obj.getOwned()));
             } else {
                 _currentBatch.push_back(Document::fromBsonWithMetaData(obj));
             }
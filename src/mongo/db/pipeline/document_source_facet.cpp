@@ -41,23 +41,30 @@
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/pipeline/tee_buffer.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
 using boost::intrusive_ptr;
 using std::vector;
 
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceFacetParallelExecution, bool, false);
+
 DocumentSourceFacet::DocumentSourceFacet(StringMap<intrusive_ptr<Pipeline>> facetPipelines,
                                          const intrusive_ptr<ExpressionContext>& expCtx)
     : DocumentSourceNeedsMongod(expCtx), _facetPipelines(std::move(facetPipelines)) {
 
     // Build the tee stage, and the consumers of the tee.
     _teeBuffer = TeeBuffer::create();
+    size_t consumerId = 0;
     for (auto&& facet : _facetPipelines) {
         auto pipeline = facet.second;
-        pipeline->addInitialSource(DocumentSourceTeeConsumer::create(pExpCtx, _teeBuffer));
+        pipeline->addInitialSource(
+            DocumentSourceTeeConsumer::create(pExpCtx, _teeBuffer, consumerId++));
     }
 }
 
@@ -81,8 +88,17 @@ boost::optional<Document> DocumentSourceFacet::getNext() {
     }
     _done = true;  // We will only ever produce one result.
 
-    // Build the results by executing each pipeline serially, one at a time.
     MutableDocument results;
+    if (canRunInParallel()) {
+        auto facetResults = runInParallel();
+        size_t facetIndex = 0;
+        for (auto&& facet : _facetPipelines) {
+            results[facet.first] = Value(std::move(facetResults[facetIndex++]));
+        }
+        return results.freeze();
+    }
+
+    // Build the results by executing each pipeline serially, one at a time.
     for (auto&& facet : _facetPipelines) {
         auto facetName = facet.first;
         auto facetPipeline = facet.second;
@@ -98,6 +114,76 @@ boost::optional<Document> DocumentSourceFacet::getNext() {
     return results.freeze();
 }
 
+bool DocumentSourceFacet::canRunInParallel() const {
+    if (!internalDocumentSourceFacetParallelExecution.load() || _facetPipelines.size() < 2) {
+        return false;
+    }
+
+    // Stages which talk to storage, like $lookup, must stay on the thread which owns the
+    // OperationContext.
+    for (auto&& facet : _facetPipelines) {
+        for (auto&& stage : facet.second->getSources()) {
+            if (dynamic_cast<DocumentSourceNeedsMongod*>(stage.get())) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+vector<vector<Value>> DocumentSourceFacet::runInParallel() {
+    const size_t numFacets = _facetPipelines.size();
+    _teeBuffer->startStreaming(numFacets);
+
+    vector<vector<Value>> facetResults(numFacets);
+    vector<Status> facetStatuses(numFacets, Status::OK());
+
+    // Runs on the worker thread for facet 'facetIndex'. Only that thread touches the sub-pipeline,
+    // its results and its status until it has been joined.
+    auto runFacet = [&](size_t facetIndex, Pipeline* facetPipeline) {
+        try {
+            while (auto next = facetPipeline->getSources().back()->getNext()) {
+                facetResults[facetIndex].emplace_back(std::move(*next));
+            }
+        } catch (const DBException& ex) {
+            facetStatuses[facetIndex] = ex.toStatus();
+        }
+
+        // Whether or not the sub-pipeline read all of its input, the producer shouldn't wait for
+        // it any longer.
+        _teeBuffer->releaseConsumer(facetIndex);
+    };
+
+    vector<stdx::thread> workers;
+    ON_BLOCK_EXIT([&] {
+        if (workers.empty()) {
+            return;
+        }
+        // We are unwinding before all input was produced, so make sure the workers finish.
+        _teeBuffer->abortStreaming(
+            Status(ErrorCodes::InternalError, "$facet stopped producing input"));
+        for (auto&& worker : workers) {
+            worker.join();
+        }
+    });
+    size_t facetIndex = 0;
+    for (auto&& facet : _facetPipelines) {
+        workers.emplace_back(runFacet, facetIndex++, facet.second.get());
+    }
+
+    _teeBuffer->produce();
+
+    for (auto&& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    for (auto&& status : facetStatuses) {
+        uassertStatusOK(status);
+    }
+    return facetResults;
+}
+
 Value DocumentSourceFacet::serialize(bool explain) const {
     MutableDocument serialized;
     for (auto&& facet : _facetPipelines) {
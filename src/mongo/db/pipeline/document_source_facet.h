@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <boost/intrusive_ptr.hpp>
 #include <boost/optional.hpp>
 #include <memory>
@@ -45,6 +46,10 @@ struct ExpressionContext;
 class NamespaceString;
 class Pipeline;
 
+// If true, a $facet with more than one sub-pipeline runs each of them on its own thread, fed by a
+// streaming TeeBuffer, as long as none of them need to access storage.
+extern std::atomic<bool> internalDocumentSourceFacetParallelExecution;  // NOLINT
+
 /**
  * A $facet stage contains multiple sub-pipelines. Each input to the $facet stage will feed into
  * each of the sub-pipelines. The $facet stage is blocking, and outputs only one document,
@@ -100,6 +105,19 @@ private:
 
     Value serialize(bool explain = false) const final;
 
+    /**
+     * Returns true if the sub-pipelines can be run on worker threads, which is not the case if any
+     * of their stages use the operation's storage snapshot.
+     */
+    bool canRunInParallel() const;
+
+    /**
+     * Runs each sub-pipeline to completion on its own thread, while this thread streams the input
+     * to them through '_teeBuffer'. Returns the results of each sub-pipeline in the order of
+     * '_facetPipelines'.
+     */
+    std::vector<std::vector<Value>> runInParallel();
+
     boost::intrusive_ptr<TeeBuffer> _teeBuffer;
     StringMap<boost::intrusive_ptr<Pipeline>> _facetPipelines;
 
@@ -39,6 +39,7 @@
 #include "mongo/db/pipeline/aggregation_context_fixture.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -235,6 +236,39 @@ TEST_F(DocumentSourceFacetTest, MultipleFacetsShouldSeeTheSameDocuments) {
     ASSERT_FALSE(facetStage->getNext());
 }
 
+TEST_F(DocumentSourceFacetTest, ParallelFacetsShouldSeeTheSameDocuments) {
+    auto ctx = getExpCtx();
+    const bool oldParallelExecution = internalDocumentSourceFacetParallelExecution.load();
+    internalDocumentSourceFacetParallelExecution.store(true);
+    ON_BLOCK_EXIT(
+        [&] { internalDocumentSourceFacetParallelExecution.store(oldParallelExecution); });
+
+    auto passthrough = DocumentSourcePassthrough::create(ctx);
+    auto allPipeline = uassertStatusOK(Pipeline::create({passthrough}, ctx));
+
+    auto limit = DocumentSourceLimit::create(ctx, 1);
+    auto limitPipeline = uassertStatusOK(Pipeline::create({limit}, ctx));
+
+    auto facetStage =
+        DocumentSourceFacet::create({{"all", allPipeline}, {"limited", limitPipeline}}, ctx);
+
+    std::deque<Document> inputs;
+    for (int i = 0; i < 1000; ++i) {
+        inputs.push_back(Document{{"_id", i}});
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+    facetStage->setSource(mock.get());
+
+    auto output = facetStage->getNext();
+    ASSERT_TRUE(output);
+    ASSERT_EQ((*output).size(), 2UL);
+    ASSERT_EQ((*output)["all"], Value(std::vector<Value>(inputs.begin(), inputs.end())));
+    ASSERT_EQ((*output)["limited"], Value(std::vector<Value>{Value(inputs.front())}));
+
+    // Should be exhausted now.
+    ASSERT_FALSE(facetStage->getNext());
+}
+
 TEST_F(DocumentSourceFacetTest, ShouldBeAbleToEvaluateMultipleStagesWithinOneSubPipeline) {
     auto ctx = getExpCtx();
 
@@ -37,6 +37,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/stdx/memory.h"
 
 namespace mongo {
@@ -46,6 +47,12 @@ using std::unique_ptr;
 
 namespace dps = ::mongo::dotted_path_support;
 
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGraphLookupMaxMemoryBytes,
+                              long long,
+                              100 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGraphLookupMaxQueryValues, int, 10000);
+
 REGISTER_DOCUMENT_SOURCE(graphLookup, DocumentSourceGraphLookUp::createFromBson);
 
 const char* DocumentSourceGraphLookUp::getSourceName() const {
@@ -150,7 +157,7 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
 
         // Check whether each key in the frontier exists in the cache or needs to be queried.
         BSONObjSet cached;
-        auto query = constructQuery(&cached);
+        std::vector<BSONObj> queries = constructQueries(&cached);
 
         std::unordered_set<Value, Value::Hash> queried;
         _frontier.swap(queried);
@@ -165,10 +172,10 @@ void DocumentSourceGraphLookUp::doBreadthFirstSearch() {
             checkMemoryUsage();
         }
 
-        if (query) {
+        for (auto&& query : queries) {
             // Query for all keys that were in the frontier and not in the cache, populating
             // '_frontier' for the next iteration of search.
-            unique_ptr<DBClientCursor> cursor = _mongod->directClient()->query(_from.ns(), *query);
+            unique_ptr<DBClientCursor> cursor = _mongod->directClient()->query(_from.ns(), query);
 
             // Iterate the cursor.
             while (cursor->more()) {
@@ -267,7 +274,7 @@ void DocumentSourceGraphLookUp::addToCache(const BSONObj& result,
     }
 }
 
-boost::optional<BSONObj> DocumentSourceGraphLookUp::constructQuery(BSONObjSet* cached) {
+std::vector<BSONObj> DocumentSourceGraphLookUp::constructQueries(BSONObjSet* cached) {
     // Add any cached values to 'cached' and remove them from '_frontier'.
     for (auto it = _frontier.begin(); it != _frontier.end();) {
         if (auto entry = _cache[*it]) {
@@ -286,19 +293,32 @@ boost::optional<BSONObj> DocumentSourceGraphLookUp::constructQuery(BSONObjSet* c
         }
     }
 
-    // Create a query of the form {_connectToField: {$in: [...]}}.
-    BSONObjBuilder query;
-    BSONObjBuilder subobj(query.subobjStart(_connectToField.fullPath()));
-    BSONArrayBuilder in(subobj.subarrayStart("$in"));
+    // Create queries of the form {_connectToField: {$in: [...]}}. A frontier on a wide level of
+    // the graph is split into several, so that no single query grows too large to plan, or to
+    // build at all.
+    const size_t maxValues =
+        static_cast<size_t>(std::max(1, internalDocumentSourceGraphLookupMaxQueryValues.load()));
+    const int maxInBytes = BSONObjMaxUserSize / 2;
+
+    std::vector<BSONObj> queries;
+    auto it = _frontier.begin();
+    while (it != _frontier.end()) {
+        BSONObjBuilder query;
+        BSONObjBuilder subobj(query.subobjStart(_connectToField.fullPath()));
+        BSONArrayBuilder in(subobj.subarrayStart("$in"));
+
+        size_t numValues = 0;
+        while (it != _frontier.end() && numValues < maxValues && in.len() < maxInBytes) {
+            in << *it;
+            ++numValues;
+            ++it;
+        }
 
-    for (auto&& value : _frontier) {
-        in << value;
+        in.doneFast();
+        subobj.doneFast();
+        queries.push_back(query.obj());
     }
-
-    in.doneFast();
-    subobj.doneFast();
-
-    return _frontier.empty() ? boost::none : boost::optional<BSONObj>(query.obj());
+    return queries;
 }
 
 void DocumentSourceGraphLookUp::performSearch() {
@@ -410,7 +430,9 @@ DocumentSourceGraphLookUp::DocumentSourceGraphLookUp(
       _connectToField(std::move(connectToField)),
       _startWith(std::move(startWith)),
       _depthField(depthField),
-      _maxDepth(maxDepth) {}
+      _maxDepth(maxDepth),
+      _maxMemoryUsageBytes(static_cast<size_t>(
+          std::max(0LL, internalDocumentSourceGraphLookupMaxMemoryBytes.load()))) {}
 
 intrusive_ptr<DocumentSource> DocumentSourceGraphLookUp::createFromBson(
     BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& expCtx) {
@@ -28,6 +28,9 @@
 
 #include "mongo/platform/basic.h"
 
+#include <deque>
+#include <unordered_map>
+
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/accumulator.h"
 #include "mongo/db/pipeline/document.h"
@@ -35,6 +38,12 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -45,6 +54,8 @@ using std::vector;
 
 REGISTER_DOCUMENT_SOURCE(group, DocumentSourceGroup::createFromBson);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGroupParallelThreads, int, 0);
+
 const char* DocumentSourceGroup::getSourceName() const {
     return "$group";
 }
@@ -61,7 +72,7 @@ boost::optional<Document> DocumentSourceGroup::getNext() {
 
     if (_spilled) {
         return getNextSpilled();
-    } else if (_streaming) {
+    } else if (_streaming && !_sortedInputExhausted) {
         return getNextStreaming();
     } else {
         return getNextStandard();
@@ -109,8 +120,16 @@ boost::optional<Document> DocumentSourceGroup::getNextStandard() {
 
     Document out = makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->inShard);
 
-    if (++groupsIterator == groups.end())
-        dispose();
+    if (++groupsIterator == groups.end()) {
+        if (_pendingGroups.empty()) {
+            dispose();
+        } else {
+            // Move on to the next partition of a parallel $group.
+            groups = std::move(_pendingGroups.back());
+            _pendingGroups.pop_back();
+            groupsIterator = groups.begin();
+        }
+    }
 
     return out;
 }
@@ -118,8 +137,9 @@ boost::optional<Document> DocumentSourceGroup::getNextStandard() {
 boost::optional<Document> DocumentSourceGroup::getNextStreaming() {
     // Streaming optimization is active.
     if (!_firstDocOfNextGroup) {
-        dispose();
-        return boost::none;
+        // The sorted input is exhausted, so move on to the groups with unstreamable keys.
+        finishStreaming();
+        return _spilled ? getNextSpilled() : getNextStandard();
     }
 
     Value id;
@@ -135,17 +155,11 @@ boost::optional<Document> DocumentSourceGroup::getNextStreaming() {
         _variables->clearRoot();
         _firstDocOfNextGroup = boost::none;
 
-        // Retrieve the next document.
-        _firstDocOfNextGroup = pSource->getNext();
-        if (!_firstDocOfNextGroup) {
+        // Retrieve the next document and compute its id. If it does not match _currentId, we will
+        // exit the loop, leaving _firstDocOfNextGroup set for the next time getNext() is called.
+        if (!loadNextStreamableDocument(&id)) {
             break;
         }
-
-        _variables->setRoot(*_firstDocOfNextGroup);
-
-        // Compute the id. If it does not match _currentId, we will exit the loop, leaving
-        // _firstDocOfNextGroup set for the next time getNext() is called.
-        id = computeId(_variables.get());
     } while (_currentId == id);
 
     Document out = makeDocument(_currentId, _currentAccumulators, pExpCtx->inShard);
@@ -157,6 +171,7 @@ boost::optional<Document> DocumentSourceGroup::getNextStreaming() {
 void DocumentSourceGroup::dispose() {
     // Free our resources.
     GroupsMap().swap(groups);
+    vector<GroupsMap>().swap(_pendingGroups);
     _sorterIterator.reset();
 
     // Make us look done.
@@ -378,27 +393,30 @@ bool containsOnlyFieldPathsAndConstants(ExpressionObject* expressionObj) {
     return true;
 }
 
-void getFieldPathMap(ExpressionObject* expressionObj,
-                     std::string prefix,
-                     StringMap<std::string>* fields) {
-    // Given an expression with only constant and FieldPath leaf nodes, such as {x: {y: "$a.b"}},
-    // attempt to compute a map from each FieldPath leaf to the path of that leaf. In the example,
-    // this method would return: {"a.b" : "x.y"}.
-
-    for (auto&& it : expressionObj->getChildExpressions()) {
-        intrusive_ptr<Expression> childExp = it.second;
-        ExpressionObject* expObj = dynamic_cast<ExpressionObject*>(childExp.get());
-        ExpressionFieldPath* expPath = dynamic_cast<ExpressionFieldPath*>(childExp.get());
-
-        std::string newPrefix = prefix.empty() ? it.first : prefix + "." + it.first;
+/**
+ * The state of one hash partition of a parallel $group. The feeding thread hands the worker owning
+ * the partition batches of (group key, accumulator arguments) pairs.
+ */
+struct GroupPartition {
+    using Batch = vector<pair<Value, vector<Value>>>;
+
+    stdx::mutex mutex;
+    stdx::condition_variable queueChanged;
+
+    // Guarded by 'mutex'.
+    std::deque<Batch> batches;
+    bool inputDone = false;
+    Status status = Status::OK();
+
+    // Owned by the worker until it has been joined.
+    GroupsMap groups;
+    vector<shared_ptr<Sorter<Value, Value>::Iterator>> sortedFiles;
+};
 
-        if (expObj) {
-            getFieldPathMap(expObj, newPrefix, fields);
-        } else if (expPath) {
-            (*fields)[expPath->getFieldPath().tail().fullPath()] = newPrefix;
-        }
-    }
-}
+// Number of documents handed to a partition at a time, and the number of batches that may be
+// queued for a partition before the feeding thread waits for its worker.
+const size_t kParallelGroupBatchSize = 256;
+const size_t kParallelGroupMaxQueuedBatches = 8;
 
 void getFieldPathListForSpilled(ExpressionObject* expressionObj,
                                 std::string prefix,
@@ -421,6 +439,136 @@ void getFieldPathListForSpilled(ExpressionObject* expressionObj,
 }
 }  // namespace
 
+bool DocumentSourceGroup::onlyNeedsOneDocumentPerGroup(std::string* idPath,
+                                                       bool* usesLast) const {
+    if (_doingMerge || !_idFieldNames.empty() || _idExpressions.size() != 1) {
+        return false;
+    }
+
+    auto fieldPathExpr = dynamic_cast<ExpressionFieldPath*>(_idExpressions[0].get());
+    if (!fieldPathExpr) {
+        return false;
+    }
+    const FieldPath& fieldPath = fieldPathExpr->getFieldPath();
+    if (fieldPath.getPathLength() < 2 || fieldPath.getFieldName(0) != "CURRENT") {
+        // The _id is either $$CURRENT itself or a path into some other variable.
+        return false;
+    }
+
+    bool sawFirst = false;
+    bool sawLast = false;
+    for (auto&& factory : vpAccumulatorFactory) {
+        const StringData opName = factory()->getOpName();
+        if (opName == "$first") {
+            sawFirst = true;
+        } else if (opName == "$last") {
+            sawLast = true;
+        } else {
+            return false;
+        }
+    }
+    if (sawFirst && sawLast) {
+        return false;
+    }
+
+    *idPath = fieldPath.tail().fullPath();
+    *usesLast = sawLast;
+    return true;
+}
+
+bool DocumentSourceGroup::hasStreamableKey(const Document& input) const {
+    for (auto&& path : _inputSortPaths) {
+        // A path which runs through an array yields a missing value.
+        switch (input.getNestedField(path).getType()) {
+            case EOO:
+            case jstNULL:
+            case Undefined:
+            case Array:
+            case Object:
+                return false;
+            case String:
+            case Symbol:
+                if (pExpCtx->collator) {
+                    return false;
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return true;
+}
+
+bool DocumentSourceGroup::loadNextStreamableDocument(Value* id) {
+    const size_t numAccumulators = vpAccumulatorFactory.size();
+    while ((_firstDocOfNextGroup = pSource->getNext())) {
+        _variables->setRoot(*_firstDocOfNextGroup);
+        *id = computeId(_variables.get());
+        if (hasStreamableKey(*_firstDocOfNextGroup)) {
+            return true;
+        }
+
+        // Documents with this key may show up anywhere in the input, so accumulate them in the
+        // side table, the same way an unsorted $group does.
+        if (_unstreamableMemoryUsageBytes > _maxMemoryUsageBytes) {
+            uassert(16945,
+                    "Exceeded memory limit for $group, but didn't allow external sort."
+                    " Pass allowDiskUse:true to opt in.",
+                    _extSortAllowed);
+            _unstreamableSpills.push_back(spill(&groups));
+            _unstreamableMemoryUsageBytes = 0;
+        }
+
+        const size_t oldSize = groups.size();
+        Accumulators& group = groups[*id];
+        if (groups.size() != oldSize) {
+            _unstreamableMemoryUsageBytes += id->getApproximateSize();
+            group.reserve(numAccumulators);
+            for (size_t i = 0; i < numAccumulators; i++) {
+                group.push_back(vpAccumulatorFactory[i]());
+            }
+        } else {
+            for (size_t i = 0; i < numAccumulators; i++) {
+                _unstreamableMemoryUsageBytes -= group[i]->memUsageForSorter();
+            }
+        }
+
+        for (size_t i = 0; i < numAccumulators; i++) {
+            group[i]->process(vpExpression[i]->evaluate(_variables.get()), _doingMerge);
+            _unstreamableMemoryUsageBytes += group[i]->memUsageForSorter();
+        }
+
+        _variables->clearRoot();
+    }
+    return false;
+}
+
+void DocumentSourceGroup::finishStreaming() {
+    _sortedInputExhausted = true;
+
+    if (!_unstreamableSpills.empty()) {
+        _spilled = true;
+        if (!groups.empty()) {
+            _unstreamableSpills.push_back(spill(&groups));
+        }
+        GroupsMap().swap(groups);
+
+        _sorterIterator.reset(Sorter<Value, Value>::Iterator::merge(
+            _unstreamableSpills, SortOptions(), SorterComparator()));
+        _unstreamableSpills.clear();
+
+        verify(_sorterIterator->more());  // we put data in, we should get something out.
+        _firstPartOfNextGroup = _sorterIterator->next();
+        return;
+    }
+
+    if (groups.empty()) {
+        dispose();
+        return;
+    }
+    groupsIterator = groups.begin();
+}
+
 void DocumentSourceGroup::initialize() {
     _initialized = true;
     const size_t numAccumulators = vpAccumulatorFactory.size();
@@ -430,6 +578,9 @@ void DocumentSourceGroup::initialize() {
         // We can convert to streaming.
         _streaming = true;
         _inputSort = *inputSort;
+        for (auto&& sortField : _inputSort) {
+            _inputSortPaths.emplace_back(sortField.fieldName());
+        }
 
         // Set up accumulators.
         _currentAccumulators.reserve(numAccumulators);
@@ -437,17 +588,9 @@ void DocumentSourceGroup::initialize() {
             _currentAccumulators.push_back(vpAccumulatorFactory[i]());
         }
 
-        // We only need to load the first document.
-        _firstDocOfNextGroup = pSource->getNext();
-
-        if (!_firstDocOfNextGroup) {
-            return;
-        }
-
-        _variables->setRoot(*_firstDocOfNextGroup);
-
-        // Compute the _id value.
-        _currentId = computeId(_variables.get());
+        // We only need to load the first document with a streamable key, and compute its _id
+        // value.
+        loadNextStreamableDocument(&_currentId);
         return;
     }
 
@@ -455,68 +598,73 @@ void DocumentSourceGroup::initialize() {
 
     // pushed to on spill()
     vector<shared_ptr<Sorter<Value, Value>::Iterator>> sortedFiles;
-    int memoryUsageBytes = 0;
-
-    // This loop consumes all input from pSource and buckets it based on pIdExpression.
-    while (boost::optional<Document> input = pSource->getNext()) {
-        if (memoryUsageBytes > _maxMemoryUsageBytes) {
-            uassert(16945,
-                    "Exceeded memory limit for $group, but didn't allow external sort."
-                    " Pass allowDiskUse:true to opt in.",
-                    _extSortAllowed);
-            sortedFiles.push_back(spill());
-            memoryUsageBytes = 0;
-        }
+    const int numPartitions = internalDocumentSourceGroupParallelThreads.load();
+    if (numPartitions > 1) {
+        initializeParallel(numPartitions, &sortedFiles);
+    } else {
+        int memoryUsageBytes = 0;
+
+        // This loop consumes all input from pSource and buckets it based on pIdExpression.
+        while (boost::optional<Document> input = pSource->getNext()) {
+            if (memoryUsageBytes > _maxMemoryUsageBytes) {
+                uassert(16945,
+                        "Exceeded memory limit for $group, but didn't allow external sort."
+                        " Pass allowDiskUse:true to opt in.",
+                        _extSortAllowed);
+                sortedFiles.push_back(spill(&groups));
+                memoryUsageBytes = 0;
+            }
 
-        _variables->setRoot(*input);
+            _variables->setRoot(*input);
 
-        /* get the _id value */
-        Value id = computeId(_variables.get());
+            /* get the _id value */
+            Value id = computeId(_variables.get());
 
-        /*
-          Look for the _id value in the map; if it's not there, add a
-          new entry with a blank accumulator.
-        */
-        const size_t oldSize = groups.size();
-        vector<intrusive_ptr<Accumulator>>& group = groups[id];
-        const bool inserted = groups.size() != oldSize;
+            /*
+              Look for the _id value in the map; if it's not there, add a
+              new entry with a blank accumulator.
+            */
+            const size_t oldSize = groups.size();
+            vector<intrusive_ptr<Accumulator>>& group = groups[id];
+            const bool inserted = groups.size() != oldSize;
 
-        if (inserted) {
-            memoryUsageBytes += id.getApproximateSize();
+            if (inserted) {
+                memoryUsageBytes += id.getApproximateSize();
 
-            // Add the accumulators
-            group.reserve(numAccumulators);
-            for (size_t i = 0; i < numAccumulators; i++) {
-                group.push_back(vpAccumulatorFactory[i]());
+                // Add the accumulators
+                group.reserve(numAccumulators);
+                for (size_t i = 0; i < numAccumulators; i++) {
+                    group.push_back(vpAccumulatorFactory[i]());
+                }
+            } else {
+                for (size_t i = 0; i < numAccumulators; i++) {
+                    // subtract old mem usage. New usage added back after processing.
+                    memoryUsageBytes -= group[i]->memUsageForSorter();
+                }
             }
-        } else {
+
+            /* tickle all the accumulators for the group we found */
+            dassert(numAccumulators == group.size());
             for (size_t i = 0; i < numAccumulators; i++) {
-                // subtract old mem usage. New usage added back after processing.
-                memoryUsageBytes -= group[i]->memUsageForSorter();
+                group[i]->process(vpExpression[i]->evaluate(_variables.get()), _doingMerge);
+                memoryUsageBytes += group[i]->memUsageForSorter();
             }
-        }
 
-        /* tickle all the accumulators for the group we found */
-        dassert(numAccumulators == group.size());
-        for (size_t i = 0; i < numAccumulators; i++) {
-            group[i]->process(vpExpression[i]->evaluate(_variables.get()), _doingMerge);
-            memoryUsageBytes += group[i]->memUsageForSorter();
-        }
-
-        // We are done with the ROOT document so release it.
-        _variables->clearRoot();
-
-        if (kDebugBuild && !storageGlobalParams.readOnly) {
-            // In debug mode, spill every time we have a duplicate id to stress merge logic.
-            if (!inserted  // is a dup
-                &&
-                !pExpCtx->inRouter  // can't spill to disk in router
-                &&
-                !_extSortAllowed  // don't change behavior when testing external sort
-                &&
-                sortedFiles.size() < 20  // don't open too many FDs
-                ) {
-                sortedFiles.push_back(spill());
+            // We are done with the ROOT document so release it.
+            _variables->clearRoot();
+
+            if (kDebugBuild && !storageGlobalParams.readOnly) {
+                // In debug mode, spill every time we have a duplicate id to stress merge logic.
+                if (!inserted  // is a dup
+                    &&
+                    !pExpCtx->inRouter  // can't spill to disk in router
+                    &&
+                    !_extSortAllowed  // don't change behavior when testing external sort
+                    &&
+                    sortedFiles.size() < 20  // don't open too many FDs
+                    ) {
+                    sortedFiles.push_back(spill(&groups));
+                }
             }
         }
     }
@@ -525,7 +673,7 @@ void DocumentSourceGroup::initialize() {
     if (!sortedFiles.empty()) {
         _spilled = true;
         if (!groups.empty()) {
-            sortedFiles.push_back(spill());
+            sortedFiles.push_back(spill(&groups));
         }
 
         // We won't be using groups again so free its memory.
@@ -548,10 +696,12 @@ void DocumentSourceGroup::initialize() {
     }
 }
 
-shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
+shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill(GroupsMap* groupsToSpill) {
     vector<const GroupsMap::value_type*> ptrs;  // using pointers to speed sorting
-    ptrs.reserve(groups.size());
-    for (GroupsMap::const_iterator it = groups.begin(), end = groups.end(); it != end; ++it) {
+    ptrs.reserve(groupsToSpill->size());
+    for (GroupsMap::const_iterator it = groupsToSpill->begin(), end = groupsToSpill->end();
+         it != end;
+         ++it) {
         ptrs.push_back(&*it);
     }
 
@@ -583,18 +733,205 @@ shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
             break;
     }
 
-    groups.clear();
+    groupsToSpill->clear();
 
     return shared_ptr<Sorter<Value, Value>::Iterator>(writer.done());
 }
 
-boost::optional<BSONObj> DocumentSourceGroup::findRelevantInputSort() const {
-    if (true) {
-        // Until streaming $group correctly handles nullish values, the streaming behavior is
-        // disabled. See SERVER-23318.
-        return boost::none;
+void DocumentSourceGroup::initializeParallel(
+    size_t numPartitions, vector<shared_ptr<Sorter<Value, Value>::Iterator>>* sortedFiles) {
+    const size_t numAccumulators = vpAccumulatorFactory.size();
+    const int partitionMaxMemoryUsageBytes = _maxMemoryUsageBytes / numPartitions;
+
+    vector<std::unique_ptr<GroupPartition>> partitions;
+    for (size_t i = 0; i < numPartitions; i++) {
+        partitions.push_back(stdx::make_unique<GroupPartition>());
+    }
+
+    // Runs on the worker thread owning 'partition'. Apart from the queue, which is guarded by the
+    // partition's mutex, only the worker touches the partition's groups and spill files until it
+    // has been joined.
+    auto accumulatePartition = [&](GroupPartition* partition) {
+        int memoryUsageBytes = 0;
+        stdx::unique_lock<stdx::mutex> lk(partition->mutex);
+        while (true) {
+            partition->queueChanged.wait(
+                lk, [&] { return !partition->batches.empty() || partition->inputDone; });
+            if (partition->batches.empty()) {
+                return;
+            }
+
+            GroupPartition::Batch batch = std::move(partition->batches.front());
+            partition->batches.pop_front();
+            partition->queueChanged.notify_all();
+
+            if (!partition->status.isOK()) {
+                // Keep draining the queue so that the feeding thread never waits on us.
+                continue;
+            }
+
+            lk.unlock();
+            try {
+                // The memory limit is only checked once per batch, so a partition may exceed it
+                // by the size of one batch.
+                if (memoryUsageBytes > partitionMaxMemoryUsageBytes) {
+                    uassert(16945,
+                            "Exceeded memory limit for $group, but didn't allow external sort."
+                            " Pass allowDiskUse:true to opt in.",
+                            _extSortAllowed);
+                    partition->sortedFiles.push_back(spill(&partition->groups));
+                    memoryUsageBytes = 0;
+                }
+
+                // Gather the entries of the batch by group, keeping their order within each group,
+                // so that each accumulator processes all of its group's arguments at once.
+                vector<pair<Accumulators*, vector<size_t>>> batchGroups;
+                std::unordered_map<Accumulators*, size_t> batchGroupIndexes;
+                for (size_t entryIndex = 0; entryIndex < batch.size(); entryIndex++) {
+                    const Value& id = batch[entryIndex].first;
+                    const size_t oldSize = partition->groups.size();
+                    Accumulators& group = partition->groups[id];
+                    const bool inserted = partition->groups.size() != oldSize;
+
+                    if (inserted) {
+                        memoryUsageBytes += id.getApproximateSize();
+
+                        group.reserve(numAccumulators);
+                        for (size_t i = 0; i < numAccumulators; i++) {
+                            group.push_back(vpAccumulatorFactory[i]());
+                            memoryUsageBytes += group[i]->memUsageForSorter();
+                        }
+                    }
+
+                    auto groupIndex = batchGroupIndexes.emplace(&group, batchGroups.size());
+                    if (groupIndex.second) {
+                        batchGroups.emplace_back(&group, vector<size_t>());
+                    }
+                    batchGroups[groupIndex.first->second].second.push_back(entryIndex);
+                }
+
+                vector<Value> arguments;
+                for (auto&& batchGroup : batchGroups) {
+                    Accumulators& group = *batchGroup.first;
+                    for (size_t i = 0; i < numAccumulators; i++) {
+                        arguments.clear();
+                        for (size_t entryIndex : batchGroup.second) {
+                            arguments.push_back(std::move(batch[entryIndex].second[i]));
+                        }
+
+                        memoryUsageBytes -= group[i]->memUsageForSorter();
+                        group[i]->processBatch(arguments.data(), arguments.size(), _doingMerge);
+                        memoryUsageBytes += group[i]->memUsageForSorter();
+                    }
+                }
+            } catch (const DBException& ex) {
+                lk.lock();
+                partition->status = ex.toStatus();
+                continue;
+            }
+            lk.lock();
+        }
+    };
+
+    vector<stdx::thread> workers;
+    ON_BLOCK_EXIT([&] {
+        for (auto&& partition : partitions) {
+            stdx::lock_guard<stdx::mutex> lk(partition->mutex);
+            partition->inputDone = true;
+            partition->queueChanged.notify_all();
+        }
+        for (auto&& worker : workers) {
+            worker.join();
+        }
+    });
+    for (auto&& partition : partitions) {
+        workers.emplace_back(accumulatePartition, partition.get());
+    }
+
+    vector<GroupPartition::Batch> pendingBatches(numPartitions);
+    auto flushBatch = [&](size_t partitionIndex) {
+        GroupPartition* partition = partitions[partitionIndex].get();
+        stdx::unique_lock<stdx::mutex> lk(partition->mutex);
+        partition->queueChanged.wait(
+            lk, [&] { return partition->batches.size() < kParallelGroupMaxQueuedBatches; });
+        uassertStatusOK(partition->status);
+        partition->batches.push_back(std::move(pendingBatches[partitionIndex]));
+        partition->queueChanged.notify_all();
+        pendingBatches[partitionIndex] = GroupPartition::Batch();
+    };
+
+    // The group key and the accumulator arguments are evaluated here, as the key is needed to
+    // pick a partition and the expressions share '_variables'. The workers only do the hash table
+    // work, which is what dominates a $group with many distinct keys.
+    const Value::Hash hasher;
+    while (boost::optional<Document> input = pSource->getNext()) {
+        _variables->setRoot(*input);
+
+        Value id = computeId(_variables.get());
+        vector<Value> accumulatorArgs;
+        accumulatorArgs.reserve(numAccumulators);
+        for (size_t i = 0; i < numAccumulators; i++) {
+            accumulatorArgs.push_back(vpExpression[i]->evaluate(_variables.get()));
+        }
+
+        // We are done with the ROOT document so release it.
+        _variables->clearRoot();
+
+        const size_t partitionIndex = hasher(id) % numPartitions;
+        pendingBatches[partitionIndex].emplace_back(std::move(id), std::move(accumulatorArgs));
+        if (pendingBatches[partitionIndex].size() >= kParallelGroupBatchSize) {
+            flushBatch(partitionIndex);
+        }
+    }
+
+    for (size_t i = 0; i < numPartitions; i++) {
+        if (!pendingBatches[i].empty()) {
+            flushBatch(i);
+        }
+    }
+
+    // Wait for the workers to drain their queues.
+    for (auto&& partition : partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition->mutex);
+        partition->inputDone = true;
+        partition->queueChanged.notify_all();
+    }
+    for (auto&& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+
+    for (auto&& partition : partitions) {
+        uassertStatusOK(partition->status);
+        sortedFiles->insert(
+            sortedFiles->end(), partition->sortedFiles.begin(), partition->sortedFiles.end());
+    }
+
+    if (!sortedFiles->empty()) {
+        // At least one partition ran out of memory. Every partition spills what it has left, and
+        // the merge of the sorted runs in getNextSpilled() combines the partial accumulator states
+        // for each key, exactly as a merging $group does with the output of the shards.
+        for (auto&& partition : partitions) {
+            if (!partition->groups.empty()) {
+                sortedFiles->push_back(spill(&partition->groups));
+            }
+        }
+        return;
     }
 
+    // No key is in more than one partition, so the partitions can be returned one after another.
+    for (auto&& partition : partitions) {
+        if (!partition->groups.empty()) {
+            _pendingGroups.push_back(std::move(partition->groups));
+        }
+    }
+    if (!_pendingGroups.empty()) {
+        groups = std::move(_pendingGroups.back());
+        _pendingGroups.pop_back();
+    }
+}
+
+boost::optional<BSONObj> DocumentSourceGroup::findRelevantInputSort() const {
     if (!pSource) {
         // Sometimes when performing an explain, or using $group as the merge point, 'pSource' will
         // not be set.
@@ -658,60 +995,16 @@ BSONObjSet DocumentSourceGroup::getOutputSorts() {
         initialize();
     }
 
-    if (!(_streaming || _spilled)) {
+    // A streaming $group outputs the groups with unstreamable keys after all the others, so only
+    // the output of an unsorted $group which has spilled to disk is sorted.
+    if (_streaming || !_spilled) {
         return BSONObjSet();
     }
 
     BSONObjBuilder sortOrder;
 
     if (_idFieldNames.empty()) {
-        if (_spilled) {
-            sortOrder.append("_id", 1);
-        } else {
-            // We have an expression like {_id: "$a"}. Check if this is a FieldPath, and if it is,
-            // get the sort order out of it.
-            if (auto obj = dynamic_cast<ExpressionFieldPath*>(_idExpressions[0].get())) {
-                FieldPath _idSort = obj->getFieldPath();
-
-                sortOrder.append(
-                    "_id",
-                    _inputSort.getIntField(_idSort.getFieldName(_idSort.getPathLength() - 1)));
-            }
-        }
-    } else if (_streaming) {
-        // At this point, we know that _streaming is true, so _id must have only contained
-        // ExpressionObjects, ExpressionConstants or ExpressionFieldPaths. We now process each
-        // '_idExpression'.
-
-        // We populate 'fieldMap' such that each key is a field the input is sorted by, and the
-        // value is where that input field is located within the _id document. For example, if our
-        // _id object is {_id: {x: {y: "$a.b"}}}, 'fieldMap' would be: {'a.b': '_id.x.y'}.
-        StringMap<std::string> fieldMap;
-        for (size_t i = 0; i < _idFieldNames.size(); i++) {
-            intrusive_ptr<Expression> exp = _idExpressions[i];
-            if (auto obj = dynamic_cast<ExpressionObject*>(exp.get())) {
-                // _id is an object containing a nested document, such as: {_id: {x: {y: "$b"}}}.
-                getFieldPathMap(obj, "_id." + _idFieldNames[i], &fieldMap);
-            } else if (auto fieldPath = dynamic_cast<ExpressionFieldPath*>(exp.get())) {
-                FieldPath _idSort = fieldPath->getFieldPath();
-                fieldMap[_idSort.getFieldName(_idSort.getPathLength() - 1)] =
-                    "_id." + _idFieldNames[i];
-            }
-        }
-
-        // Because the order of '_inputSort' is important, we go through each field we are sorted on
-        // and append it to the BSONObjBuilder in order.
-        for (BSONElement sortField : _inputSort) {
-            std::string sortString = sortField.fieldNameStringData().toString();
-
-            auto itr = fieldMap.find(sortString);
-
-            // If our sort order is (a, b, c), we could not have converted to a streaming $group if
-            // our _id was predicated on (a, c) but not 'b'. Verify that this is true.
-            invariant(itr != fieldMap.end());
-
-            sortOrder.append(itr->second, _inputSort.getIntField(sortString));
-        }
+        sortOrder.append("_id", 1);
     } else {
         // We are blocking and have spilled to disk.
         std::vector<std::string> outputSort;
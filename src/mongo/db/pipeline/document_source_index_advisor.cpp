@@ -0,0 +1,247 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <set>
+
+#include "mongo/client/dbclientinterface.h"
+#include "mongo/db/pipeline/document_source.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+REGISTER_DOCUMENT_SOURCE(indexAdvisor, DocumentSourceIndexAdvisor::createFromBson);
+
+namespace {
+
+/**
+ * Returns whether the fields of key pattern 'prefix' are the first fields of key pattern 'key',
+ * in the same order, with the same directions or index types if 'compareValues' is true.
+ */
+bool isKeyPatternPrefix(const BSONObj& prefix, const BSONObj& key, bool compareValues) {
+    BSONObjIterator keyIt(key);
+    for (auto&& prefixElem : prefix) {
+        if (!keyIt.more()) {
+            return false;
+        }
+        BSONElement keyElem = keyIt.next();
+        if (prefixElem.fieldNameStringData() != keyElem.fieldNameStringData()) {
+            return false;
+        }
+        if (compareValues && prefixElem.woCompare(keyElem, false) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns whether the index with spec 'spec' can be dropped without changing what the collection
+ * accepts or keeps: it enforces no uniqueness and expires no documents.
+ */
+bool hasNoSideEffects(const BSONObj& spec) {
+    return !spec["unique"].trueValue() && !spec.hasField("expireAfterSeconds");
+}
+
+/**
+ * Returns whether the index with spec 'spec' holds a key for every document.
+ */
+bool indexesEveryDocument(const BSONObj& spec) {
+    return !spec["sparse"].trueValue() && !spec.hasField("partialFilterExpression");
+}
+}  // namespace
+
+const char* DocumentSourceIndexAdvisor::getSourceName() const {
+    return "$indexAdvisor";
+}
+
+BSONObj DocumentSourceIndexAdvisor::recommendedKeyPattern(const BSONObj& query,
+                                                          const BSONObj& sort) {
+    std::vector<std::string> equalityFields;
+    std::vector<std::string> rangeFields;
+    for (auto&& elem : query) {
+        // Skip $and, $or, $where and such, whose fields aren't top-level ones.
+        if (elem.fieldName()[0] == '$') {
+            continue;
+        }
+
+        bool isEquality = elem.type() != RegEx;
+        bool isConstrained = true;
+        if (elem.type() == Object && elem.Obj().firstElementFieldName()[0] == '$') {
+            isEquality = false;
+            isConstrained = false;
+            for (auto&& op : elem.Obj()) {
+                StringData opName = op.fieldNameStringData();
+                if (opName == "$eq" || opName == "$in") {
+                    isEquality = true;
+                    isConstrained = true;
+                    break;
+                }
+                if (opName == "$gt" || opName == "$gte" || opName == "$lt" || opName == "$lte" ||
+                    opName == "$regex") {
+                    isConstrained = true;
+                }
+            }
+        }
+
+        if (isConstrained) {
+            (isEquality ? equalityFields : rangeFields).push_back(elem.fieldName());
+        }
+    }
+
+    BSONObjBuilder keyPattern;
+    std::set<std::string> fieldsInKeyPattern;
+    for (const auto& field : equalityFields) {
+        if (fieldsInKeyPattern.insert(field).second) {
+            keyPattern.append(field, 1);
+        }
+    }
+    for (auto&& elem : sort) {
+        // A {$meta: "textScore"} sort isn't on a field.
+        if (elem.isNumber() && fieldsInKeyPattern.insert(elem.fieldName()).second) {
+            keyPattern.append(elem.fieldName(), elem.number() < 0 ? -1 : 1);
+        }
+    }
+    for (const auto& field : rangeFields) {
+        if (fieldsInKeyPattern.insert(field).second) {
+            keyPattern.append(field, 1);
+        }
+    }
+    return keyPattern.obj();
+}
+
+void DocumentSourceIndexAdvisor::computeRecommendations() {
+    const NamespaceString& nss = pExpCtx->ns;
+    CollectionIndexUsageMap usageStats = _mongod->getIndexStats(pExpCtx->opCtx, nss);
+    std::list<BSONObj> indexSpecs = _mongod->directClient()->getIndexSpecs(nss.ns());
+
+    for (const auto& spec : indexSpecs) {
+        const std::string indexName = spec["name"].str();
+        const BSONObj keyPattern = spec["key"].Obj();
+        auto usage = usageStats.find(indexName);
+        if (indexName == "_id_" || usage == usageStats.end() || !hasNoSideEffects(spec)) {
+            continue;
+        }
+
+        if (usage->second.accesses.loadRelaxed() == 0) {
+            _recommendations.push_back(Document{{"action", "drop"_sd},
+                                                {"index", indexName},
+                                                {"key", keyPattern},
+                                                {"reason", "unused"_sd},
+                                                {"since", usage->second.trackerStartTime}});
+            continue;
+        }
+
+        // An index whose key pattern is a strict prefix of another's serves no query that the
+        // other can't, as long as they hold the same documents and compare strings alike.
+        for (const auto& otherSpec : indexSpecs) {
+            const BSONObj otherKeyPattern = otherSpec["key"].Obj();
+            if (otherKeyPattern.nFields() > keyPattern.nFields() &&
+                isKeyPatternPrefix(keyPattern, otherKeyPattern, true) &&
+                indexesEveryDocument(spec) && indexesEveryDocument(otherSpec) &&
+                spec["collation"].woCompare(otherSpec["collation"], false) == 0) {
+                _recommendations.push_back(Document{{"action", "drop"_sd},
+                                                    {"index", indexName},
+                                                    {"key", keyPattern},
+                                                    {"reason", "prefix"_sd},
+                                                    {"prefixOf", otherSpec["name"].str()}});
+                break;
+            }
+        }
+    }
+
+    BSONObj planCacheShapes;
+    if (!_mongod->directClient()->runCommand(
+            nss.db().toString(), BSON("planCacheListQueryShapes" << nss.coll()), planCacheShapes)) {
+        // Without a plan cache, there are no query shapes to recommend indexes for.
+        return;
+    }
+
+    std::vector<BSONObj> recommendedKeyPatterns;
+    for (auto&& shapeElem : planCacheShapes["shapes"].Obj()) {
+        const BSONObj shape = shapeElem.Obj();
+        const BSONObj keyPattern =
+            recommendedKeyPattern(shape["query"].Obj(), shape["sort"].Obj());
+        if (keyPattern.isEmpty()) {
+            continue;
+        }
+
+        bool isServed = false;
+        for (const auto& spec : indexSpecs) {
+            isServed = isServed || isKeyPatternPrefix(keyPattern, spec["key"].Obj(), false);
+        }
+        for (const auto& recommended : recommendedKeyPatterns) {
+            isServed = isServed || recommended.binaryEqual(keyPattern);
+        }
+        if (isServed) {
+            continue;
+        }
+
+        recommendedKeyPatterns.push_back(keyPattern);
+        _recommendations.push_back(Document{{"action", "create"_sd},
+                                            {"key", keyPattern},
+                                            {"reason", "queryShape"_sd},
+                                            {"query", shape["query"].Obj()},
+                                            {"sort", shape["sort"].Obj()}});
+    }
+}
+
+boost::optional<Document> DocumentSourceIndexAdvisor::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (!_computed) {
+        computeRecommendations();
+        _recommendationsIter = _recommendations.begin();
+        _computed = true;
+    }
+
+    if (_recommendationsIter != _recommendations.end()) {
+        return *_recommendationsIter++;
+    }
+
+    return boost::none;
+}
+
+DocumentSourceIndexAdvisor::DocumentSourceIndexAdvisor(
+    const intrusive_ptr<ExpressionContext>& pExpCtx)
+    : DocumentSourceNeedsMongod(pExpCtx) {}
+
+intrusive_ptr<DocumentSource> DocumentSourceIndexAdvisor::createFromBson(
+    BSONElement elem, const intrusive_ptr<ExpressionContext>& pExpCtx) {
+    uassert(40222,
+            "The $indexAdvisor stage specification must be an empty object",
+            elem.type() == Object && elem.Obj().isEmpty());
+    return new DocumentSourceIndexAdvisor(pExpCtx);
+}
+
+Value DocumentSourceIndexAdvisor::serialize(bool explain) const {
+    return Value(DOC(getSourceName() << Document()));
+}
+}  // namespace mongo
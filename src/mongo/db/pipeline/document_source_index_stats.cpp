@@ -46,6 +46,7 @@ boost::optional<Document> DocumentSourceIndexStats::getNext() {
     if (_indexStatsMap.empty()) {
         _indexStatsMap = _mongod->getIndexStats(pExpCtx->opCtx, pExpCtx->ns);
         _indexStatsIter = _indexStatsMap.begin();
+        _indexStorageIOStats = _mongod->getIndexStorageIOStats(pExpCtx->opCtx, pExpCtx->ns);
     }
 
     if (_indexStatsIter != _indexStatsMap.end()) {
@@ -56,6 +57,25 @@ boost::optional<Document> DocumentSourceIndexStats::getNext() {
         doc["host"] = Value(_processName);
         doc["accesses"]["ops"] = Value(stats.accesses.loadRelaxed());
         doc["accesses"]["since"] = Value(stats.trackerStartTime);
+        doc["accesses"]["covering"] = Value(stats.coveringAccesses.loadRelaxed());
+
+        std::vector<Value> boundsShapes;
+        for (const auto& shapeCount : stats.boundsShapes) {
+            boundsShapes.push_back(
+                Value(DOC("shape" << Value(shapeCount.first) << "ops" << shapeCount.second)));
+        }
+        if (stats.otherBoundsShapeAccesses > 0) {
+            boundsShapes.push_back(
+                Value(DOC("shape"
+                          << "other"
+                          << "ops"
+                          << stats.otherBoundsShapeAccesses)));
+        }
+        doc["accesses"]["boundsShapes"] = Value(std::move(boundsShapes));
+        BSONElement storageIOStats = _indexStorageIOStats[_indexStatsIter->first];
+        if (storageIOStats.type() == Object && !storageIOStats.Obj().isEmpty()) {
+            doc["storageIOStats"] = Value(storageIOStats.Obj());
+        }
         ++_indexStatsIter;
         return doc.freeze();
     }
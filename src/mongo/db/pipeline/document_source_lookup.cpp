@@ -31,12 +31,14 @@
 #include "document_source.h"
 
 #include "mongo/base/init.h"
+#include "mongo/db/bson/dotted_path_support.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression_algo.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/stdx/memory.h"
 
 namespace mongo {
@@ -44,6 +46,10 @@ namespace mongo {
 using boost::intrusive_ptr;
 using std::vector;
 
+namespace dps = ::mongo::dotted_path_support;
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookupBatchSize, int, 100);
+
 DocumentSourceLookUp::DocumentSourceLookUp(NamespaceString fromNs,
                                            std::string as,
                                            std::string localField,
@@ -54,7 +60,14 @@ DocumentSourceLookUp::DocumentSourceLookUp(NamespaceString fromNs,
       _as(std::move(as)),
       _localField(std::move(localField)),
       _foreignField(foreignField),
-      _foreignFieldFieldName(std::move(foreignField)) {}
+      _foreignFieldFieldName(std::move(foreignField)) {
+    for (size_t i = 0; i < _foreignField.getPathLength(); ++i) {
+        const std::string& component = _foreignField.getFieldName(i);
+        if (std::all_of(component.begin(), component.end(), ::isdigit)) {
+            _canBatchForeignField = false;
+        }
+    }
+}
 
 REGISTER_DOCUMENT_SOURCE(lookup, DocumentSourceLookUp::createFromBson);
 
@@ -102,15 +115,36 @@ boost::optional<Document> DocumentSourceLookUp::getNext() {
         return unwindResult();
     }
 
+    // If we have not absorbed a $unwind, we cannot absorb a $match. If we have absorbed a $unwind,
+    // '_handlingUnwind' would be set to true, and we would not have made it here.
+    invariant(!_matchSrc);
+
+    const int batchSize = internalDocumentSourceLookupBatchSize.load();
+    if (batchSize > 1 && _canBatchForeignField) {
+        if (_batchedResults.empty()) {
+            lookUpBatch(batchSize);
+        }
+        if (_batchedResults.empty()) {
+            return {};
+        }
+        Document output = std::move(_batchedResults.front());
+        _batchedResults.pop_front();
+        return output;
+    }
+
     boost::optional<Document> input = pSource->getNext();
     if (!input)
         return {};
 
-    // If we have not absorbed a $unwind, we cannot absorb a $match. If we have absorbed a $unwind,
-    // '_handlingUnwind' would be set to true, and we would not have made it here.
-    invariant(!_matchSrc);
+    std::vector<Value> results = lookUpInput(*input);
 
-    BSONObj query = queryForInput(*input, _localField, _foreignFieldFieldName, BSONObj());
+    MutableDocument output(std::move(*input));
+    output.setNestedField(_as, Value(std::move(results)));
+    return output.freeze();
+}
+
+std::vector<Value> DocumentSourceLookUp::lookUpInput(const Document& input) {
+    BSONObj query = queryForInput(input, _localField, _foreignFieldFieldName, BSONObj());
     std::unique_ptr<DBClientCursor> cursor = _mongod->directClient()->query(_fromNs.ns(), query);
 
     std::vector<Value> results;
@@ -125,10 +159,108 @@ boost::optional<Document> DocumentSourceLookUp::getNext() {
                 objsize <= BSONObjMaxInternalSize);
         results.push_back(Value(result));
     }
+    return results;
+}
+
+bool DocumentSourceLookUp::isBatchableValue(const Value& localFieldVal) const {
+    // Arrays, regexes, null and missing values each have their own query semantics, and strings
+    // and other values which may contain strings are compared according to the foreign
+    // collection's collation. Leave all of them to a query of their own.
+    switch (localFieldVal.getType()) {
+        case NumberInt:
+        case NumberLong:
+        case NumberDouble:
+        case NumberDecimal:
+        case jstOID:
+        case Date:
+        case Bool:
+        case bsonTimestamp:
+            return true;
+        default:
+            return false;
+    }
+}
 
-    MutableDocument output(std::move(*input));
-    output.setNestedField(_as, Value(std::move(results)));
-    return output.freeze();
+void DocumentSourceLookUp::lookUpBatch(size_t batchSize) {
+    std::vector<Document> inputs;
+    while (inputs.size() < batchSize) {
+        boost::optional<Document> input = pSource->getNext();
+        if (!input) {
+            break;
+        }
+        inputs.push_back(std::move(*input));
+    }
+
+    // Group the inputs which can share the $in query by the value of their local field.
+    std::unordered_map<Value, std::vector<size_t>, Value::Hash> inputsByValue;
+    std::vector<bool> isBatched(inputs.size(), false);
+    std::vector<Value> inValues;
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        Value localFieldVal = inputs[i].getNestedField(_localField);
+        if (!isBatchableValue(localFieldVal)) {
+            continue;
+        }
+        auto& valueInputs = inputsByValue[localFieldVal];
+        if (valueInputs.empty()) {
+            inValues.push_back(localFieldVal);
+        }
+        valueInputs.push_back(i);
+        isBatched[i] = true;
+    }
+
+    std::vector<std::vector<Value>> results(inputs.size());
+    if (!inValues.empty()) {
+        BSONObjBuilder query;
+        {
+            BSONObjBuilder subObj(query.subobjStart(_foreignFieldFieldName));
+            subObj << "$in" << Value(inValues);
+            subObj.doneFast();
+        }
+        std::unique_ptr<DBClientCursor> cursor =
+            _mongod->directClient()->query(_fromNs.ns(), query.obj());
+
+        std::vector<int> objsizes(inputs.size(), 0);
+        while (cursor->more()) {
+            BSONObj result = cursor->nextSafe();
+
+            // A foreign document joins with every input whose value it holds in its foreign
+            // field, either directly or as an element of an array there, the same as the
+            // equality query of each input would match it.
+            BSONElementSet foreignValues;
+            dps::extractAllElementsAlongPath(result, _foreignFieldFieldName, foreignValues);
+            std::set<size_t> joined;
+            for (auto&& elem : foreignValues) {
+                auto it = inputsByValue.find(Value(elem));
+                if (it != inputsByValue.end()) {
+                    joined.insert(it->second.begin(), it->second.end());
+                }
+            }
+
+            Value resultVal(result);
+            for (size_t i : joined) {
+                objsizes[i] += result.objsize();
+                uassert(4568,
+                        str::stream() << "Total size of documents in " << _fromNs.coll()
+                                      << " matching "
+                                      << queryForInput(inputs[i],
+                                                       _localField,
+                                                       _foreignFieldFieldName,
+                                                       BSONObj())
+                                      << " exceeds maximum document size",
+                        objsizes[i] <= BSONObjMaxInternalSize);
+                results[i].push_back(resultVal);
+            }
+        }
+    }
+
+    for (size_t i = 0; i < inputs.size(); ++i) {
+        if (!isBatched[i]) {
+            results[i] = lookUpInput(inputs[i]);
+        }
+        MutableDocument output(std::move(inputs[i]));
+        output.setNestedField(_as, Value(std::move(results[i])));
+        _batchedResults.push_back(output.freeze());
+    }
 }
 
 Pipeline::SourceContainer::iterator DocumentSourceLookUp::optimizeAt(
@@ -265,6 +397,7 @@ Pipeline::SourceContainer::iterator DocumentSourceLookUp::optimizeAt(
 
 void DocumentSourceLookUp::dispose() {
     _cursor.reset();
+    _batchedResults.clear();
     pSource->dispose();
 }
 
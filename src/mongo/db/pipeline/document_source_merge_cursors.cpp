@@ -128,6 +128,10 @@ void DocumentSourceMergeCursors::start() {
         uassert(
             17028, "error reading response from " + _cursors.back()->connection->toString(), ok);
         verify(!retry);
+
+        // Each cursor has a connection of its own, so every shard can be working on its next
+        // batch while we consume the others.
+        cursor->cursor.enablePrefetch();
     }
 
     _currentCursor = _cursors.begin();
@@ -149,6 +153,17 @@ boost::optional<Document> DocumentSourceMergeCursors::getNext() {
     if (_unstarted)
         start();
 
+    // Prefer a cursor whose batch is already here over waiting for another shard's getMore.
+    auto it = _currentCursor;
+    for (size_t i = 0; i < _cursors.size(); ++i) {
+        if ((*it)->cursor.moreInCurrentBatch()) {
+            _currentCursor = it;
+            break;
+        }
+        if (++it == _cursors.end())
+            it = _cursors.begin();
+    }
+
     // purge eof cursors and release their connections
     while (!_cursors.empty() && !(*_currentCursor)->cursor.more()) {
         (*_currentCursor)->connection.done();
@@ -92,7 +92,8 @@ void DocumentSourceOut::prepTempCollection() {
                 ok);
     }
 
-    // copy indexes on _outputNs to _tempNs
+    // copy indexes on _outputNs to _tempNs. Only the _id index is created now, the others are
+    // built by buildIndexes() once the data is in place.
     const std::list<BSONObj> indexes = conn->getIndexSpecs(_outputNs.ns());
     for (std::list<BSONObj>::const_iterator it = indexes.begin(); it != indexes.end(); ++it) {
         MutableDocument index((Document(*it)));
@@ -100,6 +101,11 @@ void DocumentSourceOut::prepTempCollection() {
         index["ns"] = Value(_tempNs.ns());
 
         BSONObj indexBson = index.freeze().toBson();
+        if (indexBson["name"].str() != "_id_") {
+            _indexesToBuild.push_back(indexBson);
+            continue;
+        }
+
         conn->insert(_tempNs.getSystemIndexesCollection(), indexBson);
         BSONObj err = conn->getLastErrorDetailed();
         uassert(16995,
@@ -112,6 +118,30 @@ void DocumentSourceOut::prepTempCollection() {
     }
 }
 
+void DocumentSourceOut::buildIndexes() {
+    if (_indexesToBuild.empty()) {
+        return;
+    }
+
+    // A single createIndexes command builds all of the indexes during one scan of the collection.
+    BSONArrayBuilder indexesArr;
+    for (auto&& index : _indexesToBuild) {
+        indexesArr.append(index);
+    }
+    BSONObj cmd = BSON("createIndexes" << _tempNs.coll() << "indexes" << indexesArr.arr());
+
+    BSONObj info;
+    bool ok = _mongod->directClient()->runCommand(_tempNs.db().toString(), cmd, info);
+    uassert(40205,
+            str::stream() << "building indexes for $out failed."
+                          << " indexes: "
+                          << cmd["indexes"]
+                          << " error: "
+                          << info,
+            ok);
+    _indexesToBuild.clear();
+}
+
 void DocumentSourceOut::spill(const vector<BSONObj>& toInsert) {
     BSONObj err = _mongod->insert(_tempNs, toInsert);
     uassert(16996,
@@ -149,6 +179,8 @@ boost::optional<Document> DocumentSourceOut::getNext() {
     if (!bufferedObjects.empty())
         spill(bufferedObjects);
 
+    buildIndexes();
+
     // Checking again to make sure we didn't become sharded while running.
     uassert(17018,
             str::stream() << "namespace '" << _outputNs.ns()
@@ -48,10 +48,12 @@ DocumentSourceSampleFromRandomCursor::DocumentSourceSampleFromRandomCursor(
     const intrusive_ptr<ExpressionContext>& pExpCtx,
     long long size,
     std::string idField,
-    long long nDocsInCollection)
+    long long nDocsInCollection,
+    bool deduplicate)
     : DocumentSource(pExpCtx),
       _size(size),
       _idField(std::move(idField)),
+      _deduplicate(deduplicate),
       _nDocsInColl(nDocsInCollection) {}
 
 const char* DocumentSourceSampleFromRandomCursor::getSourceName() const {
@@ -76,12 +78,13 @@ double smallestFromSampleOfUniform(PseudoRandom* prng, size_t N) {
 boost::optional<Document> DocumentSourceSampleFromRandomCursor::getNext() {
     pExpCtx->checkForInterrupt();
 
-    if (_seenDocs.size() >= static_cast<size_t>(_size))
+    if (_nReturned >= _size)
         return {};
 
-    auto doc = getNextNonDuplicateDocument();
+    auto doc = _deduplicate ? getNextNonDuplicateDocument() : pSource->getNext();
     if (!doc)
         return {};
+    _nReturned++;
 
     // Assign it a random value to enable merging by random value, attempting to avoid bias in that
     // process.
@@ -132,7 +135,9 @@ Value DocumentSourceSampleFromRandomCursor::serialize(bool explain) const {
 
 DocumentSource::GetDepsReturn DocumentSourceSampleFromRandomCursor::getDependencies(
     DepsTracker* deps) const {
-    deps->fields.insert(_idField);
+    if (_deduplicate) {
+        deps->fields.insert(_idField);
+    }
     return SEE_NEXT;
 }
 
@@ -140,7 +145,9 @@ intrusive_ptr<DocumentSourceSampleFromRandomCursor> DocumentSourceSampleFromRand
     const intrusive_ptr<ExpressionContext>& expCtx,
     long long size,
     std::string idField,
-    long long nDocsInCollection) {
-    return new DocumentSourceSampleFromRandomCursor(expCtx, size, idField, nDocsInCollection);
+    long long nDocsInCollection,
+    bool deduplicate) {
+    return new DocumentSourceSampleFromRandomCursor(
+        expCtx, size, idField, nDocsInCollection, deduplicate);
 }
 }  // mongo
@@ -0,0 +1,73 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source.h"
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/stats/sampled_profile_buffer.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+REGISTER_DOCUMENT_SOURCE(sampledProfile, DocumentSourceSampledProfile::createFromBson);
+
+const char* DocumentSourceSampledProfile::getSourceName() const {
+    return "$sampledProfile";
+}
+
+intrusive_ptr<DocumentSource> DocumentSourceSampledProfile::createFromBson(
+    BSONElement specElem, const intrusive_ptr<ExpressionContext>& pExpCtx) {
+    uassert(40210,
+            str::stream() << "$sampledProfile must take an empty object but found: " << specElem,
+            specElem.type() == BSONType::Object && specElem.embeddedObject().isEmpty());
+    return new DocumentSourceSampledProfile(pExpCtx);
+}
+
+boost::optional<Document> DocumentSourceSampledProfile::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (!_initialized) {
+        _docs = SampledProfileBuffer::get(pExpCtx->opCtx->getServiceContext())
+                    ->getRecent(pExpCtx->ns.db());
+        _initialized = true;
+    }
+
+    if (_nextDoc == _docs.size()) {
+        return boost::none;
+    }
+    return Document(_docs[_nextDoc++]);
+}
+
+Value DocumentSourceSampledProfile::serialize(bool explain) const {
+    return Value(DOC(getSourceName() << Document()));
+}
+
+}  // namespace mongo
@@ -42,18 +42,27 @@ namespace mongo {
 using boost::intrusive_ptr;
 
 DocumentSourceTeeConsumer::DocumentSourceTeeConsumer(const intrusive_ptr<ExpressionContext>& expCtx,
-                                                     const intrusive_ptr<TeeBuffer>& bufferSource)
-    : DocumentSource(expCtx), _bufferSource(bufferSource), _iterator() {}
+                                                     const intrusive_ptr<TeeBuffer>& bufferSource,
+                                                     size_t consumerId)
+    : DocumentSource(expCtx),
+      _consumerId(consumerId),
+      _bufferSource(bufferSource),
+      _iterator() {}
 
 boost::intrusive_ptr<DocumentSourceTeeConsumer> DocumentSourceTeeConsumer::create(
     const boost::intrusive_ptr<ExpressionContext>& expCtx,
-    const boost::intrusive_ptr<TeeBuffer>& bufferSource) {
-    return new DocumentSourceTeeConsumer(expCtx, bufferSource);
+    const boost::intrusive_ptr<TeeBuffer>& bufferSource,
+    size_t consumerId) {
+    return new DocumentSourceTeeConsumer(expCtx, bufferSource, consumerId);
 }
 
 boost::optional<Document> DocumentSourceTeeConsumer::getNext() {
     pExpCtx->checkForInterrupt();
 
+    if (_bufferSource->isStreaming()) {
+        return _bufferSource->getNextStreamed(_consumerId);
+    }
+
     if (!_initialized) {
         _bufferSource->populate();
         _initialized = true;
@@ -70,6 +79,9 @@ boost::optional<Document> DocumentSourceTeeConsumer::getNext() {
 void DocumentSourceTeeConsumer::dispose() {
     // Release our reference to the buffer. We shouldn't call dispose() on the buffer, since there
     // might be other consumers that need to use it.
+    if (_bufferSource && _bufferSource->isStreaming()) {
+        _bufferSource->releaseConsumer(_consumerId);
+    }
     _bufferSource.reset();
 }
 
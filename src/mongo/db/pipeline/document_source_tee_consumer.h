@@ -44,13 +44,15 @@ class Value;
 /**
  * This stage acts as a proxy between a pipeline within a $facet stage and the buffer of incoming
  * documents held in a TeeBuffer stage. It will simply open an iterator on the TeeBuffer stage, and
- * answer calls to getNext() by advancing said iterator.
+ * answer calls to getNext() by advancing said iterator. If the TeeBuffer streams its input, it
+ * instead reads from it as consumer number 'consumerId'.
  */
 class DocumentSourceTeeConsumer : public DocumentSource {
 public:
     static boost::intrusive_ptr<DocumentSourceTeeConsumer> create(
         const boost::intrusive_ptr<ExpressionContext>& expCtx,
-        const boost::intrusive_ptr<TeeBuffer>& bufferSource);
+        const boost::intrusive_ptr<TeeBuffer>& bufferSource,
+        size_t consumerId = 0);
 
     void dispose() final;
     boost::optional<Document> getNext() final;
@@ -59,9 +61,11 @@ public:
 
 private:
     DocumentSourceTeeConsumer(const boost::intrusive_ptr<ExpressionContext>& expCtx,
-                              const boost::intrusive_ptr<TeeBuffer>& bufferSource);
+                              const boost::intrusive_ptr<TeeBuffer>& bufferSource,
+                              size_t consumerId);
 
     bool _initialized = false;
+    const size_t _consumerId;
     boost::intrusive_ptr<TeeBuffer> _bufferSource;
     TeeBuffer::const_iterator _iterator;
 };
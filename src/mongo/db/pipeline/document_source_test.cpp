@@ -1030,10 +1030,9 @@ public:
 
         assertExhausted(group());
 
+        // The groups with unstreamable keys are output last, so the output isn't sorted.
         BSONObjSet outputSort = group()->getOutputSorts();
-        ASSERT_EQUALS(outputSort.size(), 1U);
-
-        ASSERT_EQUALS(outputSort.count(BSON("_id" << 1)), 1U);
+        ASSERT_EQUALS(outputSort.size(), 0U);
     }
 };
 
@@ -1066,22 +1065,18 @@ public:
 
         assertExhausted(source);
 
+        // The groups with unstreamable keys are output last, so the output isn't sorted.
         BSONObjSet outputSort = group()->getOutputSorts();
-        ASSERT_EQUALS(outputSort.size(), 2U);
-
-        BSONObj correctSort = BSON("_id.x" << 1 << "_id.y" << -1);
-        ASSERT_EQUALS(outputSort.count(correctSort), 1U);
-
-        BSONObj prefixSort = BSON("_id.x" << 1);
-        ASSERT_EQUALS(outputSort.count(prefixSort), 1U);
+        ASSERT_EQUALS(outputSort.size(), 0U);
     }
 };
 
 class StreamingWithMultipleLevels : public Base {
 public:
     void run() {
-        auto source = DocumentSourceMock::create(
-            {"{a: {b: {c: 3}}, d: 1}", "{a: {b: {c: 1}}, d: 2}", "{a: {b: {c: 1}}, d: 0}"});
+        auto source = DocumentSourceMock::create({"{a: {b: {c: 3, d: 1}}, d: 1}",
+                                                  "{a: {b: {c: 1, d: 1}}, d: 2}",
+                                                  "{a: {b: {c: 1, d: 1}}, d: 0}"});
         source->sorts = {BSON("a.b.c" << -1 << "a.b.d" << 1 << "d" << 1)};
 
         createGroup(fromjson("{_id: {x: {y: {z: '$a.b.c', q: '$a.b.d'}}, v: '$d'}}"));
@@ -1099,17 +1094,9 @@ public:
 
         assertExhausted(source);
 
+        // The groups with unstreamable keys are output last, so the output isn't sorted.
         BSONObjSet outputSort = group()->getOutputSorts();
-        ASSERT_EQUALS(outputSort.size(), 3U);
-
-        BSONObj correctSort = fromjson("{'_id.x.y.z': -1, '_id.x.y.q': 1, '_id.v': 1}");
-        ASSERT_EQUALS(outputSort.count(correctSort), 1U);
-
-        BSONObj prefixSortTwo = fromjson("{'_id.x.y.z': -1, '_id.x.y.q': 1}");
-        ASSERT_EQUALS(outputSort.count(prefixSortTwo), 1U);
-
-        BSONObj prefixSortOne = fromjson("{'_id.x.y.z': -1}");
-        ASSERT_EQUALS(outputSort.count(prefixSortOne), 1U);
+        ASSERT_EQUALS(outputSort.size(), 0U);
     }
 };
 
@@ -1136,15 +1123,9 @@ public:
         ASSERT_EQUALS(res->getField("a"), Value(2));
         ASSERT_EQUALS(res->getField("b"), Value(3));
 
+        // The groups with unstreamable keys are output last, so the output isn't sorted.
         BSONObjSet outputSort = group()->getOutputSorts();
-
-        ASSERT_EQUALS(outputSort.size(), 2U);
-
-        BSONObj correctSort = fromjson("{'_id.sub.z': 1}");
-        ASSERT_EQUALS(outputSort.count(correctSort), 1U);
-
-        BSONObj prefixSortTwo = fromjson("{'_id.sub.z': 1, '_id.sub.y': 1}");
-        ASSERT_EQUALS(outputSort.count(prefixSortTwo), 1U);
+        ASSERT_EQUALS(outputSort.size(), 0U);
     }
 };
 
@@ -1171,14 +1152,9 @@ public:
         ASSERT_EQUALS(res->getField("a"), Value(3));
         ASSERT_EQUALS(res->getField("b"), Value(1));
 
+        // The groups with unstreamable keys are output last, so the output isn't sorted.
         BSONObjSet outputSort = group()->getOutputSorts();
-        ASSERT_EQUALS(outputSort.size(), 2U);
-
-        BSONObj correctSort = fromjson("{'_id.sub.x': -1}");
-        ASSERT_EQUALS(outputSort.count(correctSort), 1U);
-
-        BSONObj prefixSortTwo = fromjson("{'_id.sub.x': -1, '_id.sub.y': 1}");
-        ASSERT_EQUALS(outputSort.count(prefixSortTwo), 1U);
+        ASSERT_EQUALS(outputSort.size(), 0U);
     }
 };
 
@@ -1194,11 +1170,9 @@ public:
         group()->getNext();
         ASSERT_TRUE(group()->isStreaming());
 
+        // The groups with unstreamable keys are output last, so the output isn't sorted.
         BSONObjSet outputSort = group()->getOutputSorts();
-        ASSERT_EQUALS(outputSort.size(), 1U);
-
-        BSONObj correctSort = fromjson("{_id: 1}");
-        ASSERT_EQUALS(outputSort.count(correctSort), 1U);
+        ASSERT_EQUALS(outputSort.size(), 0U);
     }
 };
 
@@ -1236,6 +1210,50 @@ public:
     }
 };
 
+class StreamingWithUnstreamableKeys : public Base {
+public:
+    void run() {
+        // Null and missing values are ordered together, and arrays by their smallest element, as
+        // in an index on 'a'.
+        auto source = DocumentSourceMock::create({"{a: null, b: 1}",
+                                                  "{b: 2}",
+                                                  "{a: null, b: 3}",
+                                                  "{a: [1, 2], b: 4}",
+                                                  "{a: 1, b: 5}",
+                                                  "{a: [1, 2], b: 6}",
+                                                  "{a: 1, b: 7}",
+                                                  "{a: 2, b: 8}"});
+        source->sorts = {BSON("a" << 1)};
+
+        createGroup(fromjson("{_id: '$a', total: {$sum: '$b'}}"));
+        group()->setSource(source.get());
+
+        // The streamable groups come first, in order.
+        auto res = group()->getNext();
+        ASSERT_TRUE(bool(res));
+        ASSERT_TRUE(group()->isStreaming());
+        ASSERT_EQUALS(*res, Document(fromjson("{_id: 1, total: 12}")));
+
+        res = group()->getNext();
+        ASSERT_TRUE(bool(res));
+        ASSERT_EQUALS(*res, Document(fromjson("{_id: 2, total: 8}")));
+
+        // Each of the others is output exactly once, in no particular order.
+        IdMap unstreamed;
+        while ((res = group()->getNext())) {
+            Value id = res->getField("_id");
+            ASSERT_EQUALS(unstreamed.count(id), 0U);
+            unstreamed[id] = *res;
+        }
+        ASSERT_EQUALS(unstreamed.size(), 2U);
+        ASSERT_EQUALS(unstreamed[Value(BSONNULL)], Document(fromjson("{_id: null, total: 6}")));
+        ASSERT_EQUALS(unstreamed[Value(BSON_ARRAY(1 << 2))],
+                      Document(fromjson("{_id: [1, 2], total: 10}")));
+
+        assertExhausted(group());
+    }
+};
+
 class NoOptimizationIfMissingDoubleSort : public Base {
 public:
     void run() {
@@ -1349,6 +1367,51 @@ public:
     }
 };
 
+/**
+ * A $group partitioned between several threads produces the same groups as a serial one,
+ * including for accumulators that depend on the order of their input.
+ */
+class ParallelMatchesSerial : public Base {
+public:
+    void run() {
+        std::deque<Document> input;
+        for (int i = 0; i < 10000; i++) {
+            input.push_back(DOC("a" << i % 997 << "b" << i));
+        }
+        BSONObj spec = fromjson(
+            "{_id: '$a', count: {$sum: 1}, first: {$first: '$b'}, last: {$last: '$b'},"
+            " all: {$push: '$b'}}");
+
+        BSONObj serial = runWithThreads(spec, input, 0);
+        ASSERT_EQUALS(997, serial.nFields());
+        ASSERT_EQUALS(serial, runWithThreads(spec, input, 4));
+    }
+
+private:
+    /** Runs the $group with 'numThreads' workers and returns its results sorted by _id. */
+    BSONObj runWithThreads(const BSONObj& spec, const std::deque<Document>& input, int numThreads) {
+        const int oldNumThreads = internalDocumentSourceGroupParallelThreads.load();
+        internalDocumentSourceGroupParallelThreads.store(numThreads);
+
+        createGroup(spec);
+        auto source = DocumentSourceMock::create(input);
+        group()->setSource(source.get());
+
+        IdMap resultSet;
+        while (boost::optional<Document> current = group()->getNext()) {
+            resultSet[current->getField("_id")] = *current;
+        }
+        assertExhausted(group());
+        internalDocumentSourceGroupParallelThreads.store(oldNumThreads);
+
+        BSONArrayBuilder bsonResultSet;
+        for (IdMap::const_iterator i = resultSet.begin(); i != resultSet.end(); ++i) {
+            bsonResultSet << i->second;
+        }
+        return bsonResultSet.arr();
+    }
+};
+
 }  // namespace DocumentSourceGroup
 
 namespace DocumentSourceProject {
@@ -1825,6 +1888,31 @@ TEST_F(SampleFromRandomCursorBasics, MimicNonOptimized) {
     ASSERT_GTE(secondTotal / nTrials, 0.48);
     ASSERT_LTE(secondTotal / nTrials, 0.52);
 }
+
+/**
+ * A $sampleFromRandomCursor stage over input known to be distinct should neither de-duplicate it
+ * nor need the id field.
+ */
+TEST_F(SampleFromRandomCursorBasics, ShouldNotDeduplicateDistinctInput) {
+    _sample = DocumentSourceSampleFromRandomCursor::create(ctx(), 3, "_id", 100, false);
+    sample()->setSource(_mock.get());
+
+    source()->queue.push_back(DOC("a" << 1));
+    source()->queue.push_back(DOC("a" << 2));
+    source()->queue.push_back(DOC("a" << 3));
+    source()->queue.push_back(DOC("a" << 4));
+
+    for (int i = 1; i <= 3; i++) {
+        auto doc = sample()->getNext();
+        ASSERT_TRUE(bool(doc));
+        ASSERT_EQUALS((*doc)["a"].getInt(), i);
+    }
+    ASSERT_FALSE(bool(sample()->getNext()));
+
+    DepsTracker dependencies;
+    ASSERT_EQUALS(DocumentSource::SEE_NEXT, sample()->getDependencies(&dependencies));
+    ASSERT_EQUALS(0U, dependencies.fields.size());
+}
 }  // namespace DocumentSourceSampleFromRandomCursor
 
 }  // namespace DocumentSourceSample
@@ -3613,6 +3701,36 @@ TEST_F(InvalidCountSpec, PeriodInStringSpec) {
 }
 }  // namespace DocumentSourceCount
 
+namespace DocumentSourceIndexAdvisor {
+using mongo::DocumentSourceIndexAdvisor;
+
+TEST(IndexAdvisorKeyPattern, ShouldOrderEqualityThenSortThenRangeFields) {
+    ASSERT_EQUALS(fromjson("{a: 1, c: 1, d: -1, b: 1}"),
+                  DocumentSourceIndexAdvisor::recommendedKeyPattern(
+                      fromjson("{b: {$gt: 1}, a: 5, c: {$in: [1, 2]}}"), fromjson("{d: -1}")));
+}
+
+TEST(IndexAdvisorKeyPattern, ShouldPlaceRangeFieldThatIsAlsoSortedAsSortField) {
+    ASSERT_EQUALS(fromjson("{a: 1, b: -1}"),
+                  DocumentSourceIndexAdvisor::recommendedKeyPattern(
+                      fromjson("{b: {$lt: 1}, a: 1}"), fromjson("{a: 1, b: -1}")));
+}
+
+TEST(IndexAdvisorKeyPattern, ShouldTreatRegexAsRange) {
+    ASSERT_EQUALS(fromjson("{b: 1, a: 1}"),
+                  DocumentSourceIndexAdvisor::recommendedKeyPattern(fromjson("{a: /^x/, b: 1}"),
+                                                                    BSONObj()));
+}
+
+TEST(IndexAdvisorKeyPattern, ShouldIgnoreLogicalOperatorsAndUnselectivePredicates) {
+    ASSERT_EQUALS(BSONObj(),
+                  DocumentSourceIndexAdvisor::recommendedKeyPattern(
+                      fromjson("{$or: [{a: 1}, {b: 1}], c: {$exists: true}}"),
+                      fromjson("{score: {$meta: 'textScore'}}")));
+}
+
+}  // namespace DocumentSourceIndexAdvisor
+
 class All : public Suite {
 public:
     All() : Suite("documentsource") {}
@@ -3659,8 +3777,7 @@ public:
         add<DocumentSourceGroup::Dependencies>();
         add<DocumentSourceGroup::StringConstantIdAndAccumulatorExpressions>();
         add<DocumentSourceGroup::ArrayConstantAccumulatorExpression>();
-#if 0
-        // Disabled tests until SERVER-23318 is implemented.
+        add<DocumentSourceGroup::ParallelMatchesSerial>();
         add<DocumentSourceGroup::StreamingOptimization>();
         add<DocumentSourceGroup::StreamingWithMultipleIdFields>();
         add<DocumentSourceGroup::NoOptimizationIfMissingDoubleSort>();
@@ -3672,7 +3789,7 @@ public:
         add<DocumentSourceGroup::StreamingWithRootSubfield>();
         add<DocumentSourceGroup::StreamingWithConstantAndFieldPath>();
         add<DocumentSourceGroup::StreamingWithFieldRepeated>();
-#endif
+        add<DocumentSourceGroup::StreamingWithUnstreamableKeys>();
 
         add<DocumentSourceSort::Empty>();
         add<DocumentSourceSort::SingleValue>();
@@ -31,6 +31,7 @@
 #include "mongo/platform/basic.h"
 
 #include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/document_arena.h"
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/dbtests/dbtests.h"
@@ -541,6 +542,128 @@ TEST(MetaFields, BadSerialization) {
 }
 }  // namespace MetaFields
 
+namespace OriginalBson {
+using mongo::Document;
+
+TEST(OriginalBson, UnmodifiedDocumentReturnsItsBson) {
+    BSONObj obj = BSON("a" << 1 << "b" << BSON("c" << "x"));
+    Document doc = Document::fromBsonKeepingOriginal(obj);
+    ASSERT_TRUE(obj.objdata() == doc.toBson().objdata());
+    ASSERT_TRUE(obj.objdata() == doc.toBsonWithMetaData().objdata());
+    ASSERT_GTE(doc.getApproximateSize(), static_cast<size_t>(obj.objsize()));
+
+    BSONObjBuilder bob;
+    doc.toBson(&bob);
+    ASSERT_EQUALS(obj, bob.obj());
+}
+
+TEST(OriginalBson, ModifiedDocumentIsSerializedAgain) {
+    BSONObj obj = BSON("a" << 1 << "b" << 2);
+    Document doc = Document::fromBsonKeepingOriginal(obj);
+
+    MutableDocument md(doc);
+    md.setField("a", Value(3));
+    Document modified = md.freeze();
+    ASSERT_EQUALS(BSON("a" << 3 << "b" << 2), modified.toBson());
+
+    // The copy-on-write leaves the original document alone.
+    ASSERT_TRUE(obj.objdata() == doc.toBson().objdata());
+}
+
+TEST(OriginalBson, ModifiedInPlaceDocumentIsSerializedAgain) {
+    MutableDocument md(Document::fromBsonKeepingOriginal(BSON("a" << 1)));
+    md.setRandMetaField(0.5);
+    md.addField("b", Value(2));
+    Document doc = md.freeze();
+    ASSERT_EQUALS(BSON("a" << 1 << "b" << 2), doc.toBson());
+    ASSERT_EQUALS(0.5, doc.toBsonWithMetaData()[Document::metaFieldRandVal].Double());
+}
+
+TEST(OriginalBson, MetadataIsNotKept) {
+    BSONObj obj = BSON("a" << 1 << Document::metaFieldTextScore << 2.0);
+    Document doc = Document::fromBsonKeepingOriginal(obj);
+    ASSERT_TRUE(doc.hasTextScore());
+    ASSERT_EQUALS(BSON("a" << 1), doc.toBson());
+}
+}  // namespace OriginalBson
+
+namespace Arena {
+
+TEST(DocumentArena, SmallAllocationsShareAChunk) {
+    DocumentArena arena;
+    boost::intrusive_ptr<DocumentArena::Chunk> first;
+    boost::intrusive_ptr<DocumentArena::Chunk> second;
+    char* a = arena.allocate(100, &first);
+    char* b = arena.allocate(20, &second);
+    ASSERT_EQUALS(first.get(), second.get());
+    ASSERT_EQUALS(1U, arena.chunksAllocated());
+    ASSERT_EQUALS(0U, reinterpret_cast<uintptr_t>(a) % DocumentArena::kAlignment);
+    ASSERT_EQUALS(0U, reinterpret_cast<uintptr_t>(b) % DocumentArena::kAlignment);
+    ASSERT_GREATER_THAN_OR_EQUALS(b - a, 100);
+}
+
+TEST(DocumentArena, LargeAllocationGetsItsOwnChunk) {
+    DocumentArena arena;
+    boost::intrusive_ptr<DocumentArena::Chunk> small;
+    boost::intrusive_ptr<DocumentArena::Chunk> large;
+    boost::intrusive_ptr<DocumentArena::Chunk> next;
+    arena.allocate(100, &small);
+    arena.allocate(DocumentArena::kMaxSharedAllocationBytes + 1, &large);
+    arena.allocate(100, &next);
+    ASSERT_NOT_EQUALS(small.get(), large.get());
+    ASSERT_EQUALS(small.get(), next.get());
+    ASSERT_GREATER_THAN_OR_EQUALS(large->capacity(), DocumentArena::kMaxSharedAllocationBytes + 1);
+}
+
+TEST(DocumentArena, OnlyUsedWithinScope) {
+    DocumentArena arena;
+    mongo::Document outside = DOC("a" << 1);
+    ASSERT_EQUALS(0U, arena.chunksAllocated());
+    {
+        DocumentArena::Scope scope(&arena);
+        ASSERT_EQUALS(&arena, DocumentArena::current());
+        {
+            DocumentArena::Scope disabled(nullptr);
+            mongo::Document heap = DOC("a" << 1);
+            ASSERT_EQUALS(0U, arena.chunksAllocated());
+        }
+        mongo::Document inside = DOC("a" << 1);
+        ASSERT_EQUALS(1U, arena.chunksAllocated());
+    }
+    ASSERT(!DocumentArena::current());
+}
+
+TEST(DocumentArena, DocumentsOutliveArena) {
+    mongo::Document doc;
+    mongo::Document clone;
+    {
+        DocumentArena arena;
+        DocumentArena::Scope scope(&arena);
+
+        // Enough fields to grow the buffer and the hash table several times.
+        MutableDocument md;
+        for (int i = 0; i < 100; i++) {
+            md.addField("field" + std::to_string(i), mongo::Value(i));
+        }
+        doc = md.freeze();
+
+        MutableDocument copy(doc);
+        copy.setField("extra", mongo::Value(BSONObj()));
+        clone = copy.freeze();
+    }
+
+    ASSERT_EQUALS(100U, doc.size());
+    ASSERT_EQUALS(101U, clone.size());
+    for (int i = 0; i < 100; i++) {
+        const std::string name = "field" + std::to_string(i);
+        ASSERT_EQUALS(mongo::Value(i), doc[name]);
+        ASSERT_EQUALS(mongo::Value(i), clone[name]);
+    }
+    ASSERT_EQUALS(doc, mongo::Document(doc.toBson()));
+}
+
+}  // namespace Arena
+
 namespace Value {
 
 using mongo::Value;
@@ -1537,6 +1660,17 @@ public:
         // High bit set.
         assertComparison(1, Timestamp(~0U, 2), Timestamp(0, 3));
 
+        // Compound $group keys, which are hashed and found equal element by element.
+        assertComparison(0,
+                         Value(vector<Value>{Value(1), Value("a")}),
+                         Value(vector<Value>{Value(1.0), Value("a")}));
+        assertComparison(-1,
+                         Value(vector<Value>{Value(1), Value("a")}),
+                         Value(vector<Value>{Value(1), Value("ab")}));
+        assertComparison(-1,
+                         Value(vector<Value>{Value(1), Value("b")}),
+                         Value(vector<Value>{Value(1), Value("b"), Value(1)}));
+
         // Cross-type comparisons. Listed in order of canonical types.
         assertComparison(-1, Value(mongo::MINKEY), Value());
         assertComparison(0, Value(), Value());
@@ -1597,6 +1731,10 @@ private:
         ASSERT_EQUALS(expectedResult, cmp(a, b));
         ASSERT_EQUALS(-expectedResult, cmp(b, a));
 
+        // equality agrees with comparison
+        ASSERT_EQUALS(expectedResult == 0, a == b);
+        ASSERT_EQUALS(expectedResult == 0, b == a);
+
         if (expectedResult == 0) {
             // equal values must hash equally.
             ASSERT_EQUALS(hash(a), hash(b));
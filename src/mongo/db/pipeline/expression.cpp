@@ -805,6 +805,19 @@ const char* ExpressionConcatArrays::getOpName() const {
 
 /* ----------------------- ExpressionCond ------------------------------ */
 
+intrusive_ptr<Expression> ExpressionCond::optimize() {
+    intrusive_ptr<Expression> optimized = Base::optimize();
+    if (optimized.get() != this) {
+        return optimized;
+    }
+
+    // A constant condition always picks the same branch, so the $cond can be replaced by it.
+    if (auto constCond = dynamic_cast<ExpressionConstant*>(vpOperand[0].get())) {
+        return vpOperand[constCond->getValue().coerceToBool() ? 1 : 2];
+    }
+    return this;
+}
+
 Value ExpressionCond::evaluateInternal(Variables* vars) const {
     Value pCond(vpOperand[0]->evaluateInternal(vars));
     int idx = pCond.coerceToBool() ? 1 : 2;
@@ -1207,8 +1220,18 @@ intrusive_ptr<ExpressionObject> ExpressionObject::parse(BSONObj obj,
 }
 
 intrusive_ptr<Expression> ExpressionObject::optimize() {
+    bool allConstant = true;
     for (auto&& pair : _expressions) {
         pair.second = pair.second->optimize();
+        if (!dynamic_cast<ExpressionConstant*>(pair.second.get())) {
+            allConstant = false;
+        }
+    }
+
+    // An object of constants is itself a constant, and needn't be rebuilt for every input.
+    if (allConstant) {
+        Variables emptyVars;
+        return ExpressionConstant::create(evaluateInternal(&emptyVars));
     }
     return this;
 }
@@ -3585,6 +3608,30 @@ boost::intrusive_ptr<Expression> ExpressionSwitch::optimize() {
                        return {branch.first->optimize(), branch.second->optimize()};
                    });
 
+    // Branches with a constant case can be decided now. Those which never match are dropped, and
+    // the first which always matches becomes the default, as no later branch can be reached.
+    std::vector<ExpressionPair> remainingBranches;
+    boost::intrusive_ptr<Expression> remainingDefault = _default;
+    for (auto&& branch : _branches) {
+        auto constCase = dynamic_cast<ExpressionConstant*>(branch.first.get());
+        if (!constCase) {
+            remainingBranches.push_back(branch);
+        } else if (constCase->getValue().coerceToBool()) {
+            remainingDefault = branch.second;
+            break;
+        }
+    }
+
+    if (remainingBranches.empty()) {
+        if (!remainingDefault) {
+            // No branch can match and there is no default. Keep the branches, so that the $switch
+            // still serializes to something which parses, and fails when evaluated.
+            return this;
+        }
+        return remainingDefault;
+    }
+    _branches = std::move(remainingBranches);
+    _default = std::move(remainingDefault);
     return this;
 }
 
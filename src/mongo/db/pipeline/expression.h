@@ -603,6 +603,7 @@ class ExpressionCond final : public ExpressionFixedArity<ExpressionCond, 3> {
     typedef ExpressionFixedArity<ExpressionCond, 3> Base;
 
 public:
+    boost::intrusive_ptr<Expression> optimize() final;
     Value evaluateInternal(Variables* vars) const final;
     const char* getOpName() const final;
 
@@ -51,9 +51,9 @@ ExpressionContext::ExpressionContext(OperationContext* opCtx, const AggregationR
 
 void ExpressionContext::checkForInterrupt() {
     // This check could be expensive, at least in relative terms, so don't check every time.
-    if (--interruptCounter == 0) {
+    if (interruptCounter.subtractAndFetch(1) <= 0) {
+        interruptCounter.store(kInterruptCheckPeriod);
         opCtx->checkForInterrupt();
-        interruptCounter = kInterruptCheckPeriod;
     }
 }
 }  // namespace mongo
@@ -35,7 +35,9 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/pipeline/aggregation_request.h"
+#include "mongo/db/pipeline/document_arena.h"
 #include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/intrusive_counter.h"
 
 namespace mongo {
@@ -69,7 +71,13 @@ public:
     // case where 'collation' is empty and there is a collection default collation.
     std::unique_ptr<CollatorInterface> collator;
 
+    // If set, the documents created while the pipeline is run are allocated from this arena.
+    std::unique_ptr<DocumentArena> documentArena;
+
     static const int kInterruptCheckPeriod = 128;
-    int interruptCounter = kInterruptCheckPeriod;  // when 0, check interruptStatus
+
+    // When this drops to 0, check interruptStatus. It is atomic since the sub-pipelines of a $facet
+    // may run on separate threads.
+    AtomicInt32 interruptCounter{kInterruptCheckPeriod};
 };
 }
@@ -2525,18 +2525,19 @@ TEST(ExpressionObjectDependencies, FieldPathsShouldBeAddedToDependencies) {
 //
 
 TEST(ExpressionObjectOptimizations, OptimizingAnObjectShouldOptimizeSubExpressions) {
-    // Build up the object {a: {$add: [1, 2]}}.
+    // Build up the object {a: {$add: [1, 2]}, b: "$c"}.
     VariablesIdGenerator idGen;
     VariablesParseState vps(&idGen);
     auto addExpression =
         ExpressionAdd::parse(BSON("$add" << BSON_ARRAY(1 << 2)).firstElement(), vps);
-    auto object = ExpressionObject::create({{"a", addExpression}});
-    ASSERT_EQ(object->getChildExpressions().size(), 1UL);
+    auto fieldPathExpression = ExpressionFieldPath::parse("$c", vps);
+    auto object = ExpressionObject::create({{"a", addExpression}, {"b", fieldPathExpression}});
+    ASSERT_EQ(object->getChildExpressions().size(), 2UL);
 
     auto optimized = object->optimize();
     auto optimizedObject = dynamic_cast<ExpressionObject*>(optimized.get());
     ASSERT_TRUE(optimizedObject);
-    ASSERT_EQ(optimizedObject->getChildExpressions().size(), 1UL);
+    ASSERT_EQ(optimizedObject->getChildExpressions().size(), 2UL);
 
     // We should have optimized {$add: [1, 2]} to just the constant 3.
     auto expConstant =
@@ -2545,8 +2546,66 @@ TEST(ExpressionObjectOptimizations, OptimizingAnObjectShouldOptimizeSubExpressio
     ASSERT_EQ(expConstant->evaluate(Document()), Value(3));
 };
 
+TEST(ExpressionObjectOptimizations, OptimizingAnObjectOfConstantsShouldFoldToAConstant) {
+    // Build up the object {a: {$add: [1, 2]}, b: {c: "x"}}.
+    VariablesIdGenerator idGen;
+    VariablesParseState vps(&idGen);
+    auto addExpression =
+        ExpressionAdd::parse(BSON("$add" << BSON_ARRAY(1 << 2)).firstElement(), vps);
+    auto nested = ExpressionObject::create({{"c", ExpressionConstant::create(Value("x"))}});
+    auto object = ExpressionObject::create({{"a", addExpression}, {"b", nested}});
+
+    auto optimized = object->optimize();
+    auto expConstant = dynamic_cast<ExpressionConstant*>(optimized.get());
+    ASSERT_TRUE(expConstant);
+    ASSERT_EQ(expConstant->getValue(), Value(fromjson("{a: 3, b: {c: 'x'}}")));
+};
+
 }  // namespace Object
 
+namespace ControlFlowOptimizations {
+
+intrusive_ptr<Expression> optimizeOperand(const char* json) {
+    VariablesIdGenerator idGen;
+    VariablesParseState vps(&idGen);
+    BSONObj spec = fromjson(json);
+    return Expression::parseOperand(spec.firstElement(), vps)->optimize();
+}
+
+TEST(ExpressionCondOptimizations, ConstantConditionShouldBeReplacedByItsBranch) {
+    auto optimized = optimizeOperand("{'': {$cond: [{$eq: [1, 1]}, '$a', '$b']}}");
+    ASSERT_EQ(optimized->serialize(false), Value("$a"));
+
+    optimized = optimizeOperand("{'': {$cond: {if: 0, then: '$a', else: '$b'}}}");
+    ASSERT_EQ(optimized->serialize(false), Value("$b"));
+
+    // A condition which depends on the input is kept.
+    optimized = optimizeOperand("{'': {$cond: ['$c', '$a', '$b']}}");
+    ASSERT_TRUE(dynamic_cast<ExpressionCond*>(optimized.get()));
+}
+
+TEST(ExpressionSwitchOptimizations, ConstantCasesShouldBeDecided) {
+    auto optimized = optimizeOperand(
+        "{'': {$switch: {branches: [{case: '$x', then: 1}, {case: false, then: 2},"
+        "                           {case: true, then: 3}, {case: '$y', then: 4}],"
+        "                default: 5}}}");
+    ASSERT_EQ(optimized->serialize(false),
+              Value(fromjson("{$switch: {branches: [{case: '$x', then: {$const: 1}}],"
+                             "           default: {$const: 3}}}")));
+
+    // Without any branch left, the $switch is replaced by its default.
+    optimized = optimizeOperand(
+        "{'': {$switch: {branches: [{case: {$lt: [2, 1]}, then: '$a'}], default: '$b'}}}");
+    ASSERT_EQ(optimized->serialize(false), Value("$b"));
+
+    // A $switch which can't match and has no default still fails when evaluated.
+    optimized = optimizeOperand("{'': {$switch: {branches: [{case: false, then: '$a'}]}}}");
+    ASSERT_TRUE(dynamic_cast<ExpressionSwitch*>(optimized.get()));
+    ASSERT_THROWS_CODE(optimized->evaluate(Document()), UserException, 40066);
+}
+
+}  // namespace ControlFlowOptimizations
+
 namespace Or {
 
 class ExpectedResultBase {
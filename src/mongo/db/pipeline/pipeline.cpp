@@ -143,6 +143,14 @@ Status Pipeline::checkAuthForCommand(ClientBasic* client,
         Privilege::addPrivilegeToPrivilegeVector(
             &privileges,
             Privilege(ResourcePattern::forAnyNormalResource(), ActionType::indexStats));
+    } else if (dps::extractElementAtPath(cmdObj, "pipeline.0.$indexAdvisor")) {
+        Privilege::addPrivilegeToPrivilegeVector(
+            &privileges,
+            Privilege(ResourcePattern::forAnyNormalResource(), ActionType::indexStats));
+        ActionSet actions;
+        actions.addAction(ActionType::listIndexes);
+        actions.addAction(ActionType::planCacheRead);
+        Privilege::addPrivilegeToPrivilegeVector(&privileges, Privilege(inputResource, actions));
     } else if (dps::extractElementAtPath(cmdObj, "pipeline.0.$collStats")) {
         Privilege::addPrivilegeToPrivilegeVector(&privileges,
                                                  Privilege(inputResource, ActionType::collStats));
@@ -338,6 +346,24 @@ bool Pipeline::needsPrimaryShardMerger() const {
     return false;
 }
 
+bool Pipeline::canUseDocumentArena() const {
+    for (auto&& source : _sources) {
+        if (!source->canUseDocumentArena()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Pipeline::neverModifiesDocuments() const {
+    for (auto&& source : _sources) {
+        if (!source->neverModifiesDocuments()) {
+            return false;
+        }
+    }
+    return true;
+}
+
 std::vector<NamespaceString> Pipeline::getInvolvedCollections() const {
     std::vector<NamespaceString> collections;
     for (auto&& source : _sources) {
@@ -136,6 +136,19 @@ public:
      */
     bool needsPrimaryShardMerger() const;
 
+    /**
+     * Returns true if every stage lets go of its input promptly, so that the pipeline may allocate
+     * its documents from a DocumentArena. See DocumentSource::canUseDocumentArena().
+     */
+    bool canUseDocumentArena() const;
+
+    /**
+     * Returns true if no stage modifies the documents it receives, so that the documents read by
+     * the pipeline may be returned as the BSON they were read as. See
+     * DocumentSource::neverModifiesDocuments().
+     */
+    bool neverModifiesDocuments() const;
+
     /**
      * Modifies the pipeline, optimizing it by combining and swapping stages.
      */
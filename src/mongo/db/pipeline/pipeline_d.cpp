@@ -36,12 +36,14 @@
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/document_validation.h"
+#include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/exec/fetch.h"
 #include "mongo/db/exec/index_iterator.h"
 #include "mongo/db/exec/multi_iterator.h"
+#include "mongo/db/exec/parallel_collection_scan.h"
 #include "mongo/db/exec/shard_filter.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/index/index_access_method.h"
@@ -51,6 +53,7 @@
 #include "mongo/db/query/collation/collator_interface.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/s/sharded_connection_info.h"
 #include "mongo/db/s/sharding_state.h"
@@ -130,8 +133,49 @@ public:
         return collection->getIndexCatalog()->findIdIndex(_ctx->opCtx);
     }
 
-    void appendLatencyStats(const NamespaceString& nss, BSONObjBuilder* builder) const {
-        Top::get(_ctx->opCtx->getServiceContext()).appendLatencyStats(nss.ns(), builder);
+    void appendLatencyStats(const NamespaceString& nss,
+                            bool includeQueryShapes,
+                            BSONObjBuilder* builder) const {
+        Top::get(_ctx->opCtx->getServiceContext())
+            .appendLatencyStats(nss.ns(), includeQueryShapes, builder);
+    }
+
+    void appendStorageIOStats(const NamespaceString& nss, BSONObjBuilder* builder) const final {
+        AutoGetCollectionForRead autoColl(_ctx->opCtx, nss);
+
+        Collection* collection = autoColl.getCollection();
+        if (!collection) {
+            return;
+        }
+
+        BSONObjBuilder storageIOBuilder(builder->subobjStart("storageIOStats"));
+        collection->getRecordStore()->appendStorageIOStats(_ctx->opCtx, &storageIOBuilder);
+    }
+
+    void appendWriteConflictStats(const NamespaceString& nss,
+                                  BSONObjBuilder* builder) const final {
+        BSONObjBuilder writeConflictBuilder(builder->subobjStart("writeConflictStats"));
+        WriteConflictContentionManager::get(_ctx->opCtx->getServiceContext())
+            .appendStats(nss.ns(), &writeConflictBuilder);
+    }
+
+    BSONObj getIndexStorageIOStats(OperationContext* opCtx, const NamespaceString& ns) final {
+        AutoGetCollectionForRead autoColl(opCtx, ns);
+
+        Collection* collection = autoColl.getCollection();
+        if (!collection) {
+            return BSONObj();
+        }
+
+        BSONObjBuilder builder;
+        IndexCatalog::IndexIterator it =
+            collection->getIndexCatalog()->getIndexIterator(opCtx, false);
+        while (it.more()) {
+            IndexDescriptor* desc = it.next();
+            BSONObjBuilder indexBuilder(builder.subobjStart(desc->indexName()));
+            it.accessMethod(desc)->appendStorageIOStats(opCtx, &indexBuilder);
+        }
+        return builder.obj();
     }
 
 private:
@@ -143,23 +187,52 @@ private:
  * Returns a PlanExecutor which uses a random cursor to sample documents if successful. Returns {}
  * if the storage engine doesn't support random cursors, or if 'sampleSize' is a large enough
  * percentage of the collection.
+ *
+ * If the sample can be drawn from random cursors on several worker threads, the executor returns
+ * no duplicates, and 'sampleIsDistinct' is set to true.
  */
 shared_ptr<PlanExecutor> createRandomCursorExecutor(Collection* collection,
                                                     OperationContext* txn,
                                                     long long sampleSize,
-                                                    long long numRecords) {
-    double kMaxSampleRatioForRandCursor = 0.05;
-    if (sampleSize > numRecords * kMaxSampleRatioForRandCursor || numRecords <= 100)
+                                                    long long numRecords,
+                                                    bool* sampleIsDistinct) {
+    *sampleIsDistinct = false;
+    if (numRecords <= 100) {
         return {};
+    }
 
     // Attempt to get a random cursor from the RecordStore. If the RecordStore does not support
     // random cursors, attempt to get one from the _id index.
     std::unique_ptr<RecordCursor> rsRandCursor = collection->getRecordStore()->getRandomCursor(txn);
 
+    ShardingState* const shardingState = ShardingState::get(txn);
+    const bool needsShardFilter = shardingState->needCollectionMetadata(txn, collection->ns().ns());
+
+    // The parallel sample knows when it is complete, which it can't once orphans are filtered out
+    // above it, and its workers can't yield the locks of a DBDirectClient's caller.
+    const int numSampleWorkers = internalQueryExecParallelSampleThreads.load();
+    const bool sampleInParallel = rsRandCursor && numSampleWorkers > 1 && !needsShardFilter &&
+        !txn->getClient()->isInDirectClient() &&
+        ParallelCollectionScan::canScanInParallel(txn, collection, nullptr);
+
+    const double kMaxSampleRatioForRandCursor = 0.05;
+    const double maxSampleRatio = sampleInParallel
+        ? internalQueryExecParallelSampleMaxSampleRatio.load()
+        : kMaxSampleRatioForRandCursor;
+    if (sampleSize > numRecords * maxSampleRatio) {
+        return {};
+    }
+
     auto ws = stdx::make_unique<WorkingSet>();
     std::unique_ptr<PlanStage> stage;
 
-    if (rsRandCursor) {
+    if (sampleInParallel) {
+        CollectionScanParams params;
+        params.collection = collection;
+        stage = stdx::make_unique<ParallelCollectionScan>(
+            txn, params, ws.get(), nullptr, numSampleWorkers, sampleSize);
+        *sampleIsDistinct = true;
+    } else if (rsRandCursor) {
         stage = stdx::make_unique<MultiIteratorStage>(txn, ws.get(), collection);
         static_cast<MultiIteratorStage*>(stage.get())->addIterator(std::move(rsRandCursor));
 
@@ -190,10 +263,8 @@ shared_ptr<PlanExecutor> createRandomCursorExecutor(Collection* collection,
             txn, ws.get(), idxIterator.release(), nullptr, collection);
     }
 
-    ShardingState* const shardingState = ShardingState::get(txn);
-
     // If we're in a sharded environment, we need to filter out documents we don't own.
-    if (shardingState->needCollectionMetadata(txn, collection->ns().ns())) {
+    if (needsShardFilter) {
         auto shardFilterStage = stdx::make_unique<ShardFilterStage>(
             txn,
             shardingState->getCollectionMetadata(collection->ns().ns()),
@@ -207,14 +278,12 @@ shared_ptr<PlanExecutor> createRandomCursorExecutor(Collection* collection,
         txn, std::move(ws), std::move(stage), collection, PlanExecutor::YIELD_AUTO));
 }
 
-StatusWith<std::unique_ptr<PlanExecutor>> attemptToGetExecutor(
+StatusWith<std::unique_ptr<CanonicalQuery>> canonicalizePipelineQuery(
     OperationContext* txn,
-    Collection* collection,
     const intrusive_ptr<ExpressionContext>& pExpCtx,
     BSONObj queryObj,
     BSONObj projectionObj,
-    BSONObj sortObj,
-    const size_t plannerOpts) {
+    BSONObj sortObj) {
     auto qr = stdx::make_unique<QueryRequest>(pExpCtx->ns);
     qr->setFilter(queryObj);
     qr->setProj(projectionObj);
@@ -231,7 +300,18 @@ StatusWith<std::unique_ptr<PlanExecutor>> attemptToGetExecutor(
 
     const ExtensionsCallbackReal extensionsCallback(pExpCtx->opCtx, &pExpCtx->ns);
 
-    auto cq = CanonicalQuery::canonicalize(txn, std::move(qr), extensionsCallback);
+    return CanonicalQuery::canonicalize(txn, std::move(qr), extensionsCallback);
+}
+
+StatusWith<std::unique_ptr<PlanExecutor>> attemptToGetExecutor(
+    OperationContext* txn,
+    Collection* collection,
+    const intrusive_ptr<ExpressionContext>& pExpCtx,
+    BSONObj queryObj,
+    BSONObj projectionObj,
+    BSONObj sortObj,
+    const size_t plannerOpts) {
+    auto cq = canonicalizePipelineQuery(txn, pExpCtx, queryObj, projectionObj, sortObj);
 
     if (!cq.isOK()) {
         // Return an error instead of uasserting, since there are cases where the combination of
@@ -245,6 +325,55 @@ StatusWith<std::unique_ptr<PlanExecutor>> attemptToGetExecutor(
     return getExecutor(
         txn, collection, std::move(cq.getValue()), PlanExecutor::YIELD_AUTO, plannerOpts);
 }
+
+/**
+ * If the pipeline, once its initial $match has been absorbed, starts with a $group which only
+ * needs one document per group, optionally preceded by a $sort, returns the path of the $group's
+ * _id and sets 'distinctSort' to the order in which the first document of each group is the one
+ * the $group needs. That order starts with the _id path, since the order within each group is
+ * all that matters. Otherwise returns boost::none.
+ */
+boost::optional<std::string> getDistinctScanGroupField(
+    const Pipeline::SourceContainer& sources,
+    const intrusive_ptr<DocumentSourceSort>& sortStage,
+    const BSONObj& sortObj,
+    BSONObj* distinctSort) {
+    if (sortStage && sortStage->getLimitSrc()) {
+        // The $group only sees the documents which make it past the $limit.
+        return boost::none;
+    }
+
+    auto it = sources.begin();
+    if (sortStage) {
+        ++it;
+    }
+    if (it == sources.end()) {
+        return boost::none;
+    }
+    auto groupStage = dynamic_cast<DocumentSourceGroup*>(it->get());
+    std::string idPath;
+    bool usesLast;
+    if (!groupStage || !groupStage->onlyNeedsOneDocumentPerGroup(&idPath, &usesLast)) {
+        return boost::none;
+    }
+
+    // The last document of each group in some order is the first one in the reverse order.
+    const int flip = usesLast ? -1 : 1;
+    BSONObjBuilder sortBuilder;
+    BSONElement idSortElem = sortObj[idPath];
+    sortBuilder.append(idPath, (idSortElem.isNumber() ? idSortElem.numberInt() : 1) * flip);
+    for (auto&& sortElem : sortObj) {
+        if (!sortElem.isNumber()) {
+            // A $meta sort.
+            return boost::none;
+        }
+        if (idPath != sortElem.fieldName()) {
+            sortBuilder.append(sortElem.fieldName(), sortElem.numberInt() * flip);
+        }
+    }
+    *distinctSort = sortBuilder.obj();
+    return idPath;
+}
 }  // namespace
 
 shared_ptr<PlanExecutor> PipelineD::prepareCursorSource(
@@ -278,17 +407,20 @@ shared_ptr<PlanExecutor> PipelineD::prepareCursorSource(
         }
 
         auto sampleStage = dynamic_cast<DocumentSourceSample*>(sources.front().get());
-        // Optimize an initial $sample stage if possible.
-        if (collection && sampleStage) {
+        // Optimize an initial $sample stage if possible. The random records of a time-series
+        // collection would be buckets rather than measurements.
+        if (collection && sampleStage && !collection->getTimeseriesOptions()) {
             const long long sampleSize = sampleStage->getSampleSize();
             const long long numRecords = collection->getRecordStore()->numRecords(txn);
-            auto exec = createRandomCursorExecutor(collection, txn, sampleSize, numRecords);
+            bool sampleIsDistinct;
+            auto exec = createRandomCursorExecutor(
+                collection, txn, sampleSize, numRecords, &sampleIsDistinct);
             if (exec) {
                 // Replace $sample stage with $sampleFromRandomCursor stage.
                 sources.pop_front();
                 std::string idString = collection->ns().isOplog() ? "ts" : "_id";
                 sources.emplace_front(DocumentSourceSampleFromRandomCursor::create(
-                    pExpCtx, sampleSize, idString, numRecords));
+                    pExpCtx, sampleSize, idString, numRecords, !sampleIsDistinct));
 
                 const BSONObj initialQuery;
                 return addCursorSource(
@@ -399,9 +531,53 @@ std::shared_ptr<PlanExecutor> PipelineD::prepareExecutor(
         plannerOpts |= QueryPlannerParams::NO_UNCOVERED_PROJECTIONS;
     }
 
+    // A collection scan feeding the pipeline may be divided between worker threads, unless this
+    // pipeline runs inside a DBDirectClient, whose caller's locks cannot be yielded.
+    if (!txn->getClient()->isInDirectClient()) {
+        plannerOpts |= QueryPlannerParams::PARALLEL_COLLSCAN;
+    }
+
     std::shared_ptr<PlanExecutor> exec;
 
     BSONObj emptyProjection;
+
+    // A $group which only needs one document per group can use a DISTINCT_SCAN, which visits a
+    // single index entry for each distinct value of the _id, rather than every document.
+    BSONObj distinctSort;
+    if (auto groupField =
+            getDistinctScanGroupField(pipeline->_sources, sortStage, *sortObj, &distinctSort)) {
+        auto attemptDistinctScan = [&](const BSONObj& projection) {
+            auto cq =
+                canonicalizePipelineQuery(txn, expCtx, queryObj, projection, distinctSort);
+            if (!cq.isOK()) {
+                return StatusWith<std::unique_ptr<PlanExecutor>>(cq.getStatus());
+            }
+            return getExecutorFirstPerDistinctValue(txn,
+                                                    collection,
+                                                    std::move(cq.getValue()),
+                                                    *groupField,
+                                                    PlanExecutor::YIELD_AUTO,
+                                                    plannerOpts);
+        };
+
+        auto swExecutorDistinct = attemptDistinctScan(*projectionObj);
+        if (!swExecutorDistinct.isOK()) {
+            swExecutorDistinct = attemptDistinctScan(emptyProjection);
+            if (swExecutorDistinct.isOK()) {
+                *projectionObj = BSONObj();
+            }
+        }
+
+        if (swExecutorDistinct.isOK()) {
+            if (sortStage) {
+                // The order within each group is provided by the scan.
+                pipeline->_sources.pop_front();
+            }
+            *sortObj = distinctSort;
+            return std::move(swExecutorDistinct.getValue());
+        }
+    }
+
     if (sortStage) {
         // See if the query system can provide a non-blocking sort.
         auto swExecutorSort = attemptToGetExecutor(
@@ -475,6 +651,11 @@ shared_ptr<PlanExecutor> PipelineD::addCursorSource(const intrusive_ptr<Pipeline
         pSource->shouldProduceEmptyDocs();
     }
 
+    // Documents which reach the client or $out unmodified needn't be serialized again.
+    if (pipeline->neverModifiesDocuments()) {
+        pSource->shouldKeepOriginalBson();
+    }
+
     if (!projectionObj.isEmpty()) {
         pSource->setProjection(projectionObj, boost::none);
     } else {
@@ -30,6 +30,8 @@
 
 #include "mongo/db/pipeline/tee_buffer.h"
 
+#include <algorithm>
+
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
@@ -44,12 +46,12 @@ boost::intrusive_ptr<TeeBuffer> TeeBuffer::create(uint64_t maxMemoryUsageBytes)
 }
 
 TeeBuffer::const_iterator TeeBuffer::begin() const {
-    invariant(_populated);
+    invariant(_populated && !_streaming);
     return _buffer.begin();
 }
 
 TeeBuffer::const_iterator TeeBuffer::end() const {
-    invariant(_populated);
+    invariant(_populated && !_streaming);
     return _buffer.end();
 }
 
@@ -60,6 +62,7 @@ void TeeBuffer::dispose() {
 
 void TeeBuffer::populate() {
     invariant(_source);
+    invariant(!_streaming);
     if (_populated) {
         return;
     }
@@ -75,4 +78,109 @@ void TeeBuffer::populate() {
         _buffer.emplace_back(std::move(*next));
     }
 }
+
+void TeeBuffer::startStreaming(size_t numConsumers, uint64_t maxBufferedBytes) {
+    invariant(!_populated);
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _streaming = true;
+    _maxBufferedBytes = maxBufferedBytes;
+    _consumerPositions.assign(numConsumers, 0);
+}
+
+void TeeBuffer::produce() {
+    invariant(_source);
+    invariant(_streaming);
+
+    auto allConsumersReleased = [&] {
+        return std::all_of(_consumerPositions.begin(),
+                           _consumerPositions.end(),
+                           [](uint64_t position) { return position == kReleasedConsumer; });
+    };
+
+    try {
+        while (auto next = _source->getNext()) {
+            const size_t size = next->getApproximateSize();
+
+            stdx::unique_lock<stdx::mutex> lk(_mutex);
+            _bufferChanged.wait(lk, [&] {
+                return _streamingBuffer.empty() || _bufferedBytes + size <= _maxBufferedBytes ||
+                    allConsumersReleased();
+            });
+            if (allConsumersReleased()) {
+                // Nobody will read any more input.
+                return;
+            }
+
+            _streamingBuffer.emplace_back(std::move(*next), size);
+            _bufferedBytes += size;
+            _bufferChanged.notify_all();
+        }
+    } catch (const DBException& ex) {
+        abortStreaming(ex.toStatus());
+        throw;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _eof = true;
+    _bufferChanged.notify_all();
+}
+
+boost::optional<Document> TeeBuffer::getNextStreamed(size_t consumerId) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    invariant(_streaming);
+    invariant(consumerId < _consumerPositions.size());
+
+    uint64_t& position = _consumerPositions[consumerId];
+    invariant(position != kReleasedConsumer);
+
+    _bufferChanged.wait(lk, [&] {
+        return position < _bufferStartPosition + _streamingBuffer.size() || _eof ||
+            !_producerStatus.isOK();
+    });
+    uassertStatusOK(_producerStatus);
+    if (position == _bufferStartPosition + _streamingBuffer.size()) {
+        invariant(_eof);
+        return boost::none;
+    }
+
+    Document next = _streamingBuffer[position - _bufferStartPosition].first;
+    ++position;
+    _trimStreamingBuffer();
+    return {std::move(next)};
+}
+
+void TeeBuffer::releaseConsumer(size_t consumerId) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    invariant(_streaming);
+    invariant(consumerId < _consumerPositions.size());
+
+    _consumerPositions[consumerId] = kReleasedConsumer;
+    _trimStreamingBuffer();
+    _bufferChanged.notify_all();
+}
+
+void TeeBuffer::abortStreaming(Status status) {
+    invariant(!status.isOK());
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _producerStatus = std::move(status);
+    _bufferChanged.notify_all();
+}
+
+void TeeBuffer::_trimStreamingBuffer() {
+    const uint64_t slowestPosition =
+        *std::min_element(_consumerPositions.begin(), _consumerPositions.end());
+
+    bool trimmed = false;
+    while (!_streamingBuffer.empty() && _bufferStartPosition < slowestPosition) {
+        _bufferedBytes -= _streamingBuffer.front().second;
+        _streamingBuffer.pop_front();
+        ++_bufferStartPosition;
+        trimmed = true;
+    }
+
+    if (trimmed) {
+        // The producer may be waiting for space.
+        _bufferChanged.notify_all();
+    }
+}
 }  // namespace mongo
@@ -30,9 +30,14 @@
 
 #include <boost/intrusive_ptr.hpp>
 #include <boost/optional.hpp>
+#include <deque>
+#include <limits>
 #include <vector>
 
+#include "mongo/base/status.h"
 #include "mongo/db/pipeline/document_source.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
@@ -46,6 +51,10 @@ class Value;
  * do so, it will buffer all incoming documents up to the configured memory limit, then provide
  * access to that buffer via an iterator.
  *
+ * Alternatively, the buffer can stream its input to consumers running on other threads. In that
+ * mode it only holds the documents which have not yet been read by every consumer, and the
+ * producer waits for the slowest consumer once those take up more than a bounded amount of memory.
+ *
  * TODO SERVER-24153: This stage should be able to spill to disk if allowed to and the memory limit
  * has been exceeded.
  */
@@ -54,6 +63,7 @@ public:
     using const_iterator = std::vector<Document>::const_iterator;
 
     static const uint64_t kMaxMemoryUsageBytes = 100 * 1024 * 1024;
+    static const uint64_t kMaxStreamingBufferBytes = 16 * 1024 * 1024;
 
     static boost::intrusive_ptr<TeeBuffer> create(
         uint64_t maxMemoryUsageBytes = kMaxMemoryUsageBytes);
@@ -77,12 +87,78 @@ public:
     const_iterator begin() const;
     const_iterator end() const;
 
+    /**
+     * Switches the buffer to streaming mode for 'numConsumers' consumers, identified by the
+     * numbers 0 to 'numConsumers' - 1. The producer will wait for the consumers whenever the
+     * documents not yet read by all of them take more than 'maxBufferedBytes', unless there is only
+     * a single such document. It is illegal to call populate(), begin() or end() afterwards.
+     */
+    void startStreaming(size_t numConsumers,
+                        uint64_t maxBufferedBytes = kMaxStreamingBufferBytes);
+
+    bool isStreaming() const {
+        return _streaming;
+    }
+
+    /**
+     * Consumes all input from the source and makes it available to the consumers. This must be
+     * called from the thread which owns the operation, since the source may need to read from
+     * storage. Returns early if every consumer has been released. If the source throws, the
+     * consumers are woken up with the error before it is rethrown.
+     */
+    void produce();
+
+    /**
+     * Returns the next document for consumer 'consumerId', waiting for the producer if necessary,
+     * or boost::none once all input has been read. May be called from any thread, but each
+     * consumer must only be used from one thread at a time.
+     */
+    boost::optional<Document> getNextStreamed(size_t consumerId);
+
+    /**
+     * Signals that consumer 'consumerId' will not read any more documents, so that the producer no
+     * longer waits for it and the documents only it had yet to read can be freed.
+     */
+    void releaseConsumer(size_t consumerId);
+
+    /**
+     * Wakes up all consumers with the error 'status' rather than any further input. Used when the
+     * input can no longer be produced.
+     */
+    void abortStreaming(Status status);
+
 private:
     TeeBuffer(uint64_t maxMemoryUsageBytes);
 
+    /**
+     * Frees the documents at the front of '_streamingBuffer' which have been read by every
+     * consumer. Must be called with '_mutex' held.
+     */
+    void _trimStreamingBuffer();
+
     bool _populated = false;
     uint64_t _maxMemoryUsageBytes;
     std::vector<Document> _buffer;
     boost::intrusive_ptr<DocumentSource> _source;
+
+    // The following are only used in streaming mode, and are all guarded by '_mutex'.
+    static const uint64_t kReleasedConsumer = std::numeric_limits<uint64_t>::max();
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _bufferChanged;
+    bool _streaming = false;
+    bool _eof = false;
+    Status _producerStatus = Status::OK();
+    uint64_t _maxBufferedBytes = 0;
+    uint64_t _bufferedBytes = 0;
+
+    // Holds each buffered document along with its approximate size. '_bufferStartPosition' is
+    // the position in the input of the document at the front.
+    std::deque<std::pair<Document, size_t>> _streamingBuffer;
+    uint64_t _bufferStartPosition = 0;
+
+    // The position in the input of the next document each consumer will read, or
+    // kReleasedConsumer once the consumer has been released.
+    std::vector<uint64_t> _consumerPositions;
 };
 }  // namespace mongo
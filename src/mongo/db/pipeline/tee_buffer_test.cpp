@@ -31,6 +31,7 @@
 #include "mongo/db/pipeline/tee_buffer.h"
 
 #include "mongo/db/pipeline/document.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
 
@@ -134,5 +135,76 @@ TEST(TeeBufferTest, ShouldErrorWhenBufferingTooManyDocuments) {
     ASSERT_THROWS(teeBuffer->populate(), UserException);
 }
 
+TEST(TeeBufferTest, ShouldStreamAllDocumentsToEachConsumer) {
+    std::deque<Document> inputs;
+    for (int i = 0; i < 100; ++i) {
+        inputs.push_back(Document{{"a", i}});
+    }
+    auto mock = DocumentSourceMock::create(inputs);
+
+    // Only leave room for a couple of documents, so that the producer has to wait for the
+    // consumers.
+    auto teeBuffer = TeeBuffer::create();
+    teeBuffer->setSource(mock.get());
+    teeBuffer->startStreaming(2, 2 * inputs.front().getApproximateSize());
+
+    std::vector<std::vector<Document>> outputs(2);
+    std::vector<stdx::thread> consumers;
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        consumers.emplace_back([&, i] {
+            while (auto next = teeBuffer->getNextStreamed(i)) {
+                outputs[i].push_back(std::move(*next));
+            }
+        });
+    }
+    teeBuffer->produce();
+    for (auto&& consumer : consumers) {
+        consumer.join();
+    }
+
+    for (auto&& output : outputs) {
+        ASSERT_EQ(output.size(), inputs.size());
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            ASSERT_EQ(output[i], inputs[i]);
+        }
+    }
+}
+
+TEST(TeeBufferTest, ShouldStopProducingOnceAllConsumersAreReleased) {
+    std::deque<Document> inputs = {
+        Document{{"a", 1}}, Document{{"a", 2}}, Document{{"a", 3}}, Document{{"a", 4}}};
+    auto mock = DocumentSourceMock::create(inputs);
+
+    // With room for only one document, the producer can't get more than two documents ahead of
+    // the consumer.
+    auto teeBuffer = TeeBuffer::create();
+    teeBuffer->setSource(mock.get());
+    teeBuffer->startStreaming(1, 1);
+
+    boost::optional<Document> consumed;
+    stdx::thread consumer([&] {
+        consumed = teeBuffer->getNextStreamed(0);
+        teeBuffer->releaseConsumer(0);
+    });
+    teeBuffer->produce();
+    consumer.join();
+
+    ASSERT_TRUE(consumed);
+    ASSERT_EQ(*consumed, inputs.front());
+
+    // The producer should not have read all of the input, since nobody was going to consume it.
+    ASSERT_TRUE(mock->getNext());
+}
+
+TEST(TeeBufferTest, ShouldWakeUpConsumersWithErrorWhenAborted) {
+    auto mock = DocumentSourceMock::create();
+    auto teeBuffer = TeeBuffer::create();
+    teeBuffer->setSource(mock.get());
+    teeBuffer->startStreaming(1);
+
+    teeBuffer->abortStreaming(Status(ErrorCodes::InternalError, "test"));
+    ASSERT_THROWS(teeBuffer->getNextStreamed(0), UserException);
+}
+
 }  // namespace
 }  // namespace mongo
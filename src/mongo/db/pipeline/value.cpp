@@ -803,6 +803,37 @@ int Value::compare(const Value& rL, const Value& rR) {
     verify(false);
 }
 
+bool Value::equal(const Value& lhs, const Value& rhs) {
+    // Values of different types may still be equal, such as numbers or strings and symbols.
+    const BSONType type = lhs.getType();
+    if (type == rhs.getType()) {
+        switch (type) {
+            case Code:
+            case Symbol:
+            case String:
+                return lhs.getStringData() == rhs.getStringData();
+
+            case Array: {
+                const vector<Value>& lArr = lhs.getArray();
+                const vector<Value>& rArr = rhs.getArray();
+                if (lArr.size() != rArr.size()) {
+                    return false;
+                }
+                for (size_t i = 0; i < lArr.size(); i++) {
+                    if (!(lArr[i] == rArr[i])) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            default:
+                break;
+        }
+    }
+    return compare(lhs, rhs) == 0;
+}
+
 void Value::hash_combine(size_t& seed) const {
     BSONType type = getType();
 
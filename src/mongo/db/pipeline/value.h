@@ -208,12 +208,19 @@ public:
      */
     static int compare(const Value& lhs, const Value& rhs);
 
+    /**
+     * Equivalent to compare(lhs, rhs) == 0, but finds strings and arrays of different sizes
+     * unequal without comparing their contents, as happens when probing a hash table of $group
+     * keys.
+     */
+    static bool equal(const Value& lhs, const Value& rhs);
+
     friend bool operator==(const Value& v1, const Value& v2) {
         if (v1._storage.identical(v2._storage)) {
             // Simple case
             return true;
         }
-        return (Value::compare(v1, v2) == 0);
+        return Value::equal(v1, v2);
     }
 
     friend bool operator!=(const Value& v1, const Value& v2) {
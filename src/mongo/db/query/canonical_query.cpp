@@ -308,6 +308,34 @@ bool CanonicalQuery::isSimpleIdQuery(const BSONObj& query) {
     return hasID;
 }
 
+// static
+bool CanonicalQuery::isSimpleEqualityQuery(const BSONObj& query) {
+    bool hasEquality = false;
+
+    BSONObjIterator it(query);
+    while (it.more()) {
+        BSONElement elt = it.next();
+        if (elt.fieldName()[0] == '$') {
+            if (!str::equals("$isolated", elt.fieldName()) &&
+                !str::equals("$atomic", elt.fieldName())) {
+                return false;
+            }
+        } else if (elt.type() == Object) {
+            // A literal object match, not a query operator.
+            if (elt.Obj().firstElementFieldName()[0] == '$') {
+                return false;
+            }
+            hasEquality = true;
+        } else if (elt.type() == RegEx) {
+            return false;
+        } else {
+            hasEquality = true;
+        }
+    }
+
+    return hasEquality;
+}
+
 // static
 MatchExpression* CanonicalQuery::normalizeTree(MatchExpression* root) {
     // root->isLogical() is true now.  We care about AND, OR, and NOT. NOR currently scares us.
@@ -90,6 +90,12 @@ public:
      */
     static bool isSimpleIdQuery(const BSONObj& query);
 
+    /**
+     * Returns true if "query" only compares top-level fields to literal values for equality,
+     * possibly with the $isolated/$atomic modifier.
+     */
+    static bool isSimpleEqualityQuery(const BSONObj& query);
+
     const NamespaceString& nss() const {
         return _qr->nss();
     }
@@ -0,0 +1,80 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "mongo/db/query/collation/collator_interface.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+/**
+ * A CollatorInterface that remembers the comparison keys another collator computed, so that a
+ * string which shows up again and again, such as the value of a low-cardinality field being
+ * sorted on, only goes through the ICU collation once.
+ *
+ * Meant to be owned by a single operation, such as a sort, which generates many comparison keys
+ * over its lifetime. The wrapped collator must outlive this one.
+ */
+class CollatorInterfaceCaching final : public CollatorInterface {
+public:
+    // The cache stops growing once it holds this many strings.
+    static const size_t kMaxCachedStrings = 1024;
+
+    // Longer strings are unlikely to repeat and always use the wrapped collator.
+    static const size_t kMaxCachedStringSize = 256;
+
+    explicit CollatorInterfaceCaching(const CollatorInterface* collator);
+
+    /**
+     * Returns a clone of the wrapped collator, without a cache.
+     */
+    std::unique_ptr<CollatorInterface> clone() const final;
+
+    int compare(StringData left, StringData right) const final;
+
+    ComparisonKey getComparisonKey(StringData stringData) const final;
+
+    /**
+     * Returns the number of strings whose comparison keys are cached.
+     */
+    size_t numCachedStrings() const;
+
+private:
+    const CollatorInterface* const _collator;
+
+    mutable stdx::mutex _mutex;
+
+    // Maps each cached string to its comparison key. Guarded by '_mutex'.
+    mutable StringMap<std::string> _keys;
+};
+
+}  // namespace mongo
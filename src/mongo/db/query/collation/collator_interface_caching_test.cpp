@@ -0,0 +1,76 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collation/collator_interface_caching.h"
+
+#include "mongo/db/query/collation/collator_interface_mock.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+
+TEST(CollatorInterfaceCachingTest, MatchesWrappedCollator) {
+    CollatorInterfaceMock mock(CollatorInterfaceMock::MockType::kReverseString);
+    CollatorInterfaceCaching caching(&mock);
+    ASSERT(caching == mock);
+    ASSERT_LT(caching.compare("abc", "cba"), 0);
+    ASSERT_GT(caching.compare("cba", "abc"), 0);
+    ASSERT_EQ(caching.compare("abc", "abc"), 0);
+
+    // Once from the wrapped collator, once from the cache.
+    for (int i = 0; i < 2; ++i) {
+        ASSERT_EQ(caching.getComparisonKey("abc").getKeyData(), "cba");
+        ASSERT_EQ(caching.getComparisonKey("").getKeyData(), "");
+    }
+    ASSERT_EQ(caching.numCachedStrings(), 2U);
+
+    auto clone = caching.clone();
+    ASSERT(*clone == mock);
+    ASSERT_EQ(clone->getComparisonKey("xyz").getKeyData(), "zyx");
+}
+
+TEST(CollatorInterfaceCachingTest, CacheIsBounded) {
+    CollatorInterfaceMock mock(CollatorInterfaceMock::MockType::kToLowerString);
+    CollatorInterfaceCaching caching(&mock);
+
+    std::string longString(CollatorInterfaceCaching::kMaxCachedStringSize + 1, 'A');
+    ASSERT_EQ(caching.getComparisonKey(longString).getKeyData(),
+              std::string(longString.size(), 'a'));
+    ASSERT_EQ(caching.numCachedStrings(), 0U);
+
+    for (size_t i = 0; i < CollatorInterfaceCaching::kMaxCachedStrings + 10; ++i) {
+        std::string str = "X" + std::to_string(i);
+        ASSERT_EQ(caching.getComparisonKey(str).getKeyData(), "x" + std::to_string(i));
+    }
+    ASSERT_EQ(caching.numCachedStrings(), CollatorInterfaceCaching::kMaxCachedStrings);
+}
+
+}  // namespace
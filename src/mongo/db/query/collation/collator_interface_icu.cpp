@@ -31,13 +31,19 @@
 #include "mongo/db/query/collation/collator_interface_icu.h"
 
 #include <unicode/coll.h>
-#include <unicode/sortkey.h>
 
 #include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
 
 namespace mongo {
 
+namespace {
+
+// The size of the buffer on the stack that comparison keys are first computed in.
+const size_t kSortKeyBufferSize = 256;
+
+}  // namespace
+
 CollatorInterfaceICU::CollatorInterfaceICU(CollationSpec spec,
                                            std::unique_ptr<icu::Collator> collator)
     : CollatorInterface(std::move(spec)), _collator(std::move(collator)) {}
@@ -75,26 +81,34 @@ CollatorInterface::ComparisonKey CollatorInterfaceICU::getComparisonKey(
     StringData stringData) const {
     // A StringPiece is ICU's StringData. They are logically the same abstraction.
     const icu::StringPiece stringPiece(stringData.rawData(), stringData.size());
+    const icu::UnicodeString unicodeString = icu::UnicodeString::fromUTF8(stringPiece);
 
-    UErrorCode status = U_ZERO_ERROR;
-    icu::CollationKey icuKey;
-    _collator->getCollationKey(icu::UnicodeString::fromUTF8(stringPiece), icuKey, status);
+    // Most sort keys fit in a buffer on the stack. Writing them there, rather than into an
+    // icu::CollationKey, saves allocating memory twice per key.
+    uint8_t keyBuffer[kSortKeyBufferSize];
+    int32_t keyLength = _collator->getSortKey(unicodeString, keyBuffer, sizeof(keyBuffer));
 
     // Any sequence of bytes, even invalid UTF-8, has defined comparison behavior in ICU (invalid
-    // subsequences are weighted as the replacement character, U+FFFD). A non-ok error code is only
-    // expected when a memory allocation fails inside ICU, which we consider fatal to the process.
-    fassert(34439, U_SUCCESS(status));
-
-    int32_t keyLength;
-    const uint8_t* keyBuffer = icuKey.getByteArray(keyLength);
-    invariant(keyLength > 0);
-    invariant(keyBuffer);
+    // subsequences are weighted as the replacement character, U+FFFD). A sort key of length zero
+    // is only expected when a memory allocation fails inside ICU, which we consider fatal to the
+    // process.
+    fassert(34439, keyLength > 0);
 
     // The last byte of the sort key should always be null. When we construct the comparison key, we
     // omit the trailing null byte.
-    invariant(keyBuffer[keyLength - 1u] == '\0');
-    const char* charBuffer = reinterpret_cast<const char*>(keyBuffer);
-    return makeComparisonKey(std::string(charBuffer, keyLength - 1u));
+    if (static_cast<size_t>(keyLength) <= sizeof(keyBuffer)) {
+        invariant(keyBuffer[keyLength - 1] == '\0');
+        const char* charBuffer = reinterpret_cast<const char*>(keyBuffer);
+        return makeComparisonKey(std::string(charBuffer, keyLength - 1));
+    }
+
+    std::string key(keyLength, '\0');
+    const int32_t fullKeyLength =
+        _collator->getSortKey(unicodeString, reinterpret_cast<uint8_t*>(&key[0]), keyLength);
+    invariant(fullKeyLength == keyLength);
+    invariant(key.back() == '\0');
+    key.pop_back();
+    return makeComparisonKey(std::move(key));
 }
 
 }  // namespace mongo
@@ -593,4 +593,12 @@ TEST(CollatorInterfaceICUTest, ComparisonKeysForFrCaCollatorCorrect) {
               "\x2D\x45\x4F\x31\x01\x88\x44\x8E\x06\x01\x0A");
 }
 
+TEST(CollatorInterfaceICUTest, LongStringsCompareCorrectlyUsingComparisonKeys) {
+    // The comparison keys of these strings are too long for the buffer they are first computed in.
+    std::string prefix(1000, 'a');
+    assertLessThanEnUS(prefix + "a", prefix + "b");
+    assertLessThanEnUS(prefix + "c\xC3\xB4t\xC3\xA9", prefix + "d");
+    assertEqualEnUS(prefix, prefix);
+}
+
 }  // namespace
@@ -44,6 +44,7 @@
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/plan_yield_policy.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/query/stage_builder.h"
@@ -151,6 +152,10 @@ size_t getDocsExamined(StageType type, const SpecificStats* specific) {
     if (STAGE_COLLSCAN == type) {
         const CollectionScanStats* spec = static_cast<const CollectionScanStats*>(specific);
         return spec->docsTested;
+    } else if (STAGE_PARALLEL_COLLSCAN == type) {
+        const ParallelCollectionScanStats* spec =
+            static_cast<const ParallelCollectionScanStats*>(specific);
+        return spec->docsTested;
     } else if (STAGE_FETCH == type) {
         const FetchStats* spec = static_cast<const FetchStats*>(specific);
         return spec->docsExamined;
@@ -263,6 +268,12 @@ void Explain::statsToBSON(const PlanStageStats& stats,
     if (verbosity >= ExplainCommon::EXEC_STATS) {
         bob->appendNumber("nReturned", stats.common.advanced);
         bob->appendNumber("executionTimeMillisEstimate", stats.common.executionTimeMillis);
+        if (stats.common.detailedStats) {
+            bob->appendNumber("executionTimeNanos", stats.common.executionTimeNanos);
+            bob->appendNumber("cpuTimeNanos", stats.common.cpuTimeNanos);
+            bob->appendNumber("diskBytesRead", stats.common.diskBytesRead);
+            bob->appendNumber("majorPageFaults", stats.common.majorPageFaults);
+        }
         bob->appendNumber("works", stats.common.works);
         bob->appendNumber("advanced", stats.common.advanced);
         bob->appendNumber("needTime", stats.common.needTime);
@@ -283,6 +294,7 @@ void Explain::statsToBSON(const PlanStageStats& stats,
 
             bob->appendNumber("flaggedButPassed", spec->flaggedButPassed);
             bob->appendNumber("flaggedInProgress", spec->flaggedInProgress);
+            bob->appendNumber("bloomFilterRejects", spec->bloomFilterRejects);
             for (size_t i = 0; i < spec->mapAfterChild.size(); ++i) {
                 bob->appendNumber(string(stream() << "mapAfterChild_" << i),
                                   spec->mapAfterChild[i]);
@@ -303,6 +315,18 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainCommon::EXEC_STATS) {
             bob->appendNumber("docsExamined", spec->docsTested);
         }
+    } else if (STAGE_PARALLEL_COLLSCAN == stats.stageType) {
+        ParallelCollectionScanStats* spec =
+            static_cast<ParallelCollectionScanStats*>(stats.specific.get());
+        if (verbosity >= ExplainCommon::EXEC_STATS) {
+            bob->appendNumber("docsExamined", spec->docsTested);
+            bob->appendNumber("workers", spec->workers);
+            if (spec->sampleSize) {
+                bob->appendNumber("sampleSize", spec->sampleSize);
+            } else {
+                bob->appendNumber("ranges", spec->ranges);
+            }
+        }
     } else if (STAGE_COUNT == stats.stageType) {
         CountStats* spec = static_cast<CountStats*>(stats.specific.get());
 
@@ -398,6 +422,10 @@ void Explain::statsToBSON(const PlanStageStats& stats,
             }
             intervalsBob.doneFast();
         }
+
+        if (STAGE_GEO_NEAR_2DSPHERE == stats.stageType && verbosity >= ExplainCommon::EXEC_STATS) {
+            bob->appendBool("usedDensityGrid", spec->usedDensityGrid);
+        }
     } else if (STAGE_GROUP == stats.stageType) {
         GroupStats* spec = static_cast<GroupStats*>(stats.specific.get());
         if (verbosity >= ExplainCommon::EXEC_STATS) {
@@ -467,6 +495,7 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainCommon::EXEC_STATS) {
             bob->appendNumber("memUsage", spec->memUsage);
             bob->appendNumber("memLimit", spec->memLimit);
+            bob->appendNumber("spills", spec->spills);
         }
 
         if (spec->limit > 0) {
@@ -479,6 +508,7 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainCommon::EXEC_STATS) {
             bob->appendNumber("dupsTested", spec->dupsTested);
             bob->appendNumber("dupsDropped", spec->dupsDropped);
+            bob->appendNumber("dedupPrunes", spec->dedupPrunes);
         }
     } else if (STAGE_TEXT == stats.stageType) {
         TextStats* spec = static_cast<TextStats*>(stats.specific.get());
@@ -496,8 +526,22 @@ void Explain::statsToBSON(const PlanStageStats& stats,
     } else if (STAGE_TEXT_OR == stats.stageType) {
         TextOrStats* spec = static_cast<TextOrStats*>(stats.specific.get());
 
+        if (spec->topK) {
+            bob->appendNumber("topK", spec->topK);
+        }
+
         if (verbosity >= ExplainCommon::EXEC_STATS) {
             bob->appendNumber("docsExamined", spec->fetches);
+            if (spec->topK) {
+                bob->appendBool("stoppedEarly", spec->stoppedEarly);
+            }
+        }
+    } else if (STAGE_UNPACK_BUCKET == stats.stageType) {
+        UnpackBucketStats* spec = static_cast<UnpackBucketStats*>(stats.specific.get());
+
+        if (verbosity >= ExplainCommon::EXEC_STATS) {
+            bob->appendNumber("bucketsUnpacked", spec->bucketsUnpacked);
+            bob->appendNumber("measurementsUnpacked", spec->measurementsUnpacked);
         }
     } else if (STAGE_UPDATE == stats.stageType) {
         UpdateStats* spec = static_cast<UpdateStats*>(stats.specific.get());
@@ -742,6 +786,13 @@ void Explain::explainStages(PlanExecutor* exec,
         long long totalTimeMillis = CurOp::get(opCtx)->elapsedMillis();
         generateExecStats(winningStats.get(), verbosity, &execBob, totalTimeMillis);
 
+        const PlanYieldPolicy::YieldStats& yieldStats = exec->getYieldPolicy().getYieldStats();
+        BSONObjBuilder yieldBob(execBob.subobjStart("yieldStats"));
+        yieldBob.appendNumber("numYields", yieldStats.numYields);
+        yieldBob.appendNumber("numSkippedYields", yieldStats.numSkippedYields);
+        yieldBob.appendNumber("yieldTimeMicros", yieldStats.yieldTimeMicros);
+        yieldBob.doneFast();
+
         // Also generate exec stats for all plans, if the verbosity level is high enough.
         // These stats reflect what happened during the trial period that ranked the plans.
         if (verbosity >= ExplainCommon::EXEC_ALL_PLANS) {
@@ -842,6 +893,8 @@ void Explain::getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsO
             const IndexScanStats* ixscanStats =
                 static_cast<const IndexScanStats*>(ixscan->getSpecificStats());
             statsOut->indexesUsed.insert(ixscanStats->indexName);
+            statsOut->indexBoundsShapes[ixscanStats->indexName] =
+                ixscan->getBounds().toShapeBSON();
         } else if (STAGE_COUNT_SCAN == stages[i]->stageType()) {
             const CountScan* countScan = static_cast<const CountScan*>(stages[i]);
             const CountScanStats* countScanStats =
@@ -29,13 +29,18 @@
 #include "mongo/db/query/expression_index.h"
 
 #include <iostream>
+#include <memory>
 
+#include "mongo/bson/util/builder.h"
 #include "mongo/db/geo/geoconstants.h"
 #include "mongo/db/geo/r2_region_coverer.h"
 #include "mongo/db/hasher.h"
 #include "mongo/db/index/expression_params.h"
 #include "mongo/db/query/expression_index_knobs.h"
+#include "mongo/db/query/lru_key_value.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "third_party/s2/s2cellid.h"
 #include "third_party/s2/s2region.h"
 #include "third_party/s2/s2regioncoverer.h"
@@ -45,8 +50,12 @@ namespace mongo {
 using std::set;
 
 BSONObj ExpressionMapping::hash(const BSONElement& value) {
+    return hash(value, BSONElementHasher::DEFAULT_HASH_SEED, kMD5HashVersion);
+}
+
+BSONObj ExpressionMapping::hash(const BSONElement& value, HashSeed seed, int hashVersion) {
     BSONObjBuilder bob;
-    bob.append("", BSONElementHasher::hash64(value, BSONElementHasher::DEFAULT_HASH_SEED));
+    bob.append("", BSONElementHasher::hash64(value, seed, hashVersion));
     return bob.obj();
 }
 
@@ -135,6 +144,95 @@ void ExpressionMapping::cover2dsphere(const S2Region& region,
     S2CellIdsToIntervalsWithParents(cover, indexingParams, oilOut);
 }
 
+namespace {
+
+/**
+ * The index intervals of recently queried 2dsphere geometries. Dashboards tend to send the same
+ * polygons over and over, and covering a complex polygon is far more expensive than copying its
+ * intervals.
+ */
+class S2CoveringCache {
+public:
+    /**
+     * Copies the cached intervals for 'key' into 'oilOut', and returns whether there were any.
+     */
+    bool get(const std::string& key, OrderedIntervalList* oilOut) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        OrderedIntervalList* cached;
+        if (!_entries || !_entries->get(key, &cached).isOK()) {
+            return false;
+        }
+        oilOut->intervals.insert(
+            oilOut->intervals.end(), cached->intervals.begin(), cached->intervals.end());
+        return true;
+    }
+
+    void add(const std::string& key, const OrderedIntervalList& oil, size_t maxSize) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_entries || _maxSize != maxSize) {
+            // The cache size changed, so start over at the new size.
+            _entries = stdx::make_unique<LRUKeyValue<std::string, OrderedIntervalList>>(maxSize);
+            _maxSize = maxSize;
+        }
+        _entries->add(key, new OrderedIntervalList(oil));
+    }
+
+    void clear() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _entries.reset();
+    }
+
+private:
+    stdx::mutex _mutex;
+    size_t _maxSize = 0;
+    std::unique_ptr<LRUKeyValue<std::string, OrderedIntervalList>> _entries;
+};
+
+S2CoveringCache s2CoveringCache;
+
+/**
+ * Returns the cache key for the intervals of 'queryGeometry'. Besides the geometry itself, the
+ * intervals depend on the index's version and coarsest level and on the covering knobs.
+ */
+std::string makeS2CoveringCacheKey(const BSONObj& queryGeometry,
+                                   const S2IndexingParams& indexParams) {
+    StackBufBuilder key;
+    key.appendNum(static_cast<int>(indexParams.indexVersion));
+    key.appendNum(indexParams.coarsestIndexedLevel);
+    key.appendNum(internalQueryS2GeoCoarsestLevel.load());
+    key.appendNum(internalQueryS2GeoFinestLevel.load());
+    key.appendNum(internalQueryS2GeoMaxCells.load());
+    key.appendBuf(queryGeometry.objdata(), queryGeometry.objsize());
+    return std::string(key.buf(), key.len());
+}
+
+}  // namespace
+
+void ExpressionMapping::cover2dsphereCached(const BSONObj& queryGeometry,
+                                            const S2Region& region,
+                                            const S2IndexingParams& indexParams,
+                                            OrderedIntervalList* oilOut) {
+    const int maxSize = internalQueryS2CoveringCacheSize.load();
+    if (maxSize <= 0) {
+        cover2dsphere(region, indexParams, oilOut);
+        return;
+    }
+
+    const std::string key = makeS2CoveringCacheKey(queryGeometry, indexParams);
+    if (s2CoveringCache.get(key, oilOut)) {
+        return;
+    }
+
+    OrderedIntervalList oil;
+    cover2dsphere(region, indexParams, &oil);
+    s2CoveringCache.add(key, oil, maxSize);
+    oilOut->intervals.insert(oilOut->intervals.end(), oil.intervals.begin(), oil.intervals.end());
+}
+
+void ExpressionMapping::clearS2CoveringCache() {
+    s2CoveringCache.clear();
+}
+
 namespace {
 bool compareIntervals(const Interval& a, const Interval& b) {
     return a.precedes(b);
@@ -32,6 +32,7 @@
 
 #include "mongo/db/geo/hash.h"
 #include "mongo/db/geo/shapes.h"
+#include "mongo/db/hasher.h"
 #include "mongo/db/index/s2_common.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds_builder.h"  // For OrderedIntervalList
@@ -50,6 +51,11 @@ class ExpressionMapping {
 public:
     static BSONObj hash(const BSONElement& value);
 
+    /**
+     * Returns the key a hashed index with the given seed and hash version stores for 'value'.
+     */
+    static BSONObj hash(const BSONElement& value, HashSeed seed, int hashVersion);
+
     static std::vector<GeoHash> get2dCovering(const R2Region& region,
                                               const BSONObj& indexInfoObj,
                                               int maxCoveringCells);
@@ -77,6 +83,21 @@ public:
     static void cover2dsphere(const S2Region& region,
                               const S2IndexingParams& indexParams,
                               OrderedIntervalList* oilOut);
+
+    /**
+     * Like cover2dsphere(), but first looks for the intervals in a cache of recent query
+     * geometries. 'queryGeometry' must be the query's own BSON for 'region', such as the
+     * $geoWithin predicate it was parsed from, since it is the cache key.
+     */
+    static void cover2dsphereCached(const BSONObj& queryGeometry,
+                                    const S2Region& region,
+                                    const S2IndexingParams& indexParams,
+                                    OrderedIntervalList* oilOut);
+
+    /**
+     * Empties the cache of intervals that cover2dsphereCached() fills.
+     */
+    static void clearS2CoveringCache();
 };
 
 }  // namespace mongo
@@ -59,4 +59,7 @@ extern std::atomic<int> internalQueryS2GeoCoarsestLevel;  // NOLINT
 // What is the maximum cell count that we want? (advisory, not a hard threshold)
 extern std::atomic<int> internalQueryS2GeoMaxCells;  // NOLINT
 
+// How many query geometries' 2dsphere index intervals do we remember? 0 disables the cache.
+extern std::atomic<int> internalQueryS2CoveringCacheSize;  // NOLINT
+
 }  // namespace mongo
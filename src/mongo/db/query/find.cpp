@@ -49,6 +49,7 @@
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/plan_summary_stats.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner_params.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/collection_sharding_state.h"
@@ -155,7 +156,7 @@ void endQueryOp(OperationContext* txn,
     curOp->debug().setPlanSummaryMetrics(summaryStats);
 
     if (collection) {
-        collection->infoCache()->notifyOfQuery(txn, summaryStats.indexesUsed);
+        collection->infoCache()->notifyOfQuery(txn, summaryStats);
     }
 
     if (curOp->shouldDBProfile(curOp->elapsedMillis())) {
@@ -394,7 +395,9 @@ Message getMore(OperationContext* txn,
 
             // Block waiting for data for up to 1 second.
             Seconds timeout(1);
-            notifier->wait(notifierVersion, timeout);
+            notifier->wait(notifierVersion,
+                           timeout,
+                           Microseconds(internalQueryAwaitDataCoalesceMicros.load()));
             notifier.reset();
 
             // Set expected latency to match wait time. This makes sure the logs aren't spammed
@@ -572,7 +575,12 @@ std::string runQuery(OperationContext* txn,
     // bb is used to hold query results
     // this buffer should contain either requested documents per query or
     // explain information, but not both
-    BufBuilder bb(FindCommon::kInitReplyBufferSize);
+    int replyBufferSize = FindCommon::kInitReplyBufferSize;
+    if (collection) {
+        replyBufferSize =
+            FindCommon::getFirstBatchBufferSize(qr, collection->averageObjectSize(txn));
+    }
+    BufBuilder bb(replyBufferSize);
     bb.skip(sizeof(QueryResult::Value));
 
     // How many results have we obtained from the executor?
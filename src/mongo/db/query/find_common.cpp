@@ -30,6 +30,8 @@
 
 #include "mongo/db/query/find_common.h"
 
+#include <algorithm>
+
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/query/query_request.h"
 #include "mongo/util/assert_util.h"
@@ -58,6 +60,28 @@ bool FindCommon::haveSpaceForNext(const BSONObj& nextDoc, long long numDocs, int
     return (bytesBuffered + nextDoc.objsize()) <= kMaxBytesToReturnToClientAtOnce;
 }
 
+int FindCommon::getFirstBatchBufferSize(const QueryRequest& qr, int averageObjectSize) {
+    // A projection may return much less than each stored document.
+    if (!qr.getProj().isEmpty() || averageObjectSize <= 0) {
+        return kInitReplyBufferSize;
+    }
+
+    long long numDocs = qr.getEffectiveBatchSize().value_or(QueryRequest::kDefaultBatchSize);
+    if (qr.getLimit()) {
+        numDocs = std::min(numDocs, *qr.getLimit());
+    }
+
+    // Leave room for the field name and type of each document in a command response, and for the
+    // reply header and cursor response envelope.
+    const long long kPerDocumentOverhead = 16;
+    const long long kEnvelopeSize = 1024;
+    const long long batchSize =
+        numDocs * (averageObjectSize + kPerDocumentOverhead) + kEnvelopeSize;
+    const long long maxBatchSize = kMaxBytesToReturnToClientAtOnce + kEnvelopeSize;
+    return static_cast<int>(
+        std::max(static_cast<long long>(kInitReplyBufferSize), std::min(batchSize, maxBatchSize)));
+}
+
 BSONObj FindCommon::transformSortSpec(const BSONObj& sortSpec) {
     BSONObjBuilder comparatorBob;
 
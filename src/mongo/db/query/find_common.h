@@ -79,6 +79,16 @@ public:
      */
     static bool haveSpaceForNext(const BSONObj& nextDoc, long long numDocs, int bytesBuffered);
 
+    /**
+     * Returns how many bytes to allocate up front for the first batch of the find described by
+     * 'qr', given the average size of the documents in the collection it reads. Sizing the buffer
+     * for the whole batch avoids growing it several times, copying the documents already in it
+     * each time.
+     *
+     * Returns kInitReplyBufferSize if the size of the batch can't be guessed from the documents.
+     */
+    static int getFirstBatchBufferSize(const QueryRequest& qr, int averageObjectSize);
+
     /**
      * Transforms the raw sort spec into one suitable for use as the ordering specification in
      * BSONObj::woCompare().
@@ -32,12 +32,15 @@
 
 #include "mongo/db/query/get_executor.h"
 
+#include <algorithm>
 #include <limits>
 #include <memory>
 
 #include "mongo/base/error_codes.h"
 #include "mongo/base/parse_number.h"
 #include "mongo/client/dbclientinterface.h"
+#include "mongo/db/client.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/exec/cached_plan.h"
 #include "mongo/db/exec/count.h"
 #include "mongo/db/exec/delete.h"
@@ -55,6 +58,7 @@
 #include "mongo/db/index_names.h"
 #include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
 #include "mongo/db/matcher/extensions_callback_noop.h"
+#include "mongo/db/matcher/expression_algo.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
 #include "mongo/db/ops/update_lifecycle.h"
 #include "mongo/db/query/canonical_query.h"
@@ -65,6 +69,7 @@
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/planner_access.h"
 #include "mongo/db/query/planner_analysis.h"
+#include "mongo/db/query/planner_ixselect.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
@@ -151,6 +156,7 @@ void fillOutPlannerParams(OperationContext* txn,
     AllowedIndices* allowedIndicesRaw;
     PlanCacheKey planCacheKey =
         collection->infoCache()->getPlanCache()->computeKey(*canonicalQuery);
+    CurOp::get(txn)->setQueryShape(planCacheKey);
 
     // Filter index catalog if index filters are specified for query.
     // Also, signal to planner that application hint should be ignored.
@@ -209,6 +215,13 @@ void fillOutPlannerParams(OperationContext* txn,
     if (isMMAPV1()) {
         plannerParams->options |= QueryPlannerParams::SNAPSHOT_USE_ID;
     }
+
+    // A query of a time-series collection reads the measurements held by its buckets, unless it
+    // asked for the buckets themselves.
+    const TimeseriesOptions* timeseries = collection->getTimeseriesOptions();
+    if (timeseries && !canonicalQuery->getQueryRequest().isRawData()) {
+        plannerParams->timeseries = timeseries;
+    }
 }
 
 namespace {
@@ -272,8 +285,9 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
 
     const IndexDescriptor* descriptor = collection->getIndexCatalog()->findIdIndex(opCtx);
 
-    // If we have an _id index we can use an idhack plan.
-    if (descriptor && IDHackStage::supportsQuery(*canonicalQuery)) {
+    // If we have an _id index we can use an idhack plan. The _id of a measurement isn't the _id
+    // of its bucket, however.
+    if (descriptor && !plannerParams.timeseries && IDHackStage::supportsQuery(*canonicalQuery)) {
         LOG(2) << "Using idhack: " << canonicalQuery->toStringShort();
 
         root = make_unique<IDHackStage>(opCtx, collection, canonicalQuery.get(), ws, descriptor);
@@ -366,7 +380,7 @@ StatusWith<PrepareExecutionResult> prepareExecution(OperationContext* opCtx,
         }
     }
 
-    if (internalQueryPlanOrChildrenIndependently &&
+    if (internalQueryPlanOrChildrenIndependently && !plannerParams.timeseries &&
         SubplanStage::canUseSubplanning(*canonicalQuery)) {
         LOG(2) << "Running query as sub-queries: " << canonicalQuery->toStringShort();
 
@@ -502,11 +516,107 @@ bool isOplogTsPred(const mongo::MatchExpression* me) {
     return mongoutils::str::equals(me->path().rawData(), "ts");
 }
 
+/**
+ * Returns true if 'me' is a LT or LTE predicate over the "ts" field. Such predicates bound a
+ * reverse oplog scan.
+ */
+bool isOplogTsUpperBoundPred(const mongo::MatchExpression* me) {
+    if (mongo::MatchExpression::LT != me->matchType() &&
+        mongo::MatchExpression::LTE != me->matchType()) {
+        return false;
+    }
+
+    return mongoutils::str::equals(me->path().rawData(), "ts");
+}
+
 mongo::BSONElement extractOplogTsOptime(const mongo::MatchExpression* me) {
-    invariant(isOplogTsPred(me));
+    invariant(isOplogTsPred(me) || isOplogTsUpperBoundPred(me));
     return static_cast<const mongo::ComparisonMatchExpression*>(me)->getData();
 }
 
+/**
+ * Returns the top-level predicate of 'cq' for which 'isTsPred' returns true, or NULL if there is
+ * none.
+ */
+MatchExpression* findOplogTsPred(const CanonicalQuery& cq,
+                                 bool (*isTsPred)(const mongo::MatchExpression*)) {
+    if (MatchExpression::AND == cq.root()->matchType()) {
+        for (size_t i = 0; i < cq.root()->numChildren(); ++i) {
+            MatchExpression* me = cq.root()->getChild(i);
+            if (isTsPred(me)) {
+                return me;
+            }
+        }
+    } else if (isTsPred(cq.root())) {
+        return cq.root();
+    }
+    return NULL;
+}
+
+/**
+ * Returns the RecordId of the newest oplog entry whose timestamp is at most that of 'tsExpr',
+ * found by a direct seek on the timestamp-encoded RecordIds, or boost::none if the record store
+ * can't seek that way. Returns a null RecordId if every entry is newer.
+ */
+boost::optional<RecordId> seekOplogTs(OperationContext* txn,
+                                      Collection* collection,
+                                      const MatchExpression* tsExpr) {
+    const BSONElement tsElem = extractOplogTsOptime(tsExpr);
+    if (tsElem.type() != bsonTimestamp) {
+        return boost::none;
+    }
+
+    StatusWith<RecordId> goal = oploghack::keyForOptime(tsElem.timestamp());
+    if (!goal.isOK()) {
+        return boost::none;
+    }
+    return collection->getRecordStore()->oplogStartHack(txn, goal.getValue());
+}
+
+/**
+ * Builds an executor for an oplogReplay query sorted by {$natural: -1} with a top-level $lt or
+ * $lte over "ts", which starts its backward scan at the newest entry inside the bound instead of
+ * at the end of the oplog. Returns boost::none if the query or record store don't allow that.
+ */
+boost::optional<unique_ptr<PlanExecutor>> getReverseOplogSeek(OperationContext* txn,
+                                                              Collection* collection,
+                                                              unique_ptr<CanonicalQuery>* cq) {
+    MatchExpression* tsExpr = findOplogTsPred(**cq, isOplogTsUpperBoundPred);
+    if (NULL == tsExpr || (*cq)->getQueryRequest().isTailable()) {
+        return boost::none;
+    }
+
+    boost::optional<RecordId> startLoc = seekOplogTs(txn, collection, tsExpr);
+    if (!startLoc) {
+        return boost::none;
+    }
+
+    LOG(3) << "Using direct oplog seek for a reverse scan";
+
+    unique_ptr<WorkingSet> ws = make_unique<WorkingSet>();
+    unique_ptr<PlanStage> root;
+    if (startLoc->isNull()) {
+        // Every entry is newer than the bound.
+        root = make_unique<EOFStage>(txn);
+    } else {
+        CollectionScanParams params;
+        params.collection = collection;
+        params.start = *startLoc;
+        params.direction = CollectionScanParams::BACKWARD;
+
+        // Going backwards, every entry before the first match is also inside the bound.
+        if ((*cq)->root() == tsExpr) {
+            params.stopApplyingFilterAfterFirstMatch = true;
+        }
+        root = make_unique<CollectionScan>(txn, params, ws.get(), (*cq)->root());
+    }
+
+    auto statusWithPlanExecutor = PlanExecutor::make(
+        txn, std::move(ws), std::move(root), std::move(*cq), collection, PlanExecutor::YIELD_AUTO);
+    invariant(statusWithPlanExecutor.isOK());
+    return std::move(statusWithPlanExecutor.getValue());
+}
+
 StatusWith<unique_ptr<PlanExecutor>> getOplogStartHack(OperationContext* txn,
                                                        Collection* collection,
                                                        unique_ptr<CanonicalQuery> cq) {
@@ -524,41 +634,28 @@ StatusWith<unique_ptr<PlanExecutor>> getOplogStartHack(OperationContext* txn,
         cq->setCollator(collection->getDefaultCollator()->clone());
     }
 
-    // A query can only do oplog start finding if it has a top-level $gt or $gte predicate over
-    // the "ts" field (the operation's timestamp). Find that predicate and pass it to
-    // the OplogStart stage.
-    MatchExpression* tsExpr = NULL;
-    if (MatchExpression::AND == cq->root()->matchType()) {
-        // The query has an AND at the top-level. See if any of the children
-        // of the AND are $gt or $gte predicates over 'ts'.
-        for (size_t i = 0; i < cq->root()->numChildren(); ++i) {
-            MatchExpression* me = cq->root()->getChild(i);
-            if (isOplogTsPred(me)) {
-                tsExpr = me;
-                break;
-            }
+    // A reverse scan seeks to the newest entry within a $lt or $lte over "ts". If it can't, the
+    // regular planner at least returns the entries in the requested order.
+    if (cq->getQueryRequest().getSort().woCompare(BSON("$natural" << -1)) == 0) {
+        auto reverseExec = getReverseOplogSeek(txn, collection, &cq);
+        if (reverseExec) {
+            return std::move(*reverseExec);
         }
-    } else if (isOplogTsPred(cq->root())) {
-        // The root of the tree is a $gt or $gte predicate over 'ts'.
-        tsExpr = cq->root();
+        return getExecutor(txn, collection, std::move(cq), PlanExecutor::YIELD_AUTO);
     }
 
+    // A query can only do oplog start finding if it has a top-level $gt or $gte predicate over
+    // the "ts" field (the operation's timestamp). Find that predicate and pass it to
+    // the OplogStart stage.
+    MatchExpression* tsExpr = findOplogTsPred(*cq, isOplogTsPred);
     if (NULL == tsExpr) {
         return Status(ErrorCodes::OplogOperationUnsupported,
                       "OplogReplay query does not contain top-level "
                       "$gt or $gte over the 'ts' field.");
     }
 
-    boost::optional<RecordId> startLoc = boost::none;
-
     // See if the RecordStore supports the oplogStartHack
-    const BSONElement tsElem = extractOplogTsOptime(tsExpr);
-    if (tsElem.type() == bsonTimestamp) {
-        StatusWith<RecordId> goal = oploghack::keyForOptime(tsElem.timestamp());
-        if (goal.isOK()) {
-            startLoc = collection->getRecordStore()->oplogStartHack(txn, goal.getValue());
-        }
-    }
+    boost::optional<RecordId> startLoc = seekOplogTs(txn, collection, tsExpr);
 
     if (startLoc) {
         LOG(3) << "Using direct oplog seek";
@@ -627,6 +724,12 @@ StatusWith<unique_ptr<PlanExecutor>> getExecutorFind(OperationContext* txn,
     if (ShardingState::get(txn)->needCollectionMetadata(txn, nss.ns())) {
         options |= QueryPlannerParams::INCLUDE_SHARD_FILTER;
     }
+
+    // A DBDirectClient query may run inside locks that cannot be yielded, and a parallel scan
+    // can only wait for its workers while yielded.
+    if (!txn->getClient()->isInDirectClient()) {
+        options |= QueryPlannerParams::PARALLEL_COLLSCAN;
+    }
     return getExecutor(
         txn, collection, std::move(canonicalQuery), PlanExecutor::YIELD_AUTO, options);
 }
@@ -824,6 +927,54 @@ inline void validateUpdate(const char* ns, const BSONObj& updateobj, const BSONO
     }
 }
 
+/**
+ * Returns the index through which the point query 'query' finds the only document it can match,
+ * and sets 'key' to the value to look up: the _id index if the query compares _id to a value, or
+ * else a unique index on a single top-level field the query compares to a value which can only
+ * be one document's key. Returns nullptr if there is no such index, or if the collection or the
+ * index compares strings with a collation.
+ */
+const IndexDescriptor* getPointQueryIndex(OperationContext* txn,
+                                          const Collection* collection,
+                                          const BSONObj& query,
+                                          BSONObj* key) {
+    if (collection->getDefaultCollator()) {
+        return nullptr;
+    }
+
+    const IndexCatalog* catalog = collection->getIndexCatalog();
+    BSONElement idElt = query["_id"];
+    if (!idElt.eoo() && idElt.type() != Array) {
+        const IndexDescriptor* descriptor = catalog->findIdIndex(txn);
+        if (descriptor) {
+            *key = idElt.wrap();
+            return descriptor;
+        }
+    }
+
+    IndexCatalog::IndexIterator it = catalog->getIndexIterator(txn, false);
+    while (it.more()) {
+        const IndexDescriptor* descriptor = it.next();
+        if (!descriptor->unique() || descriptor->isPartial() ||
+            descriptor->getAccessMethodName() != IndexNames::BTREE ||
+            descriptor->keyPattern().nFields() != 1 ||
+            catalog->getEntry(descriptor)->getCollator()) {
+            continue;
+        }
+
+        // Documents without the field, and the elements of arrays, are also keys of the index.
+        BSONElement elt = query[descriptor->keyPattern().firstElementFieldName()];
+        if (elt.eoo() || elt.isNull() || elt.type() == Undefined || elt.type() == Array ||
+            elt.type() == MinKey || elt.type() == MaxKey) {
+            continue;
+        }
+
+        *key = elt.wrap();
+        return descriptor;
+    }
+    return nullptr;
+}
+
 }  // namespace
 
 StatusWith<unique_ptr<PlanExecutor>> getExecutorUpdate(OperationContext* txn,
@@ -908,6 +1059,26 @@ StatusWith<unique_ptr<PlanExecutor>> getExecutorUpdate(OperationContext* txn,
             return PlanExecutor::make(txn, std::move(ws), std::move(root), collection, policy);
         }
 
+        BSONObj key;
+        const IndexDescriptor* pointQueryIndex = parsedUpdate->getPointQueryFilter()
+            ? getPointQueryIndex(txn, collection, unparsedQuery, &key)
+            : nullptr;
+        if (pointQueryIndex && request->getProj().isEmpty()) {
+            LOG(2) << "Using idhack with index " << pointQueryIndex->indexName()
+                   << " for point update: " << unparsedQuery.toString();
+
+            updateStageParams.filter = parsedUpdate->getPointQueryFilter();
+            PlanStage* idHackStage = new IDHackStage(txn,
+                                                     collection,
+                                                     key,
+                                                     ws.get(),
+                                                     pointQueryIndex,
+                                                     parsedUpdate->getPointQueryFilter());
+            unique_ptr<UpdateStage> root =
+                make_unique<UpdateStage>(txn, updateStageParams, ws.get(), collection, idHackStage);
+            return PlanExecutor::make(txn, std::move(ws), std::move(root), collection, policy);
+        }
+
         // If we're here then we don't have a parsed query, but we're also not eligible for
         // the idhack fast path. We need to force canonicalization now.
         Status cqStatus = parsedUpdate->parseQueryToCQ();
@@ -1139,6 +1310,86 @@ bool getDistinctNodeIndex(const std::vector<IndexEntry>& indices,
     return minFields != std::numeric_limits<int>::max();
 }
 
+/**
+ * Returns true if the bounds of a scan over 'index' can apply the whole predicate of 'query' on
+ * their own, so that a DistinctNode over those bounds needs no filter. This lets a distinct over
+ * the first field of a compound index use predicates on its other fields, which the planner only
+ * considers when the first field is also constrained. Sets 'boundsOut' to the bounds.
+ */
+bool getDistinctNodeBounds(const IndexEntry& index,
+                           const CanonicalQuery& query,
+                           IndexBounds* boundsOut) {
+    if (INDEX_BTREE != index.type || index.multikey || index.sparse || index.filterExpr ||
+        !CollatorInterface::collatorsMatch(index.collator, query.getCollator())) {
+        return false;
+    }
+
+    MatchExpression* root = query.root();
+    const bool isAnd = MatchExpression::AND == root->matchType();
+    const size_t numPreds = isAnd ? root->numChildren() : 1;
+
+    IndexBounds bounds;
+    std::vector<bool> bounded;
+    for (auto&& elt : index.keyPattern) {
+        bounds.fields.push_back(OrderedIntervalList(elt.fieldName()));
+        bounded.push_back(false);
+    }
+
+    for (size_t i = 0; i < numPreds; ++i) {
+        MatchExpression* pred = isAnd ? root->getChild(i) : root;
+        switch (pred->matchType()) {
+            case MatchExpression::EQ:
+            case MatchExpression::LT:
+            case MatchExpression::LTE:
+            case MatchExpression::GT:
+            case MatchExpression::GTE:
+            case MatchExpression::MATCH_IN:
+                break;
+            default:
+                return false;
+        }
+
+        size_t fieldNo = 0;
+        BSONObjIterator it(index.keyPattern);
+        BSONElement elt;
+        while (it.more()) {
+            elt = it.next();
+            if (pred->path() == elt.fieldNameStringData()) {
+                break;
+            }
+            ++fieldNo;
+        }
+        if (fieldNo == bounds.fields.size() ||
+            !QueryPlannerIXSelect::compatible(elt, index, pred, query.getCollator())) {
+            return false;
+        }
+
+        IndexBoundsBuilder::BoundsTightness tightness;
+        OrderedIntervalList* oil = &bounds.fields[fieldNo];
+        if (bounded[fieldNo]) {
+            IndexBoundsBuilder::translateAndIntersect(pred, elt, index, oil, &tightness);
+        } else {
+            IndexBoundsBuilder::translate(pred, elt, index, oil, &tightness);
+            bounded[fieldNo] = true;
+        }
+        if (IndexBoundsBuilder::EXACT != tightness) {
+            return false;
+        }
+    }
+
+    size_t fieldNo = 0;
+    for (auto&& elt : index.keyPattern) {
+        if (!bounded[fieldNo]) {
+            IndexBoundsBuilder::allValuesForField(elt, &bounds.fields[fieldNo]);
+        }
+        ++fieldNo;
+    }
+    IndexBoundsBuilder::alignBounds(&bounds, index.keyPattern);
+
+    *boundsOut = std::move(bounds);
+    return true;
+}
+
 /**
  * Checks dotted field for a projection and truncates the
  * field name if we could be projecting on an array element.
@@ -1249,10 +1500,12 @@ StatusWith<unique_ptr<PlanExecutor>> getExecutorCount(OperationContext* txn,
     // for its number of records. This is implemented by the CountStage, and we don't need
     // to create a child for the count stage in this case.
     //
-    // If there is a hint, then we can't use a trival count plan as described above.
+    // If there is a hint, then we can't use a trival count plan as described above. Nor can we
+    // for a time-series collection, whose records are buckets of measurements.
     const bool isEmptyQueryPredicate =
         cq->root()->matchType() == MatchExpression::AND && cq->root()->numChildren() == 0;
-    const bool useRecordStoreCount = isEmptyQueryPredicate && request.getHint().isEmpty();
+    const bool useRecordStoreCount = isEmptyQueryPredicate && request.getHint().isEmpty() &&
+        !collection->getTimeseriesOptions();
     CountStageParams params(request, useRecordStoreCount);
 
     if (useRecordStoreCount) {
@@ -1291,53 +1544,224 @@ StatusWith<unique_ptr<PlanExecutor>> getExecutorCount(OperationContext* txn,
 // Distinct hack
 //
 
+namespace {
+
+/**
+ * Returns true if 'filter' only depends on fields of the scanned index which are never arrays, so
+ * that it has the same outcome for every key the index holds for a document.
+ */
+bool filterIsIndependentOfArrays(const MatchExpression& filter, const IndexScanNode& isn) {
+    if (!isn.indexIsMultiKey) {
+        return true;
+    }
+
+    // Without path-level multikey information any field may be an array.
+    if (isn.indexMultikeyPaths.empty()) {
+        return false;
+    }
+
+    std::set<std::string> arrayFields;
+    size_t i = 0;
+    for (auto&& elt : isn.indexKeyPattern) {
+        if (!isn.indexMultikeyPaths[i++].empty()) {
+            arrayFields.insert(elt.fieldName());
+        }
+    }
+    return expression::isIndependentOf(filter, arrayFields);
+}
+
+}  // namespace
+
 bool turnIxscanIntoDistinctIxscan(QuerySolution* soln, const string& field) {
     QuerySolutionNode* root = soln->root.get();
 
-    // We're looking for a project on top of an ixscan.
-    if (STAGE_PROJECTION == root->getType() && (STAGE_IXSCAN == root->children[0]->getType())) {
-        IndexScanNode* isn = static_cast<IndexScanNode*>(root->children[0]);
+    // We're looking for a project on top of an ixscan, possibly with a fetch in between.
+    if (STAGE_PROJECTION != root->getType()) {
+        return false;
+    }
+
+    QuerySolutionNode* parent = root;
+    if (STAGE_FETCH == parent->children[0]->getType()) {
+        parent = parent->children[0];
 
-        // An additional filter must be applied to the data in the key, so we can't just skip
-        // all the keys with a given value; we must examine every one to find the one that (may)
-        // pass the filter.
-        if (NULL != isn->filter.get()) {
+        // The distinct scan only hands the fetch the first document it finds for each value. If
+        // the fetch could drop it we'd lose the value even though other documents may have it.
+        if (NULL != parent->filter.get()) {
             return false;
         }
+    }
 
-        // We only set this when we have special query modifiers (.max() or .min()) or other
-        // special cases.  Don't want to handle the interactions between those and distinct.
-        // Don't think this will ever really be true but if it somehow is, just ignore this
-        // soln.
-        if (isn->bounds.isSimpleRange) {
-            return false;
+    if (STAGE_IXSCAN != parent->children[0]->getType()) {
+        return false;
+    }
+
+    IndexScanNode* isn = static_cast<IndexScanNode*>(parent->children[0]);
+
+    // An additional filter over the data in the key is applied by the distinct scan itself, which
+    // examines keys one at a time until one passes and only then skips to the next value. This
+    // is only correct if a document's keys all agree on the filter.
+    if (NULL != isn->filter.get() && !filterIsIndependentOfArrays(*isn->filter, *isn)) {
+        return false;
+    }
+
+    // We only set this when we have special query modifiers (.max() or .min()) or other
+    // special cases.  Don't want to handle the interactions between those and distinct.
+    // Don't think this will ever really be true but if it somehow is, just ignore this
+    // soln.
+    if (isn->bounds.isSimpleRange) {
+        return false;
+    }
+
+    // Make a new DistinctNode.  We swap this for the ixscan in the provided solution.
+    DistinctNode* dn = new DistinctNode();
+    dn->indexKeyPattern = isn->indexKeyPattern;
+    dn->direction = isn->direction;
+    dn->bounds = isn->bounds;
+    dn->filter = std::move(isn->filter);
+
+    // A document fetched from a multikey index holds every value of its array, all of which the
+    // distinct command collects, so the scan needn't return it again for its other values.
+    dn->dedup = (parent != root) && isn->indexIsMultiKey;
+
+    // Figure out which field we're skipping to the next value of.  TODO: We currently only
+    // try to distinct-hack when there is an index prefixed by the field we're distinct-ing
+    // over.  Consider removing this code if we stick with that policy.
+    dn->fieldNo = 0;
+    BSONObjIterator it(isn->indexKeyPattern);
+    while (it.more()) {
+        if (field == it.next().fieldName()) {
+            break;
         }
+        dn->fieldNo++;
+    }
 
-        // Make a new DistinctNode.  We swap this for the ixscan in the provided solution.
-        DistinctNode* dn = new DistinctNode();
-        dn->indexKeyPattern = isn->indexKeyPattern;
-        dn->direction = isn->direction;
-        dn->bounds = isn->bounds;
+    // Delete the old index scan, set the child of its parent to the fast distinct scan.
+    delete parent->children[0];
+    parent->children[0] = dn;
+    return true;
+}
 
-        // Figure out which field we're skipping to the next value of.  TODO: We currently only
-        // try to distinct-hack when there is an index prefixed by the field we're distinct-ing
-        // over.  Consider removing this code if we stick with that policy.
-        dn->fieldNo = 0;
-        BSONObjIterator it(isn->indexKeyPattern);
-        while (it.more()) {
-            if (field == it.next().fieldName()) {
-                break;
-            }
-            dn->fieldNo++;
+namespace {
+
+/**
+ * Replaces the index scan at the bottom of 'soln' with a DISTINCT_SCAN which only returns the
+ * first key in the scan's order for each value of the index's first field. This is only correct if
+ * nothing above the scan could drop the document of that key, so the only stages allowed between
+ * the root and the scan are projections and fetches without filters.
+ */
+bool turnIxscanIntoDistinctScanOnFirstField(QuerySolution* soln) {
+    QuerySolutionNode* parent = nullptr;
+    QuerySolutionNode* node = soln->root.get();
+    while (STAGE_IXSCAN != node->getType()) {
+        if ((STAGE_PROJECTION != node->getType() && STAGE_FETCH != node->getType()) ||
+            node->filter || node->children.size() != 1) {
+            return false;
         }
+        parent = node;
+        node = node->children[0];
+    }
 
-        // Delete the old index scan, set the child of project to the fast distinct scan.
-        delete root->children[0];
-        root->children[0] = dn;
-        return true;
+    IndexScanNode* isn = static_cast<IndexScanNode*>(node);
+    if (isn->filter || isn->bounds.isSimpleRange) {
+        return false;
     }
 
-    return false;
+    auto dn = make_unique<DistinctNode>();
+    dn->indexKeyPattern = isn->indexKeyPattern;
+    dn->direction = isn->direction;
+    dn->bounds = isn->bounds;
+    dn->fieldNo = 0;
+
+    if (parent) {
+        delete parent->children[0];
+        parent->children[0] = dn.release();
+    } else {
+        soln->root.reset(dn.release());
+    }
+    return true;
+}
+
+}  // namespace
+
+StatusWith<unique_ptr<PlanExecutor>> getExecutorFirstPerDistinctValue(
+    OperationContext* txn,
+    Collection* collection,
+    unique_ptr<CanonicalQuery> canonicalQuery,
+    const std::string& field,
+    PlanExecutor::YieldPolicy yieldPolicy,
+    size_t plannerOptions) {
+    if (!collection) {
+        return Status(ErrorCodes::NamespaceNotFound, "no collection to run a DISTINCT_SCAN over");
+    }
+
+    // A collation would make the scan skip over strings which only compare equal under it.
+    if (canonicalQuery->getCollator()) {
+        return Status(ErrorCodes::BadValue,
+                      "a DISTINCT_SCAN can't be used for a query with a collation");
+    }
+
+    // The indexes of a time-series collection hold the keys of its buckets, not of measurements.
+    if (collection->getTimeseriesOptions() && !canonicalQuery->getQueryRequest().isRawData()) {
+        return Status(ErrorCodes::BadValue,
+                      "a DISTINCT_SCAN can't be used for a query of a time-series collection");
+    }
+
+    QueryPlannerParams plannerParams;
+    plannerParams.options =
+        plannerOptions | QueryPlannerParams::NO_TABLE_SCAN | QueryPlannerParams::NO_BLOCKING_SORT;
+    fillOutPlannerParams(txn, collection, canonicalQuery.get(), &plannerParams);
+
+    // Only consider indexes which hold exactly one key for 'field' for every document and can
+    // skip from one value of it to the next.
+    auto& indices = plannerParams.indices;
+    indices.erase(std::remove_if(indices.begin(),
+                                 indices.end(),
+                                 [&](const IndexEntry& index) {
+                                     return index.type != INDEX_BTREE || index.multikey ||
+                                         index.sparse || index.filterExpr || index.collator ||
+                                         field != index.keyPattern.firstElementFieldName();
+                                 }),
+                  indices.end());
+    if (indices.empty()) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "no index can provide a DISTINCT_SCAN on " << field);
+    }
+
+    vector<QuerySolution*> solutions;
+    Status status = QueryPlanner::plan(*canonicalQuery, plannerParams, &solutions);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    unique_ptr<QuerySolution> distinctSolution;
+    for (size_t i = 0; i < solutions.size(); ++i) {
+        unique_ptr<QuerySolution> solution(solutions[i]);
+        if (!distinctSolution && turnIxscanIntoDistinctScanOnFirstField(solution.get())) {
+            distinctSolution = std::move(solution);
+        }
+    }
+    if (!distinctSolution) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "no plan can use a DISTINCT_SCAN on " << field);
+    }
+
+    unique_ptr<WorkingSet> ws = make_unique<WorkingSet>();
+    PlanStage* rawRoot;
+    verify(StageBuilder::build(
+        txn, collection, *canonicalQuery, *distinctSolution, ws.get(), &rawRoot));
+    unique_ptr<PlanStage> root(rawRoot);
+
+    LOG(2) << "Using DISTINCT_SCAN for the first document per value of " << field << ": "
+           << canonicalQuery->toStringShort()
+           << ", planSummary: " << Explain::getPlanSummary(root.get());
+
+    return PlanExecutor::make(txn,
+                              std::move(ws),
+                              std::move(root),
+                              std::move(distinctSolution),
+                              std::move(canonicalQuery),
+                              collection,
+                              yieldPolicy);
 }
 
 StatusWith<unique_ptr<PlanExecutor>> getExecutorDistinct(OperationContext* txn,
@@ -1355,13 +1779,20 @@ StatusWith<unique_ptr<PlanExecutor>> getExecutorDistinct(OperationContext* txn,
                                   yieldPolicy);
     }
 
+    // The measurements of a time-series collection are only read by unpacking its buckets.
+    if (collection->getTimeseriesOptions() &&
+        !parsedDistinct->getQuery()->getQueryRequest().isRawData()) {
+        return getExecutor(txn, collection, parsedDistinct->releaseQuery(), yieldPolicy);
+    }
+
     // TODO: check for idhack here?
 
     // When can we do a fast distinct hack?
     // 1. There is a plan with just one leaf and that leaf is an ixscan.
     // 2. The ixscan indexes the field we're interested in.
     // 2a: We are correct if the index contains the field but for now we look for prefix.
-    // 3. The query is covered/no fetch.
+    // 3. Nothing above the ixscan can drop a document: the query is covered, or the fetch has
+    //    no filter. A filter over the index keys is fine; the distinct scan applies it.
     //
     // We go through normal planning (with limited parameters) to see if we can produce
     // a soln with the above properties.
@@ -1426,15 +1857,39 @@ StatusWith<unique_ptr<PlanExecutor>> getExecutorDistinct(OperationContext* txn,
     // Not every index in plannerParams.indices may be suitable. Refer to
     // getDistinctNodeIndex().
     size_t distinctNodeIndex = 0;
-    if (parsedDistinct->getQuery()->getQueryRequest().getFilter().isEmpty() &&
-        getDistinctNodeIndex(plannerParams.indices,
-                             parsedDistinct->getKey(),
-                             cq->getCollator(),
-                             &distinctNodeIndex)) {
+    IndexBounds distinctNodeBounds;
+    bool useDistinctNode = false;
+    if (parsedDistinct->getQuery()->getQueryRequest().getFilter().isEmpty()) {
+        if (getDistinctNodeIndex(plannerParams.indices,
+                                 parsedDistinct->getKey(),
+                                 cq->getCollator(),
+                                 &distinctNodeIndex)) {
+            IndexBoundsBuilder::allValuesBounds(plannerParams.indices[distinctNodeIndex].keyPattern,
+                                                &distinctNodeBounds);
+            useDistinctNode = true;
+        }
+    } else {
+        // Otherwise we may still be able to distinct-scan an index whose bounds alone express the
+        // query. Pick the one with the fewest fields.
+        int minFields = std::numeric_limits<int>::max();
+        for (size_t i = 0; i < plannerParams.indices.size(); ++i) {
+            const int nFields = plannerParams.indices[i].keyPattern.nFields();
+            IndexBounds bounds;
+            if (nFields < minFields &&
+                getDistinctNodeBounds(plannerParams.indices[i], *cq, &bounds)) {
+                minFields = nFields;
+                distinctNodeIndex = i;
+                distinctNodeBounds = std::move(bounds);
+                useDistinctNode = true;
+            }
+        }
+    }
+
+    if (useDistinctNode) {
         auto dn = stdx::make_unique<DistinctNode>();
         dn->indexKeyPattern = plannerParams.indices[distinctNodeIndex].keyPattern;
         dn->direction = 1;
-        IndexBoundsBuilder::allValuesBounds(dn->indexKeyPattern, &dn->bounds);
+        dn->bounds = std::move(distinctNodeBounds);
         dn->fieldNo = 0;
 
         // An index with a non-simple collation requires a FETCH stage.
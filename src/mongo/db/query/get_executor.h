@@ -95,7 +95,9 @@ StatusWith<std::unique_ptr<PlanExecutor>> getExecutorFind(
 
 /**
  * If possible, turn the provided QuerySolution into a QuerySolution that uses a DistinctNode
- * to provide results for the distinct command.
+ * to provide results for the distinct command. The index scan may sit below a fetch without a
+ * filter, and may carry a filter over its key data as long as every key of a document agrees on
+ * it.
  *
  * If the provided solution could be mutated successfully, returns true, otherwise returns
  * false.
@@ -116,6 +118,23 @@ StatusWith<std::unique_ptr<PlanExecutor>> getExecutorDistinct(
     ParsedDistinct* parsedDistinct,
     PlanExecutor::YieldPolicy yieldPolicy);
 
+/**
+ * Get an executor which, for each distinct value of 'field', only returns the first document
+ * matching 'canonicalQuery' in the order of its sort, which must start with 'field'. This is used
+ * for the input of a $group on 'field' which only takes the first document of each group.
+ *
+ * The plan must use a DISTINCT_SCAN over an index whose first field is 'field', so that it
+ * visits a single index entry per distinct value. If no such plan exists, returns an error
+ * status rather than falling back to another plan.
+ */
+StatusWith<std::unique_ptr<PlanExecutor>> getExecutorFirstPerDistinctValue(
+    OperationContext* txn,
+    Collection* collection,
+    std::unique_ptr<CanonicalQuery> canonicalQuery,
+    const std::string& field,
+    PlanExecutor::YieldPolicy yieldPolicy,
+    size_t plannerOptions);
+
 /*
  * Get a PlanExecutor for a query executing as part of a count command.
  *
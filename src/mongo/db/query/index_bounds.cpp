@@ -263,6 +263,34 @@ BSONObj IndexBounds::toBSON() const {
     return bob.obj();
 }
 
+BSONObj IndexBounds::toShapeBSON() const {
+    BSONObjBuilder bob;
+    if (isSimpleRange) {
+        bob.append("$simpleRange", true);
+        return bob.obj();
+    }
+
+    for (const auto& field : fields) {
+        const auto& intervals = field.intervals;
+        bool allPoints = !intervals.empty();
+        for (const auto& interval : intervals) {
+            allPoints = allPoints && interval.isPoint();
+        }
+        if (allPoints) {
+            bob.append(field.name, "point");
+            continue;
+        }
+
+        // Either direction of [MinKey, MaxKey] leaves the field unconstrained.
+        const bool unconstrained = intervals.size() == 1U && intervals[0].startInclusive &&
+            intervals[0].endInclusive &&
+            ((intervals[0].start.type() == MinKey && intervals[0].end.type() == MaxKey) ||
+             (intervals[0].start.type() == MaxKey && intervals[0].end.type() == MinKey));
+        bob.append(field.name, unconstrained ? "all" : "range");
+    }
+    return bob.obj();
+}
+
 //
 // Validity checking for bounds
 //
@@ -110,6 +110,17 @@ struct IndexBounds {
      */
     BSONObj toBSON() const;
 
+    /**
+     * Summarizes which kind of interval list each field has, without the values, so that the
+     * bounds of many queries with the same shape compare equal. Each field is "point" if all its
+     * intervals are points, "all" if it is unconstrained, and "range" otherwise.
+     *
+     * Ex.
+     *  {a: ["[1, 1]", "[3, 3]"], b: ["(3, 10)"], c: ["[MinKey, MaxKey]"]} gives
+     *  {a: "point", b: "range", c: "all"}
+     */
+    BSONObj toShapeBSON() const;
+
     // TODO: we use this for max/min scan.  Consider migrating that.
     bool isSimpleRange;
     BSONObj startKey;
@@ -71,6 +71,18 @@ IndexBoundsBuilder::BoundsTightness getInequalityPredicateTightness(const BSONEl
     return IndexBoundsBuilder::INEXACT_FETCH;
 }
 
+// Returns true if the field 'elt' of the key pattern of 'index' may hold array elements.
+bool isMultikeyField(const IndexEntry& index, const BSONElement& elt) {
+    size_t pos = 0;
+    for (auto&& keyElt : index.keyPattern) {
+        if (keyElt.fieldNameStringData() == elt.fieldNameStringData()) {
+            return index.isMultikeyField(pos);
+        }
+        ++pos;
+    }
+    return index.multikey;
+}
+
 }  // namespace
 
 string IndexBoundsBuilder::simpleRegex(const char* regex,
@@ -326,7 +338,7 @@ void IndexBoundsBuilder::translate(const MatchExpression* expr,
         translate(child, elt, index, oilOut, tightnessOut);
         oilOut->complement();
 
-        // If the index is multikey, it doesn't matter what the tightness of the child is, we must
+        // If the field is multikey, it doesn't matter what the tightness of the child is, we must
         // return INEXACT_FETCH. Consider a multikey index on 'a' with document {a: [1, 2, 3]} and
         // query {a: {$ne: 3}}.  If we treated the bounds [MinKey, 3), (3, MaxKey] as exact, then we
         // would erroneously return the document!
@@ -338,7 +350,7 @@ void IndexBoundsBuilder::translate(const MatchExpression* expr,
         //
         // TODO SERVER-23093: Although it is necessary to fetch the keyed documents, it is not
         // necessary to reapply the filter.
-        if (index.multikey || index.collator) {
+        if (isMultikeyField(index, elt) || index.collator) {
             *tightnessOut = INEXACT_FETCH;
         }
     } else if (MatchExpression::EXISTS == expr->matchType()) {
@@ -557,11 +569,18 @@ void IndexBoundsBuilder::translate(const MatchExpression* expr,
         // Create our various intervals.
 
         IndexBoundsBuilder::BoundsTightness tightness;
-        for (auto&& equality : ime->getEqualities()) {
-            translateEquality(equality, index, isHashed, oilOut, &tightness);
+        if (isHashed) {
+            translateHashedEqualities(ime->getEqualities(), index, oilOut, &tightness);
             if (tightness != IndexBoundsBuilder::EXACT) {
                 *tightnessOut = tightness;
             }
+        } else {
+            for (auto&& equality : ime->getEqualities()) {
+                translateEquality(equality, index, isHashed, oilOut, &tightness);
+                if (tightness != IndexBoundsBuilder::EXACT) {
+                    *tightnessOut = tightness;
+                }
+            }
         }
 
         for (auto&& regex : ime->getRegexes()) {
@@ -595,7 +614,13 @@ void IndexBoundsBuilder::translate(const MatchExpression* expr,
             const S2Region& region = gme->getGeoExpression().getGeometry().getS2Region();
             S2IndexingParams indexParams;
             ExpressionParams::initialize2dsphereParams(index.infoObj, index.collator, &indexParams);
-            ExpressionMapping::cover2dsphere(region, indexParams, oilOut);
+            if (gme->getGeoExpression().getGeometry().isPoint()) {
+                // Points are cheap to cover and would crowd the polygons out of the cache.
+                ExpressionMapping::cover2dsphere(region, indexParams, oilOut);
+            } else {
+                ExpressionMapping::cover2dsphereCached(
+                    gme->getRawObj(), region, indexParams, oilOut);
+            }
             *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
         } else if (mongoutils::str::equals("2d", elt.valuestrsafe())) {
             verify(gme->getGeoExpression().getGeometry().hasR2Region());
@@ -824,7 +849,10 @@ void IndexBoundsBuilder::translateEquality(const BSONElement& data,
     if (Array != data.type()) {
         BSONObj dataObj = objFromElement(data, index.collator);
         if (isHashed) {
-            dataObj = ExpressionMapping::hash(dataObj.firstElement());
+            HashSeed seed;
+            int hashVersion;
+            ExpressionParams::parseHashSeedAndVersion(index.infoObj, &seed, &hashVersion);
+            dataObj = ExpressionMapping::hash(dataObj.firstElement(), seed, hashVersion);
         }
 
         verify(dataObj.isOwned());
@@ -883,6 +911,46 @@ void IndexBoundsBuilder::translateEquality(const BSONElement& data,
     *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
 }
 
+// static
+void IndexBoundsBuilder::translateHashedEqualities(const BSONElementSet& equalities,
+                                                   const IndexEntry& index,
+                                                   OrderedIntervalList* oil,
+                                                   BoundsTightness* tightnessOut) {
+    *tightnessOut = IndexBoundsBuilder::EXACT;
+
+    // Hash all the values of the $in with a single batch call rather than one at a time.
+    std::vector<BSONObj> dataObjs;
+    std::vector<BSONElement> values;
+    for (auto&& equality : equalities) {
+        if (Array == equality.type()) {
+            BoundsTightness tightness;
+            translateEquality(equality, index, true, oil, &tightness);
+            if (tightness != IndexBoundsBuilder::EXACT) {
+                *tightnessOut = tightness;
+            }
+            continue;
+        }
+        dataObjs.push_back(objFromElement(equality, index.collator));
+        values.push_back(dataObjs.back().firstElement());
+    }
+
+    if (values.empty()) {
+        return;
+    }
+
+    HashSeed seed;
+    int hashVersion;
+    ExpressionParams::parseHashSeedAndVersion(index.infoObj, &seed, &hashVersion);
+    std::vector<long long int> hashes;
+    BSONElementHasher::hash64Batch(values, seed, hashVersion, &hashes);
+    for (auto&& hash : hashes) {
+        oil->intervals.push_back(makePointInterval(BSON("" << hash)));
+    }
+
+    // Different values can hash to the same key, so documents must always be fetched.
+    *tightnessOut = IndexBoundsBuilder::INEXACT_FETCH;
+}
+
 // static
 void IndexBoundsBuilder::allValuesBounds(const BSONObj& keyPattern, IndexBounds* bounds) {
     bounds->fields.resize(keyPattern.nFields());
@@ -165,6 +165,16 @@ public:
                                   OrderedIntervalList* oil,
                                   BoundsTightness* tightnessOut);
 
+    /**
+     * Appends the point intervals of a hashed index for the values of a $in to 'oil'. Computes
+     * the same intervals as calling translateEquality() on each value, but hashes the values
+     * together.
+     */
+    static void translateHashedEqualities(const BSONElementSet& equalities,
+                                          const IndexEntry& index,
+                                          OrderedIntervalList* oil,
+                                          BoundsTightness* tightnessOut);
+
     static void unionize(OrderedIntervalList* oilOut);
     static void intersectize(const OrderedIntervalList& arg, OrderedIntervalList* oilOut);
 
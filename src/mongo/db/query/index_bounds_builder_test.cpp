@@ -30,6 +30,7 @@
 
 #include "mongo/db/query/index_bounds_builder.h"
 
+#include <algorithm>
 #include <limits>
 #include <memory>
 
@@ -38,7 +39,9 @@
 #include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
 #include "mongo/db/query/collation/collator_interface_mock.h"
 #include "mongo/db/query/expression_index.h"
+#include "mongo/db/query/expression_index_knobs.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 using namespace mongo;
 
@@ -2108,6 +2111,39 @@ TEST(IndexBoundsBuilderTest, EqualityToNumberAgainstHashedIndexWithCollatorUsesH
     ASSERT_EQUALS(tightness, IndexBoundsBuilder::INEXACT_FETCH);
 }
 
+TEST(IndexBoundsBuilderTest, InAgainstHashedIndexUsesSeedAndHashVersionOfIndex) {
+    BSONObj keyPattern = fromjson("{a: 'hashed'}");
+    BSONElement elt = keyPattern.firstElement();
+    IndexEntry testIndex = IndexEntry(keyPattern);
+    testIndex.infoObj = BSON("key" << keyPattern << "seed" << 5 << "hashVersion" << 1);
+
+    BSONObj obj = fromjson("{a: {$in: [1, 'foo', {b: 2}]}}");
+    unique_ptr<MatchExpression> expr(parseMatchExpression(obj));
+
+    OrderedIntervalList oil;
+    IndexBoundsBuilder::BoundsTightness tightness;
+    IndexBoundsBuilder::translate(expr.get(), elt, testIndex, &oil, &tightness);
+
+    BSONObj values = fromjson("{'': 1, '': 'foo', '': {b: 2}}");
+    std::vector<long long int> expectedHashes;
+    for (auto&& value : values) {
+        expectedHashes.push_back(
+            ExpressionMapping::hash(value, 5, kMurmur3HashVersion).firstElement().numberLong());
+        ASSERT_NOT_EQUALS(expectedHashes.back(),
+                          ExpressionMapping::hash(value).firstElement().numberLong());
+    }
+    std::sort(expectedHashes.begin(), expectedHashes.end());
+
+    ASSERT_EQUALS(oil.name, "a");
+    ASSERT_EQUALS(oil.intervals.size(), 3U);
+    for (size_t i = 0; i < expectedHashes.size(); ++i) {
+        BSONObj intervalObj = BSON("" << expectedHashes[i] << "" << expectedHashes[i]);
+        ASSERT_EQUALS(Interval::INTERVAL_EQUALS,
+                      oil.intervals[i].compare(Interval(intervalObj, true, true)));
+    }
+    ASSERT_EQUALS(tightness, IndexBoundsBuilder::INEXACT_FETCH);
+}
+
 TEST(IndexBoundsBuilderTest, InWithStringAgainstHashedIndexWithCollatorUsesHashOfCollationKey) {
     BSONObj keyPattern = fromjson("{a: 'hashed'}");
     BSONElement elt = keyPattern.firstElement();
@@ -2137,4 +2173,52 @@ TEST(IndexBoundsBuilderTest, InWithStringAgainstHashedIndexWithCollatorUsesHashO
     ASSERT_EQUALS(tightness, IndexBoundsBuilder::INEXACT_FETCH);
 }
 
+//
+// 2dsphere covering cache
+//
+
+TEST(IndexBoundsBuilderTest, TranslateGeoWithinPolygonReusesCachedCovering) {
+    ExpressionMapping::clearS2CoveringCache();
+    const int originalMaxCells = internalQueryS2GeoMaxCells.load();
+    const int originalCacheSize = internalQueryS2CoveringCacheSize.load();
+    ON_BLOCK_EXIT([&] {
+        internalQueryS2GeoMaxCells.store(originalMaxCells);
+        internalQueryS2CoveringCacheSize.store(originalCacheSize);
+        ExpressionMapping::clearS2CoveringCache();
+    });
+
+    BSONObj keyPattern = fromjson("{a: '2dsphere'}");
+    IndexEntry testIndex = IndexEntry(keyPattern);
+    testIndex.infoObj = fromjson("{key: {a: '2dsphere'}, '2dsphereIndexVersion': 3}");
+    BSONObj obj = fromjson(
+        "{a: {$geoWithin: {$geometry: {type: 'Polygon', coordinates: "
+        "[[[0, 0], [0, 5], [3, 8], [5, 5], [5, 0], [0, 0]]]}}}}");
+    unique_ptr<MatchExpression> expr(parseMatchExpression(obj));
+    BSONElement elt = keyPattern.firstElement();
+
+    auto translate = [&]() {
+        OrderedIntervalList oil;
+        IndexBoundsBuilder::BoundsTightness tightness;
+        IndexBoundsBuilder::translate(expr.get(), elt, testIndex, &oil, &tightness);
+        ASSERT_EQUALS(tightness, IndexBoundsBuilder::INEXACT_FETCH);
+        return oil;
+    };
+
+    OrderedIntervalList uncached = translate();
+    ASSERT_GT(uncached.intervals.size(), 0U);
+    ASSERT(uncached == translate());
+
+    internalQueryS2CoveringCacheSize.store(0);
+    ASSERT(uncached == translate());
+    internalQueryS2CoveringCacheSize.store(originalCacheSize);
+
+    // The covering knobs are part of the cache key.
+    internalQueryS2GeoMaxCells.store(1);
+    OrderedIntervalList coarse = translate();
+    ASSERT_FALSE(uncached == coarse);
+    ASSERT(coarse == translate());
+    internalQueryS2GeoMaxCells.store(originalMaxCells);
+    ASSERT(uncached == translate());
+}
+
 }  // namespace
@@ -519,6 +519,46 @@ TEST(IndexBoundsTest, SimpleRangeBoundsNotEqualDifferentEndKeyInclusive) {
     ASSERT_TRUE(bounds1 != bounds2);
 }
 
+//
+// Shape
+//
+
+TEST(IndexBoundsTest, ShapeDistinguishesPointsRangesAndUnconstrainedFields) {
+    OrderedIntervalList points("a");
+    points.intervals.push_back(Interval(BSON("" << 1 << "" << 1), true, true));
+    points.intervals.push_back(Interval(BSON("" << 3 << "" << 3), true, true));
+    OrderedIntervalList range("b");
+    range.intervals.push_back(Interval(BSON("" << 3 << "" << 10), false, false));
+    OrderedIntervalList all("c");
+    all.intervals.push_back(Interval(BSON("" << MINKEY << "" << MAXKEY), true, true));
+    OrderedIntervalList allBackwards("d");
+    allBackwards.intervals.push_back(Interval(BSON("" << MAXKEY << "" << MINKEY), true, true));
+
+    IndexBounds bounds;
+    bounds.fields.push_back(points);
+    bounds.fields.push_back(range);
+    bounds.fields.push_back(all);
+    bounds.fields.push_back(allBackwards);
+
+    ASSERT_EQ(bounds.toShapeBSON(),
+              BSON("a"
+                   << "point"
+                   << "b"
+                   << "range"
+                   << "c"
+                   << "all"
+                   << "d"
+                   << "all"));
+}
+
+TEST(IndexBoundsTest, ShapeOfSimpleRangeHasNoFields) {
+    IndexBounds bounds;
+    bounds.isSimpleRange = true;
+    bounds.startKey = BSON("" << 1);
+    bounds.endKey = BSON("" << 2);
+    ASSERT_EQ(bounds.toShapeBSON(), BSON("$simpleRange" << true));
+}
+
 //
 // Iteration over
 //
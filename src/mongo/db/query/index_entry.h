@@ -33,6 +33,7 @@
 #include "mongo/db/index/multikey_paths.h"
 #include "mongo/db/index_names.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
@@ -105,6 +106,22 @@ struct IndexEntry {
 
     std::string toString() const;
 
+    /**
+     * Returns true if a single document may have index keys which differ in the key pattern
+     * field at position 'pos', that is, if some prefix of that field is an array. Every field of a
+     * multikey index is assumed to be multikey when there is no path-level multikey information.
+     */
+    bool isMultikeyField(size_t pos) const {
+        if (!multikey) {
+            return false;
+        }
+        if (multikeyPaths.empty()) {
+            return true;
+        }
+        invariant(pos < multikeyPaths.size());
+        return !multikeyPaths[pos].empty();
+    }
+
     BSONObj keyPattern;
 
     bool multikey;
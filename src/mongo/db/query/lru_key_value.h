@@ -170,6 +170,23 @@ public:
         return Status::OK();
     }
 
+    /**
+     * Removes the least recently used entry from the kv-store and passes ownership of it to the
+     * caller. Returns an empty unique_ptr if the kv-store is empty.
+     */
+    std::unique_ptr<V> removeLeastRecentlyUsed() {
+        if (_kvList.empty()) {
+            return std::unique_ptr<V>();
+        }
+        V* evictedEntry = _kvList.back().second;
+        invariant(evictedEntry);
+
+        _kvMap.erase(_kvList.back().first);
+        _kvList.pop_back();
+        _currentSize--;
+        return std::unique_ptr<V>(evictedEntry);
+    }
+
     /**
      * Deletes all entries in the kv-store.
      */
@@ -175,6 +175,32 @@ TEST(LRUKeyValueTest, ReplaceKeyTest) {
     assertInKVStore(cache, 4, 5);
 }
 
+/**
+ * Test that removeLeastRecentlyUsed() hands back entries in LRU order.
+ */
+TEST(LRUKeyValueTest, RemoveLeastRecentlyUsedTest) {
+    LRUKeyValue<int, int> cache(10);
+    ASSERT(!cache.removeLeastRecentlyUsed());
+
+    cache.add(1, new int(1));
+    cache.add(2, new int(2));
+    cache.add(3, new int(3));
+
+    // Promote 1 so that 2 becomes the least recently used entry.
+    assertInKVStore(cache, 1, 1);
+
+    std::unique_ptr<int> evicted = cache.removeLeastRecentlyUsed();
+    ASSERT(evicted);
+    ASSERT_EQUALS(*evicted, 2);
+    ASSERT_EQUALS(cache.size(), 2U);
+    assertNotInKVStore(cache, 2);
+
+    evicted = cache.removeLeastRecentlyUsed();
+    ASSERT(evicted);
+    ASSERT_EQUALS(*evicted, 3);
+    assertInKVStore(cache, 1, 1);
+}
+
 /**
  * Test iteration over the kv-store.
  */
@@ -243,6 +243,61 @@ void encodeGeoNearMatchExpression(const GeoNearMatchExpression* tree, StringBuil
     }
 }
 
+/**
+ * Returns true if the projection 'elt' is an operator whose argument is a literal that doesn't
+ * affect planning.
+ */
+bool isParameterizedProjection(const BSONElement& elt) {
+    if (elt.type() != Object || elt.Obj().nFields() != 1) {
+        return false;
+    }
+    StringData op = elt.Obj().firstElementFieldName();
+    return op == "$slice" || op == "$elemMatch";
+}
+
+/**
+ * Returns the number of work cycles per result in 'stats'. Both are offset by one, so that plans
+ * which have not produced any results yet can still be compared.
+ */
+double worksPerResult(const PlanStageStats& stats) {
+    return static_cast<double>(stats.common.works + 1) / (stats.common.advanced + 1);
+}
+
+// SpecificStats subclasses don't report their size. Most are a handful of counters, so each is
+// charged this much.
+const size_t kSpecificStatsSizeEstimate = 128;
+
+size_t estimateIndexTreeSize(const PlanCacheIndexTree* tree) {
+    if (!tree) {
+        return 0;
+    }
+    size_t size = sizeof(PlanCacheIndexTree) + tree->children.capacity() * sizeof(tree);
+    if (tree->entry) {
+        const IndexEntry& entry = *tree->entry;
+        size += sizeof(IndexEntry) + entry.keyPattern.objsize() + entry.infoObj.objsize() +
+            entry.name.capacity();
+        for (const auto& components : entry.multikeyPaths) {
+            size += sizeof(components) + components.size() * sizeof(size_t);
+        }
+    }
+    for (const PlanCacheIndexTree* child : tree->children) {
+        size += estimateIndexTreeSize(child);
+    }
+    return size;
+}
+
+size_t estimateStatsTreeSize(const PlanStageStats& stats) {
+    size_t size = sizeof(PlanStageStats) + stats.common.filter.objsize() +
+        stats.children.capacity() * sizeof(stats.children[0]);
+    if (stats.specific) {
+        size += kSpecificStatsSizeEstimate;
+    }
+    for (const auto& child : stats.children) {
+        size += estimateStatsTreeSize(*child);
+    }
+    return size;
+}
+
 }  // namespace
 
 //
@@ -380,6 +435,29 @@ PlanCacheEntry* PlanCacheEntry::clone() const {
     return entry;
 }
 
+size_t PlanCacheEntry::estimateObjectSizeInBytes() const {
+    size_t size = sizeof(PlanCacheEntry) + query.objsize() + sort.objsize() + projection.objsize();
+
+    size += plannerData.capacity() * sizeof(SolutionCacheData*);
+    for (const SolutionCacheData* data : plannerData) {
+        size += sizeof(SolutionCacheData) + estimateIndexTreeSize(data->tree.get());
+    }
+
+    if (decision) {
+        size += sizeof(PlanRankingDecision) + decision->scores.capacity() * sizeof(double) +
+            decision->candidateOrder.capacity() * sizeof(size_t);
+        for (const PlanStageStats* stats : decision->stats.vector()) {
+            size += estimateStatsTreeSize(*stats);
+        }
+    }
+
+    size += feedback.capacity() * sizeof(PlanCacheEntryFeedback*);
+    for (const PlanCacheEntryFeedback* fb : feedback) {
+        size += sizeof(PlanCacheEntryFeedback) + estimateStatsTreeSize(*fb->stats);
+    }
+    return size;
+}
+
 std::string PlanCacheEntry::toString() const {
     return str::stream() << "(query: " << query.toString() << ";sort: " << sort.toString()
                          << ";projection: " << projection.toString()
@@ -463,6 +541,10 @@ std::string SolutionCacheData::toString() const {
                                  << "tree=" << this->tree->toString() << ")";
         case COLLSCAN_SOLN:
             return "(collection scan)";
+        case SKIP_IXSCAN_SOLN:
+            verify(this->tree.get());
+            return str::stream() << "(skip scan solution: "
+                                 << "tree=" << this->tree->toString() << ")";
         case USE_INDEX_TAGS_SOLN:
             verify(this->tree.get());
             return str::stream() << "(index-tagged expression tree: "
@@ -471,6 +553,19 @@ std::string SolutionCacheData::toString() const {
     MONGO_UNREACHABLE;
 }
 
+//
+// PlanCacheStats
+//
+
+void PlanCacheStats::appendTo(BSONObjBuilder* builder) const {
+    builder->appendNumber("hits", hits.get());
+    builder->appendNumber("misses", misses.get());
+    builder->appendNumber("evictions", evictions.get());
+    builder->appendNumber("replans", replans.get());
+    builder->appendNumber("planningMillis", planningMillis.get());
+    builder->appendNumber("sizeBytes", sizeBytes.get());
+}
+
 //
 // PlanCache
 //
@@ -479,7 +574,53 @@ PlanCache::PlanCache() : _cache(internalQueryCacheSize) {}
 
 PlanCache::PlanCache(const std::string& ns) : _cache(internalQueryCacheSize), _ns(ns) {}
 
-PlanCache::~PlanCache() {}
+PlanCache::~PlanCache() {
+    // The entries go away with '_cache'. Take their size out of the global total.
+    globalStats().sizeBytes.decrement(_stats.sizeBytes.get());
+}
+
+PlanCacheStats& PlanCache::globalStats() {
+    static PlanCacheStats stats;
+    return stats;
+}
+
+void PlanCache::noteReplan() {
+    _stats.replans.increment();
+    globalStats().replans.increment();
+}
+
+void PlanCache::notePlanningTime(Milliseconds elapsed) {
+    const long long millis = durationCount<Milliseconds>(elapsed);
+    if (millis <= 0) {
+        return;
+    }
+    _stats.planningMillis.increment(millis);
+    globalStats().planningMillis.increment(millis);
+}
+
+void PlanCache::_noteSizeChange(long long bytes) {
+    if (bytes >= 0) {
+        _stats.sizeBytes.increment(bytes);
+        globalStats().sizeBytes.increment(bytes);
+    } else {
+        _stats.sizeBytes.decrement(-bytes);
+        globalStats().sizeBytes.decrement(-bytes);
+    }
+}
+
+void PlanCache::_evictToSizeBudget() {
+    const long long maxSizeBytes = internalQueryCacheMaxSizeBytes.load();
+    while (_cache.size() > 1 && globalStats().sizeBytes.get() > maxSizeBytes) {
+        std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.removeLeastRecentlyUsed();
+        invariant(evictedEntry);
+        _noteSizeChange(-static_cast<long long>(evictedEntry->estimatedEntrySizeBytes));
+        _stats.evictions.increment();
+        globalStats().evictions.increment();
+
+        LOG(1) << _ns << ": plan cache memory budget of " << maxSizeBytes << " bytes exceeded - "
+               << "removed least recently used entry " << evictedEntry->toString();
+    }
+}
 
 /**
  * Traverses expression tree pre-order.
@@ -602,6 +743,13 @@ void PlanCache::encodeKeyForProj(const BSONObj& projObj, StringBuilder* keyBuild
         if (elt.isSimpleType()) {
             // For inclusion/exclusion projections, we encode as "i" or "e".
             *keyBuilder << (elt.trueValue() ? "i" : "e");
+        } else if (isParameterizedProjection(elt)) {
+            // The arguments of $slice and $elemMatch only decide which array elements are
+            // returned, and have no bearing on the plan. Encode just the operator so that
+            // queries differing only in those literals share a cache entry.
+            *keyBuilder << "{ ";
+            encodeUserString(elt.Obj().firstElementFieldName(), keyBuilder);
+            *keyBuilder << " }";
         } else {
             // For projection operators, we use the verbatim string encoding of the element.
             encodeUserString(elt.toString(false,   // includeFieldName
@@ -651,14 +799,31 @@ Status PlanCache::add(const CanonicalQuery& query,
     }
     entry->projection = projBuilder.obj();
 
+    const PlanCacheKey key = computeKey(query);
+    entry->estimatedEntrySizeBytes = entry->estimateObjectSizeInBytes() + key.size();
+
     stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(computeKey(query), entry);
+
+    // An existing entry for the same key is replaced, so stop charging for it.
+    PlanCacheEntry* replacedEntry;
+    if (_cache.get(key, &replacedEntry).isOK()) {
+        _noteSizeChange(-static_cast<long long>(replacedEntry->estimatedEntrySizeBytes));
+    }
+
+    _noteSizeChange(entry->estimatedEntrySizeBytes);
+    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(key, entry);
 
     if (NULL != evictedEntry.get()) {
+        _noteSizeChange(-static_cast<long long>(evictedEntry->estimatedEntrySizeBytes));
+        _stats.evictions.increment();
+        globalStats().evictions.increment();
+
         LOG(1) << _ns << ": plan cache maximum size exceeded - "
                << "removed least recently used entry " << evictedEntry->toString();
     }
 
+    _evictToSizeBudget();
+
     return Status::OK();
 }
 
@@ -670,16 +835,22 @@ Status PlanCache::get(const CanonicalQuery& query, CachedSolution** crOut) const
     PlanCacheEntry* entry;
     Status cacheStatus = _cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
+        _stats.misses.increment();
+        globalStats().misses.increment();
         return cacheStatus;
     }
     invariant(entry);
+    _stats.hits.increment();
+    globalStats().hits.increment();
 
     *crOut = new CachedSolution(key, *entry);
 
     return Status::OK();
 }
 
-Status PlanCache::feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* feedback) {
+Status PlanCache::feedback(const CanonicalQuery& cq,
+                           PlanCacheEntryFeedback* feedback,
+                           bool* driftedOut) {
     if (NULL == feedback) {
         return Status(ErrorCodes::BadValue, "feedback is NULL");
     }
@@ -694,22 +865,44 @@ Status PlanCache::feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* fee
     }
     invariant(entry);
 
+    if (driftedOut) {
+        // The feedback stats are those of the CachedPlanStage, whose child is the cached plan.
+        // The stats of the winning plan from the original trial period sort first.
+        invariant(autoFeedback->stats->children.size() == 1U);
+        const double observed = worksPerResult(*autoFeedback->stats->children[0]);
+        const double original = worksPerResult(*entry->decision->stats[0]);
+        *driftedOut = observed > internalQueryCacheBackgroundReplanDriftRatio.load() * original;
+    }
+
     // We store up to a constant number of feedback entries.
     if (entry->feedback.size() < size_t(internalQueryCacheFeedbacksStored)) {
+        const size_t feedbackSize =
+            sizeof(PlanCacheEntryFeedback) + estimateStatsTreeSize(*autoFeedback->stats);
         entry->feedback.push_back(autoFeedback.release());
+        entry->estimatedEntrySizeBytes += feedbackSize;
+        _noteSizeChange(feedbackSize);
     }
 
     return Status::OK();
 }
 
 Status PlanCache::remove(const CanonicalQuery& canonicalQuery) {
+    const PlanCacheKey key = computeKey(canonicalQuery);
+
     stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.remove(computeKey(canonicalQuery));
+    PlanCacheEntry* entry;
+    Status cacheStatus = _cache.get(key, &entry);
+    if (!cacheStatus.isOK()) {
+        return cacheStatus;
+    }
+    _noteSizeChange(-static_cast<long long>(entry->estimatedEntrySizeBytes));
+    return _cache.remove(key);
 }
 
 void PlanCache::clear() {
     stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
     _cache.clear();
+    _noteSizeChange(-_stats.sizeBytes.get());
     _writeOperations.store(0);
 }
 
@@ -31,6 +31,7 @@
 #include <boost/optional/optional.hpp>
 #include <set>
 
+#include "mongo/base/counter.h"
 #include "mongo/db/exec/plan_stats.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/index_tag.h"
@@ -39,6 +40,7 @@
 #include "mongo/db/query/query_planner_params.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -159,6 +161,11 @@ struct SolutionCacheData {
         // The cached plan is a collection scan.
         COLLSCAN_SOLN,
 
+        // The plan scans the index in 'tree' with bounds
+        // on its second field, skipping between the
+        // values of its unconstrained first field.
+        SKIP_IXSCAN_SOLN,
+
         // Build the solution by using 'tree'
         // to tag the match expression.
         USE_INDEX_TAGS_SOLN
@@ -175,6 +182,40 @@ struct SolutionCacheData {
 
 class PlanCacheEntry;
 
+/**
+ * Counters describing how a plan cache is used. Each PlanCache keeps its own, and the plan caches
+ * of all collections also add to a single set returned by PlanCache::globalStats(), which is
+ * reported by serverStatus.
+ */
+struct PlanCacheStats {
+    MONGO_DISALLOW_COPYING(PlanCacheStats);
+
+    PlanCacheStats() = default;
+
+    /**
+     * Appends the counters to 'builder' as fields named after them.
+     */
+    void appendTo(BSONObjBuilder* builder) const;
+
+    // Lookups which found an entry.
+    Counter64 hits;
+
+    // Lookups which found no entry.
+    Counter64 misses;
+
+    // Entries removed by the cache itself, to keep it within its entry or size bounds.
+    Counter64 evictions;
+
+    // Times a cached plan performed badly enough that the query was planned again.
+    Counter64 replans;
+
+    // Time spent ranking candidate plans, in milliseconds.
+    Counter64 planningMillis;
+
+    // Estimated memory held by the cache's entries.
+    Counter64 sizeBytes;
+};
+
 /**
  * Information returned from a get(...) query.
  */
@@ -233,6 +274,12 @@ public:
     // For debugging.
     std::string toString() const;
 
+    /**
+     * Returns an estimate of the memory held by this entry, including the planner data, query
+     * shape, ranking decision and feedback it owns.
+     */
+    size_t estimateObjectSizeInBytes() const;
+
     //
     // Planner data
     //
@@ -262,6 +309,9 @@ public:
     // Annotations from cached runs.  The CachedPlanStage provides these stats about its
     // runs when they complete.
     std::vector<PlanCacheEntryFeedback*> feedback;
+    // The result of estimateObjectSizeInBytes() as last charged to the cache's size. Maintained
+    // by the PlanCache holding the entry.
+    size_t estimatedEntrySizeBytes = 0;
 };
 
 /**
@@ -329,8 +379,14 @@ public:
      *
      * If the entry corresponding to 'cq' still exists, 'feedback' is added to the run
      * statistics about the plan.  Status::OK() is returned.
+     *
+     * If 'driftedOut' is non-NULL, it is set to whether the works per result in 'feedback'
+     * exceed those of the plan's original trial period by more than
+     * internalQueryCacheBackgroundReplanDriftRatio, i.e. whether the entry should be replanned.
      */
-    Status feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* feedback);
+    Status feedback(const CanonicalQuery& cq,
+                    PlanCacheEntryFeedback* feedback,
+                    bool* driftedOut = NULL);
 
     /**
      * Remove the entry corresponding to 'ck' from the cache.  Returns Status::OK() if the plan
@@ -393,7 +449,43 @@ public:
      */
     void notifyOfIndexEntries(const std::vector<IndexEntry>& indexEntries);
 
+    /**
+     * Records that a query whose plan came from this cache was planned again because the cached
+     * plan performed badly.
+     */
+    void noteReplan();
+
+    /**
+     * Records time spent ranking candidate plans for a query against this collection.
+     */
+    void notePlanningTime(Milliseconds elapsed);
+
+    /**
+     * Usage counters for this collection's cache.
+     */
+    const PlanCacheStats& getStats() const {
+        return _stats;
+    }
+
+    /**
+     * Usage counters summed over the plan caches of all collections.
+     */
+    static PlanCacheStats& globalStats();
+
 private:
+    /**
+     * Adjusts this cache's and the global size counters when an entry of 'bytes' is added or,
+     * when 'bytes' is negative, removed. Callers must hold '_cacheMutex'.
+     */
+    void _noteSizeChange(long long bytes);
+
+    /**
+     * Evicts least recently used entries from this cache while the plan caches of all
+     * collections together are larger than internalQueryCacheMaxSizeBytes. The most recently
+     * used entry is always kept. Callers must hold '_cacheMutex'.
+     */
+    void _evictToSizeBudget();
+
     void encodeKeyForMatch(const MatchExpression* tree, StringBuilder* keyBuilder) const;
     void encodeKeyForSort(const BSONObj& sortObj, StringBuilder* keyBuilder) const;
     void encodeKeyForProj(const BSONObj& projObj, StringBuilder* keyBuilder) const;
@@ -410,6 +502,9 @@ private:
     // Full namespace of collection.
     std::string _ns;
 
+    // Usage counters for this cache. Their changes are also applied to globalStats().
+    mutable PlanCacheStats _stats;
+
     // Holds computed information about the collection's indexes.  Used for generating plan
     // cache keys.
     //
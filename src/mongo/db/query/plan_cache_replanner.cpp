@@ -0,0 +1,195 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/plan_cache_replanner.h"
+
+#include "mongo/base/owned_pointer_vector.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/exec/multi_plan.h"
+#include "mongo/db/exec/working_set.h"
+#include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/explain.h"
+#include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_planner.h"
+#include "mongo/db/query/query_planner_params.h"
+#include "mongo/db/query/stage_builder.h"
+#include "mongo/db/service_context.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getPlanCacheReplanner = ServiceContext::declareDecoration<PlanCacheReplanner>();
+
+// Bounds the work queued up behind the replanner thread. Shapes which are dropped are scheduled
+// again by the next query which notices their cached plan performing badly.
+const size_t kMaxPendingReplans = 64;
+
+}  // namespace
+
+PlanCacheReplanner::PlanCacheReplanner() = default;
+
+PlanCacheReplanner::~PlanCacheReplanner() {
+    if (_threadPool) {
+        _threadPool->shutdown();
+        _threadPool->join();
+    }
+}
+
+PlanCacheReplanner* PlanCacheReplanner::get(ServiceContext* service) {
+    return &getPlanCacheReplanner(service);
+}
+
+bool PlanCacheReplanner::schedule(const Collection* collection, const CanonicalQuery& cq) {
+    const NamespaceString nss = collection->ns();
+    const std::string pendingKey =
+        nss.ns() + '\0' + collection->infoCache()->getPlanCache()->computeKey(cq);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_pending.size() >= kMaxPendingReplans || !_pending.insert(pendingKey).second) {
+        return false;
+    }
+
+    if (!_threadPool) {
+        ThreadPool::Options options;
+        options.poolName = "PlanCacheReplanner";
+        options.minThreads = 0;
+        options.maxThreads = 1;
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+        };
+        _threadPool = stdx::make_unique<ThreadPool>(options);
+        _threadPool->startup();
+    }
+
+    const QueryRequest qr = cq.getQueryRequest();
+    Status status = _threadPool->schedule([this, nss, qr, pendingKey] {
+        try {
+            _replan(nss, qr);
+        } catch (const DBException& ex) {
+            LOG(1) << "Background replanning of " << nss.ns() << " query " << qr.getFilter()
+                   << " failed: " << ex.toStatus();
+        }
+        _finish(pendingKey);
+    });
+    if (!status.isOK()) {
+        _pending.erase(pendingKey);
+        return false;
+    }
+
+    return true;
+}
+
+void PlanCacheReplanner::waitForIdle() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _idleCondition.wait(lk, [this] { return _pending.empty(); });
+}
+
+void PlanCacheReplanner::_finish(const std::string& pendingKey) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _pending.erase(pendingKey);
+    if (_pending.empty()) {
+        _idleCondition.notify_all();
+    }
+}
+
+void PlanCacheReplanner::_replan(const NamespaceString& nss, const QueryRequest& qr) {
+    const ServiceContext::UniqueOperationContext txnPtr = cc().makeOperationContext();
+    OperationContext* txn = txnPtr.get();
+
+    AutoGetCollectionForRead ctx(txn, nss);
+    Collection* collection = ctx.getCollection();
+    if (!collection) {
+        return;
+    }
+
+    auto statusWithCQ = CanonicalQuery::canonicalize(
+        txn, stdx::make_unique<QueryRequest>(qr), ExtensionsCallbackReal(txn, &nss));
+    uassertStatusOK(statusWithCQ.getStatus());
+    std::unique_ptr<CanonicalQuery> cq = std::move(statusWithCQ.getValue());
+
+    // Plan from scratch rather than from the plan cache.
+    QueryPlannerParams plannerParams;
+    fillOutPlannerParams(txn, collection, cq.get(), &plannerParams);
+
+    std::vector<QuerySolution*> rawSolutions;
+    uassertStatusOK(QueryPlanner::plan(*cq, plannerParams, &rawSolutions));
+    OwnedPointerVector<QuerySolution> solutions(rawSolutions);
+
+    if (solutions.size() < 2U) {
+        // There is nothing left to choose from, so the shape does not belong in the cache.
+        collection->infoCache()->getPlanCache()->remove(*cq);
+        return;
+    }
+
+    auto ws = stdx::make_unique<WorkingSet>();
+    auto multiPlanStage = stdx::make_unique<MultiPlanStage>(
+        txn, collection, cq.get(), MultiPlanStage::CachingMode::AlwaysCache);
+
+    for (size_t ix = 0; ix < solutions.size(); ++ix) {
+        if (solutions[ix]->cacheData.get()) {
+            solutions[ix]->cacheData->indexFilterApplied = plannerParams.indexFiltersApplied;
+        }
+
+        PlanStage* nextPlanRoot;
+        verify(
+            StageBuilder::build(txn, collection, *cq, *solutions[ix], ws.get(), &nextPlanRoot));
+
+        // Takes ownership of 'solutions[ix]' and 'nextPlanRoot'.
+        multiPlanStage->addPlan(solutions.releaseAt(ix), nextPlanRoot, ws.get());
+    }
+
+    // Creating the executor runs the trial period, after which the MultiPlanStage writes the
+    // winning plan to the plan cache. The executor itself is never run.
+    auto statusWithExec = PlanExecutor::make(txn,
+                                             std::move(ws),
+                                             std::move(multiPlanStage),
+                                             std::move(cq),
+                                             collection,
+                                             PlanExecutor::YIELD_AUTO);
+    uassertStatusOK(statusWithExec.getStatus());
+
+    LOG(1) << "Replanned " << nss.ns() << " query " << qr.getFilter()
+           << " in the background, resulting in plan with summary: "
+           << Explain::getPlanSummary(statusWithExec.getValue().get());
+}
+
+}  // namespace mongo
@@ -0,0 +1,98 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class CanonicalQuery;
+class Collection;
+class NamespaceString;
+class QueryRequest;
+class ServiceContext;
+class ThreadPool;
+
+/**
+ * Replans query shapes whose cached plan has fallen behind, on a background thread. The
+ * replanner runs the usual MultiPlanStage trial period for all candidate plans against its own
+ * snapshot of the collection and writes the winner to the plan cache, replacing the previous
+ * entry under the plan cache mutex. Queries which notice a bad cached plan can therefore carry
+ * on executing it, instead of paying for the replanning themselves.
+ *
+ * Used by the CachedPlanStage when internalQueryCacheBackgroundReplan is set.
+ */
+class PlanCacheReplanner {
+    MONGO_DISALLOW_COPYING(PlanCacheReplanner);
+
+public:
+    PlanCacheReplanner();
+    ~PlanCacheReplanner();
+
+    static PlanCacheReplanner* get(ServiceContext* service);
+
+    /**
+     * Schedules the shape of 'cq' on 'collection' to be replanned. The caller must hold the
+     * collection lock. Returns false if the shape is already scheduled or too many shapes are
+     * pending, in which case nothing is done.
+     */
+    bool schedule(const Collection* collection, const CanonicalQuery& cq);
+
+    /**
+     * Blocks until all scheduled shapes have been replanned. Used for testing.
+     */
+    void waitForIdle();
+
+private:
+    /**
+     * Plans 'qr' from scratch and caches the winning plan. Runs on the replanner thread.
+     */
+    void _replan(const NamespaceString& nss, const QueryRequest& qr);
+
+    void _finish(const std::string& pendingKey);
+
+    stdx::mutex _mutex;
+
+    // Signalled whenever '_pending' becomes empty.
+    stdx::condition_variable _idleCondition;
+
+    // Namespace and plan cache key of every shape which is scheduled or being replanned.
+    std::set<std::string> _pending;
+
+    // Created when the first shape is scheduled.
+    std::unique_ptr<ThreadPool> _threadPool;
+};
+
+}  // namespace mongo
@@ -417,6 +417,126 @@ TEST(PlanCacheTest, AddValidSolution) {
     ASSERT_EQUALS(planCache.size(), 1U);
 }
 
+/**
+ * Utility function to create feedback for a cached plan, which took 'works' work cycles to
+ * produce 'advanced' results.
+ */
+PlanCacheEntryFeedback* createFeedback(size_t works, size_t advanced) {
+    CommonStats childCommon("COLLSCAN");
+    childCommon.works = works;
+    childCommon.advanced = advanced;
+    unique_ptr<PlanCacheEntryFeedback> feedback(new PlanCacheEntryFeedback());
+    feedback->stats.reset(new PlanStageStats(CommonStats("CACHED_PLAN"), STAGE_CACHED_PLAN));
+    feedback->stats->children.emplace_back(new PlanStageStats(childCommon, STAGE_COLLSCAN));
+    feedback->score = 0;
+    return feedback.release();
+}
+
+TEST(PlanCacheTest, FeedbackReportsDrift) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    QuerySolution qs;
+    qs.cacheData.reset(new SolutionCacheData());
+    qs.cacheData->tree.reset(new PlanCacheIndexTree());
+    std::vector<QuerySolution*> solns;
+    solns.push_back(&qs);
+
+    // The winning plan took 10 works to produce 10 results during its trial period.
+    unique_ptr<PlanRankingDecision> decision(createDecision(1U));
+    decision->stats[0]->common.works = 10;
+    decision->stats[0]->common.advanced = 10;
+    ASSERT_OK(planCache.add(*cq, solns, decision.release()));
+
+    bool drifted = true;
+    ASSERT_OK(planCache.feedback(*cq, createFeedback(20, 10), &drifted));
+    ASSERT_FALSE(drifted);
+
+    const double driftRatio = internalQueryCacheBackgroundReplanDriftRatio.load();
+    const size_t driftedWorks = static_cast<size_t>(driftRatio * 11) + 10;
+    ASSERT_OK(planCache.feedback(*cq, createFeedback(driftedWorks, 10), &drifted));
+    ASSERT_TRUE(drifted);
+
+    // Drift is only computed on request.
+    ASSERT_OK(planCache.feedback(*cq, createFeedback(driftedWorks, 10)));
+
+    // No drift is reported for shapes which are no longer cached.
+    ASSERT_OK(planCache.remove(*cq));
+    drifted = false;
+    ASSERT_NOT_OK(planCache.feedback(*cq, createFeedback(driftedWorks, 10), &drifted));
+    ASSERT_FALSE(drifted);
+}
+
+TEST(PlanCacheTest, StatsCountHitsMissesAndSize) {
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+    QuerySolution qs;
+    qs.cacheData.reset(new SolutionCacheData());
+    qs.cacheData->tree.reset(new PlanCacheIndexTree());
+    std::vector<QuerySolution*> solns;
+    solns.push_back(&qs);
+
+    const long long globalSizeBefore = PlanCache::globalStats().sizeBytes.get();
+    CachedSolution* rawCachedSoln;
+    ASSERT_NOT_OK(planCache.get(*cq, &rawCachedSoln));
+    ASSERT_EQUALS(planCache.getStats().misses.get(), 1LL);
+    ASSERT_EQUALS(planCache.getStats().sizeBytes.get(), 0LL);
+
+    ASSERT_OK(planCache.add(*cq, solns, createDecision(1U)));
+    const long long entrySize = planCache.getStats().sizeBytes.get();
+    ASSERT_GREATER_THAN(entrySize, 0LL);
+    ASSERT_EQUALS(PlanCache::globalStats().sizeBytes.get(), globalSizeBefore + entrySize);
+
+    ASSERT_OK(planCache.get(*cq, &rawCachedSoln));
+    delete rawCachedSoln;
+    ASSERT_EQUALS(planCache.getStats().hits.get(), 1LL);
+
+    // Replacing the entry does not charge for it twice.
+    ASSERT_OK(planCache.add(*cq, solns, createDecision(1U)));
+    ASSERT_EQUALS(planCache.getStats().sizeBytes.get(), entrySize);
+
+    // Stored feedback grows the entry.
+    ASSERT_OK(planCache.feedback(*cq, createFeedback(10, 10)));
+    ASSERT_GREATER_THAN(planCache.getStats().sizeBytes.get(), entrySize);
+
+    ASSERT_OK(planCache.remove(*cq));
+    ASSERT_EQUALS(planCache.getStats().sizeBytes.get(), 0LL);
+    ASSERT_EQUALS(PlanCache::globalStats().sizeBytes.get(), globalSizeBefore);
+}
+
+TEST(PlanCacheTest, EvictsLeastRecentlyUsedEntriesOverSizeBudget) {
+    const long long oldMaxSizeBytes = internalQueryCacheMaxSizeBytes.load();
+    ON_BLOCK_EXIT([oldMaxSizeBytes] { internalQueryCacheMaxSizeBytes.store(oldMaxSizeBytes); });
+
+    PlanCache planCache;
+    unique_ptr<CanonicalQuery> cqA(canonicalize("{a: 1}"));
+    unique_ptr<CanonicalQuery> cqB(canonicalize("{b: 1}"));
+    QuerySolution qs;
+    qs.cacheData.reset(new SolutionCacheData());
+    qs.cacheData->tree.reset(new PlanCacheIndexTree());
+    std::vector<QuerySolution*> solns;
+    solns.push_back(&qs);
+
+    const long long globalSizeBefore = PlanCache::globalStats().sizeBytes.get();
+    ASSERT_OK(planCache.add(*cqA, solns, createDecision(1U)));
+    const long long entrySize = planCache.getStats().sizeBytes.get();
+
+    // Leave room for one and a half entries of this shape.
+    internalQueryCacheMaxSizeBytes.store(globalSizeBefore + entrySize + entrySize / 2);
+    ASSERT_OK(planCache.add(*cqB, solns, createDecision(1U)));
+
+    ASSERT_EQUALS(planCache.size(), 1U);
+    ASSERT_FALSE(planCache.contains(*cqA));
+    ASSERT_TRUE(planCache.contains(*cqB));
+    ASSERT_EQUALS(planCache.getStats().evictions.get(), 1LL);
+    ASSERT_EQUALS(planCache.getStats().sizeBytes.get(), entrySize);
+
+    // The most recently added entry is kept even when it alone exceeds the budget.
+    internalQueryCacheMaxSizeBytes.store(0);
+    ASSERT_OK(planCache.add(*cqA, solns, createDecision(1U)));
+    ASSERT_EQUALS(planCache.size(), 1U);
+    ASSERT_TRUE(planCache.contains(*cqA));
+}
+
 /**
  * Each test in the CachePlanSelectionTest suite goes through
  * the following flow:
@@ -1059,6 +1179,23 @@ TEST_F(CachePlanSelectionTest,
 }
 
 
+TEST_F(CachePlanSelectionTest, CachedPlanForSkipScan) {
+    bool oldEnableSkipScan = internalQueryPlannerEnableSkipScan.load();
+    ON_BLOCK_EXIT([oldEnableSkipScan] { internalQueryPlannerEnableSkipScan = oldEnableSkipScan; });
+    internalQueryPlannerEnableSkipScan = true;
+    params.options = QueryPlannerParams::NO_TABLE_SCAN;
+
+    addIndex(BSON("a" << 1 << "b" << 1));
+
+    BSONObj query = fromjson("{b: {$in: [1, 3]}}");
+    runQuery(query);
+
+    assertPlanCacheRecoversSolution(
+        query,
+        "{fetch: {filter: {b: {$in: [1, 3]}}, node: {ixscan: {pattern: {a: 1, b: 1}, bounds: "
+        "{a: [['MinKey','MaxKey',true,true]], b: [[1,1,true,true], [3,3,true,true]]}}}}}");
+}
+
 TEST_F(CachePlanSelectionTest, CachedPlanForIntersectionOfMultikeyIndexesWhenUsingElemMatch) {
     params.options = QueryPlannerParams::NO_TABLE_SCAN | QueryPlannerParams::INDEX_INTERSECTION;
 
@@ -1242,8 +1379,10 @@ TEST(PlanCacheTest, ComputeKey) {
     testComputeKey("{}", "{}", "{a: false}", "an|ea");
     testComputeKey("{}", "{}", "{a: 99}", "an|ia");
     testComputeKey("{}", "{}", "{a: 'foo'}", "an|ia");
-    testComputeKey("{}", "{}", "{a: {$slice: [3, 5]}}", "an|{ $slice: \\[ 3\\, 5 \\] }a");
-    testComputeKey("{}", "{}", "{a: {$elemMatch: {x: 2}}}", "an|{ $elemMatch: { x: 2 } }a");
+    testComputeKey("{}", "{}", "{a: {$slice: [3, 5]}}", "an|{ $slice }a");
+    testComputeKey("{}", "{}", "{a: {$slice: 10}}", "an|{ $slice }a");
+    testComputeKey("{}", "{}", "{a: {$elemMatch: {x: 2}}}", "an|{ $elemMatch }a");
+    testComputeKey("{}", "{}", "{a: {$elemMatch: {y: {$gt: 3}}}}", "an|{ $elemMatch }a");
     testComputeKey("{}", "{}", "{a: ObjectId('507f191e810c19729de860ea')}", "an|ia");
     testComputeKey("{a: 1}", "{}", "{'a.$': 1}", "eqa|ia.$");
     testComputeKey("{a: 1}", "{}", "{a: 1}", "eqa|ia");
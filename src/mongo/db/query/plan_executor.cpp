@@ -41,6 +41,7 @@
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/query/plan_yield_policy.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
@@ -246,6 +247,10 @@ unique_ptr<PlanStageStats> PlanExecutor::getStats() const {
     return _root->getStats();
 }
 
+const PlanYieldPolicy& PlanExecutor::getYieldPolicy() const {
+    return *_yieldPolicy;
+}
+
 BSONObjSet PlanExecutor::getOutputSorts() const {
     if (_qs && _qs->root) {
         _qs->root->computeProperties();
@@ -393,6 +398,10 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
     // Incremented on every writeConflict, reset to 0 on any successful call to _root->work.
     size_t writeConflictsInARow = 0;
 
+    // Held while retrying a write to a document which other writers are contending for, so that
+    // they retry after us rather than alongside us.
+    WriteConflictContentionManager::Turn contentionTurn;
+
     for (;;) {
         // These are the conditions which can cause us to yield:
         //   1) The yield policy's timer elapsed, or
@@ -420,10 +429,12 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
         fetcher.reset();
 
         WorkingSetID id = WorkingSet::INVALID_ID;
-        PlanStage::StageState code = _root->work(&id);
+        PlanStage::StageState code = workRoot(&id);
 
-        if (code != PlanStage::NEED_YIELD)
+        if (code != PlanStage::NEED_YIELD) {
             writeConflictsInARow = 0;
+            contentionTurn.release();
+        }
 
         if (PlanStage::ADVANCED == code) {
             WorkingSetMember* member = _workingSet->get(id);
@@ -467,7 +478,11 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
                     throw WriteConflictException();
                 CurOp::get(_opCtx)->debug().writeConflicts++;
                 writeConflictsInARow++;
-                WriteConflictException::logAndBackoff(writeConflictsInARow, "plan execution", _ns);
+                if (!WriteConflictContentionManager::get(_opCtx->getServiceContext())
+                         .waitForTurn(_opCtx, &contentionTurn)) {
+                    WriteConflictException::logAndBackoff(
+                        writeConflictsInARow, "plan execution", _ns);
+                }
 
             } else {
                 WorkingSetMember* member = _workingSet->get(id);
@@ -498,9 +513,47 @@ PlanExecutor::ExecState PlanExecutor::getNextImpl(Snapshotted<BSONObj>* objOut,
     }
 }
 
+PlanStage::StageState PlanExecutor::workRoot(WorkingSetID* out) {
+    if (!_batchedResults.empty()) {
+        *out = _batchedResults.front();
+        _batchedResults.pop_front();
+        return PlanStage::ADVANCED;
+    }
+
+    if (PlanStage::NEED_TIME != _batchEndState) {
+        PlanStage::StageState state = _batchEndState;
+        *out = _batchEndId;
+        _batchEndState = PlanStage::NEED_TIME;
+        _batchEndId = WorkingSet::INVALID_ID;
+        return state;
+    }
+
+    const int batchSize = internalQueryExecWorkBatchSize.load();
+    if (batchSize <= 1 || !supportsDocLocking()) {
+        return _root->work(out);
+    }
+
+    std::vector<WorkingSetID> results;
+    PlanStage::StageState state = _root->workBatch(batchSize, &results, out);
+    if (results.empty()) {
+        return state;
+    }
+
+    // Hand out the results first, then act upon the state that ended the batch.
+    if (PlanStage::ADVANCED != state && PlanStage::NEED_TIME != state) {
+        _batchEndState = state;
+        _batchEndId = *out;
+    }
+    _batchedResults.insert(_batchedResults.end(), results.begin() + 1, results.end());
+    *out = results.front();
+    return PlanStage::ADVANCED;
+}
+
 bool PlanExecutor::isEOF() {
     invariant(_currentState == kUsable);
-    return killed() || (_stash.empty() && _root->isEOF());
+    return killed() ||
+        (_stash.empty() && _batchedResults.empty() && PlanStage::NEED_TIME == _batchEndState &&
+         _root->isEOF());
 }
 
 void PlanExecutor::registerExec(const Collection* collection) {
@@ -29,9 +29,11 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <deque>
 #include <queue>
 
 #include "mongo/base/status.h"
+#include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/invalidation_type.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/db/storage/snapshot.h"
@@ -218,6 +220,11 @@ public:
      */
     std::unique_ptr<PlanStageStats> getStats() const;
 
+    /**
+     * Returns the policy deciding when this executor yields, which also counts its yields.
+     */
+    const PlanYieldPolicy& getYieldPolicy() const;
+
     //
     // Methods that just pass down to the PlanStage tree.
     //
@@ -435,6 +442,13 @@ private:
         return static_cast<bool>(_killReason);
     };
 
+    /**
+     * Returns the next result of the root stage, as _root->work() would. When the
+     * internalQueryExecWorkBatchSize knob is set the root is asked for a block of results at a
+     * time, and they are handed out one by one from _batchedResults.
+     */
+    PlanStage::StageState workRoot(WorkingSetID* out);
+
     // The OperationContext that we're executing within.  We need this in order to release
     // locks.
     OperationContext* _opCtx;
@@ -466,6 +480,13 @@ private:
     // stages.
     std::queue<BSONObj> _stash;
 
+    // Results of the last call to _root->workBatch() that have not been returned yet. If that
+    // batch ended with a state other than ADVANCED or NEED_TIME, the state and its WorkingSetID
+    // are kept until these results have been consumed.
+    std::deque<WorkingSetID> _batchedResults;
+    PlanStage::StageState _batchEndState = PlanStage::NEED_TIME;
+    WorkingSetID _batchEndId = WorkingSet::INVALID_ID;
+
     enum { kUsable, kSaved, kDetached } _currentState = kUsable;
 
     bool _everDetachedFromOperationContext = false;
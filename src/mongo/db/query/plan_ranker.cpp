@@ -111,6 +111,14 @@ size_t PlanRanker::pickBestPlan(const vector<CandidatePlan>& candidates, PlanRan
     std::stable_sort(
         scoresAndCandidateindices.begin(), scoresAndCandidateindices.end(), scoreComparator);
 
+    // Plans which were pruned part way through the trial period ran fewer works than the others,
+    // so their scores are not directly comparable. Rank all of them behind the survivors.
+    std::stable_partition(scoresAndCandidateindices.begin(),
+                          scoresAndCandidateindices.end(),
+                          [&candidates](const std::pair<double, size_t>& scoreAndIndex) {
+                              return !candidates[scoreAndIndex.second].pruned;
+                          });
+
     // Determine whether plans tied for the win.
     if (scoresAndCandidateindices.size() > 1U) {
         double bestScore = scoresAndCandidateindices[0].first;
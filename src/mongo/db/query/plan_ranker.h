@@ -70,7 +70,7 @@ public:
  */
 struct CandidatePlan {
     CandidatePlan(QuerySolution* s, PlanStage* r, WorkingSet* w)
-        : solution(s), root(r), ws(w), failed(false) {}
+        : solution(s), root(r), ws(w), failed(false), pruned(false) {}
 
     std::unique_ptr<QuerySolution> solution;
     PlanStage* root;  // Not owned here.
@@ -80,6 +80,10 @@ struct CandidatePlan {
     std::list<WorkingSetID> results;
 
     bool failed;
+
+    // Set if the plan was dropped from the trial period early for falling behind its peers. A
+    // pruned plan is still scored, but always ranks below the plans that ran the whole trial.
+    bool pruned;
 };
 
 /**
@@ -27,8 +27,12 @@
 
 #pragma once
 
+#include <map>
+#include <set>
 #include <string>
 
+#include "mongo/bson/bsonobj.h"
+
 namespace mongo {
 
 /**
@@ -54,6 +58,10 @@ struct PlanSummaryStats {
     // The names of each index used by the plan.
     std::set<std::string> indexesUsed;
 
+    // For each index scanned by the plan, the shape of the bounds it scanned, as given by
+    // IndexBounds::toShapeBSON().
+    std::map<std::string, BSONObj> indexBoundsShapes;
+
     // Was this plan a result of using the MultiPlanStage to select a winner among several
     // candidates?
     bool fromMultiPlanner = false;
@@ -30,6 +30,10 @@
 
 #include "mongo/db/query/plan_yield_policy.h"
 
+#include <algorithm>
+
+#include "mongo/db/concurrency/lock_manager.h"
+#include "mongo/db/concurrency/locker.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/operation_context.h"
@@ -38,15 +42,42 @@
 #include "mongo/db/service_context.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
+namespace {
+
+/**
+ * Returns how much more often the plans of 'opCtx' yield than those of normal priority
+ * operations.
+ */
+int yieldFactor(OperationContext* opCtx) {
+    if (!opCtx->lockState()->isLowPriority()) {
+        return 1;
+    }
+    return std::max(1, internalQueryExecLowPriorityYieldFactor.load());
+}
+
+/**
+ * Returns whether any operation is waiting for a lock or a ticket, which the plans which are due
+ * to yield might be holding.
+ */
+bool isContended() {
+    return LockManager::hasWaitingRequests() || Locker::hasGlobalThrottlingWaiters();
+}
+
+}  // namespace
+
 PlanYieldPolicy::PlanYieldPolicy(PlanExecutor* exec, PlanExecutor::YieldPolicy policy)
     : _policy(policy),
       _forceYield(false),
-      _elapsedTracker(exec->getOpCtx()->getServiceContext()->getFastClockSource(),
-                      internalQueryExecYieldIterations,
-                      Milliseconds(internalQueryExecYieldPeriodMS.load())),
+      _elapsedTracker(
+          exec->getOpCtx()->getServiceContext()->getFastClockSource(),
+          std::max(1, internalQueryExecYieldIterations.load() / yieldFactor(exec->getOpCtx())),
+          Milliseconds(internalQueryExecYieldPeriodMS.load() / yieldFactor(exec->getOpCtx()))),
+      _clock(exec->getOpCtx()->getServiceContext()->getFastClockSource()),
+      _lastYieldTime(_clock->now()),
       _planYielding(exec) {}
 
 
@@ -56,6 +87,8 @@ PlanYieldPolicy::PlanYieldPolicy(PlanExecutor::YieldPolicy policy, ClockSource*
       _elapsedTracker(cs,
                       internalQueryExecYieldIterations,
                       Milliseconds(internalQueryExecYieldPeriodMS.load())),
+      _clock(cs),
+      _lastYieldTime(_clock->now()),
       _planYielding(nullptr) {}
 
 bool PlanYieldPolicy::shouldYield() {
@@ -64,11 +97,24 @@ bool PlanYieldPolicy::shouldYield() {
     invariant(!_planYielding->getOpCtx()->lockState()->inAWriteUnitOfWork());
     if (_forceYield)
         return true;
-    return _elapsedTracker.intervalHasElapsed();
+    if (!_elapsedTracker.intervalHasElapsed())
+        return false;
+    if (!internalQueryExecYieldOnlyWhenContended.load() || isContended())
+        return true;
+
+    // Giving up locks nobody waits for only costs the restore. Still yield now and then, so that
+    // the operation notices interrupts and doesn't pin its storage engine snapshot for too long.
+    if (_clock->now() - _lastYieldTime >=
+        Milliseconds(internalQueryExecUncontendedYieldPeriodMS.load())) {
+        return true;
+    }
+    _yieldStats.numSkippedYields++;
+    return false;
 }
 
 void PlanYieldPolicy::resetTimer() {
     _elapsedTracker.resetLastTime();
+    _lastYieldTime = _clock->now();
 }
 
 bool PlanYieldPolicy::yield(RecordFetcher* fetcher) {
@@ -80,6 +126,12 @@ bool PlanYieldPolicy::yield(RecordFetcher* fetcher) {
     // until after we return from the yield.
     ON_BLOCK_EXIT([this]() { resetTimer(); });
 
+    Timer yieldTimer;
+    ON_BLOCK_EXIT([this, &yieldTimer]() {
+        _yieldStats.numYields++;
+        _yieldStats.yieldTimeMicros += yieldTimer.micros();
+    });
+
     _forceYield = false;
 
     OperationContext* opCtx = _planYielding->getOpCtx();
@@ -39,6 +39,18 @@ class RecordFetcher;
 
 class PlanYieldPolicy {
 public:
+    struct YieldStats {
+        // Number of times the plan gave up its locks or storage engine snapshot.
+        long long numYields = 0;
+
+        // Number of times the plan was due to yield, but didn't because no other operation was
+        // waiting for a lock or a ticket.
+        long long numSkippedYields = 0;
+
+        // Time spent yielding, including saving and restoring the plan.
+        long long yieldTimeMicros = 0;
+    };
+
     /**
      * If policy == WRITE_CONFLICT_RETRY_ONLY, shouldYield will only return true after
      * forceYield has been called, and yield will only abandonSnapshot without releasing any
@@ -55,7 +67,9 @@ public:
     /**
      * Used by YIELD_AUTO plan executors in order to check whether it is time to yield.
      * PlanExecutors give up their locks periodically in order to be fair to other
-     * threads.
+     * threads. If internalQueryExecYieldOnlyWhenContended is set, a periodic yield is skipped
+     * while no operation is waiting for a lock or a ticket, unless the last yield was longer than
+     * internalQueryExecUncontendedYieldPeriodMS ago.
      */
     bool shouldYield();
 
@@ -93,12 +107,23 @@ public:
         _policy = policy;
     }
 
+    const YieldStats& getYieldStats() const {
+        return _yieldStats;
+    }
+
 private:
     PlanExecutor::YieldPolicy _policy;
 
     bool _forceYield;
     ElapsedTracker _elapsedTracker;
 
+    ClockSource* const _clock;
+
+    // When the plan last finished yielding, or when this policy was created.
+    Date_t _lastYieldTime;
+
+    YieldStats _yieldStats;
+
     // The plan executor which this yield policy is responsible for yielding. Must
     // not outlive the plan executor.
     PlanExecutor* const _planYielding;
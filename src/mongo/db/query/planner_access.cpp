@@ -37,15 +37,18 @@
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/matcher/expression_algo.h"
 #include "mongo/db/matcher/expression_array.h"
 #include "mongo/db/matcher/expression_geo.h"
 #include "mongo/db/matcher/expression_text.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/index_tag.h"
 #include "mongo/db/query/indexability.h"
+#include "mongo/db/query/planner_ixselect.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/timeseries/bucket.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 
@@ -126,12 +129,17 @@ QuerySolutionNode* QueryPlannerAccess::makeCollectionScan(const CanonicalQuery&
     csn->tailable = tailable;
     csn->maxScan = query.getQueryRequest().getMaxScan();
 
+    // A parallel scan returns documents in no particular order, so it is only used if the
+    // query neither asks for natural order nor stops after some number of documents scanned.
+    bool orderMatters = tailable || csn->maxScan != 0;
+
     // If the hint is {$natural: +-1} this changes the direction of the collection scan.
     if (!query.getQueryRequest().getHint().isEmpty()) {
         BSONElement natural =
             dps::extractElementAtPath(query.getQueryRequest().getHint(), "$natural");
         if (!natural.eoo()) {
             csn->direction = natural.numberInt() >= 0 ? 1 : -1;
+            orderMatters = true;
         }
     }
 
@@ -142,9 +150,28 @@ QuerySolutionNode* QueryPlannerAccess::makeCollectionScan(const CanonicalQuery&
         BSONElement natural = dps::extractElementAtPath(sortObj, "$natural");
         if (!natural.eoo()) {
             csn->direction = natural.numberInt() >= 0 ? 1 : -1;
+            orderMatters = true;
         }
     }
 
+    // A scan that competes with indexed plans in the MultiPlanStage is never parallel, so
+    // that trial runs do not start worker threads.
+    csn->parallel = (params.options & QueryPlannerParams::PARALLEL_COLLSCAN) &&
+        !(params.options & QueryPlannerParams::INCLUDE_COLLSCAN) && !orderMatters;
+
+    // The records of a time-series collection are buckets: scan those whose window of time and
+    // meta can hold a match, and filter the measurements they hold.
+    if (params.timeseries) {
+        csn->filter = TimeseriesBucket::createFilter(
+            *params.timeseries, query.root(), query.getCollator());
+
+        UnpackBucketNode* unpack = new UnpackBucketNode();
+        unpack->options = *params.timeseries;
+        unpack->filter = query.root()->shallowClone();
+        unpack->children.push_back(csn);
+        return unpack;
+    }
+
     return csn;
 }
 
@@ -209,6 +236,7 @@ QuerySolutionNode* QueryPlannerAccess::makeLeafNode(
         IndexScanNode* isn = new IndexScanNode();
         isn->indexKeyPattern = index.keyPattern;
         isn->indexIsMultiKey = index.multikey;
+        isn->indexMultikeyPaths = index.multikeyPaths;
         isn->bounds.fields.resize(index.keyPattern.nFields());
         isn->maxScan = query.getQueryRequest().getMaxScan();
         isn->addKeyMetadata = query.getQueryRequest().returnKey();
@@ -1196,7 +1224,7 @@ QuerySolutionNode* QueryPlannerAccess::buildIndexedDataAccess(const CanonicalQue
             if (tightness == IndexBoundsBuilder::EXACT) {
                 return soln;
             } else if (tightness == IndexBoundsBuilder::INEXACT_COVERED &&
-                       !indices[tag->index].multikey) {
+                       !indices[tag->index].isMultikeyField(tag->pos)) {
                 verify(NULL == soln->filter.get());
                 soln->filter.reset(autoRoot.release());
                 return soln;
@@ -1249,6 +1277,7 @@ QuerySolutionNode* QueryPlannerAccess::scanWholeIndex(const IndexEntry& index,
     unique_ptr<IndexScanNode> isn = make_unique<IndexScanNode>();
     isn->indexKeyPattern = index.keyPattern;
     isn->indexIsMultiKey = index.multikey;
+    isn->indexMultikeyPaths = index.multikeyPaths;
     isn->maxScan = query.getQueryRequest().getMaxScan();
     isn->addKeyMetadata = query.getQueryRequest().returnKey();
     isn->indexCollator = index.collator;
@@ -1278,6 +1307,94 @@ QuerySolutionNode* QueryPlannerAccess::scanWholeIndex(const IndexEntry& index,
     return solnRoot;
 }
 
+// static
+QuerySolutionNode* QueryPlannerAccess::skipScanIndex(const IndexEntry& index,
+                                                     const CanonicalQuery& query,
+                                                     const QueryPlannerParams& params) {
+    // Bounds from several predicates on a field may only be intersected if the index isn't
+    // multikey.
+    if (INDEX_BTREE != index.type || index.multikey || index.sparse ||
+        index.keyPattern.nFields() < 2) {
+        return NULL;
+    }
+
+    if (index.filterExpr && !expression::isSubsetOf(query.root(), index.filterExpr)) {
+        return NULL;
+    }
+
+    BSONObjIterator kpIt(index.keyPattern);
+    const BSONElement firstElt = kpIt.next();
+    const BSONElement secondElt = kpIt.next();
+
+    // Gather the predicates which can be ANDed together to bound the second field.
+    std::vector<const MatchExpression*> preds;
+    MatchExpression* root = query.root();
+    const bool isAnd = MatchExpression::AND == root->matchType();
+    const size_t numPreds = isAnd ? root->numChildren() : 1;
+    for (size_t i = 0; i < numPreds; ++i) {
+        MatchExpression* pred = isAnd ? root->getChild(i) : root;
+        if (pred->path() == firstElt.fieldNameStringData()) {
+            // The first field is constrained, so the enumerator already considered this index.
+            return NULL;
+        }
+
+        switch (pred->matchType()) {
+            case MatchExpression::EQ:
+            case MatchExpression::LT:
+            case MatchExpression::LTE:
+            case MatchExpression::GT:
+            case MatchExpression::GTE:
+            case MatchExpression::MATCH_IN:
+                break;
+            default:
+                continue;
+        }
+
+        if (pred->path() == secondElt.fieldNameStringData() &&
+            QueryPlannerIXSelect::compatible(secondElt, index, pred, query.getCollator())) {
+            preds.push_back(pred);
+        }
+    }
+
+    if (preds.empty()) {
+        return NULL;
+    }
+
+    unique_ptr<IndexScanNode> isn = make_unique<IndexScanNode>();
+    isn->indexKeyPattern = index.keyPattern;
+    isn->indexIsMultiKey = index.multikey;
+    isn->indexMultikeyPaths = index.multikeyPaths;
+    isn->maxScan = query.getQueryRequest().getMaxScan();
+    isn->addKeyMetadata = query.getQueryRequest().returnKey();
+    isn->indexCollator = index.collator;
+    isn->queryCollator = query.getCollator();
+
+    BSONObjIterator it(index.keyPattern);
+    while (it.more()) {
+        const BSONElement elt = it.next();
+        isn->bounds.fields.push_back(OrderedIntervalList());
+        OrderedIntervalList* oil = &isn->bounds.fields.back();
+        if (elt.fieldNameStringData() != secondElt.fieldNameStringData()) {
+            IndexBoundsBuilder::allValuesForField(elt, oil);
+            continue;
+        }
+
+        IndexBoundsBuilder::BoundsTightness tightness;
+        IndexBoundsBuilder::translate(preds[0], elt, index, oil, &tightness);
+        for (size_t i = 1; i < preds.size(); ++i) {
+            IndexBoundsBuilder::translateAndIntersect(preds[i], elt, index, oil, &tightness);
+        }
+    }
+    IndexBoundsBuilder::alignBounds(&isn->bounds, index.keyPattern);
+
+    // The bounds only narrow down the keys to look at, so the whole query is applied after the
+    // fetch.
+    unique_ptr<FetchNode> fetch = make_unique<FetchNode>();
+    fetch->filter = query.root()->shallowClone();
+    fetch->children.push_back(isn.release());
+    return fetch.release();
+}
+
 // static
 void QueryPlannerAccess::addFilterToSolutionNode(QuerySolutionNode* node,
                                                  MatchExpression* match,
@@ -1355,18 +1472,18 @@ void QueryPlannerAccess::handleFilterAnd(ScanBuildingState* scanState) {
         root->getChildVector()->erase(root->getChildVector()->begin() + scanState->curChild);
         delete child;
     } else if (scanState->tightness == IndexBoundsBuilder::INEXACT_COVERED &&
-               (INDEX_TEXT == index.type || !index.multikey)) {
+               (INDEX_TEXT == index.type || !index.isMultikeyField(scanState->ixtag->pos))) {
         // The bounds are not exact, but the information needed to
         // evaluate the predicate is in the index key. Remove the
         // MatchExpression from its parent and attach it to the filter
         // of the index scan we're building.
         //
-        // We can only use this optimization if the index is NOT multikey.
+        // We can only use this optimization if the field is NOT multikey.
         // Suppose that we had the multikey index {x: 1} and a document
         // {x: ["a", "b"]}. Now if we query for {x: /b/} the filter might
         // ever only be applied to the index key "a". We'd incorrectly
         // conclude that the document does not match the query :( so we
-        // gotta stick to non-multikey indices.
+        // gotta stick to fields which have the same value in every key.
         root->getChildVector()->erase(root->getChildVector()->begin() + scanState->curChild);
 
         addFilterToSolutionNode(scanState->currentScan.get(), child, root->matchType());
@@ -1387,6 +1504,7 @@ QuerySolutionNode* QueryPlannerAccess::makeIndexScan(const IndexEntry& index,
     IndexScanNode* isn = new IndexScanNode();
     isn->indexKeyPattern = index.keyPattern;
     isn->indexIsMultiKey = index.multikey;
+    isn->indexMultikeyPaths = index.multikeyPaths;
     isn->direction = 1;
     isn->maxScan = query.getQueryRequest().getMaxScan();
     isn->addKeyMetadata = query.getQueryRequest().returnKey();
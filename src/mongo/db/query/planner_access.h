@@ -197,6 +197,16 @@ public:
                                              const QueryPlannerParams& params,
                                              int direction = 1);
 
+    /**
+     * Return a plan that uses the provided compound index for a query with predicates on the
+     * index's second field but none on its first. The index scan's bounds cover every value of
+     * the first field, so the scan seeks from one distinct value of the first field to the next
+     * rather than reading the keys in between. Returns NULL if the index can't be used this way.
+     */
+    static QuerySolutionNode* skipScanIndex(const IndexEntry& index,
+                                            const CanonicalQuery& query,
+                                            const QueryPlannerParams& params);
+
     /**
      * Return a plan that scans the provided index from [startKey to endKey).
      */
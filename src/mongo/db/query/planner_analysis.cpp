@@ -89,6 +89,38 @@ bool isUnionOfPoints(const OrderedIntervalList& oil) {
     return true;
 }
 
+/**
+ * Returns true if 'node' provides every field of the shard key in its index key data.
+ *
+ * NOTE: Solution nodes only list ordinary, non-transformed index keys for now.
+ */
+bool hasShardKeyFields(const QueryPlannerParams& params, const QuerySolutionNode* node) {
+    for (auto&& elem : params.shardKey) {
+        if (!node->hasField(elem.fieldName())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Returns true if 'solnRoot' fetches the results of an index scan whose keys have every shard key
+ * field, so that the sharding filter can go between the two. The index must not have a collation,
+ * since the shard key values in its keys would then differ from those in the documents.
+ */
+bool canShardFilterBelowFetch(const QueryPlannerParams& params, const QuerySolutionNode* solnRoot) {
+    if (STAGE_FETCH != solnRoot->getType()) {
+        return false;
+    }
+
+    const QuerySolutionNode* child = solnRoot->children[0];
+    if (STAGE_IXSCAN != child->getType() ||
+        static_cast<const IndexScanNode*>(child)->indexCollator) {
+        return false;
+    }
+    return hasShardKeyFields(params, child);
+}
+
 /**
  * Should we try to expand the index scan(s) in 'solnRoot' to pull out an indexed sort?
  *
@@ -114,8 +146,15 @@ bool structureOKForExplode(QuerySolutionNode* solnRoot, QuerySolutionNode** toRe
     }
 
     if (STAGE_FETCH == solnRoot->getType()) {
-        if (STAGE_IXSCAN == solnRoot->children[0]->getType()) {
-            *toReplace = solnRoot->children[0];
+        QuerySolutionNode* child = solnRoot->children[0];
+
+        // Skip over a sharding filter stage below the fetch.
+        if (STAGE_SHARDING_FILTER == child->getType()) {
+            child = child->children[0];
+        }
+
+        if (STAGE_IXSCAN == child->getType()) {
+            *toReplace = child;
             return true;
         }
     }
@@ -219,6 +258,7 @@ void explodeScan(const IndexScanNode* isn,
         child->maxScan = isn->maxScan;
         child->addKeyMetadata = isn->addKeyMetadata;
         child->indexIsMultiKey = isn->indexIsMultiKey;
+        child->indexMultikeyPaths = isn->indexMultikeyPaths;
         child->indexCollator = isn->indexCollator;
         child->queryCollator = isn->queryCollator;
 
@@ -292,6 +332,82 @@ void geoSkipValidationOn(const std::set<StringData>& twoDSphereFields,
     }
 }
 
+/**
+ * Returns the leading component of the dotted path 'path'.
+ */
+std::string topLevelField(StringData path) {
+    return path.substr(0, path.find('.')).toString();
+}
+
+/**
+ * Adds the top-level fields that 'expr' reads to 'fields'. Returns false if 'expr' may look at
+ * parts of the document that can't be named, such as a $where.
+ */
+bool getFilterFields(const MatchExpression* expr, std::set<std::string>* fields) {
+    switch (expr->matchType()) {
+        case MatchExpression::AND:
+        case MatchExpression::OR:
+        case MatchExpression::NOR:
+        case MatchExpression::NOT:
+            for (size_t i = 0; i < expr->numChildren(); ++i) {
+                if (!getFilterFields(expr->getChild(i), fields)) {
+                    return false;
+                }
+            }
+            return true;
+        case MatchExpression::ALWAYS_FALSE:
+            return true;
+        default:
+            if (expr->path().empty()) {
+                return false;
+            }
+            fields->insert(topLevelField(expr->path()));
+            return true;
+    }
+}
+
+/**
+ * If 'solnRoot' is a collection scan topped only by stages that don't change documents, tells
+ * the scan which top-level fields the stages above it and the simple inclusion projection
+ * 'proj' will look at, so that the storage engine can skip reading the rest of each document.
+ */
+void setCollscanFieldSubset(const CanonicalQuery& query,
+                            const QueryPlannerParams& params,
+                            QuerySolutionNode* solnRoot) {
+    std::set<std::string> fields;
+    QuerySolutionNode* node = solnRoot;
+    while (STAGE_COLLSCAN != node->getType()) {
+        if (STAGE_SORT == node->getType()) {
+            const BSONObj& sortPattern = static_cast<SortNode*>(node)->pattern;
+            for (auto&& elem : sortPattern) {
+                fields.insert(topLevelField(elem.fieldNameStringData()));
+            }
+        } else if (STAGE_SHARDING_FILTER == node->getType()) {
+            for (auto&& elem : params.shardKey) {
+                fields.insert(topLevelField(elem.fieldNameStringData()));
+            }
+        } else if (STAGE_SORT_KEY_GENERATOR != node->getType()) {
+            return;
+        }
+
+        if (1 != node->children.size()) {
+            return;
+        }
+        node = node->children[0];
+    }
+
+    if (node->filter && !getFilterFields(node->filter.get(), &fields)) {
+        return;
+    }
+
+    for (StringData field : query.getProj()->getRequiredFields()) {
+        fields.insert(field.toString());
+    }
+
+    CollectionScanNode* csn = static_cast<CollectionScanNode*>(node);
+    csn->fieldSubset.assign(fields.begin(), fields.end());
+}
+
 }  // namespace
 
 // static
@@ -600,6 +716,16 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
         sort->limit = 0;
     }
 
+    // A text search sorted by text score alone with a limit only needs the highest scoring
+    // documents, which the TEXT stage can find without scoring every matching document.
+    if (sort->limit && sortObj.nFields() == 1 &&
+        QueryRequest::isTextScoreMeta(sortObj.firstElement())) {
+        QuerySolutionNode* sortInput = keyGenNode->children[0];
+        if (STAGE_TEXT == sortInput->getType()) {
+            static_cast<TextNode*>(sortInput)->topK = sort->limit;
+        }
+    }
+
     *blockingSortOut = true;
 
     return solnRoot;
@@ -623,30 +749,23 @@ QuerySolution* QueryPlannerAnalysis::analyzeDataAccess(const CanonicalQuery& que
     // If we're answering a query on a sharded system, we need to drop documents that aren't
     // logically part of our shard.
     if (params.options & QueryPlannerParams::INCLUDE_SHARD_FILTER) {
-        if (!solnRoot->fetched()) {
-            // See if we need to fetch information for our shard key.
-            // NOTE: Solution nodes only list ordinary, non-transformed index keys for now
-
-            bool fetch = false;
-            BSONObjIterator it(params.shardKey);
-            while (it.more()) {
-                BSONElement nextEl = it.next();
-                if (!solnRoot->hasField(nextEl.fieldName())) {
-                    fetch = true;
-                    break;
-                }
-            }
+        ShardingFilterNode* sfn = new ShardingFilterNode();
 
-            if (fetch) {
+        if (canShardFilterBelowFetch(params, solnRoot)) {
+            // Filter out orphans by their index keys, so that they are never fetched.
+            sfn->children.push_back(solnRoot->children[0]);
+            solnRoot->children[0] = sfn;
+        } else {
+            if (!solnRoot->fetched() && !hasShardKeyFields(params, solnRoot)) {
+                // We need to fetch information for our shard key.
                 FetchNode* fetch = new FetchNode();
                 fetch->children.push_back(solnRoot);
                 solnRoot = fetch;
             }
-        }
 
-        ShardingFilterNode* sfn = new ShardingFilterNode();
-        sfn->children.push_back(solnRoot);
-        solnRoot = sfn;
+            sfn->children.push_back(solnRoot);
+            solnRoot = sfn;
+        }
     }
 
     bool hasSortStage = false;
@@ -817,6 +936,11 @@ QuerySolution* QueryPlannerAnalysis::analyzeDataAccess(const CanonicalQuery& que
         projNode->projection = qr.getProj();
         projNode->projType = projType;
         projNode->coveredKeyObj = coveredKeyObj;
+
+        if (ProjectionNode::SIMPLE_DOC == projType) {
+            setCollscanFieldSubset(query, params, solnRoot);
+        }
+
         solnRoot = projNode;
     } else {
         // If there's no projection, we must fetch, as the user wants the entire doc.
@@ -38,12 +38,20 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationCollFraction, double, 0
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationMaxResults, int, 101);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationMaxCandidates, int, 8);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheSize, int, 5000);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheMaxSizeBytes, long long, 512 * 1024 * 1024);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheFeedbacksStored, int, 20);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheEvictionRatio, double, 10.0);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheBackgroundReplan, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheBackgroundReplanDriftRatio, double, 4.0);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerMaxIndexedSolutions, int, 64);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryEnumerationMaxOrSolutions, int, 10);
@@ -56,14 +64,39 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerEnableIndexIntersection, bool,
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerEnableHashIntersection, bool, false);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerEnableSkipScan, bool, false);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanOrChildrenIndependently, bool, true);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryMaxScansToExplode, int, 200);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecMaxBlockingSortBytes, int, 32 * 1024 * 1024);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecSortAllowDiskUse, bool, false);
+
 // Yield every 128 cycles or 10ms.
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldIterations, int, 128);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldPeriodMS, int, 10);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecLowPriorityYieldFactor, int, 4);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldOnlyWhenContended, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecUncontendedYieldPeriodMS, int, 100);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecWorkBatchSize, int, 1);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecFetchReadAhead, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecParallelCollScanThreads, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecParallelSampleThreads, int, 0);
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecParallelSampleMaxSampleRatio, double, 0.5);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecSharedCollectionScans, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryAggUseDocumentArena, bool, false);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryAwaitDataCoalesceMicros, int, 0);
+
 }  // namespace mongo
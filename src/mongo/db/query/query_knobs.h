@@ -49,6 +49,10 @@ extern AtomicDouble internalQueryPlanEvaluationCollFraction;  // NOLINT
 // Stop working plans once a plan returns this many results.
 extern std::atomic<int> internalQueryPlanEvaluationMaxResults;  // NOLINT
 
+// If more than this many plans compete, the weakest are dropped from the race after the first
+// quarter of the trial period. Zero disables pruning.
+extern std::atomic<int> internalQueryPlanEvaluationMaxCandidates;  // NOLINT
+
 // Do we give a big ranking bonus to intersection plans?
 extern std::atomic<bool> internalQueryForceIntersectionPlans;  // NOLINT
 
@@ -58,6 +62,9 @@ extern std::atomic<bool> internalQueryPlannerEnableIndexIntersection;  // NOLINT
 // Do we use hash-based intersection for rooted $and queries?
 extern std::atomic<bool> internalQueryPlannerEnableHashIntersection;  // NOLINT
 
+// Do we consider skip scans over compound indexes whose first field the query doesn't constrain?
+extern std::atomic<bool> internalQueryPlannerEnableSkipScan;  // NOLINT
+
 //
 // plan cache
 //
@@ -65,6 +72,11 @@ extern std::atomic<bool> internalQueryPlannerEnableHashIntersection;  // NOLINT
 // How many entries in the cache?
 extern std::atomic<int> internalQueryCacheSize;  // NOLINT
 
+// How many bytes may the plan caches of all collections use together? Once the total estimated
+// size of the cache entries exceeds this, the least recently used entries of the collection whose
+// cache is being added to are evicted.
+extern std::atomic<long long> internalQueryCacheMaxSizeBytes;  // NOLINT
+
 // How many feedback entries do we collect before possibly evicting from the cache based on bad
 // performance?
 extern std::atomic<int> internalQueryCacheFeedbacksStored;  // NOLINT
@@ -73,6 +85,14 @@ extern std::atomic<int> internalQueryCacheFeedbacksStored;  // NOLINT
 // and replanning?
 extern AtomicDouble internalQueryCacheEvictionRatio;  // NOLINT
 
+// Should cached plans which perform badly be replanned on a background thread, instead of by the
+// query which noticed? The query then carries on with the cached plan.
+extern std::atomic<bool> internalQueryCacheBackgroundReplan;  // NOLINT
+
+// How many times more works per result than during its original trial period may a cached plan
+// perform before it is replanned in the background?
+extern AtomicDouble internalQueryCacheBackgroundReplanDriftRatio;  // NOLINT
+
 //
 // Planning and enumeration.
 //
@@ -99,12 +119,59 @@ extern std::atomic<int> internalQueryMaxScansToExplode;  // NOLINT
 
 extern std::atomic<int> internalQueryExecMaxBlockingSortBytes;  // NOLINT
 
+// If true, a blocking sort that exceeds internalQueryExecMaxBlockingSortBytes spills to disk rather
+// than failing the query.
+extern std::atomic<bool> internalQueryExecSortAllowDiskUse;  // NOLINT
+
 // Yield after this many "should yield?" checks.
 extern std::atomic<int> internalQueryExecYieldIterations;  // NOLINT
 
 // Yield if it's been at least this many milliseconds since we last yielded.
 extern std::atomic<int> internalQueryExecYieldPeriodMS;  // NOLINT
 
+// Low priority operations yield this many times as often.
+extern std::atomic<int> internalQueryExecLowPriorityYieldFactor;  // NOLINT
+
+// Skip yields which are due while no operation waits for a lock or a ticket.
+extern std::atomic<bool> internalQueryExecYieldOnlyWhenContended;  // NOLINT
+
+// Even when uncontended, yield if it's been at least this many milliseconds since we last yielded.
+extern std::atomic<int> internalQueryExecUncontendedYieldPeriodMS;  // NOLINT
+
+// If greater than 1, the PlanExecutor pulls results from its root stage in blocks of up to this
+// many units of work using PlanStage::workBatch(). Only storage engines with document-level
+// locking are eligible, as buffered results do not take part in invalidations.
+extern std::atomic<int> internalQueryExecWorkBatchSize;  // NOLINT
+
+// If true, a FetchStage working in blocks passes the RecordIds of each block to its record cursor
+// as a read-ahead hint before fetching them. See SeekableRecordCursor::readAhead().
+extern std::atomic<bool> internalQueryExecFetchReadAhead;  // NOLINT
+
+// If greater than 1, a find or aggregate whose only plan is a full collection scan runs the scan
+// and its filter on this many worker threads. See ParallelCollectionScan for eligibility.
+extern std::atomic<int> internalQueryExecParallelCollScanThreads;  // NOLINT
+
+// If greater than 1, an aggregation starting with a $sample draws its sample from random cursors
+// on this many worker threads, which also de-duplicate the sample by RecordId. Such a sample may
+// be up to 'internalQueryExecParallelSampleMaxSampleRatio' of the collection before $sample falls
+// back to sorting a collection scan, rather than the 5% allowed for a single random cursor.
+extern std::atomic<int> internalQueryExecParallelSampleThreads;  // NOLINT
+extern AtomicDouble internalQueryExecParallelSampleMaxSampleRatio;  // NOLINT
+
+// If true, a full forward scan of a collection which other scans are already reading starts where
+// they currently are, wraps around at the end and finishes where it started, so that concurrent
+// scans read the same pages at about the same time. Such scans do not return natural order.
+extern std::atomic<bool> internalQueryExecSharedCollectionScans;  // NOLINT
+
+// If true, an aggregation whose stages all let go of their input documents promptly allocates its
+// documents from a DocumentArena. See Pipeline::canUseDocumentArena().
+extern std::atomic<bool> internalQueryAggUseDocumentArena;  // NOLINT
+
+// If greater than 0, an awaitData getMore woken by an insert into its capped collection waits this
+// many more microseconds so that it returns a burst of inserts in one batch, instead of each
+// tailer being woken and running a getMore for every insert.
+extern std::atomic<int> internalQueryAwaitDataCoalesceMicros;  // NOLINT
+
 // Limit the size that we write without yielding to 16MB / 64 (max expected number of indexes)
 const int64_t insertVectorMaxBytes = 256 * 1024;
 
@@ -45,6 +45,7 @@
 #include "mongo/db/query/planner_access.h"
 #include "mongo/db/query/planner_analysis.h"
 #include "mongo/db/query/planner_ixselect.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/util/log.h"
@@ -231,6 +232,16 @@ QuerySolution* buildWholeIXSoln(const IndexEntry& index,
     return QueryPlannerAnalysis::analyzeDataAccess(query, params, solnRoot);
 }
 
+QuerySolution* buildSkipScanSoln(const IndexEntry& index,
+                                 const CanonicalQuery& query,
+                                 const QueryPlannerParams& params) {
+    QuerySolutionNode* solnRoot = QueryPlannerAccess::skipScanIndex(index, query, params);
+    if (NULL == solnRoot) {
+        return NULL;
+    }
+    return QueryPlannerAnalysis::analyzeDataAccess(query, params, solnRoot);
+}
+
 bool providesSort(const CanonicalQuery& query, const BSONObj& kp) {
     return query.getQueryRequest().getSort().isPrefixOf(kp);
 }
@@ -359,6 +370,15 @@ Status QueryPlanner::planFromCache(const CanonicalQuery& query,
             *out = soln;
             return Status::OK();
         }
+    } else if (SolutionCacheData::SKIP_IXSCAN_SOLN == winnerCacheData.solnType) {
+        // The solution skips from one value of the index's first field to the next.
+        QuerySolution* soln = buildSkipScanSoln(*winnerCacheData.tree->entry, query, params);
+        if (soln == NULL) {
+            return Status(ErrorCodes::BadValue, "plan cache error: skip scan soln");
+        } else {
+            *out = soln;
+            return Status::OK();
+        }
     } else if (SolutionCacheData::COLLSCAN_SOLN == winnerCacheData.solnType) {
         // The cached solution is a collection scan. We don't cache collscans
         // with tailable==true, hence the false below.
@@ -457,6 +477,19 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
         return Status::OK();
     }
 
+    // The indexes of a time-series collection, if any, are on its buckets rather than on the
+    // measurements which the query is about, so its only solution scans the buckets.
+    if (params.timeseries) {
+        if (canTableScan && !QueryPlannerCommon::hasNode(query.root(), MatchExpression::GEO_NEAR) &&
+            !QueryPlannerCommon::hasNode(query.root(), MatchExpression::TEXT)) {
+            QuerySolution* soln = buildCollscanSoln(query, isTailable, params);
+            if (NULL != soln) {
+                out->push_back(soln);
+            }
+        }
+        return Status::OK();
+    }
+
     // The hint or sort can be $natural: 1.  If this happens, output a collscan. If both
     // a $natural hint and a $natural sort are specified, then the direction of the collscan
     // is determined by the sign of the sort (not the sign of the hint).
@@ -815,6 +848,30 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
         return Status::OK();
     }
 
+    // A compound index whose first field is unconstrained can still be used for predicates on its
+    // second field, by skipping between the distinct values of the first field.
+    if (internalQueryPlannerEnableSkipScan.load() && !isTailable &&
+        !QueryPlannerCommon::hasNode(query.root(), MatchExpression::GEO_NEAR) &&
+        !QueryPlannerCommon::hasNode(query.root(), MatchExpression::TEXT)) {
+        for (size_t i = 0; i < params.indices.size() && out->size() < params.maxIndexedSolutions;
+             ++i) {
+            QuerySolution* soln = buildSkipScanSoln(params.indices[i], query, params);
+            if (NULL == soln) {
+                continue;
+            }
+
+            LOG(5) << "Planner: outputting skip scan soln:" << endl << soln->toString();
+            PlanCacheIndexTree* indexTree = new PlanCacheIndexTree();
+            indexTree->setIndexEntry(params.indices[i]);
+            SolutionCacheData* scd = new SolutionCacheData();
+            scd->tree.reset(indexTree);
+            scd->solnType = SolutionCacheData::SKIP_IXSCAN_SOLN;
+
+            soln->cacheData.reset(scd);
+            out->push_back(soln);
+        }
+    }
+
     // If a sort order is requested, there may be an index that provides it, even if that
     // index is not over any predicates in the query.
     //
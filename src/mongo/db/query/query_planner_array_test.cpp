@@ -1413,4 +1413,53 @@ TEST_F(QueryPlannerTest, CannotCompoundBoundsWhenSharedPrefixInsideElemMatchIsMu
         "bounds: {'a.b.c': [[2, 2, true, true]], 'a.b.d': [['MinKey', 'MaxKey', true, true]]}}}}}");
 }
 
+TEST_F(QueryPlannerTest, CanCoverNonMultikeyFieldOfMultikeyIndex) {
+    MultikeyPaths multikeyPaths{std::set<size_t>{}, {0U}};
+    addIndex(BSON("a" << 1 << "b" << 1), multikeyPaths);
+    runQuerySortProj(fromjson("{a: 5}"), BSONObj(), fromjson("{_id: 0, a: 1}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{proj: {spec: {_id: 0, a: 1}, node: {cscan: {dir: 1, filter: {a: 5}}}}}");
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1}, node: {ixscan: {filter: null, pattern: {a: 1, b: 1}, "
+        "bounds: {a: [[5, 5, true, true]], b: [['MinKey', 'MaxKey', true, true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, CannotCoverMultikeyFieldOfMultikeyIndex) {
+    MultikeyPaths multikeyPaths{std::set<size_t>{}, {0U}};
+    addIndex(BSON("a" << 1 << "b" << 1), multikeyPaths);
+    runQuerySortProj(fromjson("{a: 5}"), BSONObj(), fromjson("{_id: 0, a: 1, b: 1}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1, b: 1}, node: {cscan: {dir: 1, filter: {a: 5}}}}}");
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1, b: 1}, node: {fetch: {filter: null, node: {ixscan: "
+        "{pattern: {a: 1, b: 1}, bounds: {a: [[5, 5, true, true]], "
+        "b: [['MinKey', 'MaxKey', true, true]]}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, CanUseExactBoundsForNegationOfNonMultikeyFieldOfMultikeyIndex) {
+    MultikeyPaths multikeyPaths{std::set<size_t>{}, {0U}};
+    addIndex(BSON("a" << 1 << "b" << 1), multikeyPaths);
+    runQuerySortProj(fromjson("{a: {$ne: 5}}"), BSONObj(), fromjson("{_id: 0, a: 1}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1}, node: {cscan: {dir: 1, filter: {a: {$ne: 5}}}}}}");
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1}, node: {ixscan: {filter: null, pattern: {a: 1, b: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, CanFilterOnNonMultikeyFieldOfMultikeyIndexInIndexScan) {
+    MultikeyPaths multikeyPaths{std::set<size_t>{}, {0U}};
+    addIndex(BSON("a" << 1 << "b" << 1), multikeyPaths);
+    runQuery(fromjson("{a: /foo/}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {a: /foo/}}}");
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: {a: /foo/}, pattern: {a: 1, b: 1}}}}}");
+}
+
 }  // namespace
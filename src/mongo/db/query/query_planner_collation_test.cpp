@@ -343,4 +343,19 @@ TEST_F(QueryPlannerTest, CompoundIndexWithNonMatchingPrefixedCollatorDoesNotCaus
         "{node: {cscan: {dir: 1, filter : {a: 1, b: 2, c: {a: 1}}}}}}}}");
 }
 
+TEST_F(QueryPlannerTest, ShardFilterStaysAboveFetchOfIndexWithCollation) {
+    params.options = QueryPlannerParams::INCLUDE_SHARD_FILTER;
+    params.shardKey = BSON("a" << 1);
+    CollatorInterfaceMock collator(CollatorInterfaceMock::MockType::kReverseString);
+    addIndex(fromjson("{a: 1}"), &collator);
+
+    runQuery(fromjson("{a: 1, b: 1}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{sharding_filter: {node: "
+        "{fetch: {filter: {b: 1}, node: "
+        "{ixscan: {pattern: {a: 1}}}}}}}");
+}
+
 }  // namespace
@@ -36,11 +36,14 @@
 
 namespace mongo {
 
+struct TimeseriesOptions;
+
 struct QueryPlannerParams {
     QueryPlannerParams()
         : options(DEFAULT),
           indexFiltersApplied(false),
-          maxIndexedSolutions(internalQueryPlannerMaxIndexedSolutions) {}
+          maxIndexedSolutions(internalQueryPlannerMaxIndexedSolutions),
+          timeseries(nullptr) {}
 
     enum Options {
         // You probably want to set this.
@@ -95,6 +98,11 @@ struct QueryPlannerParams {
         // Set this if you don't want any plans with a non-covered projection stage. All projections
         // must be provided/covered by an index.
         NO_UNCOVERED_PROJECTIONS = 1 << 10,
+
+        // Set this if a collection scan may be run on several threads when it would be the only
+        // plan. The caller must use a YIELD_AUTO executor, as the scan waits for its worker
+        // threads while yielded. Results are not returned in natural order.
+        PARALLEL_COLLSCAN = 1 << 11,
     };
 
     // See Options enum above.
@@ -115,6 +123,10 @@ struct QueryPlannerParams {
     // plans via the MultiPlanStage, and the set of possible plans is very large for certain
     // index+query combinations.
     size_t maxIndexedSolutions;
+
+    // If set, the collection is a time-series collection whose buckets the query unpacks into
+    // measurements. Not owned.
+    const TimeseriesOptions* timeseries;
 };
 
 }  // namespace mongo
@@ -36,7 +36,9 @@
 #include "mongo/db/json.h"
 #include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner_test_fixture.h"
+#include "mongo/util/scopeguard.h"
 
 namespace {
 
@@ -1374,6 +1376,38 @@ TEST_F(QueryPlannerTest, ProjNonCovering) {
         "{ixscan: {filter: null, pattern: {x: 1}}}}}}}");
 }
 
+TEST_F(QueryPlannerTest, SimpleProjRestrictsCollscanFields) {
+    runQuerySortProj(fromjson("{'a.b': 1, $or: [{c: 2}, {d: {$ne: 3}}]}"),
+                     fromjson("{e: 1}"),
+                     fromjson("{x: 1, y: 1}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {x: 1, y: 1}, node: {sort: {pattern: {e: 1}, limit: 0, node: {sortKeyGen: "
+        "{node: {cscan: {dir: 1, fields: ['_id', 'a', 'c', 'd', 'e', 'x', 'y']}}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SimpleProjWithShardFilterRestrictsCollscanFields) {
+    params.options |= QueryPlannerParams::INCLUDE_SHARD_FILTER;
+    params.shardKey = BSON("s.t" << 1);
+    runQuerySortProj(fromjson("{a: 1}"), BSONObj(), fromjson("{_id: 0, x: 1}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, x: 1}, node: {sharding_filter: {node: "
+        "{cscan: {dir: 1, fields: ['a', 's', 'x']}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, CollscanReadsWholeDocumentsForWhereOrNonSimpleProj) {
+    runQuerySortProj(fromjson("{$where: 'this.a == 1'}"), BSONObj(), fromjson("{x: 1}"));
+    assertNumSolutions(1U);
+    assertSolutionExists("{proj: {spec: {x: 1}, node: {cscan: {dir: 1, fields: []}}}}");
+
+    runQuerySortProj(fromjson("{a: 1}"), BSONObj(), fromjson("{x: 0}"));
+    assertNumSolutions(1U);
+    assertSolutionExists("{proj: {spec: {x: 0}, node: {cscan: {dir: 1, fields: []}}}}");
+}
+
 //
 // Basic sort
 //
@@ -3840,6 +3874,66 @@ TEST_F(QueryPlannerTest, ShardFilterNoIndexNotCovered) {
         "{ixscan: {pattern: {b: 1}}}}}}}}}");
 }
 
+TEST_F(QueryPlannerTest, ShardFilterBelowFetchWithFilter) {
+    params.options = QueryPlannerParams::INCLUDE_SHARD_FILTER;
+    params.shardKey = BSON("a" << 1);
+    addIndex(BSON("a" << 1));
+
+    runQuery(fromjson("{a: {$gt: 1}, b: 1}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: {b: 1}, node: "
+        "{sharding_filter: {node: "
+        "{ixscan: {pattern: {a: 1}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, ShardFilterBelowFetchCompoundShardKeyPrefix) {
+    params.options = QueryPlannerParams::INCLUDE_SHARD_FILTER;
+    params.shardKey = BSON("a" << 1 << "b" << 1);
+    addIndex(BSON("a" << 1 << "b" << 1 << "c" << 1));
+
+    runQuerySortProj(fromjson("{a: 1, d: 1}"), BSONObj(), fromjson("{_id: 0, d: 1}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, d: 1}, node: "
+        "{fetch: {filter: {d: 1}, node: "
+        "{sharding_filter: {node: "
+        "{ixscan: {pattern: {a: 1, b: 1, c: 1}}}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, ShardFilterAboveFetchWhenIndexLacksShardKeyField) {
+    params.options = QueryPlannerParams::INCLUDE_SHARD_FILTER;
+    params.shardKey = BSON("a" << 1 << "b" << 1);
+    addIndex(BSON("a" << 1));
+
+    runQuery(fromjson("{a: 1, c: 1}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{sharding_filter: {node: "
+        "{fetch: {filter: {c: 1}, node: "
+        "{ixscan: {pattern: {a: 1}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, ExplodeForSortWorksWithShardingFilterBelowFetch) {
+    params.options = QueryPlannerParams::NO_TABLE_SCAN;
+    params.options |= QueryPlannerParams::INCLUDE_SHARD_FILTER;
+    params.shardKey = BSON("a" << 1);
+
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuerySortProj(fromjson("{a: {$in: [1, 3]}, c: 1}"), fromjson("{b: 1}"), BSONObj());
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: {c: 1}, node: {sharding_filter: {node: {mergeSort: {nodes: ["
+        "{ixscan:  {pattern: {a:1,b:1}, filter: null, bounds: {a: [[1,1,true,true]], b: "
+        "[['MinKey','MaxKey',true,true]]}}},"
+        "{ixscan:  {pattern: {a:1,b:1}, filter: null, bounds: {a: [[3,3,true,true]], b: "
+        "[['MinKey','MaxKey',true,true]]}}}]}}}}}}");
+}
+
 TEST_F(QueryPlannerTest, CannotTrimIxisectParam) {
     params.options = QueryPlannerParams::CANNOT_TRIM_IXISECT;
     params.options |= QueryPlannerParams::INDEX_INTERSECTION;
@@ -4236,4 +4330,58 @@ TEST_F(QueryPlannerTest, NToReturnHackWithSingleBatch) {
         "{cscan: {dir:1, filter: {}}}}}}}");
 }
 
+//
+// Skip scans
+//
+
+TEST_F(QueryPlannerTest, SkipScanUsesCompoundIndexWithUnconstrainedFirstField) {
+    bool oldEnableSkipScan = internalQueryPlannerEnableSkipScan.load();
+    ON_BLOCK_EXIT([oldEnableSkipScan] { internalQueryPlannerEnableSkipScan = oldEnableSkipScan; });
+    internalQueryPlannerEnableSkipScan = true;
+
+    addIndex(BSON("a" << 1 << "b" << 1 << "c" << 1));
+    runQuery(fromjson("{b: {$gt: 2, $lte: 5}, d: 1}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: {b: {$gt: 2, $lte: 5}, d: 1}, node: {ixscan: {pattern: "
+        "{a: 1, b: 1, c: 1}, bounds: {a: [['MinKey','MaxKey',true,true]], "
+        "b: [[2,5,false,true]], c: [['MinKey','MaxKey',true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedWhenDisabled) {
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedForMultikeyIndex) {
+    bool oldEnableSkipScan = internalQueryPlannerEnableSkipScan.load();
+    ON_BLOCK_EXIT([oldEnableSkipScan] { internalQueryPlannerEnableSkipScan = oldEnableSkipScan; });
+    internalQueryPlannerEnableSkipScan = true;
+
+    const bool multikey = true;
+    addIndex(BSON("a" << 1 << "b" << 1), multikey);
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedWhenFirstFieldIsConstrained) {
+    bool oldEnableSkipScan = internalQueryPlannerEnableSkipScan.load();
+    ON_BLOCK_EXIT([oldEnableSkipScan] { internalQueryPlannerEnableSkipScan = oldEnableSkipScan; });
+    internalQueryPlannerEnableSkipScan = true;
+
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{a: {$gt: 1}, b: 5}"));
+
+    // Only the collection scan and the ordinary index scan.
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+}
+
 }  // namespace
@@ -239,6 +239,23 @@ bool QueryPlannerTestLib::solutionMatches(const BSONObj& testSoln,
             return false;
         }
 
+        BSONElement fields = csObj["fields"];
+        if (!fields.eoo()) {
+            if (Array != fields.type()) {
+                return false;
+            }
+            std::vector<std::string> expectedFields;
+            for (auto&& field : fields.Obj()) {
+                if (String != field.type()) {
+                    return false;
+                }
+                expectedFields.push_back(field.String());
+            }
+            if (expectedFields != csn->fieldSubset) {
+                return false;
+            }
+        }
+
         BSONElement filter = csObj["filter"];
         if (filter.eoo()) {
             return true;
@@ -389,6 +406,13 @@ bool QueryPlannerTestLib::solutionMatches(const BSONObj& testSoln,
             }
         }
 
+        BSONElement topKElt = textObj["topK"];
+        if (!topKElt.eoo()) {
+            if (!topKElt.isNumber() || topKElt.numberLong() != static_cast<long long>(node->topK)) {
+                return false;
+            }
+        }
+
         BSONObj collation;
         if (BSONElement collationElt = textObj["collation"]) {
             if (!collationElt.isABSONObj()) {
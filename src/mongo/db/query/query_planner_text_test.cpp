@@ -461,4 +461,43 @@ TEST_F(QueryPlannerTest, SortKeyMetaProjectionWithTextScoreMetaSort) {
         "{sortKeyGen: {node: {text: {search: 'foo'}}}}}}}}");
 }
 
+TEST_F(QueryPlannerTest, TextScoreSortWithLimitOnlyNeedsTopK) {
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx"
+                  << 1));
+
+    runQuerySortProjSkipNToReturn(fromjson("{$text: {$search: 'foo bar'}}"),
+                                  fromjson("{a: {$meta: 'textScore'}}"),
+                                  fromjson("{a: {$meta: 'textScore'}}"),
+                                  5,
+                                  10);
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {a: {$meta: 'textScore'}}, node: "
+        "{skip: {n: 5, node: "
+        "{sort: {limit: 15, pattern: {a: {$meta: 'textScore'}}, node: "
+        "{sortKeyGen: {node: {text: {search: 'foo bar', topK: 15}}}}}}}}}}");
+}
+
+TEST_F(QueryPlannerTest, TextSortWithLimitOnOtherFieldsNeedsEveryDocument) {
+    addIndex(BSON("_fts"
+                  << "text"
+                  << "_ftsx"
+                  << 1));
+
+    runQuerySortProjSkipNToReturn(fromjson("{$text: {$search: 'foo'}}"),
+                                  fromjson("{a: {$meta: 'textScore'}, b: 1}"),
+                                  fromjson("{a: {$meta: 'textScore'}}"),
+                                  0,
+                                  10);
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{proj: {spec: {a: {$meta: 'textScore'}}, node: "
+        "{sort: {limit: 10, pattern: {a: {$meta: 'textScore'}, b: 1}, node: "
+        "{sortKeyGen: {node: {text: {search: 'foo', topK: 0}}}}}}}}");
+}
+
 }  // namespace
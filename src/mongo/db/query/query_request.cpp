@@ -90,6 +90,7 @@ const char kMinField[] = "min";
 const char kReturnKeyField[] = "returnKey";
 const char kShowRecordIdField[] = "showRecordId";
 const char kSnapshotField[] = "snapshot";
+const char kRawDataField[] = "rawData";
 const char kTailableField[] = "tailable";
 const char kOplogReplayField[] = "oplogReplay";
 const char kNoCursorTimeoutField[] = "noCursorTimeout";
@@ -282,6 +283,13 @@ StatusWith<unique_ptr<QueryRequest>> QueryRequest::makeFromFindCommand(Namespace
             }
 
             qr->_snapshot = el.boolean();
+        } else if (str::equals(fieldName, kRawDataField)) {
+            Status status = checkFieldType(el, Bool);
+            if (!status.isOK()) {
+                return status;
+            }
+
+            qr->_rawData = el.boolean();
         } else if (str::equals(fieldName, kTailableField)) {
             Status status = checkFieldType(el, Bool);
             if (!status.isOK()) {
@@ -452,6 +460,10 @@ void QueryRequest::asFindCommand(BSONObjBuilder* cmdBuilder) const {
         cmdBuilder->append(kSnapshotField, true);
     }
 
+    if (_rawData) {
+        cmdBuilder->append(kRawDataField, true);
+    }
+
     if (_tailable) {
         cmdBuilder->append(kTailableField, true);
     }
@@ -812,6 +824,9 @@ Status QueryRequest::initFullQuery(const BSONObj& top) {
             } else if (str::equals("snapshot", name)) {
                 // Won't throw.
                 _snapshot = e.trueValue();
+            } else if (str::equals("rawData", name)) {
+                // Won't throw.
+                _rawData = e.trueValue();
             } else if (str::equals("min", name)) {
                 if (!e.isABSONObj()) {
                     return Status(ErrorCodes::BadValue, "$min must be a BSONObj");
@@ -300,6 +300,18 @@ public:
         _snapshot = snapshot;
     }
 
+    /**
+     * Whether a query of a time-series collection returns its buckets as they are stored rather
+     * than the measurements they hold, as cloning and initial sync need.
+     */
+    bool isRawData() const {
+        return _rawData;
+    }
+
+    void setRawData(bool rawData) {
+        _rawData = rawData;
+    }
+
     bool hasReadPref() const {
         return _hasReadPref;
     }
@@ -465,6 +477,7 @@ private:
     bool _returnKey = false;
     bool _showRecordId = false;
     bool _snapshot = false;
+    bool _rawData = false;
     bool _hasReadPref = false;
 
     // Options that can be specified in the OP_QUERY 'flags' header.
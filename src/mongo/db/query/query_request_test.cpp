@@ -701,6 +701,26 @@ TEST(QueryRequestTest, ParseFromCommandSnapshotWrongType) {
     ASSERT_NOT_OK(result.getStatus());
 }
 
+TEST(QueryRequestTest, ParseFromCommandRawDataWrongType) {
+    BSONObj cmdObj = fromjson(
+        "{find: 'testns',"
+        "filter:  {a: 1},"
+        "rawData: 3}");
+    const NamespaceString nss("test.testns");
+    bool isExplain = false;
+    auto result = QueryRequest::makeFromFindCommand(nss, cmdObj, isExplain);
+    ASSERT_NOT_OK(result.getStatus());
+}
+
+TEST(QueryRequestTest, RawDataRoundTripsThroughFindCommand) {
+    BSONObj cmdObj = fromjson("{find: 'testns', rawData: true}");
+    const NamespaceString nss("test.testns");
+    std::unique_ptr<QueryRequest> qr(
+        assertGet(QueryRequest::makeFromFindCommand(nss, cmdObj, false)));
+    ASSERT_TRUE(qr->isRawData());
+    ASSERT_EQUALS(cmdObj, qr->asFindCommand());
+}
+
 TEST(QueryRequestTest, ParseFromCommandTailableWrongType) {
     BSONObj cmdObj = fromjson(
         "{find: 'testns',"
@@ -1023,6 +1043,7 @@ TEST(QueryRequestTest, DefaultQueryParametersCorrect) {
     ASSERT_EQUALS(false, qr->returnKey());
     ASSERT_EQUALS(false, qr->showRecordId());
     ASSERT_EQUALS(false, qr->isSnapshot());
+    ASSERT_EQUALS(false, qr->isRawData());
     ASSERT_EQUALS(false, qr->hasReadPref());
     ASSERT_EQUALS(false, qr->isTailable());
     ASSERT_EQUALS(false, qr->isSlaveOk());
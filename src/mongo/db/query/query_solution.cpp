@@ -193,6 +193,10 @@ void TextNode::appendToString(mongoutils::str::stream* ss, int indent) const {
     *ss << "diacriticSensitive= " << ftsQuery->getDiacriticSensitive() << '\n';
     addIndent(ss, indent + 1);
     *ss << "indexPrefix = " << indexPrefix.toString() << '\n';
+    if (topK) {
+        addIndent(ss, indent + 1);
+        *ss << "topK = " << topK << '\n';
+    }
     if (NULL != filter) {
         addIndent(ss, indent + 1);
         *ss << " filter = " << filter->toString();
@@ -208,6 +212,7 @@ QuerySolutionNode* TextNode::clone() const {
     copy->indexKeyPattern = this->indexKeyPattern;
     copy->ftsQuery = this->ftsQuery->clone();
     copy->indexPrefix = this->indexPrefix;
+    copy->topK = this->topK;
 
     return copy;
 }
@@ -216,13 +221,22 @@ QuerySolutionNode* TextNode::clone() const {
 // CollectionScanNode
 //
 
-CollectionScanNode::CollectionScanNode() : tailable(false), direction(1), maxScan(0) {}
+CollectionScanNode::CollectionScanNode()
+    : tailable(false), direction(1), maxScan(0), parallel(false) {}
 
 void CollectionScanNode::appendToString(mongoutils::str::stream* ss, int indent) const {
     addIndent(ss, indent);
     *ss << "COLLSCAN\n";
     addIndent(ss, indent + 1);
     *ss << "ns = " << name << '\n';
+    if (!fieldSubset.empty()) {
+        addIndent(ss, indent + 1);
+        *ss << "fields =";
+        for (const auto& field : fieldSubset) {
+            *ss << ' ' << field;
+        }
+        *ss << '\n';
+    }
     if (NULL != filter) {
         addIndent(ss, indent + 1);
         *ss << "filter = " << filter->toString();
@@ -239,6 +253,8 @@ QuerySolutionNode* CollectionScanNode::clone() const {
     copy->tailable = this->tailable;
     copy->direction = this->direction;
     copy->maxScan = this->maxScan;
+    copy->parallel = this->parallel;
+    copy->fieldSubset = this->fieldSubset;
 
     return copy;
 }
@@ -411,7 +427,7 @@ QuerySolutionNode* OrNode::clone() const {
 // MergeSortNode
 //
 
-MergeSortNode::MergeSortNode() : dedup(true) {}
+MergeSortNode::MergeSortNode() : dedup(true), singleSortKeyPerRecord(false) {}
 
 MergeSortNode::~MergeSortNode() {}
 
@@ -431,6 +447,55 @@ void MergeSortNode::appendToString(mongoutils::str::stream* ss, int indent) cons
     }
 }
 
+namespace {
+
+/**
+ * Returns true if 'node' is an index scan, possibly under a fetch, which produces each record
+ * under at most one value of 'sortPattern'.
+ */
+bool hasSingleSortKeyPerRecord(const QuerySolutionNode* node, const BSONObj& sortPattern) {
+    if (STAGE_FETCH == node->getType()) {
+        return hasSingleSortKeyPerRecord(node->children[0], sortPattern);
+    }
+    if (STAGE_IXSCAN != node->getType()) {
+        return false;
+    }
+
+    const IndexScanNode* ixn = static_cast<const IndexScanNode*>(node);
+    for (auto&& sortElt : sortPattern) {
+        size_t pos = 0;
+        bool found = false;
+        for (auto&& keyElt : ixn->indexKeyPattern) {
+            if (sortElt.fieldNameStringData() == keyElt.fieldNameStringData()) {
+                found = true;
+                break;
+            }
+            ++pos;
+        }
+        if (!found) {
+            return false;
+        }
+        if (ixn->indexIsMultiKey &&
+            (ixn->indexMultikeyPaths.empty() || !ixn->indexMultikeyPaths[pos].empty())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+void MergeSortNode::computeProperties() {
+    singleSortKeyPerRecord = !children.empty();
+    for (size_t i = 0; i < children.size(); ++i) {
+        children[i]->computeProperties();
+        singleSortKeyPerRecord =
+            singleSortKeyPerRecord && hasSingleSortKeyPerRecord(children[i], sort);
+    }
+    _sorts.clear();
+    _sorts.insert(sort);
+}
+
 bool MergeSortNode::fetched() const {
     // Any WSM output from this stage came exactly one child stage.  Given that we don't know
     // what child stage it came from, we require that all children provide fetched data in order
@@ -464,6 +529,7 @@ QuerySolutionNode* MergeSortNode::clone() const {
     copy->_sorts = this->_sorts;
     copy->dedup = this->dedup;
     copy->sort = this->sort;
+    copy->singleSortKeyPerRecord = this->singleSortKeyPerRecord;
 
     return copy;
 }
@@ -528,9 +594,10 @@ void IndexScanNode::appendToString(mongoutils::str::stream* ss, int indent) cons
 }
 
 bool IndexScanNode::hasField(const string& field) const {
-    // There is no covering in a multikey index because you don't know whether or not the field
-    // in the key was extracted from an array in the original document.
-    if (indexIsMultiKey) {
+    // A field of a multikey index can't be covered unless we know that none of its prefixes are
+    // arrays. Otherwise, we don't know whether or not the field in the key was extracted from an
+    // array in the original document.
+    if (indexIsMultiKey && indexMultikeyPaths.empty()) {
         return false;
     }
 
@@ -540,11 +607,13 @@ bool IndexScanNode::hasField(const string& field) const {
         return false;
     }
 
+    size_t pos = 0;
     BSONObjIterator it(indexKeyPattern);
     while (it.more()) {
         if (field == it.next().fieldName()) {
-            return true;
+            return !indexIsMultiKey || indexMultikeyPaths[pos].empty();
         }
+        ++pos;
     }
     return false;
 }
@@ -711,6 +780,7 @@ QuerySolutionNode* IndexScanNode::clone() const {
     copy->_sorts = this->_sorts;
     copy->indexKeyPattern = this->indexKeyPattern;
     copy->indexIsMultiKey = this->indexIsMultiKey;
+    copy->indexMultikeyPaths = this->indexMultikeyPaths;
     copy->direction = this->direction;
     copy->maxScan = this->maxScan;
     copy->addKeyMetadata = this->addKeyMetadata;
@@ -1036,6 +1106,10 @@ void DistinctNode::appendToString(mongoutils::str::stream* ss, int indent) const
     *ss << "DISTINCT\n";
     addIndent(ss, indent + 1);
     *ss << "keyPattern = " << indexKeyPattern << '\n';
+    if (NULL != filter) {
+        addIndent(ss, indent + 1);
+        *ss << "filter = " << filter->toString();
+    }
     addIndent(ss, indent + 1);
     *ss << "direction = " << direction << '\n';
     addIndent(ss, indent + 1);
@@ -1051,6 +1125,7 @@ QuerySolutionNode* DistinctNode::clone() const {
     copy->direction = this->direction;
     copy->bounds = this->bounds;
     copy->fieldNo = this->fieldNo;
+    copy->dedup = this->dedup;
 
     return copy;
 }
@@ -1108,4 +1183,37 @@ QuerySolutionNode* EnsureSortedNode::clone() const {
     return copy;
 }
 
+//
+// UnpackBucketNode
+//
+
+void UnpackBucketNode::appendToString(mongoutils::str::stream* ss, int indent) const {
+    addIndent(ss, indent);
+    *ss << "UNPACK_BUCKET\n";
+    addIndent(ss, indent + 1);
+    *ss << "timeField = " << options.timeField << '\n';
+    if (!options.metaField.empty()) {
+        addIndent(ss, indent + 1);
+        *ss << "metaField = " << options.metaField << '\n';
+    }
+    if (NULL != filter) {
+        addIndent(ss, indent + 1);
+        *ss << "filter = " << filter->toString();
+    }
+    addCommon(ss, indent);
+    addIndent(ss, indent + 1);
+    *ss << "Child:" << '\n';
+    children[0]->appendToString(ss, indent + 2);
+}
+
+QuerySolutionNode* UnpackBucketNode::clone() const {
+    UnpackBucketNode* copy = new UnpackBucketNode();
+    cloneBaseData(copy);
+
+    copy->_sort = this->_sort;
+    copy->options = this->options;
+
+    return copy;
+}
+
 }  // namespace mongo
@@ -31,11 +31,13 @@
 #include <memory>
 
 #include "mongo/db/fts/fts_query.h"
+#include "mongo/db/index/multikey_paths.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/query/index_bounds.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/stage_types.h"
+#include "mongo/db/timeseries/timeseries_options.h"
 
 namespace mongo {
 
@@ -251,6 +253,10 @@ struct TextNode : public QuerySolutionNode {
     // text node while creating the text leaf node and convert them into a BSONObj index prefix
     // when we finish the text leaf node.
     BSONObj indexPrefix;
+
+    // If non-zero, only the 'topK' documents with the highest text scores are needed, as the
+    // results are sorted by text score and limited.
+    size_t topK = 0;
 };
 
 struct CollectionScanNode : public QuerySolutionNode {
@@ -290,6 +296,14 @@ struct CollectionScanNode : public QuerySolutionNode {
 
     // maxScan option to .find() limits how many docs we look at.
     int maxScan;
+
+    // Can the scan be divided between worker threads? Only set if the query does not depend on
+    // the order of the scan.
+    bool parallel;
+
+    // If non-empty, the only top-level fields that the stages above the scan look at. Set when a
+    // simple inclusion projection lets the scan skip reading the rest of each document.
+    std::vector<std::string> fieldSubset;
 };
 
 struct AndHashNode : public QuerySolutionNode {
@@ -390,18 +404,18 @@ struct MergeSortNode : public QuerySolutionNode {
 
     QuerySolutionNode* clone() const;
 
-    virtual void computeProperties() {
-        for (size_t i = 0; i < children.size(); ++i) {
-            children[i]->computeProperties();
-        }
-        _sorts.clear();
-        _sorts.insert(sort);
-    }
+    virtual void computeProperties();
 
     BSONObjSet _sorts;
 
     BSONObj sort;
     bool dedup;
+
+    // True if every child is an index scan, possibly under a fetch, whose index is not multikey
+    // in any of the 'sort' fields. A record then has the same sort key in each child that
+    // returns it, which lets the stage forget the records it deduplicated against once the sort
+    // key has moved past them.
+    bool singleSortKeyPerRecord;
 };
 
 struct FetchNode : public QuerySolutionNode {
@@ -470,6 +484,10 @@ struct IndexScanNode : public QuerySolutionNode {
     BSONObj indexKeyPattern;
     bool indexIsMultiKey;
 
+    // Path-level multikey information for the index, in the format of IndexEntry::multikeyPaths.
+    // Empty if the index doesn't track it.
+    MultikeyPaths indexMultikeyPaths;
+
     int direction;
 
     // maxScan option to .find() limits how many docs we look at.
@@ -846,7 +864,7 @@ struct KeepMutationsNode : public QuerySolutionNode {
  * *always* skip over the current key to the next key.
  */
 struct DistinctNode : public QuerySolutionNode {
-    DistinctNode() {}
+    DistinctNode() : dedup(false) {}
     virtual ~DistinctNode() {}
 
     virtual StageType getType() const {
@@ -878,6 +896,8 @@ struct DistinctNode : public QuerySolutionNode {
     IndexBounds bounds;
     // We are distinct-ing over the 'fieldNo'-th field of 'indexKeyPattern'.
     int fieldNo;
+    // Whether the scan may drop keys of RecordIds it has already returned. See DistinctParams.
+    bool dedup;
 };
 
 /**
@@ -951,4 +971,38 @@ struct EnsureSortedNode : public QuerySolutionNode {
     BSONObj pattern;
 };
 
+/**
+ * Turns the buckets of a time-series collection which its child scans into the measurements they
+ * hold, and keeps those which pass the filter.
+ */
+struct UnpackBucketNode : public QuerySolutionNode {
+    UnpackBucketNode() {}
+    virtual ~UnpackBucketNode() {}
+
+    virtual StageType getType() const {
+        return STAGE_UNPACK_BUCKET;
+    }
+
+    virtual void appendToString(mongoutils::str::stream* ss, int indent) const;
+
+    bool fetched() const {
+        return true;
+    }
+    bool hasField(const std::string& field) const {
+        return true;
+    }
+    bool sortedByDiskLoc() const {
+        return false;
+    }
+    const BSONObjSet& getSort() const {
+        return _sort;
+    }
+
+    QuerySolutionNode* clone() const;
+
+    BSONObjSet _sort;
+
+    TimeseriesOptions options;
+};
+
 }  // namespace mongo
@@ -48,14 +48,17 @@
 #include "mongo/db/exec/limit.h"
 #include "mongo/db/exec/merge_sort.h"
 #include "mongo/db/exec/or.h"
+#include "mongo/db/exec/parallel_collection_scan.h"
 #include "mongo/db/exec/projection.h"
 #include "mongo/db/exec/shard_filter.h"
 #include "mongo/db/exec/skip.h"
 #include "mongo/db/exec/sort.h"
 #include "mongo/db/exec/sort_key_generator.h"
 #include "mongo/db/exec/text.h"
+#include "mongo/db/exec/unpack_bucket.h"
 #include "mongo/db/index/fts_access_method.h"
 #include "mongo/db/matcher/extensions_callback_real.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/s/collection_sharding_state.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -79,6 +82,13 @@ PlanStage* buildStages(OperationContext* txn,
         params.direction =
             (csn->direction == 1) ? CollectionScanParams::FORWARD : CollectionScanParams::BACKWARD;
         params.maxScan = csn->maxScan;
+        params.fieldSubset = csn->fieldSubset;
+
+        const int numWorkers = internalQueryExecParallelCollScanThreads.load();
+        if (csn->parallel && numWorkers > 1 &&
+            ParallelCollectionScan::canScanInParallel(txn, collection, csn->filter.get())) {
+            return new ParallelCollectionScan(txn, params, ws, csn->filter.get(), numWorkers);
+        }
         return new CollectionScan(txn, params, ws, csn->filter.get());
     } else if (STAGE_IXSCAN == root->getType()) {
         const IndexScanNode* ixn = static_cast<const IndexScanNode*>(root);
@@ -116,6 +126,7 @@ PlanStage* buildStages(OperationContext* txn,
         params.collection = collection;
         params.pattern = sn->pattern;
         params.limit = sn->limit;
+        params.allowDiskUse = internalQueryExecSortAllowDiskUse.load();
         return new SortStage(txn, params, ws, childStage);
     } else if (STAGE_SORT_KEY_GENERATOR == root->getType()) {
         const SortKeyGeneratorNode* keyGenNode = static_cast<const SortKeyGeneratorNode*>(root);
@@ -201,6 +212,7 @@ PlanStage* buildStages(OperationContext* txn,
         const MergeSortNode* msn = static_cast<const MergeSortNode*>(root);
         MergeSortStageParams params;
         params.dedup = msn->dedup;
+        params.singleSortKeyPerRecord = msn->singleSortKeyPerRecord;
         params.pattern = msn->sort;
         params.collator = cq.getCollator();
         auto ret = make_unique<MergeSortStage>(txn, params, ws, collection);
@@ -261,6 +273,7 @@ PlanStage* buildStages(OperationContext* txn,
         // planning a query that contains "no-op" expressions. TODO: make StageBuilder::build()
         // fail in this case (this improvement is being tracked by SERVER-21510).
         params.query = static_cast<FTSQueryImpl&>(*node->ftsQuery);
+        params.topK = node->topK;
         return new TextStage(txn, params, ws, node->filter.get());
     } else if (STAGE_SHARDING_FILTER == root->getType()) {
         const ShardingFilterNode* fn = static_cast<const ShardingFilterNode*>(root);
@@ -273,6 +286,13 @@ PlanStage* buildStages(OperationContext* txn,
             CollectionShardingState::get(txn, collection->ns())->getMetadata(),
             ws,
             childStage);
+    } else if (STAGE_UNPACK_BUCKET == root->getType()) {
+        const UnpackBucketNode* un = static_cast<const UnpackBucketNode*>(root);
+        PlanStage* childStage = buildStages(txn, collection, cq, qsol, un->children[0], ws);
+        if (NULL == childStage) {
+            return NULL;
+        }
+        return new UnpackBucketStage(txn, un->options, ws, un->filter.get(), childStage);
     } else if (STAGE_KEEP_MUTATIONS == root->getType()) {
         const KeepMutationsNode* km = static_cast<const KeepMutationsNode*>(root);
         PlanStage* childStage = buildStages(txn, collection, cq, qsol, km->children[0], ws);
@@ -296,6 +316,8 @@ PlanStage* buildStages(OperationContext* txn,
         params.direction = dn->direction;
         params.bounds = dn->bounds;
         params.fieldNo = dn->fieldNo;
+        params.filter = dn->filter.get();
+        params.dedup = dn->dedup;
         return new DistinctScan(txn, params, ws);
     } else if (STAGE_COUNT_SCAN == root->getType()) {
         const CountScanNode* csn = static_cast<const CountScanNode*>(root);
@@ -87,6 +87,10 @@ enum StageType {
     STAGE_MULTI_PLAN,
     STAGE_OPLOG_START,
     STAGE_OR,
+
+    // Collection scan divided between worker threads.
+    STAGE_PARALLEL_COLLSCAN,
+
     STAGE_PROJECTION,
 
     // Stage for running aggregation pipelines.
@@ -107,6 +111,9 @@ enum StageType {
 
     STAGE_UNKNOWN,
 
+    // Turns the buckets of a time-series collection into the measurements they hold.
+    STAGE_UNPACK_BUCKET,
+
     STAGE_UPDATE,
 };
 
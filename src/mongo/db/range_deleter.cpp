@@ -32,11 +32,13 @@
 
 #include "mongo/db/range_deleter.h"
 
+#include <algorithm>
 #include <boost/date_time/posix_time/posix_time_duration.hpp>
 #include <memory>
 
 #include "mongo/db/client.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/util/exit.h"
@@ -78,6 +80,14 @@ namespace mongo {
 
 namespace duration = boost::posix_time;
 
+namespace {
+
+// The number of threads which delete queued ranges. Ranges of different collections can be
+// deleted concurrently.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(rangeDeleterWorkers, int, 1);
+
+}  // namespace
+
 static void logCursorsWaiting(RangeDeleteEntry* entry) {
     // We always log the first cursors waiting message (so we have cursor ids in the logs).
     // After 15 minutes (the cursor timeout period), we start logging additional messages at
@@ -156,7 +166,9 @@ bool RangeDeleter::NSMinMaxCmp::operator()(const NSMinMax* lhs, const NSMinMax*
 RangeDeleter::RangeDeleter(RangeDeleterEnv* env)
     : _env(env),  // ownership xfer
       _stopRequested(false),
-      _deletesInProgress(0) {}
+      _deletesInProgress(0),
+      _deletedDocCount(0),
+      _deletedBytes(0) {}
 
 RangeDeleter::~RangeDeleter() {
     for (TaskList::iterator it = _notReadyQueue.begin(); it != _notReadyQueue.end(); ++it) {
@@ -179,8 +191,10 @@ RangeDeleter::~RangeDeleter() {
 }
 
 void RangeDeleter::startWorkers() {
-    if (!_worker) {
-        _worker.reset(new stdx::thread(stdx::bind(&RangeDeleter::doWork, this)));
+    if (_workers.empty()) {
+        for (int i = 0; i < std::max(1, rangeDeleterWorkers); i++) {
+            _workers.emplace_back(new stdx::thread(stdx::bind(&RangeDeleter::doWork, this)));
+        }
     }
 }
 
@@ -190,8 +204,8 @@ void RangeDeleter::stopWorkers() {
         _stopRequested = true;
     }
 
-    if (_worker) {
-        _worker->join();
+    for (auto&& worker : _workers) {
+        worker->join();
     }
 
     stdx::unique_lock<stdx::mutex> sl(_queueMutex);
@@ -352,7 +366,11 @@ bool RangeDeleter::deleteNow(OperationContext* txn,
     taskDetails.stats.queueEndTS = jsTime();
 
     taskDetails.stats.deleteStartTS = jsTime();
-    bool result = _env->deleteRange(txn, taskDetails, &taskDetails.stats.deletedDocCount, errMsg);
+    bool result = _env->deleteRange(txn,
+                                    taskDetails,
+                                    &taskDetails.stats.deletedDocCount,
+                                    &taskDetails.stats.deletedBytes,
+                                    errMsg);
 
     taskDetails.stats.deleteEndTS = jsTime();
 
@@ -421,7 +439,8 @@ void RangeDeleter::doWork() {
 
         {
             stdx::unique_lock<stdx::mutex> sl(_queueMutex);
-            while (_taskQueue.empty()) {
+            TaskList::iterator nextTaskIt;
+            while ((nextTaskIt = nextTask_inlock()) == _taskQueue.end()) {
                 _taskQueueNotEmptyCV.wait_for(
                     sl, Milliseconds(kNotEmptyTimeoutMillis).toSystemDuration());
 
@@ -471,17 +490,21 @@ void RangeDeleter::doWork() {
                 return;
             }
 
-            nextTask = _taskQueue.front();
-            _taskQueue.pop_front();
+            nextTask = *nextTaskIt;
+            _taskQueue.erase(nextTaskIt);
 
+            _workerNamespaces.insert(nextTask->options.range.ns);
             _deletesInProgress++;
         }
 
         {
             auto txn = client->makeOperationContext();
             nextTask->stats.deleteStartTS = jsTime();
-            bool delResult =
-                _env->deleteRange(txn.get(), *nextTask, &nextTask->stats.deletedDocCount, &errMsg);
+            bool delResult = _env->deleteRange(txn.get(),
+                                               *nextTask,
+                                               &nextTask->stats.deletedDocCount,
+                                               &nextTask->stats.deletedBytes,
+                                               &errMsg);
             nextTask->stats.deleteEndTS = jsTime();
 
             if (delResult) {
@@ -504,8 +527,14 @@ void RangeDeleter::doWork() {
                               nextTask->options.range.minKey,
                               nextTask->options.range.maxKey);
             deletePtrElement(&_deleteSet, &setEntry);
+            _workerNamespaces.erase(nextTask->options.range.ns);
             _deletesInProgress--;
 
+            // Another worker may be waiting for a task of this namespace.
+            if (!_taskQueue.empty()) {
+                _taskQueueNotEmptyCV.notify_one();
+            }
+
             if (nextTask->doneSignal) {
                 nextTask->doneSignal->set();
             }
@@ -517,6 +546,12 @@ void RangeDeleter::doWork() {
     }
 }
 
+RangeDeleter::TaskList::iterator RangeDeleter::nextTask_inlock() {
+    return std::find_if(_taskQueue.begin(), _taskQueue.end(), [this](RangeDeleteEntry* entry) {
+        return _workerNamespaces.count(entry->options.range.ns) == 0;
+    });
+}
+
 bool RangeDeleter::canEnqueue_inlock(StringData ns,
                                      const BSONObj& min,
                                      const BSONObj& max,
@@ -551,8 +586,21 @@ size_t RangeDeleter::getDeletesInProgress() const {
     return _deletesInProgress;
 }
 
+long long RangeDeleter::getDeletedDocCount() const {
+    stdx::lock_guard<stdx::mutex> sl(_statsHistoryMutex);
+    return _deletedDocCount;
+}
+
+long long RangeDeleter::getDeletedBytes() const {
+    stdx::lock_guard<stdx::mutex> sl(_statsHistoryMutex);
+    return _deletedBytes;
+}
+
 void RangeDeleter::recordDelStats(DeleteJobStats* newStat) {
     stdx::lock_guard<stdx::mutex> sl(_statsHistoryMutex);
+    _deletedDocCount += newStat->deletedDocCount;
+    _deletedBytes += newStat->deletedBytes;
+
     if (_statsHistory.size() == kDeleteJobsHistory) {
         delete _statsHistory.front();
         _statsHistory.pop_front();
@@ -61,9 +61,11 @@ struct RangeDeleterOptions;
  *
  * Threading assumptions:
  *
- *   This class has (currently) one worker thread attacking the queue, one
- *   job at a time. If we want an immediate deletion, that job is going to
- *   be performed on the thread that is requesting it.
+ *   This class has rangeDeleterWorkers worker threads attacking the queue,
+ *   each one job at a time. No two workers delete from the same namespace at
+ *   once, so that the ranges of a collection are deleted in queue order. If we
+ *   want an immediate deletion, that job is going to be performed on the thread
+ *   that is requesting it.
  *
  *   All calls regarding deletion are synchronized.
  *
@@ -96,15 +98,15 @@ public:
     //
 
     /**
-     * Starts the background thread to work on this queue. Does nothing if the worker
-     * thread is already active.
+     * Starts the background threads to work on this queue. Does nothing if the worker
+     * threads are already active.
      *
      * This call is _not_ thread safe and must be issued before any other call.
      */
     void startWorkers();
 
     /**
-     * Stops the background thread working on this queue. This will block if there are
+     * Stops the background threads working on this queue. This will block if there are
      * tasks that are being deleted, but will leave the pending tasks in the queue.
      *
      * Steps:
@@ -161,6 +163,10 @@ public:
     size_t getPendingDeletes() const;
     size_t getDeletesInProgress() const;
 
+    // The number and total size of the documents deleted by all completed deletes.
+    long long getDeletedDocCount() const;
+    long long getDeletedBytes() const;
+
     //
     // Methods meant to be only used for testing. Should be treated like private
     // methods.
@@ -187,6 +193,12 @@ private:
     /** Body of the worker thread */
     void doWork();
 
+    /**
+     * Returns the first task of _taskQueue whose namespace no other worker is deleting from, or
+     * _taskQueue.end() if there is none.
+     */
+    TaskList::iterator nextTask_inlock();
+
     /** Returns true if the range doesn't intersect with one other range */
     bool canEnqueue_inlock(StringData ns,
                            const BSONObj& min,
@@ -199,7 +211,7 @@ private:
     std::unique_ptr<RangeDeleterEnv> _env;
 
     // Initially not active. Must be started explicitly.
-    std::unique_ptr<stdx::thread> _worker;
+    std::vector<std::unique_ptr<stdx::thread>> _workers;
 
     // Protects _stopRequested.
     mutable stdx::mutex _stopMutex;
@@ -238,9 +250,14 @@ private:
     // Keeps track of number of tasks that are in progress, including the inline deletes.
     size_t _deletesInProgress;
 
+    // Namespaces that a worker is deleting from.
+    std::set<std::string> _workerNamespaces;
+
     // Protects _statsHistory
     mutable stdx::mutex _statsHistoryMutex;
     std::deque<DeleteJobStats*> _statsHistory;
+    long long _deletedDocCount;
+    long long _deletedBytes;
 };
 
 
@@ -256,8 +273,9 @@ struct DeleteJobStats {
     Date_t waitForReplEndTS;
 
     long long int deletedDocCount;
+    long long int deletedBytes;
 
-    DeleteJobStats() : deletedDocCount(0) {}
+    DeleteJobStats() : deletedDocCount(0), deletedBytes(0) {}
 };
 
 struct RangeDeleterOptions {
@@ -306,7 +324,8 @@ struct RangeDeleterEnv {
     /**
      * Deletes the documents from the given range. This method should be
      * responsible for making sure that the proper contexts are setup
-     * to be able to perform deletions.
+     * to be able to perform deletions. Sets the number and total size of the
+     * deleted documents.
      *
      * Must be a synchronous call. Docs should be deleted after call ends.
      * Must not throw Exceptions.
@@ -314,6 +333,7 @@ struct RangeDeleterEnv {
     virtual bool deleteRange(OperationContext* txn,
                              const RangeDeleteEntry& taskDetails,
                              long long int* deletedDocs,
+                             long long int* deletedBytes,
                              std::string* errMsg) = 0;
 
     /**
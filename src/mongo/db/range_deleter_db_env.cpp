@@ -61,6 +61,7 @@ using std::string;
 bool RangeDeleterDBEnv::deleteRange(OperationContext* txn,
                                     const RangeDeleteEntry& taskDetails,
                                     long long int* deletedDocs,
+                                    long long int* deletedBytes,
                                     std::string* errMsg) {
     const string ns(taskDetails.options.range.ns);
     const BSONObj inclusiveLower(taskDetails.options.range.minKey);
@@ -73,6 +74,7 @@ bool RangeDeleterDBEnv::deleteRange(OperationContext* txn,
     Client::initThreadIfNotAlready("RangeDeleter");
 
     *deletedDocs = 0;
+    *deletedBytes = 0;
     OperationShardingState::IgnoreVersioningBlock forceVersion(txn, NamespaceString(ns));
 
     Helpers::RemoveSaver removeSaver("moveChunk", ns, taskDetails.options.removeSaverReason);
@@ -94,7 +96,8 @@ bool RangeDeleterDBEnv::deleteRange(OperationContext* txn,
                                  writeConcern,
                                  removeSaverPtr,
                                  fromMigrate,
-                                 onlyRemoveOrphans);
+                                 onlyRemoveOrphans,
+                                 deletedBytes);
 
         if (*deletedDocs < 0) {
             *errMsg = "collection or index dropped before data could be cleaned";
@@ -103,8 +106,8 @@ bool RangeDeleterDBEnv::deleteRange(OperationContext* txn,
             return false;
         }
 
-        log() << "rangeDeleter deleted " << *deletedDocs << " documents for " << ns << " from "
-              << inclusiveLower << " -> " << exclusiveUpper;
+        log() << "rangeDeleter deleted " << *deletedDocs << " documents (" << *deletedBytes
+              << " bytes) for " << ns << " from " << inclusiveLower << " -> " << exclusiveUpper;
     } catch (const DBException& ex) {
         *errMsg = str::stream() << "Error encountered while deleting range: "
                                 << "ns" << ns << " from " << inclusiveLower << " -> "
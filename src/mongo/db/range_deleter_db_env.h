@@ -46,13 +46,15 @@ struct RangeDeleterDBEnv : public RangeDeleterEnv {
      * Note that secondaryThrottle will be ignored if current process is not part
      * of a replica set.
      *
-     * docsDeleted would contain the number of docs deleted if the deletion was successful.
+     * docsDeleted and deletedBytes would contain the number and total size of the docs deleted
+     * if the deletion was successful.
      *
      * Does not throw Exceptions.
      */
     virtual bool deleteRange(OperationContext* txn,
                              const RangeDeleteEntry& taskDetails,
                              long long int* deletedDocs,
+                             long long int* deletedBytes,
                              std::string* errMsg);
 
     /**
@@ -127,6 +127,7 @@ public:
     bool deleteRange(OperationContext* txn,
                      const RangeDeleteEntry& taskDetails,
                      long long int* deletedDocs,
+                     long long int* deletedBytes,
                      std::string* errMsg);
 
     /**
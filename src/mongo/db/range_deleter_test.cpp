@@ -35,6 +35,7 @@
 #include "mongo/db/range_deleter_mock_env.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_coordinator_mock.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/stdx/functional.h"
@@ -42,6 +43,7 @@
 #include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace {
@@ -361,5 +363,69 @@ TEST(MixedDeletes, MultipleDeletes) {
     deleter.stopWorkers();
 }
 
+// Workers should delete ranges of different namespaces concurrently, but not ranges of the
+// same namespace.
+TEST(MixedDeletes, ConcurrentWorkers) {
+    const string ns1("test.user");
+    const string ns2("test.other");
+
+    ServerParameter* workersParam =
+        ServerParameterSet::getGlobal()->getMap().find("rangeDeleterWorkers")->second;
+    ASSERT_OK(workersParam->setFromString("2"));
+    ON_BLOCK_EXIT([&] { ASSERT_OK(workersParam->setFromString("1")); });
+
+    RangeDeleterMockEnv* env = new RangeDeleterMockEnv();
+    RangeDeleter deleter(env);
+
+    std::unique_ptr<mongo::repl::ReplicationCoordinatorMock> mock(
+        new mongo::repl::ReplicationCoordinatorMock(replSettings));
+
+    mongo::repl::ReplicationCoordinator::set(mongo::getGlobalServiceContext(), std::move(mock));
+
+    deleter.startWorkers();
+    env->pauseDeletes();
+
+    Notification<void> doneSignal1;
+    ASSERT_TRUE(deleter.queueDelete(
+        noTxn,
+        RangeDeleterOptions(KeyRange(ns1, BSON("x" << 0), BSON("x" << 10), BSON("x" << 1))),
+        &doneSignal1,
+        NULL /* don't care errMsg */));
+
+    Notification<void> doneSignal2;
+    ASSERT_TRUE(deleter.queueDelete(
+        noTxn,
+        RangeDeleterOptions(KeyRange(ns1, BSON("x" << 10), BSON("x" << 20), BSON("x" << 1))),
+        &doneSignal2,
+        NULL /* don't care errMsg */));
+
+    Notification<void> doneSignal3;
+    ASSERT_TRUE(deleter.queueDelete(
+        noTxn,
+        RangeDeleterOptions(KeyRange(ns2, BSON("x" << 0), BSON("x" << 10), BSON("x" << 1))),
+        &doneSignal3,
+        NULL /* don't care errMsg */));
+
+    // The first range of each namespace is in progress, and the second range of ns1 waits for
+    // the first one.
+    env->waitForNthPausedDelete(2u);
+    ASSERT_EQUALS(3U, deleter.getTotalDeletes());
+    ASSERT_EQUALS(1U, deleter.getPendingDeletes());
+    ASSERT_EQUALS(2U, deleter.getDeletesInProgress());
+
+    for (size_t remaining = 3; remaining > 0; remaining--) {
+        env->resumeOneDelete();
+        while (deleter.getTotalDeletes() >= remaining) {
+            sleepmillis(1);
+        }
+    }
+
+    doneSignal1.get(noTxn);
+    doneSignal2.get(noTxn);
+    doneSignal3.get(noTxn);
+
+    deleter.stopWorkers();
+}
+
 }  // unnamed namespace
 }  // namespace mongo
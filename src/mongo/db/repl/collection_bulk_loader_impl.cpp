@@ -93,6 +93,7 @@ Status CollectionBulkLoaderImpl::init(OperationContext* txn,
     if (secondaryIndexSpecs.size()) {
         _hasSecondaryIndexes = true;
         _secondaryIndexesBlock.ignoreUniqueConstraint();
+        _secondaryIndexesBlock.allowParallelBulkCommit();
         auto status = _secondaryIndexesBlock.init(secondaryIndexSpecs);
         if (!status.isOK()) {
             return status;
@@ -104,6 +105,7 @@ Status CollectionBulkLoaderImpl::init(OperationContext* txn,
         return status;
     }
 
+    _recordLoader = coll->getRecordStore()->getBulkLoader(txn);
     return Status::OK();
 }
 
@@ -114,6 +116,28 @@ Status CollectionBulkLoaderImpl::insertDocuments(const std::vector<BSONObj>::con
         invariant(txn);
 
         for (auto iter = begin; iter != end; ++iter) {
+            if (_recordLoader) {
+                // The documents were validated by the sync source, and the oplog isn't written
+                // during initial sync, so only the records and index keys need to be inserted.
+                auto loc = _recordLoader->insertRecord(iter->objdata(), iter->objsize());
+                if (!loc.isOK()) {
+                    return loc.getStatus();
+                }
+                MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
+                    WriteUnitOfWork wunit(txn);
+                    const auto status = _idIndexBlock.insert(*iter, loc.getValue());
+                    if (!status.isOK()) {
+                        return status;
+                    }
+                    wunit.commit();
+                }
+                MONGO_WRITE_CONFLICT_RETRY_LOOP_END(
+                    _txn, "CollectionBulkLoaderImpl::insertDocuments", _nss.ns());
+
+                ++count;
+                continue;
+            }
+
             std::vector<MultiIndexBlock*> indexers{&_idIndexBlock};
             MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
                 WriteUnitOfWork wunit(txn);
@@ -138,6 +162,14 @@ Status CollectionBulkLoaderImpl::commit() {
             invariant(txn->getClient() == &cc());
             invariant(txn == _txn);
 
+            if (_recordLoader) {
+                auto status = _recordLoader->commit(txn);
+                _recordLoader.reset();
+                if (!status.isOK()) {
+                    return status;
+                }
+            }
+
             // Commit before deleting dups, so the dups will be removed from secondary indexes when
             // deleted.
             if (_hasSecondaryIndexes) {
@@ -39,6 +39,7 @@
 #include "mongo/db/repl/collection_bulk_loader.h"
 #include "mongo/db/repl/storage_interface.h"
 #include "mongo/db/repl/task_runner.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/util/concurrency/old_thread_pool.h"
 
 namespace mongo {
@@ -81,6 +82,8 @@ private:
     NamespaceString _nss;
     MultiIndexBlock _idIndexBlock;
     MultiIndexBlock _secondaryIndexesBlock;
+    // Set if the storage engine can load the empty collection's records in bulk.
+    std::unique_ptr<RecordStoreBulkLoader> _recordLoader;
     bool _hasSecondaryIndexes = false;
     BSONObj _idIndexSpec;
     bool _callAbortOnDestructor = false;
@@ -66,14 +66,15 @@ CollectionCloner::CollectionCloner(ReplicationExecutor* executor,
       _findFetcher(_executor,
                    _source,
                    _sourceNss.db().toString(),
-                   BSON("find" << _sourceNss.coll() << "noCursorTimeout" << true),  // SERVER-1387
+                   BSON("find" << _sourceNss.coll() << "noCursorTimeout" << true  // SERVER-1387
+                               << "rawData"
+                               << true),
                    stdx::bind(&CollectionCloner::_findCallback,
                               this,
                               stdx::placeholders::_1,
                               stdx::placeholders::_2,
                               stdx::placeholders::_3)),
       _indexSpecs(),
-      _documents(),
       _dbWorkCallbackHandle(),
       _scheduleDbWorkFn([this](const ReplicationExecutor::CallbackFn& work) {
           return _executor->scheduleDBWork(work);
@@ -230,11 +231,16 @@ void CollectionCloner::_findCallback(const StatusWith<Fetcher::QueryResponse>& f
     }
 
     auto batchData(fetchResult.getValue());
-    _documents = batchData.documents;
 
+    // The fetcher sends the getMore for the next batch as soon as this returns, so the insert
+    // keeps its own copy of the documents rather than sharing a buffer with the next batch.
     bool lastBatch = *nextAction == Fetcher::NextAction::kNoAction;
-    auto&& scheduleResult = _scheduleDbWorkFn(stdx::bind(
-        &CollectionCloner::_insertDocumentsCallback, this, stdx::placeholders::_1, lastBatch));
+    auto&& scheduleResult =
+        _scheduleDbWorkFn(stdx::bind(&CollectionCloner::_insertDocumentsCallback,
+                                     this,
+                                     stdx::placeholders::_1,
+                                     std::move(batchData.documents),
+                                     lastBatch));
     if (!scheduleResult.isOK()) {
         _finishCallback(nullptr, scheduleResult.getStatus());
         return;
@@ -270,6 +276,7 @@ void CollectionCloner::_beginCollectionCallback(const ReplicationExecutor::Callb
 }
 
 void CollectionCloner::_insertDocumentsCallback(const ReplicationExecutor::CallbackArgs& cbd,
+                                                const std::vector<BSONObj>& documents,
                                                 bool lastBatch) {
     OperationContext* txn = cbd.txn;
     if (!cbd.status.isOK()) {
@@ -277,7 +284,7 @@ void CollectionCloner::_insertDocumentsCallback(const ReplicationExecutor::Callb
         return;
     }
 
-    Status status = _storageInterface->insertDocuments(txn, _destNss, _documents);
+    Status status = _storageInterface->insertDocuments(txn, _destNss, documents);
     if (!status.isOK()) {
         _finishCallback(txn, status);
         return;
@@ -148,10 +148,11 @@ private:
      * Called multiple times if there are more than one batch of documents from the fetcher.
      * On the last batch, 'lastBatch' will be true.
      *
-     * Each document returned will be inserted via the storage interfaceRequest storage
-     * interface.
+     * Each document in 'documents', which holds one batch returned by the fetcher, will be
+     * inserted via the storage interface.
      */
     void _insertDocumentsCallback(const ReplicationExecutor::CallbackArgs& callbackData,
+                                  const std::vector<BSONObj>& documents,
                                   bool lastBatch);
 
     /**
@@ -189,9 +190,6 @@ private:
 
     std::vector<BSONObj> _indexSpecs;
 
-    // Current batch of documents read from fetcher to insert into collection.
-    std::vector<BSONObj> _documents;
-
     // Callback handle for database worker.
     ReplicationExecutor::CallbackHandle _dbWorkCallbackHandle;
 
@@ -320,6 +320,7 @@ TEST_F(CollectionClonerTest, FindCommandAfterBeginCollection) {
     ASSERT_EQUALS("find", std::string(noiRequest.cmdObj.firstElementFieldName()));
     ASSERT_EQUALS(nss.coll().toString(), noiRequest.cmdObj.firstElement().valuestrsafe());
     ASSERT_TRUE(noiRequest.cmdObj.getField("noCursorTimeout").trueValue());
+    ASSERT_TRUE(noiRequest.cmdObj.getField("rawData").trueValue());
     ASSERT_FALSE(net->hasReadyRequests());
 }
 
@@ -493,4 +494,36 @@ TEST_F(CollectionClonerTest, InsertDocumentsMultipleBatches) {
     ASSERT_FALSE(collectionCloner->isActive());
 }
 
+TEST_F(CollectionClonerTest, InsertDocumentsBatchArrivesBeforePreviousInsert) {
+    ASSERT_OK(collectionCloner->start());
+
+    std::vector<std::vector<BSONObj>> collBatches;
+    storageInterface->insertDocumentsFn = [&](OperationContext* txn,
+                                              const NamespaceString& theNss,
+                                              const std::vector<BSONObj>& theDocuments) {
+        collBatches.push_back(theDocuments);
+        return Status::OK();
+    };
+
+    processNetworkResponse(createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+
+    collectionCloner->waitForDbWorker();
+
+    // The second batch is received without waiting for the first one to be inserted.
+    const BSONObj doc = BSON("_id" << 1);
+    processNetworkResponse(createCursorResponse(1, BSON_ARRAY(doc)));
+    const BSONObj doc2 = BSON("_id" << 2);
+    processNetworkResponse(createCursorResponse(0, BSON_ARRAY(doc2), "nextBatch"));
+
+    collectionCloner->waitForDbWorker();
+    ASSERT_EQUALS(2U, collBatches.size());
+    ASSERT_EQUALS(1U, collBatches[0].size());
+    ASSERT_EQUALS(doc, collBatches[0][0]);
+    ASSERT_EQUALS(1U, collBatches[1].size());
+    ASSERT_EQUALS(doc2, collBatches[1][0]);
+
+    ASSERT_OK(getStatus());
+    ASSERT_FALSE(collectionCloner->isActive());
+}
+
 }  // namespace
@@ -38,6 +38,7 @@
 
 #include "mongo/db/catalog/collection_options.h"
 #include "mongo/db/repl/storage_interface.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/rpc/metadata/server_selection_metadata.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/util/assert_util.h"
@@ -50,6 +51,9 @@ namespace repl {
 
 namespace {
 
+// The number of collections in a database which may be cloned at the same time.
+MONGO_EXPORT_SERVER_PARAMETER(maxConcurrentCollectionClonesPerDatabase, int, 1);
+
 const char* kNameFieldName = "name";
 const char* kOptionsFieldName = "options";
 
@@ -104,7 +108,9 @@ DatabaseCloner::DatabaseCloner(ReplicationExecutor* executor,
       _scheduleDbWorkFn([this](const ReplicationExecutor::CallbackFn& work) {
           return _executor->scheduleDBWork(work);
       }),
-      _startCollectionCloner([](CollectionCloner& cloner) { return cloner.start(); }) {
+      _startCollectionCloner([](CollectionCloner& cloner) { return cloner.start(); }),
+      _maxConcurrentCollectionCloners(
+          std::max(1, maxConcurrentCollectionClonesPerDatabase.load())) {
     uassert(ErrorCodes::BadValue, "null replication executor", executor);
     uassert(ErrorCodes::BadValue, "empty database name", !dbname.empty());
     uassert(ErrorCodes::BadValue, "storage interface cannot be null", si);
@@ -185,6 +191,12 @@ void DatabaseCloner::setStartCollectionClonerFn(
     _startCollectionCloner = startCollectionCloner;
 }
 
+void DatabaseCloner::setMaxConcurrentCollectionCloners(size_t maxConcurrentCollectionCloners) {
+    invariant(maxConcurrentCollectionCloners > 0);
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _maxConcurrentCollectionCloners = maxConcurrentCollectionCloners;
+}
+
 void DatabaseCloner::_listCollectionsCallback(const StatusWith<Fetcher::QueryResponse>& result,
                                               Fetcher::NextAction* nextAction,
                                               BSONObjBuilder* getMoreBob) {
@@ -294,18 +306,9 @@ void DatabaseCloner::_listCollectionsCallback(const StatusWith<Fetcher::QueryRes
         collectionCloner.setScheduleDbWorkFn(_scheduleDbWorkFn);
     }
 
-    // Start first collection cloner.
-    _currentCollectionClonerIter = _collectionCloners.begin();
-
-    LOG(1) << "    cloning collection " << _currentCollectionClonerIter->getSourceNamespace();
-
-    Status startStatus = _startCollectionCloner(*_currentCollectionClonerIter);
-    if (!startStatus.isOK()) {
-        LOG(1) << "    failed to start collection cloning on "
-               << _currentCollectionClonerIter->getSourceNamespace() << ": " << startStatus;
-        _finishCallback(startStatus);
-        return;
-    }
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _nextCollectionClonerIter = _collectionCloners.begin();
+    _startCollectionCloners(std::move(lk));
 }
 
 void DatabaseCloner::_collectionClonerCallback(const Status& status, const NamespaceString& nss) {
@@ -314,22 +317,43 @@ void DatabaseCloner::_collectionClonerCallback(const Status& status, const Names
     // from cloning the rest of the collections in the listCollections result.
     _collectionWork(status, nss);
 
-    _currentCollectionClonerIter++;
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    invariant(_activeCollectionCloners > 0);
+    --_activeCollectionCloners;
+    _startCollectionCloners(std::move(lk));
+}
+
+void DatabaseCloner::_startCollectionCloners(stdx::unique_lock<stdx::mutex> lk) {
+    invariant(lk.owns_lock());
 
-    LOG(1) << "    cloning collection " << _currentCollectionClonerIter->getSourceNamespace();
+    // Collection cloners may complete on different executor threads, so they are started while
+    // holding '_mutex' to keep '_activeCollectionCloners' consistent. CollectionCloner::start()
+    // only schedules work and never invokes its completion callback inline.
+    while (_startCollectionClonerStatus.isOK() &&
+           _nextCollectionClonerIter != _collectionCloners.end() &&
+           _activeCollectionCloners < _maxConcurrentCollectionCloners) {
+        auto&& collectionCloner = *_nextCollectionClonerIter++;
 
-    if (_currentCollectionClonerIter != _collectionCloners.end()) {
-        Status startStatus = _startCollectionCloner(*_currentCollectionClonerIter);
+        LOG(1) << "    cloning collection " << collectionCloner.getSourceNamespace();
+
+        Status startStatus = _startCollectionCloner(collectionCloner);
         if (!startStatus.isOK()) {
             LOG(1) << "    failed to start collection cloning on "
-                   << _currentCollectionClonerIter->getSourceNamespace() << ": " << startStatus;
-            _finishCallback(startStatus);
-            return;
+                   << collectionCloner.getSourceNamespace() << ": " << startStatus;
+            _startCollectionClonerStatus = startStatus;
+            break;
         }
+        ++_activeCollectionCloners;
+    }
+
+    // Collection cloners that are still running report back through _collectionClonerCallback.
+    if (_activeCollectionCloners > 0) {
         return;
     }
 
-    _finishCallback(Status::OK());
+    const Status finishStatus = _startCollectionClonerStatus;
+    lk.unlock();
+    _finishCallback(finishStatus);
 }
 
 void DatabaseCloner::_finishCallback(const Status& status) {
@@ -133,6 +133,14 @@ public:
      */
     void setStartCollectionClonerFn(const StartCollectionClonerFn& startCollectionCloner);
 
+    /**
+     * Overrides the number of collection cloners which may run at the same time. Defaults to the
+     * 'maxConcurrentCollectionClonesPerDatabase' server parameter. Must be called before start().
+     *
+     * For testing only.
+     */
+    void setMaxConcurrentCollectionCloners(size_t maxConcurrentCollectionCloners);
+
 private:
     /**
      * Read collection names and options from listCollections result.
@@ -147,6 +155,13 @@ private:
      */
     void _collectionClonerCallback(const Status& status, const NamespaceString& nss);
 
+    /**
+     * Starts collection cloners until '_maxConcurrentCollectionCloners' are running or no more
+     * are left. Reports completion once no collection cloner remains active. Takes ownership of
+     * the lock on '_mutex' and releases it before calling '_onCompletion'.
+     */
+    void _startCollectionCloners(stdx::unique_lock<stdx::mutex> lk);
+
     /**
      * Reports completion status.
      * Sets cloner to inactive.
@@ -191,12 +206,21 @@ private:
     std::vector<NamespaceString> _collectionNamespaces;
 
     std::list<CollectionCloner> _collectionCloners;
-    std::list<CollectionCloner>::iterator _currentCollectionClonerIter;
+    std::list<CollectionCloner>::iterator _nextCollectionClonerIter;
+
+    // Number of collection cloners started which have not yet invoked their callback.
+    size_t _activeCollectionCloners = 0;
+
+    // Error from the first collection cloner which failed to start. No further collection
+    // cloners are started once this is set.
+    Status _startCollectionClonerStatus = Status::OK();
 
     // Function for scheduling database work using the executor.
     CollectionCloner::ScheduleDbWorkFn _scheduleDbWorkFn;
 
     StartCollectionClonerFn _startCollectionCloner;
+
+    size_t _maxConcurrentCollectionCloners;
 };
 
 }  // namespace repl
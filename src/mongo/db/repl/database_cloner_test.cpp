@@ -544,4 +544,57 @@ TEST_F(DatabaseClonerTest, CreateCollections) {
     }
 }
 
+TEST_F(DatabaseClonerTest, CreateCollectionsConcurrently) {
+    databaseCloner->setMaxConcurrentCollectionCloners(2);
+    ASSERT_OK(databaseCloner->start());
+
+    // Replace scheduleDbWork function so that all callbacks (including exclusive tasks)
+    // will run through network interface.
+    auto&& executor = getReplExecutor();
+    databaseCloner->setScheduleDbWorkFn([&](const ReplicationExecutor::CallbackFn& workFn) {
+        return executor.scheduleWork(workFn);
+    });
+
+    const std::vector<BSONObj> sourceInfos = {BSON("name"
+                                                   << "a"
+                                                   << "options"
+                                                   << BSONObj()),
+                                              BSON("name"
+                                                   << "b"
+                                                   << "options"
+                                                   << BSONObj())};
+    processNetworkResponse(
+        createListCollectionsResponse(0, BSON_ARRAY(sourceInfos[0] << sourceInfos[1])));
+
+    ASSERT_EQUALS(getDetectableErrorStatus(), getStatus());
+    ASSERT_TRUE(databaseCloner->isActive());
+
+    // Both collection cloners are started before either of them receives a response.
+    auto net = getNet();
+    ASSERT_TRUE(net->hasReadyRequests());
+    auto firstListIndexes = net->getNextReadyRequest();
+    ASSERT_TRUE(net->hasReadyRequests());
+    auto secondListIndexes = net->getNextReadyRequest();
+    ASSERT_EQUALS("a", firstListIndexes->getRequest().cmdObj["listIndexes"].str());
+    ASSERT_EQUALS("b", secondListIndexes->getRequest().cmdObj["listIndexes"].str());
+
+    scheduleNetworkResponse(firstListIndexes,
+                            createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+    scheduleNetworkResponse(secondListIndexes,
+                            createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+    finishProcessingNetworkResponse();
+
+    processNetworkResponse(createCursorResponse(0, BSONArray()));
+    ASSERT_TRUE(databaseCloner->isActive());
+    processNetworkResponse(createCursorResponse(0, BSONArray()));
+
+    ASSERT_OK(getStatus());
+    ASSERT_FALSE(databaseCloner->isActive());
+
+    ASSERT_EQUALS(2U, collectionWorkResults.size());
+    for (auto&& result : collectionWorkResults) {
+        ASSERT_OK(result.first);
+    }
+}
+
 }  // namespace
@@ -34,6 +34,7 @@
 
 #include "mongo/db/repl/oplog.h"
 
+#include <algorithm>
 #include <deque>
 #include <set>
 #include <vector>
@@ -122,6 +123,10 @@ stdx::condition_variable newTimestampNotifier;
 
 static std::string _oplogCollectionName;
 
+// The size of the fields of an oplog entry frame other than its namespace, for sizing the buffer
+// a batch of frames is built into.
+const int kOplogEntryFrameOverhead = 64;
+
 // so we can fail the same way
 void checkOplogInsert(Status result) {
     massert(17322, str::stream() << "write to oplog failed: " << result.toString(), result.isOK());
@@ -262,29 +267,40 @@ bool oplogDisabled(OperationContext* txn,
     return false;
 }
 
-OplogDocWriter _logOpWriter(OperationContext* txn,
+/**
+ * Appends the fields of an oplog entry which come before its "o" field to 'b'.
+ */
+void _appendOplogEntryFrame(BSONObjBuilder* b,
                             const char* opstr,
                             const NamespaceString& nss,
-                            const BSONObj& obj,
                             const BSONObj* o2,
                             bool fromMigrate,
                             OpTime optime,
                             long long hashNew) {
-    BSONObjBuilder b(256);
-
-    b.append("ts", optime.getTimestamp());
+    b->append("ts", optime.getTimestamp());
     if (optime.getTerm() != -1)
-        b.append("t", optime.getTerm());
-    b.append("h", hashNew);
-    b.append("v", OplogEntry::kOplogVersion);
-    b.append("op", opstr);
-    b.append("ns", nss.ns());
+        b->append("t", optime.getTerm());
+    b->append("h", hashNew);
+    b->append("v", OplogEntry::kOplogVersion);
+    b->append("op", opstr);
+    b->append("ns", nss.ns());
     if (fromMigrate)
-        b.appendBool("fromMigrate", true);
+        b->appendBool("fromMigrate", true);
     if (o2)
-        b.append("o2", *o2);
+        b->append("o2", *o2);
+}
 
-    return OplogDocWriter(OplogDocWriter(b.obj(), obj));
+OplogDocWriter _logOpWriter(OperationContext* txn,
+                            const char* opstr,
+                            const NamespaceString& nss,
+                            const BSONObj& obj,
+                            const BSONObj* o2,
+                            bool fromMigrate,
+                            OpTime optime,
+                            long long hashNew) {
+    BSONObjBuilder b(256);
+    _appendOplogEntryFrame(&b, opstr, nss, o2, fromMigrate, optime, hashNew);
+    return OplogDocWriter(b.obj(), obj);
 }
 }  // end anon namespace
 
@@ -426,9 +442,19 @@ void logOps(OperationContext* txn,
     Lock::CollectionLock lock(txn->lockState(), _oplogCollectionName, MODE_IX);
     std::unique_ptr<OplogSlot[]> slots(new OplogSlot[count]);
     getNextOpTime(txn, oplog, replCoord, replMode, count, slots.get());
+
+    // The frames of all the entries go into one buffer, rather than one allocation each. The
+    // writers only point into it once it is done growing.
+    BufBuilder frames(count * (nss.size() + kOplogEntryFrameOverhead));
+    std::vector<int> frameOffsets(count);
     for (size_t i = 0; i < count; i++) {
-        writers.emplace_back(_logOpWriter(
-            txn, opstr, nss, begin[i], NULL, fromMigrate, slots[i].opTime, slots[i].hash));
+        frameOffsets[i] = frames.len();
+        BSONObjBuilder b(frames);
+        _appendOplogEntryFrame(&b, opstr, nss, NULL, fromMigrate, slots[i].opTime, slots[i].hash);
+        b.done();
+    }
+    for (size_t i = 0; i < count; i++) {
+        writers.emplace_back(BSONObj(frames.buf() + frameOffsets[i]), begin[i]);
     }
 
     std::unique_ptr<DocWriter const* []> basePtrs(new DocWriter const*[count]);
@@ -1082,20 +1108,22 @@ void checkForCappedOplog(OperationContext* txn) {
 
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(replSnapshotThreadThrottleMicros, int, 1000);
 
+// The SnapshotThread stops creating snapshots once this many are waiting to be committed, and
+// starts again once half of them are.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(replSnapshotThreadMaxUncommittedSnapshots, int, 1000);
+
 SnapshotThread::SnapshotThread(SnapshotManager* manager)
     : _manager(manager), _thread([this] { run(); }) {}
 
 bool SnapshotThread::shouldSleepMore(int numSleepsDone, size_t numUncommittedSnapshots) {
     const double kThrottleRatio = 1 / 20.0;
-    const size_t kUncommittedSnapshotLimit = 1000;
+    const size_t kUncommittedSnapshotLimit =
+        static_cast<size_t>(std::max(1, replSnapshotThreadMaxUncommittedSnapshots));
     const size_t kUncommittedSnapshotRestartPoint = kUncommittedSnapshotLimit / 2;
 
     if (_inShutdown.load())
         return false;  // Exit the thread quickly without sleeping.
 
-    if (numSleepsDone == 0)
-        return true;  // Always sleep at least once.
-
     {
         // Enforce a limit on the number of snapshots.
         if (numUncommittedSnapshots >= kUncommittedSnapshotLimit)
@@ -1108,6 +1136,14 @@ bool SnapshotThread::shouldSleepMore(int numSleepsDone, size_t numUncommittedSna
             return true;
     }
 
+    // Forced snapshots are wanted right away, typically because the commit point has passed every
+    // snapshot and majority reads are waiting for one.
+    if (_forcedSnapshotPending.load())
+        return false;
+
+    if (numSleepsDone == 0)
+        return true;  // Always sleep at least once.
+
     // Spread out snapshots in time by sleeping as we collect more uncommitted snapshots.
     const double numSleepsNeeded = numUncommittedSnapshots * kThrottleRatio;
     return numSleepsNeeded > numSleepsDone;
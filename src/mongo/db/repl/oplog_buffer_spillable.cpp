@@ -0,0 +1,426 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kReplication
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/oplog_buffer_spillable.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <fstream>
+#include <memory>
+
+#include "mongo/base/status.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_options.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/destructor_guard.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace repl {
+
+namespace {
+
+// Shared by all oplog buffers so that spill files in the same directory never collide.
+AtomicUInt32 spillFileCounter;
+
+std::size_t getDocumentSize(const BSONObj& o) {
+    // SERVER-9808 Avoid Fortify complaint about implicit signed->unsigned conversion
+    return static_cast<std::size_t>(o.objsize());
+}
+
+OplogBufferSpillable::Options withDefaultTempDir(OplogBufferSpillable::Options options) {
+    if (options.tempDir.empty()) {
+        options.tempDir = storageGlobalParams.dbpath + "/_tmp";
+    }
+    return options;
+}
+
+void removeSpillFile(const std::string& fileName) {
+    boost::system::error_code ec;
+    boost::filesystem::remove(fileName, ec);
+    if (ec) {
+        warning() << "failed to remove oplog buffer file \"" << fileName << "\": " << ec.message();
+    }
+}
+
+}  // namespace
+
+OplogBufferSpillable::OplogBufferSpillable() : OplogBufferSpillable(Options()) {}
+
+OplogBufferSpillable::OplogBufferSpillable(Options options)
+    : _options(withDefaultTempDir(std::move(options))) {
+    invariant(_options.maxMemorySize > 0);
+    invariant(_options.segmentSize > 0);
+}
+
+OplogBufferSpillable::~OplogBufferSpillable() {
+    DESTRUCTOR_GUARD(shutdown(nullptr););
+}
+
+void OplogBufferSpillable::startup(OperationContext*) {
+    boost::filesystem::create_directories(_options.tempDir);
+    _readAhead = stdx::thread(stdx::bind(&OplogBufferSpillable::_readAheadThread, this));
+}
+
+void OplogBufferSpillable::shutdown(OperationContext* txn) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _inShutdown = true;
+        _readAheadCV.notify_all();
+    }
+
+    if (_readAhead.joinable()) {
+        _readAhead.join();
+    }
+
+    clear(txn);
+}
+
+void OplogBufferSpillable::pushEvenIfFull(OperationContext*, const Value& value) {
+    _push(value);
+}
+
+void OplogBufferSpillable::push(OperationContext*, const Value& value) {
+    _push(value);
+}
+
+bool OplogBufferSpillable::pushAllNonBlocking(OperationContext*,
+                                              Batch::const_iterator begin,
+                                              Batch::const_iterator end) {
+    for (auto i = begin; i != end; ++i) {
+        _push(*i);
+    }
+    return true;
+}
+
+void OplogBufferSpillable::waitForSpace(OperationContext*, std::size_t) {}
+
+bool OplogBufferSpillable::isEmpty() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _count == 0;
+}
+
+std::size_t OplogBufferSpillable::getMaxSize() const {
+    return 0;
+}
+
+std::size_t OplogBufferSpillable::getSize() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _size;
+}
+
+std::size_t OplogBufferSpillable::getCount() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _count;
+}
+
+void OplogBufferSpillable::clear(OperationContext*) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    // Segments which are being written or loaded are discarded by their owner on completion.
+    ++_generation;
+    for (auto&& segment : _segments) {
+        removeSpillFile(segment.fileName);
+    }
+    _segments.clear();
+    _entries.clear();
+    _entriesSize = 0;
+    _pending.clear();
+    _pendingSize = 0;
+    _count = 0;
+    _size = 0;
+    _lastPushed = boost::none;
+}
+
+bool OplogBufferSpillable::tryPop(OperationContext*, Value* value) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_entries.empty()) {
+        return false;
+    }
+    *value = _pop_inlock();
+    return true;
+}
+
+OplogBuffer::Value OplogBufferSpillable::blockingPop(OperationContext*) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _notEmptyCV.wait(lk, [this] { return !_entries.empty(); });
+    return _pop_inlock();
+}
+
+bool OplogBufferSpillable::blockingPeek(OperationContext*, Value* value, Seconds waitDuration) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (!_notEmptyCV.wait_for(
+            lk, waitDuration.toSystemDuration(), [this] { return !_entries.empty(); })) {
+        return false;
+    }
+    *value = _entries.front();
+    return true;
+}
+
+bool OplogBufferSpillable::peek(OperationContext*, Value* value) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_entries.empty()) {
+        return false;
+    }
+    *value = _entries.front();
+    return true;
+}
+
+boost::optional<OplogBuffer::Value> OplogBufferSpillable::lastObjectPushed(
+    OperationContext*) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _lastPushed;
+}
+
+std::size_t OplogBufferSpillable::getNumSpilledSegments_forTest() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _segments.size();
+}
+
+void OplogBufferSpillable::_push(const Value& value) {
+    const auto size = getDocumentSize(value);
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    ++_count;
+    _size += size;
+    _lastPushed = value;
+
+    _pending.push_back(value);
+    _pendingSize += size;
+    _movePendingToMemory_inlock();
+
+    if (_pendingSize < _options.segmentSize) {
+        return;
+    }
+
+    // There is only one pusher, so nothing else is added to '_pending' while this segment is
+    // written without holding the mutex.
+    std::deque<Value> entries;
+    entries.swap(_pending);
+    _pendingSize = 0;
+    _writingSegment = true;
+    const auto generation = _generation;
+    lk.unlock();
+
+    Segment segment = _writeSegment(entries);
+
+    lk.lock();
+    _writingSegment = false;
+    if (generation != _generation) {
+        removeSpillFile(segment.fileName);
+        return;
+    }
+    _segments.push_back(std::move(segment));
+    _readAheadCV.notify_one();
+}
+
+void OplogBufferSpillable::_movePendingToMemory_inlock() {
+    if (!_segments.empty() || _writingSegment || _loadingSegment) {
+        return;
+    }
+
+    bool moved = false;
+    while (!_pending.empty()) {
+        const auto size = getDocumentSize(_pending.front());
+        if (!_entries.empty() && _entriesSize + size > _options.maxMemorySize) {
+            break;
+        }
+        _entries.push_back(std::move(_pending.front()));
+        _entriesSize += size;
+        _pending.pop_front();
+        _pendingSize -= size;
+        moved = true;
+    }
+
+    if (moved) {
+        _notEmptyCV.notify_all();
+    }
+}
+
+bool OplogBufferSpillable::_shouldLoadSegment_inlock() const {
+    if (_loadingSegment || _segments.empty()) {
+        return false;
+    }
+    return _entries.empty() || _entriesSize + _segments.front().size <= _options.maxMemorySize;
+}
+
+OplogBuffer::Value OplogBufferSpillable::_pop_inlock() {
+    invariant(!_entries.empty());
+    Value value = std::move(_entries.front());
+    _entries.pop_front();
+
+    const auto size = getDocumentSize(value);
+    _entriesSize -= size;
+    --_count;
+    _size -= size;
+    if (_count == 0) {
+        _lastPushed = boost::none;
+    }
+
+    _movePendingToMemory_inlock();
+    if (_shouldLoadSegment_inlock()) {
+        _readAheadCV.notify_one();
+    }
+    return value;
+}
+
+OplogBufferSpillable::Segment OplogBufferSpillable::_writeSegment(
+    const std::deque<Value>& entries) {
+    Segment segment;
+    segment.fileName = str::stream() << _options.tempDir << "/oplogBuffer."
+                                     << spillFileCounter.fetchAndAdd(1);
+
+    std::string buffer;
+    for (auto&& entry : entries) {
+        buffer.append(entry.objdata(), entry.objsize());
+    }
+    segment.count = entries.size();
+    segment.size = buffer.size();
+
+    const char* data = buffer.data();
+    std::size_t dataSize = buffer.size();
+    std::unique_ptr<char[]> protectedData;
+    auto hooks = WiredTigerCustomizationHooks::get(getGlobalServiceContext());
+    if (hooks->enabled()) {
+        std::size_t protectedSizeMax = dataSize + hooks->additionalBytesForProtectedBuffer();
+        protectedData.reset(new char[protectedSizeMax]);
+        std::size_t resultLen;
+        Status status = hooks->protectTmpData(reinterpret_cast<const uint8_t*>(data),
+                                              dataSize,
+                                              reinterpret_cast<uint8_t*>(protectedData.get()),
+                                              protectedSizeMax,
+                                              &resultLen);
+        fassert(40203, status);
+        data = protectedData.get();
+        dataSize = resultLen;
+    }
+    segment.fileSize = dataSize;
+
+    std::ofstream file(segment.fileName.c_str(), std::ios::binary | std::ios::out);
+    file.write(data, dataSize);
+    file.close();
+    if (!file.good()) {
+        fassertFailedWithStatus(40203,
+                                Status(ErrorCodes::FileStreamFailed,
+                                       str::stream() << "error writing oplog buffer file \""
+                                                     << segment.fileName
+                                                     << "\": "
+                                                     << errnoWithDescription()));
+    }
+
+    LOG(2) << "spilled " << segment.count << " oplog entries (" << segment.size << " bytes) to "
+           << segment.fileName;
+    return segment;
+}
+
+std::deque<OplogBuffer::Value> OplogBufferSpillable::_readSegment(const Segment& segment) {
+    std::unique_ptr<char[]> data(new char[segment.fileSize]);
+    {
+        std::ifstream file(segment.fileName.c_str(), std::ios::binary | std::ios::in);
+        file.read(data.get(), segment.fileSize);
+        if (!file.good() || file.gcount() != static_cast<std::streamsize>(segment.fileSize)) {
+            fassertFailedWithStatus(40204,
+                                    Status(ErrorCodes::FileStreamFailed,
+                                           str::stream() << "error reading oplog buffer file \""
+                                                         << segment.fileName
+                                                         << "\": "
+                                                         << errnoWithDescription()));
+        }
+    }
+    removeSpillFile(segment.fileName);
+
+    std::size_t dataSize = segment.fileSize;
+    auto hooks = WiredTigerCustomizationHooks::get(getGlobalServiceContext());
+    if (hooks->enabled()) {
+        std::unique_ptr<char[]> out(new char[dataSize]);
+        std::size_t outLen;
+        Status status = hooks->unprotectTmpData(reinterpret_cast<uint8_t*>(data.get()),
+                                                dataSize,
+                                                reinterpret_cast<uint8_t*>(out.get()),
+                                                dataSize,
+                                                &outLen);
+        fassert(40204, status);
+        data.swap(out);
+        dataSize = outLen;
+    }
+    fassert(40204, dataSize == segment.size);
+
+    std::deque<Value> entries;
+    std::size_t offset = 0;
+    while (offset < dataSize) {
+        BSONObj entry(data.get() + offset);
+        offset += entry.objsize();
+        fassert(40204, offset <= dataSize);
+        entries.push_back(entry.getOwned());
+    }
+    fassert(40204, entries.size() == segment.count);
+    return entries;
+}
+
+void OplogBufferSpillable::_readAheadThread() {
+    setThreadName("OplogBufferReadAhead");
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (true) {
+        _readAheadCV.wait(lk, [this] { return _inShutdown || _shouldLoadSegment_inlock(); });
+        if (_inShutdown) {
+            return;
+        }
+
+        const Segment segment = _segments.front();
+        _segments.pop_front();
+        _loadingSegment = true;
+        const auto generation = _generation;
+        lk.unlock();
+
+        auto entries = _readSegment(segment);
+
+        lk.lock();
+        _loadingSegment = false;
+        if (generation != _generation) {
+            continue;
+        }
+        for (auto&& entry : entries) {
+            _entriesSize += getDocumentSize(entry);
+            _entries.push_back(std::move(entry));
+        }
+        _movePendingToMemory_inlock();
+        _notEmptyCV.notify_all();
+    }
+}
+
+}  // namespace repl
+}  // namespace mongo
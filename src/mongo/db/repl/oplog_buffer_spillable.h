@@ -0,0 +1,181 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <string>
+
+#include "mongo/db/repl/oplog_buffer.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * Oplog buffer which holds a bounded number of bytes in memory and spills the rest to append-only
+ * files. Entries pushed while the in-memory portion is full are collected into segments, which
+ * are written out in push order once they reach the segment size. A read-ahead thread loads the
+ * oldest segment back into memory as soon as it fits, so that the popper rarely waits on disk.
+ *
+ * Pushing never blocks. Each segment file is removed once it has been loaded, and any remaining
+ * files are removed by clear() and shutdown().
+ */
+class OplogBufferSpillable final : public OplogBuffer {
+public:
+    struct Options {
+        // Maximum size of the entries held in memory and available for popping.
+        std::size_t maxMemorySize = 256 * 1024 * 1024;
+
+        // Size of the entries written to each spill file.
+        std::size_t segmentSize = 16 * 1024 * 1024;
+
+        // Directory holding the spill files. Defaults to the '_tmp' directory under the dbpath.
+        std::string tempDir;
+    };
+
+    OplogBufferSpillable();
+    explicit OplogBufferSpillable(Options options);
+    ~OplogBufferSpillable() override;
+
+    void startup(OperationContext* txn) override;
+    void shutdown(OperationContext* txn) override;
+    void pushEvenIfFull(OperationContext* txn, const Value& value) override;
+    void push(OperationContext* txn, const Value& value) override;
+    bool pushAllNonBlocking(OperationContext* txn,
+                            Batch::const_iterator begin,
+                            Batch::const_iterator end) override;
+    void waitForSpace(OperationContext* txn, std::size_t size) override;
+    bool isEmpty() const override;
+    std::size_t getMaxSize() const override;
+    std::size_t getSize() const override;
+    std::size_t getCount() const override;
+    void clear(OperationContext* txn) override;
+    bool tryPop(OperationContext* txn, Value* value) override;
+    Value blockingPop(OperationContext* txn) override;
+    bool blockingPeek(OperationContext* txn, Value* value, Seconds waitDuration) override;
+    bool peek(OperationContext* txn, Value* value) override;
+    boost::optional<Value> lastObjectPushed(OperationContext* txn) const override;
+
+    // ---- Testing API ----
+    std::size_t getNumSpilledSegments_forTest() const;
+
+private:
+    struct Segment {
+        std::string fileName;
+
+        // Number of bytes in the file, which may differ from 'size' if temporary data is
+        // encrypted.
+        std::size_t fileSize = 0;
+
+        std::size_t count = 0;
+        std::size_t size = 0;
+    };
+
+    /**
+     * Adds 'value' to the in-memory entries if nothing is ahead of it on disk and there is room.
+     * Otherwise, adds it to the pending segment, which is written out once it is large enough.
+     */
+    void _push(const Value& value);
+
+    /**
+     * Moves pending entries to the in-memory entries while there is room, as long as no entries
+     * are on disk or in the process of being written or loaded.
+     */
+    void _movePendingToMemory_inlock();
+
+    /**
+     * Returns true when the read-ahead thread should load the oldest spilled segment.
+     */
+    bool _shouldLoadSegment_inlock() const;
+
+    /**
+     * Pops the oldest in-memory entry, which must exist.
+     */
+    Value _pop_inlock();
+
+    /**
+     * Writes 'entries' to a new spill file and returns the segment describing it.
+     */
+    Segment _writeSegment(const std::deque<Value>& entries);
+
+    /**
+     * Reads back the entries of 'segment' and removes its file.
+     */
+    std::deque<Value> _readSegment(const Segment& segment);
+
+    /**
+     * Loads spilled segments ahead of the popper until shutdown.
+     */
+    void _readAheadThread();
+
+    const Options _options;
+
+    // Protects member data below.
+    mutable stdx::mutex _mutex;
+
+    // Signalled when entries become available in '_entries'.
+    stdx::condition_variable _notEmptyCV;
+
+    // Signalled when the read-ahead thread may have a segment to load.
+    stdx::condition_variable _readAheadCV;
+
+    stdx::thread _readAhead;
+
+    bool _inShutdown = false;
+
+    // Incremented by clear() so that segments being written or loaded at the time are discarded.
+    std::size_t _generation = 0;
+
+    // Entries available for popping, oldest first.
+    std::deque<Value> _entries;
+    std::size_t _entriesSize = 0;
+
+    // Spilled segments, oldest first. All of these entries were pushed after those in '_entries'.
+    std::deque<Segment> _segments;
+
+    // True while a segment is being written by the pusher or loaded by the read-ahead thread.
+    bool _writingSegment = false;
+    bool _loadingSegment = false;
+
+    // Entries pushed after those on disk which have not yet been written to a segment.
+    std::deque<Value> _pending;
+    std::size_t _pendingSize = 0;
+
+    // Totals across every part of the buffer.
+    std::size_t _count = 0;
+    std::size_t _size = 0;
+
+    boost::optional<Value> _lastPushed;
+};
+
+}  // namespace repl
+}  // namespace mongo
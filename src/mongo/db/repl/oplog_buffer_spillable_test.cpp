@@ -0,0 +1,196 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <boost/filesystem/operations.hpp>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/repl/oplog_buffer_spillable.h"
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+using namespace mongo::repl;
+
+BSONObj makeOplogEntry(int t) {
+    return BSON("ts" << Timestamp(t, t) << "h" << t << "ns"
+                     << "a.a"
+                     << "v"
+                     << 2
+                     << "op"
+                     << "i"
+                     << "o"
+                     << BSON("_id" << t << "a" << t));
+}
+
+std::size_t countFiles(const std::string& path) {
+    return std::distance(boost::filesystem::directory_iterator(path),
+                         boost::filesystem::directory_iterator());
+}
+
+/**
+ * Returns options which keep about 10 oplog entries in memory and spill 5 entries per segment.
+ */
+OplogBufferSpillable::Options makeSmallOptions(const std::string& tempDir) {
+    const std::size_t entrySize = makeOplogEntry(1).objsize();
+    OplogBufferSpillable::Options options;
+    options.maxMemorySize = 10 * entrySize;
+    options.segmentSize = 5 * entrySize;
+    options.tempDir = tempDir;
+    return options;
+}
+
+TEST(OplogBufferSpillableTest, PushAndPopInOrderWithoutSpilling) {
+    unittest::TempDir tempDir("oplog_buffer_spillable_test");
+    OplogBufferSpillable::Options options;
+    options.tempDir = tempDir.path();
+    OplogBufferSpillable oplogBuffer(options);
+    oplogBuffer.startup(nullptr);
+
+    ASSERT_TRUE(oplogBuffer.isEmpty());
+    ASSERT_FALSE(oplogBuffer.lastObjectPushed(nullptr));
+
+    std::size_t size = 0;
+    for (int i = 1; i <= 10; ++i) {
+        oplogBuffer.push(nullptr, makeOplogEntry(i));
+        size += makeOplogEntry(i).objsize();
+    }
+    ASSERT_EQUALS(10U, oplogBuffer.getCount());
+    ASSERT_EQUALS(size, oplogBuffer.getSize());
+    ASSERT_EQUALS(0U, oplogBuffer.getNumSpilledSegments_forTest());
+    ASSERT_EQUALS(0U, countFiles(tempDir.path()));
+    ASSERT_EQUALS(makeOplogEntry(10), *oplogBuffer.lastObjectPushed(nullptr));
+
+    BSONObj doc;
+    ASSERT_TRUE(oplogBuffer.peek(nullptr, &doc));
+    ASSERT_EQUALS(makeOplogEntry(1), doc);
+    for (int i = 1; i <= 10; ++i) {
+        ASSERT_TRUE(oplogBuffer.tryPop(nullptr, &doc));
+        ASSERT_EQUALS(makeOplogEntry(i), doc);
+    }
+    ASSERT_FALSE(oplogBuffer.tryPop(nullptr, &doc));
+    ASSERT_TRUE(oplogBuffer.isEmpty());
+    ASSERT_EQUALS(0U, oplogBuffer.getSize());
+    ASSERT_FALSE(oplogBuffer.lastObjectPushed(nullptr));
+
+    oplogBuffer.shutdown(nullptr);
+}
+
+TEST(OplogBufferSpillableTest, SpilledEntriesArePoppedInPushOrder) {
+    unittest::TempDir tempDir("oplog_buffer_spillable_test");
+    OplogBufferSpillable oplogBuffer(makeSmallOptions(tempDir.path()));
+    oplogBuffer.startup(nullptr);
+
+    const int numEntries = 52;
+    for (int i = 1; i <= numEntries; ++i) {
+        oplogBuffer.push(nullptr, makeOplogEntry(i));
+    }
+
+    // The first 10 entries fill memory. Nothing can be loaded back until those are popped, so
+    // the next 40 entries are on disk in 8 segments and the last 2 are waiting for a segment.
+    ASSERT_EQUALS(8U, oplogBuffer.getNumSpilledSegments_forTest());
+    ASSERT_EQUALS(8U, countFiles(tempDir.path()));
+    ASSERT_EQUALS(static_cast<std::size_t>(numEntries), oplogBuffer.getCount());
+    ASSERT_EQUALS(makeOplogEntry(numEntries), *oplogBuffer.lastObjectPushed(nullptr));
+
+    for (int i = 1; i <= numEntries; ++i) {
+        ASSERT_EQUALS(makeOplogEntry(i), oplogBuffer.blockingPop(nullptr));
+    }
+    ASSERT_TRUE(oplogBuffer.isEmpty());
+    ASSERT_EQUALS(0U, oplogBuffer.getSize());
+
+    // Every segment file is removed once it has been loaded.
+    ASSERT_EQUALS(0U, oplogBuffer.getNumSpilledSegments_forTest());
+    ASSERT_EQUALS(0U, countFiles(tempDir.path()));
+
+    oplogBuffer.shutdown(nullptr);
+}
+
+TEST(OplogBufferSpillableTest, BlockingPeekWaitsForSpilledEntries) {
+    unittest::TempDir tempDir("oplog_buffer_spillable_test");
+    OplogBufferSpillable oplogBuffer(makeSmallOptions(tempDir.path()));
+    oplogBuffer.startup(nullptr);
+
+    for (int i = 1; i <= 20; ++i) {
+        oplogBuffer.push(nullptr, makeOplogEntry(i));
+    }
+
+    BSONObj doc;
+    for (int i = 1; i <= 20; ++i) {
+        ASSERT_TRUE(oplogBuffer.blockingPeek(nullptr, &doc, Seconds(10)));
+        ASSERT_EQUALS(makeOplogEntry(i), doc);
+        ASSERT_TRUE(oplogBuffer.tryPop(nullptr, &doc));
+        ASSERT_EQUALS(makeOplogEntry(i), doc);
+    }
+    ASSERT_FALSE(oplogBuffer.blockingPeek(nullptr, &doc, Seconds(0)));
+
+    oplogBuffer.shutdown(nullptr);
+}
+
+TEST(OplogBufferSpillableTest, ClearRemovesSpillFiles) {
+    unittest::TempDir tempDir("oplog_buffer_spillable_test");
+    OplogBufferSpillable oplogBuffer(makeSmallOptions(tempDir.path()));
+    oplogBuffer.startup(nullptr);
+
+    for (int i = 1; i <= 30; ++i) {
+        oplogBuffer.push(nullptr, makeOplogEntry(i));
+    }
+    ASSERT_NOT_EQUALS(0U, countFiles(tempDir.path()));
+
+    oplogBuffer.clear(nullptr);
+    ASSERT_TRUE(oplogBuffer.isEmpty());
+    ASSERT_EQUALS(0U, oplogBuffer.getSize());
+    ASSERT_FALSE(oplogBuffer.lastObjectPushed(nullptr));
+    ASSERT_EQUALS(0U, oplogBuffer.getNumSpilledSegments_forTest());
+    ASSERT_EQUALS(0U, countFiles(tempDir.path()));
+
+    // The buffer is still usable after being cleared.
+    oplogBuffer.push(nullptr, makeOplogEntry(31));
+    ASSERT_EQUALS(makeOplogEntry(31), oplogBuffer.blockingPop(nullptr));
+
+    oplogBuffer.shutdown(nullptr);
+}
+
+TEST(OplogBufferSpillableTest, ShutdownRemovesSpillFiles) {
+    unittest::TempDir tempDir("oplog_buffer_spillable_test");
+    OplogBufferSpillable oplogBuffer(makeSmallOptions(tempDir.path()));
+    oplogBuffer.startup(nullptr);
+
+    for (int i = 1; i <= 30; ++i) {
+        oplogBuffer.push(nullptr, makeOplogEntry(i));
+    }
+    ASSERT_NOT_EQUALS(0U, countFiles(tempDir.path()));
+
+    oplogBuffer.shutdown(nullptr);
+    ASSERT_EQUALS(0U, countFiles(tempDir.path()));
+}
+
+}  // namespace
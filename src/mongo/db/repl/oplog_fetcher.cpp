@@ -32,13 +32,20 @@
 
 #include "mongo/db/repl/oplog_fetcher.h"
 
+#include <algorithm>
+
+#include "mongo/base/counter.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/stats/timer_stats.h"
 #include "mongo/rpc/metadata/server_selection_metadata.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 namespace repl {
@@ -47,6 +54,46 @@ Seconds OplogFetcher::kDefaultProtocolZeroAwaitDataTimeout(2);
 
 namespace {
 
+// Enables sending the next getMore command while the current batch is still being enqueued.
+MONGO_EXPORT_SERVER_PARAMETER(oplogFetcherPipelineGetMores, bool, true);
+
+// Enables limiting the getMore batch size to what the applier consumes in one round trip.
+MONGO_EXPORT_SERVER_PARAMETER(oplogFetcherAdaptiveBatchSize, bool, true);
+
+// Smallest batch size requested when the batch size is limited by the applier throughput.
+const long long kMinAdaptiveBatchSize = 100;
+
+// Weight given to the latest sample in the moving averages used to size getMore batches.
+const double kSampleWeight = 0.2;
+
+// Time spent by the fetcher waiting for the previous batch to be enqueued.
+TimerStats enqueueStallStats;
+ServerStatusMetricField<TimerStats> displayEnqueueStalls("repl.network.oplogFetcher.stalls",
+                                                         &enqueueStallStats);
+
+// Number of getMore commands sent while the previous batch was still being enqueued.
+Counter64 pipelinedGetMoreStats;
+ServerStatusMetricField<Counter64> displayPipelinedGetMores(
+    "repl.network.oplogFetcher.pipelinedGetMores", &pipelinedGetMoreStats);
+
+// Moving average of the getMore round trip time.
+Counter64 roundTripMillisGauge;
+ServerStatusMetricField<Counter64> displayRoundTripMillis(
+    "repl.network.oplogFetcher.roundTripMillis", &roundTripMillisGauge);
+
+// Batch size requested in the last getMore command. 0 if the sync source chooses.
+Counter64 batchSizeGauge;
+ServerStatusMetricField<Counter64> displayBatchSize("repl.network.oplogFetcher.batchSize",
+                                                    &batchSizeGauge);
+
+void setGauge(Counter64* gauge, long long value) {
+    gauge->increment(value - gauge->get());
+}
+
+double addSample(double average, double sample) {
+    return average == 0.0 ? sample : average + kSampleWeight * (sample - average);
+}
+
 /**
  * Calculates await data timeout based on the current replica set configuration.
  */
@@ -87,10 +134,14 @@ BSONObj makeFindCommandObject(DataReplicatorExternalState* dataReplicatorExterna
 BSONObj makeGetMoreCommandObject(DataReplicatorExternalState* dataReplicatorExternalState,
                                  const NamespaceString& nss,
                                  CursorId cursorId,
-                                 Milliseconds fetcherMaxTimeMS) {
+                                 Milliseconds fetcherMaxTimeMS,
+                                 boost::optional<long long> batchSize) {
     BSONObjBuilder cmdBob;
     cmdBob.append("getMore", cursorId);
     cmdBob.append("collection", nss.coll());
+    if (batchSize) {
+        cmdBob.append("batchSize", *batchSize);
+    }
     cmdBob.append("maxTimeMS", durationCount<Milliseconds>(fetcherMaxTimeMS));
     auto opTimeWithTerm = dataReplicatorExternalState->getCurrentTermAndLastCommittedOpTime();
     if (opTimeWithTerm.value != OpTime::kUninitializedTerm) {
@@ -227,7 +278,8 @@ OplogFetcher::OplogFetcher(executor::TaskExecutor* exec,
                            DataReplicatorExternalState* dataReplicatorExternalState,
                            EnqueueDocumentsFn enqueueDocumentsFn,
                            OnShutdownCallbackFn onShutdownCallbackFn)
-    : _dataReplicatorExternalState(dataReplicatorExternalState),
+    : _executor(exec),
+      _dataReplicatorExternalState(dataReplicatorExternalState),
       _fetcher(exec,
                source,
                oplogNSS.db().toString(),
@@ -256,7 +308,11 @@ std::string OplogFetcher::toString() const {
 }
 
 bool OplogFetcher::isActive() const {
-    return _fetcher.isActive();
+    if (_fetcher.isActive()) {
+        return true;
+    }
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    return _enqueueInProgress;
 }
 
 Status OplogFetcher::startup() {
@@ -269,6 +325,8 @@ void OplogFetcher::shutdown() {
 
 void OplogFetcher::join() {
     _fetcher.wait();
+    stdx::unique_lock<stdx::mutex> lock(_mutex);
+    _enqueueFinishedCondition.wait(lock, [this]() { return !_enqueueInProgress; });
 }
 
 OpTimeWithHash OplogFetcher::getLastOpTimeWithHashFetched() const {
@@ -298,10 +356,28 @@ void OplogFetcher::_callback(const Fetcher::QueryResponseStatus& result,
     // example, because it stepped down) we might not have a cursor
     if (!result.isOK()) {
         LOG(2) << "Error returned from oplog query: " << result.getStatus();
+
+        // Errors may be reported on the executor thread that still has to run the enqueue task
+        // (for example, when the getMore could not be scheduled), so we cannot wait for it here.
+        stdx::unique_lock<stdx::mutex> lock(_mutex);
+        if (_enqueueInProgress) {
+            _pendingShutdownStatus = result.getStatus();
+            return;
+        }
+        lock.unlock();
+
         _onShutdown(result.getStatus());
         return;
     }
 
+    // Responses to a getMore are processed only after the enqueue task scheduled before sending
+    // the getMore, so this does not wait on a task queued behind us on the same thread.
+    auto enqueueStatus = _waitForPendingEnqueue();
+    if (!enqueueStatus.isOK()) {
+        _onShutdown(enqueueStatus);
+        return;
+    }
+
     const auto& queryResponse = result.getValue();
     rpc::ReplSetMetadata metadata;
 
@@ -355,20 +431,71 @@ void OplogFetcher::_callback(const Fetcher::QueryResponseStatus& result,
     }
     auto info = validateResult.getValue();
 
-    // TODO: back pressure handling will be added in SERVER-23499.
-    _enqueueDocumentsFn(firstDocToApply, documents.cend(), info, queryResponse.elapsedMillis);
+    boost::optional<long long> batchSize;
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        if (!documents.empty()) {
+            _averageDocumentBytes = addSample(
+                _averageDocumentBytes, double(info.networkDocumentBytes) / documents.size());
+
+            // Only getMore responses carrying operations are sampled. Empty batches are returned
+            // when the await data timeout expires and say nothing about the network.
+            if (!queryResponse.first) {
+                auto roundTripMillis = durationCount<Milliseconds>(queryResponse.elapsedMillis);
+                _roundTripMillis = addSample(_roundTripMillis, double(roundTripMillis));
+                setGauge(&roundTripMillisGauge, static_cast<long long>(_roundTripMillis));
+            }
+        }
+        batchSize = _getBatchSize_inlock();
+    }
+
+    const bool stopFetching =
+        _dataReplicatorExternalState->shouldStopFetching(_fetcher.getSource(), metadata);
+
+    // Hand the batch off to the executor so that the next getMore is sent without waiting for
+    // space in the buffer.
+    if (getMoreBob && !stopFetching && oplogFetcherPipelineGetMores.load()) {
+        stdx::unique_lock<stdx::mutex> lock(_mutex);
+        invariant(!_enqueueInProgress);
+        _enqueueInProgress = true;
+        lock.unlock();
+
+        auto scheduleResult = _executor->scheduleWork(
+            stdx::bind(&OplogFetcher::_enqueueDocumentsCallback,
+                       this,
+                       stdx::placeholders::_1,
+                       documents,
+                       queryResponse.first,
+                       info,
+                       queryResponse.elapsedMillis));
+        if (scheduleResult.isOK()) {
+            pipelinedGetMoreStats.increment();
+            setGauge(&batchSizeGauge, batchSize.value_or(0));
+            getMoreBob->appendElements(makeGetMoreCommandObject(_dataReplicatorExternalState,
+                                                                queryResponse.nss,
+                                                                queryResponse.cursorId,
+                                                                _awaitDataTimeout,
+                                                                batchSize));
+            return;
+        }
+
+        lock.lock();
+        _enqueueInProgress = false;
+        _enqueueFinishedCondition.notify_all();
+        lock.unlock();
+
+        LOG(2) << "failed to schedule enqueue of oplog fetcher batch: "
+               << scheduleResult.getStatus();
+    }
+
+    _enqueueDocuments(documents, queryResponse.first, info, queryResponse.elapsedMillis);
 
     // Update last fetched info.
     if (firstDocToApply != documents.cend()) {
         opTimeWithHash = info.lastDocument;
-        LOG(3) << "batch resetting last fetched optime: " << opTimeWithHash.opTime
-               << "; hash: " << opTimeWithHash.value;
-
-        stdx::unique_lock<stdx::mutex> lock(_mutex);
-        _lastFetched = opTimeWithHash;
     }
 
-    if (_dataReplicatorExternalState->shouldStopFetching(_fetcher.getSource(), metadata)) {
+    if (stopFetching) {
         _onShutdown(Status(ErrorCodes::InvalidSyncSource,
                            str::stream() << "sync source " << _fetcher.getSource().toString()
                                          << " (last optime: "
@@ -389,10 +516,99 @@ void OplogFetcher::_callback(const Fetcher::QueryResponseStatus& result,
         return;
     }
 
+    {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        batchSize = _getBatchSize_inlock();
+    }
+    setGauge(&batchSizeGauge, batchSize.value_or(0));
     getMoreBob->appendElements(makeGetMoreCommandObject(_dataReplicatorExternalState,
                                                         queryResponse.nss,
                                                         queryResponse.cursorId,
-                                                        _awaitDataTimeout));
+                                                        _awaitDataTimeout,
+                                                        batchSize));
+}
+
+void OplogFetcher::_enqueueDocuments(const Fetcher::Documents& documents,
+                                     bool first,
+                                     const DocumentsInfo& info,
+                                     Milliseconds remoteCommandProcessingTime) {
+    auto firstDocToApply = documents.cbegin();
+    if (first) {
+        firstDocToApply++;
+    }
+
+    Timer timer;
+    _enqueueDocumentsFn(firstDocToApply, documents.cend(), info, remoteCommandProcessingTime);
+    auto enqueueMillis = timer.millis();
+
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+
+    // Enqueueing only takes measurable time when the buffer is full, in which case the rate at
+    // which this batch went in is the rate at which the applier drains the buffer.
+    _lastEnqueueBlocked = enqueueMillis > 0;
+    if (_lastEnqueueBlocked) {
+        _applierBytesPerMilli =
+            addSample(_applierBytesPerMilli, double(info.toApplyDocumentBytes) / enqueueMillis);
+    }
+
+    // Update last fetched info.
+    if (firstDocToApply != documents.cend()) {
+        LOG(3) << "batch resetting last fetched optime: " << info.lastDocument.opTime
+               << "; hash: " << info.lastDocument.value;
+        _lastFetched = info.lastDocument;
+    }
+}
+
+void OplogFetcher::_enqueueDocumentsCallback(
+    const executor::TaskExecutor::CallbackArgs& callbackArgs,
+    const Fetcher::Documents& documents,
+    bool first,
+    const DocumentsInfo& info,
+    Milliseconds remoteCommandProcessingTime) {
+    if (callbackArgs.status.isOK()) {
+        _enqueueDocuments(documents, first, info, remoteCommandProcessingTime);
+    }
+
+    stdx::unique_lock<stdx::mutex> lock(_mutex);
+    if (!callbackArgs.status.isOK()) {
+        // Later batches cannot be enqueued without leaving a gap in the buffer.
+        _enqueueStatus = callbackArgs.status;
+    }
+
+    // Run the shutdown callback before clearing '_enqueueInProgress' so that the oplog fetcher
+    // stays active until the caller has been notified.
+    while (_pendingShutdownStatus) {
+        auto status = *_pendingShutdownStatus;
+        _pendingShutdownStatus = boost::none;
+        lock.unlock();
+        _onShutdown(status);
+        lock.lock();
+    }
+
+    _enqueueInProgress = false;
+    _enqueueFinishedCondition.notify_all();
+}
+
+Status OplogFetcher::_waitForPendingEnqueue() {
+    stdx::unique_lock<stdx::mutex> lock(_mutex);
+    if (_enqueueInProgress) {
+        TimerHolder stallTimer(&enqueueStallStats);
+        _enqueueFinishedCondition.wait(lock, [this]() { return !_enqueueInProgress; });
+    }
+    return _enqueueStatus;
+}
+
+boost::optional<long long> OplogFetcher::_getBatchSize_inlock() const {
+    if (!oplogFetcherAdaptiveBatchSize.load() || !_lastEnqueueBlocked ||
+        _averageDocumentBytes <= 0.0) {
+        return boost::none;
+    }
+
+    // There is no point in fetching more operations per round trip than the applier consumes in
+    // that time. Larger batches only sit in memory while waiting for space in the buffer.
+    auto bytesPerRoundTrip = _applierBytesPerMilli * std::max(_roundTripMillis, 1.0);
+    return std::max(kMinAdaptiveBatchSize,
+                    static_cast<long long>(bytesPerRoundTrip / _averageDocumentBytes));
 }
 
 void OplogFetcher::_onShutdown(Status status) {
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/bson/timestamp.h"
@@ -36,7 +38,9 @@
 #include "mongo/db/repl/data_replicator_external_state.h"
 #include "mongo/db/repl/optime_with.h"
 #include "mongo/db/repl/replica_set_config.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 namespace repl {
@@ -62,7 +66,14 @@ using OpTimeWithHash = OpTimeWith<long long>;
  * Pushes operations from each batch of operations onto a buffer using the "enqueueDocumentsFn"
  * function.
  *
- * Issues a getMore command after successfully processing each batch of operations.
+ * Issues a getMore command after successfully validating each batch of operations. Unless the
+ * "oplogFetcherPipelineGetMores" server parameter is disabled, the batch is pushed onto the buffer
+ * by a separate executor task so that the next getMore is in flight while "enqueueDocumentsFn"
+ * waits for space in the buffer. At most one batch is waiting to be enqueued at any time.
+ *
+ * Unless the "oplogFetcherAdaptiveBatchSize" server parameter is disabled, the getMore batch size
+ * is limited to the number of operations the applier consumes in one round trip to the sync
+ * source whenever enqueueing a batch had to wait for the applier.
  *
  * When there is an error or when it is not possible to issue another getMore request, calls
  * "onShutdownCallbackFn" to signal the end of processing.
@@ -136,7 +147,8 @@ public:
     std::string toString() const;
 
     /**
-     * Returns true if we have scheduled the fetcher to read the oplog on the sync source.
+     * Returns true if we have scheduled the fetcher to read the oplog on the sync source or if a
+     * batch of operations is still waiting to be enqueued.
      */
     bool isActive() const;
 
@@ -155,6 +167,7 @@ public:
     /**
      * Waits until the oplog fetcher is inactive.
      * It is fine to call this multiple times.
+     * Must not be called from a task executor thread.
      */
     void join();
 
@@ -195,6 +208,39 @@ private:
      */
     void _callback(const Fetcher::QueryResponseStatus& result, BSONObjBuilder* getMoreBob);
 
+    /**
+     * Pushes the operations to apply in 'documents' onto the buffer using "enqueueDocumentsFn" and
+     * updates the last fetched optime and hash. Samples the applier throughput if the buffer was
+     * full for a measurable amount of time.
+     */
+    void _enqueueDocuments(const Fetcher::Documents& documents,
+                           bool first,
+                           const DocumentsInfo& info,
+                           Milliseconds remoteCommandProcessingTime);
+
+    /**
+     * Executor task pushing a batch of operations onto the buffer after the getMore for the next
+     * batch has been sent. Runs the shutdown callback if the fetcher completed while the batch
+     * was waiting to be enqueued.
+     */
+    void _enqueueDocumentsCallback(const executor::TaskExecutor::CallbackArgs& callbackArgs,
+                                   const Fetcher::Documents& documents,
+                                   bool first,
+                                   const DocumentsInfo& info,
+                                   Milliseconds remoteCommandProcessingTime);
+
+    /**
+     * Waits for the previous batch of operations to be enqueued.
+     * Returns an error if the batch was dropped because the enqueue task was canceled.
+     */
+    Status _waitForPendingEnqueue();
+
+    /**
+     * Returns the batch size to request in the next getMore command, or boost::none to let the
+     * sync source choose.
+     */
+    boost::optional<long long> _getBatchSize_inlock() const;
+
     /**
      * Notifies caller that the oplog fetcher has completed processing operations from
      * the remote oplog.
@@ -202,6 +248,7 @@ private:
     void _onShutdown(Status status);
     void _onShutdown(Status status, OpTimeWithHash opTimeWithHash);
 
+    executor::TaskExecutor* const _executor;
     DataReplicatorExternalState* _dataReplicatorExternalState;
     Fetcher _fetcher;
     const EnqueueDocumentsFn _enqueueDocumentsFn;
@@ -215,6 +262,28 @@ private:
     // tailing query and to keep track of the last known operation consumed via
     // "_enqueueDocumentsFn".
     OpTimeWithHash _lastFetched;
+
+    // Set while a batch of operations handed off to '_executor' has not been enqueued yet.
+    bool _enqueueInProgress = false;
+
+    // Signaled when '_enqueueInProgress' is cleared.
+    stdx::condition_variable _enqueueFinishedCondition;
+
+    // Set to an error if a batch of operations was dropped because its enqueue task was canceled.
+    Status _enqueueStatus = Status::OK();
+
+    // Final status reported by the fetcher while a batch was still waiting to be enqueued. The
+    // shutdown callback is deferred until the batch has been enqueued.
+    boost::optional<Status> _pendingShutdownStatus;
+
+    // Moving averages used to size getMore batches: round trip time of getMore commands returning
+    // operations, size of fetched operations and rate at which the applier drains the buffer.
+    double _roundTripMillis = 0.0;
+    double _averageDocumentBytes = 0.0;
+    double _applierBytesPerMilli = 0.0;
+
+    // True if enqueueing the last batch had to wait for space in the buffer.
+    bool _lastEnqueueBlocked = false;
 };
 
 }  // namespace repl
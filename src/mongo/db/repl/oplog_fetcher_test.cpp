@@ -39,6 +39,7 @@
 #include "mongo/rpc/metadata/server_selection_metadata.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/time_support.h"
 
 namespace {
 
@@ -727,6 +728,57 @@ TEST_F(OplogFetcherTest,
     ASSERT_FALSE(request.cmdObj.hasField("lastKnownCommittedOpTime"));
 }
 
+TEST_F(OplogFetcherTest, GetMoreBatchSizeIsLimitedAfterEnqueueingOperationsHadToWaitForSpace) {
+    ShutdownState shutdownState;
+
+    // Takes a measurable amount of time to enqueue each batch, as if the buffer was full.
+    auto slowEnqueueDocumentsFn = [this](Fetcher::Documents::const_iterator begin,
+                                         Fetcher::Documents::const_iterator end,
+                                         const OplogFetcher::DocumentsInfo& info,
+                                         Milliseconds elapsed) {
+        sleepmillis(5);
+        enqueueDocumentsFn(begin, end, info, elapsed);
+    };
+
+    OplogFetcher oplogFetcher(&getExecutor(),
+                              lastFetched,
+                              source,
+                              nss,
+                              _createConfig(true),
+                              dataReplicatorExternalState.get(),
+                              slowEnqueueDocumentsFn,
+                              stdx::ref(shutdownState));
+
+    ASSERT_OK(oplogFetcher.startup());
+
+    CursorId cursorId = 22LL;
+    auto firstEntry = makeNoopOplogEntry(lastFetched);
+    auto secondEntry = makeNoopOplogEntry({{Seconds(456), 0}, lastFetched.opTime.getTerm()}, 200);
+    processNetworkResponse(makeCursorResponse(cursorId, {firstEntry, secondEntry}), true);
+
+    // The first getMore is sent before the first batch has been enqueued.
+    auto thirdEntry = makeNoopOplogEntry({{Seconds(789), 0}, lastFetched.opTime.getTerm()}, 300);
+    auto request = processNetworkResponse(makeCursorResponse(cursorId, {thirdEntry}, false), true);
+    ASSERT_EQUALS(std::string("getMore"), request.cmdObj.firstElementFieldName());
+    ASSERT_FALSE(request.cmdObj.hasField("batchSize"));
+
+    auto fourthEntry = makeNoopOplogEntry({{Seconds(1200), 0}, lastFetched.opTime.getTerm()}, 400);
+    request = processNetworkResponse(makeCursorResponse(0, {fourthEntry}, false));
+    ASSERT_EQUALS(std::string("getMore"), request.cmdObj.firstElementFieldName());
+    ASSERT_GREATER_THAN_OR_EQUALS(request.cmdObj["batchSize"].numberLong(), 100LL);
+
+    ASSERT_EQUALS(1U, lastEnqueuedDocuments.size());
+    ASSERT_EQUALS(fourthEntry, lastEnqueuedDocuments[0]);
+
+    oplogFetcher.shutdown();
+    oplogFetcher.join();
+
+    ASSERT_OK(shutdownState.getStatus());
+    ASSERT_EQUALS(OpTimeWithHash(fourthEntry["h"].numberLong(),
+                                 unittest::assertGet(OpTime::parseFromOplogEntry(fourthEntry))),
+                  shutdownState.getLastFetched());
+}
+
 TEST_F(OplogFetcherTest, ValidateDocumentsReturnsNoSuchKeyIfTimestampIsNotFoundInAnyDocument) {
     auto firstEntry = makeNoopOplogEntry(Seconds(123), 100);
     auto secondEntry = BSON("o" << BSON("msg"
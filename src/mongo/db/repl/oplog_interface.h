@@ -35,6 +35,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/timestamp.h"
 #include "mongo/db/record_id.h"
 
 namespace mongo {
@@ -58,6 +59,15 @@ public:
      * Produces an iterator over oplog collection in reverse natural order.
      */
     virtual std::unique_ptr<Iterator> makeIterator() const = 0;
+
+    /**
+     * Produces an iterator over the oplog collection in reverse natural order, starting at the
+     * newest operation whose timestamp is at most 'ts'. Implementations which can't seek may start
+     * at the newest operation instead, so callers must be prepared to skip newer operations.
+     */
+    virtual std::unique_ptr<Iterator> makeIteratorUpTo(const Timestamp& ts) const {
+        return makeIterator();
+    }
 };
 
 class OplogInterface::Iterator {
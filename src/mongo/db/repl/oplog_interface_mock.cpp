@@ -73,5 +73,14 @@ std::unique_ptr<OplogInterface::Iterator> OplogInterfaceMock::makeIterator() con
         new OplogIteratorMock(_operations.begin(), _operations.end()));
 }
 
+std::unique_ptr<OplogInterface::Iterator> OplogInterfaceMock::makeIteratorUpTo(
+    const Timestamp& ts) const {
+    auto it = _operations.begin();
+    while (it != _operations.end() && it->first["ts"].timestamp() > ts) {
+        ++it;
+    }
+    return std::unique_ptr<OplogInterface::Iterator>(new OplogIteratorMock(it, _operations.end()));
+}
+
 }  // namespace repl
 }  // namespace mongo
@@ -47,6 +47,7 @@ public:
     explicit OplogInterfaceMock(const Operations& operations);
     std::string toString() const override;
     std::unique_ptr<OplogInterface::Iterator> makeIterator() const override;
+    std::unique_ptr<OplogInterface::Iterator> makeIteratorUpTo(const Timestamp& ts) const override;
 
 private:
     Operations _operations;
@@ -79,5 +79,20 @@ std::unique_ptr<OplogInterface::Iterator> OplogInterfaceRemote::makeIterator() c
         _getConnection()->query(_collectionName, query, 0, 0, &fields, 0, 0)));
 }
 
+std::unique_ptr<OplogInterface::Iterator> OplogInterfaceRemote::makeIteratorUpTo(
+    const Timestamp& ts) const {
+    // With oplogReplay the sync source seeks straight to 'ts' instead of scanning back to it.
+    const Query query = Query(BSON("ts" << BSON("$lte" << ts))).sort(BSON("$natural" << -1));
+    const BSONObj fields = BSON("ts" << 1 << "h" << 1);
+    std::unique_ptr<DBClientCursor> cursor = _getConnection()->query(
+        _collectionName, query, 0, 0, &fields, QueryOption_OplogReplay, 0);
+
+    // Older sync sources reject a reverse oplogReplay query.
+    if (!cursor || cursor->peekError()) {
+        return makeIterator();
+    }
+    return std::unique_ptr<OplogInterface::Iterator>(new OplogIteratorRemote(std::move(cursor)));
+}
+
 }  // namespace repl
 }  // namespace mongo
@@ -51,6 +51,7 @@ public:
     OplogInterfaceRemote(GetConnectionFn getConnection, const std::string& collectionName);
     std::string toString() const override;
     std::unique_ptr<OplogInterface::Iterator> makeIterator() const override;
+    std::unique_ptr<OplogInterface::Iterator> makeIteratorUpTo(const Timestamp& ts) const override;
 
 private:
     GetConnectionFn _getConnection;
@@ -53,6 +53,7 @@
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_buffer_blocking_queue.h"
 #include "mongo/db/repl/oplog_buffer_collection.h"
+#include "mongo/db/repl/oplog_buffer_spillable.h"
 #include "mongo/db/repl/repl_settings.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/repl/rs_initialsync.h"
@@ -97,6 +98,7 @@ const char tsFieldName[] = "ts";
 
 const char kCollectionOplogBufferName[] = "collection";
 const char kBlockingQueueOplogBufferName[] = "inMemoryBlockingQueue";
+const char kSpillableOplogBufferName[] = "spillable";
 
 // Set this to true to force background creation of snapshots even if --enableMajorityReadConcern
 // isn't specified. This can be used for A-B benchmarking to find how much overhead
@@ -111,12 +113,31 @@ MONGO_EXPORT_STARTUP_SERVER_PARAMETER(initialSyncOplogBuffer,
                                       std::string,
                                       kBlockingQueueOplogBufferName);
 
+// Set this to "spillable" to buffer the oplog during steady state replication in memory up to a
+// fixed size, and in temporary files beyond that.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(steadyStateOplogBuffer,
+                                      std::string,
+                                      kBlockingQueueOplogBufferName);
+
+// Size of the oplog entries a spillable oplog buffer holds in memory before writing the rest to
+// temporary files.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(spillableOplogBufferMaxMemoryMB, int, 256);
+
 MONGO_INITIALIZER(initialSyncOplogBuffer)(InitializerContext*) {
     if ((initialSyncOplogBuffer != kCollectionOplogBufferName) &&
-        (initialSyncOplogBuffer != kBlockingQueueOplogBufferName)) {
+        (initialSyncOplogBuffer != kBlockingQueueOplogBufferName) &&
+        (initialSyncOplogBuffer != kSpillableOplogBufferName)) {
         return Status(ErrorCodes::BadValue,
                       "unsupported initial sync oplog buffer option: " + initialSyncOplogBuffer);
     }
+    if ((steadyStateOplogBuffer != kBlockingQueueOplogBufferName) &&
+        (steadyStateOplogBuffer != kSpillableOplogBufferName)) {
+        return Status(ErrorCodes::BadValue,
+                      "unsupported steady state oplog buffer option: " + steadyStateOplogBuffer);
+    }
+    if (spillableOplogBufferMaxMemoryMB <= 0) {
+        return Status(ErrorCodes::BadValue, "spillableOplogBufferMaxMemoryMB must be positive");
+    }
     if (!useDataReplicatorInitialSync && (initialSyncOplogBuffer == kCollectionOplogBufferName)) {
         return Status(ErrorCodes::BadValue,
                       "cannot use collection oplog buffer without --setParameter "
@@ -138,6 +159,15 @@ std::unique_ptr<ThreadPool> makeThreadPool() {
     return stdx::make_unique<ThreadPool>(threadPoolOptions);
 }
 
+/**
+ * Returns new spillable oplog buffer which holds up to 'spillableOplogBufferMaxMemoryMB' in memory.
+ */
+std::unique_ptr<OplogBuffer> makeSpillableOplogBuffer() {
+    OplogBufferSpillable::Options options;
+    options.maxMemorySize = static_cast<std::size_t>(spillableOplogBufferMaxMemoryMB) * 1024 * 1024;
+    return stdx::make_unique<OplogBufferSpillable>(options);
+}
+
 }  // namespace
 
 ReplicationCoordinatorExternalStateImpl::ReplicationCoordinatorExternalStateImpl(
@@ -611,6 +641,8 @@ std::unique_ptr<OplogBuffer> ReplicationCoordinatorExternalStateImpl::makeInitia
     OperationContext* txn) const {
     if (initialSyncOplogBuffer == kCollectionOplogBufferName) {
         return stdx::make_unique<OplogBufferCollection>(StorageInterface::get(txn));
+    } else if (initialSyncOplogBuffer == kSpillableOplogBufferName) {
+        return makeSpillableOplogBuffer();
     } else {
         return stdx::make_unique<OplogBufferBlockingQueue>();
     }
@@ -618,6 +650,9 @@ std::unique_ptr<OplogBuffer> ReplicationCoordinatorExternalStateImpl::makeInitia
 
 std::unique_ptr<OplogBuffer> ReplicationCoordinatorExternalStateImpl::makeSteadyStateOplogBuffer(
     OperationContext* txn) const {
+    if (steadyStateOplogBuffer == kSpillableOplogBufferName) {
+        return makeSpillableOplogBuffer();
+    }
     return stdx::make_unique<OplogBufferBlockingQueue>();
 }
 
@@ -230,7 +230,9 @@ void ReplicationCoordinatorExternalStateMock::dropAllSnapshots() {}
 void ReplicationCoordinatorExternalStateMock::updateCommittedSnapshot(SnapshotName newCommitPoint) {
 }
 
-void ReplicationCoordinatorExternalStateMock::forceSnapshotCreation() {}
+void ReplicationCoordinatorExternalStateMock::forceSnapshotCreation() {
+    _numForcedSnapshots++;
+}
 
 bool ReplicationCoordinatorExternalStateMock::snapshotsEnabled() const {
     return _areSnapshotsEnabled;
@@ -240,6 +242,10 @@ void ReplicationCoordinatorExternalStateMock::setAreSnapshotsEnabled(bool val) {
     _areSnapshotsEnabled = val;
 }
 
+int ReplicationCoordinatorExternalStateMock::getNumForcedSnapshots() const {
+    return _numForcedSnapshots;
+}
+
 void ReplicationCoordinatorExternalStateMock::notifyOplogMetadataWaiters() {}
 
 double ReplicationCoordinatorExternalStateMock::getElectionTimeoutOffsetLimitFraction() const {
@@ -174,6 +174,11 @@ public:
      */
     void setAreSnapshotsEnabled(bool val);
 
+    /**
+     * Returns the number of times forceSnapshotCreation() was called.
+     */
+    int getNumForcedSnapshots() const;
+
 private:
     StatusWith<BSONObj> _localRsConfigDocument;
     StatusWith<LastVote> _localRsLastVoteDocument;
@@ -196,6 +201,7 @@ private:
     bool _threadsStarted;
     bool _isReadCommittedSupported = true;
     bool _areSnapshotsEnabled = true;
+    int _numForcedSnapshots = 0;
 };
 
 }  // namespace repl
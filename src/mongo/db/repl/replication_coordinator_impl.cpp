@@ -36,6 +36,7 @@
 #include <limits>
 
 #include "mongo/base/status.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/global_timestamp.h"
 #include "mongo/db/index/index_descriptor.h"
@@ -61,6 +62,7 @@
 #include "mongo/db/repl/replication_executor.h"
 #include "mongo/db/repl/rslog.h"
 #include "mongo/db/repl/storage_interface.h"
+#include "mongo/db/stats/timer_stats.h"
 #include "mongo/db/repl/topology_coordinator.h"
 #include "mongo/db/repl/update_position_args.h"
 #include "mongo/db/repl/vote_requester.h"
@@ -94,6 +96,11 @@ namespace {
 Status shutDownInProgressStatus(ErrorCodes::ShutdownInProgress,
                                 "replication system is shutting down");
 
+// The time majority reads spent waiting for their OpTime to be in the committed snapshot.
+TimerStats majorityReadWaitStats;
+ServerStatusMetricField<TimerStats> displayMajorityReadWaits("repl.readConcern.majorityWaits",
+                                                             &majorityReadWaitStats);
+
 void lockAndCall(stdx::unique_lock<stdx::mutex>* lk, const stdx::function<void()>& fn) {
     if (!lk->owns_lock()) {
         lk->lock();
@@ -148,7 +155,7 @@ struct ReplicationCoordinatorImpl::WaiterInfo {
      * Constructor takes the list of waiters and enqueues itself on the list, removing itself
      * in the destructor.
      */
-    WaiterInfo(std::vector<WaiterInfo*>* _list,
+    WaiterInfo(WaiterList* _list,
                unsigned int _opID,
                const OpTime* _opTime,
                const WriteConcernOptions* _writeConcern,
@@ -159,11 +166,11 @@ struct ReplicationCoordinatorImpl::WaiterInfo {
           opTime(_opTime),
           writeConcern(_writeConcern),
           condVar(_condVar) {
-        list->push_back(this);
+        position = list->emplace(*opTime, this);
     }
 
     ~WaiterInfo() {
-        list->erase(std::remove(list->begin(), list->end(), this), list->end());
+        list->erase(position);
     }
 
     BSONObj toBSON() const {
@@ -183,7 +190,8 @@ struct ReplicationCoordinatorImpl::WaiterInfo {
         return toBSON().toString();
     };
 
-    std::vector<WaiterInfo*>* list;
+    WaiterList* list;
+    WaiterList::iterator position;
     bool master;  // Set to false to indicate that stepDown was called while waiting
     const unsigned int opID;
     const OpTime* opTime;
@@ -192,6 +200,20 @@ struct ReplicationCoordinatorImpl::WaiterInfo {
 };
 
 namespace {
+/**
+ * Returns the key in _replicationWaiterList of the waiters for 'writeConcern'. Waiters with the
+ * same key are satisfied in the order of the OpTimes they wait for.
+ */
+std::string getWriteConcernClass(const WriteConcernOptions& writeConcern) {
+    str::stream key;
+    if (writeConcern.wMode.empty()) {
+        key << "w: " << writeConcern.wNumNodes;
+    } else {
+        key << "mode: " << writeConcern.wMode;
+    }
+    return key << ", sync: " << static_cast<int>(writeConcern.syncMode);
+}
+
 ReplicationCoordinator::Mode getReplicationModeFromSettings(const ReplSettings& settings) {
     if (settings.usingReplSets()) {
         return ReplicationCoordinator::modeReplSet;
@@ -585,11 +607,10 @@ void ReplicationCoordinatorImpl::shutdown(OperationContext* txn) {
             return;
         }
         fassert(18823, _rsConfigState != kConfigStartingUp);
-        for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-             it != _replicationWaiterList.end();
-             ++it) {
-            WaiterInfo* waiter = *it;
-            waiter->condVar->notify_all();
+        for (auto&& waiters : _replicationWaiterList) {
+            for (auto&& waiter : waiters.second) {
+                waiter.second->condVar->notify_all();
+            }
         }
     }
 
@@ -1019,10 +1040,10 @@ void ReplicationCoordinatorImpl::_setMyLastAppliedOpTime_inlock(const OpTime& op
     invariant(isRollbackAllowed || mySlaveInfo->lastAppliedOpTime <= opTime);
     _updateSlaveInfoAppliedOpTime_inlock(mySlaveInfo, opTime);
 
-    for (auto& opTimeWaiter : _opTimeWaiterList) {
-        if (*(opTimeWaiter->opTime) <= opTime) {
-            opTimeWaiter->condVar->notify_all();
-        }
+    for (auto it = _opTimeWaiterList.begin();
+         it != _opTimeWaiterList.end() && it->first <= opTime;
+         ++it) {
+        it->second->condVar->notify_all();
     }
 }
 
@@ -1092,7 +1113,8 @@ ReadConcernResponse ReplicationCoordinatorImpl::waitUntilOpTime(OperationContext
         return isMajorityReadConcern ? committedOptime : _getMyLastAppliedOpTime_inlock();
     };
 
-    if (isMajorityReadConcern && targetOpTime > getCurrentOpTime()) {
+    const bool waitForSnapshot = isMajorityReadConcern && targetOpTime > getCurrentOpTime();
+    if (waitForSnapshot) {
         LOG(1) << "waitUntilOpTime: waiting for optime:" << targetOpTime
                << " to be in a snapshot -- current snapshot: " << getCurrentOpTime();
     }
@@ -1140,6 +1162,9 @@ ReadConcernResponse ReplicationCoordinatorImpl::waitUntilOpTime(OperationContext
         }
     }
 
+    if (waitForSnapshot) {
+        majorityReadWaitStats.recordMillis(timer.millis());
+    }
     return ReadConcernResponse(Status::OK(), Milliseconds(timer.millis()));
 }
 
@@ -1326,19 +1351,19 @@ void ReplicationCoordinatorImpl::interrupt(unsigned opId) {
         // Wake ops waiting for a new committed snapshot.
         _currentCommittedSnapshotCond.notify_all();
 
-        for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-             it != _replicationWaiterList.end();
-             ++it) {
-            WaiterInfo* info = *it;
-            if (info->opID == opId) {
-                info->condVar->notify_all();
-                return;
+        for (auto&& waiters : _replicationWaiterList) {
+            for (auto&& waiter : waiters.second) {
+                WaiterInfo* info = waiter.second;
+                if (info->opID == opId) {
+                    info->condVar->notify_all();
+                    return;
+                }
             }
         }
 
         for (auto& opTimeWaiter : _opTimeWaiterList) {
-            if (opTimeWaiter->opID == opId) {
-                opTimeWaiter->condVar->notify_all();
+            if (opTimeWaiter.second->opID == opId) {
+                opTimeWaiter.second->condVar->notify_all();
                 return;
             }
         }
@@ -1356,15 +1381,14 @@ void ReplicationCoordinatorImpl::interruptAll() {
         // Wake ops waiting for a new committed snapshot.
         _currentCommittedSnapshotCond.notify_all();
 
-        for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-             it != _replicationWaiterList.end();
-             ++it) {
-            WaiterInfo* info = *it;
-            info->condVar->notify_all();
+        for (auto&& waiters : _replicationWaiterList) {
+            for (auto&& waiter : waiters.second) {
+                waiter.second->condVar->notify_all();
+            }
         }
 
         for (auto& opTimeWaiter : _opTimeWaiterList) {
-            opTimeWaiter->condVar->notify_all();
+            opTimeWaiter.second->condVar->notify_all();
         }
     }
 
@@ -1531,7 +1555,11 @@ ReplicationCoordinator::StatusAndDuration ReplicationCoordinatorImpl::_awaitRepl
 
     // Must hold _mutex before constructing waitInfo as it will modify _replicationWaiterList
     stdx::condition_variable condVar;
-    WaiterInfo waitInfo(&_replicationWaiterList, txn->getOpID(), &opTime, &writeConcern, &condVar);
+    WaiterInfo waitInfo(&_replicationWaiterList[getWriteConcernClass(writeConcern)],
+                        txn->getOpID(),
+                        &opTime,
+                        &writeConcern,
+                        &condVar);
     while (!_doneWaitingForReplication_inlock(opTime, minSnapshot, writeConcern)) {
         const Milliseconds elapsed{timer->millis()};
 
@@ -2463,12 +2491,12 @@ ReplicationCoordinatorImpl::_updateMemberStateFromTopologyCoordinator_inlock() {
     PostMemberStateUpdateAction result;
     if (_memberState.primary() || newState.removed() || newState.rollback()) {
         // Wake up any threads blocked in awaitReplication, close connections, etc.
-        for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-             it != _replicationWaiterList.end();
-             ++it) {
-            WaiterInfo* info = *it;
-            info->master = false;
-            info->condVar->notify_all();
+        for (auto&& waiters : _replicationWaiterList) {
+            for (auto&& waiter : waiters.second) {
+                WaiterInfo* info = waiter.second;
+                info->master = false;
+                info->condVar->notify_all();
+            }
         }
         _canAcceptNonLocalWrites = false;
         result = kActionCloseAllConnections;
@@ -2675,14 +2703,20 @@ ReplicationCoordinatorImpl::_setCurrentRSConfig_inlock(const ReplicaSetConfig& n
 }
 
 void ReplicationCoordinatorImpl::_wakeReadyWaiters_inlock() {
-    for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-         it != _replicationWaiterList.end();
-         ++it) {
-        WaiterInfo* info = *it;
-        if (_doneWaitingForReplication_inlock(
-                *info->opTime, SnapshotName::min(), *info->writeConcern)) {
+    for (auto waiters = _replicationWaiterList.begin(); waiters != _replicationWaiterList.end();) {
+        if (waiters->second.empty()) {
+            waiters = _replicationWaiterList.erase(waiters);
+            continue;
+        }
+        for (auto&& waiter : waiters->second) {
+            WaiterInfo* info = waiter.second;
+            if (!_doneWaitingForReplication_inlock(
+                    *info->opTime, SnapshotName::min(), *info->writeConcern)) {
+                break;
+            }
             info->condVar->notify_all();
         }
+        ++waiters;
     }
 }
 
@@ -3100,6 +3134,14 @@ void ReplicationCoordinatorImpl::_setLastCommittedOpTime_inlock(const OpTime& co
         // committed snapshot need to be woken up.
         _updateCommittedSnapshot_inlock(newSnapshot);
     }
+
+    if (_uncommittedSnapshots.empty() &&
+        (!_currentCommittedSnapshot || _currentCommittedSnapshot->opTime < committedOpTime)) {
+        // No snapshot includes the commit point yet, so majority reads of the newly committed
+        // writes would wait for the SnapshotThread to get to them. Have it take one right away,
+        // which is committed as soon as it's created.
+        _externalState->forceSnapshotCreation();
+    }
 }
 
 void ReplicationCoordinatorImpl::_setFirstOpTimeOfMyTerm(const OpTime& newOpTime) {
@@ -28,7 +28,9 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -505,6 +507,9 @@ private:
     // Struct that holds information about clients waiting for replication.
     struct WaiterInfo;
 
+    // Waiters ordered by the OpTime they wait for. Does *not* own the WaiterInfos.
+    using WaiterList = std::multimap<OpTime, WaiterInfo*>;
+
     // Struct that holds information about nodes in this replication group, mainly used for
     // tracking replication progress for write concern satisfaction.
     struct SlaveInfo {
@@ -601,6 +606,9 @@ private:
 
     /**
      * Helper to wake waiters in _replicationWaiterList that are doneWaitingForReplication.
+     *
+     * A write concern which is satisfied at some OpTime is satisfied at every earlier OpTime too,
+     * so only the waiters of each write concern up to the first one still waiting are checked.
      */
     void _wakeReadyWaiters_inlock();
 
@@ -1174,12 +1182,13 @@ private:
     // TODO: ideally this should only change on rollbacks NOT on mongod restarts also.
     int _rbid;  // (M)
 
-    // list of information about clients waiting on replication.  Does *not* own the WaiterInfos.
-    std::vector<WaiterInfo*> _replicationWaiterList;  // (M)
+    // Information about clients waiting on replication, keyed by the number of nodes or the mode
+    // and the sync mode of their write concern, since only waiters whose write concerns differ
+    // only in the OpTime waited for are satisfied in OpTime order.
+    std::map<std::string, WaiterList> _replicationWaiterList;  // (M)
 
-    // list of information about clients waiting for a particular opTime.
-    // Does *not* own the WaiterInfos.
-    std::vector<WaiterInfo*> _opTimeWaiterList;  // (M)
+    // Information about clients waiting for a particular opTime.
+    WaiterList _opTimeWaiterList;  // (M)
 
     // Set to true when we are in the process of shutting down replication.
     bool _inShutdown;  // (M)
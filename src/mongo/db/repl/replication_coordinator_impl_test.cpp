@@ -1177,6 +1177,65 @@ TEST_F(ReplCoordTest, NodeReturnsOkWhenAWriteConcernWithNoTimeoutHasBeenSatisfie
     awaiter.reset();
 }
 
+TEST_F(ReplCoordTest, NodeWakesWaitersForSeveralOpTimesAndWriteConcernsAsEachIsSatisfied) {
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version"
+                            << 2
+                            << "members"
+                            << BSON_ARRAY(BSON("host"
+                                               << "node1:12345"
+                                               << "_id"
+                                               << 0)
+                                          << BSON("host"
+                                                  << "node2:12345"
+                                                  << "_id"
+                                                  << 1)
+                                          << BSON("host"
+                                                  << "node3:12345"
+                                                  << "_id"
+                                                  << 2))),
+                       HostAndPort("node1", 12345));
+    ASSERT(getReplCoord()->setFollowerMode(MemberState::RS_SECONDARY));
+    getReplCoord()->setMyLastAppliedOpTime(OpTimeWithTermZero(100, 0));
+    getReplCoord()->setMyLastDurableOpTime(OpTimeWithTermZero(100, 0));
+    simulateSuccessfulV1Election();
+
+    OpTimeWithTermZero time1(100, 1);
+    OpTimeWithTermZero time2(100, 2);
+
+    WriteConcernOptions twoNodes;
+    twoNodes.wTimeout = WriteConcernOptions::kNoTimeout;
+    twoNodes.wNumNodes = 2;
+    WriteConcernOptions threeNodes = twoNodes;
+    threeNodes.wNumNodes = 3;
+
+    // Waiters with the same write concern are kept in OpTime order, apart from those of others.
+    ReplicationAwaiter twoNodesTime2(getReplCoord(), getServiceContext());
+    twoNodesTime2.setOpTime(time2);
+    twoNodesTime2.setWriteConcern(twoNodes);
+    twoNodesTime2.start();
+    ReplicationAwaiter twoNodesTime1(getReplCoord(), getServiceContext());
+    twoNodesTime1.setOpTime(time1);
+    twoNodesTime1.setWriteConcern(twoNodes);
+    twoNodesTime1.start();
+    ReplicationAwaiter threeNodesTime1(getReplCoord(), getServiceContext());
+    threeNodesTime1.setOpTime(time1);
+    threeNodesTime1.setWriteConcern(threeNodes);
+    threeNodesTime1.start();
+
+    getReplCoord()->setMyLastAppliedOpTime(time2);
+    getReplCoord()->setMyLastDurableOpTime(time2);
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 1, time1));
+    ASSERT_OK(twoNodesTime1.getResult().status);
+
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 1, time2));
+    ASSERT_OK(twoNodesTime2.getResult().status);
+
+    ASSERT_OK(getReplCoord()->setLastAppliedOptime_forTest(2, 2, time1));
+    ASSERT_OK(threeNodesTime1.getResult().status);
+}
+
 TEST_F(ReplCoordTest, NodeReturnsWriteConcernFailedWhenAWriteConcernTimesOutBeforeBeingSatisified) {
     assertStartSuccess(BSON("_id"
                             << "mySet"
@@ -4366,6 +4425,44 @@ TEST_F(ReplCoordTest,
     ASSERT_EQUALS(time6, getReplCoord()->getCurrentCommittedSnapshotOpTime());
 }
 
+TEST_F(ReplCoordTest, ForceSnapshotCreationWhenTheCommitPointPassesEveryUncommittedSnapshot) {
+    init("mySet");
+
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version"
+                            << 1
+                            << "members"
+                            << BSON_ARRAY(BSON("_id" << 0 << "host"
+                                                     << "test1:1234"))),
+                       HostAndPort("test1", 1234));
+    runSingleNodeElection(makeOperationContext(), getReplCoord());
+
+    OpTime time1(Timestamp(100, 1), 1);
+    OpTime time2(Timestamp(100, 2), 1);
+    OpTime time3(Timestamp(100, 3), 1);
+
+    getReplCoord()->onSnapshotCreate(time1, SnapshotName(1));
+    getReplCoord()->onSnapshotCreate(time2, SnapshotName(2));
+
+    // The snapshot at the commit point is committed, so none is needed.
+    const int numForcedSnapshots = getExternalState()->getNumForcedSnapshots();
+    getReplCoord()->setMyLastAppliedOpTime(time2);
+    getReplCoord()->setMyLastDurableOpTime(time2);
+    ASSERT_EQUALS(time2, getReplCoord()->getCurrentCommittedSnapshotOpTime());
+    ASSERT_EQUALS(numForcedSnapshots, getExternalState()->getNumForcedSnapshots());
+
+    // No snapshot includes the new commit point.
+    getReplCoord()->setMyLastAppliedOpTime(time3);
+    getReplCoord()->setMyLastDurableOpTime(time3);
+    ASSERT_EQUALS(time2, getReplCoord()->getCurrentCommittedSnapshotOpTime());
+    ASSERT_EQUALS(numForcedSnapshots + 1, getExternalState()->getNumForcedSnapshots());
+
+    // The forced snapshot is committed as soon as it is created.
+    getReplCoord()->onSnapshotCreate(time3, SnapshotName(3));
+    ASSERT_EQUALS(time3, getReplCoord()->getCurrentCommittedSnapshotOpTime());
+}
+
 TEST_F(ReplCoordTest, ZeroCommittedSnapshotWhenAllSnapshotsAreDropped) {
     init("mySet");
 
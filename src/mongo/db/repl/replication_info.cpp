@@ -49,6 +49,7 @@
 #include "mongo/db/wire_version.h"
 #include "mongo/executor/network_interface.h"
 #include "mongo/s/write_ops/batched_command_request.h"
+#include "mongo/transport/message_compressor_manager.h"
 
 namespace mongo {
 
@@ -252,6 +253,10 @@ public:
         result.append("maxWireVersion", WireSpec::instance().maxWireVersionIncoming);
         result.append("minWireVersion", WireSpec::instance().minWireVersionIncoming);
         result.append("readOnly", storageGlobalParams.readOnly);
+
+        if (AbstractMessagingPort* mp = txn->getClient()->port()) {
+            mp->compressorManager().serverNegotiate(cmdObj, &result);
+        }
         return true;
     }
 } cmdismaster;
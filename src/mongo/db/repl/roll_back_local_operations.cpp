@@ -149,6 +149,11 @@ StatusWith<RollBackLocalOperations::RollbackCommonPoint> RollBackLocalOperations
     return RollbackCommonPoint(Timestamp(Seconds(1), 0), RecordId());
 }
 
+Timestamp RollBackLocalOperations::getLocalTimestamp() const {
+    invariant(_scanned > 0);
+    return getTimestamp(_localOplogValue);
+}
+
 StatusWith<RollBackLocalOperations::RollbackCommonPoint> syncRollBackLocalOperations(
     const OplogInterface& localOplog,
     const OplogInterface& remoteOplog,
@@ -162,6 +167,7 @@ StatusWith<RollBackLocalOperations::RollbackCommonPoint> syncRollBackLocalOperat
 
     RollBackLocalOperations finder(localOplog, rollbackOperation);
     Timestamp theirTime;
+    bool seekedRemote = false;
     while (remoteResult.isOK()) {
         theirTime = remoteResult.getValue().first["ts"].timestamp();
         BSONObj theirObj = remoteResult.getValue().first;
@@ -171,6 +177,13 @@ StatusWith<RollBackLocalOperations::RollbackCommonPoint> syncRollBackLocalOperat
         } else if (result.getStatus().code() != ErrorCodes::NoSuchKey) {
             return result;
         }
+
+        // None of the remote operations newer than our own can be the common point, so seek past
+        // them all at once rather than reading them one by one.
+        if (!seekedRemote && theirTime > finder.getLocalTimestamp()) {
+            seekedRemote = true;
+            remoteIterator = remoteOplog.makeIteratorUpTo(finder.getLocalTimestamp());
+        }
         remoteResult = remoteIterator->next();
     }
 
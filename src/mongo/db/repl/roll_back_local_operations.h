@@ -68,6 +68,13 @@ public:
      */
     StatusWith<RollbackCommonPoint> onRemoteOperation(const BSONObj& operation);
 
+    /**
+     * Returns the timestamp of the local operation the next remote operation is compared with.
+     * Remote operations newer than it can't be the common point. Only valid after a call to
+     * onRemoteOperation() returned ErrorCodes::NoSuchKey.
+     */
+    Timestamp getLocalTimestamp() const;
+
 private:
     std::unique_ptr<OplogInterface::Iterator> _localOplogIterator;
     RollbackOperationFn _rollbackOperation;
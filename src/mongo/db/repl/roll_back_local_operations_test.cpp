@@ -294,6 +294,39 @@ TEST(SyncRollBackLocalOperationsTest, SkipOneRemoteOperation) {
     ASSERT_EQUALS(commonOperation.second, result.getValue().second);
 }
 
+TEST(SyncRollBackLocalOperationsTest, SeekPastNewerRemoteOperations) {
+    class SeekRecordingOplogInterface : public OplogInterfaceMock {
+    public:
+        using OplogInterfaceMock::OplogInterfaceMock;
+        std::unique_ptr<Iterator> makeIteratorUpTo(const Timestamp& ts) const override {
+            seekedTo.push_back(ts);
+            return OplogInterfaceMock::makeIteratorUpTo(ts);
+        }
+        mutable std::vector<Timestamp> seekedTo;
+    };
+
+    auto commonOperation = makeOpAndRecordId(1, 1);
+    auto localOperation = makeOpAndRecordId(2, 1);
+    SeekRecordingOplogInterface remoteOplog({makeOpAndRecordId(5, 1),
+                                             makeOpAndRecordId(4, 1),
+                                             makeOpAndRecordId(3, 1),
+                                             commonOperation});
+    bool called = false;
+    auto result = syncRollBackLocalOperations(OplogInterfaceMock({localOperation, commonOperation}),
+                                              remoteOplog,
+                                              [&](const BSONObj& operation) {
+                                                  ASSERT_EQUALS(localOperation.first, operation);
+                                                  called = true;
+                                                  return Status::OK();
+                                              });
+    ASSERT_OK(result.getStatus());
+    ASSERT_EQUALS(commonOperation.first["ts"].timestamp(), result.getValue().first);
+    ASSERT_EQUALS(commonOperation.second, result.getValue().second);
+    ASSERT_TRUE(called);
+    ASSERT_EQUALS(1U, remoteOplog.seekedTo.size());
+    ASSERT_EQUALS(localOperation.first["ts"].timestamp(), remoteOplog.seekedTo[0]);
+}
+
 TEST(SyncRollBackLocalOperationsTest, SameTimestampDifferentHashes) {
     auto commonOperation = makeOpAndRecordId(1, 1);
     auto localOperation = makeOpAndRecordId(1, 2);
@@ -68,6 +68,28 @@ BSONObj RollbackSourceImpl::findOne(const NamespaceString& nss, const BSONObj& f
     return _getConnection()->findOne(nss.toString(), filter, NULL, QueryOption_SlaveOk).getOwned();
 }
 
+std::vector<BSONObj> RollbackSourceImpl::findByIds(const NamespaceString& nss,
+                                                   const std::vector<BSONElement>& ids) const {
+    BSONObjBuilder filter;
+    {
+        BSONObjBuilder idBuilder(filter.subobjStart("_id"));
+        BSONArrayBuilder inBuilder(idBuilder.subarrayStart("$in"));
+        for (auto&& id : ids) {
+            inBuilder.append(id);
+        }
+    }
+
+    std::unique_ptr<DBClientCursor> cursor = _getConnection()->query(
+        nss.toString(), filter.obj(), 0, 0, NULL, QueryOption_SlaveOk);
+    uassert(40225, str::stream() << "query on " << nss.ns() << " failed", cursor);
+
+    std::vector<BSONObj> docs;
+    while (cursor->more()) {
+        docs.push_back(cursor->nextSafe().getOwned());
+    }
+    return docs;
+}
+
 void RollbackSourceImpl::copyCollectionFromRemote(OperationContext* txn,
                                                   const NamespaceString& nss) const {
     std::string errmsg;
@@ -36,12 +36,14 @@
 #include <algorithm>
 #include <memory>
 
+#include "mongo/base/counter.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/db/auth/authorization_manager.h"
 #include "mongo/db/auth/authorization_manager_global.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/collection_catalog_entry.h"
 #include "mongo/db/catalog/document_validation.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -144,6 +146,24 @@ struct DocID {
     }
 };
 
+// The most documents, and the most bytes of _ids, to refetch from the sync source with one query.
+const size_t kMaxRefetchBatchDocs = 1000;
+const int kMaxRefetchBatchBytes = 4 * 1024 * 1024;
+
+Counter64 rollbackRefetchedDocs;
+ServerStatusMetricField<Counter64> displayRollbackRefetchedDocs("repl.rollback.refetchedDocuments",
+                                                                &rollbackRefetchedDocs);
+Counter64 rollbackRefetchQueries;
+ServerStatusMetricField<Counter64> displayRollbackRefetchQueries("repl.rollback.refetchQueries",
+                                                                 &rollbackRefetchQueries);
+
+/**
+ * Returns true if values of 'type' may compare differently under a collation than they do here.
+ */
+bool isCollatableType(BSONType type) {
+    return type == String || type == Symbol || type == Object || type == Array;
+}
+
 struct FixUpInfo {
     // note this is a set -- if there are many $inc's on a single document we need to rollback,
     // we only need to refetch it once.
@@ -345,22 +365,54 @@ void syncFixUp(OperationContext* txn,
     DocID doc;
     unsigned long long numFetched = 0;
     try {
-        for (set<DocID>::iterator it = fixUpInfo.toRefetch.begin(); it != fixUpInfo.toRefetch.end();
-             it++) {
-            doc = *it;
+        // The documents to refetch are ordered by namespace, so each batch is a run of them in a
+        // single namespace, fetched with one query.
+        set<DocID>::iterator it = fixUpInfo.toRefetch.begin();
+        while (it != fixUpInfo.toRefetch.end()) {
+            std::vector<DocID> batch;
+            std::vector<BSONElement> ids;
+            int batchBytes = 0;
+            for (; it != fixUpInfo.toRefetch.end() && batch.size() < kMaxRefetchBatchDocs &&
+                 batchBytes < kMaxRefetchBatchBytes && (batch.empty() || !strcmp(it->ns, doc.ns));
+                 it++) {
+                doc = *it;
+                verify(!doc._id.eoo());
+                batch.push_back(doc);
+                ids.push_back(doc._id);
+                batchBytes += doc._id.size();
+            }
 
-            verify(!doc._id.eoo());
+            const NamespaceString nss(doc.ns);
+            map<BSONElement, BSONObj> found;
+            for (auto&& good : rollbackSource.findByIds(nss, ids)) {
+                found[good["_id"]] = good;
+            }
+            rollbackRefetchQueries.increment();
 
-            {
-                // TODO : slow.  lots of round trips.
+            for (auto&& refetched : batch) {
+                doc = refetched;
                 numFetched++;
-                BSONObj good = rollbackSource.findOne(NamespaceString(doc.ns), doc._id.wrap());
+
+                // note good might be eoo, indicating we should delete it
+                BSONObj good;
+                auto foundIt = found.find(doc._id);
+                if (foundIt != found.end()) {
+                    good = foundIt->second;
+                } else if (isCollatableType(doc._id.type())) {
+                    // Under the collection's collation the _id may match a document whose _id
+                    // compares differently here, so look it up by itself as before.
+                    good = rollbackSource.findOne(nss, doc._id.wrap());
+                    rollbackRefetchQueries.increment();
+                }
+                rollbackRefetchedDocs.increment();
+
                 totalSize += good.objsize();
                 uassert(13410, "replSet too much data to roll back", totalSize < 300 * 1024 * 1024);
 
-                // note good might be eoo, indicating we should delete it
                 goodVersions[doc.ns][doc] = good;
             }
+            LOG(1) << "rollback 3 refetched " << numFetched << '/' << fixUpInfo.toRefetch.size()
+                   << " documents";
         }
         newMinValid = rollbackSource.getLastOperation();
         if (newMinValid.isEmpty()) {
@@ -88,6 +88,8 @@ public:
     const OplogInterface& getOplog() const override;
     BSONObj getLastOperation() const override;
     BSONObj findOne(const NamespaceString& nss, const BSONObj& filter) const override;
+    std::vector<BSONObj> findByIds(const NamespaceString& nss,
+                                   const std::vector<BSONElement>& ids) const override;
     void copyCollectionFromRemote(OperationContext* txn, const NamespaceString& nss) const override;
     StatusWith<BSONObj> getCollectionInfo(const NamespaceString& nss) const override;
 
@@ -117,6 +119,19 @@ BSONObj RollbackSourceMock::findOne(const NamespaceString& nss, const BSONObj& f
     return BSONObj();
 }
 
+std::vector<BSONObj> RollbackSourceMock::findByIds(const NamespaceString& nss,
+                                                   const std::vector<BSONElement>& ids) const {
+    // Fetches each document through findOne(), which the tests below override.
+    std::vector<BSONObj> docs;
+    for (auto&& id : ids) {
+        BSONObj doc = findOne(nss, id.wrap());
+        if (!doc.isEmpty()) {
+            docs.push_back(doc);
+        }
+    }
+    return docs;
+}
+
 void RollbackSourceMock::copyCollectionFromRemote(OperationContext* txn,
                                                   const NamespaceString& nss) const {}
 
@@ -885,6 +900,87 @@ TEST_F(RSRollbackTest, RollbackApplyOpsCommand) {
         << result;
 }
 
+TEST_F(RSRollbackTest, RollbackRefetchesDocumentsOfANamespaceInOneQuery) {
+    createOplog(_txn.get());
+
+    {
+        AutoGetOrCreateDb autoDb(_txn.get(), "test", MODE_X);
+        mongo::WriteUnitOfWork wuow(_txn.get());
+        auto coll = autoDb.getDb()->createCollection(_txn.get(), "test.t");
+        ASSERT(coll);
+        OpDebug* const nullOpDebug = nullptr;
+        ASSERT_OK(
+            coll->insertDocument(_txn.get(), BSON("_id" << 1 << "v" << 2), nullOpDebug, false));
+        ASSERT_OK(
+            coll->insertDocument(_txn.get(), BSON("_id" << 2 << "v" << 4), nullOpDebug, false));
+        ASSERT_OK(coll->insertDocument(_txn.get(), BSON("_id" << "a"), nullOpDebug, false));
+        wuow.commit();
+    }
+    const auto commonOperation =
+        std::make_pair(BSON("ts" << Timestamp(Seconds(1), 0) << "h" << 1LL), RecordId(1));
+    auto makeOperation = [](int secs, const char* opstr, BSONObj id) {
+        return std::make_pair(BSON("ts" << Timestamp(Seconds(secs), 0) << "h" << 1LL << "op"
+                                        << opstr
+                                        << "ns"
+                                        << "test.t"
+                                        << "o2"
+                                        << id
+                                        << "o"
+                                        << id),
+                              RecordId(secs));
+    };
+
+    class RollbackSourceLocal : public RollbackSourceMock {
+    public:
+        RollbackSourceLocal(std::unique_ptr<OplogInterface> oplog)
+            : RollbackSourceMock(std::move(oplog)) {}
+
+        std::vector<BSONObj> findByIds(const NamespaceString& nss,
+                                       const std::vector<BSONElement>& ids) const override {
+            ++numQueries;
+            numIds += ids.size();
+            return {BSON("_id" << 1 << "v" << 1), BSON("_id" << 2 << "v" << 3)};
+        }
+
+        BSONObj findOne(const NamespaceString& nss, const BSONObj& filter) const override {
+            // Only the string _id which the batch didn't return is looked up again.
+            ASSERT_EQUALS(BSON("_id"
+                               << "a"),
+                          filter);
+            ++numQueries;
+            return {};
+        }
+
+        mutable int numQueries = 0;
+        mutable size_t numIds = 0;
+    } rollbackSource(std::unique_ptr<OplogInterface>(new OplogInterfaceMock({commonOperation})));
+
+    ASSERT_OK(syncRollback(_txn.get(),
+                           OplogInterfaceMock({makeOperation(4, "i", BSON("_id"
+                                                                          << "a")),
+                                               makeOperation(3, "u", BSON("_id" << 2)),
+                                               makeOperation(2, "u", BSON("_id" << 1)),
+                                               commonOperation}),
+                           rollbackSource,
+                           _coordinator,
+                           noSleep));
+    ASSERT_EQUALS(2, rollbackSource.numQueries);
+    ASSERT_EQUALS(3U, rollbackSource.numIds);
+
+    AutoGetCollectionForRead acr(_txn.get(), "test.t");
+    BSONObj result;
+    ASSERT(Helpers::findOne(_txn.get(), acr.getCollection(), BSON("_id" << 1), result));
+    ASSERT_EQUALS(1, result["v"].numberInt()) << result;
+    ASSERT(Helpers::findOne(_txn.get(), acr.getCollection(), BSON("_id" << 2), result));
+    ASSERT_EQUALS(3, result["v"].numberInt()) << result;
+    ASSERT_FALSE(Helpers::findOne(_txn.get(),
+                                  acr.getCollection(),
+                                  BSON("_id"
+                                       << "a"),
+                                  result))
+        << result;
+}
+
 TEST_F(RSRollbackTest, RollbackCreateCollectionCommand) {
     createOplog(_txn.get());
     auto commonOperation =
@@ -62,7 +62,8 @@ public:
     void shutdown();
 
     /**
-     * Forces a new snapshot to be taken even if the global timestamp hasn't changed.
+     * Forces a new snapshot to be taken even if the global timestamp hasn't changed. Unless too
+     * many snapshots are waiting to be committed, it is taken without the usual throttling.
      *
      * Does not wait for the snapshot to be taken.
      */
@@ -112,6 +112,10 @@ public:
 
 } exportedWriterThreadCountParam;
 
+// How many consecutive batches oplogApplication() may hand to the writers before it waits for all
+// of them to be applied. 1 waits after every batch.
+MONGO_EXPORT_SERVER_PARAMETER(replMaxPipelinedBatches, int, 1);
+
 
 static Counter64 opsAppliedStats;
 
@@ -145,6 +149,17 @@ bool isCrudOpType(const char* field) {
     return false;
 }
 
+/**
+ * Returns true if 'entry' has to be applied in a batch of its own: commands, index builds, and the
+ * sentinel the network queue uses to signal that it has been drained.
+ */
+bool mustApplyAlone(const OplogEntry& entry) {
+    return entry.raw.isEmpty() || entry.opType[0] == 'c' ||
+        // Index builds are achieved through the use of an insert op, not a command op.
+        // The following line is the same as what the insert code uses to detect an index build.
+        (!entry.ns.empty() && nsToCollectionSubstring(entry.ns) == "system.indexes");
+}
+
 void handleSlaveDelay(const Timestamp& ts) {
     ReplicationCoordinator* replCoord = getGlobalReplicationCoordinator();
     int slaveDelaySecs = durationCount<Seconds>(replCoord->getSlaveDelaySecs());
@@ -491,11 +506,9 @@ public:
 
 private:
     bool isCappedImpl(OperationContext* txn, StringData ns) {
-        auto db = dbHolder().get(txn, ns);
-        if (!db)
-            return false;
-
-        auto collection = db->getCollection(ns);
+        // An intent lock lets this run while writers apply an earlier batch.
+        AutoGetCollection autoColl(txn, NamespaceString(ns), MODE_IS);
+        auto collection = autoColl.getCollection();
         return collection && collection->isCapped();
     }
 
@@ -511,8 +524,6 @@ void fillWriterVectors(OperationContext* txn,
         getGlobalServiceContext()->getGlobalStorageEngine()->supportsDocLocking();
     const uint32_t numWriters = writerVectors->size();
 
-    Lock::GlobalRead globalReadLock(txn->lockState());
-
     CachingCappedChecker isCapped;
 
     for (auto&& op : *ops) {
@@ -712,20 +723,56 @@ void SyncTail::oplogApplication() {
             ? new ApplyBatchFinalizerForJournal(replCoord)
             : new ApplyBatchFinalizer(replCoord)};
 
+    // When replMaxPipelinedBatches allows it, consecutive batches are handed to 'pipeline'
+    // without waiting for each one to be applied. They only count as applied once it is drained,
+    // at which point minValid can move to 'pipelineEnd'.
+    PipelinedBatchApplier pipeline(
+        _writerPool.get(), [this](MultiApplier::OperationPtrs* ops) { _applyFunc(ops, this); });
+    OpTime pipelineEnd;
+
     auto minValidBoundaries = StorageInterface::get(&txn)->getMinValid(&txn);
     OpTime originalEndOpTime(minValidBoundaries.end);
     OpTime lastWriteOpTime{replCoord->getMyLastAppliedOpTime()};
-    while (!inShutdown()) {
-        if (replCoord->getInitialSyncRequestedFlag()) {
-            // got a resync command
-            return;
+
+    // Records that every op up to lastWriteOpTime has been applied.
+    auto finishApplying = [&](const OpTime& end) {
+        setNewTimestamp(lastWriteOpTime.getTimestamp());
+        StorageInterface::get(&txn)->setMinValid(&txn, end, DurableRequirement::None);
+        minValidBoundaries.start = {};
+        minValidBoundaries.end = end;
+        finalizer->record(lastWriteOpTime);
+
+        // Publish the end of the batch for reads which don't wait for the next one.
+        if (readFromLastAppliedSnapshotOnSecondaries.load()) {
+            replCoord->forceSnapshotCreation();
         }
+    };
+
+    while (!inShutdown()) {
+        const bool pipelining = pipeline.getNumBatches() > 0;
+        if (!pipelining) {
+            if (replCoord->getInitialSyncRequestedFlag()) {
+                // got a resync command
+                return;
+            }
 
-        tryToGoLiveAsASecondary(&txn, replCoord, minValidBoundaries, lastWriteOpTime);
+            tryToGoLiveAsASecondary(&txn, replCoord, minValidBoundaries, lastWriteOpTime);
+        }
 
         // Blocks up to a second waiting for a batch to be ready to apply. If one doesn't become
-        // ready in time, we'll loop again so we can do the above checks periodically.
-        OpQueue ops = batcher.getNextBatch(Seconds(1));
+        // ready in time, we'll loop again so we can do the above checks periodically. Readers are
+        // locked out while batches are in the pipeline, so in that case don't wait at all.
+        OpQueue ops = batcher.getNextBatch(pipelining ? Seconds(0) : Seconds(1));
+
+        const size_t maxPipelinedBatches = std::max(replMaxPipelinedBatches.load(), 1);
+        const bool canPipeline = maxPipelinedBatches > 1 && !ops.empty() &&
+            !mustApplyAlone(ops.back()) && replCoord->getSlaveDelaySecs() == Seconds(0) &&
+            !getGlobalServiceContext()->getGlobalStorageEngine()->isMmapV1();
+        if (pipelining && (!canPipeline || pipeline.getNumBatches() >= maxPipelinedBatches)) {
+            pipeline.drain();
+            finishApplying(pipelineEnd);
+        }
+
         if (ops.empty())
             continue;  // Try again.
 
@@ -787,7 +834,15 @@ void SyncTail::oplogApplication() {
         StorageInterface::get(&txn)->setMinValid(&txn, {start, end});
 
         const size_t opsInBatch = ops.getCount();
-        lastWriteOpTime = multiApply(&txn, ops.releaseBatch());
+        if (canPipeline) {
+            auto lastOpTimeWritten = pipeline.apply(&txn, ops.releaseBatch());
+            if (lastOpTimeWritten != ErrorCodes::InterruptedAtShutdown) {
+                fassertStatusOK(40202, lastOpTimeWritten.getStatus());
+            }
+            lastWriteOpTime = lastOpTimeWritten.isOK() ? lastOpTimeWritten.getValue() : OpTime();
+        } else {
+            lastWriteOpTime = multiApply(&txn, ops.releaseBatch());
+        }
         if (lastWriteOpTime.isNull()) {
             // fassert if oplog application failed for any reasons other than shutdown.
             error() << "Failed to apply " << opsInBatch << " operations - batch start:" << start
@@ -797,11 +852,11 @@ void SyncTail::oplogApplication() {
             return;
         }
 
-        setNewTimestamp(lastWriteOpTime.getTimestamp());
-        StorageInterface::get(&txn)->setMinValid(&txn, end, DurableRequirement::None);
-        minValidBoundaries.start = {};
-        minValidBoundaries.end = end;
-        finalizer->record(lastWriteOpTime);
+        if (canPipeline) {
+            pipelineEnd = end;
+        } else {
+            finishApplying(end);
+        }
     }
 }
 
@@ -834,11 +889,7 @@ bool SyncTail::tryPopAndWaitForMore(OperationContext* txn, SyncTail::OpQueue* op
     auto& entry = ops->back();
 
     // Check for ops that must be processed one at a time.
-    if (entry.raw.isEmpty() ||       // sentinel that network queue is drained.
-        (entry.opType[0] == 'c') ||  // commands.
-        // Index builds are achieved through the use of an insert op, not a command op.
-        // The following line is the same as what the insert code uses to detect an index build.
-        (!entry.ns.empty() && nsToCollectionSubstring(entry.ns) == "system.indexes")) {
+    if (mustApplyAlone(entry)) {
         if (ops->getCount() == 1) {
             // apply commands one-at-a-time
             _networkQueue->consume(txn);
@@ -1022,6 +1073,9 @@ Status multiSyncApply_noAbort(OperationContext* txn,
     // allow us to get through the magic barrier
     txn->lockState()->setIsBatchWriter(true);
 
+    // Oplog application must keep up however many user operations are queued for tickets.
+    txn->lockState()->setShouldAcquireTicket(false);
+
     if (oplogEntryPointers->size() > 1) {
         std::stable_sort(oplogEntryPointers->begin(),
                          oplogEntryPointers->end(),
@@ -1142,6 +1196,9 @@ Status multiInitialSyncApply_noAbort(OperationContext* txn,
     // allow us to get through the magic barrier
     txn->lockState()->setIsBatchWriter(true);
 
+    // Oplog application must keep up however many user operations are queued for tickets.
+    txn->lockState()->setShouldAcquireTicket(false);
+
     bool convertUpdatesToUpserts = false;
 
     for (auto it = ops->begin(); it != ops->end(); ++it) {
@@ -1242,5 +1299,110 @@ StatusWith<OpTime> multiApply(OperationContext* txn,
     return ops.back().getOpTime();
 }
 
+PipelinedBatchApplier::PipelinedBatchApplier(OldThreadPool* writerPool,
+                                             MultiApplier::ApplyOperationFn applyOperation)
+    : _writerPool(writerPool),
+      _applyOperation(std::move(applyOperation)),
+      _writerQueues(writerPool->getNumThreads()) {}
+
+PipelinedBatchApplier::~PipelinedBatchApplier() {
+    drain();
+}
+
+StatusWith<OpTime> PipelinedBatchApplier::apply(OperationContext* txn,
+                                                MultiApplier::Operations ops) {
+    if (ops.empty()) {
+        return {ErrorCodes::EmptyArrayOperation, "no operations provided to apply"};
+    }
+
+    // Partitioning only takes intent locks, so the writers keep working on earlier batches
+    // meanwhile.
+    std::vector<MultiApplier::OperationPtrs> writerVectors(_writerQueues.size());
+    fillWriterVectors(txn, &ops, &writerVectors);
+    LOG(2) << "replication batch size is " << ops.size();
+
+    if (!_pbwm) {
+        _fsyncLock = stdx::unique_lock<SimpleMutex>(filesLockedFsync);
+        _pbwm = stdx::make_unique<Lock::ParallelBatchWriterMode>(txn->lockState());
+    }
+
+    auto replCoord = ReplicationCoordinator::get(txn);
+    if (replCoord->getMemberState().primary() && !replCoord->isWaitingForApplierToDrain()) {
+        severe() << "attempting to replicate ops while primary";
+        return {ErrorCodes::CannotApplyOplogWhilePrimary,
+                "attempting to replicate ops while primary"};
+    }
+
+    // The writers keep pointers into the batch, which moving it into _batches does not invalidate.
+    _batches.push_back(std::move(ops));
+    const auto& batch = _batches.back();
+
+    {
+        TimerHolder timer(&applyBatchStats);
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (size_t writer = 0; writer < writerVectors.size(); ++writer) {
+            if (writerVectors[writer].empty()) {
+                continue;
+            }
+
+            auto& queue = _writerQueues[writer];
+            queue.pending.push_back(std::move(writerVectors[writer]));
+            ++_numPendingShares;
+            if (!queue.scheduled) {
+                queue.scheduled = true;
+                _writerPool->schedule([this, writer] { _runWriter(writer); });
+            }
+        }
+    }
+
+    std::vector<BSONObj> docs(batch.size());
+    auto toBSON = [](const OplogEntry& entry) { return entry.raw; };
+    std::transform(batch.begin(), batch.end(), docs.begin(), toBSON);
+
+    fassertStatusOK(40201,
+                    StorageInterface::get(txn)->insertDocuments(
+                        txn, NamespaceString(rsOplogName), docs));
+
+    if (inShutdownStrict()) {
+        log() << "Cannot apply operations due to shutdown in progress";
+        return {ErrorCodes::InterruptedAtShutdown,
+                "Cannot apply operations due to shutdown in progress"};
+    }
+    return batch.back().getOpTime();
+}
+
+void PipelinedBatchApplier::drain() {
+    {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        while (_numPendingShares > 0) {
+            _allApplied.wait(lk);
+        }
+    }
+
+    _batches.clear();
+    _pbwm.reset();
+    if (_fsyncLock.owns_lock()) {
+        _fsyncLock.unlock();
+    }
+}
+
+void PipelinedBatchApplier::_runWriter(size_t writer) {
+    auto& queue = _writerQueues[writer];
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (!queue.pending.empty()) {
+        MultiApplier::OperationPtrs ops = std::move(queue.pending.front());
+        queue.pending.pop_front();
+
+        lk.unlock();
+        _applyOperation(&ops);
+        lk.lock();
+
+        if (--_numPendingShares == 0) {
+            _allApplied.notify_all();
+        }
+    }
+    queue.scheduled = false;
+}
+
 }  // namespace repl
 }  // namespace mongo
@@ -30,13 +30,19 @@
 
 #include <deque>
 #include <memory>
+#include <vector>
 
+#include "mongo/base/disallow_copying.h"
 #include "mongo/base/status.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/repl/multiapplier.h"
 #include "mongo/db/repl/oplog_entry.h"
 #include "mongo/db/storage/mmap_v1/dur.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/concurrency/old_thread_pool.h"
 
 namespace mongo {
@@ -214,6 +220,81 @@ StatusWith<OpTime> multiApply(OperationContext* txn,
                               MultiApplier::Operations ops,
                               MultiApplier::ApplyOperationFn applyOperation);
 
+/**
+ * Applies consecutive batches of oplog entries without a barrier between them.
+ *
+ * Each batch is split between the writers exactly as multiApply() does it, but a writer moves on
+ * to its share of the next batch as soon as it has applied its share of the previous one, rather
+ * than waiting for the slowest writer to finish. A writer applies its shares in the order they
+ * were handed out, so ops on the same document are still applied in oplog order.
+ *
+ * Readers are locked out from the first batch handed out until drain() returns, so they never
+ * see a partially applied batch. Batches that must be applied alone, such as commands, must not
+ * be handed to this class.
+ */
+class PipelinedBatchApplier {
+    MONGO_DISALLOW_COPYING(PipelinedBatchApplier);
+
+public:
+    PipelinedBatchApplier(OldThreadPool* writerPool, MultiApplier::ApplyOperationFn applyOperation);
+
+    /**
+     * Waits for every batch handed out to be applied. The OperationContext passed to apply() must
+     * outlive this object.
+     */
+    ~PipelinedBatchApplier();
+
+    /**
+     * Hands 'ops' out to the writers and writes them to the local oplog, without waiting for the
+     * writers to apply them or any earlier batch.
+     *
+     * Returns the OpTime of the last operation in 'ops', or the same errors as multiApply().
+     */
+    StatusWith<OpTime> apply(OperationContext* txn, MultiApplier::Operations ops);
+
+    /**
+     * Waits for the writers to apply every batch handed out since the last call, then lets
+     * readers back in.
+     */
+    void drain();
+
+    /**
+     * Returns the number of batches handed out since the last call to drain().
+     */
+    size_t getNumBatches() const {
+        return _batches.size();
+    }
+
+private:
+    struct WriterQueue {
+        // Shares of batches waiting for this writer, oldest first.
+        std::deque<MultiApplier::OperationPtrs> pending;
+
+        // Whether a task that works through 'pending' is scheduled on the writer pool.
+        bool scheduled = false;
+    };
+
+    /**
+     * Runs on the writer pool, applying the shares queued for 'writer' until there are none left.
+     */
+    void _runWriter(size_t writer);
+
+    OldThreadPool* const _writerPool;
+    const MultiApplier::ApplyOperationFn _applyOperation;
+
+    // The batches handed out since the last drain(). The writers hold pointers into them.
+    std::deque<MultiApplier::Operations> _batches;
+
+    // Held from the first batch handed out until drain(), like multiApply() holds them for one.
+    stdx::unique_lock<SimpleMutex> _fsyncLock;
+    std::unique_ptr<Lock::ParallelBatchWriterMode> _pbwm;
+
+    stdx::mutex _mutex;  // Guards the members below.
+    stdx::condition_variable _allApplied;
+    std::vector<WriterQueue> _writerQueues;
+    size_t _numPendingShares = 0;
+};
+
 // These free functions are used by the thread pool workers to write ops to the db.
 // They consume the passed in OperationPtrs and callers should not make any assumptions about the
 // state of the container after calling. However, these functions cannot modify the pointed-to
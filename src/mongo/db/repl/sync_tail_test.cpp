@@ -53,6 +53,7 @@
 #include "mongo/db/repl/sync_tail.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_d_test_fixture.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/concurrency/old_thread_pool.h"
@@ -602,6 +603,81 @@ TEST_F(SyncTailTest, MultiApplyAssignsOperationsToWriterThreadsBasedOnNamespaceH
     ASSERT_EQUALS(op2.raw, operationsWrittenToOplog[1]);
 }
 
+TEST_F(SyncTailTest, PipelinedBatchApplierDoesNotWaitForSlowWriterBeforeApplyingNextBatch) {
+    NamespaceString nss1("test.t0");
+    NamespaceString nss2("test.t1");
+    OldThreadPool writerPool(2);
+
+    // Ensure that namespaces are hashed to different threads in pool.
+    ASSERT_EQUALS(0U, StringMapTraits::hash(nss1.ns()) % writerPool.getNumThreads());
+    ASSERT_EQUALS(1U, StringMapTraits::hash(nss2.ns()) % writerPool.getNumThreads());
+
+    auto op1 = makeInsertDocumentOplogEntry({Timestamp(Seconds(1), 0), 1LL}, nss1, BSON("x" << 1));
+    auto op2 = makeInsertDocumentOplogEntry({Timestamp(Seconds(2), 0), 1LL}, nss2, BSON("x" << 2));
+    auto op3 = makeInsertDocumentOplogEntry({Timestamp(Seconds(3), 0), 1LL}, nss2, BSON("x" << 3));
+    auto op4 = makeInsertDocumentOplogEntry({Timestamp(Seconds(4), 0), 1LL}, nss1, BSON("x" << 4));
+
+    // The writer for 'nss1' is held up applying 'op1' until the test lets it go.
+    stdx::mutex mutex;
+    stdx::condition_variable condition;
+    bool slowWriterReleased = false;
+    std::vector<OpTime> operationsApplied;
+    auto applyOperationFn = [&](MultiApplier::OperationPtrs* operationsForWriterThreadToApply) {
+        stdx::unique_lock<stdx::mutex> lock(mutex);
+        for (auto&& opPtr : *operationsForWriterThreadToApply) {
+            if (*opPtr == op1) {
+                condition.wait(lock, [&] { return slowWriterReleased; });
+            }
+            operationsApplied.push_back(opPtr->getOpTime());
+            condition.notify_all();
+        }
+    };
+
+    std::vector<BSONObj> operationsWrittenToOplog;
+    _storageInterface->insertDocumentsFn = [&](
+        OperationContext* txn, const NamespaceString& nss, const std::vector<BSONObj>& docs) {
+        stdx::lock_guard<stdx::mutex> lock(mutex);
+        operationsWrittenToOplog.insert(operationsWrittenToOplog.end(), docs.begin(), docs.end());
+        return Status::OK();
+    };
+
+    auto isApplied = [&](const OplogEntry& op) {
+        return std::find(operationsApplied.cbegin(), operationsApplied.cend(), op.getOpTime()) !=
+            operationsApplied.cend();
+    };
+
+    PipelinedBatchApplier pipeline(&writerPool, applyOperationFn);
+    ASSERT_EQUALS(op2.getOpTime(), unittest::assertGet(pipeline.apply(_txn.get(), {op1, op2})));
+    ASSERT_EQUALS(op4.getOpTime(), unittest::assertGet(pipeline.apply(_txn.get(), {op3, op4})));
+    ASSERT_EQUALS(2U, pipeline.getNumBatches());
+
+    {
+        // The other writer gets on with the second batch while the first is still being applied.
+        stdx::unique_lock<stdx::mutex> lock(mutex);
+        condition.wait(lock, [&] { return isApplied(op3); });
+        ASSERT_FALSE(isApplied(op1));
+        ASSERT_FALSE(isApplied(op4));
+        ASSERT_EQUALS(4U, operationsWrittenToOplog.size());
+
+        slowWriterReleased = true;
+        condition.notify_all();
+    }
+
+    pipeline.drain();
+    ASSERT_EQUALS(0U, pipeline.getNumBatches());
+
+    // Each writer applies its operations in oplog order.
+    stdx::lock_guard<stdx::mutex> lock(mutex);
+    ASSERT_EQUALS(4U, operationsApplied.size());
+    auto positionOf = [&](const OplogEntry& op) {
+        return std::find(operationsApplied.cbegin(), operationsApplied.cend(), op.getOpTime());
+    };
+    ASSERT_TRUE(positionOf(op1) < positionOf(op4));
+    ASSERT_TRUE(positionOf(op2) < positionOf(op3));
+    ASSERT_EQUALS(op1.raw, operationsWrittenToOplog[0]);
+    ASSERT_EQUALS(op4.raw, operationsWrittenToOplog[3]);
+}
+
 TEST_F(SyncTailTest, MultiSyncApplyUsesSyncApplyToApplyOperation) {
     NamespaceString nss("local." + _agent.getSuiteName() + "_" + _agent.getTestName());
     ASSERT_TRUE(_txn->writesAreReplicated());
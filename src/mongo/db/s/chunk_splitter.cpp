@@ -0,0 +1,296 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kSharding
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/chunk_splitter.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/s/collection_metadata.h"
+#include "mongo/db/s/collection_sharding_state.h"
+#include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/s/balancer/balancer_configuration.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/s/grid.h"
+#include "mongo/s/shard_key_pattern.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+namespace {
+
+// Number of documents sampled from the collection to pick the split points of one chunk.
+MONGO_EXPORT_SERVER_PARAMETER(shardAutoSplitSampleSize, int, 1000);
+
+const auto getChunkSplitter = ServiceContext::declareDecoration<ChunkSplitter>();
+
+// A chunk is checked each time it receives this fraction of the maximum chunk size in writes, as
+// mongos does.
+const long long kSplitTestFactor = 5;
+
+// Chunks with fewer sampled documents than this are split at the points found by splitVector.
+const size_t kMinSampledKeysInChunk = 10;
+
+}  // namespace
+
+ChunkSplitter::ChunkSplitter() = default;
+
+ChunkSplitter::~ChunkSplitter() {
+    if (_threadPool) {
+        _threadPool->shutdown();
+        _threadPool->join();
+    }
+}
+
+ChunkSplitter* ChunkSplitter::get(ServiceContext* service) {
+    return &getChunkSplitter(service);
+}
+
+long long ChunkSplitter::getSplitThresholdBytes(OperationContext* txn) {
+    auto balancerConfig = Grid::get(txn)->getBalancerConfiguration();
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_settingsRefreshScheduled) {
+            _settingsRefreshScheduled = true;
+            _pending.insert(std::string());
+            Status status = _schedule_inlock([this, balancerConfig] {
+                const ServiceContext::UniqueOperationContext txnPtr = cc().makeOperationContext();
+                Status refreshStatus = balancerConfig->refreshAndCheck(txnPtr.get());
+                if (!refreshStatus.isOK()) {
+                    warning() << "Unable to refresh the chunk size settings for autosplit"
+                              << causedBy(refreshStatus);
+                }
+                _finish(std::string());
+            });
+            if (!status.isOK()) {
+                _pending.erase(std::string());
+            }
+        }
+    }
+
+    return static_cast<long long>(balancerConfig->getMaxChunkSizeBytes()) / kSplitTestFactor;
+}
+
+void ChunkSplitter::trySplitting(const NamespaceString& nss,
+                                 const BSONObj& min,
+                                 const BSONObj& max) {
+    const std::string pendingKey = nss.ns() + '\0' + min.toString();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_pending.insert(pendingKey).second) {
+        return;
+    }
+
+    BSONObj ownedMin = min.getOwned();
+    BSONObj ownedMax = max.getOwned();
+    Status status = _schedule_inlock([this, nss, ownedMin, ownedMax, pendingKey] {
+        try {
+            _split(nss, ownedMin, ownedMax);
+        } catch (const DBException& ex) {
+            LOG(1) << "Autosplit of chunk [" << ownedMin << ", " << ownedMax << ") in "
+                   << nss.ns() << " failed: " << ex.toStatus();
+        }
+        _finish(pendingKey);
+    });
+    if (!status.isOK()) {
+        _pending.erase(pendingKey);
+    }
+}
+
+void ChunkSplitter::waitForIdle() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _idleCondition.wait(lk, [this] { return _pending.empty(); });
+}
+
+Status ChunkSplitter::_schedule_inlock(stdx::function<void()> task) {
+    if (!_threadPool) {
+        ThreadPool::Options options;
+        options.poolName = "ChunkSplitter";
+        options.minThreads = 0;
+        options.maxThreads = 1;
+        options.onCreateThread = [](const std::string& threadName) {
+            Client::initThread(threadName.c_str());
+            AuthorizationSession::get(cc())->grantInternalAuthorization();
+        };
+        _threadPool = stdx::make_unique<ThreadPool>(options);
+        _threadPool->startup();
+    }
+
+    return _threadPool->schedule(std::move(task));
+}
+
+void ChunkSplitter::_finish(const std::string& pendingKey) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _pending.erase(pendingKey);
+    if (_pending.empty()) {
+        _idleCondition.notify_all();
+    }
+}
+
+void ChunkSplitter::_split(const NamespaceString& nss, const BSONObj& min, const BSONObj& max) {
+    const ServiceContext::UniqueOperationContext txnPtr = cc().makeOperationContext();
+    OperationContext* txn = txnPtr.get();
+
+    auto balancerConfig = Grid::get(txn)->getBalancerConfiguration();
+    uassertStatusOK(balancerConfig->refreshAndCheck(txn));
+    const uint64_t maxChunkSizeBytes = balancerConfig->getMaxChunkSizeBytes();
+
+    BSONObj keyPattern;
+    OID epoch;
+    std::vector<BSONObj> sampledKeys;
+    size_t numSampled = 0;
+    uint64_t estimatedChunkBytes = 0;
+    {
+        AutoGetCollection autoColl(txn, nss, MODE_IS);
+        Collection* const collection = autoColl.getCollection();
+        if (!collection) {
+            return;
+        }
+
+        // The chunk may have been split or migrated since it was scheduled.
+        auto metadata = CollectionShardingState::get(txn, nss)->getMetadata();
+        ChunkType chunk;
+        if (!metadata || !metadata->getNextChunk(min, &chunk) || chunk.getMin().woCompare(min) ||
+            chunk.getMax().woCompare(max)) {
+            return;
+        }
+
+        keyPattern = metadata->getKeyPattern().getOwned();
+        epoch = metadata->getCollVersion().epoch();
+
+        auto cursor = collection->getRecordStore()->getRandomCursor(txn);
+        if (cursor) {
+            const ShardKeyPattern shardKeyPattern(keyPattern);
+            const int sampleSize = shardAutoSplitSampleSize.load();
+            for (; numSampled < static_cast<size_t>(std::max(sampleSize, 0)); ++numSampled) {
+                auto record = cursor->next();
+                if (!record) {
+                    break;
+                }
+
+                BSONObj key = shardKeyPattern.extractShardKeyFromDoc(record->data.toBson());
+                if (!key.isEmpty() && key.woCompare(min) >= 0 && key.woCompare(max) < 0) {
+                    sampledKeys.push_back(key.getOwned());
+                }
+            }
+
+            if (numSampled) {
+                estimatedChunkBytes = static_cast<uint64_t>(
+                    static_cast<double>(collection->dataSize(txn)) * sampledKeys.size() /
+                    numSampled);
+            }
+        }
+    }
+
+    BSONArrayBuilder splitKeys;
+    if (sampledKeys.size() >= kMinSampledKeysInChunk) {
+        if (estimatedChunkBytes < maxChunkSizeBytes) {
+            return;
+        }
+
+        // Cut the chunk into pieces of half the maximum chunk size, as splitVector does, at the
+        // quantiles of its sampled keys.
+        std::sort(sampledKeys.begin(), sampledKeys.end(), [](const BSONObj& a, const BSONObj& b) {
+            return a.woCompare(b) < 0;
+        });
+
+        const size_t numPieces = std::min(
+            sampledKeys.size(), static_cast<size_t>(estimatedChunkBytes / (maxChunkSizeBytes / 2)));
+        BSONObj lastSplitKey = min;
+        for (size_t i = 1; i < numPieces; ++i) {
+            const BSONObj& splitKey = sampledKeys[i * sampledKeys.size() / numPieces];
+            if (splitKey.woCompare(lastSplitKey) == 0) {
+                continue;
+            }
+
+            splitKeys.append(splitKey);
+            lastSplitKey = splitKey;
+        }
+    } else {
+        DBDirectClient client(txn);
+        BSONObj splitVectorResult;
+        if (!client.runCommand("admin",
+                               BSON("splitVector" << nss.ns() << "keyPattern" << keyPattern << "min"
+                                                  << min
+                                                  << "max"
+                                                  << max
+                                                  << "maxChunkSizeBytes"
+                                                  << static_cast<long long>(maxChunkSizeBytes)),
+                               splitVectorResult)) {
+            uassertStatusOK(getStatusFromCommandResult(splitVectorResult));
+        }
+
+        for (const BSONElement& splitKey : splitVectorResult["splitKeys"].Obj()) {
+            splitKeys.append(splitKey.Obj());
+        }
+    }
+
+    if (splitKeys.arrSize() == 0) {
+        return;
+    }
+
+    const BSONArray splitKeysArray = splitKeys.arr();
+
+    DBDirectClient client(txn);
+    BSONObj splitChunkResult;
+    if (!client.runCommand("admin",
+                           BSON("splitChunk" << nss.ns() << "keyPattern" << keyPattern << "min"
+                                             << min
+                                             << "max"
+                                             << max
+                                             << "from"
+                                             << ShardingState::get(txn)->getShardName()
+                                             << "splitKeys"
+                                             << splitKeysArray
+                                             << "epoch"
+                                             << epoch),
+                           splitChunkResult)) {
+        uassertStatusOK(getStatusFromCommandResult(splitChunkResult));
+    }
+
+    log() << "autosplit chunk [" << min << ", " << max << ") in " << nss.ns() << " at "
+          << splitKeysArray;
+}
+
+}  // namespace mongo
@@ -0,0 +1,118 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <set>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+class OperationContext;
+class Status;
+class ServiceContext;
+class ThreadPool;
+
+/**
+ * Splits chunks on behalf of the shard which owns them, on a background thread. The collection
+ * sharding state counts the bytes written to each of the shard's chunks and schedules a split of
+ * any chunk which has received a fifth of the maximum chunk size since it was last checked.
+ *
+ * Split points are picked from a random sample of the collection's documents, which estimates the
+ * size of the chunk and the distribution of its keys without scanning its index. Chunks which are
+ * too small a fraction of the collection to be represented in the sample fall back to the
+ * splitVector command.
+ *
+ * Used when the shardAutoSplit server parameter is set, in which case mongos should be started
+ * with --noAutoSplit.
+ */
+class ChunkSplitter {
+    MONGO_DISALLOW_COPYING(ChunkSplitter);
+
+public:
+    ChunkSplitter();
+    ~ChunkSplitter();
+
+    static ChunkSplitter* get(ServiceContext* service);
+
+    /**
+     * Returns the number of bytes which may be written to a chunk before it should be checked for
+     * splitting. Schedules a refresh of the chunk size settings the first time it is called.
+     */
+    long long getSplitThresholdBytes(OperationContext* txn);
+
+    /**
+     * Schedules the chunk [min, max) of 'nss' to be split if it has grown past the maximum chunk
+     * size. Does nothing if that chunk is already scheduled.
+     */
+    void trySplitting(const NamespaceString& nss, const BSONObj& min, const BSONObj& max);
+
+    /**
+     * Blocks until all scheduled chunks have been processed. Used for testing.
+     */
+    void waitForIdle();
+
+private:
+    /**
+     * Schedules 'task' on the splitter thread, starting it on first use. Must be called with
+     * '_mutex' held.
+     */
+    Status _schedule_inlock(stdx::function<void()> task);
+
+    /**
+     * Picks the split points of the chunk [min, max) and splits it. Runs on the splitter thread.
+     */
+    void _split(const NamespaceString& nss, const BSONObj& min, const BSONObj& max);
+
+    void _finish(const std::string& pendingKey);
+
+    stdx::mutex _mutex;
+
+    // Signalled whenever '_pending' becomes empty.
+    stdx::condition_variable _idleCondition;
+
+    // Namespace and min key of every chunk which is scheduled or being split, and the empty
+    // string while the chunk size settings are being refreshed.
+    std::set<std::string> _pending;
+
+    // Whether the chunk size settings have been scheduled to be read from the config servers.
+    bool _settingsRefreshScheduled{false};
+
+    // Created when the first task is scheduled.
+    std::unique_ptr<ThreadPool> _threadPool;
+};
+
+}  // namespace mongo
@@ -32,6 +32,8 @@
 
 #include "mongo/db/s/collection_metadata.h"
 
+#include <algorithm>
+
 #include "mongo/bson/util/builder.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/stdx/memory.h"
@@ -46,6 +48,19 @@ using std::string;
 using std::vector;
 using str::stream;
 
+namespace {
+
+// Shard key ranges compare keys with BSONObj::woCompare(), which KeyStrings of an ascending
+// ordering match.
+const Ordering kAllAscending = Ordering::make(BSONObj());
+
+std::string toKeyString(const BSONObj& key) {
+    KeyString ks(KeyString::Version::V1, key, kAllAscending);
+    return std::string(ks.getBuffer(), ks.getSize());
+}
+
+}  // namespace
+
 CollectionMetadata::CollectionMetadata() = default;
 
 CollectionMetadata::~CollectionMetadata() = default;
@@ -106,6 +121,7 @@ std::unique_ptr<CollectionMetadata> CollectionMetadata::cloneMinusPending(
 
     metadata->_chunksMap = _chunksMap;
     metadata->_rangesMap = _rangesMap;
+    metadata->_rangeBounds = _rangeBounds;
     metadata->_shardVersion = _shardVersion;
     metadata->_collVersion = _collVersion;
 
@@ -123,6 +139,7 @@ std::unique_ptr<CollectionMetadata> CollectionMetadata::clonePlusPending(
     metadata->_pendingMap = _pendingMap;
     metadata->_chunksMap = _chunksMap;
     metadata->_rangesMap = _rangesMap;
+    metadata->_rangeBounds = _rangeBounds;
     metadata->_shardVersion = _shardVersion;
     metadata->_collVersion = _collVersion;
 
@@ -282,6 +299,7 @@ StatusWith<std::unique_ptr<CollectionMetadata>> CollectionMetadata::cloneMerge(
     metadata->_pendingMap = _pendingMap;
     metadata->_chunksMap = _chunksMap;
     metadata->_rangesMap = _rangesMap;
+    metadata->_rangeBounds = _rangeBounds;
     metadata->_shardVersion = newShardVersion;
     metadata->_collVersion = newShardVersion > _collVersion ? newShardVersion : this->_collVersion;
 
@@ -302,30 +320,54 @@ bool CollectionMetadata::keyBelongsToMe(const BSONObj& key) const {
         return true;
     }
 
-    if (_rangesMap.size() <= 0) {
+    if (_rangeBounds.empty()) {
         return false;
     }
 
-    RangeMap::const_iterator it = _rangesMap.upper_bound(key);
-    if (it != _rangesMap.begin())
-        it--;
+    KeyString ks(KeyString::Version::V1, key, kAllAscending);
+    return findRangeBound(StringData(ks.getBuffer(), ks.getSize())) % 2 == 1;
+}
 
-    bool good = rangeContains(it->first, it->second, key);
+size_t CollectionMetadata::findRangeBound(StringData key) const {
+    auto it = std::upper_bound(
+        _rangeBounds.begin(), _rangeBounds.end(), key, [](StringData lhs, const std::string& rhs) {
+            return lhs < StringData(rhs);
+        });
+    return it - _rangeBounds.begin();
+}
 
-#if 0
-        // DISABLED because of SERVER-11175 - huge amount of logging
-        // Logs if the point doesn't belong here.
-        if ( !good ) {
-            log() << "bad: " << key << " " << it->first << " " << key.woCompare( it->first ) << " "
-                  << key.woCompare( it->second );
+CollectionMetadata::KeyFilter::KeyFilter(const CollectionMetadata* metadata)
+    : _metadata(metadata), _keyString(KeyString::Version::V1) {}
 
-            for ( RangeMap::const_iterator i = _rangesMap.begin(); i != _rangesMap.end(); ++i ) {
-                log() << "\t" << i->first << "\t" << i->second << "\t";
-            }
-        }
-#endif
+bool CollectionMetadata::KeyFilter::keyBelongsToMe(const BSONObj& key) {
+    if (_metadata->_keyPattern.isEmpty()) {
+        return true;
+    }
+
+    const auto& bounds = _metadata->_rangeBounds;
+    if (bounds.empty()) {
+        return false;
+    }
 
-    return good;
+    _keyString.resetToKey(key, kAllAscending);
+    const StringData ks(_keyString.getBuffer(), _keyString.getSize());
+
+    // Whether 'position' bounds are at or below the key.
+    auto isPositionOf = [&](size_t position) {
+        return (position == 0 || StringData(bounds[position - 1]) <= ks) &&
+            (position == bounds.size() || ks < StringData(bounds[position]));
+    };
+
+    if (!isPositionOf(_lastPosition)) {
+        if (_lastPosition < bounds.size() && isPositionOf(_lastPosition + 1)) {
+            ++_lastPosition;
+        } else if (_lastPosition > 0 && isPositionOf(_lastPosition - 1)) {
+            --_lastPosition;
+        } else {
+            _lastPosition = _metadata->findRangeBound(ks);
+        }
+    }
+    return _lastPosition % 2 == 1;
 }
 
 bool CollectionMetadata::keyIsPending(const BSONObj& key) const {
@@ -608,6 +650,13 @@ void CollectionMetadata::fillRanges() {
     dassert(!min.isEmpty());
 
     _rangesMap.insert(make_pair(min, max));
+
+    _rangeBounds.clear();
+    _rangeBounds.reserve(_rangesMap.size() * 2);
+    for (const auto& range : _rangesMap) {
+        _rangeBounds.push_back(toKeyString(range.first));
+        _rangeBounds.push_back(toKeyString(range.second));
+    }
 }
 
 void CollectionMetadata::fillKeyPatternFields() {
@@ -33,6 +33,7 @@
 #include "mongo/db/field_ref_set.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/range_arithmetic.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/s/chunk_version.h"
 
 namespace mongo {
@@ -130,6 +131,28 @@ public:
      */
     bool keyBelongsToMe(const BSONObj& key) const;
 
+    /**
+     * Answers keyBelongsToMe() for a stream of keys, remembering which of the metadata's ranges
+     * the last key fell in. Keys which arrive in shard key order, such as those of a scan over a
+     * shard key index, are then checked against that range or the next one instead of being
+     * searched for among all of them.
+     *
+     * The metadata must outlive the filter.
+     */
+    class KeyFilter {
+    public:
+        explicit KeyFilter(const CollectionMetadata* metadata);
+
+        bool keyBelongsToMe(const BSONObj& key);
+
+    private:
+        const CollectionMetadata* const _metadata;
+        KeyString _keyString;
+
+        // The position of the last key among the metadata's _rangeBounds.
+        size_t _lastPosition = 0;
+    };
+
     /**
      * Returns true if the document key 'key' is or has been migrated to this shard, and may
      * belong to us after a subsequent config reload.  Key must be the full shard key.
@@ -268,6 +291,11 @@ private:
     // installations.
     RangeMap _rangesMap;
 
+    // The bounds of the ranges in _rangesMap as KeyStrings, in order: the min key of the first
+    // range, its max key, the min key of the second range and so on. Searching these is cheaper
+    // than comparing BSON. A key belongs to a range if an odd number of bounds are at or below it.
+    std::vector<std::string> _rangeBounds;
+
     /**
      * Returns true if this metadata was loaded with all necessary information.
      */
@@ -278,6 +306,11 @@ private:
      */
     void fillRanges();
 
+    /**
+     * Returns the number of _rangeBounds at or below the KeyString 'key'.
+     */
+    size_t findRangeBound(StringData key) const;
+
     /**
      * Creates the _keyField* local data
      */
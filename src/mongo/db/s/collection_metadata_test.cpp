@@ -926,6 +926,41 @@ TEST_F(ThreeChunkWithRangeGapFixture, ShardDoesntOwnDoc) {
     ASSERT_FALSE(getCollMetadata().keyBelongsToMe(BSON("a" << MAXKEY)));
 }
 
+TEST_F(ThreeChunkWithRangeGapFixture, KeyFilterInOrder) {
+    std::vector<BSONObj> keys;
+    keys.push_back(BSON("a" << MINKEY));
+    for (int i = -5; i < 45; i++) {
+        keys.push_back(BSON("a" << i));
+        keys.push_back(BSON("a" << i + 0.5));
+    }
+    keys.push_back(BSON("a" << 19.99));
+    keys.push_back(BSON("a" << 29.99));
+    keys.push_back(BSON("a"
+                        << "string"));
+    keys.push_back(BSON("a" << MAXKEY));
+
+    CollectionMetadata::KeyFilter ascending(&getCollMetadata());
+    for (const auto& key : keys) {
+        ASSERT_EQUALS(getCollMetadata().keyBelongsToMe(key), ascending.keyBelongsToMe(key));
+    }
+
+    CollectionMetadata::KeyFilter descending(&getCollMetadata());
+    for (auto it = keys.rbegin(); it != keys.rend(); ++it) {
+        ASSERT_EQUALS(getCollMetadata().keyBelongsToMe(*it), descending.keyBelongsToMe(*it));
+    }
+}
+
+TEST_F(ThreeChunkWithRangeGapFixture, KeyFilterOutOfOrder) {
+    CollectionMetadata::KeyFilter filter(&getCollMetadata());
+    ASSERT(filter.keyBelongsToMe(BSON("a" << 40)));
+    ASSERT(filter.keyBelongsToMe(BSON("a" << MINKEY)));
+    ASSERT_FALSE(filter.keyBelongsToMe(BSON("a" << MAXKEY)));
+    ASSERT_FALSE(filter.keyBelongsToMe(BSON("a" << 25)));
+    ASSERT(filter.keyBelongsToMe(BSON("a" << 10LL)));
+    ASSERT_FALSE(filter.keyBelongsToMe(BSON("a" << 20.0)));
+    ASSERT(filter.keyBelongsToMe(BSON("a" << 30)));
+}
+
 TEST_F(ThreeChunkWithRangeGapFixture, GetNextFromEmpty) {
     ChunkType nextChunk;
     ASSERT(getCollMetadata().getNextChunk(getCollMetadata().getMinKey(), &nextChunk));
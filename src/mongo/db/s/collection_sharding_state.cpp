@@ -36,6 +36,7 @@
 #include "mongo/db/concurrency/lock_state.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/s/chunk_splitter.h"
 #include "mongo/db/s/collection_metadata.h"
 #include "mongo/db/s/migration_chunk_cloner_source.h"
 #include "mongo/db/s/migration_source_manager.h"
@@ -44,13 +45,20 @@
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/s/type_shard_identity.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/chunk_version.h"
+#include "mongo/s/shard_key_pattern.h"
 #include "mongo/s/stale_exception.h"
 
 namespace mongo {
 
 namespace {
 
+// Whether the primary counts the bytes written to each chunk and splits the chunks which grow too
+// large itself, rather than leaving that to mongos.
+MONGO_EXPORT_SERVER_PARAMETER(shardAutoSplit, bool, false);
+
 /**
  * Used to perform shard identity initialization once it is certain that the document is committed.
  */
@@ -105,6 +113,10 @@ void CollectionShardingState::setMetadata(std::shared_ptr<CollectionMetadata> ne
     }
 
     _metadata = std::move(newMetadata);
+
+    // The chunk boundaries may have changed, so start counting afresh.
+    stdx::lock_guard<stdx::mutex> lk(_chunkWritesMutex);
+    _chunkBytesWritten.clear();
 }
 
 MigrationSourceManager* CollectionShardingState::getMigrationSourceManager() {
@@ -170,6 +182,8 @@ void CollectionShardingState::onInsertOp(OperationContext* txn, const BSONObj& i
     if (_sourceMgr) {
         _sourceMgr->getCloner()->onInsertOp(txn, insertedDoc);
     }
+
+    _trackChunkWrite(txn, insertedDoc);
 }
 
 void CollectionShardingState::onUpdateOp(OperationContext* txn, const BSONObj& updatedDoc) {
@@ -180,6 +194,8 @@ void CollectionShardingState::onUpdateOp(OperationContext* txn, const BSONObj& u
     if (_sourceMgr) {
         _sourceMgr->getCloner()->onUpdateOp(txn, updatedDoc);
     }
+
+    _trackChunkWrite(txn, updatedDoc);
 }
 
 void CollectionShardingState::onDeleteOp(OperationContext* txn, const BSONObj& deletedDocId) {
@@ -201,6 +217,36 @@ void CollectionShardingState::onDeleteOp(OperationContext* txn, const BSONObj& d
     }
 }
 
+void CollectionShardingState::_trackChunkWrite(OperationContext* txn, const BSONObj& doc) {
+    if (!_metadata || !shardAutoSplit.load() || !txn->writesAreReplicated()) {
+        return;
+    }
+
+    const ShardKeyPattern shardKeyPattern(_metadata->getKeyPattern());
+    const BSONObj shardKey = shardKeyPattern.extractShardKeyFromDoc(doc);
+    ChunkType chunk;
+    if (shardKey.isEmpty() || !_metadata->keyBelongsToMe(shardKey) ||
+        !_metadata->getNextChunk(shardKey, &chunk)) {
+        return;
+    }
+
+    auto chunkSplitter = ChunkSplitter::get(txn->getServiceContext());
+    const long long splitThresholdBytes = chunkSplitter->getSplitThresholdBytes(txn);
+    {
+        stdx::lock_guard<stdx::mutex> lk(_chunkWritesMutex);
+        long long& bytesWritten = _chunkBytesWritten[chunk.getMin()];
+        bytesWritten += doc.objsize();
+        if (bytesWritten < splitThresholdBytes) {
+            return;
+        }
+
+        // Leave the chunk alone for another round of writes if it turns out not to need a split.
+        bytesWritten = 0;
+    }
+
+    chunkSplitter->trySplitting(_nss, chunk.getMin(), chunk.getMax());
+}
+
 bool CollectionShardingState::_checkShardVersionOk(OperationContext* txn,
                                                    string* errmsg,
                                                    ChunkVersion* expectedShardVersion,
@@ -28,16 +28,19 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
 #include <string>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/string_data.h"
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/bsonobj.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/stdx/mutex.h"
 
 namespace mongo {
 
-class BSONObj;
 struct ChunkVersion;
 class CollectionMetadata;
 class MigrationSourceManager;
@@ -126,6 +129,13 @@ public:
     void onDeleteOp(OperationContext* txn, const BSONObj& deletedDocId);
 
 private:
+    /**
+     * Adds the size of the inserted or updated document 'doc' to the bytes written to its chunk,
+     * and has the chunk splitter check the chunk once those pass its threshold. Does nothing unless
+     * the shardAutoSplit server parameter is set and this node accepts the write as primary.
+     */
+    void _trackChunkWrite(OperationContext* txn, const BSONObj& doc);
+
     /**
      * Checks whether the shard version of the operation matches that of the collection.
      *
@@ -157,6 +167,13 @@ private:
     //
     // NOTE: The value is not owned by this class.
     MigrationSourceManager* _sourceMgr{nullptr};
+
+    // Protects '_chunkBytesWritten', which writers update concurrently under the IX lock.
+    stdx::mutex _chunkWritesMutex;
+
+    // Bytes written to each chunk of '_metadata', keyed by the chunk's min key, since the chunk was
+    // last scheduled to be checked for splitting.
+    std::map<BSONObj, long long, BSONObjCmp> _chunkBytesWritten;
 };
 
 }  // namespace mongo
@@ -32,10 +32,13 @@
 
 #include "mongo/db/s/migration_chunk_cloner_source_legacy.h"
 
+#include <vector>
+
 #include "mongo/base/status.h"
 #include "mongo/client/read_preference.h"
 #include "mongo/client/remote_command_targeter.h"
 #include "mongo/db/concurrency/locker.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/exec/plan_stage.h"
@@ -44,6 +47,7 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/s/start_chunk_clone_request.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/executor/task_executor.h"
@@ -65,6 +69,10 @@ const char kRecvChunkStatus[] = "_recvChunkStatus";
 const char kRecvChunkCommit[] = "_recvChunkCommit";
 const char kRecvChunkAbort[] = "_recvChunkAbort";
 
+// The number of documents of the initial clone which are read ahead from the storage engine at a
+// time
+const std::size_t kCloneReadAheadBatch = 64;
+
 bool isInRange(const BSONObj& obj,
                const BSONObj& min,
                const BSONObj& max,
@@ -140,16 +148,18 @@ public:
         switch (_op) {
             case 'd': {
                 stdx::lock_guard<stdx::mutex> sl(_cloner->_mutex);
-                _cloner->_deleted.push_back(_idObj);
-                _cloner->_memoryUsed += _idObj.firstElement().size() + 5;
+                if (_cloner->_deleted.insert(_idObj).second) {
+                    _cloner->_memoryUsed += _idObj.firstElement().size() + 5;
+                }
                 break;
             }
 
             case 'i':
             case 'u': {
                 stdx::lock_guard<stdx::mutex> sl(_cloner->_mutex);
-                _cloner->_reload.push_back(_idObj);
-                _cloner->_memoryUsed += _idObj.firstElement().size() + 5;
+                if (_cloner->_reload.insert(_idObj).second) {
+                    _cloner->_memoryUsed += _idObj.firstElement().size() + 5;
+                }
                 break;
             }
 
@@ -405,7 +415,13 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* txn,
 
     stdx::lock_guard<stdx::mutex> sl(_mutex);
 
+    // The documents are appended straight from the storage engine's buffers, without making an
+    // owned copy of each of them first
+    auto cursor = collection->getCursor(txn);
+
     std::set<RecordId>::iterator it;
+    std::set<RecordId>::iterator readAheadEnd = _cloneLocs.begin();
+    std::vector<RecordId> readAheadIds;
 
     for (it = _cloneLocs.begin(); it != _cloneLocs.end(); ++it) {
         // We must always make progress in this method by at least one document because empty return
@@ -414,16 +430,32 @@ Status MigrationChunkClonerSourceLegacy::nextCloneBatch(OperationContext* txn,
             break;
         }
 
-        Snapshotted<BSONObj> doc;
-        if (collection->findDoc(txn, *it, &doc)) {
+        if (it == readAheadEnd) {
+            readAheadIds.clear();
+            for (; readAheadEnd != _cloneLocs.end() && readAheadIds.size() < kCloneReadAheadBatch;
+                 ++readAheadEnd) {
+                readAheadIds.push_back(*readAheadEnd);
+            }
+
+            try {
+                cursor->readAhead(readAheadIds);
+            } catch (const WriteConflictException&) {
+                // Read-ahead is only a hint, the reads below will find the documents regardless
+            }
+        }
+
+        auto record = cursor->seekExact(*it);
+        if (record) {
+            const BSONObj doc = record->data.toBson();
+
             // Use the builder size instead of accumulating the document sizes directly so that we
             // take into consideration the overhead of BSONArray indices.
             if (arrBuilder->arrSize() &&
-                (arrBuilder->len() + doc.value().objsize() + 1024) > BSONObjMaxUserSize) {
+                (arrBuilder->len() + doc.objsize() + 1024) > BSONObjMaxUserSize) {
                 break;
             }
 
-            arrBuilder->append(doc.value());
+            arrBuilder->append(doc);
         }
     }
 
@@ -629,14 +661,14 @@ Status MigrationChunkClonerSourceLegacy::_storeCurrentLocs(OperationContext* txn
 
 void MigrationChunkClonerSourceLegacy::_xfer(OperationContext* txn,
                                              Database* db,
-                                             std::list<BSONObj>* docIdList,
+                                             DocIdSet* docIdSet,
                                              BSONObjBuilder* builder,
                                              const char* fieldName,
                                              long long* sizeAccumulator,
                                              bool explode) {
     const long long maxSize = 1024 * 1024;
 
-    if (docIdList->size() == 0 || *sizeAccumulator > maxSize) {
+    if (docIdSet->empty() || *sizeAccumulator > maxSize) {
         return;
     }
 
@@ -644,8 +676,8 @@ void MigrationChunkClonerSourceLegacy::_xfer(OperationContext* txn,
 
     BSONArrayBuilder arr(builder->subarrayStart(fieldName));
 
-    std::list<BSONObj>::iterator docIdIter = docIdList->begin();
-    while (docIdIter != docIdList->end() && *sizeAccumulator < maxSize) {
+    DocIdSet::iterator docIdIter = docIdSet->begin();
+    while (docIdIter != docIdSet->end() && *sizeAccumulator < maxSize) {
         BSONObj idDoc = *docIdIter;
         if (explode) {
             BSONObj fullDoc;
@@ -658,7 +690,7 @@ void MigrationChunkClonerSourceLegacy::_xfer(OperationContext* txn,
             *sizeAccumulator += idDoc.objsize();
         }
 
-        docIdIter = docIdList->erase(docIdIter);
+        docIdIter = docIdSet->erase(docIdIter);
     }
 
     arr.done();
@@ -28,8 +28,8 @@
 
 #pragma once
 
-#include <list>
 #include <set>
+#include <unordered_set>
 
 #include "mongo/bson/bsonobj.h"
 #include "mongo/client/connection_string.h"
@@ -122,6 +122,10 @@ private:
     friend class DeleteNotificationStage;
     friend class LogOpForShardingHandler;
 
+    // Set of the _id of documents modified during the migration. The same document is only
+    // recorded once, however many times it is written before it is transferred.
+    using DocIdSet = std::unordered_set<BSONObj, BSONObj::Hasher>;
+
     /**
      * Idempotent method, which cleans up any previously initialized state. It is safe to be called
      * at any time, but no methods should be called after it.
@@ -143,16 +147,16 @@ private:
     Status _storeCurrentLocs(OperationContext* txn);
 
     /**
-     * Insert items from docIdList to a new array with the given fieldName in the given builder. If
+     * Insert items from docIdSet to a new array with the given fieldName in the given builder. If
      * explode is true, the inserted object will be the full version of the document. Note that
-     * whenever an item from the docList is inserted to the array, it will also be removed from
-     * docList.
+     * whenever an item from the docIdSet is inserted to the array, it will also be removed from
+     * docIdSet.
      *
      * Should be holding the collection lock for ns if explode is true.
      */
     void _xfer(OperationContext* txn,
                Database* db,
-               std::list<BSONObj>* docIdList,
+               DocIdSet* docIdSet,
                BSONObjBuilder* builder,
                const char* fieldName,
                long long* sizeAccumulator,
@@ -191,13 +195,13 @@ private:
     // pre-allocation.
     uint64_t _averageObjectSizeForCloneLocs{0};
 
-    // List of _id of documents that were modified that must be re-cloned.
-    std::list<BSONObj> _reload;
+    // Set of _id of documents that were modified that must be re-cloned.
+    DocIdSet _reload;
 
-    // List of _id of documents that were deleted during clone that should be deleted later.
-    std::list<BSONObj> _deleted;
+    // Set of _id of documents that were deleted during clone that should be deleted later.
+    DocIdSet _deleted;
 
-    // Total bytes in _reload + _deleted
+    // Total bytes ever recorded in _reload + _deleted
     uint64_t _memoryUsed{0};
 };
 
@@ -61,6 +61,9 @@
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/stdx/chrono.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -186,6 +189,105 @@ BSONObj createTransferModsRequest(const MigrationSessionId& sessionId) {
     return builder.obj();
 }
 
+/**
+ * Runs the _migrateClone command against the donor shard on a separate thread and keeps the next
+ * batch of documents ready while the current one is being inserted, so that the round trip to the
+ * donor overlaps with the local writes. Fetching stops after a failed command or an empty batch,
+ * which is also where the caller stops asking for more.
+ *
+ * The connection must not be used by anyone else until shutdown() has returned.
+ */
+class MigrateCloneBatchFetcher {
+    MONGO_DISALLOW_COPYING(MigrateCloneBatchFetcher);
+
+public:
+    MigrateCloneBatchFetcher(DBClientBase* conn, BSONObj migrateCloneRequest)
+        : _conn(conn),
+          _migrateCloneRequest(std::move(migrateCloneRequest)),
+          _thread([this] { _run(); }) {}
+
+    ~MigrateCloneBatchFetcher() {
+        shutdown();
+    }
+
+    /**
+     * Blocks until the response to the next _migrateClone command is available. Returns whether
+     * the command succeeded and fills 'response' with its reply either way.
+     */
+    bool getNext(BSONObj* response) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _condVar.wait(lk, [this] { return _nextBatch.is_initialized(); });
+
+        const bool ok = _nextBatch->first;
+        *response = std::move(_nextBatch->second);
+        _nextBatch = boost::none;
+        _condVar.notify_all();
+
+        return ok;
+    }
+
+    /**
+     * Stops fetching and waits for the fetching thread to exit. Safe to call more than once.
+     */
+    void shutdown() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _inShutdown = true;
+            _condVar.notify_all();
+        }
+
+        if (_thread.joinable()) {
+            _thread.join();
+        }
+    }
+
+private:
+    void _run() {
+        while (true) {
+            BSONObj res;
+            bool ok;
+            try {
+                // gets array of objects to copy, in disk order
+                ok = _conn->runCommand("admin", _migrateCloneRequest, res);
+            } catch (const DBException& ex) {
+                ok = false;
+                res = BSON("ok" << 0 << "errmsg" << ex.toString());
+            }
+
+            const bool done =
+                !ok || res["objects"].type() != Array || res["objects"].Obj().isEmpty();
+
+            stdx::unique_lock<stdx::mutex> lk(_mutex);
+            _condVar.wait(lk, [this] { return !_nextBatch || _inShutdown; });
+            if (_inShutdown) {
+                return;
+            }
+
+            _nextBatch = std::make_pair(ok, res.getOwned());
+            _condVar.notify_all();
+
+            if (done) {
+                return;
+            }
+        }
+    }
+
+    DBClientBase* const _conn;
+    const BSONObj _migrateCloneRequest;
+
+    // Protects the state below
+    stdx::mutex _mutex;
+    stdx::condition_variable _condVar;
+
+    // Response to the most recent _migrateClone command, which has not been consumed yet
+    boost::optional<std::pair<bool, BSONObj>> _nextBatch;
+
+    bool _inShutdown{false};
+
+    // Must be last so that all of the above is initialized before the thread starts
+    stdx::thread _thread;
+};
+
 // Enabling / disabling these fail points pauses / resumes MigrateStatus::_go(), the thread which
 // receives a chunk migration from the donor.
 MONGO_FP_DECLARE(migrateThreadHangAtStep1);
@@ -602,17 +704,16 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
         // 3. Initial bulk clone
         setState(CLONE);
 
-        const BSONObj migrateCloneRequest = createMigrateCloneRequest(sessionId);
+        MigrateCloneBatchFetcher cloneFetcher(conn.get(), createMigrateCloneRequest(sessionId));
 
         while (true) {
             BSONObj res;
-            if (!conn->runCommand("admin",
-                                  migrateCloneRequest,
-                                  res)) {  // gets array of objects to copy, in disk order
+            if (!cloneFetcher.getNext(&res)) {
                 setState(FAIL);
                 errmsg = "_migrateClone failed: ";
                 errmsg += res.toString();
                 error() << errmsg << migrateLog;
+                cloneFetcher.shutdown();
                 conn.done();
                 return;
             }
@@ -620,20 +721,23 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
             BSONObj arr = res["objects"].Obj();
             int thisTime = 0;
 
-            BSONObjIterator i(arr);
-            while (i.more()) {
-                txn->checkForInterrupt();
+            {
+                // The whole batch is applied under a single lock acquisition rather than taking
+                // the locks again for every document
+                OldClientWriteContext cx(txn, ns);
 
-                if (getState() == ABORT) {
-                    errmsg = str::stream() << "Migration abort requested while "
-                                           << "copying documents";
-                    error() << errmsg << migrateLog;
-                    return;
-                }
+                BSONObjIterator i(arr);
+                while (i.more()) {
+                    txn->checkForInterrupt();
 
-                BSONObj docToClone = i.next().Obj();
-                {
-                    OldClientWriteContext cx(txn, ns);
+                    if (getState() == ABORT) {
+                        errmsg = str::stream() << "Migration abort requested while "
+                                               << "copying documents";
+                        error() << errmsg << migrateLog;
+                        return;
+                    }
+
+                    BSONObj docToClone = i.next().Obj();
 
                     BSONObj localDoc;
                     if (willOverrideLocalId(
@@ -649,27 +753,28 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
                     }
 
                     Helpers::upsert(txn, ns, docToClone, true);
-                }
-                thisTime++;
+                    thisTime++;
 
-                {
-                    stdx::lock_guard<stdx::mutex> statsLock(_mutex);
-                    _numCloned++;
-                    _clonedBytes += docToClone.objsize();
+                    {
+                        stdx::lock_guard<stdx::mutex> statsLock(_mutex);
+                        _numCloned++;
+                        _clonedBytes += docToClone.objsize();
+                    }
                 }
+            }
 
-                if (writeConcern.shouldWaitForOtherNodes()) {
-                    repl::ReplicationCoordinator::StatusAndDuration replStatus =
-                        repl::getGlobalReplicationCoordinator()->awaitReplication(
-                            txn,
-                            repl::ReplClientInfo::forClient(txn->getClient()).getLastOp(),
-                            writeConcern);
-                    if (replStatus.status.code() == ErrorCodes::WriteConcernFailed) {
-                        warning() << "secondaryThrottle on, but doc insert timed out; "
-                                     "continuing";
-                    } else {
-                        massertStatusOK(replStatus.status);
-                    }
+            // Throttle on the secondaries once per batch, after the locks have been released
+            if (thisTime > 0 && writeConcern.shouldWaitForOtherNodes()) {
+                repl::ReplicationCoordinator::StatusAndDuration replStatus =
+                    repl::getGlobalReplicationCoordinator()->awaitReplication(
+                        txn,
+                        repl::ReplClientInfo::forClient(txn->getClient()).getLastOp(),
+                        writeConcern);
+                if (replStatus.status.code() == ErrorCodes::WriteConcernFailed) {
+                    warning() << "secondaryThrottle on, but doc insert timed out; "
+                                 "continuing";
+                } else {
+                    massertStatusOK(replStatus.status);
                 }
             }
 
@@ -48,6 +48,7 @@
 #include "mongo/db/server_parameters.h"
 #include "mongo/logger/log_component.h"
 #include "mongo/logger/message_event_utf8_encoder.h"
+#include "mongo/transport/message_compressor_registry.h"
 #include "mongo/util/cmdline_utils/censor_cmdline.h"
 #include "mongo/util/log.h"
 #include "mongo/util/map_util.h"
@@ -194,6 +195,12 @@ Status addGeneralServerOptions(moe::OptionSection* options) {
     options->addOptionChaining(
         "net.maxIncomingConnections", "maxConns", moe::Int, maxConnInfoBuilder.str().c_str());
 
+    options->addOptionChaining("net.compression.compressors",
+                               "networkMessageCompressors",
+                               moe::String,
+                               "comma separated list of compressors to use for network messages, "
+                               "or \"disabled\" (snappy by default)");
+
     options
         ->addOptionChaining(
             "logpath",
@@ -845,6 +852,14 @@ Status storeServerOptions(const moe::Environment& params, const std::vector<std:
         serverGlobalParams.objcheck = params["net.wireObjectCheck"].as<bool>();
     }
 
+    if (params.count("net.compression.compressors")) {
+        Status ret = MessageCompressorRegistry::get().setSupportedCompressors(
+            StringData(params["net.compression.compressors"].as<std::string>()));
+        if (!ret.isOK()) {
+            return ret;
+        }
+    }
+
     if (params.count("net.bindIp")) {
         // passing in wildcard is the same as default behavior; remove for SERVER-3350
         if (serverGlobalParams.bind_ip == "0.0.0.0") {
@@ -47,7 +47,9 @@
 
 #include "mongo/db/sorter/sorter.h"
 
+#include <algorithm>
 #include <boost/filesystem/operations.hpp>
+#include <exception>
 #include <snappy.h>
 #include <vector>
 
@@ -59,6 +61,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/s/mongos_options.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/bufreader.h"
 #include "mongo/util/destructor_guard.h"
@@ -429,29 +432,41 @@ public:
         verify(_opts.limit == 0);
     }
 
+    ~NoLimitSorter() {
+        if (_spillThread.joinable()) {
+            _spillThread.join();
+        }
+    }
+
     void add(const Key& key, const Value& val) {
         _data.push_back(std::make_pair(key, val));
 
         _memUsed += key.memUsageForSorter();
         _memUsed += val.memUsageForSorter();
 
-        if (_memUsed > _opts.maxMemoryUsageBytes)
+        // While a run is being spilled in the background it still holds memory, so each run only
+        // gets half of the budget.
+        const size_t maxRunBytes =
+            _opts.numThreads > 1 ? _opts.maxMemoryUsageBytes / 2 : _opts.maxMemoryUsageBytes;
+        if (_memUsed > maxRunBytes)
             spill();
     }
 
     Iterator* done() {
+        waitForSpill();
         if (_iters.empty()) {
-            sort();
+            sort(&_data);
             return new InMemIterator<Key, Value>(_data);
         }
 
         spill();
+        waitForSpill();
         return Iterator::merge(_iters, _opts, _comp);
     }
 
     // TEMP these are here for compatibility. Will be replaced with a general stats API
     int numFiles() const {
-        return _iters.size();
+        return _iters.size() + (_spillThread.joinable() ? 1 : 0);
     }
     size_t memUsed() const {
         return _memUsed;
@@ -470,13 +485,80 @@ private:
         const Comparator& _comp;
     };
 
-    void sort() {
+    // Runs smaller than this many items per thread are sorted on a single thread.
+    static const size_t kMinItemsPerSortThread = 16 * 1024;
+
+    void sort(std::deque<Data>* data) {
         STLComparator less(_comp);
-        std::stable_sort(_data.begin(), _data.end(), less);
+        const size_t numChunks =
+            std::min(_opts.numThreads, std::max<size_t>(1, data->size() / kMinItemsPerSortThread));
+        if (numChunks <= 1) {
+            std::stable_sort(data->begin(), data->end(), less);
+
+            // Does 2x more compares than stable_sort
+            // TODO test on windows
+            // std::sort(_data.begin(), _data.end(), comp);
+            return;
+        }
+
+        // Sort equal chunks of the run concurrently, then merge neighbouring chunks, doing the
+        // merges of each level concurrently too. Both steps are stable, so the result is the same
+        // as a single stable_sort.
+        std::vector<typename std::deque<Data>::iterator> bounds;
+        for (size_t i = 0; i <= numChunks; i++) {
+            bounds.push_back(data->begin() + (data->size() * i) / numChunks);
+        }
 
-        // Does 2x more compares than stable_sort
-        // TODO test on windows
-        // std::sort(_data.begin(), _data.end(), comp);
+        std::vector<stdx::thread> threads;
+        for (size_t i = 1; i < numChunks; i++) {
+            threads.emplace_back([&, i] { std::stable_sort(bounds[i], bounds[i + 1], less); });
+        }
+        std::stable_sort(bounds[0], bounds[1], less);
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (size_t width = 1; width < numChunks; width *= 2) {
+            threads.clear();
+            for (size_t i = 2 * width; i + width < numChunks; i += 2 * width) {
+                threads.emplace_back([&, i, width] {
+                    std::inplace_merge(bounds[i],
+                                       bounds[i + width],
+                                       bounds[std::min(i + 2 * width, numChunks)],
+                                       less);
+                });
+            }
+            std::inplace_merge(
+                bounds[0], bounds[width], bounds[std::min(2 * width, numChunks)], less);
+            for (auto& thread : threads) {
+                thread.join();
+            }
+        }
+    }
+
+    std::shared_ptr<Iterator> writeRun(std::deque<Data>* run) {
+        SortedFileWriter<Key, Value> writer(_opts, _settings);
+        for (; !run->empty(); run->pop_front()) {
+            writer.addAlreadySorted(run->front().first, run->front().second);
+        }
+        return std::shared_ptr<Iterator>(writer.done());
+    }
+
+    /**
+     * Waits for the run being spilled in the background, if any, and adds it to _iters.
+     * Rethrows any error from spilling it.
+     */
+    void waitForSpill() {
+        if (!_spillThread.joinable())
+            return;
+
+        _spillThread.join();
+        if (_spillError) {
+            std::exception_ptr error = _spillError;
+            _spillError = nullptr;
+            std::rethrow_exception(error);
+        }
+        _iters.push_back(std::move(_spilledRun));
     }
 
     void spill() {
@@ -496,16 +578,27 @@ private:
                           << " Pass allowDiskUse:true to opt in.");
         }
 
-        sort();
-
-        SortedFileWriter<Key, Value> writer(_opts, _settings);
-        for (; !_data.empty(); _data.pop_front()) {
-            writer.addAlreadySorted(_data.front().first, _data.front().second);
+        if (_opts.numThreads <= 1) {
+            sort(&_data);
+            _iters.push_back(writeRun(&_data));
+            _memUsed = 0;
+            return;
         }
 
-        _iters.push_back(std::shared_ptr<Iterator>(writer.done()));
-
+        // Sort, compress and write this run in the background while the next one fills. Runs are
+        // spilled one at a time so that _iters stays in the order the data was added.
+        waitForSpill();
+        auto run = std::make_shared<std::deque<Data>>();
+        run->swap(_data);
         _memUsed = 0;
+        _spillThread = stdx::thread([this, run] {
+            try {
+                sort(run.get());
+                _spilledRun = writeRun(run.get());
+            } catch (...) {
+                _spillError = std::current_exception();
+            }
+        });
     }
 
     const Comparator _comp;
@@ -514,6 +607,11 @@ private:
     size_t _memUsed;
     std::deque<Data> _data;                         // the "current" data
     std::vector<std::shared_ptr<Iterator>> _iters;  // data that has already been spilled
+
+    // The run being spilled in the background, only used if _opts.numThreads > 1.
+    stdx::thread _spillThread;
+    std::shared_ptr<Iterator> _spilledRun;  // Read only after joining _spillThread.
+    std::exception_ptr _spillError;         // Read only after joining _spillThread.
 };
 
 template <typename Key, typename Value, typename Comparator>
@@ -0,0 +1,104 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/sorter/sorter.h"
+
+#include <memory>
+#include <vector>
+
+#include "mongo/base/init.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/service_context_noop.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/benchmark.h"
+
+// Need access to internal classes
+#include "mongo/db/sorter/sorter.cpp"
+
+namespace mongo {
+
+// Stub to avoid including the server_options library
+bool isMongos() {
+    return false;
+}
+
+// Stub to avoid including the server environment library.
+MONGO_INITIALIZER(SetGlobalEnvironment)(InitializerContext* context) {
+    setGlobalServiceContext(stdx::make_unique<ServiceContextNoop>());
+    return Status::OK();
+}
+
+namespace {
+
+using KeySorter = Sorter<BSONObj, RecordId>;
+
+class KeyComparator {
+public:
+    int operator()(const KeySorter::Data& lhs, const KeySorter::Data& rhs) const {
+        return lhs.first.woCompare(rhs.first, BSONObj(), false);
+    }
+};
+
+std::vector<BSONObj> makeShuffledKeys(int count) {
+    // Multiplying by a prime coprime with the count visits every value once, out of order.
+    std::vector<BSONObj> keys;
+    for (int i = 0; i < count; ++i) {
+        keys.push_back(BSON("" << (i * 7919) % count));
+    }
+    return keys;
+}
+
+void runSort(benchmark::BenchmarkState& state, const SortOptions& options) {
+    const auto keys = makeShuffledKeys(10000);
+    while (state.keepRunning()) {
+        std::unique_ptr<KeySorter> sorter(KeySorter::make(options, KeyComparator()));
+        for (size_t i = 0; i < keys.size(); ++i) {
+            sorter->add(keys[i], RecordId(i + 1));
+        }
+
+        std::unique_ptr<KeySorter::Iterator> it(sorter->done());
+        while (it->more()) {
+            benchmark::doNotOptimizeAway(it->next());
+        }
+    }
+}
+
+MONGO_BENCHMARK(SorterInMemory10000Keys) {
+    runSort(state, SortOptions());
+}
+
+MONGO_BENCHMARK(SorterInMemory10000KeysLimit100) {
+    runSort(state, SortOptions().Limit(100));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -522,6 +522,20 @@ public:
 };
 
 
+// Sorts everything in memory, in chunks on several threads.
+class LotsOfDataParallelSort : public LotsOfDataLittleMemory<> {
+    SortOptions adjustSortOptions(SortOptions opts) {
+        return opts.NumThreads(4);
+    }
+};
+
+// Sorts and spills runs in the background while the next one is being added.
+class LotsOfDataParallelSpill : public LotsOfDataLittleMemory<> {
+    SortOptions adjustSortOptions(SortOptions opts) {
+        return opts.MaxMemoryUsageBytes(MEM_LIMIT).ExtSortAllowed().NumThreads(4);
+    }
+};
+
 template <long long Limit, bool Random = true>
 class LotsOfDataWithLimit : public LotsOfDataLittleMemory<Random> {
     typedef LotsOfDataLittleMemory<Random> Parent;
@@ -564,6 +578,8 @@ public:
         add<SorterTests::Dupes>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/false>>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/true>>();
+        add<SorterTests::LotsOfDataParallelSort>();
+        add<SorterTests::LotsOfDataParallelSpill>();
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/false>>();     // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/true>>();      // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<100, /*random=*/false>>();   // fits in mem
@@ -260,7 +260,11 @@ void logMongodStartupWarnings(const StorageGlobalParams& storageParams,
             log() << startupWarningsLog;
             log() << "** WARNING: " << kTransparentHugePagesDirectory << "/enabled is 'always'."
                   << startupWarningsLog;
-            log() << "**        We suggest setting it to 'never'" << startupWarningsLog;
+            log() << "**        We suggest setting it to 'never', or to 'madvise' together with"
+                  << startupWarningsLog;
+            log() << "**        --setParameter tcmallocHugePageArena=transparent to use huge pages"
+                  << startupWarningsLog;
+            log() << "**        for the heap only" << startupWarningsLog;
             warned = true;
         }
     } else if (transparentHugePagesEnabledResult.getStatus().code() !=
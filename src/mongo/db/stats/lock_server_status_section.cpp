@@ -94,6 +94,11 @@ public:
         return ret.obj();
     }
 
+    // Counting the clients locks every one of them, which is expensive with many connections.
+    virtual Milliseconds cacheDuration() const {
+        return Milliseconds(500);
+    }
+
 private:
     unsigned long long _started;
 
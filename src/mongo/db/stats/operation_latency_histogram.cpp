@@ -91,6 +91,45 @@ const std::array<uint64_t, OperationLatencyHistogram::kMaxBuckets>
                                                549755813888,
                                                1099511627776};
 
+OperationLatencyHistogram::OperationLatencyHistogram(const OperationLatencyHistogram& other) {
+    *this += other;
+}
+
+OperationLatencyHistogram& OperationLatencyHistogram::operator=(
+    const OperationLatencyHistogram& other) {
+    if (this != &other) {
+        _reset(&_reads);
+        _reset(&_writes);
+        _reset(&_commands);
+        *this += other;
+    }
+    return *this;
+}
+
+OperationLatencyHistogram& OperationLatencyHistogram::operator+=(
+    const OperationLatencyHistogram& other) {
+    _add(other._reads, &_reads);
+    _add(other._writes, &_writes);
+    _add(other._commands, &_commands);
+    return *this;
+}
+
+void OperationLatencyHistogram::_add(const HistogramData& from, HistogramData* to) {
+    for (int i = 0; i < kMaxBuckets; i++) {
+        to->buckets[i].fetchAndAdd(from.buckets[i].load());
+    }
+    to->entryCount.fetchAndAdd(from.entryCount.load());
+    to->sum.fetchAndAdd(from.sum.load());
+}
+
+void OperationLatencyHistogram::_reset(HistogramData* data) {
+    for (auto& bucket : data->buckets) {
+        bucket.store(0);
+    }
+    data->entryCount.store(0);
+    data->sum.store(0);
+}
+
 void OperationLatencyHistogram::_append(const HistogramData& data,
                                         const char* key,
                                         BSONObjBuilder* builder) const {
@@ -98,17 +137,18 @@ void OperationLatencyHistogram::_append(const HistogramData& data,
     BSONObjBuilder histogramBuilder(builder->subobjStart(key));
     BSONArrayBuilder arrayBuilder(histogramBuilder.subarrayStart("histogram"));
     for (int i = 0; i < kMaxBuckets; i++) {
-        if (data.buckets[i] == 0)
+        const auto count = data.buckets[i].load();
+        if (count == 0)
             continue;
         BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
         entryBuilder.append("micros", static_cast<long long>(kLowerBounds[i]));
-        entryBuilder.append("count", static_cast<long long>(data.buckets[i]));
+        entryBuilder.append("count", static_cast<long long>(count));
         entryBuilder.doneFast();
     }
 
     arrayBuilder.doneFast();
-    histogramBuilder.append("latency", static_cast<long long>(data.sum));
-    histogramBuilder.append("ops", static_cast<long long>(data.entryCount));
+    histogramBuilder.append("latency", static_cast<long long>(data.sum.load()));
+    histogramBuilder.append("ops", static_cast<long long>(data.entryCount.load()));
     histogramBuilder.doneFast();
 }
 
@@ -146,9 +186,9 @@ int OperationLatencyHistogram::_getBucket(uint64_t value) {
 }
 
 void OperationLatencyHistogram::_incrementData(uint64_t latency, int bucket, HistogramData* data) {
-    data->buckets[bucket]++;
-    data->entryCount++;
-    data->sum += latency;
+    data->buckets[bucket].fetchAndAdd(1);
+    data->entryCount.fetchAndAdd(1);
+    data->sum.fetchAndAdd(latency);
 }
 
 void OperationLatencyHistogram::increment(uint64_t latency, Command::ReadWriteType type) {
@@ -30,6 +30,7 @@
 #include <array>
 
 #include "mongo/db/commands.h"
+#include "mongo/platform/atomic_word.h"
 
 namespace mongo {
 
@@ -38,7 +39,9 @@ class BSONObjBuilder;
 /**
  * Stores statistics for latencies of read, write, and command operations.
  *
- * Note: This class is not thread-safe.
+ * The counters are atomic, so that any number of threads may call increment() concurrently with
+ * each other and with append(), without any lock. A concurrent append() may see an operation
+ * counted in its bucket but not yet in the totals.
  */
 class OperationLatencyHistogram {
 public:
@@ -47,11 +50,20 @@ public:
     // Inclusive lower bounds of the histogram buckets.
     static const std::array<uint64_t, kMaxBuckets> kLowerBounds;
 
+    OperationLatencyHistogram() = default;
+    OperationLatencyHistogram(const OperationLatencyHistogram& other);
+    OperationLatencyHistogram& operator=(const OperationLatencyHistogram& other);
+
     /**
      * Increments the bucket of the histogram based on the operation type.
      */
     void increment(uint64_t latency, Command::ReadWriteType type);
 
+    /**
+     * Adds the counts of 'other' to this histogram.
+     */
+    OperationLatencyHistogram& operator+=(const OperationLatencyHistogram& other);
+
     /**
      * Appends the three histograms with latency totals and operation counts.
      */
@@ -59,15 +71,19 @@ public:
 
 private:
     struct HistogramData {
-        std::array<uint64_t, kMaxBuckets> buckets{};
-        uint64_t entryCount = 0;
-        uint64_t sum = 0;
+        std::array<AtomicUInt64, kMaxBuckets> buckets;
+        AtomicUInt64 entryCount;
+        AtomicUInt64 sum;
     };
 
     static int _getBucket(uint64_t latency);
 
     static uint64_t _getBucketMicros(int bucket);
 
+    static void _add(const HistogramData& from, HistogramData* to);
+
+    static void _reset(HistogramData* data);
+
     void _append(const HistogramData& data, const char* key, BSONObjBuilder* builder) const;
 
     void _incrementData(uint64_t latency, int bucket, HistogramData* data);
@@ -37,6 +37,7 @@
 
 #include "mongo/db/commands.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -89,4 +90,49 @@ TEST(OperationLatencyHistogram, CheckBucketCountsAndTotalLatency) {
         ASSERT_EQUALS(bucket["count"].Long(), (i < kMaxBuckets - 1) ? 3 : 2);
     }
 }
+
+TEST(OperationLatencyHistogram, AddAndCopyHistograms) {
+    OperationLatencyHistogram first;
+    first.increment(10, Command::ReadWriteType::kRead);
+    OperationLatencyHistogram second;
+    second.increment(20, Command::ReadWriteType::kRead);
+    second.increment(30, Command::ReadWriteType::kWrite);
+
+    OperationLatencyHistogram total(first);
+    total += second;
+
+    BSONObjBuilder outBuilder;
+    total.append(&outBuilder);
+    BSONObj out = outBuilder.done();
+    ASSERT_EQUALS(out["reads"]["ops"].Long(), 2);
+    ASSERT_EQUALS(out["reads"]["latency"].Long(), 30);
+    ASSERT_EQUALS(out["writes"]["ops"].Long(), 1);
+    ASSERT_EQUALS(out["commands"]["ops"].Long(), 0);
+
+    total = first;
+    BSONObjBuilder copyBuilder;
+    total.append(&copyBuilder);
+    ASSERT_EQUALS(copyBuilder.done()["reads"]["ops"].Long(), 1);
+}
+
+TEST(OperationLatencyHistogram, ConcurrentIncrementsAreAllCounted) {
+    OperationLatencyHistogram hist;
+    const int kThreads = 4;
+    const int kIncrementsPerThread = 10000;
+    std::vector<stdx::thread> threads;
+    for (int i = 0; i < kThreads; i++) {
+        threads.emplace_back([&hist] {
+            for (int j = 0; j < kIncrementsPerThread; j++) {
+                hist.increment(j, Command::ReadWriteType::kRead);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    BSONObjBuilder outBuilder;
+    hist.append(&outBuilder);
+    ASSERT_EQUALS(outBuilder.done()["reads"]["ops"].Long(), kThreads * kIncrementsPerThread);
+}
 }  // namespace mongo
@@ -38,9 +38,14 @@ namespace mongo {
  * Sample format:
  *
  * rangeDeleter: {
+ *   pendingDeletes: 2,
+ *   deletesInProgress: 1,
+ *   deletedDocs: NumberLong(1200),
+ *   deletedBytes: NumberLong(96000),
  *   lastDeleteStats: [
  *     {
  *       deleteDocs: NumberLong(5);
+ *       deletedBytes: NumberLong(400);
  *       queueStart: ISODate("2014-06-11T22:45:30.221Z"),
  *       queueEnd: ISODate("2014-06-11T22:45:30.221Z"),
  *       deleteStart: ISODate("2014-06-11T22:45:30.221Z"),
@@ -65,6 +70,10 @@ public:
         }
 
         BSONObjBuilder result;
+        result.appendNumber("pendingDeletes", deleter->getPendingDeletes());
+        result.appendNumber("deletesInProgress", deleter->getDeletesInProgress());
+        result.appendNumber("deletedDocs", deleter->getDeletedDocCount());
+        result.appendNumber("deletedBytes", deleter->getDeletedBytes());
 
         OwnedPointerVector<DeleteJobStats> statsList;
         deleter->getStatsHistory(&statsList.mutableVector());
@@ -74,6 +83,7 @@ public:
              ++it) {
             BSONObjBuilder entryBuilder;
             entryBuilder.append("deletedDocs", (*it)->deletedDocCount);
+            entryBuilder.append("deletedBytes", (*it)->deletedBytes);
 
             if ((*it)->queueEndTS > Date_t()) {
                 entryBuilder.append("queueStart", (*it)->queueStartTS);
@@ -0,0 +1,193 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/sampled_profile_buffer.h"
+
+#include <algorithm>
+#include <third_party/murmurhash3/MurmurHash3.h>
+
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(sampledProfilerSampleRate, double, 0.0);
+MONGO_EXPORT_SERVER_PARAMETER(sampledProfilerShapeIntervalMillis, int, 0);
+MONGO_EXPORT_SERVER_PARAMETER(sampledProfilerRetainedRecords, int, 1000);
+
+namespace {
+
+const auto getSampledProfileBuffer = ServiceContext::declareDecoration<SampledProfileBuffer>();
+
+static_assert((SampledProfileBuffer::kRingCapacity & (SampledProfileBuffer::kRingCapacity - 1)) ==
+                  0,
+              "the capacity of the ring must be a power of two");
+
+/**
+ * Maps consecutive values of a counter to well distributed 64 bit values (splitmix64).
+ */
+uint64_t mix(uint64_t value) {
+    value += 0x9E3779B97F4A7C15ULL;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+    return value ^ (value >> 31);
+}
+
+}  // namespace
+
+const size_t SampledProfileBuffer::kRingCapacity;
+const size_t SampledProfileBuffer::kNumShapeSlots;
+
+SampledProfileBuffer::SampledProfileBuffer() : _ring(new Slot[kRingCapacity]) {
+    for (size_t i = 0; i < kRingCapacity; ++i) {
+        _ring[i].sequence.store(i);
+    }
+}
+
+SampledProfileBuffer* SampledProfileBuffer::get(ServiceContext* service) {
+    return &getSampledProfileBuffer(service);
+}
+
+bool SampledProfileBuffer::shouldSample(StringData ns, StringData queryShape, Date_t now) {
+    const long long intervalMillis = sampledProfilerShapeIntervalMillis.load();
+    if (intervalMillis > 0 && !queryShape.empty()) {
+        uint32_t hash;
+        MurmurHash3_x86_32(
+            queryShape.rawData(), queryShape.size(), StringMapTraits::hash(ns), &hash);
+        auto& lastSampledMillis = _shapeLastSampledMillis[hash % kNumShapeSlots];
+
+        const long long nowMillis = now.toMillisSinceEpoch();
+        const long long last = lastSampledMillis.load();
+        if (nowMillis - last < intervalMillis) {
+            return false;
+        }
+
+        // Of the operations of the shape which see the interval elapse, only the one which
+        // advances the time is sampled.
+        return lastSampledMillis.compareAndSwap(last, nowMillis) == last;
+    }
+
+    const double rate = sampledProfilerSampleRate.load();
+    if (rate <= 0) {
+        return false;
+    }
+    if (rate >= 1) {
+        return true;
+    }
+
+    // The top 53 bits give a uniform double in [0, 1).
+    const uint64_t random = mix(_sampleCount.fetchAndAdd(1));
+    return (random >> 11) * (1.0 / (1ULL << 53)) < rate;
+}
+
+void SampledProfileBuffer::record(Record record) {
+    uint64_t position = _pushPosition.load();
+    Slot* slot;
+    while (true) {
+        slot = &_ring[position & (kRingCapacity - 1)];
+        const uint64_t sequence = slot->sequence.load();
+        if (sequence == position) {
+            // The slot is free for this position; claim the position.
+            const uint64_t observed = _pushPosition.compareAndSwap(position, position + 1);
+            if (observed == position) {
+                break;
+            }
+            position = observed;
+        } else if (sequence < position) {
+            // The slot still holds the record of the previous lap, so the ring is full.
+            _dropped.fetchAndAdd(1);
+            return;
+        } else {
+            position = _pushPosition.load();
+        }
+    }
+
+    slot->record = std::move(record);
+    slot->sequence.store(position + 1);
+}
+
+bool SampledProfileBuffer::_pop(Record* record) {
+    uint64_t position = _popPosition.load();
+    Slot* slot;
+    while (true) {
+        slot = &_ring[position & (kRingCapacity - 1)];
+        const uint64_t sequence = slot->sequence.load();
+        if (sequence == position + 1) {
+            const uint64_t observed = _popPosition.compareAndSwap(position, position + 1);
+            if (observed == position) {
+                break;
+            }
+            position = observed;
+        } else if (sequence < position + 1) {
+            // The slot has not been written for this position yet, so the ring is empty.
+            return false;
+        } else {
+            position = _popPosition.load();
+        }
+    }
+
+    *record = std::move(slot->record);
+    slot->record = Record();
+    slot->sequence.store(position + kRingCapacity);
+    return true;
+}
+
+std::vector<SampledProfileBuffer::Record> SampledProfileBuffer::drain() {
+    std::vector<Record> records;
+    Record record;
+    while (_pop(&record)) {
+        records.push_back(std::move(record));
+    }
+
+    const size_t maxRecent =
+        static_cast<size_t>(std::max(sampledProfilerRetainedRecords.load(), 0));
+    stdx::lock_guard<stdx::mutex> lk(_recentMutex);
+    _recent.insert(_recent.end(), records.begin(), records.end());
+    while (_recent.size() > maxRecent) {
+        _recent.pop_front();
+    }
+    return records;
+}
+
+std::vector<BSONObj> SampledProfileBuffer::getRecent(StringData dbName) {
+    drain();
+
+    std::vector<BSONObj> docs;
+    stdx::lock_guard<stdx::mutex> lk(_recentMutex);
+    for (const auto& record : _recent) {
+        if (record.dbName == dbName) {
+            docs.push_back(record.doc);
+        }
+    }
+    return docs;
+}
+
+}  // namespace mongo
@@ -0,0 +1,155 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/platform/atomic_proxy.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class ServiceContext;
+
+// The probability with which an operation not sampled by query shape is sampled.
+extern AtomicDouble sampledProfilerSampleRate;  // NOLINT
+
+// The minimum interval between two samples of the same query shape of a collection, or 0 to sample
+// all operations by rate.
+extern std::atomic<int> sampledProfilerShapeIntervalMillis;  // NOLINT
+
+// The number of the most recent sampled profile documents kept for $sampledProfile.
+extern std::atomic<int> sampledProfilerRetainedRecords;  // NOLINT
+
+/**
+ * Holds the profile documents of a sample of the operations, recorded by the sampled profiler.
+ * Unlike the profiler, which inserts into system.profile on the thread of the operation, the
+ * sampled profiler only builds the document on that thread and pushes it into a fixed-size
+ * lock-free ring. Its documents are then drained by a background thread, which keeps the most
+ * recent ones for the $sampledProfile aggregation stage and, on request, also inserts them into the
+ * system.profile collection of their database.
+ *
+ * Operations are sampled in one of two ways:
+ *  - Those which planned a query are sampled at most once per query shape of each collection
+ *    every sampledProfilerShapeIntervalMillis milliseconds, if that is positive.
+ *  - Others, or all operations if the interval is not positive, are sampled with probability
+ *    sampledProfilerSampleRate.
+ */
+class SampledProfileBuffer {
+    MONGO_DISALLOW_COPYING(SampledProfileBuffer);
+
+public:
+    /**
+     * The profile document of one sampled operation, and the database whose profile it belongs
+     * to.
+     */
+    struct Record {
+        std::string dbName;
+        BSONObj doc;
+    };
+
+    /**
+     * The number of records the ring holds before sampled operations are dropped.
+     */
+    static const size_t kRingCapacity = 4096;
+
+    SampledProfileBuffer();
+
+    static SampledProfileBuffer* get(ServiceContext* service);
+
+    /**
+     * Returns whether the operation on 'ns', with query shape 'queryShape', which is empty if the
+     * operation did not plan a query, should be sampled. Does not take any lock.
+     */
+    bool shouldSample(StringData ns, StringData queryShape, Date_t now);
+
+    /**
+     * Pushes 'record' into the ring, or drops it if the ring is full. Does not take any lock.
+     */
+    void record(Record record);
+
+    /**
+     * Moves the records in the ring to the most recent records returned by getRecent(), and
+     * returns them, oldest first.
+     */
+    std::vector<Record> drain();
+
+    /**
+     * Returns the most recent sampled profile documents of database 'dbName', oldest first, after
+     * draining the ring. At most sampledProfilerRetainedRecords records are kept.
+     */
+    std::vector<BSONObj> getRecent(StringData dbName);
+
+    /**
+     * Returns the number of records dropped because the ring was full.
+     */
+    long long getDroppedCount() const {
+        return _dropped.loadRelaxed();
+    }
+
+private:
+    /**
+     * A slot of the ring. Its sequence is the position in the ring which may next be written to it,
+     * or one more than the position which may next be read from it.
+     */
+    struct Slot {
+        AtomicUInt64 sequence;
+        Record record;
+    };
+
+    static const size_t kNumShapeSlots = 1024;
+
+    bool _pop(Record* record);
+
+    std::unique_ptr<Slot[]> _ring;
+    AtomicUInt64 _pushPosition;
+    AtomicUInt64 _popPosition;
+    AtomicInt64 _dropped;
+
+    // The time in milliseconds at which a query shape hashing to each slot was last sampled.
+    std::array<AtomicInt64, kNumShapeSlots> _shapeLastSampledMillis;
+
+    // Used to draw the random number of each operation sampled by rate.
+    AtomicUInt64 _sampleCount;
+
+    stdx::mutex _recentMutex;
+    std::deque<Record> _recent;
+};
+
+}  // namespace mongo
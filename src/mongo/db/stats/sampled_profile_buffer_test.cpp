@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/stats/sampled_profile_buffer.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Restores the sampled profiler knobs changed by a test.
+ */
+class SampledProfileBufferTest : public unittest::Test {
+protected:
+    void tearDown() override {
+        sampledProfilerSampleRate.store(0.0);
+        sampledProfilerShapeIntervalMillis.store(0);
+        sampledProfilerRetainedRecords.store(1000);
+    }
+
+    SampledProfileBuffer buffer;
+};
+
+SampledProfileBuffer::Record makeRecord(std::string dbName, int i) {
+    return {std::move(dbName), BSON("i" << i)};
+}
+
+TEST_F(SampledProfileBufferTest, NothingIsSampledByDefault) {
+    const Date_t now = Date_t::fromMillisSinceEpoch(100000);
+    ASSERT_FALSE(buffer.shouldSample("test.coll", "", now));
+    ASSERT_FALSE(buffer.shouldSample("test.coll", "an[eqa]", now));
+}
+
+TEST_F(SampledProfileBufferTest, SampleRateIsApproximatelyHonored) {
+    sampledProfilerSampleRate.store(0.25);
+    const Date_t now = Date_t::fromMillisSinceEpoch(100000);
+    int sampled = 0;
+    for (int i = 0; i < 10000; ++i) {
+        if (buffer.shouldSample("test.coll", "", now)) {
+            ++sampled;
+        }
+    }
+    ASSERT_GREATER_THAN(sampled, 2000);
+    ASSERT_LESS_THAN(sampled, 3000);
+}
+
+TEST_F(SampledProfileBufferTest, QueryShapeIsSampledOncePerInterval) {
+    sampledProfilerShapeIntervalMillis.store(1000);
+    const Date_t now = Date_t::fromMillisSinceEpoch(100000);
+    ASSERT_TRUE(buffer.shouldSample("test.coll", "an[eqa]", now));
+    ASSERT_FALSE(buffer.shouldSample("test.coll", "an[eqa]", now + Milliseconds(999)));
+    ASSERT_TRUE(buffer.shouldSample("test.coll", "an[eqa]", now + Milliseconds(1000)));
+
+    // Operations without a query shape fall back to the sample rate, which is 0.
+    ASSERT_FALSE(buffer.shouldSample("test.coll", "", now + Milliseconds(5000)));
+}
+
+TEST_F(SampledProfileBufferTest, DrainReturnsRecordsInOrder) {
+    for (int i = 0; i < 3; ++i) {
+        buffer.record(makeRecord("test", i));
+    }
+
+    auto records = buffer.drain();
+    ASSERT_EQUALS(3U, records.size());
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_EQUALS("test", records[i].dbName);
+        ASSERT_EQUALS(i, records[i].doc["i"].numberInt());
+    }
+    ASSERT_TRUE(buffer.drain().empty());
+}
+
+TEST_F(SampledProfileBufferTest, FullRingDropsRecords) {
+    for (size_t i = 0; i < SampledProfileBuffer::kRingCapacity + 2; ++i) {
+        buffer.record(makeRecord("test", static_cast<int>(i)));
+    }
+    ASSERT_EQUALS(2, buffer.getDroppedCount());
+    ASSERT_EQUALS(SampledProfileBuffer::kRingCapacity, buffer.drain().size());
+
+    // The ring is usable again once drained.
+    buffer.record(makeRecord("test", 0));
+    ASSERT_EQUALS(1U, buffer.drain().size());
+}
+
+TEST_F(SampledProfileBufferTest, GetRecentKeepsTheMostRecentRecordsOfTheDatabase) {
+    sampledProfilerRetainedRecords.store(3);
+    buffer.record(makeRecord("test", 0));
+    buffer.record(makeRecord("other", 1));
+    buffer.drain();
+    buffer.record(makeRecord("test", 2));
+    buffer.record(makeRecord("test", 3));
+
+    auto docs = buffer.getRecent("test");
+    ASSERT_EQUALS(2U, docs.size());
+    ASSERT_EQUALS(2, docs[0]["i"].numberInt());
+    ASSERT_EQUALS(3, docs[1]["i"].numberInt());
+
+    ASSERT_EQUALS(1U, buffer.getRecent("other").size());
+}
+
+}  // namespace
+}  // namespace mongo
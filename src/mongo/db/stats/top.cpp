@@ -35,7 +35,10 @@
 
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/threadlocal.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -49,8 +52,23 @@ namespace {
 
 const auto getTop = ServiceContext::declareDecoration<Top>();
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryShapeLatencyStatsMaxShapes, int, 100);
+
+// One more than the index of the global histogram shard of this thread, or 0 until it is chosen.
+MONGO_TRIVIALLY_CONSTRUCTIBLE_THREAD_LOCAL size_t globalHistogramShardPlusOne;
+
+AtomicUInt32 nextGlobalHistogramShard;
+
+bool isLatencyTracked(OperationContext* txn) {
+    // Only update histograms if the operation came from a user.
+    Client* client = txn->getClient();
+    return client->isFromUserConnection() && !client->isInDirectClient();
+}
+
 }  // namespace
 
+const size_t Top::kNumGlobalHistogramShards;
+
 Top::UsageData::UsageData(const UsageData& older, const UsageData& newer) {
     // this won't be 100% accurate on rollovers and drop(), but at least it won't be negative
     time = (newer.time >= older.time) ? (newer.time - older.time) : newer.time;
@@ -143,9 +161,14 @@ void Top::_record(OperationContext* txn,
 }
 
 void Top::collectionDropped(StringData ns) {
-    stdx::lock_guard<SimpleMutex> lk(_lock);
-    _usage.erase(ns);
-    _lastDropped = ns.toString();
+    {
+        stdx::lock_guard<SimpleMutex> lk(_lock);
+        _usage.erase(ns);
+        _lastDropped = ns.toString();
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_queryShapeMutex);
+    _queryShapes.erase(ns);
 }
 
 void Top::cloneMap(Top::UsageMap& out) const {
@@ -196,33 +219,101 @@ void Top::_appendStatsEntry(BSONObjBuilder& b, const char* statsName, const Usag
     bb.done();
 }
 
-void Top::appendLatencyStats(StringData ns, BSONObjBuilder* builder) {
+void Top::appendLatencyStats(StringData ns, bool includeQueryShapes, BSONObjBuilder* builder) {
     auto hashedNs = UsageMap::HashedKey(ns);
-    stdx::lock_guard<SimpleMutex> lk(_lock);
     BSONObjBuilder latencyStatsBuilder;
-    _usage[hashedNs].opLatencyHistogram.append(&latencyStatsBuilder);
+    {
+        stdx::lock_guard<SimpleMutex> lk(_lock);
+        _usage[hashedNs].opLatencyHistogram.append(&latencyStatsBuilder);
+    }
+
+    if (includeQueryShapes) {
+        BSONArrayBuilder shapesBuilder(latencyStatsBuilder.subarrayStart("queryShapes"));
+        stdx::lock_guard<stdx::mutex> lk(_queryShapeMutex);
+        auto it = _queryShapes.find(ns);
+        if (it != _queryShapes.end()) {
+            for (auto&& shape : it->second) {
+                BSONObjBuilder shapeBuilder(shapesBuilder.subobjStart());
+                shapeBuilder.append("queryShape", shape.first);
+                shape.second->append(&shapeBuilder);
+            }
+        }
+    }
     builder->append("latencyStats", latencyStatsBuilder.obj());
 }
 
 void Top::incrementGlobalLatencyStats(OperationContext* txn,
                                       uint64_t latency,
                                       Command::ReadWriteType readWriteType) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _incrementHistogram(txn, latency, &_globalHistogramStats, readWriteType);
+    if (!isLatencyTracked(txn)) {
+        return;
+    }
+
+    if (globalHistogramShardPlusOne == 0) {
+        globalHistogramShardPlusOne =
+            nextGlobalHistogramShard.fetchAndAdd(1) % kNumGlobalHistogramShards + 1;
+    }
+    _globalHistogramShards[globalHistogramShardPlusOne - 1].increment(latency, readWriteType);
 }
 
 void Top::appendGlobalLatencyStats(BSONObjBuilder* builder) {
-    stdx::lock_guard<SimpleMutex> guard(_lock);
-    _globalHistogramStats.append(builder);
+    OperationLatencyHistogram total;
+    for (const auto& shard : _globalHistogramShards) {
+        total += shard;
+    }
+    total.append(builder);
+}
+
+void Top::incrementQueryShapeLatencyStats(OperationContext* txn,
+                                          StringData ns,
+                                          StringData queryShape,
+                                          uint64_t latency,
+                                          Command::ReadWriteType readWriteType) {
+    if (!isLatencyTracked(txn)) {
+        return;
+    }
+
+    std::shared_ptr<OperationLatencyHistogram> histogram;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_queryShapeMutex);
+        auto& shapes = _queryShapes[ns];
+        auto it = shapes.find(queryShape.toString());
+        if (it != shapes.end()) {
+            histogram = it->second;
+        } else if (shapes.size() <
+                   static_cast<size_t>(internalQueryShapeLatencyStatsMaxShapes.load())) {
+            histogram = std::make_shared<OperationLatencyHistogram>();
+            shapes.emplace(queryShape.toString(), histogram);
+        } else {
+            return;
+        }
+    }
+    histogram->increment(latency, readWriteType);
+}
+
+void Top::appendQueryShapeLatencyStats(BSONObjBuilder* builder) {
+    stdx::lock_guard<stdx::mutex> lk(_queryShapeMutex);
+    std::vector<std::string> names;
+    for (auto&& ns : _queryShapes) {
+        names.push_back(ns.first);
+    }
+    std::sort(names.begin(), names.end());
+
+    for (const auto& name : names) {
+        BSONArrayBuilder shapesBuilder(builder->subarrayStart(name));
+        for (auto&& shape : _queryShapes.find(name)->second) {
+            BSONObjBuilder shapeBuilder(shapesBuilder.subobjStart());
+            shapeBuilder.append("queryShape", shape.first);
+            shape.second->append(&shapeBuilder);
+        }
+    }
 }
 
 void Top::_incrementHistogram(OperationContext* txn,
                               long long latency,
                               OperationLatencyHistogram* histogram,
                               Command::ReadWriteType readWriteType) {
-    // Only update histogram if operation came from a user.
-    Client* client = txn->getClient();
-    if (client->isFromUserConnection() && !client->isInDirectClient()) {
+    if (isLatencyTracked(txn)) {
         histogram->increment(latency, readWriteType);
     }
 }
@@ -29,11 +29,15 @@
 
 #pragma once
 
+#include <array>
 #include <boost/date_time/posix_time/posix_time.hpp>
+#include <map>
+#include <memory>
 
 #include "mongo/db/commands.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/stats/operation_latency_histogram.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/string_map.h"
@@ -102,12 +106,13 @@ public:
     void collectionDropped(StringData ns);
 
     /**
-     * Appends the collection-level latency statistics
+     * Appends the collection-level latency statistics, and those of each query shape of the
+     * collection if 'includeQueryShapes' is true.
      */
-    void appendLatencyStats(StringData ns, BSONObjBuilder* builder);
+    void appendLatencyStats(StringData ns, bool includeQueryShapes, BSONObjBuilder* builder);
 
     /**
-     * Increments the global histogram.
+     * Increments the global histogram. Does not take the Top lock.
      */
     void incrementGlobalLatencyStats(OperationContext* txn,
                                      uint64_t latency,
@@ -118,6 +123,22 @@ public:
      */
     void appendGlobalLatencyStats(BSONObjBuilder* builder);
 
+    /**
+     * Increments the histogram of the query shape 'queryShape', a PlanCacheKey, of collection
+     * 'ns'. Once a collection has internalQueryShapeLatencyStatsMaxShapes shapes, the latencies of
+     * its other shapes are not recorded. Does not take the Top lock.
+     */
+    void incrementQueryShapeLatencyStats(OperationContext* txn,
+                                         StringData ns,
+                                         StringData queryShape,
+                                         uint64_t latency,
+                                         Command::ReadWriteType readWriteType);
+
+    /**
+     * Appends the latency statistics of every query shape of every collection.
+     */
+    void appendQueryShapeLatencyStats(BSONObjBuilder* builder);
+
 private:
     void _appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const;
 
@@ -135,10 +156,24 @@ private:
                              OperationLatencyHistogram* histogram,
                              Command::ReadWriteType readWriteType);
 
+    using QueryShapeMap = std::map<std::string, std::shared_ptr<OperationLatencyHistogram>>;
+
+    void _appendQueryShapes(const QueryShapeMap& shapes, BSONObjBuilder* builder) const;
+
+    /**
+     * The number of copies of the global histogram. Each thread increments one of them, so that
+     * threads recording latencies at the same time rarely touch the same counters.
+     */
+    static const size_t kNumGlobalHistogramShards = 16;
+
     mutable SimpleMutex _lock;
-    OperationLatencyHistogram _globalHistogramStats;
+    std::array<OperationLatencyHistogram, kNumGlobalHistogramShards> _globalHistogramShards;
     UsageMap _usage;
     std::string _lastDropped;
+
+    // Guards the map, but not the histograms it holds, which are incremented after it is released.
+    mutable stdx::mutex _queryShapeMutex;
+    StringMap<QueryShapeMap> _queryShapes;
 };
 
 }  // namespace mongo
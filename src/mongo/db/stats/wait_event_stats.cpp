@@ -0,0 +1,124 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/wait_event_stats.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getWaitEventStats = OperationContext::declareDecoration<WaitEventStats>();
+
+WaitEventStats globalWaitEventStats;
+
+}  // namespace
+
+StringData waitEventName(WaitEvent event) {
+    switch (event) {
+        case WaitEvent::kTicketAcquisition:
+            return "ticketAcquisition";
+        case WaitEvent::kJournalFlush:
+            return "journalFlush";
+        case WaitEvent::kReplicationWriteConcern:
+            return "replicationWriteConcern";
+        case WaitEvent::kRemoteCommand:
+            return "remoteCommand";
+        case WaitEvent::kNumWaitEvents:
+            break;
+    }
+    MONGO_UNREACHABLE;
+}
+
+WaitEventStats& WaitEventStats::get(OperationContext* txn) {
+    return getWaitEventStats(txn);
+}
+
+const WaitEventStats& WaitEventStats::get(const OperationContext* txn) {
+    return getWaitEventStats(txn);
+}
+
+WaitEventStats& WaitEventStats::getGlobal() {
+    return globalWaitEventStats;
+}
+
+void WaitEventStats::record(WaitEvent event, Microseconds elapsed) {
+    auto& counters = _counters[static_cast<size_t>(event)];
+    counters.count.fetchAndAdd(1);
+    counters.micros.fetchAndAdd(durationCount<Microseconds>(elapsed));
+}
+
+void WaitEventStats::append(BSONObjBuilder* builder, bool includeZeros) const {
+    for (size_t i = 0; i < _counters.size(); ++i) {
+        const long long count = _counters[i].count.load();
+        if (count == 0 && !includeZeros) {
+            continue;
+        }
+
+        BSONObjBuilder eventBuilder(builder->subobjStart(waitEventName(static_cast<WaitEvent>(i))));
+        eventBuilder.append("count", count);
+        eventBuilder.append("timeMicros", static_cast<long long>(_counters[i].micros.load()));
+    }
+}
+
+bool WaitEventStats::empty() const {
+    for (const auto& counters : _counters) {
+        if (counters.count.load() != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+ScopedWaitEvent::~ScopedWaitEvent() {
+    const auto elapsed = _timer.elapsed();
+    if (_txn) {
+        WaitEventStats::get(_txn).record(_event, elapsed);
+    }
+    globalWaitEventStats.record(_event, elapsed);
+}
+
+/**
+ * Appends the global wait event stats to the server status.
+ */
+class WaitEventsServerStatusMetric : public ServerStatusMetric {
+public:
+    WaitEventsServerStatusMetric() : ServerStatusMetric(".metrics.waitEvents") {}
+    virtual void appendAtLeaf(BSONObjBuilder& builder) const {
+        BSONObjBuilder waitEventsBuilder(builder.subobjStart("waitEvents"));
+        globalWaitEventStats.append(&waitEventsBuilder, true);
+    }
+} waitEventsServerStatusMetric;
+
+}  // namespace mongo
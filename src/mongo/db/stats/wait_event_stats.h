@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class OperationContext;
+
+/**
+ * The points at which an operation can block on something other than a lock. Time waiting for
+ * locks is already accounted for by LockStats.
+ */
+enum class WaitEvent {
+    kTicketAcquisition,
+    kJournalFlush,
+    kReplicationWriteConcern,
+    kRemoteCommand,
+    kNumWaitEvents,
+};
+
+/**
+ * Returns the name used to report 'event', e.g. "ticketAcquisition".
+ */
+StringData waitEventName(WaitEvent event);
+
+/**
+ * Number of waits and total time waited, per wait event. There is one instance per operation,
+ * reported in currentOp, the slow operation log and the profiler, and one for the whole process,
+ * reported in serverStatus under metrics.waitEvents.
+ *
+ * The counters are atomic so that currentOp can read them while the operation is running.
+ */
+class WaitEventStats {
+    MONGO_DISALLOW_COPYING(WaitEventStats);
+
+public:
+    WaitEventStats() = default;
+
+    /**
+     * The stats of the operation 'txn'.
+     */
+    static WaitEventStats& get(OperationContext* txn);
+    static const WaitEventStats& get(const OperationContext* txn);
+
+    /**
+     * The stats aggregated over all operations of the process.
+     */
+    static WaitEventStats& getGlobal();
+
+    void record(WaitEvent event, Microseconds elapsed);
+
+    /**
+     * Appends {<event>: {count: <n>, timeMicros: <n>}, ...} to 'builder' for each event which
+     * occurred at least once, or for every event if 'includeZeros' is true.
+     */
+    void append(BSONObjBuilder* builder, bool includeZeros = false) const;
+
+    bool empty() const;
+
+private:
+    struct Counters {
+        AtomicInt64 count;
+        AtomicInt64 micros;
+    };
+
+    std::array<Counters, static_cast<size_t>(WaitEvent::kNumWaitEvents)> _counters;
+};
+
+/**
+ * Accounts the time between its construction and destruction as a wait on 'event', in the stats
+ * of the operation 'txn' and in the global stats. 'txn' may be null when the waiting thread has no
+ * operation, in which case only the global stats are updated.
+ *
+ * Usage:
+ *     {
+ *         ScopedWaitEvent wait(txn, WaitEvent::kJournalFlush);
+ *         txn->recoveryUnit()->waitUntilDurable();
+ *     }
+ */
+class ScopedWaitEvent {
+    MONGO_DISALLOW_COPYING(ScopedWaitEvent);
+
+public:
+    ScopedWaitEvent(OperationContext* txn, WaitEvent event) : _txn(txn), _event(event) {}
+
+    ~ScopedWaitEvent();
+
+private:
+    OperationContext* const _txn;
+    const WaitEvent _event;
+    const Timer _timer;
+};
+
+}  // namespace mongo
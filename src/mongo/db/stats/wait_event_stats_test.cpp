@@ -0,0 +1,80 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/stats/wait_event_stats.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(WaitEventStatsTest, OnlyEventsWhichOccurredAreAppended) {
+    WaitEventStats stats;
+    ASSERT_TRUE(stats.empty());
+
+    stats.record(WaitEvent::kJournalFlush, Microseconds(10));
+    stats.record(WaitEvent::kJournalFlush, Microseconds(15));
+    stats.record(WaitEvent::kTicketAcquisition, Microseconds(3));
+    ASSERT_FALSE(stats.empty());
+
+    BSONObjBuilder builder;
+    stats.append(&builder);
+    ASSERT_EQUALS(BSON("ticketAcquisition" << BSON("count" << 1LL << "timeMicros" << 3LL)
+                                           << "journalFlush"
+                                           << BSON("count" << 2LL << "timeMicros" << 25LL)),
+                  builder.obj());
+}
+
+TEST(WaitEventStatsTest, IncludeZerosAppendsEveryEvent) {
+    WaitEventStats stats;
+    BSONObjBuilder builder;
+    stats.append(&builder, true);
+    const BSONObj obj = builder.obj();
+    ASSERT_EQ(obj.nFields(), static_cast<int>(WaitEvent::kNumWaitEvents));
+    for (int i = 0; i < static_cast<int>(WaitEvent::kNumWaitEvents); ++i) {
+        const BSONObj event = obj[waitEventName(static_cast<WaitEvent>(i))].Obj();
+        ASSERT_EQ(event["count"].numberLong(), 0);
+    }
+}
+
+TEST(WaitEventStatsTest, ScopedWaitEventWithoutOperationRecordsGlobally) {
+    BSONObjBuilder before;
+    WaitEventStats::getGlobal().append(&before, true);
+    const long long countBefore = before.obj()["remoteCommand"]["count"].numberLong();
+
+    { ScopedWaitEvent wait(nullptr, WaitEvent::kRemoteCommand); }
+
+    BSONObjBuilder after;
+    WaitEventStats::getGlobal().append(&after, true);
+    ASSERT_EQ(after.obj()["remoteCommand"]["count"].numberLong(), countBefore + 1);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -30,14 +30,63 @@
 
 #include "mongo/db/storage/devnull/devnull_kv_engine.h"
 
+#include <algorithm>
+#include <cmath>
+
 #include "mongo/base/disallow_copying.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_record_store.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/sorted_data_interface.h"
+#include "mongo/platform/random.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
+MONGO_EXPORT_SERVER_PARAMETER(devnullReadLatencyMicros, int, 0);
+MONGO_EXPORT_SERVER_PARAMETER(devnullWriteLatencyMicros, int, 0);
+MONGO_EXPORT_SERVER_PARAMETER(devnullSyncLatencyMicros, int, 0);
+MONGO_EXPORT_SERVER_PARAMETER(devnullExponentialLatency, bool, false);
+
+namespace {
+
+stdx::mutex latencyRandomMutex;
+PseudoRandom latencyRandom(static_cast<int64_t>(curTimeMicros64()));
+
+/**
+ * Sleeps for a latency of mean "meanMicros" microseconds.
+ */
+void injectLatency(const std::atomic<int>& meanMicros) {  // NOLINT
+    const int mean = meanMicros.load();
+    if (mean <= 0) {
+        return;
+    }
+
+    long long micros = mean;
+    if (devnullExponentialLatency.load()) {
+        double u;
+        {
+            stdx::lock_guard<stdx::mutex> lk(latencyRandomMutex);
+            u = latencyRandom.nextCanonicalDouble();
+        }
+        // Cap the tail, so that one unlucky sample doesn't stall a benchmark.
+        micros = std::min(static_cast<long long>(-mean * std::log(1.0 - u)), 20LL * mean);
+    }
+    sleepmicros(micros);
+}
+
+class DevNullRecoveryUnit final : public RecoveryUnitNoop {
+public:
+    bool waitUntilDurable() final {
+        injectLatency(devnullSyncLatencyMicros);
+        return true;
+    }
+};
+
+}  // namespace
+
 class EmptyRecordCursor final : public SeekableRecordCursor {
 public:
     boost::optional<Record> next() final {
@@ -87,19 +136,24 @@ public:
     }
 
     virtual RecordData dataFor(OperationContext* txn, const RecordId& loc) const {
+        injectLatency(devnullReadLatencyMicros);
         return RecordData(_dummy.objdata(), _dummy.objsize());
     }
 
     virtual bool findRecord(OperationContext* txn, const RecordId& loc, RecordData* rd) const {
+        injectLatency(devnullReadLatencyMicros);
         return false;
     }
 
-    virtual void deleteRecord(OperationContext* txn, const RecordId& dl) {}
+    virtual void deleteRecord(OperationContext* txn, const RecordId& dl) {
+        injectLatency(devnullWriteLatencyMicros);
+    }
 
     virtual StatusWith<RecordId> insertRecord(OperationContext* txn,
                                               const char* data,
                                               int len,
                                               bool enforceQuota) {
+        injectLatency(devnullWriteLatencyMicros);
         _numInserts++;
         return StatusWith<RecordId>(RecordId(6, 4));
     }
@@ -108,6 +162,7 @@ public:
                                               const DocWriter* const* docs,
                                               size_t nDocs,
                                               RecordId* idsOut) {
+        injectLatency(devnullWriteLatencyMicros);
         _numInserts += nDocs;
         if (idsOut) {
             for (size_t i = 0; i < nDocs; i++) {
@@ -123,6 +178,7 @@ public:
                                 int len,
                                 bool enforceQuota,
                                 UpdateNotifier* notifier) {
+        injectLatency(devnullWriteLatencyMicros);
         return Status::OK();
     }
 
@@ -141,6 +197,7 @@ public:
 
     std::unique_ptr<SeekableRecordCursor> getCursor(OperationContext* txn,
                                                     bool forward) const final {
+        injectLatency(devnullReadLatencyMicros);
         return stdx::make_unique<EmptyRecordCursor>();
     }
 
@@ -201,13 +258,16 @@ public:
                           const BSONObj& key,
                           const RecordId& loc,
                           bool dupsAllowed) {
+        injectLatency(devnullWriteLatencyMicros);
         return Status::OK();
     }
 
     virtual void unindex(OperationContext* txn,
                          const BSONObj& key,
                          const RecordId& loc,
-                         bool dupsAllowed) {}
+                         bool dupsAllowed) {
+        injectLatency(devnullWriteLatencyMicros);
+    }
 
     virtual Status dupKeyCheck(OperationContext* txn, const BSONObj& key, const RecordId& loc) {
         return Status::OK();
@@ -233,6 +293,7 @@ public:
 
     virtual std::unique_ptr<SortedDataInterface::Cursor> newCursor(OperationContext* txn,
                                                                    bool isForward) const {
+        injectLatency(devnullReadLatencyMicros);
         return {};
     }
 
@@ -241,6 +302,17 @@ public:
     }
 };
 
+RecoveryUnit* DevNullKVEngine::newRecoveryUnit() {
+    return new DevNullRecoveryUnit();
+}
+
+int DevNullKVEngine::flushAllFiles(bool sync) {
+    // devnull isn't durable, so fsync write concerns flush the files rather than the journal.
+    if (sync) {
+        injectLatency(devnullSyncLatencyMicros);
+    }
+    return 0;
+}
 
 RecordStore* DevNullKVEngine::getRecordStore(OperationContext* opCtx,
                                              StringData ns,
@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include <atomic>
 
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/recovery_unit_noop.h"
@@ -38,13 +39,27 @@ namespace mongo {
 
 class JournalListener;
 
+/**
+ * Mean latencies devnull adds to each record or index read, each write, and each wait for
+ * durability, to model slower storage. Zero adds none.
+ */
+extern std::atomic<int> devnullReadLatencyMicros;   // NOLINT
+extern std::atomic<int> devnullWriteLatencyMicros;  // NOLINT
+extern std::atomic<int> devnullSyncLatencyMicros;   // NOLINT
+
+/**
+ * Whether the latencies are exponentially distributed around their means, for a long tail like
+ * that of a disk, instead of constant.
+ */
+extern std::atomic<bool> devnullExponentialLatency;  // NOLINT
+
 class DevNullKVEngine : public KVEngine {
 public:
     virtual ~DevNullKVEngine() {}
 
-    virtual RecoveryUnit* newRecoveryUnit() {
-        return new RecoveryUnitNoop();
-    }
+    virtual RecoveryUnit* newRecoveryUnit();
+
+    virtual int flushAllFiles(bool sync);
 
     virtual Status createRecordStore(OperationContext* opCtx,
                                      StringData ns,
@@ -37,8 +37,10 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/recovery_unit.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -48,6 +50,40 @@ namespace mongo {
 
 using std::shared_ptr;
 
+namespace {
+
+// The size of the records of all record stores, for the memory limit.
+AtomicInt64 totalDataSizeBytes;
+
+}  // namespace
+
+// The most bytes of records all the record stores may hold together. Writes which would grow them
+// past it fail with ExceededMemoryLimit, unless they are to capped collections, which limit their
+// own size. Zero means no limit.
+MONGO_EXPORT_SERVER_PARAMETER(ephemeralForTestMaxDataSizeBytes, long long, 0);
+
+void EphemeralForTestRecordStore::Data::addDataSize(int64_t delta) {
+    dataSize += delta;
+    totalDataSizeBytes.fetchAndAdd(delta);
+}
+
+int64_t EphemeralForTestRecordStore::totalDataSize() {
+    return totalDataSizeBytes.load();
+}
+
+Status EphemeralForTestRecordStore::checkMemoryLimit(int64_t growth) const {
+    const long long limit = ephemeralForTestMaxDataSizeBytes.load();
+    if (_isCapped || limit <= 0 || growth <= 0 || totalDataSizeBytes.load() + growth <= limit) {
+        return Status::OK();
+    }
+
+    return Status(ErrorCodes::ExceededMemoryLimit,
+                  str::stream() << "writing " << growth << " more bytes to " << ns()
+                                << " would exceed ephemeralForTestMaxDataSizeBytes ("
+                                << limit
+                                << ")");
+}
+
 class EphemeralForTestRecordStore::InsertChange : public RecoveryUnit::Change {
 public:
     InsertChange(Data* data, RecordId loc) : _data(data), _loc(loc) {}
@@ -55,7 +91,7 @@ public:
     virtual void rollback() {
         Records::iterator it = _data->records.find(_loc);
         if (it != _data->records.end()) {
-            _data->dataSize -= it->second.size;
+            _data->addDataSize(-it->second.size);
             _data->records.erase(it);
         }
     }
@@ -75,10 +111,10 @@ public:
     virtual void rollback() {
         Records::iterator it = _data->records.find(_loc);
         if (it != _data->records.end()) {
-            _data->dataSize -= it->second.size;
+            _data->addDataSize(-it->second.size);
         }
 
-        _data->dataSize += _rec.size;
+        _data->addDataSize(_rec.size);
         _data->records[_loc] = _rec;
     }
 
@@ -90,16 +126,16 @@ private:
 
 class EphemeralForTestRecordStore::TruncateChange : public RecoveryUnit::Change {
 public:
-    TruncateChange(Data* data) : _data(data), _dataSize(0) {
+    TruncateChange(Data* data) : _data(data), _dataSize(data->dataSize) {
         using std::swap;
-        swap(_dataSize, _data->dataSize);
+        _data->addDataSize(-_dataSize);
         swap(_records, _data->records);
     }
 
     virtual void commit() {}
     virtual void rollback() {
         using std::swap;
-        swap(_dataSize, _data->dataSize);
+        _data->addDataSize(_dataSize - _data->dataSize);
         swap(_records, _data->records);
     }
 
@@ -322,7 +358,7 @@ bool EphemeralForTestRecordStore::findRecord(OperationContext* txn,
 void EphemeralForTestRecordStore::deleteRecord(OperationContext* txn, const RecordId& loc) {
     EphemeralForTestRecord* rec = recordFor(loc);
     txn->recoveryUnit()->registerChange(new RemoveChange(_data, loc, *rec));
-    _data->dataSize -= rec->size;
+    _data->addDataSize(-rec->size);
     invariant(_data->records.erase(loc) == 1);
 }
 
@@ -376,6 +412,10 @@ StatusWith<RecordId> EphemeralForTestRecordStore::insertRecord(OperationContext*
         return StatusWith<RecordId>(ErrorCodes::BadValue, "object to insert exceeds cappedMaxSize");
     }
 
+    Status limitStatus = checkMemoryLimit(len);
+    if (!limitStatus.isOK())
+        return limitStatus;
+
     EphemeralForTestRecord rec(len);
     memcpy(rec.data.get(), data, len);
 
@@ -390,7 +430,7 @@ StatusWith<RecordId> EphemeralForTestRecordStore::insertRecord(OperationContext*
     }
 
     txn->recoveryUnit()->registerChange(new InsertChange(_data, loc));
-    _data->dataSize += len;
+    _data->addDataSize(len);
     _data->records[loc] = rec;
 
     cappedDeleteAsNeeded(txn);
@@ -410,6 +450,10 @@ Status EphemeralForTestRecordStore::insertRecordsWithDocWriter(OperationContext*
             return Status(ErrorCodes::BadValue, "object to insert exceeds cappedMaxSize");
         }
 
+        Status limitStatus = checkMemoryLimit(len);
+        if (!limitStatus.isOK())
+            return limitStatus;
+
         EphemeralForTestRecord rec(len);
         docs[i]->writeDocument(rec.data.get());
 
@@ -424,7 +468,7 @@ Status EphemeralForTestRecordStore::insertRecordsWithDocWriter(OperationContext*
         }
 
         txn->recoveryUnit()->registerChange(new InsertChange(_data, loc));
-        _data->dataSize += len;
+        _data->addDataSize(len);
         _data->records[loc] = rec;
 
         cappedDeleteAsNeeded(txn);
@@ -448,6 +492,10 @@ Status EphemeralForTestRecordStore::updateRecord(OperationContext* txn,
     // Documents in capped collections cannot change size. We check that above the storage layer.
     invariant(!_isCapped || len == oldLen);
 
+    Status limitStatus = checkMemoryLimit(len - oldLen);
+    if (!limitStatus.isOK())
+        return limitStatus;
+
     if (notifier) {
         // The in-memory KV engine uses the invalidation framework (does not support
         // doc-locking), and therefore must notify that it is updating a document.
@@ -461,7 +509,7 @@ Status EphemeralForTestRecordStore::updateRecord(OperationContext* txn,
     memcpy(newRecord.data.get(), data, len);
 
     txn->recoveryUnit()->registerChange(new RemoveChange(_data, loc, *oldRecord));
-    _data->dataSize += len - oldLen;
+    _data->addDataSize(len - oldLen);
     *oldRecord = newRecord;
 
     cappedDeleteAsNeeded(txn);
@@ -525,7 +573,7 @@ void EphemeralForTestRecordStore::temp_cappedTruncateAfter(OperationContext* txn
         inclusive ? _data->records.lower_bound(end) : _data->records.upper_bound(end);
     while (it != _data->records.end()) {
         txn->recoveryUnit()->registerChange(new RemoveChange(_data, it->first, it->second));
-        _data->dataSize -= it->second.size;
+        _data->addDataSize(-it->second.size);
         _data->records.erase(it++);
     }
 }
@@ -125,7 +125,7 @@ public:
                                         long long numRecords,
                                         long long dataSize) {
         invariant(_data->records.size() == size_t(numRecords));
-        _data->dataSize = dataSize;
+        _data->addDataSize(dataSize - _data->dataSize);
     }
 
 protected:
@@ -166,6 +166,12 @@ public:
         return _cappedMaxSize;
     }
 
+    /**
+     * Returns the size of the records of all the record stores, which the
+     * ephemeralForTestMaxDataSizeBytes server parameter limits.
+     */
+    static int64_t totalDataSize();
+
 private:
     class InsertChange;
     class RemoveChange;
@@ -176,6 +182,12 @@ private:
 
     StatusWith<RecordId> extractAndCheckLocForOplog(const char* data, int len) const;
 
+    /**
+     * Returns ExceededMemoryLimit if growing this record store by 'growth' bytes would take the
+     * total size of all record stores past ephemeralForTestMaxDataSizeBytes.
+     */
+    Status checkMemoryLimit(int64_t growth) const;
+
     RecordId allocateLoc();
     bool cappedAndNeedDelete(OperationContext* txn) const;
     void cappedDeleteAsNeeded(OperationContext* txn);
@@ -189,6 +201,12 @@ private:
     // This is the "persistent" data.
     struct Data {
         Data(bool isOplog) : dataSize(0), nextId(1), isOplog(isOplog) {}
+        ~Data() {
+            addDataSize(-dataSize);
+        }
+
+        // Changes dataSize, and the total size of all record stores along with it.
+        void addDataSize(int64_t delta);
 
         int64_t dataSize;
         Records records;
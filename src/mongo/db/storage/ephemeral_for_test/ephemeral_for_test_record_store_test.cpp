@@ -32,9 +32,11 @@
 
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_record_store.h"
 
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/ephemeral_for_test/ephemeral_for_test_recovery_unit.h"
 #include "mongo/db/storage/record_store_test_harness.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -65,4 +67,44 @@ public:
 std::unique_ptr<HarnessHelper> newHarnessHelper() {
     return stdx::make_unique<EphemeralForTestHarnessHelper>();
 }
+
+TEST(EphemeralForTestRecordStoreTest, WritesPastMemoryLimitFail) {
+    EphemeralForTestHarnessHelper harnessHelper;
+    std::unique_ptr<RecordStore> rs(harnessHelper.newNonCappedRecordStore());
+    auto opCtx = harnessHelper.newOperationContext();
+
+    const std::string data(100, 'x');
+    const int64_t startSize = EphemeralForTestRecordStore::totalDataSize();
+    ServerParameter* maxDataSize =
+        ServerParameterSet::getGlobal()->getMap().find("ephemeralForTestMaxDataSizeBytes")->second;
+    ASSERT_OK(maxDataSize->setFromString(std::to_string(startSize + 150)));
+    ON_BLOCK_EXIT([maxDataSize] { maxDataSize->setFromString("0"); });
+
+    RecordId loc;
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        StatusWith<RecordId> res =
+            rs->insertRecord(opCtx.get(), data.c_str(), data.size() + 1, false);
+        ASSERT_OK(res.getStatus());
+        loc = res.getValue();
+        uow.commit();
+    }
+    ASSERT_EQUALS(startSize + 101, EphemeralForTestRecordStore::totalDataSize());
+
+    {
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_EQUALS(ErrorCodes::ExceededMemoryLimit,
+                      rs->insertRecord(opCtx.get(), data.c_str(), data.size() + 1, false)
+                          .getStatus());
+
+        // Updates which don't grow the record aren't limited.
+        ASSERT_OK(rs->updateRecord(opCtx.get(), loc, data.c_str(), 50, false, nullptr));
+        uow.commit();
+    }
+    ASSERT_EQUALS(startSize + 50, EphemeralForTestRecordStore::totalDataSize());
+
+    rs.reset();
+    harnessHelper.data.reset();
+    ASSERT_EQUALS(startSize, EphemeralForTestRecordStore::totalDataSize());
+}
 }
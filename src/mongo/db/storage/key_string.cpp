@@ -229,10 +229,24 @@ const uint8_t kGreater = 254;
 
 // some utility functions
 namespace {
+/**
+ * Copies 'bytes' bytes from 'src' to 'dst', inverting every bit. 'dst' may equal 'src'.
+ *
+ * Works a word at a time, which the compiler can turn into vector instructions, since descending
+ * index fields and inverted string decoding run every byte they touch through here.
+ */
 void memcpy_flipBits(void* dst, const void* src, size_t bytes) {
     const char* input = static_cast<const char*>(src);
     char* output = static_cast<char*>(dst);
     const char* const end = input + bytes;
+    while (end - input >= static_cast<std::ptrdiff_t>(sizeof(uint64_t))) {
+        uint64_t word;
+        memcpy(&word, input, sizeof(word));
+        word = ~word;
+        memcpy(output, &word, sizeof(word));
+        input += sizeof(word);
+        output += sizeof(word);
+    }
     while (input != end) {
         *output++ = ~(*input++);
     }
@@ -284,10 +298,8 @@ string readInvertedCString(BufReader* reader) {
     const char* end = static_cast<const char*>(memchr(start, 0xFF, reader->remaining()));
     invariant(end);
     size_t actualBytes = end - start;
-    string s(start, actualBytes);
-    for (size_t i = 0; i < s.size(); i++) {
-        s[i] = ~s[i];
-    }
+    string s(actualBytes, '\0');
+    memcpy_flipBits(&s[0], start, actualBytes);
     reader->skip(1 + actualBytes);
     return s;
 }
@@ -314,9 +326,7 @@ string readInvertedCStringWithNuls(BufReader* reader) {
         reader->skip(1 + actualBytes);
     } while (reader->peek<unsigned char>() == 0x00);
 
-    for (size_t i = 0; i < out.size(); i++) {
-        out[i] = ~out[i];
-    }
+    memcpy_flipBits(&out[0], out.data(), out.size());
 
     return out;
 }
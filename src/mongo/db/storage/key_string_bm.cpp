@@ -0,0 +1,98 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/storage/key_string.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+const Ordering kAllAscending = Ordering::make(BSONObj());
+
+const std::string kStringComponent = "key string benchmark value";
+
+BSONObj makeKey(int i) {
+    return BSON("" << i << "" << kStringComponent << "" << static_cast<double>(i) / 3);
+}
+
+MONGO_BENCHMARK(KeyStringEncodeV1) {
+    const BSONObj key = makeKey(12345);
+    while (state.keepRunning()) {
+        KeyString ks(KeyString::Version::V1, key, kAllAscending, RecordId(1));
+        benchmark::doNotOptimizeAway(ks);
+    }
+}
+
+MONGO_BENCHMARK(KeyStringEncodeReuseV1) {
+    const BSONObj key = makeKey(12345);
+    KeyString ks(KeyString::Version::V1);
+    while (state.keepRunning()) {
+        ks.resetToKey(key, kAllAscending, RecordId(1));
+        benchmark::doNotOptimizeAway(ks);
+    }
+}
+
+MONGO_BENCHMARK(KeyStringEncodeDecimalV1) {
+    // A price, whose conversion to double doesn't need the decimal library.
+    const BSONObj key = BSON("" << Decimal128("1234.56"));
+    KeyString ks(KeyString::Version::V1);
+    while (state.keepRunning()) {
+        ks.resetToKey(key, kAllAscending, RecordId(1));
+        benchmark::doNotOptimizeAway(ks);
+    }
+}
+
+MONGO_BENCHMARK(KeyStringDecodeV1) {
+    const KeyString ks(KeyString::Version::V1, makeKey(12345), kAllAscending);
+    while (state.keepRunning()) {
+        benchmark::doNotOptimizeAway(
+            KeyString::toBson(ks.getBuffer(), ks.getSize(), kAllAscending, ks.getTypeBits()));
+    }
+}
+
+MONGO_BENCHMARK(KeyStringCompareV1) {
+    const KeyString lhs(KeyString::Version::V1, makeKey(12345), kAllAscending, RecordId(1));
+    const KeyString rhs(KeyString::Version::V1, makeKey(12346), kAllAscending, RecordId(1));
+    while (state.keepRunning()) {
+        benchmark::doNotOptimizeAway(lhs.compare(rhs));
+    }
+}
+
+MONGO_BENCHMARK(BSONObjCompareForKeyStringBaseline) {
+    const BSONObj lhs = makeKey(12345);
+    const BSONObj rhs = makeKey(12346);
+    while (state.keepRunning()) {
+        benchmark::doNotOptimizeAway(lhs.woCompare(rhs, kAllAscending, false));
+    }
+}
+
+}  // namespace
+}  // namespace mongo
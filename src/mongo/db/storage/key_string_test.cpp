@@ -47,6 +47,7 @@
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/hex.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 #include "mongo/util/timer.h"
 
 using std::string;
@@ -1051,6 +1052,60 @@ void perfTest(KeyString::Version version, const Numbers& numbers) {
           << (kDebugBuild ? " (DEBUG BUILD!)" : "") << " min " << (*minmax.first)[""] << ", max"
           << (*minmax.second)[""];
 }
+
+/**
+ * Encodes and then decodes each of 'keys' once, timing the two directions separately, and logs the
+ * average size of an encoded key and of its TypeBits. Also logs the average number of leading
+ * bytes each encoded key shares with its predecessor in index order, which approximates what
+ * WiredTiger index prefix compression saves for these keys.
+ */
+void encodedSizeTest(KeyString::Version version, const std::vector<BSONObj>& keys) {
+    std::vector<std::string> encoded;
+    std::vector<KeyString::TypeBits> typeBits;
+    encoded.reserve(keys.size());
+    typeBits.reserve(keys.size());
+
+    Timer encodeTimer;
+    for (const auto& key : keys) {
+        const KeyString ks(version, key, ALL_ASCENDING);
+        encoded.emplace_back(ks.getBuffer(), ks.getSize());
+        typeBits.push_back(ks.getTypeBits());
+    }
+    const auto encodeMicros = encodeTimer.micros();
+
+    Timer decodeTimer;
+    for (size_t i = 0; i < keys.size(); i++) {
+        const BSONObj decoded =
+            KeyString::toBson(encoded[i].data(), encoded[i].size(), ALL_ASCENDING, typeBits[i]);
+        invariant(decoded.binaryEqual(keys[i]));
+    }
+    const auto decodeMicros = decodeTimer.micros();
+
+    uint64_t keyBytes = 0;
+    uint64_t typeBitsBytes = 0;
+    for (size_t i = 0; i < keys.size(); i++) {
+        keyBytes += encoded[i].size();
+        // All-zero TypeBits are not stored at all by the storage engines.
+        typeBitsBytes += typeBits[i].isAllZeros() ? 0 : typeBits[i].getSize();
+    }
+
+    std::sort(encoded.begin(), encoded.end());
+    uint64_t sharedPrefixBytes = 0;
+    for (size_t i = 1; i < encoded.size(); i++) {
+        const auto& prev = encoded[i - 1];
+        const auto& cur = encoded[i];
+        const size_t len = std::min(prev.size(), cur.size());
+        sharedPrefixBytes += std::mismatch(prev.begin(), prev.begin() + len, cur.begin()).first -
+            prev.begin();
+    }
+
+    const double n = static_cast<double>(keys.size());
+    log() << mongo::KeyString::versionToString(version) << ": " << 1E3 * encodeMicros / n
+          << " ns per encode, " << 1E3 * decodeMicros / n << " ns per decode, " << keyBytes / n
+          << " bytes per key, " << typeBitsBytes / n << " TypeBits bytes per key, "
+          << sharedPrefixBytes / n << " bytes per key shared with the previous key"
+          << (kDebugBuild ? " (DEBUG BUILD!)" : "");
+}
 }  // namespace
 
 TEST_F(KeyStringTest, CommonIntPerf) {
@@ -1064,6 +1119,7 @@ TEST_F(KeyStringTest, CommonIntPerf) {
         numbers.push_back(BSON("" << static_cast<int>(expReal(gen))));
 
     perfTest(version, numbers);
+    encodedSizeTest(version, numbers);
 }
 
 TEST_F(KeyStringTest, UniformInt64Perf) {
@@ -1145,3 +1201,22 @@ TEST_F(KeyStringTest, UniformDecimalPerf) {
     }
     perfTest(version, numbers);
 }
+
+TEST_F(KeyStringTest, CompoundStringPrefixPerf) {
+    // Compound keys of the shape {tenant, url, counter}, where the string fields share long common
+    // prefixes in index order, as is typical for multi-tenant and URL indexes.
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<int> tenantDist(0, 99);
+    std::uniform_int_distribution<int> pathDist(0, 9999);
+
+    std::vector<BSONObj> keys;
+    for (uint64_t x = 0; x < kMinPerfSamples; x++) {
+        const std::string tenant = str::stream() << "tenant-organization-" << tenantDist(gen);
+        const std::string url = str::stream() << "https://www.example.com/catalog/products/"
+                                              << pathDist(gen);
+        keys.push_back(BSON("" << tenant << "" << url << "" << static_cast<int>(x)));
+    }
+
+    encodedSizeTest(version, keys);
+}
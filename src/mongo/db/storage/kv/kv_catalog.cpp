@@ -333,9 +333,12 @@ bool KVCatalog::_hasEntryCollidingWithRand() const {
     return false;
 }
 
-std::string KVCatalog::_newUniqueIdent(StringData ns, const char* kind) {
+std::string KVCatalog::_newUniqueIdent(StringData ns, const char* kind, StringData storageTier) {
     // If this changes to not put _rand at the end, _hasEntryCollidingWithRand will need fixing.
     StringBuilder buf;
+    if (!storageTier.empty()) {
+        buf << "tiers/" << storageTier << '/';
+    }
     if (_directoryPerDb) {
         buf << NamespaceString::escapeDbName(nsToDatabaseSubstring(ns)) << '/';
     }
@@ -397,7 +400,7 @@ Status KVCatalog::newCollection(OperationContext* opCtx,
         rLk.reset(new Lock::ResourceLock(opCtx->lockState(), resourceIdCatalogMetadata, MODE_X));
     }
 
-    const string ident = _newUniqueIdent(ns, "collection");
+    const string ident = _newUniqueIdent(ns, "collection", options.storageTier);
 
     stdx::lock_guard<stdx::mutex> lk(_identsLock);
     Entry& old = _idents[ns.toString()];
@@ -515,7 +518,7 @@ void KVCatalog::putMetaData(OperationContext* opCtx,
                 continue;
             }
             // missing, create new
-            newIdentMap.append(name, _newUniqueIdent(ns, "index"));
+            newIdentMap.append(name, _newUniqueIdent(ns, "index", md.options.storageTier));
         }
         b.append("idxIdent", newIdentMap.obj());
 
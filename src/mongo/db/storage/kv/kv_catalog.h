@@ -101,7 +101,7 @@ private:
      * @param ns - the containing ns
      * @param kind - what this "thing" is, likely collection or index
      */
-    std::string _newUniqueIdent(StringData ns, const char* kind);
+    std::string _newUniqueIdent(StringData ns, const char* kind, StringData storageTier);
 
     // Helpers only used by constructor and init(). Don't call from elsewhere.
     static std::string _newRand();
@@ -37,6 +37,7 @@
 #include "mongo/db/storage/kv/kv_collection_catalog_entry.h"
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/db/storage/kv/kv_storage_engine.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/recovery_unit.h"
 
 namespace mongo {
@@ -239,24 +240,28 @@ Status KVDatabaseCatalogEntry::createCollection(OperationContext* txn,
 void KVDatabaseCatalogEntry::initCollection(OperationContext* opCtx,
                                             const std::string& ns,
                                             bool forRepair) {
-    invariant(!_collections.count(ns));
-
-    const std::string ident = _engine->getCatalog()->getCollectionIdent(ns);
-
-    RecordStore* rs;
-    if (forRepair) {
-        // Using a NULL rs since we don't want to open this record store before it has been
-        // repaired. This also ensures that if we try to use it, it will blow up.
-        rs = NULL;
-    } else {
+    std::unique_ptr<RecordStore> rs;
+    if (!forRepair) {
+        const std::string ident = _engine->getCatalog()->getCollectionIdent(ns);
         BSONCollectionCatalogEntry::MetaData md = _engine->getCatalog()->getMetaData(opCtx, ns);
-        rs = _engine->getEngine()->getRecordStore(opCtx, ns, ident, md.options);
+        rs.reset(_engine->getEngine()->getRecordStore(opCtx, ns, ident, md.options));
         invariant(rs);
     }
 
+    // Using a NULL rs for repair since we don't want to open this record store before it has
+    // been repaired. This also ensures that if we try to use it, it will blow up.
+    initCollection(ns, std::move(rs));
+}
+
+void KVDatabaseCatalogEntry::initCollection(const std::string& ns,
+                                            std::unique_ptr<RecordStore> rs) {
+    invariant(!_collections.count(ns));
+
+    const std::string ident = _engine->getCatalog()->getCollectionIdent(ns);
+
     // No change registration since this is only for committed collections
-    _collections[ns] =
-        new KVCollectionCatalogEntry(_engine->getEngine(), _engine->getCatalog(), ns, ident, rs);
+    _collections[ns] = new KVCollectionCatalogEntry(
+        _engine->getEngine(), _engine->getCatalog(), ns, ident, rs.release());
 }
 
 void KVDatabaseCatalogEntry::reinitCollectionAfterRepair(OperationContext* opCtx,
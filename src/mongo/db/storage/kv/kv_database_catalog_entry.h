@@ -31,6 +31,7 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <string>
 
 #include "mongo/db/catalog/database_catalog_entry.h"
@@ -39,6 +40,7 @@ namespace mongo {
 
 class KVCollectionCatalogEntry;
 class KVStorageEngine;
+class RecordStore;
 
 class KVDatabaseCatalogEntry : public DatabaseCatalogEntry {
 public:
@@ -86,6 +88,12 @@ public:
 
     void initCollection(OperationContext* opCtx, const std::string& ns, bool forRepair);
 
+    /**
+     * Like initCollection(), but with the collection's record store already opened. 'rs' is null
+     * if the collection is about to be repaired.
+     */
+    void initCollection(const std::string& ns, std::unique_ptr<RecordStore> rs);
+
     void initCollectionBeforeRepair(OperationContext* opCtx, const std::string& ns);
     void reinitCollectionAfterRepair(OperationContext* opCtx, const std::string& ns);
 
@@ -322,6 +322,62 @@ TEST(KVCatalogTest, DirectoryPerDb1) {
     }
 }
 
+TEST(KVCatalogTest, StorageTier) {
+    unique_ptr<KVHarnessHelper> helper(KVHarnessHelper::create());
+    KVEngine* engine = helper->getEngine();
+
+    unique_ptr<RecordStore> rs;
+    unique_ptr<KVCatalog> catalog;
+    {
+        MyOperationContext opCtx(engine);
+        WriteUnitOfWork uow(&opCtx);
+        ASSERT_OK(engine->createRecordStore(&opCtx, "catalog", "catalog", CollectionOptions()));
+        rs.reset(engine->getRecordStore(&opCtx, "catalog", "catalog", CollectionOptions()));
+        catalog.reset(new KVCatalog(rs.get(), true, true, false));
+        uow.commit();
+    }
+
+    CollectionOptions options;
+    options.storageTier = "cold";
+    {  // collection
+        MyOperationContext opCtx(engine);
+        WriteUnitOfWork uow(&opCtx);
+        ASSERT_OK(catalog->newCollection(&opCtx, "a.b", options));
+        const std::string ident = catalog->getCollectionIdent("a.b");
+        ASSERT_TRUE(StringData(ident).startsWith("tiers/cold/a/"));
+        ASSERT_TRUE(catalog->isUserDataIdent(ident));
+        ASSERT_OK(engine->createRecordStore(&opCtx, "a.b", ident, options));
+        uow.commit();
+    }
+
+    {  // index
+        MyOperationContext opCtx(engine);
+        WriteUnitOfWork uow(&opCtx);
+
+        BSONCollectionCatalogEntry::MetaData md;
+        md.ns = "a.b";
+        md.options = options;
+        md.indexes.push_back(BSONCollectionCatalogEntry::IndexMetaData(BSON("name"
+                                                                            << "foo"),
+                                                                       false,
+                                                                       RecordId(),
+                                                                       false));
+        catalog->putMetaData(&opCtx, "a.b", md);
+        const std::string ident = catalog->getIndexIdent(&opCtx, "a.b", "foo");
+        ASSERT_TRUE(StringData(ident).startsWith("tiers/cold/a/"));
+        ASSERT_TRUE(catalog->isUserDataIdent(ident));
+        uow.commit();
+    }
+
+    {  // collections without a tier stay out of the tiers directory
+        MyOperationContext opCtx(engine);
+        WriteUnitOfWork uow(&opCtx);
+        ASSERT_OK(catalog->newCollection(&opCtx, "a.c", CollectionOptions()));
+        ASSERT_FALSE(StringData(catalog->getCollectionIdent("a.c")).startsWith("tiers/"));
+        uow.commit();
+    }
+}
+
 TEST(KVCatalogTest, Split1) {
     unique_ptr<KVHarnessHelper> helper(KVHarnessHelper::create());
     KVEngine* engine = helper->getEngine();
@@ -32,9 +32,15 @@
 
 #include "mongo/db/storage/kv/kv_storage_engine.h"
 
+#include <algorithm>
+#include <exception>
+
 #include "mongo/db/operation_context_noop.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/kv/kv_database_catalog_entry.h"
 #include "mongo/db/storage/kv/kv_engine.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -46,7 +52,67 @@ using std::vector;
 
 namespace {
 const std::string catalogInfo = "_mdb_catalog";
+
+// Number of threads which open the record stores of existing collections on startup.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(kvStorageEngineStartupThreads, int, 8);
+
+/**
+ * Opens the record store of each of 'collections' into the corresponding element of
+ * 'recordStores'. With many collections, reading the metadata and sizes of every table dominates
+ * startup, so if the catalog and record stores are thread safe the work is spread over
+ * kvStorageEngineStartupThreads threads.
+ */
+void openRecordStores(KVEngine* engine,
+                      KVCatalog* catalog,
+                      bool threadSafe,
+                      const std::vector<std::string>& collections,
+                      std::vector<std::unique_ptr<RecordStore>>* recordStores) {
+    invariant(recordStores->size() == collections.size());
+
+    AtomicUInt64 nextCollection;
+    auto openRecordStoresOnThisThread = [&] {
+        OperationContextNoop opCtx(engine->newRecoveryUnit());
+        for (size_t i = nextCollection.fetchAndAdd(1); i < collections.size();
+             i = nextCollection.fetchAndAdd(1)) {
+            const std::string& ns = collections[i];
+            BSONCollectionCatalogEntry::MetaData md = catalog->getMetaData(&opCtx, ns);
+            (*recordStores)[i].reset(engine->getRecordStore(
+                &opCtx, ns, catalog->getCollectionIdent(ns), md.options));
+            invariant((*recordStores)[i]);
+        }
+        opCtx.recoveryUnit()->abandonSnapshot();
+    };
+
+    const size_t numThreads = threadSafe
+        ? std::min(collections.size(),
+                   static_cast<size_t>(std::max(1, kvStorageEngineStartupThreads)))
+        : 1;
+    if (numThreads <= 1) {
+        openRecordStoresOnThisThread();
+        return;
+    }
+
+    std::vector<std::exception_ptr> errors(numThreads);
+    std::vector<stdx::thread> threads;
+    for (size_t t = 0; t < numThreads; t++) {
+        threads.emplace_back([&, t] {
+            try {
+                openRecordStoresOnThisThread();
+            } catch (...) {
+                errors[t] = std::current_exception();
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
 }
+}  // namespace
 
 class KVStorageEngine::RemoveDBChange : public RecoveryUnit::Change {
 public:
@@ -108,6 +174,13 @@ KVStorageEngine::KVStorageEngine(KVEngine* engine, const KVStorageEngineOptions&
     std::vector<std::string> collections;
     _catalog->getAllCollections(&collections);
 
+    // Record stores are not opened before a repair.
+    std::vector<std::unique_ptr<RecordStore>> recordStores(collections.size());
+    if (!options.forRepair) {
+        openRecordStores(
+            _engine.get(), _catalog.get(), _supportsDocLocking, collections, &recordStores);
+    }
+
     for (size_t i = 0; i < collections.size(); i++) {
         std::string coll = collections[i];
         NamespaceString nss(coll);
@@ -119,7 +192,7 @@ KVStorageEngine::KVStorageEngine(KVEngine* engine, const KVStorageEngineOptions&
             db = new KVDatabaseCatalogEntry(dbName, this);
         }
 
-        db->initCollection(&opCtx, coll, options.forRepair);
+        db->initCollection(coll, std::move(recordStores[i]));
     }
 
     opCtx.recoveryUnit()->abandonSnapshot();
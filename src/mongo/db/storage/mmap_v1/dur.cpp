@@ -137,9 +137,10 @@ enum {
     NumCommitsBeforeRemap = 10,
 
     // How many outstanding journal flushes should be allowed before applying writer back
-    // pressure. Size of 1 allows two journal blocks to be in the process of being written -
-    // one on the journal writer's buffer and one blocked waiting to be picked up.
-    NumAsyncJournalWrites = 1,
+    // pressure. The journal writer compresses, writes and applies a group commit on one thread
+    // each, so with one buffer per stage the next group is prepared while the previous ones
+    // are in flight.
+    NumAsyncJournalWrites = 3,
 };
 
 // Remap loop state
@@ -488,6 +489,8 @@ void Stats::S::_asObj(BSONObjBuilder* builder) const {
       << _journaledBytes / (_uncompressedBytes + 1.0) << "commitsInWriteLock" << _commitsInWriteLock
       << "earlyCommits" << 0 << "timeMs"
       << BSON("dt" << _durationMillis << "prepLogBuffer" << (unsigned)(_prepLogBufferMicros / 1000)
+                   << "compressJournal"
+                   << (unsigned)(_compressJournalMicros / 1000)
                    << "writeToJournal"
                    << (unsigned)(_writeToJournalMicros / 1000)
                    << "writeToDataFiles"
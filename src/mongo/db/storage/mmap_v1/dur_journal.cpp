@@ -751,19 +751,15 @@ void Journal::_rotate(unsigned long long lsnOfCurrentJournalEntry) {
     }
 }
 
-/** write (append) the buffer we have built to the journal and fsync it.
-    outside of dbMutex lock as this could be slow.
+/** compress the buffer we have built into a journal section. the section is completed by
+    WRITETOJOURNAL, as its file id is only known once the sections before it are written.
     @param uncompressed - a buffer that will be written to the journal after compression
-    will not return until on disk
 */
-void WRITETOJOURNAL(const JSectHeader& h, const AlignedBuilder& uncompressed) {
+void COMPRESSJOURNALSECTION(const JSectHeader& h,
+                            const AlignedBuilder& uncompressed,
+                            AlignedBuilder* section) {
     Timer t;
-    j.journal(h, uncompressed);
-    stats.curr()->_writeToJournalMicros += t.micros();
-}
 
-void Journal::journal(const JSectHeader& h, const AlignedBuilder& uncompressed) {
-    static AlignedBuilder b(32 * 1024 * 1024);
     /* buffer to journal will be
        JSectHeader
        compressed operations
@@ -771,37 +767,37 @@ void Journal::journal(const JSectHeader& h, const AlignedBuilder& uncompressed)
     */
     const unsigned headTailSize = sizeof(JSectHeader) + sizeof(JSectFooter);
     const unsigned max = maxCompressedLength(uncompressed.len()) + headTailSize;
-    b.reset(max);
+    // Leave room for the padding WRITETOJOURNAL adds, so that completing the section never
+    // reallocates it.
+    section->reset(max + Alignment);
 
     {
         dassert(h.sectionLen() == (unsigned)0xffffffff);  // we will backfill later
-        b.appendStruct(h);
+        section->appendStruct(h);
     }
 
     size_t compressedLength = 0;
-    rawCompress(uncompressed.buf(), uncompressed.len(), b.cur(), &compressedLength);
+    rawCompress(uncompressed.buf(), uncompressed.len(), section->cur(), &compressedLength);
     verify(compressedLength < 0xffffffff);
     verify(compressedLength < max);
-    b.skip(compressedLength);
+    section->skip(compressedLength);
 
-    // footer
-    unsigned L = 0xffffffff;
-    {
-        // pad to alignment, and set the total section length in the JSectHeader
-        verify(0xffffe000 == (~(Alignment - 1)));
-        unsigned lenUnpadded = b.len() + sizeof(JSectFooter);
-        L = (lenUnpadded + Alignment - 1) & (~(Alignment - 1));
-        dassert(L >= lenUnpadded);
-
-        ((JSectHeader*)b.atOfs(0))->setSectionLen(lenUnpadded);
+    stats.curr()->_compressJournalMicros += t.micros();
+}
 
-        JSectFooter f(b.buf(), b.len());  // computes checksum
-        b.appendStruct(f);
-        dassert(b.len() == lenUnpadded);
+/** write (append) the section we have compressed to the journal and fsync it.
+    outside of dbMutex lock as this could be slow.
+    will not return until on disk
+*/
+void WRITETOJOURNAL(AlignedBuilder* section, unsigned uncompressedLen) {
+    Timer t;
+    j.journal(section, uncompressedLen);
+    stats.curr()->_writeToJournalMicros += t.micros();
+}
 
-        b.skip(L - lenUnpadded);
-        dassert(b.len() % Alignment == 0);
-    }
+void Journal::journal(AlignedBuilder* section, unsigned uncompressedLen) {
+    AlignedBuilder& b = *section;
+    JSectHeader* const h = (JSectHeader*)b.atOfs(0);
 
     try {
         stdx::lock_guard<SimpleMutex> lk(_curLogFileMutex);
@@ -809,13 +805,38 @@ void Journal::journal(const JSectHeader& h, const AlignedBuilder& uncompressed)
         // must already be open -- so that _curFileId is correct for previous buffer building
         verify(_curLogFile);
 
-        stats.curr()->_uncompressedBytes += uncompressed.len();
+        // The section was prepared and compressed while the sections before it were written,
+        // which may have rotated the journal file since. Recovery stops at the first section of
+        // another file, so the id is set here, before the footer checksums the header.
+        h->fileId = _curFileId;
+        const unsigned long long seqNumber = h->seqNumber;
+
+        // footer
+        unsigned L = 0xffffffff;
+        {
+            // pad to alignment, and set the total section length in the JSectHeader
+            verify(0xffffe000 == (~(Alignment - 1)));
+            unsigned lenUnpadded = b.len() + sizeof(JSectFooter);
+            L = (lenUnpadded + Alignment - 1) & (~(Alignment - 1));
+            dassert(L >= lenUnpadded);
+
+            h->setSectionLen(lenUnpadded);
+
+            JSectFooter f(b.buf(), b.len());  // computes checksum
+            b.appendStruct(f);
+            dassert(b.len() == lenUnpadded);
+
+            b.skip(L - lenUnpadded);
+            dassert(b.len() % Alignment == 0);
+        }
+
+        stats.curr()->_uncompressedBytes += uncompressedLen;
         unsigned w = b.len();
         _written += w;
         verify(w <= L);
         stats.curr()->_journaledBytes += L;
         _curLogFile->synchronousAppend((const void*)b.buf(), L);
-        _rotate(h.seqNumber);
+        _rotate(seqNumber);
     } catch (std::exception& e) {
         log() << "error exception in dur::journal " << e.what() << endl;
         throw;
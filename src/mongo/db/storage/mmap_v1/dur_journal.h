@@ -83,9 +83,19 @@ unsigned long long journalReadLSN();
 bool haveJournalFiles(bool anyFiles = false);
 
 /**
- * Writes the specified uncompressed buffer to the journal.
+ * Compresses the specified uncompressed buffer into a journal section in "section", after a
+ * copy of the header. Does not touch the journal file, so it may run while earlier sections are
+ * being written.
  */
-void WRITETOJOURNAL(const JSectHeader& h, const AlignedBuilder& uncompressed);
+void COMPRESSJOURNALSECTION(const JSectHeader& h,
+                            const AlignedBuilder& uncompressed,
+                            AlignedBuilder* section);
+
+/**
+ * Completes a section built by COMPRESSJOURNALSECTION with the id of the current journal file
+ * and the footer, and writes it to the journal.
+ */
+void WRITETOJOURNAL(AlignedBuilder* section, unsigned uncompressedLen);
 
 // in case disk controller buffers writes
 const long long ExtraKeepTimeMs = 10000;
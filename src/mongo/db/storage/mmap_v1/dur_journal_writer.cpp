@@ -75,7 +75,7 @@ void WRITETODATAFILES(const JSectHeader& h, const AlignedBuilder& uncompressed)
 
 
 /**
- * Used inside the journal writer thread to ensure that used buffers are cleaned up properly.
+ * Used inside the journal applier thread to ensure that used buffers are cleaned up properly.
  */
 class BufferGuard {
     MONGO_DISALLOW_COPYING(BufferGuard);
@@ -117,6 +117,8 @@ JournalWriter::JournalWriter(CommitNotifier* commitNotify,
       _shutdownRequested(false),
       _journalQueue(numBuffers),
       _lastCommitNumber(0),
+      _writeQueue(numBuffers),
+      _applyQueue(numBuffers),
       _readyQueue(numBuffers) {
     invariant(_journalQueue.maxSize() == _readyQueue.maxSize());
 }
@@ -124,6 +126,8 @@ JournalWriter::JournalWriter(CommitNotifier* commitNotify,
 JournalWriter::~JournalWriter() {
     // Never close the journal writer with outstanding or unaccounted writes
     invariant(_journalQueue.empty());
+    invariant(_writeQueue.empty());
+    invariant(_applyQueue.empty());
     invariant(_readyQueue.empty());
 }
 
@@ -136,9 +140,24 @@ void JournalWriter::start() {
         _readyQueue.push(new Buffer(InitialBufferSizeBytes));
     }
 
-    // Start the thread
-    stdx::thread t(stdx::bind(&JournalWriter::_journalWriterThread, this));
-    _journalWriterThreadHandle.swap(t);
+    // Start the threads
+    stdx::thread compressor(stdx::bind(&JournalWriter::_runStage,
+                                       this,
+                                       std::string("journal compressor"),
+                                       &JournalWriter::_compressStage));
+    _compressorThreadHandle.swap(compressor);
+
+    stdx::thread writer(stdx::bind(&JournalWriter::_runStage,
+                                   this,
+                                   std::string("journal writer"),
+                                   &JournalWriter::_writeStage));
+    _journalWriterThreadHandle.swap(writer);
+
+    stdx::thread applier(stdx::bind(&JournalWriter::_runStage,
+                                    this,
+                                    std::string("journal applier"),
+                                    &JournalWriter::_applyStage));
+    _applierThreadHandle.swap(applier);
 }
 
 void JournalWriter::shutdown() {
@@ -152,12 +171,14 @@ void JournalWriter::shutdown() {
     Buffer* const shutdownBuffer = newBuffer();
     shutdownBuffer->_setShutdown();
 
-    // This will terminate the journal thread. No need to specify commit number, since we are
-    // shutting down and nothing will be notified anyways.
+    // This will terminate the journal threads, as it goes through each stage. No need to
+    // specify commit number, since we are shutting down and nothing will be notified anyways.
     writeBuffer(shutdownBuffer, 0);
 
-    // Ensure the journal thread has stopped and everything accounted for.
+    // Ensure the journal threads have stopped and everything accounted for.
+    _compressorThreadHandle.join();
     _journalWriterThreadHandle.join();
+    _applierThreadHandle.join();
     assertIdle();
 
     // Delete the buffers (this deallocates the journal buffer memory)
@@ -170,6 +191,8 @@ void JournalWriter::shutdown() {
 void JournalWriter::assertIdle() {
     // All buffers are in the ready queue means there is nothing pending.
     invariant(_journalQueue.empty());
+    invariant(_writeQueue.empty());
+    invariant(_applyQueue.empty());
     invariant(_readyQueue.count() == _readyQueue.maxSize());
 }
 
@@ -204,73 +227,114 @@ void JournalWriter::flush() {
     }
 }
 
-void JournalWriter::_journalWriterThread() {
-    Client::initThread("journal writer");
+void JournalWriter::_runStage(const std::string& threadName, void (JournalWriter::*stage)()) {
+    Client::initThread(threadName.c_str());
 
-    log() << "Journal writer thread started";
+    log() << threadName << " thread started";
 
     try {
-        while (true) {
-            Buffer* const buffer = _journalQueue.blockingPop();
-            BufferGuard bufferGuard(buffer, &_readyQueue);
+        (this->*stage)();
+    } catch (const DBException& e) {
+        severe() << "dbexception in " << threadName
+                 << " thread causing immediate shutdown: " << e.toString();
+        invariant(false);
+    } catch (const std::ios_base::failure& e) {
+        severe() << "ios_base exception in " << threadName
+                 << " thread causing immediate shutdown: " << e.what();
+        invariant(false);
+    } catch (const std::bad_alloc& e) {
+        severe() << "bad_alloc exception in " << threadName
+                 << " thread causing immediate shutdown: " << e.what();
+        invariant(false);
+    } catch (const std::exception& e) {
+        severe() << "exception in " << threadName
+                 << " thread causing immediate shutdown: " << e.what();
+        invariant(false);
+    } catch (...) {
+        severe() << "unhandled exception in " << threadName
+                 << " thread causing immediate shutdown";
+        invariant(false);
+    }
 
-            if (buffer->_isShutdown) {
-                invariant(buffer->_builder.len() == 0);
+    log() << threadName << " thread stopped";
+}
+
+void JournalWriter::_compressStage() {
+    while (true) {
+        Buffer* const buffer = _journalQueue.blockingPop();
 
-                // The journal writer thread is terminating. Nothing to notify or write.
-                break;
-            }
+        if (!buffer->_isShutdown && !buffer->_isNoop) {
+            // Building the section doesn't touch the journal file, so this runs while the
+            // writer thread is doing the I/O of the previous buffer.
+            COMPRESSJOURNALSECTION(buffer->_header, buffer->_builder, &buffer->_section);
+        }
 
-            if (buffer->_isNoop) {
-                invariant(buffer->_builder.len() == 0);
+        // Shutdown and noop buffers are passed on, so they stay ordered after all other writes.
+        _writeQueue.push(buffer);
 
-                // There's nothing to be writen, but we still need to notify this commit number
-                _commitNotify->notifyAll(buffer->_commitNumber);
-                _applyToDataFilesNotify->notifyAll(buffer->_commitNumber);
-                continue;
-            }
+        if (buffer->_isShutdown) {
+            break;
+        }
+    }
+}
 
-            LOG(4) << "Journaling commit number " << buffer->_commitNumber << " (journal file "
-                   << buffer->_header.fileId << ", sequence " << buffer->_header.seqNumber
-                   << ", size " << buffer->_builder.len() << " bytes)";
+void JournalWriter::_writeStage() {
+    while (true) {
+        Buffer* const buffer = _writeQueue.blockingPop();
 
-            // This performs synchronous I/O to the journal file and will block.
-            WRITETOJOURNAL(buffer->_header, buffer->_builder);
+        if (buffer->_isShutdown) {
+            invariant(buffer->_builder.len() == 0);
 
-            // Data is now persisted in the journal, which is sufficient for acknowledging
-            // durability.
-            dur::getJournalListener()->onDurable(buffer->journalListenerToken);
+            // The journal writer thread is terminating. Nothing to notify or write.
+            _applyQueue.push(buffer);
+            break;
+        }
+
+        if (buffer->_isNoop) {
+            invariant(buffer->_builder.len() == 0);
+
+            // There's nothing to be writen, but we still need to notify this commit number
             _commitNotify->notifyAll(buffer->_commitNumber);
+            _applyQueue.push(buffer);
+            continue;
+        }
+
+        LOG(4) << "Journaling commit number " << buffer->_commitNumber << " (journal file "
+               << buffer->_header.fileId << ", sequence " << buffer->_header.seqNumber
+               << ", size " << buffer->_builder.len() << " bytes)";
 
+        // This performs synchronous I/O to the journal file and will block.
+        WRITETOJOURNAL(&buffer->_section, buffer->_builder.len());
+
+        // Data is now persisted in the journal, which is sufficient for acknowledging
+        // durability.
+        dur::getJournalListener()->onDurable(buffer->journalListenerToken);
+        _commitNotify->notifyAll(buffer->_commitNumber);
+
+        _applyQueue.push(buffer);
+    }
+}
+
+void JournalWriter::_applyStage() {
+    while (true) {
+        Buffer* const buffer = _applyQueue.blockingPop();
+        BufferGuard bufferGuard(buffer, &_readyQueue);
+
+        if (buffer->_isShutdown) {
+            // The journal applier thread is terminating. Nothing to notify or apply.
+            break;
+        }
+
+        if (!buffer->_isNoop) {
             // Apply the journal entries on top of the shared view so that when flush is
             // requested it would write the latest.
             WRITETODATAFILES(buffer->_header, buffer->_builder);
-
-            // Data is now persisted on the shared view, so notify any potential journal file
-            // cleanup waiters.
-            _applyToDataFilesNotify->notifyAll(buffer->_commitNumber);
         }
-    } catch (const DBException& e) {
-        severe() << "dbexception in journalWriterThread causing immediate shutdown: "
-                 << e.toString();
-        invariant(false);
-    } catch (const std::ios_base::failure& e) {
-        severe() << "ios_base exception in journalWriterThread causing immediate shutdown: "
-                 << e.what();
-        invariant(false);
-    } catch (const std::bad_alloc& e) {
-        severe() << "bad_alloc exception in journalWriterThread causing immediate shutdown: "
-                 << e.what();
-        invariant(false);
-    } catch (const std::exception& e) {
-        severe() << "exception in journalWriterThread causing immediate shutdown: " << e.what();
-        invariant(false);
-    } catch (...) {
-        severe() << "unhandled exception in journalWriterThread causing immediate shutdown";
-        invariant(false);
-    }
 
-    log() << "Journal writer thread stopped";
+        // Data is now persisted on the shared view, so notify any potential journal file
+        // cleanup waiters.
+        _applyToDataFilesNotify->notifyAll(buffer->_commitNumber);
+    }
 }
 
 
@@ -279,7 +343,12 @@ void JournalWriter::_journalWriterThread() {
 //
 
 JournalWriter::Buffer::Buffer(size_t initialSize)
-    : _commitNumber(0), _isNoop(false), _isShutdown(false), _header(), _builder(initialSize) {}
+    : _commitNumber(0),
+      _isNoop(false),
+      _isShutdown(false),
+      _header(),
+      _builder(initialSize),
+      _section(initialSize) {}
 
 JournalWriter::Buffer::~Buffer() {
     _assertEmpty();
@@ -294,6 +363,7 @@ void JournalWriter::Buffer::_reset() {
     _commitNumber = 0;
     _isNoop = false;
     _builder.reset();
+    _section.reset();
 }
 
 }  // namespace dur
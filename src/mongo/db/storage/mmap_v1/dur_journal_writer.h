@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <string>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/mmap_v1/aligned_builder.h"
@@ -40,9 +42,14 @@ namespace mongo {
 namespace dur {
 
 /**
- * Manages the thread and queues used for writing the journal to disk and notify parties with
+ * Manages the threads and queues used for writing the journal to disk and notify parties with
  * are waiting on the write concern.
  *
+ * Each buffer goes through three threads in turn, connected by queues: one compresses it into a
+ * journal section, one writes the section to the journal file, and one applies the buffer to
+ * the shared view. This way the compression of a group commit and the application of the one
+ * before it overlap with the synchronous write of the journal.
+ *
  * NOTE: Not thread-safe and must not be used from more than one thread.
  */
 class JournalWriter {
@@ -97,6 +104,9 @@ public:
 
         JSectHeader _header;
         AlignedBuilder _builder;
+
+        // The compressed journal section built from _builder
+        AlignedBuilder _section;
     };
 
 
@@ -121,12 +131,12 @@ public:
     ~JournalWriter();
 
     /**
-     * Allocates buffer memory and starts the journal writer thread.
+     * Allocates buffer memory and starts the journal writer threads.
      */
     void start();
 
     /**
-     * Terminates the journal writer thread and frees memory for the buffers. Must not be
+     * Terminates the journal writer threads and frees memory for the buffers. Must not be
      * called if there are any pending journal writes.
      */
     void shutdown();
@@ -172,7 +182,16 @@ private:
     enum { InitialBufferSizeBytes = 4 * 1024 * 1024 };
 
 
-    void _journalWriterThread();
+    /**
+     * Runs one stage of the pipeline on the calling thread until the shutdown buffer reaches it,
+     * and terminates the process if the stage throws.
+     */
+    void _runStage(const std::string& threadName, void (JournalWriter::*stage)());
+
+    // The stages of the pipeline, in the order a buffer goes through them
+    void _compressStage();
+    void _writeStage();
+    void _applyStage();
 
 
     // This gets notified as journal buffers are written. It is not owned and needs to outlive
@@ -182,16 +201,24 @@ private:
     // This gets notified as journal buffers are done being applied to the shared view
     CommitNotifier* const _applyToDataFilesNotify;
 
-    // Wraps and controls the journal writer thread
+    // Wrap and control the journal writer threads, one per stage
+    stdx::thread _compressorThreadHandle;
     stdx::thread _journalWriterThreadHandle;
+    stdx::thread _applierThreadHandle;
 
     // Indicates that shutdown has been requested. Used for idempotency of the shutdown call.
     bool _shutdownRequested;
 
-    // Queue of buffers, which need to be written by the journal writer thread
+    // Queue of buffers, which need to be compressed by the journal compressor thread
     BufferQueue _journalQueue;
     CommitNotifier::When _lastCommitNumber;
 
+    // Queue of compressed buffers, which need to be written by the journal writer thread
+    BufferQueue _writeQueue;
+
+    // Queue of written buffers, which need to be applied to the shared view
+    BufferQueue _applyQueue;
+
     // Queue of buffers, whose write has been completed by the journal writer thread.
     BufferQueue _readyQueue;
 };
@@ -174,8 +174,9 @@ public:
      */
     virtual int quantizeExtentSize(int size) const;
 
-    // see cacheHint methods
-    enum HintType { Sequential, Random };
+    // see cacheHint methods. WillNeed asks for the extent to be read ahead of its use, and
+    // needs no CacheHint to be kept alive.
+    enum HintType { Sequential, Random, WillNeed };
     class CacheHint {
     public:
         virtual ~CacheHint() {}
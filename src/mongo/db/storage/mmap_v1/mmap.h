@@ -51,12 +51,13 @@ class MAdvise {
     MONGO_DISALLOW_COPYING(MAdvise);
 
 public:
-    enum Advice { Sequential = 1, Random = 2 };
+    enum Advice { Sequential = 1, Random = 2, WillNeed = 3 };
     MAdvise(void* p, unsigned len, Advice a);
-    ~MAdvise();  // destructor resets the range to MADV_NORMAL
+    ~MAdvise();  // destructor resets the range to MADV_NORMAL, unless the advice was WillNeed
 private:
     void* _p;
     unsigned _len;
+    Advice _advice;
 };
 
 // lock order: lock dbMutex before this if you lock both
@@ -116,7 +116,7 @@ public:
 MAdvise::MAdvise(void*, unsigned, Advice) {}
 MAdvise::~MAdvise() {}
 #else
-MAdvise::MAdvise(void* p, unsigned len, Advice a) {
+MAdvise::MAdvise(void* p, unsigned len, Advice a) : _advice(a) {
     _p = _pageAlign(p);
 
     _len = len + static_cast<unsigned>(reinterpret_cast<size_t>(p) - reinterpret_cast<size_t>(_p));
@@ -129,6 +129,9 @@ MAdvise::MAdvise(void* p, unsigned len, Advice a) {
         case Random:
             advice = MADV_RANDOM;
             break;
+        case WillNeed:
+            advice = MADV_WILLNEED;
+            break;
     }
 
     if (madvise(_p, _len, advice)) {
@@ -136,7 +139,10 @@ MAdvise::MAdvise(void* p, unsigned len, Advice a) {
     }
 }
 MAdvise::~MAdvise() {
-    madvise(_p, _len, MADV_NORMAL);
+    // MADV_WILLNEED only starts reading the range in, it doesn't change the range's advice.
+    if (_advice != WillNeed) {
+        madvise(_p, _len, MADV_NORMAL);
+    }
 }
 #endif
 
@@ -634,9 +634,11 @@ private:
 
 ExtentManager::CacheHint* MmapV1ExtentManager::cacheHint(const DiskLoc& extentLoc,
                                                          const ExtentManager::HintType& hint) {
-    invariant(hint == Sequential);
+    invariant(hint == Sequential || hint == WillNeed);
     Extent* e = getExtent(extentLoc);
-    return new CacheHintMadvise(reinterpret_cast<void*>(e), e->length, MAdvise::Sequential);
+    return new CacheHintMadvise(reinterpret_cast<void*>(e),
+                                e->length,
+                                hint == Sequential ? MAdvise::Sequential : MAdvise::WillNeed);
 }
 
 MmapV1ExtentManager::FilesArray::~FilesArray() {
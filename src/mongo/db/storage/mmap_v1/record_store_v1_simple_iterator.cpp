@@ -28,13 +28,20 @@
 
 #include "mongo/db/storage/mmap_v1/record_store_v1_simple_iterator.h"
 
+#include <algorithm>
+#include <memory>
+#include <vector>
+
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/mmap_v1/extent.h"
 #include "mongo/db/storage/mmap_v1/extent_manager.h"
 #include "mongo/db/storage/mmap_v1/record_store_v1_simple.h"
 
 namespace mongo {
 
+MONGO_EXPORT_SERVER_PARAMETER(mmapv1ScanReadAheadExtents, int, 0);
+
 //
 // Regular / non-capped collection traversal
 //
@@ -74,6 +81,8 @@ SimpleRecordStoreV1Iterator::SimpleRecordStoreV1Iterator(OperationContext* txn,
         // valid e->xprev
         _curr = e->lastRecord;
     }
+
+    _readAhead();
 }
 
 boost::optional<Record> SimpleRecordStoreV1Iterator::next() {
@@ -90,6 +99,41 @@ boost::optional<Record> SimpleRecordStoreV1Iterator::seekExact(const RecordId& i
     return {{id, _recordStore->RecordStore::dataFor(_txn, id)}};
 }
 
+void SimpleRecordStoreV1Iterator::_readAhead() {
+    const int numExtents = mmapv1ScanReadAheadExtents.load();
+    if (numExtents <= 0 || isEOF()) {
+        return;
+    }
+
+    ExtentManager* em = _recordStore->_extentManager;
+    const DiskLoc currExtent = em->extentLocForV1(_curr);
+    if (currExtent == _readAheadFrom) {
+        return;
+    }
+    _readAheadFrom = currExtent;
+
+    std::vector<DiskLoc> window;
+    DiskLoc loc = currExtent;
+    for (int i = 0; i < numExtents; i++) {
+        Extent* e = em->getExtent(loc);
+        loc = _forward ? e->xnext : e->xprev;
+        if (loc.isNull()) {
+            break;
+        }
+        window.push_back(loc);
+    }
+
+    // Skip the extents read ahead from an earlier extent. If the farthest of them isn't in the
+    // window, the scan has moved elsewhere and the whole window is read ahead.
+    auto start = std::find(window.begin(), window.end(), _readAheadTo);
+    start = start == window.end() ? window.begin() : start + 1;
+    for (auto it = start; it != window.end(); ++it) {
+        std::unique_ptr<ExtentManager::CacheHint> hint(
+            em->cacheHint(*it, ExtentManager::WillNeed));
+        _readAheadTo = *it;
+    }
+}
+
 void SimpleRecordStoreV1Iterator::advance() {
     // Move to the next thing.
     if (!isEOF()) {
@@ -98,6 +142,7 @@ void SimpleRecordStoreV1Iterator::advance() {
         } else {
             _curr = _recordStore->getPrevRecord(_txn, _curr);
         }
+        _readAhead();
     }
 }
 
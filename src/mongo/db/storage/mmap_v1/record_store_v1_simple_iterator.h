@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "mongo/db/storage/mmap_v1/diskloc.h"
 #include "mongo/db/storage/record_store.h"
 
@@ -35,6 +37,12 @@ namespace mongo {
 
 class SimpleRecordStoreV1;
 
+/**
+ * How many extents ahead of the current one a collection scan asks the OS to read in, each time
+ * it enters a new extent. Zero disables the read-ahead.
+ */
+extern std::atomic<int> mmapv1ScanReadAheadExtents;  // NOLINT
+
 /**
  * This class iterates over a non-capped collection identified by 'ns'.
  * The collection must exist when the constructor is called.
@@ -67,6 +75,12 @@ private:
         return _curr.isNull();
     }
 
+    /**
+     * Issues the read-ahead of the extents after the one of _curr, in the direction of the
+     * scan, when _curr has moved into another extent.
+     */
+    void _readAhead();
+
     // for getNext, not owned
     OperationContext* _txn;
 
@@ -74,6 +88,11 @@ private:
     DiskLoc _curr;
     const SimpleRecordStoreV1* const _recordStore;
     const bool _forward;
+
+    // The extent of _curr when the read-ahead was last issued, and the farthest extent the
+    // read-ahead has reached.
+    DiskLoc _readAheadFrom;
+    DiskLoc _readAheadTo;
 };
 
 }  // namespace mongo
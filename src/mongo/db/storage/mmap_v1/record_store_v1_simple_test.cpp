@@ -33,8 +33,10 @@
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/db/storage/mmap_v1/extent.h"
 #include "mongo/db/storage/mmap_v1/record.h"
+#include "mongo/db/storage/mmap_v1/record_store_v1_simple_iterator.h"
 #include "mongo/db/storage/mmap_v1/record_store_v1_test_help.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 using namespace mongo;
 
@@ -449,4 +451,56 @@ TEST(SimpleRecordStoreV1, Truncate) {
         assertStateV1RS(&txn, recs, drecs, NULL, &em, md);
     }
 }
+
+/**
+ * A scan reads ahead the extents after the one it enters, each extent once.
+ */
+TEST(SimpleRecordStoreV1, ScanReadsAheadExtents) {
+    OperationContextNoop txn;
+    DummyExtentManager em;
+    DummyRecordStoreV1MetaData* md = new DummyRecordStoreV1MetaData(false, 0);
+    SimpleRecordStoreV1 rs(&txn, "test.foo", md, &em, false);
+
+    {
+        LocAndSize recs[] = {{DiskLoc(0, 1000), 100},
+                             {DiskLoc(1, 1000), 100},
+                             {DiskLoc(2, 1000), 100},
+                             {DiskLoc(3, 1000), 100},
+                             {DiskLoc(4, 1000), 100},
+                             {}};
+        initializeV1RS(&txn, recs, NULL, NULL, &em, md);
+    }
+
+    // Disabled by default.
+    auto cursor = rs.getCursor(&txn, true);
+    while (cursor->next()) {
+    }
+    ASSERT_EQUALS(0U, em.getWillNeedHints().size());
+
+    mmapv1ScanReadAheadExtents.store(2);
+    ON_BLOCK_EXIT([] { mmapv1ScanReadAheadExtents.store(0); });
+
+    cursor = rs.getCursor(&txn, true);
+    int count = 0;
+    while (cursor->next()) {
+        count++;
+    }
+    ASSERT_EQUALS(5, count);
+    const std::vector<DiskLoc> forward = {
+        DiskLoc(1, 0), DiskLoc(2, 0), DiskLoc(3, 0), DiskLoc(4, 0)};
+    ASSERT(forward == em.getWillNeedHints());
+
+    cursor = rs.getCursor(&txn, false);
+    while (cursor->next()) {
+    }
+    const std::vector<DiskLoc> backward = {DiskLoc(1, 0),
+                                           DiskLoc(2, 0),
+                                           DiskLoc(3, 0),
+                                           DiskLoc(4, 0),
+                                           DiskLoc(3, 0),
+                                           DiskLoc(2, 0),
+                                           DiskLoc(1, 0),
+                                           DiskLoc(0, 0)};
+    ASSERT(backward == em.getWillNeedHints());
+}
 }
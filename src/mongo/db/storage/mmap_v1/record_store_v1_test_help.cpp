@@ -292,6 +292,9 @@ int DummyExtentManager::maxSize() const {
 
 DummyExtentManager::CacheHint* DummyExtentManager::cacheHint(const DiskLoc& extentLoc,
                                                              const HintType& hint) {
+    if (hint == WillNeed) {
+        _willNeedHints.push_back(extentLoc);
+    }
     return new CacheHint();
 }
 
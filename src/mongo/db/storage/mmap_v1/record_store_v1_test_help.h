@@ -142,6 +142,13 @@ public:
 
     virtual CacheHint* cacheHint(const DiskLoc& extentLoc, const HintType& hint);
 
+    /**
+     * The extents passed to cacheHint() with WillNeed, in order.
+     */
+    const std::vector<DiskLoc>& getWillNeedHints() const {
+        return _willNeedHints;
+    }
+
     DataFileVersion getFileFormat(OperationContext* txn) const final;
 
     virtual void setFileFormat(OperationContext* txn, DataFileVersion newVersion) final;
@@ -156,6 +163,7 @@ protected:
     };
 
     std::vector<ExtentInfo> _extents;
+    std::vector<DiskLoc> _willNeedHints;
 };
 
 struct LocAndSize {
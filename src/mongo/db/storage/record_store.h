@@ -31,6 +31,8 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <string>
+#include <vector>
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/mutable/damage_vector.h"
@@ -153,6 +155,17 @@ public:
      */
     virtual boost::optional<Record> next() = 0;
 
+    /**
+     * Asks the cursor to return only the named top-level fields of each BSON record from
+     * subsequent calls to next() and seekExact(), building the trimmed document directly from
+     * the engine's buffer rather than handing out the whole record. An empty list restores the
+     * default of returning full records.
+     *
+     * This is only a hint: engines are free to ignore it and return full records, so callers
+     * must not depend on the absence of any field they did not ask for.
+     */
+    virtual void restrictToFields(std::vector<std::string> fieldNames) {}
+
     //
     // Saving and restoring state
     //
@@ -268,6 +281,39 @@ public:
     virtual std::unique_ptr<RecordFetcher> fetcherForId(const RecordId& id) const {
         return {};
     }
+
+    /**
+     * Hints that the Records with the provided ids are about to be read with seekExact(), so that
+     * the storage engine can bring them into memory ahead of time, in whatever order is cheapest.
+     * Does not change the position of the cursor. Ids which no longer exist are ignored.
+     *
+     * May throw WriteConflictException. The default implementation does nothing.
+     */
+    virtual void readAhead(const std::vector<RecordId>& ids) {}
+};
+
+/**
+ * Loads records into an empty RecordStore without a transaction per record, for restores and
+ * copies of whole collections. Records are visible to other operations as soon as they are
+ * inserted, and can't be rolled back: the caller must have the record store to itself, and
+ * drop it if the load fails.
+ *
+ * The load only becomes durable once commit() returns.
+ */
+class RecordStoreBulkLoader {
+public:
+    virtual ~RecordStoreBulkLoader() = default;
+
+    /**
+     * Inserts a record, and returns its id. Ids increase with each insert.
+     */
+    virtual StatusWith<RecordId> insertRecord(const char* data, int len) = 0;
+
+    /**
+     * Ends the load and makes the inserted records durable. No other method may be called after
+     * this one.
+     */
+    virtual Status commit(OperationContext* txn) = 0;
 };
 
 /**
@@ -498,6 +544,29 @@ public:
         return out;
     }
 
+    /**
+     * Returns a loader which inserts records into this empty record store more efficiently than
+     * insertRecord(), or {} if the storage engine has none or the record store isn't empty.
+     * Callers then insert records as usual.
+     */
+    virtual std::unique_ptr<RecordStoreBulkLoader> getBulkLoader(OperationContext* txn) {
+        return {};
+    }
+
+    /**
+     * Returns a forward cursor over the Records whose RecordIds are in the range [start, end).
+     * Returns {} if this RecordStore cannot position a cursor at an arbitrary RecordId without
+     * scanning the records before it, in which case callers must fall back to getCursor().
+     *
+     * Cursors over disjoint ranges are used by parallel collection scans to divide a RecordStore
+     * between worker threads, each with its own OperationContext.
+     */
+    virtual std::unique_ptr<RecordCursor> getCursorForRange(OperationContext* txn,
+                                                            const RecordId& start,
+                                                            const RecordId& end) const {
+        return {};
+    }
+
     // higher level
 
 
@@ -565,6 +634,13 @@ public:
                                    BSONObjBuilder* result,
                                    double scale) const = 0;
 
+    /**
+     * Appends the counters of cache and I/O activity the storage engine keeps for this record
+     * store, if any, to 'result'. Unlike appendCustomStats(), this must be cheap enough to call
+     * frequently.
+     */
+    virtual void appendStorageIOStats(OperationContext* txn, BSONObjBuilder* result) const {}
+
     /**
      * Load all data into cache.
      * What cache depends on implementation.
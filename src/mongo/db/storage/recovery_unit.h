@@ -119,6 +119,38 @@ public:
         return {};
     }
 
+    /**
+     * Informs this RecoveryUnit that all future reads through it should be from the newest named
+     * snapshot, until clearReadFromLastAppliedSnapshot() is called. Named snapshots are only
+     * created between oplog application batches on a secondary, so such reads see the state at
+     * the end of the last applied batch and don't need to wait for the current one.
+     *
+     * If there are no named snapshots, returns a status with error code SnapshotUnavailable. If
+     * they are all dropped before a snapshot is acquired, a UserException with the same code is
+     * thrown.
+     *
+     * StorageEngines that don't support a SnapshotManager should use the default
+     * implementation.
+     */
+    virtual Status setReadFromLastAppliedSnapshot() {
+        return {ErrorCodes::CommandNotSupported,
+                "Current storage engine does not support reading from named snapshots"};
+    }
+
+    /**
+     * Makes future reads through this RecoveryUnit use the latest data again. Must not be called
+     * while a snapshot is held.
+     */
+    virtual void clearReadFromLastAppliedSnapshot() {}
+
+    /**
+     * Returns the SnapshotName being used by this recovery unit or boost::none if not reading from
+     * the last applied snapshot. Reads may occur from later snapshots, but not from earlier ones.
+     */
+    virtual boost::optional<SnapshotName> getLastAppliedSnapshot() const {
+        return {};
+    }
+
     /**
      * Gets the local SnapshotId.
      *
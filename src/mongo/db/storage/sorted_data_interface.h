@@ -145,6 +145,12 @@ public:
                                    BSONObjBuilder* output,
                                    double scale) const = 0;
 
+    /**
+     * Appends the counters of cache and I/O activity the storage engine keeps for this index, if
+     * any, to 'output'. Unlike appendCustomStats(), this must be cheap enough to call frequently.
+     */
+    virtual void appendStorageIOStats(OperationContext* txn, BSONObjBuilder* output) const {}
+
 
     /**
      * Return the number of bytes consumed by 'this' index.
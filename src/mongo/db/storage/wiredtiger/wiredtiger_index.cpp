@@ -274,7 +274,9 @@ void WiredTigerIndex::unindex(OperationContext* txn,
 void WiredTigerIndex::fullValidate(OperationContext* txn,
                                    long long* numKeysOut,
                                    ValidateResults* fullResults) const {
-    if (fullResults && !WiredTigerRecoveryUnit::get(txn)->getSessionCache()->isEphemeral()) {
+    // Verifying the table needs exclusive access, which a background validate doesn't have.
+    if (fullResults && !WiredTigerRecoveryUnit::get(txn)->getSessionCache()->isEphemeral() &&
+        txn->lockState()->isCollectionLockedForMode(_collectionNamespace, MODE_X)) {
         int err = WiredTigerUtil::verifyTable(txn, _uri, &(fullResults->errors));
         if (err == EBUSY) {
             const char* msg = "verify() returned EBUSY. Not treating as invalid.";
@@ -345,6 +347,16 @@ bool WiredTigerIndex::appendCustomStats(OperationContext* txn,
     return true;
 }
 
+void WiredTigerIndex::appendStorageIOStats(OperationContext* txn, BSONObjBuilder* output) const {
+    WT_SESSION* s = WiredTigerRecoveryUnit::get(txn)->getSession(txn)->getSession();
+    Status status = WiredTigerUtil::appendStorageIOStats(s, uri(), output);
+    if (!status.isOK()) {
+        output->append("error", "unable to retrieve statistics");
+        output->append("code", static_cast<int>(status.code()));
+        output->append("reason", status.reason());
+    }
+}
+
 Status WiredTigerIndex::dupKeyCheck(OperationContext* txn, const BSONObj& key, const RecordId& id) {
     invariant(!hasFieldNames(key));
     invariant(unique());
@@ -454,6 +466,11 @@ Status WiredTigerIndex::compact(OperationContext* txn) {
         UniqueWiredTigerSession session = cache->getSession();
         WT_SESSION* s = session->getSession();
         int ret = s->compact(s, uri().c_str(), "timeout=0");
+        // Compacting online, the table may be in use by a checkpoint or another compaction.
+        if (ret == EBUSY) {
+            return Status(ErrorCodes::LockBusy,
+                          str::stream() << "compaction of " << uri() << " is busy, retry later");
+        }
         invariantWTOK(ret);
     }
     return Status::OK();
@@ -96,6 +96,7 @@ public:
     virtual bool appendCustomStats(OperationContext* txn,
                                    BSONObjBuilder* output,
                                    double scale) const;
+    void appendStorageIOStats(OperationContext* txn, BSONObjBuilder* output) const override;
     virtual Status dupKeyCheck(OperationContext* txn, const BSONObj& key, const RecordId& id);
 
     virtual bool isEmpty(OperationContext* txn);
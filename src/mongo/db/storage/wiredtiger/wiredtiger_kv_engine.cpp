@@ -169,8 +169,146 @@ TicketHolder openReadTransaction(128);
 TicketServerParameter openReadTransactionParam(&openReadTransaction,
                                                "wiredTigerConcurrentReadTransactions");
 
+// When set, the read and write tickets are resized between the bounds below from the throughput
+// and queueing of each pool and the pressure on the cache, overriding the concurrent transaction
+// parameters above.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveConcurrency, bool, false);
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveConcurrencyMinTickets, int, 16);
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveConcurrencyMaxTickets, int, 512);
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveConcurrencyIntervalMillis, int, 1000);
+
+// The cache is under pressure once this much of it is used, which is where WiredTiger's
+// application threads start helping with eviction by default.
+const double kCachePressureRatio = 0.95;
+
+// A pool which grew is shrunk back if its throughput fell by more than this much.
+const double kThroughputLossRatio = 0.95;
+
+/**
+ * Returns the number of tickets a pool of 'outof' tickets should have next. While the cache is
+ * under pressure pools shrink quickly, since more concurrent transactions only pin more of it.
+ * Otherwise pools with waiting operations grow by small steps as long as growing doesn't lose
+ * throughput.
+ */
+int computeTicketTarget(int outof,
+                        int waiting,
+                        bool cachePressure,
+                        bool lastGrew,
+                        double throughput,
+                        double lastThroughput,
+                        int minTickets,
+                        int maxTickets) {
+    const int step = std::max(1, outof / 8);
+    int target = outof;
+    if (cachePressure) {
+        target = outof - std::max(1, outof / 4);
+    } else if (lastGrew && throughput < lastThroughput * kThroughputLossRatio) {
+        target = outof - step;
+    } else if (waiting > 0) {
+        target = outof + step;
+    }
+    return std::min(std::max(target, minTickets), maxTickets);
+}
+
 }  // namespace
 
+/**
+ * Periodically resizes the read and write tickets when wiredTigerAdaptiveConcurrency is set.
+ */
+class WiredTigerKVEngine::WiredTigerTicketAdjuster : public BackgroundJob {
+public:
+    explicit WiredTigerTicketAdjuster(WT_CONNECTION* conn)
+        : BackgroundJob(false /* deleteSelf */), _conn(conn) {}
+
+    virtual string name() const {
+        return "WTTicketAdjuster";
+    }
+
+    virtual void run() {
+        Client::initThread(name().c_str());
+
+        LOG(1) << "starting " << name() << " thread";
+
+        TicketPool pools[] = {{&openReadTransaction, "read"}, {&openWriteTransaction, "write"}};
+        Date_t last = Date_t::now();
+        while (!_shuttingDown.load()) {
+            sleepmillis(std::max(100, wiredTigerAdaptiveConcurrencyIntervalMillis.load()));
+
+            const Date_t now = Date_t::now();
+            const double elapsedSecs = durationCount<Milliseconds>(now - last) / 1000.0;
+            last = now;
+            if (!wiredTigerAdaptiveConcurrency.load() || elapsedSecs <= 0) {
+                for (auto&& pool : pools) {
+                    pool.lastAcquired = pool.holder->numAcquired();
+                    pool.lastGrew = false;
+                }
+                continue;
+            }
+
+            const bool cachePressure = _isCacheUnderPressure();
+            const int minTickets = std::max(1, wiredTigerAdaptiveConcurrencyMinTickets.load());
+            const int maxTickets =
+                std::max(minTickets, wiredTigerAdaptiveConcurrencyMaxTickets.load());
+            for (auto&& pool : pools) {
+                const long long acquired = pool.holder->numAcquired();
+                const double throughput = (acquired - pool.lastAcquired) / elapsedSecs;
+                const int outof = pool.holder->outof();
+                const int target = computeTicketTarget(outof,
+                                                       pool.holder->waiting(),
+                                                       cachePressure,
+                                                       pool.lastGrew,
+                                                       throughput,
+                                                       pool.lastThroughput,
+                                                       minTickets,
+                                                       maxTickets);
+                if (target != outof) {
+                    LOG(1) << "resizing " << pool.name << " tickets from " << outof << " to "
+                           << target << "; throughput: " << throughput
+                           << "/s, cache under pressure: " << cachePressure;
+                    invariantOK(pool.holder->resize(target));
+                }
+                pool.lastAcquired = acquired;
+                pool.lastThroughput = throughput;
+                pool.lastGrew = target > outof;
+            }
+        }
+        LOG(1) << "stopping " << name() << " thread";
+    }
+
+    void shutdown() {
+        _shuttingDown.store(true);
+        wait();
+    }
+
+private:
+    struct TicketPool {
+        TicketPool(TicketHolder* holder, const char* name) : holder(holder), name(name) {}
+
+        TicketHolder* holder;
+        const char* name;
+        long long lastAcquired = 0;
+        double lastThroughput = 0;
+        bool lastGrew = false;
+    };
+
+    bool _isCacheUnderPressure() {
+        WiredTigerSession session(_conn);
+        const std::string uri = "statistics:";
+        const std::string config = "statistics=(fast)";
+        auto inUse = WiredTigerUtil::getStatisticsValueAs<int64_t>(
+            session.getSession(), uri, config, WT_STAT_CONN_CACHE_BYTES_INUSE);
+        auto max = WiredTigerUtil::getStatisticsValueAs<int64_t>(
+            session.getSession(), uri, config, WT_STAT_CONN_CACHE_BYTES_MAX);
+        if (!inUse.isOK() || !max.isOK() || max.getValue() <= 0) {
+            return false;
+        }
+        return inUse.getValue() >= max.getValue() * kCachePressureRatio;
+    }
+
+    WT_CONNECTION* const _conn;
+    std::atomic<bool> _shuttingDown{false};  // NOLINT
+};
+
 WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
                                        const std::string& path,
                                        ClockSource* cs,
@@ -278,6 +416,11 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& canonicalName,
     }
 
     Locker::setGlobalThrottling(&openReadTransaction, &openWriteTransaction);
+
+    if (!_readOnly) {
+        _ticketAdjuster = stdx::make_unique<WiredTigerTicketAdjuster>(_conn);
+        _ticketAdjuster->go();
+    }
 }
 
 
@@ -313,6 +456,8 @@ void WiredTigerKVEngine::cleanShutdown() {
     syncSizeInfo(true);
     if (_conn) {
         // these must be the last things we do before _conn->close();
+        if (_ticketAdjuster)
+            _ticketAdjuster->shutdown();
         if (_journalFlusher)
             _journalFlusher->shutdown();
         _sizeStorer.reset();
@@ -153,6 +153,7 @@ public:
 
 private:
     class WiredTigerJournalFlusher;
+    class WiredTigerTicketAdjuster;
 
     Status _salvageIfNeeded(const char* uri);
     void _checkIdentPath(StringData ident);
@@ -176,6 +177,7 @@ private:
     bool _ephemeral;
     bool _readOnly;
     std::unique_ptr<WiredTigerJournalFlusher> _journalFlusher;  // Depends on _sizeStorer
+    std::unique_ptr<WiredTigerTicketAdjuster> _ticketAdjuster;
 
     std::string _rsOptions;
     std::string _indexOptions;
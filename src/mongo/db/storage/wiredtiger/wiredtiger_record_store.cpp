@@ -35,9 +35,11 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 
+#include <algorithm>
 #include <wiredtiger.h>
 
 #include "mongo/base/checked_cast.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/db/concurrency/locker.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
@@ -201,6 +203,26 @@ void WiredTigerRecordStore::OplogStones::popOldestStone() {
     _stones.pop_front();
 }
 
+void WiredTigerRecordStore::OplogStones::appendStats(BSONObjBuilder* builder, double scale) const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    // The stones beyond '_numStonesToKeep' are the oldest ones, at the front of the deque.
+    const size_t numExcessStones =
+        _stones.size() > _numStonesToKeep ? _stones.size() - _numStonesToKeep : 0;
+    int64_t excessRecords = 0;
+    int64_t excessBytes = 0;
+    for (size_t i = 0; i < numExcessStones; ++i) {
+        excessRecords += _stones[i].records;
+        excessBytes += _stones[i].bytes;
+    }
+
+    builder->appendIntOrLL("numStones", static_cast<long long>(_stones.size()));
+    builder->appendIntOrLL("numStonesToKeep", static_cast<long long>(_numStonesToKeep));
+    builder->appendIntOrLL("excessStones", static_cast<long long>(numExcessStones));
+    builder->appendIntOrLL("excessRecords", excessRecords);
+    builder->appendIntOrLL("excessSize", static_cast<long long>(excessBytes / scale));
+}
+
 void WiredTigerRecordStore::OplogStones::createNewStoneIfNeeded(RecordId lastRecord) {
     stdx::unique_lock<stdx::mutex> lk(_mutex, stdx::try_to_lock);
     if (!lk) {
@@ -431,11 +453,22 @@ void WiredTigerRecordStore::OplogStones::_pokeReclaimThreadIfNeeded() {
 
 class WiredTigerRecordStore::Cursor final : public SeekableRecordCursor {
 public:
-    Cursor(OperationContext* txn, const WiredTigerRecordStore& rs, bool forward = true)
+    /**
+     * A forward cursor can be restricted to the RecordIds in [rangeStart, rangeEnd). A null
+     * 'rangeStart' starts at the first record.
+     */
+    Cursor(OperationContext* txn,
+           const WiredTigerRecordStore& rs,
+           bool forward = true,
+           const RecordId& rangeStart = RecordId(),
+           const RecordId& rangeEnd = RecordId::max())
         : _rs(rs),
           _txn(txn),
           _forward(forward),
+          _rangeStart(rangeStart),
+          _rangeEnd(rangeEnd),
           _readUntilForOplog(WiredTigerRecoveryUnit::get(txn)->getOplogReadTill()) {
+        invariant(_forward || (_rangeStart.isNull() && _rangeEnd == RecordId::max()));
         _cursor.emplace(rs.getURI(), rs.tableId(), true, txn);
     }
 
@@ -467,6 +500,19 @@ public:
                     ? (cmp >= 0)
                     : (cmp > 0);  // No longer hidden.
             }
+        } else if (_lastReturnedId.isNull() && !_rangeStart.isNull()) {
+            // Position ourselves at the first record of our range.
+            c->set_key(c, _makeKey(_rangeStart));
+            int cmp;
+            int seekRet = WT_OP_CHECK(c->search_near(c, &cmp));
+            if (seekRet == WT_NOTFOUND) {
+                _eof = true;
+                return {};
+            }
+            invariantWTOK(seekRet);
+
+            // If we landed before the start of the range, the next record is the first one in it.
+            mustAdvance = cmp < 0;
         }
 
         if (mustAdvance) {
@@ -503,7 +549,7 @@ public:
             throw WriteConflictException();
         }
 
-        if (!isVisible(id)) {
+        if (!isVisible(id) || id >= _rangeEnd) {
             _eof = true;
             return {};
         }
@@ -512,7 +558,7 @@ public:
         invariantWTOK(c->get_value(c, &value));
 
         _lastReturnedId = id;
-        return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
+        return _makeRecord(id, value);
     }
 
     boost::optional<Record> seekExact(const RecordId& id) final {
@@ -532,7 +578,31 @@ public:
 
         _lastReturnedId = id;
         _eof = false;
-        return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
+        return _makeRecord(id, value);
+    }
+
+    void readAhead(const std::vector<RecordId>& ids) final {
+        if (ids.size() < 2)
+            return;
+
+        // Searching in RecordId order turns the random reads of the upcoming seekExact() calls
+        // into a single pass through the table, after which those calls are served from cache.
+        // A separate WT cursor is used so that our own position is left alone.
+        std::vector<RecordId> sorted(ids);
+        std::sort(sorted.begin(), sorted.end());
+
+        WiredTigerCursor readAheadCursor(_rs.getURI(), _rs.tableId(), true, _txn);
+        WT_CURSOR* c = readAheadCursor.get();
+        for (const auto& id : sorted) {
+            c->set_key(c, _makeKey(id));
+            int ret = WT_OP_CHECK(c->search(c));
+            if (ret != WT_NOTFOUND)
+                invariantWTOK(ret);
+        }
+    }
+
+    void restrictToFields(std::vector<std::string> fieldNames) final {
+        _fieldSubset = std::move(fieldNames);
     }
 
     void save() final {
@@ -609,6 +679,36 @@ public:
     }
 
 private:
+    /**
+     * Wraps the value under the cursor in a Record. Without a field subset the returned data
+     * points into WT's buffer and is only valid until the cursor moves. With one, the requested
+     * top-level fields are copied straight out of that buffer into an owned, trimmed document, so
+     * callers never need to make an owned copy of the whole record.
+     */
+    Record _makeRecord(const RecordId& id, const WT_ITEM& value) const {
+        const char* data = static_cast<const char*>(value.data);
+        if (_fieldSubset.empty()) {
+            return {id, {data, static_cast<int>(value.size)}};
+        }
+
+        BufBuilder buf;
+        BSONObjBuilder bob(buf);
+        size_t numFound = 0;
+        BSONObj stored(data);
+        BSONObjIterator it(stored);
+        while (it.more() && numFound < _fieldSubset.size()) {
+            BSONElement elem = it.next();
+            if (std::find(_fieldSubset.begin(), _fieldSubset.end(), elem.fieldNameStringData()) !=
+                _fieldSubset.end()) {
+                bob.append(elem);
+                ++numFound;
+            }
+        }
+        bob.doneFast();
+        const int size = buf.len();
+        return {id, {buf.release(), size}};
+    }
+
     bool isVisible(const RecordId& id) {
         if (!_rs._isCapped)
             return true;
@@ -630,11 +730,14 @@ private:
     const WiredTigerRecordStore& _rs;
     OperationContext* _txn;
     const bool _forward;
+    const RecordId _rangeStart;  // Only used for the initial seek, if not null.
+    const RecordId _rangeEnd;    // RecordId::max() if the cursor is not restricted to a range.
     bool _skipNextAdvance = false;
     boost::optional<WiredTigerCursor> _cursor;
     bool _eof = false;
     RecordId _lastReturnedId;  // If null, need to seek to first/last record.
     const RecordId _readUntilForOplog;
+    std::vector<std::string> _fieldSubset;  // Top-level fields to return; empty means all.
 };
 
 StatusWith<std::string> WiredTigerRecordStore::parseOptionsField(const BSONObj options) {
@@ -727,6 +830,76 @@ private:
     const std::string _config;
 };
 
+/**
+ * Appends records to an empty table through a WiredTiger bulk cursor, which writes leaf pages
+ * directly instead of inserting each record through a transaction.
+ */
+class WiredTigerRecordStore::BulkLoader final : public RecordStoreBulkLoader {
+public:
+    BulkLoader(OperationContext* txn, WiredTigerRecordStore* rs)
+        : _rs(rs),
+          _session(WiredTigerRecoveryUnit::get(txn)->getSessionCache()->getSession()),
+          _cursor(openBulkCursor(txn)) {}
+
+    ~BulkLoader() {
+        if (_cursor)
+            _cursor->close(_cursor);
+    }
+
+    StatusWith<RecordId> insertRecord(const char* data, int len) final {
+        invariant(_cursor);
+        const RecordId id = _rs->_nextId();
+        _cursor->set_key(_cursor, _makeKey(id));
+        WiredTigerItem value(data, len);
+        _cursor->set_value(_cursor, value.Get());
+        int ret = _cursor->insert(_cursor);
+        if (ret)
+            return wtRCToStatus(ret, "WiredTigerRecordStore::BulkLoader::insertRecord");
+
+        // The records can't be rolled back, so neither can the sizes.
+        _rs->_numRecords.fetchAndAdd(1);
+        _rs->_increaseDataSize(nullptr, len);
+        return id;
+    }
+
+    Status commit(OperationContext* txn) final {
+        invariant(_cursor);
+        int ret = _cursor->close(_cursor);
+        _cursor = nullptr;
+        if (ret)
+            return wtRCToStatus(ret, "WiredTigerRecordStore::BulkLoader::commit");
+
+        // Bulk loads aren't written to the journal, so only a checkpoint makes them durable.
+        if (!_rs->_isEphemeral) {
+            WiredTigerRecoveryUnit::get(txn)->getSessionCache()->waitUntilDurable(true);
+        }
+        return Status::OK();
+    }
+
+private:
+    WT_CURSOR* openBulkCursor(OperationContext* txn) {
+        // Open cursors can cause bulk open_cursor to fail with EBUSY.
+        WiredTigerRecoveryUnit::get(txn)->getSession(txn)->closeAllCursors();
+
+        // We use our own session to ensure we aren't in a transaction.
+        WT_CURSOR* cursor;
+        WT_SESSION* session = _session->getSession();
+        int err = session->open_cursor(session, _rs->_uri.c_str(), NULL, "bulk", &cursor);
+        if (!err)
+            return cursor;
+
+        warning() << "failed to create WiredTiger bulk cursor: " << wiredtiger_strerror(err);
+        warning() << "falling back to non-bulk cursor for collection " << _rs->_uri;
+
+        invariantWTOK(session->open_cursor(session, _rs->_uri.c_str(), NULL, NULL, &cursor));
+        return cursor;
+    }
+
+    WiredTigerRecordStore* const _rs;
+    UniqueWiredTigerSession const _session;
+    WT_CURSOR* _cursor;
+};
+
 
 // static
 StatusWith<std::string> WiredTigerRecordStore::generateCreateString(
@@ -1219,8 +1392,15 @@ bool WiredTigerRecordStore::yieldAndAwaitOplogDeletionRequest(OperationContext*
     return !oplogStones->isDead();
 }
 
-void WiredTigerRecordStore::reclaimOplog(OperationContext* txn) {
+int64_t WiredTigerRecordStore::reclaimOplog(OperationContext* txn, int64_t maxBytes) {
+    int64_t bytesReclaimed = 0;
     while (auto stone = _oplogStones->peekOldestStoneIfNeeded()) {
+        if (bytesReclaimed >= maxBytes && !_oplogStones->hasExcessStonesUnderPressure()) {
+            LOG(1) << "Reclaimed " << bytesReclaimed << " bytes from the oplog, deferring the "
+                   << "truncation of the remaining stones";
+            return bytesReclaimed;
+        }
+
         invariant(stone->lastRecord.isNormal());
 
         LOG(1) << "Truncating the oplog between " << _oplogStones->firstRecord << " and "
@@ -1252,6 +1432,8 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* txn) {
 
             // Stash the truncate point for next time to cleanly skip over tombstones, etc.
             _oplogStones->firstRecord = stone->lastRecord;
+
+            bytesReclaimed += stone->bytes;
         } catch (const WriteConflictException& wce) {
             LOG(1) << "Caught WriteConflictException while truncating oplog entries, retrying";
         }
@@ -1259,6 +1441,7 @@ void WiredTigerRecordStore::reclaimOplog(OperationContext* txn) {
 
     LOG(1) << "Finished truncating the oplog, it now contains approximately " << _numRecords.load()
            << " records totaling to " << _dataSize.load() << " bytes";
+    return bytesReclaimed;
 }
 
 Status WiredTigerRecordStore::insertRecords(OperationContext* txn,
@@ -1348,20 +1531,21 @@ StatusWith<RecordId> WiredTigerRecordStore::insertRecord(OperationContext* txn,
 void WiredTigerRecordStore::_dealtWithCappedId(SortedRecordIds::iterator it) {
     invariant(&(*it) != NULL);
     stdx::lock_guard<stdx::mutex> lk(_uncommittedRecordIdsMutex);
+    const bool wasLowest = it == _uncommittedRecordIds.begin();
     _uncommittedRecordIds.erase(it);
+    if (wasLowest) {
+        _lowestUncommittedRecordId.store(
+            _uncommittedRecordIds.empty() ? 0 : _uncommittedRecordIds.front().repr());
+    }
 }
 
 bool WiredTigerRecordStore::isCappedHidden(const RecordId& id) const {
-    stdx::lock_guard<stdx::mutex> lk(_uncommittedRecordIdsMutex);
-    if (_uncommittedRecordIds.empty()) {
-        return false;
-    }
-    return _uncommittedRecordIds.front() <= id;
+    const RecordId lowestHidden = lowestCappedHiddenRecord();
+    return !lowestHidden.isNull() && lowestHidden <= id;
 }
 
 RecordId WiredTigerRecordStore::lowestCappedHiddenRecord() const {
-    stdx::lock_guard<stdx::mutex> lk(_uncommittedRecordIdsMutex);
-    return _uncommittedRecordIds.empty() ? RecordId() : _uncommittedRecordIds.front();
+    return RecordId(_lowestUncommittedRecordId.load());
 }
 
 Status WiredTigerRecordStore::insertRecordsWithDocWriter(OperationContext* txn,
@@ -1442,7 +1626,7 @@ Status WiredTigerRecordStore::updateRecord(OperationContext* txn,
 }
 
 bool WiredTigerRecordStore::updateWithDamagesSupported() const {
-    return false;
+    return true;
 }
 
 StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
@@ -1451,7 +1635,30 @@ StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
     const RecordData& oldRec,
     const char* damageSource,
     const mutablebson::DamageVector& damages) {
-    MONGO_UNREACHABLE;
+    // WiredTiger can't overwrite part of a value, so the damages are applied to a copy of the
+    // record, which is written back whole. This still spares the caller from serializing the
+    // entire updated document again.
+    const int len = oldRec.size();
+    SharedBuffer data = SharedBuffer::allocate(len);
+    memcpy(data.get(), oldRec.data(), len);
+    for (const auto& damage : damages) {
+        invariant(damage.targetOffset + damage.size <= static_cast<size_t>(len));
+        memcpy(data.get() + damage.targetOffset, damageSource + damage.sourceOffset, damage.size);
+    }
+
+    WiredTigerCursor curwrap(_uri, _tableId, true, txn);
+    curwrap.assertInActiveTxn();
+    WT_CURSOR* c = curwrap.get();
+    invariant(c);
+    c->set_key(c, _makeKey(id));
+    WiredTigerItem value(data.get(), len);
+    c->set_value(c, value.Get());
+    int ret = WT_OP_CHECK(c->insert(c));
+    invariantWTOK(ret);
+
+    // The size of the record is unchanged, so neither the data size nor the capped collection
+    // bounds need adjusting.
+    return RecordData(std::move(data), len);
 }
 
 void WiredTigerRecordStore::_oplogSetStartHack(WiredTigerRecoveryUnit* wru) const {
@@ -1493,6 +1700,25 @@ std::vector<std::unique_ptr<RecordCursor>> WiredTigerRecordStore::getManyCursors
     return cursors;
 }
 
+std::unique_ptr<RecordStoreBulkLoader> WiredTigerRecordStore::getBulkLoader(
+    OperationContext* txn) {
+    // Capped collections and the oplog need to track the visibility of each insert.
+    if (_isCapped || _useOplogHack || numRecords(txn) != 0) {
+        return {};
+    }
+    return stdx::make_unique<BulkLoader>(txn, this);
+}
+
+std::unique_ptr<RecordCursor> WiredTigerRecordStore::getCursorForRange(OperationContext* txn,
+                                                                       const RecordId& start,
+                                                                       const RecordId& end) const {
+    // Capped collections have visibility rules that only a full scan from the start can follow.
+    if (_isCapped) {
+        return {};
+    }
+    return stdx::make_unique<Cursor>(txn, *this, /*forward=*/true, start, end);
+}
+
 Status WiredTigerRecordStore::truncate(OperationContext* txn) {
     WiredTigerCursor startWrap(_uri, _tableId, true, txn);
     WT_CURSOR* start = startWrap.get();
@@ -1524,6 +1750,11 @@ Status WiredTigerRecordStore::compact(OperationContext* txn,
         UniqueWiredTigerSession session = cache->getSession();
         WT_SESSION* s = session->getSession();
         int ret = s->compact(s, getURI().c_str(), "timeout=0");
+        // Compacting online, the table may be in use by a checkpoint or another compaction.
+        if (ret == EBUSY) {
+            return Status(ErrorCodes::LockBusy,
+                          str::stream() << "compaction of " << getURI() << " is busy, retry later");
+        }
         invariantWTOK(ret);
     }
     return Status::OK();
@@ -1534,7 +1765,12 @@ Status WiredTigerRecordStore::validate(OperationContext* txn,
                                        ValidateAdaptor* adaptor,
                                        ValidateResults* results,
                                        BSONObjBuilder* output) {
-    if (!_isEphemeral) {
+    // Without an exclusive lock this is a background validate, reading a snapshot while writes
+    // go on. Verifying the table would need exclusive access to it, and the size counters may
+    // change under the scan.
+    const bool exclusive = txn->lockState()->isCollectionLockedForMode(ns(), MODE_X);
+
+    if (!_isEphemeral && exclusive) {
         int err = WiredTigerUtil::verifyTable(txn, _uri, &results->errors);
         if (err == EBUSY) {
             const char* msg = "verify() returned EBUSY. Not treating as invalid.";
@@ -1584,7 +1820,7 @@ Status WiredTigerRecordStore::validate(OperationContext* txn,
         }
     }
 
-    if (_sizeStorer && results->valid) {
+    if (_sizeStorer && results->valid && exclusive) {
         if (nrecords != _numRecords.load() || dataSizeTotal != _dataSize.load()) {
             warning() << _uri << ": Existing record and data size counters (" << _numRecords.load()
                       << " records " << _dataSize.load() << " bytes) "
@@ -1615,6 +1851,10 @@ void WiredTigerRecordStore::appendCustomStats(OperationContext* txn,
         result->appendIntOrLL("sleepCount", _cappedSleep.load());
         result->appendIntOrLL("sleepMS", _cappedSleepMS.load());
     }
+    if (_oplogStones) {
+        BSONObjBuilder stonesBuilder(result->subobjStart("oplogStones"));
+        _oplogStones->appendStats(&stonesBuilder, scale);
+    }
     WiredTigerSession* session = WiredTigerRecoveryUnit::get(txn)->getSession(txn);
     WT_SESSION* s = session->getSession();
     BSONObjBuilder bob(result->subobjStart(_engineName));
@@ -1652,6 +1892,17 @@ void WiredTigerRecordStore::appendCustomStats(OperationContext* txn,
     }
 }
 
+void WiredTigerRecordStore::appendStorageIOStats(OperationContext* txn,
+                                                 BSONObjBuilder* result) const {
+    WT_SESSION* s = WiredTigerRecoveryUnit::get(txn)->getSession(txn)->getSession();
+    Status status = WiredTigerUtil::appendStorageIOStats(s, getURI(), result);
+    if (!status.isOK()) {
+        result->append("error", "unable to retrieve statistics");
+        result->append("code", static_cast<int>(status.code()));
+        result->append("reason", status.reason());
+    }
+}
+
 Status WiredTigerRecordStore::touch(OperationContext* txn, BSONObjBuilder* output) const {
     if (_isEphemeral) {
         // Everything is already in memory.
@@ -1697,6 +1948,9 @@ void WiredTigerRecordStore::_addUncommitedRecordId_inlock(OperationContext* txn,
     // todo: make this a dassert at some point
     // invariant(_uncommittedRecordIds.empty() || _uncommittedRecordIds.back() < id);
     SortedRecordIds::iterator it = _uncommittedRecordIds.insert(_uncommittedRecordIds.end(), id);
+    if (it == _uncommittedRecordIds.begin()) {
+        _lowestUncommittedRecordId.store(id.repr());
+    }
     txn->recoveryUnit()->registerChange(new CappedInsertChange(this, it));
     _oplog_highestSeen = id;
 }
@@ -32,6 +32,7 @@
 #pragma once
 
 #include <boost/thread/mutex.hpp>
+#include <limits>
 #include <set>
 #include <string>
 
@@ -155,6 +156,12 @@ public:
 
     std::vector<std::unique_ptr<RecordCursor>> getManyCursors(OperationContext* txn) const final;
 
+    std::unique_ptr<RecordStoreBulkLoader> getBulkLoader(OperationContext* txn) final;
+
+    std::unique_ptr<RecordCursor> getCursorForRange(OperationContext* txn,
+                                                    const RecordId& start,
+                                                    const RecordId& end) const final;
+
     virtual Status truncate(OperationContext* txn);
 
     virtual bool compactSupported() const {
@@ -179,6 +186,8 @@ public:
                                    BSONObjBuilder* result,
                                    double scale) const;
 
+    void appendStorageIOStats(OperationContext* txn, BSONObjBuilder* result) const override;
+
     virtual Status touch(OperationContext* txn, BSONObjBuilder* output) const;
 
     virtual void temp_cappedTruncateAfter(OperationContext* txn, RecordId end, bool inclusive);
@@ -221,7 +230,14 @@ public:
 
     bool inShutdown() const;
 
-    void reclaimOplog(OperationContext* txn);
+    /**
+     * Truncates the oldest oplog stones while there are more than the record store wants to keep,
+     * stopping early once at least 'maxBytes' have been reclaimed, unless the oplog is far enough
+     * over its maximum size that the limit should be ignored. Returns the number of bytes
+     * reclaimed.
+     */
+    int64_t reclaimOplog(OperationContext* txn,
+                         int64_t maxBytes = std::numeric_limits<int64_t>::max());
 
     int64_t cappedDeleteAsNeeded(OperationContext* txn, const RecordId& justInserted);
 
@@ -244,6 +260,7 @@ public:
 private:
     class Cursor;
     class RandomCursor;
+    class BulkLoader;
 
     class CappedInsertChange;
     class NumRecordsChange;
@@ -296,6 +313,10 @@ private:
     RecordId _oplog_visibleTo;
     RecordId _oplog_highestSeen;
     mutable stdx::mutex _uncommittedRecordIdsMutex;
+    // The repr of the front of '_uncommittedRecordIds', or 0 if it is empty. Only written while
+    // holding '_uncommittedRecordIdsMutex', so that cursors, which check the visibility of every
+    // record they return, can read it without taking the mutex.
+    AtomicInt64 _lowestUncommittedRecordId;
 
     AtomicInt64 _nextIdNum;
     AtomicInt64 _dataSize;
@@ -34,16 +34,20 @@
 #include <set>
 
 #include "mongo/base/checked_cast.h"
+#include "mongo/base/counter.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/client.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
+#include "mongo/db/stats/timer_stats.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/background.h"
 #include "mongo/util/exit.h"
@@ -56,6 +60,17 @@ namespace {
 std::set<NamespaceString> _backgroundThreadNamespaces;
 stdx::mutex _backgroundThreadMutex;
 
+// Maximum rate, in bytes per second, at which the background thread truncates the oplog. Zero
+// means unlimited. The limit is ignored when the oplog grows far beyond its maximum size.
+MONGO_EXPORT_SERVER_PARAMETER(oplogTruncationMaxBytesPerSecond, long long, 0);
+
+Counter64 oplogTruncationBytesReclaimed;
+ServerStatusMetricField<Counter64> displayOplogTruncationBytesReclaimed(
+    "storage.oplogTruncation.bytesReclaimed", &oplogTruncationBytesReclaimed);
+TimerStats oplogTruncationTimer;
+ServerStatusMetricField<TimerStats> displayOplogTruncationTimer("storage.oplogTruncation.passes",
+                                                                &oplogTruncationTimer);
+
 class WiredTigerRecordStoreThread : public BackgroundJob {
 public:
     WiredTigerRecordStoreThread(const NamespaceString& ns)
@@ -68,9 +83,11 @@ public:
     }
 
     /**
-     * Returns true iff there was an oplog to delete from.
+     * Returns true iff there was an oplog to delete from. Sets 'throttleMillis' to how long the
+     * caller should wait, once no locks are held, to keep truncation within
+     * oplogTruncationMaxBytesPerSecond.
      */
-    bool _deleteExcessDocuments() {
+    bool _deleteExcessDocuments(long long* throttleMillis) {
         if (!getGlobalServiceContext()->getGlobalStorageEngine()) {
             LOG(2) << "no global storage engine yet";
             return false;
@@ -103,7 +120,18 @@ public:
             if (!rs->yieldAndAwaitOplogDeletionRequest(&txn)) {
                 return false;  // Oplog went away.
             }
-            rs->reclaimOplog(&txn);
+
+            const long long maxBytesPerSecond = oplogTruncationMaxBytesPerSecond.load();
+            TimerHolder timer(&oplogTruncationTimer);
+            if (maxBytesPerSecond > 0) {
+                // Spend at most one second's budget per pass, then wait out whatever part of the
+                // time it allots to the reclaimed bytes the truncation itself didn't take.
+                const int64_t bytesReclaimed = rs->reclaimOplog(&txn, maxBytesPerSecond);
+                oplogTruncationBytesReclaimed.increment(bytesReclaimed);
+                *throttleMillis = bytesReclaimed * 1000 / maxBytesPerSecond - timer.millis();
+            } else {
+                oplogTruncationBytesReclaimed.increment(rs->reclaimOplog(&txn));
+            }
         } catch (const std::exception& e) {
             severe() << "error in WiredTigerRecordStoreThread: " << e.what();
             fassertFailedNoTrace(!"error in WiredTigerRecordStoreThread");
@@ -117,8 +145,11 @@ public:
         Client::initThread(_name.c_str());
 
         while (!inShutdown()) {
-            if (!_deleteExcessDocuments()) {
+            long long throttleMillis = 0;
+            if (!_deleteExcessDocuments(&throttleMillis)) {
                 sleepmillis(1000);  // Back off in case there were problems deleting.
+            } else if (throttleMillis > 0) {
+                sleepmillis(throttleMillis);
             }
         }
     }
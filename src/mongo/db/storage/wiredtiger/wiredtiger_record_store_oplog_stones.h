@@ -38,6 +38,7 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
 class OperationContext;
 class RecordId;
 
@@ -61,6 +62,12 @@ public:
         return _stones.size() > _numStonesToKeep;
     }
 
+    // True if there are so many more stones than '_numStonesToKeep' that truncation should no
+    // longer be throttled.
+    bool hasExcessStonesUnderPressure() const {
+        return _stones.size() > 2 * _numStonesToKeep;
+    }
+
     void awaitHasExcessStonesOrDead();
 
     boost::optional<OplogStones::Stone> peekOldestStoneIfNeeded() const;
@@ -81,6 +88,10 @@ public:
                                               int64_t bytesRemoved,
                                               RecordId firstRemovedId);
 
+    // Appends the number of stones and the amount of data waiting to be truncated to 'builder',
+    // scaling byte counts by 'scale'.
+    void appendStats(BSONObjBuilder* builder, double scale) const;
+
     // The start point of where to truncate next. Used by the background reclaim thread to
     // efficiently truncate records with WiredTiger by skipping over tombstones, etc.
     RecordId firstRecord;
@@ -48,6 +48,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -667,6 +668,48 @@ TEST(WiredTigerRecordStoreTest, OplogHackOnNonOplog) {
     ASSERT_EQ(rs->oplogStartHack(opCtx.get(), RecordId(0, 1)), boost::none);
 }
 
+TEST(WiredTigerRecordStoreTest, BulkLoader) {
+    unique_ptr<HarnessHelper> harnessHelper(newHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    std::vector<RecordId> ids;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        auto loader = rs->getBulkLoader(opCtx.get());
+        ASSERT(loader);
+        for (int i = 0; i < 10; i++) {
+            std::string data = str::stream() << "record" << i;
+            StatusWith<RecordId> res = loader->insertRecord(data.c_str(), data.size() + 1);
+            ASSERT_OK(res.getStatus());
+            if (!ids.empty()) {
+                ASSERT_LT(ids.back(), res.getValue());
+            }
+            ids.push_back(res.getValue());
+        }
+        ASSERT_OK(loader->commit(opCtx.get()));
+    }
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(10, rs->numRecords(opCtx.get()));
+        for (int i = 0; i < 10; i++) {
+            std::string data = str::stream() << "record" << i;
+            ASSERT_EQUALS(data, rs->dataFor(opCtx.get(), ids[i]).data());
+        }
+
+        // Only an empty record store can be loaded in bulk.
+        ASSERT_FALSE(rs->getBulkLoader(opCtx.get()));
+    }
+}
+
+TEST(WiredTigerRecordStoreTest, BulkLoaderNotForCapped) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newCappedRecordStore("a.b", 100000, 10000));
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper->newOperationContext());
+    ASSERT_FALSE(rs->getBulkLoader(opCtx.get()));
+}
+
 TEST(WiredTigerRecordStoreTest, CappedOrder) {
     unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
     unique_ptr<RecordStore> rs(harnessHelper->newCappedRecordStore("a.b", 100000, 10000));
@@ -983,6 +1026,36 @@ TEST(WiredTigerRecordStoreTest, CappedCursorYieldFirst) {
     ASSERT(!cursor->next());
 }
 
+// Verify that a read-ahead hint, including ids of records that don't exist, leaves the cursor
+// where it was.
+TEST(WiredTigerRecordStoreTest, CursorReadAheadKeepsPosition) {
+    WiredTigerHarnessHelper harnessHelper;
+    unique_ptr<RecordStore> rs(harnessHelper.newNonCappedRecordStore("a.b"));
+
+    std::vector<RecordId> ids;
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < 5; i++) {
+            StatusWith<RecordId> res = rs->insertRecord(opCtx.get(), "a", 2, false);
+            ASSERT_OK(res.getStatus());
+            ids.push_back(res.getValue());
+        }
+        uow.commit();
+    }
+
+    ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+    auto cursor = rs->getCursor(opCtx.get());
+    ASSERT(cursor->seekExact(ids[1]));
+
+    cursor->readAhead({ids[4], RecordId(ids[4].repr() + 100), ids[0], ids[3]});
+
+    auto record = cursor->next();
+    ASSERT(record);
+    ASSERT_EQ(ids[2], record->id);
+    ASSERT(cursor->seekExact(ids[4]));
+}
+
 BSONObj makeBSONObjWithSize(const Timestamp& opTime, int size, char fill = 'x') {
     BSONObj objTemplate = BSON("ts" << opTime << "str"
                                     << "");
@@ -1379,6 +1452,64 @@ TEST(WiredTigerRecordStoreTest, OplogStones_ReclaimStones) {
     }
 }
 
+// Verify that reclaiming the oplog stops once the byte limit is reached, unless there are so many
+// excess stones that the limit is ignored.
+TEST(WiredTigerRecordStoreTest, OplogStones_ReclaimStonesWithByteLimit) {
+    WiredTigerHarnessHelper harnessHelper;
+
+    const int64_t cappedMaxSize = 10 * 1024;  // 10KB
+    unique_ptr<RecordStore> rs(
+        harnessHelper.newCappedRecordStore("local.oplog.stones", cappedMaxSize, -1));
+
+    WiredTigerRecordStore* wtrs = static_cast<WiredTigerRecordStore*>(rs.get());
+    WiredTigerRecordStore::OplogStones* oplogStones = wtrs->oplogStones();
+
+    oplogStones->setMinBytesPerStone(100);
+    oplogStones->setNumStonesToKeep(2U);
+
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 1), 100), RecordId(1, 1));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 2), 110), RecordId(1, 2));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 3), 120), RecordId(1, 3));
+        ASSERT_EQ(insertBSONWithSize(opCtx.get(), rs.get(), Timestamp(1, 4), 130), RecordId(1, 4));
+
+        ASSERT_EQ(4U, oplogStones->numStones());
+
+        BSONObjBuilder builder;
+        oplogStones->appendStats(&builder, 1);
+        BSONObj stats = builder.obj();
+        ASSERT_EQ(4, stats["numStones"].numberLong());
+        ASSERT_EQ(2, stats["excessStones"].numberLong());
+        ASSERT_EQ(2, stats["excessRecords"].numberLong());
+        ASSERT_EQ(210, stats["excessSize"].numberLong());
+    }
+
+    // Only a single stone is truncated once the limit is reached.
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+
+        ASSERT_EQ(100, wtrs->reclaimOplog(opCtx.get(), 1));
+
+        ASSERT_EQ(3, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(360, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(3U, oplogStones->numStones());
+    }
+
+    // The limit is ignored while there are more than twice as many stones as there are to keep.
+    oplogStones->setNumStonesToKeep(1U);
+    {
+        ServiceContext::UniqueOperationContext opCtx(harnessHelper.newOperationContext());
+
+        ASSERT_EQ(110, wtrs->reclaimOplog(opCtx.get(), 1));
+
+        ASSERT_EQ(2, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(250, rs->dataSize(opCtx.get()));
+        ASSERT_EQ(2U, oplogStones->numStones());
+    }
+}
+
 // Verify that oplog stones are not reclaimed even if the size of the record store exceeds
 // 'cappedMaxSize'.
 TEST(WiredTigerRecordStoreTest, OplogStones_ExceedCappedMaxSize) {
@@ -78,6 +78,7 @@ void WiredTigerRecoveryUnit::prepareForCreateSnapshot(OperationContext* opCtx) {
     invariant(!_active);  // Can't already be in a WT transaction.
     invariant(!_inUnitOfWork);
     invariant(!_readFromMajorityCommittedSnapshot);
+    invariant(!_readFromLastAppliedSnapshot);
 
     // Starts the WT transaction that will be the basis for creating a named snapshot.
     getSession(opCtx);
@@ -235,6 +236,28 @@ boost::optional<SnapshotName> WiredTigerRecoveryUnit::getMajorityCommittedSnapsh
     return _majorityCommittedSnapshot;
 }
 
+Status WiredTigerRecoveryUnit::setReadFromLastAppliedSnapshot() {
+    auto snapshotName = _sessionCache->snapshotManager().getNewestSnapshot();
+    if (!snapshotName) {
+        return {ErrorCodes::SnapshotUnavailable, "No named snapshot has been created yet."};
+    }
+
+    _lastAppliedSnapshot = *snapshotName;
+    _readFromLastAppliedSnapshot = true;
+    return Status::OK();
+}
+
+void WiredTigerRecoveryUnit::clearReadFromLastAppliedSnapshot() {
+    invariant(!_active);
+    _readFromLastAppliedSnapshot = false;
+}
+
+boost::optional<SnapshotName> WiredTigerRecoveryUnit::getLastAppliedSnapshot() const {
+    if (!_readFromLastAppliedSnapshot)
+        return {};
+    return _lastAppliedSnapshot;
+}
+
 void WiredTigerRecoveryUnit::_txnOpen(OperationContext* opCtx) {
     invariant(!_active);
     _ensureSession();
@@ -244,6 +267,8 @@ void WiredTigerRecoveryUnit::_txnOpen(OperationContext* opCtx) {
     if (_readFromMajorityCommittedSnapshot) {
         _majorityCommittedSnapshot =
             _sessionCache->snapshotManager().beginTransactionOnCommittedSnapshot(s);
+    } else if (_readFromLastAppliedSnapshot) {
+        _lastAppliedSnapshot = _sessionCache->snapshotManager().beginTransactionOnNewestSnapshot(s);
     } else {
         invariantWTOK(s->begin_transaction(s, NULL));
     }
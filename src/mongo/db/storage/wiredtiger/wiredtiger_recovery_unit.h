@@ -79,6 +79,10 @@ public:
 
     boost::optional<SnapshotName> getMajorityCommittedSnapshot() const final;
 
+    Status setReadFromLastAppliedSnapshot() final;
+    void clearReadFromLastAppliedSnapshot() final;
+    boost::optional<SnapshotName> getLastAppliedSnapshot() const final;
+
     // ---- WT STUFF
 
     WiredTigerSession* getSession(OperationContext* opCtx);
@@ -140,6 +144,8 @@ private:
     RecordId _oplogReadTill;
     bool _readFromMajorityCommittedSnapshot = false;
     SnapshotName _majorityCommittedSnapshot = SnapshotName::min();
+    bool _readFromLastAppliedSnapshot = false;
+    SnapshotName _lastAppliedSnapshot = SnapshotName::min();
 
     typedef OwnedPointerVector<Change> Changes;
     Changes _changes;
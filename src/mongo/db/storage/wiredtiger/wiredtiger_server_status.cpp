@@ -76,7 +76,18 @@ BSONObj WiredTigerServerStatusSection::generateSection(OperationContext* txn,
 
     WiredTigerKVEngine::appendGlobalStats(bob);
 
+    {
+        BSONObjBuilder cursorCacheBuilder(bob.subobjStart("sessionCursorCache"));
+        WiredTigerSessionCache::appendCursorCacheStats(&cursorCacheBuilder);
+    }
+
     return bob.obj();
 }
 
+Milliseconds WiredTigerServerStatusSection::cacheDuration() const {
+    // Well under the one second period of diagnostic data capture, so that every sample it takes
+    // is fresh.
+    return Milliseconds(500);
+}
+
 }  // namespace mongo
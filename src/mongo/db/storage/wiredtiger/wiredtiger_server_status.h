@@ -45,6 +45,12 @@ public:
     virtual bool includeByDefault() const;
     virtual BSONObj generateSection(OperationContext* txn, const BSONElement& configElement) const;
 
+    /**
+     * Reading the statistics cursor goes through every statistic of the connection, so callers
+     * polling at the same time share the result.
+     */
+    virtual Milliseconds cacheDuration() const;
+
 private:
     WiredTigerKVEngine* _engine;
 };
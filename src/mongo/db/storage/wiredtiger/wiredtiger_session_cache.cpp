@@ -35,7 +35,12 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include <functional>
+#include <iterator>
+
 #include "mongo/base/error_codes.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/journal_listener.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
@@ -43,6 +48,7 @@
 #include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -68,16 +74,20 @@ WiredTigerSession::~WiredTigerSession() {
 }
 
 WT_CURSOR* WiredTigerSession::getCursor(const std::string& uri, uint64_t id, bool forRecordStore) {
-    // Find the most recently used cursor
-    for (CursorCache::iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        if (i->_id == id) {
-            WT_CURSOR* c = i->_cursor;
-            _cursors.erase(i);
-            _cursorsOut++;
-            _cursorsCached--;
-            return c;
-        }
+    // Find the most recently used cursor. Index entries are kept when they become empty, as the
+    // same tables tend to be used over and over.
+    CursorCacheIndex::iterator indexIt = _cursorIndex.find(id);
+    if (indexIt != _cursorIndex.end() && !indexIt->second.empty()) {
+        CursorCache::iterator i = indexIt->second.back();
+        indexIt->second.pop_back();
+        WT_CURSOR* c = i->_cursor;
+        _cursors.erase(i);
+        _cursorsOut++;
+        _cursorsCached--;
+        _cursorCacheHits++;
+        return c;
     }
+    _cursorCacheMisses++;
 
     WT_CURSOR* c = NULL;
     int ret = _session->open_cursor(
@@ -98,6 +108,7 @@ void WiredTigerSession::releaseCursor(uint64_t id, WT_CURSOR* cursor) {
 
     // Cursors are pushed to the front of the list and removed from the back
     _cursors.push_front(WiredTigerCachedCursor(id, _cursorGen++, cursor));
+    _cursorIndex[id].push_back(_cursors.begin());
     _cursorsCached++;
 
     // "Old" is defined as not used in the last N**2 operations, if we have N cursors cached.
@@ -106,6 +117,11 @@ void WiredTigerSession::releaseCursor(uint64_t id, WT_CURSOR* cursor) {
     // would like to cache N cursors in that case, so any given cursor could go N**2 operations
     // in between use.
     while (_cursorGen - _cursors.back()._gen > 10000) {
+        // The oldest cursor in the cache is also the oldest one cached for its ID.
+        std::vector<CursorCache::iterator>& sameId = _cursorIndex[_cursors.back()._id];
+        dassert(sameId.front() == std::prev(_cursors.end()));
+        sameId.erase(sameId.begin());
+
         cursor = _cursors.back()._cursor;
         _cursors.pop_back();
         _cursorsCached--;
@@ -122,10 +138,19 @@ void WiredTigerSession::closeAllCursors() {
         }
     }
     _cursors.clear();
+    _cursorIndex.clear();
 }
 
 namespace {
 AtomicUInt64 nextTableId(1);
+
+// Cursor cache statistics, accumulated from each session as it is released.
+AtomicUInt64 cursorCacheHits;
+AtomicUInt64 cursorCacheMisses;
+
+// How long, in microseconds, the thread that is about to flush the journal on behalf of all
+// waiting writers waits first, so that more concurrent writers can join its group commit.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerJournalCommitBatchWindowMicros, int, 0);
 }
 // static
 uint64_t WiredTigerSession::genTableId() {
@@ -197,6 +222,13 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint) {
         // Someone else synced already since we read lastSyncTime, so we're done!
         return;
     }
+
+    // Writers that arrive while we wait read the same lastSyncTime as we did and block on the
+    // mutex, so the flush below covers them and they return without flushing again.
+    const int batchWindowMicros = wiredTigerJournalCommitBatchWindowMicros.load();
+    if (batchWindowMicros > 0 && _engine->isDurable()) {
+        sleepmicros(batchWindowMicros);
+    }
     _lastSyncTime.store(current + 1);
 
     // Nobody has synched yet, so we have to sync ourselves.
@@ -220,20 +252,29 @@ void WiredTigerSessionCache::waitUntilDurable(bool forceCheckpoint) {
 }
 
 void WiredTigerSessionCache::closeAll() {
-    // Increment the epoch as we are now closing all sessions with this epoch
-    SessionCache swap;
+    // Increment the epoch as we are now closing all sessions with this epoch. Sessions released
+    // into a partition after we have emptied it see the new epoch and are not cached.
+    _epoch.fetchAndAdd(1);
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
-    }
+    for (auto& partition : _partitions) {
+        SessionCache swap;
+
+        {
+            stdx::lock_guard<stdx::mutex> lock(partition.lock);
+            partition.sessions.swap(swap);
+        }
 
-    for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
-        delete (*i);
+        for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
+            delete (*i);
+        }
     }
 }
 
+// static
+size_t WiredTigerSessionCache::_partitionForThisThread() {
+    return std::hash<stdx::thread::id>()(stdx::this_thread::get_id()) % kNumPartitions;
+}
+
 bool WiredTigerSessionCache::isEphemeral() {
     return _engine && _engine->isEphemeral();
 }
@@ -243,13 +284,16 @@ UniqueWiredTigerSession WiredTigerSessionCache::getSession() {
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) {
+    // Start with our own partition, then try the others in turn.
+    const size_t firstPartition = _partitionForThisThread();
+    for (size_t i = 0; i < kNumPartitions; i++) {
+        SessionCachePartition& partition = _partitions[(firstPartition + i) % kNumPartitions];
+        stdx::lock_guard<stdx::mutex> lock(partition.lock);
+        if (!partition.sessions.empty()) {
             // Get the most recently used session so that if we discard sessions, we're
             // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
+            WiredTigerSession* cachedSession = partition.sessions.back();
+            partition.sessions.pop_back();
             return UniqueWiredTigerSession(cachedSession);
         }
     }
@@ -282,14 +326,24 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
         invariant(range == 0);
     }
 
+    if (session->_cursorCacheHits) {
+        cursorCacheHits.fetchAndAdd(session->_cursorCacheHits);
+        session->_cursorCacheHits = 0;
+    }
+    if (session->_cursorCacheMisses) {
+        cursorCacheMisses.fetchAndAdd(session->_cursorCacheMisses);
+        session->_cursorCacheMisses = 0;
+    }
+
     bool returnedToCache = false;
     uint64_t currentEpoch = _epoch.load();
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        SessionCachePartition& partition = _partitions[_partitionForThisThread()];
+        stdx::lock_guard<stdx::mutex> lock(partition.lock);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            partition.sessions.push_back(session);
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -307,6 +361,12 @@ void WiredTigerSessionCache::setJournalListener(JournalListener* jl) {
     _journalListener = jl;
 }
 
+// static
+void WiredTigerSessionCache::appendCursorCacheStats(BSONObjBuilder* builder) {
+    builder->append("hits", static_cast<long long>(cursorCacheHits.load()));
+    builder->append("misses", static_cast<long long>(cursorCacheMisses.load()));
+}
+
 void WiredTigerSessionCache::WiredTigerSessionDeleter::operator()(
     WiredTigerSession* session) const {
     session->_cache->releaseSession(session);
@@ -33,6 +33,8 @@
 
 #include <list>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 #include <boost/thread/shared_mutex.hpp>
 #include <wiredtiger.h>
@@ -45,6 +47,7 @@
 
 namespace mongo {
 
+class BSONObjBuilder;
 class WiredTigerKVEngine;
 class WiredTigerSessionCache;
 
@@ -112,8 +115,11 @@ public:
 private:
     friend class WiredTigerSessionCache;
 
-    // The cursor cache is a list of pairs that contain an ID and cursor
+    // The cursor cache is a list of pairs that contain an ID and cursor, most recently released
+    // first. It is indexed by ID so that getCursor() need not scan it; each index entry holds the
+    // cached cursors for that ID, least recently released first.
     typedef std::list<WiredTigerCachedCursor> CursorCache;
+    typedef std::unordered_map<uint64_t, std::vector<CursorCache::iterator>> CursorCacheIndex;
 
     // Used internally by WiredTigerSessionCache
     uint64_t _getEpoch() const {
@@ -124,8 +130,14 @@ private:
     WiredTigerSessionCache* _cache;  // not owned
     WT_SESSION* _session;            // owned
     CursorCache _cursors;            // owned
+    CursorCacheIndex _cursorIndex;
     uint64_t _cursorGen;
     int _cursorsCached, _cursorsOut;
+
+    // Cursor cache lookups since this session was last returned to the WiredTigerSessionCache,
+    // which adds them to its global statistics.
+    uint64_t _cursorCacheHits = 0;
+    uint64_t _cursorCacheMisses = 0;
 };
 
 /**
@@ -187,6 +199,11 @@ public:
 
     void setJournalListener(JournalListener* jl);
 
+    /**
+     * Appends the number of cursor cache hits and misses of all sessions released so far.
+     */
+    static void appendCursorCacheStats(BSONObjBuilder* builder);
+
 private:
     WiredTigerKVEngine* _engine;  // not owned, might be NULL
     WT_CONNECTION* _conn;         // not owned
@@ -198,9 +215,17 @@ private:
     AtomicUInt32 _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
     typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
+
+    // Released sessions are cached in several partitions with a lock each, so that concurrent
+    // threads getting and releasing sessions rarely contend. A thread uses the partition its id
+    // hashes to, and takes a session from another partition when its own is empty.
+    static const size_t kNumPartitions = 16;
+    struct SessionCachePartition {
+        stdx::mutex lock;
+        SessionCache sessions;
+    };
+    SessionCachePartition _partitions[kNumPartitions];
 
     // Bumped when all open sessions need to be closed
     AtomicUInt64 _epoch;  // atomic so we can check it outside of the lock
@@ -219,6 +244,11 @@ private:
      * session and releasing it, the session is directly released. This method is thread safe.
      */
     void releaseSession(WiredTigerSession* session);
+
+    /**
+     * Returns the index of the partition the current thread should use.
+     */
+    static size_t _partitionForThisThread();
 };
 
 /**
@@ -49,7 +49,13 @@ Status WiredTigerSnapshotManager::prepareForCreateSnapshot(OperationContext* txn
 Status WiredTigerSnapshotManager::createSnapshot(OperationContext* txn, const SnapshotName& name) {
     auto session = WiredTigerRecoveryUnit::get(txn)->getSession(txn)->getSession();
     const std::string config = str::stream() << "name=" << name.asU64();
-    return wtRCToStatus(session->snapshot(session, config.c_str()));
+    Status status = wtRCToStatus(session->snapshot(session, config.c_str()));
+    if (status.isOK()) {
+        stdx::lock_guard<stdx::mutex> lock(_mutex);
+        invariant(!_newestSnapshot || *_newestSnapshot < name);
+        _newestSnapshot = name;
+    }
+    return status;
 }
 
 void WiredTigerSnapshotManager::setCommittedSnapshot(const SnapshotName& name) {
@@ -73,6 +79,7 @@ void WiredTigerSnapshotManager::cleanupUnneededSnapshots() {
 void WiredTigerSnapshotManager::dropAllSnapshots() {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
     _committedSnapshot = boost::none;
+    _newestSnapshot = boost::none;
     invariantWTOK(_session->snapshot(_session, "drop=(all)"));
 }
 
@@ -105,4 +112,24 @@ SnapshotName WiredTigerSnapshotManager::beginTransactionOnCommittedSnapshot(
     return *_committedSnapshot;
 }
 
+SnapshotName WiredTigerSnapshotManager::beginTransactionOnNewestSnapshot(
+    WT_SESSION* session) const {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+
+    uassert(ErrorCodes::SnapshotUnavailable,
+            "Named snapshots were dropped while running operation",
+            _newestSnapshot);
+
+    StringBuilder config;
+    config << "snapshot=" << _newestSnapshot->asU64();
+    invariantWTOK(session->begin_transaction(session, config.str().c_str()));
+
+    return *_newestSnapshot;
+}
+
+boost::optional<SnapshotName> WiredTigerSnapshotManager::getNewestSnapshot() const {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    return _newestSnapshot;
+}
+
 }  // namespace mongo
@@ -83,9 +83,26 @@ public:
      */
     boost::optional<SnapshotName> getMinSnapshotForNextCommittedRead() const;
 
+    /**
+     * Starts a transaction on the most recently created snapshot and returns its SnapshotName.
+     *
+     * Throws if there are currently no snapshots.
+     */
+    SnapshotName beginTransactionOnNewestSnapshot(WT_SESSION* session) const;
+
+    /**
+     * Returns the name of the most recently created snapshot, or boost::none if there are
+     * currently no snapshots. Like getMinSnapshotForNextCommittedRead(), this is a lower bound
+     * for the snapshot used by the next call to beginTransactionOnNewestSnapshot().
+     */
+    boost::optional<SnapshotName> getNewestSnapshot() const;
+
 private:
     mutable stdx::mutex _mutex;  // Guards all members.
     boost::optional<SnapshotName> _committedSnapshot;
+
+    // Never older than '_committedSnapshot', so it is not dropped by cleanupUnneededSnapshots().
+    boost::optional<SnapshotName> _newestSnapshot;
     WT_SESSION* _session;  // only used for dropping snapshots.
 };
 }
@@ -35,6 +35,7 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 
+#include <algorithm>
 #include <limits>
 
 #include "mongo/bson/bsonobjbuilder.h"
@@ -497,4 +498,58 @@ Status WiredTigerUtil::exportTableToBSON(WT_SESSION* session,
     return Status::OK();
 }
 
+Status WiredTigerUtil::appendStorageIOStats(WT_SESSION* session,
+                                            const std::string& uri,
+                                            BSONObjBuilder* bob) {
+    invariant(session);
+    invariant(bob);
+    const std::string statsURI = "statistics:" + uri;
+    WT_CURSOR* c = NULL;
+    int ret = session->open_cursor(session, statsURI.c_str(), NULL, "statistics=(fast)", &c);
+    if (ret != 0) {
+        return Status(ErrorCodes::CursorNotFound,
+                      str::stream() << "unable to open cursor at URI " << statsURI
+                                    << ". reason: "
+                                    << wiredtiger_strerror(ret));
+    }
+    invariant(c);
+    ON_BLOCK_EXIT(c->close, c);
+
+    // Statistics the data source doesn't keep, such as those of other table types, read as zero.
+    auto getStat = [c](int key) -> long long {
+        uint64_t value;
+        c->set_key(c, key);
+        if (c->search(c) != 0 || c->get_value(c, NULL, NULL, &value) != 0) {
+            return 0;
+        }
+        return _castStatisticsValue<long long>(value);
+    };
+
+    const long long pagesRequested = getStat(WT_STAT_DSRC_CACHE_PAGES_REQUESTED);
+    const long long pagesRead = getStat(WT_STAT_DSRC_CACHE_READ);
+    bob->appendNumber("bytesReadIntoCache", getStat(WT_STAT_DSRC_CACHE_BYTES_READ));
+    bob->appendNumber("bytesWrittenFromCache", getStat(WT_STAT_DSRC_CACHE_BYTES_WRITE));
+    bob->appendNumber("pagesRequestedFromCache", pagesRequested);
+    bob->appendNumber("pagesReadIntoCache", pagesRead);
+    bob->appendNumber("pagesWrittenFromCache", getStat(WT_STAT_DSRC_CACHE_WRITE));
+    bob->appendNumber("pagesEvicted",
+                      getStat(WT_STAT_DSRC_CACHE_EVICTION_CLEAN) +
+                          getStat(WT_STAT_DSRC_CACHE_EVICTION_DIRTY));
+    if (pagesRequested > 0) {
+        const long long pagesFoundInCache = std::max(0LL, pagesRequested - pagesRead);
+        bob->append("cacheHitPercent", 100.0 * pagesFoundInCache / pagesRequested);
+    }
+
+    BSONObjBuilder cursor(bob->subobjStart("cursor"));
+    cursor.appendNumber("insert", getStat(WT_STAT_DSRC_CURSOR_INSERT));
+    cursor.appendNumber("update", getStat(WT_STAT_DSRC_CURSOR_UPDATE));
+    cursor.appendNumber("remove", getStat(WT_STAT_DSRC_CURSOR_REMOVE));
+    cursor.appendNumber("search", getStat(WT_STAT_DSRC_CURSOR_SEARCH));
+    cursor.appendNumber("searchNear", getStat(WT_STAT_DSRC_CURSOR_SEARCH_NEAR));
+    cursor.appendNumber("next", getStat(WT_STAT_DSRC_CURSOR_NEXT));
+    cursor.appendNumber("prev", getStat(WT_STAT_DSRC_CURSOR_PREV));
+    cursor.done();
+    return Status::OK();
+}
+
 }  // namespace mongo
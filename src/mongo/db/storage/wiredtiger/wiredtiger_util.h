@@ -114,6 +114,14 @@ public:
                                     const std::string& config,
                                     BSONObjBuilder* bob);
 
+    /**
+     * Appends a summary of the cache and I/O activity of the table or index at 'uri' to 'bob':
+     * bytes and pages read into and written from the cache, pages evicted, the percentage of page
+     * requests served from the cache, and cursor operation counts. Reads the data source's
+     * statistics in fast mode, which WiredTiger maintains continuously.
+     */
+    static Status appendStorageIOStats(WT_SESSION* s, const std::string& uri, BSONObjBuilder* bob);
+
     /**
      * Gets entire metadata string for collection/index at URI.
      */
@@ -0,0 +1,842 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/summary_collection.h"
+
+#include <limits>
+#include <list>
+#include <map>
+
+#include "mongo/db/bson/dotted_path_support.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/collection_catalog_entry.h"
+#include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/database_catalog_entry.h"
+#include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/catalog/document_validation.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/dbhelpers.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
+#include "mongo/db/op_observer.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/internal_plans.h"
+#include "mongo/db/query/query_request.h"
+#include "mongo/db/service_context.h"
+#include "mongo/platform/overflow_arithmetic.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace dps = ::mongo::dotted_path_support;
+
+namespace {
+
+const auto getSummaryCatalog = ServiceContext::declareDecoration<SummaryCatalog>();
+
+/**
+ * Parses the field path 'elem', such as "$a.b", into its dotted path.
+ */
+StatusWith<std::string> parseFieldPath(const BSONElement& elem) {
+    if (elem.type() != String || elem.valueStringData().size() < 2 ||
+        elem.valueStringData()[0] != '$') {
+        return {ErrorCodes::BadValue,
+                str::stream() << "'" << elem.fieldNameStringData()
+                              << "' has to be a field path, such as \"$a.b\"."};
+    }
+
+    StringData path = elem.valueStringData().substr(1);
+    for (size_t start = 0; start <= path.size();) {
+        size_t end = path.find('.', start);
+        if (end == std::string::npos) {
+            end = path.size();
+        }
+        if (end == start || path[start] == '$') {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "'" << elem.valueStringData()
+                                  << "' is not a valid field path."};
+        }
+        start = end + 1;
+    }
+
+    return path.toString();
+}
+
+/**
+ * Returns whether the source document 'doc' has a value for a $min or $max to consider.
+ */
+bool isComparable(const BSONElement& value) {
+    return !value.eoo() && !value.isNull() && value.type() != Undefined;
+}
+
+/**
+ * Returns 'total' plus, or if 'subtract' is set minus, the number 'operand', as the only element
+ * of an object. An EOO 'total' stands for an int 0. The result widens the way $sum does: ints
+ * overflow into longs, longs into doubles, and a double or decimal operand makes it one.
+ */
+BSONObj addNumbers(const BSONElement& total, const BSONElement& operand, bool subtract) {
+    const BSONType totalType = total.eoo() ? NumberInt : total.type();
+
+    BSONObjBuilder bob;
+    if (totalType == NumberDecimal || operand.type() == NumberDecimal) {
+        const Decimal128 lhs = total.eoo() ? Decimal128(0) : total.numberDecimal();
+        bob.append("", subtract ? lhs.subtract(operand.numberDecimal())
+                                : lhs.add(operand.numberDecimal()));
+    } else if (totalType == NumberDouble || operand.type() == NumberDouble) {
+        const double rhs = operand.numberDouble();
+        bob.append("", total.numberDouble() + (subtract ? -rhs : rhs));
+    } else {
+        const int64_t lhs = total.numberLong();
+        const int64_t rhs = operand.numberLong();
+        int64_t result;
+        if (subtract ? mongoSignedSubtractOverflow64(lhs, rhs, &result)
+                     : mongoSignedAddOverflow64(lhs, rhs, &result)) {
+            bob.append("",
+                       static_cast<double>(lhs) +
+                           (subtract ? -static_cast<double>(rhs) : static_cast<double>(rhs)));
+        } else if (totalType == NumberInt && operand.type() == NumberInt &&
+                   result >= std::numeric_limits<int>::min() &&
+                   result <= std::numeric_limits<int>::max()) {
+            bob.append("", static_cast<int>(result));
+        } else {
+            bob.append("", static_cast<long long>(result));
+        }
+    }
+    return bob.obj();
+}
+
+/**
+ * Returns whether replacing the source document 'before' by 'after' leaves every summary of
+ * 'definition' unchanged, which is the case for most updates of fields it does not read.
+ */
+bool contributesAlike(const SummaryDefinition& definition,
+                      const BSONObj& before,
+                      const BSONObj& after) {
+    const bool matchedBefore = definition.matches(before);
+    if (matchedBefore != definition.matches(after)) {
+        return false;
+    }
+    if (!matchedBefore) {
+        return true;
+    }
+    if (!definition.groupKey(before).binaryEqual(definition.groupKey(after))) {
+        return false;
+    }
+
+    for (auto&& accumulator : definition.accumulators()) {
+        if (accumulator.path.empty()) {
+            continue;
+        }
+        BSONElement beforeValue = dps::extractElementAtPath(before, accumulator.path);
+        BSONElement afterValue = dps::extractElementAtPath(after, accumulator.path);
+        if (beforeValue.eoo() != afterValue.eoo() ||
+            (!beforeValue.eoo() && !beforeValue.binaryEqualValues(afterValue))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * The changes that the writes of one operation make to the groups of one summary. They are
+ * gathered before being written back, so that the summary document of a group which several
+ * documents of a batch belong to is read and written only once.
+ */
+class GroupChanges {
+    MONGO_DISALLOW_COPYING(GroupChanges);
+
+public:
+    GroupChanges(OperationContext* txn, const SummaryDefinition& definition, Collection* summary)
+        : _txn(txn), _definition(definition), _summary(summary) {}
+
+    void add(const BSONObj& doc) {
+        _apply(doc, false);
+    }
+
+    void remove(const BSONObj& doc) {
+        _apply(doc, true);
+    }
+
+    /**
+     * Writes the changed summary documents, deleting those of groups left without documents.
+     * 'source' is read to recompute a $min or $max whose value was removed.
+     */
+    void write(Collection* source);
+
+private:
+    struct Group {
+        // The summary document of the group, unless the group is new.
+        RecordId recordId;
+        Snapshotted<BSONObj> original;
+
+        long long count = 0;
+
+        // The value of each accumulator as the only element of an object, or empty for none yet.
+        std::vector<BSONObj> values;
+
+        // Whether the $min or $max value of a removed document has to be looked for again.
+        bool rescan = false;
+    };
+
+    Group& _getGroup(const BSONObj& groupKey);
+    void _apply(const BSONObj& doc, bool remove);
+    void _rescan(Collection* source, const BSONObj& groupKey, Group* group);
+    BSONObj _summaryDocument(const BSONObj& groupKey, const Group& group) const;
+
+    static void _accumulateExtreme(const SummaryDefinition::Accumulator& accumulator,
+                                   const BSONElement& operand,
+                                   BSONObj* value);
+
+    OperationContext* const _txn;
+    const SummaryDefinition& _definition;
+    Collection* const _summary;
+
+    std::map<BSONObj, Group, BSONObjCmp> _groups;
+};
+
+GroupChanges::Group& GroupChanges::_getGroup(const BSONObj& groupKey) {
+    auto it = _groups.find(groupKey);
+    if (it != _groups.end()) {
+        return it->second;
+    }
+
+    Group& group = _groups[groupKey];
+    group.values.resize(_definition.accumulators().size());
+    group.recordId = Helpers::findById(_txn, _summary, BSON("_id" << groupKey.firstElement()));
+    if (group.recordId.isNull()) {
+        return group;
+    }
+
+    group.original = _summary->docFor(_txn, group.recordId);
+    const BSONObj& doc = group.original.value();
+    group.count = doc[SummaryDefinition::kCountField].safeNumberLong();
+    for (size_t i = 0; i < _definition.accumulators().size(); ++i) {
+        BSONElement value = doc[_definition.accumulators()[i].name];
+        if (isComparable(value)) {
+            group.values[i] = value.wrap("");
+        }
+    }
+    return group;
+}
+
+void GroupChanges::_apply(const BSONObj& doc, bool remove) {
+    if (!_definition.matches(doc)) {
+        return;
+    }
+
+    Group& group = _getGroup(_definition.groupKey(doc));
+    group.count += remove ? -1 : 1;
+
+    for (size_t i = 0; i < _definition.accumulators().size(); ++i) {
+        const auto& accumulator = _definition.accumulators()[i];
+        BSONObj& value = group.values[i];
+        const BSONElement operand = accumulator.path.empty()
+            ? accumulator.constant.firstElement()
+            : dps::extractElementAtPath(doc, accumulator.path);
+
+        switch (accumulator.type) {
+            case SummaryDefinition::AccumulatorType::kCount:
+                // Written from the count of the group.
+                break;
+            case SummaryDefinition::AccumulatorType::kSum:
+                if (operand.isNumber()) {
+                    value = addNumbers(
+                        value.isEmpty() ? BSONElement() : value.firstElement(), operand, remove);
+                }
+                break;
+            case SummaryDefinition::AccumulatorType::kMin:
+            case SummaryDefinition::AccumulatorType::kMax:
+                if (!isComparable(operand)) {
+                    break;
+                }
+                if (!remove) {
+                    _accumulateExtreme(accumulator, operand, &value);
+                } else if (!value.isEmpty() &&
+                           operand.woCompare(value.firstElement(), false) == 0) {
+                    // Another document may hold the same value, or the next one may be anywhere.
+                    group.rescan = true;
+                }
+                break;
+        }
+    }
+}
+
+void GroupChanges::_accumulateExtreme(const SummaryDefinition::Accumulator& accumulator,
+                                      const BSONElement& operand,
+                                      BSONObj* value) {
+    if (value->isEmpty()) {
+        *value = operand.wrap("");
+        return;
+    }
+
+    const int cmp = operand.woCompare(value->firstElement(), false);
+    if (accumulator.type == SummaryDefinition::AccumulatorType::kMin ? cmp < 0 : cmp > 0) {
+        *value = operand.wrap("");
+    }
+}
+
+void GroupChanges::_rescan(Collection* source, const BSONObj& groupKey, Group* group) {
+    const auto& accumulators = _definition.accumulators();
+    for (size_t i = 0; i < accumulators.size(); ++i) {
+        if (accumulators[i].type == SummaryDefinition::AccumulatorType::kMin ||
+            accumulators[i].type == SummaryDefinition::AccumulatorType::kMax) {
+            group->values[i] = BSONObj();
+        }
+    }
+    group->rescan = false;
+
+    if (!source) {
+        return;
+    }
+
+    // The filter and the group key are matched with the simple collation, as when the documents
+    // were added.
+    auto qr = stdx::make_unique<QueryRequest>(source->ns());
+    qr->setFilter(_definition.groupQuery(groupKey));
+    qr->setCollation(BSON("locale"
+                          << "simple"));
+    auto cq = uassertStatusOK(CanonicalQuery::canonicalize(
+        _txn, std::move(qr), ExtensionsCallbackDisallowExtensions()));
+
+    // The group has to be read within the unit of work of the write, which cannot yield.
+    auto exec = uassertStatusOK(
+        getExecutor(_txn, source, std::move(cq), PlanExecutor::YIELD_MANUAL));
+
+    BSONObj doc;
+    PlanExecutor::ExecState state;
+    while (PlanExecutor::ADVANCED == (state = exec->getNext(&doc, nullptr))) {
+        // The query may match documents of other groups whose key is an array or null.
+        if (!_definition.matches(doc) ||
+            _definition.groupKey(doc).woCompare(groupKey, BSONObj(), false) != 0) {
+            continue;
+        }
+
+        for (size_t i = 0; i < accumulators.size(); ++i) {
+            if (accumulators[i].type != SummaryDefinition::AccumulatorType::kMin &&
+                accumulators[i].type != SummaryDefinition::AccumulatorType::kMax) {
+                continue;
+            }
+            BSONElement operand = dps::extractElementAtPath(doc, accumulators[i].path);
+            if (isComparable(operand)) {
+                _accumulateExtreme(accumulators[i], operand, &group->values[i]);
+            }
+        }
+    }
+
+    uassert(40397,
+            str::stream() << "Failed to read a group of " << source->ns().ns()
+                          << " to maintain the summary "
+                          << _definition.ns().ns()
+                          << ": "
+                          << WorkingSetCommon::toStatusString(doc),
+            state == PlanExecutor::IS_EOF);
+}
+
+BSONObj GroupChanges::_summaryDocument(const BSONObj& groupKey, const Group& group) const {
+    BSONObjBuilder bob;
+    bob.appendAs(groupKey.firstElement(), "_id");
+    bob.appendNumber(SummaryDefinition::kCountField, group.count);
+
+    for (size_t i = 0; i < _definition.accumulators().size(); ++i) {
+        const auto& accumulator = _definition.accumulators()[i];
+        const BSONObj& value = group.values[i];
+        switch (accumulator.type) {
+            case SummaryDefinition::AccumulatorType::kCount:
+                bob.appendNumber(accumulator.name, group.count);
+                break;
+            case SummaryDefinition::AccumulatorType::kSum:
+                if (value.isEmpty()) {
+                    bob.append(accumulator.name, 0);
+                } else {
+                    bob.appendAs(value.firstElement(), accumulator.name);
+                }
+                break;
+            case SummaryDefinition::AccumulatorType::kMin:
+            case SummaryDefinition::AccumulatorType::kMax:
+                if (value.isEmpty()) {
+                    bob.appendNull(accumulator.name);
+                } else {
+                    bob.appendAs(value.firstElement(), accumulator.name);
+                }
+                break;
+        }
+    }
+    return bob.obj();
+}
+
+void GroupChanges::write(Collection* source) {
+    DisableDocumentValidation validationDisabler(_txn);
+
+    for (auto&& entry : _groups) {
+        const BSONObj& groupKey = entry.first;
+        Group& group = entry.second;
+
+        if (group.count <= 0) {
+            if (!group.recordId.isNull()) {
+                _summary->deleteDocument(_txn, group.recordId, nullptr);
+            }
+            continue;
+        }
+
+        if (group.rescan) {
+            _rescan(source, groupKey, &group);
+        }
+
+        BSONObj doc = _summaryDocument(groupKey, group);
+        if (group.recordId.isNull()) {
+            uassertStatusOK(_summary->insertDocument(_txn, doc, nullptr, false));
+            continue;
+        }
+        if (doc.binaryEqual(group.original.value())) {
+            continue;
+        }
+
+        OplogUpdateEntryArgs args;
+        args.ns = _summary->ns().ns();
+        args.update = doc;
+        args.criteria = BSON("_id" << groupKey.firstElement());
+        args.fromMigrate = false;
+        uassertStatusOK(_summary->updateDocument(
+            _txn, group.recordId, group.original, doc, false, true, nullptr, &args));
+    }
+}
+
+/**
+ * Lets 'apply' change the groups of the summary of 'definition', then writes them.
+ */
+template <typename Apply>
+void maintainSummary(OperationContext* txn, const SummaryDefinition& definition, Apply apply) {
+    Database* db = dbHolder().get(txn, definition.ns().db());
+    if (!db) {
+        return;
+    }
+
+    // The caller holds an intent lock on the database, for writing the source.
+    Lock::CollectionLock summaryLock(txn->lockState(), definition.ns().ns(), MODE_IX);
+    Collection* summary = db->getCollection(definition.ns());
+    if (!summary) {
+        return;
+    }
+
+    GroupChanges changes(txn, definition, summary);
+    apply(&changes);
+    changes.write(db->getCollection(definition.sourceNs()));
+}
+
+}  // namespace
+
+const char SummaryDefinition::kCountField[] = "_count";
+
+StatusWith<std::unique_ptr<SummaryDefinition>> SummaryDefinition::parse(const NamespaceString& nss,
+                                                                         const BSONObj& spec) {
+    std::unique_ptr<SummaryDefinition> definition(new SummaryDefinition());
+    definition->_nss = nss;
+
+    bool hasGroupBy = false;
+    for (auto&& elem : spec) {
+        const StringData fieldName = elem.fieldNameStringData();
+        if (fieldName == "source") {
+            if (elem.type() != String || elem.valueStringData().empty()) {
+                return {ErrorCodes::BadValue, "'summary.source' has to be a collection name."};
+            }
+            definition->_sourceNss = NamespaceString(nss.db(), elem.valueStringData());
+            if (!NamespaceString::validCollectionComponent(definition->_sourceNss.ns()) ||
+                definition->_sourceNss == nss) {
+                return {ErrorCodes::BadValue,
+                        str::stream() << "'" << elem.valueStringData()
+                                      << "' cannot be the source of the summary "
+                                      << nss.ns()};
+            }
+        } else if (fieldName == "groupBy") {
+            hasGroupBy = true;
+            if (elem.type() == Object) {
+                definition->_groupByDocument = true;
+                for (auto&& field : elem.Obj()) {
+                    auto path = parseFieldPath(field);
+                    if (!path.isOK()) {
+                        return path.getStatus();
+                    }
+                    definition->_groupBy.emplace_back(field.fieldName(), path.getValue());
+                }
+            } else if (!elem.isNull()) {
+                auto path = parseFieldPath(elem);
+                if (!path.isOK()) {
+                    return path.getStatus();
+                }
+                definition->_groupBy.emplace_back("", path.getValue());
+            }
+        } else if (fieldName == "filter") {
+            if (elem.type() != Object) {
+                return {ErrorCodes::BadValue, "'summary.filter' has to be a document."};
+            }
+            definition->_filter = elem.Obj().getOwned();
+            auto expression = MatchExpressionParser::parse(
+                definition->_filter, ExtensionsCallbackDisallowExtensions(), nullptr);
+            if (!expression.isOK()) {
+                return expression.getStatus();
+            }
+            definition->_filterExpression = std::move(expression.getValue());
+        } else if (fieldName == "accumulators") {
+            if (elem.type() != Object) {
+                return {ErrorCodes::BadValue, "'summary.accumulators' has to be a document."};
+            }
+            for (auto&& field : elem.Obj()) {
+                Accumulator accumulator;
+                accumulator.name = field.fieldName();
+                if (accumulator.name.empty() || accumulator.name == "_id" ||
+                    accumulator.name == kCountField ||
+                    accumulator.name.find('.') != std::string::npos ||
+                    accumulator.name[0] == '$') {
+                    return {ErrorCodes::BadValue,
+                            str::stream() << "'" << accumulator.name
+                                          << "' cannot be the name of an accumulator."};
+                }
+                if (field.type() != Object || field.Obj().nFields() != 1) {
+                    return {ErrorCodes::BadValue,
+                            str::stream() << "The accumulator '" << accumulator.name
+                                          << "' has to be a document with one operator."};
+                }
+
+                const BSONElement op = field.Obj().firstElement();
+                const StringData opName = op.fieldNameStringData();
+                if (opName == "$count") {
+                    if (op.type() != Object || !op.Obj().isEmpty()) {
+                        return {ErrorCodes::BadValue, "$count takes an empty document."};
+                    }
+                    accumulator.type = AccumulatorType::kCount;
+                } else if (opName == "$sum" || opName == "$min" || opName == "$max") {
+                    accumulator.type = opName == "$sum"
+                        ? AccumulatorType::kSum
+                        : opName == "$min" ? AccumulatorType::kMin : AccumulatorType::kMax;
+                    if (accumulator.type == AccumulatorType::kSum && op.isNumber()) {
+                        accumulator.constant = op.wrap("");
+                    } else {
+                        auto path = parseFieldPath(op);
+                        if (!path.isOK()) {
+                            return path.getStatus();
+                        }
+                        accumulator.path = path.getValue();
+                    }
+                } else {
+                    return {ErrorCodes::BadValue,
+                            str::stream() << "The accumulator '" << accumulator.name
+                                          << "' has to use $sum, $count, $min or $max."};
+                }
+                definition->_accumulators.push_back(std::move(accumulator));
+            }
+        } else {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "'summary." << fieldName << "' is not a summary option."};
+        }
+    }
+
+    if (definition->_sourceNss.ns().empty()) {
+        return {ErrorCodes::BadValue, "'summary.source' is required."};
+    }
+    if (!hasGroupBy) {
+        return {ErrorCodes::BadValue, "'summary.groupBy' is required."};
+    }
+    if (definition->_accumulators.empty()) {
+        return {ErrorCodes::BadValue, "'summary.accumulators' needs at least one accumulator."};
+    }
+
+    return {std::move(definition)};
+}
+
+bool SummaryDefinition::matches(const BSONObj& doc) const {
+    return !_filterExpression || _filterExpression->matchesBSON(doc);
+}
+
+BSONObj SummaryDefinition::groupKey(const BSONObj& doc) const {
+    const auto appendValue = [&doc](BSONObjBuilder* bob, StringData name, StringData path) {
+        BSONElement value = dps::extractElementAtPath(doc, path);
+        if (value.eoo()) {
+            bob->appendNull(name);
+        } else {
+            bob->appendAs(value, name);
+        }
+    };
+
+    BSONObjBuilder bob;
+    if (_groupByDocument) {
+        BSONObjBuilder key(bob.subobjStart(""));
+        for (auto&& field : _groupBy) {
+            appendValue(&key, field.first, field.second);
+        }
+        key.doneFast();
+    } else if (_groupBy.empty()) {
+        bob.appendNull("");
+    } else {
+        appendValue(&bob, "", _groupBy.front().second);
+    }
+    return bob.obj();
+}
+
+BSONObj SummaryDefinition::groupQuery(const BSONObj& groupKey) const {
+    BSONArrayBuilder clauses;
+    if (!_filter.isEmpty()) {
+        clauses.append(_filter);
+    }
+
+    const auto appendClause = [&clauses](StringData path, const BSONElement& value) {
+        // An equality predicate on a null or an array would miss documents whose key is null
+        // because a path crosses an array, or match too few arrays.
+        if (value.isNull() || value.type() == Array || value.type() == Undefined) {
+            return;
+        }
+        BSONObjBuilder clause(clauses.subobjStart());
+        BSONObjBuilder eq(clause.subobjStart(path));
+        eq.appendAs(value, "$eq");
+    };
+
+    BSONElement key = groupKey.firstElement();
+    if (_groupByDocument) {
+        BSONObjIterator values(key.Obj());
+        for (auto&& field : _groupBy) {
+            appendClause(field.second, values.next());
+        }
+    } else if (!_groupBy.empty()) {
+        appendClause(_groupBy.front().second, key);
+    }
+
+    BSONArray array = clauses.arr();
+    return array.isEmpty() ? BSONObj() : BSON("$and" << array);
+}
+
+SummaryCatalog* SummaryCatalog::get(ServiceContext* service) {
+    return &getSummaryCatalog(service);
+}
+
+std::shared_ptr<const SummaryCatalog::DatabaseSummaries> SummaryCatalog::_getDatabase(
+    OperationContext* txn, StringData dbName) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        auto it = _databases.find(dbName);
+        if (it != _databases.end()) {
+            return it->second;
+        }
+    }
+
+    auto summaries = std::make_shared<DatabaseSummaries>();
+    Database* db = dbHolder().get(txn, dbName);
+    if (!db) {
+        return summaries;
+    }
+
+    const DatabaseCatalogEntry* dbEntry = db->getDatabaseCatalogEntry();
+    std::list<std::string> namespaces;
+    dbEntry->getCollectionNamespaces(&namespaces);
+    for (auto&& ns : namespaces) {
+        CollectionCatalogEntry* entry = dbEntry->getCollectionCatalogEntry(ns);
+        if (!entry) {
+            continue;
+        }
+        BSONObj spec = entry->getCollectionOptions(txn).summary;
+        if (spec.isEmpty()) {
+            continue;
+        }
+
+        auto definition = SummaryDefinition::parse(NamespaceString(ns), spec);
+        if (!definition.isOK()) {
+            warning() << "Not maintaining the summary collection " << ns << ": "
+                      << definition.getStatus();
+            continue;
+        }
+        std::shared_ptr<const SummaryDefinition> shared(std::move(definition.getValue()));
+        summaries->summaries[ns] = true;
+        summaries->bySource[shared->sourceNs().ns()].push_back(std::move(shared));
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _databases[dbName] = summaries;
+    return summaries;
+}
+
+std::vector<std::shared_ptr<const SummaryDefinition>> SummaryCatalog::_getSummariesOf(
+    OperationContext* txn, const NamespaceString& source) {
+    auto summaries = _getDatabase(txn, source.db());
+    auto it = summaries->bySource.find(source.ns());
+    if (it == summaries->bySource.end()) {
+        return {};
+    }
+    return it->second;
+}
+
+bool SummaryCatalog::hasSummaries(OperationContext* txn, const NamespaceString& source) {
+    // Secondaries apply the writes of the summaries from the oplog instead.
+    if (!txn->writesAreReplicated()) {
+        return false;
+    }
+    auto summaries = _getDatabase(txn, source.db());
+    return summaries->bySource.find(source.ns()) != summaries->bySource.end();
+}
+
+bool SummaryCatalog::isSummaryOrSource(OperationContext* txn, const NamespaceString& nss) {
+    auto summaries = _getDatabase(txn, nss.db());
+    return summaries->bySource.find(nss.ns()) != summaries->bySource.end() ||
+        summaries->summaries.find(nss.ns()) != summaries->summaries.end();
+}
+
+void SummaryCatalog::onInserts(OperationContext* txn,
+                               const NamespaceString& source,
+                               std::vector<BSONObj>::const_iterator begin,
+                               std::vector<BSONObj>::const_iterator end) {
+    if (!hasSummaries(txn, source)) {
+        return;
+    }
+
+    for (auto&& definition : _getSummariesOf(txn, source)) {
+        maintainSummary(txn, *definition, [&](GroupChanges* changes) {
+            for (auto it = begin; it != end; ++it) {
+                changes->add(*it);
+            }
+        });
+    }
+}
+
+void SummaryCatalog::onUpdate(OperationContext* txn,
+                              const NamespaceString& source,
+                              const BSONObj& preImageDoc,
+                              const BSONObj& updatedDoc) {
+    if (preImageDoc.isEmpty() || !hasSummaries(txn, source)) {
+        return;
+    }
+
+    for (auto&& definition : _getSummariesOf(txn, source)) {
+        if (contributesAlike(*definition, preImageDoc, updatedDoc)) {
+            continue;
+        }
+        maintainSummary(txn, *definition, [&](GroupChanges* changes) {
+            changes->remove(preImageDoc);
+            changes->add(updatedDoc);
+        });
+    }
+}
+
+void SummaryCatalog::onDelete(OperationContext* txn,
+                              const NamespaceString& source,
+                              const BSONObj& deletedDoc) {
+    if (!hasSummaries(txn, source)) {
+        return;
+    }
+
+    for (auto&& definition : _getSummariesOf(txn, source)) {
+        maintainSummary(
+            txn, *definition, [&](GroupChanges* changes) { changes->remove(deletedDoc); });
+    }
+}
+
+void SummaryCatalog::onDropCollection(OperationContext* txn, const NamespaceString& nss) {
+    if (!isSummaryOrSource(txn, nss)) {
+        return;
+    }
+
+    if (txn->writesAreReplicated()) {
+        Database* db = dbHolder().get(txn, nss.db());
+        for (auto&& definition : _getSummariesOf(txn, nss)) {
+            Collection* summary = db ? db->getCollection(definition->ns()) : nullptr;
+            if (!summary) {
+                continue;
+            }
+
+            std::vector<RecordId> recordIds;
+            {
+                auto cursor = summary->getCursor(txn);
+                while (auto record = cursor->next()) {
+                    recordIds.push_back(record->id);
+                }
+            }
+            for (auto&& recordId : recordIds) {
+                summary->deleteDocument(txn, recordId, nullptr);
+            }
+        }
+    }
+
+    invalidate(txn, nss.db());
+}
+
+void SummaryCatalog::invalidate(OperationContext* txn, StringData dbName) {
+    _invalidate(dbName);
+
+    // A rolled back unit of work may have read the definitions it created or dropped.
+    std::string db = dbName.toString();
+    txn->recoveryUnit()->onRollback([this, db] { _invalidate(db); });
+}
+
+void SummaryCatalog::_invalidate(StringData dbName) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _databases.erase(dbName);
+}
+
+Status populateSummaryCollection(OperationContext* txn,
+                                 Database* db,
+                                 const SummaryDefinition& definition) {
+    Collection* summary = db->getCollection(definition.ns());
+    invariant(summary);
+    if (summary->isCapped() || !summary->getIndexCatalog()->findIdIndex(txn)) {
+        return {ErrorCodes::InvalidOptions,
+                "A summary collection cannot be capped and needs an _id index."};
+    }
+
+    Collection* source = db->getCollection(definition.sourceNs());
+    if (!source) {
+        return Status::OK();
+    }
+    if (source->isCapped()) {
+        return {ErrorCodes::InvalidOptions,
+                str::stream() << "The capped collection " << source->ns().ns()
+                              << " cannot be the source of a summary."};
+    }
+
+    GroupChanges changes(txn, definition, summary);
+    auto exec = InternalPlanner::collectionScan(
+        txn, source->ns().ns(), source, PlanExecutor::YIELD_MANUAL);
+    BSONObj doc;
+    PlanExecutor::ExecState state;
+    while (PlanExecutor::ADVANCED == (state = exec->getNext(&doc, nullptr))) {
+        changes.add(doc);
+    }
+    if (state != PlanExecutor::IS_EOF) {
+        return WorkingSetCommon::getMemberObjectStatus(doc);
+    }
+
+    changes.write(source);
+    return Status::OK();
+}
+
+}  // namespace mongo
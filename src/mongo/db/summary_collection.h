@@ -0,0 +1,229 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class Database;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * A summary collection holds the result of grouping the documents of a source collection of the
+ * same database, and is kept up to date as the source is written instead of being recomputed by an
+ * aggregation on every read. It is created with a "summary" collection option:
+ *
+ *     db.createCollection("salesByRegion", {summary: {
+ *         source: "sales",
+ *         groupBy: "$region",
+ *         filter: {status: "closed"},
+ *         accumulators: {total: {$sum: "$amount"}, n: {$count: {}},
+ *                        lowest: {$min: "$amount"}, highest: {$max: "$amount"}}}});
+ *
+ * "groupBy" is a field path, a document of field paths or null, as the _id of $group. The optional
+ * "filter" is a query predicate which the source documents have to match to be counted. Each of
+ * the accumulators is $sum of a field path or of a number, $count, $min or $max of a field path.
+ * Field paths do not descend into arrays, and missing group key fields group as null.
+ *
+ * The summary holds one document per group, {_id: <group key>, _count: <number of documents>,
+ * <accumulators>...}, which is read, filtered and indexed like the documents of any collection.
+ *
+ * The OpObserver applies the change each insert, update and delete of a source document makes to
+ * its group within the write's own unit of work, so that a summary never disagrees with the
+ * committed contents of its source. Its writes are replicated as ordinary writes of the summary
+ * collection, so secondaries apply them instead of maintaining the summary themselves. Removing the
+ * current minimum or maximum of a group rescans the source documents of the group, which is only
+ * cheap with an index on the groupBy fields. Concurrent writes of the documents of one group
+ * conflict on its summary document.
+ */
+class SummaryDefinition {
+    MONGO_DISALLOW_COPYING(SummaryDefinition);
+
+public:
+    enum class AccumulatorType { kSum, kCount, kMin, kMax };
+
+    struct Accumulator {
+        std::string name;
+        AccumulatorType type;
+
+        // The dotted path of the accumulated field, or empty for a $sum of 'constant'.
+        std::string path;
+
+        // Holds the number a $sum without a path adds per document as its only element.
+        BSONObj constant;
+    };
+
+    // The field of a summary document holding the number of source documents of its group.
+    static const char kCountField[];
+
+    /**
+     * Parses the "summary" option 'spec' of the summary collection 'nss'.
+     */
+    static StatusWith<std::unique_ptr<SummaryDefinition>> parse(const NamespaceString& nss,
+                                                                const BSONObj& spec);
+
+    const NamespaceString& ns() const {
+        return _nss;
+    }
+
+    const NamespaceString& sourceNs() const {
+        return _sourceNss;
+    }
+
+    const std::vector<Accumulator>& accumulators() const {
+        return _accumulators;
+    }
+
+    /**
+     * Returns whether the source document 'doc' belongs to the summary, that is whether it matches
+     * the filter.
+     */
+    bool matches(const BSONObj& doc) const;
+
+    /**
+     * Returns the group key of the source document 'doc' as the only element of an object.
+     */
+    BSONObj groupKey(const BSONObj& doc) const;
+
+    /**
+     * Returns a query which matches at least all source documents of the group 'groupKey' that
+     * pass the filter, to find them with an index on the groupBy fields.
+     */
+    BSONObj groupQuery(const BSONObj& groupKey) const;
+
+private:
+    SummaryDefinition() = default;
+
+    NamespaceString _nss;
+    NamespaceString _sourceNss;
+
+    // The name and dotted path of each groupBy field. A groupBy path instead of a document has one
+    // field with an empty name, and a null groupBy none.
+    std::vector<std::pair<std::string, std::string>> _groupBy;
+    bool _groupByDocument = false;
+
+    BSONObj _filter;
+    std::unique_ptr<MatchExpression> _filterExpression;
+
+    std::vector<Accumulator> _accumulators;
+};
+
+/**
+ * Keeps the summary definitions of each database, and maintains summary collections as their
+ * sources are written. The definitions of a database are read from its collection options the first
+ * time one of its collections is written, and forgotten when one of its summary collections or
+ * their sources is created, dropped or renamed.
+ */
+class SummaryCatalog {
+    MONGO_DISALLOW_COPYING(SummaryCatalog);
+
+public:
+    SummaryCatalog() = default;
+
+    static SummaryCatalog* get(ServiceContext* service);
+
+    /**
+     * Returns whether writes of 'source' by 'txn' have summaries to maintain. The caller holds at
+     * least an intent lock on the database of 'source'.
+     */
+    bool hasSummaries(OperationContext* txn, const NamespaceString& source);
+
+    /**
+     * Returns whether 'nss' is a summary collection or the source of one.
+     */
+    bool isSummaryOrSource(OperationContext* txn, const NamespaceString& nss);
+
+    void onInserts(OperationContext* txn,
+                   const NamespaceString& source,
+                   std::vector<BSONObj>::const_iterator begin,
+                   std::vector<BSONObj>::const_iterator end);
+    void onUpdate(OperationContext* txn,
+                  const NamespaceString& source,
+                  const BSONObj& preImageDoc,
+                  const BSONObj& updatedDoc);
+    void onDelete(OperationContext* txn, const NamespaceString& source, const BSONObj& deletedDoc);
+
+    /**
+     * Empties the summaries of 'nss' if it was their source, and forgets the definitions of its
+     * database if 'nss' was a summary collection or a source.
+     */
+    void onDropCollection(OperationContext* txn, const NamespaceString& nss);
+
+    /**
+     * Forgets the summary definitions of the database 'dbName', both now and if the unit of work of
+     * 'txn' rolls back.
+     */
+    void invalidate(OperationContext* txn, StringData dbName);
+
+private:
+    struct DatabaseSummaries {
+        // The summaries of each source collection, by its full name.
+        StringMap<std::vector<std::shared_ptr<const SummaryDefinition>>> bySource;
+
+        // The full names of the summary collections.
+        StringMap<bool> summaries;
+    };
+
+    std::shared_ptr<const DatabaseSummaries> _getDatabase(OperationContext* txn,
+                                                          StringData dbName);
+
+    std::vector<std::shared_ptr<const SummaryDefinition>> _getSummariesOf(
+        OperationContext* txn, const NamespaceString& source);
+
+    void _invalidate(StringData dbName);
+
+    stdx::mutex _mutex;
+
+    // The summary definitions of each database read since they last changed.
+    StringMap<std::shared_ptr<const DatabaseSummaries>> _databases;
+};
+
+/**
+ * Fills the summary collection of 'definition', which was just created, from the current documents
+ * of its source. The caller holds the database lock in MODE_X within a WriteUnitOfWork.
+ */
+Status populateSummaryCollection(OperationContext* txn,
+                                 Database* db,
+                                 const SummaryDefinition& definition);
+
+}  // namespace mongo
@@ -0,0 +1,429 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket.h"
+
+#include <cmath>
+#include <cstdint>
+
+#include "mongo/base/parse_number.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+const char TimeseriesBucket::kControlField[] = "control";
+const char TimeseriesBucket::kVersionField[] = "version";
+const char TimeseriesBucket::kCountField[] = "count";
+const char TimeseriesBucket::kMinField[] = "min";
+const char TimeseriesBucket::kMaxField[] = "max";
+const char TimeseriesBucket::kMetaField[] = "meta";
+const char TimeseriesBucket::kDataField[] = "data";
+
+const int TimeseriesBucket::kOpenVersion;
+const int TimeseriesBucket::kClosedVersion;
+const char TimeseriesBucket::kDeltaOfDelta;
+
+namespace {
+
+// More rows than any bucket can be created with, to reject corrupt counts before allocating.
+const int kMaxBucketRows = 100 * 1000;
+
+// Doubles of up to this magnitude convert to long long and back exactly.
+const double kMaxExactDouble = 9007199254740992.0;  // 2^53
+
+uint64_t zigZagEncode(uint64_t n) {
+    return (n << 1) ^ (0 - (n >> 63));
+}
+
+uint64_t zigZagDecode(uint64_t n) {
+    return (n >> 1) ^ (0 - (n & 1));
+}
+
+void appendVarint(uint64_t n, BufBuilder* buf) {
+    while (n >= 0x80) {
+        buf->appendChar(static_cast<char>((n & 0x7f) | 0x80));
+        n >>= 7;
+    }
+    buf->appendChar(static_cast<char>(n));
+}
+
+uint64_t readVarint(const char** pos, const char* end) {
+    uint64_t n = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        uassert(40398, "Invalid bucket in time-series collection: truncated column", *pos < end);
+        const uint8_t byte = static_cast<uint8_t>(*(*pos)++);
+        n |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return n;
+        }
+    }
+    uasserted(40398, "Invalid bucket in time-series collection: overlong varint");
+}
+
+/**
+ * Returns whether the value 'elem' can be stored in a column encoded as 'type', and if so sets
+ * 'number' to it.
+ */
+bool getEncodableNumber(const BSONElement& elem, BSONType type, long long* number) {
+    if (elem.type() != type) {
+        return false;
+    }
+
+    switch (type) {
+        case Date:
+            *number = elem.date().toMillisSinceEpoch();
+            return true;
+        case NumberInt:
+        case NumberLong:
+            *number = elem.numberLong();
+            return true;
+        case NumberDouble: {
+            const double value = elem.numberDouble();
+            if (!(std::fabs(value) <= kMaxExactDouble) || value != std::trunc(value) ||
+                (value == 0 && std::signbit(value))) {
+                return false;
+            }
+            *number = static_cast<long long>(value);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+/**
+ * Appends the column 'column' of a bucket of 'count' rows as 'bob', encoded if it can be.
+ */
+void appendCompressedColumn(const BSONElement& column, int count, BSONObjBuilder* bob) {
+    const BSONObj rows = column.Obj();
+    const BSONType type = rows.firstElementType();
+
+    BufBuilder buf;
+    buf.appendChar(TimeseriesBucket::kDeltaOfDelta);
+    buf.appendChar(static_cast<char>(type));
+
+    int row = 0;
+    uint64_t previous = 0;
+    uint64_t previousDelta = 0;
+    for (auto&& elem : rows) {
+        long long number;
+        if (row >= count || elem.fieldNameStringData() != BSONObjBuilder::numStr(row) ||
+            !getEncodableNumber(elem, type, &number)) {
+            bob->append(column);
+            return;
+        }
+
+        const uint64_t value = static_cast<uint64_t>(number);
+        const uint64_t delta = value - previous;
+        appendVarint(zigZagEncode(row < 2 ? delta : delta - previousDelta), &buf);
+        previous = value;
+        previousDelta = delta;
+        ++row;
+    }
+
+    if (row != count) {
+        bob->append(column);
+        return;
+    }
+    bob->appendBinData(column.fieldNameStringData(), buf.len(), BinDataGeneral, buf.buf());
+}
+
+/**
+ * Decodes the encoded column 'column' of a bucket of 'count' rows into 'type' and 'numbers'.
+ */
+void decodeColumn(const BSONElement& column,
+                  int count,
+                  BSONType* type,
+                  std::vector<long long>* numbers) {
+    int len;
+    const char* pos = column.binData(len);
+    const char* end = pos + len;
+    uassert(40398,
+            str::stream() << "Invalid bucket in time-series collection: unknown encoding of "
+                          << "column '"
+                          << column.fieldNameStringData()
+                          << "'",
+            len >= 2 && pos[0] == TimeseriesBucket::kDeltaOfDelta);
+
+    *type = static_cast<BSONType>(pos[1]);
+    uassert(40398,
+            str::stream() << "Invalid bucket in time-series collection: column '"
+                          << column.fieldNameStringData()
+                          << "' cannot hold values of type "
+                          << static_cast<int>(*type),
+            *type == Date || *type == NumberInt || *type == NumberLong || *type == NumberDouble);
+    pos += 2;
+
+    numbers->clear();
+    numbers->reserve(count);
+    uint64_t previous = 0;
+    uint64_t previousDelta = 0;
+    for (int row = 0; row < count; ++row) {
+        const uint64_t encoded = zigZagDecode(readVarint(&pos, end));
+        const uint64_t delta = row < 2 ? encoded : previousDelta + encoded;
+        previous += delta;
+        previousDelta = delta;
+        numbers->push_back(static_cast<long long>(previous));
+    }
+    uassert(40398, "Invalid bucket in time-series collection: column longer than its bucket",
+            pos == end);
+}
+
+/**
+ * Appends to 'predicates' the predicates on buckets implied by the conjunction 'expr' of a query on
+ * measurements.
+ */
+void appendBucketPredicates(const TimeseriesOptions& options,
+                            const MatchExpression* expr,
+                            BSONArrayBuilder* predicates) {
+    if (MatchExpression::AND == expr->matchType()) {
+        for (size_t i = 0; i < expr->numChildren(); ++i) {
+            appendBucketPredicates(options, expr->getChild(i), predicates);
+        }
+        return;
+    }
+
+    const StringData path = expr->path();
+    if (!options.metaField.empty() && (expr->isLeaf() || expr->isArray()) &&
+        path.startsWith(options.metaField) &&
+        (path.size() == options.metaField.size() || path[options.metaField.size()] == '.')) {
+        // All the measurements of a bucket have its meta, so the bucket matches exactly when they
+        // do.
+        BSONObjBuilder bob;
+        expr->serialize(&bob);
+        BSONObj predicate = bob.obj();
+        if (predicate.nFields() == 1 && predicate.firstElementFieldName() == path) {
+            BSONObjBuilder renamed(predicates->subobjStart());
+            renamed.appendAs(predicate.firstElement(),
+                             TimeseriesBucket::kMetaField +
+                                 path.substr(options.metaField.size()).toString());
+        }
+        return;
+    }
+
+    if (path != options.timeField) {
+        return;
+    }
+
+    const MatchExpression::MatchType type = expr->matchType();
+    if (MatchExpression::EQ != type && MatchExpression::LT != type &&
+        MatchExpression::LTE != type && MatchExpression::GT != type &&
+        MatchExpression::GTE != type) {
+        return;
+    }
+    const BSONElement& time = static_cast<const ComparisonMatchExpression*>(expr)->getData();
+    if (time.type() != Date) {
+        return;
+    }
+
+    const std::string minPath = str::stream() << TimeseriesBucket::kControlField << "."
+                                              << TimeseriesBucket::kMinField << "."
+                                              << options.timeField;
+    const std::string maxPath = str::stream() << TimeseriesBucket::kControlField << "."
+                                              << TimeseriesBucket::kMaxField << "."
+                                              << options.timeField;
+    switch (type) {
+        case MatchExpression::EQ:
+            predicates->append(BSON(minPath << BSON("$lte" << time)));
+            predicates->append(BSON(maxPath << BSON("$gte" << time)));
+            break;
+        case MatchExpression::LT:
+            predicates->append(BSON(minPath << BSON("$lt" << time)));
+            break;
+        case MatchExpression::LTE:
+            predicates->append(BSON(minPath << BSON("$lte" << time)));
+            break;
+        case MatchExpression::GT:
+            predicates->append(BSON(maxPath << BSON("$gt" << time)));
+            break;
+        default:
+            predicates->append(BSON(maxPath << BSON("$gte" << time)));
+            break;
+    }
+}
+
+}  // namespace
+
+// static
+std::unique_ptr<MatchExpression> TimeseriesBucket::createFilter(
+    const TimeseriesOptions& options,
+    const MatchExpression* query,
+    const CollatorInterface* collator) {
+    BSONArrayBuilder predicates;
+    appendBucketPredicates(options, query, &predicates);
+    if (predicates.arrSize() == 0) {
+        return nullptr;
+    }
+
+    auto filter = MatchExpressionParser::parse(BSON("$and" << predicates.arr()),
+                                               ExtensionsCallbackDisallowExtensions(),
+                                               collator);
+    if (!filter.isOK()) {
+        // Leave the buckets unfiltered rather than fail a query which the measurements answer.
+        return nullptr;
+    }
+    return std::move(filter.getValue());
+}
+
+// static
+BSONObj TimeseriesBucket::compress(const BSONObj& bucket) {
+    const BSONObj control = bucket[kControlField].Obj();
+    const int count = control[kCountField].numberInt();
+
+    BSONObjBuilder bob;
+    for (auto&& elem : bucket) {
+        const StringData fieldName = elem.fieldNameStringData();
+        if (fieldName == kControlField) {
+            BSONObjBuilder controlBuilder(bob.subobjStart(kControlField));
+            for (auto&& controlElem : control) {
+                if (controlElem.fieldNameStringData() == kVersionField) {
+                    controlBuilder.append(kVersionField, kClosedVersion);
+                } else {
+                    controlBuilder.append(controlElem);
+                }
+            }
+        } else if (fieldName == kDataField) {
+            BSONObjBuilder dataBuilder(bob.subobjStart(kDataField));
+            for (auto&& column : elem.Obj()) {
+                appendCompressedColumn(column, count, &dataBuilder);
+            }
+        } else {
+            bob.append(elem);
+        }
+    }
+    return bob.obj();
+}
+
+BucketUnpacker::BucketUnpacker(const TimeseriesOptions& options)
+    : _timeField(options.timeField), _metaField(options.metaField) {}
+
+void BucketUnpacker::reset(const BSONObj& bucket) {
+    _columns.clear();
+    _count = 0;
+    _row = 0;
+
+    const BSONElement control = bucket[TimeseriesBucket::kControlField];
+    const BSONElement data = bucket[TimeseriesBucket::kDataField];
+    uassert(40398,
+            str::stream() << "Invalid bucket in time-series collection: " << bucket.toString(),
+            control.type() == Object && data.type() == Object);
+
+    const int version = control.Obj()[TimeseriesBucket::kVersionField].numberInt();
+    const int count = control.Obj()[TimeseriesBucket::kCountField].numberInt();
+    uassert(40398,
+            str::stream() << "Invalid bucket in time-series collection: version " << version
+                          << " with "
+                          << count
+                          << " measurements",
+            (version == TimeseriesBucket::kOpenVersion ||
+             version == TimeseriesBucket::kClosedVersion) &&
+                count >= 0 && count <= kMaxBucketRows);
+
+    _meta = _metaField.empty() ? BSONElement() : bucket[TimeseriesBucket::kMetaField];
+    for (auto&& elem : data.Obj()) {
+        _columns.emplace_back();
+        Column& column = _columns.back();
+        column.name = elem.fieldNameStringData();
+
+        if (elem.type() == BinData) {
+            uassert(40398,
+                    "Invalid bucket in time-series collection: encoded column in an open bucket",
+                    version == TimeseriesBucket::kClosedVersion);
+            decodeColumn(elem, count, &column.numberType, &column.numbers);
+            continue;
+        }
+
+        uassert(40398,
+                str::stream() << "Invalid bucket in time-series collection: column '"
+                              << column.name
+                              << "' is not a document",
+                elem.type() == Object);
+        column.values.resize(count);
+        for (auto&& value : elem.Obj()) {
+            int row;
+            uassert(40398,
+                    str::stream() << "Invalid bucket in time-series collection: column '"
+                                  << column.name
+                                  << "' has no row '"
+                                  << value.fieldNameStringData()
+                                  << "'",
+                    parseNumberFromStringWithBase(value.fieldNameStringData(), 10, &row).isOK() &&
+                        row >= 0 && row < count);
+            column.values[row] = value;
+        }
+    }
+
+    _count = count;
+}
+
+BSONObj BucketUnpacker::next() {
+    invariant(more());
+
+    BSONObjBuilder bob;
+    for (auto&& column : _columns) {
+        if (column.numberType == EOO) {
+            const BSONElement& value = column.values[_row];
+            if (!value.eoo()) {
+                bob.appendAs(value, column.name);
+            }
+        } else {
+            const long long number = column.numbers[_row];
+            switch (column.numberType) {
+                case Date:
+                    bob.appendDate(column.name, Date_t::fromMillisSinceEpoch(number));
+                    break;
+                case NumberInt:
+                    bob.append(column.name, static_cast<int>(number));
+                    break;
+                case NumberLong:
+                    bob.append(column.name, number);
+                    break;
+                default:
+                    bob.append(column.name, static_cast<double>(number));
+                    break;
+            }
+        }
+
+        if (!_meta.eoo() && column.name == _timeField) {
+            bob.appendAs(_meta, _metaField);
+        }
+    }
+
+    ++_row;
+    return bob.obj();
+}
+
+}  // namespace mongo
@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/timeseries/timeseries_options.h"
+
+namespace mongo {
+
+class CollatorInterface;
+class MatchExpression;
+
+/**
+ * The documents of a time-series collection are buckets, each holding the measurements of one
+ * series within one window of time as columns:
+ *
+ *     {_id: ObjectId,
+ *      control: {version: 1, count: <n>, min: {<timeField>: Date}, max: {<timeField>: Date}},
+ *      meta: <the metaField value of the series, missing if the measurements have none>,
+ *      data: {<field>: {"0": <value of row 0>, "1": <value of row 1>, ...}, ...}}
+ *
+ * A column holds the rows which have the field, keyed by their decimal row number. Measurements
+ * are appended to an open bucket, version 1, until it is closed and compressed into version 2,
+ * whose columns are either kept as they are or, when each row has a value and the values are all
+ * Dates, all ints, all longs or all integral doubles, encoded as BinData: a byte holding
+ * kDeltaOfDelta, a byte holding the BSONType of the values, then the first value, the delta
+ * between the first two and the deltas between each next pair of deltas, as zigzag varints.
+ * Regular measurements thus take a byte or two per value. The control fields are never
+ * compressed, so that queries can skip the buckets whose window of time cannot match.
+ */
+class TimeseriesBucket {
+public:
+    static const char kControlField[];
+    static const char kVersionField[];
+    static const char kCountField[];
+    static const char kMinField[];
+    static const char kMaxField[];
+    static const char kMetaField[];
+    static const char kDataField[];
+
+    static const int kOpenVersion = 1;
+    static const int kClosedVersion = 2;
+
+    // The encodings of closed columns, as their first byte.
+    static const char kDeltaOfDelta = 1;
+
+    /**
+     * Returns the closed form of the open bucket 'bucket'.
+     */
+    static BSONObj compress(const BSONObj& bucket);
+
+    /**
+     * Returns a filter which the buckets holding the measurements that match 'query' match, or
+     * null if any bucket can hold them. It bounds the window of time of the buckets by the
+     * comparisons of the timeField with a Date, and applies the predicates on the metaField to
+     * the meta of the buckets, with 'collator' as 'query' does.
+     */
+    static std::unique_ptr<MatchExpression> createFilter(const TimeseriesOptions& options,
+                                                         const MatchExpression* query,
+                                                         const CollatorInterface* collator);
+};
+
+/**
+ * Turns the buckets of a time-series collection back into the measurements they hold.
+ */
+class BucketUnpacker {
+    MONGO_DISALLOW_COPYING(BucketUnpacker);
+
+public:
+    explicit BucketUnpacker(const TimeseriesOptions& options);
+
+    /**
+     * Starts unpacking 'bucket', which has to stay valid until the next reset(). Throws a
+     * UserException if it is not a valid bucket.
+     */
+    void reset(const BSONObj& bucket);
+
+    bool more() const {
+        return _row < _count;
+    }
+
+    /**
+     * Returns the next measurement of the bucket. Its fields follow the order of the columns, with
+     * the metaField after the timeField.
+     */
+    BSONObj next();
+
+private:
+    struct Column {
+        StringData name;
+
+        // The value of each row, or EOO for the rows which lack the field, unless 'numbers' holds
+        // the values of an encoded column.
+        std::vector<BSONElement> values;
+
+        BSONType numberType = EOO;
+        std::vector<long long> numbers;
+    };
+
+    const std::string _timeField;
+    const std::string _metaField;
+
+    BSONElement _meta;
+    std::vector<Column> _columns;
+    int _count = 0;
+    int _row = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,377 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket_catalog.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/dbhelpers.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/ops/update.h"
+#include "mongo/db/ops/update_lifecycle_impl.h"
+#include "mongo/db/ops/update_request.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/timeseries/bucket.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getBucketCatalog = ServiceContext::declareDecoration<BucketCatalog>();
+
+// A bucket is closed before it grows past this size, to keep appending to it cheap.
+const int kBucketMaxSizeBytes = 125 * 1024;
+
+// The catalog forgets all the open buckets rather than remember more series than this.
+const size_t kMaxOpenBuckets = 100 * 1000;
+
+/**
+ * The measurements of one series in a batch of inserts.
+ */
+struct Series {
+    std::string key;
+
+    // The meta of the series as the only element of an object, or empty if it has none.
+    BSONObj meta;
+
+    std::vector<const BSONObj*> measurements;
+};
+
+/**
+ * The bucket that the measurements of a series are being appended to.
+ */
+struct OpenBucket {
+    OID id;
+
+    // The bucket as it is stored, or empty if it is created by this batch.
+    BSONObj stored;
+
+    int count = 0;
+    int size = 0;
+    Date_t min;
+    Date_t max;
+
+    // The measurements to append as the rows [count - pending.size(), count).
+    std::vector<const BSONObj*> pending;
+};
+
+/**
+ * Returns whether the measurement 'elem' goes into a column of the bucket.
+ */
+bool isColumn(const TimeseriesOptions& options, const BSONElement& elem) {
+    const StringData fieldName = elem.fieldNameStringData();
+    return fieldName != "_id" && fieldName != options.metaField;
+}
+
+/**
+ * Returns the bucket 'bucket' holds once its pending measurements are added.
+ */
+BSONObj buildBucket(const TimeseriesOptions& options,
+                    const BSONObj& meta,
+                    const OpenBucket& bucket) {
+    std::vector<std::pair<std::string, std::unique_ptr<BSONObjBuilder>>> columns;
+    StringMap<size_t> columnIndexes;
+    auto getColumn = [&](StringData name) -> BSONObjBuilder* {
+        auto it = columnIndexes.find(name);
+        if (it != columnIndexes.end()) {
+            return columns[it->second].second.get();
+        }
+        columnIndexes[name] = columns.size();
+        columns.emplace_back(name.toString(), stdx::make_unique<BSONObjBuilder>());
+        return columns.back().second.get();
+    };
+
+    if (bucket.stored.isEmpty()) {
+        getColumn(options.timeField);
+    } else {
+        for (auto&& column : bucket.stored[TimeseriesBucket::kDataField].Obj()) {
+            getColumn(column.fieldNameStringData())->appendElements(column.Obj());
+        }
+    }
+
+    int row = bucket.count - bucket.pending.size();
+    for (const BSONObj* measurement : bucket.pending) {
+        const std::string rowName = BSONObjBuilder::numStr(row++);
+        for (auto&& elem : *measurement) {
+            if (isColumn(options, elem)) {
+                getColumn(elem.fieldNameStringData())->appendAs(elem, rowName);
+            }
+        }
+    }
+
+    BSONObjBuilder bob;
+    bob.append("_id", bucket.id);
+    {
+        BSONObjBuilder control(bob.subobjStart(TimeseriesBucket::kControlField));
+        control.append(TimeseriesBucket::kVersionField, TimeseriesBucket::kOpenVersion);
+        control.append(TimeseriesBucket::kCountField, bucket.count);
+        control.append(TimeseriesBucket::kMinField, BSON(options.timeField << bucket.min));
+        control.append(TimeseriesBucket::kMaxField, BSON(options.timeField << bucket.max));
+    }
+    if (!meta.isEmpty()) {
+        bob.appendAs(meta.firstElement(), TimeseriesBucket::kMetaField);
+    }
+    {
+        BSONObjBuilder data(bob.subobjStart(TimeseriesBucket::kDataField));
+        for (auto&& column : columns) {
+            data.append(column.first, column.second->done());
+        }
+    }
+    return bob.obj();
+}
+
+/**
+ * Returns the update which appends the pending measurements to the stored bucket 'bucket'.
+ */
+BSONObj buildAppendUpdate(const TimeseriesOptions& options, const OpenBucket& bucket) {
+    const BSONObj storedControl = bucket.stored[TimeseriesBucket::kControlField].Obj();
+    const std::string dataPrefix = str::stream() << TimeseriesBucket::kDataField << ".";
+    const std::string controlPrefix = str::stream() << TimeseriesBucket::kControlField << ".";
+
+    BSONObjBuilder update;
+    BSONObjBuilder set(update.subobjStart("$set"));
+    int row = bucket.count - bucket.pending.size();
+    for (const BSONObj* measurement : bucket.pending) {
+        const std::string rowName = BSONObjBuilder::numStr(row++);
+        for (auto&& elem : *measurement) {
+            if (isColumn(options, elem)) {
+                set.appendAs(elem,
+                             std::string(str::stream() << dataPrefix << elem.fieldNameStringData()
+                                                       << "."
+                                                       << rowName));
+            }
+        }
+    }
+
+    set.append(controlPrefix + TimeseriesBucket::kCountField, bucket.count);
+    if (storedControl[TimeseriesBucket::kMinField][options.timeField].date() != bucket.min) {
+        set.appendDate(std::string(str::stream() << controlPrefix << TimeseriesBucket::kMinField
+                                                 << "."
+                                                 << options.timeField),
+                       bucket.min);
+    }
+    if (storedControl[TimeseriesBucket::kMaxField][options.timeField].date() != bucket.max) {
+        set.appendDate(std::string(str::stream() << controlPrefix << TimeseriesBucket::kMaxField
+                                                 << "."
+                                                 << options.timeField),
+                       bucket.max);
+    }
+    set.done();
+    return update.obj();
+}
+
+/**
+ * Writes the pending measurements of 'bucket', and compresses it if 'close' is set.
+ */
+void writeBucket(OperationContext* txn,
+                 Collection* collection,
+                 const BSONObj& meta,
+                 bool close,
+                 OpenBucket* bucket) {
+    const TimeseriesOptions& options = *collection->getTimeseriesOptions();
+    if (bucket->stored.isEmpty()) {
+        if (bucket->pending.empty()) {
+            return;
+        }
+        BSONObj doc = buildBucket(options, meta, *bucket);
+        uassertStatusOK(collection->insertDocument(
+            txn, close ? TimeseriesBucket::compress(doc) : doc, nullptr, true));
+    } else {
+        if (bucket->pending.empty() && !close) {
+            return;
+        }
+        BSONObj updateObj = close
+            ? TimeseriesBucket::compress(buildBucket(options, meta, *bucket))
+            : buildAppendUpdate(options, *bucket);
+
+        UpdateRequest request(collection->ns());
+        request.setQuery(BSON("_id" << bucket->id));
+        request.setUpdates(updateObj);
+        UpdateLifecycleImpl updateLifecycle(collection->ns());
+        request.setLifecycle(&updateLifecycle);
+
+        Database* db = dbHolder().get(txn, collection->ns().db());
+        invariant(db);
+        UpdateResult result = update(txn, db, request);
+        uassert(40399,
+                str::stream() << "Bucket " << bucket->id << " of the time-series collection "
+                              << collection->ns().ns()
+                              << " disappeared while appending to it",
+                result.numMatched == 1);
+    }
+    bucket->pending.clear();
+}
+
+}  // namespace
+
+BucketCatalog* BucketCatalog::get(ServiceContext* service) {
+    return &getBucketCatalog(service);
+}
+
+Status BucketCatalog::insert(OperationContext* txn,
+                             Collection* collection,
+                             std::vector<BSONObj>::const_iterator begin,
+                             std::vector<BSONObj>::const_iterator end) {
+    const TimeseriesOptions& options = *collection->getTimeseriesOptions();
+    const long long maxSpanMillis = options.bucketMaxSpanSeconds * 1000;
+
+    // Group the measurements by series, in the order of the first measurement of each.
+    std::vector<Series> series;
+    StringMap<size_t> seriesIndexes;
+    for (auto it = begin; it != end; ++it) {
+        const BSONObj& measurement = *it;
+        if (measurement[options.timeField].type() != Date) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "The measurements of the time-series collection "
+                                  << collection->ns().ns()
+                                  << " need a Date in '"
+                                  << options.timeField
+                                  << "': "
+                                  << measurement.toString()};
+        }
+        for (auto&& elem : measurement) {
+            if (elem.fieldNameStringData().empty() ||
+                elem.fieldNameStringData().find('.') != std::string::npos) {
+                return {ErrorCodes::BadValue,
+                        str::stream() << "The field names of the measurements of a time-series "
+                                         "collection cannot be empty or contain '.': "
+                                      << measurement.toString()};
+            }
+        }
+
+        BSONObj meta;
+        if (!options.metaField.empty()) {
+            if (auto metaElem = measurement[options.metaField]) {
+                meta = metaElem.wrap("");
+            }
+        }
+        std::string key = collection->ns().ns();
+        key.push_back('\0');
+        key.append(meta.objdata(), meta.objsize());
+
+        auto indexIt = seriesIndexes.find(key);
+        size_t index;
+        if (indexIt == seriesIndexes.end()) {
+            index = series.size();
+            seriesIndexes[key] = index;
+            series.emplace_back();
+            series.back().key = std::move(key);
+            series.back().meta = meta;
+        } else {
+            index = indexIt->second;
+        }
+        series[index].measurements.push_back(&measurement);
+    }
+
+    for (auto&& current : series) {
+        OpenBucket bucket;
+        bucket.id = _getOpenBucket(current.key);
+        if (bucket.id.isSet()) {
+            RecordId recordId = Helpers::findById(txn, collection, BSON("_id" << bucket.id));
+            if (!recordId.isNull()) {
+                BSONObj stored = collection->docFor(txn, recordId).value().getOwned();
+                BSONObj control = stored[TimeseriesBucket::kControlField].Obj();
+                if (control[TimeseriesBucket::kVersionField].numberInt() ==
+                    TimeseriesBucket::kOpenVersion) {
+                    bucket.stored = stored;
+                    bucket.count = control[TimeseriesBucket::kCountField].numberInt();
+                    bucket.size = stored.objsize();
+                    bucket.min = control[TimeseriesBucket::kMinField][options.timeField].date();
+                    bucket.max = control[TimeseriesBucket::kMaxField][options.timeField].date();
+                }
+            }
+        }
+
+        for (const BSONObj* measurement : current.measurements) {
+            const Date_t time = (*measurement)[options.timeField].date();
+            if (bucket.count > 0) {
+                const Date_t min = std::min(bucket.min, time);
+                const Date_t max = std::max(bucket.max, time);
+                if (bucket.count >= options.bucketMaxCount ||
+                    (max - min).count() >= maxSpanMillis ||
+                    bucket.size + measurement->objsize() > kBucketMaxSizeBytes) {
+                    writeBucket(txn, collection, current.meta, true, &bucket);
+                    bucket = OpenBucket();
+                }
+            }
+
+            if (bucket.count == 0) {
+                bucket.id = OID::gen();
+                bucket.min = time;
+                bucket.max = time;
+            } else {
+                bucket.min = std::min(bucket.min, time);
+                bucket.max = std::max(bucket.max, time);
+            }
+            ++bucket.count;
+            bucket.size += measurement->objsize();
+            bucket.pending.push_back(measurement);
+        }
+
+        // A full bucket is closed right away rather than by the next measurement of its series.
+        const bool full = bucket.count >= options.bucketMaxCount;
+        writeBucket(txn, collection, current.meta, full, &bucket);
+        _setOpenBucketOnCommit(txn, current.key, full ? OID() : bucket.id);
+    }
+
+    return Status::OK();
+}
+
+OID BucketCatalog::_getOpenBucket(StringData seriesKey) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _openBuckets.find(seriesKey);
+    return it == _openBuckets.end() ? OID() : it->second;
+}
+
+void BucketCatalog::_setOpenBucketOnCommit(OperationContext* txn,
+                                           StringData seriesKey,
+                                           const OID& bucketId) {
+    std::string key = seriesKey.toString();
+    txn->recoveryUnit()->onCommit([this, key, bucketId] {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!bucketId.isSet()) {
+            _openBuckets.erase(key);
+            return;
+        }
+        if (_openBuckets.size() >= kMaxOpenBuckets) {
+            _openBuckets = StringMap<OID>();
+        }
+        _openBuckets[key] = bucketId;
+    });
+}
+
+}  // namespace mongo
@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/bson/oid.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+
+namespace mongo {
+
+class Collection;
+class OperationContext;
+class ServiceContext;
+
+/**
+ * Writes the measurements inserted into time-series collections into their buckets, whose format
+ * is described by TimeseriesBucket.
+ *
+ * The measurements of each series are appended to its open bucket until one does not fit, because
+ * its time is too far from the others or the bucket is full, at which point the bucket is
+ * compressed and a new one is opened. Appending to a bucket is an update with $set of the new rows
+ * and control fields, so that its oplog entry only holds what was appended, and secondaries apply
+ * the writes of the primary as they would for any collection.
+ *
+ * The catalog remembers the open bucket of each series to find it again by _id. It forgets them on
+ * restart, after which the measurements of each series start a new bucket, and never reopens a
+ * closed bucket: measurements which arrive late for their window of time go to the open bucket if
+ * they fit it, and otherwise close it.
+ */
+class BucketCatalog {
+    MONGO_DISALLOW_COPYING(BucketCatalog);
+
+public:
+    BucketCatalog() = default;
+
+    static BucketCatalog* get(ServiceContext* service);
+
+    /**
+     * Writes the measurements [begin, end) into the buckets of the time-series collection
+     * 'collection', within the unit of work of the caller, who holds the collection in MODE_IX.
+     * Their _id is dropped. Returns BadValue if one of them lacks a Date in the timeField, in which
+     * case nothing is written.
+     */
+    Status insert(OperationContext* txn,
+                  Collection* collection,
+                  std::vector<BSONObj>::const_iterator begin,
+                  std::vector<BSONObj>::const_iterator end);
+
+private:
+    /**
+     * Returns the _id of the open bucket of the series 'seriesKey', or an unset OID if it has none.
+     */
+    OID _getOpenBucket(StringData seriesKey);
+
+    /**
+     * Remembers 'bucketId', or no bucket if it is unset, as the open bucket of 'seriesKey' once the
+     * unit of work of 'txn' commits.
+     */
+    void _setOpenBucketOnCommit(OperationContext* txn, StringData seriesKey, const OID& bucketId);
+
+    stdx::mutex _mutex;
+
+    // The _id of the open bucket of each series, by the name of its collection and its meta.
+    StringMap<OID> _openBuckets;
+};
+
+}  // namespace mongo
@@ -0,0 +1,240 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket.h"
+
+#include <limits>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TimeseriesOptions makeOptions() {
+    auto options = TimeseriesOptions::parse(fromjson("{timeField: 't', metaField: 'sensor'}"));
+    ASSERT_OK(options.getStatus());
+    return options.getValue();
+}
+
+Date_t date(long long millis) {
+    return Date_t::fromMillisSinceEpoch(millis);
+}
+
+/**
+ * Returns the open bucket of 'meta' holding 'measurements', whose columns are in the order of
+ * their fields in the first measurement which has each.
+ */
+BSONObj makeBucket(const BSONObj& meta, const std::vector<BSONObj>& measurements) {
+    std::vector<std::string> names;
+    for (auto&& measurement : measurements) {
+        for (auto&& elem : measurement) {
+            if (std::find(names.begin(), names.end(), elem.fieldName()) == names.end()) {
+                names.push_back(elem.fieldName());
+            }
+        }
+    }
+
+    Date_t min = measurements.front()["t"].date();
+    Date_t max = min;
+    for (auto&& measurement : measurements) {
+        min = std::min(min, measurement["t"].date());
+        max = std::max(max, measurement["t"].date());
+    }
+
+    BSONObjBuilder bob;
+    bob.append("_id", OID::gen());
+    bob.append("control",
+               BSON("version" << 1 << "count" << static_cast<int>(measurements.size()) << "min"
+                              << BSON("t" << min)
+                              << "max"
+                              << BSON("t" << max)));
+    if (!meta.isEmpty()) {
+        bob.appendAs(meta.firstElement(), "meta");
+    }
+    BSONObjBuilder data(bob.subobjStart("data"));
+    for (auto&& name : names) {
+        BSONObjBuilder column(data.subobjStart(name));
+        for (size_t row = 0; row < measurements.size(); ++row) {
+            if (auto elem = measurements[row][name]) {
+                column.appendAs(elem, BSONObjBuilder::numStr(row));
+            }
+        }
+    }
+    data.done();
+    return bob.obj();
+}
+
+std::vector<BSONObj> unpack(const BSONObj& bucket) {
+    BucketUnpacker unpacker(makeOptions());
+    unpacker.reset(bucket);
+    std::vector<BSONObj> measurements;
+    while (unpacker.more()) {
+        measurements.push_back(unpacker.next());
+    }
+    return measurements;
+}
+
+void assertMeasurementsEqual(const std::vector<BSONObj>& expected,
+                             const std::vector<BSONObj>& actual) {
+    ASSERT_EQUALS(expected.size(), actual.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        ASSERT_TRUE(expected[i].binaryEqual(actual[i])) << expected[i] << " != " << actual[i];
+    }
+}
+
+TEST(TimeseriesBucket, CompressionRoundTrips) {
+    std::vector<BSONObj> measurements;
+    for (int i = 0; i < 100; ++i) {
+        BSONObjBuilder bob;
+        bob.append("t", date(1480000000000LL + i * 1000 + (i % 3)));
+        bob.append("count", i * 7);
+        bob.append("total", static_cast<long long>(i) * 1000000000LL);
+        bob.append("reading", static_cast<double>(20 - i));
+        bob.append("ratio", i / 3.0);
+        bob.append("status", i % 2 ? "ok" : "warn");
+        if (i % 10 == 0) {
+            bob.append("alarm", true);
+        }
+        measurements.push_back(bob.obj());
+    }
+
+    const BSONObj open = makeBucket(BSONObj(), measurements);
+    const BSONObj closed = TimeseriesBucket::compress(open);
+    ASSERT_EQUALS(2, closed["control"]["version"].numberInt());
+    ASSERT_EQUALS(open["control"]["min"].Obj(), closed["control"]["min"].Obj());
+
+    const BSONObj data = closed["data"].Obj();
+    ASSERT_EQUALS(BinData, data["t"].type());
+    ASSERT_EQUALS(BinData, data["count"].type());
+    ASSERT_EQUALS(BinData, data["total"].type());
+    ASSERT_EQUALS(BinData, data["reading"].type());
+    ASSERT_EQUALS(Object, data["ratio"].type());
+    ASSERT_EQUALS(Object, data["status"].type());
+    ASSERT_EQUALS(Object, data["alarm"].type());
+
+    // Regular times take a byte or two each.
+    int len;
+    data["t"].binData(len);
+    ASSERT_LESS_THAN(len, 2 + 2 * 100);
+
+    assertMeasurementsEqual(measurements, unpack(open));
+    assertMeasurementsEqual(measurements, unpack(closed));
+}
+
+TEST(TimeseriesBucket, CompressionHandlesExtremeValues) {
+    const long long values[] = {std::numeric_limits<long long>::max(),
+                                std::numeric_limits<long long>::min(),
+                                0,
+                                -1,
+                                std::numeric_limits<long long>::max(),
+                                1};
+    std::vector<BSONObj> measurements;
+    for (long long value : values) {
+        measurements.push_back(BSON("t" << date(value % 1000000) << "v" << value));
+    }
+
+    const BSONObj closed = TimeseriesBucket::compress(makeBucket(BSONObj(), measurements));
+    ASSERT_EQUALS(BinData, closed["data"]["v"].type());
+    assertMeasurementsEqual(measurements, unpack(closed));
+}
+
+TEST(TimeseriesBucket, CompressionKeepsColumnsOfMixedTypes) {
+    std::vector<BSONObj> measurements = {BSON("t" << date(0) << "v" << 1),
+                                         BSON("t" << date(1) << "v" << 2LL),
+                                         BSON("t" << date(2) << "v" << -0.0)};
+    const BSONObj closed = TimeseriesBucket::compress(makeBucket(BSONObj(), measurements));
+    ASSERT_EQUALS(Object, closed["data"]["v"].type());
+    assertMeasurementsEqual(measurements, unpack(closed));
+}
+
+TEST(TimeseriesBucket, UnpackingPlacesMetaAfterTime) {
+    const BSONObj meta = BSON("" << BSON("id" << 5));
+    const BSONObj bucket = makeBucket(meta, {BSON("t" << date(10) << "x" << 1)});
+    assertMeasurementsEqual({BSON("t" << date(10) << "sensor" << BSON("id" << 5) << "x" << 1)},
+                            unpack(bucket));
+    assertMeasurementsEqual(unpack(bucket), unpack(TimeseriesBucket::compress(bucket)));
+}
+
+TEST(TimeseriesBucket, UnpackingRejectsInvalidBuckets) {
+    BucketUnpacker unpacker(makeOptions());
+    ASSERT_THROWS_CODE(unpacker.reset(BSON("_id" << 1)), UserException, 40398);
+    ASSERT_THROWS_CODE(unpacker.reset(fromjson("{control: {version: 3, count: 1}, data: {}}")),
+                       UserException,
+                       40398);
+    ASSERT_THROWS_CODE(
+        unpacker.reset(fromjson("{control: {version: 1, count: 1}, data: {x: {'1': 5}}}")),
+        UserException,
+        40398);
+
+    BSONObj column = BSON("x" << BSONBinData("\x01\x12\x02", 3, BinDataGeneral));
+    BSONObj truncated =
+        BSON("control" << BSON("version" << 2 << "count" << 3) << "data" << column);
+    ASSERT_THROWS_CODE(unpacker.reset(truncated), UserException, 40398);
+}
+
+TEST(TimeseriesBucket, FilterBoundsTimeAndMatchesMeta) {
+    auto query = MatchExpressionParser::parse(
+        BSON("t" << BSON("$gte" << date(1000) << "$lt" << date(2000)) << "sensor" << "a"
+                 << "x"
+                 << 5),
+        ExtensionsCallbackDisallowExtensions(),
+        nullptr);
+    ASSERT_OK(query.getStatus());
+    auto filter = TimeseriesBucket::createFilter(makeOptions(), query.getValue().get(), nullptr);
+    ASSERT(filter);
+
+    auto bucket = [](const char* meta, long long min, long long max) {
+        return makeBucket(BSON("" << meta),
+                          {BSON("t" << date(min) << "x" << 1), BSON("t" << date(max) << "x" << 2)});
+    };
+    ASSERT_TRUE(filter->matchesBSON(bucket("a", 500, 1000)));
+    ASSERT_TRUE(filter->matchesBSON(bucket("a", 1500, 3000)));
+    ASSERT_FALSE(filter->matchesBSON(bucket("a", 0, 999)));
+    ASSERT_FALSE(filter->matchesBSON(bucket("a", 2000, 3000)));
+    ASSERT_FALSE(filter->matchesBSON(bucket("b", 1500, 1600)));
+}
+
+TEST(TimeseriesBucket, NoFilterWithoutTimeOrMetaPredicates) {
+    auto query = MatchExpressionParser::parse(
+        fromjson("{x: 5, t: {$gt: 5}, $or: [{sensor: 'a'}, {y: 1}]}"),
+        ExtensionsCallbackDisallowExtensions(),
+        nullptr);
+    ASSERT_OK(query.getStatus());
+    ASSERT_FALSE(TimeseriesBucket::createFilter(makeOptions(), query.getValue().get(), nullptr));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,124 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/timeseries_options.h"
+
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+
+const long long kMaxBucketMaxSpanSeconds = 365LL * 24 * 60 * 60;
+const int kMaxBucketMaxCount = 100 * 1000;
+
+/**
+ * Checks that 'elem' names a top-level field of the measurements.
+ */
+StatusWith<std::string> parseFieldName(const BSONElement& elem) {
+    if (elem.type() != String) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "'timeseries." << elem.fieldNameStringData()
+                              << "' has to be a string."};
+    }
+
+    StringData name = elem.valueStringData();
+    if (name.empty() || name[0] == '$' || name.find('.') != std::string::npos || name == "_id") {
+        return {ErrorCodes::BadValue,
+                str::stream() << "'" << name << "' cannot be the "
+                              << elem.fieldNameStringData()
+                              << " of a time-series collection, which has to be a top-level "
+                                 "field other than _id."};
+    }
+
+    return name.toString();
+}
+
+}  // namespace
+
+const long long TimeseriesOptions::kDefaultBucketMaxSpanSeconds;
+const int TimeseriesOptions::kDefaultBucketMaxCount;
+
+// static
+StatusWith<TimeseriesOptions> TimeseriesOptions::parse(const BSONObj& spec) {
+    TimeseriesOptions options;
+    for (auto&& elem : spec) {
+        const StringData fieldName = elem.fieldNameStringData();
+        if (fieldName == "timeField") {
+            auto name = parseFieldName(elem);
+            if (!name.isOK()) {
+                return name.getStatus();
+            }
+            options.timeField = std::move(name.getValue());
+        } else if (fieldName == "metaField") {
+            auto name = parseFieldName(elem);
+            if (!name.isOK()) {
+                return name.getStatus();
+            }
+            options.metaField = std::move(name.getValue());
+        } else if (fieldName == "bucketMaxSpanSeconds") {
+            if (!elem.isNumber() || elem.numberLong() <= 0 ||
+                elem.numberLong() > kMaxBucketMaxSpanSeconds) {
+                return {ErrorCodes::BadValue,
+                        str::stream() << "'timeseries.bucketMaxSpanSeconds' has to be a number "
+                                         "of seconds between 1 and "
+                                      << kMaxBucketMaxSpanSeconds
+                                      << "."};
+            }
+            options.bucketMaxSpanSeconds = elem.numberLong();
+        } else if (fieldName == "bucketMaxCount") {
+            if (!elem.isNumber() || elem.numberLong() <= 0 ||
+                elem.numberLong() > kMaxBucketMaxCount) {
+                return {ErrorCodes::BadValue,
+                        str::stream() << "'timeseries.bucketMaxCount' has to be a number "
+                                         "between 1 and "
+                                      << kMaxBucketMaxCount
+                                      << "."};
+            }
+            options.bucketMaxCount = elem.numberInt();
+        } else {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "Unknown field 'timeseries." << fieldName << "'."};
+        }
+    }
+
+    if (options.timeField.empty()) {
+        return {ErrorCodes::BadValue, "'timeseries.timeField' is required."};
+    }
+    if (options.metaField == options.timeField) {
+        return {ErrorCodes::BadValue,
+                "'timeseries.metaField' and 'timeseries.timeField' have to differ."};
+    }
+
+    return options;
+}
+
+}  // namespace mongo
@@ -0,0 +1,69 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+
+#pragma once
+
+#include <string>
+
+#include "mongo/base/status_with.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+/**
+ * The "timeseries" option of a time-series collection, which stores the measurements inserted
+ * into it in buckets:
+ *
+ *     db.createCollection("weather", {timeseries: {timeField: "ts", metaField: "sensor"}});
+ *
+ * Each bucket holds the measurements of one series, that is with the same value of the optional
+ * "metaField", whose times lie within "bucketMaxSpanSeconds" of each other, up to
+ * "bucketMaxCount" of them. See TimeseriesBucket for the format of the buckets.
+ */
+struct TimeseriesOptions {
+    static const long long kDefaultBucketMaxSpanSeconds = 60 * 60;
+    static const int kDefaultBucketMaxCount = 1000;
+
+    /**
+     * Parses the "timeseries" option 'spec'.
+     */
+    static StatusWith<TimeseriesOptions> parse(const BSONObj& spec);
+
+    // The top-level field holding the Date of each measurement. Required.
+    std::string timeField;
+
+    // The top-level field whose value identifies the series of each measurement, or empty if all
+    // the measurements of the collection belong to one series.
+    std::string metaField;
+
+    long long bucketMaxSpanSeconds = kDefaultBucketMaxSpanSeconds;
+    int bucketMaxCount = kDefaultBucketMaxCount;
+};
+
+}  // namespace mongo
@@ -34,6 +34,9 @@
 
 #include "mongo/db/ttl.h"
 
+#include <algorithm>
+#include <map>
+
 #include "mongo/base/counter.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_name.h"
@@ -43,10 +46,12 @@
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/client.h"
 #include "mongo/db/commands/fsync.h"
+#include "mongo/db/commands/server_status.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
-#include "mongo/db/exec/delete.h"
+#include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
 #include "mongo/db/namespace_string.h"
@@ -54,9 +59,13 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/background.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -69,14 +78,166 @@ using std::unique_ptr;
 
 Counter64 ttlPasses;
 Counter64 ttlDeletedDocuments;
+Counter64 ttlDeleteBatches;
 
 ServerStatusMetricField<Counter64> ttlPassesDisplay("ttl.passes", &ttlPasses);
 ServerStatusMetricField<Counter64> ttlDeletedDocumentsDisplay("ttl.deletedDocuments",
                                                               &ttlDeletedDocuments);
+ServerStatusMetricField<Counter64> ttlDeleteBatchesDisplay("ttl.deleteBatches", &ttlDeleteBatches);
 
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorEnabled, bool, true);
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorSleepSecs, int, 60);  // used for testing
 
+// The most documents deleted through a TTL index under a single acquisition of the collection lock.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorBatchSize, int, 500);
+
+// The most documents the TTL monitor deletes per second, across all collections. 0 means no limit.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorDeletesPerSecond, int, 0);
+
+// The number of collections whose expired documents are deleted at the same time.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorParallelism, int, 1);
+
+namespace {
+
+/**
+ * Spreads the deletes of every TTL worker over time, so that together they don't exceed
+ * ttlMonitorDeletesPerSecond.
+ */
+class TTLDeleteRateLimiter {
+public:
+    /**
+     * Accounts for 'numDeleted' more deletes, and returns how long the caller must wait before
+     * deleting any more documents.
+     */
+    Microseconds recordDeletes(long long numDeleted) {
+        const int deletesPerSecond = ttlMonitorDeletesPerSecond.load();
+        if (deletesPerSecond <= 0) {
+            return Microseconds(0);
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        const unsigned long long now = curTimeMicros64();
+        _nextDeleteMicros = std::max(_nextDeleteMicros, now);
+        _nextDeleteMicros += numDeleted * 1000 * 1000 / deletesPerSecond;
+        return Microseconds(static_cast<long long>(_nextDeleteMicros - now));
+    }
+
+private:
+    stdx::mutex _mutex;
+    unsigned long long _nextDeleteMicros = 0;
+};
+
+TTLDeleteRateLimiter ttlDeleteRateLimiter;
+
+/**
+ * The progress of the TTL monitor through each TTL index, as reported by the "ttlIndexes" section
+ * of serverStatus.
+ */
+class TTLIndexStatsRegistry {
+public:
+    /**
+     * Forgets the TTL indexes which aren't in 'indexes', a list of index specs.
+     */
+    void retainIndexes(const vector<BSONObj>& indexes) {
+        std::map<string, std::map<string, IndexStats>> retained;
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (auto&& spec : indexes) {
+            const string ns = spec["ns"].String();
+            const string name = spec["name"].String();
+            retained[ns][name] = _stats[ns][name];
+        }
+        _stats.swap(retained);
+    }
+
+    /**
+     * Records a batch of 'numDeleted' deletes, the oldest of which was 'lag' past its expiration.
+     */
+    void recordBatch(const string& ns, const string& name, long long numDeleted, Milliseconds lag) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        IndexStats& stats = _stats[ns][name];
+        stats.batches++;
+        stats.deletedDocuments += numDeleted;
+        stats.lag = lag;
+    }
+
+    /**
+     * Records a pass over the index which deleted 'numDeleted' documents.
+     */
+    void recordPass(const string& ns,
+                    const string& name,
+                    long long numDeleted,
+                    Milliseconds duration,
+                    bool caughtUp) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        IndexStats& stats = _stats[ns][name];
+        stats.passes++;
+        stats.lastPassDeletedDocuments = numDeleted;
+        stats.lastPassDuration = duration;
+        stats.lastPassEnd = Date_t::now();
+        if (caughtUp) {
+            stats.lag = Milliseconds(0);
+        }
+    }
+
+    void append(BSONObjBuilder* builder) const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (auto&& collection : _stats) {
+            BSONObjBuilder collectionBuilder(builder->subobjStart(collection.first));
+            for (auto&& index : collection.second) {
+                const IndexStats& stats = index.second;
+                BSONObjBuilder indexBuilder(collectionBuilder.subobjStart(index.first));
+                indexBuilder.appendNumber("passes", stats.passes);
+                indexBuilder.appendNumber("batches", stats.batches);
+                indexBuilder.appendNumber("deletedDocuments", stats.deletedDocuments);
+                indexBuilder.appendNumber("lastPassDeletedDocuments",
+                                          stats.lastPassDeletedDocuments);
+                indexBuilder.appendNumber("lastPassMillis",
+                                          durationCount<Milliseconds>(stats.lastPassDuration));
+                indexBuilder.appendDate("lastPassEnd", stats.lastPassEnd);
+                indexBuilder.appendNumber("lagMillis", durationCount<Milliseconds>(stats.lag));
+            }
+        }
+    }
+
+private:
+    struct IndexStats {
+        long long passes = 0;
+        long long batches = 0;
+        long long deletedDocuments = 0;
+        long long lastPassDeletedDocuments = 0;
+        Milliseconds lastPassDuration{0};
+        Date_t lastPassEnd;
+
+        // How long past its expiration the oldest document deleted by the latest batch was. Zero
+        // once a pass leaves no expired documents behind.
+        Milliseconds lag{0};
+    };
+
+    mutable stdx::mutex _mutex;
+    std::map<string, std::map<string, IndexStats>> _stats;
+};
+
+TTLIndexStatsRegistry ttlIndexStats;
+
+class TTLIndexesServerStatusSection : public ServerStatusSection {
+public:
+    TTLIndexesServerStatusSection() : ServerStatusSection("ttlIndexes") {}
+
+    bool includeByDefault() const override {
+        return false;
+    }
+
+    BSONObj generateSection(OperationContext* txn,
+                            const BSONElement& configElement) const override {
+        BSONObjBuilder builder;
+        ttlIndexStats.append(&builder);
+        return builder.obj();
+    }
+} ttlIndexesServerStatusSection;
+
+}  // namespace
+
 class TTLMonitor : public BackgroundJob {
 public:
     TTLMonitor() {}
@@ -118,6 +279,37 @@ public:
     }
 
 private:
+    /**
+     * The TTL indexes of each collection, which a pass hands out to its workers one collection
+     * at a time.
+     */
+    class CollectionQueue {
+    public:
+        explicit CollectionQueue(vector<vector<BSONObj>> collections)
+            : _collections(std::move(collections)) {}
+
+        size_t size() const {
+            return _collections.size();
+        }
+
+        /**
+         * Returns false once every collection has been handed out.
+         */
+        bool next(vector<BSONObj>* indexes) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (_next == _collections.size()) {
+                return false;
+            }
+            *indexes = _collections[_next++];
+            return true;
+        }
+
+    private:
+        stdx::mutex _mutex;
+        const vector<vector<BSONObj>> _collections;
+        size_t _next = 0;
+    };
+
     void doTTLPass() {
         // Count it as active from the moment the TTL thread wakes up
         const ServiceContext::UniqueOperationContext txnPtr = cc().makeOperationContext();
@@ -134,17 +326,63 @@ private:
 
         ttlPasses.increment();
 
+        // The index specifications are grouped by the collection to which they belong.
+        vector<BSONObj> allIndexes;
+        vector<vector<BSONObj>> indexesByCollection;
         for (set<string>::const_iterator i = dbs.begin(); i != dbs.end(); ++i) {
-            string db = *i;
-
             vector<BSONObj> indexes;
-            getTTLIndexesForDB(&txn, db, &indexes);
+            getTTLIndexesForDB(&txn, *i, &indexes);
 
+            for (vector<BSONObj>::const_iterator it = indexes.begin(); it != indexes.end(); ++it) {
+                if (indexesByCollection.empty() ||
+                    indexesByCollection.back().front()["ns"].String() != (*it)["ns"].String()) {
+                    indexesByCollection.emplace_back();
+                }
+                indexesByCollection.back().push_back(*it);
+                allIndexes.push_back(*it);
+            }
+        }
+        ttlIndexStats.retainIndexes(allIndexes);
+
+        CollectionQueue queue(std::move(indexesByCollection));
+        const size_t numWorkers =
+            std::min(queue.size(), static_cast<size_t>(std::max(1, ttlMonitorParallelism.load())));
+        if (numWorkers <= 1) {
+            doTTLForCollections(&txn, &queue);
+            return;
+        }
+
+        vector<stdx::thread> workers;
+        workers.reserve(numWorkers);
+        for (size_t i = 0; i < numWorkers; i++) {
+            workers.emplace_back([this, &queue] {
+                Client::initThread("TTLMonitorWorker");
+                AuthorizationSession::get(cc())->grantInternalAuthorization();
+                const ServiceContext::UniqueOperationContext workerTxn =
+                    cc().makeOperationContext();
+                try {
+                    doTTLForCollections(workerTxn.get(), &queue);
+                } catch (const WriteConflictException& e) {
+                    LOG(1) << "Got WriteConflictException in TTL worker thread";
+                }
+            });
+        }
+        for (auto&& worker : workers) {
+            worker.join();
+        }
+    }
+
+    /**
+     * Processes the TTL indexes of the collections taken from 'queue' until it is empty.
+     */
+    void doTTLForCollections(OperationContext* txn, CollectionQueue* queue) {
+        vector<BSONObj> indexes;
+        while (queue->next(&indexes)) {
             for (vector<BSONObj>::const_iterator it = indexes.begin(); it != indexes.end(); ++it) {
                 BSONObj idx = *it;
                 try {
-                    if (!doTTLForIndex(&txn, db, idx)) {
-                        break;  // stop processing TTL indexes on this database
+                    if (!doTTLForIndex(txn, idx)) {
+                        break;  // stop processing TTL indexes on this collection
                     }
                 } catch (const DBException& dbex) {
                     error() << "Error processing ttl index: " << idx << " -- " << dbex.toString();
@@ -205,10 +443,13 @@ private:
      * after a sufficient amount of time has passed according to its expiry
      * specification.
      *
-     * @return true if caller should continue processing TTL indexes of collections
-     *         on the specified database, and false otherwise
+     * The documents are deleted in batches of at most ttlMonitorBatchSize, each under its own
+     * acquisition of the collection lock, and no faster than ttlMonitorDeletesPerSecond allows.
+     *
+     * @return true if caller should continue processing TTL indexes of the collection, and false
+     *         otherwise
      */
-    bool doTTLForIndex(OperationContext* txn, const string& dbName, BSONObj idx) {
+    bool doTTLForIndex(OperationContext* txn, BSONObj idx) {
         const string ns = idx["ns"].String();
         NamespaceString nss(ns);
         if (!userAllowedWriteNS(nss).isOK()) {
@@ -225,8 +466,59 @@ private:
 
         LOG(1) << "TTL -- ns: " << ns << " key: " << key;
 
+        const string indexName = idx["name"].String();
+        Timer timer;
+        long long numDeleted = 0;
+        bool caughtUp = false;
+        bool keepGoing = true;
+        while (!caughtUp && keepGoing && !inShutdown()) {
+            txn->checkForInterrupt();
+
+            // Keep each batch small enough to let the rate limit spread deletes out evenly.
+            long long maxDocs = std::max(1, ttlMonitorBatchSize.load());
+            const int deletesPerSecond = ttlMonitorDeletesPerSecond.load();
+            if (deletesPerSecond > 0) {
+                maxDocs = std::min(maxDocs, static_cast<long long>(deletesPerSecond));
+            }
+
+            long long batchDeleted = 0;
+            keepGoing = deleteExpiredBatch(txn, nss, key, maxDocs, &batchDeleted, &caughtUp);
+            numDeleted += batchDeleted;
+            if (batchDeleted == 0) {
+                // Every expired document the batch found was changed or deleted by someone else.
+                break;
+            }
+
+            sleepFor(ttlDeleteRateLimiter.recordDeletes(batchDeleted));
+        }
+
+        ttlIndexStats.recordPass(ns, indexName, numDeleted, Milliseconds(timer.millis()), caughtUp);
+        LOG(1) << "\tTTL deleted: " << numDeleted << endl;
+
+        return keepGoing;
+    }
+
+    /**
+     * Deletes up to 'maxDocs' of the expired documents which the TTL index on 'key' finds, in
+     * RecordId order.
+     *
+     * Sets 'numDeleted' to the number of documents deleted, and 'caughtUp' to whether the index
+     * had no more expired documents.
+     *
+     * @return true if caller should continue processing TTL indexes of the collection, and false
+     *         otherwise
+     */
+    bool deleteExpiredBatch(OperationContext* txn,
+                            const NamespaceString& nss,
+                            const BSONObj& key,
+                            long long maxDocs,
+                            long long* numDeleted,
+                            bool* caughtUp) {
+        const string& ns = nss.ns();
+        *numDeleted = 0;
+
         ScopedTransaction scopedXact(txn, MODE_IX);
-        AutoGetDb autoDb(txn, dbName, MODE_IX);
+        AutoGetDb autoDb(txn, nss.db(), MODE_IX);
         Database* db = autoDb.getDb();
         if (!db) {
             return false;
@@ -237,7 +529,7 @@ private:
         Collection* collection = db->getCollection(ns);
         if (!collection) {
             // Collection was dropped.
-            return true;
+            return false;
         }
 
         if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(nss)) {
@@ -249,13 +541,13 @@ private:
         IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByKeyPattern(txn, key);
         if (!desc) {
             LOG(1) << "index not found (index build in progress? index dropped?), skipping "
-                   << "ttl job for: " << idx;
+                   << "ttl job for: " << key << " on " << ns;
             return true;
         }
 
         // Re-read 'idx' from the descriptor, in case the collection or index definition
         // changed before we re-acquired the collection lock.
-        idx = desc->infoObj();
+        BSONObj idx = desc->infoObj();
 
         if (IndexType::INDEX_BTREE != IndexNames::nameToType(desc->getAccessMethodName())) {
             error() << "special index can't be used as a ttl index, skipping ttl job for: " << idx;
@@ -282,9 +574,9 @@ private:
             ? InternalPlanner::Direction::FORWARD
             : InternalPlanner::Direction::BACKWARD;
 
-        // We need to pass into the DeleteStageParams (below) a CanonicalQuery with a BSONObj that
-        // queries for the expired documents correctly so that we do not delete documents that are
-        // not actually expired when our snapshot changes during deletion.
+        // We need a CanonicalQuery with a BSONObj that queries for the expired documents
+        // correctly so that we do not delete documents that are not actually expired when they
+        // change between reading their index keys and deleting them.
         const char* keyFieldName = key.firstElement().fieldName();
         BSONObj query =
             BSON(keyFieldName << BSON("$gte" << kDawnOfTime << "$lte" << expirationTime));
@@ -293,31 +585,72 @@ private:
         auto canonicalQuery = CanonicalQuery::canonicalize(
             txn, std::move(qr), ExtensionsCallbackDisallowExtensions());
         invariantOK(canonicalQuery.getStatus());
+        const MatchExpression* expiredFilter = canonicalQuery.getValue()->root();
+
+        // Either direction scans the oldest keys first.
+        vector<RecordId> locs;
+        BSONObj oldestKey;
+        {
+            unique_ptr<PlanExecutor> exec = InternalPlanner::indexScan(txn,
+                                                                       collection,
+                                                                       desc,
+                                                                       startKey,
+                                                                       endKey,
+                                                                       endKeyInclusive,
+                                                                       PlanExecutor::YIELD_MANUAL,
+                                                                       direction);
+            BSONObj indexKey;
+            RecordId loc;
+            PlanExecutor::ExecState state = PlanExecutor::ADVANCED;
+            while (static_cast<long long>(locs.size()) < maxDocs &&
+                   PlanExecutor::ADVANCED == (state = exec->getNext(&indexKey, &loc))) {
+                if (locs.empty()) {
+                    oldestKey = indexKey.getOwned();
+                }
+                locs.push_back(loc);
+            }
 
-        DeleteStageParams params;
-        params.isMulti = true;
-        params.canonicalQuery = canonicalQuery.getValue().get();
-
-        unique_ptr<PlanExecutor> exec =
-            InternalPlanner::deleteWithIndexScan(txn,
-                                                 collection,
-                                                 params,
-                                                 desc,
-                                                 startKey,
-                                                 endKey,
-                                                 endKeyInclusive,
-                                                 PlanExecutor::YIELD_AUTO,
-                                                 direction);
-
-        Status result = exec->executePlan();
-        if (!result.isOK()) {
-            error() << "ttl query execution for index " << idx << " failed with status: " << result;
-            return true;
+            if (state != PlanExecutor::ADVANCED && state != PlanExecutor::IS_EOF) {
+                error() << "ttl query execution for index " << idx << " failed with status: "
+                        << WorkingSetCommon::toStatusString(indexKey);
+                return true;
+            }
+            *caughtUp = (state == PlanExecutor::IS_EOF);
         }
 
-        const long long numDeleted = DeleteStage::getNumDeleted(*exec);
-        ttlDeletedDocuments.increment(numDeleted);
-        LOG(1) << "\tTTL deleted: " << numDeleted << endl;
+        // Deleting in RecordId order visits the collection's storage sequentially. A document
+        // with several expired keys is only deleted once.
+        std::sort(locs.begin(), locs.end());
+        locs.erase(std::unique(locs.begin(), locs.end()), locs.end());
+
+        for (auto&& loc : locs) {
+            bool deleted = false;
+            MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
+                deleted = false;
+                WriteUnitOfWork wunit(txn);
+                Snapshotted<BSONObj> doc;
+                if (collection->findDoc(txn, loc, &doc) &&
+                    expiredFilter->matchesBSON(doc.value())) {
+                    collection->deleteDocument(txn, loc, nullptr);
+                    deleted = true;
+                }
+                wunit.commit();
+            }
+            MONGO_WRITE_CONFLICT_RETRY_LOOP_END(txn, "ttl delete", ns);
+
+            if (deleted) {
+                ++*numDeleted;
+            }
+        }
+
+        ttlDeleteBatches.increment();
+        ttlDeletedDocuments.increment(*numDeleted);
+
+        Milliseconds lag(0);
+        if (!oldestKey.isEmpty() && oldestKey.firstElement().type() == Date) {
+            lag = std::max(Milliseconds(0), expirationTime - oldestKey.firstElement().date());
+        }
+        ttlIndexStats.recordBatch(ns, desc->indexName(), *numDeleted, lag);
 
         return true;
     }
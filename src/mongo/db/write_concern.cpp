@@ -42,6 +42,7 @@
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/timer_stats.h"
+#include "mongo/db/stats/wait_event_stats.h"
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/rpc/protocol.h"
@@ -232,6 +233,7 @@ Status waitForWriteConcern(OperationContext* txn,
         case WriteConcernOptions::SyncMode::NONE:
             break;
         case WriteConcernOptions::SyncMode::FSYNC: {
+            ScopedWaitEvent wait(txn, WaitEvent::kJournalFlush);
             StorageEngine* storageEngine = getGlobalServiceContext()->getGlobalStorageEngine();
             if (!storageEngine->isDurable()) {
                 result->fsyncFiles = storageEngine->flushAllFiles(true);
@@ -241,7 +243,8 @@ Status waitForWriteConcern(OperationContext* txn,
             }
             break;
         }
-        case WriteConcernOptions::SyncMode::JOURNAL:
+        case WriteConcernOptions::SyncMode::JOURNAL: {
+            ScopedWaitEvent wait(txn, WaitEvent::kJournalFlush);
             if (replCoord->getReplicationMode() != repl::ReplicationCoordinator::Mode::modeNone) {
                 // Wait for ops to become durable then update replication system's
                 // knowledge of this.
@@ -252,6 +255,7 @@ Status waitForWriteConcern(OperationContext* txn,
                 txn->recoveryUnit()->waitUntilDurable();
             }
             break;
+        }
     }
 
     result->syncMillis = syncTimer.millis();
@@ -272,9 +276,11 @@ Status waitForWriteConcern(OperationContext* txn,
 
     // Now we wait for replication
     // Note that replica set stepdowns and gle mode changes are thrown as errors
-    repl::ReplicationCoordinator::StatusAndDuration replStatus =
-        repl::getGlobalReplicationCoordinator()->awaitReplication(
+    repl::ReplicationCoordinator::StatusAndDuration replStatus = [&] {
+        ScopedWaitEvent wait(txn, WaitEvent::kReplicationWriteConcern);
+        return repl::getGlobalReplicationCoordinator()->awaitReplication(
             txn, replOpTime, writeConcernWithPopulatedSyncMode);
+    }();
     if (replStatus.status == ErrorCodes::WriteConcernFailed) {
         gleWtimeouts.increment();
         result->err = "timeout";
@@ -28,6 +28,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <limits>
+
 #include "mongo/db/json.h"
 #include "mongo/db/operation_context_noop.h"
 #include "mongo/dbtests/dbtests.h"
@@ -64,6 +66,46 @@ public:
         }
 
         _chunkRangeMap = _constructRanges(_chunkMap);
+        _constructHashedChunkBoundaries();
+    }
+
+    bool hasHashedChunkBoundaries() const {
+        return !_hashedChunks.empty();
+    }
+
+    /**
+     * Moves the chunk ending at 'max' to 'shardId' and patches the range map with only that chunk
+     * marked as changed.
+     */
+    void moveChunk(const BSONObj& max, const ShardId& shardId) {
+        auto it = _chunkMap.find(max);
+        ASSERT(it != _chunkMap.end());
+
+        const std::shared_ptr<Chunk> oldChunk = it->second;
+        it->second.reset(new Chunk(
+            this, oldChunk->getMin(), oldChunk->getMax(), shardId, oldChunk->getLastmod(), 0));
+
+        _chunkRangeMap = _updateRanges(
+            _chunkRangeMap, _chunkMap, ChunkRange(oldChunk->getMin(), oldChunk->getMax()));
+    }
+
+    size_t numRanges() const {
+        return _chunkRangeMap.size();
+    }
+
+    /**
+     * Checks that the incrementally maintained range map is identical to one built from scratch.
+     */
+    void assertRangesMatchFullRebuild() const {
+        const ChunkRangeMap expected = _constructRanges(_chunkMap);
+        ASSERT_EQUALS(expected.size(), _chunkRangeMap.size());
+
+        for (auto it = expected.begin(), actual = _chunkRangeMap.begin(); it != expected.end();
+             ++it, ++actual) {
+            ASSERT_EQUALS(it->first, actual->first);
+            ASSERT_EQUALS(it->second.getMin(), actual->second.getMin());
+            ASSERT_EQUALS(it->second.getShardId(), actual->second.getShardId());
+        }
     }
 };
 
@@ -337,6 +379,91 @@ class InMultiShard : public CompoundKeyBase {
     }
 };
 
+class IncrementalRangeUpdate {
+public:
+    void run() {
+        ShardKeyPattern shardKeyPattern(BSON("a" << 1));
+        TestableChunkManager chunkManager("", shardKeyPattern, false);
+        chunkManager.setSingleChunkForShards({BSON("a"
+                                                   << "x"),
+                                              BSON("a"
+                                                   << "y"),
+                                              BSON("a"
+                                                   << "z")});
+        ASSERT_EQUALS(4U, chunkManager.numRanges());
+
+        // [y, z) joins [x, y) on shard 1
+        chunkManager.moveChunk(BSON("a"
+                                    << "z"),
+                               ShardId("1"));
+        chunkManager.assertRangesMatchFullRebuild();
+        ASSERT_EQUALS(3U, chunkManager.numRanges());
+
+        // [MinKey, x) joins [x, z) on shard 1
+        chunkManager.moveChunk(BSON("a"
+                                    << "x"),
+                               ShardId("1"));
+        chunkManager.assertRangesMatchFullRebuild();
+        ASSERT_EQUALS(2U, chunkManager.numRanges());
+
+        // [z, MaxKey) joins [MinKey, z) on shard 1
+        chunkManager.moveChunk(shardKeyPattern.getKeyPattern().globalMax(), ShardId("1"));
+        chunkManager.assertRangesMatchFullRebuild();
+        ASSERT_EQUALS(1U, chunkManager.numRanges());
+
+        // [x, y) is split out of the middle of the single range
+        chunkManager.moveChunk(BSON("a"
+                                    << "y"),
+                               ShardId("2"));
+        chunkManager.assertRangesMatchFullRebuild();
+        ASSERT_EQUALS(3U, chunkManager.numRanges());
+    }
+};
+
+class HashedKeyTargeting {
+public:
+    void run() {
+        auto opCtx = stdx::make_unique<OperationContextNoop>();
+
+        ShardKeyPattern shardKeyPattern(BSON("a"
+                                             << "hashed"));
+        TestableChunkManager chunkManager("", shardKeyPattern, false);
+        chunkManager.setSingleChunkForShards(
+            {BSON("a" << -100LL), BSON("a" << 0LL), BSON("a" << 100LL)});
+        ASSERT(chunkManager.hasHashedChunkBoundaries());
+
+        const std::vector<std::pair<long long, std::string>> expected{
+            {std::numeric_limits<long long>::min(), "0"},
+            {-101, "0"},
+            {-100, "1"},
+            {-1, "1"},
+            {0, "2"},
+            {99, "2"},
+            {100, "3"},
+            {std::numeric_limits<long long>::max(), "3"}};
+
+        for (const auto& keyAndShard : expected) {
+            auto chunk =
+                chunkManager.findIntersectingChunk(opCtx.get(), BSON("a" << keyAndShard.first));
+            ASSERT_EQUALS(ShardId(keyAndShard.second), chunk->getShardId());
+            ASSERT(chunk->containsKey(BSON("a" << keyAndShard.first)));
+        }
+    }
+};
+
+class HashedKeyWithNonNumericSplitPoint {
+public:
+    void run() {
+        ShardKeyPattern shardKeyPattern(BSON("a"
+                                             << "hashed"));
+        TestableChunkManager chunkManager("", shardKeyPattern, false);
+        chunkManager.setSingleChunkForShards({BSON("a" << 0LL),
+                                              BSON("a"
+                                                   << "x")});
+        ASSERT(!chunkManager.hasHashedChunkBoundaries());
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("chunk") {}
@@ -361,6 +488,9 @@ public:
         add<InequalityThenUnsatisfiable>();
         add<OrEqualityUnsatisfiableInequality>();
         add<InMultiShard>();
+        add<IncrementalRangeUpdate>();
+        add<HashedKeyTargeting>();
+        add<HashedKeyWithNonNumericSplitPoint>();
     }
 };
 
@@ -439,6 +439,58 @@ public:
     }
 };
 
+/** Writes made during a background build end up in the index once it is committed. */
+class InsertBuildCapturesConcurrentWrites : public IndexBuildBase {
+public:
+    void run() {
+        for (int i = 1; i <= 3; i++) {
+            _client.insert(_ns, BSON("_id" << i << "a" << i));
+        }
+
+        MultiIndexBlock indexer(&_txn, collection());
+        indexer.allowBackgroundBuilding();
+        indexer.allowInterruption();
+
+        const BSONObj spec = BSON("name"
+                                  << "a"
+                                  << "ns"
+                                  << _ns
+                                  << "key"
+                                  << BSON("a" << 1)
+                                  << "unique"
+                                  << true
+                                  << "background"
+                                  << true);
+        ASSERT_OK(indexer.init(spec));
+
+        // The key of the removed document moves to a new one, which mustn't be a duplicate.
+        _client.update(_ns, BSON("_id" << 1), BSON("$set" << BSON("a" << 10)));
+        _client.remove(_ns, BSON("_id" << 2));
+        _client.insert(_ns, BSON("_id" << 4 << "a" << 2));
+        ASSERT_OK(indexer.insertAllDocumentsInCollection());
+
+        _client.insert(_ns, BSON("_id" << 5 << "a" << 5));
+        _client.update(_ns, BSON("_id" << 3), BSON("$set" << BSON("a" << BSON_ARRAY(3 << 6))));
+        {
+            WriteUnitOfWork wunit(&_txn);
+            indexer.commit();
+            wunit.commit();
+        }
+
+        IndexCatalog* indexCatalog = collection()->getIndexCatalog();
+        IndexDescriptor* desc = indexCatalog->findIndexByName(&_txn, "a");
+        ASSERT(desc);
+        ASSERT(indexCatalog->isMultikey(&_txn, desc));
+
+        std::vector<int> keys;
+        auto cursor = indexCatalog->getIndex(desc)->newCursor(&_txn);
+        for (auto kv = cursor->seek(BSONObj(), true); kv; kv = cursor->next()) {
+            keys.push_back(kv->key.firstElement().numberInt());
+        }
+        ASSERT(keys == std::vector<int>({2, 3, 5, 6, 10}));
+    }
+};
+
 /** Index creation fills a passed-in set of dups rather than failing. */
 template <bool background>
 class InsertBuildFillDups : public IndexBuildBase {
@@ -500,6 +552,193 @@ public:
     }
 };
 
+/** Bottom-up builds of several indexes may run in parallel and still report dups and multikey. */
+class InsertBuildParallelBulkCommit : public IndexBuildBase {
+public:
+    void run() {
+        // Create a new collection.
+        Database* db = _ctx.db();
+        Collection* coll;
+        {
+            WriteUnitOfWork wunit(&_txn);
+            db->dropCollection(&_txn, _ns);
+            coll = db->createCollection(&_txn, _ns);
+
+            OpDebug* const nullOpDebug = nullptr;
+            ASSERT_OK(coll->insertDocument(&_txn,
+                                           BSON("_id" << 1 << "a"
+                                                      << "dup"
+                                                      << "b"
+                                                      << BSON_ARRAY(1 << 2)),
+                                           nullOpDebug,
+                                           true));
+            ASSERT_OK(coll->insertDocument(&_txn,
+                                           BSON("_id" << 2 << "a"
+                                                      << "dup"
+                                                      << "b"
+                                                      << 3),
+                                           nullOpDebug,
+                                           true));
+            wunit.commit();
+        }
+
+        MultiIndexBlock indexer(&_txn, coll);
+        indexer.allowParallelBulkCommit();
+
+        const std::vector<BSONObj> specs = {BSON("name"
+                                                 << "a"
+                                                 << "ns"
+                                                 << coll->ns().ns()
+                                                 << "key"
+                                                 << BSON("a" << 1)
+                                                 << "unique"
+                                                 << true),
+                                            BSON("name"
+                                                 << "b"
+                                                 << "ns"
+                                                 << coll->ns().ns()
+                                                 << "key"
+                                                 << BSON("b" << 1))};
+        ASSERT_OK(indexer.init(specs));
+
+        std::set<RecordId> dups;
+        ASSERT_OK(indexer.insertAllDocumentsInCollection(&dups));
+        ASSERT_EQUALS(dups.size(), 1U);
+
+        {
+            WriteUnitOfWork wunit(&_txn);
+            indexer.commit();
+            wunit.commit();
+        }
+
+        IndexCatalog* indexCatalog = coll->getIndexCatalog();
+        IndexDescriptor* bIndex = indexCatalog->findIndexByName(&_txn, "b");
+        ASSERT(bIndex);
+        ASSERT(indexCatalog->isMultikey(&_txn, bIndex));
+        IndexDescriptor* aIndex = indexCatalog->findIndexByName(&_txn, "a");
+        ASSERT(aIndex);
+        ASSERT_FALSE(indexCatalog->isMultikey(&_txn, aIndex));
+    }
+};
+
+/** The keys of several indexes may be generated in parallel from a single collection scan. */
+class InsertBuildParallelKeyGeneration : public IndexBuildBase {
+public:
+    void run() {
+        // Create a new collection.
+        Database* db = _ctx.db();
+        Collection* coll;
+        const int nDocs = 2500;
+        {
+            WriteUnitOfWork wunit(&_txn);
+            db->dropCollection(&_txn, _ns);
+            coll = db->createCollection(&_txn, _ns);
+
+            OpDebug* const nullOpDebug = nullptr;
+            for (int i = 0; i < nDocs; ++i) {
+                BSONObj doc = i % 2 ? BSON("_id" << i << "a" << i << "b" << BSON_ARRAY(i << -i))
+                                    : BSON("_id" << i << "a" << i << "b" << i << "c" << i);
+                ASSERT_OK(coll->insertDocument(&_txn, doc, nullOpDebug, true));
+            }
+            wunit.commit();
+        }
+
+        MultiIndexBlock indexer(&_txn, coll);
+        indexer.allowParallelKeyGeneration();
+
+        const std::vector<BSONObj> specs = {BSON("name"
+                                                 << "a"
+                                                 << "ns"
+                                                 << coll->ns().ns()
+                                                 << "key"
+                                                 << BSON("a" << 1)),
+                                            BSON("name"
+                                                 << "b"
+                                                 << "ns"
+                                                 << coll->ns().ns()
+                                                 << "key"
+                                                 << BSON("b" << 1)),
+                                            BSON("name"
+                                                 << "c"
+                                                 << "ns"
+                                                 << coll->ns().ns()
+                                                 << "key"
+                                                 << BSON("c" << 1)
+                                                 << "partialFilterExpression"
+                                                 << BSON("c" << BSON("$exists" << true)))};
+        ASSERT_OK(indexer.init(specs));
+        ASSERT_OK(indexer.insertAllDocumentsInCollection());
+
+        {
+            WriteUnitOfWork wunit(&_txn);
+            indexer.commit();
+            wunit.commit();
+        }
+
+        IndexCatalog* indexCatalog = coll->getIndexCatalog();
+        IndexDescriptor* bIndex = indexCatalog->findIndexByName(&_txn, "b");
+        ASSERT(bIndex);
+        ASSERT(indexCatalog->isMultikey(&_txn, bIndex));
+        IndexDescriptor* aIndex = indexCatalog->findIndexByName(&_txn, "a");
+        ASSERT(aIndex);
+        ASSERT_FALSE(indexCatalog->isMultikey(&_txn, aIndex));
+
+        ASSERT_EQUALS(nDocs, _client.query(_ns, Query().hint(BSON("a" << 1)))->itcount());
+        ASSERT_EQUALS(
+            nDocs / 2,
+            _client.query(_ns, Query(BSON("b" << BSON("$lt" << 0))).hint(BSON("b" << 1)))
+                ->itcount());
+        ASSERT_EQUALS(
+            nDocs / 2,
+            _client.query(_ns, Query(BSON("c" << BSON("$exists" << true))).hint(BSON("c" << 1)))
+                ->itcount());
+    }
+};
+
+/** An error generating keys on a worker thread fails the whole index build. */
+class InsertBuildParallelKeyGenerationError : public IndexBuildBase {
+public:
+    void run() {
+        // Create a new collection.
+        Database* db = _ctx.db();
+        Collection* coll;
+        {
+            WriteUnitOfWork wunit(&_txn);
+            db->dropCollection(&_txn, _ns);
+            coll = db->createCollection(&_txn, _ns);
+
+            OpDebug* const nullOpDebug = nullptr;
+            for (int i = 0; i < 10; ++i) {
+                ASSERT_OK(coll->insertDocument(&_txn,
+                                               BSON("_id" << i << "a" << i << "loc"
+                                                          << "not a point"),
+                                               nullOpDebug,
+                                               true));
+            }
+            wunit.commit();
+        }
+
+        MultiIndexBlock indexer(&_txn, coll);
+        indexer.allowParallelKeyGeneration();
+
+        const std::vector<BSONObj> specs = {BSON("name"
+                                                 << "a"
+                                                 << "ns"
+                                                 << coll->ns().ns()
+                                                 << "key"
+                                                 << BSON("a" << 1)),
+                                            BSON("name"
+                                                 << "loc"
+                                                 << "ns"
+                                                 << coll->ns().ns()
+                                                 << "key"
+                                                 << BSON("loc"
+                                                         << "2dsphere"))};
+        ASSERT_OK(indexer.init(specs));
+        ASSERT_NOT_OK(indexer.insertAllDocumentsInCollection());
+    }
+};
+
 /** Index creation is killed if mayInterrupt is true. */
 class InsertBuildIndexInterrupt : public IndexBuildBase {
 public:
@@ -993,6 +1232,10 @@ public:
         add<InsertBuildEnforceUnique<false>>();
         add<InsertBuildFillDups<true>>();
         add<InsertBuildFillDups<false>>();
+        add<InsertBuildParallelBulkCommit>();
+        add<InsertBuildParallelKeyGeneration>();
+        add<InsertBuildParallelKeyGenerationError>();
+        add<InsertBuildCapturesConcurrentWrites>();
         add<InsertBuildIndexInterrupt>();
         add<InsertBuildIndexInterruptDisallowed>();
         add<InsertBuildIdIndexInterrupt>();
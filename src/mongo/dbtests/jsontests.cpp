@@ -33,6 +33,7 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <limits>
 
 #include "mongo/db/jsobj.h"
@@ -40,6 +41,8 @@
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/platform/decimal128.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 
 namespace JsonTests {
@@ -2699,6 +2702,44 @@ class MaxKey : public Base {
     }
 };
 
+// Parses a corpus of newline-delimited documents, like an import does, and reports throughput.
+class NewlineDelimitedCorpus {
+public:
+    void run() {
+        vector<BSONObj> docs;
+        std::string corpus;
+        for (int i = 0; i < 2000; ++i) {
+            BSONObjBuilder b;
+            b.append("_id", i);
+            b.append("name", str::stream() << "user" << i);
+            b.append("text",
+                     str::stream() << std::string(i % 300, 'x') << "\"quoted\"\n\t"
+                                   << std::string(i % 7, 'y'));
+            b.append("nested", BSON("a" << BSON_ARRAY(1 << 2.5 << "z") << "b" << true));
+            docs.push_back(b.obj());
+            corpus += docs.back().jsonString(Strict);
+            corpus += '\n';
+        }
+
+        Timer timer;
+        const char* next = corpus.c_str();
+        for (const BSONObj& expected : docs) {
+            int len = 0;
+            BSONObj parsed = fromjson(next, &len);
+            ASSERT_EQUALS(expected, parsed);
+            next += len;
+            ASSERT_EQUALS('\n', *next);
+            ++next;
+        }
+        ASSERT_EQUALS('\0', *next);
+
+        const long long micros = std::max(timer.micros(), 1LL);
+        ::mongo::log() << "fromjson parsed " << corpus.size() << " bytes in " << docs.size()
+                       << " documents in " << micros << " micros ("
+                       << (corpus.size() / static_cast<double>(micros)) << " MB/s)";
+    }
+};
+
 }  // namespace FromJsonTests
 
 class All : public Suite {
@@ -2963,6 +3004,7 @@ public:
         add<FromJsonTests::NullFieldUnquoted>();
         add<FromJsonTests::MinKey>();
         add<FromJsonTests::MaxKey>();
+        add<FromJsonTests::NewlineDelimitedCorpus>();
     }
 };
 
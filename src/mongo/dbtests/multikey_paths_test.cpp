@@ -236,6 +236,35 @@ TEST_F(MultikeyPathsTest, PathsUpdatedOnDocumentInsert) {
     assertMultikeyPaths(collection, keyPattern, {{0U}, {0U}});
 }
 
+TEST_F(MultikeyPathsTest, PathsUpdatedOnBatchInsert) {
+    AutoGetCollection autoColl(_opCtx.get(), _nss, MODE_X);
+    Collection* collection = autoColl.getCollection();
+    invariant(collection);
+
+    BSONObj keyPattern = BSON("a" << 1 << "b" << 1);
+    createIndex(collection,
+                BSON("name"
+                     << "a_1_b_1"
+                     << "ns"
+                     << _nss.ns()
+                     << "key"
+                     << keyPattern));
+
+    {
+        WriteUnitOfWork wuow(_opCtx.get());
+        OpDebug* const nullOpDebug = nullptr;
+        const bool enforceQuota = true;
+        std::vector<BSONObj> docs{BSON("_id" << 0 << "a" << 5 << "b" << BSON_ARRAY(1 << 2 << 3)),
+                                  BSON("_id" << 1 << "a" << 3 << "b" << 4),
+                                  BSON("_id" << 2 << "a" << BSON_ARRAY(1 << 2 << 3) << "b" << 5)};
+        ASSERT_OK(collection->insertDocuments(
+            _opCtx.get(), docs.begin(), docs.end(), nullOpDebug, enforceQuota));
+        wuow.commit();
+    }
+
+    assertMultikeyPaths(collection, keyPattern, {{0U}, {0U}});
+}
+
 TEST_F(MultikeyPathsTest, PathsUpdatedOnDocumentUpdate) {
     AutoGetCollection autoColl(_opCtx.get(), _nss, MODE_X);
     Collection* collection = autoColl.getCollection();
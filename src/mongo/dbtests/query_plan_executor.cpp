@@ -511,6 +511,48 @@ public:
     }
 };
 
+/**
+ * Test that the cursor manager keeps track of many cursors, whichever of its partitions they
+ * belong to.
+ */
+class ManyCursors : public PlanExecutorBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_txn, nss.ns());
+        insert(BSON("a" << 1 << "b" << 1));
+
+        Collection* coll = ctx.getCollection();
+        CursorManager* cursorManager = coll->getCursorManager();
+
+        const size_t numClientCursors = 100;
+        std::set<CursorId> ids;
+        for (size_t i = 0; i < numClientCursors; i++) {
+            BSONObj filterObj = fromjson("{_id: {$gt: 0}, b: {$gt: 0}}");
+            PlanExecutor* exec = makeCollScanExec(coll, filterObj);
+            ids.insert(
+                (new ClientCursor(cursorManager, exec, nss.ns(), false, 0, BSONObj()))->cursorid());
+        }
+        ASSERT_EQUALS(numClientCursors, ids.size());
+        ASSERT_EQUALS(numClientCursors, numCursors());
+
+        std::set<CursorId> openCursors;
+        cursorManager->getCursorIds(&openCursors);
+        ASSERT(ids == openCursors);
+        for (auto&& id : ids) {
+            ClientCursor* cc = cursorManager->find(id, false);
+            ASSERT(cc);
+            ASSERT_EQUALS(id, cc->cursorid());
+        }
+
+        ASSERT_OK(cursorManager->eraseCursor(&_txn, *ids.begin(), false));
+        ASSERT_FALSE(cursorManager->find(*ids.begin(), false));
+        ASSERT_EQUALS(numClientCursors - 1, numCursors());
+
+        cursorManager->invalidateAll(false, "ManyCursors Test");
+        ASSERT_EQUALS(0U, numCursors());
+    }
+};
+
 }  // namespace ClientCursor
 
 class All : public Suite {
@@ -526,6 +568,7 @@ public:
         add<ClientCursor::Invalidate>();
         add<ClientCursor::InvalidatePinned>();
         add<ClientCursor::Timeout>();
+        add<ClientCursor::ManyCursors>();
     }
 };
 
@@ -565,6 +565,11 @@ public:
         // foo == bar == baz, and foo<=20, bar>=10, 5<=baz<=15, so our values are:
         // foo == 10, 11, 12, 13, 14, 15.
         ASSERT_EQUALS(6, countResults(ah.get()));
+
+        // Most of the RecordIds of the second and third children are not in those of the
+        // previous children, and the Bloom filter should have ruled some of them out.
+        const AndHashStats* stats = static_cast<const AndHashStats*>(ah->getSpecificStats());
+        ASSERT_GREATER_THAN(stats->bloomFilterRejects, 0U);
     }
 };
 
@@ -42,6 +42,7 @@
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_cache_replanner.h"
 #include "mongo/db/query/plan_yield_policy.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner_params.h"
@@ -249,6 +250,87 @@ public:
     }
 };
 
+/**
+ * Test that with background replanning enabled, hitting the trial period's threshold for work
+ * cycles leaves the query running the cached plan and replans in the background instead, which
+ * results in a new plan cache entry.
+ */
+class QueryStageCachedPlanBackgroundReplan : public QueryStageCachedPlanBase {
+public:
+    QueryStageCachedPlanBackgroundReplan()
+        : _oldBackgroundReplan(internalQueryCacheBackgroundReplan.load()) {
+        internalQueryCacheBackgroundReplan.store(true);
+    }
+
+    ~QueryStageCachedPlanBackgroundReplan() {
+        internalQueryCacheBackgroundReplan.store(_oldBackgroundReplan);
+    }
+
+    void run() {
+        AutoGetCollectionForRead ctx(&_txn, nss.ns());
+        Collection* collection = ctx.getCollection();
+        ASSERT(collection);
+
+        // Query can be answered by either index on "a" or index on "b".
+        auto qr = stdx::make_unique<QueryRequest>(nss);
+        qr->setFilter(fromjson("{a: {$gte: 8}, b: 1}"));
+        auto statusWithCQ = CanonicalQuery::canonicalize(
+            txn(), std::move(qr), ExtensionsCallbackDisallowExtensions());
+        ASSERT_OK(statusWithCQ.getStatus());
+        const std::unique_ptr<CanonicalQuery> cq = std::move(statusWithCQ.getValue());
+
+        // We shouldn't have anything in the plan cache for this shape yet.
+        PlanCache* cache = collection->infoCache()->getPlanCache();
+        ASSERT(cache);
+        CachedSolution* rawCachedSolution;
+        ASSERT_NOT_OK(cache->get(*cq, &rawCachedSolution));
+
+        // Get planner params.
+        QueryPlannerParams plannerParams;
+        fillOutPlannerParams(&_txn, collection, cq.get(), &plannerParams);
+
+        // Set up queued data stage to take long enough before returning EOF to trigger a replan.
+        const size_t decisionWorks = 10;
+        const size_t mockWorks =
+            1U + static_cast<size_t>(internalQueryCacheEvictionRatio * decisionWorks);
+        auto mockChild = stdx::make_unique<QueuedDataStage>(&_txn, &_ws);
+        for (size_t i = 0; i < mockWorks; i++) {
+            mockChild->pushBack(PlanStage::NEED_TIME);
+        }
+
+        CachedPlanStage cachedPlanStage(
+            &_txn, collection, &_ws, cq.get(), plannerParams, decisionWorks, mockChild.release());
+
+        PlanYieldPolicy yieldPolicy(PlanExecutor::YIELD_MANUAL,
+                                    _txn.getServiceContext()->getFastClockSource());
+        ASSERT_OK(cachedPlanStage.pickBestPlan(&yieldPolicy));
+
+        const CachedPlanStats* stats =
+            static_cast<const CachedPlanStats*>(cachedPlanStage.getSpecificStats());
+        ASSERT_FALSE(stats->replanned);
+        ASSERT_TRUE(stats->backgroundReplanScheduled);
+
+        // The query carries on with the cached plan, which produces no results.
+        PlanStage::StageState state = PlanStage::NEED_TIME;
+        while (state != PlanStage::IS_EOF) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            state = cachedPlanStage.work(&id);
+
+            ASSERT_NE(state, PlanStage::ADVANCED);
+            ASSERT_NE(state, PlanStage::FAILURE);
+            ASSERT_NE(state, PlanStage::DEAD);
+        }
+
+        // The background replan writes the winner of a new trial period to the plan cache.
+        PlanCacheReplanner::get(_txn.getServiceContext())->waitForIdle();
+        ASSERT_OK(cache->get(*cq, &rawCachedSolution));
+        const std::unique_ptr<CachedSolution> cachedSolution(rawCachedSolution);
+    }
+
+private:
+    const bool _oldBackgroundReplan;
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_cached_plan") {}
@@ -256,6 +338,7 @@ public:
     void setupTests() {
         add<QueryStageCachedPlanFailure>();
         add<QueryStageCachedPlanHitMaxWorks>();
+        add<QueryStageCachedPlanBackgroundReplan>();
     }
 };
 
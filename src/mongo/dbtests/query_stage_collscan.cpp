@@ -32,6 +32,8 @@
 
 #include "mongo/platform/basic.h"
 
+#include <set>
+
 #include "mongo/client/dbclientcursor.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
@@ -44,6 +46,7 @@
 #include "mongo/db/matcher/expression_parser.h"
 #include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
@@ -149,8 +152,6 @@ public:
 protected:
     const ServiceContext::UniqueOperationContext _txnPtr = cc().makeOperationContext();
     OperationContext& _txn = *_txnPtr;
-
-private:
     DBDirectClient _client;
 };
 
@@ -400,6 +401,138 @@ public:
     }
 };
 
+//
+// Documents handed out by the scan point into its cursor, and are only copied when the consumer
+// still holds them once the cursor moves or is saved.
+//
+
+class QueryStageCollscanBorrowedObjects : public QueryStageCollectionScanBase {
+public:
+    void run() {
+        AutoGetCollectionForRead ctx(&_txn, ns());
+
+        CollectionScanParams params;
+        params.collection = ctx.getCollection();
+        params.direction = CollectionScanParams::FORWARD;
+        params.tailable = false;
+
+        WorkingSet ws;
+        unique_ptr<CollectionScan> scan(new CollectionScan(&_txn, params, &ws, NULL));
+
+        // Hold on to the first few results, as a batched parent would.
+        std::vector<WorkingSetID> results;
+        WorkingSetID id = WorkingSet::INVALID_ID;
+        while (results.size() < 10U) {
+            if (PlanStage::ADVANCED == scan->work(&id)) {
+                results.push_back(id);
+            }
+        }
+
+        for (size_t i = 0; i < results.size(); ++i) {
+            WorkingSetMember* member = ws.get(results[i]);
+            ASSERT_EQUALS(static_cast<int>(i), member->obj.value()["foo"].numberInt());
+            if (supportsDocLocking() && i + 1 < results.size()) {
+                ASSERT_TRUE(member->obj.value().isOwned());
+            }
+        }
+
+        // Saving the scan must not leave the last result pointing into the saved cursor.
+        scan->saveState();
+        if (supportsDocLocking()) {
+            ASSERT_TRUE(ws.get(results.back())->obj.value().isOwned());
+        }
+        scan->restoreState();
+        ASSERT_EQUALS(9, ws.get(results.back())->obj.value()["foo"].numberInt());
+
+        for (auto result : results) {
+            ws.free(result);
+        }
+
+        // Results that are freed before the scan moves on are never copied, and the scan carries
+        // on from where it was.
+        int count = static_cast<int>(results.size());
+        while (!scan->isEOF()) {
+            PlanStage::StageState state = scan->work(&id);
+            if (PlanStage::ADVANCED == state) {
+                ASSERT_EQUALS(count, ws.get(id)->obj.value()["foo"].numberInt());
+                ws.free(id);
+                ++count;
+            }
+        }
+        ASSERT_EQUALS(numObj(), count);
+    }
+};
+
+//
+// A shared scan started while another scan of the collection is running begins where the other
+// scan is, wraps around, and still returns every document once.
+//
+
+class QueryStageCollscanSharedScan : public QueryStageCollectionScanBase {
+public:
+    void run() {
+        const int nDocs = 300;
+        {
+            OldClientWriteContext ctx(&_txn, ns());
+            for (int i = numObj(); i < nDocs; ++i) {
+                _client.insert(ns(), BSON("foo" << i));
+            }
+        }
+
+        const bool oldSharedScans = internalQueryExecSharedCollectionScans.load();
+        internalQueryExecSharedCollectionScans.store(true);
+
+        AutoGetCollectionForRead ctx(&_txn, ns());
+
+        CollectionScanParams params;
+        params.collection = ctx.getCollection();
+        params.direction = CollectionScanParams::FORWARD;
+        params.tailable = false;
+
+        // The first scan reports its position after every 128 records.
+        WorkingSet firstWs;
+        unique_ptr<CollectionScan> firstScan(new CollectionScan(&_txn, params, &firstWs, NULL));
+        int firstCount = 0;
+        while (firstCount < 200) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            if (PlanStage::ADVANCED == firstScan->work(&id)) {
+                ASSERT_EQUALS(firstCount, firstWs.get(id)->obj.value()["foo"].numberInt());
+                firstWs.free(id);
+                ++firstCount;
+            }
+        }
+
+        WorkingSet secondWs;
+        unique_ptr<CollectionScan> secondScan(new CollectionScan(&_txn, params, &secondWs, NULL));
+        std::set<int> seen;
+        int firstSeen = -1;
+        while (!secondScan->isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            if (PlanStage::ADVANCED == secondScan->work(&id)) {
+                int foo = secondWs.get(id)->obj.value()["foo"].numberInt();
+                if (firstSeen < 0) {
+                    firstSeen = foo;
+                }
+                ASSERT_TRUE(seen.insert(foo).second);
+                secondWs.free(id);
+            }
+        }
+
+        internalQueryExecSharedCollectionScans.store(oldSharedScans);
+
+        ASSERT_EQUALS(static_cast<size_t>(nDocs), seen.size());
+
+        // Where the record store can start a cursor in the middle, the second scan starts at the
+        // 128th document, which is where the first scan last reported its position.
+        const RecordStore* rs = params.collection->getRecordStore();
+        if (supportsDocLocking() && rs->getCursorForRange(&_txn, RecordId(), RecordId::max())) {
+            ASSERT_EQUALS(127, firstSeen);
+        } else {
+            ASSERT_EQUALS(0, firstSeen);
+        }
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("QueryStageCollectionScan") {}
@@ -414,6 +547,8 @@ public:
         add<QueryStageCollscanObjectsInOrderBackward>();
         add<QueryStageCollscanInvalidateUpcomingObject>();
         add<QueryStageCollscanInvalidateUpcomingObjectBackward>();
+        add<QueryStageCollscanBorrowedObjects>();
+        add<QueryStageCollscanSharedScan>();
     }
 };
 
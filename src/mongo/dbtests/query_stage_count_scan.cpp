@@ -36,6 +36,7 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/count.h"
 #include "mongo/db/exec/count_scan.h"
 #include "mongo/db/exec/keep_mutations.h"
 #include "mongo/db/exec/working_set.h"
@@ -638,6 +639,72 @@ public:
     }
 };
 
+//
+// Check that counting in batches dedups like work() and makes no working set members, and that a
+// CountStage asking for batches applies its skip and limit
+//
+class QueryStageCountScanBatches : public CountBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_txn, ns());
+
+        for (int i = 0; i < 50; ++i) {
+            insert(BSON("a" << BSON_ARRAY(i << i + 100)));
+        }
+        addIndex(BSON("a" << 1));
+
+        CountScanParams params;
+        params.descriptor = getIndex(ctx.db(), BSON("a" << 1));
+        params.startKey = BSON("" << 0);
+        params.startKeyInclusive = true;
+        params.endKey = BSON("" << 1000);
+        params.endKeyInclusive = true;
+
+        {
+            WorkingSet ws;
+            CountScan count(&_txn, params, &ws);
+
+            size_t numCounted = 0;
+            PlanStage::StageState state = PlanStage::NEED_TIME;
+            while (PlanStage::IS_EOF != state) {
+                std::vector<WorkingSetID> results;
+                WorkingSetID id = WorkingSet::INVALID_ID;
+                state = count.workBatch(7, &results, &id);
+                for (auto result : results) {
+                    ASSERT_EQUALS(WorkingSet::INVALID_ID, result);
+                }
+                numCounted += results.size();
+            }
+            ASSERT_EQUALS(50U, numCounted);
+        }
+
+        {
+            WorkingSet ws;
+            CountRequest request(NamespaceString(ns()), fromjson("{}"));
+            request.setSkip(5);
+            request.setLimit(30);
+            CountStage countStage(&_txn,
+                                  ctx.getCollection(),
+                                  CountStageParams(request, false),
+                                  &ws,
+                                  new CountScan(&_txn, params, &ws));
+
+            PlanStage::StageState state = PlanStage::NEED_TIME;
+            while (PlanStage::IS_EOF != state) {
+                std::vector<WorkingSetID> results;
+                WorkingSetID id = WorkingSet::INVALID_ID;
+                state = countStage.workBatch(16, &results, &id);
+                ASSERT(results.empty());
+            }
+
+            const CountStats* stats =
+                static_cast<const CountStats*>(countStage.getSpecificStats());
+            ASSERT_EQUALS(30, stats->nCounted);
+            ASSERT_EQUALS(5, stats->nSkipped);
+        }
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_count_scan") {}
@@ -654,6 +721,7 @@ public:
         add<QueryStageCountScanInsertNewDocsDuringYield>();
         add<QueryStageCountScanBecomesMultiKeyDuringYield>();
         add<QueryStageCountScanUnusedKeys>();
+        add<QueryStageCountScanBatches>();
     }
 };
 
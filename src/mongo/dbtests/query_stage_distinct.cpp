@@ -37,6 +37,8 @@
 #include "mongo/db/exec/distinct_scan.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/extensions_callback_disallow_extensions.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/dbtests/dbtests.h"
@@ -229,6 +231,113 @@ public:
     }
 };
 
+// Tests distinct with a filter over the key data of a compound index.
+class QueryStageDistinctFilter : public DistinctBase {
+public:
+    virtual ~QueryStageDistinctFilter() {}
+
+    void run() {
+        // For each 'a' in [1, 3] insert documents with every 'b' in [0, 9], except that no
+        // document with a: 2 has b: 7.
+        for (int a = 1; a <= 3; ++a) {
+            for (int b = 0; b < 10; ++b) {
+                if (a != 2 || b != 7) {
+                    insert(BSON("a" << a << "b" << b));
+                }
+            }
+        }
+
+        addIndex(BSON("a" << 1 << "b" << 1));
+
+        AutoGetCollectionForRead ctx(&_txn, ns());
+        Collection* coll = ctx.getCollection();
+
+        const CollatorInterface* collator = nullptr;
+        StatusWithMatchExpression statusWithMatcher = MatchExpressionParser::parse(
+            BSON("b" << 7), ExtensionsCallbackDisallowExtensions(), collator);
+        ASSERT_OK(statusWithMatcher.getStatus());
+        std::unique_ptr<MatchExpression> filter = std::move(statusWithMatcher.getValue());
+
+        DistinctParams params;
+        params.descriptor =
+            coll->getIndexCatalog()->findIndexByKeyPattern(&_txn, BSON("a" << 1 << "b" << 1));
+        verify(params.descriptor);
+        params.direction = 1;
+        params.fieldNo = 0;
+        params.filter = filter.get();
+        params.bounds.isSimpleRange = false;
+        OrderedIntervalList oilA("a");
+        oilA.intervals.push_back(IndexBoundsBuilder::allValues());
+        params.bounds.fields.push_back(oilA);
+        OrderedIntervalList oilB("b");
+        oilB.intervals.push_back(IndexBoundsBuilder::allValues());
+        params.bounds.fields.push_back(oilB);
+
+        WorkingSet ws;
+        DistinctScan distinct(&_txn, params, &ws);
+
+        // Only the values of 'a' with a key passing the filter come back, each with that key.
+        std::vector<int> seen;
+        WorkingSetID wsid;
+        PlanStage::StageState state;
+        while (PlanStage::IS_EOF != (state = distinct.work(&wsid))) {
+            if (PlanStage::ADVANCED == state) {
+                ASSERT_EQUALS(7, getIntFieldDotted(ws, wsid, "b"));
+                seen.push_back(getIntFieldDotted(ws, wsid, "a"));
+            }
+        }
+
+        ASSERT_EQUALS(2U, seen.size());
+        ASSERT_EQUALS(1, seen[0]);
+        ASSERT_EQUALS(3, seen[1]);
+    }
+};
+
+// Tests that a deduplicating distinct scan returns each document of a multikey index once.
+class QueryStageDistinctMultiKeyDedup : public DistinctBase {
+public:
+    virtual ~QueryStageDistinctMultiKeyDedup() {}
+
+    void run() {
+        for (size_t i = 0; i < 100; ++i) {
+            insert(BSON("a" << BSON_ARRAY(1 << 2 << 3)));
+            insert(BSON("a" << BSON_ARRAY(4 << 5 << 6)));
+        }
+
+        addIndex(BSON("a" << 1));
+
+        AutoGetCollectionForRead ctx(&_txn, ns());
+        Collection* coll = ctx.getCollection();
+
+        DistinctParams params;
+        params.descriptor = coll->getIndexCatalog()->findIndexByKeyPattern(&_txn, BSON("a" << 1));
+        verify(params.descriptor);
+        ASSERT_TRUE(params.descriptor->isMultikey(&_txn));
+        params.direction = 1;
+        params.fieldNo = 0;
+        params.dedup = true;
+        params.bounds.isSimpleRange = false;
+        OrderedIntervalList oil("a");
+        oil.intervals.push_back(IndexBoundsBuilder::allValues());
+        params.bounds.fields.push_back(oil);
+
+        WorkingSet ws;
+        DistinctScan distinct(&_txn, params, &ws);
+
+        // The first document found for 1 holds 2 and 3 as well, and likewise for 4, 5 and 6.
+        std::set<RecordId> returned;
+        WorkingSetID wsid;
+        PlanStage::StageState state;
+        while (PlanStage::IS_EOF != (state = distinct.work(&wsid))) {
+            if (PlanStage::ADVANCED == state) {
+                ASSERT_TRUE(returned.insert(ws.get(wsid)->recordId).second);
+            }
+        }
+
+        ASSERT_EQUALS(2U, returned.size());
+    }
+};
+
 // XXX: add a test case with bounds where skipping to the next key gets us a result that's not
 // valid w.r.t. our query.
 
@@ -239,6 +348,8 @@ public:
     void setupTests() {
         add<QueryStageDistinctBasic>();
         add<QueryStageDistinctMultiKey>();
+        add<QueryStageDistinctFilter>();
+        add<QueryStageDistinctMultiKeyDedup>();
     }
 };
 
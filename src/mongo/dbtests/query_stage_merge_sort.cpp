@@ -255,6 +255,81 @@ public:
     }
 };
 
+// Each document appears in both indices under a single sort key, so the records remembered for
+// deduplication are forgotten as the sort key moves on without letting any duplicates through.
+class QueryStageMergeSortDedupPrunesSeenRecords : public QueryStageMergeSortTestBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_txn, ns());
+        Database* db = ctx.db();
+        Collection* coll = db->getCollection(ns());
+        if (!coll) {
+            WriteUnitOfWork wuow(&_txn);
+            coll = db->createCollection(&_txn, ns());
+            wuow.commit();
+        }
+
+        const int N = 3 * MergeSortStage::kSeenRecordsBeforePruning;
+
+        // Several documents share each value of 'c'.
+        for (int i = 0; i < N; ++i) {
+            insert(BSON("a" << 1 << "b" << 1 << "c" << i / 3));
+        }
+
+        BSONObj firstIndex = BSON("a" << 1 << "c" << 1);
+        BSONObj secondIndex = BSON("b" << 1 << "c" << 1);
+
+        addIndex(firstIndex);
+        addIndex(secondIndex);
+
+        WorkingSet ws;
+        // Sort by c:1
+        MergeSortStageParams msparams;
+        msparams.pattern = BSON("c" << 1);
+        msparams.singleSortKeyPerRecord = true;
+        auto ms = make_unique<MergeSortStage>(&_txn, msparams, &ws, coll);
+
+        // a:1
+        IndexScanParams params;
+        params.descriptor = getIndex(firstIndex, coll);
+        params.bounds.isSimpleRange = true;
+        params.bounds.startKey = objWithMinKey(1);
+        params.bounds.endKey = objWithMaxKey(1);
+        params.bounds.endKeyInclusive = true;
+        params.direction = 1;
+        ms->addChild(new IndexScan(&_txn, params, &ws, NULL));
+
+        // b:1
+        params.descriptor = getIndex(secondIndex, coll);
+        ms->addChild(new IndexScan(&_txn, params, &ws, NULL));
+
+        set<RecordId> returned;
+        int lastC = -1;
+        while (!ms->isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState status = ms->work(&id);
+            if (PlanStage::ADVANCED != status) {
+                ASSERT_NE(PlanStage::FAILURE, status);
+                continue;
+            }
+
+            WorkingSetMember* member = ws.get(id);
+            BSONElement c;
+            ASSERT(member->getFieldDotted("c", &c));
+            ASSERT_LTE(lastC, c.numberInt());
+            lastC = c.numberInt();
+            ASSERT(returned.insert(member->recordId).second);
+            ws.free(id);
+        }
+
+        ASSERT_EQUALS(static_cast<size_t>(N), returned.size());
+
+        const MergeSortStats* stats = static_cast<const MergeSortStats*>(ms->getSpecificStats());
+        ASSERT_EQUALS(static_cast<size_t>(N), stats->dupsDropped);
+        ASSERT_GT(stats->dedupPrunes, 0U);
+    }
+};
+
 // Each inserted document appears in both indices, no deduping, get each result twice.
 class QueryStageMergeSortDupsNoDedup : public QueryStageMergeSortTestBase {
 public:
@@ -894,6 +969,7 @@ public:
     void setupTests() {
         add<QueryStageMergeSortPrefixIndex>();
         add<QueryStageMergeSortDups>();
+        add<QueryStageMergeSortDedupPrunesSeenRecords>();
         add<QueryStageMergeSortDupsNoDedup>();
         add<QueryStageMergeSortPrefixIndexReverse>();
         add<QueryStageMergeSortOneStageEOF>();
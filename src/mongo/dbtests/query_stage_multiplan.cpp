@@ -390,6 +390,70 @@ private:
     }
 };
 
+// Test that once the trial period is a quarter done, only the best
+// 'internalQueryPlanEvaluationMaxCandidates' plans keep being worked.
+class MPSPruneCandidates : public QueryStageMultiPlanBase {
+public:
+    void run() {
+        // Insert a document to create the collection.
+        insert(BSON("x" << 1));
+
+        const int nDocs = 500;
+        const size_t numPlans = 3;
+
+        // Plan 'i' returns a result on every (i + 1)th call to work(), so plan 0 is the fastest.
+        auto ws = stdx::make_unique<WorkingSet>();
+        std::vector<std::unique_ptr<QueuedDataStage>> plans;
+        for (size_t i = 0; i < numPlans; ++i) {
+            plans.push_back(stdx::make_unique<QueuedDataStage>(&_txn, ws.get()));
+            for (int j = 0; j < nDocs; ++j) {
+                WorkingSetID id = ws->allocate();
+                WorkingSetMember* wsm = ws->get(id);
+                wsm->obj = Snapshotted<BSONObj>(SnapshotId(), BSON("x" << 1));
+                wsm->transitionToOwnedObj();
+                plans.back()->pushBack(id);
+                for (size_t k = 0; k < i; ++k) {
+                    plans.back()->pushBack(PlanStage::NEED_TIME);
+                }
+            }
+        }
+
+        AutoGetCollectionForRead ctx(&_txn, nss.ns());
+
+        auto qr = stdx::make_unique<QueryRequest>(nss);
+        qr->setFilter(BSON("x" << 1));
+        auto cq = uassertStatusOK(CanonicalQuery::canonicalize(
+            txn(), std::move(qr), ExtensionsCallbackDisallowExtensions()));
+        unique_ptr<MultiPlanStage> mps =
+            make_unique<MultiPlanStage>(&_txn, ctx.getCollection(), cq.get());
+        for (auto&& plan : plans) {
+            mps->addPlan(createQuerySolution(), plan.release(), ws.get());
+        }
+
+        // With a trial period of 40 works, no plan can produce enough results to end the trial
+        // early, and the losing plans are pruned after 10 works.
+        const int oldWorks = internalQueryPlanEvaluationWorks.load();
+        const int oldMaxCandidates = internalQueryPlanEvaluationMaxCandidates.load();
+        internalQueryPlanEvaluationWorks.store(40);
+        internalQueryPlanEvaluationMaxCandidates.store(1);
+
+        PlanYieldPolicy yieldPolicy(PlanExecutor::YIELD_MANUAL, _clock);
+        Status status = mps->pickBestPlan(&yieldPolicy);
+
+        internalQueryPlanEvaluationWorks.store(oldWorks);
+        internalQueryPlanEvaluationMaxCandidates.store(oldMaxCandidates);
+
+        ASSERT_OK(status);
+        ASSERT(mps->bestPlanChosen());
+        ASSERT_EQUALS(0, mps->bestPlanIdx());
+
+        ASSERT_EQUALS(40U, mps->getChildren()[0]->getStats()->common.works);
+        for (size_t i = 1; i < numPlans; ++i) {
+            ASSERT_EQUALS(10U, mps->getChildren()[i]->getStats()->common.works);
+        }
+    }
+};
+
 // Test that the plan summary only includes stats from the winning plan.
 //
 // This is a regression test for SERVER-20111.
@@ -439,6 +503,7 @@ public:
         add<MPSBackupPlan>();
         add<MPSExplainAllPlans>();
         add<MPSSummaryStats>();
+        add<MPSPruneCandidates>();
     }
 };
 
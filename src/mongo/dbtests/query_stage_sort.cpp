@@ -41,6 +41,7 @@
 #include "mongo/db/exec/sort.h"
 #include "mongo/db/json.h"
 #include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
 
@@ -156,11 +157,13 @@ public:
         params.collection = coll;
         params.pattern = BSON("foo" << direction);
         params.limit = limit();
+        params.allowDiskUse = allowDiskUse();
 
         auto keyGenStage = make_unique<SortKeyGeneratorStage>(
             &_txn, queuedDataStage.release(), ws.get(), params.pattern, BSONObj(), nullptr);
 
         auto sortStage = make_unique<SortStage>(&_txn, params, ws.get(), keyGenStage.release());
+        const SortStage* sortStagePtr = sortStage.get();
 
         auto fetchStage =
             make_unique<FetchStage>(&_txn, ws.get(), sortStage.release(), nullptr, coll);
@@ -192,6 +195,12 @@ public:
         }
         ASSERT_EQUALS(PlanExecutor::IS_EOF, state);
         checkCount(count);
+
+        if (allowDiskUse()) {
+            // The data does not fit in the memory limit, so it must have been spilled.
+            auto stats = static_cast<const SortStats*>(sortStagePtr->getSpecificStats());
+            ASSERT_GREATER_THAN(stats->spills, 0U);
+        }
     }
 
     /**
@@ -215,6 +224,11 @@ public:
         return 0;
     };
 
+    // Returns whether the sort may spill to disk.
+    virtual bool allowDiskUse() const {
+        return false;
+    }
+
 
     static const char* ns() {
         return "unittests.QueryStageSort";
@@ -302,6 +316,35 @@ public:
     }
 };
 
+// Sort a bunch of objects which do not fit in the memory limit, spilling them to disk.
+class QueryStageSortExternal : public QueryStageSortExt {
+public:
+    QueryStageSortExternal()
+        : _maxBlockingSortBytes(internalQueryExecMaxBlockingSortBytes.load()) {
+        internalQueryExecMaxBlockingSortBytes.store(16 * 1024);
+    }
+
+    virtual ~QueryStageSortExternal() {
+        internalQueryExecMaxBlockingSortBytes.store(_maxBlockingSortBytes);
+    }
+
+    virtual bool allowDiskUse() const {
+        return true;
+    }
+
+private:
+    const int _maxBlockingSortBytes;
+};
+
+// Spill with the top-k limiting strategy.
+template <int LIMIT>
+class QueryStageSortExternalWithLimit : public QueryStageSortExternal {
+public:
+    virtual int limit() const {
+        return LIMIT;
+    }
+};
+
 // Mutation invalidation of docs fed to sort.
 class QueryStageSortMutationInvalidation : public QueryStageSortTestBase {
 public:
@@ -586,6 +629,8 @@ public:
         // and a special case for limit == 1
         add<QueryStageSortDecWithLimit<1>>();
         add<QueryStageSortExt>();
+        add<QueryStageSortExternal>();
+        add<QueryStageSortExternalWithLimit<5000>>();
         add<QueryStageSortMutationInvalidation>();
         add<QueryStageSortDeletionInvalidation>();
         add<QueryStageSortDeletionInvalidationWithLimit<10>>();
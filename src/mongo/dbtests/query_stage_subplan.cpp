@@ -312,6 +312,68 @@ public:
     }
 };
 
+/**
+ * Branches of the same shape should only have their candidate plans ranked once per query.
+ */
+class QueryStageSubplanReuseRankingForSameShape : public QueryStageSubplanBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_txn, nss.ns());
+
+        addIndex(BSON("a" << 1));
+        addIndex(BSON("b" << 1));
+        addIndex(BSON("c" << 1));
+
+        for (int i = 0; i < 10; i++) {
+            insert(BSON("a" << 1 << "b" << i << "c" << i));
+            insert(BSON("a" << 2 << "b" << i << "c" << i));
+        }
+
+        // The first two branches have the same shape, and each of them can use either the {a: 1}
+        // or the {b: 1} index. The third branch has a different shape.
+        BSONObj query = fromjson("{$or: [{a: 1, b: 1}, {a: 2, b: 2}, {c: 3}]}");
+
+        Collection* collection = ctx.getCollection();
+
+        auto qr = stdx::make_unique<QueryRequest>(nss);
+        qr->setFilter(query);
+        auto cq = unittest::assertGet(CanonicalQuery::canonicalize(
+            txn(), std::move(qr), ExtensionsCallbackDisallowExtensions()));
+
+        // Get planner params.
+        QueryPlannerParams plannerParams;
+        fillOutPlannerParams(&_txn, collection, cq.get(), &plannerParams);
+
+        WorkingSet ws;
+        std::unique_ptr<SubplanStage> subplan(
+            new SubplanStage(&_txn, collection, &ws, plannerParams, cq.get()));
+
+        PlanYieldPolicy yieldPolicy(PlanExecutor::YIELD_MANUAL, _clock);
+        ASSERT_OK(subplan->pickBestPlan(&yieldPolicy));
+
+        ASSERT_FALSE(subplan->branchPlannedFromEarlierBranch(0));
+        ASSERT_TRUE(subplan->branchPlannedFromEarlierBranch(1));
+        ASSERT_FALSE(subplan->branchPlannedFromEarlierBranch(2));
+
+        // Work the stage until it produces all results.
+        size_t numResults = 0;
+        PlanStage::StageState stageState = PlanStage::NEED_TIME;
+        while (stageState != PlanStage::IS_EOF) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            stageState = subplan->work(&id);
+            ASSERT_NE(stageState, PlanStage::DEAD);
+            ASSERT_NE(stageState, PlanStage::FAILURE);
+
+            if (stageState == PlanStage::ADVANCED) {
+                ++numResults;
+            }
+        }
+
+        // {a: 1, b: 1}, {a: 2, b: 2} and the two documents with c: 3.
+        ASSERT_EQ(numResults, 4U);
+    }
+};
+
 /**
  * Unit test the subplan stage's canUseSubplanning() method.
  */
@@ -634,6 +696,7 @@ public:
         add<QueryStageSubplanPlanFromCache>();
         add<QueryStageSubplanDontCacheZeroResults>();
         add<QueryStageSubplanDontCacheTies>();
+        add<QueryStageSubplanReuseRankingForSameShape>();
         add<QueryStageSubplanCanUseSubplanning>();
         add<QueryStageSubplanRewriteToRootedOr>();
         add<QueryStageSubplanPlanContainedOr>();
@@ -99,13 +99,28 @@ public:
      */
     size_t createdConnections(const stdx::unique_lock<stdx::mutex>& lk);
 
+    /**
+     * Returns the number of connections in setup or refresh.
+     */
+    size_t refreshingConnections(const stdx::unique_lock<stdx::mutex>& lk);
+
+    /**
+     * Returns the counts of fulfilled requests by the time they waited for a connection.
+     */
+    const std::array<size_t, ConnectionStatsPerHost::kNumQueueWaitBuckets>& queueWaitCounts(
+        const stdx::unique_lock<stdx::mutex>& lk);
+
 private:
     using OwnedConnection = std::unique_ptr<ConnectionInterface>;
     using OwnershipPool = std::unordered_map<ConnectionInterface*, OwnedConnection>;
-    using Request = std::pair<Date_t, GetConnectionCallback>;
+    struct Request {
+        Date_t expiration;
+        Date_t enqueued;
+        GetConnectionCallback cb;
+    };
     struct RequestComparator {
         bool operator()(const Request& a, const Request& b) {
-            return a.first > b.first;
+            return a.expiration > b.expiration;
         }
     };
 
@@ -115,6 +130,12 @@ private:
 
     void spawnConnections(stdx::unique_lock<stdx::mutex>& lk, const HostAndPort& hostAndPort);
 
+    /**
+     * Spawns connections for requests which are still waiting once a connection leaves setup or
+     * refresh, since maxConnecting may have held them back.
+     */
+    void spawnConnectionsForWaitingRequests(stdx::unique_lock<stdx::mutex>& lk);
+
     void shutdown();
 
     OwnedConnection takeFromPool(OwnershipPool& pool, ConnectionInterface* connection);
@@ -141,6 +162,8 @@ private:
 
     size_t _created;
 
+    std::array<size_t, ConnectionStatsPerHost::kNumQueueWaitBuckets> _queueWaitCounts{};
+
     /**
      * The current state of the pool
      *
@@ -223,6 +246,8 @@ void ConnectionPool::appendConnectionStats(ConnectionPoolStats* stats) const {
         ConnectionStatsPerHost hostStats{pool->inUseConnections(lk),
                                          pool->availableConnections(lk),
                                          pool->createdConnections(lk)};
+        hostStats.refreshing = pool->refreshingConnections(lk);
+        hostStats.queueWaitCounts = pool->queueWaitCounts(lk);
         stats->updateStatsForHost(host, hostStats);
     }
 }
@@ -263,6 +288,16 @@ size_t ConnectionPool::SpecificPool::createdConnections(const stdx::unique_lock<
     return _created;
 }
 
+size_t ConnectionPool::SpecificPool::refreshingConnections(
+    const stdx::unique_lock<stdx::mutex>& lk) {
+    return _processingPool.size();
+}
+
+const std::array<size_t, ConnectionStatsPerHost::kNumQueueWaitBuckets>&
+ConnectionPool::SpecificPool::queueWaitCounts(const stdx::unique_lock<stdx::mutex>& lk) {
+    return _queueWaitCounts;
+}
+
 void ConnectionPool::SpecificPool::getConnection(const HostAndPort& hostAndPort,
                                                  Milliseconds timeout,
                                                  stdx::unique_lock<stdx::mutex> lk,
@@ -270,11 +305,12 @@ void ConnectionPool::SpecificPool::getConnection(const HostAndPort& hostAndPort,
     // We need some logic here to handle kNoTimeout, which is defined as -1 Milliseconds. If we just
     // added the timeout, we would get a time 1MS in the past, which would immediately timeout - the
     // exact opposite of what we want.
+    const auto now = _parent->_factory->now();
     auto expiration = (timeout == RemoteCommandRequest::kNoTimeout)
         ? RemoteCommandRequest::kNoExpirationDate
-        : _parent->_factory->now() + timeout;
+        : now + timeout;
 
-    _requests.push(make_pair(expiration, std::move(cb)));
+    _requests.push(Request{expiration, now, std::move(cb)});
 
     updateStateInLock();
 
@@ -338,6 +374,7 @@ void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr
                              // pool
                              if (status.isOK()) {
                                  addToReady(lk, std::move(conn));
+                                 spawnConnectionsForWaitingRequests(lk);
                                  return;
                              }
 
@@ -422,7 +459,7 @@ void ConnectionPool::SpecificPool::processFailure(const Status& status,
     lk.unlock();
 
     while (requestsToFail.size()) {
-        requestsToFail.top().second(status);
+        requestsToFail.top().cb(status);
         requestsToFail.pop();
     }
 }
@@ -464,7 +501,9 @@ void ConnectionPool::SpecificPool::fulfillRequests(stdx::unique_lock<stdx::mutex
         }
 
         // Grab the request and callback
-        auto cb = std::move(_requests.top().second);
+        auto cb = std::move(_requests.top().cb);
+        const auto waited = _parent->_factory->now() - _requests.top().enqueued;
+        ++_queueWaitCounts[ConnectionStatsPerHost::queueWaitBucket(waited)];
         _requests.pop();
 
         auto connPtr = conn.get();
@@ -493,8 +532,10 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
             std::min(_requests.size() + _checkedOutPool.size(), _parent->_options.maxConnections));
     };
 
-    // While all of our inflight connections are less than our target
-    while (_readyPool.size() + _processingPool.size() + _checkedOutPool.size() < target()) {
+    // While all of our inflight connections are less than our target, and not too many of them are
+    // still being set up
+    while (_readyPool.size() + _processingPool.size() + _checkedOutPool.size() < target() &&
+           _processingPool.size() < _parent->_options.maxConnecting) {
         // make a new connection and put it in processing
         auto handle = _parent->_factory->makeConnection(hostAndPort, _generation);
         auto connPtr = handle.get();
@@ -520,7 +561,10 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
                            } else {
                                // If the setup failed, cascade the failure edge
                                processFailure(status, std::move(lk));
+                               return;
                            }
+
+                           spawnConnectionsForWaitingRequests(lk);
                        });
         // Note that this assumes that the refreshTimeout is sound for the
         // setupTimeout
@@ -529,6 +573,14 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
     }
 }
 
+void ConnectionPool::SpecificPool::spawnConnectionsForWaitingRequests(
+    stdx::unique_lock<stdx::mutex>& lk) {
+    if (_requests.empty())
+        return;
+
+    spawnConnections(lk, _hostAndPort);
+}
+
 // Called every second after hostTimeout until all processing connections reap
 void ConnectionPool::SpecificPool::shutdown() {
     stdx::unique_lock<stdx::mutex> lk(_parent->_mutex);
@@ -594,16 +646,16 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
 
         // If we were already running and the timer is the same as it was
         // before, nothing to do
-        if (_state == State::kRunning && _requestTimerExpiration == _requests.top().first)
+        if (_state == State::kRunning && _requestTimerExpiration == _requests.top().expiration)
             return;
 
         _state = State::kRunning;
 
         _requestTimer->cancelTimeout();
 
-        _requestTimerExpiration = _requests.top().first;
+        _requestTimerExpiration = _requests.top().expiration;
 
-        auto timeout = _requests.top().first - _parent->_factory->now();
+        auto timeout = _requests.top().expiration - _parent->_factory->now();
 
         // We set a timer for the most recent request, then invoke each timed
         // out request we couldn't service
@@ -615,8 +667,8 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
             while (_requests.size()) {
                 auto& x = _requests.top();
 
-                if (x.first <= now) {
-                    auto cb = std::move(x.second);
+                if (x.expiration <= now) {
+                    auto cb = std::move(x.cb);
                     _requests.pop();
 
                     lk.unlock();
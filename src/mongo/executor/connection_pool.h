@@ -90,6 +90,13 @@ public:
          */
         size_t maxConnections = std::numeric_limits<size_t>::max();
 
+        /**
+         * The maximum number of connections to a host which may be in setup or refresh at once.
+         * When a host slows down, this keeps a burst of requests from opening a connection per
+         * request; the requests wait for connections to come back instead.
+         */
+        size_t maxConnecting = std::numeric_limits<size_t>::max();
+
         /**
          * Amount of time to wait before timing out a refresh attempt
          */
@@ -36,6 +36,13 @@
 namespace mongo {
 namespace executor {
 
+namespace {
+const char* const kQueueWaitBucketNames[] = {"lt1", "lt10", "lt100", "lt1000", "ge1000"};
+static_assert(sizeof(kQueueWaitBucketNames) / sizeof(kQueueWaitBucketNames[0]) ==
+                  ConnectionStatsPerHost::kNumQueueWaitBuckets,
+              "a name is needed for each queue wait bucket");
+}  // namespace
+
 ConnectionStatsPerHost::ConnectionStatsPerHost(size_t nInUse, size_t nAvailable, size_t nCreated)
     : inUse(nInUse), available(nAvailable), created(nCreated) {}
 
@@ -45,10 +52,24 @@ ConnectionStatsPerHost& ConnectionStatsPerHost::operator+=(const ConnectionStats
     inUse += other.inUse;
     available += other.available;
     created += other.created;
+    refreshing += other.refreshing;
+    for (size_t i = 0; i < kNumQueueWaitBuckets; ++i) {
+        queueWaitCounts[i] += other.queueWaitCounts[i];
+    }
 
     return *this;
 }
 
+size_t ConnectionStatsPerHost::queueWaitBucket(Milliseconds wait) {
+    long long bound = 1;
+    for (size_t i = 0; i < kNumQueueWaitBuckets - 1; ++i, bound *= 10) {
+        if (durationCount<Milliseconds>(wait) < bound) {
+            return i;
+        }
+    }
+    return kNumQueueWaitBuckets - 1;
+}
+
 void ConnectionPoolStats::updateStatsForHost(HostAndPort host, ConnectionStatsPerHost newStats) {
     // Update stats for this host.
     auto hostStats = mapFindWithDefault(statsByHost, host);
@@ -74,6 +95,12 @@ void ConnectionPoolStats::appendToBSON(mongo::BSONObjBuilder& result) {
         hostInfo.appendNumber("inUse", hostStats.inUse);
         hostInfo.appendNumber("available", hostStats.available);
         hostInfo.appendNumber("created", hostStats.created);
+        hostInfo.appendNumber("refreshing", hostStats.refreshing);
+
+        BSONObjBuilder waitBuilder(hostInfo.subobjStart("queueWaitMillis"));
+        for (size_t i = 0; i < ConnectionStatsPerHost::kNumQueueWaitBuckets; ++i) {
+            waitBuilder.appendNumber(kQueueWaitBucketNames[i], hostStats.queueWaitCounts[i]);
+        }
     }
 }
 
@@ -28,8 +28,11 @@
 
 #pragma once
 
+#include <array>
 #include <unordered_map>
 
+#include "mongo/util/time_support.h"
+
 #include "mongo/util/net/hostandport.h"
 
 namespace mongo {
@@ -46,9 +49,23 @@ struct ConnectionStatsPerHost {
 
     ConnectionStatsPerHost& operator+=(const ConnectionStatsPerHost& other);
 
+    /**
+     * The number of buckets in queueWaitCounts. Bucket i counts the requests which waited less
+     * than 10^i milliseconds for a connection, and not less than the bound of bucket i - 1. The
+     * last bucket counts the remainder.
+     */
+    static const size_t kNumQueueWaitBuckets = 5;
+
+    /**
+     * Returns the queueWaitCounts bucket for a request which waited 'wait' for a connection.
+     */
+    static size_t queueWaitBucket(Milliseconds wait);
+
     size_t inUse = 0u;
     size_t available = 0u;
     size_t created = 0u;
+    size_t refreshing = 0u;
+    std::array<size_t, kNumQueueWaitBuckets> queueWaitCounts{};
 };
 
 /**
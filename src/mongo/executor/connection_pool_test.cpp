@@ -30,6 +30,7 @@
 #include "mongo/executor/connection_pool_test_fixture.h"
 
 #include "mongo/executor/connection_pool.h"
+#include "mongo/executor/connection_pool_stats.h"
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
@@ -436,6 +437,82 @@ TEST_F(ConnectionPoolTest, maxPoolRespected) {
     doneWith(conn3);
 }
 
+/**
+ * Verify that maxConnecting limits the connections in setup, and that requests held back by it are
+ * served once a setup completes.
+ */
+TEST_F(ConnectionPoolTest, maxConnectingRespected) {
+    ConnectionPool::Options options;
+    options.minConnections = 1;
+    options.maxConnections = 3;
+    options.maxConnecting = 1;
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), options);
+
+    ConnectionPool::ConnectionHandle conn1;
+    ConnectionPool::ConnectionHandle conn2;
+    ConnectionPool::ConnectionHandle conn3;
+
+    pool.get(HostAndPort(),
+             Milliseconds(3000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+
+                 conn3 = std::move(swConn.getValue());
+             });
+    pool.get(HostAndPort(),
+             Milliseconds(2000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+
+                 conn2 = std::move(swConn.getValue());
+             });
+    pool.get(HostAndPort(),
+             Milliseconds(1000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+
+                 conn1 = std::move(swConn.getValue());
+             });
+
+    // Only one connection is being set up
+    {
+        ConnectionPoolStats stats;
+        pool.appendConnectionStats(&stats);
+        ASSERT_EQ(1u, stats.totalCreated);
+        ASSERT_EQ(1u, stats.statsByHost[HostAndPort()].refreshing);
+    }
+
+    // Each completed setup serves the most urgent request and starts the next setup
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT(conn1);
+    ASSERT(!conn2);
+
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT(conn2);
+    ASSERT(!conn3);
+
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT(conn3);
+
+    {
+        ConnectionPoolStats stats;
+        pool.appendConnectionStats(&stats);
+        ASSERT_EQ(3u, stats.totalCreated);
+
+        const auto& hostStats = stats.statsByHost[HostAndPort()];
+        ASSERT_EQ(0u, hostStats.refreshing);
+        size_t served = 0;
+        for (auto count : hostStats.queueWaitCounts) {
+            served += count;
+        }
+        ASSERT_EQ(3u, served);
+    }
+
+    doneWith(conn1);
+    doneWith(conn2);
+    doneWith(conn3);
+}
+
 /**
  * Verify that minConnections is respected
  */
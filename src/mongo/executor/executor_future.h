@@ -0,0 +1,361 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
+#include "mongo/executor/remote_command_request.h"
+#include "mongo/executor/remote_command_response.h"
+#include "mongo/executor/task_executor.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+namespace executor {
+
+template <typename T>
+class ExecutorFuture;
+
+namespace future_details {
+
+/**
+ * The state shared by an ExecutorPromise and its ExecutorFuture. Holds the result until either a
+ * continuation is attached or get() is called, and otherwise hands it to the continuation on the
+ * thread which completes the state. Its mutex is only taken once to complete it and once to
+ * consume it.
+ */
+template <typename T>
+class SharedState {
+    MONGO_DISALLOW_COPYING(SharedState);
+
+public:
+    using Continuation = stdx::function<void(StatusWith<T>)>;
+
+    SharedState() = default;
+
+    void complete(StatusWith<T> result) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        invariant(!_completed);
+        _completed = true;
+        if (!_continuation) {
+            _result.emplace(std::move(result));
+            _resultReady.notify_all();
+            return;
+        }
+
+        auto continuation = std::move(_continuation);
+        lk.unlock();
+        continuation(std::move(result));
+    }
+
+    void setContinuation(Continuation continuation) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        invariant(!_continuation);
+        if (!_result) {
+            _continuation = std::move(continuation);
+            return;
+        }
+
+        auto result = std::move(*_result);
+        _result = boost::none;
+        lk.unlock();
+        continuation(std::move(result));
+    }
+
+    StatusWith<T> get() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _resultReady.wait(lk, [this] { return static_cast<bool>(_result); });
+        auto result = std::move(*_result);
+        _result = boost::none;
+        return result;
+    }
+
+private:
+    stdx::mutex _mutex;
+    stdx::condition_variable _resultReady;
+    bool _completed = false;
+    boost::optional<StatusWith<T>> _result;
+    Continuation _continuation;
+};
+
+/**
+ * Describes the value returned by a continuation, which is either a StatusWith<U>, for a step
+ * completed inline, or an ExecutorFuture<U>, for a step which itself runs asynchronously.
+ */
+template <typename R>
+struct ContinuationTraits;
+
+template <typename U>
+struct ContinuationTraits<StatusWith<U>> {
+    using ValueType = U;
+
+    static void forward(StatusWith<U> result, const std::shared_ptr<SharedState<U>>& state) {
+        state->complete(std::move(result));
+    }
+};
+
+template <typename U>
+struct ContinuationTraits<ExecutorFuture<U>> {
+    using ValueType = U;
+
+    static void forward(ExecutorFuture<U> future, const std::shared_ptr<SharedState<U>>& state) {
+        future.getAsync([state](StatusWith<U> result) { state->complete(std::move(result)); });
+    }
+};
+
+}  // namespace future_details
+
+/**
+ * The eventual result of an asynchronous operation, typically a remote command run by a
+ * TaskExecutor, to which the next steps of a workflow are attached as continuations.
+ *
+ * A continuation runs inline on the thread which completes the previous step, usually one of the
+ * executor's threads, or on the caller's thread if that step has already completed, so that
+ * chaining steps does not go back through the executor's queue. Continuations must therefore not
+ * block. A future is consumed by exactly one of get(), getAsync(), then() or onError().
+ */
+template <typename T>
+class ExecutorFuture {
+public:
+    /**
+     * Constructs an invalid future. Use ExecutorPromise::getFuture() to get a valid one.
+     */
+    ExecutorFuture() = default;
+
+    /**
+     * Constructs a future completed through 'state'. Used by ExecutorPromise.
+     */
+    explicit ExecutorFuture(std::shared_ptr<future_details::SharedState<T>> state)
+        : _state(std::move(state)) {}
+
+    bool valid() const {
+        return static_cast<bool>(_state);
+    }
+
+    /**
+     * Blocks until the result is available and returns it. Must not be called from a continuation
+     * or from a task executor callback.
+     */
+    StatusWith<T> get() {
+        return _consumeState()->get();
+    }
+
+    /**
+     * Calls 'callback' with the result, whether successful or not, once it is available.
+     */
+    void getAsync(stdx::function<void(StatusWith<T>)> callback) {
+        _consumeState()->setContinuation(std::move(callback));
+    }
+
+    /**
+     * Returns a future for the result of calling 'fn' with the value of this future. 'fn' returns
+     * either a StatusWith<U> or an ExecutorFuture<U> for the next asynchronous step. If this
+     * future fails, 'fn' is not called and the returned future fails with the same error. An
+     * exception thrown by 'fn' fails the returned future with the exception's status.
+     */
+    template <typename Fn>
+    ExecutorFuture<typename future_details::ContinuationTraits<
+        typename std::result_of<Fn(T)>::type>::ValueType>
+    then(Fn fn) {
+        using Result = typename std::result_of<Fn(T)>::type;
+        using Traits = future_details::ContinuationTraits<Result>;
+        using U = typename Traits::ValueType;
+
+        auto next = std::make_shared<future_details::SharedState<U>>();
+        _consumeState()->setContinuation([next, fn](StatusWith<T> result) {
+            if (!result.isOK()) {
+                next->complete(result.getStatus());
+                return;
+            }
+
+            boost::optional<Result> fnResult;
+            try {
+                fnResult.emplace(fn(std::move(result.getValue())));
+            } catch (const DBException& ex) {
+                next->complete(ex.toStatus());
+                return;
+            }
+            Traits::forward(std::move(*fnResult), next);
+        });
+        return ExecutorFuture<U>(std::move(next));
+    }
+
+    /**
+     * Returns a future for the value of this future or, if it fails, for the result of calling 'fn'
+     * with its error. 'fn' returns either a StatusWith<T> or an ExecutorFuture<T>, and may return
+     * the error itself to let it through.
+     */
+    template <typename Fn>
+    ExecutorFuture<T> onError(Fn fn) {
+        using Result = typename std::result_of<Fn(Status)>::type;
+        using Traits = future_details::ContinuationTraits<Result>;
+        static_assert(std::is_same<typename Traits::ValueType, T>::value,
+                      "onError() must recover a value of the type of the future");
+
+        auto next = std::make_shared<future_details::SharedState<T>>();
+        _consumeState()->setContinuation([next, fn](StatusWith<T> result) {
+            if (result.isOK()) {
+                next->complete(std::move(result));
+                return;
+            }
+
+            boost::optional<Result> fnResult;
+            try {
+                fnResult.emplace(fn(result.getStatus()));
+            } catch (const DBException& ex) {
+                next->complete(ex.toStatus());
+                return;
+            }
+            Traits::forward(std::move(*fnResult), next);
+        });
+        return ExecutorFuture<T>(std::move(next));
+    }
+
+private:
+    std::shared_ptr<future_details::SharedState<T>> _consumeState() {
+        invariant(_state);
+        return std::move(_state);
+    }
+
+    std::shared_ptr<future_details::SharedState<T>> _state;
+};
+
+/**
+ * The producing side of an ExecutorFuture. Copies of a promise complete the same future, so that
+ * a promise can be captured by the callbacks passed to a TaskExecutor. Exactly one of them must
+ * call setResult().
+ */
+template <typename T>
+class ExecutorPromise {
+public:
+    ExecutorPromise() : _state(std::make_shared<future_details::SharedState<T>>()) {}
+
+    /**
+     * Returns the future completed by this promise. May be called once.
+     */
+    ExecutorFuture<T> getFuture() const {
+        return ExecutorFuture<T>(_state);
+    }
+
+    /**
+     * Completes the future, running its continuation, if any, on this thread.
+     */
+    void setResult(StatusWith<T> result) const {
+        _state->complete(std::move(result));
+    }
+
+private:
+    std::shared_ptr<future_details::SharedState<T>> _state;
+};
+
+/**
+ * Returns a future which is already completed with 'result'.
+ */
+template <typename T>
+ExecutorFuture<T> makeReadyFuture(StatusWith<T> result) {
+    ExecutorPromise<T> promise;
+    promise.setResult(std::move(result));
+    return promise.getFuture();
+}
+
+/**
+ * Returns a future for the values of all of 'futures', in the same order, which fails with the
+ * error of the first of them to fail.
+ */
+template <typename T>
+ExecutorFuture<std::vector<T>> whenAll(std::vector<ExecutorFuture<T>> futures) {
+    struct State {
+        stdx::mutex mutex;
+        std::vector<boost::optional<T>> values;
+        size_t remaining;
+        bool failed = false;
+    };
+
+    ExecutorPromise<std::vector<T>> promise;
+    auto allFuture = promise.getFuture();
+    if (futures.empty()) {
+        promise.setResult(std::vector<T>());
+        return allFuture;
+    }
+
+    auto state = std::make_shared<State>();
+    state->values.resize(futures.size());
+    state->remaining = futures.size();
+    for (size_t i = 0; i < futures.size(); ++i) {
+        futures[i].getAsync([state, promise, i](StatusWith<T> result) {
+            stdx::unique_lock<stdx::mutex> lk(state->mutex);
+            if (state->failed) {
+                return;
+            }
+
+            if (!result.isOK()) {
+                state->failed = true;
+                lk.unlock();
+                promise.setResult(result.getStatus());
+                return;
+            }
+
+            state->values[i] = std::move(result.getValue());
+            if (--state->remaining > 0) {
+                return;
+            }
+
+            std::vector<T> values;
+            values.reserve(state->values.size());
+            for (auto& value : state->values) {
+                values.push_back(std::move(*value));
+            }
+            lk.unlock();
+            promise.setResult(std::move(values));
+        });
+    }
+    return allFuture;
+}
+
+/**
+ * Schedules 'request' on 'executor' and returns a future for its response, completed on the thread
+ * which runs the executor's callback. The future fails if the command could not be scheduled, was
+ * canceled or could not reach its target, but holds the response of a command which ran and
+ * failed, since only the caller knows how to interpret it. If 'cbHandle' is not null, it is set to
+ * the handle with which the command can be canceled.
+ */
+ExecutorFuture<RemoteCommandResponse> scheduleRemoteCommandAsync(
+    TaskExecutor* executor,
+    const RemoteCommandRequest& request,
+    TaskExecutor::CallbackHandle* cbHandle = nullptr);
+
+}  // namespace executor
+}  // namespace mongo
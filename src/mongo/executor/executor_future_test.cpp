@@ -0,0 +1,227 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/executor/executor_future.h"
+#include "mongo/executor/network_interface_mock.h"
+#include "mongo/executor/thread_pool_task_executor_test_fixture.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace executor {
+namespace {
+
+TEST(ExecutorFutureTest, ThenChainsValuesOnceThePromiseIsSet) {
+    ExecutorPromise<int> promise;
+    auto future = promise.getFuture()
+                      .then([](int x) { return StatusWith<int>(x + 1); })
+                      .then([](int x) { return StatusWith<std::string>(std::to_string(x * 2)); });
+
+    promise.setResult(1);
+    auto result = future.get();
+    ASSERT_OK(result.getStatus());
+    ASSERT_EQUALS("4", result.getValue());
+}
+
+TEST(ExecutorFutureTest, ContinuationOfReadyFutureRunsInline) {
+    bool ran = false;
+    makeReadyFuture(StatusWith<int>(5)).getAsync([&ran](StatusWith<int> result) {
+        ASSERT_OK(result.getStatus());
+        ASSERT_EQUALS(5, result.getValue());
+        ran = true;
+    });
+    ASSERT_TRUE(ran);
+}
+
+TEST(ExecutorFutureTest, ErrorSkipsThen) {
+    bool ran = false;
+    auto result = makeReadyFuture(StatusWith<int>(Status(ErrorCodes::BadValue, "bad")))
+                      .then([&ran](int x) {
+                          ran = true;
+                          return StatusWith<int>(x);
+                      })
+                      .get();
+    ASSERT_FALSE(ran);
+    ASSERT_EQUALS(ErrorCodes::BadValue, result.getStatus());
+}
+
+TEST(ExecutorFutureTest, OnErrorRecoversFromErrorAndPassesValuesThrough) {
+    auto recover = [](Status status) {
+        ASSERT_EQUALS(ErrorCodes::HostUnreachable, status);
+        return StatusWith<int>(0);
+    };
+
+    auto recovered =
+        makeReadyFuture(StatusWith<int>(Status(ErrorCodes::HostUnreachable, "unreachable")))
+            .onError(recover)
+            .get();
+    ASSERT_OK(recovered.getStatus());
+    ASSERT_EQUALS(0, recovered.getValue());
+
+    auto passed = makeReadyFuture(StatusWith<int>(3)).onError(recover).get();
+    ASSERT_OK(passed.getStatus());
+    ASSERT_EQUALS(3, passed.getValue());
+}
+
+TEST(ExecutorFutureTest, ThenWaitsForReturnedFuture) {
+    ExecutorPromise<int> inner;
+    auto future =
+        makeReadyFuture(StatusWith<int>(1)).then([inner](int) { return inner.getFuture(); });
+
+    bool ran = false;
+    future.getAsync([&ran](StatusWith<int> result) {
+        ASSERT_OK(result.getStatus());
+        ASSERT_EQUALS(7, result.getValue());
+        ran = true;
+    });
+    ASSERT_FALSE(ran);
+
+    inner.setResult(7);
+    ASSERT_TRUE(ran);
+}
+
+TEST(ExecutorFutureTest, ExceptionInContinuationFailsFuture) {
+    auto result = makeReadyFuture(StatusWith<int>(1))
+                      .then([](int x) -> StatusWith<int> {
+                          uasserted(ErrorCodes::InternalError, "continuation failed");
+                      })
+                      .get();
+    ASSERT_EQUALS(ErrorCodes::InternalError, result.getStatus());
+}
+
+TEST(ExecutorFutureTest, WhenAllCollectsValuesInOrder) {
+    ExecutorPromise<int> first;
+    ExecutorPromise<int> second;
+    std::vector<ExecutorFuture<int>> futures;
+    futures.push_back(first.getFuture());
+    futures.push_back(second.getFuture());
+    auto all = whenAll(std::move(futures));
+
+    second.setResult(2);
+    first.setResult(1);
+    auto result = all.get();
+    ASSERT_OK(result.getStatus());
+    ASSERT_EQUALS(2U, result.getValue().size());
+    ASSERT_EQUALS(1, result.getValue()[0]);
+    ASSERT_EQUALS(2, result.getValue()[1]);
+}
+
+TEST(ExecutorFutureTest, WhenAllFailsWithFirstError) {
+    ExecutorPromise<int> first;
+    ExecutorPromise<int> second;
+    std::vector<ExecutorFuture<int>> futures;
+    futures.push_back(first.getFuture());
+    futures.push_back(second.getFuture());
+    auto all = whenAll(std::move(futures));
+
+    second.setResult(Status(ErrorCodes::ShardNotFound, "no shard"));
+    first.setResult(Status(ErrorCodes::BadValue, "bad"));
+    ASSERT_EQUALS(ErrorCodes::ShardNotFound, all.get().getStatus());
+}
+
+TEST(ExecutorFutureTest, WhenAllOfNoFuturesIsReady) {
+    auto result = whenAll(std::vector<ExecutorFuture<int>>()).get();
+    ASSERT_OK(result.getStatus());
+    ASSERT_TRUE(result.getValue().empty());
+}
+
+TEST_F(ThreadPoolExecutorTest, ChainsRemoteCommands) {
+    auto net = getNet();
+    auto& executor = getExecutor();
+    launchExecutorThread();
+
+    const HostAndPort host("localhost", 27017);
+    auto future =
+        scheduleRemoteCommandAsync(&executor,
+                                   RemoteCommandRequest(host, "admin", BSON("first" << 1)))
+            .then([&executor, host](RemoteCommandResponse response) {
+                return scheduleRemoteCommandAsync(
+                    &executor,
+                    RemoteCommandRequest(
+                        host, "admin", BSON("second" << response.data["value"].numberInt())));
+            })
+            .then([](RemoteCommandResponse response) {
+                return StatusWith<int>(response.data["value"].numberInt());
+            });
+
+    net->enterNetwork();
+    for (int value = 1; value <= 2; ++value) {
+        ASSERT_TRUE(net->hasReadyRequests());
+        auto noi = net->getNextReadyRequest();
+        const auto& cmdObj = noi->getRequest().cmdObj;
+        if (value == 1) {
+            ASSERT_EQUALS("first", cmdObj.firstElementFieldName());
+        } else {
+            ASSERT_EQUALS(BSON("second" << 1), cmdObj);
+        }
+        net->scheduleResponse(noi,
+                              net->now(),
+                              TaskExecutor::ResponseStatus(RemoteCommandResponse(
+                                  BSON("ok" << 1 << "value" << value), BSONObj(), Milliseconds(0))));
+        net->runReadyNetworkOperations();
+    }
+    net->exitNetwork();
+
+    auto result = future.get();
+    ASSERT_OK(result.getStatus());
+    ASSERT_EQUALS(2, result.getValue());
+
+    executor.shutdown();
+    joinExecutorThread();
+}
+
+TEST_F(ThreadPoolExecutorTest, CanceledRemoteCommandFailsFuture) {
+    auto net = getNet();
+    auto& executor = getExecutor();
+    launchExecutorThread();
+
+    TaskExecutor::CallbackHandle cbHandle;
+    auto future = scheduleRemoteCommandAsync(
+        &executor,
+        RemoteCommandRequest(HostAndPort("localhost", 27017), "admin", BSON("ping" << 1)),
+        &cbHandle);
+    ASSERT_TRUE(cbHandle.isValid());
+    executor.cancel(cbHandle);
+
+    net->enterNetwork();
+    net->runReadyNetworkOperations();
+    net->exitNetwork();
+    ASSERT_EQUALS(ErrorCodes::CallbackCanceled, future.get().getStatus());
+
+    executor.shutdown();
+    joinExecutorThread();
+}
+
+}  // namespace
+}  // namespace executor
+}  // namespace mongo
@@ -34,6 +34,7 @@
 
 #include <asio/system_timer.hpp>
 
+#include <algorithm>
 #include <utility>
 
 #include "mongo/executor/async_stream_factory.h"
@@ -57,14 +58,22 @@ namespace mongo {
 namespace executor {
 
 namespace {
-const std::size_t kIOServiceWorkers = 1;
+
+std::vector<std::unique_ptr<asio::io_service>> makeIOServices(std::size_t numIOServices) {
+    std::vector<std::unique_ptr<asio::io_service>> ioServices;
+    for (std::size_t i = 0; i < std::max<std::size_t>(numIOServices, 1); ++i) {
+        ioServices.push_back(stdx::make_unique<asio::io_service>());
+    }
+    return ioServices;
+}
+
 }  // namespace
 
 NetworkInterfaceASIO::Options::Options() = default;
 
 NetworkInterfaceASIO::NetworkInterfaceASIO(Options options)
     : _options(std::move(options)),
-      _io_service(),
+      _ioServices(makeIOServices(_options.numIOServices)),
       _metadataHook(std::move(_options.metadataHook)),
       _hook(std::move(_options.networkConnectionHook)),
       _state(State::kReady),
@@ -73,7 +82,7 @@ NetworkInterfaceASIO::NetworkInterfaceASIO(Options options)
       _connectionPool(stdx::make_unique<connection_pool_asio::ASIOImpl>(this),
                       _options.connectionPoolOptions),
       _isExecutorRunnable(false),
-      _strand(_io_service) {}
+      _strand(*_ioServices.front()) {}
 
 std::string NetworkInterfaceASIO::getDiagnosticString() {
     stdx::lock_guard<stdx::mutex> lk(_inProgressMutex);
@@ -145,14 +154,14 @@ std::string NetworkInterfaceASIO::getHostName() {
 }
 
 void NetworkInterfaceASIO::startup() {
-    _serviceRunners.resize(kIOServiceWorkers);
-    for (std::size_t i = 0; i < kIOServiceWorkers; ++i) {
+    _serviceRunners.resize(_ioServices.size());
+    for (std::size_t i = 0; i < _ioServices.size(); ++i) {
         _serviceRunners[i] = stdx::thread([this, i]() {
             setThreadName(_options.instanceName + "-" + std::to_string(i));
             try {
                 LOG(2) << "The NetworkInterfaceASIO worker thread is spinning up";
-                asio::io_service::work work(_io_service);
-                _io_service.run();
+                asio::io_service::work work(*_ioServices[i]);
+                _ioServices[i]->run();
             } catch (...) {
                 severe() << "Uncaught exception in NetworkInterfaceASIO IO "
                             "worker thread of type: "
@@ -166,7 +175,9 @@ void NetworkInterfaceASIO::startup() {
 
 void NetworkInterfaceASIO::shutdown() {
     _state.store(State::kShutdown);
-    _io_service.stop();
+    for (auto&& ioService : _ioServices) {
+        ioService->stop();
+    }
     for (auto&& worker : _serviceRunners) {
         worker.join();
     }
@@ -402,7 +413,8 @@ Status NetworkInterfaceASIO::setAlarm(Date_t when, const stdx::function<void()>&
     }
 
     // "alarm" must stay alive until it expires, hence the shared_ptr.
-    auto alarm = std::make_shared<asio::system_timer>(_io_service, when.toSystemTimePoint());
+    auto alarm =
+        std::make_shared<asio::system_timer>(*_ioServices.front(), when.toSystemTimePoint());
     alarm->async_wait([alarm, this, action](std::error_code ec) {
         if (!ec) {
             return action();
@@ -416,6 +428,13 @@ Status NetworkInterfaceASIO::setAlarm(Date_t when, const stdx::function<void()>&
     return Status::OK();
 };
 
+asio::io_service& NetworkInterfaceASIO::_ioServiceFor(const HostAndPort& target) {
+    if (_ioServices.size() == 1) {
+        return *_ioServices.front();
+    }
+    return *_ioServices[std::hash<HostAndPort>()(target) % _ioServices.size()];
+}
+
 bool NetworkInterfaceASIO::inShutdown() const {
     return (_state.load() == State::kShutdown);
 }
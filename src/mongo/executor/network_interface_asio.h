@@ -56,6 +56,7 @@
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/transport/message_compressor_manager.h"
 #include "mongo/util/net/message.h"
 
 namespace mongo {
@@ -106,6 +107,11 @@ public:
         std::unique_ptr<NetworkConnectionHook> networkConnectionHook;
         std::unique_ptr<AsyncStreamFactoryInterface> streamFactory;
         std::unique_ptr<rpc::EgressMetadataHook> metadataHook;
+
+        // The number of io_services, each run by its own thread. Every connection, and every
+        // operation run over it, is bound to the io_service chosen by the hash of its target host,
+        // so operations against different hosts do not share a reactor.
+        std::size_t numIOServices = 1;
     };
 
     NetworkInterfaceASIO(Options = Options());
@@ -160,6 +166,8 @@ private:
         rpc::ProtocolSet clientProtocols() const;
         void setServerProtocols(rpc::ProtocolSet protocols);
 
+        MessageCompressorManager& compressorManager();
+
     private:
         std::unique_ptr<AsyncStreamInterface> _stream;
 
@@ -168,6 +176,8 @@ private:
         // Dynamically initialized from [min max]WireVersionOutgoing.
         // Its expected that isMaster response is checked only on the caller.
         rpc::ProtocolSet _clientProtocols{rpc::supports::kNone};
+
+        MessageCompressorManager _compressorManager;
     };
 
     /**
@@ -207,6 +217,12 @@ private:
         Message& toRecv();
         MSGHEADER::Value& header();
 
+        /**
+         * The message actually written to the network for toSend(), which differs from it if the
+         * connection negotiated compression.
+         */
+        Message& toSendOnWire();
+
         ResponseStatus response(rpc::Protocol protocol,
                                 Date_t now,
                                 rpc::EgressMetadataHook* metadataHook = nullptr);
@@ -217,6 +233,7 @@ private:
         const CommandType _type;
 
         Message _toSend;
+        Message _toSendOnWire;
         Message _toRecv;
 
         // TODO: Investigate efficiency of storing header separately.
@@ -420,6 +437,11 @@ private:
 
     void _startCommand(AsyncOp* op);
 
+    /**
+     * Returns the io_service which runs the connections and operations for 'target'.
+     */
+    asio::io_service& _ioServiceFor(const HostAndPort& target);
+
     /**
      * Wraps a completion handler in pre-condition checks.
      * When we resume after an asynchronous call, we may find the following:
@@ -473,7 +495,9 @@ private:
 
     Options _options;
 
-    asio::io_service _io_service;
+    // Never empty. The first io_service also runs the non-op operations, such as alarms and the
+    // connection pool's timers.
+    std::vector<std::unique_ptr<asio::io_service>> _ioServices;
     std::vector<stdx::thread> _serviceRunners;
 
     const std::unique_ptr<rpc::EgressMetadataHook> _metadataHook;
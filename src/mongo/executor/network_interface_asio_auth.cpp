@@ -72,6 +72,8 @@ void NetworkInterfaceASIO::_runIsMaster(AsyncOp* op) {
         bob.append("hostInfo", sb.str());
     }
 
+    op->connection().compressorManager().clientBegin(&bob);
+
     requestBuilder.setCommandArgs(bob.done());
     requestBuilder.setMetadata(rpc::makeEmptyMetadata());
 
@@ -104,6 +106,8 @@ void NetworkInterfaceASIO::_runIsMaster(AsyncOp* op) {
 
         op->connection().setServerProtocols(protocolSet.getValue());
 
+        op->connection().compressorManager().clientFinish(commandReply.data);
+
         invariant(op->connection().clientProtocols() != rpc::supports::kNone);
         // Set the operation protocol
         auto negotiatedProtocol =
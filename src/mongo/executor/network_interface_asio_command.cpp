@@ -40,6 +40,7 @@
 #include "mongo/executor/async_stream_interface.h"
 #include "mongo/executor/connection_pool_asio.h"
 #include "mongo/executor/downconvert_find_and_getmore_commands.h"
+#include "mongo/executor/reply_buffer_pool.h"
 #include "mongo/rpc/factory.h"
 #include "mongo/rpc/metadata/metadata_hook.h"
 #include "mongo/rpc/protocol.h"
@@ -75,8 +76,6 @@ template <typename Handler>
 void asyncSendMessage(AsyncStreamInterface& stream, Message* m, Handler&& handler) {
     static_assert(IsNetworkHandler<Handler>::value,
                   "Handler passed to asyncSendMessage does not conform to NetworkHandler concept");
-    m->header().setResponseToMsgId(0);
-    m->header().setId(nextMessageId());
     // TODO: Some day we may need to support vector messages.
     fassert(28708, m->buf() != 0);
     stream.write(asio::buffer(m->buf(), m->size()), std::forward<Handler>(handler));
@@ -115,7 +114,7 @@ void asyncRecvMessageBody(AsyncStreamInterface& stream,
 
     int z = (len + 1023) & 0xfffffc00;
     invariant(z >= len);
-    m->setData(SharedBuffer::allocate(z));
+    m->setData(ReplyBufferPool::get()->allocate(z));
     MsgData::View mdView = m->buf();
 
     // copy header data into master buffer
@@ -187,6 +186,10 @@ Message& NetworkInterfaceASIO::AsyncCommand::toSend() {
     return _toSend;
 }
 
+Message& NetworkInterfaceASIO::AsyncCommand::toSendOnWire() {
+    return _toSendOnWire;
+}
+
 Message& NetworkInterfaceASIO::AsyncCommand::toRecv() {
     return _toRecv;
 }
@@ -362,6 +365,14 @@ void NetworkInterfaceASIO::_asyncRunCommand(AsyncOp* op, NetworkOpHandler handle
 
     // Step 4
     auto recvMessageCallback = [this, cmd, handler, op](std::error_code ec, size_t bytes) {
+        if (!ec && cmd->toRecv().operation() == dbCompressed) {
+            auto swm = cmd->conn().compressorManager().decompressMessage(cmd->toRecv());
+            if (!swm.isOK()) {
+                return handler(make_error_code(swm.getStatus().code()), bytes);
+            }
+            cmd->toRecv() = std::move(swm.getValue());
+        }
+
         // We don't call _validateAndRun here as we assume the caller will.
         handler(ec, bytes);
     };
@@ -401,7 +412,16 @@ void NetworkInterfaceASIO::_asyncRunCommand(AsyncOp* op, NetworkOpHandler handle
     };
 
     // Step 1
-    asyncSendMessage(cmd->conn().stream(), &cmd->toSend(), std::move(sendMessageCallback));
+    cmd->toSend().header().setResponseToMsgId(0);
+    cmd->toSend().header().setId(nextMessageId());
+
+    auto swm = cmd->conn().compressorManager().compressMessage(cmd->toSend());
+    if (!swm.isOK()) {
+        return handler(make_error_code(swm.getStatus().code()), 0);
+    }
+    cmd->toSendOnWire() = std::move(swm.getValue());
+
+    asyncSendMessage(cmd->conn().stream(), &cmd->toSendOnWire(), std::move(sendMessageCallback));
 }
 
 void NetworkInterfaceASIO::_runConnectionHook(AsyncOp* op) {
@@ -145,6 +145,14 @@ TEST_F(NetworkInterfaceASIOIntegrationTest, Ping) {
     assertCommandOK("admin", BSON("ping" << 1));
 }
 
+TEST_F(NetworkInterfaceASIOIntegrationTest, PingWithSeveralIOServices) {
+    NetworkInterfaceASIO::Options options;
+    options.numIOServices = 4;
+    startNet(std::move(options));
+    assertCommandOK("admin", BSON("ping" << 1));
+    assertCommandOK("admin", BSON("ping" << 1));
+}
+
 TEST_F(NetworkInterfaceASIOIntegrationTest, Timeouts) {
     startNet();
     // This sleep command will take 10 seconds, so we should time out client side first given
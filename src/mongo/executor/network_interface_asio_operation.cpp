@@ -113,11 +113,11 @@ NetworkInterfaceASIO::AsyncOp::AsyncOp(NetworkInterfaceASIO* const owner,
       _request(request),
       _onFinish(onFinish),
       _start(now),
-      _resolver(owner->_io_service),
+      _resolver(owner->_ioServiceFor(request.target)),
       _id(kAsyncOpIdCounter.addAndFetch(1)),
       _access(std::make_shared<AsyncOp::AccessControl>()),
       _inSetup(true),
-      _strand(owner->_io_service) {
+      _strand(owner->_ioServiceFor(request.target)) {
     // No need to take lock when we aren't yet constructed.
     _transitionToState_inlock(State::kUninitialized);
 }
@@ -28,6 +28,9 @@
 
 #include "mongo/executor/network_interface_factory.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "mongo/base/init.h"
 #include "mongo/base/status.h"
 #include "mongo/config.h"
@@ -45,6 +48,19 @@
 namespace mongo {
 namespace executor {
 
+namespace {
+
+// The number of io_services, and so of network threads, in each NetworkInterfaceASIO. Spreading
+// the target hosts over several of them helps processes, such as mongos, which fan out to many.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(taskExecutorNetworkIOServices, int, 1);
+
+// The most connections to one host which each NetworkInterfaceASIO's pool sets up at once.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(taskExecutorPoolMaxConnecting,
+                                      int,
+                                      std::numeric_limits<int>::max());
+
+}  // namespace
+
 std::unique_ptr<NetworkInterface> makeNetworkInterface(std::string instanceName) {
     return makeNetworkInterface(std::move(instanceName), nullptr, nullptr);
 }
@@ -58,6 +74,8 @@ std::unique_ptr<NetworkInterface> makeNetworkInterface(
     options.networkConnectionHook = std::move(hook);
     options.metadataHook = std::move(metadataHook);
     options.timerFactory = stdx::make_unique<AsyncTimerFactoryASIO>();
+    options.numIOServices = std::max(taskExecutorNetworkIOServices, 1);
+    options.connectionPoolOptions.maxConnecting = std::max(taskExecutorPoolMaxConnecting, 1);
 
 #ifdef MONGO_CONFIG_SSL
     if (SSLManagerInterface* manager = getSSLManager()) {
@@ -0,0 +1,145 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/executor/reply_buffer_pool.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/allocator.h"
+
+namespace mongo {
+namespace executor {
+
+namespace {
+
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(replyBufferPoolMaxCachedBytesPerSizeClass,
+                                      int,
+                                      4 * 1024 * 1024);
+
+}  // namespace
+
+const size_t ReplyBufferPool::kMinSizeClassBytes;
+const size_t ReplyBufferPool::kMaxSizeClassBytes;
+const size_t ReplyBufferPool::kNumSizeClasses;
+
+ReplyBufferPool::ReplyBufferPool(size_t maxCachedBytesPerSizeClass) {
+    static_assert(kMinSizeClassBytes << (kNumSizeClasses - 1) == kMaxSizeClassBytes,
+                  "the size classes must double from the smallest to the largest");
+
+    for (size_t blockBytes = kMinSizeClassBytes; blockBytes <= kMaxSizeClassBytes;
+         blockBytes *= 2) {
+        _sizeClasses.push_back(
+            stdx::make_unique<SizeClass>(blockBytes, maxCachedBytesPerSizeClass / blockBytes));
+    }
+}
+
+ReplyBufferPool::~ReplyBufferPool() = default;
+
+ReplyBufferPool* ReplyBufferPool::get() {
+    static ReplyBufferPool* const pool =
+        new ReplyBufferPool(std::max(replyBufferPoolMaxCachedBytesPerSizeClass, 0));
+    return pool;
+}
+
+SharedBuffer ReplyBufferPool::allocate(size_t bytes) {
+    if (bytes > kMaxSizeClassBytes) {
+        _oversized.fetchAndAdd(1);
+        return SharedBuffer::allocate(bytes);
+    }
+
+    size_t index = 0;
+    for (size_t blockBytes = kMinSizeClassBytes; blockBytes < bytes; blockBytes *= 2) {
+        ++index;
+    }
+    return _sizeClasses[index]->allocate(&_hits, &_misses);
+}
+
+void ReplyBufferPool::appendStats(BSONObjBuilder* builder) const {
+    size_t cachedBytes = 0;
+    for (const auto& sizeClass : _sizeClasses) {
+        cachedBytes += sizeClass->cachedBytes();
+    }
+
+    builder->appendNumber("hits", static_cast<long long>(_hits.load()));
+    builder->appendNumber("misses", static_cast<long long>(_misses.load()));
+    builder->appendNumber("oversized", static_cast<long long>(_oversized.load()));
+    builder->appendNumber("cachedBytes", static_cast<long long>(cachedBytes));
+}
+
+ReplyBufferPool::SizeClass::SizeClass(size_t blockBytes, size_t maxCachedBlocks)
+    : _blockBytes(blockBytes), _maxCachedBlocks(maxCachedBlocks) {}
+
+ReplyBufferPool::SizeClass::~SizeClass() {
+    for (auto block : _freeBlocks) {
+        std::free(block);
+    }
+}
+
+SharedBuffer ReplyBufferPool::SizeClass::allocate(AtomicUInt64* hits, AtomicUInt64* misses) {
+    void* block = nullptr;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_freeBlocks.empty()) {
+            block = _freeBlocks.back();
+            _freeBlocks.pop_back();
+        }
+    }
+
+    if (block) {
+        hits->fetchAndAdd(1);
+    } else {
+        misses->fetchAndAdd(1);
+        block = mongoMalloc(SharedBuffer::releasableHeaderSize() + _blockBytes);
+    }
+    return SharedBuffer::takeReleasableOwnership(block, this);
+}
+
+void ReplyBufferPool::SizeClass::release(void* block) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_freeBlocks.size() < _maxCachedBlocks) {
+            _freeBlocks.push_back(block);
+            return;
+        }
+    }
+    std::free(block);
+}
+
+size_t ReplyBufferPool::SizeClass::cachedBytes() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _freeBlocks.size() * _blockBytes;
+}
+
+}  // namespace executor
+}  // namespace mongo
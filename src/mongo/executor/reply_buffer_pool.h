@@ -0,0 +1,122 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/shared_buffer.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+namespace executor {
+
+/**
+ * A pool of buffers for the replies read by NetworkInterfaceASIO, grouped in power-of-two size
+ * classes, so that a mongos reading many replies of similar sizes reuses the same few blocks
+ * rather than allocating fresh ones for each reply. A buffer goes back to its size class when the
+ * last reference to it, usually from the RemoteCommandResponse or the BSONObjs pointing into it, is
+ * dropped. Replies larger than the largest size class are allocated as plain buffers.
+ */
+class ReplyBufferPool {
+    MONGO_DISALLOW_COPYING(ReplyBufferPool);
+
+public:
+    static const size_t kMinSizeClassBytes = 1024;
+    static const size_t kMaxSizeClassBytes = 1024 * 1024;
+
+    /**
+     * Creates a pool which keeps at most 'maxCachedBytesPerSizeClass' bytes of free blocks in
+     * each size class and frees the blocks released beyond that.
+     */
+    explicit ReplyBufferPool(size_t maxCachedBytesPerSizeClass);
+
+    /**
+     * Frees the cached blocks. Must not be called while buffers from this pool are referenced.
+     */
+    ~ReplyBufferPool();
+
+    /**
+     * Returns the pool shared by every NetworkInterfaceASIO in the process, which is never
+     * destroyed so that replies may outlive the network interface which read them.
+     */
+    static ReplyBufferPool* get();
+
+    /**
+     * Returns a buffer of at least 'bytes' bytes.
+     */
+    SharedBuffer allocate(size_t bytes);
+
+    /**
+     * Appends the counts of allocations served from and missed by the pool, and of the bytes it
+     * currently caches.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+private:
+    /**
+     * The free blocks of one size. Blocks hold the SharedBuffer header followed by 'blockBytes'
+     * bytes of data.
+     */
+    class SizeClass final : public SharedBuffer::Releaser {
+    public:
+        SizeClass(size_t blockBytes, size_t maxCachedBlocks);
+        ~SizeClass();
+
+        SharedBuffer allocate(AtomicUInt64* hits, AtomicUInt64* misses);
+
+        void release(void* block) override;
+
+        size_t cachedBytes() const;
+
+    private:
+        const size_t _blockBytes;
+        const size_t _maxCachedBlocks;
+
+        mutable stdx::mutex _mutex;
+        std::vector<void*> _freeBlocks;
+    };
+
+    static const size_t kNumSizeClasses = 11;
+
+    std::vector<std::unique_ptr<SizeClass>> _sizeClasses;
+
+    AtomicUInt64 _hits;
+    AtomicUInt64 _misses;
+    AtomicUInt64 _oversized;
+};
+
+}  // namespace executor
+}  // namespace mongo
@@ -0,0 +1,112 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <cstring>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/executor/reply_buffer_pool.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace executor {
+namespace {
+
+BSONObj getStats(const ReplyBufferPool& pool) {
+    BSONObjBuilder builder;
+    pool.appendStats(&builder);
+    return builder.obj();
+}
+
+TEST(ReplyBufferPoolTest, ReleasedBufferIsReused) {
+    ReplyBufferPool pool(1024 * 1024);
+
+    auto buffer = pool.allocate(3000);
+    const auto data = buffer.get();
+    std::memset(data, 'x', 3000);
+    buffer = SharedBuffer();
+    ASSERT_EQUALS(4096, getStats(pool)["cachedBytes"].numberLong());
+
+    buffer = pool.allocate(4000);
+    ASSERT_EQUALS(data, buffer.get());
+
+    auto stats = getStats(pool);
+    ASSERT_EQUALS(1, stats["hits"].numberLong());
+    ASSERT_EQUALS(1, stats["misses"].numberLong());
+    ASSERT_EQUALS(0, stats["cachedBytes"].numberLong());
+}
+
+TEST(ReplyBufferPoolTest, BufferIsReleasedWithItsLastReference) {
+    ReplyBufferPool pool(1024 * 1024);
+
+    auto buffer = pool.allocate(100);
+    ConstSharedBuffer reference(buffer);
+    buffer = SharedBuffer();
+    ASSERT_EQUALS(0, getStats(pool)["cachedBytes"].numberLong());
+
+    reference = ConstSharedBuffer();
+    ASSERT_EQUALS(1024, getStats(pool)["cachedBytes"].numberLong());
+}
+
+TEST(ReplyBufferPoolTest, SizeClassesDoNotShareBlocks) {
+    ReplyBufferPool pool(1024 * 1024);
+
+    pool.allocate(1024);
+    auto buffer = pool.allocate(1025);
+
+    auto stats = getStats(pool);
+    ASSERT_EQUALS(0, stats["hits"].numberLong());
+    ASSERT_EQUALS(2, stats["misses"].numberLong());
+}
+
+TEST(ReplyBufferPoolTest, CachedBytesAreBounded) {
+    ReplyBufferPool pool(2048);
+
+    {
+        auto first = pool.allocate(1024);
+        auto second = pool.allocate(1024);
+        auto third = pool.allocate(1024);
+    }
+    ASSERT_EQUALS(2048, getStats(pool)["cachedBytes"].numberLong());
+}
+
+TEST(ReplyBufferPoolTest, OversizedBuffersAreNotPooled) {
+    ReplyBufferPool pool(16 * 1024 * 1024);
+
+    pool.allocate(ReplyBufferPool::kMaxSizeClassBytes + 1);
+
+    auto stats = getStats(pool);
+    ASSERT_EQUALS(1, stats["oversized"].numberLong());
+    ASSERT_EQUALS(0, stats["misses"].numberLong());
+    ASSERT_EQUALS(0, stats["cachedBytes"].numberLong());
+}
+
+}  // namespace
+}  // namespace executor
+}  // namespace mongo
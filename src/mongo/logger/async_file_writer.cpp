@@ -0,0 +1,134 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/logger/async_file_writer.h"
+
+#include "mongo/logger/rotatable_file_writer.h"
+
+namespace mongo {
+namespace logger {
+
+Counter64 AsyncFileWriter::queuedEvents;
+Counter64 AsyncFileWriter::droppedEvents;
+
+AsyncFileWriter::AsyncFileWriter(RotatableFileWriter* writer,
+                                 size_t maxQueuedEvents,
+                                 OverflowPolicy policy)
+    : _writer(writer), _maxQueuedEvents(maxQueuedEvents), _policy(policy) {
+    _thread = stdx::thread([this] { _run(); });
+}
+
+AsyncFileWriter::~AsyncFileWriter() {
+    stop();
+}
+
+void AsyncFileWriter::write(std::string line) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    if (!_stopped && _queue.size() >= _maxQueuedEvents) {
+        if (_policy == OverflowPolicy::kDrop) {
+            droppedEvents.increment();
+            return;
+        }
+        _linesTaken.wait(lk, [&] { return _queue.size() < _maxQueuedEvents || _stopped; });
+    }
+
+    if (_stopped) {
+        // Holding '_mutex' keeps the line in order with those other threads write now.
+        std::deque<std::string> lines;
+        lines.push_back(std::move(line));
+        _writeLines(lines);
+        return;
+    }
+
+    _queue.push_back(std::move(line));
+    ++_numQueued;
+    queuedEvents.increment();
+    _linesQueued.notify_one();
+}
+
+void AsyncFileWriter::flush() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    const unsigned long long target = _numQueued;
+    _linesTaken.wait(lk, [&] { return _numWritten >= target || _stopped; });
+}
+
+void AsyncFileWriter::stop() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_inShutdown) {
+            return;
+        }
+        _inShutdown = true;
+        _linesQueued.notify_one();
+    }
+    _thread.join();
+}
+
+void AsyncFileWriter::_run() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (true) {
+        _linesQueued.wait(lk, [&] { return !_queue.empty() || _inShutdown; });
+        if (_queue.empty()) {
+            break;
+        }
+
+        std::deque<std::string> lines;
+        lines.swap(_queue);
+        _linesTaken.notify_all();
+        lk.unlock();
+
+        _writeLines(lines);
+        queuedEvents.decrement(lines.size());
+
+        lk.lock();
+        _numWritten += lines.size();
+        _linesTaken.notify_all();
+    }
+
+    // Later lines are written by the threads logging them, with '_mutex' held.
+    _stopped = true;
+    _linesTaken.notify_all();
+}
+
+void AsyncFileWriter::_writeLines(const std::deque<std::string>& lines) {
+    // Errors can't be logged from here without queueing more lines, so they are dropped as the
+    // synchronous appenders' are.
+    RotatableFileWriter::Use useWriter(_writer);
+    if (!useWriter.status().isOK()) {
+        return;
+    }
+    for (const auto& line : lines) {
+        useWriter.stream() << line;
+    }
+    useWriter.stream().flush();
+}
+
+}  // namespace logger
+}  // namespace mongo
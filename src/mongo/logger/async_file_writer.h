@@ -0,0 +1,130 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <deque>
+#include <string>
+
+#include "mongo/base/counter.h"
+#include "mongo/base/disallow_copying.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+namespace logger {
+
+class RotatableFileWriter;
+
+/**
+ * Writes formatted log lines to a RotatableFileWriter from a thread of its own, so that threads
+ * logging don't wait for the file system.
+ *
+ * Lines are queued in memory up to a bound. What happens to a line that would exceed it depends on
+ * the OverflowPolicy given at construction.
+ */
+class AsyncFileWriter {
+    MONGO_DISALLOW_COPYING(AsyncFileWriter);
+
+public:
+    enum class OverflowPolicy {
+        // Wait for the writer thread to make room.
+        kBlock,
+        // Discard the line and count it in droppedEvents.
+        kDrop,
+    };
+
+    /**
+     * Number of lines queued and not yet written, and of lines discarded, by all writers.
+     */
+    static Counter64 queuedEvents;
+    static Counter64 droppedEvents;
+
+    /**
+     * Starts the writer thread. Does not own "writer", which must outlive the constructed object.
+     */
+    AsyncFileWriter(RotatableFileWriter* writer, size_t maxQueuedEvents, OverflowPolicy policy);
+
+    /**
+     * Writes all queued lines and stops the writer thread.
+     */
+    ~AsyncFileWriter();
+
+    /**
+     * Queues "line" to be written. After stop(), writes it on the calling thread instead.
+     */
+    void write(std::string line);
+
+    /**
+     * Waits until every line queued before this call has been written.
+     */
+    void flush();
+
+    /**
+     * Writes all queued lines and stops the writer thread. Lines written later go straight to
+     * the file, which is what messages logged while the process exits need.
+     */
+    void stop();
+
+private:
+    void _run();
+
+    /**
+     * Writes "lines" to the file under a single use of the RotatableFileWriter.
+     */
+    void _writeLines(const std::deque<std::string>& lines);
+
+    RotatableFileWriter* const _writer;
+    const size_t _maxQueuedEvents;
+    const OverflowPolicy _policy;
+
+    // Protects the members below
+    stdx::mutex _mutex;
+
+    // Signaled when lines are queued or stop() is called
+    stdx::condition_variable _linesQueued;
+
+    // Signaled when the writer thread takes the queued lines, and when it has written them
+    stdx::condition_variable _linesTaken;
+
+    std::deque<std::string> _queue;
+
+    // Counts of the lines ever queued and written, which flush() waits on
+    unsigned long long _numQueued = 0;
+    unsigned long long _numWritten = 0;
+
+    bool _inShutdown = false;
+    bool _stopped = false;
+
+    stdx::thread _thread;
+};
+
+}  // namespace logger
+}  // namespace mongo
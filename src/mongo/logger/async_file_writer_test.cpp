@@ -0,0 +1,113 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "mongo/logger/async_file_writer.h"
+#include "mongo/logger/rotatable_file_writer.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+using namespace mongo;
+using namespace mongo::logger;
+
+const std::string logFileName("LogTest_AsyncFileWriter.txt");
+
+class AsyncFileWriterTest : public mongo::unittest::Test {
+public:
+    AsyncFileWriterTest() {
+        unlink(logFileName.c_str());
+        RotatableFileWriter::Use writerUse(&writer);
+        ASSERT_OK(writerUse.setFileName(logFileName, false));
+    }
+
+    virtual ~AsyncFileWriterTest() {
+        unlink(logFileName.c_str());
+    }
+
+    std::vector<std::string> readLines() {
+        std::vector<std::string> lines;
+        std::ifstream ifs(logFileName.c_str());
+        ASSERT_TRUE(ifs.is_open());
+        std::string line;
+        while (std::getline(ifs, line)) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    RotatableFileWriter writer;
+};
+
+TEST_F(AsyncFileWriterTest, WritesLinesInOrder) {
+    AsyncFileWriter asyncWriter(&writer, 10, AsyncFileWriter::OverflowPolicy::kBlock);
+    for (int i = 0; i < 100; i++) {
+        asyncWriter.write(std::to_string(i) + "\n");
+    }
+    asyncWriter.flush();
+
+    std::vector<std::string> lines = readLines();
+    ASSERT_EQUALS(100U, lines.size());
+    for (int i = 0; i < 100; i++) {
+        ASSERT_EQUALS(std::to_string(i), lines[i]);
+    }
+}
+
+TEST_F(AsyncFileWriterTest, WritesDirectlyAfterStop) {
+    AsyncFileWriter asyncWriter(&writer, 10, AsyncFileWriter::OverflowPolicy::kDrop);
+    asyncWriter.write("before\n");
+    asyncWriter.stop();
+    asyncWriter.write("after\n");
+
+    std::vector<std::string> lines = readLines();
+    ASSERT_EQUALS(2U, lines.size());
+    ASSERT_EQUALS("before", lines[0]);
+    ASSERT_EQUALS("after", lines[1]);
+}
+
+TEST_F(AsyncFileWriterTest, DropsLinesOverTheBound) {
+    const long long droppedBefore = AsyncFileWriter::droppedEvents.get();
+    AsyncFileWriter asyncWriter(&writer, 2, AsyncFileWriter::OverflowPolicy::kDrop);
+    {
+        // Holding the file writer blocks the writer thread once it has taken a batch of at most
+        // two lines, so at most four of the lines fit.
+        RotatableFileWriter::Use writerUse(&writer);
+        for (int i = 0; i < 10; i++) {
+            asyncWriter.write(std::to_string(i) + "\n");
+        }
+        ASSERT_GTE(AsyncFileWriter::droppedEvents.get() - droppedBefore, 6);
+    }
+    asyncWriter.flush();
+    ASSERT_EQUALS(10U, readLines().size() + AsyncFileWriter::droppedEvents.get() - droppedBefore);
+}
+
+}  // namespace
@@ -34,6 +34,7 @@
 #include <cmath>
 #include <cstdlib>
 #include <iostream>
+#include <limits>
 #include <memory>
 #include <string>
 #include <utility>
@@ -201,6 +202,35 @@ BID_UINT128 quantizeTo15DecimalDigits(BID_UINT128 value,
     return value;
 }
 
+// The powers of ten which are exact doubles.
+const double kExactPowersOfTen[] = {1E0,  1E1,  1E2,  1E3,  1E4,  1E5,  1E6,  1E7,
+                                    1E8,  1E9,  1E10, 1E11, 1E12, 1E13, 1E14, 1E15,
+                                    1E16, 1E17, 1E18, 1E19, 1E20, 1E21, 1E22};
+const int kMaxExactPowerOfTen = 22;
+
+// The high and low 64 bits of the largest coefficient, 1E34 - 1.
+const std::uint64_t kMaxCoefficientHigh64 = 0x1ed09bead87c0;
+const std::uint64_t kMaxCoefficientLow64 = 0x378d8e63ffffffff;
+
+/**
+ * Computes the 128-bit product of 'a' and 'b' from the products of their 32-bit halves.
+ */
+void multiply64To128(std::uint64_t a, std::uint64_t b, std::uint64_t* high, std::uint64_t* low) {
+    const std::uint64_t aLo = a & 0xffffffff;
+    const std::uint64_t aHi = a >> 32;
+    const std::uint64_t bLo = b & 0xffffffff;
+    const std::uint64_t bHi = b >> 32;
+
+    const std::uint64_t loLo = aLo * bLo;
+    const std::uint64_t hiLo = aHi * bLo;
+    const std::uint64_t loHi = aLo * bHi;
+    const std::uint64_t hiHi = aHi * bHi;
+
+    const std::uint64_t middle = (loLo >> 32) + (hiLo & 0xffffffff) + (loHi & 0xffffffff);
+    *low = (middle << 32) | (loLo & 0xffffffff);
+    *high = hiHi + (hiLo >> 32) + (loHi >> 32) + (middle >> 32);
+}
+
 }  // namespace
 
 Decimal128::Decimal128(std::int32_t int32Value)
@@ -472,6 +502,11 @@ double Decimal128::toDouble(RoundingMode roundMode) const {
 }
 
 double Decimal128::toDouble(std::uint32_t* signalingFlags, RoundingMode roundMode) const {
+    double result;
+    if (_toDoubleSmall(roundMode, signalingFlags, &result)) {
+        return result;
+    }
+
     BID_UINT128 dec128 = decimal128ToLibraryType(_value);
     return bid128_to_binary64(dec128, roundMode, signalingFlags);
 }
@@ -620,6 +655,11 @@ Decimal128 Decimal128::add(const Decimal128& other, RoundingMode roundMode) cons
 Decimal128 Decimal128::add(const Decimal128& other,
                            std::uint32_t* signalingFlags,
                            RoundingMode roundMode) const {
+    Decimal128 sum;
+    if (_addSmall(other, false, roundMode, &sum)) {
+        return sum;
+    }
+
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 addend = decimal128ToLibraryType(other.getValue());
     current = bid128_add(current, addend, roundMode, signalingFlags);
@@ -636,6 +676,11 @@ Decimal128 Decimal128::subtract(const Decimal128& other, RoundingMode roundMode)
 Decimal128 Decimal128::subtract(const Decimal128& other,
                                 std::uint32_t* signalingFlags,
                                 RoundingMode roundMode) const {
+    Decimal128 difference;
+    if (_addSmall(other, true, roundMode, &difference)) {
+        return difference;
+    }
+
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 sub = decimal128ToLibraryType(other.getValue());
     current = bid128_sub(current, sub, roundMode, signalingFlags);
@@ -652,6 +697,11 @@ Decimal128 Decimal128::multiply(const Decimal128& other, RoundingMode roundMode)
 Decimal128 Decimal128::multiply(const Decimal128& other,
                                 std::uint32_t* signalingFlags,
                                 RoundingMode roundMode) const {
+    Decimal128 product;
+    if (_multiplySmall(other, &product)) {
+        return product;
+    }
+
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 factor = decimal128ToLibraryType(other.getValue());
     current = bid128_mul(current, factor, roundMode, signalingFlags);
@@ -781,6 +831,11 @@ Decimal128 Decimal128::squareRoot(std::uint32_t* signalingFlags, RoundingMode ro
 }
 
 bool Decimal128::isEqual(const Decimal128& other) const {
+    int cmp;
+    if (_compareSmall(other, &cmp)) {
+        return cmp == 0;
+    }
+
     std::uint32_t throwAwayFlag = 0;
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 compare = decimal128ToLibraryType(other.getValue());
@@ -788,6 +843,11 @@ bool Decimal128::isEqual(const Decimal128& other) const {
 }
 
 bool Decimal128::isNotEqual(const Decimal128& other) const {
+    int cmp;
+    if (_compareSmall(other, &cmp)) {
+        return cmp != 0;
+    }
+
     std::uint32_t throwAwayFlag = 0;
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 compare = decimal128ToLibraryType(other.getValue());
@@ -795,6 +855,11 @@ bool Decimal128::isNotEqual(const Decimal128& other) const {
 }
 
 bool Decimal128::isGreater(const Decimal128& other) const {
+    int cmp;
+    if (_compareSmall(other, &cmp)) {
+        return cmp > 0;
+    }
+
     std::uint32_t throwAwayFlag = 0;
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 compare = decimal128ToLibraryType(other.getValue());
@@ -802,6 +867,11 @@ bool Decimal128::isGreater(const Decimal128& other) const {
 }
 
 bool Decimal128::isGreaterEqual(const Decimal128& other) const {
+    int cmp;
+    if (_compareSmall(other, &cmp)) {
+        return cmp >= 0;
+    }
+
     std::uint32_t throwAwayFlag = 0;
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 compare = decimal128ToLibraryType(other.getValue());
@@ -809,6 +879,11 @@ bool Decimal128::isGreaterEqual(const Decimal128& other) const {
 }
 
 bool Decimal128::isLess(const Decimal128& other) const {
+    int cmp;
+    if (_compareSmall(other, &cmp)) {
+        return cmp < 0;
+    }
+
     std::uint32_t throwAwayFlag = 0;
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 compare = decimal128ToLibraryType(other.getValue());
@@ -816,12 +891,145 @@ bool Decimal128::isLess(const Decimal128& other) const {
 }
 
 bool Decimal128::isLessEqual(const Decimal128& other) const {
+    int cmp;
+    if (_compareSmall(other, &cmp)) {
+        return cmp <= 0;
+    }
+
     std::uint32_t throwAwayFlag = 0;
     BID_UINT128 current = decimal128ToLibraryType(_value);
     BID_UINT128 compare = decimal128ToLibraryType(other.getValue());
     return bid128_quiet_less_equal(current, compare, &throwAwayFlag);
 }
 
+bool Decimal128::_addSmall(const Decimal128& other,
+                           bool negateOther,
+                           RoundingMode roundMode,
+                           Decimal128* result) const {
+    // With equal exponents the sum is the sum of the coefficients, which can't have more than 65
+    // bits and so is exact.
+    if (!_hasSmallCoefficient() || !other._hasSmallCoefficient() ||
+        getBiasedExponent() != other.getBiasedExponent()) {
+        return false;
+    }
+
+    const uint64_t sign = _value.high64 >> kSignFieldPos;
+    const uint64_t otherSign = (other._value.high64 >> kSignFieldPos) ^ negateOther;
+    const uint64_t coefficient = _value.low64;
+    const uint64_t otherCoefficient = other._value.low64;
+
+    if (sign == otherSign) {
+        const uint64_t low = coefficient + otherCoefficient;
+        *result = Decimal128(sign, getBiasedExponent(), low < coefficient, low);
+    } else if (coefficient > otherCoefficient) {
+        *result = Decimal128(sign, getBiasedExponent(), 0, coefficient - otherCoefficient);
+    } else if (coefficient < otherCoefficient) {
+        *result = Decimal128(otherSign, getBiasedExponent(), 0, otherCoefficient - coefficient);
+    } else {
+        // An exact zero sum of operands with opposite signs is positive, except when rounding
+        // toward negative.
+        *result = Decimal128(roundMode == kRoundTowardNegative, getBiasedExponent(), 0, 0);
+    }
+    return true;
+}
+
+bool Decimal128::_multiplySmall(const Decimal128& other, Decimal128* result) const {
+    if (!_hasSmallCoefficient() || !other._hasSmallCoefficient()) {
+        return false;
+    }
+
+    // The exponent of an exact product is the sum of the exponents of the factors.
+    const int64_t exponent = static_cast<int64_t>(getBiasedExponent()) +
+        other.getBiasedExponent() - kExponentBias;
+    if (exponent < 0 || exponent > kMaxBiasedExponent) {
+        return false;
+    }
+
+    uint64_t high;
+    uint64_t low;
+    multiply64To128(_value.low64, other._value.low64, &high, &low);
+    if (high > kMaxCoefficientHigh64 ||
+        (high == kMaxCoefficientHigh64 && low > kMaxCoefficientLow64)) {
+        // The product has more than 34 digits and needs rounding.
+        return false;
+    }
+
+    const uint64_t sign = (_value.high64 ^ other._value.high64) >> kSignFieldPos;
+    *result = Decimal128(sign, exponent, high, low);
+    return true;
+}
+
+bool Decimal128::_compareSmall(const Decimal128& other, int* result) const {
+    if (!_hasSmallCoefficient() || !other._hasSmallCoefficient() ||
+        getBiasedExponent() != other.getBiasedExponent()) {
+        return false;
+    }
+
+    const bool negative = _value.high64 >> kSignFieldPos;
+    const bool otherNegative = other._value.high64 >> kSignFieldPos;
+    const uint64_t coefficient = _value.low64;
+    const uint64_t otherCoefficient = other._value.low64;
+
+    if (coefficient == 0 && otherCoefficient == 0) {
+        // Zeros are equal regardless of their signs.
+        *result = 0;
+    } else if (negative != otherNegative) {
+        *result = negative ? -1 : 1;
+    } else {
+        const int magnitude =
+            coefficient < otherCoefficient ? -1 : (coefficient > otherCoefficient ? 1 : 0);
+        *result = negative ? -magnitude : magnitude;
+    }
+    return true;
+}
+
+bool Decimal128::_toDoubleSmall(RoundingMode roundMode,
+                                std::uint32_t* signalingFlags,
+                                double* result) const {
+    // Ties between two doubles can occur when multiplying by a power of ten, and are broken
+    // toward even by the hardware.
+    if (!_hasSmallCoefficient() || _value.low64 > (1ULL << 53) || roundMode == kRoundTiesToAway) {
+        return false;
+    }
+    const int32_t exponent = static_cast<int32_t>(getBiasedExponent()) - kExponentBias;
+    if (exponent < -kMaxExactPowerOfTen || exponent > kMaxExactPowerOfTen) {
+        return false;
+    }
+
+    // Both the coefficient and the power of ten are exact doubles, so a single multiplication or
+    // division yields the magnitude rounded to nearest, and a fused multiply-add gives the exact
+    // error of that rounding. The error is positive if the magnitude was rounded down.
+    const bool negative = _value.high64 >> kSignFieldPos;
+    const double coefficient = static_cast<double>(_value.low64);
+    const double powerOfTen = kExactPowersOfTen[exponent < 0 ? -exponent : exponent];
+    double magnitude;
+    double error;
+    if (exponent < 0) {
+        magnitude = coefficient / powerOfTen;
+        error = std::fma(-magnitude, powerOfTen, coefficient);
+    } else {
+        magnitude = coefficient * powerOfTen;
+        error = std::fma(coefficient, powerOfTen, -magnitude);
+    }
+
+    if (error != 0) {
+        *signalingFlags |= kInexact;
+        const bool roundMagnitudeUp = (roundMode == kRoundTowardPositive && !negative) ||
+            (roundMode == kRoundTowardNegative && negative);
+        const bool roundMagnitudeDown = roundMode == kRoundTowardZero ||
+            (roundMode == kRoundTowardPositive && negative) ||
+            (roundMode == kRoundTowardNegative && !negative);
+        if (error > 0 && roundMagnitudeUp) {
+            magnitude = std::nextafter(magnitude, std::numeric_limits<double>::infinity());
+        } else if (error < 0 && roundMagnitudeDown) {
+            magnitude = std::nextafter(magnitude, 0.0);
+        }
+    }
+
+    *result = negative ? -magnitude : magnitude;
+    return true;
+}
+
 /**
  * The following static const variables are used to mathematically produce
  * frequently needed Decimal128 constants.
@@ -843,6 +1051,7 @@ const std::uint64_t t17hi32 = t17 >> 32;
 const std::uint64_t t34hi64 = t17hi32 * t17hi32 + (((t17hi32 * t17lo32) >> 31));
 static_assert(t34hi64 == 0x1ed09bead87c0, "");
 static_assert(t34lo64 == 0x378d8e63ffffffff, "");
+static_assert(t34hi64 == kMaxCoefficientHigh64 && t34lo64 == kMaxCoefficientLow64, "");
 }  // namespace
 
 // (t34hi64 << 64) + t34lo64 == 1e34 - 1
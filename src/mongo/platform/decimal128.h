@@ -426,6 +426,29 @@ private:
         return (_value.high64 >> kCombinationFieldPos) & kCombinationFieldMask;
     }
 
+    /**
+     * Returns true if this is a finite number whose coefficient fits in 64 bits. Arithmetic and
+     * comparisons between such numbers have fast paths which don't call into the decimal library.
+     */
+    bool _hasSmallCoefficient() const {
+        return _getCombinationField() < kCombinationNonCanonical &&
+            (_value.high64 & kCanonicalCoefficientHighFieldMask) == 0;
+    }
+
+    /**
+     * The fast paths. Each returns false, leaving the out parameters untouched, if it can't
+     * compute the correctly rounded result from the coefficients of the operands, in which case
+     * the caller has to use the decimal library. Arithmetic results computed by a fast path are
+     * exact, so no signaling flags are raised; a conversion to double may raise kInexact.
+     */
+    bool _addSmall(const Decimal128& other,
+                   bool negateOther,
+                   RoundingMode roundMode,
+                   Decimal128* result) const;
+    bool _multiplySmall(const Decimal128& other, Decimal128* result) const;
+    bool _compareSmall(const Decimal128& other, int* result) const;
+    bool _toDoubleSmall(RoundingMode roundMode, std::uint32_t* signalingFlags, double* result) const;
+
     Value _value;
 };
 }  // namespace mongo
@@ -0,0 +1,90 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/platform/decimal128.h"
+#include "mongo/unittest/benchmark.h"
+
+namespace mongo {
+namespace {
+
+// Prices with two decimal places, which take the fast paths.
+const Decimal128 kPrice("1234.56");
+const Decimal128 kOtherPrice("78.90");
+
+// The same values with different exponents, which go through the decimal library.
+const Decimal128 kPriceExtraDigit("1234.560");
+const Decimal128 kQuantity("3");
+
+MONGO_BENCHMARK(Decimal128AddSameExponent) {
+    while (state.keepRunning()) {
+        benchmark::doNotOptimizeAway(kPrice.add(kOtherPrice));
+    }
+}
+
+MONGO_BENCHMARK(Decimal128AddDifferentExponent) {
+    while (state.keepRunning()) {
+        benchmark::doNotOptimizeAway(kPriceExtraDigit.add(kOtherPrice));
+    }
+}
+
+MONGO_BENCHMARK(Decimal128Multiply) {
+    while (state.keepRunning()) {
+        benchmark::doNotOptimizeAway(kPrice.multiply(kQuantity));
+    }
+}
+
+MONGO_BENCHMARK(Decimal128CompareSameExponent) {
+    while (state.keepRunning()) {
+        benchmark::doNotOptimizeAway(kPrice.isLess(kOtherPrice));
+    }
+}
+
+MONGO_BENCHMARK(Decimal128CompareDifferentExponent) {
+    while (state.keepRunning()) {
+        benchmark::doNotOptimizeAway(kPriceExtraDigit.isLess(kOtherPrice));
+    }
+}
+
+MONGO_BENCHMARK(Decimal128ToDouble) {
+    while (state.keepRunning()) {
+        benchmark::doNotOptimizeAway(kPrice.toDouble());
+    }
+}
+
+MONGO_BENCHMARK(DoubleAddBaseline) {
+    double sum = 1234.56;
+    while (state.keepRunning()) {
+        sum += 78.90;
+        benchmark::doNotOptimizeAway(sum);
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -1210,6 +1210,67 @@ TEST(Decimal128Test, TestDecimal128LessEqualCase3) {
     ASSERT_TRUE(result);
 }
 
+// The following cases take the fast paths for finite values with 64-bit coefficients.
+
+TEST(Decimal128Test, TestDecimal128AdditionSameExponentCarriesIntoHigh64) {
+    Decimal128 d1(0, Decimal128::kExponentBias, 0, ~0ULL);
+    Decimal128 d2(0, Decimal128::kExponentBias, 0, 2);
+    uint32_t sigFlags = Decimal128::SignalingFlag::kNoFlag;
+    Decimal128 result = d1.add(d2, &sigFlags);
+    ASSERT_EQUALS(sigFlags, Decimal128::SignalingFlag::kNoFlag);
+    Decimal128 expected("18446744073709551617");
+    ASSERT_EQUALS(result.getValue().low64, expected.getValue().low64);
+    ASSERT_EQUALS(result.getValue().high64, expected.getValue().high64);
+}
+
+TEST(Decimal128Test, TestDecimal128SubtractionSameExponentToZero) {
+    Decimal128 d1("12.34");
+    Decimal128 result = d1.subtract(d1);
+    Decimal128 expected("0.00");
+    ASSERT_EQUALS(result.getValue().low64, expected.getValue().low64);
+    ASSERT_EQUALS(result.getValue().high64, expected.getValue().high64);
+
+    result = d1.subtract(d1, Decimal128::kRoundTowardNegative);
+    expected = Decimal128("-0.00");
+    ASSERT_EQUALS(result.getValue().low64, expected.getValue().low64);
+    ASSERT_EQUALS(result.getValue().high64, expected.getValue().high64);
+}
+
+TEST(Decimal128Test, TestDecimal128MultiplicationWithInexactResult) {
+    Decimal128 d1("9999999999999999999");
+    uint32_t sigFlags = Decimal128::SignalingFlag::kNoFlag;
+    Decimal128 result = d1.multiply(d1, &sigFlags);
+    Decimal128 expected("9.999999999999999998000000000000000E37");
+    ASSERT_TRUE(Decimal128::hasFlag(sigFlags, Decimal128::SignalingFlag::kInexact));
+    ASSERT_EQUALS(result.getValue().low64, expected.getValue().low64);
+    ASSERT_EQUALS(result.getValue().high64, expected.getValue().high64);
+}
+
+TEST(Decimal128Test, TestDecimal128CompareZerosOfDifferentSigns) {
+    Decimal128 d1("0.00");
+    Decimal128 d2("-0.00");
+    ASSERT_TRUE(d1.isEqual(d2));
+    ASSERT_FALSE(d1.isLess(d2));
+    ASSERT_FALSE(d2.isLess(d1));
+    ASSERT_TRUE(d2.isLess(Decimal128("0.01")));
+    ASSERT_TRUE(Decimal128("-0.01").isLess(d1));
+}
+
+TEST(Decimal128Test, TestDecimal128ToDoubleRoundingModes) {
+    Decimal128 d("0.1");
+    uint32_t sigFlags = Decimal128::SignalingFlag::kNoFlag;
+    ASSERT_EQUALS(d.toDouble(&sigFlags), 0.1);
+    ASSERT_TRUE(Decimal128::hasFlag(sigFlags, Decimal128::SignalingFlag::kInexact));
+    ASSERT_LT(d.toDouble(Decimal128::kRoundTowardZero), 0.1);
+    ASSERT_EQUALS(d.toDouble(Decimal128::kRoundTowardPositive), 0.1);
+    ASSERT_EQUALS(d.negate().toDouble(Decimal128::kRoundTowardZero),
+                  -d.toDouble(Decimal128::kRoundTowardZero));
+
+    sigFlags = Decimal128::SignalingFlag::kNoFlag;
+    ASSERT_EQUALS(Decimal128("-1.5").toDouble(&sigFlags), -1.5);
+    ASSERT_EQUALS(sigFlags, Decimal128::SignalingFlag::kNoFlag);
+}
+
 TEST(Decimal128Test, TestDecimal128GetLargestPositive) {
     Decimal128 d = Decimal128::kLargestPositive;
     uint64_t largestPositiveDecimalHigh64 = 6917508178773903296ull;
@@ -32,6 +32,7 @@
 
 #include "mongo/s/balancer/balancer.h"
 
+#include <algorithm>
 #include <string>
 
 #include "mongo/base/status_with.h"
@@ -42,6 +43,7 @@
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/query_request.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/balancer/balancer_chunk_selection_policy_impl.h"
 #include "mongo/s/balancer/balancer_configuration.h"
 #include "mongo/s/balancer/cluster_statistics_impl.h"
@@ -54,6 +56,7 @@
 #include "mongo/s/shard_util.h"
 #include "mongo/s/sharding_raii.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
 #include "mongo/util/represent_as.h"
 #include "mongo/util/timer.h"
@@ -74,6 +77,11 @@ const char kChunkTooBig[] = "chunkTooBig";
 
 const auto getBalancer = ServiceContext::declareDecoration<std::unique_ptr<Balancer>>();
 
+// The chunk selection policy never uses the same shard for more than one migration of a round, so
+// the migrations of a round can run concurrently. This bounds how many of them are in flight at
+// the same time. Setting it to 1 runs the migrations one after the other.
+MONGO_EXPORT_SERVER_PARAMETER(balancerMaxConcurrentMigrations, int, 8);
+
 /**
  * Utility class to generate timing and statistics for a single balancer round.
  */
@@ -242,6 +250,23 @@ Status executeSingleMigration(OperationContext* txn,
     return Status::OK();
 }
 
+/**
+ * Same as executeSingleMigration, but reports exceptions as a status, so that it can be run on a
+ * separate thread.
+ */
+Status executeSingleMigrationNoThrow(OperationContext* txn,
+                                     const MigrateInfo& migrateInfo,
+                                     uint64_t maxChunkSizeBytes,
+                                     const MigrationSecondaryThrottleOptions& secondaryThrottle,
+                                     bool waitForDelete) {
+    try {
+        return executeSingleMigration(
+            txn, migrateInfo, maxChunkSizeBytes, secondaryThrottle, waitForDelete);
+    } catch (const DBException& ex) {
+        return ex.toStatus();
+    }
+}
+
 }  // namespace
 
 Balancer::Balancer()
@@ -634,7 +659,11 @@ int Balancer::_moveChunks(OperationContext* txn,
                           bool waitForDelete) {
     int movedCount = 0;
 
-    for (const auto& migrateInfo : candidateChunks) {
+    const size_t maxConcurrentMigrations =
+        static_cast<size_t>(std::max(1, balancerMaxConcurrentMigrations.load()));
+
+    for (size_t waveBegin = 0; waveBegin < candidateChunks.size();
+         waveBegin += maxConcurrentMigrations) {
         auto balancerConfig = Grid::get(txn)->getBalancerConfiguration();
 
         // If the balancer was disabled since we started this round, don't start new chunk moves
@@ -643,6 +672,12 @@ int Balancer::_moveChunks(OperationContext* txn,
             return movedCount;
         }
 
+        const size_t waveEnd =
+            std::min(candidateChunks.size(), waveBegin + maxConcurrentMigrations);
+        const uint64_t maxChunkSizeBytes = balancerConfig->getMaxChunkSizeBytes();
+        const auto secondaryThrottleForWave = balancerConfig->getSecondaryThrottle();
+        const bool waitForDeleteForWave = balancerConfig->waitForDelete();
+
         // Changes to metadata, borked metadata, and connectivity problems between shards
         // should cause us to abort this chunk move, but shouldn't cause us to abort the entire
         // round of chunks.
@@ -653,20 +688,57 @@ int Balancer::_moveChunks(OperationContext* txn,
         //
         // TODO: Handle all these things more cleanly, since they're expected problems
 
-        const NamespaceString nss(migrateInfo.ns);
+        vector<Status> statuses(waveEnd - waveBegin, Status::OK());
+
+        if (statuses.size() == 1) {
+            statuses[0] = executeSingleMigrationNoThrow(txn,
+                                                        candidateChunks[waveBegin],
+                                                        maxChunkSizeBytes,
+                                                        secondaryThrottleForWave,
+                                                        waitForDeleteForWave);
+        } else {
+            // Each migration blocks until the donor shard reports back, so run them on separate
+            // threads, each with its own client and operation context
+            vector<stdx::thread> migrationThreads;
+            for (size_t i = waveBegin; i < waveEnd; i++) {
+                migrationThreads.emplace_back([&, i] {
+                    Client::initThread("BalancerMigration");
+                    const auto migrationTxn = cc().makeOperationContext();
+
+                    statuses[i - waveBegin] =
+                        executeSingleMigrationNoThrow(migrationTxn.get(),
+                                                      candidateChunks[i],
+                                                      maxChunkSizeBytes,
+                                                      secondaryThrottleForWave,
+                                                      waitForDeleteForWave);
+                });
+            }
+
+            for (auto& migrationThread : migrationThreads) {
+                migrationThread.join();
+            }
+        }
+
+        for (size_t i = waveBegin; i < waveEnd; i++) {
+            const auto& migrateInfo = candidateChunks[i];
+            const Status& status = statuses[i - waveBegin];
 
-        try {
-            Status status = executeSingleMigration(txn,
-                                                   migrateInfo,
-                                                   balancerConfig->getMaxChunkSizeBytes(),
-                                                   balancerConfig->getSecondaryThrottle(),
-                                                   balancerConfig->waitForDelete());
             if (status.isOK()) {
                 movedCount++;
-            } else if (status == ErrorCodes::ChunkTooBig) {
-                log() << "Performing a split because migrate failed for size reasons"
-                      << causedBy(status);
+                continue;
+            }
 
+            if (status != ErrorCodes::ChunkTooBig) {
+                log() << "balancer move " << migrateInfo << " failed" << causedBy(status);
+                continue;
+            }
+
+            log() << "Performing a split because migrate failed for size reasons"
+                  << causedBy(status);
+
+            const NamespaceString nss(migrateInfo.ns);
+
+            try {
                 auto scopedCM = uassertStatusOK(ScopedChunkManager::getExisting(txn, nss));
                 ChunkManager* const cm = scopedCM.cm();
 
@@ -681,11 +753,9 @@ int Balancer::_moveChunks(OperationContext* txn,
                     // We increment moveCount so we do another round right away
                     movedCount++;
                 }
-            } else {
-                log() << "Balancer move failed" << causedBy(status);
+            } catch (const DBException& ex) {
+                log() << "balancer move " << migrateInfo << " failed" << causedBy(ex);
             }
-        } catch (const DBException& ex) {
-            log() << "balancer move " << migrateInfo << " failed" << causedBy(ex);
         }
     }
 
@@ -174,7 +174,8 @@ private:
     Status _enforceTagRanges(OperationContext* txn);
 
     /**
-     * Issues chunk migration request, one at a time.
+     * Issues chunk migration requests. Since no two candidates share a shard, up to
+     * balancerMaxConcurrentMigrations of them are run at the same time.
      *
      * @param candidateChunks possible chunks to move
      * @param writeConcern detailed write concern. NULL means the default write concern.
@@ -157,6 +157,10 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToMo
 
     MigrateInfoVector candidateChunks;
 
+    // Shards which already participate in a migration selected for an earlier collection, so that
+    // the selected migrations can all run in parallel
+    std::set<ShardId> usedShards;
+
     for (const auto& coll : collections) {
         const NamespaceString nss(coll.getNs());
 
@@ -165,8 +169,8 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::selectChunksToMo
             continue;
         }
 
-        auto candidatesStatus =
-            _getMigrateCandidatesForCollection(txn, nss, shardStats, aggressiveBalanceHint);
+        auto candidatesStatus = _getMigrateCandidatesForCollection(
+            txn, nss, shardStats, aggressiveBalanceHint, &usedShards);
         if (!candidatesStatus.isOK()) {
             warning() << "Unable to balance collection " << nss.ns()
                       << causedBy(candidatesStatus.getStatus());
@@ -209,7 +213,7 @@ BalancerChunkSelectionPolicyImpl::selectSpecificChunkToMove(OperationContext* tx
     ShardToChunksMap shardToChunksMap = std::move(std::get<0>(collInfo));
 
     DistributionStatus distStatus(shardStatsStatus.getValue(), shardToChunksMap);
-    const ShardId newShardId(distStatus.getBestReceieverShard(tagForChunkStatus.getValue()));
+    const ShardId newShardId(distStatus.getBestReceieverShard(tagForChunkStatus.getValue(), {}));
     if (!newShardId.isValid() || newShardId == chunk.getShard()) {
         return boost::optional<MigrateInfo>();
     }
@@ -295,7 +299,8 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::_getMigrateCandi
     OperationContext* txn,
     const NamespaceString& nss,
     const ShardStatisticsVector& shardStats,
-    bool aggressiveBalanceHint) {
+    bool aggressiveBalanceHint,
+    std::set<ShardId>* usedShards) {
     auto scopedCMStatus = ScopedChunkManager::getExisting(txn, nss);
     if (!scopedCMStatus.isOK()) {
         return scopedCMStatus.getStatus();
@@ -350,7 +355,7 @@ StatusWith<MigrateInfoVector> BalancerChunkSelectionPolicyImpl::_getMigrateCandi
         }
     }
 
-    return BalancerPolicy::balance(nss.ns(), distStatus, aggressiveBalanceHint);
+    return BalancerPolicy::balance(nss.ns(), distStatus, aggressiveBalanceHint, usedShards);
 }
 
 }  // namespace mongo
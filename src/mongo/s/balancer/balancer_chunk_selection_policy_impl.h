@@ -61,13 +61,15 @@ private:
 
     /**
      * Synchronous method, which iterates the collection's chunks and uses the cluster statistics to
-     * figure out where to place them.
+     * figure out where to place them. Skips the shards in usedShards and adds the ones used by the
+     * returned migrations to it.
      */
     StatusWith<MigrateInfoVector> _getMigrateCandidatesForCollection(
         OperationContext* txn,
         const NamespaceString& nss,
         const ShardStatisticsVector& shardStats,
-        bool aggressiveBalanceHint);
+        bool aggressiveBalanceHint,
+        std::set<ShardId>* usedShards);
 
     // Source for obtaining cluster statistics
     std::unique_ptr<ClusterStatistics> _clusterStats;
@@ -36,6 +36,7 @@
 
 #include "mongo/client/read_preference.h"
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/catalog/sharding_catalog_client.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/catalog/type_tags.h"
@@ -55,6 +56,89 @@ using std::set;
 using std::string;
 using std::vector;
 
+namespace {
+
+// A shard is considered overloaded by a collection if it serves this many times the operations per
+// second on it as the least loaded shard.
+MONGO_EXPORT_SERVER_PARAMETER(balancerLoadImbalanceRatio, double, 2.0);
+
+// Differences in operations per second smaller than this are not worth a migration.
+MONGO_EXPORT_SERVER_PARAMETER(balancerMinLoadImbalanceOpsPerSec, int, 1000);
+
+/**
+ * Schedules the migration of a chunk with tag 'tag' from the shard which serves the most operations
+ * on 'ns' to the one which serves the fewest, among those not in 'usedShards', if that evens out
+ * their load. Assumes the operations are spread evenly over the donor's chunks, so a migration is
+ * only worth its cost if moving one chunk's share of them leaves the donor at least as loaded as
+ * the recipient. Migrations which would put the chunk counts out of 'threshold' are not scheduled
+ * either, since they would just be undone by the next balancing round.
+ */
+void balanceByLoad(const string& ns,
+                   const DistributionStatus& distribution,
+                   const string& tag,
+                   int threshold,
+                   set<ShardId>* usedShards,
+                   vector<MigrateInfo>* migrations) {
+    const ClusterStatistics::ShardStatistics* donor = nullptr;
+    const ClusterStatistics::ShardStatistics* recipient = nullptr;
+
+    for (const auto& stat : distribution.getStats()) {
+        if (usedShards->count(stat.shardId)) {
+            continue;
+        }
+
+        const double load = stat.getCollectionOpsPerSecond(ns);
+        if (!stat.isDraining && distribution.numberOfChunksInShardWithTag(stat.shardId, tag) &&
+            (!donor || load > donor->getCollectionOpsPerSecond(ns))) {
+            donor = &stat;
+        }
+
+        if (DistributionStatus::isShardSuitableReceiver(stat, tag).isOK() &&
+            (!recipient || load < recipient->getCollectionOpsPerSecond(ns))) {
+            recipient = &stat;
+        }
+    }
+
+    if (!donor || !recipient || donor == recipient) {
+        return;
+    }
+
+    const double donorLoad = donor->getCollectionOpsPerSecond(ns);
+    const double recipientLoad = recipient->getCollectionOpsPerSecond(ns);
+    if (donorLoad - recipientLoad < balancerMinLoadImbalanceOpsPerSec.load() ||
+        donorLoad < balancerLoadImbalanceRatio.load() * recipientLoad) {
+        return;
+    }
+
+    const unsigned donorChunks = distribution.numberOfChunksInShardWithTag(donor->shardId, tag);
+    const unsigned recipientChunks =
+        distribution.numberOfChunksInShardWithTag(recipient->shardId, tag);
+    if (donorLoad / donorChunks > (donorLoad - recipientLoad) / 2) {
+        return;
+    }
+
+    if (static_cast<int>(recipientChunks + 1) - static_cast<int>(donorChunks - 1) >= threshold) {
+        return;
+    }
+
+    for (const auto& chunk : distribution.getChunks(donor->shardId)) {
+        if (chunk.getJumbo() || distribution.getTagForChunk(chunk) != tag) {
+            continue;
+        }
+
+        log() << " ns: " << ns << " going to move " << chunk << " from: " << donor->shardId
+              << " (" << donorLoad << " ops/sec) to: " << recipient->shardId << " ("
+              << recipientLoad << " ops/sec) tag [" << tag << "] to even out load";
+
+        migrations->emplace_back(ns, recipient->shardId, chunk);
+        usedShards->insert(donor->shardId);
+        usedShards->insert(recipient->shardId);
+        return;
+    }
+}
+
+}  // namespace
+
 DistributionStatus::DistributionStatus(ShardStatisticsVector shardInfo,
                                        const ShardToChunksMap& shardToChunksMap)
     : _shardInfo(std::move(shardInfo)), _shardChunks(shardToChunksMap) {}
@@ -118,11 +202,15 @@ Status DistributionStatus::isShardSuitableReceiver(const ClusterStatistics::Shar
     return Status::OK();
 }
 
-ShardId DistributionStatus::getBestReceieverShard(const string& tag) const {
+ShardId DistributionStatus::getBestReceieverShard(const string& tag,
+                                                  const set<ShardId>& excludedShards) const {
     ShardId best;
     unsigned minChunks = numeric_limits<unsigned>::max();
 
     for (const auto& stat : _shardInfo) {
+        if (excludedShards.count(stat.shardId))
+            continue;
+
         auto status = isShardSuitableReceiver(stat, tag);
         if (!status.isOK()) {
             LOG(1) << status.codeString();
@@ -143,11 +231,15 @@ ShardId DistributionStatus::getBestReceieverShard(const string& tag) const {
     return best;
 }
 
-ShardId DistributionStatus::getMostOverloadedShard(const string& tag) const {
+ShardId DistributionStatus::getMostOverloadedShard(const string& tag,
+                                                   const set<ShardId>& excludedShards) const {
     ShardId worst;
     unsigned maxChunks = 0;
 
     for (const auto& stat : _shardInfo) {
+        if (excludedShards.count(stat.shardId))
+            continue;
+
         unsigned myChunks = numberOfChunksInShardWithTag(stat.shardId, tag);
         if (myChunks <= maxChunks)
             continue;
@@ -216,11 +308,17 @@ string DistributionStatus::getTagForChunk(const ChunkType& chunk) const {
 
 std::vector<MigrateInfo> BalancerPolicy::balance(const string& ns,
                                                  const DistributionStatus& distribution,
-                                                 bool shouldAggressivelyBalance) {
+                                                 bool shouldAggressivelyBalance,
+                                                 set<ShardId>* usedShards) {
+    // Each shard takes part in at most one migration, so that all the returned migrations can run
+    // concurrently without competing for the same donor or recipient.
+    vector<MigrateInfo> migrations;
+
     // 1) check for shards that policy require to us to move off of:
     //    draining only
     // 2) check tag policy violations
     // 3) then we make sure chunks are balanced for each tag
+    // 4) and finally that no shard serves a disproportionate share of the operations
 
     // ----
 
@@ -230,6 +328,9 @@ std::vector<MigrateInfo> BalancerPolicy::balance(const string& ns,
             if (!stat.isDraining)
                 continue;
 
+            if (usedShards->count(stat.shardId))
+                continue;
+
             if (distribution.numberOfChunksInShard(stat.shardId) == 0)
                 continue;
 
@@ -237,6 +338,7 @@ std::vector<MigrateInfo> BalancerPolicy::balance(const string& ns,
             // tags policy
             const vector<ChunkType>& chunks = distribution.getChunks(stat.shardId);
             unsigned numJumboChunks = 0;
+            bool foundChunkToMove = false;
 
             // Since we have to move all chunks, lets just do in order
             for (unsigned i = 0; i < chunks.size(); i++) {
@@ -248,7 +350,7 @@ std::vector<MigrateInfo> BalancerPolicy::balance(const string& ns,
 
                 const string tag = distribution.getTagForChunk(chunkToMove);
 
-                const ShardId to = distribution.getBestReceieverShard(tag);
+                const ShardId to = distribution.getBestReceieverShard(tag, *usedShards);
                 if (!to.isValid()) {
                     warning() << "want to move chunk: " << chunkToMove << " (" << tag << ") from "
                               << stat.shardId << " but can't find anywhere to put it";
@@ -258,18 +360,27 @@ std::vector<MigrateInfo> BalancerPolicy::balance(const string& ns,
                 log() << "going to move " << chunkToMove << " from " << stat.shardId << " (" << tag
                       << ") to " << to;
 
-                return {MigrateInfo(ns, to, chunkToMove)};
+                migrations.emplace_back(ns, to, chunkToMove);
+                usedShards->insert(stat.shardId);
+                usedShards->insert(to);
+                foundChunkToMove = true;
+                break;
             }
 
-            warning() << "can't find any chunk to move from: " << stat.shardId
-                      << " but we want to. "
-                      << " numJumboChunks: " << numJumboChunks;
+            if (!foundChunkToMove) {
+                warning() << "can't find any chunk to move from: " << stat.shardId
+                          << " but we want to. "
+                          << " numJumboChunks: " << numJumboChunks;
+            }
         }
     }
 
     // 2) tag violations
     if (!distribution.tags().empty()) {
         for (const auto& stat : distribution.getStats()) {
+            if (usedShards->count(stat.shardId))
+                continue;
+
             const vector<ChunkType>& chunks = distribution.getChunks(stat.shardId);
             for (unsigned j = 0; j < chunks.size(); j++) {
                 const ChunkType& chunk = chunks[j];
@@ -286,7 +397,7 @@ std::vector<MigrateInfo> BalancerPolicy::balance(const string& ns,
                     continue;
                 }
 
-                const ShardId to = distribution.getBestReceieverShard(tag);
+                const ShardId to = distribution.getBestReceieverShard(tag, *usedShards);
                 if (!to.isValid()) {
                     log() << "no where to put it :(";
                     continue;
@@ -294,7 +405,11 @@ std::vector<MigrateInfo> BalancerPolicy::balance(const string& ns,
 
                 invariant(to != stat.shardId);
                 log() << " going to move to: " << to;
-                return {MigrateInfo(ns, to, chunk)};
+
+                migrations.emplace_back(ns, to, chunk);
+                usedShards->insert(stat.shardId);
+                usedShards->insert(to);
+                break;
             }
         }
     }
@@ -321,63 +436,83 @@ std::vector<MigrateInfo> BalancerPolicy::balance(const string& ns,
     }
 
     for (const auto& tag : tags) {
-        const ShardId from = distribution.getMostOverloadedShard(tag);
-        if (!from.isValid()) {
-            continue;
-        }
-
-        unsigned max = distribution.numberOfChunksInShardWithTag(from, tag);
-        if (max == 0)
-            continue;
+        // Keep pairing the most overloaded and the least loaded of the shards, which are not
+        // already busy, until they are within the threshold of each other
+        set<ShardId> excludedShards(*usedShards);
+
+        while (true) {
+            const ShardId from = distribution.getMostOverloadedShard(tag, excludedShards);
+            if (!from.isValid())
+                break;
+
+            unsigned max = distribution.numberOfChunksInShardWithTag(from, tag);
+            if (max == 0)
+                break;
+
+            ShardId to = distribution.getBestReceieverShard(tag, excludedShards);
+            if (!to.isValid()) {
+                if (migrations.empty()) {
+                    log() << "no available shards to take chunks for tag [" << tag << "]";
+                }
+                return migrations;
+            }
 
-        ShardId to = distribution.getBestReceieverShard(tag);
-        if (!to.isValid()) {
-            log() << "no available shards to take chunks for tag [" << tag << "]";
-            return vector<MigrateInfo>();
-        }
+            unsigned min = distribution.numberOfChunksInShardWithTag(to, tag);
 
-        unsigned min = distribution.numberOfChunksInShardWithTag(to, tag);
+            const int imbalance = max - min;
 
-        const int imbalance = max - min;
+            LOG(1) << "collection : " << ns;
+            LOG(1) << "donor      : " << from << " chunks on " << max;
+            LOG(1) << "receiver   : " << to << " chunks on " << min;
+            LOG(1) << "threshold  : " << threshold;
 
-        LOG(1) << "collection : " << ns;
-        LOG(1) << "donor      : " << from << " chunks on " << max;
-        LOG(1) << "receiver   : " << to << " chunks on " << min;
-        LOG(1) << "threshold  : " << threshold;
+            if (imbalance < threshold)
+                break;
 
-        if (imbalance < threshold)
-            continue;
+            // The donor is not considered again for this tag, whether or not it has a movable
+            // chunk, so that the next most overloaded shard gets a turn
+            excludedShards.insert(from);
 
-        const vector<ChunkType>& chunks = distribution.getChunks(from);
-        unsigned numJumboChunks = 0;
-        for (unsigned j = 0; j < chunks.size(); j++) {
-            const ChunkType& chunk = chunks[j];
-            if (distribution.getTagForChunk(chunk) != tag)
-                continue;
+            const vector<ChunkType>& chunks = distribution.getChunks(from);
+            unsigned numJumboChunks = 0;
+            bool foundChunkToMove = false;
+            for (unsigned j = 0; j < chunks.size(); j++) {
+                const ChunkType& chunk = chunks[j];
+                if (distribution.getTagForChunk(chunk) != tag)
+                    continue;
 
-            if (chunk.getJumbo()) {
-                numJumboChunks++;
-                continue;
-            }
+                if (chunk.getJumbo()) {
+                    numJumboChunks++;
+                    continue;
+                }
 
-            log() << " ns: " << ns << " going to move " << chunk << " from: " << from
-                  << " to: " << to << " tag [" << tag << "]";
+                log() << " ns: " << ns << " going to move " << chunk << " from: " << from
+                      << " to: " << to << " tag [" << tag << "]";
 
-            return {MigrateInfo(ns, to, chunk)};
-        }
+                migrations.emplace_back(ns, to, chunk);
+                usedShards->insert(from);
+                usedShards->insert(to);
+                excludedShards.insert(to);
+                foundChunkToMove = true;
+                break;
+            }
 
-        if (numJumboChunks) {
-            error() << "shard: " << from << " ns: " << ns
-                    << " has too many chunks, but they are all jumbo "
-                    << " numJumboChunks: " << numJumboChunks;
-            continue;
+            if (!foundChunkToMove) {
+                invariant(numJumboChunks);
+                error() << "shard: " << from << " ns: " << ns
+                        << " has too many chunks, but they are all jumbo "
+                        << " numJumboChunks: " << numJumboChunks;
+            }
         }
+    }
 
-        MONGO_UNREACHABLE;
+    // 4) for each tag, even out the operations served by the shards which are still idle
+    for (const auto& tag : tags) {
+        balanceByLoad(ns, distribution, tag, threshold, usedShards, &migrations);
     }
 
-    // Everything is balanced here!
-    return vector<MigrateInfo>();
+    // Everything is balanced here, or as balanced as the busy shards allow
+    return migrations;
 }
 
 string TagRange::toString() const {
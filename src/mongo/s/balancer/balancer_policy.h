@@ -93,15 +93,20 @@ public:
 
     /**
      * @param forTag "" if you don't care, or a tag
+     * @param excludedShards shards which must not be considered, such as the ones which already
+     *        participate in a migration
      * @return shard best suited to receive a chunk
      */
-    ShardId getBestReceieverShard(const std::string& tag) const;
+    ShardId getBestReceieverShard(const std::string& tag,
+                                  const std::set<ShardId>& excludedShards) const;
 
     /**
+     * @param excludedShards shards which must not be considered
      * @return the shard with the most chunks
      *         based on # of chunks with the given tag
      */
-    ShardId getMostOverloadedShard(const std::string& forTag) const;
+    ShardId getMostOverloadedShard(const std::string& forTag,
+                                   const std::set<ShardId>& excludedShards) const;
 
     /** @return total number of chunks  */
     unsigned totalChunks() const;
@@ -146,13 +151,25 @@ public:
      * shouldAggressivelyBalance indicates that the last round successfully moved chunks around and
      * causes the threshold for chunk number disparity between shards to be lowered.
      *
+     * usedShards contains the shards which already participate in a migration, for example one
+     * selected for another collection in the same round. No shard is used by more than one of the
+     * returned migrations and every shard they use is added to usedShards.
+     *
      * Returns vector of MigrateInfos of the best moves to make towards balacing the specified
      * collection. The entries in the vector do not need to be done serially and can be scheduled in
      * parallel.
      */
     static std::vector<MigrateInfo> balance(const std::string& ns,
                                             const DistributionStatus& distribution,
-                                            bool shouldAggressivelyBalance);
+                                            bool shouldAggressivelyBalance,
+                                            std::set<ShardId>* usedShards);
+
+    static std::vector<MigrateInfo> balance(const std::string& ns,
+                                            const DistributionStatus& distribution,
+                                            bool shouldAggressivelyBalance) {
+        std::set<ShardId> usedShards;
+        return balance(ns, distribution, shouldAggressivelyBalance, &usedShards);
+    }
 };
 
 }  // namespace mongo
@@ -51,6 +51,7 @@ const std::string emptyShardVersion = "";
 const auto kShardId0 = ShardId("shard0");
 const auto kShardId1 = ShardId("shard1");
 const auto kShardId2 = ShardId("shard2");
+const auto kShardId3 = ShardId("shard3");
 const uint64_t kNoMaxSize = 0;
 
 ShardStatistics& findStat(std::vector<ShardStatistics>& stats, const ShardId& shardId) {
@@ -325,6 +326,55 @@ TEST(BalancerPolicyTests, MultipleDraining) {
     ASSERT_EQ(kShardId2, migrations[0].to);
 }
 
+TEST(BalancerPolicyTests, ParallelBalancingUsesDisjointShards) {
+    ShardToChunksMap chunks;
+    addShard(chunks, 20, false);
+    addShard(chunks, 20, false);
+    addShard(chunks, 0, false);
+    addShard(chunks, 0, true);
+
+    DistributionStatus distributionStatus(
+        {ShardStatistics(kShardId0, kNoMaxSize, 20, false, emptyTagSet, emptyShardVersion),
+         ShardStatistics(kShardId1, kNoMaxSize, 20, false, emptyTagSet, emptyShardVersion),
+         ShardStatistics(kShardId2, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion),
+         ShardStatistics(kShardId3, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion)},
+        chunks);
+
+    std::set<ShardId> usedShards;
+    const auto migrations(BalancerPolicy::balance("ns", distributionStatus, false, &usedShards));
+    ASSERT_EQ(2U, migrations.size());
+
+    ASSERT_EQ(kShardId0, migrations[0].from);
+    ASSERT_EQ(kShardId2, migrations[0].to);
+    ASSERT_EQ(kShardId1, migrations[1].from);
+    ASSERT_EQ(kShardId3, migrations[1].to);
+
+    ASSERT_EQ(4U, usedShards.size());
+
+    // All shards are busy, so nothing else can be scheduled in this round
+    ASSERT(BalancerPolicy::balance("ns", distributionStatus, false, &usedShards).empty());
+}
+
+TEST(BalancerPolicyTests, ParallelBalancingSkipsUsedShards) {
+    ShardToChunksMap chunks;
+    addShard(chunks, 20, false);
+    addShard(chunks, 20, false);
+    addShard(chunks, 0, true);
+
+    DistributionStatus distributionStatus(
+        {ShardStatistics(kShardId0, kNoMaxSize, 20, false, emptyTagSet, emptyShardVersion),
+         ShardStatistics(kShardId1, kNoMaxSize, 20, false, emptyTagSet, emptyShardVersion),
+         ShardStatistics(kShardId2, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion)},
+        chunks);
+
+    // The most overloaded shard is busy with another collection's migration
+    std::set<ShardId> usedShards{kShardId0};
+    const auto migrations(BalancerPolicy::balance("ns", distributionStatus, false, &usedShards));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQ(kShardId1, migrations[0].from);
+    ASSERT_EQ(kShardId2, migrations[0].to);
+}
+
 TEST(BalancerPolicyTests, TagsDraining) {
     ShardToChunksMap chunks;
     addShard(chunks, 5, false);
@@ -495,6 +545,76 @@ TEST(BalancerPolicyTests, MaxSizeNoDrain) {
     ASSERT(migrations.empty());
 }
 
+ShardStatistics makeLoadedShardStat(const ShardId& shardId, double opsPerSecond) {
+    ShardStatistics stat(shardId, kNoMaxSize, 0, false, emptyTagSet, emptyShardVersion);
+    stat.collectionOpsPerSecond["ns"] = opsPerSecond;
+    stat.opsPerSecond = opsPerSecond;
+    return stat;
+}
+
+TEST(BalancerPolicyTests, LoadImbalance) {
+    ShardToChunksMap chunks;
+    addShard(chunks, 5, false);
+    addShard(chunks, 4, true);
+
+    // The chunk counts are within the threshold, but shard0 serves most of the operations
+    DistributionStatus distributionStatus(
+        {makeLoadedShardStat(kShardId0, 10000), makeLoadedShardStat(kShardId1, 100)}, chunks);
+
+    const auto migrations(BalancerPolicy::balance("ns", distributionStatus, false));
+    ASSERT_EQ(1U, migrations.size());
+    ASSERT_EQUALS(kShardId0, migrations[0].from);
+    ASSERT_EQUALS(kShardId1, migrations[0].to);
+}
+
+TEST(BalancerPolicyTests, LoadImbalanceOtherCollection) {
+    ShardToChunksMap chunks;
+    addShard(chunks, 5, false);
+    addShard(chunks, 4, true);
+
+    // The operations are on some other collection, so moving chunks of this one doesn't help
+    DistributionStatus distributionStatus(
+        {makeLoadedShardStat(kShardId0, 10000), makeLoadedShardStat(kShardId1, 100)}, chunks);
+
+    ASSERT(BalancerPolicy::balance("otherns", distributionStatus, false).empty());
+}
+
+TEST(BalancerPolicyTests, LoadImbalanceTooSmall) {
+    ShardToChunksMap chunks;
+    addShard(chunks, 5, false);
+    addShard(chunks, 4, true);
+
+    // The load differs by a large factor, but not by enough operations to justify a migration
+    DistributionStatus distributionStatus(
+        {makeLoadedShardStat(kShardId0, 500), makeLoadedShardStat(kShardId1, 10)}, chunks);
+
+    ASSERT(BalancerPolicy::balance("ns", distributionStatus, false).empty());
+}
+
+TEST(BalancerPolicyTests, LoadImbalanceSingleChunk) {
+    ShardToChunksMap chunks;
+    addShard(chunks, 1, false);
+    addShard(chunks, 1, true);
+
+    // Moving the only chunk of the loaded shard would just move the load along with it
+    DistributionStatus distributionStatus(
+        {makeLoadedShardStat(kShardId0, 10000), makeLoadedShardStat(kShardId1, 0)}, chunks);
+
+    ASSERT(BalancerPolicy::balance("ns", distributionStatus, false).empty());
+}
+
+TEST(BalancerPolicyTests, LoadImbalanceRespectsChunkCounts) {
+    ShardToChunksMap chunks;
+    addShard(chunks, 4, false);
+    addShard(chunks, 4, true);
+
+    // Moving a chunk would put the chunk counts out of balance and be undone by the next round
+    DistributionStatus distributionStatus(
+        {makeLoadedShardStat(kShardId0, 10000), makeLoadedShardStat(kShardId1, 100)}, chunks);
+
+    ASSERT(BalancerPolicy::balance("ns", distributionStatus, false).empty());
+}
+
 /**
  * Idea behind this test is that we set up several shards, the first two of which are draining and
  * the second two of which have a data size limit.  We also simulate a random number of chunks on
@@ -62,6 +62,15 @@ bool ClusterStatistics::ShardStatistics::isSizeMaxed() const {
     return currSizeMB >= maxSizeMB;
 }
 
+double ClusterStatistics::ShardStatistics::getCollectionOpsPerSecond(const std::string& ns) const {
+    auto it = collectionOpsPerSecond.find(ns);
+    if (it == collectionOpsPerSecond.end()) {
+        return 0;
+    }
+
+    return it->second;
+}
+
 BSONObj ClusterStatistics::ShardStatistics::toBSON() const {
     BSONObjBuilder builder;
     builder.append("id", shardId.toString());
@@ -74,6 +83,7 @@ BSONObj ClusterStatistics::ShardStatistics::toBSON() const {
     }
 
     builder.append("version", mongoVersion);
+    builder.append("opsPerSecond", opsPerSecond);
     return builder.obj();
 }
 
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <map>
 #include <memory>
 #include <set>
 #include <string>
@@ -71,6 +72,12 @@ public:
          */
         bool isSizeMaxed() const;
 
+        /**
+         * Returns the operations per second served by this shard for the collection 'ns', or zero
+         * if none were reported.
+         */
+        double getCollectionOpsPerSecond(const std::string& ns) const;
+
         /**
          * Returns BSON representation of this shard's statistics, for reporting purposes.
          */
@@ -93,6 +100,14 @@ public:
 
         // Version of mongod, which runs on this shard's primary
         std::string mongoVersion;
+
+        // Operations per second served by this shard's primary for each of its collections, keyed
+        // by namespace and averaged since the previous statistics refresh. Empty if the shard did
+        // not report them.
+        std::map<std::string, double> collectionOpsPerSecond;
+
+        // Operations per second served by this shard's primary over all of its collections
+        double opsPerSecond{0};
     };
 
     virtual ~ClusterStatistics();
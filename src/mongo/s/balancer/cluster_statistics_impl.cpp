@@ -90,6 +90,53 @@ StatusWith<string> retrieveShardMongoDVersion(OperationContext* txn, ShardId sha
     return version;
 }
 
+/**
+ * Executes the top command against the specified shard and obtains the number of operations its
+ * primary has run against each collection since it started.
+ *
+ * Returns a map from namespace to operation count or an error. Known error codes are:
+ *  ShardNotFound if shard by that id is not available on the registry
+ *  NoSuchKey if the totals could not be retrieved
+ */
+StatusWith<std::map<string, long long>> retrieveShardCollectionOpCounts(OperationContext* txn,
+                                                                       ShardId shardId) {
+    auto shardRegistry = Grid::get(txn)->shardRegistry();
+    auto shard = shardRegistry->getShard(txn, shardId);
+    if (!shard) {
+        return {ErrorCodes::ShardNotFound, str::stream() << "shard " << shardId << " not found"};
+    }
+
+    auto commandResponse = shard->runCommand(txn,
+                                             ReadPreferenceSetting{ReadPreference::PrimaryOnly},
+                                             "admin",
+                                             BSON("top" << 1),
+                                             Shard::RetryPolicy::kIdempotent);
+    if (!commandResponse.isOK()) {
+        return commandResponse.getStatus();
+    }
+    if (!commandResponse.getValue().commandStatus.isOK()) {
+        return commandResponse.getValue().commandStatus;
+    }
+
+    BSONElement totalsElem;
+    Status status =
+        bsonExtractTypedField(commandResponse.getValue().response, "totals", Object, &totalsElem);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    std::map<string, long long> opCounts;
+    for (const BSONElement& nsElem : totalsElem.Obj()) {
+        if (nsElem.type() != Object) {
+            continue;
+        }
+
+        opCounts[nsElem.fieldName()] = nsElem.Obj()["total"]["count"].safeNumberLong();
+    }
+
+    return opCounts;
+}
+
 }  // namespace
 
 using ShardStatistics = ClusterStatistics::ShardStatistics;
@@ -150,9 +197,48 @@ void ClusterStatisticsImpl::_refreshShardStats(OperationContext* txn) {
                                      shardTags,
                                      mongoDVersion);
 
+        // Shards which cannot report their operation counts are balanced by chunk count only
+        auto opCountsStatus = retrieveShardCollectionOpCounts(txn, shard.getName());
+
         stdx::lock_guard<stdx::mutex> scopedLock(_mutex);
+        if (opCountsStatus.isOK()) {
+            _updateOpRates_inlock(
+                shard.getName(), std::move(opCountsStatus.getValue()), &newShardStat);
+        }
+
         _shardStatsMap[shard.getName()] = std::move(newShardStat);
     }
 }
 
+void ClusterStatisticsImpl::_updateOpRates_inlock(const ShardId& shardId,
+                                                  std::map<string, long long> opCounts,
+                                                  ShardStatistics* stat) {
+    const Date_t now = Date_t::now();
+
+    auto it = _opCountSamples.find(shardId);
+    if (it != _opCountSamples.end()) {
+        const double elapsedSecs = durationCount<Milliseconds>(now - it->second.time) / 1000.0;
+        if (elapsedSecs > 0) {
+            for (const auto& opCount : opCounts) {
+                auto prevIt = it->second.opCounts.find(opCount.first);
+                const long long prevCount =
+                    (prevIt == it->second.opCounts.end()) ? 0 : prevIt->second;
+
+                // The counts start over when the shard's primary restarts or changes
+                if (opCount.second < prevCount) {
+                    continue;
+                }
+
+                const double rate = (opCount.second - prevCount) / elapsedSecs;
+                stat->collectionOpsPerSecond[opCount.first] = rate;
+                stat->opsPerSecond += rate;
+            }
+        }
+    }
+
+    OpCountSample& sample = _opCountSamples[shardId];
+    sample.time = now;
+    sample.opCounts = std::move(opCounts);
+}
+
 }  // namespace mongo
@@ -29,9 +29,11 @@
 #pragma once
 
 #include <map>
+#include <string>
 
 #include "mongo/s/balancer/cluster_statistics.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -40,7 +42,8 @@ class Status;
 
 /**
  * Default implementation for the cluster statistics gathering utility. Uses a blocking method to
- * fetch the statistics and does not perform any caching.
+ * fetch the statistics and does not perform any caching, other than remembering the operation
+ * counts of each shard in order to compute its operation rates.
  */
 class ClusterStatisticsImpl final : public ClusterStatistics {
 public:
@@ -61,11 +64,28 @@ private:
      */
     void _refreshShardStats(OperationContext* txn);
 
+    /**
+     * Computes the operation rates of 'stat' from the per-collection operation counts 'opCounts'
+     * just reported by shard 'shardId' and those of its previous report, if any, and remembers
+     * 'opCounts' for the next refresh.
+     */
+    void _updateOpRates_inlock(const ShardId& shardId,
+                               std::map<std::string, long long> opCounts,
+                               ShardStatistics* stat);
+
     // Mutex to protect the mutable state below
     stdx::mutex _mutex;
 
     // The most up-to-date shard statistics
     ShardStatisticsMap _shardStatsMap;
+
+    // The operation counts each shard reported at the previous refresh, from which its operation
+    // rates are computed
+    struct OpCountSample {
+        Date_t time;
+        std::map<std::string, long long> opCounts;
+    };
+    std::map<ShardId, OpCountSample> _opCountSamples;
 };
 
 }  // namespace mongo
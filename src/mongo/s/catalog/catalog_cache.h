@@ -67,6 +67,12 @@ public:
     StatusWith<std::shared_ptr<DBConfig>> getDatabase(OperationContext* txn,
                                                       const std::string& dbName);
 
+    /**
+     * Returns the cached metadata for the specified database, or nullptr if it isn't cached. Never
+     * loads the database from the persistent store.
+     */
+    std::shared_ptr<DBConfig> getDatabaseIfCached(const std::string& dbName);
+
     /**
      * Removes the database information for the specified name from the cache, so that the
      * next time getDatabase is called, it will be reloaded.
@@ -290,7 +290,14 @@ StatusWith<DistLockManager::ScopedDistLock> ReplSetDistLockManager::lockWithSess
     // the lock is currently taken, we will back off and try the acquisition again, repeating this
     // until the lockTryInterval has been reached. If a network error occurs at each lock
     // acquisition attempt, the lock acquisition will be retried immediately.
+    const Date_t deadline = Date_t::now() + waitFor;
     while (waitFor <= Milliseconds::zero() || Milliseconds(timer.millis()) < waitFor) {
+        // Another thread of this process holding the lock is sure to make the attempt fail, so
+        // wait for it in memory rather than on the config server.
+        if (!waitForLocalRelease(name, lockSessionID, waitFor, deadline)) {
+            break;
+        }
+
         const string who = str::stream() << _processID << ":" << getThreadName();
 
         auto lockExpiration = _lockExpiration;
@@ -315,6 +322,7 @@ StatusWith<DistLockManager::ScopedDistLock> ReplSetDistLockManager::lockWithSess
             // the lock document.
             log() << "distributed lock '" << name << "' acquired for '" << whyMessage
                   << "', ts : " << lockSessionID;
+            recordLocalLock(name, lockSessionID);
             return ScopedDistLock(txn, lockSessionID, this);
         }
 
@@ -384,6 +392,7 @@ StatusWith<DistLockManager::ScopedDistLock> ReplSetDistLockManager::lockWithSess
 
                     LOG(0) << "lock '" << name << "' successfully forced";
                     LOG(0) << "distributed lock '" << name << "' acquired, ts : " << lockSessionID;
+                    recordLocalLock(name, lockSessionID);
                     return ScopedDistLock(txn, lockSessionID, this);
                 }
 
@@ -422,9 +431,56 @@ StatusWith<DistLockManager::ScopedDistLock> ReplSetDistLockManager::lockWithSess
     return {ErrorCodes::LockBusy, str::stream() << "timed out waiting for " << name};
 }
 
+bool ReplSetDistLockManager::waitForLocalRelease(StringData name,
+                                                 const OID& lockSessionID,
+                                                 Milliseconds waitFor,
+                                                 Date_t deadline) {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (true) {
+        auto it = _locksHeld.find(name.toString());
+        if (it == _locksHeld.end() || it->second == lockSessionID) {
+            return true;
+        }
+
+        if (waitFor == Milliseconds::zero()) {
+            return false;
+        }
+
+        if (waitFor < Milliseconds::zero()) {
+            _lockReleasedCV.wait(lk);
+        } else if (Date_t::now() >= deadline ||
+                   _lockReleasedCV.wait_until(lk, deadline.toSystemTimePoint()) ==
+                       stdx::cv_status::timeout) {
+            return _locksHeld.find(name.toString()) == _locksHeld.end();
+        }
+    }
+}
+
+void ReplSetDistLockManager::recordLocalLock(StringData name, const OID& lockSessionID) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _locksHeld[name.toString()] = lockSessionID;
+}
+
+void ReplSetDistLockManager::releaseLocalLocks(const OID& lockSessionID) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (auto it = _locksHeld.begin(); it != _locksHeld.end();) {
+        if (it->second == lockSessionID) {
+            it = _locksHeld.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    _lockReleasedCV.notify_all();
+}
+
 void ReplSetDistLockManager::unlock(OperationContext* txn, const DistLockHandle& lockSessionID) {
     auto unlockStatus = _catalog->unlock(txn, lockSessionID);
 
+    // Other threads of this process may try for the lock as soon as it is released here. If the
+    // unlock failed, they find it still taken on the config server and poll for it as usual.
+    releaseLocalLocks(lockSessionID);
+
     if (!unlockStatus.isOK()) {
         queueUnlock(lockSessionID);
     } else {
@@ -434,6 +490,12 @@ void ReplSetDistLockManager::unlock(OperationContext* txn, const DistLockHandle&
 }
 
 void ReplSetDistLockManager::unlockAll(OperationContext* txn, const std::string& processID) {
+    if (processID == _processID) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _locksHeld.clear();
+        _lockReleasedCV.notify_all();
+    }
+
     Status status = _catalog->unlockAll(txn, processID);
     if (!status.isOK()) {
         warning() << "Error while trying to unlock existing distributed locks" << causedBy(status);
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <deque>
+#include <map>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -41,6 +42,7 @@
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -94,6 +96,28 @@ private:
      */
     void queueUnlock(const DistLockHandle& lockSessionID);
 
+    /**
+     * Waits until no other session of this process holds the lock 'name'. A zero 'waitFor' does
+     * not wait, a negative one waits indefinitely and a positive one waits until 'deadline'.
+     * Returns false if the lock is still held by another session. Waiting for the holder to
+     * release the lock in memory saves polling the config server for it.
+     */
+    bool waitForLocalRelease(StringData name,
+                             const OID& lockSessionID,
+                             Milliseconds waitFor,
+                             Date_t deadline);
+
+    /**
+     * Records that this process holds the lock 'name' under 'lockSessionID'.
+     */
+    void recordLocalLock(StringData name, const OID& lockSessionID);
+
+    /**
+     * Forgets the locks this process holds under 'lockSessionID' and wakes up the threads waiting
+     * for them.
+     */
+    void releaseLocalLocks(const OID& lockSessionID);
+
     /**
      * Periodically pings and checks if there are locks queued that needs unlocking.
      */
@@ -145,5 +169,10 @@ private:
 
     // Map of lockName to last ping information.
     std::unordered_map<std::string, DistLockPingInfo> _pingHistory;  // (M)
+
+    // Map of lockName to the session under which this process holds it, and the condition
+    // signalled whenever one of those locks is released.
+    std::map<std::string, OID> _locksHeld;     // (M)
+    stdx::condition_variable _lockReleasedCV;  // (M)
 };
 }
@@ -292,6 +292,48 @@ TEST_F(ReplSetDistLockManagerFixture, BasicLockLifeCycle) {
     ASSERT_EQUALS(lockSessionIDPassed, unlockSessionIDPassed);
 }
 
+/**
+ * Test scenario:
+ * 1. Grab lock.
+ * 2. Try to grab the same lock with a different lock session id while the first is held.
+ * 3. Check that the second attempt fails without going to the config server.
+ * 4. Unlock the first and check that the lock can be grabbed again.
+ */
+TEST_F(ReplSetDistLockManagerFixture, LockHeldByThisProcessFailsWithoutGrabbing) {
+    LocksType retLockDoc;
+    retLockDoc.setName("test");
+    retLockDoc.setState(LocksType::LOCKED);
+    retLockDoc.setProcess(getProcessID());
+    retLockDoc.setWho("me");
+    retLockDoc.setWhy("why");
+    // Will be different from the actual lock session id. For testing only.
+    retLockDoc.setLockID(OID::gen());
+
+    int grabLockCallCount = 0;
+    getMockCatalog()->expectGrabLock(
+        [&grabLockCallCount](StringData, const OID&, StringData, StringData, Date_t, StringData) {
+            grabLockCallCount++;
+        },
+        retLockDoc);
+    getMockCatalog()->expectUnLock([](const OID&) {}, Status::OK());
+
+    {
+        auto lockStatus = getMgr()->lock(txn(), "test", "why", Milliseconds(0), Milliseconds(0));
+        ASSERT_OK(lockStatus.getStatus());
+
+        auto otherStatus = getMgr()->lock(txn(), "test", "why", Milliseconds(0), Milliseconds(0));
+        ASSERT_EQUALS(ErrorCodes::LockBusy, otherStatus.getStatus());
+
+        auto timedStatus = getMgr()->lock(txn(), "test", "why", Milliseconds(5), Milliseconds(1));
+        ASSERT_EQUALS(ErrorCodes::LockBusy, timedStatus.getStatus());
+        ASSERT_EQUALS(1, grabLockCallCount);
+    }
+
+    auto lockStatus = getMgr()->lock(txn(), "test", "why", Milliseconds(0), Milliseconds(0));
+    ASSERT_OK(lockStatus.getStatus());
+    ASSERT_EQUALS(2, grabLockCallCount);
+}
+
 /**
  * Test scenario:
  * 1. Grab lock fails up to 3 times.
@@ -32,6 +32,7 @@
 
 #include "mongo/s/chunk_manager.h"
 
+#include <algorithm>
 #include <iterator>
 #include <map>
 #include <set>
@@ -181,10 +182,11 @@ void ChunkManager::loadExistingRanges(OperationContext* txn, const ChunkManager*
         ChunkMap chunkMap;
         set<ShardId> shardIds;
         ShardVersionMap shardVersions;
+        boost::optional<ChunkRange> changedRange;
 
         Timer t;
 
-        bool success = _load(txn, chunkMap, shardIds, &shardVersions, oldManager);
+        bool success = _load(txn, chunkMap, shardIds, &shardVersions, oldManager, &changedRange);
         if (success) {
             log() << "ChunkManager: time to load chunks for " << _ns << ": " << t.millis() << "ms"
                   << " sequenceNumber: " << _sequenceNumber << " version: " << _version.toString()
@@ -196,7 +198,17 @@ void ChunkManager::loadExistingRanges(OperationContext* txn, const ChunkManager*
                 _chunkMap.swap(chunkMap);
                 _shardIds.swap(shardIds);
                 _shardVersions.swap(shardVersions);
-                _chunkRangeMap = _constructRanges(_chunkMap);
+
+                // Only the ranges touched by the diff need to be recomputed, which avoids walking
+                // every chunk of a large collection after each split or migration
+                if (changedRange) {
+                    _chunkRangeMap =
+                        _updateRanges(oldManager->_chunkRangeMap, _chunkMap, *changedRange);
+                } else {
+                    _chunkRangeMap = _constructRanges(_chunkMap);
+                }
+
+                _constructHashedChunkBoundaries();
                 return;
             }
         }
@@ -216,13 +228,16 @@ bool ChunkManager::_load(OperationContext* txn,
                          ChunkMap& chunkMap,
                          set<ShardId>& shardIds,
                          ShardVersionMap* shardVersions,
-                         const ChunkManager* oldManager) {
+                         const ChunkManager* oldManager,
+                         boost::optional<ChunkRange>* changedRange) {
     // Reset the max version, but not the epoch, when we aren't loading from the oldManager
     _version = ChunkVersion(0, 0, _version.epoch());
+    *changedRange = boost::none;
 
     // If we have a previous version of the ChunkManager to work from, use that info to reduce
     // our config query
-    if (oldManager && oldManager->getVersion().isSet()) {
+    const bool loadingDiff = oldManager && oldManager->getVersion().isSet();
+    if (loadingDiff) {
         // Get the old max version
         _version = oldManager->getVersion();
 
@@ -234,7 +249,8 @@ bool ChunkManager::_load(OperationContext* txn,
 
         // Could be v.expensive
         // TODO: If chunks were immutable and didn't reference the manager, we could do more
-        // interesting things here
+        // interesting things here. Since the old map is already sorted, each insert is hinted at
+        // the end of the new map so that the copy is linear in the number of chunks.
         for (const auto& oldChunkMapEntry : oldChunkMap) {
             shared_ptr<Chunk> oldC = oldChunkMapEntry.second;
             shared_ptr<Chunk> newC(new Chunk(this,
@@ -244,7 +260,7 @@ bool ChunkManager::_load(OperationContext* txn,
                                              oldC->getLastmod(),
                                              oldC->getBytesWritten()));
 
-            chunkMap.insert(make_pair(oldC->getMax(), newC));
+            chunkMap.emplace_hint(chunkMap.end(), oldC->getMax(), std::move(newC));
         }
 
         LOG(2) << "loading chunk manager for collection " << _ns
@@ -284,6 +300,21 @@ bool ChunkManager::_load(OperationContext* txn,
             }
         }
 
+        if (loadingDiff) {
+            BSONObj changedMin = chunks.front().getMin();
+            BSONObj changedMax = chunks.front().getMax();
+            for (const auto& chunk : chunks) {
+                if (chunk.getMin().woCompare(changedMin) < 0) {
+                    changedMin = chunk.getMin();
+                }
+                if (chunk.getMax().woCompare(changedMax) > 0) {
+                    changedMax = chunk.getMax();
+                }
+            }
+
+            *changedRange = ChunkRange(changedMin, changedMax);
+        }
+
         _configOpTime = opTime;
 
         return true;
@@ -446,6 +477,15 @@ Status ChunkManager::createFirstChunks(OperationContext* txn,
 
 shared_ptr<Chunk> ChunkManager::findIntersectingChunk(OperationContext* txn,
                                                       const BSONObj& shardKey) const {
+    if (!_hashedChunks.empty()) {
+        const BSONElement hashedKey = shardKey.firstElement();
+        if (hashedKey.type() == NumberLong) {
+            const auto it = std::upper_bound(
+                _hashedChunkMaxes.begin(), _hashedChunkMaxes.end(), hashedKey._numberLong());
+            return _hashedChunks[it - _hashedChunkMaxes.begin()];
+        }
+    }
+
     {
         BSONObj chunkMin;
         shared_ptr<Chunk> chunk;
@@ -714,12 +754,108 @@ ChunkManager::ChunkRangeMap ChunkManager::_constructRanges(const ChunkMap& chunk
         return chunkRangeMap;
     }
 
-    ChunkMap::const_iterator current = chunkMap.cbegin();
+    _appendRanges(chunkMap.cbegin(), chunkMap.cend(), &chunkRangeMap);
+
+    invariant(!chunkRangeMap.empty());
+    invariant(allOfType(MinKey, chunkRangeMap.begin()->second.getMin()));
+    invariant(allOfType(MaxKey, chunkRangeMap.rbegin()->first));
+
+    return chunkRangeMap;
+}
+
+ChunkManager::ChunkRangeMap ChunkManager::_updateRanges(const ChunkRangeMap& oldRangeMap,
+                                                        const ChunkMap& chunkMap,
+                                                        const ChunkRange& changedRange) {
+    if (oldRangeMap.empty() || chunkMap.empty()) {
+        return _constructRanges(chunkMap);
+    }
+
+    // The range containing the first changed key and the one before it, because the changed
+    // chunks may now merge with it
+    auto firstStale = oldRangeMap.upper_bound(changedRange.getMin());
+    invariant(firstStale != oldRangeMap.end());
+    if (firstStale != oldRangeMap.begin()) {
+        firstStale--;
+    }
+
+    // One past the range containing the last changed key and the one after it, for the same reason
+    auto lastStale = oldRangeMap.lower_bound(changedRange.getMax());
+    invariant(lastStale != oldRangeMap.end());
+    lastStale++;
+    if (lastStale != oldRangeMap.end()) {
+        lastStale++;
+    }
+
+    // The boundaries of the stale ranges are chunk boundaries in the new chunk map as well, since
+    // none of the chunks outside of the changed range have been modified
+    const auto firstChunk = chunkMap.upper_bound(firstStale->second.getMin());
+    const auto lastChunk = (lastStale == oldRangeMap.end())
+        ? chunkMap.cend()
+        : chunkMap.upper_bound(std::prev(lastStale)->first);
+
+    ChunkRangeMap chunkRangeMap(oldRangeMap.begin(), firstStale);
+    _appendRanges(firstChunk, lastChunk, &chunkRangeMap);
+
+    if (lastStale != oldRangeMap.end()) {
+        // Make sure there are no gaps between the rebuilt and the reused ranges
+        invariant(chunkRangeMap.rbegin()->first == lastStale->second.getMin());
+        chunkRangeMap.insert(lastStale, oldRangeMap.end());
+    }
+
+    invariant(!chunkRangeMap.empty());
+    invariant(allOfType(MinKey, chunkRangeMap.begin()->second.getMin()));
+    invariant(allOfType(MaxKey, chunkRangeMap.rbegin()->first));
+
+    return chunkRangeMap;
+}
+
+void ChunkManager::_constructHashedChunkBoundaries() {
+    _hashedChunkMaxes.clear();
+    _hashedChunks.clear();
+
+    if (!_keyPattern.isHashedPattern() || _chunkMap.empty()) {
+        return;
+    }
+
+    vector<long long> hashedChunkMaxes;
+    vector<shared_ptr<Chunk>> hashedChunks;
+    hashedChunkMaxes.reserve(_chunkMap.size() - 1);
+    hashedChunks.reserve(_chunkMap.size());
+
+    for (const auto& chunkMapEntry : _chunkMap) {
+        hashedChunks.push_back(chunkMapEntry.second);
+
+        const BSONElement max = chunkMapEntry.first.firstElement();
+        if (max.type() == MaxKey) {
+            // Only the last chunk may end at MaxKey
+            break;
+        }
+
+        if (max.type() != NumberLong) {
+            // Chunks which were split manually on values of another type are not covered by the
+            // fast path, so fall back to comparing the keys as BSON
+            return;
+        }
+
+        hashedChunkMaxes.push_back(max._numberLong());
+    }
+
+    invariant(hashedChunks.size() == _chunkMap.size());
+    invariant(hashedChunkMaxes.size() + 1 == hashedChunks.size());
+
+    _hashedChunkMaxes.swap(hashedChunkMaxes);
+    _hashedChunks.swap(hashedChunks);
+}
+
+void ChunkManager::_appendRanges(ChunkMap::const_iterator first,
+                                 ChunkMap::const_iterator last,
+                                 ChunkRangeMap* chunkRangeMap) {
+    ChunkMap::const_iterator current = first;
 
-    while (current != chunkMap.cend()) {
+    while (current != last) {
         const auto rangeFirst = current;
-        current = std::find_if(
-            current, chunkMap.cend(), [&rangeFirst](const ChunkMap::value_type& chunkMapEntry) {
+        current =
+            std::find_if(current, last, [&rangeFirst](const ChunkMap::value_type& chunkMapEntry) {
                 return chunkMapEntry.second->getShardId() != rangeFirst->second->getShardId();
             });
         const auto rangeLast = std::prev(current);
@@ -727,21 +863,15 @@ ChunkManager::ChunkRangeMap ChunkManager::_constructRanges(const ChunkMap& chunk
         const BSONObj rangeMin = rangeFirst->second->getMin();
         const BSONObj rangeMax = rangeLast->second->getMax();
 
-        auto insertResult = chunkRangeMap.insert(std::make_pair(
+        auto insertResult = chunkRangeMap->insert(std::make_pair(
             rangeMax, ShardAndChunkRange(rangeMin, rangeMax, rangeFirst->second->getShardId())));
         invariant(insertResult.second);
-        if (insertResult.first != chunkRangeMap.begin()) {
+        if (insertResult.first != chunkRangeMap->begin()) {
             // Make sure there are no gaps in the ranges
             insertResult.first--;
             invariant(insertResult.first->first == rangeMin);
         }
     }
-
-    invariant(!chunkRangeMap.empty());
-    invariant(allOfType(MinKey, chunkRangeMap.begin()->second.getMin()));
-    invariant(allOfType(MaxKey, chunkRangeMap.rbegin()->first));
-
-    return chunkRangeMap;
 }
 
 uint64_t ChunkManager::getCurrentDesiredChunkSize() const {
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <boost/optional.hpp>
 #include <map>
 #include <set>
 #include <string>
@@ -219,18 +220,48 @@ private:
      * If load was successful, returns true and it is guaranteed that the _chunkMap and
      * _chunkRangeMap are consistent with each other. If false is returned, it is not safe to use
      * the chunk manager anymore.
+     *
+     * If the chunks were loaded as a diff on top of 'oldManager', 'changedRange' is set to the
+     * smallest range of keys which covers all the chunks returned by the diff. Chunks outside of
+     * this range are the same as in 'oldManager'.
      */
     bool _load(OperationContext* txn,
                ChunkMap& chunks,
                std::set<ShardId>& shardIds,
                ShardVersionMap* shardVersions,
-               const ChunkManager* oldManager);
+               const ChunkManager* oldManager,
+               boost::optional<ChunkRange>* changedRange);
 
     /**
      * Merges consecutive chunks, which reside on the same shard into a single range.
      */
     static ChunkRangeMap _constructRanges(const ChunkMap& chunkMap);
 
+    /**
+     * Builds the same range map as _constructRanges(chunkMap), but reuses the entries of
+     * 'oldRangeMap', which was constructed from a chunk map that only differs from 'chunkMap'
+     * within 'changedRange'. Only the ranges overlapping 'changedRange' and their immediate
+     * neighbours are rebuilt from the chunks.
+     */
+    static ChunkRangeMap _updateRanges(const ChunkRangeMap& oldRangeMap,
+                                       const ChunkMap& chunkMap,
+                                       const ChunkRange& changedRange);
+
+    /**
+     * Fills _hashedChunkMaxes and _hashedChunks from _chunkMap if the collection is sharded on a
+     * hashed field, and clears them otherwise.
+     */
+    void _constructHashedChunkBoundaries();
+
+    /**
+     * Merges the consecutive chunks in [first, last), which reside on the same shard, and appends
+     * the resulting ranges to 'chunkRangeMap'. The chunks must start where the last range already
+     * in 'chunkRangeMap' ends.
+     */
+    static void _appendRanges(ChunkMap::const_iterator first,
+                              ChunkMap::const_iterator last,
+                              ChunkRangeMap* chunkRangeMap);
+
     // All members should be const for thread-safety
     const std::string _ns;
     const ShardKeyPattern _keyPattern;
@@ -244,6 +275,13 @@ private:
     ChunkMap _chunkMap;
     ChunkRangeMap _chunkRangeMap;
 
+    // For collections sharded on a hashed field every chunk boundary other than MinKey and MaxKey
+    // is a NumberLong. These contain the max of each chunk except the last one, and the chunks in
+    // the same order, so that targeting a hashed key is a binary search over plain integers
+    // instead of over BSON objects. Both are empty if the shard key is not hashed.
+    std::vector<long long> _hashedChunkMaxes;
+    std::vector<std::shared_ptr<Chunk>> _hashedChunks;
+
     std::set<ShardId> _shardIds;
 
     // Max known version per shard
@@ -32,6 +32,7 @@
 
 #include "mongo/s/chunk_manager_targeter.h"
 
+#include <algorithm>
 #include <boost/thread/tss.hpp>
 
 #include "mongo/s/chunk.h"
@@ -286,32 +287,43 @@ const NamespaceString& ChunkManagerTargeter::getNS() const {
     return _nss;
 }
 
+StatusWith<BSONObj> ChunkManagerTargeter::extractInsertShardKey(const BSONObj& doc) const {
+    invariant(_manager);
+
+    //
+    // Sharded collections have the following requirements for targeting:
+    //
+    // Inserts must contain the exact shard key.
+    //
+
+    BSONObj shardKey = _manager->getShardKeyPattern().extractShardKeyFromDoc(doc);
+
+    // Check shard key exists
+    if (shardKey.isEmpty()) {
+        return Status(ErrorCodes::ShardKeyNotFound,
+                      stream() << "document " << doc << " does not contain shard key for pattern "
+                               << _manager->getShardKeyPattern().toString());
+    }
+
+    // Check shard key size on insert
+    Status status = ShardKeyPattern::checkShardKeySize(shardKey);
+    if (!status.isOK())
+        return status;
+
+    return shardKey;
+}
+
 Status ChunkManagerTargeter::targetInsert(OperationContext* txn,
                                           const BSONObj& doc,
                                           ShardEndpoint** endpoint) const {
     BSONObj shardKey;
 
     if (_manager) {
-        //
-        // Sharded collections have the following requirements for targeting:
-        //
-        // Inserts must contain the exact shard key.
-        //
-
-        shardKey = _manager->getShardKeyPattern().extractShardKeyFromDoc(doc);
-
-        // Check shard key exists
-        if (shardKey.isEmpty()) {
-            return Status(ErrorCodes::ShardKeyNotFound,
-                          stream() << "document " << doc
-                                   << " does not contain shard key for pattern "
-                                   << _manager->getShardKeyPattern().toString());
-        }
+        auto swShardKey = extractInsertShardKey(doc);
+        if (!swShardKey.isOK())
+            return swShardKey.getStatus();
 
-        // Check shard key size on insert
-        Status status = ShardKeyPattern::checkShardKeySize(shardKey);
-        if (!status.isOK())
-            return status;
+        shardKey = std::move(swShardKey.getValue());
     }
 
     // Target the shard key or database primary
@@ -329,6 +341,57 @@ Status ChunkManagerTargeter::targetInsert(OperationContext* txn,
     }
 }
 
+void ChunkManagerTargeter::targetInserts(OperationContext* txn,
+                                         const vector<BSONObj>& docs,
+                                         vector<ShardEndpoint*>* endpoints,
+                                         vector<Status>* statuses) const {
+    if (!_manager) {
+        // Every document goes to the primary shard, so there is nothing to share
+        NSTargeter::targetInserts(txn, docs, endpoints, statuses);
+        return;
+    }
+
+    endpoints->assign(docs.size(), NULL);
+    statuses->assign(docs.size(), Status::OK());
+
+    vector<BSONObj> shardKeys(docs.size());
+    vector<size_t> sortedIndexes;
+    sortedIndexes.reserve(docs.size());
+
+    for (size_t i = 0; i < docs.size(); ++i) {
+        auto swShardKey = extractInsertShardKey(docs[i]);
+        if (!swShardKey.isOK()) {
+            (*statuses)[i] = swShardKey.getStatus();
+            continue;
+        }
+
+        shardKeys[i] = std::move(swShardKey.getValue());
+        sortedIndexes.push_back(i);
+    }
+
+    std::sort(sortedIndexes.begin(), sortedIndexes.end(), [&shardKeys](size_t lhs, size_t rhs) {
+        return shardKeys[lhs].woCompare(shardKeys[rhs]) < 0;
+    });
+
+    // Walk the keys in order and only search the chunk map when a key falls outside of the chunk
+    // found for the previous key
+    shared_ptr<Chunk> chunk;
+    ChunkVersion shardVersion;
+
+    for (size_t i : sortedIndexes) {
+        if (!chunk || !chunk->containsKey(shardKeys[i])) {
+            chunk = _manager->findIntersectingChunk(txn, shardKeys[i]);
+            shardVersion = _manager->getVersion(chunk->getShardId());
+        }
+
+        // Track autosplit stats for sharded collections
+        // Note: this is only best effort accounting and is not accurate.
+        _stats->chunkSizeDelta[chunk->getMin()] += docs[i].objsize();
+
+        (*endpoints)[i] = new ShardEndpoint(chunk->getShardId(), shardVersion);
+    }
+}
+
 Status ChunkManagerTargeter::targetUpdate(OperationContext* txn,
                                           const BatchedUpdateDocument& updateDoc,
                                           vector<ShardEndpoint*>* endpoints) const {
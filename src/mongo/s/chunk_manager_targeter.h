@@ -70,6 +70,13 @@ public:
     // Returns ShardKeyNotFound if document does not have a full shard key.
     Status targetInsert(OperationContext* txn, const BSONObj& doc, ShardEndpoint** endpoint) const;
 
+    // Targets the documents in shard key order, so that consecutive documents which fall into the
+    // same chunk share a single chunk lookup.
+    void targetInserts(OperationContext* txn,
+                       const std::vector<BSONObj>& docs,
+                       std::vector<ShardEndpoint*>* endpoints,
+                       std::vector<Status>* statuses) const;
+
     // Returns ShardKeyNotFound if the update can't be targeted without a shard key.
     Status targetUpdate(OperationContext* txn,
                         const BatchedUpdateDocument& updateDoc,
@@ -118,6 +125,12 @@ private:
      */
     Status refreshNow(OperationContext* txn, RefreshType refreshType);
 
+    /**
+     * Extracts the shard key of a document to be inserted into the sharded collection and checks
+     * that it is complete and not too large.
+     */
+    StatusWith<BSONObj> extractInsertShardKey(const BSONObj& doc) const;
+
     /**
      * Returns a vector of ShardEndpoints where a document might need to be placed.
      *
@@ -145,7 +145,11 @@ void DBClientMultiCommand::sendAll() {
          it != _pendingCommands.end();
          ++it) {
         PendingCommand* command = *it;
-        dassert(!command->conn);
+
+        // Skip the commands which were sent by an earlier call
+        if (command->conn || !command->status.isOK()) {
+            continue;
+        }
 
         try {
             dassert(command->endpoint.type() == ConnectionString::MASTER ||
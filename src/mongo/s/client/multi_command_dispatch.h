@@ -63,6 +63,9 @@ public:
      * without waiting for responses.  May block on full send queue (though this should be
      * rare).
      *
+     * Commands sent by an earlier call are not sent again, so commands may be added and sent
+     * while responses to the earlier ones are still outstanding.
+     *
      * Any error which occurs during sendAll will be reported on recvAny, *does not throw.*
      */
     virtual void sendAll() = 0;
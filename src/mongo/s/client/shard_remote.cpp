@@ -44,6 +44,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/query/query_request.h"
 #include "mongo/db/repl/read_concern_args.h"
+#include "mongo/db/stats/wait_event_stats.h"
 #include "mongo/executor/task_executor_pool.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/rpc/metadata/repl_set_metadata.h"
@@ -52,6 +53,7 @@
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -217,17 +219,29 @@ StatusWith<Shard::CommandResponse> ShardRemote::_runCommand(OperationContext* tx
     StatusWith<RemoteCommandResponse> swResponse =
         Status(ErrorCodes::InternalError, "Internal error running command");
 
+    // Let the targeter take the load and the latency of its hosts into account.
+    _targeter->noteRequestStarted(host.getValue());
+    Timer requestTimer;
+
     TaskExecutor* executor = Grid::get(txn)->getExecutorPool()->getFixedExecutor();
     auto callStatus = executor->scheduleRemoteCommand(
         request,
         [&swResponse](const RemoteCommandCallbackArgs& args) { swResponse = args.response; });
     if (!callStatus.isOK()) {
+        _targeter->noteRequestFinished(host.getValue(), boost::none);
         return callStatus.getStatus();
     }
 
     // Block until the command is carried out
-    executor->wait(callStatus.getValue());
+    {
+        ScopedWaitEvent wait(txn, WaitEvent::kRemoteCommand);
+        executor->wait(callStatus.getValue());
+    }
 
+    _targeter->noteRequestFinished(host.getValue(),
+                                   swResponse.isOK()
+                                       ? boost::make_optional(Microseconds(requestTimer.micros()))
+                                       : boost::none);
     updateReplSetMonitor(host.getValue(), swResponse.getStatus());
 
     if (!swResponse.isOK()) {
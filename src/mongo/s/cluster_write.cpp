@@ -46,6 +46,7 @@
 #include "mongo/s/config.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/mongos_options.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 #include "mongo/s/write_ops/batch_write_exec.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -278,6 +279,9 @@ void ClusterWriter::write(OperationContext* txn,
             exec.executeBatch(txn, *request, response, &_stats);
         }
 
+        // Invalidate after the write so that results read before it completed are not kept.
+        ClusterQueryResultCache::get(txn)->invalidate(request->getTargetingNSS());
+
         if (_autoSplit) {
             splitIfNeeded(txn, request->getNS(), targeterStats);
         }
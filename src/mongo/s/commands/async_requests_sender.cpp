@@ -0,0 +1,162 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kCommand
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/commands/async_requests_sender.h"
+
+#include "mongo/client/remote_command_targeter.h"
+#include "mongo/rpc/get_status_from_command_result.h"
+#include "mongo/rpc/metadata/server_selection_metadata.h"
+#include "mongo/s/client/shard_registry.h"
+#include "mongo/s/grid.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+AsyncRequestsSender::Request::Request(ShardId shardId, BSONObj cmdObj)
+    : shardId(std::move(shardId)), cmdObj(std::move(cmdObj)) {}
+
+AsyncRequestsSender::AsyncRequestsSender(OperationContext* txn,
+                                         executor::TaskExecutor* executor,
+                                         const std::string& db,
+                                         const std::vector<Request>& requests,
+                                         const ReadPreferenceSetting& readPref,
+                                         Milliseconds perShardTimeout)
+    : _executor(executor), _cbHandles(requests.size()), _responsesLeft(requests.size()) {
+    BSONObjBuilder metadataBuilder;
+    rpc::ServerSelectionMetadata metadata(readPref.pref != ReadPreference::PrimaryOnly,
+                                          boost::none);
+    uassertStatusOK(metadata.writeToMetadata(&metadataBuilder));
+    const BSONObj metadataObj = metadataBuilder.obj();
+
+    // Filled before any request is scheduled, since the callbacks read it without the mutex.
+    for (const auto& request : requests) {
+        _shardIds.push_back(request.shardId);
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    for (size_t i = 0; i < requests.size(); ++i) {
+        const auto& shardId = _shardIds[i];
+
+        const auto shard = grid.shardRegistry()->getShard(txn, shardId);
+        if (!shard) {
+            _readyResponses.push_back(
+                {shardId,
+                 boost::none,
+                 Status(ErrorCodes::ShardNotFound,
+                        str::stream() << "Could not find shard " << shardId)});
+            continue;
+        }
+
+        auto findHostStatus = shard->getTargeter()->findHost(
+            readPref, RemoteCommandTargeter::selectFindHostMaxWaitTime(txn));
+        if (!findHostStatus.isOK()) {
+            _readyResponses.push_back({shardId, boost::none, findHostStatus.getStatus()});
+            continue;
+        }
+
+        executor::RemoteCommandRequest request(
+            findHostStatus.getValue(), db, requests[i].cmdObj, metadataObj, perShardTimeout);
+
+        auto callbackStatus = _executor->scheduleRemoteCommand(
+            request,
+            stdx::bind(&AsyncRequestsSender::handleResponse, this, stdx::placeholders::_1, i));
+        if (!callbackStatus.isOK()) {
+            _readyResponses.push_back(
+                {shardId, findHostStatus.getValue(), callbackStatus.getStatus()});
+            continue;
+        }
+
+        _cbHandles[i] = callbackStatus.getValue();
+    }
+}
+
+AsyncRequestsSender::~AsyncRequestsSender() {
+    std::vector<executor::TaskExecutor::CallbackHandle> outstanding;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (const auto& cbHandle : _cbHandles) {
+            if (cbHandle.isValid()) {
+                outstanding.push_back(cbHandle);
+            }
+        }
+    }
+
+    // The callbacks refer to this object, so they must all have run before it goes away.
+    for (const auto& cbHandle : outstanding) {
+        _executor->cancel(cbHandle);
+    }
+    for (const auto& cbHandle : outstanding) {
+        _executor->wait(cbHandle);
+    }
+}
+
+bool AsyncRequestsSender::done() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _responsesLeft == 0;
+}
+
+AsyncRequestsSender::Response AsyncRequestsSender::next() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    invariant(_responsesLeft > 0);
+
+    _responseReady.wait(lk, [this] { return !_readyResponses.empty(); });
+
+    Response response = std::move(_readyResponses.front());
+    _readyResponses.pop_front();
+    --_responsesLeft;
+    return response;
+}
+
+void AsyncRequestsSender::handleResponse(
+    const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData, size_t index) {
+    const auto& shardId = _shardIds[index];
+    const auto& host = cbData.request.target;
+
+    // Tell the replica set monitor of any errors.
+    if (auto shard = grid.shardRegistry()->getShardNoReload(shardId)) {
+        shard->updateReplSetMonitor(host,
+                                    cbData.response.isOK()
+                                        ? getStatusFromCommandResult(cbData.response.getValue().data)
+                                        : cbData.response.getStatus());
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _cbHandles[index] = executor::TaskExecutor::CallbackHandle();
+    _readyResponses.push_back({shardId, host, cbData.response});
+    _responseReady.notify_one();
+}
+
+}  // namespace mongo
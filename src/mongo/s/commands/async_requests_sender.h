@@ -0,0 +1,149 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <deque>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/client/read_preference.h"
+#include "mongo/executor/remote_command_request.h"
+#include "mongo/executor/remote_command_response.h"
+#include "mongo/executor/task_executor.h"
+#include "mongo/s/shard_id.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/net/hostandport.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class OperationContext;
+
+/**
+ * Sends a command to each of a set of shards at once through a TaskExecutor, and hands the
+ * responses back in the order in which they arrive, so that callers can process each one while the
+ * others are still outstanding. A command scattered this way takes as long as the slowest of its
+ * shards rather than the sum of their latencies.
+ *
+ * A request which cannot be targeted or scheduled produces an error response right away. If the
+ * AsyncRequestsSender is destroyed before all of its responses have been retrieved, the outstanding
+ * requests are canceled and their callbacks waited for.
+ *
+ * next() must only be called from one thread at a time.
+ */
+class AsyncRequestsSender {
+    MONGO_DISALLOW_COPYING(AsyncRequestsSender);
+
+public:
+    /**
+     * A command to run on a shard.
+     */
+    struct Request {
+        Request(ShardId shardId, BSONObj cmdObj);
+
+        ShardId shardId;
+        BSONObj cmdObj;
+    };
+
+    /**
+     * The outcome of a Request.
+     */
+    struct Response {
+        ShardId shardId;
+
+        // The host the command was sent to, unset if no host could be targeted.
+        boost::optional<HostAndPort> shardHostAndPort;
+
+        // The response to the command, or the error which prevented one from being received. A
+        // command which ran and failed has an OK status here, its error being in the response.
+        StatusWith<executor::RemoteCommandResponse> swResponse;
+    };
+
+    /**
+     * Targets a host of each shard according to 'readPref' and schedules the requests against
+     * database 'db' on 'executor', which must outlive this object. Each request is abandoned with
+     * ErrorCodes::ExceededTimeLimit if it has not been answered within 'perShardTimeout'.
+     */
+    AsyncRequestsSender(OperationContext* txn,
+                        executor::TaskExecutor* executor,
+                        const std::string& db,
+                        const std::vector<Request>& requests,
+                        const ReadPreferenceSetting& readPref,
+                        Milliseconds perShardTimeout = executor::RemoteCommandRequest::kNoTimeout);
+
+    ~AsyncRequestsSender();
+
+    /**
+     * Returns true once next() has returned the response to every request.
+     */
+    bool done();
+
+    /**
+     * Blocks until a response which has not yet been returned is available, and returns it.
+     *
+     * Invalid to call once done() has returned true.
+     */
+    Response next();
+
+private:
+    /**
+     * Callback run by the executor with the response to the request at 'index'.
+     */
+    void handleResponse(const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData,
+                        size_t index);
+
+    // Not owned here.
+    executor::TaskExecutor* const _executor;
+
+    // The shards of the requests, by request index. Not modified once requests are scheduled.
+    std::vector<ShardId> _shardIds;
+
+    // Must be held to access the members below.
+    stdx::mutex _mutex;
+
+    // Notified whenever a response is added to '_readyResponses'.
+    stdx::condition_variable _responseReady;
+
+    // The handles of the scheduled requests, by request index. A handle is reset once its callback
+    // has run, and is invalid for a request which could not be scheduled.
+    std::vector<executor::TaskExecutor::CallbackHandle> _cbHandles;
+
+    // Responses which have arrived but have not yet been returned by next().
+    std::deque<Response> _readyResponses;
+
+    // Number of responses not yet returned by next().
+    size_t _responsesLeft;
+};
+
+}  // namespace mongo
@@ -28,10 +28,14 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/db/client.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/operation_context.h"
 #include "mongo/db/wire_version.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/write_ops/batched_command_request.h"
+#include "mongo/transport/message_compressor_manager.h"
+#include "mongo/util/net/abstract_message_port.h"
 
 namespace mongo {
 namespace {
@@ -77,6 +81,10 @@ public:
         result.append("maxWireVersion", WireSpec::instance().maxWireVersionIncoming);
         result.append("minWireVersion", WireSpec::instance().minWireVersionIncoming);
 
+        if (AbstractMessagingPort* mp = txn->getClient()->port()) {
+            mp->compressorManager().serverNegotiate(cmdObj, &result);
+        }
+
         return true;
     }
 
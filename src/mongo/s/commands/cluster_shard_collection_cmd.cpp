@@ -315,6 +315,17 @@ public:
                     return false;
                 }
 
+                // Shard keys are always hashed with hash version 0, which the index must match.
+                // Hash version 1 is only for hashed indexes that don't serve as shard keys.
+                if (isHashedShardKey && idx["hashVersion"].numberInt() != kMD5HashVersion) {
+                    errmsg = str::stream() << "can't shard collection " << nss.ns()
+                                           << " with hashed shard key " << proposedKey
+                                           << " because the hashed index uses hashVersion "
+                                           << idx["hashVersion"].numberInt();
+                    conn.done();
+                    return false;
+                }
+
                 hasUsefulIndexForKey = true;
             }
         }
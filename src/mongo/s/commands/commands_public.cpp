@@ -788,6 +788,8 @@ public:
                     // skip this field in the rollup
                 } else if (str::equals(e.fieldName(), "wiredTiger")) {
                     // skip this field in the rollup
+                } else if (str::equals(e.fieldName(), "planCache")) {
+                    // skip this field in the rollup
                 } else if (str::equals(e.fieldName(), "nindexes")) {
                     int myIndexes = e.numberInt();
 
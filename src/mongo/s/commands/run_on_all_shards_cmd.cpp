@@ -32,12 +32,16 @@
 
 #include "mongo/s/commands/run_on_all_shards_cmd.h"
 
+#include <algorithm>
 #include <list>
+#include <map>
 #include <set>
 
 #include "mongo/db/jsobj.h"
+#include "mongo/executor/task_executor_pool.h"
 #include "mongo/s/client/shard.h"
 #include "mongo/s/client/shard_registry.h"
+#include "mongo/s/commands/async_requests_sender.h"
 #include "mongo/s/commands/cluster_commands_common.h"
 #include "mongo/s/commands/sharded_command_processing.h"
 #include "mongo/s/grid.h"
@@ -71,6 +75,76 @@ void RunOnAllShardsCommand::getShardIds(OperationContext* txn,
     grid.shardRegistry()->getAllShardIds(&shardIds);
 }
 
+void RunOnAllShardsCommand::runWithShardConnections(OperationContext* txn,
+                                                    const std::string& dbName,
+                                                    const BSONObj& cmdObj,
+                                                    const std::vector<ShardId>& shardIds,
+                                                    const ResultProcessor& processResult) {
+    std::list<std::shared_ptr<Future::CommandResult>> futures;
+    std::vector<const ShardId*> futureShardIds;
+    for (const ShardId& shardId : shardIds) {
+        const auto shard = grid.shardRegistry()->getShard(txn, shardId);
+        if (!shard) {
+            continue;
+        }
+
+        futures.push_back(Future::spawnCommand(
+            shard->getConnString().toString(), dbName, cmdObj, 0, NULL, true /* useShardConn */));
+        futureShardIds.push_back(&shardId);
+    }
+
+    // The commands were all sent before the first reply is waited for.
+    size_t i = 0;
+    for (const auto& res : futures) {
+        const bool ok = res->join(txn);
+        processResult(*futureShardIds[i++], res->getServer(), ok, res->result());
+    }
+}
+
+void RunOnAllShardsCommand::runWithExecutor(OperationContext* txn,
+                                            const std::string& dbName,
+                                            const BSONObj& cmdObj,
+                                            const std::vector<ShardId>& shardIds,
+                                            const ResultProcessor& processResult) {
+    std::vector<AsyncRequestsSender::Request> requests;
+    std::map<ShardId, std::string> servers;
+    for (const ShardId& shardId : shardIds) {
+        const auto shard = grid.shardRegistry()->getShard(txn, shardId);
+        if (!shard) {
+            continue;
+        }
+
+        requests.emplace_back(shardId, cmdObj);
+        servers[shardId] = shard->getConnString().toString();
+    }
+
+    AsyncRequestsSender ars(txn,
+                            Grid::get(txn)->getExecutorPool()->getArbitraryExecutor(),
+                            dbName,
+                            requests,
+                            ReadPreferenceSetting(ReadPreference::PrimaryOnly));
+
+    // Each reply is processed as soon as it arrives, in whichever order the shards answer.
+    while (!ars.done()) {
+        auto response = ars.next();
+
+        const auto it = std::find(shardIds.begin(), shardIds.end(), response.shardId);
+        invariant(it != shardIds.end());
+        const auto& server = servers[response.shardId];
+
+        if (!response.swResponse.isOK()) {
+            BSONObjBuilder errorBuilder;
+            Command::appendCommandStatus(errorBuilder, response.swResponse.getStatus());
+            processResult(*it, server, false, errorBuilder.obj());
+            continue;
+        }
+
+        BSONObj result = response.swResponse.getValue().data.getOwned();
+        const bool ok = result["ok"].trueValue();
+        processResult(*it, server, ok, std::move(result));
+    }
+}
+
 bool RunOnAllShardsCommand::run(OperationContext* txn,
                                 const std::string& dbName,
                                 BSONObj& cmdObj,
@@ -86,78 +160,54 @@ bool RunOnAllShardsCommand::run(OperationContext* txn,
     std::vector<ShardId> shardIds;
     getShardIds(txn, dbName, cmdObj, shardIds);
 
-    std::list<std::shared_ptr<Future::CommandResult>> futures;
-    for (const ShardId& shardId : shardIds) {
-        const auto shard = grid.shardRegistry()->getShard(txn, shardId);
-        if (!shard) {
-            continue;
-        }
-
-        futures.push_back(Future::spawnCommand(
-            shard->getConnString().toString(), dbName, cmdObj, 0, NULL, _useShardConn));
-    }
-
     std::vector<ShardAndReply> results;
     BSONObjBuilder subobj(output.subobjStart("raw"));
     BSONObjBuilder errors;
     int commonErrCode = -1;
 
-    std::list<std::shared_ptr<Future::CommandResult>>::iterator futuresit;
-    std::vector<ShardId>::const_iterator shardIdsIt;
-
+    BSONObj wcErrorResult;  // owns 'wcErrorElem'
     BSONElement wcErrorElem;
     ShardId wcErrorShardId;
     bool hasWCError = false;
 
-    // We iterate over the set of shard ids and their corresponding futures in parallel.
-    // TODO: replace with zip iterator if we ever decide to use one from Boost or elsewhere
-    for (futuresit = futures.begin(), shardIdsIt = shardIds.cbegin();
-         futuresit != futures.end() && shardIdsIt != shardIds.end();
-         ++futuresit, ++shardIdsIt) {
-        std::shared_ptr<Future::CommandResult> res = *futuresit;
-
-        if (res->join(txn)) {
-            // success :)
-            BSONObj result = res->result();
-            results.emplace_back(shardIdsIt->toString(), result);
-            subobj.append(res->getServer(), result);
-
-            if (!hasWCError) {
-                if ((wcErrorElem = result["writeConcernError"])) {
-                    wcErrorShardId = *shardIdsIt;
-                    hasWCError = true;
-                }
-            }
-            continue;
-        }
-
-        BSONObj result = res->result();
-
+    // Folds the reply of one shard into the results. 'shardId' must outlive 'results'.
+    auto processResult = [&](const ShardId& shardId,
+                             const std::string& server,
+                             bool ok,
+                             BSONObj result) {
         if (!hasWCError) {
             if ((wcErrorElem = result["writeConcernError"])) {
-                wcErrorShardId = *shardIdsIt;
+                wcErrorResult = result;
+                wcErrorShardId = shardId;
                 hasWCError = true;
             }
         }
 
+        if (ok) {
+            // success :)
+            results.emplace_back(shardId.toString(), result);
+            subobj.append(server, result);
+            return;
+        }
+
         if (result["errmsg"].type() || result["code"].numberInt() != 0) {
-            result = specialErrorHandler(res->getServer(), dbName, cmdObj, result);
+            result = specialErrorHandler(server, dbName, cmdObj, result);
 
             BSONElement errmsgObj = result["errmsg"];
             if (errmsgObj.eoo() || errmsgObj.String().empty()) {
                 // it was fixed!
-                results.emplace_back(shardIdsIt->toString(), result);
-                subobj.append(res->getServer(), result);
-                continue;
+                results.emplace_back(shardId.toString(), result);
+                subobj.append(server, result);
+                return;
             }
         }
 
         // Handle "errmsg".
         if (!result["errmsg"].eoo()) {
-            errors.appendAs(result["errmsg"], res->getServer());
+            errors.appendAs(result["errmsg"], server);
         } else {
             // Can happen if message is empty, for some reason
-            errors.append(res->getServer(),
+            errors.append(server,
                           str::stream() << "result without error message returned : " << result);
         }
 
@@ -168,8 +218,14 @@ bool RunOnAllShardsCommand::run(OperationContext* txn,
         } else if (commonErrCode != errCode) {
             commonErrCode = 0;
         }
-        results.emplace_back(shardIdsIt->toString(), result);
-        subobj.append(res->getServer(), result);
+        results.emplace_back(shardId.toString(), result);
+        subobj.append(server, result);
+    };
+
+    if (_useShardConn) {
+        runWithShardConnections(txn, dbName, cmdObj, shardIds, processResult);
+    } else {
+        runWithExecutor(txn, dbName, cmdObj, shardIds, processResult);
     }
 
     subobj.done();
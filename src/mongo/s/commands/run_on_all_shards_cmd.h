@@ -33,6 +33,7 @@
 #include "mongo/base/string_data.h"
 #include "mongo/db/commands.h"
 #include "mongo/s/client/shard.h"
+#include "mongo/stdx/functional.h"
 
 namespace mongo {
 
@@ -44,7 +45,8 @@ class OperationContext;
  * Logic for commands that simply map out to all shards then fold the results into
  * a single response.
  *
- * All shards are contacted in parallel.
+ * All shards are contacted in parallel, and replies are folded in as they arrive unless the
+ * command needs ShardConnection.
  *
  * When extending, don't override run() - but rather aggregateResults(). If you need
  * to implement some kind of fall back logic for multiversion clusters,
@@ -91,7 +93,31 @@ public:
              BSONObjBuilder& output) final;
 
 private:
-    // Use ShardConnection as opposed to ScopedDbConnection
+    // Folds the reply of a shard, reached at 'server', into the command response.
+    using ResultProcessor = stdx::function<void(
+        const ShardId& shardId, const std::string& server, bool ok, BSONObj result)>;
+
+    /**
+     * Sends the command to every shard through ShardConnections, which attach the shard version,
+     * and processes the replies in the order of 'shardIds'.
+     */
+    void runWithShardConnections(OperationContext* txn,
+                                 const std::string& dbName,
+                                 const BSONObj& cmdObj,
+                                 const std::vector<ShardId>& shardIds,
+                                 const ResultProcessor& processResult);
+
+    /**
+     * Sends the command to every shard through the task executor, and processes the replies as
+     * they arrive.
+     */
+    void runWithExecutor(OperationContext* txn,
+                         const std::string& dbName,
+                         const BSONObj& cmdObj,
+                         const std::vector<ShardId>& shardIds,
+                         const ResultProcessor& processResult);
+
+    // Use ShardConnection as opposed to the task executor
     const bool _useShardConn;
 
     // Whether the requested database should be created implicitly
@@ -305,6 +305,69 @@ std::shared_ptr<ChunkManager> DBConfig::getChunkManager(OperationContext* txn,
 
     invariant(!key.isEmpty());
 
+    if (forceReload) {
+        return _refreshChunkManager(txn, ns, oldManager, oldVersion, true);
+    }
+
+    // Threads which find the chunk manager stale at the same time share a single refresh, instead
+    // of each querying the config server. A thread which joins a refresh already in progress may
+    // have seen a newer version than that refresh is going to find, so if the refresh doesn't
+    // change the chunk manager, the thread waits for or runs one more, which is sure to have
+    // started after it asked.
+    for (int attempt = 0;; attempt++) {
+        std::shared_ptr<ChunkManagerRefresh> refresh;
+        {
+            stdx::unique_lock<stdx::mutex> lk(_lock);
+
+            std::shared_ptr<ChunkManagerRefresh>& pendingRefresh = _chunkManagerRefreshes[ns];
+            if (!pendingRefresh) {
+                refresh = std::make_shared<ChunkManagerRefresh>();
+                pendingRefresh = refresh;
+            } else {
+                refresh = pendingRefresh;
+                _chunkManagerRefreshDone.wait(lk, [&refresh] { return refresh->done; });
+                uassertStatusOK(refresh->status);
+
+                const CollectionInfo& ci = _collections[ns];
+                uassert(10181, str::stream() << "not sharded:" << ns, ci.isSharded());
+
+                if (attempt > 0 || !ci.getCM()->getVersion().equals(oldVersion)) {
+                    return ci.getCM();
+                }
+
+                continue;
+            }
+        }
+
+        std::shared_ptr<ChunkManager> manager;
+        try {
+            manager = _refreshChunkManager(txn, ns, oldManager, oldVersion, false);
+        } catch (const DBException& ex) {
+            _finishChunkManagerRefresh(ns, refresh, ex.toStatus());
+            throw;
+        }
+
+        _finishChunkManagerRefresh(ns, refresh, Status::OK());
+        return manager;
+    }
+}
+
+void DBConfig::_finishChunkManagerRefresh(const std::string& ns,
+                                          const std::shared_ptr<ChunkManagerRefresh>& refresh,
+                                          Status status) {
+    stdx::lock_guard<stdx::mutex> lk(_lock);
+    refresh->done = true;
+    refresh->status = std::move(status);
+    _chunkManagerRefreshes.erase(ns);
+    _chunkManagerRefreshDone.notify_all();
+}
+
+std::shared_ptr<ChunkManager> DBConfig::_refreshChunkManager(
+    OperationContext* txn,
+    const string& ns,
+    std::shared_ptr<ChunkManager> oldManager,
+    const ChunkVersion& oldVersion,
+    bool forceReload) {
     // TODO: We need to keep this first one-chunk check in until we have a more efficient way of
     // creating/reusing a chunk manager, as doing so requires copying the full set of chunks
     // currently
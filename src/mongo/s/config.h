@@ -28,17 +28,23 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
 #include <set>
+#include <string>
 
+#include "mongo/base/status.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/s/client/shard.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/util/concurrency/mutex.h"
 
 namespace mongo {
 
 class ChunkManager;
+struct ChunkVersion;
 class CollectionType;
 class DatabaseType;
 class DBConfig;
@@ -196,6 +202,33 @@ protected:
 
     void _save(OperationContext* txn, bool db = true, bool coll = true);
 
+    /**
+     * Reloads the chunk manager of the sharded collection 'ns' from the config server, unless the
+     * config server's newest chunk shows that 'oldManager', at version 'oldVersion', is still up
+     * to date. With 'forceReload', the chunk manager is always reloaded. Returns the collection's
+     * current chunk manager.
+     */
+    std::shared_ptr<ChunkManager> _refreshChunkManager(OperationContext* txn,
+                                                       const std::string& ns,
+                                                       std::shared_ptr<ChunkManager> oldManager,
+                                                       const ChunkVersion& oldVersion,
+                                                       bool forceReload);
+
+    // A chunk manager refresh in progress, which threads that find the same chunk manager stale
+    // wait for instead of refreshing it themselves.
+    struct ChunkManagerRefresh {
+        bool done{false};
+        Status status{Status::OK()};
+    };
+
+    /**
+     * Marks 'refresh' of the chunk manager of 'ns' as done with 'status' and wakes up the threads
+     * waiting for it.
+     */
+    void _finishChunkManagerRefresh(const std::string& ns,
+                                    const std::shared_ptr<ChunkManagerRefresh>& refresh,
+                                    Status status);
+
     // All member variables are labeled with one of the following codes indicating the
     // synchronization rules for accessing them.
     //
@@ -223,6 +256,11 @@ protected:
     // OpTime of config server when the database definition was loaded.
     repl::OpTime _configOpTime;  // (L)
 
+    // Chunk manager refreshes in progress, by collection namespace, and the condition signalled
+    // whenever one is done.
+    std::map<std::string, std::shared_ptr<ChunkManagerRefresh>> _chunkManagerRefreshes;  // (L)
+    stdx::condition_variable _chunkManagerRefreshDone;
+
     // Ensures that only one thread at a time loads collection configuration data from
     // the config server
     stdx::mutex _hitConfigServerLock;
@@ -0,0 +1,234 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kSharding
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/config_change_watcher.h"
+
+#include "mongo/client/connpool.h"
+#include "mongo/client/read_preference.h"
+#include "mongo/client/remote_command_targeter.h"
+#include "mongo/db/client.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/s/catalog/catalog_cache.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/s/catalog/type_collection.h"
+#include "mongo/s/client/shard_registry.h"
+#include "mongo/s/config.h"
+#include "mongo/s/grid.h"
+#include "mongo/util/exit.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+// Whether mongos should tail the config server oplog to learn about routing metadata changes as
+// they happen
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(watchConfigChanges, bool, false);
+
+const char kOplogNs[] = "local.oplog.rs";
+
+const Seconds kRetryInterval(1);
+
+// Socket timeout for the tailing connection, which must outlast the wait of each getMore
+const double kSocketTimeoutSecs = 30;
+
+/**
+ * Returns the namespace of the collection a config.chunks document belongs to, or an empty string
+ * if the document is a partial one, such as the query of a delete, which doesn't name it.
+ */
+std::string chunkNamespace(const BSONObj& chunkDoc) {
+    BSONElement nsElem = chunkDoc[ChunkType::ns.name()];
+    return nsElem.type() == String ? nsElem.String() : std::string();
+}
+
+}  // namespace
+
+ConfigChangeWatcher::ConfigChangeWatcher() = default;
+
+ConfigChangeWatcher::~ConfigChangeWatcher() {
+    // The thread must not be running when this object is destroyed
+    invariant(!_thread.joinable());
+}
+
+void ConfigChangeWatcher::startThread() {
+    if (!watchConfigChanges) {
+        return;
+    }
+
+    invariant(!_thread.joinable());
+
+    _thread = stdx::thread([this] {
+        Client::initThread("ConfigChangeWatcher");
+
+        while (!inShutdown()) {
+            try {
+                auto txn = cc().makeOperationContext();
+                _tailOplog(txn.get());
+            } catch (const DBException& ex) {
+                log() << "Error tailing the config server oplog for metadata changes"
+                      << causedBy(ex);
+            }
+
+            sleepFor(kRetryInterval);
+        }
+    });
+}
+
+void ConfigChangeWatcher::extractChangedNamespaces(const BSONObj& oplogEntry,
+                                                   std::set<std::string>* chunksChanged,
+                                                   std::set<std::string>* collectionsChanged) {
+    const std::string ns = oplogEntry["ns"].str();
+    const BSONObj o = oplogEntry["o"].Obj();
+
+    if (ns == ChunkType::ConfigNS) {
+        // Deletes only name the chunk _id, but they are always committed along with an update of
+        // another chunk of the same collection or a change to its collection entry
+        std::string chunkNs = chunkNamespace(o);
+        if (!chunkNs.empty()) {
+            chunksChanged->insert(std::move(chunkNs));
+        }
+    } else if (ns == CollectionType::ConfigNS) {
+        // The collection entries are keyed by namespace, and updates name it in the query
+        BSONElement idElem = oplogEntry["o2"].isABSONObj() ? oplogEntry["o2"].Obj()["_id"]
+                                                           : o["_id"];
+        if (idElem.type() == String) {
+            collectionsChanged->insert(idElem.String());
+        }
+    } else if (o.firstElementFieldName() == StringData("applyOps")) {
+        for (const auto& opElem : o.firstElement().Obj()) {
+            if (opElem.isABSONObj()) {
+                extractChangedNamespaces(opElem.Obj(), chunksChanged, collectionsChanged);
+            }
+        }
+    }
+}
+
+void ConfigChangeWatcher::_tailOplog(OperationContext* txn) {
+    auto configShard = Grid::get(txn)->shardRegistry()->getConfigShard();
+    const ReadPreferenceSetting readPref(ReadPreference::PrimaryOnly, TagSet());
+    const HostAndPort host = uassertStatusOK(configShard->getTargeter()->findHost(readPref));
+
+    ScopedDbConnection conn(host.toString(), kSocketTimeoutSecs);
+
+    // Changes which happened before the watcher started are picked up by the regular refreshes
+    if (_lastSeen.isNull()) {
+        const BSONObj lastEntry = conn->findOne(
+            kOplogNs, Query().sort(BSON("$natural" << -1)), nullptr, QueryOption_SlaveOk);
+        if (lastEntry.isEmpty()) {
+            conn.done();
+            return;
+        }
+
+        _lastSeen = lastEntry["ts"].timestamp();
+    }
+
+    const BSONArray watchedNamespaces = BSON_ARRAY(ChunkType::ConfigNS << CollectionType::ConfigNS);
+    const BSONObj query =
+        BSON("ts" << BSON("$gt" << _lastSeen) << "$or"
+                  << BSON_ARRAY(BSON("ns" << BSON("$in" << watchedNamespaces))
+                                << BSON("o.applyOps.ns" << BSON("$in" << watchedNamespaces))));
+
+    LOG(1) << "Tailing metadata changes in the oplog of config server " << host << " from "
+           << _lastSeen.toString();
+
+    auto cursor = conn->query(kOplogNs,
+                              query,
+                              0,
+                              0,
+                              nullptr,
+                              QueryOption_SlaveOk | QueryOption_CursorTailable |
+                                  QueryOption_OplogReplay | QueryOption_AwaitData);
+    uassert(ErrorCodes::HostUnreachable,
+            str::stream() << "Unable to tail the oplog of config server " << host.toString(),
+            cursor);
+
+    while (!inShutdown()) {
+        if (!cursor->more()) {
+            if (cursor->isDead()) {
+                break;
+            }
+
+            continue;
+        }
+
+        // Apply each batch of changes at once, so that a chunk operation which touches many chunks
+        // of the same collection causes only one refresh of it
+        std::set<std::string> chunksChanged;
+        std::set<std::string> collectionsChanged;
+        while (cursor->moreInCurrentBatch()) {
+            const BSONObj entry = cursor->nextSafe();
+            _lastSeen = entry["ts"].timestamp();
+            extractChangedNamespaces(entry, &chunksChanged, &collectionsChanged);
+        }
+
+        _refresh(txn, chunksChanged, collectionsChanged);
+    }
+
+    conn.done();
+}
+
+void ConfigChangeWatcher::_refresh(OperationContext* txn,
+                                   const std::set<std::string>& chunksChanged,
+                                   const std::set<std::string>& collectionsChanged) {
+    auto catalogCache = Grid::get(txn)->catalogCache();
+
+    // A collection which was sharded or dropped changes which collections of its database are
+    // sharded, so the database is reloaded on its next use
+    for (const auto& ns : collectionsChanged) {
+        LOG(1) << "Collection " << ns << " changed on the config server";
+        catalogCache->invalidate(NamespaceString(ns).db().toString());
+    }
+
+    for (const auto& ns : chunksChanged) {
+        if (collectionsChanged.count(ns)) {
+            continue;
+        }
+
+        // Only refresh the routing metadata which this mongos has already loaded
+        auto db = catalogCache->getDatabaseIfCached(NamespaceString(ns).db().toString());
+        if (!db) {
+            continue;
+        }
+
+        LOG(1) << "Chunks of collection " << ns << " changed on the config server, refreshing";
+
+        try {
+            db->getChunkManagerIfExists(txn, ns, true);
+        } catch (const DBException& ex) {
+            log() << "Failed to refresh the chunks of collection " << ns << causedBy(ex);
+        }
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <set>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/timestamp.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+
+class BSONObj;
+class OperationContext;
+
+/**
+ * Tails the oplog of the config server primary for writes to config.chunks and
+ * config.collections and refreshes the affected cached routing metadata as soon as they happen,
+ * instead of waiting for a stale version error from a shard to trigger the refresh.
+ *
+ * The refreshes load only the chunks which changed since the cached version, as on a stale
+ * version error, and are coalesced with any concurrent refreshes of the same collection.
+ *
+ * NOTE: Not thread-safe, so it should not be used from more than one thread at a time.
+ */
+class ConfigChangeWatcher {
+    MONGO_DISALLOW_COPYING(ConfigChangeWatcher);
+
+public:
+    ConfigChangeWatcher();
+    ~ConfigChangeWatcher();
+
+    /**
+     * Starts the thread which tails the config server oplog. Does nothing unless the
+     * watchConfigChanges server parameter is set.
+     */
+    void startThread();
+
+    /**
+     * Adds to the output sets the namespaces of the collections whose chunks and whose collection
+     * entry, respectively, were changed by the specified oplog entry. Understands the applyOps
+     * entries through which chunk metadata is committed.
+     */
+    static void extractChangedNamespaces(const BSONObj& oplogEntry,
+                                         std::set<std::string>* chunksChanged,
+                                         std::set<std::string>* collectionsChanged);
+
+private:
+    /**
+     * Tails the oplog until an error, the config server primary changes or shutdown.
+     */
+    void _tailOplog(OperationContext* txn);
+
+    /**
+     * Refreshes the cached metadata of the changed collections.
+     */
+    void _refresh(OperationContext* txn,
+                  const std::set<std::string>& chunksChanged,
+                  const std::set<std::string>& collectionsChanged);
+
+    // Timestamp of the last oplog entry seen, or null if tailing hasn't started
+    Timestamp _lastSeen;
+
+    // The background watcher thread (if started)
+    stdx::thread _thread;
+};
+
+}  // namespace mongo
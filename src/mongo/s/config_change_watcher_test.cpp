@@ -0,0 +1,146 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/config_change_watcher.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using std::set;
+using std::string;
+
+TEST(ConfigChangeWatcher, ChunkInsert) {
+    set<string> chunksChanged;
+    set<string> collectionsChanged;
+    ConfigChangeWatcher::extractChangedNamespaces(
+        BSON("op"
+             << "i"
+             << "ns"
+             << "config.chunks"
+             << "o"
+             << BSON("_id"
+                     << "TestDB.TestColl-a_MinKey"
+                     << "ns"
+                     << "TestDB.TestColl")),
+        &chunksChanged,
+        &collectionsChanged);
+
+    ASSERT(set<string>{"TestDB.TestColl"} == chunksChanged);
+    ASSERT(collectionsChanged.empty());
+}
+
+TEST(ConfigChangeWatcher, ChunkDeleteHasNoNamespace) {
+    set<string> chunksChanged;
+    set<string> collectionsChanged;
+    ConfigChangeWatcher::extractChangedNamespaces(BSON("op"
+                                                       << "d"
+                                                       << "ns"
+                                                       << "config.chunks"
+                                                       << "o"
+                                                       << BSON("_id"
+                                                               << "TestDB.TestColl-a_MinKey")),
+                                                  &chunksChanged,
+                                                  &collectionsChanged);
+
+    ASSERT(chunksChanged.empty());
+    ASSERT(collectionsChanged.empty());
+}
+
+TEST(ConfigChangeWatcher, CollectionUpdate) {
+    set<string> chunksChanged;
+    set<string> collectionsChanged;
+    ConfigChangeWatcher::extractChangedNamespaces(
+        BSON("op"
+             << "u"
+             << "ns"
+             << "config.collections"
+             << "o2"
+             << BSON("_id"
+                     << "TestDB.TestColl")
+             << "o"
+             << BSON("$set" << BSON("dropped" << true))),
+        &chunksChanged,
+        &collectionsChanged);
+
+    ASSERT(chunksChanged.empty());
+    ASSERT(set<string>{"TestDB.TestColl"} == collectionsChanged);
+}
+
+TEST(ConfigChangeWatcher, ApplyOpsChunkCommit) {
+    BSONArrayBuilder ops;
+    ops.append(BSON("op"
+                    << "u"
+                    << "ns"
+                    << "config.chunks"
+                    << "o2"
+                    << BSON("_id"
+                            << "TestDB.TestColl-a_MinKey")
+                    << "o"
+                    << BSON("_id"
+                            << "TestDB.TestColl-a_MinKey"
+                            << "ns"
+                            << "TestDB.TestColl")));
+    ops.append(BSON("op"
+                    << "i"
+                    << "ns"
+                    << "config.chunks"
+                    << "o"
+                    << BSON("_id"
+                            << "OtherDB.OtherColl-a_10"
+                            << "ns"
+                            << "OtherDB.OtherColl")));
+    ops.append(BSON("op"
+                    << "i"
+                    << "ns"
+                    << "TestDB.Unrelated"
+                    << "o"
+                    << BSON("_id" << 1 << "ns"
+                                  << "TestDB.Ignored")));
+
+    set<string> chunksChanged;
+    set<string> collectionsChanged;
+    ConfigChangeWatcher::extractChangedNamespaces(BSON("op"
+                                                       << "c"
+                                                       << "ns"
+                                                       << "config.$cmd"
+                                                       << "o"
+                                                       << BSON("applyOps" << ops.arr())),
+                                                  &chunksChanged,
+                                                  &collectionsChanged);
+
+    ASSERT((set<string>{"OtherDB.OtherColl", "TestDB.TestColl"}) == chunksChanged);
+    ASSERT(collectionsChanged.empty());
+}
+
+}  // namespace
+}  // namespace mongo
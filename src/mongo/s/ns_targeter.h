@@ -29,6 +29,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/bson/bsonobj.h"
@@ -87,6 +88,26 @@ public:
                                 const BSONObj& doc,
                                 ShardEndpoint** endpoint) const = 0;
 
+    /**
+     * Targets each of 'docs' as targetInsert() would, filling 'endpoints' and 'statuses' with one
+     * entry per document, in the same order. An entry of 'endpoints' is NULL if the corresponding
+     * status is !OK, and is owned by the caller otherwise.
+     *
+     * Implementations may override this to share work between the documents of a batch. The
+     * default implementation targets the documents one at a time.
+     */
+    virtual void targetInserts(OperationContext* txn,
+                               const std::vector<BSONObj>& docs,
+                               std::vector<ShardEndpoint*>* endpoints,
+                               std::vector<Status>* statuses) const {
+        endpoints->assign(docs.size(), NULL);
+        statuses->assign(docs.size(), Status::OK());
+
+        for (size_t i = 0; i < docs.size(); ++i) {
+            (*statuses)[i] = targetInsert(txn, docs[i], &(*endpoints)[i]);
+        }
+    }
+
     /**
      * Returns a vector of ShardEndpoints for a potentially multi-shard update.
      *
@@ -32,10 +32,13 @@
 
 #include "mongo/s/query/async_results_merger.h"
 
+#include <algorithm>
+
 #include "mongo/client/remote_command_targeter.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/executor/remote_command_request.h"
 #include "mongo/executor/remote_command_response.h"
 #include "mongo/rpc/metadata/server_selection_metadata.h"
@@ -51,6 +54,23 @@ namespace {
 // Maximum number of retries for network and replication notMaster errors (per host).
 const int kMaxNumFailedHostRetryAttempts = 3;
 
+// Enables requesting the next batch from a remote before its buffered results run out.
+MONGO_EXPORT_SERVER_PARAMETER(internalAsyncResultsMergerPrefetch, bool, true);
+
+// A remote is not asked for its next batch ahead of time while it has at least this many bytes of
+// results buffered.
+MONGO_EXPORT_SERVER_PARAMETER(internalAsyncResultsMergerMaxBufferedBytesPerRemote,
+                              int,
+                              16 * 1024 * 1024);
+
+// A hedged copy of a cursor establishment command is sent no earlier than this many milliseconds
+// after the command itself.
+MONGO_EXPORT_SERVER_PARAMETER(internalHedgedReadMinDelayMS, int, 10);
+
+// A hedged copy of a cursor establishment command is sent once the command has gone unanswered for
+// this many times the observed round trip time of its host.
+MONGO_EXPORT_SERVER_PARAMETER(internalHedgedReadLatencyMultiplier, int, 3);
+
 }  // namespace
 
 AsyncResultsMerger::AsyncResultsMerger(executor::TaskExecutor* executor,
@@ -79,10 +99,23 @@ AsyncResultsMerger::AsyncResultsMerger(executor::TaskExecutor* executor,
             _params.readPreference->pref != ReadPreference::PrimaryOnly, boost::none);
         uassertStatusOK(metadata.writeToMetadata(&metadataBuilder));
         _metadataObj = metadataBuilder.obj();
+
+        const bool hasInitialCommands =
+            std::any_of(_remotes.begin(), _remotes.end(), [](const RemoteCursorData& remote) {
+                return static_cast<bool>(remote.initialCmdObj);
+            });
+        if (_params.readPreference->hedge && hasInitialCommands) {
+            _hedgeState = std::make_shared<HedgeState>(this, _executor, _params.nsString);
+        }
     }
 }
 
 AsyncResultsMerger::~AsyncResultsMerger() {
+    if (_hedgeState) {
+        stdx::lock_guard<stdx::mutex> lk(_hedgeState->mutex);
+        _hedgeState->arm = nullptr;
+    }
+
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     invariant(remotesExhausted_inlock() || _lifecycleState == kKillComplete);
 }
@@ -114,6 +147,47 @@ Status AsyncResultsMerger::setAwaitDataTimeout(Milliseconds awaitDataTimeout) {
     return Status::OK();
 }
 
+Status AsyncResultsMerger::retryStaleRemotes(
+    const ClusterClientCursorParams::MakeEstablishCmdFn& makeCmdObj) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    if (_lifecycleState != kAlive) {
+        return Status(ErrorCodes::IllegalOperation, "AsyncResultsMerger killed");
+    }
+
+    // Build all the commands first, so that nothing is retried if any of them can't be built.
+    std::vector<std::pair<size_t, BSONObj>> retries;
+    for (size_t i = 0; i < _remotes.size(); ++i) {
+        const auto& remote = _remotes[i];
+        if (remote.status.isOK()) {
+            continue;
+        }
+
+        if (remote.cursorId || !remote.shardId ||
+            !ErrorCodes::isStaleShardingError(remote.status.code())) {
+            return remote.status;
+        }
+
+        auto cmdObj = makeCmdObj(*remote.shardId);
+        if (!cmdObj.isOK()) {
+            return cmdObj.getStatus();
+        }
+        retries.emplace_back(i, std::move(cmdObj.getValue()));
+    }
+
+    for (auto& retry : retries) {
+        auto& remote = _remotes[retry.first];
+        LOG(1) << "Retrying cursor establishment on shard " << *remote.shardId
+               << " after stale shard version error" << causedBy(remote.status);
+
+        remote.initialCmdObj = std::move(retry.second);
+        remote.status = Status::OK();
+    }
+
+    _status = Status::OK();
+    return Status::OK();
+}
+
 bool AsyncResultsMerger::ready() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     return ready_inlock();
@@ -211,8 +285,7 @@ boost::optional<BSONObj> AsyncResultsMerger::nextReadySorted() {
     invariant(!_remotes[smallestRemote].docBuffer.empty());
     invariant(_remotes[smallestRemote].status.isOK());
 
-    BSONObj front = _remotes[smallestRemote].docBuffer.front();
-    _remotes[smallestRemote].docBuffer.pop();
+    BSONObj front = popNextBuffered_inlock(smallestRemote);
 
     // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
     // next result.
@@ -230,8 +303,7 @@ boost::optional<BSONObj> AsyncResultsMerger::nextReadyUnsorted() {
         invariant(_remotes[_gettingFromRemote].status.isOK());
 
         if (_remotes[_gettingFromRemote].hasNext()) {
-            BSONObj front = _remotes[_gettingFromRemote].docBuffer.front();
-            _remotes[_gettingFromRemote].docBuffer.pop();
+            BSONObj front = popNextBuffered_inlock(_gettingFromRemote);
 
             if (_params.isTailable && !_remotes[_gettingFromRemote].hasNext()) {
                 // The cursor is tailable and we're about to return the last buffered result. This
@@ -293,18 +365,219 @@ Status AsyncResultsMerger::askForNextBatch_inlock(size_t remoteIndex) {
     executor::RemoteCommandRequest request(
         remote.getTargetHost(), _params.nsString.db().toString(), cmdObj, _metadataObj);
 
-    auto callbackStatus = _executor->scheduleRemoteCommand(
-        request,
-        stdx::bind(
-            &AsyncResultsMerger::handleBatchResponse, this, stdx::placeholders::_1, remoteIndex));
+    auto callbackStatus =
+        _executor->scheduleRemoteCommand(request, makeBatchResponseCallback(remoteIndex));
     if (!callbackStatus.isOK()) {
         return callbackStatus.getStatus();
     }
 
     remote.cbHandle = callbackStatus.getValue();
+
+    if (_hedgeState && !remote.cursorId && !remote.hedgeTimerHandle.isValid() &&
+        !remote.hedgeCbHandle.isValid()) {
+        scheduleHedgeTimer_inlock(remoteIndex);
+    }
+
     return Status::OK();
 }
 
+executor::TaskExecutor::RemoteCommandCallbackFn AsyncResultsMerger::makeBatchResponseCallback(
+    size_t remoteIndex) {
+    if (!_hedgeState) {
+        return stdx::bind(
+            &AsyncResultsMerger::handleBatchResponse, this, stdx::placeholders::_1, remoteIndex);
+    }
+
+    auto hedgeState = _hedgeState;
+    return [hedgeState, remoteIndex](
+        const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
+        stdx::lock_guard<stdx::mutex> lk(hedgeState->mutex);
+        if (hedgeState->arm) {
+            hedgeState->arm->handleBatchResponse(cbData, remoteIndex);
+        } else {
+            scheduleKillHedgeLoserCursor(hedgeState->executor, hedgeState->nss, cbData);
+        }
+    };
+}
+
+void AsyncResultsMerger::scheduleHedgeTimer_inlock(size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+
+    auto shard = remote.getShard();
+    if (!shard) {
+        return;
+    }
+
+    Milliseconds delay(internalHedgedReadMinDelayMS.load());
+    auto latency = shard->getTargeter()->getHostLatency(remote.getTargetHost());
+    if (latency) {
+        delay = std::max(delay,
+                         duration_cast<Milliseconds>(*latency *
+                                                     internalHedgedReadLatencyMultiplier.load()));
+    }
+
+    auto hedgeState = _hedgeState;
+    auto timerStatus = _executor->scheduleWorkAt(
+        _executor->now() + delay,
+        [hedgeState, remoteIndex](const executor::TaskExecutor::CallbackArgs& cbData) {
+            stdx::lock_guard<stdx::mutex> lk(hedgeState->mutex);
+            if (hedgeState->arm) {
+                hedgeState->arm->handleHedgeTimer(cbData, remoteIndex);
+            }
+        });
+    if (!timerStatus.isOK()) {
+        LOG(1) << "Failed to schedule a hedged read for " << remote.getTargetHost()
+               << causedBy(timerStatus.getStatus());
+        return;
+    }
+
+    remote.hedgeTimerHandle = timerStatus.getValue();
+}
+
+void AsyncResultsMerger::handleHedgeTimer(const executor::TaskExecutor::CallbackArgs& cbData,
+                                          size_t remoteIndex) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto& remote = _remotes[remoteIndex];
+
+    // The timer is dropped as soon as the request it hedges is answered.
+    if (cbData.myHandle != remote.hedgeTimerHandle) {
+        return;
+    }
+    remote.hedgeTimerHandle = executor::TaskExecutor::CallbackHandle();
+
+    if (_lifecycleState != kAlive) {
+        invariant(_lifecycleState == kKillStarted);
+        completeKillIfNoOutstandingRequests_inlock();
+        return;
+    }
+
+    if (!cbData.status.isOK()) {
+        return;
+    }
+
+    invariant(remote.cbHandle.isValid());
+    invariant(!remote.cursorId);
+
+    auto shard = remote.getShard();
+    if (!shard) {
+        return;
+    }
+
+    auto hedgeHostStatus =
+        shard->getTargeter()->findHedgeHost(*_params.readPreference, remote.getTargetHost());
+    if (!hedgeHostStatus.isOK()) {
+        LOG(2) << "Not hedging the read sent to " << remote.getTargetHost()
+               << causedBy(hedgeHostStatus.getStatus());
+        return;
+    }
+
+    executor::RemoteCommandRequest request(hedgeHostStatus.getValue(),
+                                           _params.nsString.db().toString(),
+                                           *remote.initialCmdObj,
+                                           _metadataObj);
+
+    auto callbackStatus =
+        _executor->scheduleRemoteCommand(request, makeBatchResponseCallback(remoteIndex));
+    if (!callbackStatus.isOK()) {
+        LOG(1) << "Failed to send a hedged read to " << hedgeHostStatus.getValue()
+               << causedBy(callbackStatus.getStatus());
+        return;
+    }
+
+    LOG(2) << "Hedging the read sent to " << remote.getTargetHost() << " with "
+           << hedgeHostStatus.getValue();
+
+    remote.hedgeCbHandle = callbackStatus.getValue();
+    remote.hedgeHost = std::move(hedgeHostStatus.getValue());
+}
+
+bool AsyncResultsMerger::settleHedgedRace_inlock(size_t remoteIndex,
+                                                 bool isHedgeResponse,
+                                                 const Status& responseStatus) {
+    auto& remote = _remotes[remoteIndex];
+
+    if (isHedgeResponse) {
+        invariant(remote.cbHandle.isValid());
+        const HostAndPort hedgeHost = std::move(*remote.hedgeHost);
+        remote.hedgeHost = boost::none;
+
+        if (!responseStatus.isOK()) {
+            LOG(1) << "Hedged read on " << hedgeHost << " failed, waiting for "
+                   << remote.getTargetHost() << causedBy(responseStatus);
+            if (auto shard = remote.getShard()) {
+                shard->updateReplSetMonitor(hedgeHost, responseStatus);
+            }
+            return false;
+        }
+
+        // The response to the first request will only be used to kill the cursor it opened.
+        remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+        remote.retargetTo(hedgeHost);
+        return true;
+    }
+
+    // Whatever the outcome, it is too late to send a hedged copy of the request.
+    if (remote.hedgeTimerHandle.isValid()) {
+        _executor->cancel(remote.hedgeTimerHandle);
+        remote.hedgeTimerHandle = executor::TaskExecutor::CallbackHandle();
+    }
+
+    if (!remote.hedgeCbHandle.isValid()) {
+        return true;
+    }
+
+    if (responseStatus.isOK()) {
+        // The response to the hedged copy will only be used to kill the cursor it opened.
+        remote.hedgeCbHandle = executor::TaskExecutor::CallbackHandle();
+        remote.hedgeHost = boost::none;
+        return true;
+    }
+
+    // The hedged copy may still succeed, so wait for it as if it had been the first request.
+    LOG(1) << "Read on " << remote.getTargetHost() << " failed, waiting for its hedged copy on "
+           << *remote.hedgeHost << causedBy(responseStatus);
+    if (auto shard = remote.getShard()) {
+        shard->updateReplSetMonitor(remote.getTargetHost(), responseStatus);
+    }
+    remote.cbHandle = remote.hedgeCbHandle;
+    remote.hedgeCbHandle = executor::TaskExecutor::CallbackHandle();
+    remote.retargetTo(std::move(*remote.hedgeHost));
+    remote.hedgeHost = boost::none;
+    return false;
+}
+
+BSONObj AsyncResultsMerger::popNextBuffered_inlock(size_t remoteIndex) {
+    auto& remote = _remotes[remoteIndex];
+
+    BSONObj front = remote.docBuffer.front();
+    remote.docBuffer.pop();
+    remote.bufferedBytes -= front.objsize();
+
+    // An empty buffer is refilled by nextEvent(). Batches received from remote tailable cursors
+    // are passed through to the client as they are, so they are never requested early.
+    if (!internalAsyncResultsMergerPrefetch.load() || _params.isTailable || !remote.hasNext() ||
+        remote.exhausted() || remote.cbHandle.isValid()) {
+        return front;
+    }
+
+    if (remote.docBuffer.size() * 2 >= remote.lastBatchCount ||
+        remote.bufferedBytes >=
+            static_cast<size_t>(internalAsyncResultsMergerMaxBufferedBytesPerRemote.load())) {
+        return front;
+    }
+
+    // A failure here is not fatal to the cursor: nextEvent() asks for the batch again once the
+    // buffer is empty.
+    auto prefetchStatus = askForNextBatch_inlock(remoteIndex);
+    if (!prefetchStatus.isOK()) {
+        LOG(1) << "Failed to request the next batch from " << remote.getTargetHost()
+               << " ahead of time" << causedBy(prefetchStatus);
+    }
+
+    return front;
+}
+
 StatusWith<executor::TaskExecutor::EventHandle> AsyncResultsMerger::nextEvent() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
 
@@ -381,9 +654,21 @@ void AsyncResultsMerger::handleBatchResponse(
 
     auto& remote = _remotes[remoteIndex];
 
+    // While hedging, a response is either to the request we are waiting on, to its hedged copy, or
+    // to whichever of the two has lost the race.
+    const bool isHedgeResponse = _hedgeState && cbData.myHandle == remote.hedgeCbHandle;
+    if (_hedgeState && !isHedgeResponse && cbData.myHandle != remote.cbHandle) {
+        scheduleKillHedgeLoserCursor(_executor, _params.nsString, cbData);
+        return;
+    }
+
     // Clear the callback handle. This indicates that we are no longer waiting on a response from
     // 'remote'.
-    remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+    if (isHedgeResponse) {
+        remote.hedgeCbHandle = executor::TaskExecutor::CallbackHandle();
+    } else {
+        remote.cbHandle = executor::TaskExecutor::CallbackHandle();
+    }
 
     // If we're in the process of shutting down then there's no need to process the batch.
     if (_lifecycleState != kAlive) {
@@ -393,30 +678,19 @@ void AsyncResultsMerger::handleBatchResponse(
         signalCurrentEventIfReady_inlock();
 
         // Make a best effort to parse the response and retrieve the cursor id. We need the cursor
-        // id in order to issue a killCursors command against it.
-        if (cbData.response.isOK()) {
+        // id in order to issue a killCursors command against it. The cursor opened by a hedged
+        // copy is not the one tracked by 'remote', so it is killed right away.
+        if (isHedgeResponse) {
+            remote.hedgeHost = boost::none;
+            scheduleKillHedgeLoserCursor(_executor, _params.nsString, cbData);
+        } else if (cbData.response.isOK()) {
             auto cursorResponse = parseCursorResponse(cbData.response.getValue().data, remote);
             if (cursorResponse.isOK()) {
                 remote.cursorId = cursorResponse.getValue().getCursorId();
             }
         }
 
-        // If we're killed and we're not waiting on any more batches to come back, then we are ready
-        // to kill the cursors on the remote hosts and clean up this cursor. Schedule the
-        // killCursors command and signal that this cursor is safe now safe to destroy. We have to
-        // promise not to touch any members of this class because 'this' could become invalid as
-        // soon as we signal the event.
-        if (!haveOutstandingBatchRequests_inlock()) {
-            // If the event handle is invalid, then the executor is in the middle of shutting down,
-            // and we can't schedule any more work for it to complete.
-            if (_killCursorsScheduledEvent.isValid()) {
-                scheduleKillCursors_inlock();
-                _executor->signalEvent(_killCursorsScheduledEvent);
-            }
-
-            _lifecycleState = kKillComplete;
-        }
-
+        completeKillIfNoOutstandingRequests_inlock();
         return;
     }
 
@@ -427,6 +701,11 @@ void AsyncResultsMerger::handleBatchResponse(
         cbData.response.isOK() ? parseCursorResponse(cbData.response.getValue().data, remote)
                                : cbData.response.getStatus());
 
+    if (_hedgeState && !remote.cursorId &&
+        !settleHedgedRace_inlock(remoteIndex, isHedgeResponse, cursorResponseStatus.getStatus())) {
+        return;
+    }
+
     if (!cursorResponseStatus.isOK()) {
         auto shard = remote.getShard();
         if (!shard) {
@@ -466,13 +745,11 @@ void AsyncResultsMerger::handleBatchResponse(
         }
 
         // Unreachable host errors are swallowed if the 'allowPartialResults' option is set. We
-        // remove the unreachable host entirely from consideration by marking it as exhausted.
+        // remove the unreachable host from consideration by marking it as exhausted. Results that
+        // were buffered before a prefetched batch failed are still returned; the remote may
+        // already be on the merge queue for them.
         if (_params.isAllowPartialResults) {
             remote.status = Status::OK();
-
-            // Clear the results buffer and cursor id.
-            std::queue<BSONObj> emptyBuffer;
-            std::swap(remote.docBuffer, emptyBuffer);
             remote.cursorId = 0;
         }
 
@@ -484,6 +761,11 @@ void AsyncResultsMerger::handleBatchResponse(
     remote.cursorId = cursorResponse.getCursorId();
     remote.initialCmdObj = boost::none;
 
+    // A prefetched batch may arrive while results are still buffered, in which case the remote is
+    // already on the merge queue.
+    const bool hadBufferedResults = remote.hasNext();
+    remote.lastBatchCount = cursorResponse.getBatch().size();
+
     for (const auto& obj : cursorResponse.getBatch()) {
         // If there's a sort, we're expecting the remote node to give us back a sort key.
         if (!_params.sort.isEmpty() &&
@@ -497,12 +779,13 @@ void AsyncResultsMerger::handleBatchResponse(
         }
 
         remote.docBuffer.push(obj);
+        remote.bufferedBytes += obj.objsize();
         ++remote.fetchedCount;
     }
 
     // If we're doing a sorted merge, then we have to make sure to put this remote onto the
     // merge queue.
-    if (!_params.sort.isEmpty() && !cursorResponse.getBatch().empty()) {
+    if (!_params.sort.isEmpty() && !hadBufferedResults && !cursorResponse.getBatch().empty()) {
         _mergeQueue.push(remoteIndex);
     }
 
@@ -541,7 +824,8 @@ void AsyncResultsMerger::signalCurrentEventIfReady_inlock() {
 
 bool AsyncResultsMerger::haveOutstandingBatchRequests_inlock() {
     for (const auto& remote : _remotes) {
-        if (remote.cbHandle.isValid()) {
+        if (remote.cbHandle.isValid() || remote.hedgeTimerHandle.isValid() ||
+            remote.hedgeCbHandle.isValid()) {
             return true;
         }
     }
@@ -549,6 +833,26 @@ bool AsyncResultsMerger::haveOutstandingBatchRequests_inlock() {
     return false;
 }
 
+void AsyncResultsMerger::completeKillIfNoOutstandingRequests_inlock() {
+    // If we're killed and we're not waiting on any more batches to come back, then we are ready to
+    // kill the cursors on the remote hosts and clean up this cursor. Schedule the killCursors
+    // command and signal that this cursor is safe now safe to destroy. We have to promise not to
+    // touch any members of this class because 'this' could become invalid as soon as we signal the
+    // event.
+    if (haveOutstandingBatchRequests_inlock()) {
+        return;
+    }
+
+    // If the event handle is invalid, then the executor is in the middle of shutting down, and we
+    // can't schedule any more work for it to complete.
+    if (_killCursorsScheduledEvent.isValid()) {
+        scheduleKillCursors_inlock();
+        _executor->signalEvent(_killCursorsScheduledEvent);
+    }
+
+    _lifecycleState = kKillComplete;
+}
+
 void AsyncResultsMerger::scheduleKillCursors_inlock() {
     invariant(_lifecycleState == kKillStarted);
     invariant(_killCursorsScheduledEvent.isValid());
@@ -574,6 +878,27 @@ void AsyncResultsMerger::handleKillCursorsResponse(
     // We just ignore any killCursors command responses.
 }
 
+void AsyncResultsMerger::scheduleKillHedgeLoserCursor(
+    executor::TaskExecutor* executor,
+    const NamespaceString& nss,
+    const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData) {
+    if (!cbData.response.isOK()) {
+        return;
+    }
+
+    auto cursorResponse = CursorResponse::parseFromBSON(cbData.response.getValue().data);
+    if (!cursorResponse.isOK() || cursorResponse.getValue().getCursorId() == 0) {
+        return;
+    }
+
+    BSONObj cmdObj = KillCursorsRequest(nss, {cursorResponse.getValue().getCursorId()}).toBSON();
+
+    executor::RemoteCommandRequest request(cbData.request.target, nss.db().toString(), cmdObj);
+
+    executor->scheduleRemoteCommand(
+        request, stdx::bind(&AsyncResultsMerger::handleKillCursorsResponse, stdx::placeholders::_1));
+}
+
 executor::TaskExecutor::EventHandle AsyncResultsMerger::kill() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     if (_killCursorsScheduledEvent.isValid()) {
@@ -583,6 +908,14 @@ executor::TaskExecutor::EventHandle AsyncResultsMerger::kill() {
 
     _lifecycleState = kKillStarted;
 
+    // No hedged copies of requests are sent once the ARM is being killed. The timers stay
+    // outstanding until their canceled callbacks have run.
+    for (const auto& remote : _remotes) {
+        if (remote.hedgeTimerHandle.isValid()) {
+            _executor->cancel(remote.hedgeTimerHandle);
+        }
+    }
+
     // Make '_killCursorsScheduledEvent', which we will signal as soon as we have scheduled a
     // killCursors command to run on all the remote shards.
     auto statusWithEvent = _executor->makeEvent();
@@ -655,6 +988,12 @@ Status AsyncResultsMerger::RemoteCursorData::resolveShardIdToHostAndPort(
     return Status::OK();
 }
 
+void AsyncResultsMerger::RemoteCursorData::retargetTo(HostAndPort host) {
+    invariant(shardId);
+    invariant(!cursorId);
+    _shardHostAndPort = std::move(host);
+}
+
 std::shared_ptr<Shard> AsyncResultsMerger::RemoteCursorData::getShard() {
     invariant(shardId || _shardHostAndPort);
     if (shardId) {
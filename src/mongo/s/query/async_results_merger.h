@@ -29,6 +29,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <memory>
 #include <queue>
 #include <vector>
 
@@ -36,6 +37,7 @@
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/cursor_id.h"
+#include "mongo/db/namespace_string.h"
 #include "mongo/executor/task_executor.h"
 #include "mongo/s/query/cluster_client_cursor_params.h"
 #include "mongo/stdx/mutex.h"
@@ -64,6 +66,15 @@ class CursorResponse;
  * This requires waiting until we have a response from every remote before returning results.
  * Without a sort, we are ready to return results as soon as we have *any* response from a remote.
  *
+ * To avoid waiting for a full round trip each time a remote's buffer runs dry, the next batch is
+ * requested as soon as a remote's buffer holds fewer than half of the documents of the batch it
+ * last received, as long as the buffered documents do not exceed a per-remote byte limit.
+ *
+ * If the read preference asks for hedged reads, the initial cursor establishment command on each
+ * shard is also sent to a second eligible host when the first has not answered within a delay
+ * derived from its observed latency. The first successful response is used, and the cursor opened
+ * by the other one, if any, is killed.
+ *
  * On any error, the caller is responsible for shutting down the ARM using the kill() method.
  *
  * Does not throw exceptions.
@@ -100,6 +111,17 @@ public:
      */
     Status setAwaitDataTimeout(Milliseconds awaitDataTimeout);
 
+    /**
+     * If every remote which reported an error failed to establish its cursor because its shard
+     * version was stale, clears those errors and makes the next call to nextEvent() send each of
+     * these remotes the command returned for its shard by 'makeCmdObj'. The other remotes, and the
+     * cursors they have already established, are left untouched.
+     *
+     * Returns the error which will be reported by nextReady() if any remote failed for another
+     * reason, or the error returned by 'makeCmdObj', in which case nothing is retried.
+     */
+    Status retryStaleRemotes(const ClusterClientCursorParams::MakeEstablishCmdFn& makeCmdObj);
+
     /**
      * Returns true if there is no need to schedule remote work in order to take the next action.
      * This means that either
@@ -207,6 +229,14 @@ private:
          */
         Status resolveShardIdToHostAndPort(const ReadPreferenceSetting& readPref);
 
+        /**
+         * Makes 'host' the host on which the cursor is being established, after the hedged copy of
+         * the cursor establishment command sent to it has won.
+         *
+         * May not be called once a cursor has already been established.
+         */
+        void retargetTo(HostAndPort host);
+
         /**
          * Returns the Shard object associated with this remote cursor.
          */
@@ -228,9 +258,26 @@ private:
         boost::optional<CursorId> cursorId;
 
         std::queue<BSONObj> docBuffer;
+
+        // Total size in bytes of the documents in 'docBuffer'.
+        size_t bufferedBytes = 0;
+
+        // Number of documents in the last batch received from the remote. Used to decide when to
+        // prefetch the next batch.
+        size_t lastBatchCount = 0;
+
         executor::TaskExecutor::CallbackHandle cbHandle;
         Status status = Status::OK();
 
+        // Set while the timer which sends a hedged copy of the cursor establishment command is
+        // pending.
+        executor::TaskExecutor::CallbackHandle hedgeTimerHandle;
+
+        // Set while a hedged copy of the cursor establishment command is outstanding on
+        // 'hedgeHost'.
+        executor::TaskExecutor::CallbackHandle hedgeCbHandle;
+        boost::optional<HostAndPort> hedgeHost;
+
         // Counts how many times we retried the initial cursor establishment command. It is used to
         // make a decision based on the error type and the retry count about whether we are allowed
         // to retry sending the request to another host from this shard.
@@ -259,6 +306,23 @@ private:
         const BSONObj& _sort;
     };
 
+    /**
+     * Shared with the callbacks of a hedging ARM. A request which lost a hedged race is no longer
+     * tracked by the ARM, so its response may arrive after the ARM has been destroyed, in which
+     * case 'arm' is null and the response is only used to kill the cursor it opened.
+     */
+    struct HedgeState {
+        HedgeState(AsyncResultsMerger* arm, executor::TaskExecutor* executor, NamespaceString nss)
+            : arm(arm), executor(executor), nss(std::move(nss)) {}
+
+        // Held while calling into 'arm', and by the ARM's destructor to reset it.
+        stdx::mutex mutex;
+        AsyncResultsMerger* arm;
+
+        executor::TaskExecutor* const executor;
+        const NamespaceString nss;
+    };
+
     enum LifecycleState { kAlive, kKillStarted, kKillComplete };
 
     /**
@@ -267,6 +331,15 @@ private:
     static void handleKillCursorsResponse(
         const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData);
 
+    /**
+     * Schedules a killCursors command for the cursor, if any, opened by a request which lost a
+     * hedged race.
+     */
+    static void scheduleKillHedgeLoserCursor(
+        executor::TaskExecutor* executor,
+        const NamespaceString& nss,
+        const executor::TaskExecutor::RemoteCommandCallbackArgs& cbData);
+
     /**
      * Parses the find or getMore command response object to a CursorResponse.
      *
@@ -285,6 +358,40 @@ private:
      */
     Status askForNextBatch_inlock(size_t remoteIndex);
 
+    /**
+     * Returns the callback to pass to the executor for a request to the remote at 'remoteIndex'.
+     */
+    executor::TaskExecutor::RemoteCommandCallbackFn makeBatchResponseCallback(size_t remoteIndex);
+
+    /**
+     * Schedules the timer which sends a hedged copy of the cursor establishment command of the
+     * remote at 'remoteIndex' if it has not been answered by then. Hedging is best effort, so a
+     * failure to schedule the timer is only logged.
+     */
+    void scheduleHedgeTimer_inlock(size_t remoteIndex);
+
+    /**
+     * Callback run when the hedge timer of the remote at 'remoteIndex' fires or is canceled.
+     */
+    void handleHedgeTimer(const executor::TaskExecutor::CallbackArgs& cbData, size_t remoteIndex);
+
+    /**
+     * Decides the hedged race of the remote at 'remoteIndex' given the outcome of one of its
+     * requests, 'isHedgeResponse' telling whether the response is to the hedged copy. Returns true
+     * if the response should be processed as the remote's own, or false if it should be dropped
+     * because the other request of the race is still outstanding.
+     */
+    bool settleHedgedRace_inlock(size_t remoteIndex,
+                                 bool isHedgeResponse,
+                                 const Status& responseStatus);
+
+    /**
+     * Removes and returns the next buffered document of the remote at 'remoteIndex' in '_remotes'.
+     * Asks the remote for its next batch ahead of time if the buffer has dropped below the
+     * prefetch watermark.
+     */
+    BSONObj popNextBuffered_inlock(size_t remoteIndex);
+
     /**
      * Checks whether or not the remote cursors are all exhausted.
      */
@@ -330,6 +437,12 @@ private:
      */
     bool haveOutstandingBatchRequests_inlock();
 
+    /**
+     * Once a killed ARM has no outstanding requests, schedules the killCursors commands and marks
+     * the kill as complete.
+     */
+    void completeKillIfNoOutstandingRequests_inlock();
+
     /**
      * Schedules a killCursors command to be run on all remote hosts that have open cursors.
      */
@@ -369,6 +482,9 @@ private:
 
     boost::optional<Milliseconds> _awaitDataTimeout;
 
+    // Set if the initial cursor establishment commands are hedged.
+    std::shared_ptr<HedgeState> _hedgeState;
+
     //
     // Killing
     //
@@ -42,6 +42,7 @@
 #include "mongo/rpc/metadata/server_selection_metadata.h"
 #include "mongo/s/catalog/type_shard.h"
 #include "mongo/s/client/shard_registry.h"
+#include "mongo/s/grid.h"
 #include "mongo/s/sharding_test_fixture.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
@@ -1367,6 +1368,202 @@ TEST_F(AsyncResultsMergerTest, GetMoreRequestWithoutAwaitDataCantHaveMaxTime) {
     executor()->waitForEvent(killEvent);
 }
 
+TEST_F(AsyncResultsMergerTest, SortedMergePrefetchesNextBatchBeforeBufferIsEmpty) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}}");
+    makeCursorFromFindCmd(findCmd, {kTestShardIds[0], kTestShardIds[1]});
+
+    ASSERT_FALSE(arm->ready());
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    ASSERT_FALSE(arm->ready());
+
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch1 = {fromjson("{$sortKey: {'': 1}}"),
+                                   fromjson("{$sortKey: {'': 2}}"),
+                                   fromjson("{$sortKey: {'': 3}}"),
+                                   fromjson("{$sortKey: {'': 4}}")};
+    responses.emplace_back(_nss, CursorId(1), batch1);
+    std::vector<BSONObj> batch2 = {fromjson("{$sortKey: {'': 5}}"),
+                                   fromjson("{$sortKey: {'': 6}}")};
+    responses.emplace_back(_nss, CursorId(0), batch2);
+    scheduleNetworkResponses(std::move(responses), CursorResponse::ResponseType::InitialResponse);
+    executor()->waitForEvent(readyEvent);
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{$sortKey: {'': 1}}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{$sortKey: {'': 2}}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{$sortKey: {'': 3}}"), *unittest::assertGet(arm->nextReady()));
+
+    // Only one document is left from the first shard, so its next batch has been requested.
+    BSONObj expectedCmdObj = BSON("getMore" << CursorId(1) << "collection"
+                                            << "testcoll");
+    ASSERT_EQ(getFirstPendingRequest().cmdObj, expectedCmdObj);
+
+    responses.clear();
+    std::vector<BSONObj> batch3 = {fromjson("{$sortKey: {'': 7}}"),
+                                   fromjson("{$sortKey: {'': 8}}")};
+    responses.emplace_back(_nss, CursorId(0), batch3);
+    scheduleNetworkResponses(std::move(responses),
+                             CursorResponse::ResponseType::SubsequentResponse);
+
+    ASSERT_TRUE(arm->remotesExhausted());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{$sortKey: {'': 4}}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{$sortKey: {'': 5}}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{$sortKey: {'': 6}}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{$sortKey: {'': 7}}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{$sortKey: {'': 8}}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT(!unittest::assertGet(arm->nextReady()));
+}
+
+TEST_F(AsyncResultsMergerTest, HedgedReadUsesFirstResponseAndKillsTheOtherCursor) {
+    const HostAndPort hedgeHost("FakeShard1Secondary", 12345);
+    auto targeter = RemoteCommandTargeterMock::get(
+        grid.shardRegistry()->getShardNoReload(kTestShardIds[0])->getTargeter());
+    targeter->setFindHedgeHostReturnValue(hedgeHost);
+
+    ReadPreferenceSetting readPref(ReadPreference::Nearest);
+    readPref.hedge = true;
+    BSONObj findCmd = fromjson("{find: 'testcoll'}");
+    makeCursorFromFindCmd(findCmd, {kTestShardIds[0]}, boost::none, readPref);
+
+    ASSERT_FALSE(arm->ready());
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    ASSERT_FALSE(arm->ready());
+
+    // The first host does not answer, so once the hedge delay has passed the find is also sent to
+    // another host.
+    executor::NetworkInterfaceMock* net = network();
+    net->enterNetwork();
+    ASSERT_TRUE(net->hasReadyRequests());
+    NetworkInterfaceMock::NetworkOperationIterator firstRequest = net->getNextReadyRequest();
+    ASSERT_EQ(firstRequest->getRequest().target, kTestShardHosts[0]);
+    net->runUntil(net->now() + Milliseconds(10));
+    ASSERT_TRUE(net->hasReadyRequests());
+    NetworkInterfaceMock::NetworkOperationIterator hedgeRequest = net->getNextReadyRequest();
+    ASSERT_EQ(hedgeRequest->getRequest().target, hedgeHost);
+    ASSERT_EQ(hedgeRequest->getRequest().cmdObj, findCmd);
+
+    // The hedged copy answers first, and its results are returned.
+    std::vector<BSONObj> batch = {fromjson("{_id: 1}")};
+    BSONObj hedgeResponse = CursorResponse(_nss, CursorId(0), batch)
+                                .toBSON(CursorResponse::ResponseType::InitialResponse);
+    net->scheduleResponse(hedgeRequest,
+                          net->now(),
+                          executor::TaskExecutor::ResponseStatus(
+                              RemoteCommandResponse(hedgeResponse, BSONObj(), Milliseconds(0))));
+    net->runReadyNetworkOperations();
+    net->exitNetwork();
+
+    executor()->waitForEvent(readyEvent);
+    ASSERT_TRUE(arm->remotesExhausted());
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT(!unittest::assertGet(arm->nextReady()));
+
+    // The cursor opened by the late response of the first host is killed.
+    net->enterNetwork();
+    BSONObj lateResponse = CursorResponse(_nss, CursorId(123), batch)
+                               .toBSON(CursorResponse::ResponseType::InitialResponse);
+    net->scheduleResponse(firstRequest,
+                          net->now(),
+                          executor::TaskExecutor::ResponseStatus(
+                              RemoteCommandResponse(lateResponse, BSONObj(), Milliseconds(0))));
+    net->runReadyNetworkOperations();
+    net->exitNetwork();
+
+    auto killCursorsRequest = getFirstPendingRequest();
+    ASSERT_EQ(killCursorsRequest.target, kTestShardHosts[0]);
+    BSONObj expectedCmdObj = BSON("killCursors"
+                                  << "testcoll"
+                                  << "cursors"
+                                  << BSON_ARRAY(CursorId(123)));
+    ASSERT_EQ(killCursorsRequest.cmdObj, expectedCmdObj);
+}
+
+
+TEST_F(AsyncResultsMergerTest, RetryStaleRemotesResendsOnlyToStaleShard) {
+    BSONObj findCmd = fromjson("{find: 'testcoll'}");
+    makeCursorFromFindCmd(findCmd, kTestShardIds);
+
+    ASSERT_FALSE(arm->ready());
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    ASSERT_FALSE(arm->ready());
+
+    // The first shard establishes its cursor, while the second reports a stale shard version.
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch1 = {fromjson("{_id: 1}")};
+    responses.emplace_back(_nss, CursorId(0), batch1);
+    scheduleNetworkResponses(std::move(responses), CursorResponse::ResponseType::InitialResponse);
+    scheduleErrorResponse({ErrorCodes::StaleShardVersion, "stale shard version"});
+    executor()->waitForEvent(readyEvent);
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(ErrorCodes::StaleShardVersion, arm->nextReady().getStatus().code());
+
+    BSONObj retryCmd = fromjson("{find: 'testcoll', shardVersion: [Timestamp(2, 0), 0]}");
+    std::vector<ShardId> retriedShardIds;
+    ASSERT_OK(arm->retryStaleRemotes([&](const ShardId& shardId) -> StatusWith<BSONObj> {
+        retriedShardIds.push_back(shardId);
+        return retryCmd;
+    }));
+    ASSERT_EQ(1U, retriedShardIds.size());
+    ASSERT_EQ(kTestShardIds[1], retriedShardIds[0]);
+
+    ASSERT_FALSE(arm->ready());
+    readyEvent = unittest::assertGet(arm->nextEvent());
+    ASSERT_FALSE(arm->ready());
+
+    // Only the stale shard is sent the refreshed command.
+    ASSERT_EQ(getFirstPendingRequest().cmdObj, retryCmd);
+    responses.clear();
+    std::vector<BSONObj> batch2 = {fromjson("{_id: 2}")};
+    responses.emplace_back(_nss, CursorId(0), batch2);
+    scheduleNetworkResponses(std::move(responses), CursorResponse::ResponseType::InitialResponse);
+    executor()->waitForEvent(readyEvent);
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 1}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{_id: 2}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_TRUE(arm->ready());
+    ASSERT(!unittest::assertGet(arm->nextReady()));
+}
+
+TEST_F(AsyncResultsMergerTest, RetryStaleRemotesFailsOnOtherErrors) {
+    BSONObj findCmd = fromjson("{find: 'testcoll'}");
+    makeCursorFromFindCmd(findCmd, {kTestShardIds[0]});
+
+    ASSERT_FALSE(arm->ready());
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+    ASSERT_FALSE(arm->ready());
+
+    scheduleErrorResponse({ErrorCodes::BadValue, "bad thing happened"});
+    executor()->waitForEvent(readyEvent);
+
+    bool calledMakeCmdObj = false;
+    auto retryStatus = arm->retryStaleRemotes([&](const ShardId&) -> StatusWith<BSONObj> {
+        calledMakeCmdObj = true;
+        return findCmd;
+    });
+    ASSERT_EQ(ErrorCodes::BadValue, retryStatus.code());
+    ASSERT_FALSE(calledMakeCmdObj);
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(ErrorCodes::BadValue, arm->nextReady().getStatus().code());
+
+    // Required to kill the 'arm' on error before destruction.
+    auto killEvent = arm->kill();
+    executor()->waitForEvent(killEvent);
+}
+
 }  // namespace
 
 }  // namespace mongo
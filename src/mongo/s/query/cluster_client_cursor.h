@@ -31,6 +31,7 @@
 #include <boost/optional.hpp>
 
 #include "mongo/db/jsobj.h"
+#include "mongo/s/query/cluster_client_cursor_params.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
@@ -105,6 +106,14 @@ public:
      * the cursor is not tailable + awaitData).
      */
     virtual Status setAwaitDataTimeout(Milliseconds awaitDataTimeout) = 0;
+
+    /**
+     * Re-sends the cursor establishment command, as returned for their shard by 'makeCmdObj', to
+     * the remotes which failed to establish their cursor because of a stale shard version, without
+     * affecting the other remotes. Returns a non-OK status if any remote failed for another reason.
+     */
+    virtual Status retryStaleRemotes(
+        const ClusterClientCursorParams::MakeEstablishCmdFn& makeCmdObj) = 0;
 };
 
 }  // namespace mongo
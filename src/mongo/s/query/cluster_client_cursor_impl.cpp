@@ -113,6 +113,11 @@ Status ClusterClientCursorImpl::setAwaitDataTimeout(Milliseconds awaitDataTimeou
     return _root->setAwaitDataTimeout(awaitDataTimeout);
 }
 
+Status ClusterClientCursorImpl::retryStaleRemotes(
+    const ClusterClientCursorParams::MakeEstablishCmdFn& makeCmdObj) {
+    return _root->retryStaleRemotes(makeCmdObj);
+}
+
 std::unique_ptr<RouterExecStage> ClusterClientCursorImpl::buildMergerPlan(
     executor::TaskExecutor* executor, ClusterClientCursorParams&& params) {
     const auto skip = params.skip;
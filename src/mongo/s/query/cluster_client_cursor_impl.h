@@ -105,6 +105,8 @@ public:
 
     Status setAwaitDataTimeout(Milliseconds awaitDataTimeout) final;
 
+    Status retryStaleRemotes(const ClusterClientCursorParams::MakeEstablishCmdFn& makeCmdObj) final;
+
 private:
     /**
      * Constructs a cluster client cursor.
@@ -97,4 +97,9 @@ Status ClusterClientCursorMock::setAwaitDataTimeout(Milliseconds awaitDataTimeou
     MONGO_UNREACHABLE;
 }
 
+Status ClusterClientCursorMock::retryStaleRemotes(
+    const ClusterClientCursorParams::MakeEstablishCmdFn& makeCmdObj) {
+    MONGO_UNREACHABLE;
+}
+
 }  // namespace mongo
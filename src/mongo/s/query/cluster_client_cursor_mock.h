@@ -55,6 +55,8 @@ public:
 
     Status setAwaitDataTimeout(Milliseconds awaitDataTimeout) final;
 
+    Status retryStaleRemotes(const ClusterClientCursorParams::MakeEstablishCmdFn& makeCmdObj) final;
+
     /**
      * Returns true unless marked as having non-exhausted remote cursors via
      * markRemotesNotExhausted().
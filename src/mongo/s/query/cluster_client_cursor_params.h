@@ -32,11 +32,13 @@
 #include <memory>
 #include <vector>
 
+#include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/client/read_preference.h"
 #include "mongo/db/cursor_id.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/s/client/shard.h"
+#include "mongo/stdx/functional.h"
 #include "mongo/util/net/hostandport.h"
 
 namespace mongo {
@@ -48,6 +50,10 @@ struct ClusterClientCursorParams {
     // order, it requests a sortKey meta-projection using this field name.
     static const char kSortKeyField[];
 
+    // Returns the command with which to establish again the cursor on the given shard, typically
+    // carrying a refreshed shard version.
+    using MakeEstablishCmdFn = stdx::function<StatusWith<BSONObj>(const ShardId& shardId)>;
+
     /**
      * Contains any CCC parameters that are specified per-remote node.
      */
@@ -35,11 +35,13 @@
 #include <set>
 #include <vector>
 
+#include "mongo/base/counter.h"
 #include "mongo/base/status_with.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/client/connpool.h"
 #include "mongo/client/read_preference.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/getmore_request.h"
@@ -54,9 +56,11 @@
 #include "mongo/s/grid.h"
 #include "mongo/s/query/cluster_client_cursor_impl.h"
 #include "mongo/s/query/cluster_cursor_manager.h"
+#include "mongo/s/query/cluster_query_result_cache.h"
 #include "mongo/s/query/store_possible_cursor.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/clock_source.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 
@@ -73,6 +77,50 @@ static const BSONObj kSortKeyMetaProjection = BSON("$meta"
 // more than 8 decimal digits since the response is at most 16MB, and 16 * 1024 * 1024 < 1 * 10^8.
 static const int kPerDocumentOverheadBytesUpperBound = 10;
 
+Counter64 resultCacheHitStats;
+ServerStatusMetricField<Counter64> displayResultCacheHits("query.clusterResultCache.hits",
+                                                          &resultCacheHitStats);
+
+Counter64 resultCacheMissStats;
+ServerStatusMetricField<Counter64> displayResultCacheMisses("query.clusterResultCache.misses",
+                                                            &resultCacheMissStats);
+
+/**
+ * Returns true if the complete result set of 'query' may be served from and stored in the cluster
+ * query result cache.
+ */
+bool canUseResultCache(const CanonicalQuery& query) {
+    const auto& qr = query.getQueryRequest();
+    return ClusterQueryResultCache::isEnabledForNamespace(query.nss()) && !qr.isTailable() &&
+        !qr.isAllowPartialResults() && !qr.isExplain();
+}
+
+/**
+ * Returns the cluster query result cache key for 'query' targeted using 'chunkManager' or, if the
+ * collection is not sharded, sent to 'primary'.
+ */
+BSONObj makeResultCacheKey(const CanonicalQuery& query,
+                           const ReadPreferenceSetting& readPref,
+                           const ChunkManager* chunkManager,
+                           const Shard* primary) {
+    BSONObjBuilder keyBuilder;
+    {
+        // The find command includes the read concern.
+        BSONObjBuilder findBuilder(keyBuilder.subobjStart("find"));
+        query.getQueryRequest().asFindCommand(&findBuilder);
+    }
+    keyBuilder.append("readPref", readPref.toBSON());
+    if (chunkManager) {
+        chunkManager->getVersion().appendWithFieldForCommands(&keyBuilder, "version");
+        keyBuilder.append("sequenceNumber",
+                          static_cast<long long>(chunkManager->getSequenceNumber()));
+    } else {
+        invariant(primary);
+        keyBuilder.append("primary", primary->getId().toString());
+    }
+    return keyBuilder.obj();
+}
+
 /**
  * Given the QueryRequest 'qr' being executed by mongos, returns a copy of the query which is
  * suitable for forwarding to the targeted hosts.
@@ -145,9 +193,74 @@ StatusWith<std::unique_ptr<QueryRequest>> transformQueryForShards(const QueryReq
     return std::move(newQR);
 }
 
+/**
+ * Returns the find command to forward to 'shardId', with the shard version of the collection on
+ * that shard according to 'chunkManager' attached, or the unsharded version if 'chunkManager' is
+ * null.
+ */
+BSONObj makeFindCmdForShard(const NamespaceString& nss,
+                            const QueryRequest& qrToForward,
+                            const ChunkManager* chunkManager,
+                            const ShardId& shardId) {
+    BSONObjBuilder cmdBuilder;
+    qrToForward.asFindCommand(&cmdBuilder);
+
+    if (chunkManager) {
+        ChunkVersion version(chunkManager->getVersion(shardId));
+        version.appendForCommands(&cmdBuilder);
+    } else if (!nss.isOnInternalDb()) {
+        ChunkVersion version(ChunkVersion::UNSHARDED());
+        version.appendForCommands(&cmdBuilder);
+    }
+
+    return cmdBuilder.obj();
+}
+
+/**
+ * Called when a shard targeted by 'query' against a sharded collection reported a stale shard
+ * version while establishing its cursor. Refreshes the routing table and, if the query still
+ * targets exactly 'shardIds', makes 'ccc' send the find command again with the refreshed shard
+ * version to the stale shards only, keeping the cursors established on the others.
+ *
+ * Returns false if the whole query has to be re-targeted instead.
+ */
+bool retryStaleShards(OperationContext* txn,
+                      const CanonicalQuery& query,
+                      DBConfig* dbConfig,
+                      const std::set<ShardId>& shardIds,
+                      const QueryRequest& qrToForward,
+                      ClusterClientCursorGuard& ccc) {
+    auto chunkManager = dbConfig->getChunkManagerIfExists(txn, query.nss().ns(), true);
+    if (!chunkManager) {
+        return false;
+    }
+
+    std::set<ShardId> newShardIds;
+    chunkManager->getShardIdsForQuery(txn, query.getQueryRequest().getFilter(), &newShardIds);
+    if (newShardIds != shardIds) {
+        return false;
+    }
+
+    auto retryStatus =
+        ccc->retryStaleRemotes([&](const ShardId& shardId) -> StatusWith<BSONObj> {
+            return makeFindCmdForShard(query.nss(), qrToForward, chunkManager.get(), shardId);
+        });
+    if (!retryStatus.isOK()) {
+        LOG(1) << "Could not retry only the stale shards for query " << query.toStringShort()
+               << causedBy(retryStatus);
+        return false;
+    }
+
+    // Results cached for the old routing information can no longer be trusted, and those of this
+    // query must not be cached under it either.
+    ClusterQueryResultCache::get(txn)->invalidate(query.nss());
+    return true;
+}
+
 StatusWith<CursorId> runQueryWithoutRetrying(OperationContext* txn,
                                              const CanonicalQuery& query,
                                              const ReadPreferenceSetting& readPref,
+                                             DBConfig* dbConfig,
                                              ChunkManager* chunkManager,
                                              std::shared_ptr<Shard> primary,
                                              std::vector<BSONObj>* results) {
@@ -155,12 +268,12 @@ StatusWith<CursorId> runQueryWithoutRetrying(OperationContext* txn,
 
     // Get the set of shards on which we will run the query.
     std::vector<std::shared_ptr<Shard>> shards;
+    std::set<ShardId> shardIds;
     if (primary) {
         shards.emplace_back(std::move(primary));
     } else {
         invariant(chunkManager);
 
-        std::set<ShardId> shardIds;
         chunkManager->getShardIdsForQuery(txn, query.getQueryRequest().getFilter(), &shardIds);
 
         for (auto id : shardIds) {
@@ -208,19 +321,10 @@ StatusWith<CursorId> runQueryWithoutRetrying(OperationContext* txn,
     for (const auto& shard : shards) {
         invariant(!shard->isConfig() || shard->getConnString().type() != ConnectionString::INVALID);
 
-        // Build the find command, and attach shard version if necessary.
-        BSONObjBuilder cmdBuilder;
-        qrToForward.getValue()->asFindCommand(&cmdBuilder);
-
-        if (chunkManager) {
-            ChunkVersion version(chunkManager->getVersion(shard->getId()));
-            version.appendForCommands(&cmdBuilder);
-        } else if (!query.nss().isOnInternalDb()) {
-            ChunkVersion version(ChunkVersion::UNSHARDED());
-            version.appendForCommands(&cmdBuilder);
-        }
-
-        params.remotes.emplace_back(shard->getId(), cmdBuilder.obj());
+        params.remotes.emplace_back(
+            shard->getId(),
+            makeFindCmdForShard(
+                query.nss(), *qrToForward.getValue(), chunkManager, shard->getId()));
     }
 
     auto ccc = ClusterClientCursorImpl::make(
@@ -228,9 +332,24 @@ StatusWith<CursorId> runQueryWithoutRetrying(OperationContext* txn,
 
     auto cursorState = ClusterCursorManager::CursorState::NotExhausted;
     int bytesBuffered = 0;
+    size_t staleShardRetries = 0;
     while (!FindCommon::enoughForFirstBatch(query.getQueryRequest(), results->size())) {
         auto next = ccc->next();
         if (!next.isOK()) {
+            // A shard with a stale version is retried on its own as long as the refreshed routing
+            // table targets the same shards. A changed epoch means the collection was dropped and
+            // recreated, which always requires re-targeting the whole query.
+            const auto& status = next.getStatus();
+            if (chunkManager && ErrorCodes::isStaleShardingError(status.code()) &&
+                status != ErrorCodes::StaleEpoch &&
+                staleShardRetries < ClusterFind::kMaxStaleConfigRetries &&
+                retryStaleShards(
+                    txn, query, dbConfig, shardIds, *qrToForward.getValue(), ccc)) {
+                LOG(1) << "Retrying stale shards for query " << query.toStringShort()
+                       << " on attempt " << ++staleShardRetries << " of "
+                       << ClusterFind::kMaxStaleConfigRetries << causedBy(status);
+                continue;
+            }
             return next.getStatus();
         }
 
@@ -311,12 +430,41 @@ StatusWith<CursorId> ClusterFind::runQuery(OperationContext* txn,
     std::shared_ptr<Shard> primary;
     dbConfig.getValue()->getChunkManagerOrPrimary(txn, query.nss().ns(), chunkManager, primary);
 
+    // Serve the query from the result cache if this mongos has recently run it against the same
+    // routing information.
+    auto resultCache = ClusterQueryResultCache::get(txn);
+    const bool useResultCache = canUseResultCache(query);
+    BSONObj resultCacheKey;
+    unsigned long long resultCacheGeneration = 0;
+    if (useResultCache) {
+        resultCacheKey = makeResultCacheKey(query, readPref, chunkManager.get(), primary.get());
+        resultCacheGeneration = resultCache->getGeneration(query.nss());
+        auto now = txn->getServiceContext()->getFastClockSource()->now();
+        if (resultCache->lookup(query.nss(), resultCacheKey, now, results)) {
+            resultCacheHitStats.increment();
+            return CursorId(0);
+        }
+        resultCacheMissStats.increment();
+    }
+
     // Re-target and re-send the initial find command to the shards until we have established the
     // shard version.
     for (size_t retries = 1; retries <= kMaxStaleConfigRetries; ++retries) {
-        auto cursorId = runQueryWithoutRetrying(
-            txn, query, readPref, chunkManager.get(), std::move(primary), results);
+        auto cursorId = runQueryWithoutRetrying(txn,
+                                                query,
+                                                readPref,
+                                                dbConfig.getValue().get(),
+                                                chunkManager.get(),
+                                                std::move(primary),
+                                                results);
         if (cursorId.isOK()) {
+            // Only complete result sets are cached. If the query had to be retried, the cache
+            // entries for the namespace were invalidated and the results are not inserted.
+            if (useResultCache && cursorId.getValue() == 0) {
+                auto now = txn->getServiceContext()->getFastClockSource()->now();
+                resultCache->insert(
+                    query.nss(), resultCacheKey, resultCacheGeneration, *results, now);
+            }
             return cursorId;
         }
         auto status = std::move(cursorId.getStatus());
@@ -332,6 +480,9 @@ StatusWith<CursorId> ClusterFind::runQuery(OperationContext* txn,
         LOG(1) << "Received error status for query " << query.toStringShort() << " on attempt "
                << retries << " of " << kMaxStaleConfigRetries << ": " << status;
 
+        // Results cached for the old routing information can no longer be trusted.
+        resultCache->invalidate(query.nss());
+
         const bool staleEpoch = (status == ErrorCodes::StaleEpoch);
         if (staleEpoch) {
             if (!dbConfig.getValue()->reload(txn)) {
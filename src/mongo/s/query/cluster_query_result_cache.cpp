@@ -0,0 +1,181 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/cluster_query_result_cache.h"
+
+#include <algorithm>
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(clusterQueryResultCacheNamespaces,
+                                      std::vector<std::string>,
+                                      std::vector<std::string>{});
+
+MONGO_EXPORT_SERVER_PARAMETER(clusterQueryResultCacheMaxSizeBytes, long long, 64 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(clusterQueryResultCacheTTLMillis, int, 1000);
+
+namespace {
+
+const auto getCache = ServiceContext::declareDecoration<ClusterQueryResultCache>();
+
+std::string makeIndexKey(const NamespaceString& nss, const BSONObj& key) {
+    std::string indexKey = nss.ns();
+    indexKey.push_back('\0');
+    indexKey.append(key.objdata(), key.objsize());
+    return indexKey;
+}
+
+}  // namespace
+
+ClusterQueryResultCache* ClusterQueryResultCache::get(ServiceContext* serviceContext) {
+    return &getCache(serviceContext);
+}
+
+ClusterQueryResultCache* ClusterQueryResultCache::get(OperationContext* txn) {
+    return get(txn->getServiceContext());
+}
+
+bool ClusterQueryResultCache::isEnabledForNamespace(const NamespaceString& nss) {
+    // Only set at startup, so it is safe to read without synchronization.
+    const auto& namespaces = clusterQueryResultCacheNamespaces;
+    return std::find(namespaces.begin(), namespaces.end(), nss.ns()) != namespaces.end();
+}
+
+unsigned long long ClusterQueryResultCache::getGeneration(const NamespaceString& nss) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto it = _generations.find(nss.ns());
+    return it == _generations.end() ? 0 : it->second;
+}
+
+bool ClusterQueryResultCache::lookup(const NamespaceString& nss,
+                                     const BSONObj& key,
+                                     Date_t now,
+                                     std::vector<BSONObj>* results) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto indexIt = _index.find(makeIndexKey(nss, key));
+    if (indexIt == _index.end()) {
+        return false;
+    }
+
+    auto entryIt = indexIt->second;
+    if (now - entryIt->readAt >= Milliseconds(clusterQueryResultCacheTTLMillis.load())) {
+        _erase_inlock(entryIt);
+        return false;
+    }
+
+    // Move the entry to the front of the LRU list.
+    _entries.splice(_entries.begin(), _entries, entryIt);
+    *results = entryIt->results;
+    return true;
+}
+
+void ClusterQueryResultCache::insert(const NamespaceString& nss,
+                                     const BSONObj& key,
+                                     unsigned long long generation,
+                                     const std::vector<BSONObj>& results,
+                                     Date_t now) {
+    long long sizeBytes = 0;
+    std::vector<BSONObj> ownedResults;
+    ownedResults.reserve(results.size());
+    for (const auto& result : results) {
+        sizeBytes += result.objsize();
+        ownedResults.push_back(result.getOwned());
+    }
+
+    const long long maxSizeBytes = clusterQueryResultCacheMaxSizeBytes.load();
+    if (sizeBytes > maxSizeBytes) {
+        return;
+    }
+
+    auto indexKey = makeIndexKey(nss, key);
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    auto generationIt = _generations.find(nss.ns());
+    if (generation != (generationIt == _generations.end() ? 0 : generationIt->second)) {
+        // The namespace was invalidated while the results were being read.
+        return;
+    }
+
+    auto indexIt = _index.find(indexKey);
+    if (indexIt != _index.end()) {
+        _erase_inlock(indexIt->second);
+    }
+
+    while (!_entries.empty() && _sizeBytes + sizeBytes > maxSizeBytes) {
+        _erase_inlock(std::prev(_entries.end()));
+    }
+
+    _entries.push_front(Entry{nss.ns(), indexKey, std::move(ownedResults), sizeBytes, now});
+    _index[indexKey] = _entries.begin();
+    _sizeBytes += sizeBytes;
+}
+
+void ClusterQueryResultCache::invalidate(const NamespaceString& nss) {
+    if (!isEnabledForNamespace(nss)) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ++_generations[nss.ns()];
+
+    // The number of entries is bounded by the cache size, so a scan is cheap enough compared to the
+    // write or shard version refresh which triggered the invalidation.
+    auto it = _entries.begin();
+    while (it != _entries.end()) {
+        auto next = std::next(it);
+        if (it->ns == nss.ns()) {
+            _erase_inlock(it);
+        }
+        it = next;
+    }
+}
+
+size_t ClusterQueryResultCache::size() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _entries.size();
+}
+
+long long ClusterQueryResultCache::getSizeBytes() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _sizeBytes;
+}
+
+void ClusterQueryResultCache::_erase_inlock(EntryList::iterator it) {
+    _sizeBytes -= it->sizeBytes;
+    _index.erase(it->key);
+    _entries.erase(it);
+}
+
+}  // namespace mongo
@@ -0,0 +1,159 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class OperationContext;
+class ServiceContext;
+
+// Namespaces whose query results may be cached by mongos. Empty by default, which disables the
+// cache entirely.
+extern std::vector<std::string> clusterQueryResultCacheNamespaces;
+
+// Upper bound on the total size of the cached result documents.
+extern std::atomic<long long> clusterQueryResultCacheMaxSizeBytes;  // NOLINT
+
+// How long a cached result set may be returned after it was read from the shards.
+extern std::atomic<int> clusterQueryResultCacheTTLMillis;  // NOLINT
+
+/**
+ * ClusterQueryResultCache holds the complete result sets of recently run read-only queries, so
+ * that mongos can answer repeated identical queries without contacting the shards.
+ *
+ * Entries are keyed on the namespace and on a caller-provided key, which must describe everything
+ * the results depend on: the query itself, the read concern, the read preference and the version
+ * of the routing information used to target the shards. A change in routing information
+ * therefore never returns stale results. Writes routed through this mongos and stale shard version
+ * errors invalidate all entries for the affected namespace. Writes routed through other mongos
+ * processes are only reflected once an entry expires.
+ *
+ * The total size of the cached results is bounded, with the least recently used entries evicted
+ * first.
+ *
+ * This class is thread-safe.
+ */
+class ClusterQueryResultCache {
+    MONGO_DISALLOW_COPYING(ClusterQueryResultCache);
+
+public:
+    ClusterQueryResultCache() = default;
+
+    static ClusterQueryResultCache* get(ServiceContext* serviceContext);
+    static ClusterQueryResultCache* get(OperationContext* txn);
+
+    /**
+     * Returns true if results of queries against 'nss' may be cached.
+     */
+    static bool isEnabledForNamespace(const NamespaceString& nss);
+
+    /**
+     * Returns the invalidation generation of 'nss'. Callers must obtain it before running a query
+     * and pass it to insert(), so that results read concurrently with an invalidation are not
+     * cached.
+     */
+    unsigned long long getGeneration(const NamespaceString& nss);
+
+    /**
+     * Fills 'results' and returns true if there is an entry for 'key' on 'nss' which has not
+     * expired by 'now'.
+     */
+    bool lookup(const NamespaceString& nss,
+                const BSONObj& key,
+                Date_t now,
+                std::vector<BSONObj>* results);
+
+    /**
+     * Caches 'results' as the complete result set for 'key' on 'nss' read at 'now', unless 'nss'
+     * has been invalidated since 'generation' was obtained or the results do not fit in the cache.
+     */
+    void insert(const NamespaceString& nss,
+                const BSONObj& key,
+                unsigned long long generation,
+                const std::vector<BSONObj>& results,
+                Date_t now);
+
+    /**
+     * Removes all entries for 'nss'.
+     */
+    void invalidate(const NamespaceString& nss);
+
+    /**
+     * Returns the number of cached entries.
+     */
+    size_t size();
+
+    /**
+     * Returns the total size of the cached result documents.
+     */
+    long long getSizeBytes();
+
+private:
+    struct Entry {
+        std::string ns;
+        std::string key;
+        std::vector<BSONObj> results;
+        long long sizeBytes;
+        Date_t readAt;
+    };
+
+    using EntryList = std::list<Entry>;
+
+    /**
+     * Removes the entry at 'it' from both the LRU list and the index.
+     */
+    void _erase_inlock(EntryList::iterator it);
+
+    stdx::mutex _mutex;
+
+    // Entries in least recently used order, most recently used first.
+    EntryList _entries;
+
+    // Index of '_entries' by namespace and key.
+    std::unordered_map<std::string, EntryList::iterator> _index;
+
+    // Incremented for a namespace each time its entries are invalidated.
+    std::unordered_map<std::string, unsigned long long> _generations;
+
+    long long _sizeBytes = 0;
+};
+
+}  // namespace mongo
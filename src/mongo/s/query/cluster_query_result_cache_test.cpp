@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/cluster_query_result_cache.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString kNss("testdb.testcoll");
+const NamespaceString kOtherNss("testdb.othercoll");
+
+class ClusterQueryResultCacheTest : public unittest::Test {
+protected:
+    void setUp() override {
+        _savedNamespaces = clusterQueryResultCacheNamespaces;
+        _savedMaxSizeBytes = clusterQueryResultCacheMaxSizeBytes.load();
+        _savedTTLMillis = clusterQueryResultCacheTTLMillis.load();
+        clusterQueryResultCacheNamespaces = {kNss.ns(), kOtherNss.ns()};
+    }
+
+    void tearDown() override {
+        clusterQueryResultCacheNamespaces = _savedNamespaces;
+        clusterQueryResultCacheMaxSizeBytes.store(_savedMaxSizeBytes);
+        clusterQueryResultCacheTTLMillis.store(_savedTTLMillis);
+    }
+
+    void insert(const NamespaceString& nss, const BSONObj& key, std::vector<BSONObj> results) {
+        cache.insert(nss, key, cache.getGeneration(nss), results, now);
+    }
+
+    ClusterQueryResultCache cache;
+    Date_t now = Date_t::fromMillisSinceEpoch(1000);
+
+private:
+    std::vector<std::string> _savedNamespaces;
+    long long _savedMaxSizeBytes = 0;
+    int _savedTTLMillis = 0;
+};
+
+TEST_F(ClusterQueryResultCacheTest, OnlyConfiguredNamespacesAreEnabled) {
+    ASSERT_TRUE(ClusterQueryResultCache::isEnabledForNamespace(kNss));
+    ASSERT_FALSE(ClusterQueryResultCache::isEnabledForNamespace(NamespaceString("testdb.other")));
+}
+
+TEST_F(ClusterQueryResultCacheTest, LookupReturnsInsertedResults) {
+    insert(kNss, BSON("filter" << BSON("a" << 1)), {BSON("_id" << 1), BSON("_id" << 2)});
+
+    std::vector<BSONObj> results;
+    ASSERT_TRUE(cache.lookup(kNss, BSON("filter" << BSON("a" << 1)), now, &results));
+    ASSERT_EQUALS(2U, results.size());
+    ASSERT_EQUALS(BSON("_id" << 1), results[0]);
+    ASSERT_EQUALS(BSON("_id" << 2), results[1]);
+
+    ASSERT_FALSE(cache.lookup(kNss, BSON("filter" << BSON("a" << 2)), now, &results));
+    ASSERT_FALSE(cache.lookup(kOtherNss, BSON("filter" << BSON("a" << 1)), now, &results));
+}
+
+TEST_F(ClusterQueryResultCacheTest, EntriesExpireAfterTTL) {
+    clusterQueryResultCacheTTLMillis.store(100);
+    insert(kNss, BSON("filter" << BSONObj()), {BSON("_id" << 1)});
+
+    std::vector<BSONObj> results;
+    ASSERT_TRUE(cache.lookup(kNss, BSON("filter" << BSONObj()), now + Milliseconds(99), &results));
+    ASSERT_FALSE(
+        cache.lookup(kNss, BSON("filter" << BSONObj()), now + Milliseconds(100), &results));
+    ASSERT_EQUALS(0U, cache.size());
+    ASSERT_EQUALS(0, cache.getSizeBytes());
+}
+
+TEST_F(ClusterQueryResultCacheTest, InvalidateRemovesOnlyEntriesForNamespace) {
+    insert(kNss, BSON("filter" << BSONObj()), {BSON("_id" << 1)});
+    insert(kOtherNss, BSON("filter" << BSONObj()), {BSON("_id" << 2)});
+    ASSERT_EQUALS(2U, cache.size());
+
+    cache.invalidate(kNss);
+
+    std::vector<BSONObj> results;
+    ASSERT_FALSE(cache.lookup(kNss, BSON("filter" << BSONObj()), now, &results));
+    ASSERT_TRUE(cache.lookup(kOtherNss, BSON("filter" << BSONObj()), now, &results));
+    ASSERT_EQUALS(1U, cache.size());
+}
+
+TEST_F(ClusterQueryResultCacheTest, ResultsReadDuringInvalidationAreNotInserted) {
+    auto generation = cache.getGeneration(kNss);
+    cache.invalidate(kNss);
+    cache.insert(kNss, BSON("filter" << BSONObj()), generation, {BSON("_id" << 1)}, now);
+
+    std::vector<BSONObj> results;
+    ASSERT_FALSE(cache.lookup(kNss, BSON("filter" << BSONObj()), now, &results));
+    ASSERT_EQUALS(0U, cache.size());
+}
+
+TEST_F(ClusterQueryResultCacheTest, LeastRecentlyUsedEntryIsEvictedWhenFull) {
+    const BSONObj doc = BSON("_id" << 1);
+    clusterQueryResultCacheMaxSizeBytes.store(2 * doc.objsize());
+
+    insert(kNss, BSON("filter" << 1), {doc});
+    insert(kNss, BSON("filter" << 2), {doc});
+
+    // Use the first entry so that the second one is the least recently used.
+    std::vector<BSONObj> results;
+    ASSERT_TRUE(cache.lookup(kNss, BSON("filter" << 1), now, &results));
+
+    insert(kNss, BSON("filter" << 3), {doc});
+    ASSERT_EQUALS(2U, cache.size());
+    ASSERT_EQUALS(2 * doc.objsize(), cache.getSizeBytes());
+    ASSERT_TRUE(cache.lookup(kNss, BSON("filter" << 1), now, &results));
+    ASSERT_FALSE(cache.lookup(kNss, BSON("filter" << 2), now, &results));
+    ASSERT_TRUE(cache.lookup(kNss, BSON("filter" << 3), now, &results));
+}
+
+TEST_F(ClusterQueryResultCacheTest, ResultsLargerThanCacheAreNotInserted) {
+    const BSONObj doc = BSON("_id" << 1);
+    clusterQueryResultCacheMaxSizeBytes.store(doc.objsize());
+
+    insert(kNss, BSON("filter" << 1), {doc, doc});
+    ASSERT_EQUALS(0U, cache.size());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -33,6 +33,7 @@
 
 #include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/s/query/cluster_client_cursor_params.h"
 #include "mongo/util/time_support.h"
 
 namespace mongo {
@@ -85,6 +86,14 @@ public:
      */
     virtual Status setAwaitDataTimeout(Milliseconds awaitDataTimeout) = 0;
 
+    /**
+     * Re-sends the cursor establishment command, as returned for their shard by 'makeCmdObj', to
+     * the remotes which failed to establish their cursor because of a stale shard version, without
+     * affecting the other remotes. Returns a non-OK status if any remote failed for another reason.
+     */
+    virtual Status retryStaleRemotes(
+        const ClusterClientCursorParams::MakeEstablishCmdFn& makeCmdObj) = 0;
+
 protected:
     /**
      * Returns an unowned pointer to the child stage, or nullptr if there is no child.
@@ -67,4 +67,9 @@ Status RouterStageLimit::setAwaitDataTimeout(Milliseconds awaitDataTimeout) {
     return getChildStage()->setAwaitDataTimeout(awaitDataTimeout);
 }
 
+Status RouterStageLimit::retryStaleRemotes(
+    const ClusterClientCursorParams::MakeEstablishCmdFn& makeCmdObj) {
+    return getChildStage()->retryStaleRemotes(makeCmdObj);
+}
+
 }  // namespace mongo
@@ -47,6 +47,8 @@ public:
 
     Status setAwaitDataTimeout(Milliseconds awaitDataTimeout) final;
 
+    Status retryStaleRemotes(const ClusterClientCursorParams::MakeEstablishCmdFn& makeCmdObj) final;
+
 private:
     long long _limit;
 
@@ -68,4 +68,9 @@ Status RouterStageMerge::setAwaitDataTimeout(Milliseconds awaitDataTimeout) {
     return _arm.setAwaitDataTimeout(awaitDataTimeout);
 }
 
+Status RouterStageMerge::retryStaleRemotes(
+    const ClusterClientCursorParams::MakeEstablishCmdFn& makeCmdObj) {
+    return _arm.retryStaleRemotes(makeCmdObj);
+}
+
 }  // namespace mongo
@@ -53,6 +53,8 @@ public:
 
     Status setAwaitDataTimeout(Milliseconds awaitDataTimeout) final;
 
+    Status retryStaleRemotes(const ClusterClientCursorParams::MakeEstablishCmdFn& makeCmdObj) final;
+
 private:
     // Not owned here.
     executor::TaskExecutor* _executor;
@@ -32,6 +32,8 @@
 
 #include "mongo/s/query/router_stage_mock.h"
 
+#include "mongo/util/assert_util.h"
+
 namespace mongo {
 
 void RouterStageMock::queueResult(BSONObj obj) {
@@ -73,6 +75,11 @@ Status RouterStageMock::setAwaitDataTimeout(Milliseconds awaitDataTimeout) {
     return Status::OK();
 }
 
+Status RouterStageMock::retryStaleRemotes(
+    const ClusterClientCursorParams::MakeEstablishCmdFn& makeCmdObj) {
+    MONGO_UNREACHABLE;
+}
+
 StatusWith<Milliseconds> RouterStageMock::getAwaitDataTimeout() {
     if (!_awaitDataTimeout) {
         return Status(ErrorCodes::BadValue, "no awaitData timeout set");
@@ -69,4 +69,9 @@ Status RouterStageRemoveSortKey::setAwaitDataTimeout(Milliseconds awaitDataTimeo
     return getChildStage()->setAwaitDataTimeout(awaitDataTimeout);
 }
 
+Status RouterStageRemoveSortKey::retryStaleRemotes(
+    const ClusterClientCursorParams::MakeEstablishCmdFn& makeCmdObj) {
+    return getChildStage()->retryStaleRemotes(makeCmdObj);
+}
+
 }  // namespace mongo
@@ -68,4 +68,9 @@ Status RouterStageSkip::setAwaitDataTimeout(Milliseconds awaitDataTimeout) {
     return getChildStage()->setAwaitDataTimeout(awaitDataTimeout);
 }
 
+Status RouterStageSkip::retryStaleRemotes(
+    const ClusterClientCursorParams::MakeEstablishCmdFn& makeCmdObj) {
+    return getChildStage()->retryStaleRemotes(makeCmdObj);
+}
+
 }  // namespace mongo
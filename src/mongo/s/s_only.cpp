@@ -49,6 +49,7 @@
 #include "mongo/util/assert_util.h"
 #include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/log.h"
+#include "mongo/util/sampling_profiler.h"
 #include "mongo/util/scopeguard.h"
 
 namespace mongo {
@@ -101,6 +102,7 @@ void Command::execCommandClientBasic(OperationContext* txn,
                                      const char* ns,
                                      BSONObj& cmdObj,
                                      BSONObjBuilder& result) {
+    SamplingProfiler::ScopedTag profilerTag(c->getName().c_str());
     std::string dbname = nsToDatabase(ns);
 
     if (cmdObj.getBoolField("help")) {
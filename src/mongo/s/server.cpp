@@ -73,6 +73,7 @@
 #include "mongo/s/client/sharding_connection_hook_for_mongos.h"
 #include "mongo/s/commands/request.h"
 #include "mongo/s/config.h"
+#include "mongo/s/config_change_watcher.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/mongos_options.h"
 #include "mongo/s/query/cluster_cursor_cleanup_job.h"
@@ -119,6 +120,8 @@ namespace {
 
 boost::optional<ShardingUptimeReporter> shardingUptimeReporter;
 
+boost::optional<ConfigChangeWatcher> configChangeWatcher;
+
 }  // namespace
 
 #if defined(_WIN32)
@@ -338,6 +341,9 @@ static ExitCode runMongosServer() {
     shardingUptimeReporter.emplace();
     shardingUptimeReporter->startPeriodicThread();
 
+    configChangeWatcher.emplace();
+    configChangeWatcher->startThread();
+
     Balancer::create(getGlobalServiceContext());
 
     clusterCursorCleanupJob.go();
@@ -388,6 +394,7 @@ static int _main() {
     if (!initializeServerGlobalState())
         return EXIT_FAILURE;
 
+    logGlobalInitializerTimes();
     startSignalProcessingThread();
 
     getGlobalServiceContext()->setFastClockSource(FastClockSourceFactory::create(Milliseconds{10}));
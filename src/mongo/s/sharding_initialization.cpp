@@ -37,6 +37,7 @@
 #include "mongo/base/status.h"
 #include "mongo/client/remote_command_targeter_factory_impl.h"
 #include "mongo/db/audit.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/server_options.h"
 #include "mongo/db/service_context.h"
 #include "mongo/executor/network_interface_factory.h"
@@ -59,6 +60,7 @@
 #include "mongo/s/query/cluster_cursor_manager.h"
 #include "mongo/s/sharding_egress_metadata_hook.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -72,6 +74,11 @@ using executor::NetworkInterfaceThreadPool;
 using executor::TaskExecutorPool;
 using executor::ThreadPoolTaskExecutor;
 
+// Number of threads running the callbacks of each executor of the TaskExecutorPool, which share
+// their work by stealing from each other. If 0, the callbacks run on the thread of the executor's
+// network interface instead.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(taskExecutorPoolCallbackThreads, int, 2);
+
 std::unique_ptr<ThreadPoolTaskExecutor> makeTaskExecutor(std::unique_ptr<NetworkInterface> net) {
     auto netPtr = net.get();
     return stdx::make_unique<ThreadPoolTaskExecutor>(
@@ -101,15 +108,23 @@ std::unique_ptr<ShardingCatalogClient> makeCatalogClient(ServiceContext* service
 std::unique_ptr<TaskExecutorPool> makeTaskExecutorPool(
     std::unique_ptr<NetworkInterface> fixedNet,
     std::unique_ptr<rpc::EgressMetadataHook> metadataHook) {
+    const int callbackThreads = taskExecutorPoolCallbackThreads;
     std::vector<std::unique_ptr<executor::TaskExecutor>> executors;
     for (size_t i = 0; i < TaskExecutorPool::getSuggestedPoolSize(); ++i) {
         auto net = executor::makeNetworkInterface(
             "NetworkInterfaceASIO-TaskExecutorPool-" + std::to_string(i),
             stdx::make_unique<ShardingNetworkConnectionHook>(),
             std::move(metadataHook));
-        auto netPtr = net.get();
-        auto exec = stdx::make_unique<ThreadPoolTaskExecutor>(
-            stdx::make_unique<NetworkInterfaceThreadPool>(netPtr), std::move(net));
+        std::unique_ptr<ThreadPoolInterface> pool;
+        if (callbackThreads > 0) {
+            WorkStealingThreadPool::Options options;
+            options.poolName = "TaskExecutorPool-" + std::to_string(i);
+            options.numThreads = callbackThreads;
+            pool = stdx::make_unique<WorkStealingThreadPool>(std::move(options));
+        } else {
+            pool = stdx::make_unique<NetworkInterfaceThreadPool>(net.get());
+        }
+        auto exec = stdx::make_unique<ThreadPoolTaskExecutor>(std::move(pool), std::move(net));
 
         executors.emplace_back(std::move(exec));
     }
@@ -32,12 +32,16 @@
 
 #include "mongo/s/write_ops/batch_write_exec.h"
 
+#include <algorithm>
+#include <deque>
+#include <map>
+
 #include "mongo/base/error_codes.h"
-#include "mongo/base/owned_pointer_map.h"
 #include "mongo/base/status.h"
 #include "mongo/bson/util/builder.h"
 #include "mongo/client/connection_string.h"
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/s/client/multi_command_dispatch.h"
 #include "mongo/s/client/shard_registry.h"
 #include "mongo/s/grid.h"
@@ -56,13 +60,17 @@ BatchWriteExec::BatchWriteExec(NSTargeter* targeter, MultiCommandDispatch* dispa
 
 namespace {
 
+// The number of child batches of an unordered write which may be out on the network to a single
+// shard at once
+MONGO_EXPORT_SERVER_PARAMETER(maxWriteBatchesInFlightPerShard, int, 2);
+
 //
 // Map which allows associating ConnectionString hosts with TargetedWriteBatches
 // This is needed since the dispatcher only returns hosts with responses.
 //
 
 // TODO: Unordered map?
-typedef OwnedPointerMap<ConnectionString, TargetedWriteBatch> OwnedHostBatchMap;
+typedef std::map<ConnectionString, std::deque<TargetedWriteBatch*>> HostBatchQueueMap;
 }
 
 static void buildErrorFrom(const Status& status, WriteErrorDetail* error) {
@@ -141,174 +149,165 @@ void BatchWriteExec::executeBatch(OperationContext* txn,
             dassert(childBatches.size() == 0u);
         }
 
-        //
-        // Send all child batches
-        //
-
-        size_t numSent = 0;
-        size_t numToSend = childBatches.size();
-        while (numSent != numToSend) {
-            // Collect batches out on the network, mapped by endpoint
-            OwnedHostBatchMap ownedPendingBatches;
-            OwnedHostBatchMap::MapType& pendingBatches = ownedPendingBatches.mutableMap();
-
-            //
-            // Send side
-            //
-
-            // Get as many batches as we can at once
-            for (vector<TargetedWriteBatch*>::iterator it = childBatches.begin();
-                 it != childBatches.end();
-                 ++it) {
-                //
-                // Collect the info needed to dispatch our targeted batch
-                //
-
-                TargetedWriteBatch* nextBatch = *it;
-                // If the batch is NULL, we sent it previously, so skip
-                if (nextBatch == NULL)
-                    continue;
-
-                // Figure out what host we need to dispatch our targeted batch
-                bool resolvedHost = true;
-                const ReadPreferenceSetting readPref(ReadPreference::PrimaryOnly, TagSet());
-                auto shard =
-                    grid.shardRegistry()->getShard(txn, nextBatch->getEndpoint().shardName);
-
-                if (!shard) {
-                    Status status = Status(ErrorCodes::ShardNotFound,
-                                           str::stream() << "unknown shard name "
-                                                         << nextBatch->getEndpoint().shardName);
-                    resolvedHost = false;
-
-                    // Record a resolve failure
-                    // TODO: It may be necessary to refresh the cache if stale, or maybe just
-                    // cancel and retarget the batch
-                    WriteErrorDetail error;
-                    buildErrorFrom(status, &error);
-                    LOG(4) << "unable to send write batch to " << nextBatch->getEndpoint().shardName
-                           << causedBy(status);
-                    batchOp.noteBatchError(*nextBatch, error);
+        // Unordered batches are targeted in full, so that each shard can be sent its next child
+        // batch as soon as it replies to the previous one, rather than after every shard has
+        // replied. Any targeting error leaves the remaining writes for the next round.
+        if (targetStatus.isOK() && !clientRequest.getOrdered()) {
+            while (batchOp.numWriteOpsIn(WriteOpState_Ready) > 0) {
+                const size_t numChildBatches = childBatches.size();
+                targetStatus =
+                    batchOp.targetBatch(txn, *_targeter, recordTargetErrors, &childBatches);
+                if (!targetStatus.isOK()) {
+                    _targeter->noteCouldNotTarget();
+                    refreshedTargeter = true;
+                    ++stats->numTargetErrors;
+                    break;
                 }
 
-                auto swHostAndPort = shard->getTargeter()->findHost(readPref);
-                if (!swHostAndPort.isOK()) {
-                    resolvedHost = false;
-
-                    // Record a resolve failure
-                    // TODO: It may be necessary to refresh the cache if stale, or maybe just
-                    // cancel and retarget the batch
-                    WriteErrorDetail error;
-                    buildErrorFrom(swHostAndPort.getStatus(), &error);
-                    LOG(4) << "unable to send write batch to " << nextBatch->getEndpoint().shardName
-                           << causedBy(swHostAndPort.getStatus());
-                    batchOp.noteBatchError(*nextBatch, error);
+                if (childBatches.size() == numChildBatches) {
+                    break;
                 }
+            }
+        }
 
-                if (!resolvedHost) {
-                    ++stats->numResolveErrors;
+        //
+        // Resolve the host of each child batch, queueing the batches by host
+        //
 
-                    // We're done with this batch
-                    // Clean up when we can't resolve a host
-                    delete *it;
-                    *it = NULL;
-                    --numToSend;
-                    continue;
-                }
+        HostBatchQueueMap queuedBatches;
+        for (TargetedWriteBatch* nextBatch : childBatches) {
+            // Figure out what host we need to dispatch our targeted batch
+            const ReadPreferenceSetting readPref(ReadPreference::PrimaryOnly, TagSet());
+            auto shard = grid.shardRegistry()->getShard(txn, nextBatch->getEndpoint().shardName);
+
+            StatusWith<HostAndPort> swHostAndPort = shard
+                ? shard->getTargeter()->findHost(readPref)
+                : StatusWith<HostAndPort>(ErrorCodes::ShardNotFound,
+                                          str::stream() << "unknown shard name "
+                                                        << nextBatch->getEndpoint().shardName);
+            if (!swHostAndPort.isOK()) {
+                // Record a resolve failure
+                // TODO: It may be necessary to refresh the cache if stale, or maybe just
+                // cancel and retarget the batch
+                WriteErrorDetail error;
+                buildErrorFrom(swHostAndPort.getStatus(), &error);
+                LOG(4) << "unable to send write batch to " << nextBatch->getEndpoint().shardName
+                       << causedBy(swHostAndPort.getStatus());
+                batchOp.noteBatchError(*nextBatch, error);
+
+                ++stats->numResolveErrors;
+                continue;
+            }
 
-                ConnectionString shardHost(swHostAndPort.getValue());
+            queuedBatches[ConnectionString(swHostAndPort.getValue())].push_back(nextBatch);
+        }
 
-                // If we already have a batch for this host, wait until the next time
-                OwnedHostBatchMap::MapType::iterator pendingIt = pendingBatches.find(shardHost);
-                if (pendingIt != pendingBatches.end())
-                    continue;
+        //
+        // Send the child batches, keeping up to the outstanding limit of each host's batches out
+        // on the network. Ordered batches never have more than one batch out per host, since a
+        // later batch may depend on the result of an earlier one.
+        //
 
-                //
-                // We now have all the info needed to dispatch the batch
-                //
+        const size_t maxOutstandingPerHost = clientRequest.getOrdered()
+            ? 1U
+            : static_cast<size_t>(std::max(1, maxWriteBatchesInFlightPerShard.load()));
 
-                BatchedCommandRequest request(clientRequest.getBatchType());
-                batchOp.buildBatchRequest(*nextBatch, &request);
+        HostBatchQueueMap sentBatches;
+        auto sendNextBatch = [&](const ConnectionString& shardHost) {
+            std::deque<TargetedWriteBatch*>& queue = queuedBatches[shardHost];
+            TargetedWriteBatch* nextBatch = queue.front();
+            queue.pop_front();
 
-                // Internally we use full namespaces for request/response, but we send the
-                // command to a database with the collection name in the request.
-                NamespaceString nss(request.getNS());
-                request.setNS(nss);
+            BatchedCommandRequest request(clientRequest.getBatchType());
+            batchOp.buildBatchRequest(*nextBatch, &request);
 
-                LOG(4) << "sending write batch to " << shardHost.toString() << ": "
-                       << request.toString();
+            // Internally we use full namespaces for request/response, but we send the
+            // command to a database with the collection name in the request.
+            NamespaceString nss(request.getNS());
+            request.setNS(nss);
 
-                _dispatcher->addCommand(shardHost, nss.db(), request.toBSON());
+            LOG(4) << "sending write batch to " << shardHost.toString() << ": "
+                   << request.toString();
 
-                // Indicate we're done by setting the batch to NULL
-                // We'll only get duplicate hostEndpoints if we have broadcast and non-broadcast
-                // endpoints for the same host, so this should be pretty efficient without
-                // moving stuff around.
-                *it = NULL;
+            _dispatcher->addCommand(shardHost, nss.db(), request.toBSON());
+            sentBatches[shardHost].push_back(nextBatch);
+        };
 
-                // Recv-side is responsible for cleaning up the nextBatch when used
-                pendingBatches.insert(make_pair(shardHost, nextBatch));
+        for (const auto& hostQueue : queuedBatches) {
+            for (size_t i = 0; i < std::min(maxOutstandingPerHost, hostQueue.second.size()); ++i) {
+                sendNextBatch(hostQueue.first);
             }
+        }
 
-            // Send them all out
-            _dispatcher->sendAll();
-            numSent += pendingBatches.size();
+        _dispatcher->sendAll();
 
-            //
-            // Recv side
-            //
+        while (_dispatcher->numPending() > 0) {
+            // Get the response
+            ConnectionString shardHost;
+            BatchedCommandResponse response;
+            Status dispatchStatus = _dispatcher->recvAny(&shardHost, &response);
 
-            while (_dispatcher->numPending() > 0) {
-                // Get the response
-                ConnectionString shardHost;
-                BatchedCommandResponse response;
-                Status dispatchStatus = _dispatcher->recvAny(&shardHost, &response);
+            // The dispatcher returns the responses of each host in the order they were sent, so
+            // this is the TargetedWriteBatch to put the response in
+            std::deque<TargetedWriteBatch*>& hostSentBatches = sentBatches[shardHost];
+            dassert(!hostSentBatches.empty());
+            TargetedWriteBatch* batch = hostSentBatches.front();
+            hostSentBatches.pop_front();
 
-                // Get the TargetedWriteBatch to find where to put the response
-                dassert(pendingBatches.find(shardHost) != pendingBatches.end());
-                TargetedWriteBatch* batch = pendingBatches.find(shardHost)->second;
+            std::deque<TargetedWriteBatch*>& hostQueuedBatches = queuedBatches[shardHost];
 
-                if (dispatchStatus.isOK()) {
-                    TrackedErrors trackedErrors;
-                    trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
+            if (dispatchStatus.isOK()) {
+                TrackedErrors trackedErrors;
+                trackedErrors.startTracking(ErrorCodes::StaleShardVersion);
 
-                    LOG(4) << "write results received from " << shardHost.toString() << ": "
-                           << response.toString();
+                LOG(4) << "write results received from " << shardHost.toString() << ": "
+                       << response.toString();
 
-                    // Dispatch was ok, note response
-                    batchOp.noteBatchResponse(*batch, response, &trackedErrors);
+                // Dispatch was ok, note response
+                batchOp.noteBatchResponse(*batch, response, &trackedErrors);
 
-                    // Note if anything was stale
-                    const vector<ShardError*>& staleErrors =
-                        trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
+                // Note if anything was stale
+                const vector<ShardError*>& staleErrors =
+                    trackedErrors.getErrors(ErrorCodes::StaleShardVersion);
 
-                    if (staleErrors.size() > 0) {
-                        noteStaleResponses(staleErrors, _targeter);
-                        ++stats->numStaleBatches;
+                if (staleErrors.size() > 0) {
+                    noteStaleResponses(staleErrors, _targeter);
+                    ++stats->numStaleBatches;
+
+                    // The host's other batches were targeted with the same stale version, so
+                    // return their writes to be retargeted next round instead of sending them
+                    for (TargetedWriteBatch* staleBatch : hostQueuedBatches) {
+                        batchOp.noteBatchError(*staleBatch, staleErrors.front()->error);
                     }
+                    hostQueuedBatches.clear();
+                }
 
-                    // Remember that we successfully wrote to this shard
-                    // NOTE: This will record lastOps for shards where we actually didn't update
-                    // or delete any documents, which preserves old behavior but is conservative
-                    stats->noteWriteAt(
-                        shardHost,
-                        response.isLastOpSet() ? response.getLastOp() : repl::OpTime(),
-                        response.isElectionIdSet() ? response.getElectionId() : OID());
-                } else {
-                    // Error occurred dispatching, note it
+                // Remember that we successfully wrote to this shard
+                // NOTE: This will record lastOps for shards where we actually didn't update
+                // or delete any documents, which preserves old behavior but is conservative
+                stats->noteWriteAt(shardHost,
+                                   response.isLastOpSet() ? response.getLastOp() : repl::OpTime(),
+                                   response.isElectionIdSet() ? response.getElectionId() : OID());
+            } else {
+                // Error occurred dispatching, note it
 
-                    stringstream msg;
-                    msg << "write results unavailable from " << shardHost.toString()
-                        << causedBy(dispatchStatus.toString());
+                stringstream msg;
+                msg << "write results unavailable from " << shardHost.toString()
+                    << causedBy(dispatchStatus.toString());
 
-                    WriteErrorDetail error;
-                    buildErrorFrom(Status(ErrorCodes::RemoteResultsUnavailable, msg.str()), &error);
+                WriteErrorDetail error;
+                buildErrorFrom(Status(ErrorCodes::RemoteResultsUnavailable, msg.str()), &error);
 
-                    LOG(4) << "unable to receive write results from " << shardHost.toString()
-                           << causedBy(dispatchStatus.toString());
+                LOG(4) << "unable to receive write results from " << shardHost.toString()
+                       << causedBy(dispatchStatus.toString());
 
-                    batchOp.noteBatchError(*batch, error);
-                }
+                batchOp.noteBatchError(*batch, error);
+            }
+
+            // Keep the host busy with its next batch, if it has one
+            if (!hostQueuedBatches.empty()) {
+                sendNextBatch(shardHost);
+                _dispatcher->sendAll();
             }
         }
 
@@ -273,6 +273,43 @@ Status BatchWriteOp::targetBatch(OperationContext* txn,
     int numTargetErrors = 0;
 
     size_t numWriteOps = _clientRequest->sizeWriteOps();
+
+    //
+    // Unordered inserts are all targeted up front, which lets the targeter share work between
+    // documents. Ordered batches usually stop at the first change of endpoint, so targeting their
+    // remaining documents ahead of time would mostly be wasted.
+    //
+
+    const bool targetInsertsAsBatch =
+        !ordered && _clientRequest->getBatchType() == BatchedCommandRequest::BatchType_Insert &&
+        !_clientRequest->isInsertIndexRequest();
+
+    OwnedPointerVector<ShardEndpoint> insertEndpointsOwned;
+    vector<ShardEndpoint*>& insertEndpoints = insertEndpointsOwned.mutableVector();
+    vector<Status> insertStatuses;
+
+    if (targetInsertsAsBatch) {
+        vector<BSONObj> docs;
+        vector<size_t> docOpIndexes;
+        for (size_t i = 0; i < numWriteOps; ++i) {
+            if (_writeOps[i].getWriteState() == WriteOpState_Ready) {
+                docs.push_back(_writeOps[i].getWriteItem().getDocument());
+                docOpIndexes.push_back(i);
+            }
+        }
+
+        vector<ShardEndpoint*> docEndpoints;
+        vector<Status> docStatuses;
+        targeter.targetInserts(txn, docs, &docEndpoints, &docStatuses);
+
+        insertEndpoints.assign(numWriteOps, NULL);
+        insertStatuses.assign(numWriteOps, Status::OK());
+        for (size_t j = 0; j < docOpIndexes.size(); ++j) {
+            insertEndpoints[docOpIndexes[j]] = docEndpoints[j];
+            insertStatuses[docOpIndexes[j]] = docStatuses[j];
+        }
+    }
+
     for (size_t i = 0; i < numWriteOps; ++i) {
         WriteOp& writeOp = _writeOps[i];
 
@@ -288,7 +325,17 @@ Status BatchWriteOp::targetBatch(OperationContext* txn,
         OwnedPointerVector<TargetedWrite> writesOwned;
         vector<TargetedWrite*>& writes = writesOwned.mutableVector();
 
-        Status targetStatus = writeOp.targetWrites(txn, targeter, &writes);
+        Status targetStatus = Status::OK();
+        if (targetInsertsAsBatch) {
+            targetStatus = insertStatuses[i];
+            if (targetStatus.isOK()) {
+                // The write op takes ownership of the endpoint
+                writeOp.targetInsertWrite(insertEndpoints[i], &writes);
+                insertEndpoints[i] = NULL;
+            }
+        } else {
+            targetStatus = writeOp.targetWrites(txn, targeter, &writes);
+        }
 
         if (!targetStatus.isOK()) {
             WriteErrorDetail targetError;
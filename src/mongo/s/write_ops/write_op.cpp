@@ -116,7 +116,24 @@ Status WriteOp::targetWrites(OperationContext* txn,
     if (!targetStatus.isOK())
         return targetStatus;
 
-    for (vector<ShardEndpoint*>::iterator it = endpoints.begin(); it != endpoints.end(); ++it) {
+    createChildWrites(endpoints, targetedWrites);
+    return Status::OK();
+}
+
+void WriteOp::targetInsertWrite(ShardEndpoint* endpoint,
+                                std::vector<TargetedWrite*>* targetedWrites) {
+    dassert(_itemRef.getOpType() == BatchedCommandRequest::BatchType_Insert);
+
+    OwnedPointerVector<ShardEndpoint> endpointsOwned;
+    endpointsOwned.mutableVector().push_back(endpoint);
+
+    createChildWrites(endpointsOwned.vector(), targetedWrites);
+}
+
+void WriteOp::createChildWrites(const std::vector<ShardEndpoint*>& endpoints,
+                                std::vector<TargetedWrite*>* targetedWrites) {
+    for (vector<ShardEndpoint*>::const_iterator it = endpoints.begin(); it != endpoints.end();
+         ++it) {
         ShardEndpoint* endpoint = *it;
 
         _childOps.push_back(new ChildWriteOp(this));
@@ -136,7 +153,6 @@ Status WriteOp::targetWrites(OperationContext* txn,
     }
 
     _state = WriteOpState_Pending;
-    return Status::OK();
 }
 
 size_t WriteOp::getNumTargeted() {
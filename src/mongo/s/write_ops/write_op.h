@@ -126,6 +126,12 @@ public:
                         const NSTargeter& targeter,
                         std::vector<TargetedWrite*>* targetedWrites);
 
+    /**
+     * Same as targetWrites, but for an insert which was already targeted at 'endpoint' as part of
+     * its batch (see NSTargeter::targetInserts). Takes ownership of 'endpoint'.
+     */
+    void targetInsertWrite(ShardEndpoint* endpoint, std::vector<TargetedWrite*>* targetedWrites);
+
     /**
      * Returns the number of child writes that were last targeted.
      */
@@ -164,6 +170,12 @@ public:
     void setOpError(const WriteErrorDetail& error);
 
 private:
+    /**
+     * Creates a pending child write for each of 'endpoints' and moves this op to _Pending.
+     */
+    void createChildWrites(const std::vector<ShardEndpoint*>& endpoints,
+                           std::vector<TargetedWrite*>* targetedWrites);
+
     /**
      * Updates the op state after new information is received.
      */
@@ -136,6 +136,58 @@ inline void sortByEndpoint(vector<TargetedWrite*>* writes) {
     std::sort(writes->begin(), writes->end(), EndpointComp());
 }
 
+TEST(WriteOpTests, TargetInsertsAsBatch) {
+    //
+    // Targeting a batch of inserts at once, then creating the writes from the results
+    //
+
+    OperationContextNoop txn;
+    NamespaceString nss("foo.bar");
+
+    ShardEndpoint endpointA(ShardId("shardA"), ChunkVersion::IGNORED());
+    ShardEndpoint endpointB(ShardId("shardB"), ChunkVersion::IGNORED());
+
+    vector<MockRange*> mockRanges;
+    mockRanges.push_back(new MockRange(endpointA, nss, BSON("x" << MINKEY), BSON("x" << 0)));
+    mockRanges.push_back(new MockRange(endpointB, nss, BSON("x" << 0), BSON("x" << MAXKEY)));
+
+    BatchedCommandRequest request(BatchedCommandRequest::BatchType_Insert);
+    request.setNS(nss);
+    request.getInsertRequest()->addToDocuments(BSON("x" << 1));
+    request.getInsertRequest()->addToDocuments(BSON("x" << -1));
+
+    MockNSTargeter targeter;
+    targeter.init(mockRanges);
+
+    vector<ShardEndpoint*> endpoints;
+    vector<Status> statuses;
+    targeter.targetInserts(&txn,
+                           {request.getInsertRequest()->getDocumentsAt(0),
+                            request.getInsertRequest()->getDocumentsAt(1)},
+                           &endpoints,
+                           &statuses);
+
+    ASSERT_EQUALS(endpoints.size(), 2u);
+    ASSERT_EQUALS(statuses.size(), 2u);
+    ASSERT_OK(statuses[0]);
+    ASSERT_OK(statuses[1]);
+
+    for (size_t i = 0; i < endpoints.size(); ++i) {
+        WriteOp writeOp(BatchItemRef(&request, i));
+
+        OwnedPointerVector<TargetedWrite> targetedOwned;
+        vector<TargetedWrite*>& targeted = targetedOwned.mutableVector();
+        writeOp.targetInsertWrite(endpoints[i], &targeted);
+
+        ASSERT_EQUALS(writeOp.getWriteState(), WriteOpState_Pending);
+        ASSERT_EQUALS(targeted.size(), 1u);
+        assertEndpointsEqual(targeted.front()->endpoint, i == 0 ? endpointB : endpointA);
+
+        writeOp.noteWriteComplete(*targeted.front());
+        ASSERT_EQUALS(writeOp.getWriteState(), WriteOpState_Completed);
+    }
+}
+
 TEST(WriteOpTests, TargetMultiOneShard) {
     //
     // Multi-write targeting test where our query goes to one shard
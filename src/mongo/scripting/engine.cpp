@@ -33,12 +33,14 @@
 
 #include "mongo/scripting/engine.h"
 
+#include <algorithm>
 #include <boost/filesystem/operations.hpp>
 #include <cctype>
 
 #include "mongo/client/dbclientcursor.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/platform/unordered_set.h"
 #include "mongo/scripting/dbdirectclient_factory.h"
@@ -312,32 +314,60 @@ void Scope::execCoreFiles() {
 }
 
 namespace {
+
+// The number of idle scopes kept for reuse, across all pools
+MONGO_EXPORT_SERVER_PARAMETER(scriptingScopePoolSize, int, 10);
+
+// The number of operations a scope is reused for before it is discarded. Reused scopes keep their
+// compiled functions, so $where and group functions are only compiled on first use.
+MONGO_EXPORT_SERVER_PARAMETER(scriptingScopeMaxReuse, int, 100);
+
+// The total JavaScript heap size of the idle scopes kept for reuse, beyond which the least
+// recently used ones are discarded
+MONGO_EXPORT_SERVER_PARAMETER(scriptingScopePoolMaxMB, int, 256);
+
 class ScopeCache {
 public:
     void release(const string& poolName, const std::shared_ptr<Scope>& scope) {
+        // Asking the scope may have to run on its own thread, so don't do it under the mutex
+        const bool hasOutOfMemoryException = scope->hasOutOfMemoryException();
+        const size_t memoryUsageBytes = scope->getMemoryUsageBytes();
+
         stdx::lock_guard<stdx::mutex> lk(_mutex);
 
-        if (scope->hasOutOfMemoryException()) {
+        if (hasOutOfMemoryException) {
             // make some room
             log() << "Clearing all idle JS contexts due to out of memory" << endl;
-            _pools.clear();
+            _clear_inlock();
             return;
         }
 
-        if (scope->getTimesUsed() > kMaxScopeReuse)
+        if (scope->getTimesUsed() > scriptingScopeMaxReuse.load())
             return;  // used too many times to save
 
         if (!scope->getError().empty())
             return;  // not saving errored scopes
 
-        if (_pools.size() >= kMaxPoolSize) {
-            // prefer to keep recently-used scopes
+        const size_t maxPooledBytes =
+            static_cast<size_t>(std::max(0, scriptingScopePoolMaxMB.load())) * 1024 * 1024;
+        if (memoryUsageBytes > maxPooledBytes)
+            return;  // too large to keep idle
+
+        // prefer to keep recently-used scopes
+        const size_t maxPoolSize = static_cast<size_t>(std::max(0, scriptingScopePoolSize.load()));
+        while (!_pools.empty() &&
+               (_pools.size() >= maxPoolSize || _pooledBytes + memoryUsageBytes > maxPooledBytes)) {
+            _pooledBytes -= _pools.back().memoryUsageBytes;
             _pools.pop_back();
         }
 
+        if (maxPoolSize == 0)
+            return;
+
         scope->reset();
-        ScopeAndPool toStore = {scope, poolName};
+        ScopeAndPool toStore = {scope, poolName, memoryUsageBytes};
         _pools.push_front(toStore);
+        _pooledBytes += memoryUsageBytes;
     }
 
     std::shared_ptr<Scope> tryAcquire(OperationContext* txn, const string& poolName) {
@@ -346,6 +376,7 @@ public:
         for (Pools::iterator it = _pools.begin(); it != _pools.end(); ++it) {
             if (it->poolName == poolName) {
                 std::shared_ptr<Scope> scope = it->scope;
+                _pooledBytes -= it->memoryUsageBytes;
                 _pools.erase(it);
                 scope->incTimesUsed();
                 scope->reset();
@@ -360,21 +391,25 @@ public:
     void clear() {
         stdx::lock_guard<stdx::mutex> lk(_mutex);
 
-        _pools.clear();
+        _clear_inlock();
     }
 
 private:
     struct ScopeAndPool {
         std::shared_ptr<Scope> scope;
         string poolName;
+        size_t memoryUsageBytes;
     };
 
-    // Note: if these numbers change, reconsider choice of datastructure for _pools
-    static const unsigned kMaxPoolSize = 10;
-    static const int kMaxScopeReuse = 10;
+    void _clear_inlock() {
+        _pools.clear();
+        _pooledBytes = 0;
+    }
 
+    // Note: acquiring searches _pools linearly, so it should stay small
     typedef std::deque<ScopeAndPool> Pools;  // More-recently used Scopes are kept at the front.
     Pools _pools;                            // protected by _mutex
+    size_t _pooledBytes = 0;                 // protected by _mutex
     stdx::mutex _mutex;
 };
 
@@ -437,6 +472,9 @@ public:
     bool hasOutOfMemoryException() {
         return _real->hasOutOfMemoryException();
     }
+    size_t getMemoryUsageBytes() {
+        return _real->getMemoryUsageBytes();
+    }
     void rename(const char* from, const char* to) {
         _real->rename(from, to);
     }
@@ -97,6 +97,14 @@ public:
 
     virtual bool hasOutOfMemoryException() = 0;
 
+    /**
+     * Returns the number of bytes allocated by the JavaScript heap of this scope, or 0 if the
+     * engine doesn't account for it.
+     */
+    virtual size_t getMemoryUsageBytes() {
+        return 0;
+    }
+
     virtual bool isKillPending() const = 0;
 
     virtual void gc() = 0;
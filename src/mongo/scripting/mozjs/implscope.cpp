@@ -388,6 +388,11 @@ bool MozJSImplScope::hasOutOfMemoryException() {
     return _hasOutOfMemoryException;
 }
 
+size_t MozJSImplScope::getMemoryUsageBytes() {
+    // The allocator accounts per thread, and each runtime has a thread of its own
+    return mongo::sm::get_total_bytes();
+}
+
 void MozJSImplScope::init(const BSONObj* data) {
     if (!data)
         return;
@@ -105,6 +105,8 @@ public:
 
     bool hasOutOfMemoryException() override;
 
+    size_t getMemoryUsageBytes() override;
+
     void gc() override;
 
     bool isJavaScriptProtectionEnabled() const;
@@ -113,6 +113,12 @@ bool MozJSProxyScope::hasOutOfMemoryException() {
     return out;
 }
 
+size_t MozJSProxyScope::getMemoryUsageBytes() {
+    size_t out;
+    run([&] { out = _implScope->getMemoryUsageBytes(); });
+    return out;
+}
+
 void MozJSProxyScope::gc() {
     _implScope->gc();
 }
@@ -125,6 +125,8 @@ public:
 
     bool hasOutOfMemoryException() override;
 
+    size_t getMemoryUsageBytes() override;
+
     void gc() override;
 
     void advanceGeneration() override;
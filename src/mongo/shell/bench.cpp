@@ -34,11 +34,13 @@
 
 #include "mongo/shell/bench.h"
 
+#include <cmath>
 #include <iostream>
 #include <pcrecpp.h>
 
 #include "mongo/client/dbclientcursor.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/platform/bits.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/query_request.h"
@@ -90,7 +92,9 @@ const std::map<OpType, std::string> opTypeName{{OpType::NONE, "none"},
                                                {OpType::REMOVE, "remove"},
                                                {OpType::CREATEINDEX, "createIndex"},
                                                {OpType::DROPINDEX, "dropIndex"},
-                                               {OpType::LET, "let"}};
+                                               {OpType::LET, "let"},
+                                               {OpType::AGGREGATE, "aggregate"},
+                                               {OpType::FINDANDMODIFY, "findAndModify"}};
 
 BenchRunEventCounter::BenchRunEventCounter() {
     reset();
@@ -101,11 +105,64 @@ BenchRunEventCounter::~BenchRunEventCounter() {}
 void BenchRunEventCounter::reset() {
     _numEvents = 0;
     _totalTimeMicros = 0;
+    _maxTimeMicros = 0;
+    _buckets.fill(0);
 }
 
 void BenchRunEventCounter::updateFrom(const BenchRunEventCounter& other) {
     _numEvents += other._numEvents;
     _totalTimeMicros += other._totalTimeMicros;
+    _maxTimeMicros = std::max(_maxTimeMicros, other._maxTimeMicros);
+    for (size_t i = 0; i < kNumBuckets; ++i)
+        _buckets[i] += other._buckets[i];
+}
+
+size_t BenchRunEventCounter::bucketFor(long long timeMicros) {
+    if (timeMicros < 2 * kSubBuckets)
+        return timeMicros < 0 ? 0 : timeMicros;
+
+    const int highestBit = 63 - countLeadingZeros64(timeMicros);
+    if (highestBit >= kMaxDurationBits)
+        return kNumBuckets - 1;
+
+    // The kSubBucketBits bits below the highest set bit pick the bucket within its power of two.
+    const int shift = highestBit - kSubBucketBits;
+    return shift * kSubBuckets + (timeMicros >> shift);
+}
+
+long long BenchRunEventCounter::bucketUpperBound(size_t index) {
+    if (index < 2 * kSubBuckets)
+        return index;
+
+    const int shift = index / kSubBuckets - 1;
+    const long long subBucket = index - shift * kSubBuckets;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+long long BenchRunEventCounter::getPercentileMicros(double fraction) const {
+    if (_numEvents == 0)
+        return 0;
+
+    const unsigned long long rank =
+        std::max(1ULL, static_cast<unsigned long long>(std::ceil(fraction * _numEvents)));
+    unsigned long long seen = 0;
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+        seen += _buckets[i];
+        if (seen >= rank)
+            return std::min(bucketUpperBound(i), _maxTimeMicros);
+    }
+    return _maxTimeMicros;
+}
+
+void BenchRunEventCounter::appendLatencyStats(BSONObjBuilder* builder) const {
+    builder->append("count", static_cast<long long>(_numEvents));
+    if (_numEvents > 0)
+        builder->append("mean", static_cast<double>(_totalTimeMicros) / _numEvents);
+    builder->append("p50", getPercentileMicros(0.5));
+    builder->append("p90", getPercentileMicros(0.9));
+    builder->append("p99", getPercentileMicros(0.99));
+    builder->append("p999", getPercentileMicros(0.999));
+    builder->append("max", _maxTimeMicros);
 }
 
 BenchRunStats::BenchRunStats() {
@@ -125,6 +182,9 @@ void BenchRunStats::reset() {
     deleteCounter.reset();
     queryCounter.reset();
     commandCounter.reset();
+    aggregateCounter.reset();
+    findAndModifyCounter.reset();
+    scheduleLagCounter.reset();
     trappedErrors.clear();
 }
 
@@ -140,6 +200,9 @@ void BenchRunStats::updateFrom(const BenchRunStats& other) {
     deleteCounter.updateFrom(other.deleteCounter);
     queryCounter.updateFrom(other.queryCounter);
     commandCounter.updateFrom(other.commandCounter);
+    aggregateCounter.updateFrom(other.aggregateCounter);
+    findAndModifyCounter.updateFrom(other.findAndModifyCounter);
+    scheduleLagCounter.updateFrom(other.scheduleLagCounter);
 
     for (size_t i = 0; i < other.trappedErrors.size(); ++i)
         trappedErrors.push_back(other.trappedErrors[i]);
@@ -169,6 +232,7 @@ void BenchRunConfig::initializeToDefaults() {
     throwGLE = false;
     breakOnTrap = true;
     randomSeed = 1314159265358979323;
+    opsPerSecond = 0;
 }
 
 BenchRunConfig* BenchRunConfig::createFromBson(const BSONObj& args) {
@@ -191,8 +255,21 @@ BenchRunOp opFromBson(const BSONObj& op) {
             uassert(34378,
                     str::stream() << "Field 'batchSize' only valid for find op types. Type is "
                                   << opType,
-                    (opType == "find") || (opType == "query"));
+                    (opType == "find") || (opType == "query") || (opType == "aggregate"));
             myOp.batchSize = arg.numberInt();
+        } else if (name == "bulkSize") {
+            uassert(40211,
+                    str::stream() << "Field 'bulkSize' should be a positive number, instead it's: "
+                                  << arg,
+                    arg.isNumber() && arg.numberInt() > 0);
+            uassert(40212,
+                    str::stream()
+                        << "Field 'bulkSize' only valid for insert/update/remove/delete op types. "
+                           "Type is "
+                        << opType,
+                    (opType == "insert") || (opType == "update") || (opType == "remove") ||
+                        (opType == "delete"));
+            myOp.bulkSize = arg.numberInt();
         } else if (name == "check") {
             // check function gets thrown into a scoped function. Leaving that parsing in main loop.
             myOp.useCheck = true;
@@ -272,6 +349,12 @@ BenchRunOp opFromBson(const BSONObj& op) {
                         << opType,
                     (opType == "update") || (opType == "remove") || (opType == "delete"));
             myOp.multi = arg.trueValue();
+        } else if (name == "new") {
+            uassert(40213,
+                    str::stream() << "Field 'new' is only valid for findAndModify op type. Type is "
+                                  << opType,
+                    (opType == "findAndModify"));
+            myOp.returnNew = arg.trueValue();
         } else if (name == "ns") {
             uassert(34385,
                     str::stream() << "Field 'ns' should be a string, instead it's type: "
@@ -304,6 +387,10 @@ BenchRunOp opFromBson(const BSONObj& op) {
                 myOp.op = OpType::DROPINDEX;
             } else if (type == "let") {
                 myOp.op = OpType::LET;
+            } else if (type == "aggregate") {
+                myOp.op = OpType::AGGREGATE;
+            } else if (type == "findAndModify") {
+                myOp.op = OpType::FINDANDMODIFY;
             } else {
                 uassert(34387,
                         str::stream() << "benchRun passed an unsupported op type: " << type,
@@ -319,15 +406,33 @@ BenchRunOp opFromBson(const BSONObj& op) {
                                   << opType,
                     (opType == "command") || (opType == "query") || (opType == "find"));
             myOp.options = arg.numberInt();
+        } else if (name == "pipeline") {
+            uassert(40214,
+                    str::stream()
+                        << "Field 'pipeline' is only valid for aggregate op type. Type is "
+                        << opType,
+                    (opType == "aggregate"));
+            uassert(40215,
+                    str::stream() << "Field 'pipeline' should be an array, instead it's type: "
+                                  << typeName(arg.type()),
+                    arg.type() == Array);
+            myOp.pipeline = arg.Obj();
         } else if (name == "query") {
             uassert(34389,
-                    str::stream() << "Field 'query' is only valid for findOne, find, update, and "
-                                     "remove types. Type is "
+                    str::stream() << "Field 'query' is only valid for findOne, find, update, "
+                                     "remove, and findAndModify types. Type is "
                                   << opType,
                     (opType == "findOne") || (opType == "query") ||
                         (opType == "find" || (opType == "update") || (opType == "delete") ||
-                         (opType == "remove")));
+                         (opType == "remove") || (opType == "findAndModify")));
             myOp.query = arg.Obj();
+        } else if (name == "remove") {
+            uassert(40216,
+                    str::stream()
+                        << "Field 'remove' is only valid for findAndModify op type. Type is "
+                        << opType,
+                    (opType == "findAndModify"));
+            myOp.remove = arg.trueValue();
         } else if (name == "safe") {
             myOp.safe = arg.trueValue();
         } else if (name == "skip") {
@@ -340,6 +445,13 @@ BenchRunOp opFromBson(const BSONObj& op) {
                                   << opType,
                     (opType == "find") || (opType == "query"));
             myOp.skip = arg.numberInt();
+        } else if (name == "sort") {
+            uassert(40217,
+                    str::stream()
+                        << "Field 'sort' is only valid for findAndModify op type. Type is "
+                        << opType,
+                    (opType == "findAndModify"));
+            myOp.sort = arg.Obj();
         } else if (name == "showError") {
             myOp.showError = arg.trueValue();
         } else if (name == "showResult") {
@@ -354,15 +466,17 @@ BenchRunOp opFromBson(const BSONObj& op) {
             myOp.throwGLE = arg.trueValue();
         } else if (name == "update") {
             uassert(34391,
-                    str::stream() << "Field 'update' is only valid for update op type. Op type is "
+                    str::stream() << "Field 'update' is only valid for update and findAndModify op "
+                                     "types. Op type is "
                                   << opType,
-                    (opType == "update"));
+                    (opType == "update") || (opType == "findAndModify"));
             myOp.update = arg.Obj();
         } else if (name == "upsert") {
             uassert(34392,
-                    str::stream() << "Field 'upsert' is only valid for update op type. Op type is "
+                    str::stream() << "Field 'upsert' is only valid for update and findAndModify op "
+                                     "types. Op type is "
                                   << opType,
-                    (opType == "update"));
+                    (opType == "update") || (opType == "findAndModify"));
             myOp.upsert = arg.trueValue();
         } else if (name == "readCmd") {
             myOp.useReadCmd = arg.trueValue();
@@ -387,6 +501,12 @@ BenchRunOp opFromBson(const BSONObj& op) {
 
     uassert(34395, "Benchrun op has an zero length ns", !myOp.ns.empty());
     uassert(34396, "Benchrun op doesn't have an optype set", myOp.op != OpType::NONE);
+    uassert(40218,
+            "Benchrun op field 'bulkSize' requires 'writeCmd'",
+            myOp.bulkSize == 1 || myOp.useWriteCmd);
+    uassert(40219,
+            "Benchrun findAndModify op needs exactly one of 'update' or 'remove'",
+            myOp.op != OpType::FINDANDMODIFY || myOp.update.isEmpty() == myOp.remove);
     return myOp;
 }
 
@@ -437,6 +557,12 @@ void BenchRunConfig::initializeFromBson(const BSONObj& args) {
                                   << typeName(arg.type()),
                     arg.isNumber());
             seconds = arg.number();
+        } else if (name == "opsPerSecond") {
+            uassert(40220,
+                    str::stream() << "Field '" << name << "' should be a non-negative number, "
+                                  << "instead it's: " << arg,
+                    arg.isNumber() && arg.number() >= 0);
+            opsPerSecond = arg.number();
         } else if (name == "hideResults") {
             hideResults = arg.trueValue();
         } else if (name == "handleErrors") {
@@ -666,6 +792,36 @@ int runQueryWithReadCommands(DBClientBase* conn,
     return count;
 }
 
+/**
+ * Iterates the cursor returned in the command reply 'cmdResult' to exhaustion, issuing getMores
+ * against 'dbName'. Returns the total number of documents in the result set.
+ *
+ * On error, throws a UserException.
+ */
+int runGetMoresOnCursor(DBClientBase* conn,
+                        const std::string& dbName,
+                        const BSONObj& cmdResult,
+                        boost::optional<long long> batchSize = boost::none) {
+    auto cursorResponse = uassertStatusOK(CursorResponse::parseFromBSON(cmdResult));
+    int count = cursorResponse.getBatch().size();
+    while (cursorResponse.getCursorId() != 0) {
+        GetMoreRequest getMoreRequest(cursorResponse.getNSS(),
+                                      cursorResponse.getCursorId(),
+                                      batchSize,
+                                      boost::none,   // maxTimeMS
+                                      boost::none,   // term
+                                      boost::none);  // lastKnownCommittedOpTime
+        BSONObj getMoreCommandResult;
+        bool ok = conn->runCommand(dbName, getMoreRequest.toBSON(), getMoreCommandResult);
+        uassert(ErrorCodes::CommandFailed,
+                str::stream() << "getMore command failed; reply was: " << getMoreCommandResult,
+                ok);
+        cursorResponse = uassertStatusOK(CursorResponse::parseFromBSON(getMoreCommandResult));
+        count += cursorResponse.getBatch().size();
+    }
+    return count;
+}
+
 void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
     verify(conn);
     long long count = 0;
@@ -684,12 +840,40 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
     unique_ptr<Scope> scope{globalScriptEngine->newScopeForCurrentThread()};
     verify(scope.get());
 
+    // With a target rate, this worker's share of it puts every operation on a fixed schedule, and
+    // an operation which starts late is charged for the time it spent waiting for its slot.
+    using Clock = stdx::chrono::steady_clock;
+    Clock::duration scheduleInterval = Clock::duration::zero();
+    if (_config->opsPerSecond > 0) {
+        scheduleInterval = stdx::chrono::duration_cast<Clock::duration>(
+            stdx::chrono::duration<double>(_config->parallel / _config->opsPerSecond));
+    }
+    Clock::time_point nextScheduledStart = Clock::now();
+
     while (!shouldStop()) {
         for (const auto& op : _config->ops) {
             if (shouldStop())
                 break;
             auto& stats = shouldCollectStats() ? _stats : _statsBlackHole;
 
+            Microseconds scheduleLag{0};
+            if (scheduleInterval != Clock::duration::zero() && op.op != OpType::LET) {
+                Clock::time_point now = Clock::now();
+                while (now < nextScheduledStart && !shouldStop()) {
+                    // Sleep in short steps so that a low target rate doesn't hold up shutdown.
+                    stdx::this_thread::sleep_for(std::min<Clock::duration>(
+                        nextScheduledStart - now, stdx::chrono::milliseconds(100)));
+                    now = Clock::now();
+                }
+                if (shouldStop())
+                    break;
+
+                if (now > nextScheduledStart)
+                    scheduleLag = duration_cast<Microseconds>(now - nextScheduledStart);
+                nextScheduledStart += scheduleInterval;
+                stats.scheduleLagCounter.countOne(durationCount<Microseconds>(scheduleLag));
+            }
+
             ScriptingFunction scopeFunc = 0;
             BSONObj scopeObj;
             if (op.useCheck) {
@@ -721,10 +905,10 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                             qr->setWantMore(false);
                             invariantOK(qr->validate());
 
-                            BenchRunEventTrace _bret(&stats.findOneCounter);
+                            BenchRunEventTrace _bret(&stats.findOneCounter, scheduleLag);
                             runQueryWithReadCommands(conn, std::move(qr), &result);
                         } else {
-                            BenchRunEventTrace _bret(&stats.findOneCounter);
+                            BenchRunEventTrace _bret(&stats.findOneCounter, scheduleLag);
                             result = conn->findOne(op.ns, fixedQuery);
                         }
 
@@ -747,7 +931,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                         bool ok;
                         BSONObj result;
                         {
-                            BenchRunEventTrace _bret(&stats.commandCounter);
+                            BenchRunEventTrace _bret(&stats.commandCounter, scheduleLag);
                             ok = conn->runCommand(op.ns,
                                                   fixQuery(op.command, bsonTemplateEvaluator),
                                                   result,
@@ -759,28 +943,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
 
                         if (!result["cursor"].eoo()) {
                             // The command returned a cursor, so iterate all results.
-                            auto cursorResponse =
-                                uassertStatusOK(CursorResponse::parseFromBSON(result));
-                            int count = cursorResponse.getBatch().size();
-                            while (cursorResponse.getCursorId() != 0) {
-                                GetMoreRequest getMoreRequest(
-                                    cursorResponse.getNSS(),
-                                    cursorResponse.getCursorId(),
-                                    boost::none,   // batchSize
-                                    boost::none,   // maxTimeMS
-                                    boost::none,   // term
-                                    boost::none);  // lastKnownCommittedOpTime
-                                BSONObj getMoreCommandResult;
-                                ok = conn->runCommand(
-                                    op.ns, getMoreRequest.toBSON(), getMoreCommandResult);
-                                uassert(ErrorCodes::CommandFailed,
-                                        str::stream() << "getMore command failed; reply was: "
-                                                      << getMoreCommandResult,
-                                        ok);
-                                cursorResponse = uassertStatusOK(
-                                    CursorResponse::parseFromBSON(getMoreCommandResult));
-                                count += cursorResponse.getBatch().size();
-                            }
+                            int count = runGetMoresOnCursor(conn, op.ns, result);
                             // Just give the count to the check function.
                             result = BSON("count" << count << "context" << op.context);
                         }
@@ -830,17 +993,17 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                             }
                             invariantOK(qr->validate());
 
-                            BenchRunEventTrace _bret(&stats.queryCounter);
+                            BenchRunEventTrace _bret(&stats.queryCounter, scheduleLag);
                             count = runQueryWithReadCommands(conn, std::move(qr));
                         } else {
                             // Use special query function for exhaust query option.
                             if (op.options & QueryOption_Exhaust) {
-                                BenchRunEventTrace _bret(&stats.queryCounter);
+                                BenchRunEventTrace _bret(&stats.queryCounter, scheduleLag);
                                 stdx::function<void(const BSONObj&)> castedDoNothing(doNothing);
                                 count = conn->query(
                                     castedDoNothing, op.ns, fixedQuery, &op.projection, op.options);
                             } else {
-                                BenchRunEventTrace _bret(&stats.queryCounter);
+                                BenchRunEventTrace _bret(&stats.queryCounter, scheduleLag);
                                 unique_ptr<DBClientCursor> cursor;
                                 cursor = conn->query(op.ns,
                                                      fixedQuery,
@@ -878,24 +1041,29 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                     case OpType::UPDATE: {
                         BSONObj result;
                         {
-                            BenchRunEventTrace _bret(&stats.updateCounter);
-                            BSONObj query = fixQuery(op.query, bsonTemplateEvaluator);
-                            BSONObj update = fixQuery(op.update, bsonTemplateEvaluator);
+                            BenchRunEventTrace _bret(&stats.updateCounter, scheduleLag);
 
                             if (op.useWriteCmd) {
                                 // TODO: Replace after SERVER-11774.
                                 BSONObjBuilder builder;
                                 builder.append("update", nsToCollectionSubstring(op.ns));
                                 BSONArrayBuilder docBuilder(builder.subarrayStart("updates"));
-                                docBuilder.append(BSON(
-                                    "q" << query << "u" << update << "multi" << op.multi << "upsert"
-                                        << op.upsert));
+                                for (int i = 0; i < op.bulkSize; ++i) {
+                                    BSONObj query = fixQuery(op.query, bsonTemplateEvaluator);
+                                    BSONObj update = fixQuery(op.update, bsonTemplateEvaluator);
+                                    docBuilder.append(BSON("q" << query << "u" << update << "multi"
+                                                               << op.multi
+                                                               << "upsert"
+                                                               << op.upsert));
+                                }
                                 docBuilder.done();
                                 builder.append("writeConcern", op.writeConcern);
                                 conn->runCommand(nsToDatabaseSubstring(op.ns).toString(),
                                                  builder.done(),
                                                  result);
                             } else {
+                                BSONObj query = fixQuery(op.query, bsonTemplateEvaluator);
+                                BSONObj update = fixQuery(op.update, bsonTemplateEvaluator);
                                 conn->update(op.ns, query, update, op.upsert, op.multi);
                                 if (op.safe)
                                     result = conn->getLastErrorDetailed();
@@ -930,7 +1098,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                         BSONObj result;
 
                         {
-                            BenchRunEventTrace _bret(&stats.insertCounter);
+                            BenchRunEventTrace _bret(&stats.insertCounter, scheduleLag);
 
                             BSONObj insertDoc;
                             if (op.useWriteCmd) {
@@ -938,14 +1106,17 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                                 BSONObjBuilder builder;
                                 builder.append("insert", nsToCollectionSubstring(op.ns));
                                 BSONArrayBuilder docBuilder(builder.subarrayStart("documents"));
-                                if (op.isDocAnArray) {
-                                    for (const auto& element : op.doc) {
-                                        insertDoc = fixQuery(element.Obj(), bsonTemplateEvaluator);
+                                for (int i = 0; i < op.bulkSize; ++i) {
+                                    if (op.isDocAnArray) {
+                                        for (const auto& element : op.doc) {
+                                            insertDoc =
+                                                fixQuery(element.Obj(), bsonTemplateEvaluator);
+                                            docBuilder.append(insertDoc);
+                                        }
+                                    } else {
+                                        insertDoc = fixQuery(op.doc, bsonTemplateEvaluator);
                                         docBuilder.append(insertDoc);
                                     }
-                                } else {
-                                    insertDoc = fixQuery(op.doc, bsonTemplateEvaluator);
-                                    docBuilder.append(insertDoc);
                                 }
                                 docBuilder.done();
                                 builder.append("writeConcern", op.writeConcern);
@@ -996,21 +1167,24 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                     case OpType::REMOVE: {
                         BSONObj result;
                         {
-                            BenchRunEventTrace _bret(&stats.deleteCounter);
-                            BSONObj predicate = fixQuery(op.query, bsonTemplateEvaluator);
+                            BenchRunEventTrace _bret(&stats.deleteCounter, scheduleLag);
                             if (op.useWriteCmd) {
                                 // TODO: Replace after SERVER-11774.
                                 BSONObjBuilder builder;
                                 builder.append("delete", nsToCollectionSubstring(op.ns));
                                 BSONArrayBuilder docBuilder(builder.subarrayStart("deletes"));
                                 int limit = (op.multi == true) ? 0 : 1;
-                                docBuilder.append(BSON("q" << predicate << "limit" << limit));
+                                for (int i = 0; i < op.bulkSize; ++i) {
+                                    BSONObj predicate = fixQuery(op.query, bsonTemplateEvaluator);
+                                    docBuilder.append(BSON("q" << predicate << "limit" << limit));
+                                }
                                 docBuilder.done();
                                 builder.append("writeConcern", op.writeConcern);
                                 conn->runCommand(nsToDatabaseSubstring(op.ns).toString(),
                                                  builder.done(),
                                                  result);
                             } else {
+                                BSONObj predicate = fixQuery(op.query, bsonTemplateEvaluator);
                                 conn->remove(op.ns, predicate, !op.multi);
                                 if (op.safe)
                                     result = conn->getLastErrorDetailed();
@@ -1041,6 +1215,95 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                                                   result["code"].eoo() ? 0 : result["code"].Int());
                         }
                     } break;
+                    case OpType::AGGREGATE: {
+                        int count;
+                        {
+                            BenchRunEventTrace _bret(&stats.aggregateCounter, scheduleLag);
+                            BSONObjBuilder builder;
+                            builder.append("aggregate", nsToCollectionSubstring(op.ns));
+                            builder.appendArray("pipeline",
+                                                fixQuery(op.pipeline, bsonTemplateEvaluator));
+                            BSONObjBuilder cursorBuilder(builder.subobjStart("cursor"));
+                            if (op.batchSize) {
+                                cursorBuilder.append("batchSize", op.batchSize);
+                            }
+                            cursorBuilder.done();
+
+                            std::string dbName = nsToDatabaseSubstring(op.ns).toString();
+                            BSONObj result;
+                            bool ok = conn->runCommand(dbName, builder.done(), result);
+                            uassert(ErrorCodes::CommandFailed,
+                                    str::stream() << "aggregate command failed; reply was: "
+                                                  << result,
+                                    ok);
+                            boost::optional<long long> batchSize;
+                            if (op.batchSize) {
+                                batchSize = op.batchSize;
+                            }
+                            count = runGetMoresOnCursor(conn, dbName, result, batchSize);
+                        }
+
+                        if (op.useCheck) {
+                            BSONObj thisValue = BSON("count" << count << "context" << op.context);
+                            int err = scope->invoke(scopeFunc, 0, &thisValue, 1000 * 60, false);
+                            if (err) {
+                                log() << "Error checking in benchRun thread [aggregate]"
+                                      << causedBy(scope->getError()) << endl;
+
+                                stats.errCount++;
+
+                                return;
+                            }
+                        }
+
+                        if (!_config->hideResults || op.showResult)
+                            log() << "Result from benchRun thread [aggregate] : " << count << endl;
+                    } break;
+                    case OpType::FINDANDMODIFY: {
+                        BSONObj result;
+                        bool ok;
+                        {
+                            BenchRunEventTrace _bret(&stats.findAndModifyCounter, scheduleLag);
+                            BSONObjBuilder builder;
+                            builder.append("findAndModify", nsToCollectionSubstring(op.ns));
+                            builder.append("query", fixQuery(op.query, bsonTemplateEvaluator));
+                            if (!op.sort.isEmpty()) {
+                                builder.append("sort", op.sort);
+                            }
+                            if (op.remove) {
+                                builder.append("remove", true);
+                            } else {
+                                builder.append("update",
+                                               fixQuery(op.update, bsonTemplateEvaluator));
+                                builder.append("new", op.returnNew);
+                                builder.append("upsert", op.upsert);
+                            }
+                            if (!op.writeConcern.isEmpty()) {
+                                builder.append("writeConcern", op.writeConcern);
+                            }
+                            ok = conn->runCommand(
+                                nsToDatabaseSubstring(op.ns).toString(), builder.done(), result);
+                        }
+                        if (!ok) {
+                            stats.errCount++;
+                        }
+
+                        if (op.useCheck) {
+                            int err = scope->invoke(scopeFunc, 0, &result, 1000 * 60, false);
+                            if (err) {
+                                log() << "Error checking in benchRun thread [findAndModify]"
+                                      << causedBy(scope->getError()) << endl;
+
+                                stats.errCount++;
+
+                                return;
+                            }
+                        }
+
+                        if (!_config->hideResults || op.showResult)
+                            log() << "Result from benchRun thread [findAndModify] : " << result
+                                  << endl;
+                    } break;
                     case OpType::CREATEINDEX:
                         conn->createIndex(op.ns, op.key);
                         break;
@@ -1241,6 +1504,15 @@ void BenchRunner::populateStats(BenchRunStats* stats) {
         stats->updateFrom(_workers[i]->stats());
 }
 
+static void appendLatencyStatsIfAvailable(BSONObjBuilder& buf,
+                                          StringData name,
+                                          const BenchRunEventCounter& counter) {
+    if (counter.getNumEvents() > 0) {
+        BSONObjBuilder sub(buf.subobjStart(name));
+        counter.appendLatencyStats(&sub);
+    }
+}
+
 static void appendAverageMicrosIfAvailable(BSONObjBuilder& buf,
                                            const std::string& name,
                                            const BenchRunEventCounter& counter) {
@@ -1271,6 +1543,9 @@ BSONObj BenchRunner::finish(BenchRunner* runner) {
     appendAverageMicrosIfAvailable(buf, "updateLatencyAverageMicros", stats.updateCounter);
     appendAverageMicrosIfAvailable(buf, "queryLatencyAverageMicros", stats.queryCounter);
     appendAverageMicrosIfAvailable(buf, "commandsLatencyAverageMicros", stats.commandCounter);
+    appendAverageMicrosIfAvailable(buf, "aggregateLatencyAverageMicros", stats.aggregateCounter);
+    appendAverageMicrosIfAvailable(
+        buf, "findAndModifyLatencyAverageMicros", stats.findAndModifyCounter);
 
     buf.append("totalOps", static_cast<long long>(stats.opCount));
 
@@ -1285,6 +1560,26 @@ BSONObj BenchRunner::finish(BenchRunner* runner) {
     appendPerSec("update", stats.updateCounter.getNumEvents());
     appendPerSec("query", stats.queryCounter.getNumEvents());
     appendPerSec("command", stats.commandCounter.getNumEvents());
+    appendPerSec("aggregate", stats.aggregateCounter.getNumEvents());
+    appendPerSec("findAndModify", stats.findAndModifyCounter.getNumEvents());
+
+    {
+        BSONObjBuilder latencies(buf.subobjStart("latencyMicros"));
+        appendLatencyStatsIfAvailable(latencies, "findOne", stats.findOneCounter);
+        appendLatencyStatsIfAvailable(latencies, "insert", stats.insertCounter);
+        appendLatencyStatsIfAvailable(latencies, "delete", stats.deleteCounter);
+        appendLatencyStatsIfAvailable(latencies, "update", stats.updateCounter);
+        appendLatencyStatsIfAvailable(latencies, "query", stats.queryCounter);
+        appendLatencyStatsIfAvailable(latencies, "command", stats.commandCounter);
+        appendLatencyStatsIfAvailable(latencies, "aggregate", stats.aggregateCounter);
+        appendLatencyStatsIfAvailable(latencies, "findAndModify", stats.findAndModifyCounter);
+    }
+
+    if (runner->_config->opsPerSecond > 0) {
+        buf.append("targetOps/s", runner->_config->opsPerSecond);
+        BSONObjBuilder lag(buf.subobjStart("scheduleLagMicros"));
+        stats.scheduleLagCounter.appendLatencyStats(&lag);
+    }
 
     BSONObj zoo = buf.obj();
 
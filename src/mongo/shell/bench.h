@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <array>
 #include <string>
 
 #include "mongo/client/dbclientinterface.h"
@@ -35,6 +36,7 @@
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
 #include "mongo/util/timer.h"
 
 namespace pcrecpp {
@@ -54,7 +56,9 @@ enum class OpType {
     REMOVE,
     CREATEINDEX,
     DROPINDEX,
-    LET
+    LET,
+    AGGREGATE,
+    FINDANDMODIFY
 };
 
 /**
@@ -63,6 +67,7 @@ enum class OpType {
 struct BenchRunOp {
 public:
     int batchSize = 0;
+    int bulkSize = 1;
     BSONElement check;
     BSONObj command;
     BSONObj context;
@@ -77,10 +82,14 @@ public:
     std::string ns;
     OpType op = OpType::NONE;
     int options = 0;
+    BSONObj pipeline;
     BSONObj projection;
     BSONObj query;
+    bool remove = false;
+    bool returnNew = false;
     bool safe = false;
     int skip = 0;
+    BSONObj sort;
     bool showError = false;
     bool showResult = false;
     std::string target;
@@ -156,6 +165,17 @@ public:
     /// Base random seed for threads
     int64_t randomSeed;
 
+    /**
+     * Target rate, in operations per second summed over all threads. Zero means each thread
+     * issues its next operation as soon as the previous one returns.
+     *
+     * When non-zero, every thread starts its operations on a fixed schedule, and each
+     * operation's latency is measured from the time it was scheduled to start rather than
+     * the time it actually started, so that a slow server can't hide its backlog by delaying
+     * the client (coordinated omission).
+     */
+    double opsPerSecond;
+
     bool hideResults;
     bool handleErrors;
     bool hideErrors;
@@ -187,6 +207,9 @@ private:
 /**
  * An event counter for events that have an associated duration.
  *
+ * Besides the count and total duration, keeps a log-linear histogram of the durations, with a
+ * relative error of at most 1/32, from which latency percentiles are reported.
+ *
  * Not thread safe. Expected use is one instance per thread during parallel execution.
  */
 class BenchRunEventCounter {
@@ -213,6 +236,9 @@ public:
     void countOne(long long timeMicros) {
         ++_numEvents;
         _totalTimeMicros += timeMicros;
+        if (timeMicros > _maxTimeMicros)
+            _maxTimeMicros = timeMicros;
+        ++_buckets[bucketFor(timeMicros)];
     }
 
     /**
@@ -229,9 +255,36 @@ public:
         return _numEvents;
     }
 
+    /**
+     * Returns the duration, in microseconds, which at least "fraction" (between 0 and 1) of the
+     * observed events did not exceed. Returns 0 if no events were observed.
+     */
+    long long getPercentileMicros(double fraction) const;
+
+    /**
+     * Appends the count, mean, maximum and the 50th, 90th, 99th and 99.9th percentiles of the
+     * observed durations, in microseconds, to "builder".
+     */
+    void appendLatencyStats(BSONObjBuilder* builder) const;
+
 private:
+    // Durations below 2 * kSubBuckets micros get a bucket each. Above that, every power of two
+    // is split into kSubBuckets equal buckets.
+    static const int kSubBucketBits = 5;
+    static const long long kSubBuckets = 1LL << kSubBucketBits;
+    // Enough for durations up to 2^40 micros, about twelve days. Longer ones are clamped.
+    static const int kMaxDurationBits = 40;
+    static const size_t kNumBuckets = (kMaxDurationBits - kSubBucketBits + 1) * kSubBuckets;
+
+    static size_t bucketFor(long long timeMicros);
+
+    /// Returns the largest duration which falls into bucket "index".
+    static long long bucketUpperBound(size_t index);
+
     unsigned long long _numEvents;
     long long _totalTimeMicros;
+    long long _maxTimeMicros;
+    std::array<unsigned long long, kNumBuckets> _buckets;
 };
 
 /**
@@ -255,6 +308,15 @@ public:
         initialize(eventCounter, eventCounter, false);
     }
 
+    /**
+     * Traces an event which was scheduled to start "scheduleLag" before now. The lag is added to
+     * the measured duration.
+     */
+    BenchRunEventTrace(BenchRunEventCounter* eventCounter, Microseconds scheduleLag)
+        : _scheduleLagMicros(durationCount<Microseconds>(scheduleLag)) {
+        initialize(eventCounter, eventCounter, false);
+    }
+
     BenchRunEventTrace(BenchRunEventCounter* successCounter,
                        BenchRunEventCounter* failCounter,
                        bool defaultToFailure = true) {
@@ -262,7 +324,8 @@ public:
     }
 
     ~BenchRunEventTrace() {
-        (_succeeded ? _successCounter : _failCounter)->countOne(_timer.micros());
+        (_succeeded ? _successCounter : _failCounter)
+            ->countOne(_timer.micros() + _scheduleLagMicros);
     }
 
     void succeed() {
@@ -282,6 +345,7 @@ private:
     }
 
     Timer _timer;
+    long long _scheduleLagMicros = 0;
     BenchRunEventCounter* _successCounter;
     BenchRunEventCounter* _failCounter;
     bool _succeeded;
@@ -311,6 +375,11 @@ public:
     BenchRunEventCounter deleteCounter;
     BenchRunEventCounter queryCounter;
     BenchRunEventCounter commandCounter;
+    BenchRunEventCounter aggregateCounter;
+    BenchRunEventCounter findAndModifyCounter;
+
+    /// How late operations started relative to their schedule. Only used when opsPerSecond is set.
+    BenchRunEventCounter scheduleLagCounter;
 
     std::map<std::string, long long> opcounters;
     std::vector<BSONObj> trappedErrors;
@@ -49,6 +49,7 @@
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/tools/bridge_commands.h"
+#include "mongo/tools/message_recording.h"
 #include "mongo/tools/mongobridge_options.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/exit.h"
@@ -90,8 +91,13 @@ public:
     Forwarder(AbstractMessagingPort* mp,
               stdx::mutex* settingsMutex,
               HostSettingsMap* settings,
+              MessageRecorder* recorder,
               int64_t seed)
-        : _mp(mp), _settingsMutex(settingsMutex), _settings(settings), _prng(seed) {}
+        : _mp(mp),
+          _settingsMutex(settingsMutex),
+          _settings(settings),
+          _recorder(recorder),
+          _prng(seed) {}
 
     void operator()() {
         DBClientConnection dest;
@@ -203,6 +209,8 @@ public:
                         break;
                 }
 
+                record(RecordedMessage::Direction::kRequest, request);
+
                 // Send the message we received from '_mp' to 'dest'. 'dest' returns a response for
                 // OP_QUERY, OP_MSG, OP_GET_MORE, and OP_COMMAND messages that we respond back to
                 // '_mp' with.
@@ -235,6 +243,7 @@ public:
                     }
 
                     _mp->say(response, requestId);
+                    record(RecordedMessage::Direction::kResponse, response);
 
                     // If 'exhaust' is true, then instead of trying to receive another message from
                     // '_mp', receive messages from 'dest' until it returns a cursor id of zero.
@@ -251,6 +260,7 @@ public:
                             response.reset();
                             dest.port().recv(response);
                             _mp->say(response, requestId);
+                            record(RecordedMessage::Direction::kResponse, response);
                         } else {
                             exhaust = false;
                         }
@@ -296,6 +306,12 @@ private:
         return boost::none;
     }
 
+    void record(RecordedMessage::Direction direction, const Message& message) {
+        if (_recorder) {
+            _recorder->record(_mp->connectionId(), direction, message);
+        }
+    }
+
     HostSettings getHostSettings(boost::optional<HostAndPort> host) {
         if (host) {
             stdx::lock_guard<stdx::mutex> lk(*_settingsMutex);
@@ -309,9 +325,14 @@ private:
     stdx::mutex* _settingsMutex;
     HostSettingsMap* _settings;
 
+    // Null unless mongobridge was started with --record.
+    MessageRecorder* _recorder;
+
     PseudoRandom _prng;
 };
 
+std::unique_ptr<MessageRecorder> recorder;
+
 class BridgeListener final : public Listener {
 public:
     BridgeListener()
@@ -330,7 +351,7 @@ public:
             _ports.insert(mp);
         }
 
-        Forwarder f(mp, &_settingsMutex, &_settings, _seedSource.nextInt64());
+        Forwarder f(mp, &_settingsMutex, &_settings, recorder.get(), _seedSource.nextInt64());
         stdx::thread t(f);
         t.detach();
     }
@@ -373,12 +394,20 @@ int bridgeMain(int argc, char** argv, char** envp) {
         // existence of threads.
         ListeningSockets::get()->closeAll();
         listener->shutdownAll();
+        if (recorder) {
+            recorder->flush();
+        }
     });
 
     setupSignalHandlers();
     runGlobalInitializersOrDie(argc, argv, envp);
     startSignalProcessingThread();
 
+    if (!mongoBridgeGlobalParams.recordFile.empty()) {
+        recorder = stdx::make_unique<MessageRecorder>(mongoBridgeGlobalParams.recordFile);
+        log() << "Recording forwarded messages to " << mongoBridgeGlobalParams.recordFile;
+    }
+
     listener = stdx::make_unique<BridgeListener>();
     listener->setupSockets();
     listener->initAndListen();
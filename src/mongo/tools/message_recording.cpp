@@ -0,0 +1,226 @@
+/**
+ * Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kBridge
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/tools/message_recording.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <cstdlib>
+#include <cstring>
+#include <snappy.h>
+
+#include "mongo/base/data_view.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Returns the length of the prefix of the recording 'fileName', which is 'fileSize' bytes long,
+ * that is made up of whole blocks. Anything after it was being written when a previous
+ * mongobridge exited.
+ */
+std::uint64_t getCompleteBlocksLength(const std::string& fileName, std::uint64_t fileSize) {
+    std::ifstream file(fileName.c_str(), std::ios::binary | std::ios::in);
+    std::uint64_t length = 0;
+    char header[sizeof(int32_t)];
+    while (file.read(header, sizeof(header))) {
+        const int32_t blockSize = std::abs(ConstDataView(header).read<LittleEndian<int32_t>>());
+        const std::uint64_t blockEnd = length + sizeof(header) + blockSize;
+        if (blockEnd > fileSize) {
+            break;
+        }
+        length = blockEnd;
+        file.seekg(length);
+    }
+    return length;
+}
+
+}  // namespace
+
+const Milliseconds MessageRecorder::kMaxBufferedTime{1000};
+
+MessageRecorder::MessageRecorder(const std::string& fileName) : _fileName(fileName) {
+    // Drop a block which was cut short so that the blocks appended here can be read back.
+    if (boost::filesystem::exists(_fileName)) {
+        const std::uint64_t fileSize = boost::filesystem::file_size(_fileName);
+        const std::uint64_t completeLength = getCompleteBlocksLength(_fileName, fileSize);
+        if (completeLength < fileSize) {
+            warning() << "Truncating incomplete block at offset " << completeLength
+                      << " of recording file \"" << _fileName << "\"";
+            boost::filesystem::resize_file(_fileName, completeLength);
+        }
+    }
+
+    _file.open(_fileName.c_str(), std::ios::binary | std::ios::out | std::ios::app);
+    uassert(40391,
+            str::stream() << "error opening recording file \"" << _fileName << "\": "
+                          << errnoWithDescription(),
+            _file.good());
+}
+
+MessageRecorder::~MessageRecorder() {
+    flush();
+}
+
+void MessageRecorder::record(long long connectionId,
+                             RecordedMessage::Direction direction,
+                             const Message& message) {
+    const std::uint64_t timestampMicros = curTimeMicros64();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_buffer.len() == 0) {
+        _oldestBuffered = Date_t::now();
+    }
+
+    _buffer.appendNum(static_cast<long long>(timestampMicros));
+    _buffer.appendNum(connectionId);
+    _buffer.appendNum(static_cast<char>(direction));
+    _buffer.appendBuf(message.sharedBuffer().get(), message.size());
+
+    if (_buffer.len() >= kBlockSize || Date_t::now() - _oldestBuffered >= kMaxBufferedTime) {
+        _flush_inlock();
+    }
+}
+
+void MessageRecorder::flush() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _flush_inlock();
+}
+
+void MessageRecorder::_flush_inlock() {
+    int32_t size = _buffer.len();
+    const char* outBuffer = _buffer.buf();
+
+    if (size == 0) {
+        return;
+    }
+
+    std::string compressed;
+    snappy::Compress(outBuffer, size, &compressed);
+
+    const bool shouldCompress = compressed.size() < size_t(size / 10 * 9);
+    if (shouldCompress) {
+        size = compressed.size();
+        outBuffer = compressed.data();
+    }
+
+    // A negative size means the block is compressed.
+    char header[sizeof(int32_t)];
+    DataView(header).write(tagLittleEndian<int32_t>(shouldCompress ? -size : size));
+
+    _file.write(header, sizeof(header));
+    _file.write(outBuffer, size);
+    _file.flush();
+    if (!_file.good()) {
+        // Losing part of a recording must not interrupt the traffic being forwarded.
+        error() << "error writing to recording file \"" << _fileName
+                << "\": " << errnoWithDescription();
+        _file.clear();
+    }
+
+    _buffer.reset();
+}
+
+MessageRecordingReader::MessageRecordingReader(const std::string& fileName)
+    : _fileName(fileName) {
+    _file.open(_fileName.c_str(), std::ios::binary | std::ios::in);
+    uassert(40392,
+            str::stream() << "error opening recording file \"" << _fileName << "\": "
+                          << errnoWithDescription(),
+            _file.good());
+}
+
+bool MessageRecordingReader::next(RecordedMessage* out) {
+    while (!_reader || _reader->atEof()) {
+        if (!_readBlock()) {
+            return false;
+        }
+    }
+
+    out->timestampMicros = _reader->read<LittleEndian<long long>>();
+    out->connectionId = _reader->read<LittleEndian<long long>>();
+    out->direction = static_cast<RecordedMessage::Direction>(_reader->read<char>());
+
+    const int32_t size = _reader->peek<LittleEndian<int32_t>>();
+    uassert(40393,
+            str::stream() << "invalid message length " << size << " in recording file \""
+                          << _fileName << "\"",
+            size >= static_cast<int32_t>(sizeof(MSGHEADER::Value)) &&
+                static_cast<uint32_t>(size) <= _reader->remaining());
+
+    SharedBuffer buffer = SharedBuffer::allocate(size);
+    std::memcpy(buffer.get(), _reader->skip(size), size);
+    out->message = Message(std::move(buffer));
+    return true;
+}
+
+bool MessageRecordingReader::_readBlock() {
+    char header[sizeof(int32_t)];
+    if (!_file.read(header, sizeof(header))) {
+        return false;
+    }
+
+    const int32_t rawSize = ConstDataView(header).read<LittleEndian<int32_t>>();
+    const bool compressed = rawSize < 0;
+    size_t blockSize = std::abs(rawSize);
+
+    std::unique_ptr<char[]> block(new char[blockSize]);
+    if (!_file.read(block.get(), blockSize)) {
+        // The last block was cut short.
+        return false;
+    }
+
+    if (compressed) {
+        size_t uncompressedSize;
+        uassert(40394,
+                str::stream() << "corrupt block in recording file \"" << _fileName << "\"",
+                snappy::GetUncompressedLength(block.get(), blockSize, &uncompressedSize));
+
+        std::unique_ptr<char[]> uncompressed(new char[uncompressedSize]);
+        uassert(40395,
+                str::stream() << "corrupt block in recording file \"" << _fileName << "\"",
+                snappy::RawUncompress(block.get(), blockSize, uncompressed.get()));
+
+        block.swap(uncompressed);
+        blockSize = uncompressedSize;
+    }
+
+    _block = std::move(block);
+    _reader = stdx::make_unique<BufReader>(_block.get(), blockSize);
+    return true;
+}
+
+}  // namespace mongo
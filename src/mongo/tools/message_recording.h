@@ -0,0 +1,133 @@
+/**
+ * Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/util/builder.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/bufreader.h"
+#include "mongo/util/net/message.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * A message which passed through mongobridge, along with when it was seen and on which connection.
+ */
+struct RecordedMessage {
+    enum class Direction : std::uint8_t { kRequest = 0, kResponse = 1 };
+
+    // Microseconds since the epoch.
+    std::uint64_t timestampMicros = 0;
+    long long connectionId = 0;
+    Direction direction = Direction::kRequest;
+
+    // The message as it was sent on the wire, including its header.
+    Message message;
+};
+
+/**
+ * Appends the messages forwarded by mongobridge to a recording file, so that a workload can be
+ * replayed later. Safe to call from every forwarding thread.
+ *
+ * The file is a sequence of blocks, each an int32 length followed by that many bytes of records.
+ * A negative length means the block is snappy-compressed. Blocks are self-contained, so a new
+ * recorder appends to an existing file and a reader only loses the block that was being written
+ * if mongobridge is killed.
+ */
+class MessageRecorder {
+    MONGO_DISALLOW_COPYING(MessageRecorder);
+
+public:
+    /**
+     * Opens 'fileName' for appending. Throws if it can't be opened.
+     */
+    explicit MessageRecorder(const std::string& fileName);
+
+    ~MessageRecorder();
+
+    void record(long long connectionId,
+                RecordedMessage::Direction direction,
+                const Message& message);
+
+    /**
+     * Writes out the records which are buffered in memory.
+     */
+    void flush();
+
+private:
+    void _flush_inlock();
+
+    // A block is written once it reaches this size, or once it holds records older than
+    // kMaxBufferedTime.
+    static const int kBlockSize = 256 * 1024;
+    static const Milliseconds kMaxBufferedTime;
+
+    const std::string _fileName;
+
+    stdx::mutex _mutex;
+    std::ofstream _file;
+    BufBuilder _buffer;
+    Date_t _oldestBuffered;
+};
+
+/**
+ * Reads back the messages written by a MessageRecorder, in the order in which they were recorded.
+ */
+class MessageRecordingReader {
+    MONGO_DISALLOW_COPYING(MessageRecordingReader);
+
+public:
+    /**
+     * Opens 'fileName' for reading. Throws if it can't be opened.
+     */
+    explicit MessageRecordingReader(const std::string& fileName);
+
+    /**
+     * Stores the next message in 'out' and returns true, or returns false at the end of the
+     * recording. A block which was cut short by mongobridge exiting is treated as the end.
+     */
+    bool next(RecordedMessage* out);
+
+private:
+    bool _readBlock();
+
+    const std::string _fileName;
+
+    std::ifstream _file;
+    std::unique_ptr<char[]> _block;
+    std::unique_ptr<BufReader> _reader;
+};
+
+}  // namespace mongo
@@ -0,0 +1,171 @@
+/**
+ * Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects
+ *    for all of the code used other than as permitted herein. If you modify
+ *    file(s) with this exception, you may extend this exception to your
+ *    version of the file(s), but you are not obligated to do so. If you do not
+ *    wish to do so, delete this exception statement from your version. If you
+ *    delete this exception statement from all source files in the program,
+ *    then also delete it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/tools/message_recording.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <string>
+
+#include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using Direction = RecordedMessage::Direction;
+
+Message makeMessage(const std::string& text) {
+    Message message;
+    message.setData(dbMsg, text.c_str());
+    message.header().setId(nextMessageId());
+    return message;
+}
+
+void assertNextMessage(MessageRecordingReader* reader,
+                       long long connectionId,
+                       Direction direction,
+                       const Message& expected) {
+    RecordedMessage recorded;
+    ASSERT_TRUE(reader->next(&recorded));
+    ASSERT_EQ(connectionId, recorded.connectionId);
+    ASSERT(direction == recorded.direction);
+    ASSERT_EQ(expected.size(), recorded.message.size());
+    ASSERT_EQ(0,
+              memcmp(expected.sharedBuffer().get(),
+                     recorded.message.sharedBuffer().get(),
+                     expected.size()));
+}
+
+TEST(MessageRecordingTest, ReadsBackRecordedMessagesInOrder) {
+    unittest::TempDir tempDir("message_recording_test");
+    const std::string fileName = tempDir.path() + "/recording";
+
+    const Message request = makeMessage("request");
+    const Message response = makeMessage("response");
+    const Message other = makeMessage("other");
+    {
+        MessageRecorder recorder(fileName);
+        recorder.record(1, Direction::kRequest, request);
+        recorder.record(2, Direction::kRequest, other);
+        recorder.record(1, Direction::kResponse, response);
+    }
+
+    MessageRecordingReader reader(fileName);
+    assertNextMessage(&reader, 1, Direction::kRequest, request);
+    assertNextMessage(&reader, 2, Direction::kRequest, other);
+    assertNextMessage(&reader, 1, Direction::kResponse, response);
+
+    RecordedMessage recorded;
+    ASSERT_FALSE(reader.next(&recorded));
+}
+
+TEST(MessageRecordingTest, TimestampsAreNonDecreasing) {
+    unittest::TempDir tempDir("message_recording_test");
+    const std::string fileName = tempDir.path() + "/recording";
+
+    const std::uint64_t start = curTimeMicros64();
+    {
+        MessageRecorder recorder(fileName);
+        for (int i = 0; i < 10; ++i) {
+            recorder.record(1, Direction::kRequest, makeMessage("request"));
+        }
+    }
+
+    MessageRecordingReader reader(fileName);
+    RecordedMessage recorded;
+    std::uint64_t last = start;
+    while (reader.next(&recorded)) {
+        ASSERT_GTE(recorded.timestampMicros, last);
+        last = recorded.timestampMicros;
+    }
+}
+
+TEST(MessageRecordingTest, SpansManyBlocks) {
+    unittest::TempDir tempDir("message_recording_test");
+    const std::string fileName = tempDir.path() + "/recording";
+
+    // Enough data for several blocks, with some of them compressible.
+    const Message message = makeMessage(std::string(10 * 1024, 'x'));
+    const int kNumMessages = 100;
+    {
+        MessageRecorder recorder(fileName);
+        for (int i = 0; i < kNumMessages; ++i) {
+            recorder.record(i, Direction::kRequest, message);
+            if (i % 30 == 0) {
+                recorder.flush();
+            }
+        }
+    }
+
+    MessageRecordingReader reader(fileName);
+    for (int i = 0; i < kNumMessages; ++i) {
+        assertNextMessage(&reader, i, Direction::kRequest, message);
+    }
+    RecordedMessage recorded;
+    ASSERT_FALSE(reader.next(&recorded));
+}
+
+TEST(MessageRecordingTest, AppendsAfterIncompleteBlock) {
+    unittest::TempDir tempDir("message_recording_test");
+    const std::string fileName = tempDir.path() + "/recording";
+
+    const Message first = makeMessage("first");
+    const Message second = makeMessage("second");
+    const Message third = makeMessage("third");
+    {
+        MessageRecorder recorder(fileName);
+        recorder.record(1, Direction::kRequest, first);
+        recorder.flush();
+        recorder.record(1, Direction::kRequest, second);
+    }
+
+    // Cut the second block short, as if mongobridge had been killed while writing it.
+    boost::filesystem::resize_file(fileName, boost::filesystem::file_size(fileName) - 1);
+    {
+        MessageRecordingReader reader(fileName);
+        assertNextMessage(&reader, 1, Direction::kRequest, first);
+        RecordedMessage recorded;
+        ASSERT_FALSE(reader.next(&recorded));
+    }
+
+    {
+        MessageRecorder recorder(fileName);
+        recorder.record(2, Direction::kRequest, third);
+    }
+
+    MessageRecordingReader reader(fileName);
+    assertNextMessage(&reader, 1, Direction::kRequest, first);
+    assertNextMessage(&reader, 2, Direction::kRequest, third);
+    RecordedMessage recorded;
+    ASSERT_FALSE(reader.next(&recorded));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -51,6 +51,11 @@ Status addMongoBridgeOptions(moe::OptionSection* options) {
 
     options->addOptionChaining("dest", "dest", moe::String, "URI of remote MongoDB process");
 
+    options->addOptionChaining("record",
+                               "record",
+                               moe::String,
+                               "file to append a timestamped log of forwarded messages to");
+
     options->addOptionChaining("verbose", "verbose", moe::String, "log more verbose output")
         .setImplicit(moe::Value(std::string("v")));
 
@@ -86,6 +91,10 @@ Status storeMongoBridgeOptions(const moe::Environment& params,
     mongoBridgeGlobalParams.port = params["port"].as<int>();
     mongoBridgeGlobalParams.destUri = params["dest"].as<std::string>();
 
+    if (params.count("record")) {
+        mongoBridgeGlobalParams.recordFile = params["record"].as<std::string>();
+    }
+
     if (!params.count("seed")) {
         std::unique_ptr<SecureRandom> seedSource{SecureRandom::create()};
         mongoBridgeGlobalParams.seed = seedSource->nextInt64();
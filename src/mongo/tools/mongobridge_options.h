@@ -49,6 +49,9 @@ struct MongoBridgeGlobalParams {
     std::int64_t seed = 0;
     std::string destUri;
 
+    // If set, the messages forwarded by mongobridge are appended to this file.
+    std::string recordFile;
+
     MongoBridgeGlobalParams() = default;
 };
 
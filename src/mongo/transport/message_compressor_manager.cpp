@@ -0,0 +1,278 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/message_compressor_manager.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "mongo/base/data_range_cursor.h"
+#include "mongo/base/data_type_string_data.h"
+#include "mongo/base/data_type_terminated.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/transport/message_compressor_base.h"
+#include "mongo/transport/message_compressor_registry.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+
+const char kCompressionFieldName[] = "compression";
+
+// Commands carrying credentials or taking part in the handshake itself are never compressed, so
+// that they are exchanged exactly as they would be without compression.
+const StringData kNoCompressCommands[] = {"isMaster"_sd,
+                                          "ismaster"_sd,
+                                          "saslStart"_sd,
+                                          "saslContinue"_sd,
+                                          "getnonce"_sd,
+                                          "authenticate"_sd,
+                                          "createUser"_sd,
+                                          "updateUser"_sd,
+                                          "copydbSaslStart"_sd,
+                                          "copydbgetnonce"_sd,
+                                          "copydb"_sd};
+
+/**
+ * Returns the name of the command in an OP_QUERY or OP_COMMAND request, or an empty StringData
+ * for any other message.
+ */
+StringData getCommandName(const Message& msg) {
+    ConstDataRangeCursor cursor(msg.singleData().data(),
+                                msg.singleData().data() + msg.singleData().dataLen());
+
+    if (msg.operation() == dbCommand) {
+        // database, then commandName.
+        auto db = cursor.readAndAdvance<Terminated<'\0', StringData>>();
+        if (!db.isOK()) {
+            return {};
+        }
+        auto commandName = cursor.readAndAdvance<Terminated<'\0', StringData>>();
+        return commandName.isOK() ? commandName.getValue().value : StringData();
+    }
+
+    if (msg.operation() == dbQuery) {
+        // flags, ns, ntoskip, ntoreturn, then the query.
+        if (!cursor.skip<LittleEndian<int32_t>>().isOK()) {
+            return {};
+        }
+        auto ns = cursor.readAndAdvance<Terminated<'\0', StringData>>();
+        if (!ns.isOK() || !ns.getValue().value.endsWith(".$cmd")) {
+            return {};
+        }
+        if (!cursor.skip<LittleEndian<int32_t>>().isOK() ||
+            !cursor.skip<LittleEndian<int32_t>>().isOK()) {
+            return {};
+        }
+        auto query = cursor.read<BSONObj>();
+        if (!query.isOK()) {
+            return {};
+        }
+        BSONObj cmd = query.getValue();
+        BSONElement wrapped = cmd["$query"];
+        if (wrapped.eoo()) {
+            wrapped = cmd["query"];
+        }
+        if (wrapped.type() == Object) {
+            cmd = wrapped.Obj();
+        }
+        return cmd.firstElementFieldName();
+    }
+
+    return {};
+}
+
+bool isCompressible(const Message& msg) {
+    auto commandName = getCommandName(msg);
+    if (commandName.empty()) {
+        return true;
+    }
+    return std::find(std::begin(kNoCompressCommands), std::end(kNoCompressCommands), commandName) ==
+        std::end(kNoCompressCommands);
+}
+
+}  // namespace
+
+MessageCompressorManager::MessageCompressorManager()
+    : MessageCompressorManager(&MessageCompressorRegistry::get()) {}
+
+MessageCompressorManager::MessageCompressorManager(MessageCompressorRegistry* registry)
+    : _registry(registry) {}
+
+void MessageCompressorManager::clientBegin(BSONObjBuilder* output) {
+    _negotiated.clear();
+
+    const auto& names = _registry->getCompressorNames();
+    if (names.empty()) {
+        return;
+    }
+
+    BSONArrayBuilder sub(output->subarrayStart(kCompressionFieldName));
+    for (const auto& name : names) {
+        sub.append(name);
+    }
+    sub.doneFast();
+}
+
+void MessageCompressorManager::clientFinish(const BSONObj& input) {
+    _negotiated.clear();
+    _isClient = true;
+
+    BSONElement elem = input.getField(kCompressionFieldName);
+    if (elem.type() != Array) {
+        return;
+    }
+
+    for (const auto& e : elem.Obj()) {
+        if (e.type() != String) {
+            continue;
+        }
+        auto compressor = _registry->getCompressor(e.valueStringData());
+        if (compressor) {
+            _negotiated.push_back(compressor);
+        }
+    }
+}
+
+void MessageCompressorManager::serverNegotiate(const BSONObj& input, BSONObjBuilder* output) {
+    _negotiated.clear();
+
+    BSONElement elem = input.getField(kCompressionFieldName);
+    if (elem.type() != Array) {
+        return;
+    }
+
+    for (const auto& e : elem.Obj()) {
+        if (e.type() != String) {
+            continue;
+        }
+        auto compressor = _registry->getCompressor(e.valueStringData());
+        if (compressor &&
+            std::find(_negotiated.begin(), _negotiated.end(), compressor) == _negotiated.end()) {
+            _negotiated.push_back(compressor);
+        }
+    }
+
+    if (_negotiated.empty()) {
+        return;
+    }
+
+    BSONArrayBuilder sub(output->subarrayStart(kCompressionFieldName));
+    for (auto compressor : _negotiated) {
+        sub.append(compressor->getName());
+    }
+    sub.doneFast();
+}
+
+StatusWith<Message> MessageCompressorManager::compressMessage(const Message& msg) {
+    MessageCompressorBase* compressor = _lastReceived;
+    if (!compressor && _isClient && !_negotiated.empty()) {
+        compressor = _negotiated.front();
+    }
+
+    if (!compressor || msg.operation() == dbCompressed || !isCompressible(msg)) {
+        return msg;
+    }
+
+    const auto inputHeader = msg.singleData();
+    const size_t inputSize = inputHeader.dataLen();
+    const size_t bufferSize = compressor->getMaxCompressedSize(inputSize) +
+        MsgData::MsgDataHeaderSize + kCompressionHeaderSize;
+
+    auto outputBuffer = SharedBuffer::allocate(bufferSize);
+    MsgData::View outMessage(outputBuffer.get());
+    outMessage.setId(inputHeader.getId());
+    outMessage.setResponseToMsgId(inputHeader.getResponseToMsgId());
+    outMessage.setOperation(dbCompressed);
+
+    DataRangeCursor output(outMessage.data(), outputBuffer.get() + bufferSize);
+    invariantOK(output.writeAndAdvance<LittleEndian<int32_t>>(inputHeader.getNetworkOp()));
+    invariantOK(output.writeAndAdvance<LittleEndian<int32_t>>(inputSize));
+    invariantOK(output.writeAndAdvance<LittleEndian<uint8_t>>(compressor->getId()));
+
+    auto sws = compressor->compressData(ConstDataRange(inputHeader.data(), inputSize), output);
+    if (!sws.isOK()) {
+        return sws.getStatus();
+    }
+
+    outMessage.setLen(MsgData::MsgDataHeaderSize + kCompressionHeaderSize + sws.getValue());
+
+    return {Message(outputBuffer)};
+}
+
+StatusWith<Message> MessageCompressorManager::decompressMessage(const Message& msg) {
+    if (msg.operation() != dbCompressed) {
+        _lastReceived = nullptr;
+        return msg;
+    }
+
+    const auto inputHeader = msg.singleData();
+    ConstDataRangeCursor input(inputHeader.data(), inputHeader.data() + inputHeader.dataLen());
+
+    auto originalOpcode = input.readAndAdvance<LittleEndian<int32_t>>();
+    auto uncompressedSize = input.readAndAdvance<LittleEndian<int32_t>>();
+    auto compressorId = input.readAndAdvance<LittleEndian<uint8_t>>();
+    if (!originalOpcode.isOK() || !uncompressedSize.isOK() || !compressorId.isOK()) {
+        return {ErrorCodes::BadValue, "Compressed message header was truncated"};
+    }
+
+    auto compressor = _registry->getCompressor(compressorId.getValue().value);
+    if (!compressor) {
+        return {ErrorCodes::InternalError,
+                str::stream() << "Compression algorithm specified in message is not available: "
+                              << static_cast<int>(compressorId.getValue().value)};
+    }
+
+    const int32_t size = uncompressedSize.getValue().value;
+    if (size < 0 || static_cast<size_t>(size) + MsgData::MsgDataHeaderSize > MaxMessageSizeBytes) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "Decompressed message would be " << size
+                              << " bytes, which is not a valid message size"};
+    }
+
+    const size_t bufferSize = size + MsgData::MsgDataHeaderSize;
+    auto outputBuffer = SharedBuffer::allocate(bufferSize);
+    MsgData::View outMessage(outputBuffer.get());
+    outMessage.setLen(bufferSize);
+    outMessage.setId(inputHeader.getId());
+    outMessage.setResponseToMsgId(inputHeader.getResponseToMsgId());
+    outMessage.setOperation(originalOpcode.getValue().value);
+
+    auto sws = compressor->decompressData(input, DataRange(outMessage.data(), size));
+    if (!sws.isOK()) {
+        return sws.getStatus();
+    }
+
+    _lastReceived = compressor;
+    return {Message(outputBuffer)};
+}
+
+}  // namespace mongo
@@ -0,0 +1,124 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/base/status_with.h"
+#include "mongo/util/net/message.h"
+
+namespace mongo {
+
+class BSONObj;
+class BSONObjBuilder;
+class MessageCompressorBase;
+class MessageCompressorRegistry;
+
+/**
+ * Per-connection state for wire protocol compression.
+ *
+ * Compression is negotiated during the isMaster handshake. The client lists the compressors it
+ * is willing to use, in order of preference, in the "compression" field of its isMaster command
+ * (clientBegin). The server replies with the subset it also supports (serverNegotiate), and the
+ * client records that reply (clientFinish). From then on either side may wrap messages in an
+ * OP_COMPRESSED envelope:
+ *
+ *     MSGHEADER      header;            // opCode is dbCompressed; id and responseTo are kept
+ *     int32          originalOpcode;
+ *     int32          uncompressedSize;  // size of the original message, less its header
+ *     uint8          compressorId;
+ *     char[]         compressedMessage;
+ *
+ * A client compresses its requests with the first compressor the server agreed to. A server only
+ * compresses replies to requests that were themselves compressed, and uses the same compressor.
+ */
+class MessageCompressorManager {
+public:
+    /**
+     * Constructs a manager using the process-wide compressor registry.
+     */
+    MessageCompressorManager();
+
+    explicit MessageCompressorManager(MessageCompressorRegistry* registry);
+
+    /**
+     * Called by a client to add the compressors it supports to an outgoing isMaster command.
+     */
+    void clientBegin(BSONObjBuilder* output);
+
+    /**
+     * Called by a client with the server's reply to isMaster to record which compressors were
+     * agreed on. Replies without a "compression" field leave compression disabled.
+     */
+    void clientFinish(const BSONObj& input);
+
+    /**
+     * Called by a server with an incoming isMaster command. Appends to "output" the compressors
+     * of the client, in the client's order of preference, that this server also supports.
+     */
+    void serverNegotiate(const BSONObj& input, BSONObjBuilder* output);
+
+    /**
+     * Returns "msg" wrapped in an OP_COMPRESSED envelope if a compressor was negotiated and the
+     * message is eligible for compression, or "msg" itself otherwise. The request id and
+     * responseTo of "msg" must already be set.
+     */
+    StatusWith<Message> compressMessage(const Message& msg);
+
+    /**
+     * Returns the message inside an OP_COMPRESSED envelope, or "msg" itself if it is not
+     * compressed.
+     */
+    StatusWith<Message> decompressMessage(const Message& msg);
+
+    /**
+     * Returns the compressors agreed on during the handshake, in order of preference.
+     */
+    const std::vector<MessageCompressorBase*>& getNegotiatedCompressors() const {
+        return _negotiated;
+    }
+
+    /**
+     * The number of bytes needed for the OP_COMPRESSED prefix that follows the message header.
+     */
+    static const size_t kCompressionHeaderSize =
+        sizeof(int32_t) + sizeof(int32_t) + sizeof(uint8_t);
+
+private:
+    MessageCompressorRegistry* _registry;
+    std::vector<MessageCompressorBase*> _negotiated;
+
+    // True once clientFinish has run, that is if this end of the connection issues requests.
+    bool _isClient = false;
+
+    // The compressor of the last message decompressed, or nullptr if it was not compressed.
+    MessageCompressorBase* _lastReceived = nullptr;
+};
+
+}  // namespace mongo
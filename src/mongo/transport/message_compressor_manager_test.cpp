@@ -0,0 +1,270 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/message_compressor_manager.h"
+#include "mongo/transport/message_compressor_noop.h"
+#include "mongo/transport/message_compressor_registry.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::unique_ptr<MessageCompressorRegistry> buildRegistry(std::vector<std::string> names) {
+    auto registry = stdx::make_unique<MessageCompressorRegistry>();
+    registry->registerImplementation(stdx::make_unique<NoopMessageCompressor>());
+    ASSERT_OK(registry->setSupportedCompressors(std::move(names)));
+    return registry;
+}
+
+Message buildQuery(StringData ns, const BSONObj& query) {
+    BufBuilder b;
+    b.appendNum(0);  // flags
+    b.appendStr(ns);
+    b.appendNum(0);  // ntoskip
+    b.appendNum(1);  // ntoreturn
+    query.appendSelfToBufBuilder(b);
+
+    Message msg;
+    msg.setData(dbQuery, b.buf(), b.len());
+    msg.header().setId(1234);
+    msg.header().setResponseToMsgId(5678);
+    return msg;
+}
+
+Message buildInsert() {
+    std::string payload(10000, 'x');
+    BufBuilder b;
+    b.appendNum(0);  // flags
+    b.appendStr("test.coll");
+    BSON("_id" << 1 << "payload" << payload).appendSelfToBufBuilder(b);
+
+    Message msg;
+    msg.setData(dbInsert, b.buf(), b.len());
+    msg.header().setId(42);
+    return msg;
+}
+
+/**
+ * Runs the isMaster handshake between "client" and "server" and returns the server's reply.
+ */
+BSONObj negotiate(MessageCompressorManager* client, MessageCompressorManager* server) {
+    BSONObjBuilder isMaster;
+    isMaster.append("isMaster", 1);
+    client->clientBegin(&isMaster);
+
+    BSONObjBuilder reply;
+    server->serverNegotiate(isMaster.obj(), &reply);
+    BSONObj replyObj = reply.obj();
+    client->clientFinish(replyObj);
+    return replyObj;
+}
+
+void checkRoundTrip(const std::string& compressorName) {
+    auto registry = buildRegistry({compressorName});
+    MessageCompressorManager client(registry.get());
+    MessageCompressorManager server(registry.get());
+
+    auto reply = negotiate(&client, &server);
+    ASSERT_EQ(reply["compression"].Array().size(), 1U);
+    ASSERT_EQ(reply["compression"].Array()[0].String(), compressorName);
+    ASSERT_EQ(client.getNegotiatedCompressors().size(), 1U);
+
+    Message original = buildInsert();
+    auto compressed = client.compressMessage(original);
+    ASSERT_OK(compressed.getStatus());
+    ASSERT_EQ(compressed.getValue().operation(), dbCompressed);
+    ASSERT_EQ(compressed.getValue().header().getId(), 42);
+    if (compressorName != "noop") {
+        ASSERT_LT(compressed.getValue().size(), original.size());
+    }
+
+    auto decompressed = server.decompressMessage(compressed.getValue());
+    ASSERT_OK(decompressed.getStatus());
+    auto& result = decompressed.getValue();
+    ASSERT_EQ(result.operation(), dbInsert);
+    ASSERT_EQ(result.header().getId(), 42);
+    ASSERT_EQ(result.size(), original.size());
+    ASSERT_EQ(0, memcmp(result.buf(), original.buf(), original.size()));
+
+    // The server answers a compressed request with a compressed reply.
+    auto compressedReply = server.compressMessage(buildInsert());
+    ASSERT_OK(compressedReply.getStatus());
+    ASSERT_EQ(compressedReply.getValue().operation(), dbCompressed);
+}
+
+TEST(MessageCompressorManager, RoundTripNoop) {
+    checkRoundTrip("noop");
+}
+
+TEST(MessageCompressorManager, RoundTripSnappy) {
+    checkRoundTrip("snappy");
+}
+
+TEST(MessageCompressorManager, RoundTripZlib) {
+    checkRoundTrip("zlib");
+}
+
+TEST(MessageCompressorManager, NegotiationKeepsClientOrder) {
+    auto clientRegistry = buildRegistry({"zlib", "noop", "snappy"});
+    auto serverRegistry = buildRegistry({"snappy", "zlib"});
+    MessageCompressorManager client(clientRegistry.get());
+    MessageCompressorManager server(serverRegistry.get());
+
+    auto reply = negotiate(&client, &server);
+    auto names = reply["compression"].Array();
+    ASSERT_EQ(names.size(), 2U);
+    ASSERT_EQ(names[0].String(), "zlib");
+    ASSERT_EQ(names[1].String(), "snappy");
+
+    ASSERT_EQ(client.getNegotiatedCompressors().size(), 2U);
+    ASSERT_EQ(client.getNegotiatedCompressors()[0]->getName(), "zlib");
+}
+
+TEST(MessageCompressorManager, NoCommonCompressor) {
+    auto clientRegistry = buildRegistry({"noop"});
+    auto serverRegistry = buildRegistry({"snappy"});
+    MessageCompressorManager client(clientRegistry.get());
+    MessageCompressorManager server(serverRegistry.get());
+
+    auto reply = negotiate(&client, &server);
+    ASSERT_FALSE(reply.hasField("compression"));
+    ASSERT_TRUE(client.getNegotiatedCompressors().empty());
+
+    auto msg = client.compressMessage(buildInsert());
+    ASSERT_OK(msg.getStatus());
+    ASSERT_EQ(msg.getValue().operation(), dbInsert);
+}
+
+TEST(MessageCompressorManager, CompressionDisabled) {
+    auto registry = buildRegistry({});
+    MessageCompressorManager client(registry.get());
+
+    BSONObjBuilder isMaster;
+    client.clientBegin(&isMaster);
+    ASSERT_FALSE(isMaster.obj().hasField("compression"));
+}
+
+TEST(MessageCompressorManager, OldServerLeavesCompressionOff) {
+    auto registry = buildRegistry({"snappy"});
+    MessageCompressorManager client(registry.get());
+
+    client.clientFinish(BSON("ismaster" << true << "maxWireVersion" << 4));
+    ASSERT_TRUE(client.getNegotiatedCompressors().empty());
+}
+
+TEST(MessageCompressorManager, ServerDoesNotCompressRepliesToUncompressedRequests) {
+    auto registry = buildRegistry({"snappy"});
+    MessageCompressorManager client(registry.get());
+    MessageCompressorManager server(registry.get());
+    negotiate(&client, &server);
+
+    auto request = server.decompressMessage(buildInsert());
+    ASSERT_OK(request.getStatus());
+    ASSERT_EQ(request.getValue().operation(), dbInsert);
+
+    auto reply = server.compressMessage(buildInsert());
+    ASSERT_OK(reply.getStatus());
+    ASSERT_EQ(reply.getValue().operation(), dbInsert);
+}
+
+TEST(MessageCompressorManager, HandshakeAndAuthCommandsAreNotCompressed) {
+    auto registry = buildRegistry({"snappy"});
+    MessageCompressorManager client(registry.get());
+    MessageCompressorManager server(registry.get());
+    negotiate(&client, &server);
+
+    for (auto&& cmd : {BSON("isMaster" << 1),
+                       BSON("saslStart" << 1 << "mechanism"
+                                        << "SCRAM-SHA-1"),
+                       BSON("$query" << BSON("authenticate" << 1)),
+                       BSON("createUser"
+                            << "bob"
+                            << "pwd"
+                            << "secret")}) {
+        auto msg = client.compressMessage(buildQuery("admin.$cmd", cmd));
+        ASSERT_OK(msg.getStatus());
+        ASSERT_EQ(msg.getValue().operation(), dbQuery);
+    }
+
+    auto msg = client.compressMessage(buildQuery("admin.$cmd", BSON("ping" << 1)));
+    ASSERT_OK(msg.getStatus());
+    ASSERT_EQ(msg.getValue().operation(), dbCompressed);
+
+    msg = client.compressMessage(buildQuery("test.saslStart", BSON("saslStart" << 1)));
+    ASSERT_OK(msg.getStatus());
+    ASSERT_EQ(msg.getValue().operation(), dbCompressed);
+}
+
+TEST(MessageCompressorManager, BadMessagesAreRejected) {
+    auto registry = buildRegistry({"noop"});
+    MessageCompressorManager client(registry.get());
+    MessageCompressorManager server(registry.get());
+    negotiate(&client, &server);
+
+    auto compressed = client.compressMessage(buildInsert());
+    ASSERT_OK(compressed.getStatus());
+    auto& msg = compressed.getValue();
+
+    // Claim an uncompressed size larger than any valid message.
+    DataView(msg.singleData().view2ptr())
+        .write<LittleEndian<int32_t>>(MaxMessageSizeBytes, MsgData::MsgDataHeaderSize + 4);
+    ASSERT_EQ(server.decompressMessage(msg).getStatus(), ErrorCodes::BadValue);
+
+    // Name a compressor that is not enabled.
+    auto snappyOnly = buildRegistry({"snappy"});
+    MessageCompressorManager snappyServer(snappyOnly.get());
+    auto other = client.compressMessage(buildInsert());
+    ASSERT_OK(other.getStatus());
+    ASSERT_NOT_OK(snappyServer.decompressMessage(other.getValue()).getStatus());
+}
+
+TEST(MessageCompressorManager, CorruptSnappyDataIsRejected) {
+    auto registry = buildRegistry({"snappy"});
+    MessageCompressorManager client(registry.get());
+    MessageCompressorManager server(registry.get());
+    negotiate(&client, &server);
+
+    auto compressed = client.compressMessage(buildInsert());
+    ASSERT_OK(compressed.getStatus());
+    auto& msg = compressed.getValue();
+    char* body = msg.singleData().view2ptr() + MsgData::MsgDataHeaderSize +
+        MessageCompressorManager::kCompressionHeaderSize;
+    memset(body, 0xff, 8);
+    ASSERT_NOT_OK(server.decompressMessage(msg).getStatus());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,119 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/message_compressor_registry.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/transport/message_compressor_snappy.h"
+#include "mongo/transport/message_compressor_zlib.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/stringutils.h"
+
+namespace mongo {
+
+MessageCompressorRegistry::MessageCompressorRegistry() : _compressorNames{"snappy"} {
+    registerImplementation(stdx::make_unique<SnappyMessageCompressor>());
+    registerImplementation(stdx::make_unique<ZlibMessageCompressor>());
+}
+
+MessageCompressorRegistry& MessageCompressorRegistry::get() {
+    static MessageCompressorRegistry globalRegistry;
+    return globalRegistry;
+}
+
+void MessageCompressorRegistry::registerImplementation(
+    std::unique_ptr<MessageCompressorBase> compressor) {
+    auto& slot = _compressors[compressor->getId()];
+    invariant(!slot);
+    invariant(!_findRegistered(compressor->getName()));
+    slot = std::move(compressor);
+}
+
+Status MessageCompressorRegistry::setSupportedCompressors(std::vector<std::string> names) {
+    for (auto it = names.begin(); it != names.end(); ++it) {
+        if (!_findRegistered(*it)) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "Invalid network message compressor specified: " << *it};
+        }
+        if (std::find(names.begin(), it, *it) != it) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "Network message compressor specified twice: " << *it};
+        }
+    }
+    _compressorNames = std::move(names);
+    return Status::OK();
+}
+
+Status MessageCompressorRegistry::setSupportedCompressors(StringData optionValue) {
+    std::vector<std::string> names;
+    if (optionValue != "disabled") {
+        splitStringDelim(optionValue.toString(), &names, ',');
+    }
+    return setSupportedCompressors(std::move(names));
+}
+
+MessageCompressorBase* MessageCompressorRegistry::getCompressor(StringData name) const {
+    if (std::find(_compressorNames.begin(), _compressorNames.end(), name) ==
+        _compressorNames.end()) {
+        return nullptr;
+    }
+    return _findRegistered(name);
+}
+
+MessageCompressorBase* MessageCompressorRegistry::getCompressor(MessageCompressorId id) const {
+    auto compressor = _compressors[id].get();
+    if (!compressor ||
+        std::find(_compressorNames.begin(), _compressorNames.end(), compressor->getName()) ==
+            _compressorNames.end()) {
+        return nullptr;
+    }
+    return compressor;
+}
+
+void MessageCompressorRegistry::appendStats(BSONObjBuilder* b) const {
+    for (const auto& name : _compressorNames) {
+        _findRegistered(name)->appendStats(b);
+    }
+}
+
+MessageCompressorBase* MessageCompressorRegistry::_findRegistered(StringData name) const {
+    for (const auto& compressor : _compressors) {
+        if (compressor && compressor->getName() == name) {
+            return compressor.get();
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace mongo
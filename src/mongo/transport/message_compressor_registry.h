@@ -0,0 +1,111 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+#include "mongo/transport/message_compressor_base.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * The process-wide collection of message compressors, and the list of those enabled for use on
+ * the wire. The snappy and zlib compressors are always registered; whether they are offered to
+ * peers is controlled by the net.compression.compressors option.
+ *
+ * All registration and configuration must happen during startup, before any connections are
+ * established. After that the registry is read-only and can be used without synchronization.
+ */
+class MessageCompressorRegistry {
+    MONGO_DISALLOW_COPYING(MessageCompressorRegistry);
+
+public:
+    MessageCompressorRegistry();
+
+    /**
+     * Returns the process-wide registry.
+     */
+    static MessageCompressorRegistry& get();
+
+    /**
+     * Adds "compressor" to the registry. It is an error to register two compressors with the same
+     * name or id.
+     */
+    void registerImplementation(std::unique_ptr<MessageCompressorBase> compressor);
+
+    /**
+     * Sets the names of the compressors offered to peers, in order of preference. Every name must
+     * refer to a registered compressor. An empty list disables compression.
+     */
+    Status setSupportedCompressors(std::vector<std::string> names);
+
+    /**
+     * Parses the value of the net.compression.compressors option, a comma separated list of
+     * compressor names or "disabled", and passes it to setSupportedCompressors().
+     */
+    Status setSupportedCompressors(StringData optionValue);
+
+    /**
+     * Returns the names of the compressors offered to peers, in order of preference.
+     */
+    const std::vector<std::string>& getCompressorNames() const {
+        return _compressorNames;
+    }
+
+    /**
+     * Returns the compressor with the given name or id if it is both registered and enabled, or
+     * nullptr otherwise.
+     */
+    MessageCompressorBase* getCompressor(StringData name) const;
+    MessageCompressorBase* getCompressor(MessageCompressorId id) const;
+
+    /**
+     * Appends the traffic statistics of every enabled compressor to "b".
+     */
+    void appendStats(BSONObjBuilder* b) const;
+
+private:
+    MessageCompressorBase* _findRegistered(StringData name) const;
+
+    std::array<std::unique_ptr<MessageCompressorBase>,
+               std::numeric_limits<MessageCompressorId>::max() + 1>
+        _compressors;
+    std::vector<std::string> _compressorNames;
+};
+
+}  // namespace mongo
@@ -0,0 +1,84 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/transport/message_compressor_registry.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(MessageCompressorRegistry, DefaultsToSnappy) {
+    MessageCompressorRegistry registry;
+    ASSERT_EQ(registry.getCompressorNames().size(), 1U);
+    ASSERT_EQ(registry.getCompressorNames()[0], "snappy");
+    ASSERT(registry.getCompressor("snappy"));
+    ASSERT(registry.getCompressor(static_cast<MessageCompressorId>(MessageCompressor::kSnappy)));
+
+    // zlib is registered but not enabled.
+    ASSERT_FALSE(registry.getCompressor("zlib"));
+    ASSERT_FALSE(
+        registry.getCompressor(static_cast<MessageCompressorId>(MessageCompressor::kZlib)));
+}
+
+TEST(MessageCompressorRegistry, ParseOption) {
+    MessageCompressorRegistry registry;
+    ASSERT_OK(registry.setSupportedCompressors(StringData("zlib,snappy")));
+    ASSERT_EQ(registry.getCompressorNames().size(), 2U);
+    ASSERT_EQ(registry.getCompressorNames()[0], "zlib");
+    ASSERT(registry.getCompressor("zlib"));
+
+    ASSERT_OK(registry.setSupportedCompressors(StringData("disabled")));
+    ASSERT_TRUE(registry.getCompressorNames().empty());
+    ASSERT_FALSE(registry.getCompressor("snappy"));
+}
+
+TEST(MessageCompressorRegistry, RejectsBadNames) {
+    MessageCompressorRegistry registry;
+    ASSERT_EQ(registry.setSupportedCompressors(StringData("snappy,lzma")), ErrorCodes::BadValue);
+    ASSERT_EQ(registry.setSupportedCompressors(StringData("snappy,snappy")), ErrorCodes::BadValue);
+
+    // Failed updates leave the previous setting in place.
+    ASSERT_EQ(registry.getCompressorNames().size(), 1U);
+    ASSERT_EQ(registry.getCompressorNames()[0], "snappy");
+}
+
+TEST(MessageCompressorRegistry, AppendStats) {
+    MessageCompressorRegistry registry;
+    BSONObjBuilder b;
+    registry.appendStats(&b);
+    BSONObj stats = b.obj();
+    ASSERT_EQ(stats["snappy"]["compressor"]["bytesIn"].numberLong(), 0);
+    ASSERT_FALSE(stats.hasField("zlib"));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/transport/message_compressor_zlib.h"
+
+#include <zlib.h>
+
+namespace mongo {
+
+namespace {
+
+// Network traffic is latency sensitive, so favor speed over compression ratio.
+const int kZlibCompressionLevel = 1;
+
+}  // namespace
+
+ZlibMessageCompressor::ZlibMessageCompressor()
+    : MessageCompressorBase(MessageCompressor::kZlib, "zlib") {}
+
+std::size_t ZlibMessageCompressor::getMaxCompressedSize(size_t inputSize) {
+    // The same bound as compressBound(), which is not part of the vendored zlib.
+    return inputSize + (inputSize >> 12) + (inputSize >> 14) + (inputSize >> 25) + 13;
+}
+
+StatusWith<std::size_t> ZlibMessageCompressor::compressData(ConstDataRange input,
+                                                            DataRange output) {
+    z_stream stream{};
+    if (deflateInit(&stream, kZlibCompressionLevel) != Z_OK) {
+        return {ErrorCodes::InternalError, "Could not initialize zlib compression"};
+    }
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = input.length();
+    stream.next_out = reinterpret_cast<Bytef*>(const_cast<char*>(output.data()));
+    stream.avail_out = output.length();
+
+    int ret = deflate(&stream, Z_FINISH);
+    const size_t length = stream.total_out;
+    deflateEnd(&stream);
+
+    if (ret != Z_STREAM_END) {
+        return {ErrorCodes::BadValue, "Could not compress input"};
+    }
+
+    counterHitCompress(input.length(), length);
+    return length;
+}
+
+StatusWith<std::size_t> ZlibMessageCompressor::decompressData(ConstDataRange input,
+                                                              DataRange output) {
+    z_stream stream{};
+    if (inflateInit(&stream) != Z_OK) {
+        return {ErrorCodes::InternalError, "Could not initialize zlib decompression"};
+    }
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    stream.avail_in = input.length();
+    stream.next_out = reinterpret_cast<Bytef*>(const_cast<char*>(output.data()));
+    stream.avail_out = output.length();
+
+    int ret = inflate(&stream, Z_FINISH);
+    const size_t length = stream.total_out;
+    inflateEnd(&stream);
+
+    if (ret != Z_STREAM_END || length != output.length()) {
+        return {ErrorCodes::BadValue, "Compressed message was invalid or corrupted"};
+    }
+
+    counterHitDecompress(input.length(), length);
+    return length;
+}
+
+}  // namespace mongo
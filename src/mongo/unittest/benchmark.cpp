@@ -0,0 +1,204 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/unittest/benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <vector>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace benchmark {
+
+namespace {
+
+struct RegisteredBenchmark {
+    std::string name;
+    BenchmarkFunction function;
+};
+
+std::vector<RegisteredBenchmark>& registeredBenchmarks() {
+    static std::vector<RegisteredBenchmark> benchmarks;
+    return benchmarks;
+}
+
+// Bounds the calibration of benchmarks which do not call keepRunning().
+const std::uint64_t kMaxIterations = 1ULL << 32;
+
+Nanoseconds runSample(const BenchmarkFunction& function, std::uint64_t iterations) {
+    BenchmarkState state(iterations);
+    function(state);
+    return state.elapsed();
+}
+
+/**
+ * Returns the number of iterations for which one sample of 'function' lasts at least
+ * 'minSampleTime'.
+ */
+std::uint64_t calibrate(const BenchmarkFunction& function, Milliseconds minSampleTime) {
+    const auto target = duration_cast<Nanoseconds>(minSampleTime);
+    std::uint64_t iterations = 1;
+    while (iterations < kMaxIterations) {
+        const auto elapsed = runSample(function, iterations);
+        if (elapsed >= target) {
+            break;
+        }
+
+        // Aim a little past the target, but grow by at most 10x per step so that a noisy short
+        // sample does not blow up the estimate.
+        std::uint64_t factor = 10;
+        if (elapsed > Nanoseconds(0)) {
+            factor = std::min<std::uint64_t>(
+                factor, 1 + (target.count() * 12 / 10) / durationCount<Nanoseconds>(elapsed));
+        }
+        iterations *= std::max<std::uint64_t>(factor, 2);
+    }
+    return std::min(iterations, kMaxIterations);
+}
+
+struct BenchmarkResult {
+    std::string name;
+    std::uint64_t iterations;
+    double minNanos;
+    double medianNanos;
+    double meanNanos;
+    double maxNanos;
+    double stddevNanos;
+
+    BSONObj toBSON() const {
+        BSONObjBuilder builder;
+        builder.append("name", name);
+        builder.append("iterations", static_cast<long long>(iterations));
+        BSONObjBuilder nanos(builder.subobjStart("nanosPerIteration"));
+        nanos.append("min", minNanos);
+        nanos.append("median", medianNanos);
+        nanos.append("mean", meanNanos);
+        nanos.append("max", maxNanos);
+        nanos.append("stddev", stddevNanos);
+        nanos.doneFast();
+        return builder.obj();
+    }
+};
+
+BenchmarkResult runBenchmark(const RegisteredBenchmark& benchmark,
+                             const BenchmarkOptions& options) {
+    const auto iterations = calibrate(benchmark.function, options.minSampleTime);
+
+    // Warmup
+    runSample(benchmark.function, iterations);
+
+    std::vector<double> nanosPerIteration;
+    for (int i = 0; i < options.samples; ++i) {
+        const auto elapsed = runSample(benchmark.function, iterations);
+        nanosPerIteration.push_back(static_cast<double>(durationCount<Nanoseconds>(elapsed)) /
+                                    iterations);
+    }
+    std::sort(nanosPerIteration.begin(), nanosPerIteration.end());
+
+    double sum = 0;
+    for (auto value : nanosPerIteration) {
+        sum += value;
+    }
+    const double mean = sum / nanosPerIteration.size();
+
+    double squaredDeviations = 0;
+    for (auto value : nanosPerIteration) {
+        squaredDeviations += (value - mean) * (value - mean);
+    }
+
+    const size_t middle = nanosPerIteration.size() / 2;
+    const double median = nanosPerIteration.size() % 2
+        ? nanosPerIteration[middle]
+        : (nanosPerIteration[middle - 1] + nanosPerIteration[middle]) / 2;
+
+    return {benchmark.name,
+            iterations,
+            nanosPerIteration.front(),
+            median,
+            mean,
+            nanosPerIteration.back(),
+            std::sqrt(squaredDeviations / nanosPerIteration.size())};
+}
+
+}  // namespace
+
+BenchmarkRegistration::BenchmarkRegistration(std::string name, BenchmarkFunction function) {
+    registeredBenchmarks().push_back({std::move(name), std::move(function)});
+}
+
+int runBenchmarks(const BenchmarkOptions& options) {
+    if (options.samples < 1) {
+        severe() << "The number of samples must be at least 1";
+        return EXIT_FAILURE;
+    }
+
+    std::vector<RegisteredBenchmark> selected;
+    for (const auto& benchmark : registeredBenchmarks()) {
+        if (benchmark.name.find(options.filter) != std::string::npos) {
+            selected.push_back(benchmark);
+        }
+    }
+    std::sort(selected.begin(),
+              selected.end(),
+              [](const RegisteredBenchmark& lhs, const RegisteredBenchmark& rhs) {
+                  return lhs.name < rhs.name;
+              });
+
+    BSONArrayBuilder resultsBuilder;
+    for (const auto& benchmark : selected) {
+        const auto result = runBenchmark(benchmark, options);
+        log() << result.name << ": " << result.medianNanos << " ns/iteration (median of "
+              << options.samples << " samples of " << result.iterations
+              << " iterations; min: " << result.minNanos << ", mean: " << result.meanNanos
+              << ", max: " << result.maxNanos << ", stddev: " << result.stddevNanos << ")";
+        resultsBuilder.append(result.toBSON());
+    }
+
+    if (!options.jsonOutputFile.empty()) {
+        std::ofstream out(options.jsonOutputFile.c_str());
+        out << BSON("benchmarks" << resultsBuilder.arr()).jsonString(Strict, 1) << std::endl;
+        if (!out) {
+            severe() << "Failed to write the benchmark results to " << options.jsonOutputFile;
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+}  // namespace benchmark
+}  // namespace mongo
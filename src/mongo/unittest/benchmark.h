@@ -0,0 +1,166 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * A small harness for microbenchmarks of hot code paths.
+ *
+ * A benchmark is a function which runs the code under measurement in a loop controlled by a
+ * BenchmarkState:
+ *
+ *     MONGO_BENCHMARK(BSONObjBuilderSmallObject) {
+ *         while (state.keepRunning()) {
+ *             BSONObjBuilder builder;
+ *             builder.append("a", 1);
+ *             benchmark::doNotOptimizeAway(builder.obj());
+ *         }
+ *     }
+ *
+ * The harness first calibrates the number of iterations so that a sample takes at least
+ * --minSampleTimeMillis, which also warms up caches and allocators, then discards one warmup
+ * sample and times --samples more. It reports the minimum, median, mean, maximum and standard
+ * deviation of the time per iteration, and optionally writes them as JSON to --jsonOutput so that
+ * runs can be compared.
+ *
+ * Benchmarks are built with env.Benchmark() in SConscript files and are part of the "benchmarks"
+ * alias.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/stdx/chrono.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace benchmark {
+
+/**
+ * Controls the iterations of one timed sample of a benchmark.
+ */
+class BenchmarkState {
+    MONGO_DISALLOW_COPYING(BenchmarkState);
+
+public:
+    explicit BenchmarkState(std::uint64_t iterations) : _iterations(iterations) {}
+
+    /**
+     * Returns true 'iterations()' times, then false. The time between the first call and the
+     * last, less the time spent paused, is the duration of the sample.
+     */
+    bool keepRunning() {
+        if (_remaining == _iterations) {
+            _start = Clock::now();
+        }
+        if (_remaining-- == 0) {
+            _elapsed += Clock::now() - _start;
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * Excludes the time until the next call to resumeTiming() from the sample, e.g. to set up
+     * state which must be rebuilt during the loop.
+     */
+    void pauseTiming() {
+        _elapsed += Clock::now() - _start;
+    }
+
+    void resumeTiming() {
+        _start = Clock::now();
+    }
+
+    std::uint64_t iterations() const {
+        return _iterations;
+    }
+
+    Nanoseconds elapsed() const {
+        return duration_cast<Nanoseconds>(_elapsed);
+    }
+
+private:
+    using Clock = stdx::chrono::steady_clock;
+
+    const std::uint64_t _iterations;
+    std::uint64_t _remaining{_iterations};
+    Clock::time_point _start;
+    Clock::duration _elapsed{Clock::duration::zero()};
+};
+
+using BenchmarkFunction = stdx::function<void(BenchmarkState&)>;
+
+/**
+ * Registers a benchmark at static initialization time. Use MONGO_BENCHMARK() instead.
+ */
+class BenchmarkRegistration {
+public:
+    BenchmarkRegistration(std::string name, BenchmarkFunction function);
+};
+
+struct BenchmarkOptions {
+    // Only the benchmarks whose name contains 'filter' are run.
+    std::string filter;
+
+    int samples = 10;
+
+    Milliseconds minSampleTime{100};
+
+    // If not empty, the results are also written to this file as JSON.
+    std::string jsonOutputFile;
+};
+
+/**
+ * Runs the registered benchmarks selected by 'options' and logs their results. Returns the exit
+ * code of the benchmark program.
+ */
+int runBenchmarks(const BenchmarkOptions& options);
+
+/**
+ * Prevents the compiler from discarding the computation of 'value' as unused.
+ */
+template <typename T>
+inline void doNotOptimizeAway(const T& value) {
+#if defined(__GNUC__)
+    asm volatile("" : : "g"(&value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+#endif
+}
+
+}  // namespace benchmark
+}  // namespace mongo
+
+#define MONGO_BENCHMARK(NAME)                                                         \
+    void NAME(::mongo::benchmark::BenchmarkState& state);                             \
+    const ::mongo::benchmark::BenchmarkRegistration NAME##_registration(#NAME, NAME); \
+    void NAME(::mongo::benchmark::BenchmarkState& state)
@@ -0,0 +1,109 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <iostream>
+
+#include "mongo/base/initializer.h"
+#include "mongo/unittest/benchmark.h"
+#include "mongo/util/options_parser/environment.h"
+#include "mongo/util/options_parser/option_section.h"
+#include "mongo/util/options_parser/options_parser.h"
+#include "mongo/util/options_parser/startup_option_init.h"
+#include "mongo/util/options_parser/startup_options.h"
+#include "mongo/util/quick_exit.h"
+#include "mongo/util/signal_handlers_synchronous.h"
+
+using namespace mongo;
+
+namespace {
+
+benchmark::BenchmarkOptions benchmarkOptions;
+
+}  // namespace
+
+int main(int argc, char** argv, char** envp) {
+    setupSynchronousSignalHandlers();
+    runGlobalInitializersOrDie(argc, argv, envp);
+
+    return benchmark::runBenchmarks(benchmarkOptions);
+}
+
+namespace moe = mongo::optionenvironment;
+
+MONGO_GENERAL_STARTUP_OPTIONS_REGISTER(BenchmarkOptions)(InitializerContext*) {
+    auto& opts = moe::startupOptions;
+    opts.addOptionChaining("help", "help", moe::Switch, "Display help");
+    opts.addOptionChaining("filter",
+                           "filter",
+                           moe::String,
+                           "Only run the benchmarks whose name contains this")
+        .setDefault(moe::Value(std::string()));
+    opts.addOptionChaining("samples", "samples", moe::Int, "Number of timed samples per benchmark")
+        .setDefault(moe::Value(10));
+    opts.addOptionChaining("minSampleTimeMillis",
+                           "minSampleTimeMillis",
+                           moe::Int,
+                           "Minimum duration of a sample, used to choose the number of iterations")
+        .setDefault(moe::Value(100));
+    opts.addOptionChaining(
+        "jsonOutput", "jsonOutput", moe::String, "File to write the results to as JSON");
+    return Status::OK();
+}
+
+MONGO_STARTUP_OPTIONS_VALIDATE(BenchmarkOptions)(InitializerContext*) {
+    auto& env = moe::startupOptionsParsed;
+    auto& opts = moe::startupOptions;
+
+    auto ret = env.validate();
+
+    if (!ret.isOK()) {
+        return ret;
+    }
+
+    if (env.count("help")) {
+        std::cout << opts.helpString() << std::endl;
+        quickExit(EXIT_SUCCESS);
+    }
+
+    return Status::OK();
+}
+
+MONGO_STARTUP_OPTIONS_STORE(BenchmarkOptions)(InitializerContext*) {
+    auto& env = moe::startupOptionsParsed;
+
+    benchmarkOptions.filter = env["filter"].as<std::string>();
+    benchmarkOptions.samples = env["samples"].as<int>();
+    benchmarkOptions.minSampleTime = Milliseconds(env["minSampleTimeMillis"].as<int>());
+    if (env.count("jsonOutput")) {
+        benchmarkOptions.jsonOutputFile = env["jsonOutput"].as<std::string>();
+    }
+
+    return Status::OK();
+}
@@ -0,0 +1,167 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+#include "mongo/util/log.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace {
+
+const size_t kNumWorkers = 8;
+const size_t kNumProducers = 8;
+const int kTasksPerProducer = 50000;
+const int kFanOutDepth = 16;
+
+std::unique_ptr<ThreadPoolInterface> makeThreadPool() {
+    ThreadPool::Options options;
+    options.minThreads = kNumWorkers;
+    options.maxThreads = kNumWorkers;
+    return stdx::make_unique<ThreadPool>(options);
+}
+
+std::unique_ptr<ThreadPoolInterface> makeWorkStealingThreadPool() {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = kNumWorkers;
+    return stdx::make_unique<WorkStealingThreadPool>(options);
+}
+
+/**
+ * Waits until 'count' tasks have called done().
+ */
+class Latch {
+public:
+    explicit Latch(int count) : _count(count) {}
+
+    void done() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (--_count == 0) {
+            _cv.notify_all();
+        }
+    }
+
+    void wait() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _cv.wait(lk, [this] { return _count == 0; });
+    }
+
+private:
+    stdx::mutex _mutex;
+    stdx::condition_variable _cv;
+    int _count;
+};
+
+/**
+ * Returns the number of tasks per second run by 'pool' when 'kNumProducers' threads outside of
+ * the pool each schedule 'kTasksPerProducer' tasks, as the executor's network threads do.
+ */
+long long timeExternalProducers(ThreadPoolInterface* pool) {
+    pool->startup();
+    Latch latch(kNumProducers * kTasksPerProducer);
+    AtomicInt64 sum;
+
+    Timer timer;
+    std::vector<stdx::thread> producers;
+    for (size_t i = 0; i < kNumProducers; ++i) {
+        producers.emplace_back([&] {
+            for (int j = 0; j < kTasksPerProducer; ++j) {
+                ASSERT_OK(pool->schedule([&, j] {
+                    sum.fetchAndAdd(j);
+                    latch.done();
+                }));
+            }
+        });
+    }
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    latch.wait();
+    const auto micros = std::max(timer.micros(), 1LL);
+
+    pool->shutdown();
+    pool->join();
+    return static_cast<long long>(kNumProducers) * kTasksPerProducer * 1000 * 1000 / micros;
+}
+
+/**
+ * Returns the number of tasks per second run by 'pool' for a binary tree of tasks of depth
+ * 'kFanOutDepth' in which each task schedules its children itself.
+ */
+long long timeFanOut(ThreadPoolInterface* pool) {
+    pool->startup();
+    const int numTasks = (1 << kFanOutDepth) - 1;
+    Latch latch(numTasks);
+
+    stdx::function<void(int)> runNode = [&](int depth) {
+        if (depth + 1 < kFanOutDepth) {
+            ASSERT_OK(pool->schedule([&, depth] { runNode(depth + 1); }));
+            ASSERT_OK(pool->schedule([&, depth] { runNode(depth + 1); }));
+        }
+        latch.done();
+    };
+
+    Timer timer;
+    ASSERT_OK(pool->schedule([&] { runNode(0); }));
+    latch.wait();
+    const auto micros = std::max(timer.micros(), 1LL);
+
+    pool->shutdown();
+    pool->join();
+    return static_cast<long long>(numTasks) * 1000 * 1000 / micros;
+}
+
+TEST(ThreadPoolPerf, ExternalProducers) {
+    log() << "THROUGHPUT ThreadPool external producers tasks/s: "
+          << timeExternalProducers(makeThreadPool().get());
+    log() << "THROUGHPUT WorkStealingThreadPool external producers tasks/s: "
+          << timeExternalProducers(makeWorkStealingThreadPool().get());
+}
+
+TEST(ThreadPoolPerf, FanOut) {
+    log() << "THROUGHPUT ThreadPool fan out tasks/s: " << timeFanOut(makeThreadPool().get());
+    log() << "THROUGHPUT WorkStealingThreadPool fan out tasks/s: "
+          << timeFanOut(makeWorkStealingThreadPool().get());
+}
+
+}  // namespace
+}  // namespace mongo
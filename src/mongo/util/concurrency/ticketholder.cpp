@@ -25,178 +25,128 @@
  *    then also delete it in the license file.
  */
 
-#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
-
 #include "mongo/platform/basic.h"
 
 #include "mongo/util/concurrency/ticketholder.h"
 
-#include <iostream>
+#include <algorithm>
 
-#include "mongo/util/log.h"
+#include "mongo/util/assert_util.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
-#if defined(__linux__)
-namespace {
-void _check(int ret) {
-    if (ret == 0)
-        return;
-    int err = errno;
-    severe() << "error in Ticketholder: " << errnoWithDescription(err);
-    fassertFailed(28604);
-}
-}
+TicketHolder::TicketHolder(int num) : _available(num), _outof(num) {}
 
-TicketHolder::TicketHolder(int num) : _outof(num) {
-    _check(sem_init(&_sem, 0, num));
-}
+const int TicketHolder::kTicketsPerLowPriorityTicket;
 
 TicketHolder::~TicketHolder() {
-    _check(sem_destroy(&_sem));
-}
-
-bool TicketHolder::tryAcquire() {
-    while (0 != sem_trywait(&_sem)) {
-        switch (errno) {
-            case EAGAIN:
-                return false;
-            case EINTR:
-                break;
-            default:
-                _check(-1);
-        }
-    }
-    return true;
+    invariant(_waiters.empty());
+    invariant(_lowPriorityWaiters.empty());
 }
 
-void TicketHolder::waitForTicket() {
-    while (0 != sem_wait(&_sem)) {
-        switch (errno) {
-            case EINTR:
-                break;
-            default:
-                _check(-1);
+bool TicketHolder::_tryAcquireAvailable() {
+    int available = _available.load();
+    while (available > 0) {
+        const int previous = _available.compareAndSwap(available, available - 1);
+        if (previous == available) {
+            _numAcquired.fetchAndAdd(1);
+            return true;
         }
+        available = previous;
     }
+    return false;
 }
 
-void TicketHolder::release() {
-    _check(sem_post(&_sem));
+bool TicketHolder::tryAcquire() {
+    // Waiting threads are served first.
+    return _waiting.load() == 0 && _tryAcquireAvailable();
 }
 
-Status TicketHolder::resize(int newSize) {
-    stdx::lock_guard<stdx::mutex> lk(_resizeMutex);
-
-    if (newSize < 5)
-        return Status(ErrorCodes::BadValue,
-                      str::stream() << "Minimum value for semaphore is 5; given " << newSize);
-
-    if (newSize > SEM_VALUE_MAX)
-        return Status(ErrorCodes::BadValue,
-                      str::stream() << "Maximum value for semaphore is " << SEM_VALUE_MAX
-                                    << "; given "
-                                    << newSize);
-
-    while (_outof.load() < newSize) {
-        release();
-        _outof.fetchAndAdd(1);
-    }
-
-    while (_outof.load() > newSize) {
-        waitForTicket();
-        _outof.subtractAndFetch(1);
+void TicketHolder::waitForTicket(Priority priority) {
+    if (tryAcquire()) {
+        return;
     }
 
-    invariant(_outof.load() == newSize);
-    return Status::OK();
-}
-
-int TicketHolder::available() const {
-    int val = 0;
-    _check(sem_getvalue(&_sem, &val));
-    return val;
-}
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _waiting.fetchAndAdd(1);
+    ON_BLOCK_EXIT([this] { _waiting.subtractAndFetch(1); });
 
-int TicketHolder::used() const {
-    return outof() - available();
-}
+    // A ticket released before '_waiting' was incremented has not been handed out.
+    if (_waiters.empty() && _lowPriorityWaiters.empty() && _tryAcquireAvailable()) {
+        return;
+    }
 
-int TicketHolder::outof() const {
-    return _outof.load();
+    Waiter waiter;
+    (priority == Priority::kLow ? _lowPriorityWaiters : _waiters).push_back(&waiter);
+    waiter.granted.wait(lk, [&waiter] { return waiter.hasTicket; });
 }
 
-#else
-
-TicketHolder::TicketHolder(int num) : _outof(num), _num(num) {}
+void TicketHolder::release() {
+    _available.addAndFetch(1);
 
-TicketHolder::~TicketHolder() = default;
+    // A thread which starts waiting after this check finds the ticket released above.
+    if (_waiting.load() == 0) {
+        return;
+    }
 
-bool TicketHolder::tryAcquire() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
-    return _tryAcquire();
+    _handOutTickets_inlock();
 }
 
-void TicketHolder::waitForTicket() {
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-
-    while (!_tryAcquire()) {
-        _newTicket.wait(lk);
+void TicketHolder::_handOutTickets_inlock() {
+    while ((!_waiters.empty() || !_lowPriorityWaiters.empty()) && _tryAcquireAvailable()) {
+        Waiter* waiter = _popNextWaiter_inlock();
+        waiter->hasTicket = true;
+        waiter->granted.notify_one();
     }
 }
 
-void TicketHolder::release() {
-    {
-        stdx::lock_guard<stdx::mutex> lk(_mutex);
-        _num++;
-    }
-    _newTicket.notify_one();
+TicketHolder::Waiter* TicketHolder::_popNextWaiter_inlock() {
+    const bool lowPriorityTurn = !_lowPriorityWaiters.empty() &&
+        (_waiters.empty() || _ticketsSinceLowPriorityTicket + 1 >= kTicketsPerLowPriorityTicket);
+
+    std::deque<Waiter*>& waiters = lowPriorityTurn ? _lowPriorityWaiters : _waiters;
+    Waiter* waiter = waiters.front();
+    waiters.pop_front();
+    _ticketsSinceLowPriorityTicket = lowPriorityTurn ? 0 : _ticketsSinceLowPriorityTicket + 1;
+    return waiter;
 }
 
 Status TicketHolder::resize(int newSize) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
-    int used = _outof.load() - _num;
-    if (used > newSize) {
-        std::stringstream ss;
-        ss << "can't resize since we're using (" << used << ") "
-           << "more than newSize(" << newSize << ")";
-
-        std::string errmsg = ss.str();
-        log() << errmsg;
-        return Status(ErrorCodes::BadValue, errmsg);
+    if (newSize < 1) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "Minimum value for the number of tickets is 1; given "
+                                    << newSize);
     }
 
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    const int delta = newSize - _outof.load();
     _outof.store(newSize);
-    _num = _outof.load() - used;
-
-    // Potentially wasteful, but easier to see is correct
-    _newTicket.notify_all();
+    _available.addAndFetch(delta);
+    _handOutTickets_inlock();
     return Status::OK();
 }
 
 int TicketHolder::available() const {
-    return _num;
+    return std::max(0, _available.load());
 }
 
 int TicketHolder::used() const {
-    return outof() - _num;
+    return outof() - _available.load();
 }
 
 int TicketHolder::outof() const {
     return _outof.load();
 }
 
-bool TicketHolder::_tryAcquire() {
-    if (_num <= 0) {
-        if (_num < 0) {
-            std::cerr << "DISASTER! in TicketHolder" << std::endl;
-        }
-        return false;
-    }
-    _num--;
-    return true;
+int TicketHolder::waiting() const {
+    return _waiting.load();
 }
-#endif
+
+long long TicketHolder::numAcquired() const {
+    return _numAcquired.load();
 }
+
+}  // namespace mongo
@@ -26,30 +26,49 @@
  */
 #pragma once
 
-#if defined(__linux__)
-#include <semaphore.h>
-#endif
+#include <deque>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
-#include "mongo/util/concurrency/mutex.h"
 
 namespace mongo {
 
+/**
+ * A counting semaphore which hands out its tickets in the order they were waited for, serving
+ * normal priority waiters before low priority ones. Acquiring or releasing a ticket only takes a
+ * mutex while some thread is waiting.
+ */
 class TicketHolder {
     MONGO_DISALLOW_COPYING(TicketHolder);
 
 public:
+    enum class Priority { kNormal, kLow };
+
+    /**
+     * While threads of both priorities are waiting, every this many tickets one goes to a low
+     * priority waiter, so that low priority work slows down under load without starving.
+     */
+    static const int kTicketsPerLowPriorityTicket = 8;
+
     explicit TicketHolder(int num);
     ~TicketHolder();
 
+    /**
+     * Takes a ticket if one is available and no other thread is waiting for one.
+     */
     bool tryAcquire();
 
-    void waitForTicket();
+    void waitForTicket(Priority priority = Priority::kNormal);
 
     void release();
 
+    /**
+     * Changes the number of tickets to 'newSize' without waiting. If more than 'newSize' tickets
+     * are in use, no more are handed out until enough of them are released.
+     */
     Status resize(int newSize);
 
     int available() const;
@@ -58,21 +77,44 @@ public:
 
     int outof() const;
 
+    /**
+     * Number of threads currently blocked in waitForTicket().
+     */
+    int waiting() const;
+
+    /**
+     * Number of tickets handed out since this TicketHolder was created.
+     */
+    long long numAcquired() const;
+
 private:
-#if defined(__linux__)
-    mutable sem_t _sem;
+    struct Waiter {
+        stdx::condition_variable granted;
+        bool hasTicket = false;
+    };
 
-    // You can read _outof without a lock, but have to hold _resizeMutex to change.
-    AtomicInt32 _outof;
-    stdx::mutex _resizeMutex;
-#else
-    bool _tryAcquire();
+    // Takes a ticket from '_available' if it is positive.
+    bool _tryAcquireAvailable();
+
+    // Hands available tickets to the longest waiting threads, by priority.
+    void _handOutTickets_inlock();
+
+    // Removes and returns the waiter the next ticket goes to.
+    Waiter* _popNextWaiter_inlock();
 
+    // Tickets which are neither in use nor owed, or minus the number of tickets in use beyond
+    // '_outof' after shrinking.
+    AtomicInt32 _available;
     AtomicInt32 _outof;
-    int _num;
+    AtomicInt32 _waiting;
+    AtomicInt64 _numAcquired;
+
     stdx::mutex _mutex;
-    stdx::condition_variable _newTicket;
-#endif
+
+    // Guarded by _mutex.
+    std::deque<Waiter*> _waiters;
+    std::deque<Waiter*> _lowPriorityWaiters;
+    int _ticketsSinceLowPriorityTicket = 0;
 };
 
 class ScopedTicket {
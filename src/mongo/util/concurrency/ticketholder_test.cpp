@@ -0,0 +1,171 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace {
+
+void waitForWaiters(const TicketHolder& holder, int numWaiters) {
+    while (holder.waiting() < numWaiters) {
+        sleepmillis(1);
+    }
+}
+
+TEST(TicketHolderTest, AcquireAndRelease) {
+    TicketHolder holder(2);
+    ASSERT_TRUE(holder.tryAcquire());
+    ASSERT_TRUE(holder.tryAcquire());
+    ASSERT_FALSE(holder.tryAcquire());
+    ASSERT_EQUALS(2, holder.used());
+    ASSERT_EQUALS(0, holder.available());
+
+    holder.release();
+    ASSERT_EQUALS(1, holder.used());
+    ASSERT_EQUALS(1, holder.available());
+    ASSERT_EQUALS(2, holder.outof());
+    ASSERT_EQUALS(2, holder.numAcquired());
+}
+
+TEST(TicketHolderTest, ShrinkingDoesNotWaitForTicketsInUse) {
+    TicketHolder holder(3);
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TRUE(holder.tryAcquire());
+    }
+
+    ASSERT_OK(holder.resize(1));
+    ASSERT_EQUALS(1, holder.outof());
+    ASSERT_EQUALS(3, holder.used());
+    ASSERT_EQUALS(0, holder.available());
+
+    // The tickets beyond the new size are not handed out again when released.
+    holder.release();
+    holder.release();
+    ASSERT_FALSE(holder.tryAcquire());
+    holder.release();
+    ASSERT_TRUE(holder.tryAcquire());
+}
+
+TEST(TicketHolderTest, ResizeRejectsFewerThanOneTicket) {
+    TicketHolder holder(3);
+    ASSERT_EQUALS(ErrorCodes::BadValue, holder.resize(0));
+    ASSERT_EQUALS(3, holder.outof());
+}
+
+TEST(TicketHolderTest, WaitersAreServedInOrder) {
+    TicketHolder holder(1);
+    ASSERT_TRUE(holder.tryAcquire());
+
+    stdx::mutex mutex;
+    std::vector<int> order;
+    auto waitAndRecord = [&](int id) {
+        holder.waitForTicket();
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            order.push_back(id);
+        }
+        holder.release();
+    };
+
+    stdx::thread first(waitAndRecord, 1);
+    waitForWaiters(holder, 1);
+    stdx::thread second(waitAndRecord, 2);
+    waitForWaiters(holder, 2);
+
+    // Threads which just arrived don't take tickets ahead of the waiting ones.
+    ASSERT_FALSE(holder.tryAcquire());
+
+    holder.release();
+    first.join();
+    second.join();
+    ASSERT_EQUALS(2U, order.size());
+    ASSERT_EQUALS(1, order[0]);
+    ASSERT_EQUALS(2, order[1]);
+    ASSERT_EQUALS(0, holder.used());
+}
+
+TEST(TicketHolderTest, LowPriorityWaitersAreServedEveryFewTickets) {
+    TicketHolder holder(1);
+    ASSERT_TRUE(holder.tryAcquire());
+
+    stdx::mutex mutex;
+    std::vector<int> order;
+    auto waitAndRecord = [&](int id, TicketHolder::Priority priority) {
+        holder.waitForTicket(priority);
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            order.push_back(id);
+        }
+        holder.release();
+    };
+
+    // The low priority waiter arrives first, and is served after the normal priority waiters
+    // which get the tickets in between.
+    std::vector<stdx::thread> threads;
+    threads.emplace_back(waitAndRecord, 0, TicketHolder::Priority::kLow);
+    waitForWaiters(holder, 1);
+    const int numNormal = TicketHolder::kTicketsPerLowPriorityTicket;
+    for (int i = 1; i <= numNormal; i++) {
+        threads.emplace_back(waitAndRecord, i, TicketHolder::Priority::kNormal);
+        waitForWaiters(holder, i + 1);
+    }
+
+    holder.release();
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+    ASSERT_EQUALS(static_cast<size_t>(numNormal + 1), order.size());
+    for (int i = 0; i < numNormal - 1; i++) {
+        ASSERT_EQUALS(i + 1, order[i]);
+    }
+    ASSERT_EQUALS(0, order[numNormal - 1]);
+    ASSERT_EQUALS(numNormal, order[numNormal]);
+}
+
+TEST(TicketHolderTest, GrowingHandsTicketsToWaiters) {
+    TicketHolder holder(1);
+    ASSERT_TRUE(holder.tryAcquire());
+
+    stdx::thread waiter([&holder] { holder.waitForTicket(); });
+    waitForWaiters(holder, 1);
+
+    ASSERT_OK(holder.resize(2));
+    waiter.join();
+    ASSERT_EQUALS(2, holder.used());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,307 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+#include "mongo/base/status.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/concurrency/threadlocal.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+
+// Counter used to assign unique names to otherwise-unnamed thread pools.
+AtomicInt32 nextUnnamedWorkStealingThreadPoolId{1};
+
+// The pool whose worker is running on this thread, if any, and the index of that worker.
+MONGO_TRIVIALLY_CONSTRUCTIBLE_THREAD_LOCAL const void* currentPool;
+MONGO_TRIVIALLY_CONSTRUCTIBLE_THREAD_LOCAL size_t currentWorkerIndex;
+
+/**
+ * Sets defaults and checks bounds limits on "options", and returns it.
+ */
+WorkStealingThreadPool::Options cleanUpOptions(WorkStealingThreadPool::Options&& options) {
+    if (options.poolName.empty()) {
+        options.poolName = str::stream() << "WorkStealingThreadPool"
+                                         << nextUnnamedWorkStealingThreadPoolId.fetchAndAdd(1);
+    }
+    if (options.threadNamePrefix.empty()) {
+        options.threadNamePrefix = str::stream() << options.poolName << '-';
+    }
+    if (options.numThreads < 1) {
+        severe() << "Tried to create pool " << options.poolName << " with "
+                 << options.numThreads << " threads but it must have at least 1";
+        fassertFailed(40206);
+    }
+    return options;
+}
+
+}  // namespace
+
+WorkStealingThreadPool::WorkStealingThreadPool(Options options)
+    : _options(cleanUpOptions(std::move(options))) {
+    for (size_t i = 0; i < _options.numThreads; ++i) {
+        _workers.emplace_back(stdx::make_unique<Worker>());
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _shutdown_inlock();
+    if (shutdownComplete != _state) {
+        _join_inlock(&lk);
+    }
+
+    if (shutdownComplete != _state) {
+        severe() << "Failed to shutdown pool during destruction";
+        fassertFailed(40207);
+    }
+    invariant(!_hasPendingTasks());
+}
+
+void WorkStealingThreadPool::startup() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_state != preStart) {
+        severe() << "Attempting to start pool " << _options.poolName
+                 << ", but it has already started";
+        fassertFailed(40208);
+    }
+    _setState_inlock(running);
+    for (size_t i = 0; i < _workers.size(); ++i) {
+        const std::string threadName = str::stream() << _options.threadNamePrefix << i;
+        try {
+            _workers[i]->thread = stdx::thread(
+                stdx::bind(&WorkStealingThreadPool::_workerThreadBody, this, i, threadName));
+        } catch (const std::exception& ex) {
+            // The tasks queued for this worker are left for the other workers to steal.
+            error() << "Failed to start " << threadName << " in pool " << _options.poolName
+                    << "; caught exception: " << ex.what();
+        }
+    }
+}
+
+void WorkStealingThreadPool::shutdown() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _shutdown_inlock();
+}
+
+void WorkStealingThreadPool::_shutdown_inlock() {
+    switch (_state) {
+        case preStart:
+        case running:
+            _inShutdown.store(true);
+            _setState_inlock(joinRequired);
+            _workAvailable.notify_all();
+            return;
+        case joinRequired:
+        case joining:
+        case shutdownComplete:
+            return;
+    }
+    MONGO_UNREACHABLE;
+}
+
+void WorkStealingThreadPool::join() {
+    try {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _join_inlock(&lk);
+    } catch (...) {
+        std::terminate();
+    }
+}
+
+void WorkStealingThreadPool::_join_inlock(stdx::unique_lock<stdx::mutex>* lk) {
+    _stateChange.wait(*lk, [this] {
+        switch (_state) {
+            case preStart:
+                return false;
+            case running:
+                return false;
+            case joinRequired:
+                return true;
+            case joining:
+            case shutdownComplete:
+                severe() << "Attempted to join pool " << _options.poolName << " more than once";
+                fassertFailed(40209);
+        }
+        MONGO_UNREACHABLE;
+    });
+    _setState_inlock(joining);
+    lk->unlock();
+
+    // No task can be scheduled anymore, so once every queue has been found empty the workers only
+    // have the tasks they are already running left to finish.
+    Task task;
+    while (_stealTask(_workers.size(), &task)) {
+        _runTask(task);
+    }
+    for (auto& worker : _workers) {
+        if (worker->thread.joinable()) {
+            worker->thread.join();
+        }
+    }
+
+    lk->lock();
+    invariant(_state == joining);
+    _setState_inlock(shutdownComplete);
+}
+
+Status WorkStealingThreadPool::schedule(Task task) {
+    const size_t workerIndex = (currentPool == this)
+        ? currentWorkerIndex
+        : _nextWorkerIndex.fetchAndAdd(1) % _workers.size();
+    {
+        auto& worker = *_workers[workerIndex];
+        stdx::lock_guard<stdx::mutex> lk(worker.mutex);
+        if (_inShutdown.load()) {
+            return Status(ErrorCodes::ShutdownInProgress,
+                          str::stream() << "Shutdown of thread pool " << _options.poolName
+                                        << " in progress");
+        }
+        worker.tasks.emplace_back(std::move(task));
+    }
+
+    // A worker going to sleep registers itself before checking every queue one last time, so
+    // either it sees this task or this sees it asleep.
+    if (_numSleepingWorkers.load() > 0) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _workAvailable.notify_one();
+    }
+    return Status::OK();
+}
+
+void WorkStealingThreadPool::_workerThreadBody(WorkStealingThreadPool* pool,
+                                               size_t workerIndex,
+                                               const std::string& threadName) {
+    setThreadName(threadName);
+    pool->_options.onCreateThread(threadName);
+    currentPool = pool;
+    currentWorkerIndex = workerIndex;
+    LOG(1) << "starting thread in pool " << pool->_options.poolName;
+    try {
+        pool->_consumeTasks(workerIndex);
+    } catch (...) {
+        severe() << "Exception reached top of stack in thread pool " << pool->_options.poolName;
+        std::terminate();
+    }
+    LOG(1) << "shutting down thread in pool " << pool->_options.poolName;
+    currentPool = nullptr;
+}
+
+void WorkStealingThreadPool::_consumeTasks(size_t workerIndex) {
+    while (true) {
+        Task task;
+        if (_popOwnTask(workerIndex, &task) || _stealTask(workerIndex, &task)) {
+            _runTask(task);
+            continue;
+        }
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        if (_state != running) {
+            // Nothing can be scheduled anymore, and whatever is still queued is drained by the
+            // other workers and by join().
+            return;
+        }
+
+        _numSleepingWorkers.fetchAndAdd(1);
+        if (!_hasPendingTasks()) {
+            _workAvailable.wait(lk);
+        }
+        _numSleepingWorkers.fetchAndSubtract(1);
+    }
+}
+
+bool WorkStealingThreadPool::_popOwnTask(size_t workerIndex, Task* task) {
+    auto& worker = *_workers[workerIndex];
+    stdx::lock_guard<stdx::mutex> lk(worker.mutex);
+    if (worker.tasks.empty()) {
+        return false;
+    }
+    *task = std::move(worker.tasks.front());
+    worker.tasks.pop_front();
+    return true;
+}
+
+bool WorkStealingThreadPool::_stealTask(size_t thiefIndex, Task* task) {
+    // Start with the next worker, so that thieves do not all go after the same victim.
+    for (size_t i = 1; i <= _workers.size(); ++i) {
+        const size_t victimIndex = (thiefIndex + i) % _workers.size();
+        if (victimIndex == thiefIndex) {
+            continue;
+        }
+
+        auto& victim = *_workers[victimIndex];
+        stdx::lock_guard<stdx::mutex> lk(victim.mutex);
+        if (victim.tasks.empty()) {
+            continue;
+        }
+        *task = std::move(victim.tasks.back());
+        victim.tasks.pop_back();
+        return true;
+    }
+    return false;
+}
+
+bool WorkStealingThreadPool::_hasPendingTasks() {
+    for (auto& worker : _workers) {
+        stdx::lock_guard<stdx::mutex> lk(worker->mutex);
+        if (!worker->tasks.empty()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void WorkStealingThreadPool::_runTask(const Task& task) {
+    try {
+        LOG(3) << "Executing a task on behalf of pool " << _options.poolName;
+        task();
+    } catch (...) {
+        severe() << "Exception escaped task in thread pool " << _options.poolName;
+        std::terminate();
+    }
+}
+
+void WorkStealingThreadPool::_setState_inlock(const LifecycleState newState) {
+    if (newState == _state) {
+        return;
+    }
+    _state = newState;
+    _stateChange.notify_all();
+}
+
+}  // namespace mongo
@@ -0,0 +1,199 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_pool_interface.h"
+
+namespace mongo {
+
+class Status;
+
+/**
+ * A thread pool with a fixed number of worker threads, each of which owns a queue of tasks.
+ *
+ * A task scheduled by a worker thread goes to that worker's own queue, and a task scheduled by any
+ * other thread goes to the queue of the next worker in round-robin order, so that schedule() only
+ * contends with the one worker whose queue it appends to. A worker runs the tasks of its own queue
+ * in order, and steals from the back of the other queues once its own is empty. Idle workers
+ * sleep on a shared condition variable, which is only signaled if some worker is asleep.
+ *
+ * Unlike ThreadPool, the pool does not grow or shrink, and does not support waitForIdle().
+ */
+class WorkStealingThreadPool final : public ThreadPoolInterface {
+    MONGO_DISALLOW_COPYING(WorkStealingThreadPool);
+
+public:
+    /**
+     * Structure used to configure an instance of WorkStealingThreadPool.
+     */
+    struct Options {
+        // Name of the thread pool. If this string is empty, the pool will be assigned a name
+        // unique to the current process.
+        std::string poolName;
+
+        // Prefix used to name threads for logging purposes. An integer will be appended to this
+        // string to create the thread name for each thread in the pool. If you leave this empty,
+        // the prefix will be the pool name followed by a hyphen.
+        std::string threadNamePrefix;
+
+        // Number of worker threads, all of which are started by startup(). Must be at least 1.
+        size_t numThreads = 4;
+
+        // This function is run before each worker thread begins consuming tasks.
+        using OnCreateThreadFn = stdx::function<void(const std::string& threadName)>;
+        OnCreateThreadFn onCreateThread = [](const std::string&) {};
+    };
+
+    /**
+     * Constructs a thread pool, configured with the given "options".
+     */
+    explicit WorkStealingThreadPool(Options options);
+
+    ~WorkStealingThreadPool() override;
+
+    void startup() override;
+    void shutdown() override;
+    void join() override;
+    Status schedule(Task task) override;
+
+private:
+    /**
+     * A worker thread and the queue of tasks it owns. The mutex only guards the queue.
+     */
+    struct Worker {
+        stdx::mutex mutex;
+        std::deque<Task> tasks;
+        stdx::thread thread;
+    };
+
+    /**
+     * Representation of the stage of life of the pool, with the same transitions as those of
+     * ThreadPool:
+     *
+     * preStart -> running -> joinRequired -> joining -> shutdownComplete
+     *        \               ^
+     *         \_____________/
+     */
+    enum LifecycleState { preStart, running, joinRequired, joining, shutdownComplete };
+
+    /**
+     * This is the thread body for worker threads.
+     */
+    static void _workerThreadBody(WorkStealingThreadPool* pool,
+                                  size_t workerIndex,
+                                  const std::string& threadName);
+
+    /**
+     * This is the run loop of the worker at "workerIndex", invoked by _workerThreadBody. Returns
+     * once the pool is shutting down and no task is left to run.
+     */
+    void _consumeTasks(size_t workerIndex);
+
+    /**
+     * Takes the oldest task of the queue of the worker at "workerIndex" into "task". Returns false
+     * if that queue is empty.
+     */
+    bool _popOwnTask(size_t workerIndex, Task* task);
+
+    /**
+     * Takes the newest task of the queue of any worker other than the one at "thiefIndex" into
+     * "task". A "thiefIndex" which is not a worker index may steal from every worker. Returns false
+     * if all of those queues are empty.
+     */
+    bool _stealTask(size_t thiefIndex, Task* task);
+
+    /**
+     * Returns whether any worker's queue holds a task.
+     */
+    bool _hasPendingTasks();
+
+    /**
+     * Runs "task", terminating the process if it throws.
+     */
+    void _runTask(const Task& task);
+
+    /**
+     * Implementation of shutdown once _mutex is locked.
+     */
+    void _shutdown_inlock();
+
+    /**
+     * Implementation of join once _mutex is owned by "lk".
+     */
+    void _join_inlock(stdx::unique_lock<stdx::mutex>* lk);
+
+    /**
+     * Changes the lifecycle state (_state) of the pool and wakes up any threads waiting for a state
+     * change. Has no effect if _state == newState.
+     */
+    void _setState_inlock(LifecycleState newState);
+
+    // These are the options with which the pool was configured at construction time.
+    const Options _options;
+
+    // One entry per worker thread, created at construction time so that tasks can be scheduled
+    // before startup(). The vector itself is not modified after construction.
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    // Index of the worker whose queue receives the next task scheduled by a non-worker thread.
+    AtomicUInt32 _nextWorkerIndex;
+
+    // Set once shutdown has started, after which no task may be scheduled. Checked by schedule()
+    // while holding the mutex of the queue it appends to, so that join() sees every task accepted.
+    AtomicWord<bool> _inShutdown{false};
+
+    // Number of workers waiting on _workAvailable. Only modified while holding _mutex.
+    AtomicInt32 _numSleepingWorkers;
+
+    // Mutex guarding the lifecycle state, and on which idle workers sleep.
+    stdx::mutex _mutex;
+
+    // This variable represents the lifecycle state of the pool.
+    LifecycleState _state = preStart;
+
+    // Condition signaled when a task is scheduled while a worker is asleep, or when the pool
+    // starts shutting down.
+    stdx::condition_variable _workAvailable;
+
+    // Condition variable signaled whenever _state changes.
+    stdx::condition_variable _stateChange;
+};
+
+}  // namespace mongo
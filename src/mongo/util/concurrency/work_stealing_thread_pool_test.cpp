@@ -0,0 +1,111 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/base/init.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/thread_pool_test_common.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+namespace {
+using namespace mongo;
+
+MONGO_INITIALIZER(WorkStealingThreadPoolCommonTests)(InitializerContext*) {
+    addTestsForThreadPool("WorkStealingThreadPoolCommon", []() {
+        return stdx::make_unique<WorkStealingThreadPool>(WorkStealingThreadPool::Options());
+    });
+    return Status::OK();
+}
+
+TEST(WorkStealingThreadPoolTest, IdleWorkerStealsTaskScheduledByBusyWorker) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 2;
+    WorkStealingThreadPool pool(options);
+    pool.startup();
+
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+    bool innerDone = false;
+    bool outerDone = false;
+    stdx::thread::id outerThread;
+    stdx::thread::id innerThread;
+
+    // The inner task is queued on the worker running the outer task, which only returns once the
+    // inner task has run, so the inner task can only be run by the other worker.
+    ASSERT_OK(pool.schedule([&] {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        outerThread = stdx::this_thread::get_id();
+        ASSERT_OK(pool.schedule([&] {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            innerThread = stdx::this_thread::get_id();
+            innerDone = true;
+            cv.notify_all();
+        }));
+        cv.wait(lk, [&] { return innerDone; });
+        outerDone = true;
+        cv.notify_all();
+    }));
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cv.wait(lk, [&] { return outerDone; });
+    }
+    ASSERT_NOT_EQUALS(outerThread, innerThread);
+
+    pool.shutdown();
+    pool.join();
+}
+
+TEST(WorkStealingThreadPoolTest, RunsEveryTaskScheduledBeforeAndAfterStartup) {
+    WorkStealingThreadPool::Options options;
+    options.numThreads = 3;
+    WorkStealingThreadPool pool(options);
+
+    const int numTasks = 1000;
+    AtomicInt32 numRun;
+    for (int i = 0; i < numTasks; ++i) {
+        ASSERT_OK(pool.schedule([&] { numRun.fetchAndAdd(1); }));
+    }
+    pool.startup();
+    for (int i = 0; i < numTasks; ++i) {
+        ASSERT_OK(pool.schedule([&] { numRun.fetchAndAdd(1); }));
+    }
+
+    pool.shutdown();
+    ASSERT_EQ(ErrorCodes::ShutdownInProgress, pool.schedule([] {}));
+    pool.join();
+    ASSERT_EQ(2 * numTasks, numRun.load());
+}
+
+}  // namespace
@@ -152,6 +152,37 @@ TEST(DecorableTest, ThrowingConstructor) {
     ASSERT_EQ(1, numDestructedAs);
 }
 
+TEST(DecorableTest, TrivialDecorationsAreZeroed) {
+    struct Trivial {
+        int count;
+        void* ptr;
+        double ratio;
+    };
+
+    numConstructedAs = 0;
+    numDestructedAs = 0;
+    DecorationRegistry registry;
+    const auto dd1 = registry.declareDecoration<Trivial>();
+    const auto dd2 = registry.declareDecoration<A>();
+    const auto dd3 = registry.declareDecoration<long long>();
+
+    // Dirty the memory each container leaves behind, which the next one may reuse.
+    for (int i = 0; i < 3; ++i) {
+        DecorationContainer decorable(&registry);
+        ASSERT_EQ(0, decorable.getDecoration(dd1).count);
+        ASSERT(decorable.getDecoration(dd1).ptr == nullptr);
+        ASSERT_EQ(0.0, decorable.getDecoration(dd1).ratio);
+        ASSERT_EQ(0, decorable.getDecoration(dd2).value);
+        ASSERT_EQ(0LL, decorable.getDecoration(dd3));
+
+        decorable.getDecoration(dd1) = {i + 1, &decorable, 0.5};
+        decorable.getDecoration(dd2).value = i + 1;
+        decorable.getDecoration(dd3) = i + 1;
+    }
+    ASSERT_EQ(3, numConstructedAs);
+    ASSERT_EQ(3, numDestructedAs);
+}
+
 TEST(DecorableTest, Alignment) {
     DecorationRegistry registry;
     const auto firstChar = registry.declareDecoration<char>();
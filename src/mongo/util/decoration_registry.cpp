@@ -30,6 +30,8 @@
 
 #include "mongo/util/decoration_registry.h"
 
+#include <cstring>
+
 namespace mongo {
 
 DecorationContainer::DecorationDescriptor DecorationRegistry::declareDecoration(
@@ -42,12 +44,23 @@ DecorationContainer::DecorationDescriptor DecorationRegistry::declareDecoration(
         _totalSizeBytes += alignBytes - misalignment;
     }
     DecorationContainer::DecorationDescriptor result(_totalSizeBytes);
-    _decorationInfo.push_back(DecorationInfo(result, constructor, destructor));
+    if (constructor) {
+        _decorationInfo.push_back(DecorationInfo(result, constructor, destructor));
+    } else {
+        _hasTrivialDecorations = true;
+    }
     _totalSizeBytes += sizeBytes;
     return result;
 }
 
 void DecorationRegistry::construct(DecorationContainer* decorable) const {
+    if (_hasTrivialDecorations) {
+        // The buffer starts with the first decoration.
+        memset(decorable->getDecoration(DecorationContainer::DecorationDescriptor(0)),
+               0,
+               _totalSizeBytes);
+    }
+
     auto iter = _decorationInfo.cbegin();
     try {
         for (; iter != _decorationInfo.cend(); ++iter) {
@@ -83,8 +96,6 @@ DecorationRegistry::DecorationInfo::DecorationInfo(
     DecorationContainer::DecorationDescriptor inDescriptor,
     DecorationConstructorFn inConstructor,
     DecorationDestructorFn inDestructor)
-    : descriptor(std::move(inDescriptor)),
-      constructor(std::move(inConstructor)),
-      destructor(std::move(inDestructor)) {}
+    : descriptor(std::move(inDescriptor)), constructor(inConstructor), destructor(inDestructor) {}
 
 }  // namespace mongo
@@ -32,7 +32,6 @@
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
-#include "mongo/stdx/functional.h"
 #include "mongo/util/decoration_container.h"
 
 namespace mongo {
@@ -61,8 +60,15 @@ public:
     DecorationContainer::DecorationDescriptorWithType<T> declareDecoration() {
         static_assert(std::is_nothrow_destructible<T>::value,
                       "Decorations must be nothrow destructible");
-        return DecorationContainer::DecorationDescriptorWithType<T>(std::move(declareDecoration(
-            sizeof(T), std::alignment_of<T>::value, &constructAt<T>, &destructAt<T>)));
+        // Trivial decorations, such as plain counters and pointers, are value-initialized by
+        // zeroing the decoration buffer rather than by a call for each of them.
+        const bool isTrivial = std::is_trivially_default_constructible<T>::value &&
+            std::is_trivially_destructible<T>::value;
+        return DecorationContainer::DecorationDescriptorWithType<T>(
+            std::move(declareDecoration(sizeof(T),
+                                        std::alignment_of<T>::value,
+                                        isTrivial ? nullptr : &constructAt<T>,
+                                        isTrivial ? nullptr : &destructAt<T>)));
     }
 
     size_t getDecorationBufferSizeBytes() const {
@@ -88,12 +94,12 @@ private:
     /**
      * Function that constructs (initializes) a single instance of a decoration.
      */
-    using DecorationConstructorFn = stdx::function<void(void*)>;
+    using DecorationConstructorFn = void (*)(void*);
 
     /**
      * Function that destructs (deinitializes) a single instance of a decoration.
      */
-    using DecorationDestructorFn = stdx::function<void(void*)>;
+    using DecorationDestructorFn = void (*)(void*);
 
     struct DecorationInfo {
         DecorationInfo() {}
@@ -120,7 +126,8 @@ private:
 
     /**
      * Declares a decoration with given "constructor" and "destructor" functions,
-     * of "sizeBytes" bytes.
+     * of "sizeBytes" bytes. Both functions are null for a decoration which is initialized by
+     * zeroing its bytes and needs no destruction.
      *
      * NOTE: "destructor" must not throw exceptions.
      */
@@ -129,8 +136,10 @@ private:
                                                                 DecorationConstructorFn constructor,
                                                                 DecorationDestructorFn destructor);
 
+    // Only the decorations which must be constructed and destroyed by a function call.
     DecorationInfoVector _decorationInfo;
     size_t _totalSizeBytes{0};
+    bool _hasTrivialDecorations{false};
 };
 
 }  // namespace mongo
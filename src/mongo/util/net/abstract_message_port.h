@@ -38,6 +38,7 @@
 
 namespace mongo {
 
+class MessageCompressorManager;
 class SSLManagerInterface;
 
 class AbstractMessagingPort {
@@ -179,6 +180,19 @@ public:
      */
     virtual Tag getTag() const = 0;
 
+    /**
+     * Returns the socket descriptor backing this port if readiness for the next recv() can be
+     * detected by polling the descriptor directly, or -1 if it cannot (for example, because an
+     * encryption layer may already hold buffered input).
+     */
+    virtual int pollableFD() const = 0;
+
+    /**
+     * Returns the wire protocol compression state of this connection. Messages passing through
+     * recv() and say() are decompressed and compressed using it.
+     */
+    virtual MessageCompressorManager& compressorManager() = 0;
+
     /**
      * Initiates the TLS/SSL handshake on this AbstractMessagingPort. When this function returns,
      * further communication on this AbstractMessagingPort will be encrypted.
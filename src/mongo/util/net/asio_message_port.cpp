@@ -464,7 +464,12 @@ bool ASIOMessagingPort::recv(Message& m) {
             throw asio::system_error(ec);
         }
 
-        m.setData(std::move(buf));
+        auto swm = _compressorManager.decompressMessage(Message(std::move(buf)));
+        if (!swm.isOK()) {
+            LOG(_logLevel) << "recv(): could not decompress message: " << swm.getStatus();
+            return false;
+        }
+        m = std::move(swm.getValue());
         return true;
 
     } catch (const asio::system_error& e) {
@@ -502,7 +507,9 @@ void ASIOMessagingPort::say(Message& toSend, int responseTo) {
     invariant(!toSend.empty());
     toSend.header().setId(nextMessageId());
     toSend.header().setResponseToMsgId(responseTo);
-    auto buf = toSend.buf();
+    auto swm = _compressorManager.compressMessage(toSend);
+    uassertStatusOK(swm.getStatus());
+    auto buf = swm.getValue().buf();
     if (buf) {
         send(buf, MsgData::ConstView(buf).getLen(), nullptr);
     }
@@ -649,6 +656,16 @@ uint64_t ASIOMessagingPort::getSockCreationMicroSec() const {
     return _creationTime;
 }
 
+int ASIOMessagingPort::pollableFD() const {
+    // Reads are driven through this port's own io_service, so its socket cannot be handed off to
+    // an external poller.
+    return -1;
+}
+
+MessageCompressorManager& ASIOMessagingPort::compressorManager() {
+    return _compressorManager;
+}
+
 void ASIOMessagingPort::setLogLevel(logger::LogSeverity logLevel) {
     _logLevel = logLevel;
 }
@@ -36,6 +36,7 @@
 #include "mongo/config.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/transport/message_compressor_manager.h"
 #include "mongo/util/net/abstract_message_port.h"
 #include "mongo/util/net/asio_ssl_context.h"
 #include "mongo/util/net/message.h"
@@ -116,6 +117,10 @@ public:
 
     AbstractMessagingPort::Tag getTag() const override;
 
+    int pollableFD() const override;
+
+    MessageCompressorManager& compressorManager() override;
+
     bool secure(SSLManagerInterface* ssl, const std::string& remoteHost) override;
 
     static void closeSockets(AbstractMessagingPort::Tag skipMask = kSkipAllMask);
@@ -151,6 +156,8 @@ private:
     long long _connectionId;
     AbstractMessagingPort::Tag _tag;
 
+    MessageCompressorManager _compressorManager;
+
 #ifdef MONGO_CONFIG_SSL
     boost::optional<ASIOSSLContext> _context;
     asio::ssl::stream<asio::generic::stream_protocol::socket> _sslSock;
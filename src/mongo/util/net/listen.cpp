@@ -655,6 +655,7 @@ void Listener::closeMessagingPorts(AbstractMessagingPort::Tag skipMask) {
 
 TicketHolder Listener::globalTicketHolder(DEFAULT_MAX_CONN);
 AtomicInt64 Listener::globalConnectionNumber;
+AtomicInt32 Listener::globalActiveConnections;
 
 void ListeningSockets::closeAll() {
     std::set<int>* sockets;
@@ -114,6 +114,9 @@ public:
     /** the "next" connection number.  every connection to this process has a unique number */
     static AtomicInt64 globalConnectionNumber;
 
+    /** the number of connections currently processing a request, as opposed to waiting for one */
+    static AtomicInt32 globalActiveConnections;
+
     /** keeps track of how many allowed connections there are and how many are being used*/
     static TicketHolder globalTicketHolder;
 
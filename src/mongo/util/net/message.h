@@ -66,6 +66,7 @@ enum NetworkOp : int32_t {
     // dbCommandReply_DEPRECATED = 2009, //
     dbCommand = 2010,
     dbCommandReply = 2011,
+    dbCompressed = 2012,  /* another message, compressed. see transport/message_compressor_*. */
 };
 
 enum class LogicalOp {
@@ -131,6 +132,8 @@ inline const char* networkOpToString(NetworkOp networkOp) {
             return "command";
         case dbCommandReply:
             return "commandReply";
+        case dbCompressed:
+            return "compressed";
         default:
             int op = static_cast<int>(networkOp);
             massert(16141, str::stream() << "cannot translate opcode " << op, !op);
@@ -191,7 +191,12 @@ bool MessagingPort::recv(Message& m) {
 
         _psock->recv(md.data(), left);
 
-        m.setData(std::move(buf));
+        auto swm = _compressorManager.decompressMessage(Message(std::move(buf)));
+        if (!swm.isOK()) {
+            LOG(0) << "recv(): could not decompress message: " << swm.getStatus();
+            return false;
+        }
+        m = std::move(swm.getValue());
         return true;
 
     } catch (const SocketException& e) {
@@ -228,7 +233,9 @@ void MessagingPort::say(Message& toSend, int responseTo) {
     verify(!toSend.empty());
     toSend.header().setId(nextMessageId());
     toSend.header().setResponseToMsgId(responseTo);
-    auto buf = toSend.buf();
+    auto swm = _compressorManager.compressMessage(toSend);
+    uassertStatusOK(swm.getStatus());
+    auto buf = swm.getValue().buf();
     if (buf) {
         send(buf, MsgData::ConstView(buf).getLen(), "say");
     }
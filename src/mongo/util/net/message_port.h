@@ -32,6 +32,7 @@
 #include <vector>
 
 #include "mongo/config.h"
+#include "mongo/transport/message_compressor_manager.h"
 #include "mongo/util/net/abstract_message_port.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/net/sock.h"
@@ -135,6 +136,14 @@ public:
         return _psock->getSockCreationMicroSec();
     }
 
+    int pollableFD() const override {
+        return _psock->isSecure() ? -1 : _psock->rawFD();
+    }
+
+    MessageCompressorManager& compressorManager() override {
+        return _compressorManager;
+    }
+
 private:
     // this is the parsed version of remote
     HostAndPort _remoteParsed;
@@ -142,6 +151,7 @@ private:
     long long _connectionId;
     AbstractMessagingPort::Tag _tag;
     std::shared_ptr<Socket> _psock;
+    MessageCompressorManager _compressorManager;
 
 
 public:
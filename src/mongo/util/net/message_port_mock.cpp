@@ -100,6 +100,14 @@ uint64_t MessagingPortMock::getSockCreationMicroSec() const {
     return 0;
 }
 
+int MessagingPortMock::pollableFD() const {
+    return -1;
+}
+
+MessageCompressorManager& MessagingPortMock::compressorManager() {
+    return _compressorManager;
+}
+
 void MessagingPortMock::setX509SubjectName(const std::string& x509SubjectName) {}
 
 std::string MessagingPortMock::getX509SubjectName() const {
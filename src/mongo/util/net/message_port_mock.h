@@ -30,6 +30,7 @@
 
 #include <vector>
 
+#include "mongo/transport/message_compressor_manager.h"
 #include "mongo/util/net/abstract_message_port.h"
 #include "mongo/util/net/message.h"
 #include "mongo/util/net/sockaddr.h"
@@ -90,12 +91,17 @@ public:
 
     AbstractMessagingPort::Tag getTag() const override;
 
+    int pollableFD() const override;
+
+    MessageCompressorManager& compressorManager() override;
+
     bool secure(SSLManagerInterface* ssl, const std::string& remoteHost) override;
 
     void setRemote(const HostAndPort& remote);
 
 private:
     HostAndPort _remote;
+    MessageCompressorManager _compressorManager;
 };
 
 }  // namespace mongo
@@ -33,16 +33,22 @@
 
 #include <memory>
 #include <system_error>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/base/init.h"
 #include "mongo/config.h"
+#include "mongo/db/client.h"
 #include "mongo/db/lasterror.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/concurrency/ticketholder.h"
 #include "mongo/util/debug_util.h"
 #include "mongo/util/exit.h"
@@ -55,11 +61,14 @@
 #include "mongo/util/net/socket_exception.h"
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/net/thread_idle_callback.h"
+#include "mongo/util/processinfo.h"
 #include "mongo/util/quick_exit.h"
 #include "mongo/util/scopeguard.h"
 
 #ifdef __linux__  // TODO: consider making this ifndef _WIN32
+#include <sys/epoll.h>
 #include <sys/resource.h>
+#include <unistd.h>
 #endif
 
 #if !defined(__has_feature)
@@ -75,6 +84,375 @@ namespace {
 
 using MessagingPortWithHandler = std::pair<AbstractMessagingPort*, std::shared_ptr<MessageHandler>>;
 
+const char kServiceModelThreadPerConnection[] = "threadPerConnection";
+const char kServiceModelWorkerPool[] = "workerPool";
+
+/**
+ * Selects how accepted connections are serviced. With "threadPerConnection" every connection gets
+ * a dedicated thread for its lifetime. With "workerPool" idle connections are parked in a poller
+ * and are only bound to one of a fixed number of worker threads while a request is being read,
+ * processed and replied to.
+ */
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(connectionServiceModel,
+                                      std::string,
+                                      kServiceModelThreadPerConnection);
+
+/**
+ * Number of worker threads used by the "workerPool" service model. A value of 0 sizes the pool to
+ * the number of available cores.
+ */
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(connectionServiceWorkerThreads, int, 0);
+
+/**
+ * If true and the host has more than one NUMA node, connections are assigned to the nodes in turn
+ * and are only serviced by threads bound to their node's CPUs, so that the memory used for a
+ * connection is allocated on, and stays local to, a single node.
+ */
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(connectionNumaAffinity, bool, false);
+
+MONGO_INITIALIZER(connectionServiceModel)(InitializerContext*) {
+    if ((connectionServiceModel != kServiceModelThreadPerConnection) &&
+        (connectionServiceModel != kServiceModelWorkerPool)) {
+        return Status(ErrorCodes::BadValue,
+                      "unsupported connection service model: " + connectionServiceModel);
+    }
+    if (connectionServiceWorkerThreads < 0) {
+        return Status(ErrorCodes::BadValue,
+                      "connectionServiceWorkerThreads must be greater than or equal to 0");
+    }
+    return Status::OK();
+}
+
+/**
+ * Returns the number of NUMA nodes connections are spread over, or 0 if they aren't bound to
+ * nodes.
+ */
+size_t getNumConnectionNumaNodes() {
+    if (!connectionNumaAffinity) {
+        return 0;
+    }
+    return ProcessInfo().getNumaNodeCpus().size();
+}
+
+/**
+ * Returns the NUMA node for the next connection, assigning them round-robin.
+ */
+size_t getNextConnectionNumaNode(size_t numNodes) {
+    static AtomicWord<unsigned long long> nextNode;
+    return nextNode.fetchAndAdd(1) % numNodes;
+}
+
+/**
+ * Logs the exception currently being handled on a connection. Must be called from within a catch
+ * block. Terminates the process on exceptions that are not DBExceptions.
+ */
+void logConnectionException() {
+    try {
+        throw;
+    } catch (AssertionException& e) {
+        log() << "AssertionException handling request, closing client connection: " << e;
+    } catch (SocketException& e) {
+        log() << "SocketException handling request, closing client connection: " << e;
+    } catch (const DBException& e) {  // must be right above std::exception to avoid catching
+                                      // subclasses
+        log() << "DBException handling request, closing client connection: " << e;
+    } catch (std::exception& e) {
+        error() << "Uncaught std::exception: " << e.what() << ", terminating";
+        quickExit(EXIT_UNCAUGHT);
+    }
+}
+
+/**
+ * Receives one message from "mp" and hands it to "handler" for processing. Returns false if the
+ * connection has been closed by the remote end or the server is shutting down, in which case no
+ * message was processed.
+ */
+bool receiveAndProcessMessage(AbstractMessagingPort* mp,
+                              MessageHandler* handler,
+                              Message* m,
+                              int64_t* counter) {
+    if (inShutdown()) {
+        return false;
+    }
+
+    m->reset();
+    mp->clearCounters();
+
+    if (!mp->recv(*m)) {
+        if (!serverGlobalParams.quiet) {
+            int conns = Listener::globalTicketHolder.used() - 1;
+            const char* word = (conns == 1 ? " connection" : " connections");
+            log() << "end connection " << mp->remote().toString() << " (" << conns << word
+                  << " now open)";
+        }
+        return false;
+    }
+
+    Listener::globalActiveConnections.fetchAndAdd(1);
+    {
+        ON_BLOCK_EXIT([] { Listener::globalActiveConnections.fetchAndSubtract(1); });
+        handler->process(*m, mp);
+    }
+    networkCounter.hit(mp->getBytesIn(), mp->getBytesOut());
+
+    // Occasionally we want to see if we're using too much memory.
+    if (((*counter)++ & 0xf) == 0) {
+        markThreadIdle();
+    }
+    return true;
+}
+
+#ifdef __linux__
+/**
+ * Services connections on a fixed-size pool of worker threads.
+ *
+ * Between requests a connection does not hold a thread: its socket is registered with an epoll
+ * set in one-shot mode and a single poller thread waits for any of them to become readable. A
+ * ready connection is handed to a worker, which attaches the connection's Client, receives and
+ * processes one request, detaches the Client again and re-arms the socket.
+ *
+ * Connections whose readiness cannot be observed through their socket descriptor (see
+ * AbstractMessagingPort::pollableFD()) are moved to a dedicated thread for the rest of their
+ * lifetime.
+ */
+class SessionWorkerPool {
+    MONGO_DISALLOW_COPYING(SessionWorkerPool);
+
+public:
+    /**
+     * Creates "numWorkers" workers. If "numNumaNodes" is more than 1, they are split between one
+     * pool per NUMA node, whose workers are bound to that node and only service the connections
+     * assigned to it.
+     */
+    SessionWorkerPool(size_t numWorkers, size_t numNumaNodes) {
+        if (numNumaNodes < 2) {
+            _workers.push_back(stdx::make_unique<ThreadPool>(_makeOptions(numWorkers)));
+            return;
+        }
+        for (size_t node = 0; node < numNumaNodes; ++node) {
+            const size_t nodeWorkers = std::max(size_t(1), numWorkers / numNumaNodes);
+            _workers.push_back(stdx::make_unique<ThreadPool>(_makeOptions(nodeWorkers, node)));
+        }
+    }
+
+    /**
+     * Starts the workers and the poller thread. Returns false if the poller could not be set up.
+     */
+    bool startup() {
+        _epollFD = epoll_create1(EPOLL_CLOEXEC);
+        if (_epollFD < 0) {
+            error() << "epoll_create1 failed: " << errnoWithDescription();
+            return false;
+        }
+        for (auto&& workers : _workers) {
+            workers->startup();
+        }
+        stdx::thread(&SessionWorkerPool::_pollerThreadBody, this).detach();
+        return true;
+    }
+
+    /**
+     * Takes ownership of "portWithHandler" and starts servicing it. The caller must have acquired
+     * a ticket from Listener::globalTicketHolder, which is released when the connection ends.
+     */
+    void startSession(std::unique_ptr<MessagingPortWithHandler> portWithHandler) {
+        auto session = new Session(std::move(portWithHandler));
+        if (_workers.size() > 1) {
+            session->numaNode = getNextConnectionNumaNode(_workers.size());
+        }
+        _schedule(session, &SessionWorkerPool::_connect);
+    }
+
+private:
+    /**
+     * Per-connection state, owned by whichever thread is currently servicing the connection or by
+     * the epoll set while the connection is idle.
+     */
+    struct Session {
+        explicit Session(std::unique_ptr<MessagingPortWithHandler> portWithHandler)
+            : port(portWithHandler->first), handler(std::move(portWithHandler->second)) {}
+
+        AbstractMessagingPort* port;
+        std::shared_ptr<MessageHandler> handler;
+        ServiceContext::UniqueClient client;
+        Message message;
+        int64_t counter = 0;
+        bool connected = false;
+
+        // Index of the pool in "_workers" which services the session.
+        size_t numaNode = 0;
+
+        // Descriptor registered with the epoll set, or -1 if the session has never been parked.
+        int registeredFD = -1;
+    };
+
+    using SessionStep = void (SessionWorkerPool::*)(Session*);
+
+    static ThreadPool::Options _makeOptions(size_t numWorkers) {
+        ThreadPool::Options options;
+        options.poolName = "ConnectionServiceWorkers";
+        options.threadNamePrefix = "connWorker";
+        options.minThreads = numWorkers;
+        options.maxThreads = numWorkers;
+        return options;
+    }
+
+    static ThreadPool::Options _makeOptions(size_t numWorkers, size_t numaNode) {
+        ThreadPool::Options options = _makeOptions(numWorkers);
+        options.poolName += str::stream() << "-node" << numaNode;
+        options.threadNamePrefix = str::stream() << "connWorker-node" << numaNode << "-";
+        options.onCreateThread = [numaNode](const std::string&) {
+            ProcessInfo::bindCurrentThreadToNumaNode(numaNode);
+        };
+        return options;
+    }
+
+    void _schedule(Session* session, SessionStep step) {
+        auto status = _workers[session->numaNode]->schedule(
+            [this, session, step] { (this->*step)(session); });
+        if (!status.isOK()) {
+            log() << "failed to schedule work for connection, closing it: " << status;
+            _end(session);
+        }
+    }
+
+    void _connect(Session* session) {
+        const std::string workerThreadName = getThreadName();
+        try {
+            session->handler->connected(session->port);
+            session->connected = true;
+            session->port->setLogLevel(logger::LogSeverity::Debug(1));
+        } catch (...) {
+            logConnectionException();
+            _end(session);
+            setThreadName(workerThreadName);
+            return;
+        }
+        _detachClient(session, workerThreadName);
+        _park(session);
+    }
+
+    void _runRequest(Session* session) {
+        const std::string workerThreadName = getThreadName();
+        _attachClient(session);
+        bool keepOpen = false;
+        try {
+            keepOpen = receiveAndProcessMessage(
+                session->port, session->handler.get(), &session->message, &session->counter);
+        } catch (...) {
+            logConnectionException();
+        }
+        if (!keepOpen) {
+            _end(session);
+            setThreadName(workerThreadName);
+            return;
+        }
+        _detachClient(session, workerThreadName);
+        _park(session);
+    }
+
+    /**
+     * Waits for the next request on "session" without holding a worker thread.
+     */
+    void _park(Session* session) {
+        const int fd = session->port->pollableFD();
+        if (fd < 0) {
+            _moveToDedicatedThread(session);
+            return;
+        }
+
+        epoll_event event;
+        event.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+        event.data.ptr = session;
+        const int op = (session->registeredFD == fd) ? EPOLL_CTL_MOD : EPOLL_CTL_ADD;
+        if (epoll_ctl(_epollFD, op, fd, &event) != 0) {
+            log() << "failed to register connection " << session->port->remote().toString()
+                  << " for polling, closing it: " << errnoWithDescription();
+            _end(session);
+            return;
+        }
+        session->registeredFD = fd;
+    }
+
+    void _moveToDedicatedThread(Session* session) {
+        try {
+            const bool bindToNode = _workers.size() > 1;
+            stdx::thread([this, session, bindToNode] {
+                if (bindToNode) {
+                    ProcessInfo::bindCurrentThreadToNumaNode(session->numaNode);
+                }
+                _attachClient(session);
+                try {
+                    while (receiveAndProcessMessage(session->port,
+                                                    session->handler.get(),
+                                                    &session->message,
+                                                    &session->counter)) {
+                    }
+                } catch (...) {
+                    logConnectionException();
+                }
+                _end(session);
+            }).detach();
+        } catch (...) {
+            log() << "failed to create thread for connection, closing it";
+            _end(session);
+        }
+    }
+
+    /**
+     * Tears down "session" on the current thread, which must not have a Client of its own.
+     */
+    void _end(Session* session) {
+        if (session->registeredFD >= 0) {
+            epoll_ctl(_epollFD, EPOLL_CTL_DEL, session->registeredFD, nullptr);
+        }
+        _attachClient(session);
+        if (session->connected) {
+            session->handler->close();
+        }
+        session->port->shutdown();
+        delete session;
+        Listener::globalTicketHolder.release();
+    }
+
+    void _attachClient(Session* session) {
+        if (session->client) {
+            Client::setCurrent(std::move(session->client));
+        }
+    }
+
+    void _detachClient(Session* session, const std::string& workerThreadName) {
+        session->client = Client::releaseCurrent();
+        setThreadName(workerThreadName);
+    }
+
+    void _pollerThreadBody() {
+        setThreadName("connPoller");
+
+        const int kMaxEvents = 256;
+        epoll_event events[kMaxEvents];
+        while (!inShutdown()) {
+            const int numReady = epoll_wait(_epollFD, events, kMaxEvents, 1000);
+            if (numReady < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                severe() << "epoll_wait failed: " << errnoWithDescription();
+                fassertFailed(40200);
+            }
+            for (int i = 0; i < numReady; ++i) {
+                _schedule(static_cast<Session*>(events[i].data.ptr),
+                          &SessionWorkerPool::_runRequest);
+            }
+        }
+    }
+
+    // One pool per NUMA node, or a single pool if connections aren't bound to nodes.
+    std::vector<std::unique_ptr<ThreadPool>> _workers;
+    int _epollFD = -1;
+};
+#endif  // __linux__
+
 }  // namespace
 
 class PortMessageServer : public MessageServer, public Listener {
@@ -100,6 +478,14 @@ public:
             return;
         }
 
+#ifdef __linux__
+        if (_workerPool) {
+            _workerPool->startSession(std::move(portWithHandler));
+            sleepAfterClosingPort.Dismiss();
+            return;
+        }
+#endif  // __linux__
+
         try {
 #ifndef __linux__  // TODO: consider making this ifdef _WIN32
             {
@@ -150,6 +536,31 @@ public:
     }
 
     virtual bool setupSockets() {
+        if (connectionNumaAffinity) {
+            if (const size_t numNumaNodes = getNumConnectionNumaNodes()) {
+                log() << "binding connection threads to " << numNumaNodes << " NUMA nodes";
+            } else {
+                warning() << "connectionNumaAffinity has no effect, the NUMA topology of this "
+                          << "host has a single node or can't be read";
+            }
+        }
+        if (connectionServiceModel == kServiceModelWorkerPool) {
+#ifdef __linux__
+            size_t numWorkers = connectionServiceWorkerThreads;
+            if (numWorkers == 0) {
+                numWorkers = std::max(1u, stdx::thread::hardware_concurrency());
+            }
+            const size_t numNumaNodes = getNumConnectionNumaNodes();
+            _workerPool = stdx::make_unique<SessionWorkerPool>(numWorkers, numNumaNodes);
+            if (!_workerPool->startup()) {
+                return false;
+            }
+            log() << "servicing connections with a pool of " << numWorkers << " worker threads";
+#else
+            warning() << "the " << kServiceModelWorkerPool << " connection service model is not "
+                      << "supported on this platform, using one thread per connection";
+#endif  // __linux__
+        }
         return Listener::setupSockets();
     }
 
@@ -164,6 +575,10 @@ public:
 private:
     const std::shared_ptr<MessageHandler> _handler;
 
+#ifdef __linux__
+    std::unique_ptr<SessionWorkerPool> _workerPool;
+#endif  // __linux__
+
     /**
      * Handles incoming messages from a given socket.
      *
@@ -188,45 +603,20 @@ private:
         setThreadName(std::string(str::stream() << "conn" << mp->connectionId()));
         mp->setLogLevel(logger::LogSeverity::Debug(1));
 
+        if (const size_t numNumaNodes = getNumConnectionNumaNodes()) {
+            ProcessInfo::bindCurrentThreadToNumaNode(getNextConnectionNumaNode(numNumaNodes));
+        }
+
         Message m;
         int64_t counter = 0;
         try {
             handler->connected(mp);
             ON_BLOCK_EXIT([handler]() { handler->close(); });
 
-            while (!inShutdown()) {
-                m.reset();
-                mp->clearCounters();
-
-                if (!mp->recv(m)) {
-                    if (!serverGlobalParams.quiet) {
-                        int conns = Listener::globalTicketHolder.used() - 1;
-                        const char* word = (conns == 1 ? " connection" : " connections");
-                        log() << "end connection " << mp->remote().toString() << " (" << conns
-                              << word << " now open)" << endl;
-                    }
-                    break;
-                }
-
-                handler->process(m, mp);
-                networkCounter.hit(mp->getBytesIn(), mp->getBytesOut());
-
-                // Occasionally we want to see if we're using too much memory.
-                if ((counter++ & 0xf) == 0) {
-                    markThreadIdle();
-                }
+            while (receiveAndProcessMessage(mp, handler.get(), &m, &counter)) {
             }
-        } catch (AssertionException& e) {
-            log() << "AssertionException handling request, closing client connection: " << e
-                  << endl;
-        } catch (SocketException& e) {
-            log() << "SocketException handling request, closing client connection: " << e << endl;
-        } catch (const DBException&
-                     e) {  // must be right above std::exception to avoid catching subclasses
-            log() << "DBException handling request, closing client connection: " << e << endl;
-        } catch (std::exception& e) {
-            error() << "Uncaught std::exception: " << e.what() << ", terminating" << endl;
-            quickExit(EXIT_UNCAUGHT);
+        } catch (...) {
+            logConnectionException();
         }
         mp->shutdown();
 
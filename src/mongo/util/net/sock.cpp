@@ -33,9 +33,12 @@
 
 #include "mongo/util/net/sock.h"
 
+#include <algorithm>
+
 #if !defined(_WIN32)
 #include <arpa/inet.h>
 #include <errno.h>
+#include <limits.h>
 #include <netdb.h>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
@@ -449,11 +452,46 @@ void Socket::send(const char* data, int len, const char* context) {
     }
 }
 
+namespace {
+// Buffers smaller than this are copied together before being handed to SSL_write, so that a
+// message split into many small pieces goes out in a few full TLS records rather than one record
+// per piece. It matches the largest plaintext a single TLS record carries.
+const size_t kSSLCoalesceBytes = 16 * 1024;
+
+#if !defined(_WIN32)
+// The most iovecs a single sendmsg() call accepts.
+#if defined(IOV_MAX)
+const size_t kMaxIovecsPerSend = IOV_MAX;
+#else
+const size_t kMaxIovecsPerSend = 1024;
+#endif
+#endif
+}  // namespace
+
 void Socket::_send(const vector<pair<char*, int>>& data, const char* context) {
+    std::vector<char> pending;
     for (vector<pair<char*, int>>::const_iterator i = data.begin(); i != data.end(); ++i) {
         char* data = i->first;
-        int len = i->second;
-        send(data, len, context);
+        size_t len = i->second > 0 ? i->second : 0;
+        if (len < kSSLCoalesceBytes) {
+            pending.insert(pending.end(), data, data + len);
+            if (pending.size() < kSSLCoalesceBytes) {
+                continue;
+            }
+            len = 0;
+        }
+
+        if (!pending.empty()) {
+            send(&pending[0], pending.size(), context);
+            pending.clear();
+        }
+        if (len > 0) {
+            send(data, len, context);
+        }
+    }
+
+    if (!pending.empty()) {
+        send(&pending[0], pending.size(), context);
     }
 }
 
@@ -473,7 +511,7 @@ void Socket::send(const vector<pair<char*, int>>& data, const char* context) {
     _send(data, context);
 #else
     vector<struct iovec> d(data.size());
-    int i = 0;
+    size_t i = 0;
     for (vector<pair<char*, int>>::const_iterator j = data.begin(); j != data.end(); ++j) {
         if (j->second > 0) {
             d[i].iov_base = j->first;
@@ -482,12 +520,21 @@ void Socket::send(const vector<pair<char*, int>>& data, const char* context) {
             _bytesOut += j->second;
         }
     }
+    if (i == 0) {
+        return;
+    }
+
+    // Empty buffers were skipped above, so only the first 'i' entries of 'd' hold data.
+    struct iovec* iov = &d[0];
+    size_t iovRemaining = i;
+
     struct msghdr meta;
     memset(&meta, 0, sizeof(meta));
-    meta.msg_iov = &d[0];
-    meta.msg_iovlen = d.size();
 
-    while (meta.msg_iovlen > 0) {
+    while (iovRemaining > 0) {
+        meta.msg_iov = iov;
+        meta.msg_iovlen = std::min(iovRemaining, kMaxIovecsPerSend);
+
         int ret = -1;
         if (MONGO_FAIL_POINT(throwSockExcep)) {
 #if defined(_WIN32)
@@ -510,16 +557,15 @@ void Socket::send(const vector<pair<char*, int>>& data, const char* context) {
                 throw SocketException(SocketException::SEND_TIMEOUT, remoteString());
             }
         } else {
-            struct iovec*& i = meta.msg_iov;
             while (ret > 0) {
-                if (i->iov_len > unsigned(ret)) {
-                    i->iov_len -= ret;
-                    i->iov_base = (char*)(i->iov_base) + ret;
+                if (iov->iov_len > unsigned(ret)) {
+                    iov->iov_len -= ret;
+                    iov->iov_base = (char*)(iov->iov_base) + ret;
                     ret = 0;
                 } else {
-                    ret -= i->iov_len;
-                    ++i;
-                    --(meta.msg_iovlen);
+                    ret -= iov->iov_len;
+                    ++iov;
+                    --iovRemaining;
                 }
             }
         }
@@ -200,6 +200,18 @@ public:
         return _awaitingHandshake;
     }
 
+    /**
+     * Returns true if this socket has an established SSL connection, in which case data read from
+     * the socket descriptor may be buffered by the SSL layer.
+     */
+    bool isSecure() const {
+#ifdef MONGO_CONFIG_SSL
+        return _sslConnection.get();
+#else
+        return false;
+#endif
+    }
+
 #ifdef MONGO_CONFIG_SSL
     /** secures inline
      *  ssl - Pointer to the global SSLManager.
@@ -236,7 +248,7 @@ public:
 private:
     void _init();
 
-    /** sends dumbly, just each buffer at a time */
+    /** sends each buffer in turn, copying runs of small buffers together into one send */
     void _send(const std::vector<std::pair<char*, int>>& data, const char* context);
 
     /** raw send, same semantics as ::send with an additional context parameter */
@@ -288,6 +288,26 @@ TEST_F(SocketFailPointTest, TestSendVector) {
     ASSERT_TRUE(tryRecv());
 }
 
+TEST_F(SocketFailPointTest, TestSendVectorManyBuffers) {
+    // More pieces than one sendmsg() call accepts, with empty pieces mixed in and trailing.
+    const size_t kPieces = 3000;
+    std::vector<char> bytes(kPieces);
+    std::vector<std::pair<char*, int>> data;
+    for (size_t i = 0; i < kPieces; ++i) {
+        bytes[i] = static_cast<char>('a' + i % 26);
+        data.push_back(std::make_pair(&bytes[i], 1));
+        if (i % 7 == 0) {
+            data.push_back(std::make_pair(&bytes[i], 0));
+        }
+    }
+    data.push_back(std::make_pair(&bytes[0], 0));
+    _sockets.first->send(data, "SocketFailPointTest::TestSendVectorManyBuffers");
+
+    std::vector<char> received(kPieces);
+    _sockets.second->recv(&received[0], kPieces);
+    ASSERT_TRUE(bytes == received);
+}
+
 TEST_F(SocketFailPointTest, TestRecv) {
     ASSERT_TRUE(trySend());  // data for recv
     ASSERT_TRUE(tryRecv());
@@ -36,6 +36,7 @@
 #include <boost/thread/recursive_mutex.hpp>
 #include <boost/thread/tss.hpp>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -45,6 +46,7 @@
 #include "mongo/config.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/debug_util.h"
 #include "mongo/util/exit.h"
@@ -56,6 +58,7 @@
 #include "mongo/util/net/ssl_options.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/text.h"
+#include "mongo/util/timer.h"
 
 #ifdef MONGO_CONFIG_SSL
 #include <openssl/evp.h>
@@ -181,10 +184,44 @@ using UniqueSSLContext = std::unique_ptr<SSL_CTX, decltype(&_free_ssl_context)>;
 static const int BUFFER_SIZE = 8 * 1024;
 static const int DATE_LEN = 128;
 
+// The number of sessions an incoming SSL context keeps for resumption, and how long they stay
+// resumable. Session tickets, which OpenSSL enables by default, are subject to the same timeout.
+static const long kServerSessionCacheSize = 20 * 1024;
+static const long kSessionTimeoutSecs = 60 * 60;
+
+// The number of remote hosts whose last session outgoing connections remember.
+static const size_t kClientSessionCacheSize = 1024;
+
+/**
+ * Counts the handshakes performed in one direction, how many of them resumed an earlier
+ * session, and the total time they took.
+ */
+struct SSLHandshakeCounters {
+    void record(bool resumed, long long micros) {
+        total.fetchAndAdd(1);
+        if (resumed) {
+            this->resumed.fetchAndAdd(1);
+        }
+        totalMicros.fetchAndAdd(micros);
+    }
+
+    void append(BSONObjBuilder* builder) const {
+        builder->append("total", static_cast<long long>(total.load()));
+        builder->append("resumed", static_cast<long long>(resumed.load()));
+        builder->append("totalMicros", static_cast<long long>(totalMicros.load()));
+    }
+
+    AtomicUInt64 total;
+    AtomicUInt64 resumed;
+    AtomicUInt64 totalMicros;
+};
+
 class SSLManager : public SSLManagerInterface {
 public:
     explicit SSLManager(const SSLParams& params, bool isServer);
 
+    ~SSLManager();
+
     /**
      * Initializes an OpenSSL context according to the provided settings. Only settings which are
      * acceptable on non-blocking connections are set.
@@ -221,6 +258,8 @@ public:
 
     virtual void SSL_free(SSLConnection* conn);
 
+    void appendHandshakeStats(BSONObjBuilder* builder) const final;
+
 private:
     UniqueSSLContext _serverContext;  // SSL context for incoming connections
     UniqueSSLContext _clientContext;  // SSL context for outgoing connections
@@ -230,6 +269,24 @@ private:
     bool _allowInvalidHostnames;
     SSLConfiguration _sslConfiguration;
 
+    SSLHandshakeCounters _incomingHandshakes;
+    SSLHandshakeCounters _outgoingHandshakes;
+
+    // The most recent session negotiated with each remote address, offered for resumption by the
+    // next outgoing connection to it. Each entry holds a reference on its SSL_SESSION.
+    stdx::mutex _clientSessionsMutex;
+    std::map<std::string, SSL_SESSION*> _clientSessions;
+
+    /**
+     * Offers the session remembered for "remote", if any, for resumption by "conn".
+     */
+    void _resumeClientSession(const std::string& remote, SSLConnection* conn);
+
+    /**
+     * Remembers the session "conn" negotiated with "remote", replacing any earlier one.
+     */
+    void _saveClientSession(const std::string& remote, SSLConnection* conn);
+
     /**
      * creates an SSL object to be used for this file descriptor.
      * caller must SSL_free it.
@@ -473,6 +530,58 @@ BSONObj SSLConfiguration::getServerStatusBSON() const {
 
 SSLManagerInterface::~SSLManagerInterface() {}
 
+SSLManager::~SSLManager() {
+    for (auto&& entry : _clientSessions) {
+        ::SSL_SESSION_free(entry.second);
+    }
+}
+
+void SSLManager::appendHandshakeStats(BSONObjBuilder* builder) const {
+    BSONObjBuilder handshakes(builder->subobjStart("SSLHandshakes"));
+    {
+        BSONObjBuilder incoming(handshakes.subobjStart("incoming"));
+        _incomingHandshakes.append(&incoming);
+    }
+    {
+        BSONObjBuilder outgoing(handshakes.subobjStart("outgoing"));
+        _outgoingHandshakes.append(&outgoing);
+    }
+}
+
+void SSLManager::_resumeClientSession(const std::string& remote, SSLConnection* conn) {
+    stdx::lock_guard<stdx::mutex> lk(_clientSessionsMutex);
+    auto it = _clientSessions.find(remote);
+    if (it != _clientSessions.end()) {
+        // The connection takes its own reference on the session.
+        ::SSL_set_session(conn->ssl, it->second);
+    }
+}
+
+void SSLManager::_saveClientSession(const std::string& remote, SSLConnection* conn) {
+    SSL_SESSION* session = ::SSL_get1_session(conn->ssl);
+    if (!session) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_clientSessionsMutex);
+    auto it = _clientSessions.find(remote);
+    if (it != _clientSessions.end()) {
+        ::SSL_SESSION_free(it->second);
+        it->second = session;
+        return;
+    }
+
+    if (_clientSessions.size() >= kClientSessionCacheSize) {
+        // Forget everything rather than tracking recency; the next connection to each host just
+        // pays for a full handshake.
+        for (auto&& entry : _clientSessions) {
+            ::SSL_SESSION_free(entry.second);
+        }
+        _clientSessions.clear();
+    }
+    _clientSessions.emplace(remote, session);
+}
+
 SSLManager::SSLManager(const SSLParams& params, bool isServer)
     : _serverContext(nullptr, _free_ssl_context),
       _clientContext(nullptr, _free_ssl_context),
@@ -626,6 +735,18 @@ Status SSLManager::initSSLContext(SSL_CTX* context,
                                     << getSSLErrorMessage(ERR_get_error()));
     }
 
+    // Incoming contexts keep sessions so that reconnecting peers can resume them, either by
+    // session id or with a session ticket. Outgoing contexts never look sessions up themselves;
+    // resumption is driven by setting a remembered session on each new connection.
+    if (direction == ConnectionDirection::kIncoming) {
+        ::SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_SERVER);
+        ::SSL_CTX_sess_set_cache_size(context, kServerSessionCacheSize);
+        ::SSL_CTX_clear_options(context, SSL_OP_NO_TICKET);
+    } else {
+        ::SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_CLIENT);
+    }
+    ::SSL_CTX_set_timeout(context, kSessionTimeoutSecs);
+
     if (direction == ConnectionDirection::kOutgoing && !params.sslClusterFile.empty()) {
         ::EVP_set_pw_prompt("Enter cluster certificate passphrase");
         if (!_setupPEM(context, params.sslClusterFile, params.sslClusterPassword)) {
@@ -1049,6 +1170,10 @@ SSLConnection* SSLManager::connect(Socket* socket) {
     std::unique_ptr<SSLConnection> sslConn =
         stdx::make_unique<SSLConnection>(_clientContext.get(), socket, (const char*)NULL, 0);
 
+    const std::string remote = socket->remoteString();
+    _resumeClientSession(remote, sslConn.get());
+
+    Timer timer;
     int ret;
     do {
         ret = ::SSL_connect(sslConn->ssl);
@@ -1057,6 +1182,12 @@ SSLConnection* SSLManager::connect(Socket* socket) {
     if (ret != 1)
         _handleSSLError(SSL_get_error(sslConn.get(), ret), ret);
 
+    const bool resumed = ::SSL_session_reused(sslConn->ssl);
+    _outgoingHandshakes.record(resumed, timer.micros());
+    if (!resumed) {
+        _saveClientSession(remote, sslConn.get());
+    }
+
     return sslConn.release();
 }
 
@@ -1064,6 +1195,7 @@ SSLConnection* SSLManager::accept(Socket* socket, const char* initialBytes, int
     std::unique_ptr<SSLConnection> sslConn =
         stdx::make_unique<SSLConnection>(_serverContext.get(), socket, initialBytes, len);
 
+    Timer timer;
     int ret;
     do {
         ret = ::SSL_accept(sslConn->ssl);
@@ -1072,6 +1204,8 @@ SSLConnection* SSLManager::accept(Socket* socket, const char* initialBytes, int
     if (ret != 1)
         _handleSSLError(SSL_get_error(sslConn.get(), ret), ret);
 
+    _incomingHandshakes.record(::SSL_session_reused(sslConn->ssl), timer.micros());
+
     return sslConn.release();
 }
 
@@ -38,6 +38,7 @@
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/string_data.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/util/decorable.h"
 #include "mongo/util/net/sock.h"
 #include "mongo/util/time_support.h"
@@ -147,6 +148,12 @@ public:
 
     virtual void SSL_free(SSLConnection* conn) = 0;
 
+    /**
+     * Appends the number of TLS handshakes performed on incoming and outgoing connections, how
+     * many of them resumed an earlier session, and the time they took.
+     */
+    virtual void appendHandshakeStats(BSONObjBuilder* builder) const = 0;
+
     enum class ConnectionDirection { kIncoming, kOutgoing };
 
     /**
@@ -32,6 +32,7 @@
 #include <boost/optional.hpp>
 #include <cstdint>
 #include <string>
+#include <vector>
 
 #include "mongo/db/jsobj.h"
 #include "mongo/platform/process_id.h"
@@ -124,6 +125,20 @@ public:
         return sysInfo().hasNuma;
     }
 
+    /**
+     * Get the CPUs of each NUMA node, indexed by node number. Empty unless the system has more
+     * than one node and its topology could be read.
+     */
+    const std::vector<std::vector<unsigned>>& getNumaNodeCpus() const {
+        return sysInfo().numaNodeCpus;
+    }
+
+    /**
+     * Restricts the calling thread to the CPUs of NUMA node "node", so that the memory it touches
+     * first is allocated on that node. Returns false if this isn't supported or fails.
+     */
+    static bool bindCurrentThreadToNumaNode(size_t node);
+
     /**
      * Determine if file zeroing is necessary for newly allocated data files.
      */
@@ -198,6 +213,7 @@ private:
         unsigned long long pageSize;
         std::string cpuArch;
         bool hasNuma;
+        std::vector<std::vector<unsigned>> numaNodeCpus;
         BSONObj _extraStats;
 
         // This is an OS specific value, which determines whether files should be zero-filled
@@ -35,6 +35,7 @@
 
 #include <iostream>
 #include <malloc.h>
+#include <pthread.h>
 #include <sched.h>
 #include <stdio.h>
 #include <sys/mman.h>
@@ -52,6 +53,7 @@
 
 #include "mongo/util/file.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 
 using namespace std;
 
@@ -261,6 +263,90 @@ public:
         return fstr;
     }
 
+    /**
+    * Get the CPUs of each NUMA node from sysfs, or nothing if there is only one node
+    */
+    static vector<vector<unsigned>> getNumaNodeCpus() {
+        vector<vector<unsigned>> nodes;
+        for (;;) {
+            const string nodeDir = str::stream() << "/sys/devices/system/node/node" << nodes.size();
+            if (!boost::filesystem::exists(nodeDir)) {
+                break;
+            }
+
+            // e.g. "0-7,16-23"
+            vector<unsigned> cpus;
+            string cpuList = readLineFromFile((nodeDir + "/cpulist").c_str());
+            char* saveptr = NULL;
+            for (char* range = strtok_r(&cpuList[0], ",", &saveptr); range;
+                 range = strtok_r(NULL, ",", &saveptr)) {
+                unsigned first, last;
+                int found = sscanf(range, "%u-%u", &first, &last);
+                if (found == 1) {
+                    last = first;
+                } else if (found != 2) {
+                    continue;
+                }
+                for (unsigned cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            }
+            nodes.push_back(std::move(cpus));
+        }
+
+        if (nodes.size() < 2) {
+            nodes.clear();
+        }
+        return nodes;
+    }
+
+    /**
+    * Append the kernel's per-node allocation counters, which cover the whole system
+    */
+    static void appendNumaStats(size_t numNodes, BSONObjBuilder* builder) {
+        long long localNode = 0;
+        long long otherNode = 0;
+        long long numaHit = 0;
+        long long numaMiss = 0;
+
+        BSONArrayBuilder nodesBuilder(builder->subarrayStart("nodes"));
+        for (size_t node = 0; node < numNodes; ++node) {
+            const string numastat = str::stream() << "/sys/devices/system/node/node" << node
+                                                  << "/numastat";
+            FILE* f = fopen(numastat.c_str(), "r");
+            if (f == NULL) {
+                continue;
+            }
+
+            BSONObjBuilder nodeBuilder(nodesBuilder.subobjStart());
+            char name[64];
+            long long value;
+            while (fscanf(f, "%63s %lld", name, &value) == 2) {
+                nodeBuilder.append(name, value);
+                if (strcmp(name, "local_node") == 0) {
+                    localNode += value;
+                } else if (strcmp(name, "other_node") == 0) {
+                    otherNode += value;
+                } else if (strcmp(name, "numa_hit") == 0) {
+                    numaHit += value;
+                } else if (strcmp(name, "numa_miss") == 0) {
+                    numaMiss += value;
+                }
+            }
+            fclose(f);
+        }
+        nodesBuilder.doneFast();
+
+        if (localNode + otherNode > 0) {
+            builder->append("localAllocationRatio",
+                            static_cast<double>(localNode) / (localNode + otherNode));
+        }
+        if (numaHit + numaMiss > 0) {
+            builder->append("intendedNodeHitRatio",
+                            static_cast<double>(numaHit) / (numaHit + numaMiss));
+        }
+    }
+
     /**
     * Get some details about the CPU
     */
@@ -464,6 +550,12 @@ void ProcessInfo::getExtraInfo(BSONObjBuilder& info) {
         info.appendNumber("page_faults", static_cast<long long>(p._maj_flt));
     else
         info.appendNumber("page_faults", static_cast<double>(p._maj_flt));
+
+    const size_t numNumaNodes = sysInfo().numaNodeCpus.size();
+    if (numNumaNodes > 0) {
+        BSONObjBuilder numaBuilder(info.subobjStart("numa"));
+        LinuxSysHelper::appendNumaStats(numNumaNodes, &numaBuilder);
+    }
 }
 
 /**
@@ -492,6 +584,7 @@ void ProcessInfo::SystemInfo::collectSystemInfo() {
     pageSize = static_cast<unsigned long long>(sysconf(_SC_PAGESIZE));
     cpuArch = unameData.machine;
     hasNuma = checkNumaEnabled();
+    numaNodeCpus = LinuxSysHelper::getNumaNodeCpus();
 
     BSONObjBuilder bExtra;
     bExtra.append("versionString", LinuxSysHelper::readLineFromFile("/proc/version"));
@@ -546,6 +639,29 @@ bool ProcessInfo::checkNumaEnabled() {
     return false;
 }
 
+bool ProcessInfo::bindCurrentThreadToNumaNode(size_t node) {
+    const auto& nodes = systemInfo->numaNodeCpus;
+    if (node >= nodes.size()) {
+        return false;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (unsigned cpu : nodes[node]) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &set);
+        }
+    }
+
+    int err = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (err != 0) {
+        warning() << "failed to bind thread to NUMA node " << node << ": "
+                  << errnoWithDescription(err);
+        return false;
+    }
+    return true;
+}
+
 bool ProcessInfo::blockCheckSupported() {
     return true;
 }
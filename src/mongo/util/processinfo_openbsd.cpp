@@ -100,6 +100,10 @@ bool ProcessInfo::checkNumaEnabled() {
     return false;
 }
 
+bool ProcessInfo::bindCurrentThreadToNumaNode(size_t node) {
+    return false;
+}
+
 int ProcessInfo::getVirtualMemorySize() {
     kvm_t* kd = NULL;
     int cnt = 0;
@@ -218,6 +218,10 @@ bool ProcessInfo::checkNumaEnabled() {
     return false;
 }
 
+bool ProcessInfo::bindCurrentThreadToNumaNode(size_t node) {
+    return false;
+}
+
 bool ProcessInfo::blockCheckSupported() {
     return true;
 }
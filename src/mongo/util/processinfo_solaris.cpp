@@ -217,6 +217,10 @@ bool ProcessInfo::checkNumaEnabled() {
     return groups > 1;
 }
 
+bool ProcessInfo::bindCurrentThreadToNumaNode(size_t node) {
+    return false;
+}
+
 bool ProcessInfo::blockCheckSupported() {
     return true;
 }
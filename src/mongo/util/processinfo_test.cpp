@@ -64,6 +64,14 @@ TEST(ProcessInfo, GetNumAvailableCores) {
 #endif
 }
 
+TEST(ProcessInfo, NumaTopologyHasNoneOrSeveralNodes) {
+    ProcessInfo processInfo;
+    ProcessInfo::initializeSystemInfo();
+    const auto& nodes = processInfo.getNumaNodeCpus();
+    ASSERT_NOT_EQUALS(1U, nodes.size());
+    ASSERT_FALSE(ProcessInfo::bindCurrentThreadToNumaNode(nodes.size()));
+}
+
 TEST(ProcessInfo, GetNumCoresReturnsNonZeroNumberOfProcessors) {
     ProcessInfo processInfo;
     ProcessInfo::initializeSystemInfo();
@@ -61,6 +61,10 @@ bool ProcessInfo::checkNumaEnabled() {
     return false;
 }
 
+bool ProcessInfo::bindCurrentThreadToNumaNode(size_t node) {
+    return false;
+}
+
 bool ProcessInfo::blockCheckSupported() {
     return false;
 }
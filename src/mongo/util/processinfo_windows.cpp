@@ -440,6 +440,10 @@ bool ProcessInfo::checkNumaEnabled() {
     return numaNodeCount > 1;
 }
 
+bool ProcessInfo::bindCurrentThreadToNumaNode(size_t node) {
+    return false;
+}
+
 bool ProcessInfo::blockCheckSupported() {
     return psapiGlobal->supported;
 }
@@ -0,0 +1,213 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+/**
+ * A map from strings to pointers, which can be searched without any locking while entries are
+ * inserted into it.
+ *
+ * Calls to insert(), erase() and clear() must be serialized by the caller. find() may run
+ * concurrently with insert(), and then either finds the inserted entry or doesn't. It must not
+ * run concurrently with erase() or clear(): the caller must exclude readers while it removes
+ * entries, for example with a lock which readers hold in a shared mode. This suits registries
+ * whose entries are only removed under an exclusive lock, but are looked up very often.
+ *
+ * Entries live in an open-addressed table of atomic pointers, so that a reader sees each slot
+ * either before or after an insertion. When the table grows, a new one is published for readers
+ * to find. The tables it replaces may still be searched by readers, so they are only freed by the
+ * next erase() or clear().
+ *
+ * The map does not own the values it points to.
+ */
+template <typename T>
+class ReadMostlyStringMap {
+    MONGO_DISALLOW_COPYING(ReadMostlyStringMap);
+
+public:
+    ReadMostlyStringMap() : _current(new Table(kMinCapacity)) {
+        _table.store(_current.get());
+    }
+
+    ~ReadMostlyStringMap() {
+        clear();
+    }
+
+    /**
+     * Returns the value of 'key', or nullptr if it has none. Takes no locks.
+     */
+    T* find(StringData key) const {
+        const Table* table = _table.load(std::memory_order_acquire);
+        const Node* node = table->slots[table->findSlot(key)].load(std::memory_order_acquire);
+        return node ? node->value.load(std::memory_order_acquire) : nullptr;
+    }
+
+    /**
+     * Sets the value of 'key' to 'value', adding an entry if it has none.
+     */
+    void insert(StringData key, T* value) {
+        size_t slot = _current->findSlot(key);
+        Node* node = _current->slots[slot].load(std::memory_order_relaxed);
+        if (node) {
+            node->value.store(value, std::memory_order_release);
+            return;
+        }
+
+        // Keep the table at most half full, so that searches stay short.
+        if (2 * (_size + 1) > _current->capacity) {
+            _grow();
+            slot = _current->findSlot(key);
+        }
+        _current->slots[slot].store(new Node(key, value), std::memory_order_release);
+        ++_size;
+    }
+
+    /**
+     * Removes the entry for 'key', if any. No reader may search the map concurrently.
+     */
+    void erase(StringData key) {
+        _retired.clear();
+
+        size_t slot = _current->findSlot(key);
+        std::unique_ptr<Node> node(_current->slots[slot].exchange(nullptr));
+        if (!node) {
+            return;
+        }
+        --_size;
+
+        // Move the entries after the removed one in its run of full slots back to where a search
+        // can find them.
+        const size_t mask = _current->capacity - 1;
+        for (slot = (slot + 1) & mask; Node* next = _current->slots[slot].load();
+             slot = (slot + 1) & mask) {
+            _current->slots[slot].store(nullptr);
+            _current->slots[_current->findSlot(next->key)].store(next);
+        }
+    }
+
+    /**
+     * Removes all entries. No reader may search the map concurrently.
+     */
+    void clear() {
+        _retired.clear();
+        for (size_t i = 0; i < _current->capacity; ++i) {
+            delete _current->slots[i].exchange(nullptr);
+        }
+        _size = 0;
+    }
+
+    /**
+     * Calls 'callback' with the key and value of each entry. Must be serialized with the
+     * functions which change the map.
+     */
+    template <typename Callback>
+    void forEach(const Callback& callback) const {
+        for (size_t i = 0; i < _current->capacity; ++i) {
+            if (const Node* node = _current->slots[i].load(std::memory_order_relaxed)) {
+                callback(StringData(node->key), node->value.load(std::memory_order_relaxed));
+            }
+        }
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+private:
+    static const size_t kMinCapacity = 16;
+
+    struct Node {
+        Node(StringData key, T* value) : key(key.toString()), value(value) {}
+
+        const std::string key;
+        std::atomic<T*> value;  // NOLINT
+    };
+
+    struct Table {
+        explicit Table(size_t capacity)
+            : capacity(capacity), slots(new std::atomic<Node*>[capacity]) {
+            for (size_t i = 0; i < capacity; ++i) {
+                slots[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * Returns the slot holding 'key', or the empty slot where it would be inserted.
+         */
+        size_t findSlot(StringData key) const {
+            const size_t mask = capacity - 1;
+            size_t slot = StringData::Hasher()(key) & mask;
+            while (const Node* node = slots[slot].load(std::memory_order_acquire)) {
+                if (StringData(node->key) == key) {
+                    break;
+                }
+                slot = (slot + 1) & mask;
+            }
+            return slot;
+        }
+
+        const size_t capacity;
+        std::unique_ptr<std::atomic<Node*>[]> slots;  // NOLINT
+    };
+
+    void _grow() {
+        std::unique_ptr<Table> table(new Table(2 * _current->capacity));
+        for (size_t i = 0; i < _current->capacity; ++i) {
+            if (Node* node = _current->slots[i].load(std::memory_order_relaxed)) {
+                table->slots[table->findSlot(node->key)].store(node, std::memory_order_relaxed);
+            }
+        }
+
+        _table.store(table.get(), std::memory_order_release);
+        _retired.push_back(std::move(_current));
+        _current = std::move(table);
+    }
+
+    // The table readers search, which is always '_current'.
+    std::atomic<Table*> _table;  // NOLINT
+
+    std::unique_ptr<Table> _current;
+    std::vector<std::unique_ptr<Table>> _retired;
+    size_t _size = 0;
+};
+
+}  // namespace mongo
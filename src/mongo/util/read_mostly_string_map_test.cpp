@@ -0,0 +1,132 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/read_mostly_string_map.h"
+
+#include <atomic>
+#include <set>
+#include <vector>
+
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+std::string key(size_t i) {
+    return str::stream() << "key" << i;
+}
+
+TEST(ReadMostlyStringMapTest, InsertFindErase) {
+    int a = 1;
+    int b = 2;
+    ReadMostlyStringMap<int> map;
+    ASSERT_TRUE(map.empty());
+    ASSERT_TRUE(map.find("a") == nullptr);
+
+    map.insert("a", &a);
+    map.insert("b", &b);
+    ASSERT_EQUALS(2U, map.size());
+    ASSERT_TRUE(map.find("a") == &a);
+    ASSERT_TRUE(map.find("b") == &b);
+
+    map.insert("a", &b);
+    ASSERT_EQUALS(2U, map.size());
+    ASSERT_TRUE(map.find("a") == &b);
+
+    map.erase("a");
+    map.erase("c");
+    ASSERT_EQUALS(1U, map.size());
+    ASSERT_TRUE(map.find("a") == nullptr);
+    ASSERT_TRUE(map.find("b") == &b);
+
+    map.clear();
+    ASSERT_TRUE(map.empty());
+    ASSERT_TRUE(map.find("b") == nullptr);
+}
+
+TEST(ReadMostlyStringMapTest, GrowAndEraseKeepAllEntriesFindable) {
+    std::vector<int> values(1000);
+    ReadMostlyStringMap<int> map;
+    for (size_t i = 0; i < values.size(); ++i) {
+        map.insert(key(i), &values[i]);
+    }
+    ASSERT_EQUALS(values.size(), map.size());
+
+    // Erasing entries moves others back in their runs of full slots.
+    for (size_t i = 0; i < values.size(); i += 3) {
+        map.erase(key(i));
+    }
+    for (size_t i = 0; i < values.size(); ++i) {
+        int* expected = i % 3 ? &values[i] : nullptr;
+        ASSERT_TRUE(map.find(key(i)) == expected);
+    }
+
+    std::set<std::string> keys;
+    map.forEach([&](StringData key, int* value) {
+        ASSERT_TRUE(value);
+        keys.insert(key.toString());
+    });
+    ASSERT_EQUALS(map.size(), keys.size());
+}
+
+TEST(ReadMostlyStringMapTest, FindWhileInserting) {
+    int value = 0;
+    ReadMostlyStringMap<int> map;
+    map.insert("always", &value);
+
+    std::atomic<bool> done(false);       // NOLINT
+    std::atomic<bool> sawMissing(false);  // NOLINT
+    std::vector<stdx::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                if (map.find("always") != &value) {
+                    sawMissing.store(true);
+                }
+            }
+        });
+    }
+
+    // Grow the table several times under the readers.
+    for (int i = 0; i < 10000; ++i) {
+        map.insert(key(i), &value);
+    }
+    done.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    ASSERT_FALSE(sawMissing.load());
+    ASSERT_EQUALS(10001U, map.size());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,354 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/sampling_profiler.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/config.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/threadlocal.h"
+#include "mongo/util/hex.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/stacktrace.h"
+#include "mongo/util/time_support.h"
+
+#if defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+namespace mongo {
+
+const size_t SamplingProfiler::kMaxStacks;
+const size_t SamplingProfiler::kMaxFrames;
+
+namespace {
+
+MONGO_TRIVIALLY_CONSTRUCTIBLE_THREAD_LOCAL const char* currentTag = nullptr;
+
+// The signal handler's frame and the signal trampoline's frame, which start every sample.
+const size_t kSkippedFrames = 2;
+
+// Number of samples the signal handler can store before the drain thread empties them. The drain
+// thread runs ten times a second, so this holds a tenth of a second of samples of up to 50 busy
+// CPUs at the highest rate.
+const size_t kSampleBufferSize = 5000;
+
+// The most samples per CPU-second that start() accepts.
+const int kMaxSamplesPerSecond = 1000;
+
+// The size past which a report stops adding stacks, well below the BSON object size limit.
+const int kMaxReportStacksBytes = 8 * 1024 * 1024;
+
+enum SampleState : int { kEmpty, kWriting, kReady };
+
+struct Sample {
+    AtomicInt32 state;
+    const char* tag;
+    size_t frameCount;
+    void* frames[SamplingProfiler::kMaxFrames + kSkippedFrames];
+};
+
+// Allocated by the first start() and never freed, since a late signal may still arrive after
+// stop().
+Sample* sampleBuffer = nullptr;
+AtomicUInt32 nextSample;
+AtomicUInt64 samplesLostToFullBuffer;
+
+#if defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)
+void handleProfilingSignal(int) {
+    const int savedErrno = errno;
+    Sample& sample = sampleBuffer[nextSample.fetchAndAdd(1) % kSampleBufferSize];
+    if (sample.state.compareAndSwap(kEmpty, kWriting) == kEmpty) {
+        sample.tag = currentTag;
+        sample.frameCount =
+            rawBacktrace(sample.frames, SamplingProfiler::kMaxFrames + kSkippedFrames);
+        sample.state.store(kReady);
+    } else {
+        samplesLostToFullBuffer.fetchAndAdd(1);
+    }
+    errno = savedErrno;
+}
+
+/**
+ * Arms the process's CPU timer to fire 'samplesPerSecond' times per CPU-second, or disarms it if
+ * 'samplesPerSecond' is 0.
+ */
+Status setProfilingTimer(int samplesPerSecond) {
+    struct itimerval timer;
+    timer.it_interval.tv_sec = 0;
+    timer.it_interval.tv_usec = samplesPerSecond ? 1000 * 1000 / samplesPerSecond : 0;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        return Status(ErrorCodes::InternalError,
+                      str::stream() << "Failed to set the profiling timer: "
+                                    << errnoWithDescription());
+    }
+    return Status::OK();
+}
+
+std::string symbolName(void* address) {
+    Dl_info info;
+    if (!dladdr(address, &info) || !info.dli_fbase) {
+        return "0x" + integerToHex(reinterpret_cast<uintptr_t>(address));
+    }
+
+    if (info.dli_sname) {
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        std::string name(status == 0 && demangled ? demangled : info.dli_sname);
+        free(demangled);
+        return name;
+    }
+
+    StringData fileName(info.dli_fname ? info.dli_fname : "???");
+    const size_t lastSlash = fileName.rfind('/');
+    if (lastSlash != std::string::npos) {
+        fileName = fileName.substr(lastSlash + 1);
+    }
+    const uintptr_t offset = uintptr_t(address) - uintptr_t(info.dli_fbase);
+    return str::stream() << fileName << "+0x" << integerToHex(offset);
+}
+#endif
+}  // namespace
+
+SamplingProfiler::ScopedTag::ScopedTag(const char* tag) : _previousTag(currentTag) {
+    currentTag = tag;
+}
+
+SamplingProfiler::ScopedTag::~ScopedTag() {
+    currentTag = _previousTag;
+}
+
+SamplingProfiler& SamplingProfiler::get() {
+    static SamplingProfiler profiler;
+    return profiler;
+}
+
+Status SamplingProfiler::start(int samplesPerSecond) {
+    if (samplesPerSecond <= 0 || samplesPerSecond > kMaxSamplesPerSecond) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "samplesPerSecond must be between 1 and "
+                                    << kMaxSamplesPerSecond);
+    }
+
+#if defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_running) {
+        return Status(ErrorCodes::ConflictingOperationInProgress,
+                      "The sampling profiler is already running");
+    }
+    if (_signalReserved) {
+        return Status(ErrorCodes::ConflictingOperationInProgress,
+                      "The CPU profiler started by _cpuProfilerStart is running");
+    }
+
+    if (!sampleBuffer) {
+        sampleBuffer = new Sample[kSampleBufferSize];
+        for (size_t i = 0; i < kSampleBufferSize; ++i) {
+            sampleBuffer[i].state.store(kEmpty);
+        }
+
+        // The first backtrace() loads the unwinder, which allocates.
+        void* frames[kSkippedFrames];
+        rawBacktrace(frames, kSkippedFrames);
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = &handleProfilingSignal;
+    action.sa_flags = SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, nullptr) != 0) {
+        return Status(ErrorCodes::InternalError,
+                      str::stream() << "Failed to install the profiling signal handler: "
+                                    << errnoWithDescription());
+    }
+
+    Status status = setProfilingTimer(samplesPerSecond);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    _running = true;
+    _samplesPerSecond = samplesPerSecond;
+    _drainThread = stdx::thread([this] { _drainLoop(); });
+    return Status::OK();
+#else
+    return Status(ErrorCodes::CommandNotSupported,
+                  "The sampling profiler isn't supported on this platform");
+#endif
+}
+
+void SamplingProfiler::stop() {
+    stdx::thread drainThread;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_running) {
+            return;
+        }
+#if defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)
+        // The handler stays installed: the default action of a SIGPROF already on its way would
+        // terminate the process.
+        setProfilingTimer(0);
+#endif
+        _running = false;
+        _stopCondition.notify_all();
+        drainThread = std::move(_drainThread);
+    }
+    drainThread.join();
+}
+
+bool SamplingProfiler::isRunning() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _running;
+}
+
+void SamplingProfiler::reset() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _drainSamples_inlock();
+    _stackCounts.clear();
+    _symbols.clear();
+    _totalSamples = 0;
+    _samplesOverStackLimit = 0;
+    samplesLostToFullBuffer.store(0);
+}
+
+Status SamplingProfiler::setSignalReserved(bool reserved) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (reserved && _running) {
+        return Status(ErrorCodes::ConflictingOperationInProgress,
+                      "The sampling profiler is running; stop it with {samplingProfiler: 'stop'}");
+    }
+    _signalReserved = reserved;
+    return Status::OK();
+}
+
+void SamplingProfiler::_drainLoop() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (_running) {
+        _stopCondition.wait_for(lk, Milliseconds(100).toSystemDuration());
+        _drainSamples_inlock();
+    }
+}
+
+void SamplingProfiler::_drainSamples_inlock() {
+    if (!sampleBuffer) {
+        return;
+    }
+
+    for (size_t i = 0; i < kSampleBufferSize; ++i) {
+        Sample& sample = sampleBuffer[i];
+        if (sample.state.load() != kReady) {
+            continue;
+        }
+
+        ++_totalSamples;
+        const size_t firstFrame = std::min(kSkippedFrames, sample.frameCount);
+        StackKey key(sample.tag,
+                     std::vector<void*>(sample.frames + firstFrame,
+                                        sample.frames + sample.frameCount));
+        sample.state.store(kEmpty);
+
+        auto it = _stackCounts.find(key);
+        if (it != _stackCounts.end()) {
+            ++it->second;
+        } else if (_stackCounts.size() < kMaxStacks) {
+            _stackCounts.emplace(std::move(key), 1);
+        } else {
+            ++_samplesOverStackLimit;
+        }
+    }
+}
+
+const std::string& SamplingProfiler::_symbolize_inlock(void* address) {
+    auto it = _symbols.find(address);
+    if (it == _symbols.end()) {
+#if defined(MONGO_CONFIG_HAVE_EXECINFO_BACKTRACE)
+        it = _symbols.emplace(address, symbolName(address)).first;
+#else
+        it = _symbols.emplace(address, "0x" + integerToHex(reinterpret_cast<uintptr_t>(address)))
+                 .first;
+#endif
+    }
+    return it->second;
+}
+
+void SamplingProfiler::appendReport(size_t maxStacks, BSONObjBuilder* builder) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _drainSamples_inlock();
+
+    builder->append("running", _running);
+    builder->append("samplesPerSecond", _samplesPerSecond);
+    builder->append("samples", static_cast<long long>(_totalSamples));
+    builder->append("samplesLostToFullBuffer",
+                    static_cast<long long>(samplesLostToFullBuffer.load()));
+    builder->append("samplesOverStackLimit", static_cast<long long>(_samplesOverStackLimit));
+
+    std::vector<std::map<StackKey, uint64_t>::const_iterator> stacks;
+    stacks.reserve(_stackCounts.size());
+    for (auto it = _stackCounts.begin(); it != _stackCounts.end(); ++it) {
+        stacks.push_back(it);
+    }
+    const size_t reported = std::min(maxStacks, stacks.size());
+    std::partial_sort(stacks.begin(),
+                      stacks.begin() + reported,
+                      stacks.end(),
+                      [](std::map<StackKey, uint64_t>::const_iterator lhs,
+                         std::map<StackKey, uint64_t>::const_iterator rhs) {
+                          return lhs->second > rhs->second;
+                      });
+
+    BSONArrayBuilder stacksBuilder(builder->subarrayStart("stacks"));
+    for (size_t i = 0; i < reported && stacksBuilder.len() < kMaxReportStacksBytes; ++i) {
+        const StackKey& key = stacks[i]->first;
+        std::string folded(key.first ? key.first : "none");
+        for (auto frame = key.second.rbegin(); frame != key.second.rend(); ++frame) {
+            folded += ';';
+            folded += _symbolize_inlock(*frame);
+        }
+
+        BSONObjBuilder stackBuilder(stacksBuilder.subobjStart());
+        stackBuilder.append("stack", folded);
+        stackBuilder.append("samples", static_cast<long long>(stacks[i]->second));
+    }
+}
+
+}  // namespace mongo
@@ -0,0 +1,145 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * A low-frequency CPU sampling profiler that is cheap enough to leave on in production.
+ *
+ * While running, the process's CPU timer interrupts whichever thread is on a CPU about
+ * 'samplesPerSecond' times per CPU-second. The signal handler only copies the thread's stack
+ * addresses and its tag into a fixed buffer; a background thread drains the buffer and counts
+ * the samples of each distinct stack. Reports symbolize the stacks into "folded" form, one
+ * "tag;outermost frame;...;innermost frame" string per stack, which flame graph tools read
+ * directly. The tag of a thread is the name of the command it is running, if any.
+ *
+ * The profiler uses SIGPROF, as does the gperftools profiler, so the two can't run at once.
+ * Only platforms whose C library provides backtrace() support it.
+ */
+class SamplingProfiler {
+    MONGO_DISALLOW_COPYING(SamplingProfiler);
+
+public:
+    /**
+     * Tags the samples taken on the current thread with 'tag' for the lifetime of this object.
+     * 'tag' must outlive the profiler; in practice, it is a string literal or a command name.
+     */
+    class ScopedTag {
+        MONGO_DISALLOW_COPYING(ScopedTag);
+
+    public:
+        explicit ScopedTag(const char* tag);
+        ~ScopedTag();
+
+    private:
+        const char* _previousTag;
+    };
+
+    // The most distinct stacks kept. Samples of later stacks are only counted as dropped.
+    static const size_t kMaxStacks = 10000;
+
+    // The most frames kept per stack, from the innermost one.
+    static const size_t kMaxFrames = 64;
+
+    static SamplingProfiler& get();
+
+    /**
+     * Starts sampling 'samplesPerSecond' times per CPU-second, keeping the samples collected by
+     * earlier runs. Fails if the profiler is already running, if SIGPROF is reserved by another
+     * profiler, or if the platform doesn't support sampling.
+     */
+    Status start(int samplesPerSecond);
+
+    /**
+     * Stops sampling. The samples collected so far remain available to appendReport().
+     */
+    void stop();
+
+    bool isRunning() const;
+
+    /**
+     * Discards all the samples collected so far.
+     */
+    void reset();
+
+    /**
+     * Reserves SIGPROF for another profiler, such as the one of the _cpuProfilerStart command,
+     * while 'reserved' is true. Fails if this profiler is running.
+     */
+    Status setSignalReserved(bool reserved);
+
+    /**
+     * Appends the state of the profiler and, for at most 'maxStacks' of the stacks sampled most
+     * often, their folded form and sample count.
+     */
+    void appendReport(size_t maxStacks, BSONObjBuilder* builder);
+
+private:
+    SamplingProfiler() = default;
+
+    // A stack sample: the tag of the thread and the return addresses of the stack frames,
+    // innermost first.
+    using StackKey = std::pair<const char*, std::vector<void*>>;
+
+    void _drainLoop();
+    void _drainSamples_inlock();
+    const std::string& _symbolize_inlock(void* address);
+
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _stopCondition;
+    stdx::thread _drainThread;
+    bool _running = false;
+    bool _signalReserved = false;
+    int _samplesPerSecond = 0;
+
+    // Number of samples of each distinct stack.
+    std::map<StackKey, uint64_t> _stackCounts;
+    uint64_t _totalSamples = 0;
+    uint64_t _samplesOverStackLimit = 0;
+
+    // Symbol names by address, filled in as reports need them.
+    std::map<void*, std::string> _symbols;
+};
+
+}  // namespace mongo
@@ -0,0 +1,103 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/sampling_profiler.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace {
+
+// Keeps a CPU busy for 'millis' milliseconds of wall time.
+unsigned long long spin(int millis) {
+    unsigned long long sum = 0;
+    Timer timer;
+    while (timer.millis() < millis) {
+        for (int i = 0; i < 10000; ++i) {
+            sum += i * i;
+        }
+    }
+    return sum;
+}
+
+TEST(SamplingProfilerTest, SamplesTaggedStacks) {
+    SamplingProfiler& profiler = SamplingProfiler::get();
+    profiler.reset();
+
+    Status status = profiler.start(200);
+    if (status == ErrorCodes::CommandNotSupported) {
+        return;
+    }
+    ASSERT_OK(status);
+    ASSERT_TRUE(profiler.isRunning());
+    ASSERT_EQUALS(ErrorCodes::ConflictingOperationInProgress, profiler.start(200));
+    ASSERT_EQUALS(ErrorCodes::ConflictingOperationInProgress, profiler.setSignalReserved(true));
+
+    {
+        SamplingProfiler::ScopedTag tag("spinning");
+        ASSERT_NOT_EQUALS(0ULL, spin(500));
+    }
+    profiler.stop();
+    ASSERT_FALSE(profiler.isRunning());
+
+    BSONObjBuilder builder;
+    profiler.appendReport(10, &builder);
+    BSONObj report = builder.obj();
+    ASSERT_FALSE(report["running"].trueValue());
+    ASSERT_EQUALS(200, report["samplesPerSecond"].numberInt());
+    ASSERT_GT(report["samples"].numberLong(), 0);
+
+    bool sawTaggedStack = false;
+    for (auto&& stack : report["stacks"].Obj()) {
+        ASSERT_GT(stack["samples"].numberLong(), 0);
+        sawTaggedStack = sawTaggedStack || stack["stack"].str().find("spinning;") == 0U;
+    }
+    ASSERT_TRUE(sawTaggedStack) << report;
+
+    profiler.reset();
+    BSONObjBuilder resetBuilder;
+    profiler.appendReport(10, &resetBuilder);
+    ASSERT_EQUALS(0, resetBuilder.obj()["samples"].numberLong());
+}
+
+TEST(SamplingProfilerTest, RefusesToStartWhileSignalIsReserved) {
+    SamplingProfiler& profiler = SamplingProfiler::get();
+    ASSERT_EQUALS(ErrorCodes::BadValue, profiler.start(0));
+
+    ASSERT_OK(profiler.setSignalReserved(true));
+    Status status = profiler.start(19);
+    ASSERT_NOT_OK(status);
+    ASSERT_FALSE(profiler.isRunning());
+    ASSERT_OK(profiler.setSignalReserved(false));
+}
+
+}  // namespace
+}  // namespace mongo
@@ -40,7 +40,24 @@ namespace mongo {
  * A mutable, ref-counted buffer.
  */
 class SharedBuffer {
+    class Holder;
+
 public:
+    /**
+     * Takes back the memory of buffers created by takeReleasableOwnership() once their last
+     * reference goes away, so that it can be reused rather than freed.
+     */
+    class Releaser {
+    public:
+        virtual ~Releaser() = default;
+
+        /**
+         * Called with the block which was passed to takeReleasableOwnership(), from the thread
+         * which drops the last reference to the buffer.
+         */
+        virtual void release(void* block) = 0;
+    };
+
     SharedBuffer() = default;
 
     void swap(SharedBuffer& other) {
@@ -61,6 +78,7 @@ public:
      */
     void realloc(size_t size) {
         invariant(!_holder || !_holder->isShared());
+        invariant(!_holder || !_holder->isReleasable());
 
         const size_t realSize = size + sizeof(Holder);
         void* newPtr = mongoRealloc(_holder.get(), realSize);
@@ -80,9 +98,40 @@ public:
         return bool(_holder);
     }
 
+    /**
+     * The number of bytes of a block passed to takeReleasableOwnership() which precede the data of
+     * the buffer.
+     */
+    static size_t releasableHeaderSize() {
+        return sizeof(ReleasablePrefix) + sizeof(Holder);
+    }
+
+    /**
+     * Given a block with releasableHeaderSize() bytes of space before the data, return a
+     * SharedBuffer that owns the memory and hands 'block' to 'releaser' instead of freeing it.
+     * 'releaser' must outlive every reference to the buffer.
+     */
+    static SharedBuffer takeReleasableOwnership(void* block, Releaser* releaser) {
+        auto prefix = new (block) ReleasablePrefix{releaser};
+        return SharedBuffer(new (prefix + 1) Holder(1U | Holder::kReleasableFlag));
+    }
+
 private:
+    /**
+     * Precedes the Holder of buffers created by takeReleasableOwnership().
+     */
+    struct ReleasablePrefix {
+        Releaser* releaser;
+    };
+
     class Holder {
     public:
+        /**
+         * Set in the reference count of buffers created by takeReleasableOwnership(), which
+         * keeps plain buffers free of any extra header.
+         */
+        static const AtomicUInt32::WordType kReleasableFlag = 1U << 31;
+
         explicit Holder(AtomicUInt32::WordType initial = AtomicUInt32::WordType())
             : _refCount(initial) {}
 
@@ -92,12 +141,25 @@ private:
         }
 
         friend void intrusive_ptr_release(Holder* h) {
-            if (h->_refCount.subtractAndFetch(1) == 0) {
-                // We placement new'ed a Holder in takeOwnership above,
-                // so we must destroy the object here.
-                h->~Holder();
+            const auto remaining = h->_refCount.subtractAndFetch(1);
+            if ((remaining & ~kReleasableFlag) == 0) {
+                destroy(h, remaining & kReleasableFlag);
+            }
+        }
+
+        static void destroy(Holder* h, bool releasable) {
+            // We placement new'ed a Holder in takeOwnership above,
+            // so we must destroy the object here.
+            h->~Holder();
+            if (!releasable) {
                 free(h);
+                return;
             }
+
+            auto prefix = reinterpret_cast<ReleasablePrefix*>(h) - 1;
+            auto releaser = prefix->releaser;
+            prefix->~ReleasablePrefix();
+            releaser->release(prefix);
         }
 
         char* data() {
@@ -109,7 +171,11 @@ private:
         }
 
         bool isShared() const {
-            return _refCount.load() > 1;
+            return (_refCount.load() & ~kReleasableFlag) > 1;
+        }
+
+        bool isReleasable() const {
+            return _refCount.load() & kReleasableFlag;
         }
 
         AtomicUInt32 _refCount;
@@ -31,6 +31,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <iosfwd>
 
 #if defined(_WIN32)
@@ -45,6 +46,14 @@ namespace mongo {
 void printStackTrace(std::ostream& os);
 void printStackTrace();
 
+/**
+ * Stores the return addresses of at most 'maxFrames' frames of the current thread's stack,
+ * innermost first, into 'addresses' and returns how many it stored, or 0 if the platform can't
+ * walk the stack. Doesn't allocate or lock, so a signal handler can call it as long as some
+ * thread has called it once before, which loads the unwinder.
+ */
+size_t rawBacktrace(void** addresses, size_t maxFrames);
+
 #if defined(_WIN32)
 // Print stack trace (using a specified stack context) to "os", default to the log stream.
 void printWindowsStackTrace(CONTEXT& context, std::ostream& os);
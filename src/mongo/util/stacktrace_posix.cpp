@@ -135,7 +135,16 @@ void printStackTrace(std::ostream& os) {
     os << "This platform does not support printing stacktraces" << std::endl;
 }
 
+size_t rawBacktrace(void** addresses, size_t maxFrames) {
+    return 0;
+}
+
 #else
+size_t rawBacktrace(void** addresses, size_t maxFrames) {
+    const int addressCount = backtrace(addresses, static_cast<int>(maxFrames));
+    return addressCount > 0 ? static_cast<size_t>(addressCount) : 0;
+}
+
 /**
  * Prints a stack backtrace for the current thread to the specified ostream.
  *
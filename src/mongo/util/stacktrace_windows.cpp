@@ -174,6 +174,10 @@ void printStackTrace(std::ostream& os) {
     printWindowsStackTrace(context, os);
 }
 
+size_t rawBacktrace(void** addresses, size_t maxFrames) {
+    return CaptureStackBackTrace(0, static_cast<DWORD>(maxFrames), addresses, NULL);
+}
+
 static SimpleMutex _stackTraceMutex;
 
 /**
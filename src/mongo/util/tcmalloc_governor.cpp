@@ -0,0 +1,203 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#ifdef _WIN32
+#define NVALGRIND
+#endif
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/tcmalloc_governor.h"
+
+#include <algorithm>
+#include <atomic>
+#include <gperftools/malloc_extension.h>
+#include <valgrind/valgrind.h>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/background.h"
+#include "mongo/util/log.h"
+#include "mongo/util/net/listen.h"
+
+namespace mongo {
+namespace {
+
+// Thread cache bytes granted to each connection which is processing a request. Zero leaves
+// tcmalloc.max_total_thread_cache_bytes alone.
+MONGO_EXPORT_SERVER_PARAMETER(tcmallocGovernorThreadCacheBytesPerActiveConnection, long long, 0);
+
+// Upper bound on the free page heap bytes returned to the operating system on each run of the
+// governor. Zero disables the release.
+MONGO_EXPORT_SERVER_PARAMETER(tcmallocGovernorReleaseBytesPerRun, long long, 0);
+
+// tcmalloc's own default for tcmalloc.max_total_thread_cache_bytes. Scaling never goes below it,
+// so that a briefly quiet server does not flush its thread caches.
+const size_t kMinThreadCacheBytes = 32 * 1024 * 1024;
+
+std::atomic<size_t> threadCacheCeiling{0};  // NOLINT
+
+size_t getNumericProperty(const char* property) {
+    size_t value = 0;
+    MallocExtension::instance()->GetNumericProperty(property, &value);
+    return value;
+}
+
+class TcmallocGovernor : public PeriodicTask {
+public:
+    std::string taskName() const override {
+        return "TcmallocGovernor";
+    }
+
+    void taskDoWork() override {
+        if (RUNNING_ON_VALGRIND)
+            return;
+
+        const int activeConnections = Listener::globalActiveConnections.load();
+        const int openConnections = Listener::globalTicketHolder.used();
+        const size_t heapSize = getNumericProperty("generic.heap_size");
+        const size_t allocatedBytes = getNumericProperty("generic.current_allocated_bytes");
+        const size_t pageHeapFreeBytes = getNumericProperty("tcmalloc.pageheap_free_bytes");
+
+        size_t threadCacheTarget = 0;
+        const long long bytesPerConnection =
+            tcmallocGovernorThreadCacheBytesPerActiveConnection.load();
+        if (bytesPerConnection > 0) {
+            threadCacheTarget = _scaleThreadCache(activeConnections, bytesPerConnection);
+        } else if (_lastThreadCacheTarget) {
+            // Scaling was switched off, so go back to the configured value.
+            _setThreadCacheBytes(_getCeiling());
+            _lastThreadCacheTarget = 0;
+        }
+
+        size_t releasedBytes = 0;
+        const long long releaseBytesPerRun = tcmallocGovernorReleaseBytesPerRun.load();
+        if (releaseBytesPerRun > 0 && pageHeapFreeBytes > 0) {
+            releasedBytes = std::min(pageHeapFreeBytes, static_cast<size_t>(releaseBytesPerRun));
+            MallocExtension::instance()->ReleaseToSystem(releasedBytes);
+            LOG(1) << "tcmalloc governor released " << (releasedBytes / 1024) << "k of "
+                   << (pageHeapFreeBytes / 1024) << "k free page heap memory";
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _stats.runs++;
+        _stats.activeConnections = activeConnections;
+        _stats.openConnections = openConnections;
+        _stats.heapSize = heapSize;
+        _stats.allocatedBytes = allocatedBytes;
+        _stats.threadCacheTarget = threadCacheTarget;
+        _stats.lastReleasedBytes = releasedBytes;
+        _stats.totalReleasedBytes += releasedBytes;
+    }
+
+    void appendStats(BSONObjBuilder* builder) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        builder->appendNumber("runs", _stats.runs);
+        builder->appendNumber("activeConnections", _stats.activeConnections);
+        builder->appendNumber("openConnections", _stats.openConnections);
+        // The share of the heap which tcmalloc holds but the server has not allocated.
+        builder->append("fragmentation",
+                        _stats.heapSize ? 1.0 - double(_stats.allocatedBytes) / _stats.heapSize
+                                        : 0.0);
+        builder->appendNumber("thread_cache_target_bytes", _stats.threadCacheTarget);
+        builder->appendNumber("last_released_bytes", _stats.lastReleasedBytes);
+        builder->appendNumber("total_released_bytes", _stats.totalReleasedBytes);
+    }
+
+private:
+    struct Stats {
+        long long runs = 0;
+        int activeConnections = 0;
+        int openConnections = 0;
+        size_t heapSize = 0;
+        size_t allocatedBytes = 0;
+        size_t threadCacheTarget = 0;
+        size_t lastReleasedBytes = 0;
+        size_t totalReleasedBytes = 0;
+    };
+
+    /**
+     * Sets tcmalloc.max_total_thread_cache_bytes in proportion to 'activeConnections' and returns
+     * the value set. The target grows at once but shrinks by at most half per run, since a single
+     * sample of the active connections is noisy.
+     */
+    size_t _scaleThreadCache(int activeConnections, long long bytesPerConnection) {
+        const size_t ceiling = _getCeiling();
+        const size_t floor = std::min(kMinThreadCacheBytes, ceiling);
+
+        size_t target = static_cast<size_t>(std::max(activeConnections, 0)) *
+            static_cast<size_t>(bytesPerConnection);
+        target = std::max(target, _lastThreadCacheTarget / 2);
+        target = std::max(target, floor);
+        target = std::min(target, ceiling);
+
+        if (target != getNumericProperty("tcmalloc.max_total_thread_cache_bytes")) {
+            _setThreadCacheBytes(target);
+            LOG(1) << "tcmalloc governor set max_total_thread_cache_bytes to " << target
+                   << " for " << activeConnections << " active connections";
+        }
+        _lastThreadCacheTarget = target;
+        return target;
+    }
+
+    static size_t _getCeiling() {
+        size_t ceiling = threadCacheCeiling.load();
+        if (!ceiling) {
+            // Configured through the environment rather than the server parameter.
+            ceiling = getNumericProperty("tcmalloc.max_total_thread_cache_bytes");
+            threadCacheCeiling.store(ceiling);
+        }
+        return ceiling;
+    }
+
+    static void _setThreadCacheBytes(size_t bytes) {
+        MallocExtension::instance()->SetNumericProperty("tcmalloc.max_total_thread_cache_bytes",
+                                                        bytes);
+    }
+
+    // Only touched from the PeriodicTask thread.
+    size_t _lastThreadCacheTarget = 0;
+
+    stdx::mutex _mutex;
+    Stats _stats;
+} tcmallocGovernor;
+
+}  // namespace
+
+void setTcmallocGovernorThreadCacheCeiling(size_t bytes) {
+    threadCacheCeiling.store(bytes);
+}
+
+void appendTcmallocGovernorStats(BSONObjBuilder* builder) {
+    tcmallocGovernor.appendStats(builder);
+}
+
+}  // namespace mongo
@@ -0,0 +1,55 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * The tcmalloc governor is a PeriodicTask which adapts tcmalloc to the server's load: it scales
+ * tcmalloc.max_total_thread_cache_bytes with the number of connections that are processing a
+ * request, and returns free page heap memory to the operating system at a configured rate. Both
+ * behaviors are off by default and are enabled through server parameters.
+ */
+
+/**
+ * Records the value configured for tcmalloc.max_total_thread_cache_bytes. The governor never
+ * grows the thread caches past it.
+ */
+void setTcmallocGovernorThreadCacheCeiling(size_t bytes);
+
+/**
+ * Appends the governor's most recent decisions to 'builder'.
+ */
+void appendTcmallocGovernorStats(BSONObjBuilder* builder);
+
+}  // namespace mongo
@@ -0,0 +1,286 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kControl
+
+#ifdef _WIN32
+#define NVALGRIND
+#endif
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/tcmalloc_huge_page_arena.h"
+
+#include <algorithm>
+#include <atomic>
+#include <gperftools/malloc_extension.h>
+#include <valgrind/valgrind.h>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#include "mongo/base/init.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+
+namespace mongo {
+namespace {
+
+const char kModeOff[] = "off";
+const char kModeTransparent[] = "transparent";
+const char kModeHugetlb2MB[] = "hugetlb2MB";
+const char kModeHugetlb1GB[] = "hugetlb1GB";
+
+// How memory added to the tcmalloc heap is mapped. "off" leaves it to tcmalloc, "transparent" maps
+// 2MB aligned regions and asks for transparent huge pages, and "hugetlb2MB" and "hugetlb1GB" take
+// pages of that size from the kernel's hugetlb pool, which must have been reserved beforehand.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(tcmallocHugePageArena, std::string, kModeOff);
+
+// The most memory the arena maps, after which the heap grows through tcmalloc's default system
+// allocator. Zero means no limit.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(tcmallocHugePageArenaLimitMB, long long, 0);
+
+// Locks the arena's memory so that it's never paged out. Needs a large enough RLIMIT_MEMLOCK.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(tcmallocHugePageArenaLock, bool, false);
+
+// Counters of the installed arena, read by serverStatus without tcmalloc's lock.
+std::atomic<bool> arenaInstalled{false};         // NOLINT
+std::atomic<bool> arenaExhausted{false};         // NOLINT
+std::atomic<long long> arenaPageSize{0};         // NOLINT
+std::atomic<long long> arenaMappedBytes{0};      // NOLINT
+std::atomic<long long> arenaLockedBytes{0};      // NOLINT
+std::atomic<long long> arenaMappings{0};         // NOLINT
+std::atomic<long long> arenaFallbacks{0};        // NOLINT
+std::atomic<long long> arenaLockFailures{0};     // NOLINT
+
+#ifdef __linux__
+/**
+ * Maps huge page aligned regions for tcmalloc, falling back to its default system allocator once
+ * the hugetlb pool or the configured limit is exhausted.
+ *
+ * tcmalloc calls Alloc() with its page heap lock held, so it must neither allocate nor log.
+ */
+class HugePageSysAllocator : public SysAllocator {
+public:
+    HugePageSysAllocator(SysAllocator* fallback,
+                         size_t pageSize,
+                         size_t mmapGranularity,
+                         int mmapFlags,
+                         bool transparent,
+                         size_t limitBytes,
+                         bool lock)
+        : _fallback(fallback),
+          _pageSize(pageSize),
+          _mmapGranularity(mmapGranularity),
+          _mmapFlags(mmapFlags),
+          _transparent(transparent),
+          _limitBytes(limitBytes),
+          _lock(lock) {}
+
+    void* Alloc(size_t size, size_t* actualSize, size_t alignment) override {
+        // Requests which can't take a whole page, such as tcmalloc's metadata, aren't worth one.
+        if (!actualSize && size < _pageSize) {
+            return _fallback->Alloc(size, actualSize, alignment);
+        }
+
+        if (!arenaExhausted.load(std::memory_order_relaxed)) {
+            if (void* result = _allocHugePages(size, actualSize, alignment)) {
+                return result;
+            }
+        }
+        arenaFallbacks.fetch_add(1, std::memory_order_relaxed);
+        return _fallback->Alloc(size, actualSize, alignment);
+    }
+
+private:
+    void* _allocHugePages(size_t size, size_t* actualSize, size_t alignment) {
+        const size_t align = std::max(alignment, _pageSize);
+        const size_t alignedSize = (size + align - 1) / align * align;
+        if (alignedSize < size) {
+            return nullptr;
+        }
+
+        const size_t mapped = arenaMappedBytes.load(std::memory_order_relaxed);
+        if (_limitBytes && mapped + alignedSize > _limitBytes) {
+            if (_limitBytes - mapped < _pageSize) {
+                arenaExhausted.store(true);
+            }
+            return nullptr;
+        }
+
+        // mmap only guarantees '_mmapGranularity' alignment, so map enough to trim the region to
+        // 'align' on both ends.
+        const size_t slop = align - _mmapGranularity;
+        void* region = mmap(nullptr,
+                            alignedSize + slop,
+                            PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS | _mmapFlags,
+                            -1,
+                            0);
+        if (region == MAP_FAILED) {
+            // An exhausted hugetlb pool doesn't refill by itself.
+            if (!_transparent) {
+                arenaExhausted.store(true);
+            }
+            return nullptr;
+        }
+
+        const uintptr_t regionStart = reinterpret_cast<uintptr_t>(region);
+        const uintptr_t start = (regionStart + align - 1) / align * align;
+        const size_t head = start - regionStart;
+        const size_t tail = slop - head;
+        if (head) {
+            munmap(region, head);
+        }
+        if (tail) {
+            munmap(reinterpret_cast<void*>(start + alignedSize), tail);
+        }
+
+        void* result = reinterpret_cast<void*>(start);
+        if (_transparent) {
+            madvise(result, alignedSize, MADV_HUGEPAGE);
+        }
+        if (_lock) {
+            if (mlock(result, alignedSize) == 0) {
+                arenaLockedBytes.fetch_add(alignedSize, std::memory_order_relaxed);
+            } else {
+                arenaLockFailures.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        arenaMappedBytes.fetch_add(alignedSize, std::memory_order_relaxed);
+        arenaMappings.fetch_add(1, std::memory_order_relaxed);
+        if (actualSize) {
+            *actualSize = alignedSize;
+        }
+        return result;
+    }
+
+    SysAllocator* const _fallback;
+    const size_t _pageSize;
+    const size_t _mmapGranularity;
+    const int _mmapFlags;
+    const bool _transparent;
+    const size_t _limitBytes;
+    const bool _lock;
+};
+#endif  // __linux__
+
+MONGO_INITIALIZER(TcmallocHugePageArena)(InitializerContext*) {
+    const std::string mode = tcmallocHugePageArena;
+    if (mode == kModeOff) {
+        return Status::OK();
+    }
+    if (tcmallocHugePageArenaLimitMB < 0) {
+        return Status(ErrorCodes::BadValue,
+                      "tcmallocHugePageArenaLimitMB must be greater than or equal to 0");
+    }
+
+#ifdef __linux__
+    const size_t systemPageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t pageSize;
+    size_t mmapGranularity;
+    int mmapFlags;
+    if (mode == kModeTransparent) {
+        pageSize = 2 * 1024 * 1024;
+        mmapGranularity = systemPageSize;
+        mmapFlags = 0;
+    } else if (mode == kModeHugetlb2MB) {
+        pageSize = 2 * 1024 * 1024;
+        mmapGranularity = pageSize;
+        mmapFlags = MAP_HUGETLB | (21 << MAP_HUGE_SHIFT);
+    } else if (mode == kModeHugetlb1GB) {
+        pageSize = 1024 * 1024 * 1024;
+        mmapGranularity = pageSize;
+        mmapFlags = MAP_HUGETLB | (30 << MAP_HUGE_SHIFT);
+    } else {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "unsupported tcmallocHugePageArena mode '" << mode
+                                    << "', expected one of "
+                                    << kModeOff
+                                    << ", "
+                                    << kModeTransparent
+                                    << ", "
+                                    << kModeHugetlb2MB
+                                    << " or "
+                                    << kModeHugetlb1GB);
+    }
+
+    if (RUNNING_ON_VALGRIND) {
+        warning() << "not installing the tcmalloc huge page arena while running under valgrind";
+        return Status::OK();
+    }
+
+    // Never freed, since tcmalloc keeps using it until the process exits.
+    auto allocator =
+        new HugePageSysAllocator(MallocExtension::instance()->GetSystemAllocator(),
+                                 pageSize,
+                                 mmapGranularity,
+                                 mmapFlags,
+                                 mode == kModeTransparent,
+                                 static_cast<size_t>(tcmallocHugePageArenaLimitMB) * 1024 * 1024,
+                                 tcmallocHugePageArenaLock);
+    MallocExtension::instance()->SetSystemAllocator(allocator);
+
+    arenaPageSize.store(pageSize);
+    arenaInstalled.store(true);
+    log() << "growing the tcmalloc heap with " << mode << " huge pages of " << (pageSize / 1024)
+          << "KB" << (tcmallocHugePageArenaLock ? ", locked into memory" : "");
+    return Status::OK();
+#else
+    return Status(ErrorCodes::BadValue, "tcmallocHugePageArena is only supported on Linux");
+#endif  // __linux__
+}
+
+}  // namespace
+
+void appendTcmallocHugePageArenaStats(BSONObjBuilder* builder) {
+    builder->append("mode", arenaInstalled.load() ? tcmallocHugePageArena : kModeOff);
+    if (!arenaInstalled.load()) {
+        return;
+    }
+    builder->appendNumber("page_size_bytes", arenaPageSize.load());
+    builder->appendNumber("limit_bytes", tcmallocHugePageArenaLimitMB * 1024 * 1024);
+    builder->append("locked", tcmallocHugePageArenaLock);
+    builder->append("exhausted", arenaExhausted.load());
+    builder->appendNumber("mapped_bytes", arenaMappedBytes.load());
+    builder->appendNumber("locked_bytes", arenaLockedBytes.load());
+    builder->appendNumber("mappings", arenaMappings.load());
+    builder->appendNumber("fallback_allocations", arenaFallbacks.load());
+    builder->appendNumber("lock_failures", arenaLockFailures.load());
+}
+
+}  // namespace mongo
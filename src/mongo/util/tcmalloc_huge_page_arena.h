@@ -0,0 +1,48 @@
+/**
+ *    Copyright (C) 2016 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * The huge page arena is a tcmalloc system allocator which backs the growth of the heap with huge
+ * pages, either from the kernel's hugetlb pool or as transparent huge pages, and optionally locks
+ * it into memory. Every allocation made once it is installed can use it, including the storage
+ * engine's cache and the server's large buffers. It is selected at startup through the
+ * tcmallocHugePageArena server parameter and is off by default.
+ */
+
+/**
+ * Appends the arena's configuration and counters to 'builder'.
+ */
+void appendTcmallocHugePageArenaStats(BSONObjBuilder* builder);
+
+}  // namespace mongo
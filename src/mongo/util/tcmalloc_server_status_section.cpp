@@ -41,6 +41,8 @@
 #include "mongo/util/log.h"
 #include "mongo/util/net/listen.h"
 #include "mongo/util/net/thread_idle_callback.h"
+#include "mongo/util/tcmalloc_governor.h"
+#include "mongo/util/tcmalloc_huge_page_arena.h"
 
 namespace mongo {
 
@@ -166,6 +168,14 @@ public:
             MallocExtension::instance()->GetStats(buffer, sizeof buffer);
             builder.append("formattedString", buffer);
         }
+        {
+            BSONObjBuilder sub(builder.subobjStart("governor"));
+            appendTcmallocGovernorStats(&sub);
+        }
+        {
+            BSONObjBuilder sub(builder.subobjStart("huge_page_arena"));
+            appendTcmallocHugePageArenaStats(&sub);
+        }
 
         return builder.obj();
     }
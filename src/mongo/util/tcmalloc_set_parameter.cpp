@@ -44,6 +44,7 @@
 #include "mongo/db/server_parameters.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/processinfo.h"
+#include "mongo/util/tcmalloc_governor.h"
 
 namespace mongo {
 namespace {
@@ -122,8 +123,25 @@ Status TcmallocNumericPropertyServerParameter::setFromString(const std::string&
     return set(builder.done().firstElement());
 }
 
-TcmallocNumericPropertyServerParameter tcmallocMaxTotalThreadCacheBytesParameter(
-    "tcmallocMaxTotalThreadCacheBytes", "tcmalloc.max_total_thread_cache_bytes");
+/**
+ * Also records the value as the most the tcmalloc governor may grow the thread caches to.
+ */
+class TcmallocMaxTotalThreadCacheBytesServerParameter
+    : public TcmallocNumericPropertyServerParameter {
+public:
+    TcmallocMaxTotalThreadCacheBytesServerParameter()
+        : TcmallocNumericPropertyServerParameter("tcmallocMaxTotalThreadCacheBytes",
+                                                 "tcmalloc.max_total_thread_cache_bytes") {}
+
+    Status set(const BSONElement& newValueElement) override {
+        Status status = TcmallocNumericPropertyServerParameter::set(newValueElement);
+        if (status.isOK()) {
+            setTcmallocGovernorThreadCacheCeiling(
+                static_cast<size_t>(newValueElement.safeNumberLong()));
+        }
+        return status;
+    }
+} tcmallocMaxTotalThreadCacheBytesParameter;
 
 TcmallocNumericPropertyServerParameter tcmallocAggressiveMemoryDecommit(
     "tcmallocAggressiveMemoryDecommit", "tcmalloc.aggressive_memory_decommit");